@@ -0,0 +1,218 @@
+#!/usr/bin/env python
+
+# Weak and strong scaling benchmarks.
+#
+# Usage: From this directory, call this script with python, e.g.
+#        python run_scaling.py --mode weak --ranks 1 8 64 --blocks-per-rank 8
+#        python run_scaling.py --mode strong --ranks 8 16 32 64 --blocks-per-rank 32 \
+#            hydro_linwave mhd_orszag_tang
+#
+# Notes:
+#   - Requires Python 3+.
+#   - Each problem in inputs/ is run once for every number of ranks.  In weak scaling
+#     every rank has --blocks-per-rank MeshBlocks.  In strong scaling the total number
+#     of MeshBlocks is --blocks-per-rank times the smallest number of ranks.  The
+#     physical domain of each problem is fixed, so the resolution changes with the
+#     number of MeshBlocks.
+#   - Timings are read from the "perf" output of each run (see src/outputs/perf.cpp).
+#     The first perf interval (which includes the first cycle) is discarded, and the
+#     others are averaged.  Results are printed, and written to scaling_<mode>.csv.
+#   - gr_torus and z4c_bbh need executables built with -D PROBLEM=gr_torus and
+#     -D PROBLEM=z4c_two_puncture.  Give them with e.g. --exe gr_torus=path/to/athena
+#     (the default for every problem is --exe-default).  Problems whose executable
+#     does not exist are skipped.
+#   - This is not a test: nothing is checked, and the runs are left in --run-dir.
+
+# Modules
+import argparse
+import csv
+import os
+import subprocess
+import sys
+from collections import OrderedDict
+
+# Problems: number of dimensions decomposed into MeshBlocks, and default MeshBlock size
+_problems = OrderedDict([
+    ('hydro_linwave', {'dims': 3, 'mbsize': 32}),
+    ('mhd_orszag_tang', {'dims': 2, 'mbsize': 128}),
+    ('gr_torus', {'dims': 3, 'mbsize': 32}),
+    ('z4c_bbh', {'dims': 3, 'mbsize': 32}),
+    ('rad_hohlraum', {'dims': 2, 'mbsize': 64}),
+])
+
+# Columns of each quantity (mean, min, max over ranks) in perf files
+_perf_cols = OrderedDict([
+    ('t_cycle', 4), ('t_comp', 7), ('t_comm', 10), ('t_amr', 13), ('bytes_sent', 16)
+])
+
+
+# Returns number of MeshBlocks along each of the dims directions, as close to equal as
+# possible, whose product is nblocks
+def decompose(nblocks, dims):
+    factors = []
+    n, p = nblocks, 2
+    while n > 1:
+        while n % p == 0:
+            factors.append(p)
+            n //= p
+        p += 1
+    nb = [1]*dims
+    for f in sorted(factors, reverse=True):
+        nb[nb.index(min(nb))] *= f
+    return sorted(nb, reverse=True)
+
+
+# Returns command line parameters for mesh of nblocks MeshBlocks of mbsize^dims cells
+def mesh_arguments(nblocks, dims, mbsize, ncycles, dcycle):
+    nb = decompose(nblocks, dims)
+    args = []
+    for d in range(dims):
+        args += ['mesh/nx{0}={1}'.format(d+1, nb[d]*mbsize),
+                 'meshblock/nx{0}={1}'.format(d+1, mbsize)]
+    args += ['time/nlim={0}'.format(ncycles), 'output1/dcycle={0}'.format(dcycle)]
+    return args, nb
+
+
+# Returns per-cycle quantities averaged over all but the first interval of a perf file
+def read_perf(filename):
+    rows = []
+    with open(filename) as f:
+        for line in f:
+            if line.startswith('#') or len(line.split()) == 0:
+                continue
+            rows.append([float(v) for v in line.split()])
+    if len(rows) > 1:
+        rows = rows[1:]
+    ncycles = sum(r[2] for r in rows)
+    if ncycles == 0:
+        return None
+    # zone-cycles/s from total zone-cycles and total time of slowest rank
+    res = OrderedDict()
+    res['zcps'] = ncycles / sum(r[2]/r[3] for r in rows if r[3] > 0.0)
+    for name, col in _perf_cols.items():
+        for off, stat in enumerate(['mean', 'min', 'max']):
+            res[name + '_' + stat] = sum(r[2]*r[col+off] for r in rows) / ncycles
+    return res
+
+
+# Main function
+def main(**kwargs):
+    problems = kwargs['problems']
+    if len(problems) == 0:
+        problems = list(_problems.keys())
+    for p in problems:
+        if p not in _problems:
+            print('Unknown problem ' + p + ', choose from ' + ' '.join(_problems))
+            sys.exit(1)
+    exes = {}
+    for e in kwargs['exe']:
+        name, path = e.split('=', 1)
+        exes[name] = path
+    ranks = sorted(kwargs['ranks'])
+    mode = kwargs['mode']
+    bpr = kwargs['blocks_per_rank']
+    ncycles = kwargs['ncycles']
+    dcycle = max(1, ncycles // kwargs['nperf'])
+    scaling_dir = os.path.dirname(os.path.abspath(__file__))
+    results = []
+
+    for prob in problems:
+        exe = os.path.abspath(exes.get(prob, kwargs['exe_default']))
+        if not os.path.isfile(exe):
+            print('Skipping {0}: executable {1} not found'.format(prob, exe))
+            continue
+        deck = os.path.join(scaling_dir, 'inputs', prob + '.athinput')
+        dims = _problems[prob]['dims']
+        mbsize = kwargs['mbsize'] if kwargs['mbsize'] > 0 else _problems[prob]['mbsize']
+        base = None
+        for n in ranks:
+            nblocks = bpr*n if mode == 'weak' else bpr*ranks[0]
+            if nblocks < n:
+                print('Skipping {0} on {1} ranks: only {2} MeshBlocks'.format(
+                    prob, n, nblocks))
+                continue
+            args, nb = mesh_arguments(nblocks, dims, mbsize, ncycles, dcycle)
+            run_dir = os.path.join(os.path.abspath(kwargs['run_dir']),
+                                   '{0}_{1}_n{2}'.format(prob, mode, n))
+            os.makedirs(run_dir, exist_ok=True)
+            perf_file = os.path.join(run_dir, prob + '.perf')
+            if os.path.isfile(perf_file):
+                os.remove(perf_file)
+            cmd = (kwargs['launcher'].format(nranks=n).split() + [exe, '-i', deck]
+                   + args + kwargs['args'])
+            print('Running ' + ' '.join(cmd))
+            with open(os.path.join(run_dir, 'athena.log'), 'w') as log:
+                err = subprocess.call(cmd, cwd=run_dir, stdout=log,
+                                      stderr=subprocess.STDOUT)
+            if err != 0 or not os.path.isfile(perf_file):
+                print('  failed (return code {0}), see {1}'.format(
+                    err, os.path.join(run_dir, 'athena.log')))
+                continue
+            res = read_perf(perf_file)
+            if res is None:
+                print('  no cycles measured, increase --ncycles')
+                continue
+            # parallel efficiency relative to smallest run
+            if base is None:
+                base = (n, res['zcps'])
+            if mode == 'weak':
+                eff = (res['zcps']/n) / (base[1]/base[0])
+            else:
+                eff = (res['zcps']/base[1]) / (float(n)/base[0])
+            row = OrderedDict([('problem', prob), ('mode', mode), ('nranks', n),
+                               ('nblocks', nblocks),
+                               ('blocks', 'x'.join(str(b) for b in nb)),
+                               ('mbsize', mbsize), ('efficiency', eff)])
+            row.update(res)
+            results.append(row)
+
+    if len(results) == 0:
+        return
+    print('')
+    print('{0:<16} {1:>6} {2:>8} {3:>12} {4:>12} {5:>6} {6:>10} {7:>10} {8:>10} '
+          '{9:>12}'.format('problem', 'ranks', 'blocks', 'zcps', 'zcps/rank', 'eff',
+                           't_cycle', 't_comp', 't_comm', 'bytes/cycle'))
+    for r in results:
+        print('{0:<16} {1:>6d} {2:>8d} {3:>12.4e} {4:>12.4e} {5:>6.3f} {6:>10.3e} '
+              '{7:>10.3e} {8:>10.3e} {9:>12.4e}'.format(
+                  r['problem'], r['nranks'], r['nblocks'], r['zcps'],
+                  r['zcps']/r['nranks'], r['efficiency'], r['t_cycle_max'],
+                  r['t_comp_max'], r['t_comm_max'], r['bytes_sent_mean']))
+    print('(times are seconds per cycle on the slowest rank, bytes are sent per rank)')
+    csv_file = 'scaling_{0}.csv'.format(mode)
+    with open(csv_file, 'w') as f:
+        writer = csv.DictWriter(f, fieldnames=list(results[0].keys()))
+        writer.writeheader()
+        writer.writerows(results)
+    print('Results written to ' + csv_file)
+
+
+# Execute main function
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('problems', type=str, default=[], nargs='*',
+                        help='names of problems to run (default: all), from: '
+                        + ' '.join(_problems))
+    parser.add_argument('--mode', choices=['weak', 'strong'], default='weak',
+                        help='weak or strong scaling')
+    parser.add_argument('--ranks', type=int, default=[1], nargs='+',
+                        help='numbers of MPI ranks to run on')
+    parser.add_argument('--blocks-per-rank', type=int, default=8,
+                        help='MeshBlocks per rank (strong: on smallest number of ranks)')
+    parser.add_argument('--mbsize', type=int, default=0,
+                        help='cells along each side of a MeshBlock (0: per problem)')
+    parser.add_argument('--ncycles', type=int, default=100,
+                        help='cycles in each run')
+    parser.add_argument('--nperf', type=int, default=5,
+                        help='perf outputs in each run (first is discarded)')
+    parser.add_argument('--launcher', type=str, default='mpirun -np {nranks}',
+                        help='command used to launch athena on {nranks} ranks')
+    parser.add_argument('--exe-default', type=str, default='../build/src/athena',
+                        help='athena executable used for all problems')
+    parser.add_argument('--exe', type=str, default=[], action='append',
+                        help='executable for one problem, as problem=path')
+    parser.add_argument('--run-dir', type=str, default='runs',
+                        help='directory in which each run is made')
+    parser.add_argument('--args', type=str, default=[], nargs='*',
+                        help='additional block/par=value arguments passed to athena')
+    main(**vars(parser.parse_args()))
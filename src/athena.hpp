@@ -9,6 +9,7 @@
 //  \brief contains Athena++ general purpose types, structures, enums, etc.
 
 #include <string>
+#include <type_traits>
 
 #include <Kokkos_Core.hpp>
 #include <Kokkos_DualView.hpp>
@@ -34,6 +35,32 @@ using Real = double;
 
 #endif // SINGLE_PRECISION_ENABLED
 
+// type aliases for storage of large transient arrays, which can be stored in single
+// precision (with MIXED_PRECISION_ENABLED) while evolved variables are stored as Real.
+// Arithmetic is always performed in Real; values are only rounded when they are stored.
+//   FluxReal: face-centered fluxes of conserved variables (e.g. Hydro::uflx)
+//   OutReal:  output data (BaseTypeOutput::outarray)
+// Boundary buffers are always Real.  Reduced-precision messages between MeshBlocks at
+// different levels are chosen per physics module (see MeshBoundaryValues).
+
+#if MIXED_PRECISION_ENABLED
+
+using FluxReal = float;
+using OutReal = float;
+#if MPI_PARALLEL_ENABLED
+#define MPI_ATHENA_OUT_REAL MPI_FLOAT
+#endif
+
+#else
+
+using FluxReal = Real;
+using OutReal = Real;
+#if MPI_PARALLEL_ENABLED
+#define MPI_ATHENA_OUT_REAL MPI_ATHENA_REAL
+#endif
+
+#endif // MIXED_PRECISION_ENABLED
+
 //----------------------------------------------------------------------------------------
 // general purpose macros (never modified)
 
@@ -64,6 +91,59 @@ enum ParticlesIndex {PGID=0, PTAG=1, IPX=0, IPVX=1, IPY=2, IPVY=3, IPZ=4, IPVZ=5
 // integer constants to specify spatial reconstruction methods
 enum ReconstructionMethod {dc, plm, ppm4, ppmx, wenoz};
 
+// regions of MeshBlocks, used when communication of ghost zones is overlapped with
+// computation: interior cells/faces do not depend on ghost zones, shell is the remainder
+enum class BlockRegion {all, interior, shell};
+
+// subsets of the MeshBlocks in a pack, used to update and send MBs with neighbors on
+// other ranks before all others: offrank MBs have at least one such neighbor
+enum class PackRegion {all, offrank, onrank};
+
+// inclusive bounds of a 3D box of cells or faces
+struct IndexBox {
+  int il, iu, jl, ju, kl, ku;
+};
+
+// decomposes box b into at most six boxes covering the requested region of b, where
+// interior is the box of interior cells/faces.  Returns number of (non-empty) boxes.
+inline int BlockRegionBoxes(BlockRegion region, const IndexBox &b,
+                            const IndexBox &interior, IndexBox boxes[6]) {
+  if (region == BlockRegion::all) {
+    boxes[0] = b;
+    return 1;
+  }
+  // clip interior box to b
+  IndexBox c = {(interior.il > b.il)? interior.il : b.il,
+                (interior.iu < b.iu)? interior.iu : b.iu,
+                (interior.jl > b.jl)? interior.jl : b.jl,
+                (interior.ju < b.ju)? interior.ju : b.ju,
+                (interior.kl > b.kl)? interior.kl : b.kl,
+                (interior.ku < b.ku)? interior.ku : b.ku};
+  bool empty = (c.il > c.iu || c.jl > c.ju || c.kl > c.ku);
+  if (region == BlockRegion::interior) {
+    if (empty) return 0;
+    boxes[0] = c;
+    return 1;
+  }
+  if (empty) {
+    boxes[0] = b;
+    return 1;
+  }
+  // shell: peel off slabs of b outside c in k, then j, then i
+  IndexBox slabs[6] = {{b.il, b.iu, b.jl, b.ju, b.kl, c.kl-1},
+                       {b.il, b.iu, b.jl, b.ju, c.ku+1, b.ku},
+                       {b.il, b.iu, b.jl, c.jl-1, c.kl, c.ku},
+                       {b.il, b.iu, c.ju+1, b.ju, c.kl, c.ku},
+                       {b.il, c.il-1, c.jl, c.ju, c.kl, c.ku},
+                       {c.iu+1, b.iu, c.jl, c.ju, c.kl, c.ku}
+  };
+  int nbox = 0;
+  for (auto &x : slabs) {
+    if (x.il <= x.iu && x.jl <= x.ju && x.kl <= x.ku) {boxes[nbox++] = x;}
+  }
+  return nbox;
+}
+
 // constants that enumerate time evolution options
 enum TimeEvolution {tstatic, kinematic, dynamic};
 
@@ -90,12 +170,23 @@ struct MHDCons1D {
 // define default Kokkos execution and memory spaces
 
 using DevExeSpace = Kokkos::DefaultExecutionSpace;
+using HostExeSpace = Kokkos::DefaultHostExecutionSpace;
 using DevMemSpace = Kokkos::DefaultExecutionSpace::memory_space;
 using HostMemSpace = Kokkos::HostSpace;
 using ScratchMemSpace = DevExeSpace::scratch_memory_space;
 using LayoutWrapper = Kokkos::LayoutRight;                // increments last index fastest
 using TeamMember_t = Kokkos::TeamPolicy<>::member_type;   // for Kokkos thread teams
 
+// layout of 5D arrays of cell-centered fields (m,n,k,j,i), set with Athena_FIELD_LAYOUT.
+// Kernels only access them through View::operator(), so they are independent of the
+// layout.  Arrays whose memory is read from or written to files use IOLayout instead.
+#if FIELD_LAYOUT_LEFT
+using FieldLayout = Kokkos::LayoutLeft;         // increments first index fastest
+#else
+using FieldLayout = Kokkos::LayoutRight;
+#endif
+using IOLayout = Kokkos::LayoutRight;
+
 //----------------------------------------------------------------------------------------
 // alias template declarations for various array types (formerly AthenaArrays)
 // mostly used to store cell-centered variables (volume averaged)
@@ -110,7 +201,7 @@ using DvceArray3D = Kokkos::View<T ***, LayoutWrapper, DevMemSpace>;
 template <typename T>
 using DvceArray4D = Kokkos::View<T ****, LayoutWrapper, DevMemSpace>;
 template <typename T>
-using DvceArray5D = Kokkos::View<T *****, LayoutWrapper, DevMemSpace>;
+using DvceArray5D = Kokkos::View<T *****, FieldLayout, DevMemSpace>;
 template <typename T>
 using DvceArray6D = Kokkos::View<T ******, LayoutWrapper, DevMemSpace>;
 
@@ -124,7 +215,7 @@ using HostArray3D = Kokkos::View<T ***, LayoutWrapper, HostMemSpace>;
 template <typename T>
 using HostArray4D = Kokkos::View<T ****, LayoutWrapper, HostMemSpace>;
 template <typename T>
-using HostArray5D = Kokkos::View<T *****, LayoutWrapper, HostMemSpace>;
+using HostArray5D = Kokkos::View<T *****, FieldLayout, HostMemSpace>;
 
 // template declarations for construction of Kokkos::DualViews
 template <typename T>
@@ -136,7 +227,32 @@ using DualArray3D = Kokkos::DualView<T ***, LayoutWrapper, DevMemSpace>;
 template <typename T>
 using DualArray4D = Kokkos::DualView<T ****, LayoutWrapper, DevMemSpace>;
 template <typename T>
-using DualArray5D = Kokkos::DualView<T *****, LayoutWrapper, DevMemSpace>;
+using DualArray5D = Kokkos::DualView<T *****, FieldLayout, DevMemSpace>;
+
+// template declarations for 5D arrays stored in output and restart files, which are
+// contiguous in (m,n,k,j,i) order (or (n,m,k,j,i) for outputs) for any FieldLayout
+template <typename T>
+using DvceIOArray5D = Kokkos::View<T *****, IOLayout, DevMemSpace>;
+template <typename T>
+using HostIOArray5D = Kokkos::View<T *****, IOLayout, HostMemSpace>;
+
+//----------------------------------------------------------------------------------------
+//! \fn void DeepCopyLayout()
+//! \brief Kokkos::deep_copy between Views in different memory spaces that may also have
+//! different layouts (e.g. a field and its IOLayout copy on the host).  With a common
+//! layout this is a single deep_copy, otherwise the data is remapped on the host.
+
+template <typename Dst, typename Src>
+void DeepCopyLayout(const Dst &dst, const Src &src) {
+  if constexpr (std::is_same_v<typename Dst::array_layout, typename Src::array_layout>) {
+    Kokkos::deep_copy(dst, src);
+  } else {
+    auto hdst = Kokkos::create_mirror_view(Kokkos::HostSpace(), dst);
+    auto hsrc = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), src);
+    Kokkos::deep_copy(hdst, hsrc);
+    Kokkos::deep_copy(dst, hdst);
+  }
+}
 
 // template declarations for construction of Kokkos::View in scratch memory
 template <typename T>
@@ -211,6 +327,33 @@ struct DvceEdgeFld4D {
   ~DvceEdgeFld4D() = default;
 };
 
+//----------------------------------------------------------------------------------------
+// execution space instance bound to the Task currently being executed.  With the default
+// (serial) TaskList scheduler nothing is bound and kernels are launched on the instance
+// passed by the caller.  The concurrent scheduler binds a separate instance (stream) to
+// each Task it dispatches, so that kernels from independent Tasks can overlap.  The
+// binding is thread_local, so it is only seen by the thread running the Task.  Every
+// kernel launch, deep_copy, and fence inside a Task must use TaskExecSpace() (or one of
+// the par_for wrappers, which select the bound instance) rather than DevExeSpace().
+
+namespace task_exec_space {
+inline const DevExeSpace *&Bound() {
+  static thread_local const DevExeSpace *pinstance = nullptr;
+  return pinstance;
+}
+inline void Bind(const DevExeSpace *pinstance) { Bound() = pinstance; }
+inline void Unbind() { Bound() = nullptr; }
+inline DevExeSpace Select(const DevExeSpace &requested) {
+  return (Bound() != nullptr) ? *Bound() : requested;
+}
+} // namespace task_exec_space
+
+// instance on which kernels and copies of the current Task are launched (the default
+// instance outside of Tasks, or with the serial scheduler)
+inline DevExeSpace TaskExecSpace() {
+  return task_exec_space::Select(DevExeSpace());
+}
+
 //----------------------------------------------------------------------------------------
 // wrappers for Kokkos::parallel_for
 // These wrappers implement a variety of parallel execution strategies, including
@@ -222,9 +365,10 @@ struct DvceEdgeFld4D {
 template <typename Function>
 inline void par_for(const std::string &name, DevExeSpace exec_space,
                     const int &il, const int &iu, const Function &function) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
   // compute total number of elements and call Kokkos::parallel_for()
   const int ni = iu - il + 1;
-  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, ni),
+  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_inst, 0, ni),
   KOKKOS_LAMBDA(const int &idx) {
     // compute i indices of thread and call function
     int i = (idx) + il;
@@ -238,11 +382,12 @@ template <typename Function>
 inline void par_for(const std::string &name, DevExeSpace exec_space,
                     const int &jl, const int &ju,
                     const int &il, const int &iu, const Function &function) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
   // compute total number of elements and call Kokkos::parallel_for()
   const int nj = ju - jl + 1;
   const int ni = iu - il + 1;
   const int nji  = nj * ni;
-  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, nji),
+  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_inst, 0, nji),
   KOKKOS_LAMBDA(const int &idx) {
     // compute j,i indices of thread and call function
     int j = (idx)/ni;
@@ -258,13 +403,14 @@ template <typename Function>
 inline void par_for(const std::string &name, DevExeSpace exec_space,
                     const int &kl, const int &ku, const int &jl, const int &ju,
                     const int &il, const int &iu, const Function &function) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
   // compute total number of elements and call Kokkos::parallel_for()
   const int nk = ku - kl + 1;
   const int nj = ju - jl + 1;
   const int ni = iu - il + 1;
   const int nkji = nk * nj * ni;
   const int nji  = nj * ni;
-  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, nkji),
+  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_inst, 0, nkji),
   KOKKOS_LAMBDA(const int &idx) {
     // compute k,j,i indices of thread and call function
     int k = (idx)/nji;
@@ -283,6 +429,7 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
                     const int &nl, const int &nu, const int &kl, const int &ku,
                     const int &jl, const int &ju, const int &il, const int &iu,
                     const Function &function) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
   // compute total number of elements and call Kokkos::parallel_for()
   const int nn = nu - nl + 1;
   const int nk = ku - kl + 1;
@@ -291,7 +438,7 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
   const int nnkji = nn * nk * nj * ni;
   const int nkji  = nk * nj * ni;
   const int nji   = nj * ni;
-  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, nnkji),
+  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_inst, 0, nnkji),
   KOKKOS_LAMBDA(const int &idx) {
     // compute n,k,j,i indices of thread and call function
     int n = (idx)/nkji;
@@ -313,6 +460,7 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
                     const int &nl, const int &nu, const int &kl, const int &ku,
                     const int &jl, const int &ju, const int &il, const int &iu,
                     const Function &function) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
   // compute total number of elements and call Kokkos::parallel_for()
   const int nm = mu - ml + 1;
   const int nn = nu - nl + 1;
@@ -323,7 +471,7 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
   const int nnkji  = nn * nk * nj * ni;
   const int nkji   = nk * nj * ni;
   const int nji    = nj * ni;
-  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, nmnkji),
+  Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_inst, 0, nmnkji),
   KOKKOS_LAMBDA(const int &idx) {
     // compute m,n,k,j,i indices of thread and call function
     int m = (idx)/nnkji;
@@ -339,19 +487,120 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
   });
 }
 
+//------------------------------
+// 4D loop using Kokkos 1D Range in the host execution space (threads with OpenMP).  Used
+// to fill host mirrors of arrays, e.g. in pgens that call CPU-only libraries.  The
+// function is an ordinary C++ lambda (not KOKKOS_LAMBDA), so may call host functions.
+template <typename Function>
+inline void par_for_host(const std::string &name,
+                         const int &ml, const int &mu, const int &kl, const int &ku,
+                         const int &jl, const int &ju, const int &il, const int &iu,
+                         const Function &function) {
+  // compute total number of elements and call Kokkos::parallel_for()
+  const int nm = mu - ml + 1;
+  const int nk = ku - kl + 1;
+  const int nj = ju - jl + 1;
+  const int ni = iu - il + 1;
+  const int nmkji = nm * nk * nj * ni;
+  const int nkji = nk * nj * ni;
+  const int nji  = nj * ni;
+  Kokkos::parallel_for(name, Kokkos::RangePolicy<HostExeSpace>(0, nmkji),
+  [=](const int &idx) {
+    // compute m,k,j,i indices of thread and call function
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/ni;
+    int i = (idx - m*nkji - k*nji - j*ni) + il;
+    m += ml;
+    k += kl;
+    j += jl;
+    function(m, k, j, i);
+  });
+}
+
+//----------------------------------------------------------------------------------------
+// Runtime tuning of the team size and vector length of the TeamPolicy used by
+// par_for_outer, enabled with <job>/autotune=true (see utils/team_tuner.cpp).  While a
+// kernel (identified by its label) is tuned, each launch uses one candidate size and is
+// timed between fences; afterwards the fastest candidate is used.  When not enabled,
+// Kokkos::AUTO is used without any timing.
+namespace team_tuner {
+struct TeamConfig {
+  int team_size = 0;        // 0 means Kokkos::AUTO (for both)
+  int vector_length = 1;
+};
+inline bool &Enabled() {
+  static bool enabled = false;
+  return enabled;
+}
+// set while kernels are captured in device graphs, which cannot be fenced
+inline bool &Paused() {
+  static bool paused = false;
+  return paused;
+}
+// returns configuration for next launch of kernel, and sets timed=true if the launch
+// must be timed and passed to Record()
+TeamConfig Select(const std::string &name, bool &timed);
+// records time of launch made with the configuration returned by Select(). Negative
+// time flags a configuration that cannot be launched for this kernel.
+void Record(const std::string &name, const double time);
+} // namespace team_tuner
+
+template <typename Lambda>
+inline void LaunchTeams(const std::string &name, const DevExeSpace &exec_space,
+                        const int league, size_t scr_size, const int scr_level,
+                        const Lambda &lambda) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
+  using Policy = Kokkos::TeamPolicy<>;
+  if (!(team_tuner::Enabled())) {
+    Policy policy(exec_inst, league, Kokkos::AUTO);
+    policy.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size));
+    Kokkos::parallel_for(name, policy, lambda);
+    return;
+  }
+  bool timed = false;
+  team_tuner::TeamConfig cfg = team_tuner::Select(name, timed);
+  if (cfg.team_size > 0) {
+    bool valid = (cfg.vector_length <= Policy::vector_length_max());
+    if (valid) {
+      Policy probe(exec_inst, league, Kokkos::AUTO, cfg.vector_length);
+      probe.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size));
+      valid = (cfg.team_size <= probe.team_size_max(lambda, Kokkos::ParallelForTag()));
+    }
+    if (!(valid)) {
+      if (timed) {team_tuner::Record(name, -1.0);}
+      cfg = team_tuner::TeamConfig();
+      timed = false;
+    }
+  }
+  Policy policy = (cfg.team_size > 0) ?
+      Policy(exec_inst, league, cfg.team_size, cfg.vector_length) :
+      Policy(exec_inst, league, Kokkos::AUTO);
+  policy.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size));
+  if (!(timed)) {
+    Kokkos::parallel_for(name, policy, lambda);
+    return;
+  }
+  exec_inst.fence();
+  Kokkos::Timer timer;
+  Kokkos::parallel_for(name, policy, lambda);
+  exec_inst.fence();
+  team_tuner::Record(name, timer.seconds());
+}
+
 //------------------------------------------
 // 1D outer parallel loop using Kokkos Teams
 template <typename Function>
 inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
                           size_t scr_size, const int scr_level,
                           const int kl, const int ku, const Function &function) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
   const int nk = ku - kl + 1;
-  Kokkos::TeamPolicy<> policy(exec_space, nk, Kokkos::AUTO);
-  Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
-  KOKKOS_LAMBDA(TeamMember_t tmember) {
+  auto kernel = KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int k = tmember.league_rank() + kl;
     function(tmember, k);
-  });
+  };
+  LaunchTeams(name, exec_inst, nk, scr_size, scr_level, kernel);
 }
 
 //------------------------------------------
@@ -361,16 +610,16 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
                           size_t scr_size, const int scr_level,
                           const int kl, const int ku, const int jl, const int ju,
                           const Function &function) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
   const int nk = ku - kl + 1;
   const int nj = ju - jl + 1;
   const int nkj = nk*nj;
-  Kokkos::TeamPolicy<> policy(exec_space, nkj, Kokkos::AUTO);
-  Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
-  KOKKOS_LAMBDA(TeamMember_t tmember) {
+  auto kernel = KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int k = tmember.league_rank()/nj + kl;
     const int j = tmember.league_rank()%nj + jl;
     function(tmember, k, j);
-  });
+  };
+  LaunchTeams(name, exec_inst, nkj, scr_size, scr_level, kernel);
 }
 
 //------------------------------------------
@@ -380,21 +629,21 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
                           size_t scr_size, const int scr_level,
                           const int nl, const int nu, const int kl, const int ku,
                           const int jl, const int ju, const Function &function) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
   const int nn = nu - nl + 1;
   const int nk = ku - kl + 1;
   const int nj = ju - jl + 1;
   const int nkj  = nk*nj;
   const int nnkj = nn*nk*nj;
-  Kokkos::TeamPolicy<> policy(exec_space, nnkj, Kokkos::AUTO);
-  Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
-  KOKKOS_LAMBDA(TeamMember_t tmember) {
+  auto kernel = KOKKOS_LAMBDA(TeamMember_t tmember) {
     int n = (tmember.league_rank())/nkj;
     int k = (tmember.league_rank() - n*nkj)/nj;
     int j = (tmember.league_rank() - n*nkj - k*nj) + jl;
     n += nl;
     k += kl;
     function(tmember, n, k, j);
-  });
+  };
+  LaunchTeams(name, exec_inst, nnkj, scr_size, scr_level, kernel);
 }
 
 //------------------------------------------
@@ -405,6 +654,7 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
                           const int ml, const int mu,
                           const int nl, const int nu, const int kl, const int ku,
                           const int jl, const int ju, const Function &function) {
+  const DevExeSpace exec_inst = task_exec_space::Select(exec_space);
   const int nm = mu - ml + 1;
   const int nn = nu - nl + 1;
   const int nk = ku - kl + 1;
@@ -412,9 +662,7 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
   const int nkj   = nk*nj;
   const int nnkj  = nn*nk*nj;
   const int nmnkj = nm*nn*nk*nj;
-  Kokkos::TeamPolicy<> policy(exec_space, nmnkj, Kokkos::AUTO);
-  Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
-  KOKKOS_LAMBDA(TeamMember_t tmember) {
+  auto kernel = KOKKOS_LAMBDA(TeamMember_t tmember) {
     int m = (tmember.league_rank())/nnkj;
     int n = (tmember.league_rank() - m*nnkj)/nkj;
     int k = (tmember.league_rank() - m*nnkj - n*nkj)/nj;
@@ -423,7 +671,8 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
     n += nl;
     k += kl;
     function(tmember, m, n, k, j);
-  });
+  };
+  LaunchTeams(name, exec_inst, nmnkj, scr_size, scr_level, kernel);
 }
 
 //---------------------------------------------
@@ -435,6 +684,37 @@ KOKKOS_INLINE_FUNCTION void par_for_inner(TeamMember_t tmember, const int il,con
   Kokkos::parallel_for(Kokkos::TeamVectorRange(tmember, il, iu+1), function);
 }
 
+//---------------------------------------------
+// 1D inner parallel loop explicitly vectorized on CPUs.  On GPUs this is identical to
+// par_for_inner.  On CPUs the range is split over the threads of the team (as with
+// TeamVectorRange), and each chunk is an "omp simd" loop, so that branches in the loop
+// body are vectorized with masks rather than left to the auto-vectorizer.  Iterations run
+// concurrently in SIMD lanes, so the function must not write any variable shared between
+// iterations (such as temporaries declared outside the lambda).
+#if HOST_SIMD_ENABLED && !defined(KOKKOS_ENABLE_CUDA) && !defined(KOKKOS_ENABLE_HIP) && \
+    !defined(KOKKOS_ENABLE_SYCL)
+#define ATHENA_HOST_SIMD 1
+#else
+#define ATHENA_HOST_SIMD 0
+#endif
+
+template <typename Function>
+KOKKOS_INLINE_FUNCTION void par_for_inner_simd(TeamMember_t tmember, const int il,
+                                               const int iu, const Function &function) {
+#if ATHENA_HOST_SIMD
+  const int nt = tmember.team_size();
+  const int chunk = (iu - il + nt)/nt;
+  const int ib = il + tmember.team_rank()*chunk;
+  const int ie = (ib + chunk - 1 < iu)? (ib + chunk - 1) : iu;
+#pragma omp simd
+  for (int i=ib; i<=ie; ++i) {
+    function(i);
+  }
+#else
+  Kokkos::parallel_for(Kokkos::TeamVectorRange(tmember, il, iu+1), function);
+#endif
+}
+
 #define NREDUCTION_VARIABLES 20
 //----------------------------------------------------------------------------------------
 //! \struct summed_array_type
@@ -11,6 +11,7 @@
 //  Convention: indices a,b,c,d are tensor indices. Indices n,i,j,k are grid indices.
 
 #include <cassert> // assert
+#include <type_traits>
 #include <utility>
 #include "athena.hpp"
 
@@ -355,6 +356,51 @@ constexpr int TensorDOF<TensorSymm::ISYM2, ndim, 4> = ndim*ndim*ndim*(ndim+1)/2;
 template<int ndim>
 constexpr int TensorDOF<TensorSymm::SYM22, ndim, 4> = ndim*ndim*(ndim+1)*(ndim+1)/4;
 
+//----------------------------------------------------------------------------------------
+//! \struct TensorIndex
+//! \brief constexpr maps from tensor indices to storage of AthenaPointTensor of rank 2
+//! and 3.  With compile-time indices (e.g. inside TensorFor) the map is folded away, so
+//! tensors are never indexed dynamically and can be kept in registers.
+template<TensorSymm sym, int ndim>
+struct TensorIndex {
+  // index of symmetric pair (a,b) = (b,a)
+  KOKKOS_INLINE_FUNCTION
+  static constexpr int Sym(int const a, int const b) {
+    return (b < a) ? b*(2*ndim - b + 1)/2 + a - b : a*(2*ndim - a + 1)/2 + b - a;
+  }
+  KOKKOS_INLINE_FUNCTION
+  static constexpr int Rank2(int const a, int const b) {
+    return (sym == TensorSymm::NONE) ? b + ndim*a : Sym(a, b);
+  }
+  KOKKOS_INLINE_FUNCTION
+  static constexpr int Rank3(int const a, int const b, int const c) {
+    constexpr int ndof2 = TensorDOF<TensorSymm::SYM2, ndim, 2>;
+    return (sym == TensorSymm::NONE) ? c + ndim*(b + ndim*a) :
+           (sym == TensorSymm::SYM2) ? Sym(b, c) + ndof2*a : c + ndim*Sym(a, b);
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void TensorFor
+//! \brief Calls f(a) for a = 0...N-1, where a is a std::integral_constant, so the loop
+//! is unrolled at compile time.  Nested TensorFor loops replace runtime loops over tensor
+//! indices in kernels, e.g.
+//!   TensorFor<3>([&](auto a) { TensorFor<3>([&](auto b) {
+//!     if constexpr (b >= a) {T_dd(a,b) = ...;}
+//!   });});
+
+template<typename F, int... I>
+KOKKOS_FORCEINLINE_FUNCTION
+void TensorForImpl(const F &f, std::integer_sequence<int, I...>) {
+  (f(std::integral_constant<int, I>{}), ...);
+}
+
+template<int N, typename F>
+KOKKOS_FORCEINLINE_FUNCTION
+void TensorFor(const F &f) {
+  TensorForImpl(f, std::make_integer_sequence<int, N>{});
+}
+
 
 //----------------------------------------------------------------------------------------
 // rank 2 AthenaPointTensor
@@ -371,29 +417,18 @@ class AthenaPointTensor<T, sym, ndim, 2> {
   (AthenaPointTensor<T, sym, ndim, 2> const &) = default;
   KOKKOS_INLINE_FUNCTION
   Real operator()(int const a, int const b) const {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[b + ndim*a];
-    } else if (sym == TensorSymm::SYM2) {
-      if (b < a) {
-        return data_[b*(2*ndim - b + 1)/2+a-b];
-      } else {
-        return data_[a*(2*ndim - a + 1)/2+b-a];
-      }
-    }
-    //return data_[idxmap_[a][b]];
+    return data_[TensorIndex<sym, ndim>::Rank2(a, b)];
   }
   KOKKOS_INLINE_FUNCTION
   Real & operator()(int const a, int const b) {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[b + ndim*a];
-    } else if (sym == TensorSymm::SYM2) {
-      if (b < a) {
-        return data_[b*(2*ndim - b + 1)/2+a-b];
-      } else {
-        return data_[a*(2*ndim - a + 1)/2+b-a];
-      }
-    }
-    //return data_[idxmap_[a][b]];
+    return data_[TensorIndex<sym, ndim>::Rank2(a, b)];
+  }
+  // access with compile-time indices
+  template<int a, int b>
+  KOKKOS_INLINE_FUNCTION
+  Real & get() {
+    constexpr int n = TensorIndex<sym, ndim>::Rank2(a, b);
+    return data_[n];
   }
   KOKKOS_INLINE_FUNCTION
   void ZeroClear() {
@@ -421,41 +456,18 @@ class AthenaPointTensor<T, sym, ndim, 3> {
   (AthenaPointTensor<T, sym, ndim, 3> const &) = default;
   KOKKOS_INLINE_FUNCTION
   Real operator()(int const a, int const b, int const c) const {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[c + ndim*(b + ndim*a)];
-    } else if (sym == TensorSymm::SYM2) {
-      constexpr int ndof2_ = TensorDOF<TensorSymm::SYM2, ndim, 2>;
-      if (c < b) {
-        return data_[c*(2*ndim - c + 1)/2 + b - c + ndof2_*a];
-      } else {
-        return data_[b*(2*ndim - b + 1)/2 + c - b + ndof2_*a];
-      }
-    } else if (sym == TensorSymm::ISYM2) {
-      if (b < a) {
-        return data_[c + ndim*(b*(2*ndim - b + 1)/2 + a - b)];
-      } else {
-        return data_[c + ndim*(a*(2*ndim - a + 1)/2 + b - a)];
-      }
-    }
+    return data_[TensorIndex<sym, ndim>::Rank3(a, b, c)];
   }
   KOKKOS_INLINE_FUNCTION
   Real & operator()(int const a, int const b, int const c) {
-    if constexpr (sym == TensorSymm::NONE) {
-      return data_[c + ndim*(b + ndim*a)];
-    } else if (sym == TensorSymm::SYM2) {
-      constexpr int ndof2_ = TensorDOF<TensorSymm::SYM2, ndim, 2>;
-      if (c < b) {
-        return data_[c*(2*ndim - c + 1)/2 + b - c + ndof2_*a];
-      } else {
-        return data_[b*(2*ndim - b + 1)/2 + c - b + ndof2_*a];
-      }
-    } else if (sym == TensorSymm::ISYM2) {
-      if (b < a) {
-        return data_[c + ndim*(b*(2*ndim - b + 1)/2 + a - b)];
-      } else {
-        return data_[c + ndim*(a*(2*ndim - a + 1)/2 + b - a)];
-      }
-    }
+    return data_[TensorIndex<sym, ndim>::Rank3(a, b, c)];
+  }
+  // access with compile-time indices
+  template<int a, int b, int c>
+  KOKKOS_INLINE_FUNCTION
+  Real & get() {
+    constexpr int n = TensorIndex<sym, ndim>::Rank3(a, b, c);
+    return data_[n];
   }
   KOKKOS_INLINE_FUNCTION
   void ZeroClear() {
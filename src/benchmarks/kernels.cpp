@@ -0,0 +1,318 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file kernels.cpp
+//! \brief Standalone microbenchmark of the Hydro and MHD flux kernels (reconstruction and
+//! Riemann solver) and of the conserved-to-primitive conversion, for every combination
+//! of physics, EOS, Riemann solver and reconstruction method that is compiled.
+//!
+//! Built as the athena_bench target when configured with -D Athena_BENCHMARKS=ON.  Each
+//! combination is set up exactly as in a run (Mesh, MeshBlockPack, Coordinates, and the
+//! Hydro or MHD module are constructed from a generated input), on a smooth state with
+//! all waves present.  The kernels are then timed over <bench>/niter calls, and the
+//! update rate (cells/s), effective bandwidth and flop rate are reported, using the
+//! theoretical cost per cell of each kernel in utils/roofline.hpp.  The bandwidth counts
+//! only compulsory memory traffic (each input read once, each output written once), so
+//! it is a lower bound that can be compared with the STREAM bandwidth of the device.
+//! With the peak bandwidth and flop rate of the device given (bench/peak_bandwidth in
+//! GB/s, bench/peak_gflops in GFLOP/s), the fraction of the roofline achieved is also
+//! reported.  Options are changed on the command line as for athena, e.g.
+//!   athena_bench bench/nx=128 bench/physics=mhd bench/recons=plm,wenoz
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "utils/roofline.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace {
+// default parameters, each can be changed on the command line with bench/par=value
+const char kBenchDefaults[] =
+  "<bench>\n"
+  "nx             = 64\n"                    // cells along each side of a MeshBlock
+  "nmb            = 1\n"                     // MeshBlocks per rank (along x1)
+  "niter          = 20\n"                    // calls of each kernel timed
+  "physics        = hydro,mhd\n"
+  "relativity     = newtonian\n"             // any of newtonian,sr,gr
+  "eos            = ideal,isothermal\n"
+  "hydro_rsolvers = llf,hlle,hllc,roe\n"
+  "mhd_rsolvers   = llf,hlle,hlld\n"
+  "recons         = dc,plm,ppm4,ppmx,wenoz\n"
+  "peak_bandwidth = 0.0\n"                   // GB/s of device (0: unknown)
+  "peak_gflops    = 0.0\n";                  // GFLOP/s of device (0: unknown)
+
+std::vector<std::string> SplitList(const std::string &list) {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    std::size_t first = item.find_first_not_of(" \t");
+    std::size_t last = item.find_last_not_of(" \t");
+    if (first != std::string::npos) {items.push_back(item.substr(first, last-first+1));}
+  }
+  return items;
+}
+
+// Returns true if the combination is implemented, and its flux kernel was compiled
+// (see Athena_FLUX_RECON and Athena_FLUX_EOS).  Combinations that are not would stop
+// the benchmark with a fatal error in the module constructors.
+bool Supported(const std::string &phys, const std::string &rel, const std::string &eos,
+               const std::string &rs, const std::string &recon) {
+  if (recon == "dc" && !(FLUX_RECON_DC_ENABLED)) return false;
+  if (recon == "plm" && !(FLUX_RECON_PLM_ENABLED)) return false;
+  if ((recon == "ppm4" || recon == "ppmx") && !(FLUX_RECON_PPM_ENABLED)) return false;
+  if (recon == "wenoz" && !(FLUX_RECON_WENOZ_ENABLED)) return false;
+  if (eos == "ideal" && !(FLUX_EOS_IDEAL_ENABLED)) return false;
+  if (eos == "isothermal" && !(FLUX_EOS_ISOTHERMAL_ENABLED)) return false;
+  if (eos != "ideal" && eos != "isothermal") return false;
+  if (rel != "newtonian" && eos != "ideal") return false;
+  if (rs == "llf" || rs == "hlle") return true;
+  if (rel == "gr") return false;
+  if (phys == "hydro") {
+    return ((rs == "hllc" && eos == "ideal") || (rs == "roe" && rel == "newtonian"));
+  }
+  return (rs == "hlld");
+}
+
+// input for one combination: periodic 3D mesh of nmb MeshBlocks of nx^3 cells per rank
+std::string BenchInput(const std::string &phys, const std::string &rel,
+                       const std::string &eos, const std::string &rs,
+                       const std::string &recon, int nx, int nmb) {
+  int ng = (recon == "dc" || recon == "plm")? 2 : 3;
+  std::stringstream in;
+  in << "<time>\nevolution = dynamic\nintegrator = rk2\ntlim = 1.0\n";
+  in << "<mesh>\nnghost = " << ng << "\n";
+  int nmb1 = nmb*global_variable::nranks;
+  in << "nx1 = " << nx*nmb1 << "\nx1min = 0.0\nx1max = " << nmb1 << ".0\n";
+  in << "ix1_bc = periodic\nox1_bc = periodic\n";
+  in << "nx2 = " << nx << "\nx2min = 0.0\nx2max = 1.0\n";
+  in << "ix2_bc = periodic\nox2_bc = periodic\n";
+  in << "nx3 = " << nx << "\nx3min = 0.0\nx3max = 1.0\n";
+  in << "ix3_bc = periodic\nox3_bc = periodic\n";
+  in << "<meshblock>\nnx1 = " << nx << "\nnx2 = " << nx << "\nnx3 = " << nx << "\n";
+  if (rel == "sr") {
+    in << "<coord>\nspecial_rel = true\n";
+  } else if (rel == "gr") {
+    in << "<coord>\ngeneral_rel = true\nminkowski = true\n";
+  }
+  in << "<" << phys << ">\neos = " << eos << "\nreconstruct = " << recon << "\n";
+  in << "rsolver = " << rs << "\ngamma = 1.6666666666666667\niso_sound_speed = 1.0\n";
+  return in.str();
+}
+
+// maximum over ranks of time taken by slowest rank
+double MaxOverRanks(double t) {
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  return t;
+}
+
+// prints one line of results: cells/s, GB/s and GFLOP/s over all ranks, fraction of
+// roofline (per rank), and time per call
+void Report(const std::string &label, const std::string &kernel, double time,
+            double ncells, const roofline::KernelCost &cost,
+            const roofline::MachinePeak &peak, int niter) {
+  double cells = ncells*static_cast<double>(global_variable::nranks)*niter;
+  double frac = roofline::RooflineFraction(cost, ncells*niter/time, peak);
+  if (global_variable::my_rank == 0) {
+    std::printf("%-40s %-6s %12.4e %10.2f %10.2f %8.3f %10.2f\n", label.c_str(),
+                kernel.c_str(), cells/time, 1.0e-9*cells*cost.bytes/time,
+                1.0e-9*cells*cost.flops/time, frac, 1.0e3*time/niter);
+  }
+}
+
+// Sets a smooth state (sound, shear and, with MHD, Alfven and magnetosonic waves in
+// all directions) in all cells including ghost zones, then the conserved variables.
+void SetState(MeshBlockPack *pmbp, bool mhd, bool ideal) {
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  int n1 = indcs.nx1 + 2*indcs.ng;
+  int n2 = indcs.nx2 + 2*indcs.ng;
+  int n3 = indcs.nx3 + 2*indcs.ng;
+  int nmb1 = pmbp->nmb_thispack - 1;
+  Real kx = 2.0*M_PI/static_cast<Real>(indcs.nx1);
+  auto &w0 = (mhd)? pmbp->pmhd->w0 : pmbp->phydro->w0;
+  par_for("bench_w0",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real x = kx*i, y = kx*j, z = kx*k;
+    w0(m,IDN,k,j,i) = 1.0 + 0.2*sin(x + y + z);
+    w0(m,IVX,k,j,i) = 0.2*sin(y + 2.0*z);
+    w0(m,IVY,k,j,i) = 0.2*sin(z + 2.0*x);
+    w0(m,IVZ,k,j,i) = 0.2*sin(x + 2.0*y);
+    if (ideal) {
+      w0(m,IEN,k,j,i) = 1.5*(1.0 + 0.1*cos(x - y + z));
+    }
+  });
+  if (!(mhd)) {
+    pmbp->phydro->peos->PrimToCons(w0, pmbp->phydro->u0, 0, (n1-1), 0, (n2-1), 0, (n3-1));
+    return;
+  }
+
+  // divergence-free field: each face component varies only transverse to it
+  auto &b0 = pmbp->pmhd->b0;
+  auto &bcc0 = pmbp->pmhd->bcc0;
+  par_for("bench_b0",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real x = kx*i, y = kx*j, z = kx*k;
+    b0.x1f(m,k,j,i) = 0.5 + 0.3*sin(y + z);
+    b0.x2f(m,k,j,i) = 0.3*sin(z + x);
+    b0.x3f(m,k,j,i) = 0.3*sin(x + y);
+    if (i == n1-1) {b0.x1f(m,k,j,i+1) = b0.x1f(m,k,j,i);}
+    if (j == n2-1) {b0.x2f(m,k,j+1,i) = b0.x2f(m,k,j,i);}
+    if (k == n3-1) {b0.x3f(m,k+1,j,i) = b0.x3f(m,k,j,i);}
+    bcc0(m,IBX,k,j,i) = b0.x1f(m,k,j,i);
+    bcc0(m,IBY,k,j,i) = b0.x2f(m,k,j,i);
+    bcc0(m,IBZ,k,j,i) = b0.x3f(m,k,j,i);
+  });
+  pmbp->pmhd->peos->PrimToCons(w0, bcc0, pmbp->pmhd->u0, 0, (n1-1), 0, (n2-1), 0,
+                               (n3-1));
+}
+
+// Constructs the Mesh for one combination, and times its flux and C2P kernels
+void RunCombination(const std::string &phys, const std::string &rel,
+                    const std::string &eos, const std::string &rs,
+                    const std::string &recon, int nx, int nmb, int niter,
+                    const roofline::MachinePeak &peak) {
+  bool mhd = (phys == "mhd");
+  bool ideal = (eos == "ideal");
+  ParameterInput *pin = new ParameterInput;
+  std::stringstream in(BenchInput(phys, rel, eos, rs, recon, nx, nmb));
+  pin->LoadFromStream(in);
+  Kokkos::Timer wall;
+  Mesh *pmesh = new Mesh(pin);
+  pmesh->BuildTreeFromScratch(pin);
+  pmesh->AddCoordinatesAndPhysics(pin);
+  Driver *pdriver = new Driver(pin, pmesh, -1.0, &wall);
+  MeshBlockPack *pmbp = pmesh->pmb_pack;
+  SetState(pmbp, mhd, ideal);
+
+  auto &indcs = pmesh->mb_indcs;
+  int n1 = indcs.nx1 + 2*indcs.ng;
+  int n2 = indcs.nx2 + 2*indcs.ng;
+  int n3 = indcs.nx3 + 2*indcs.ng;
+  double nmb_rank = static_cast<double>(pmbp->nmb_thispack);
+  double ncells = nmb_rank*indcs.nx1*indcs.nx2*indcs.nx3;
+  double ncells_c2p = nmb_rank*n1*n2*n3;
+  roofline::KernelCost flx_cost, c2p_cost;
+  if (mhd) {
+    auto *pm = pmbp->pmhd;
+    flx_cost = roofline::MHDFluxes(pm->recon_method, pm->rsolver_method, pm->nmhd);
+    c2p_cost = roofline::MHDConsToPrim(pm->rsolver_method, pm->nmhd);
+  } else {
+    auto *ph = pmbp->phydro;
+    flx_cost = roofline::HydroFluxes(ph->recon_method, ph->rsolver_method, ph->nhydro);
+    c2p_cost = roofline::HydroConsToPrim(ph->rsolver_method, ph->nhydro);
+  }
+
+  std::string label = phys + "/" + rel + "/" + eos + "/" + rs + "/" + recon;
+  Kokkos::Timer timer;
+  // fluxes (one untimed call first, so first-touch and kernel loading are excluded)
+  for (int n=0; n<=niter; ++n) {
+    if (n == 1) {Kokkos::fence(); timer.reset();}
+    if (mhd) {
+      pmbp->pmhd->Fluxes(pdriver, 1);
+    } else {
+      pmbp->phydro->Fluxes(pdriver, 1);
+    }
+  }
+  Kokkos::fence();
+  Report(label, "flux", MaxOverRanks(timer.seconds()), ncells, flx_cost, peak, niter);
+
+  // conserved-to-primitive.  The primitives recovered are those set initially, so every
+  // call does the same work.
+  for (int n=0; n<=niter; ++n) {
+    if (n == 1) {Kokkos::fence(); timer.reset();}
+    if (mhd) {
+      auto *pm = pmbp->pmhd;
+      pm->peos->ConsToPrim(pm->u0, pm->b0, pm->w0, pm->bcc0, false, 0, (n1-1), 0,
+                           (n2-1), 0, (n3-1));
+    } else {
+      auto *ph = pmbp->phydro;
+      ph->peos->ConsToPrim(ph->u0, ph->w0, false, 0, (n1-1), 0, (n2-1), 0, (n3-1));
+    }
+  }
+  Kokkos::fence();
+  Report(label, "c2p", MaxOverRanks(timer.seconds()), ncells_c2p, c2p_cost, peak,
+         niter);
+
+  delete pdriver;
+  delete pmesh;
+  delete pin;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn int main(int argc, char *argv[])
+//! \brief Athena kernel benchmark program
+
+int main(int argc, char *argv[]) {
+#if MPI_PARALLEL_ENABLED
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &(global_variable::my_rank));
+  MPI_Comm_size(MPI_COMM_WORLD, &(global_variable::nranks));
+#else
+  global_variable::my_rank = 0;
+  global_variable::nranks  = 1;
+#endif
+  Kokkos::initialize(argc, argv);
+  {
+    ParameterInput bench;
+    std::stringstream defaults(kBenchDefaults);
+    bench.LoadFromStream(defaults);
+    bench.ModifyFromCmdline(argc, argv);
+    int nx = bench.GetInteger("bench", "nx");
+    int nmb = bench.GetInteger("bench", "nmb");
+    int niter = bench.GetInteger("bench", "niter");
+    roofline::MachinePeak peak;
+    peak.bytes_per_s = 1.0e9*bench.GetReal("bench", "peak_bandwidth");
+    peak.flops_per_s = 1.0e9*bench.GetReal("bench", "peak_gflops");
+
+    if (global_variable::my_rank == 0) {
+      std::cout << "Kernel benchmark: " << nmb << " MeshBlock(s) of " << nx << "^3 cells"
+                << " on each of " << global_variable::nranks << " rank(s), " << niter
+                << " iterations" << std::endl;
+      std::printf("%-40s %-6s %12s %10s %10s %8s %10s\n",
+                  "physics/rel/eos/rsolver/recon", "kernel", "cells/s", "GB/s",
+                  "GFLOP/s", "roofline", "ms/call");
+    }
+    for (auto &phys : SplitList(bench.GetString("bench", "physics"))) {
+      auto rsolvers = SplitList(bench.GetString("bench", phys + "_rsolvers"));
+      for (auto &rel : SplitList(bench.GetString("bench", "relativity"))) {
+        for (auto &eos : SplitList(bench.GetString("bench", "eos"))) {
+          for (auto &rs : rsolvers) {
+            for (auto &recon : SplitList(bench.GetString("bench", "recons"))) {
+              if (Supported(phys, rel, eos, rs, recon)) {
+                RunCombination(phys, rel, eos, rs, recon, nx, nmb, niter, peak);
+              } else if (global_variable::my_rank == 0) {
+                std::cout << phys << "/" << rel << "/" << eos << "/" << rs << "/"
+                          << recon << " not supported, skipped" << std::endl;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  Kokkos::finalize();
+#if MPI_PARALLEL_ENABLED
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -31,6 +31,8 @@ void MeshBoundaryValuesFC::InitSendIndices(MeshBoundaryBuffer &buf,
   auto &mb_indcs  = pmy_pack->pmesh->mb_indcs;
   int ng  = mb_indcs.ng;
   int ng1 = ng - 1;
+  int ngs  = nghost_same;  // ghost layers exchanged with neighbors on same level
+  int ngs1 = ngs - 1;
 
   // set indices for sends to neighbors on SAME level
   // Formulae same as in LoadBoundaryBufferSameLevel() in src/bvals/fc/bvals_fc.cpp
@@ -42,39 +44,39 @@ void MeshBoundaryValuesFC::InitSendIndices(MeshBoundaryBuffer &buf,
       isame[1].bis = mb_indcs.is,           isame[1].bie = mb_indcs.ie;
       isame[2].bis = mb_indcs.is,           isame[2].bie = mb_indcs.ie;
     } else if (ox1 > 0) {
-      isame[0].bis = mb_indcs.ie - ng1,     isame[0].bie = mb_indcs.ie;
-      isame[1].bis = mb_indcs.ie - ng1,     isame[1].bie = mb_indcs.ie;
-      isame[2].bis = mb_indcs.ie - ng1,     isame[2].bie = mb_indcs.ie;
+      isame[0].bis = mb_indcs.ie - ngs1,     isame[0].bie = mb_indcs.ie;
+      isame[1].bis = mb_indcs.ie - ngs1,     isame[1].bie = mb_indcs.ie;
+      isame[2].bis = mb_indcs.ie - ngs1,     isame[2].bie = mb_indcs.ie;
     } else {
-      isame[0].bis = mb_indcs.is + 1,       isame[0].bie = mb_indcs.is + ng;
-      isame[1].bis = mb_indcs.is,           isame[1].bie = mb_indcs.is + ng1;
-      isame[2].bis = mb_indcs.is,           isame[2].bie = mb_indcs.is + ng1;
+      isame[0].bis = mb_indcs.is + 1,       isame[0].bie = mb_indcs.is + ngs;
+      isame[1].bis = mb_indcs.is,           isame[1].bie = mb_indcs.is + ngs1;
+      isame[2].bis = mb_indcs.is,           isame[2].bie = mb_indcs.is + ngs1;
     }
     if (ox2 == 0) {
       isame[0].bjs = mb_indcs.js,           isame[0].bje = mb_indcs.je;
       isame[1].bjs = mb_indcs.js,           isame[1].bje = mb_indcs.je + 1;
       isame[2].bjs = mb_indcs.js,           isame[2].bje = mb_indcs.je;
     } else if (ox2 > 0) {
-      isame[0].bjs = mb_indcs.je - ng1,     isame[0].bje = mb_indcs.je;
-      isame[1].bjs = mb_indcs.je - ng1,     isame[1].bje = mb_indcs.je;
-      isame[2].bjs = mb_indcs.je - ng1,     isame[2].bje = mb_indcs.je;
+      isame[0].bjs = mb_indcs.je - ngs1,     isame[0].bje = mb_indcs.je;
+      isame[1].bjs = mb_indcs.je - ngs1,     isame[1].bje = mb_indcs.je;
+      isame[2].bjs = mb_indcs.je - ngs1,     isame[2].bje = mb_indcs.je;
     } else {
-      isame[0].bjs = mb_indcs.js,           isame[0].bje = mb_indcs.js + ng1;
-      isame[1].bjs = mb_indcs.js + 1,       isame[1].bje = mb_indcs.js + ng;
-      isame[2].bjs = mb_indcs.js,           isame[2].bje = mb_indcs.js + ng1;
+      isame[0].bjs = mb_indcs.js,           isame[0].bje = mb_indcs.js + ngs1;
+      isame[1].bjs = mb_indcs.js + 1,       isame[1].bje = mb_indcs.js + ngs;
+      isame[2].bjs = mb_indcs.js,           isame[2].bje = mb_indcs.js + ngs1;
     }
     if (ox3 == 0) {
       isame[0].bks = mb_indcs.ks,           isame[0].bke = mb_indcs.ke;
       isame[1].bks = mb_indcs.ks,           isame[1].bke = mb_indcs.ke;
       isame[2].bks = mb_indcs.ks,           isame[2].bke = mb_indcs.ke + 1;
     } else if (ox3 > 0) {
-      isame[0].bks = mb_indcs.ke - ng1,     isame[0].bke = mb_indcs.ke;
-      isame[1].bks = mb_indcs.ke - ng1,     isame[1].bke = mb_indcs.ke;
-      isame[2].bks = mb_indcs.ke - ng1,     isame[2].bke = mb_indcs.ke;
+      isame[0].bks = mb_indcs.ke - ngs1,     isame[0].bke = mb_indcs.ke;
+      isame[1].bks = mb_indcs.ke - ngs1,     isame[1].bke = mb_indcs.ke;
+      isame[2].bks = mb_indcs.ke - ngs1,     isame[2].bke = mb_indcs.ke;
     } else {
-      isame[0].bks = mb_indcs.ks,           isame[0].bke = mb_indcs.ks + ng1;
-      isame[1].bks = mb_indcs.ks,           isame[1].bke = mb_indcs.ks + ng1;
-      isame[2].bks = mb_indcs.ks + 1,       isame[2].bke = mb_indcs.ks + ng;
+      isame[0].bks = mb_indcs.ks,           isame[0].bke = mb_indcs.ks + ngs1;
+      isame[1].bks = mb_indcs.ks,           isame[1].bke = mb_indcs.ks + ngs1;
+      isame[2].bks = mb_indcs.ks + 1,       isame[2].bke = mb_indcs.ks + ngs;
     }
     // for SMR/AMR, always include the overlapping faces in edge and corner boundaries
     // x1f component on x1-faces
@@ -389,6 +391,7 @@ void MeshBoundaryValuesFC::InitRecvIndices(MeshBoundaryBuffer &buf,
                                            int ox1, int ox2, int ox3, int f1, int f2) {
   auto &mb_indcs  = pmy_pack->pmesh->mb_indcs;
   int ng = mb_indcs.ng;
+  int ngs = nghost_same;  // ghost layers exchanged with neighbors on same level
 
   // set indices for receives from neighbors on SAME level
   // Formulae same as in SetBoundarySameLevel() in src/bvals/fc/bvals_fc.cpp
@@ -399,39 +402,39 @@ void MeshBoundaryValuesFC::InitRecvIndices(MeshBoundaryBuffer &buf,
       isame[1].bis = mb_indcs.is,         isame[1].bie = mb_indcs.ie;
       isame[2].bis = mb_indcs.is,         isame[2].bie = mb_indcs.ie;
     } else if (ox1 > 0) {
-      isame[0].bis = mb_indcs.ie + 2,     isame[0].bie = mb_indcs.ie + ng + 1;
-      isame[1].bis = mb_indcs.ie + 1,     isame[1].bie = mb_indcs.ie + ng;
-      isame[2].bis = mb_indcs.ie + 1,     isame[2].bie = mb_indcs.ie + ng;
+      isame[0].bis = mb_indcs.ie + 2,     isame[0].bie = mb_indcs.ie + ngs + 1;
+      isame[1].bis = mb_indcs.ie + 1,     isame[1].bie = mb_indcs.ie + ngs;
+      isame[2].bis = mb_indcs.ie + 1,     isame[2].bie = mb_indcs.ie + ngs;
     } else {
-      isame[0].bis = mb_indcs.is - ng,    isame[0].bie = mb_indcs.is - 1;
-      isame[1].bis = mb_indcs.is - ng,    isame[1].bie = mb_indcs.is - 1;
-      isame[2].bis = mb_indcs.is - ng,    isame[2].bie = mb_indcs.is - 1;
+      isame[0].bis = mb_indcs.is - ngs,    isame[0].bie = mb_indcs.is - 1;
+      isame[1].bis = mb_indcs.is - ngs,    isame[1].bie = mb_indcs.is - 1;
+      isame[2].bis = mb_indcs.is - ngs,    isame[2].bie = mb_indcs.is - 1;
     }
     if (ox2 == 0) {
       isame[0].bjs = mb_indcs.js,          isame[0].bje = mb_indcs.je;
       isame[1].bjs = mb_indcs.js,          isame[1].bje = mb_indcs.je + 1;
       isame[2].bjs = mb_indcs.js,          isame[2].bje = mb_indcs.je;
     } else if (ox2 > 0) {
-      isame[0].bjs = mb_indcs.je + 1,      isame[0].bje = mb_indcs.je + ng;
-      isame[1].bjs = mb_indcs.je + 2,      isame[1].bje = mb_indcs.je + ng + 1;
-      isame[2].bjs = mb_indcs.je + 1,      isame[2].bje = mb_indcs.je + ng;
+      isame[0].bjs = mb_indcs.je + 1,      isame[0].bje = mb_indcs.je + ngs;
+      isame[1].bjs = mb_indcs.je + 2,      isame[1].bje = mb_indcs.je + ngs + 1;
+      isame[2].bjs = mb_indcs.je + 1,      isame[2].bje = mb_indcs.je + ngs;
     } else {
-      isame[0].bjs = mb_indcs.js - ng,     isame[0].bje = mb_indcs.js - 1;
-      isame[1].bjs = mb_indcs.js - ng,     isame[1].bje = mb_indcs.js - 1;
-      isame[2].bjs = mb_indcs.js - ng,     isame[2].bje = mb_indcs.js - 1;
+      isame[0].bjs = mb_indcs.js - ngs,     isame[0].bje = mb_indcs.js - 1;
+      isame[1].bjs = mb_indcs.js - ngs,     isame[1].bje = mb_indcs.js - 1;
+      isame[2].bjs = mb_indcs.js - ngs,     isame[2].bje = mb_indcs.js - 1;
     }
     if (ox3 == 0) {
       isame[0].bks = mb_indcs.ks,          isame[0].bke = mb_indcs.ke;
       isame[1].bks = mb_indcs.ks,          isame[1].bke = mb_indcs.ke;
       isame[2].bks = mb_indcs.ks,          isame[2].bke = mb_indcs.ke + 1;
     } else if (ox3 > 0) {
-      isame[0].bks = mb_indcs.ke + 1,      isame[0].bke = mb_indcs.ke + ng;
-      isame[1].bks = mb_indcs.ke + 1,      isame[1].bke = mb_indcs.ke + ng;
-      isame[2].bks = mb_indcs.ke + 2,      isame[2].bke = mb_indcs.ke + ng + 1;
+      isame[0].bks = mb_indcs.ke + 1,      isame[0].bke = mb_indcs.ke + ngs;
+      isame[1].bks = mb_indcs.ke + 1,      isame[1].bke = mb_indcs.ke + ngs;
+      isame[2].bks = mb_indcs.ke + 2,      isame[2].bke = mb_indcs.ke + ngs + 1;
     } else {
-      isame[0].bks = mb_indcs.ks - ng,     isame[0].bke = mb_indcs.ks - 1;
-      isame[1].bks = mb_indcs.ks - ng,     isame[1].bke = mb_indcs.ks - 1;
-      isame[2].bks = mb_indcs.ks - ng,     isame[2].bke = mb_indcs.ks - 1;
+      isame[0].bks = mb_indcs.ks - ngs,     isame[0].bke = mb_indcs.ks - 1;
+      isame[1].bks = mb_indcs.ks - ngs,     isame[1].bke = mb_indcs.ks - 1;
+      isame[2].bks = mb_indcs.ks - ngs,     isame[2].bke = mb_indcs.ks - 1;
     }
     // for SMR/AMR, always include the overlapping faces in edge and corner boundaries
     // x1f component on x1-faces
@@ -10,7 +10,10 @@
 #include <cstdlib>
 #include <iostream>
 #include <utility>
-#include <algorithm> // max
+#include <algorithm> // max, sort
+#include <array>
+#include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -28,7 +31,29 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
   is_z4c_(z4c),
   u_in("uin",1,1),
   b_in("bin",1,1),
-  i_in("iin",1,1) {
+  i_in("iin",1,1),
+  nghost_same(pp->pmesh->mb_indcs.ng),
+  reduced_msgs(false),
+  aggregate_msgs(false),
+  persistent_reqs(false),
+  gpu_aware_mpi(true),
+  agg_version(-1),
+  agg_nvar(0),
+  agg_stotal(0),
+  agg_rtotal(0),
+  agg_soffset("agg_soff",1,1),
+  agg_roffset("agg_roff",1,1),
+  agg_sbuf("agg_sbuf",1),
+  agg_rbuf("agg_rbuf",1),
+  shm_exchange(false),
+  aflx_version(-1),
+  aflx_nvar(0),
+  aflx_stotal(0),
+  aflx_rtotal(0),
+  aflx_soffset("aflx_soff",1,1),
+  aflx_roffset("aflx_roff",1,1),
+  aflx_sbuf("aflx_sbuf",1),
+  aflx_rbuf("aflx_rbuf",1) {
   // allocate vector of status flags and MPI requests (if needed)
   int nnghbr = pmy_pack->pmb->nnghbr;
 
@@ -69,6 +94,12 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
   // create unique communicators for variables and fluxes in this BoundaryValues object
   MPI_Comm_dup(MPI_COMM_WORLD, &comm_vars);
   MPI_Comm_dup(MPI_COMM_WORLD, &comm_flux);
+  comm_node = MPI_COMM_NULL;
+  shm_win = MPI_WIN_NULL;
+  shm_rhdr = nullptr;
+  shm_rdata = nullptr;
+  shm_sseq = 0;
+  shm_rseq = 0;
 #endif
 }
 
@@ -84,9 +115,75 @@ MeshBoundaryValues::~MeshBoundaryValues() {
     delete [] recvbuf[n].vars_req;
     delete [] recvbuf[n].flux_req;
   }
+  for (auto &req : agg_sreq) {
+    if (req != MPI_REQUEST_NULL) {MPI_Request_free(&req);}
+  }
+  for (auto &req : agg_rreq) {
+    if (req != MPI_REQUEST_NULL) {MPI_Request_free(&req);}
+  }
+  for (auto &req : aflx_sreq) {
+    if (req != MPI_REQUEST_NULL) {MPI_Request_free(&req);}
+  }
+  for (auto &req : aflx_rreq) {
+    if (req != MPI_REQUEST_NULL) {MPI_Request_free(&req);}
+  }
+  FreeSharedMessages();
+  if (comm_node != MPI_COMM_NULL) {MPI_Comm_free(&comm_node);}
 #endif
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::SetSameLevelGhosts
+//! \brief set number of ghost cells exchanged with neighbors at the same level from
+//! <block>/nghost_exchange.  Exchanging fewer than nghost cells reduces message sizes
+//! when the reconstruction stencil is narrower than the ghost zones.  Must be called
+//! before InitializeBuffers().  Buffers for SMR/AMR and shearing box always use nghost,
+//! since prolongation and remapping require the full depth.
+
+void MeshBoundaryValues::SetSameLevelGhosts(ParameterInput *pin,
+                                            const std::string &block) {
+  int ng = pmy_pack->pmesh->mb_indcs.ng;
+  nghost_same = pin->GetOrAddInteger(block, "nghost_exchange", ng);
+  if (nghost_same < 1 || nghost_same > ng) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<" << block << ">/nghost_exchange=" << nghost_same
+              << " must be between 1 and <mesh>/nghost=" << ng << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (nghost_same < ng &&
+      (pmy_pack->pmesh->multilevel || pin->DoesBlockExist("shearing_box"))) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<" << block << ">/nghost_exchange < <mesh>/nghost "
+              << "cannot be used with SMR/AMR or shearing box" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::SetReducedPrecision
+//! \brief sets from <block>/reduced_precision_bvals whether variables sent between
+//! MeshBlocks at different levels on different ranks are stored in ReducedReal, which
+//! halves the size of these messages in double precision.  Fluxes on faces between levels
+//! are made consistent by flux correction (in Real), so conservation is unaffected, but
+//! the ghost zones are only accurate to ReducedReal.  Must be called before
+//! InitializeBuffers().  Not available for Z4c (whose prolongation uses data at the same
+//! level) or with aggregated messages, which mix data at all levels.
+
+void MeshBoundaryValues::SetReducedPrecision(ParameterInput *pin,
+                                             const std::string &block) {
+  reduced_msgs = pin->GetOrAddBoolean(block, "reduced_precision_bvals", false);
+  if (reduced_msgs && (is_z4c_ || aggregate_msgs)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<" << block << ">/reduced_precision_bvals cannot be used "
+              << "with Z4c or with aggregated messages" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // only messages between ranks of a multilevel mesh are affected
+  if (global_variable::nranks == 1 || !(pmy_pack->pmesh->multilevel)) {
+    reduced_msgs = false;
+  }
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBoundaryValues::InitializeBuffers
 //! \brief initialize each element of send/recv MeshBoundaryBuffers fixed-length arrays
@@ -218,6 +315,245 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
     }
   }
 
+  // reduced-precision storage of messages between levels, for buffers in use
+  if (reduced_msgs) {
+    for (int n=0; n<56; ++n) {
+      if (sendbuf[n].vars.extent_int(1) > 0) {
+        sendbuf[n].AllocateReducedBuffers(nmb, nvar);
+        recvbuf[n].AllocateReducedBuffers(nmb, nvar);
+      }
+    }
+  }
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::SetAggregatedMessages
+//! \brief With aggregated messages, builds the list of neighboring ranks, and the offset
+//! of every buffer sent to (or received from) another rank within the single contiguous
+//! message for that rank.  Sender and receiver must agree on the order of buffers within
+//! a message, so both sort them by (gid, buffer index) of the *receiving* MeshBlock.
+//! Message buffers (and persistent requests, if used) are sized for nvar variables.
+//! Only rebuilt when the neighbors of MeshBlocks change (e.g. with AMR), or nvar changes.
+//! Device arrays are only reallocated when they must grow, so that frequent regridding
+//! reuses the existing allocations.
+
+void MeshBoundaryValues::SetAggregatedMessages(const int nvar) {
+#if MPI_PARALLEL_ENABLED
+  if (agg_version == pmy_pack->pmesh->nghbr_version && agg_nvar == nvar) return;
+  if (agg_version != pmy_pack->pmesh->nghbr_version) {
+    int nmb = pmy_pack->nmb_thispack;
+    int nnghbr = pmy_pack->pmb->nnghbr;
+    auto &nghbr = pmy_pack->pmb->nghbr;
+    auto &mblev = pmy_pack->pmb->mb_lev;
+    int gids = pmy_pack->gids;
+
+    // number of data elements per variable in buffer n of MB m (same for send and recv)
+    auto ndat = [&](MeshBoundaryBuffer *buf, int m, int n) {
+      if (nghbr.h_view(m,n).lev < mblev.h_view(m)) {
+        return buf[n].icoar_ndat;
+      } else if (nghbr.h_view(m,n).lev == mblev.h_view(m)) {
+        return (is_z4c_) ? buf[n].isame_z4c_ndat : buf[n].isame_ndat;
+      }
+      return buf[n].ifine_ndat;
+    };
+
+    // collect (rank, gid, buffer index) of receiving MB, and (m,n) of every buffer
+    std::vector<std::array<int,5>> sends, recvs;
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if (nghbr.h_view(m,n).gid >= 0 &&
+            nghbr.h_view(m,n).rank != global_variable::my_rank) {
+          int drank = nghbr.h_view(m,n).rank;
+          sends.push_back({drank, nghbr.h_view(m,n).gid, nghbr.h_view(m,n).dest, m, n});
+          recvs.push_back({drank, gids + m, n, m, n});
+        }
+      }
+    }
+    std::sort(sends.begin(), sends.end());
+    std::sort(recvs.begin(), recvs.end());
+
+    if (agg_soffset.extent_int(0) < nmb || agg_soffset.extent_int(1) != nnghbr) {
+      int nmbmax = std::max(nmb, pmy_pack->pmesh->nmb_maxperrank);
+      Kokkos::realloc(agg_soffset, nmbmax, nnghbr);
+      Kokkos::realloc(agg_roffset, nmbmax, nnghbr);
+    }
+    Kokkos::deep_copy(agg_soffset.h_view, -1);
+    Kokkos::deep_copy(agg_roffset.h_view, -1);
+    agg_ranks.clear();
+    agg_sstart.clear();
+    agg_ssize.clear();
+    agg_rstart.clear();
+    agg_rsize.clear();
+
+    // messages in both directions are between the same pairs of ranks
+    agg_stotal = 0;
+    for (auto &it : sends) {
+      if (agg_ranks.empty() || agg_ranks.back() != it[0]) {
+        agg_ranks.push_back(it[0]);
+        agg_sstart.push_back(agg_stotal);
+        agg_ssize.push_back(0);
+      }
+      agg_soffset.h_view(it[3],it[4]) = agg_stotal;
+      int nd = ndat(sendbuf, it[3], it[4]);
+      agg_ssize.back() += nd;
+      agg_stotal += nd;
+    }
+    agg_rtotal = 0;
+    for (auto &it : recvs) {
+      if (agg_rstart.size() == 0 || it[0] != agg_ranks[agg_rstart.size()-1]) {
+        agg_rstart.push_back(agg_rtotal);
+        agg_rsize.push_back(0);
+      }
+      agg_roffset.h_view(it[3],it[4]) = agg_rtotal;
+      int nd = ndat(recvbuf, it[3], it[4]);
+      agg_rsize.back() += nd;
+      agg_rtotal += nd;
+    }
+    agg_soffset.template modify<HostMemSpace>();
+    agg_soffset.template sync<DevExeSpace>();
+    agg_roffset.template modify<HostMemSpace>();
+    agg_roffset.template sync<DevExeSpace>();
+    agg_version = pmy_pack->pmesh->nghbr_version;
+  }
+
+  // (re)allocate messages, and (re)create persistent requests.  Any previous requests
+  // have completed, since this function is only called at the start of communications.
+  for (auto &req : agg_sreq) {
+    if (req != MPI_REQUEST_NULL) {MPI_Request_free(&req);}
+  }
+  for (auto &req : agg_rreq) {
+    if (req != MPI_REQUEST_NULL) {MPI_Request_free(&req);}
+  }
+  if (agg_sbuf.extent_int(0) < nvar*agg_stotal) {
+    Kokkos::realloc(agg_sbuf, nvar*agg_stotal);
+  }
+  if (agg_rbuf.extent_int(0) < nvar*agg_rtotal) {
+    Kokkos::realloc(agg_rbuf, nvar*agg_rtotal);
+  }
+  agg_sreq.assign(agg_ranks.size(), MPI_REQUEST_NULL);
+  agg_rreq.assign(agg_ranks.size(), MPI_REQUEST_NULL);
+  if (persistent_reqs) {
+    Real *sptr = (gpu_aware_mpi) ? agg_sbuf.d_view.data() : agg_sbuf.h_view.data();
+    Real *rptr = (gpu_aware_mpi) ? agg_rbuf.d_view.data() : agg_rbuf.h_view.data();
+    bool no_errors=true;
+    for (std::size_t r=0; r<agg_ranks.size(); ++r) {
+      int ierr = MPI_Send_init(sptr + nvar*agg_sstart[r], nvar*agg_ssize[r],
+                               MPI_ATHENA_REAL, agg_ranks[r], 0, comm_vars,
+                               &(agg_sreq[r]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+      ierr = MPI_Recv_init(rptr + nvar*agg_rstart[r], nvar*agg_rsize[r],
+                           MPI_ATHENA_REAL, agg_ranks[r], 0,
+                           comm_vars, &(agg_rreq[r]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+    if (!(no_errors)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "MPI error in creating persistent requests" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  agg_nvar = nvar;
+  if (shm_exchange) {SetSharedMessages(nvar);}
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::SetAggregatedFluxMessages
+//! \brief With aggregated messages, builds the lists of ranks to which restricted fluxes
+//! are sent (coarser neighbors) and from which they are received (finer neighbors) in
+//! the flux-correction step, and the offset of every flux buffer within the single
+//! message exchanged with each rank.  Buffers are ordered as in SetAggregatedMessages()
+//! by (gid, buffer index) of the *receiving* MeshBlock.  Only rebuilt when neighbors
+//! change, or nvar changes.
+
+void MeshBoundaryValues::SetAggregatedFluxMessages(const int nvar) {
+#if MPI_PARALLEL_ENABLED
+  if (aflx_version == pmy_pack->pmesh->nghbr_version && aflx_nvar == nvar) return;
+  // any previous messages have completed, since this function is only called at the
+  // start of communications
+  if (aflx_version != pmy_pack->pmesh->nghbr_version) {
+    int nmb = pmy_pack->nmb_thispack;
+    int nnghbr = pmy_pack->pmb->nnghbr;
+    auto &nghbr = pmy_pack->pmb->nghbr;
+    auto &mblev = pmy_pack->pmb->mb_lev;
+    int gids = pmy_pack->gids;
+
+    // collect (rank, gid, buffer index) of receiving MB, and (m,n) of every flux buffer
+    // on faces exchanged with another rank
+    std::vector<std::array<int,5>> sends, recvs;
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if ((nghbr.h_view(m,n).gid >= 0) &&
+            (nghbr.h_view(m,n).rank != global_variable::my_rank) &&
+            ((n<16) || ((n>=24) && (n<32)))) {
+          int drank = nghbr.h_view(m,n).rank;
+          if (nghbr.h_view(m,n).lev < mblev.h_view(m)) {
+            sends.push_back({drank, nghbr.h_view(m,n).gid, nghbr.h_view(m,n).dest, m, n});
+          } else if (nghbr.h_view(m,n).lev > mblev.h_view(m)) {
+            recvs.push_back({drank, gids + m, n, m, n});
+          }
+        }
+      }
+    }
+    std::sort(sends.begin(), sends.end());
+    std::sort(recvs.begin(), recvs.end());
+
+    if (aflx_soffset.extent_int(0) < nmb || aflx_soffset.extent_int(1) != nnghbr) {
+      int nmbmax = std::max(nmb, pmy_pack->pmesh->nmb_maxperrank);
+      Kokkos::realloc(aflx_soffset, nmbmax, nnghbr);
+      Kokkos::realloc(aflx_roffset, nmbmax, nnghbr);
+    }
+    Kokkos::deep_copy(aflx_soffset.h_view, -1);
+    Kokkos::deep_copy(aflx_roffset.h_view, -1);
+    aflx_sranks.clear();
+    aflx_sstart.clear();
+    aflx_ssize.clear();
+    aflx_rranks.clear();
+    aflx_rstart.clear();
+    aflx_rsize.clear();
+
+    aflx_stotal = 0;
+    for (auto &it : sends) {
+      if (aflx_sranks.empty() || aflx_sranks.back() != it[0]) {
+        aflx_sranks.push_back(it[0]);
+        aflx_sstart.push_back(aflx_stotal);
+        aflx_ssize.push_back(0);
+      }
+      aflx_soffset.h_view(it[3],it[4]) = aflx_stotal;
+      aflx_ssize.back() += sendbuf[it[4]].iflxc_ndat;
+      aflx_stotal += sendbuf[it[4]].iflxc_ndat;
+    }
+    aflx_rtotal = 0;
+    for (auto &it : recvs) {
+      if (aflx_rranks.empty() || aflx_rranks.back() != it[0]) {
+        aflx_rranks.push_back(it[0]);
+        aflx_rstart.push_back(aflx_rtotal);
+        aflx_rsize.push_back(0);
+      }
+      aflx_roffset.h_view(it[3],it[4]) = aflx_rtotal;
+      aflx_rsize.back() += recvbuf[it[4]].iflxc_ndat;
+      aflx_rtotal += recvbuf[it[4]].iflxc_ndat;
+    }
+    aflx_soffset.template modify<HostMemSpace>();
+    aflx_soffset.template sync<DevExeSpace>();
+    aflx_roffset.template modify<HostMemSpace>();
+    aflx_roffset.template sync<DevExeSpace>();
+    aflx_version = pmy_pack->pmesh->nghbr_version;
+  }
+
+  if (aflx_sbuf.extent_int(0) < nvar*aflx_stotal) {
+    Kokkos::realloc(aflx_sbuf, nvar*aflx_stotal);
+  }
+  if (aflx_rbuf.extent_int(0) < nvar*aflx_rtotal) {
+    Kokkos::realloc(aflx_rbuf, nvar*aflx_rtotal);
+  }
+  aflx_sreq.assign(aflx_sranks.size(), MPI_REQUEST_NULL);
+  aflx_rreq.assign(aflx_rranks.size(), MPI_REQUEST_NULL);
+  aflx_nvar = nvar;
+#endif
   return;
 }
 
@@ -227,22 +563,22 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
 particles::ParticlesBoundaryValues::ParticlesBoundaryValues(
   particles::Particles *pp, ParameterInput *pin) :
     sendlist("sendlist",1),
+    prtcl_dest("prtcl_dest",1),
 #if MPI_PARALLEL_ENABLED
     prtcl_rsendbuf("rsend",1),
     prtcl_rrecvbuf("rrecv",1),
     prtcl_isendbuf("isend",1),
     prtcl_irecvbuf("irecv",1),
+    d_nghbr_ranks("d_nghbr_ranks",1),
+    send_order("send_order",1),
+    send_keys("send_keys",1),
+    send_counts("send_counts",1),
 #endif
     pmy_part(pp) {
 #if MPI_PARALLEL_ENABLED
-  // Guess that no more than 10% of particles will be communicated to set size of buffer
-  int npart = pmy_part->nprtcl_thispack;
-
-  //resize vectors over number of ranks
-  nsends_eachrank.resize(global_variable::nranks);
-
-  // create unique communicator for particles
+  // create unique communicator for particles, and graph communicator for counts
   MPI_Comm_dup(MPI_COMM_WORLD, &mpi_comm_part);
+  SetNeighborRanks();
 #endif
 }
 
@@ -250,4 +586,32 @@ particles::ParticlesBoundaryValues::ParticlesBoundaryValues(
 // destructor
 
 particles::ParticlesBoundaryValues::~ParticlesBoundaryValues() {
+#if MPI_PARALLEL_ENABLED
+  if (mpi_comm_nghbr != MPI_COMM_NULL) {MPI_Comm_free(&mpi_comm_nghbr);}
+#endif
+}
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::AddRecvRequests()
+//! \brief Appends pointers to the requests of all receives (of variables and fluxes)
+//! that may be posted by this object, so the Driver can block until one of them
+//! completes.  Requests that are not active are MPI_REQUEST_NULL (or inactive persistent
+//! requests), and are ignored by MPI_Waitsome.
+
+void MeshBoundaryValues::AddRecvRequests(std::vector<MPI_Request*> &reqs) {
+  if (aggregate_msgs) {
+    for (auto &req : agg_rreq) {reqs.push_back(&req);}
+    for (auto &req : aflx_rreq) {reqs.push_back(&req);}
+  }
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  for (int n=0; n<nnghbr; ++n) {
+    for (int m=0; m<nmb; ++m) {
+      reqs.push_back(&(recvbuf[n].vars_req[m]));
+      reqs.push_back(&(recvbuf[n].flux_req[m]));
+    }
+  }
+  return;
 }
+#endif
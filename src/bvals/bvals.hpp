@@ -20,6 +20,8 @@ enum class BoundaryFlag {undef=-1,block, reflect, inflow, outflow, diode, user,
                          shear_periodic, vacuum};
 
 #include <algorithm>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include "athena.hpp"
@@ -28,6 +30,13 @@ enum class BoundaryFlag {undef=-1,block, reflect, inflow, outflow, diode, user,
 #include "tasklist/task_list.hpp"
 //#include "particles/particles.hpp"
 
+// storage type of reduced-precision messages between MeshBlocks at different levels on
+// different ranks (see MeshBoundaryValues::SetReducedPrecision)
+using ReducedReal = float;
+#if MPI_PARALLEL_ENABLED
+#define MPI_ATHENA_REDUCED_REAL MPI_FLOAT
+#endif
+
 // Forward declarations
 class MeshBlockPack;
 namespace particles {
@@ -77,6 +86,9 @@ struct MeshBoundaryBuffer {
 
   // 2D Views that store buffer data on device, dimensioned (nmb, ndata)
   DvceArray2D<Real> vars, flux;
+  // reduced-precision storage of vars sent to/received from other ranks at other levels,
+  // only allocated when requested by the physics module
+  DvceArray2D<ReducedReal> vars_lo;
 
 #if MPI_PARALLEL_ENABLED
   // vectors of length (number of MBs) to hold MPI requests
@@ -98,10 +110,29 @@ struct MeshBoundaryBuffer {
     int nmax = std::max(iflxs_ndat, iflxc_ndat);
     Kokkos::realloc(flux, nmb, (nvars*nmax));
   }
+  void AllocateReducedBuffers(int nmb, int nvars) {
+    int nmax = std::max(icoar_ndat, ifine_ndat);
+    Kokkos::realloc(vars_lo, nmb, (nvars*nmax));
+  }
+};
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \struct ShmMessageHeader
+//! \brief header in the shared-memory receive window of a rank, describing the message
+//! from one other rank on the same node.  The sender sets seq once the message has been
+//! copied into the window, and the receiver sets ack once it has copied it out.
+
+struct ShmMessageHeader {
+  int64_t offset;           // offset of message within data of the window
+  volatile int64_t seq;     // sequence number of last message written by sender
+  volatile int64_t ack;     // sequence number of last message read by receiver
 };
+#endif
 
 // Forward declarations
 class MeshBlockPack;
+class MeshBoundaryMessageGroup;
 
 //----------------------------------------------------------------------------------------
 //! \class MeshBoundaryValues
@@ -120,15 +151,84 @@ class MeshBoundaryValues {
   // constant inflow states at each face, initialized in problem generator
   DualArray2D<Real> u_in, b_in, i_in;
 
+  // number of ghost cells exchanged with neighbors at the same level.  Defaults to
+  // <mesh>/nghost, but may be smaller when the reconstruction stencil needs fewer cells.
+  int nghost_same;
+
+  // send variables to (and receive from) MeshBlocks at different levels on other ranks
+  // in ReducedReal.  Data at the same level, data copied within a rank, and fluxes are
+  // always Real, so the result is conservative (fluxes at level boundaries are replaced
+  // in flux correction).  Only used with individual (not aggregated) messages.
+  bool reduced_msgs;
+
 #if MPI_PARALLEL_ENABLED
   // unique MPI communicators for each case (variables/fluxes)
   MPI_Comm comm_vars, comm_flux;
 #endif
 
+  // data for aggregated messages, in which all buffers of variables sent from this rank
+  // to another rank are packed into one contiguous message.  Only used for CC variables.
+  // Sizes and offsets are in units of data elements per variable.
+  // Aggregated messages may be posted with persistent requests, and may be staged
+  // through host memory when MPI library cannot access device memory.
+  bool aggregate_msgs;
+  bool persistent_reqs;               // use MPI_Send_init/MPI_Recv_init + MPI_Startall
+  bool gpu_aware_mpi;                 // pass device pointers directly to MPI
+  int agg_version;                    // Mesh::nghbr_version when data below was built
+  int agg_nvar;                       // number of variables messages were built for
+  std::vector<int> agg_ranks;         // neighboring ranks
+  std::vector<int> agg_sstart, agg_ssize, agg_rstart, agg_rsize;  // [agg_ranks.size()]
+  int agg_stotal, agg_rtotal;         // total size of data sent/received
+  DualArray2D<int> agg_soffset, agg_roffset;  // offset of buffer (m,n) in messages
+  DualArray1D<Real> agg_sbuf, agg_rbuf;   // contiguous send/recv messages
+#if MPI_PARALLEL_ENABLED
+  std::vector<MPI_Request> agg_sreq, agg_rreq;  // [agg_ranks.size()]
+#endif
+  // With shared_memory_exchange, aggregated messages to ranks on the same node bypass
+  // MPI.  They are copied directly into a receive window of the neighbor allocated with
+  // MPI_Win_allocate_shared, and signalled with sequence numbers in the window header.
+  bool shm_exchange;
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm comm_node;                      // ranks sharing memory with this rank
+  MPI_Win shm_win;                         // receive window of this rank
+  std::vector<int> shm_nrank;              // rank of agg_ranks in comm_node (or -1)
+  std::vector<ShmMessageHeader*> shm_shdr; // headers of sends in receivers' windows
+  std::vector<Real*> shm_sdata;        // destination of sends in receivers' windows
+  ShmMessageHeader *shm_rhdr;              // headers of receives in own window
+  Real *shm_rdata;                     // data of receives in own window
+  int64_t shm_sseq, shm_rseq;              // sequence numbers of last send/receive
+#endif
+  // data for aggregated messages of restricted fluxes for the flux-correction step, used
+  // whenever messages of variables are aggregated.  Fluxes are sent to coarser neighbors
+  // and received from finer neighbors, so ranks differ for sends and receives.
+  int aflx_version;                   // Mesh::nghbr_version when data below was built
+  int aflx_nvar;                      // number of variables messages were built for
+  std::vector<int> aflx_sranks, aflx_rranks;    // neighboring ranks
+  std::vector<int> aflx_sstart, aflx_ssize;     // [aflx_sranks.size()]
+  std::vector<int> aflx_rstart, aflx_rsize;     // [aflx_rranks.size()]
+  int aflx_stotal, aflx_rtotal;                 // total size of data sent/received
+  DualArray2D<int> aflx_soffset, aflx_roffset;  // offset of buffer (m,n) in messages
+  DualArray1D<Real> aflx_sbuf, aflx_rbuf;   // contiguous send/recv messages
+#if MPI_PARALLEL_ENABLED
+  std::vector<MPI_Request> aflx_sreq, aflx_rreq;
+#endif
+  // group which combines the aggregated messages of this object with those of other
+  // physics into one message per rank (nullptr if not in a group)
+  MeshBoundaryMessageGroup *pmsg_group = nullptr;
+  bool Grouped() const;
+
   //functions
   virtual void InitSendIndices(MeshBoundaryBuffer &buf,int x,int y,int z,int a,int b)=0;
   virtual void InitRecvIndices(MeshBoundaryBuffer &buf,int x,int y,int z,int a,int b)=0;
+  void SetSameLevelGhosts(ParameterInput *pin, const std::string &block);
+  void SetReducedPrecision(ParameterInput *pin, const std::string &block);
   void InitializeBuffers(const int nvar);
+  void SetAggregatedMessages(const int nvar);
+  void SetAggregatedFluxMessages(const int nvar);
+  void SetSharedMessages(const int nvar);
+  void FreeSharedMessages();
+  void SendSharedMessage(std::size_t r);
+  bool TestSharedRecvs(bool wait);
 
   TaskStatus InitRecv(const int nvar);
   virtual TaskStatus InitFluxRecv(const int nvar)=0;
@@ -136,6 +236,9 @@ class MeshBoundaryValues {
   TaskStatus ClearSend();
   TaskStatus ClearFluxRecv();
   TaskStatus ClearFluxSend();
+#if MPI_PARALLEL_ENABLED
+  void AddRecvRequests(std::vector<MPI_Request*> &reqs);
+#endif
 
   // BCs associated with various physics modules
   static void HydroBCs(MeshBlockPack *pp, DualArray2D<Real> uin, DvceArray5D<Real> u0);
@@ -164,23 +267,26 @@ class MeshBoundaryValuesCC : public MeshBoundaryValues {
   void InitRecvIndices(MeshBoundaryBuffer &b,int o1,int o2,int o3,int f1,int f2) override;
   TaskStatus InitFluxRecv(const int nvar) override;
 
-  // functions to communicate CC data
-  TaskStatus PackAndSendCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca);
+  // functions to communicate CC data.  Buffers of the offrank and onrank MBs may be
+  // packed in separate calls, with all MPI messages sent by the offrank call.
+  TaskStatus PackAndSendCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca,
+                           PackRegion region=PackRegion::all);
   TaskStatus RecvAndUnpackCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca);
   // functions to communicate fluxes of CC data
-  TaskStatus PackAndSendFluxCC(DvceFaceFld5D<Real> &flx);
-  TaskStatus RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx);
+  TaskStatus PackAndSendFluxCC(DvceFaceFld5D<FluxReal> &flx);
+  TaskStatus RecvAndUnpackFluxCC(DvceFaceFld5D<FluxReal> &flx);
+  // function to add ghost zones of CC data to active cells of neighbors (uniform grids)
+  void SumGhostsCC(DvceArray5D<Real> &a);
 
   // functions to prolongate conserved and primitive CC variables
   void FillCoarseInBndryCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca,
        bool is_z4c=false);
   void ProlongateCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca, bool is_z4c=false);
-  void ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons, DvceArray5D<Real> &prim);
-  void PrimToConsFineBndry(const DvceArray5D<Real> &prim, DvceArray5D<Real> &cons);
-  void ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
-                             DvceArray5D<Real> &prim);
-  void PrimToConsFineBndry(const DvceArray5D<Real> &prim, const DvceFaceFld4D<Real> &b,
-                           DvceArray5D<Real> &cons);
+  void ProlongatePrimsCC(DvceArray5D<Real> &cons, DvceArray5D<Real> &ccons,
+                         DvceArray5D<Real> &prim);
+  void ProlongatePrimsCC(DvceArray5D<Real> &cons, DvceArray5D<Real> &ccons,
+                         const DvceFaceFld4D<Real> &b, const DvceFaceFld4D<Real> &cb,
+                         DvceArray5D<Real> &prim);
 };
 
 //----------------------------------------------------------------------------------------
@@ -209,6 +315,47 @@ class MeshBoundaryValuesFC : public MeshBoundaryValues {
   void AverageBoundaryFluxes(DvceEdgeFld4D<Real> &flx, DvceArray2D<int> &nflx);
 };
 
+//----------------------------------------------------------------------------------------
+//! \class MeshBoundaryMessageGroup
+//  \brief Combines the aggregated messages of several MeshBoundaryValuesCC objects (e.g.
+//  for radiation and the fluid), so that all variables sent from this rank to another
+//  rank are sent as one MPI message, and received with one completion.  Each member
+//  still packs/unpacks its own buffers; the message sent to each rank is described by an
+//  MPI datatype spanning the segments of all members.  Receives (sends) are posted when
+//  the last member posts its receives (packs its buffers) in each stage, so members must
+//  exchange their variables in every stage, and their sends must not depend on the
+//  receives of other members.  Only active while enabled is set by the Driver.
+
+class MeshBoundaryMessageGroup {
+ public:
+  explicit MeshBoundaryMessageGroup(MeshBlockPack *ppack);
+  ~MeshBoundaryMessageGroup();
+
+  bool enabled;                               // combine messages of members if true
+  std::vector<MeshBoundaryValues*> members;
+
+  //functions
+  void AddMember(MeshBoundaryValues *pbval);
+  void PostRecvs();
+  void PostSends();
+  bool TestRecvs();
+  TaskStatus ClearRecv();
+  TaskStatus ClearSend();
+#if MPI_PARALLEL_ENABLED
+  void AddRecvRequests(std::vector<MPI_Request*> &reqs);
+#endif
+
+ private:
+  MeshBlockPack* pmy_pack;
+  int nrecv_ready_, nsend_ready_;   // number of members ready to receive/send
+  bool recvs_posted_;               // combined receives posted for this stage
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm comm_;                   // unique MPI communicator for combined messages
+  std::vector<MPI_Request> sreq_, rreq_;  // one request per neighboring rank
+  MPI_Datatype MessageType(std::size_t r, bool send);
+#endif
+};
+
 //----------------------------------------------------------------------------------------
 //! \struct ParticleLocationData
 //! \brief data describing location of data for particles communicated with MPI
@@ -219,16 +366,6 @@ struct ParticleLocationData {
   int dest_rank;    // rank of target MeshBlock
 };
 
-// Custom operators to sort ParticleLocationData array by dest_rank or prtcl_indx
-struct {
-  bool operator()(ParticleLocationData a, ParticleLocationData b)
-    const { return a.dest_rank < b.dest_rank; }
-} SortByRank;
-struct {
-  bool operator()(ParticleLocationData a, ParticleLocationData b)
-    const { return a.prtcl_indx < b.prtcl_indx; }
-} SortByIndex;
-
 //----------------------------------------------------------------------------------------
 //! \struct ParticleMessageData
 //! \brief Data describing MPI messages containing particles
@@ -252,22 +389,36 @@ class ParticlesBoundaryValues {
   ~ParticlesBoundaryValues();
 
   int nprtcl_send, nprtcl_recv;
-  DualArray1D<ParticleLocationData> sendlist;
+  std::int64_t nprtcl_sent_total = 0;  // particles sent to other ranks by SetNewPrtclGID
+  // first nprtcl_send elements of sendlist are valid (ordered by prtcl_indx), its
+  // capacity grows as needed.  Only stored on device.
+  DvceArray1D<ParticleLocationData> sendlist;
+  DvceArray1D<int> prtcl_dest;  // rank each particle is sent to (-1 if not sent)
 
   // Data needed to count number of messages and particles to send between ranks
   int nsends; // number of MPI sends to neighboring ranks on this rank
   int nrecvs; // number of MPI recvs from neighboring ranks on this rank
-  std::vector<int> nsends_eachrank;                // length nranks
   std::vector<ParticleMessageData> sends_thisrank; // length nsends
   std::vector<ParticleMessageData> recvs_thisrank; // length nrecvs
-  std::vector<ParticleMessageData> sends_allranks; // length ncounts summed over ranks
 
 #if MPI_PARALLEL_ENABLED
+  // persistent buffers (with capacity that only grows) holding messages to/from each
+  // neighboring rank contiguously
   DvceArray1D<Real> prtcl_rsendbuf, prtcl_rrecvbuf;
   DvceArray1D<int>  prtcl_isendbuf, prtcl_irecvbuf;
   std::vector<MPI_Request> rrecv_req, rsend_req;  // vectors of requests for Reals
   std::vector<MPI_Request> irecv_req, isend_req;  // vectors of requests for ints
   MPI_Comm mpi_comm_part;                       // unique MPI communicators for particles
+  // sorted ranks owning neighbors of MBs on this rank (on host and device), and graph
+  // communicator over them
+  std::vector<int> nghbr_ranks;
+  DvceArray1D<int> d_nghbr_ranks;
+  // entries of sendlist ordered by destination rank, and number sent to each rank
+  DvceArray1D<int> send_order;
+  DvceArray1D<std::int64_t> send_keys;
+  DualArray1D<int> send_counts;
+  MPI_Comm mpi_comm_nghbr = MPI_COMM_NULL;
+  int nghbr_version = 0;  // Mesh::mesh_version when mpi_comm_nghbr was built
 #endif
 
   //functions
@@ -278,6 +429,16 @@ class ParticlesBoundaryValues {
   TaskStatus PackAndSendPrtcls();
   TaskStatus ClearPrtclSend();
   TaskStatus RecvAndUnpackPrtcls();
+  void SetNeighborRanks();
+  void BuildSendList();
+  void SetSendOrder(const DvceArray1D<int> &ranks, const int nranks,
+                    std::vector<int> &nsend);
+  void SetMessages(const std::vector<int> &ranks, const std::vector<int> &nsend,
+                   const std::vector<int> &nrecv);
+  void RedistributeParticles(DualArray2D<int> &new_gid, DualArray2D<int> &new_rank);
+#if MPI_PARALLEL_ENABLED
+  void AddRecvRequests(std::vector<MPI_Request*> &reqs);
+#endif
 
  protected:
   particles::Particles* pmy_part;
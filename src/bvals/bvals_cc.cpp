@@ -11,6 +11,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -24,6 +25,34 @@
 MeshBoundaryValuesCC::MeshBoundaryValuesCC(MeshBlockPack *pp, ParameterInput *pin,
                                            bool z4c) :
   MeshBoundaryValues(pp, pin, z4c) {
+#if MPI_PARALLEL_ENABLED
+  // optionally pack all buffers sent between each pair of ranks into one message
+  aggregate_msgs = pin->GetOrAddBoolean("mesh", "aggregate_messages", false);
+  // persistent requests, and staging of messages through host memory for MPI libraries
+  // that cannot access device memory, are only implemented for aggregated messages
+  persistent_reqs = pin->GetOrAddBoolean("mesh", "persistent_mpi", false);
+  gpu_aware_mpi = pin->GetOrAddBoolean("mesh", "gpu_aware_mpi", true);
+  if (persistent_reqs || !(gpu_aware_mpi)) {aggregate_msgs = true;}
+  // messages of several physics may be combined (see MeshBoundaryMessageGroup), which
+  // requires aggregated messages
+  if (pin->GetOrAddBoolean("mesh", "combine_messages", false)) {aggregate_msgs = true;}
+  // aggregated messages to ranks on the same node may be exchanged through shared
+  // memory.  Messages are then staged through host memory (CUDA/HIP IPC handles are not
+  // used), and persistent requests cannot be used.
+  shm_exchange = pin->GetOrAddBoolean("mesh", "shared_memory_exchange", false);
+  if (shm_exchange) {
+    if (persistent_reqs) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mesh>/shared_memory_exchange cannot be used with "
+                << "persistent_mpi" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    aggregate_msgs = true;
+    gpu_aware_mpi = false;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                        MPI_INFO_NULL, &comm_node);
+  }
+#endif
 }
 
 //----------------------------------------------------------------------------------------
@@ -37,13 +66,26 @@ MeshBoundaryValuesCC::MeshBoundaryValuesCC(MeshBlockPack *pp, ParameterInput *pi
 //!
 //! Input arrays must be 5D Kokkos View dimensioned (nmb, nvar, nx3, nx2, nx1)
 //! 5D Kokkos View of coarsened (restricted) array data also required with SMR/AMR
+//!
+//! With region=offrank or onrank only the buffers of those MBs are packed.  Since onrank
+//! MBs have no neighbors on other ranks, nothing is sent with MPI for them.
 
 TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
-                                               DvceArray5D<Real> &ca) {
+                                               DvceArray5D<Real> &ca, PackRegion region) {
+  ScopedTimer comm_timer(pmy_pack->pmesh->pcounter.t_comm);
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
   int nvar = a.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
+  bool all_mbs = (region == PackRegion::all);
+  auto &mbs = (region == PackRegion::onrank)? pmy_pack->pmb->onrank_mbs :
+                                              pmy_pack->pmb->offrank_mbs;
+  int nmb_pack = (all_mbs)? nmb : ((region == PackRegion::onrank)?
+                 pmy_pack->pmb->nmb_onrank : pmy_pack->pmb->nmb_offrank);
+
+  // With aggregated messages, buffers sent to other ranks are packed directly into one
+  // contiguous message per rank at offsets computed in SetAggregatedMessages()
+  if (aggregate_msgs) {SetAggregatedMessages(nvar);}
 
   {int my_rank = global_variable::my_rank;
   auto &nghbr = pmy_pack->pmb->nghbr;
@@ -53,13 +95,19 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
   auto &rbuf = recvbuf;
   auto &is_z4c = is_z4c_;
   auto &multilevel = pmy_pack->pmesh->multilevel;
+  bool agg = aggregate_msgs;
+  bool lo = reduced_msgs;
+  auto &sofst = agg_soffset;
+  auto &asbuf = agg_sbuf.d_view;
+  auto &mbs_ = mbs.d_view;
   // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
-  int nmnv = nmb*nnghbr*nvar;
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), nmnv, Kokkos::AUTO);
-  Kokkos::parallel_for("SendBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr*nvar);
-    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+  int nmnv = nmb_pack*nnghbr*nvar;
+  LaunchTeams("SendBuff", DevExeSpace(), nmnv, 0, 0,
+  KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int mp = (tmember.league_rank())/(nnghbr*nvar);
+    const int n = (tmember.league_rank() - mp*(nnghbr*nvar))/nvar;
+    const int v = (tmember.league_rank() - mp*(nnghbr*nvar) - n*nvar);
+    const int m = (all_mbs)? mp : mbs_(mp);
 
     // only load buffers when neighbor exists
     if (nghbr.d_view(m,n).gid >= 0) {
@@ -125,21 +173,44 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
             tmember.team_barrier();
           }
 
-        // else copy into send buffer for MPI communication below
+        // else copy into reduced-precision send buffer if neighbor at different level
+
+        } else if (lo && nghbr.d_view(m,n).lev != mblev.d_view(m)) {
+          ReducedReal *psend = &sbuf[n].vars_lo(m,0);
+          // if neighbor is at finer level, load data from u0
+          if (nghbr.d_view(m,n).lev > mblev.d_view(m)) {
+            Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+            [&](const int i) {
+              psend[i-il + ni*(j-jl + nj*(k-kl + nk*v))] =
+                static_cast<ReducedReal>(a(m,v,k,j,i));
+            });
+            tmember.team_barrier();
+          // if neighbor is at coarser level, load data from coarse_u0
+          } else {
+            Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+            [&](const int i) {
+              psend[i-il + ni*(j-jl + nj*(k-kl + nk*v))] =
+                static_cast<ReducedReal>(ca(m,v,k,j,i));
+            });
+            tmember.team_barrier();
+          }
+
+        // else copy into send buffer (or aggregated message) for MPI communication below
 
         } else {
+          Real *psend = (agg) ? &asbuf(nvar*sofst.d_view(m,n)) : &sbuf[n].vars(m,0);
           // if neighbor is at same or finer level, load data from u0
           if (nghbr.d_view(m,n).lev >= mblev.d_view(m)) {
             Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
             [&](const int i) {
-              sbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) = a(m,v,k,j,i);
+              psend[i-il + ni*(j-jl + nj*(k-kl + nk*v))] = a(m,v,k,j,i);
             });
             tmember.team_barrier();
           // if neighbor is at coarser level, load data from coarse_u0
           } else {
             Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
             [&](const int i) {
-              sbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) = ca(m,v,k,j,i);
+              psend[i-il + ni*(j-jl + nj*(k-kl + nk*v))] = ca(m,v,k,j,i);
             });
             tmember.team_barrier();
           }
@@ -148,10 +219,12 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
     } // end if-neighbor-exists block
   }); // end par_for_outer
 
-  Kokkos::parallel_for("SendBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr*nvar);
-    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+  LaunchTeams("SendBuffZ4c", DevExeSpace(), nmnv, 0, 0,
+  KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int mp = (tmember.league_rank())/(nnghbr*nvar);
+    const int n = (tmember.league_rank() - mp*(nnghbr*nvar))/nvar;
+    const int v = (tmember.league_rank() - mp*(nnghbr*nvar) - n*nvar);
+    const int m = (all_mbs)? mp : mbs_(mp);
 
     // only load buffers when neighbor exists
     if (nghbr.d_view(m,n).gid >= 0) {
@@ -194,10 +267,11 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
 
           // else copy into send buffer for MPI communication below
           } else {
+            Real *psend = (agg) ? &asbuf(nvar*sofst.d_view(m,n)) : &sbuf[n].vars(m,0);
             // load data from coarse_u0
             Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
             [&](const int i) {
-              sbuf[n].vars(m,ndat+ (i-il + ni*(j-jl + nj*(k-kl + nk*v))) )=ca(m,v,k,j,i);
+              psend[ndat + (i-il + ni*(j-jl + nj*(k-kl + nk*v)))] = ca(m,v,k,j,i);
             });
             tmember.team_barrier();
           }
@@ -208,12 +282,44 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
   }
 
 #if MPI_PARALLEL_ENABLED
+  if (region == PackRegion::onrank) return TaskStatus::complete;
   // Send boundary buffer to neighboring MeshBlocks using MPI
-  Kokkos::fence();
+  TaskExecSpace().fence();
   auto &is_z4c = is_z4c_;
   int my_rank = global_variable::my_rank;
   auto &nghbr = pmy_pack->pmb->nghbr;
   bool no_errors=true;
+  // With aggregated messages, send one message to each neighboring rank
+  if (aggregate_msgs) {
+    if (!(gpu_aware_mpi)) {
+      agg_sbuf.template modify<DevExeSpace>();
+      agg_sbuf.template sync<HostMemSpace>();
+    }
+    // messages combined with other physics are sent once all members are packed
+    if (Grouped()) {
+      pmsg_group->PostSends();
+    } else if (persistent_reqs) {
+      if (!(agg_sreq.empty())) {
+        int ierr = MPI_Startall(agg_sreq.size(), agg_sreq.data());
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+      }
+    } else {
+      Real *sptr = (gpu_aware_mpi) ? agg_sbuf.d_view.data() : agg_sbuf.h_view.data();
+      if (shm_exchange) {shm_sseq++;}
+      for (std::size_t r=0; r<agg_ranks.size(); ++r) {
+        if (shm_exchange && shm_nrank[r] >= 0) {
+          SendSharedMessage(r);
+        } else {
+          int ierr = MPI_Isend(sptr + nvar*agg_sstart[r], nvar*agg_ssize[r],
+                               MPI_ATHENA_REAL, agg_ranks[r], 0,
+                               comm_vars, &(agg_sreq[r]));
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+        }
+        pmy_pack->pmesh->pcounter.nbytes_sent += nvar*agg_ssize[r]*sizeof(Real);
+      }
+    }
+    nmb = 0;  // skip sends of individual buffers below
+  }
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<nnghbr; ++n) {
       if (nghbr.h_view(m,n).gid >= 0) {  // neighbor exists and not a physical boundary
@@ -238,10 +344,19 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
           } else {
             data_size *= sendbuf[n].ifine_ndat;
           }
-          auto send_ptr = Kokkos::subview(sendbuf[n].vars, m, Kokkos::ALL);
-
-          int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
-                               comm_vars, &(sendbuf[n].vars_req[m]));
+          int ierr;
+          if (reduced_msgs &&
+              nghbr.h_view(m,n).lev != pmy_pack->pmb->mb_lev.h_view(m)) {
+            auto send_ptr = Kokkos::subview(sendbuf[n].vars_lo, m, Kokkos::ALL);
+            ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REDUCED_REAL,
+                             drank, tag, comm_vars, &(sendbuf[n].vars_req[m]));
+            pmy_pack->pmesh->pcounter.nbytes_sent += data_size*sizeof(ReducedReal);
+          } else {
+            auto send_ptr = Kokkos::subview(sendbuf[n].vars, m, Kokkos::ALL);
+            ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL,
+                             drank, tag, comm_vars, &(sendbuf[n].vars_req[m]));
+            pmy_pack->pmesh->pcounter.nbytes_sent += data_size*sizeof(Real);
+          }
           if (ierr != MPI_SUCCESS) {no_errors=false;}
         }
       }
@@ -263,6 +378,7 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
 
 TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
                                                  DvceArray5D<Real> &ca) {
+  ScopedTimer comm_timer(pmy_pack->pmesh->pcounter.t_comm);
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
@@ -275,15 +391,29 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
 
   bool bflag = false;
   bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if (nghbr.h_view(m,n).gid >= 0) { // neighbor exists and not a physical boundary
-        if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
-          int test;
-          int ierr = MPI_Test(&(rbuf[n].vars_req[m]), &test, MPI_STATUS_IGNORE);
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
-          if (!(static_cast<bool>(test))) {
-            bflag = true;
+  if (Grouped()) {
+    bflag = !(pmsg_group->TestRecvs());
+  } else if (aggregate_msgs) {
+    for (auto &req : agg_rreq) {
+      int test;
+      int ierr = MPI_Test(&req, &test, MPI_STATUS_IGNORE);
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+      if (!(static_cast<bool>(test))) {
+        bflag = true;
+      }
+    }
+    if (shm_exchange && !(TestSharedRecvs(false))) {bflag = true;}
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if (nghbr.h_view(m,n).gid >= 0) { // neighbor exists and not a physical boundary
+          if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
+            int test;
+            int ierr = MPI_Test(&(rbuf[n].vars_req[m]), &test, MPI_STATUS_IGNORE);
+            if (ierr != MPI_SUCCESS) {no_errors=false;}
+            if (!(static_cast<bool>(test))) {
+              bflag = true;
+            }
           }
         }
       }
@@ -298,16 +428,27 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
   }
   // exit if recv boundary buffer communications have not completed
   if (bflag) {return TaskStatus::incomplete;}
+  // copy messages staged through host memory to device
+  if (aggregate_msgs && !(gpu_aware_mpi)) {
+    agg_rbuf.template modify<HostMemSpace>();
+    agg_rbuf.template sync<DevExeSpace>();
+  }
 #endif
 
   //----- STEP 2: buffers have all completed, so unpack
 
   int nvar = a.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
   auto &mblev = pmy_pack->pmb->mb_lev;
+  // buffers received from other ranks are unpacked from aggregated messages if used
+  bool agg = aggregate_msgs;
+  bool lo = reduced_msgs;
+  int my_rank = global_variable::my_rank;
+  auto &rofst = agg_roffset;
+  auto &arbuf = agg_rbuf.d_view;
 
   // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
-  Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+  LaunchTeams("RecvBuff", DevExeSpace(), nmb*nnghbr*nvar, 0, 0,
+  KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int m = (tmember.league_rank())/(nnghbr*nvar);
     const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
     const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
@@ -344,6 +485,12 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
       int nj = ju - jl + 1;
       int nk = ku - kl + 1;
       int nkj  = nk*nj;
+      const Real *precv = (agg && rofst.d_view(m,n) >= 0) ?
+                          &arbuf(nvar*rofst.d_view(m,n)) : &rbuf[n].vars(m,0);
+      // messages from other ranks at other levels may be in reduced precision
+      bool rlo = lo && nghbr.d_view(m,n).rank != my_rank &&
+                 nghbr.d_view(m,n).lev != mblev.d_view(m);
+      const ReducedReal *precv_lo = (rlo) ? &rbuf[n].vars_lo(m,0) : nullptr;
 
       // Middle loop over k,j
       Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
@@ -351,11 +498,21 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
         int j = (idx - k * nj) + jl;
         k += kl;
 
+        // reduced-precision data from finer (into u0) or coarser (into coarse_u0) level
+        if (rlo) {
+          auto &dst = (nghbr.d_view(m,n).lev > mblev.d_view(m)) ? a : ca;
+          Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+          [&](const int i) {
+            dst(m,v,k,j,i) =
+              static_cast<Real>(precv_lo[i-il + ni*(j-jl + nj*(k-kl + nk*v))]);
+          });
+          tmember.team_barrier();
+
         // if neighbor is at same or finer level, load data directly into u0
-        if (nghbr.d_view(m,n).lev >= mblev.d_view(m)) {
+        } else if (nghbr.d_view(m,n).lev >= mblev.d_view(m)) {
           Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
           [&](const int i) {
-            a(m,v,k,j,i) = rbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) );
+            a(m,v,k,j,i) = precv[i-il + ni*(j-jl + nj*(k-kl + nk*v))];
           });
           tmember.team_barrier();
 
@@ -363,7 +520,7 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
         } else {
           Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
           [&](const int i) {
-            ca(m,v,k,j,i) = rbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) );
+            ca(m,v,k,j,i) = precv[i-il + ni*(j-jl + nj*(k-kl + nk*v))];
           });
           tmember.team_barrier();
         }
@@ -372,7 +529,8 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
   });  // end par_for_outer
 
   // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
-  Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+  LaunchTeams("RecvBuffZ4c", DevExeSpace(), nmb*nnghbr*nvar, 0, 0,
+  KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int m = (tmember.league_rank())/(nnghbr*nvar);
     const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
     const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
@@ -393,6 +551,8 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
         int nk = ku - kl + 1;
         int nkj  = nk*nj;
         int ndat = nvar*rbuf[n].isame_ndat; // size of same level data packed in buff
+        const Real *precv = (agg && rofst.d_view(m,n) >= 0) ?
+                            &arbuf(nvar*rofst.d_view(m,n)) : &rbuf[n].vars(m,0);
 
         // Middle loop over k,j
         Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
@@ -403,7 +563,7 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
           // load data into coarse_u0
           Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
           [&](const int i) {
-            ca(m,v,k,j,i) = rbuf[n].vars(m,ndat + (i-il + ni*(j-jl + nj*(k-kl + nk*v))) );
+            ca(m,v,k,j,i) = precv[ndat + (i-il + ni*(j-jl + nj*(k-kl + nk*v)))];
           });
           tmember.team_barrier();
         });
@@ -413,3 +573,159 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
 
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+// \!fn void SumGhostsCC()
+// \brief Adds values in the ghost zones of array a to the active cells they overlap on
+// neighboring MeshBlocks, e.g. for quantities deposited by particles.  This is the
+// reverse of the usual exchange: the ghost cells of buffer n (recv indices) are added to
+// the cells the neighbor packs into buffer dest (its send indices), which have the same
+// shape for neighbors at the same level.  Ghost zones at physical boundaries are
+// discarded.
+// Blocking, and uses comm_vars, so must not be called while the boundary communications
+// of this object are in progress.
+
+void MeshBoundaryValuesCC::SumGhostsCC(DvceArray5D<Real> &a) {
+  if (pmy_pack->pmesh->multilevel) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Sum over ghost zones only implemented for uniform grids"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int nvar = a.extent_int(1);
+  int my_rank = global_variable::my_rank;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0 && nghbr.h_view(m,n).rank != my_rank &&
+          nvar*recvbuf[n].isame_ndat > recvbuf[n].vars.extent_int(1)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Boundary buffers too small to sum " << nvar
+                  << " variables over ghost zones" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+  }
+
+#if MPI_PARALLEL_ENABLED
+  // post receives of ghost zones of neighbors on other ranks
+  std::vector<MPI_Request> sum_req;
+  bool no_errors=true;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0 && nghbr.h_view(m,n).rank != my_rank) {
+        int tag = CreateBvals_MPI_Tag(m, n);
+        auto recv_ptr = Kokkos::subview(recvbuf[n].vars, m, Kokkos::ALL);
+        sum_req.emplace_back();
+        int ierr = MPI_Irecv(recv_ptr.data(), nvar*recvbuf[n].isame_ndat,
+                             MPI_ATHENA_REAL, nghbr.h_view(m,n).rank, tag, comm_vars,
+                             &(sum_req.back()));
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+      }
+    }
+  }
+#endif
+
+  // add ghost zones to neighbors on this rank, and pack those sent to other ranks
+  {auto &mbgid = pmy_pack->pmb->mb_gid;
+  auto &sbuf = sendbuf;
+  auto &rbuf = recvbuf;
+  int nmnv = nmb*nnghbr*nvar;
+  LaunchTeams("SumGhostsSend", DevExeSpace(), nmnv, 0, 0,
+  KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int m = (tmember.league_rank())/(nnghbr*nvar);
+    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
+    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+    if (nghbr.d_view(m,n).gid >= 0) {
+      int il = rbuf[n].isame[0].bis, iu = rbuf[n].isame[0].bie;
+      int jl = rbuf[n].isame[0].bjs, ju = rbuf[n].isame[0].bje;
+      int kl = rbuf[n].isame[0].bks, ku = rbuf[n].isame[0].bke;
+      int ni = iu - il + 1;
+      int nj = ju - jl + 1;
+      int nk = ku - kl + 1;
+      int nkj  = nk*nj;
+      int dm = nghbr.d_view(m,n).gid - mbgid.d_view(0);
+      int dn = nghbr.d_view(m,n).dest;
+      int dil = sbuf[dn].isame[0].bis;
+      int djl = sbuf[dn].isame[0].bjs;
+      int dkl = sbuf[dn].isame[0].bks;
+      bool local = (nghbr.d_view(m,n).rank == my_rank);
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
+        int k = idx / nj;
+        int j = (idx - k * nj) + jl;
+        k += kl;
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+        [&](const int i) {
+          if (local) {
+            Kokkos::atomic_add(&a(dm,v,k-kl+dkl,j-jl+djl,i-il+dil), a(m,v,k,j,i));
+          } else {
+            sbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v)))) = a(m,v,k,j,i);
+          }
+        });
+      });
+    }
+  });
+  TaskExecSpace().fence();}
+
+#if MPI_PARALLEL_ENABLED
+  // send ghost zones to neighbors on other ranks, and wait for all messages
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      int drank = nghbr.h_view(m,n).rank;
+      if (nghbr.h_view(m,n).gid >= 0 && drank != my_rank) {
+        int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
+        int tag = CreateBvals_MPI_Tag(lid, nghbr.h_view(m,n).dest);
+        auto send_ptr = Kokkos::subview(sendbuf[n].vars, m, Kokkos::ALL);
+        sum_req.emplace_back();
+        int ierr = MPI_Isend(send_ptr.data(), nvar*recvbuf[n].isame_ndat,
+                             MPI_ATHENA_REAL, drank, tag, comm_vars,
+                             &(sum_req.back()));
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+      }
+    }
+  }
+  if (!(sum_req.empty())) {
+    int ierr = MPI_Waitall(sum_req.size(), sum_req.data(), MPI_STATUSES_IGNORE);
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+  }
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in sum over ghost zones" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // add received ghost zones to active cells
+  {auto &sbuf = sendbuf;
+  auto &rbuf = recvbuf;
+  int nmnv = nmb*nnghbr*nvar;
+  LaunchTeams("SumGhostsRecv", DevExeSpace(), nmnv, 0, 0,
+  KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int m = (tmember.league_rank())/(nnghbr*nvar);
+    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
+    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+    if (nghbr.d_view(m,n).gid >= 0 && nghbr.d_view(m,n).rank != my_rank) {
+      int il = sbuf[n].isame[0].bis, iu = sbuf[n].isame[0].bie;
+      int jl = sbuf[n].isame[0].bjs, ju = sbuf[n].isame[0].bje;
+      int kl = sbuf[n].isame[0].bks, ku = sbuf[n].isame[0].bke;
+      int ni = iu - il + 1;
+      int nj = ju - jl + 1;
+      int nk = ku - kl + 1;
+      int nkj  = nk*nj;
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
+        int k = idx / nj;
+        int j = (idx - k * nj) + jl;
+        k += kl;
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+        [&](const int i) {
+          Kokkos::atomic_add(&a(m,v,k,j,i),
+                             static_cast<Real>(rbuf[n].vars(m, (i-il + ni*(j-jl +
+                                               nj*(k-kl + nk*v))))));
+        });
+      });
+    }
+  });}
+#endif
+  return;
+}
@@ -0,0 +1,230 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file bvals_group.cpp
+//! \brief functions to send the aggregated messages of several MeshBoundaryValuesCC
+//! objects to each neighboring rank as one combined MPI message
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals.hpp"
+
+//----------------------------------------------------------------------------------------
+// MeshBoundaryMessageGroup constructor:
+
+MeshBoundaryMessageGroup::MeshBoundaryMessageGroup(MeshBlockPack *pp) :
+  enabled(false),
+  pmy_pack(pp),
+  nrecv_ready_(0),
+  nsend_ready_(0),
+  recvs_posted_(false) {
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_dup(MPI_COMM_WORLD, &comm_);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// MeshBoundaryMessageGroup destructor
+
+MeshBoundaryMessageGroup::~MeshBoundaryMessageGroup() {
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool MeshBoundaryValues::Grouped
+//! \brief Returns true if messages of this object are currently combined with those of
+//! the other members of its MeshBoundaryMessageGroup
+
+bool MeshBoundaryValues::Grouped() const {
+  return (pmsg_group != nullptr) && (pmsg_group->enabled);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryMessageGroup::AddMember
+//! \brief Adds a MeshBoundaryValues object to this group.  Its messages must be
+//! aggregated (without persistent requests, which are bound to a single buffer, or
+//! shared-memory exchanges).
+
+void MeshBoundaryMessageGroup::AddMember(MeshBoundaryValues *pbval) {
+  if (!(pbval->aggregate_msgs) || pbval->persistent_reqs || pbval->shm_exchange) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<mesh>/combine_messages requires aggregate_messages, and "
+              << "cannot be used with persistent_mpi or shared_memory_exchange"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  pbval->pmsg_group = this;
+  members.push_back(pbval);
+}
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn MPI_Datatype MeshBoundaryMessageGroup::MessageType
+//! \brief Returns a committed MPI datatype (at absolute addresses, used with MPI_BOTTOM)
+//! spanning the segments of the aggregated messages of all members sent to (or received
+//! from) the r-th neighboring rank.  The datatype may be freed as soon as the send or
+//! receive using it has been posted.
+
+MPI_Datatype MeshBoundaryMessageGroup::MessageType(std::size_t r, bool send) {
+  std::vector<int> blen;
+  std::vector<MPI_Aint> disp;
+  for (auto pbval : members) {
+    auto &buf = (send) ? pbval->agg_sbuf : pbval->agg_rbuf;
+    Real *ptr = (pbval->gpu_aware_mpi) ? buf.d_view.data() : buf.h_view.data();
+    int nvar = pbval->agg_nvar;
+    int start = (send) ? pbval->agg_sstart[r] : pbval->agg_rstart[r];
+    int size = (send) ? pbval->agg_ssize[r] : pbval->agg_rsize[r];
+    MPI_Aint addr;
+    MPI_Get_address(ptr + nvar*start, &addr);
+    blen.push_back(nvar*size);
+    disp.push_back(addr);
+  }
+  MPI_Datatype type;
+  MPI_Type_create_hindexed(static_cast<int>(blen.size()), blen.data(), disp.data(),
+                           MPI_ATHENA_REAL, &type);
+  MPI_Type_commit(&type);
+  return type;
+}
+#endif
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryMessageGroup::PostRecvs
+//! \brief Called by each member after it has set up its aggregated messages in InitRecv.
+//! When all members are ready, posts one receive for each neighboring rank.
+
+void MeshBoundaryMessageGroup::PostRecvs() {
+  if (++nrecv_ready_ < static_cast<int>(members.size())) return;
+  nrecv_ready_ = 0;
+#if MPI_PARALLEL_ENABLED
+  // all members exchange messages with the same ranks, since they share MeshBlocks
+  auto &ranks = members[0]->agg_ranks;
+  for (auto pbval : members) {
+    if (pbval->agg_ranks != ranks) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Members of combined messages have different neighbor "
+                << "ranks" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  bool no_errors=true;
+  rreq_.assign(ranks.size(), MPI_REQUEST_NULL);
+  for (std::size_t r=0; r<ranks.size(); ++r) {
+    MPI_Datatype type = MessageType(r, false);
+    int ierr = MPI_Irecv(MPI_BOTTOM, 1, type, ranks[r], 0, comm_, &(rreq_[r]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    MPI_Type_free(&type);
+  }
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in posting combined non-blocking receives" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  recvs_posted_ = true;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryMessageGroup::PostSends
+//! \brief Called by each member after it has packed (and staged) its aggregated
+//! messages.  When all members are ready, sends one message to each neighboring rank.
+
+void MeshBoundaryMessageGroup::PostSends() {
+  if (++nsend_ready_ < static_cast<int>(members.size())) return;
+  nsend_ready_ = 0;
+#if MPI_PARALLEL_ENABLED
+  auto &ranks = members[0]->agg_ranks;
+  bool no_errors=true;
+  sreq_.assign(ranks.size(), MPI_REQUEST_NULL);
+  for (std::size_t r=0; r<ranks.size(); ++r) {
+    MPI_Datatype type = MessageType(r, true);
+    int ierr = MPI_Isend(MPI_BOTTOM, 1, type, ranks[r], 0, comm_, &(sreq_[r]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    MPI_Type_free(&type);
+    for (auto pbval : members) {
+      pmy_pack->pmesh->pcounter.nbytes_sent +=
+          pbval->agg_nvar*pbval->agg_ssize[r]*sizeof(Real);
+    }
+  }
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in posting combined sends" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool MeshBoundaryMessageGroup::TestRecvs
+//! \brief Returns true when all combined receives of this stage have completed
+
+bool MeshBoundaryMessageGroup::TestRecvs() {
+  if (!(recvs_posted_)) return false;
+#if MPI_PARALLEL_ENABLED
+  int flag;
+  int ierr = MPI_Testall(static_cast<int>(rreq_.size()), rreq_.data(), &flag,
+                         MPI_STATUSES_IGNORE);
+  if (ierr != MPI_SUCCESS) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in testing combined receives" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  return static_cast<bool>(flag);
+#else
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MeshBoundaryMessageGroup::ClearRecv
+//! \brief Waits for all combined receives to complete.  May be called by every member.
+
+TaskStatus MeshBoundaryMessageGroup::ClearRecv() {
+#if MPI_PARALLEL_ENABLED
+  int ierr = MPI_Waitall(static_cast<int>(rreq_.size()), rreq_.data(),
+                         MPI_STATUSES_IGNORE);
+  if (ierr != MPI_SUCCESS) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in clearing combined receives" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  recvs_posted_ = false;
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MeshBoundaryMessageGroup::ClearSend
+//! \brief Waits for all combined sends to complete.  May be called by every member.
+
+TaskStatus MeshBoundaryMessageGroup::ClearSend() {
+#if MPI_PARALLEL_ENABLED
+  int ierr = MPI_Waitall(static_cast<int>(sreq_.size()), sreq_.data(),
+                         MPI_STATUSES_IGNORE);
+  if (ierr != MPI_SUCCESS) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in clearing combined sends" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return TaskStatus::complete;
+}
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryMessageGroup::AddRecvRequests()
+//! \brief Appends pointers to the requests of the combined receives, so the Driver can
+//! block until one of them completes.
+
+void MeshBoundaryMessageGroup::AddRecvRequests(std::vector<MPI_Request*> &reqs) {
+  for (auto &req : rreq_) {reqs.push_back(&req);}
+  return;
+}
+#endif
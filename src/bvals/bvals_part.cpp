@@ -12,7 +12,7 @@
 #include <vector>
 #include <algorithm>
 #include <Kokkos_Core.hpp>
-#include <Kokkos_StdAlgorithms.hpp>
+#include <Kokkos_Sort.hpp>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -26,19 +26,15 @@ namespace particles {
 //----------------------------------------------------------------------------------------
 //! \fn void ParticlesBoundaryValues::UpdateGID()
 //! \brief Updates GID of particles that cross boundary of their parent MeshBlock.  If
-//! the new GID is on a different rank, then store in sendlist_buf DvceArray: (1) index of
-//! particle in prtcl array, (2) destination GID, and (3) destination rank.
+//! the new GID is on a different rank, then store destination rank of particle, from
+//! which the sendlist is built with a prefix scan.
 
 KOKKOS_INLINE_FUNCTION
-void UpdateGID(int &newgid, NeighborBlock nghbr, int myrank, int *pcounter,
-               DualArray1D<ParticleLocationData> slist, int p) {
+void UpdateGID(int &newgid, int &newrank, NeighborBlock nghbr, int myrank) {
   newgid = nghbr.gid;
 #if MPI_PARALLEL_ENABLED
   if (nghbr.rank != myrank) {
-    int index = Kokkos::atomic_fetch_add(pcounter,1);
-    slist.d_view(index).prtcl_indx = p;
-    slist.d_view(index).dest_gid   = nghbr.gid;
-    slist.d_view(index).dest_rank  = nghbr.rank;
+    newrank = nghbr.rank;
   }
 #endif
   return;
@@ -59,15 +55,16 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
   auto &meshsize = pmy_part->pmy_pack->pmesh->mesh_size;
   auto myrank = global_variable::my_rank;
   auto &nghbr = pmy_part->pmy_pack->pmb->nghbr;
-  auto &psendl = sendlist;
-  int counter=0;
-  int *pcounter = &counter;
   bool &multi_d = pmy_part->pmy_pack->pmesh->multi_d;
   bool &three_d = pmy_part->pmy_pack->pmesh->three_d;
 
-  Kokkos::realloc(sendlist, static_cast<int>(0.1*npart));
+  if (prtcl_dest.extent_int(0) < npart) {
+    Kokkos::realloc(prtcl_dest, GrowCapacity(prtcl_dest.extent_int(0), npart));
+  }
+  auto &pdest = prtcl_dest;
   par_for("part_update",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
     int m = pi(PGID,p) - gids;
+    pdest(p) = -1;
     int mylevel = mblev.d_view(m);
     Real x1 = pr(IPX,p);
     Real x2 = pr(IPY,p);
@@ -100,7 +97,7 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
             indx = NeighborIndex(ix,0,0,fy,fz);
           }
           while (nghbr.d_view(m,indx).gid < 0) {indx++;}  // neighbor at coarser level
-          UpdateGID(pi(PGID,p), nghbr.d_view(m,indx), myrank, pcounter, psendl, p);
+          UpdateGID(pi(PGID,p), pdest(p), nghbr.d_view(m,indx), myrank);
         } else if (ix == 0) {
           // x2 face
           int indx = NeighborIndex(0,iy,0,0,0);
@@ -108,7 +105,7 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
             indx = NeighborIndex(0,iy,0,fx,fz);
           }
           while (nghbr.d_view(m,indx).gid < 0) {indx++;}
-          UpdateGID(pi(PGID,p), nghbr.d_view(m,indx), myrank, pcounter, psendl, p);
+          UpdateGID(pi(PGID,p), pdest(p), nghbr.d_view(m,indx), myrank);
         } else {
           // x1x2 edge
           int indx = NeighborIndex(ix,iy,0,0,0);
@@ -116,7 +113,7 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
             indx = NeighborIndex(ix,iy,0,fz,0);
           }
           while (nghbr.d_view(m,indx).gid < 0) {indx++;}
-          UpdateGID(pi(PGID,p), nghbr.d_view(m,indx), myrank, pcounter, psendl, p);
+          UpdateGID(pi(PGID,p), pdest(p), nghbr.d_view(m,indx), myrank);
         }
       } else if (iy == 0) {
         if (ix == 0) {
@@ -126,7 +123,7 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
             indx = NeighborIndex(0,0,iz,fx,fy);
           }
           while (nghbr.d_view(m,indx).gid < 0) {indx++;}
-          UpdateGID(pi(PGID,p), nghbr.d_view(m,indx), myrank, pcounter, psendl, p);
+          UpdateGID(pi(PGID,p), pdest(p), nghbr.d_view(m,indx), myrank);
         } else {
           // x3x1 edge
           int indx = NeighborIndex(ix,0,iz,0,0);
@@ -134,7 +131,7 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
             indx = NeighborIndex(ix,0,iz,fy,0);
           }
           while (nghbr.d_view(m,indx).gid < 0) {indx++;}
-          UpdateGID(pi(PGID,p), nghbr.d_view(m,indx), myrank, pcounter, psendl, p);
+          UpdateGID(pi(PGID,p), pdest(p), nghbr.d_view(m,indx), myrank);
         }
       } else {
         if (ix == 0) {
@@ -144,11 +141,11 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
             indx = NeighborIndex(0,iy,iz,fx,0);
           }
           while (nghbr.d_view(m,indx).gid < 0) {indx++;}
-          UpdateGID(pi(PGID,p), nghbr.d_view(m,indx), myrank, pcounter, psendl, p);
+          UpdateGID(pi(PGID,p), pdest(p), nghbr.d_view(m,indx), myrank);
         } else {
           // corners
           int indx = NeighborIndex(ix,iy,iz,0,0);
-          UpdateGID(pi(PGID,p), nghbr.d_view(m,indx), myrank, pcounter, psendl, p);
+          UpdateGID(pi(PGID,p), pdest(p), nghbr.d_view(m,indx), myrank);
         }
       }
 
@@ -170,147 +167,257 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
       }
     }
   });
-  nprtcl_send = counter;
-  Kokkos::resize(sendlist, nprtcl_send);
-  // sync sendlist device array with host
-  sendlist.template modify<DevExeSpace>();
-  sendlist.template sync<HostMemSpace>();
+  BuildSendList();
+  nprtcl_sent_total += nprtcl_send;
 
   return TaskStatus::complete;
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void ParticlesBoundaryValues::CountSendsAndRecvs()
-//! \brief
-
-TaskStatus ParticlesBoundaryValues::CountSendsAndRecvs() {
+//! \fn void ParticlesBoundaryValues::BuildSendList()
+//! \brief Stores in sendlist: (1) index of particle in prtcl array, (2) destination GID,
+//! and (3) destination rank of particles sent to other ranks (those with prtcl_dest>=0),
+//! ordered by index with a prefix scan.  If capacity of sendlist is too small, grow it
+//! and repeat the scan.
+
+void ParticlesBoundaryValues::BuildSendList() {
+  nprtcl_send = 0;
 #if MPI_PARALLEL_ENABLED
-  // Sort sendlist on host by destrank.
-  namespace KE = Kokkos::Experimental;
-  std::sort(KE::begin(sendlist.h_view), KE::end(sendlist.h_view), SortByRank);
-  // sync sendlist host array with device.  This results in sorted array on device
-  sendlist.template modify<HostMemSpace>();
-  sendlist.template sync<DevExeSpace>();
-
-  // load STL::vector of ParticleMessageData with <sendrank, recvrank, nprtcls> for sends
-  // from this rank. Length will be nsends; initially this length is unknown
-  sends_thisrank.clear();
-  if (nprtcl_send > 0) {
-    int &myrank = global_variable::my_rank;
-    int rank = sendlist.h_view(0).dest_rank;
-    int nprtcl = 1;
-
-    for (int n=1; n<nprtcl_send; ++n) {
-      if (sendlist.h_view(n).dest_rank == rank) {
-        ++nprtcl;
-      } else {
-        sends_thisrank.emplace_back(ParticleMessageData(myrank,rank,nprtcl));
-        rank = sendlist.h_view(n).dest_rank;
-        nprtcl = 1;
+  int npart = pmy_part->nprtcl_thispack;
+  auto &pi = pmy_part->prtcl_idata;
+  auto &pdest = prtcl_dest;
+  while (true) {
+    int capacity = sendlist.extent_int(0);
+    auto &slist = sendlist;
+    Kokkos::parallel_scan("part_sendlist",
+                          Kokkos::RangePolicy<>(TaskExecSpace(), 0, npart),
+    KOKKOS_LAMBDA(const int p, int &index, const bool is_final) {
+      if (pdest(p) >= 0) {
+        if (is_final && index < capacity) {
+          slist(index).prtcl_indx = p;
+          slist(index).dest_gid   = pi(PGID,p);
+          slist(index).dest_rank  = pdest(p);
+        }
+        ++index;
       }
-    }
-    sends_thisrank.emplace_back(ParticleMessageData(myrank,rank,nprtcl));
+    }, nprtcl_send);
+    if (nprtcl_send <= capacity) {break;}
+    Kokkos::realloc(sendlist, GrowCapacity(capacity, nprtcl_send));
   }
-  nsends = sends_thisrank.size();
+#endif
+  return;
+}
 
-  // Share number of ranks to send to amongst all ranks
-  nsends_eachrank[global_variable::my_rank] = nsends;
-  MPI_Allgather(&nsends, 1, MPI_INT, nsends_eachrank.data(), 1, MPI_INT, mpi_comm_part);
-
-  // Now share ParticleMessageData amongst all ranks
-  // First create vector of starting indices in full vector
-  std::vector<int> nsends_displ;
-  nsends_displ.resize(global_variable::nranks);
-  nsends_displ[0] = 0;
-  for (int n=1; n<(global_variable::nranks); ++n) {
-    nsends_displ[n] = nsends_displ[n-1] + nsends_eachrank[n-1];
+//----------------------------------------------------------------------------------------
+//! n void ParticlesBoundaryValues::SetSendOrder()
+//! rief Given the sorted list of ranks particles can be sent to (on the device), stores
+//! in send_order the indices of entries in sendlist ordered by destination rank (and by
+//! index in particle arrays for each rank), and returns number of particles sent to each
+//! rank in nsend.  Done on the device with a sort of 64-bit keys, so that only the counts
+//! are copied to the host.
+
+void ParticlesBoundaryValues::SetSendOrder(const DvceArray1D<int> &ranks,
+                                           const int nranks, std::vector<int> &nsend) {
+#if MPI_PARALLEL_ENABLED
+  int nsend_tot = nprtcl_send;
+  if (send_order.extent_int(0) < nsend_tot) {
+    int capacity = GrowCapacity(send_order.extent_int(0), nsend_tot);
+    Kokkos::realloc(send_order, capacity);
+    Kokkos::realloc(send_keys, capacity);
+  }
+  if (send_counts.extent_int(0) != nranks) {
+    Kokkos::realloc(send_counts, nranks);
+  }
+  Kokkos::deep_copy(TaskExecSpace(), send_counts.d_view, 0);
+
+  if (nsend_tot > 0) {
+    // key of each particle = (index of destination rank)*nsend_tot + index in sendlist,
+    // where index of rank is found by binary search in (sorted) ranks.  Ranks not in the
+    // list are given index nranks, and are flagged below.
+    auto &slist = sendlist;
+    auto &keys = send_keys;
+    auto &cnts = send_counts;
+    par_for("part_sendkeys",DevExeSpace(),0,(nsend_tot-1), KOKKOS_LAMBDA(const int n) {
+      int rank = slist(n).dest_rank;
+      int indx = nranks;
+      if (nranks > 0) {
+        int lo = 0, hi = nranks - 1;
+        while (lo < hi) {
+          int mid = (lo + hi)/2;
+          if (ranks(mid) < rank) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+        if (ranks(lo) == rank) {
+          indx = lo;
+          Kokkos::atomic_add(&cnts.d_view(indx), 1);
+        }
+      }
+      keys(n) = static_cast<std::int64_t>(indx)*nsend_tot + n;
+    });
+    Kokkos::sort(Kokkos::subview(keys, std::make_pair(0, nsend_tot)));
+    auto &order = send_order;
+    par_for("part_sendorder",DevExeSpace(),0,(nsend_tot-1), KOKKOS_LAMBDA(const int n) {
+      order(n) = static_cast<int>(keys(n) % nsend_tot);
+    });
   }
-  int nsends_allranks = nsends_displ[global_variable::nranks - 1] +
-                        nsends_eachrank[global_variable::nranks - 1];
-  // Load ParticleMessageData on this rank into full vector
-  sends_allranks.resize(nsends_allranks, ParticleMessageData(0,0,0));
-  for (int n=0; n<nsends_eachrank[global_variable::my_rank]; ++n) {
-    sends_allranks[n + nsends_displ[global_variable::my_rank]] = sends_thisrank[n];
+  send_counts.template modify<DevExeSpace>();
+  send_counts.template sync<HostMemSpace>();
+
+  int ncount = 0;
+  nsend.assign(nranks, 0);
+  for (int n=0; n<nranks; ++n) {
+    nsend[n] = send_counts.h_view(n);
+    ncount += nsend[n];
   }
+  if (ncount != nsend_tot) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << (nsend_tot - ncount) << " particles sent to ranks which "
+              << "do not own a neighboring MeshBlock" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::SetNeighborRanks()
+//! \brief Stores (sorted) ranks owning neighbors of MeshBlocks on this rank, and creates
+//! distributed graph communicator over them, so that counts of particles sent between
+//! ranks are only exchanged with neighbors.  Since MeshBlocks are neighbors of each
+//! other, the graph is symmetric.
 
-  // Share tuples using MPI derived data type for tuple of 3*int
-  MPI_Datatype mpi_ituple;
-  MPI_Type_contiguous(3, MPI_INT, &mpi_ituple);
-  MPI_Allgatherv(MPI_IN_PLACE, nsends_eachrank[global_variable::my_rank],
-                   mpi_ituple, sends_allranks.data(), nsends_eachrank.data(),
-                   nsends_displ.data(), mpi_ituple, mpi_comm_part);
+void ParticlesBoundaryValues::SetNeighborRanks() {
+#if MPI_PARALLEL_ENABLED
+  auto &nghbr = pmy_part->pmy_pack->pmb->nghbr;
+  int nmb = pmy_part->pmy_pack->nmb_thispack;
+  int nnghbr = pmy_part->pmy_pack->pmb->nnghbr;
+  nghbr_ranks.clear();
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      int rank = nghbr.h_view(m,n).rank;
+      if (nghbr.h_view(m,n).gid >= 0 && rank != global_variable::my_rank) {
+        nghbr_ranks.push_back(rank);
+      }
+    }
+  }
+  std::sort(nghbr_ranks.begin(), nghbr_ranks.end());
+  nghbr_ranks.erase(std::unique(nghbr_ranks.begin(), nghbr_ranks.end()),
+                    nghbr_ranks.end());
+  // copy to device, where destination ranks of particles are looked up
+  Kokkos::realloc(d_nghbr_ranks, std::max(static_cast<int>(nghbr_ranks.size()), 1));
+  auto h_nghbr_ranks = Kokkos::create_mirror_view(d_nghbr_ranks);
+  for (std::size_t n=0; n<nghbr_ranks.size(); ++n) {
+    h_nghbr_ranks(n) = nghbr_ranks[n];
+  }
+  Kokkos::deep_copy(d_nghbr_ranks, h_nghbr_ranks);
+
+  if (mpi_comm_nghbr != MPI_COMM_NULL) {MPI_Comm_free(&mpi_comm_nghbr);}
+  int nnr = nghbr_ranks.size();
+  MPI_Dist_graph_create_adjacent(mpi_comm_part, nnr, nghbr_ranks.data(), MPI_UNWEIGHTED,
+                                 nnr, nghbr_ranks.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+                                 0, &mpi_comm_nghbr);
+  nghbr_version = pmy_part->pmy_pack->pmesh->mesh_version;
 #endif
-  return TaskStatus::complete;
+  return;
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void ParticlesBoundaryValues::InitPrtclRecv()
-//! \brief
+//! \fn void ParticlesBoundaryValues::CountSendsAndRecvs()
+//! \brief Orders sendlist by destination rank on the device, and exchanges number of
+//! particles sent with neighboring ranks only using MPI_Neighbor_alltoall.  The graph
+//! communicator and device copy of the neighboring ranks are rebuilt when the Mesh has
+//! changed (e.g. with AMR).
 
-TaskStatus ParticlesBoundaryValues::InitPrtclRecv() {
+TaskStatus ParticlesBoundaryValues::CountSendsAndRecvs() {
 #if MPI_PARALLEL_ENABLED
-  // load STL::vector of ParticleMessageData with <sendrank,recvrank,nprtcl_recv> for
-  // receives // on this rank. Length will be nrecvs, initially this length is unknown
-  recvs_thisrank.clear();
+  // rebuild graph communicator if MeshBlocks have been redistributed
+  if (nghbr_version != pmy_part->pmy_pack->pmesh->mesh_version) {SetNeighborRanks();}
+
+  // order sendlist by destination rank, and count particles sent to each neighbor rank
+  int nnr = nghbr_ranks.size();
+  std::vector<int> nsend_nghbr, nrecv_nghbr(nnr, 0);
+  SetSendOrder(d_nghbr_ranks, nnr, nsend_nghbr);
 
-  int nsends_allranks = sends_allranks.size();
-  for (int n=0; n<nsends_allranks; ++n) {
-    if (sends_allranks[n].recvrank == global_variable::my_rank) {
-      recvs_thisrank.emplace_back(sends_allranks[n]);
+  // exchange counts with neighboring ranks
+  MPI_Neighbor_alltoall(nsend_nghbr.data(), 1, MPI_INT, nrecv_nghbr.data(), 1, MPI_INT,
+                        mpi_comm_nghbr);
+
+  SetMessages(nghbr_ranks, nsend_nghbr, nrecv_nghbr);
+#endif
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::SetMessages()
+//! \brief Loads STL::vectors of ParticleMessageData with <sendrank, recvrank, nprtcls>
+//! for sends from and receives on this rank, given the number of particles sent to and
+//! received from each of the (sorted) ranks.  Messages are in order of rank, which is
+//! the same as the order of the sendlist.
+
+void ParticlesBoundaryValues::SetMessages(const std::vector<int> &ranks,
+                                          const std::vector<int> &nsend,
+                                          const std::vector<int> &nrecv) {
+  int &myrank = global_variable::my_rank;
+  sends_thisrank.clear();
+  recvs_thisrank.clear();
+  for (std::size_t n=0; n<ranks.size(); ++n) {
+    if (nsend[n] > 0) {
+      sends_thisrank.emplace_back(ParticleMessageData(myrank, ranks[n], nsend[n]));
+    }
+    if (nrecv[n] > 0) {
+      recvs_thisrank.emplace_back(ParticleMessageData(ranks[n], myrank, nrecv[n]));
     }
   }
+  nsends = sends_thisrank.size();
   nrecvs = recvs_thisrank.size();
+  return;
+}
 
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::InitPrtclRecv()
+//! \brief
+
+TaskStatus ParticlesBoundaryValues::InitPrtclRecv() {
+#if MPI_PARALLEL_ENABLED
   // Figure out how many particles will be received from all ranks
   nprtcl_recv=0;
   for (int n=0; n<nrecvs; ++n) {
     nprtcl_recv += recvs_thisrank[n].nprtcls;
   }
 
-  // Allocate receive buffer
-  Kokkos::realloc(prtcl_rrecvbuf, (pmy_part->nrdata)*nprtcl_recv);
-  Kokkos::realloc(prtcl_irecvbuf, (pmy_part->nidata)*nprtcl_recv);
+  // Grow receive buffers if needed
+  // only attributes flagged for migration are communicated
+  int nrdata = pmy_part->nrmigrate;
+  int nidata = pmy_part->nimigrate;
+  int capacity = prtcl_rrecvbuf.extent_int(0)/nrdata;
+  if (nprtcl_recv > capacity) {
+    capacity = GrowCapacity(capacity, nprtcl_recv);
+    Kokkos::realloc(prtcl_rrecvbuf, nrdata*capacity);
+    Kokkos::realloc(prtcl_irecvbuf, nidata*capacity);
+  }
 
   // Post non-blocking receives
   bool no_errors=true;
-  rrecv_req.clear();
-  irecv_req.clear();
-  for (int n=0; n<nrecvs; ++n) {
-    rrecv_req.emplace_back(MPI_REQUEST_NULL);
-    irecv_req.emplace_back(MPI_REQUEST_NULL);
-  }
+  rrecv_req.assign(nrecvs, MPI_REQUEST_NULL);
+  irecv_req.assign(nrecvs, MPI_REQUEST_NULL);
 
-  // Init receives for Reals
-  int data_start=0;
+  int prtcl_start=0;
   for (int n=0; n<nrecvs; ++n) {
-    // calculate amount of data to be passed, get pointer to variables
-    int data_size = (pmy_part->nrdata)*(recvs_thisrank[n].nprtcls);
-    int data_end = data_start + (pmy_part->nrdata)*(recvs_thisrank[n].nprtcls - 1);
-    auto recv_ptr = Kokkos::subview(prtcl_rrecvbuf, std::make_pair(data_start, data_end));
     int drank = recvs_thisrank[n].sendrank;
-    int tag = 0; // 0 for Reals, 1 for ints
-
-    // Post non-blocking receive
-    int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+    // Init receives for Reals (tag=0)
+    int ierr = MPI_Irecv(prtcl_rrecvbuf.data() + nrdata*prtcl_start,
+                         nrdata*recvs_thisrank[n].nprtcls, MPI_ATHENA_REAL, drank, 0,
                          mpi_comm_part, &(rrecv_req[n]));
     if (ierr != MPI_SUCCESS) {no_errors=false;}
-    data_start += data_size;
-  }
-  // Init receives for ints
-  data_start=0;
-  for (int n=0; n<nrecvs; ++n) {
-    // calculate amount of data to be passed, get pointer to variables
-    int data_size = (pmy_part->nidata)*(recvs_thisrank[n].nprtcls);
-    int data_end = data_start + (pmy_part->nidata)*(recvs_thisrank[n].nprtcls - 1);
-    auto recv_ptr = Kokkos::subview(prtcl_irecvbuf, std::make_pair(data_start, data_end));
-    int drank = recvs_thisrank[n].sendrank;
-    int tag = 1; // 0 for Reals, 1 for ints
-
-    // Post non-blocking receive
-    int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_INT, drank, tag,
-                         mpi_comm_part, &(irecv_req[n]));
+    // Init receives for ints (tag=1)
+    ierr = MPI_Irecv(prtcl_irecvbuf.data() + nidata*prtcl_start,
+                     nidata*recvs_thisrank[n].nprtcls, MPI_INT, drank, 1,
+                     mpi_comm_part, &(irecv_req[n]));
     if (ierr != MPI_SUCCESS) {no_errors=false;}
-    data_start += data_size;
+    prtcl_start += recvs_thisrank[n].nprtcls;
   }
 
   // Quit if MPI error detected
@@ -329,76 +436,56 @@ TaskStatus ParticlesBoundaryValues::InitPrtclRecv() {
 
 TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
 #if MPI_PARALLEL_ENABLED
-  // Figure out how many particles will be sent from this ranks
-  nprtcl_send=0;
-  for (int n=0; n<nsends; ++n) {
-    nprtcl_send += sends_thisrank[n].nprtcls;
-  }
-
   bool no_errors=true;
   if (nprtcl_send > 0) {
-    // Allocate send buffer
-    Kokkos::realloc(prtcl_rsendbuf, (pmy_part->nrdata)*nprtcl_send);
-    Kokkos::realloc(prtcl_isendbuf, (pmy_part->nidata)*nprtcl_send);
-
-    // sendlist on device is already sorted by destrank in CountSendAndRecvs()
-    // Use sendlist on device to load particles into send buffer ordered by dest_rank
-    int nrdata = pmy_part->nrdata;
-    int nidata = pmy_part->nidata;
+    // Grow send buffers if needed
+    // only attributes flagged for migration are communicated
+    int nrdata = pmy_part->nrmigrate;
+    int nidata = pmy_part->nimigrate;
+    int capacity = prtcl_rsendbuf.extent_int(0)/nrdata;
+    if (nprtcl_send > capacity) {
+      capacity = GrowCapacity(capacity, nprtcl_send);
+      Kokkos::realloc(prtcl_rsendbuf, nrdata*capacity);
+      Kokkos::realloc(prtcl_isendbuf, nidata*capacity);
+    }
+
+    // Use send_order (set in SetSendOrder()) to load particles into send buffer ordered
+    // by dest_rank
     auto &pr = pmy_part->prtcl_rdata;
     auto &pi = pmy_part->prtcl_idata;
     auto &rsendbuf = prtcl_rsendbuf;
     auto &isendbuf = prtcl_isendbuf;
+    auto &slist = sendlist;
+    auto &order = send_order;
+    auto &imig = pmy_part->imigrate;
+    auto &rmig = pmy_part->rmigrate;
     par_for("ppack",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
-      int p = sendlist.d_view(n).prtcl_indx;
+      int p = slist(order(n)).prtcl_indx;
       for (int i=0; i<nidata; ++i) {
-        isendbuf(nidata*n + i) = pi(i,p);
+        isendbuf(nidata*n + i) = pi(imig.d_view(i),p);
       }
       for (int i=0; i<nrdata; ++i) {
-        rsendbuf(nrdata*n + i) = pr(i,p);
+        rsendbuf(nrdata*n + i) = pr(rmig.d_view(i),p);
       }
     });
 
-    // Post non-blocking sends
-    Kokkos::fence();
-    rsend_req.clear();
-    isend_req.clear();
+    // Post non-blocking sends, one message of Reals (tag=0) and ints (tag=1) for each
+    // neighboring rank
+    TaskExecSpace().fence();
+    rsend_req.assign(nsends, MPI_REQUEST_NULL);
+    isend_req.assign(nsends, MPI_REQUEST_NULL);
+    int prtcl_start=0;
     for (int n=0; n<nsends; ++n) {
-      rsend_req.emplace_back(MPI_REQUEST_NULL);
-      isend_req.emplace_back(MPI_REQUEST_NULL);
-    }
-
-    // Send Reals
-    int data_start=0;
-    for (int n=0; n<nsends; ++n) {
-      // calculate amount of data to be passed, get pointer to variables
-      int data_size = nrdata*(sends_thisrank[n].nprtcls);
-      int data_end = data_start + nrdata*(sends_thisrank[n].nprtcls - 1);
-      auto send_ptr = Kokkos::subview(prtcl_rsendbuf,std::make_pair(data_start,data_end));
       int drank = sends_thisrank[n].recvrank;
-      int tag = 0; // 0 for Reals, 1 for ints
-
-      // Post non-blocking sends
-      int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+      int ierr = MPI_Isend(prtcl_rsendbuf.data() + nrdata*prtcl_start,
+                           nrdata*sends_thisrank[n].nprtcls, MPI_ATHENA_REAL, drank, 0,
                            mpi_comm_part, &(rsend_req[n]));
       if (ierr != MPI_SUCCESS) {no_errors=false;}
-      data_start += data_size;
-    }
-    // Send ints
-    data_start=0;
-    for (int n=0; n<nsends; ++n) {
-      // calculate amount of data to be passed, get pointer to variables
-      int data_size = nidata*(sends_thisrank[n].nprtcls);
-      int data_end = data_start + nidata*(sends_thisrank[n].nprtcls - 1);
-      auto send_ptr = Kokkos::subview(prtcl_isendbuf,std::make_pair(data_start,data_end));
-      int drank = sends_thisrank[n].recvrank;
-      int tag = 1; // 0 for Reals, 1 for ints
-
-      // Post non-blocking sends
-      int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_INT, drank, tag,
-                           mpi_comm_part, &(isend_req[n]));
+      ierr = MPI_Isend(prtcl_isendbuf.data() + nidata*prtcl_start,
+                       nidata*sends_thisrank[n].nprtcls, MPI_INT, drank, 1,
+                       mpi_comm_part, &(isend_req[n]));
       if (ierr != MPI_SUCCESS) {no_errors=false;}
-      data_start += data_size;
+      prtcl_start += sends_thisrank[n].nprtcls;
     }
   }
 
@@ -414,24 +501,13 @@ TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
 
 //----------------------------------------------------------------------------------------
 //! \fn void ParticlesBoundaryValues::RecvAndUnpackPrtcls()
-//! \brief
+//! \brief Unpacks received particles into holes left by sent particles (or at the end of
+//! the particle arrays), then fills any remaining holes by moving particles from the end
+//! of the arrays, using a prefix scan on the device.  Capacity of particle arrays only
+//! grows, so they are not reallocated every step.
 
 TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
 #if MPI_PARALLEL_ENABLED
-  // Sort sendlist on host by index in particle array
-  namespace KE = Kokkos::Experimental;
-  std::sort(KE::begin(sendlist.h_view), KE::end(sendlist.h_view), SortByIndex);
-  // sync sendlist host array with device.  This results in sorted array on device
-  sendlist.template modify<HostMemSpace>();
-  sendlist.template sync<DevExeSpace>();
-
-  // increase size of particle arrays if needed
-  int new_npart = pmy_part->nprtcl_thispack + (nprtcl_recv - nprtcl_send);
-  if (nprtcl_recv > nprtcl_send) {
-    Kokkos::resize(pmy_part->prtcl_idata, pmy_part->nidata, new_npart);
-    Kokkos::resize(pmy_part->prtcl_rdata, pmy_part->nrdata, new_npart);
-  }
-
   // check that particle communications have all completed
   bool bflag = false;
   bool no_errors=true;
@@ -458,60 +534,71 @@ TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
   // exit if particle communications have not completed
   if (bflag) {return TaskStatus::incomplete;}
 
-  // unpack particles into positions of sent particles
-  if (nprtcl_recv > 0) {
-    int nrdata = pmy_part->nrdata;
-    int nidata = pmy_part->nidata;
-    auto &pr = pmy_part->prtcl_rdata;
-    auto &pi = pmy_part->prtcl_idata;
+  // increase capacity of particle arrays if needed
+  int npart = pmy_part->nprtcl_thispack;
+  int new_npart = npart + (nprtcl_recv - nprtcl_send);
+  pmy_part->ReserveParticles(new_npart);
+
+  int nrdata = pmy_part->nrdata;
+  int nidata = pmy_part->nidata;
+  auto &pr = pmy_part->prtcl_rdata;
+  auto &pi = pmy_part->prtcl_idata;
+  auto &slist = sendlist;
+  int nsend = nprtcl_send, nrecv = nprtcl_recv;
+
+  // If (nprtcl_recv < nprtcl_send), holes nrecv...nsend-1 of sendlist are not filled by
+  // received particles.  Those below new_npart are filled by the particles (that are not
+  // holes) in [new_npart,npart), in order, with the index of each given by a prefix scan.
+  // Since sendlist is sorted by index, no hole filled by received particles is moved.
+  if (nrecv < nsend) {
+    auto &pdest = prtcl_dest;
+    Kokkos::parallel_scan("pcompact", Kokkos::RangePolicy<>(TaskExecSpace(), new_npart,
+                                                           npart),
+    KOKKOS_LAMBDA(const int p, int &index, const bool is_final) {
+      if (pdest(p) < 0) {
+        if (is_final) {
+          int hole = slist(nrecv + index).prtcl_indx;
+          for (int i=0; i<nidata; ++i) {
+            pi(i,hole) = pi(i,p);
+          }
+          for (int i=0; i<nrdata; ++i) {
+            pr(i,hole) = pr(i,p);
+          }
+        }
+        ++index;
+      }
+    });
+  }
+
+  // unpack particles into positions of sent particles.  Attributes that are not
+  // communicated are set to zero.
+  if (nrecv > 0) {
     auto &rrecvbuf = prtcl_rrecvbuf;
     auto &irecvbuf = prtcl_irecvbuf;
-    int &npart = pmy_part->nprtcl_thispack;
-    par_for("punpack",DevExeSpace(),0,(nprtcl_recv-1), KOKKOS_LAMBDA(const int n) {
+    auto &imig = pmy_part->imigrate;
+    auto &rmig = pmy_part->rmigrate;
+    int nimig = pmy_part->nimigrate;
+    int nrmig = pmy_part->nrmigrate;
+    par_for("punpack",DevExeSpace(),0,(nrecv-1), KOKKOS_LAMBDA(const int n) {
       int p;
-      if (n < nprtcl_send) {
-        p = sendlist.d_view(n).prtcl_indx; // place particles in holes created by sends
+      if (n < nsend) {
+        p = slist(n).prtcl_indx; // place particles in holes created by sends
       } else {
-        p = npart + (n - nprtcl_send);     // place particle at end of arrays
+        p = npart + (n - nsend);        // place particle at end of arrays
       }
       for (int i=0; i<nidata; ++i) {
-        pi(i,p) = irecvbuf(nidata*n + i);
+        pi(i,p) = 0;
       }
       for (int i=0; i<nrdata; ++i) {
-        pr(i,p) = rrecvbuf(nrdata*n + i);
+        pr(i,p) = 0.0;
       }
-    });
-  }
-
-  // At this point have filled npart_recv holes in particle arrays from sends
-  // If (nprtcl_recv < nprtcl_send), have to move particles from end of arrays to fill
-  // remaining holes
-  int nremain = nprtcl_send - nprtcl_recv;
-  if (nremain > 0) {
-    int &npart = pmy_part->nprtcl_thispack;
-    int i_last_hole = nprtcl_send-1;
-    int i_next_hole = nprtcl_recv;
-    for (int n=1; n<=nremain; ++n) {
-      int nend = npart-n;
-      if (nend > sendlist.h_view(i_last_hole).prtcl_indx) {
-        // copy particle from end into hole
-        int next_hole = sendlist.h_view(i_next_hole).prtcl_indx;
-        auto rdest = Kokkos::subview(pmy_part->prtcl_rdata, Kokkos::ALL, next_hole);
-        auto rsrc  = Kokkos::subview(pmy_part->prtcl_rdata, Kokkos::ALL, nend);
-        Kokkos::deep_copy(rdest, rsrc);
-        auto idest = Kokkos::subview(pmy_part->prtcl_idata, Kokkos::ALL, next_hole);
-        auto isrc  = Kokkos::subview(pmy_part->prtcl_idata, Kokkos::ALL, nend);
-        Kokkos::deep_copy(idest, isrc);
-        i_next_hole += 1;
-      } else {
-        // this index contains a hole, so do nothing except find new index of last hole
-        i_last_hole -= 1;
+      for (int i=0; i<nimig; ++i) {
+        pi(imig.d_view(i),p) = irecvbuf(nimig*n + i);
       }
-    }
-
-    // shrink size of particle data arrays
-    Kokkos::resize(pmy_part->prtcl_idata, pmy_part->nidata, new_npart);
-    Kokkos::resize(pmy_part->prtcl_rdata, pmy_part->nrdata, new_npart);
+      for (int i=0; i<nrmig; ++i) {
+        pr(rmig.d_view(i),p) = rrecvbuf(nrmig*n + i);
+      }
+    });
   }
 
   // Update nparticles_thisrank.  Update cost array (use npart_thismb[nmb]?)
@@ -577,4 +664,79 @@ TaskStatus ParticlesBoundaryValues::ClearPrtclRecv() {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::RedistributeParticles()
+//! \brief Moves particles with their MeshBlocks when MBs are redistributed over ranks
+//! and/or refined.  The new GID and rank of the MB containing each particle are given by
+//! new_gid(m,o) and new_rank(m,o), where m is the index of the old MB on this rank and o
+//! the octant of the old MB containing the particle (which only matters for refined MBs).
+//! Since particles can move to any rank, the number of particles sent is exchanged
+//! between all ranks.  Called while the old MBs still exist, and must be called on all
+//! ranks.
+
+void ParticlesBoundaryValues::RedistributeParticles(DualArray2D<int> &new_gid,
+                                                    DualArray2D<int> &new_rank) {
+  auto gids = pmy_part->pmy_pack->gids;
+  auto &pr = pmy_part->prtcl_rdata;
+  auto &pi = pmy_part->prtcl_idata;
+  int npart = pmy_part->nprtcl_thispack;
+  auto &mbsize = pmy_part->pmy_pack->pmb->mb_size;
+  auto myrank = global_variable::my_rank;
+  bool &multi_d = pmy_part->pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_part->pmy_pack->pmesh->three_d;
+  if (prtcl_dest.extent_int(0) < npart) {
+    Kokkos::realloc(prtcl_dest, GrowCapacity(prtcl_dest.extent_int(0), npart));
+  }
+  auto &pdest = prtcl_dest;
+  par_for("part_redist",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
+    int m = pi(PGID,p) - gids;
+    int fx = (pr(IPX,p) < 0.5*(mbsize.d_view(m).x1min + mbsize.d_view(m).x1max))? 0 : 1;
+    int fy = (pr(IPY,p) < 0.5*(mbsize.d_view(m).x2min + mbsize.d_view(m).x2max))? 0 : 1;
+    int fz = 0;
+    if (three_d) {
+      fz = (pr(IPZ,p) < 0.5*(mbsize.d_view(m).x3min + mbsize.d_view(m).x3max))? 0 : 1;
+    }
+    int o = fx + ((multi_d)? 2*fy : 0) + 4*fz;
+    pi(PGID,p) = new_gid.d_view(m,o);
+    pdest(p) = (new_rank.d_view(m,o) != myrank)? new_rank.d_view(m,o) : -1;
+  });
+  pmy_part->sorted = false;
+
+#if MPI_PARALLEL_ENABLED
+  BuildSendList();
+
+  // order sendlist by destination rank, and exchange counts with all ranks
+  int nranks = global_variable::nranks;
+  std::vector<int> ranks(nranks), nsend, nrecv(nranks, 0);
+  for (int n=0; n<nranks; ++n) {ranks[n] = n;}
+  DvceArray1D<int> d_ranks("d_ranks", nranks);
+  par_for("part_ranks",DevExeSpace(),0,(nranks-1), KOKKOS_LAMBDA(const int n) {
+    d_ranks(n) = n;
+  });
+  SetSendOrder(d_ranks, nranks, nsend);
+  MPI_Alltoall(nsend.data(), 1, MPI_INT, nrecv.data(), 1, MPI_INT, mpi_comm_part);
+  SetMessages(ranks, nsend, nrecv);
+
+  // communicate particles and wait for all messages
+  InitPrtclRecv();
+  PackAndSendPrtcls();
+  while (RecvAndUnpackPrtcls() == TaskStatus::incomplete) {}
+  ClearPrtclSend();
+  ClearPrtclRecv();
+#endif
+  return;
+}
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn void ParticlesBoundaryValues::AddRecvRequests()
+//! \brief Appends pointers to the requests of receives of particles from other ranks
+
+void ParticlesBoundaryValues::AddRecvRequests(std::vector<MPI_Request*> &reqs) {
+  for (auto &req : rrecv_req) {reqs.push_back(&req);}
+  for (auto &req : irecv_req) {reqs.push_back(&req);}
+  return;
+}
+#endif
+
 } // namespace particles
@@ -0,0 +1,161 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file bvals_shm.cpp
+//! \brief functions to exchange aggregated messages with ranks on the same node through
+//! an MPI-3 shared-memory window, rather than through MPI point-to-point messages.
+//!
+//! Each rank allocates a window holding one ShmMessageHeader for every rank on its node,
+//! followed by space for all its aggregated receives (with the same layout as agg_rbuf).
+//! A sender copies its message directly into the window of the receiver and then sets
+//! the sequence number in the header.  The receiver polls the sequence number, copies the
+//! message into agg_rbuf, and acknowledges it, after which the sender may overwrite it.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::SetSharedMessages
+//! \brief (Re)creates the shared-memory receive window after aggregated messages have
+//! been rebuilt in SetAggregatedMessages().  Collective over the ranks of the node, which
+//! all rebuild their messages at the same time (when the neighbors of MeshBlocks change).
+
+void MeshBoundaryValues::SetSharedMessages(const int nvar) {
+#if MPI_PARALLEL_ENABLED
+  FreeSharedMessages();
+
+  // ranks of neighbors within node communicator (-1 if neighbor is on another node)
+  int nnode;
+  MPI_Comm_size(comm_node, &nnode);
+  MPI_Group world_group, node_group;
+  MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+  MPI_Comm_group(comm_node, &node_group);
+  shm_nrank.assign(agg_ranks.size(), -1);
+  if (!(agg_ranks.empty())) {
+    MPI_Group_translate_ranks(world_group, static_cast<int>(agg_ranks.size()),
+                              agg_ranks.data(), node_group, shm_nrank.data());
+  }
+  MPI_Group_free(&world_group);
+  MPI_Group_free(&node_group);
+  for (auto &nr : shm_nrank) {
+    if (nr == MPI_UNDEFINED) {nr = -1;}
+  }
+
+  // allocate window, and initialize headers of messages received from on-node ranks
+  MPI_Aint hdr_size = nnode*sizeof(ShmMessageHeader);
+  MPI_Aint win_size = hdr_size + nvar*agg_rtotal*sizeof(Real);
+  char *pbase;
+  MPI_Win_allocate_shared(win_size, 1, MPI_INFO_NULL, comm_node, &pbase, &shm_win);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, shm_win);
+  shm_rhdr = reinterpret_cast<ShmMessageHeader*>(pbase);
+  shm_rdata = reinterpret_cast<Real*>(pbase + hdr_size);
+  for (int n=0; n<nnode; ++n) {
+    shm_rhdr[n].offset = -1;
+    shm_rhdr[n].seq = 0;
+    shm_rhdr[n].ack = 0;
+  }
+  for (std::size_t r=0; r<agg_ranks.size(); ++r) {
+    if (shm_nrank[r] >= 0) {shm_rhdr[shm_nrank[r]].offset = nvar*agg_rstart[r];}
+  }
+  MPI_Win_sync(shm_win);
+  MPI_Barrier(comm_node);
+  MPI_Win_sync(shm_win);
+
+  // locate headers and data of messages sent to on-node ranks in their windows
+  int my_nrank;
+  MPI_Comm_rank(comm_node, &my_nrank);
+  shm_shdr.assign(agg_ranks.size(), nullptr);
+  shm_sdata.assign(agg_ranks.size(), nullptr);
+  for (std::size_t r=0; r<agg_ranks.size(); ++r) {
+    if (shm_nrank[r] < 0) continue;
+    MPI_Aint size;
+    int disp_unit;
+    char *pnghbr;
+    MPI_Win_shared_query(shm_win, shm_nrank[r], &size, &disp_unit, &pnghbr);
+    shm_shdr[r] = reinterpret_cast<ShmMessageHeader*>(pnghbr) + my_nrank;
+    if (shm_shdr[r]->offset < 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "No shared-memory receive posted by rank " << agg_ranks[r]
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    shm_sdata[r] = reinterpret_cast<Real*>(pnghbr + hdr_size) + shm_shdr[r]->offset;
+  }
+  shm_sseq = 0;
+  shm_rseq = 0;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::FreeSharedMessages
+//! \brief Frees the shared-memory receive window (if any).  Collective over the node.
+
+void MeshBoundaryValues::FreeSharedMessages() {
+#if MPI_PARALLEL_ENABLED
+  if (shm_win != MPI_WIN_NULL) {
+    MPI_Win_unlock_all(shm_win);
+    MPI_Win_free(&shm_win);
+  }
+  shm_rhdr = nullptr;
+  shm_rdata = nullptr;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::SendSharedMessage
+//! \brief Copies the (host-staged) aggregated message for the r-th neighboring rank into
+//! its shared-memory window.  Waits until the receiver has read the previous message.
+
+void MeshBoundaryValues::SendSharedMessage(std::size_t r) {
+#if MPI_PARALLEL_ENABLED
+  ShmMessageHeader *phdr = shm_shdr[r];
+  while (phdr->ack < shm_sseq - 1) {MPI_Win_sync(shm_win);}
+  std::memcpy(shm_sdata[r], agg_sbuf.h_view.data() + agg_nvar*agg_sstart[r],
+              agg_nvar*agg_ssize[r]*sizeof(Real));
+  MPI_Win_sync(shm_win);
+  phdr->seq = shm_sseq;
+  MPI_Win_sync(shm_win);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool MeshBoundaryValues::TestSharedRecvs
+//! \brief Copies messages from on-node ranks that have arrived in the shared-memory
+//! window into agg_rbuf, and returns true when all have been received.  If wait is true,
+//! spins until all messages have arrived.
+
+bool MeshBoundaryValues::TestSharedRecvs(bool wait) {
+  bool all_recvd = true;
+#if MPI_PARALLEL_ENABLED
+  for (std::size_t r=0; r<agg_ranks.size(); ++r) {
+    if (shm_nrank[r] < 0) continue;
+    ShmMessageHeader *phdr = &(shm_rhdr[shm_nrank[r]]);
+    if (phdr->ack == shm_rseq) continue;
+    MPI_Win_sync(shm_win);
+    while (wait && (phdr->seq != shm_rseq)) {MPI_Win_sync(shm_win);}
+    if (phdr->seq == shm_rseq) {
+      MPI_Win_sync(shm_win);
+      std::memcpy(agg_rbuf.h_view.data() + agg_nvar*agg_rstart[r],
+                  shm_rdata + phdr->offset, agg_nvar*agg_rsize[r]*sizeof(Real));
+      MPI_Win_sync(shm_win);
+      phdr->ack = shm_rseq;
+      MPI_Win_sync(shm_win);
+    } else {
+      all_recvd = false;
+    }
+  }
+#endif
+  return all_recvd;
+}
@@ -36,6 +36,40 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
 
   // Initialize communications of variables
   bool no_errors=true;
+
+  // With aggregated messages, post one receive for each neighboring rank
+  if (aggregate_msgs) {
+    SetAggregatedMessages(nvars);
+    // messages combined with other physics are received once all members are ready
+    if (Grouped()) {
+      pmsg_group->PostRecvs();
+      return TaskStatus::complete;
+    }
+    if (persistent_reqs) {
+      if (!(agg_rreq.empty())) {
+        int ierr = MPI_Startall(agg_rreq.size(), agg_rreq.data());
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+      }
+    } else {
+      Real *rptr = (gpu_aware_mpi) ? agg_rbuf.d_view.data() : agg_rbuf.h_view.data();
+      if (shm_exchange) {shm_rseq++;}
+      for (std::size_t r=0; r<agg_ranks.size(); ++r) {
+        // messages from ranks on the same node arrive through shared memory
+        if (shm_exchange && shm_nrank[r] >= 0) continue;
+        int ierr = MPI_Irecv(rptr + nvars*agg_rstart[r], nvars*agg_rsize[r],
+                             MPI_ATHENA_REAL, agg_ranks[r], 0,
+                             comm_vars, &(agg_rreq[r]));
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+      }
+    }
+    if (!(no_errors)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "MPI error in posting non-blocking receives" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    return TaskStatus::complete;
+  }
+
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<nnghbr; ++n) {
       if (nghbr.h_view(m,n).gid >= 0) {
@@ -60,11 +94,18 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
           } else {
             data_size *= recvbuf[n].ifine_ndat;
           }
-          auto recv_ptr = Kokkos::subview(recvbuf[n].vars, m, Kokkos::ALL);
-
           // Post non-blocking receive for this buffer on this MeshBlock
-          int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
-                               comm_vars, &(recvbuf[n].vars_req[m]));
+          int ierr;
+          if (reduced_msgs &&
+              nghbr.h_view(m,n).lev != pmy_pack->pmb->mb_lev.h_view(m)) {
+            auto recv_ptr = Kokkos::subview(recvbuf[n].vars_lo, m, Kokkos::ALL);
+            ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REDUCED_REAL,
+                             drank, tag, comm_vars, &(recvbuf[n].vars_req[m]));
+          } else {
+            auto recv_ptr = Kokkos::subview(recvbuf[n].vars, m, Kokkos::ALL);
+            ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL,
+                             drank, tag, comm_vars, &(recvbuf[n].vars_req[m]));
+          }
           if (ierr != MPI_SUCCESS) {no_errors=false;}
         }
       }
@@ -93,12 +134,22 @@ TaskStatus MeshBoundaryValues::ClearRecv() {
   auto &nghbr = pmy_pack->pmb->nghbr;
 
   // wait for all non-blocking receives for vars to finish before continuing
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if ( (nghbr.h_view(m,n).gid >= 0) &&
-           (nghbr.h_view(m,n).rank != global_variable::my_rank) ) {
-        int ierr = MPI_Wait(&(recvbuf[n].vars_req[m]), MPI_STATUS_IGNORE);
-        if (ierr != MPI_SUCCESS) {no_errors=false;}
+  if (Grouped()) {
+    return pmsg_group->ClearRecv();
+  } else if (aggregate_msgs) {
+    for (auto &req : agg_rreq) {
+      int ierr = MPI_Wait(&req, MPI_STATUS_IGNORE);
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+    if (shm_exchange) {(void) TestSharedRecvs(true);}
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if ( (nghbr.h_view(m,n).gid >= 0) &&
+             (nghbr.h_view(m,n).rank != global_variable::my_rank) ) {
+          int ierr = MPI_Wait(&(recvbuf[n].vars_req[m]), MPI_STATUS_IGNORE);
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+        }
       }
     }
   }
@@ -125,12 +176,21 @@ TaskStatus MeshBoundaryValues::ClearSend() {
   auto &nghbr = pmy_pack->pmb->nghbr;
 
   // wait for all non-blocking sends for vars to finish before continuing
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if ( (nghbr.h_view(m,n).gid >= 0) &&
-           (nghbr.h_view(m,n).rank != global_variable::my_rank) ) {
-        int ierr = MPI_Wait(&(sendbuf[n].vars_req[m]), MPI_STATUS_IGNORE);
-        if (ierr != MPI_SUCCESS) {no_errors=false;}
+  if (Grouped()) {
+    return pmsg_group->ClearSend();
+  } else if (aggregate_msgs) {
+    for (auto &req : agg_sreq) {
+      int ierr = MPI_Wait(&req, MPI_STATUS_IGNORE);
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if ( (nghbr.h_view(m,n).gid >= 0) &&
+             (nghbr.h_view(m,n).rank != global_variable::my_rank) ) {
+          int ierr = MPI_Wait(&(sendbuf[n].vars_req[m]), MPI_STATUS_IGNORE);
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+        }
       }
     }
   }
@@ -157,6 +217,12 @@ TaskStatus MeshBoundaryValues::ClearFluxRecv() {
   auto &nghbr = pmy_pack->pmb->nghbr;
 
   // wait for all non-blocking receives for fluxes to finish before continuing
+  if (aggregate_msgs) {
+    for (auto &req : aflx_rreq) {
+      int ierr = MPI_Wait(&req, MPI_STATUS_IGNORE);
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+  }
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<nnghbr; ++n) {
       if ( (nghbr.h_view(m,n).gid >= 0) &&
@@ -186,6 +252,12 @@ TaskStatus MeshBoundaryValues::ClearFluxSend() {
   auto &nghbr = pmy_pack->pmb->nghbr;
 
   // wait for all non-blocking sends for fluxes to finish before continuing
+  if (aggregate_msgs) {
+    for (auto &req : aflx_sreq) {
+      int ierr = MPI_Wait(&req, MPI_STATUS_IGNORE);
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+  }
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<nnghbr; ++n) {
       if ( (nghbr.h_view(m,n).gid >= 0) &&
@@ -26,7 +26,8 @@
 //! MeshBlocks. Buffer data are then sent (via MPI) or copied directly for periodic or
 //! block boundaries.
 
-TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
+TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<FluxReal> &flx) {
+  ScopedTimer comm_timer(pmy_pack->pmesh->pcounter.t_comm);
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
@@ -44,9 +45,15 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
   auto &rbuf = recvbuf;
   auto &one_d = pmy_pack->pmesh->one_d;
   auto &two_d = pmy_pack->pmesh->two_d;
+  // With aggregated messages, buffers sent to other ranks are packed directly into one
+  // contiguous message per rank at offsets computed in SetAggregatedFluxMessages()
+  if (aggregate_msgs) {SetAggregatedFluxMessages(nvar);}
+  bool agg = aggregate_msgs;
+  auto &sofst = aflx_soffset;
+  auto &asbuf = aflx_sbuf.d_view;
 
   // Outer loop over (# of MeshBlocks)*(# of neighbors)*(# of variables)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
+  Kokkos::TeamPolicy<> policy(TaskExecSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
   Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int m = (tmember.league_rank())/(nnghbr*nvar);
     const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
@@ -73,6 +80,8 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
 
     // only pack buffers when neighbor is at coarser level
     if ((nghbr.d_view(m,n).gid >=0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
+      Real *psend = (agg && sofst.d_view(m,n) >= 0) ?
+                        &asbuf(nvar*sofst.d_view(m,n)) : &sbuf[n].flux(m,0);
       // x1faces
       if (n<8) {
         // i-index is fixed for flux correction on x1faces
@@ -97,7 +106,7 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
             rbuf[dn].flux(dm, (j-jl + nj*(k-kl + nk*v)) ) = rflx;
           // else copy into send buffer for MPI communication below
           } else {
-            sbuf[n].flux(m, (j-jl + nj*(k-kl + nk*v)) ) = rflx;
+            psend[j-jl + nj*(k-kl + nk*v)] = rflx;
           }
         });
         tmember.team_barrier();
@@ -124,7 +133,7 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
             rbuf[dn].flux(dm, (i-il + ni*(k-kl + nk*v)) ) = rflx;
           // else copy into send buffer for MPI communication below
           } else {
-            sbuf[n].flux(m, (i-il + ni*(k-kl + nk*v)) ) = rflx;
+            psend[i-il + ni*(k-kl + nk*v)] = rflx;
           }
         });
         tmember.team_barrier();
@@ -146,7 +155,7 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
             rbuf[dn].flux(dm, (i-il + ni*(j-jl + nj*v)) ) = rflx;
           // else copy into send buffer for MPI communication below
           } else {
-            sbuf[n].flux(m, (i-il + ni*(j-jl + nj*v)) ) = rflx;
+            psend[i-il + ni*(j-jl + nj*v)] = rflx;
           }
         });
         tmember.team_barrier();
@@ -157,8 +166,24 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
 #if MPI_PARALLEL_ENABLED
   // Send boundary buffer to neighboring MeshBlocks using MPI
   // Sends only occur to neighbors on FACES at a COARSER level
-  Kokkos::fence();
+  TaskExecSpace().fence();
   bool no_errors=true;
+  // With aggregated messages, send one message to each coarser neighboring rank
+  if (aggregate_msgs) {
+    if (!(gpu_aware_mpi)) {
+      aflx_sbuf.template modify<DevExeSpace>();
+      aflx_sbuf.template sync<HostMemSpace>();
+    }
+    Real *sptr = (gpu_aware_mpi) ? aflx_sbuf.d_view.data() : aflx_sbuf.h_view.data();
+    for (std::size_t r=0; r<aflx_sranks.size(); ++r) {
+      int ierr = MPI_Isend(sptr + nvar*aflx_sstart[r], nvar*aflx_ssize[r],
+                           MPI_ATHENA_REAL, aflx_sranks[r], 0,
+                           comm_flux, &(aflx_sreq[r]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+      pmy_pack->pmesh->pcounter.nbytes_sent += nvar*aflx_ssize[r]*sizeof(Real);
+    }
+    nmb = 0;  // skip sends of individual buffers below
+  }
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<nnghbr; ++n) {
       if ( (nghbr.h_view(m,n).gid >=0) &&
@@ -177,9 +202,10 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
           int data_size = nvar*(sendbuf[n].iflxc_ndat);
           auto send_ptr = Kokkos::subview(sendbuf[n].flux, m, Kokkos::ALL);
 
-          int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
-                               comm_flux, &(sendbuf[n].flux_req[m]));
+          int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL,
+                               drank, tag, comm_flux, &(sendbuf[n].flux_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          pmy_pack->pmesh->pcounter.nbytes_sent += data_size*sizeof(Real);
         }
       }
     }
@@ -198,7 +224,8 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
 //! \fn void RecvBuffers()
 //! \brief Unpack boundary buffers for flux correction of CC variables.
 
-TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
+TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<FluxReal> &flx) {
+  ScopedTimer comm_timer(pmy_pack->pmesh->pcounter.t_comm);
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
@@ -211,17 +238,28 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
 
   bool bflag = false;
   bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if ( (nghbr.h_view(m,n).gid >=0) &&
-           (nghbr.h_view(m,n).lev > mblev.h_view(m)) &&
-           ((n<16) || ((n>=24) && (n<32))) ) {
-        if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
-          int test;
-          int ierr = MPI_Test(&(rbuf[n].flux_req[m]), &test, MPI_STATUS_IGNORE);
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
-          if (!(static_cast<bool>(test))) {
-            bflag = true;
+  if (aggregate_msgs) {
+    for (auto &req : aflx_rreq) {
+      int test;
+      int ierr = MPI_Test(&req, &test, MPI_STATUS_IGNORE);
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+      if (!(static_cast<bool>(test))) {
+        bflag = true;
+      }
+    }
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if ( (nghbr.h_view(m,n).gid >=0) &&
+             (nghbr.h_view(m,n).lev > mblev.h_view(m)) &&
+             ((n<16) || ((n>=24) && (n<32))) ) {
+          if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
+            int test;
+            int ierr = MPI_Test(&(rbuf[n].flux_req[m]), &test, MPI_STATUS_IGNORE);
+            if (ierr != MPI_SUCCESS) {no_errors=false;}
+            if (!(static_cast<bool>(test))) {
+              bflag = true;
+            }
           }
         }
       }
@@ -236,14 +274,23 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
   }
   // exit if recv boundary buffer communications have not completed
   if (bflag) {return TaskStatus::incomplete;}
+  // copy messages staged through host memory to device
+  if (aggregate_msgs && !(gpu_aware_mpi)) {
+    aflx_rbuf.template modify<HostMemSpace>();
+    aflx_rbuf.template sync<DevExeSpace>();
+  }
 #endif
 
   //----- STEP 2: buffers have all completed, so unpack
 
   int nvar = flx.x1f.extent_int(1); // TODO(@user): 2nd idx from L of in arr must be NVAR
+  // buffers received from other ranks are unpacked from aggregated messages if used
+  bool agg = aggregate_msgs;
+  auto &rofst = aflx_roffset;
+  auto &arbuf = aflx_rbuf.d_view;
 
   // Outer loop over (# of MeshBlocks)*(# of neighbors)*(# of variables)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
+  Kokkos::TeamPolicy<> policy(TaskExecSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
   Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int m = (tmember.league_rank())/(nnghbr*nvar);
     const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
@@ -265,13 +312,15 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
 
     // only unpack buffers for faces when neighbor is at finer level
     if ((nghbr.d_view(m,n).gid >=0) && (nghbr.d_view(m,n).lev > mblev.d_view(m))) {
+      const Real *precv = (agg && rofst.d_view(m,n) >= 0) ?
+                              &arbuf(nvar*rofst.d_view(m,n)) : &rbuf[n].flux(m,0);
       //x1 faces
       if (n<8) {
         Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
           int k = idx / nj;
           int j = (idx - k * nj) + jl;
           k += kl;
-          flx.x1f(m,v,k,j,il) = rbuf[n].flux(m,(j-jl + nj*(k-kl + nk*v)));
+          flx.x1f(m,v,k,j,il) = precv[j-jl + nj*(k-kl + nk*v)];
         });
         tmember.team_barrier();
       // x2faces
@@ -280,7 +329,7 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
           int k = idx / ni;
           int i = (idx - k * ni) + il;
           k += kl;
-          flx.x2f(m,v,k,jl,i) = rbuf[n].flux(m,(i-il + ni*(k-kl + nk*v)));
+          flx.x2f(m,v,k,jl,i) = precv[i-il + ni*(k-kl + nk*v)];
         });
         tmember.team_barrier();
       // x3faces
@@ -289,7 +338,7 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
           int j = idx / ni;
           int i = (idx - j * ni) + il;
           j += jl;
-          flx.x3f(m,v,kl,j,i) = rbuf[n].flux(m,(i-il + ni*(j-jl + nj*v)));
+          flx.x3f(m,v,kl,j,i) = precv[i-il + ni*(j-jl + nj*v)];
         });
         tmember.team_barrier();
       }
@@ -307,12 +356,24 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
 
 TaskStatus MeshBoundaryValuesCC::InitFluxRecv(const int nvars) {
 #if MPI_PARALLEL_ENABLED
-  int &nmb = pmy_pack->nmb_thispack;
+  int nmb = pmy_pack->nmb_thispack;
   int &nnghbr = pmy_pack->pmb->nnghbr;
   auto &nghbr = pmy_pack->pmb->nghbr;
 
   // Initialize communications of fluxes
   bool no_errors=true;
+  // With aggregated messages, post one receive for each finer neighboring rank
+  if (aggregate_msgs) {
+    SetAggregatedFluxMessages(nvars);
+    Real *rptr = (gpu_aware_mpi) ? aflx_rbuf.d_view.data() : aflx_rbuf.h_view.data();
+    for (std::size_t r=0; r<aflx_rranks.size(); ++r) {
+      int ierr = MPI_Irecv(rptr + nvars*aflx_rstart[r], nvars*aflx_rsize[r],
+                           MPI_ATHENA_REAL, aflx_rranks[r], 0,
+                           comm_flux, &(aflx_rreq[r]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+    nmb = 0;  // skip receives of individual buffers below
+  }
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<nnghbr; ++n) {
       // only post receives for neighbors on FACES at FINER level
@@ -333,8 +394,8 @@ TaskStatus MeshBoundaryValuesCC::InitFluxRecv(const int nvars) {
           auto recv_ptr = Kokkos::subview(recvbuf[n].flux, m, Kokkos::ALL);
 
           // Post non-blocking receive for this buffer on this MeshBlock
-          int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
-                               comm_flux, &(recvbuf[n].flux_req[m]));
+          int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL,
+                               drank, tag, comm_flux, &(recvbuf[n].flux_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
         }
       }
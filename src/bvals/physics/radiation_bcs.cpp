@@ -29,126 +29,139 @@ void MeshBoundaryValues::RadiationBCs(MeshBlockPack *ppack, DualArray2D<Real> i_
   int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
   int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
   int nvar = i0.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
-  int nmb = ppack->nmb_thispack;
+  // faces of MBs in this pack with physical BCs, ordered by direction (see MeshBlock)
+  auto &bcface = ppack->pmb->physbc_face;
+  int fsx1 = ppack->pmb->physbc_start[0], nfx1 = ppack->pmb->physbc_start[1] - fsx1;
+  int fsx2 = ppack->pmb->physbc_start[1], nfx2 = ppack->pmb->physbc_start[2] - fsx2;
+  int fsx3 = ppack->pmb->physbc_start[2], nfx3 = ppack->pmb->physbc_start[3] - fsx3;
 
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::periodic) {
+  // only launch kernel if MBs in this pack have physical BCs in this direction
+  if (nfx1 > 0) {
     int &is = indcs.is;
     int &ie = indcs.ie;
-    par_for("radiationbc_x1", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n2-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int j) {
-      // apply physical boundaries to inner_x1
-      switch (mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
-        case BoundaryFlag::outflow:
-          for (int i=0; i<ng; ++i) {
-            i0(m,n,k,j,is-i-1) = i0(m,n,k,j,is);
-          }
-          break;
-        case BoundaryFlag::inflow:
-          for (int i=0; i<ng; ++i) {
-            i0(m,n,k,j,is-i-1) = i_in.d_view(n,BoundaryFace::inner_x1);
-          }
-          break;
-        default:
-          break;
-      }
-
-      // apply physical boundaries to outer_x1
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x1)) {
-        case BoundaryFlag::outflow:
-          for (int i=0; i<ng; ++i) {
-            i0(m,n,k,j,ie+i+1) = i0(m,n,k,j,ie);
-          }
-          break;
-        case BoundaryFlag::inflow:
-          for (int i=0; i<ng; ++i) {
-            i0(m,n,k,j,ie+i+1) = i_in.d_view(n,BoundaryFace::outer_x1);
-          }
-          break;
-        default:
-          break;
+    par_for("radiationbc_x1", DevExeSpace(), 0,(nfx1-1),0,(nvar-1),0,(n3-1),0,(n2-1),
+    KOKKOS_LAMBDA(int f, int n, int k, int j) {
+      int m = bcface.d_view(fsx1 + f)/6;
+      if (bcface.d_view(fsx1 + f) == 6*m + BoundaryFace::inner_x1) {
+        // apply physical boundaries to inner_x1
+        switch (mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
+          case BoundaryFlag::outflow:
+            for (int i=0; i<ng; ++i) {
+              i0(m,n,k,j,is-i-1) = i0(m,n,k,j,is);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int i=0; i<ng; ++i) {
+              i0(m,n,k,j,is-i-1) = i_in.d_view(n,BoundaryFace::inner_x1);
+            }
+            break;
+          default:
+            break;
+        }
+      } else {
+        // apply physical boundaries to outer_x1
+        switch (mb_bcs.d_view(m,BoundaryFace::outer_x1)) {
+          case BoundaryFlag::outflow:
+            for (int i=0; i<ng; ++i) {
+              i0(m,n,k,j,ie+i+1) = i0(m,n,k,j,ie);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int i=0; i<ng; ++i) {
+              i0(m,n,k,j,ie+i+1) = i_in.d_view(n,BoundaryFace::outer_x1);
+            }
+            break;
+          default:
+            break;
+        }
       }
     });
   }
   if (pm->one_d) return;
 
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x2] != BoundaryFlag::periodic) {
+  // only launch kernel if MBs in this pack have physical BCs in this direction
+  if (nfx2 > 0) {
     int &js = indcs.js;
     int &je = indcs.je;
-    par_for("radiationbc_x2", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n1-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int i) {
-      // apply physical boundaries to inner_x2
-      switch (mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
+    par_for("radiationbc_x2", DevExeSpace(), 0,(nfx2-1),0,(nvar-1),0,(n3-1),0,(n1-1),
+    KOKKOS_LAMBDA(int f, int n, int k, int i) {
+      int m = bcface.d_view(fsx2 + f)/6;
+      if (bcface.d_view(fsx2 + f) == 6*m + BoundaryFace::inner_x2) {
+        // apply physical boundaries to inner_x2
+        switch (mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
+          case BoundaryFlag::outflow:
+            for (int j=0; j<ng; ++j) {
+              i0(m,n,k,js-j-1,i) = i0(m,n,k,js,i);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int j=0; j<ng; ++j) {
+              i0(m,n,k,js-j-1,i) = i_in.d_view(n,BoundaryFace::inner_x2);
+            }
+            break;
+          default:
+            break;
+        }
+      } else {
+        // apply physical boundaries to outer_x2
+        switch (mb_bcs.d_view(m,BoundaryFace::outer_x2)) {
+          case BoundaryFlag::outflow:
+            for (int j=0; j<ng; ++j) {
+              i0(m,n,k,je+j+1,i) = i0(m,n,k,je,i);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int j=0; j<ng; ++j) {
+              i0(m,n,k,je+j+1,i) = i_in.d_view(n,BoundaryFace::outer_x2);
+            }
+            break;
+          default:
+            break;
+        }
+      }
+    });
+  }
+  if (pm->two_d) return;
+
+  // only launch kernel if MBs in this pack have physical BCs in this direction
+  if (nfx3 == 0) return;
+  int &ks = indcs.ks;
+  int &ke = indcs.ke;
+  par_for("radiationbc_x3", DevExeSpace(), 0,(nfx3-1),0,(nvar-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int f, int n, int j, int i) {
+    int m = bcface.d_view(fsx3 + f)/6;
+    if (bcface.d_view(fsx3 + f) == 6*m + BoundaryFace::inner_x3) {
+      // apply physical boundaries to inner_x3
+      switch (mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
         case BoundaryFlag::outflow:
-          for (int j=0; j<ng; ++j) {
-            i0(m,n,k,js-j-1,i) = i0(m,n,k,js,i);
+          for (int k=0; k<ng; ++k) {
+            i0(m,n,ks-k-1,j,i) = i0(m,n,ks,j,i);
           }
           break;
         case BoundaryFlag::inflow:
-          for (int j=0; j<ng; ++j) {
-            i0(m,n,k,js-j-1,i) = i_in.d_view(n,BoundaryFace::inner_x2);
+          for (int k=0; k<ng; ++k) {
+            i0(m,n,ks-k-1,j,i) = i_in.d_view(n,BoundaryFace::inner_x3);
           }
           break;
         default:
           break;
       }
-
-      // apply physical boundaries to outer_x2
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x2)) {
+    } else {
+      // apply physical boundaries to outer_x3
+      switch (mb_bcs.d_view(m,BoundaryFace::outer_x3)) {
         case BoundaryFlag::outflow:
-          for (int j=0; j<ng; ++j) {
-            i0(m,n,k,je+j+1,i) = i0(m,n,k,je,i);
+          for (int k=0; k<ng; ++k) {
+            i0(m,n,ke+k+1,j,i) = i0(m,n,ke,j,i);
           }
           break;
         case BoundaryFlag::inflow:
-          for (int j=0; j<ng; ++j) {
-            i0(m,n,k,je+j+1,i) = i_in.d_view(n,BoundaryFace::outer_x2);
+          for (int k=0; k<ng; ++k) {
+            i0(m,n,ke+k+1,j,i) = i_in.d_view(n,BoundaryFace::outer_x3);
           }
           break;
         default:
           break;
       }
-    });
-  }
-  if (pm->two_d) return;
-
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic) return;
-  int &ks = indcs.ks;
-  int &ke = indcs.ke;
-  par_for("radiationbc_x3", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n2-1),0,(n1-1),
-  KOKKOS_LAMBDA(int m, int n, int j, int i) {
-    // apply physical boundaries to inner_x3
-    switch (mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
-      case BoundaryFlag::outflow:
-        for (int k=0; k<ng; ++k) {
-          i0(m,n,ks-k-1,j,i) = i0(m,n,ks,j,i);
-        }
-        break;
-      case BoundaryFlag::inflow:
-        for (int k=0; k<ng; ++k) {
-          i0(m,n,ks-k-1,j,i) = i_in.d_view(n,BoundaryFace::inner_x3);
-        }
-        break;
-      default:
-        break;
-    }
-
-    // apply physical boundaries to outer_x3
-    switch (mb_bcs.d_view(m,BoundaryFace::outer_x3)) {
-      case BoundaryFlag::outflow:
-        for (int k=0; k<ng; ++k) {
-          i0(m,n,ke+k+1,j,i) = i0(m,n,ke,j,i);
-        }
-        break;
-      case BoundaryFlag::inflow:
-        for (int k=0; k<ng; ++k) {
-          i0(m,n,ke+k+1,j,i) = i_in.d_view(n,BoundaryFace::outer_x3);
-        }
-        break;
-      default:
-        break;
     }
   });
 
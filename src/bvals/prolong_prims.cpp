@@ -4,9 +4,11 @@
 // Licensed under the 3-clause BSD License, see LICENSE file for details
 //========================================================================================
 //! \file prolong_prims.cpp
-//! \brief functions to convert conserved to primitive variables (and vice-versa) in
-//! boundary buffers where prolongation is used at fine/coarse level boundaries.  This
-//! enables prolongation in either the conserved or primitive variables.
+//! \brief functions to prolongate primitive (rather than conserved) variables at
+//! fine/coarse level boundaries.  Conserved variables in coarse boundary buffers are
+//! converted to primitives, prolongated, and converted back to conserved variables on the
+//! fine mesh in a single kernel per buffer, so no coarse primitive arrays are needed.
+#include <algorithm>  // max()
 #include <cstdlib>
 #include <iostream>
 #include <string>
@@ -26,17 +28,52 @@
 #include "coordinates/cell_locations.hpp"
 
 //----------------------------------------------------------------------------------------
-//! \fn void ConsToPrimCoarseBndry()
-//! \brief Converts Hydro conserved variables in coarse level boundary buffers into
-//! Hydro primitive variables for prolongation. Coarse arrays should be passed in through
-//! arguments.
+//! \fn int ProlongPrimsStencilSize()
+//! \brief Returns maximum number of coarse cells over all buffers in stencil used for
+//! 2nd-order prolongation (cells prolongated plus one cell on each side).
+
+static int ProlongPrimsStencilSize(const MeshBoundaryBuffer *rbuf, const int nnghbr,
+                                   const bool multi_d, const bool three_d) {
+  int ncells = 1;
+  for (int n=0; n<nnghbr; ++n) {
+    int ni = rbuf[n].iprol[0].bie - rbuf[n].iprol[0].bis + 3;
+    int nj = rbuf[n].iprol[0].bje - rbuf[n].iprol[0].bjs + ((multi_d)? 3 : 1);
+    int nk = rbuf[n].iprol[0].bke - rbuf[n].iprol[0].bks + ((three_d)? 3 : 1);
+    ncells = std::max(ncells, ni*nj*nk);
+  }
+  return ncells;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real ProlongPrimsSlope()
+//! \brief Min-mod limited slope (times 1/8, as in ProlongCC()) of variable v at coarse
+//! cell c in scratch array, in direction in which the stride between cells is stride.
+//! Returns zero if stride is zero (in unused dimensions).
+
+KOKKOS_INLINE_FUNCTION
+Real ProlongPrimsSlope(const ScrArray2D<Real> &cw, const int v, const int c,
+                       const int stride) {
+  if (stride == 0) return 0.0;
+  Real dl = cw(v,c) - cw(v,c-stride);
+  Real dr = cw(v,c+stride) - cw(v,c);
+  return 0.125*(SIGN(dl) + SIGN(dr))*fmin(fabs(dl), fabs(dr));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProlongatePrimsCC()
+//! \brief Prolongates Hydro primitive variables at fine/coarse boundaries.  Conserved
+//! variables in coarse arrays (ccons) are converted to primitives over the prolongation
+//! stencil of each buffer, prolongated, and stored in both the fine primitive (prim) and
+//! conserved (cons) arrays.
 //! Only works for hydrodynamics, the same function for MHD has different argument list.
 
-void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
-                                                 DvceArray5D<Real> &prim) {
+void MeshBoundaryValuesCC::ProlongatePrimsCC(DvceArray5D<Real> &cons,
+                                             DvceArray5D<Real> &ccons,
+                                             DvceArray5D<Real> &prim) {
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
+  int nvar = cons.extent_int(1);  // TODO(@user): 2nd index from L of array must be NVAR
 
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &mblev = pmy_pack->pmb->mb_lev;
@@ -50,40 +87,44 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
   bool &is_sr = pmy_pack->pcoord->is_special_relativistic;
   bool &is_gr = pmy_pack->pcoord->is_general_relativistic;
   auto &eos = pmy_pack->phydro->peos->eos_data;
+  Real &gamma = pmy_pack->phydro->peos->eos_data.gamma;
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
 
+  // coarse primitives over the stencil of each buffer are stored in scratch memory
+  int ncells = ProlongPrimsStencilSize(rbuf, nnghbr, multi_d, three_d);
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, ncells);
+  int scr_level = 1;
+
   // Outer loop over (# of MeshBlocks)*(# of buffers)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
-  Kokkos::parallel_for("Prol_C2P_CC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+  Kokkos::TeamPolicy<> policy(TaskExecSpace(), (nmb*nnghbr), Kokkos::AUTO);
+  Kokkos::parallel_for("ProlPrimsCC",
+                       policy.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size)),
+                       KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int m = tmember.league_rank()/nnghbr;
     const int n = tmember.league_rank() - m*nnghbr;
 
-    // only convert coarse vars when neighbor exists and is at coarser level
+    // only prolongate when neighbor exists and is at coarser level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
-      // use indices for prolongation on this buffer as loop limits.
-      // Note that one extra cell is added to match stencil of 2nd-order prolongation
-      int il = rbuf[n].iprol[0].bis - 1;
-      int iu = rbuf[n].iprol[0].bie + 1;
-      int jl = rbuf[n].iprol[0].bjs;
-      int ju = rbuf[n].iprol[0].bje;
-      if (multi_d) {
-        jl -= 1;
-        ju += 1;
-      }
-      int kl = rbuf[n].iprol[0].bks;
-      int ku = rbuf[n].iprol[0].bke;
-      if (three_d) {
-        kl -= 1;
-        ku += 1;
-      }
-      const int ni = iu - il + 1;
-      const int nj = ju - jl + 1;
-      const int nk = ku - kl + 1;
+      ScrArray2D<Real> cw(tmember.team_scratch(scr_level), nvar, ncells);
+      // indices of coarse cells to be prolongated on this buffer
+      const int pil = rbuf[n].iprol[0].bis;
+      const int piu = rbuf[n].iprol[0].bie;
+      const int pjl = rbuf[n].iprol[0].bjs;
+      const int pju = rbuf[n].iprol[0].bje;
+      const int pkl = rbuf[n].iprol[0].bks;
+      const int pku = rbuf[n].iprol[0].bke;
+      // One extra cell is added to match stencil of 2nd-order prolongation
+      const int il = pil - 1;
+      const int jl = (multi_d)? (pjl - 1) : pjl;
+      const int kl = (three_d)? (pkl - 1) : pkl;
+      const int ni = (piu + 1) - il + 1;
+      const int nj = ((multi_d)? (pju + 1) : pju) - jl + 1;
+      const int nk = ((three_d)? (pku + 1) : pku) - kl + 1;
       const int nkji = nk*nj*ni;
       const int nji  = nj*ni;
 
-      // Middle loop over k,j,i
+      // Step 1: convert coarse conserved variables to primitives over stencil
       Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji), [&](const int idx) {
         int k = idx/nji;
         int j = (idx - k*nji)/ni;
@@ -93,11 +134,11 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
 
         // load single state conserved variables
         HydCons1D u;
-        u.d  = cons(m,IDN,k,j,i);
-        u.mx = cons(m,IM1,k,j,i);
-        u.my = cons(m,IM2,k,j,i);
-        u.mz = cons(m,IM3,k,j,i);
-        u.e  = cons(m,IEN,k,j,i);
+        u.d  = ccons(m,IDN,k,j,i);
+        u.mx = ccons(m,IM1,k,j,i);
+        u.my = ccons(m,IM2,k,j,i);
+        u.mz = ccons(m,IM3,k,j,i);
+        u.e  = ccons(m,IEN,k,j,i);
         HydPrim1D w;
 
         bool dfloor_used=false, efloor_used=false, tfloor_used=false;
@@ -160,131 +201,104 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
 
         // No need to correct conserved state in coarse boundary arrays if floors used
         // since these values will be overwritten after prolongation anyways.
-        // store primitive state in 3D array
-        prim(m,IDN,k,j,i) = w.d;
-        prim(m,IVX,k,j,i) = w.vx;
-        prim(m,IVY,k,j,i) = w.vy;
-        prim(m,IVZ,k,j,i) = w.vz;
-        prim(m,IEN,k,j,i) = w.e;
+        // store primitive state in scratch array
+        const int c = idx;
+        cw(IDN,c) = w.d;
+        cw(IVX,c) = w.vx;
+        cw(IVY,c) = w.vy;
+        cw(IVZ,c) = w.vz;
+        cw(IEN,c) = w.e;
         // convert scalars (if any)
-        for (int n=nhyd; n<(nhyd+nscal); ++n) {
+        for (int s=nhyd; s<(nhyd+nscal); ++s) {
           // apply scalar floor
-          if (cons(m,n,k,j,i) < 0.0) {
-            cons(m,n,k,j,i) = 0.0;
+          if (ccons(m,s,k,j,i) < 0.0) {
+            ccons(m,s,k,j,i) = 0.0;
           }
-          prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+          cw(s,c) = ccons(m,s,k,j,i)/u.d;
         }
       });
       tmember.team_barrier();
-    }
-  });
-  return;
-}
-
-//----------------------------------------------------------------------------------------
-//! \fn void PrimToConsFineBndry()
-//! \brief Converts prolongated Hydro primitive variables at fine level in boundary
-//! buffers into Hydro conservative variables.
-//! Note same function for MHD has different argument list.
-
-void MeshBoundaryValuesCC::PrimToConsFineBndry(const DvceArray5D<Real> &prim,
-                                               DvceArray5D<Real> &cons) {
-  // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
-  int nnghbr = pmy_pack->pmb->nnghbr;
-
-  auto &nghbr = pmy_pack->pmb->nghbr;
-  auto &mblev = pmy_pack->pmb->mb_lev;
-  auto &rbuf = recvbuf;
-  auto &indcs  = pmy_pack->pmesh->mb_indcs;
-  const bool multi_d = pmy_pack->pmesh->multi_d;
-  const bool three_d = pmy_pack->pmesh->three_d;
-  auto &size = pmy_pack->pmb->mb_size;
-  auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
-  auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
-  bool &is_sr = pmy_pack->pcoord->is_special_relativistic;
-  bool &is_gr = pmy_pack->pcoord->is_general_relativistic;
-  Real &gamma = pmy_pack->phydro->peos->eos_data.gamma;
-  int &nhyd  = pmy_pack->phydro->nhydro;
-  int &nscal = pmy_pack->phydro->nscalars;
 
-  // Outer loop over (# of MeshBlocks)*(# of buffers)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
-  Kokkos::parallel_for("ProlCC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = tmember.league_rank()/nnghbr;
-    const int n = tmember.league_rank() - m*nnghbr;
-
-    // only prolongate when neighbor exists and is at coarser level
-    if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
-      // loop over indices for prolongation on this buffer
-      // Convert indices from coarse to fine arrays
-      int il = (rbuf[n].iprol[0].bis - indcs.cis)*2 + indcs.is;
-      int iu = (rbuf[n].iprol[0].bie - indcs.cis)*2 + indcs.is + 1;
-      int jl = (rbuf[n].iprol[0].bjs - indcs.cjs)*2 + indcs.js;
-      int ju = (rbuf[n].iprol[0].bje - indcs.cjs)*2 + indcs.js;
-      if (multi_d) {
-        ju += 1;
-      }
-      int kl = (rbuf[n].iprol[0].bks - indcs.cks)*2 + indcs.ks;
-      int ku = (rbuf[n].iprol[0].bke - indcs.cks)*2 + indcs.ks;
-      if (three_d) {
-        ku += 1;
-      }
-      const int ni = iu - il + 1;
-      const int nj = ju - jl + 1;
-      const int nk = ku - kl + 1;
-      const int nkji = nk*nj*ni;
-      const int nji  = nj*ni;
-
-      // Middle loop over k,j,i
-      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji), [&](const int idx) {
-        int k = idx/nji;
-        int j = (idx - k*nji)/ni;
-        int i = (idx - k*nji - j*ni) + il;
-        j += jl;
-        k += kl;
-
-        // Load single state of primitive variables
-        HydPrim1D w;
-        w.d  = prim(m,IDN,k,j,i);
-        w.vx = prim(m,IVX,k,j,i);
-        w.vy = prim(m,IVY,k,j,i);
-        w.vz = prim(m,IVZ,k,j,i);
-        w.e  = prim(m,IEN,k,j,i);
-        HydCons1D u;
-
-        if (is_gr) {
-          Real &x1min = size.d_view(m).x1min;
-          Real &x1max = size.d_view(m).x1max;
-          Real x1v = CellCenterX(i-indcs.is, indcs.nx1, x1min, x1max);
-
-          Real &x2min = size.d_view(m).x2min;
-          Real &x2max = size.d_view(m).x2max;
-          Real x2v = CellCenterX(j-indcs.js, indcs.nx2, x2min, x2max);
-
-          Real &x3min = size.d_view(m).x3min;
-          Real &x3max = size.d_view(m).x3max;
-          Real x3v = CellCenterX(k-indcs.ks, indcs.nx3, x3min, x3max);
+      // Step 2: prolongate primitives to fine cells, and convert to conserved variables
+      const int pni = piu - pil + 1;
+      const int pnj = pju - pjl + 1;
+      const int pnk = pku - pkl + 1;
+      const int pnkji = pnk*pnj*pni;
+      const int pnji  = pnj*pni;
+      const int sj = (multi_d)? ni : 0;
+      const int sk = (three_d)? nji : 0;
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, pnkji),[&](const int idx) {
+        int k = idx/pnji;
+        int j = (idx - k*pnji)/pni;
+        int i = (idx - k*pnji - j*pni) + pil;
+        j += pjl;
+        k += pkl;
+        // index of coarse cell in scratch array
+        const int c = (i - il) + ni*(j - jl) + nji*(k - kl);
+
+        // indices for prolongation refer to coarse array.  So must compute
+        // indices for fine array
+        const int fil = (i - indcs.cis)*2 + indcs.is;
+        const int fjl = (j - indcs.cjs)*2 + indcs.js;
+        const int fkl = (k - indcs.cks)*2 + indcs.ks;
+        // loop over 2 (1D), 4 (2D) or 8 (3D) fine cells in this coarse cell
+        const int nfine = 2*((multi_d)? 2 : 1)*((three_d)? 2 : 1);
+        for (int f=0; f<nfine; ++f) {
+          const int fi = fil + (f & 1);
+          const int fj = fjl + ((f >> 1) & 1);
+          const int fk = fkl + (f >> 2);
+          // prolongate each primitive with the min-mod limited slopes of ProlongCC()
+          const Real sgn1 = static_cast<Real>(2*(fi - fil) - 1);
+          const Real sgn2 = static_cast<Real>(2*(fj - fjl) - 1);
+          const Real sgn3 = static_cast<Real>(2*(fk - fkl) - 1);
+          for (int v=0; v<nvar; ++v) {
+            prim(m,v,fk,fj,fi) = cw(v,c) + sgn1*ProlongPrimsSlope(cw,v,c,1)
+                               + sgn2*ProlongPrimsSlope(cw,v,c,sj)
+                               + sgn3*ProlongPrimsSlope(cw,v,c,sk);
+          }
 
-          Real glower[4][4], gupper[4][4];
-          ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
-          SingleP2C_IdealGRHyd(glower, gupper, w, gamma, u);
-        } else if (is_sr) {
-          SingleP2C_IdealSRHyd(w, gamma, u);
-        } else {
-          SingleP2C_IdealHyd(w, u);
-        }
+          // Load single state of primitive variables
+          HydPrim1D w;
+          w.d  = prim(m,IDN,fk,fj,fi);
+          w.vx = prim(m,IVX,fk,fj,fi);
+          w.vy = prim(m,IVY,fk,fj,fi);
+          w.vz = prim(m,IVZ,fk,fj,fi);
+          w.e  = prim(m,IEN,fk,fj,fi);
+          HydCons1D u;
+
+          if (is_gr) {
+            Real &x1min = size.d_view(m).x1min;
+            Real &x1max = size.d_view(m).x1max;
+            Real x1v = CellCenterX(fi-indcs.is, indcs.nx1, x1min, x1max);
+
+            Real &x2min = size.d_view(m).x2min;
+            Real &x2max = size.d_view(m).x2max;
+            Real x2v = CellCenterX(fj-indcs.js, indcs.nx2, x2min, x2max);
+
+            Real &x3min = size.d_view(m).x3min;
+            Real &x3max = size.d_view(m).x3max;
+            Real x3v = CellCenterX(fk-indcs.ks, indcs.nx3, x3min, x3max);
+
+            Real glower[4][4], gupper[4][4];
+            ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+            SingleP2C_IdealGRHyd(glower, gupper, w, gamma, u);
+          } else if (is_sr) {
+            SingleP2C_IdealSRHyd(w, gamma, u);
+          } else {
+            SingleP2C_IdealHyd(w, u);
+          }
 
-        // Set conserved quantities
-        cons(m,IDN,k,j,i) = u.d;
-        cons(m,IM1,k,j,i) = u.mx;
-        cons(m,IM2,k,j,i) = u.my;
-        cons(m,IM3,k,j,i) = u.mz;
-        cons(m,IEN,k,j,i) = u.e;
+          // Set conserved quantities
+          cons(m,IDN,fk,fj,fi) = u.d;
+          cons(m,IM1,fk,fj,fi) = u.mx;
+          cons(m,IM2,fk,fj,fi) = u.my;
+          cons(m,IM3,fk,fj,fi) = u.mz;
+          cons(m,IEN,fk,fj,fi) = u.e;
 
-        // convert scalars (if any)
-        for (int n=nhyd; n<(nhyd+nscal); ++n) {
-          cons(m,n,k,j,i) = u.d*prim(m,n,k,j,i);
+          // convert scalars (if any)
+          for (int s=nhyd; s<(nhyd+nscal); ++s) {
+            cons(m,s,fk,fj,fi) = u.d*prim(m,s,fk,fj,fi);
+          }
         }
       });
       tmember.team_barrier();
@@ -294,17 +308,23 @@ void MeshBoundaryValuesCC::PrimToConsFineBndry(const DvceArray5D<Real> &prim,
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void ConsToPrimCoarseBndry()
-//! \brief Converts MHD conserved variables in coarse level boundary buffers into
-//! MHD primitive variables for prolongation. Coarse arrays should be passed in through
-//! arguments.
+//! \fn void ProlongatePrimsCC()
+//! \brief Prolongates MHD primitive variables at fine/coarse boundaries.  Conserved
+//! variables in coarse arrays (ccons) are converted to primitives using the coarse
+//! face-centered fields (cb) over the prolongation stencil of each buffer, prolongated,
+//! and stored in both the fine primitive (prim) and conserved (cons) arrays using the
+//! fine face-centered fields (b), which must already have been prolongated.
 //! Only works for MHD, the same function for hydro has different argument list.
 
-void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
-                                 const DvceFaceFld4D<Real> &b, DvceArray5D<Real> &prim) {
+void MeshBoundaryValuesCC::ProlongatePrimsCC(DvceArray5D<Real> &cons,
+                                             DvceArray5D<Real> &ccons,
+                                             const DvceFaceFld4D<Real> &b,
+                                             const DvceFaceFld4D<Real> &cb,
+                                             DvceArray5D<Real> &prim) {
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
+  int nvar = cons.extent_int(1);  // TODO(@user): 2nd index from L of array must be NVAR
 
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &mblev = pmy_pack->pmb->mb_lev;
@@ -318,40 +338,44 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
   bool &is_sr = pmy_pack->pcoord->is_special_relativistic;
   bool &is_gr = pmy_pack->pcoord->is_general_relativistic;
   auto &eos = pmy_pack->pmhd->peos->eos_data;
+  Real &gamma = pmy_pack->pmhd->peos->eos_data.gamma;
   int &nmhd  = pmy_pack->pmhd->nmhd;
   int &nscal = pmy_pack->pmhd->nscalars;
 
+  // coarse primitives over the stencil of each buffer are stored in scratch memory
+  int ncells = ProlongPrimsStencilSize(rbuf, nnghbr, multi_d, three_d);
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, ncells);
+  int scr_level = 1;
+
   // Outer loop over (# of MeshBlocks)*(# of buffers)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
-  Kokkos::parallel_for("ProlCC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+  Kokkos::TeamPolicy<> policy(TaskExecSpace(), (nmb*nnghbr), Kokkos::AUTO);
+  Kokkos::parallel_for("ProlPrimsCC",
+                       policy.set_scratch_size(scr_level, Kokkos::PerTeam(scr_size)),
+                       KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int m = tmember.league_rank()/nnghbr;
     const int n = tmember.league_rank() - m*nnghbr;
 
-    // only convert coarse vars when neighbor exists and is at coarser level
+    // only prolongate when neighbor exists and is at coarser level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
-      // use indices for prolongation on this buffer as loop limits
-      // Note that one extra cell is added to match stencil of 2nd-order prolongation
-      int il = rbuf[n].iprol[0].bis - 1;
-      int iu = rbuf[n].iprol[0].bie + 1;
-      int jl = rbuf[n].iprol[0].bjs;
-      int ju = rbuf[n].iprol[0].bje;
-      if (multi_d) {
-        jl -= 1;
-        ju += 1;
-      }
-      int kl = rbuf[n].iprol[0].bks;
-      int ku = rbuf[n].iprol[0].bke;
-      if (three_d) {
-        kl -= 1;
-        ku += 1;
-      }
-      const int ni = iu - il + 1;
-      const int nj = ju - jl + 1;
-      const int nk = ku - kl + 1;
+      ScrArray2D<Real> cw(tmember.team_scratch(scr_level), nvar, ncells);
+      // indices of coarse cells to be prolongated on this buffer
+      const int pil = rbuf[n].iprol[0].bis;
+      const int piu = rbuf[n].iprol[0].bie;
+      const int pjl = rbuf[n].iprol[0].bjs;
+      const int pju = rbuf[n].iprol[0].bje;
+      const int pkl = rbuf[n].iprol[0].bks;
+      const int pku = rbuf[n].iprol[0].bke;
+      // One extra cell is added to match stencil of 2nd-order prolongation
+      const int il = pil - 1;
+      const int jl = (multi_d)? (pjl - 1) : pjl;
+      const int kl = (three_d)? (pkl - 1) : pkl;
+      const int ni = (piu + 1) - il + 1;
+      const int nj = ((multi_d)? (pju + 1) : pju) - jl + 1;
+      const int nk = ((three_d)? (pku + 1) : pku) - kl + 1;
       const int nkji = nk*nj*ni;
       const int nji  = nj*ni;
 
-      // Middle loop over k,j,i
+      // Step 1: convert coarse conserved variables to primitives over stencil
       Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji), [&](const int idx) {
         int k = idx/nji;
         int j = (idx - k*nji)/ni;
@@ -361,15 +385,15 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
 
         // load single state conserved variables
         MHDCons1D u;
-        u.d  = cons(m,IDN,k,j,i);
-        u.mx = cons(m,IM1,k,j,i);
-        u.my = cons(m,IM2,k,j,i);
-        u.mz = cons(m,IM3,k,j,i);
-        u.e  = cons(m,IEN,k,j,i);
+        u.d  = ccons(m,IDN,k,j,i);
+        u.mx = ccons(m,IM1,k,j,i);
+        u.my = ccons(m,IM2,k,j,i);
+        u.mz = ccons(m,IM3,k,j,i);
+        u.e  = ccons(m,IEN,k,j,i);
         // use simple linear average of face-centered fields
-        u.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
-        u.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
-        u.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
+        u.bx = 0.5*(cb.x1f(m,k,j,i) + cb.x1f(m,k,j,i+1));
+        u.by = 0.5*(cb.x2f(m,k,j,i) + cb.x2f(m,k,j+1,i));
+        u.bz = 0.5*(cb.x3f(m,k,j,i) + cb.x3f(m,k+1,j,i));
         HydPrim1D w;
 
         bool dfloor_used=false, efloor_used=false, tfloor_used=false;
@@ -434,136 +458,109 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
 
         // No need to correct conserved state in coarse boundary arrays if floors used
         // since these values will be overwritten after prolongation anyways.
-        // store primitive state in 3D array
-        prim(m,IDN,k,j,i) = w.d;
-        prim(m,IVX,k,j,i) = w.vx;
-        prim(m,IVY,k,j,i) = w.vy;
-        prim(m,IVZ,k,j,i) = w.vz;
-        prim(m,IEN,k,j,i) = w.e;
+        // store primitive state in scratch array
+        const int c = idx;
+        cw(IDN,c) = w.d;
+        cw(IVX,c) = w.vx;
+        cw(IVY,c) = w.vy;
+        cw(IVZ,c) = w.vz;
+        cw(IEN,c) = w.e;
         // No need to store cell-centered fields since they will not be prolongated
         // convert scalars (if any)
-        for (int n=nmhd; n<(nmhd+nscal); ++n) {
+        for (int s=nmhd; s<(nmhd+nscal); ++s) {
           // apply scalar floor
-          if (cons(m,n,k,j,i) < 0.0) {
-            cons(m,n,k,j,i) = 0.0;
+          if (ccons(m,s,k,j,i) < 0.0) {
+            ccons(m,s,k,j,i) = 0.0;
           }
-          prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+          cw(s,c) = ccons(m,s,k,j,i)/u.d;
         }
       });
       tmember.team_barrier();
-    }
-  });
-  return;
-}
-
-//----------------------------------------------------------------------------------------
-//! \fn void PrimToConsFineBndry()
-//! \brief Converts prolongated MHD primitive variables at fine level in boundary buffers
-//! into MHD conservative variables.
-//! Note same function for Hydrodynamics has different argument list.
-
-void MeshBoundaryValuesCC::PrimToConsFineBndry(const DvceArray5D<Real> &prim,
-                               const DvceFaceFld4D<Real> &b, DvceArray5D<Real> &cons) {
-  // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
-  int nnghbr = pmy_pack->pmb->nnghbr;
-
-  auto &nghbr = pmy_pack->pmb->nghbr;
-  auto &mblev = pmy_pack->pmb->mb_lev;
-  auto &rbuf = recvbuf;
-  auto &indcs  = pmy_pack->pmesh->mb_indcs;
-  const bool multi_d = pmy_pack->pmesh->multi_d;
-  const bool three_d = pmy_pack->pmesh->three_d;
-  auto &size = pmy_pack->pmb->mb_size;
-  auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
-  auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
-  bool &is_sr = pmy_pack->pcoord->is_special_relativistic;
-  bool &is_gr = pmy_pack->pcoord->is_general_relativistic;
-  Real &gamma = pmy_pack->pmhd->peos->eos_data.gamma;
-  int &nmhd  = pmy_pack->pmhd->nmhd;
-  int &nscal = pmy_pack->pmhd->nscalars;
-
-  // Outer loop over (# of MeshBlocks)*(# of buffers)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
-  Kokkos::parallel_for("ProlCC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = tmember.league_rank()/nnghbr;
-    const int n = tmember.league_rank() - m*nnghbr;
-
-    // only prolongate when neighbor exists and is at coarser level
-    if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
-      // loop over indices for prolongation on this buffer
-      // Convert indices from coarse to fine arrays
-      int il = (rbuf[n].iprol[0].bis - indcs.cis)*2 + indcs.is;
-      int iu = (rbuf[n].iprol[0].bie - indcs.cis)*2 + indcs.is + 1;
-      int jl = (rbuf[n].iprol[0].bjs - indcs.cjs)*2 + indcs.js;
-      int ju = (rbuf[n].iprol[0].bje - indcs.cjs)*2 + indcs.js;
-      if (multi_d) {
-        ju += 1;
-      }
-      int kl = (rbuf[n].iprol[0].bks - indcs.cks)*2 + indcs.ks;
-      int ku = (rbuf[n].iprol[0].bke - indcs.cks)*2 + indcs.ks;
-      if (three_d) {
-        ku += 1;
-      }
-      const int ni = iu - il + 1;
-      const int nj = ju - jl + 1;
-      const int nk = ku - kl + 1;
-      const int nkji = nk*nj*ni;
-      const int nji  = nj*ni;
-
-      // Middle loop over k,j,i
-      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji), [&](const int idx) {
-        int k = idx/nji;
-        int j = (idx - k*nji)/ni;
-        int i = (idx - k*nji - j*ni) + il;
-        j += jl;
-        k += kl;
-
-        // Load single state of primitive variables
-        MHDPrim1D w;
-        w.d  = prim(m,IDN,k,j,i);
-        w.vx = prim(m,IVX,k,j,i);
-        w.vy = prim(m,IVY,k,j,i);
-        w.vz = prim(m,IVZ,k,j,i);
-        w.e  = prim(m,IEN,k,j,i);
-        // use simple linear average of face-centered fields
-        w.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
-        w.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
-        w.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
-        HydCons1D u;
-
-        if (is_gr) {
-          Real &x1min = size.d_view(m).x1min;
-          Real &x1max = size.d_view(m).x1max;
-          Real x1v = CellCenterX(i-indcs.is, indcs.nx1, x1min, x1max);
 
-          Real &x2min = size.d_view(m).x2min;
-          Real &x2max = size.d_view(m).x2max;
-          Real x2v = CellCenterX(j-indcs.js, indcs.nx2, x2min, x2max);
-
-          Real &x3min = size.d_view(m).x3min;
-          Real &x3max = size.d_view(m).x3max;
-          Real x3v = CellCenterX(k-indcs.ks, indcs.nx3, x3min, x3max);
+      // Step 2: prolongate primitives to fine cells, and convert to conserved variables
+      const int pni = piu - pil + 1;
+      const int pnj = pju - pjl + 1;
+      const int pnk = pku - pkl + 1;
+      const int pnkji = pnk*pnj*pni;
+      const int pnji  = pnj*pni;
+      const int sj = (multi_d)? ni : 0;
+      const int sk = (three_d)? nji : 0;
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, pnkji),[&](const int idx) {
+        int k = idx/pnji;
+        int j = (idx - k*pnji)/pni;
+        int i = (idx - k*pnji - j*pni) + pil;
+        j += pjl;
+        k += pkl;
+        // index of coarse cell in scratch array
+        const int c = (i - il) + ni*(j - jl) + nji*(k - kl);
+
+        // indices for prolongation refer to coarse array.  So must compute
+        // indices for fine array
+        const int fil = (i - indcs.cis)*2 + indcs.is;
+        const int fjl = (j - indcs.cjs)*2 + indcs.js;
+        const int fkl = (k - indcs.cks)*2 + indcs.ks;
+        // loop over 2 (1D), 4 (2D) or 8 (3D) fine cells in this coarse cell
+        const int nfine = 2*((multi_d)? 2 : 1)*((three_d)? 2 : 1);
+        for (int f=0; f<nfine; ++f) {
+          const int fi = fil + (f & 1);
+          const int fj = fjl + ((f >> 1) & 1);
+          const int fk = fkl + (f >> 2);
+          // prolongate each primitive with the min-mod limited slopes of ProlongCC()
+          const Real sgn1 = static_cast<Real>(2*(fi - fil) - 1);
+          const Real sgn2 = static_cast<Real>(2*(fj - fjl) - 1);
+          const Real sgn3 = static_cast<Real>(2*(fk - fkl) - 1);
+          for (int v=0; v<nvar; ++v) {
+            prim(m,v,fk,fj,fi) = cw(v,c) + sgn1*ProlongPrimsSlope(cw,v,c,1)
+                               + sgn2*ProlongPrimsSlope(cw,v,c,sj)
+                               + sgn3*ProlongPrimsSlope(cw,v,c,sk);
+          }
 
-          Real glower[4][4], gupper[4][4];
-          ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
-          SingleP2C_IdealGRMHD(glower, gupper, w, gamma, u);
-        } else if (is_sr) {
-          SingleP2C_IdealSRMHD(w, gamma, u);
-        } else {
-          SingleP2C_IdealMHD(w, u);
-        }
+          // Load single state of primitive variables
+          MHDPrim1D w;
+          w.d  = prim(m,IDN,fk,fj,fi);
+          w.vx = prim(m,IVX,fk,fj,fi);
+          w.vy = prim(m,IVY,fk,fj,fi);
+          w.vz = prim(m,IVZ,fk,fj,fi);
+          w.e  = prim(m,IEN,fk,fj,fi);
+          // use simple linear average of face-centered fields
+          w.bx = 0.5*(b.x1f(m,fk,fj,fi) + b.x1f(m,fk,fj,fi+1));
+          w.by = 0.5*(b.x2f(m,fk,fj,fi) + b.x2f(m,fk,fj+1,fi));
+          w.bz = 0.5*(b.x3f(m,fk,fj,fi) + b.x3f(m,fk+1,fj,fi));
+          HydCons1D u;
+
+          if (is_gr) {
+            Real &x1min = size.d_view(m).x1min;
+            Real &x1max = size.d_view(m).x1max;
+            Real x1v = CellCenterX(fi-indcs.is, indcs.nx1, x1min, x1max);
+
+            Real &x2min = size.d_view(m).x2min;
+            Real &x2max = size.d_view(m).x2max;
+            Real x2v = CellCenterX(fj-indcs.js, indcs.nx2, x2min, x2max);
+
+            Real &x3min = size.d_view(m).x3min;
+            Real &x3max = size.d_view(m).x3max;
+            Real x3v = CellCenterX(fk-indcs.ks, indcs.nx3, x3min, x3max);
+
+            Real glower[4][4], gupper[4][4];
+            ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+            SingleP2C_IdealGRMHD(glower, gupper, w, gamma, u);
+          } else if (is_sr) {
+            SingleP2C_IdealSRMHD(w, gamma, u);
+          } else {
+            SingleP2C_IdealMHD(w, u);
+          }
 
-        // Set conserved quantities
-        cons(m,IDN,k,j,i) = u.d;
-        cons(m,IM1,k,j,i) = u.mx;
-        cons(m,IM2,k,j,i) = u.my;
-        cons(m,IM3,k,j,i) = u.mz;
-        cons(m,IEN,k,j,i) = u.e;
+          // Set conserved quantities
+          cons(m,IDN,fk,fj,fi) = u.d;
+          cons(m,IM1,fk,fj,fi) = u.mx;
+          cons(m,IM2,fk,fj,fi) = u.my;
+          cons(m,IM3,fk,fj,fi) = u.mz;
+          cons(m,IEN,fk,fj,fi) = u.e;
 
-        // convert scalars (if any)
-        for (int n=nmhd; n<(nmhd+nscal); ++n) {
-          cons(m,n,k,j,i) = u.d*prim(m,n,k,j,i);
+          // convert scalars (if any)
+          for (int s=nmhd; s<(nmhd+nscal); ++s) {
+            cons(m,s,fk,fj,fi) = u.d*prim(m,s,fk,fj,fi);
+          }
         }
       });
       tmember.team_barrier();
@@ -0,0 +1,367 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file chemistry.cpp
+//! \brief Implements Chemistry class: reading the reaction network from the input file,
+//! and batched per-cell Rosenbrock integration of the network.
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "chemistry.hpp"
+
+namespace {
+// size of system: abundances and temperature
+constexpr int NCHEM_SYS = NCHEM_SPECIES + 1;
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParseSpeciesList()
+//! \brief parses comma-separated list of species indices
+
+void ParseSpeciesList(const std::string &list, int nspecies, int r, std::string name,
+                      std::vector<int> &spec) {
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.find_first_not_of(" \t") == std::string::npos) continue;
+    int n = std::stoi(item);
+    if (n < 0 || n >= nspecies || static_cast<int>(spec.size()) >= NCHEM_REACT) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<chemistry>/" << name << "_" << r << " = '" << list
+                << "' must list at most " << NCHEM_REACT << " species in range [0,"
+                << nspecies-1 << "]" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    spec.push_back(n);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ChemRHS()
+//! \brief computes dy/dt of abundances and T, and optionally the Jacobian d(dy/dt)/dy.
+//! Index nsp of y is T, which is only evolved if evolve_t=true.
+
+template <typename S, typename C>
+KOKKOS_INLINE_FUNCTION
+void ChemRHS(const S &spec, const C &coef, const int nreac, const int nsp,
+             const bool evolve_t, const Real gm1, const Real den, const Real y[],
+             Real f[], Real jac[][NCHEM_SYS], const bool need_jac) {
+  const int nsys = nsp + (evolve_t? 1 : 0);
+  Real temp = y[nsp];
+  for (int n=0; n<nsys; ++n) {
+    f[n] = 0.0;
+    if (need_jac) {
+      for (int l=0; l<nsys; ++l) {jac[n][l] = 0.0;}
+    }
+  }
+  for (int r=0; r<nreac; ++r) {
+    // rate coefficient, including density factor of rate per unit mass
+    int nr = 0;
+    for (int s=0; s<NCHEM_REACT; ++s) {
+      if (spec(r,s) >= 0) {nr++;}
+    }
+    Real krate = coef(r,0)*pow(temp, coef(r,1))*exp(-coef(r,2)/temp);
+    for (int s=1; s<nr; ++s) {krate *= den;}
+    Real rate = krate;
+    for (int s=0; s<NCHEM_REACT; ++s) {
+      if (spec(r,s) >= 0) {rate *= y[spec(r,s)];}
+    }
+    // (reactants and products are accumulated separately, so repeated species work)
+    for (int s=0; s<NCHEM_REACT; ++s) {
+      if (spec(r,s) >= 0) {f[spec(r,s)] -= rate;}
+      if (spec(r,NCHEM_REACT+s) >= 0) {f[spec(r,NCHEM_REACT+s)] += rate;}
+    }
+    if (evolve_t) {f[nsp] += gm1*coef(r,3)*rate;}
+    if (!(need_jac)) continue;
+
+    // d(rate)/dy_j from each occurrence of y_j among the reactants
+    for (int s=0; s<NCHEM_REACT; ++s) {
+      if (spec(r,s) < 0) continue;
+      Real drate = krate;
+      for (int s2=0; s2<NCHEM_REACT; ++s2) {
+        if (s2 != s && spec(r,s2) >= 0) {drate *= y[spec(r,s2)];}
+      }
+      int l = spec(r,s);
+      for (int s2=0; s2<NCHEM_REACT; ++s2) {
+        if (spec(r,s2) >= 0) {jac[spec(r,s2)][l] -= drate;}
+        if (spec(r,NCHEM_REACT+s2) >= 0) {jac[spec(r,NCHEM_REACT+s2)][l] += drate;}
+      }
+      if (evolve_t) {jac[nsp][l] += gm1*coef(r,3)*drate;}
+    }
+    // d(rate)/dT
+    if (evolve_t) {
+      Real drate = rate*(coef(r,1)/temp + coef(r,2)/(temp*temp));
+      for (int s2=0; s2<NCHEM_REACT; ++s2) {
+        if (spec(r,s2) >= 0) {jac[spec(r,s2)][nsp] -= drate;}
+        if (spec(r,NCHEM_REACT+s2) >= 0) {jac[spec(r,NCHEM_REACT+s2)][nsp] += drate;}
+      }
+      jac[nsp][nsp] += gm1*coef(r,3)*drate;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LUDecompose()
+//! \brief in-place LU decomposition with partial pivoting of n x n matrix a
+
+KOKKOS_INLINE_FUNCTION
+void LUDecompose(const int n, Real a[][NCHEM_SYS], int piv[]) {
+  for (int c=0; c<n; ++c) {
+    int p = c;
+    for (int r=c+1; r<n; ++r) {
+      if (fabs(a[r][c]) > fabs(a[p][c])) {p = r;}
+    }
+    piv[c] = p;
+    if (p != c) {
+      for (int l=0; l<n; ++l) {
+        Real tmp = a[c][l];
+        a[c][l] = a[p][l];
+        a[p][l] = tmp;
+      }
+    }
+    Real inv = (a[c][c] != 0.0)? 1.0/a[c][c] : 0.0;
+    for (int r=c+1; r<n; ++r) {
+      a[r][c] *= inv;
+      for (int l=c+1; l<n; ++l) {a[r][l] -= a[r][c]*a[c][l];}
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LUSolve()
+//! \brief solves a x = b in place (b overwritten with x) using LU decomposition of a
+
+KOKKOS_INLINE_FUNCTION
+void LUSolve(const int n, const Real a[][NCHEM_SYS], const int piv[], Real b[]) {
+  for (int c=0; c<n; ++c) {
+    if (piv[c] != c) {
+      Real tmp = b[c];
+      b[c] = b[piv[c]];
+      b[piv[c]] = tmp;
+    }
+    for (int r=c+1; r<n; ++r) {b[r] -= a[r][c]*b[c];}
+  }
+  for (int r=n-1; r>=0; --r) {
+    for (int l=r+1; l<n; ++l) {b[r] -= a[r][l]*b[l];}
+    b[r] = (a[r][r] != 0.0)? b[r]/a[r][r] : 0.0;
+  }
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// constructor, reads reaction network from <chemistry> block
+
+Chemistry::Chemistry(MeshBlockPack *pp, ParameterInput *pin, int nscalars) :
+    reac_spec("chem_spec",1,1),
+    reac_coef("chem_coef",1,1),
+    work("chem_work",1,1,1,1,1),
+    pmy_pack(pp) {
+  nspecies = pin->GetOrAddInteger("chemistry", "nspecies", nscalars);
+  if (nspecies < 1 || nspecies > nscalars || nspecies > NCHEM_SPECIES) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<chemistry>/nspecies=" << nspecies << " must be >= 1, and at most "
+              << "the number of passive scalars and " << NCHEM_SPECIES << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  nreactions = pin->GetInteger("chemistry", "nreactions");
+  rtol = pin->GetOrAddReal("chemistry", "rtol", 1.0e-4);
+  atol = pin->GetOrAddReal("chemistry", "atol", 1.0e-12);
+  tfloor = pin->GetOrAddReal("chemistry", "tfloor", 1.0e-20);
+  max_substeps = pin->GetOrAddInteger("chemistry", "max_substeps", 1000);
+
+  Kokkos::realloc(reac_spec, std::max(nreactions, 1), 2*NCHEM_REACT);
+  Kokkos::realloc(reac_coef, std::max(nreactions, 1), 4);
+  for (int r=0; r<nreactions; ++r) {
+    std::string rs = std::to_string(r);
+    std::vector<int> reactants, products;
+    ParseSpeciesList(pin->GetString("chemistry", "reactants_" + rs), nspecies, r,
+                     "reactants", reactants);
+    ParseSpeciesList(pin->GetOrAddString("chemistry", "products_" + rs, ""), nspecies,
+                     r, "products", products);
+    if (reactants.size() == 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<chemistry>/reactants_" << r << " must list at least "
+                << "one species" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    for (int s=0; s<NCHEM_REACT; ++s) {
+      reac_spec.h_view(r,s) = (s < static_cast<int>(reactants.size()))?
+                              reactants[s] : -1;
+      reac_spec.h_view(r,NCHEM_REACT+s) = (s < static_cast<int>(products.size()))?
+                                          products[s] : -1;
+    }
+    reac_coef.h_view(r,0) = pin->GetReal("chemistry", "rate_a_" + rs);
+    reac_coef.h_view(r,1) = pin->GetOrAddReal("chemistry", "rate_b_" + rs, 0.0);
+    reac_coef.h_view(r,2) = pin->GetOrAddReal("chemistry", "rate_c_" + rs, 0.0);
+    reac_coef.h_view(r,3) = pin->GetOrAddReal("chemistry", "heat_" + rs, 0.0);
+  }
+  reac_spec.template modify<HostMemSpace>();
+  reac_spec.template sync<DevExeSpace>();
+  reac_coef.template modify<HostMemSpace>();
+  reac_coef.template sync<DevExeSpace>();
+
+  // allocate work array (reallocated in Integrate() if number of MBs changes)
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  Kokkos::realloc(work, pmy_pack->nmb_thispack, 1, ncells3, ncells2, ncells1);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Chemistry::Integrate()
+//! \brief Integrates network over dt in each cell with adaptive ROS2 substeps:
+//!   (I - g h J) k1 = f(y),  (I - g h J) k2 = f(y + h k1) - 2 k1,  g = 1 + 1/sqrt(2)
+//!   y_new = y + (3/2) h k1 + (1/2) h k2
+//! with error estimate y_new - (y + h k1) = (h/2)(k1 + k2).  Cells in the ghost zones
+//! are also integrated, which gives the same result as in the neighboring MeshBlock, so
+//! that ghost zones remain current without further communication.  nfluid is the index
+//! of the first passive scalar (nhydro or nmhd).
+
+void Chemistry::Integrate(DvceArray5D<Real> &w0, DvceArray5D<Real> &u0,
+                          const EOS_Data &eos_data, const int nfluid, const Real dt) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb = pmy_pack->nmb_thispack;
+  if (work.extent_int(0) != nmb || work.extent_int(4) != ncells1 ||
+      work.extent_int(3) != ncells2 || work.extent_int(2) != ncells3) {
+    Kokkos::realloc(work, nmb, 1, ncells3, ncells2, ncells1);
+  }
+
+  bool evolve_t = eos_data.is_ideal;
+  bool use_e = eos_data.use_e;
+  Real gm1 = eos_data.gamma - 1.0;
+  Real temp_iso = SQR(eos_data.iso_cs);
+  Real tfloor_ = fmax(tfloor, eos_data.tfloor);
+  int nsp = nspecies;
+  int nsys = nsp + (evolve_t? 1 : 0);
+  int nreac = nreactions;
+  auto spec = reac_spec.d_view;
+  auto coef = reac_coef.d_view;
+  Real rtol_ = rtol, atol_ = atol;
+  int max_sub = max_substeps;
+  auto work_ = work;
+  const Real gam = 1.0 + 1.0/sqrt(2.0);
+
+  par_for("chem_ros2", DevExeSpace(), 0, nmb-1, 0, ncells3-1, 0, ncells2-1, 0,
+          ncells1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real den = w0(m,IDN,k,j,i);
+    if (!(den > 0.0)) {
+      work_(m,0,k,j,i) = 0.0;
+      return;
+    }
+    Real y[NCHEM_SYS], f[NCHEM_SYS], k1[NCHEM_SYS], k2[NCHEM_SYS], ytmp[NCHEM_SYS];
+    Real jac[NCHEM_SYS][NCHEM_SYS];
+    int piv[NCHEM_SYS];
+    for (int n=0; n<nsp; ++n) {y[n] = w0(m,nfluid+n,k,j,i);}
+    Real temp0 = temp_iso;
+    if (evolve_t) {
+      temp0 = (use_e)? w0(m,IEN,k,j,i)*gm1/den : w0(m,ITM,k,j,i);
+    }
+    y[nsp] = temp0;
+
+    Real t = 0.0, h = dt;
+    int nstep = 0, naccept = 0;
+    while (t < dt && naccept < max_sub) {
+      h = fmin(h, dt - t);
+      // factor (I - g h J), and solve for k1
+      ChemRHS(spec, coef, nreac, nsp, evolve_t, gm1, den, y, f, jac, true);
+      for (int n=0; n<nsys; ++n) {
+        for (int l=0; l<nsys; ++l) {jac[n][l] = -gam*h*jac[n][l];}
+        jac[n][n] += 1.0;
+        k1[n] = f[n];
+      }
+      LUDecompose(nsys, jac, piv);
+      LUSolve(nsys, jac, piv, k1);
+      // solve for k2
+      for (int n=0; n<nsys; ++n) {ytmp[n] = y[n] + h*k1[n];}
+      if (evolve_t) {ytmp[nsp] = fmax(ytmp[nsp], tfloor_);}
+      ChemRHS(spec, coef, nreac, nsp, evolve_t, gm1, den, ytmp, k2, jac, false);
+      for (int n=0; n<nsys; ++n) {k2[n] -= 2.0*k1[n];}
+      LUSolve(nsys, jac, piv, k2);
+      // error norm of embedded first-order solution
+      Real err = 0.0;
+      for (int n=0; n<nsys; ++n) {
+        ytmp[n] = y[n] + 1.5*h*k1[n] + 0.5*h*k2[n];
+        Real scale = rtol_*fmax(fabs(y[n]), fabs(ytmp[n])) + ((n < nsp)? atol_ : 0.0);
+        err = fmax(err, 0.5*h*fabs(k1[n] + k2[n])/fmax(scale, 1.0e-300));
+      }
+      nstep++;
+      if (err <= 1.0) {
+        t += h;
+        naccept++;
+        for (int n=0; n<nsp; ++n) {y[n] = fmax(ytmp[n], 0.0);}
+        if (evolve_t) {y[nsp] = fmax(ytmp[nsp], tfloor_);}
+      }
+      h *= fmin(4.0, fmax(0.2, 0.9/sqrt(fmax(err, 1.0e-10))));
+    }
+    work_(m,0,k,j,i) = static_cast<Real>(nstep);
+
+    // update abundances and internal energy at constant density
+    for (int n=0; n<nsp; ++n) {
+      w0(m,nfluid+n,k,j,i) = y[n];
+      u0(m,nfluid+n,k,j,i) = den*y[n];
+    }
+    if (evolve_t) {
+      u0(m,IEN,k,j,i) += den*(y[nsp] - temp0)/gm1;
+      if (use_e) {
+        w0(m,IEN,k,j,i) = den*y[nsp]/gm1;
+      } else {
+        w0(m,ITM,k,j,i) = y[nsp];
+      }
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Chemistry::WorkEachMB()
+//! \brief Returns mean number of Rosenbrock steps per active cell in each MeshBlock in
+//! the last call to Integrate(), used to weight costs for automatic load balancing.
+
+void Chemistry::WorkEachMB(std::vector<float> &work_mb) {
+  int nmb = pmy_pack->nmb_thispack;
+  work_mb.assign(nmb, 0.0);
+  if (work.extent_int(0) != nmb) return;
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto work_ = work;
+  DualArray1D<Real> work_each("chem_work_mb", nmb);
+  par_for_outer("ChemWorkEachMB",DevExeSpace(), 0, 0, 0, (nmb-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+    Real team_sum = 0.0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+    [=](const int idx, Real& sum) {
+      int k = (idx)/nji;
+      int j = (idx - k*nji)/nx1;
+      int i = (idx - k*nji - j*nx1) + is;
+      j += js;
+      k += ks;
+      sum += work_(m,0,k,j,i);
+    },Kokkos::Sum<Real>(team_sum));
+    work_each.d_view(m) = team_sum/static_cast<Real>(nkji);
+  });
+  work_each.template modify<DevExeSpace>();
+  work_each.template sync<HostMemSpace>();
+  for (int m=0; m<nmb; ++m) {
+    work_mb[m] = static_cast<float>(work_each.h_view(m));
+  }
+  return;
+}
@@ -0,0 +1,68 @@
+#ifndef CHEMISTRY_CHEMISTRY_HPP_
+#define CHEMISTRY_CHEMISTRY_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file chemistry.hpp
+//! \brief Operator-split integration of a stiff reaction network, in which the first
+//! <chemistry>/nspecies passive scalars of Hydro or MHD are the abundances y_n = n_n/rho
+//! of the species (number densities per unit mass, in code units).  Each reaction
+//!   r_0 + r_1 (+ r_2) -> p_0 (+ p_1 + p_2)
+//! proceeds at rate k(T) rho^(nr-1) y_r0 y_r1 ... per unit mass, where nr is the number
+//! of reactants and k(T) = a T^b exp(-c/T), and releases heat q per unit abundance
+//! reacted (so changes the specific internal energy by q times the rate).  T is the
+//! temperature P/rho in code units.
+//!
+//! The abundances and T in each cell are integrated over dt at constant density with the
+//! L-stable, second-order Rosenbrock method ROS2 (Verwer et al. 1999), using the analytic
+//! Jacobian and adaptive substeps controlled by the embedded first-order solution.  The
+//! number of Rosenbrock steps (including rejected steps) in each cell is saved in the
+//! "chem_work" field, which can be output and is used to weight the cost of MeshBlocks
+//! with automatic load balancing (<loadbalancing>/chem_fraction).
+
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+
+// maximum number of species and reactants/products of each reaction.  Jacobian of size
+// (NCHEM_SPECIES+1)^2 is stored in registers
+#define NCHEM_SPECIES 8
+#define NCHEM_REACT 3
+
+struct EOS_Data;
+
+//----------------------------------------------------------------------------------------
+//! \class Chemistry
+//! \brief data and functions for stiff reaction networks
+
+class Chemistry {
+ public:
+  Chemistry(MeshBlockPack *pp, ParameterInput *pin, int nscalars);
+  ~Chemistry() = default;
+
+  int nspecies;                // number of species (first nspecies scalars)
+  int nreactions;              // number of reactions
+  DualArray2D<int> reac_spec;  // species of reactants [0,2], products [3,5] (-1 if none)
+  DualArray2D<Real> reac_coef; // a, b, c, and q of each reaction
+  Real rtol, atol;             // relative and absolute error tolerances of substeps
+  Real tfloor;                 // minimum temperature (code units)
+  int max_substeps;            // maximum number of accepted substeps in each cell
+  DvceArray5D<Real> work;      // number of Rosenbrock steps in each cell last cycle
+
+  // integrate network over dt in all cells (including ghost zones), updating abundances
+  // and internal energy in both w0 and u0
+  void Integrate(DvceArray5D<Real> &w0, DvceArray5D<Real> &u0, const EOS_Data &eos,
+                 const int nfluid, const Real dt);
+  // mean number of Rosenbrock steps per active cell in each MB on this rank
+  void WorkEachMB(std::vector<float> &work_mb);
+
+ private:
+  MeshBlockPack *pmy_pack;
+};
+
+#endif // CHEMISTRY_CHEMISTRY_HPP_
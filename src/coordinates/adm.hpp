@@ -256,6 +256,28 @@ void Face3Metric(const int m, const int k, const int j, const int i,
   return;
 }
 
+// number of variables (3-metric, shift, lapse) stored by DynGRMHD::SetFaceMetric()
+constexpr int NFACEMETRIC = NSPMETRIC + 4;
+
+//----------------------------------------------------------------------------------------
+//! \fn void LoadFaceMetric
+//! \brief loads components of 3-metric, lapse and shift at a face from an array of face
+//  values of the form computed by DynGRMHD::SetFaceMetric(): metric components in the
+//  order S11...S33, followed by the shift and the lapse
+
+KOKKOS_INLINE_FUNCTION
+void LoadFaceMetric(const int m, const int k, const int j, const int i,
+     const DvceArray5D<Real> &fmet, Real gface_dd[NSPMETRIC], Real betaface_u[3],
+     Real &alphaface) {
+  for (int n = 0; n < NSPMETRIC; ++n) {
+    gface_dd[n] = fmet(m,n,k,j,i);
+  }
+  for (int a = 0; a < 3; ++a) {
+    betaface_u[a] = fmet(m,NSPMETRIC+a,k,j,i);
+  }
+  alphaface = fmet(m,NSPMETRIC+3,k,j,i);
+  return;
+}
 
 } // namespace adm
 #endif // COORDINATES_ADM_HPP_
@@ -98,6 +98,62 @@ void ComputeMetricAndInverse(Real x, Real y, Real z, bool minkowski, Real a,
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void ComputeSphericalKS
+//! \brief computes spherical Kerr-Schild coordinates s = (r,theta,phi) of the Cartesian
+//!  Kerr-Schild point (x,y,z), where x + iy = (r + ia) e^{i phi} sin(theta), z = r
+//!  cos(theta).  Also returns the Jacobians ds_dx[a][i] = ds^a/dx^i and dx_ds[i][a] =
+//!  dx^i/ds^a, and sqrt(-g) = r^2 + a^2 cos^2(theta) in spherical KS.  Derivatives of
+//!  theta and phi are set to zero on the polar axis, where they are singular.
+
+KOKKOS_INLINE_FUNCTION
+void ComputeSphericalKS(Real x, Real y, Real z, Real a, Real s[3], Real ds_dx[][3],
+                        Real dx_ds[][3], Real *psqrtmdet) {
+  Real rad2 = SQR(x) + SQR(y) + SQR(z);
+  Real a2 = SQR(a);
+  Real r = sqrt((rad2 - a2 + sqrt(SQR(rad2 - a2) + 4.0*a2*SQR(z)))/2.0);
+  Real eps = 1e-6;
+  if (r < eps) {
+    r = 0.5*(eps + r*r/eps);
+  }
+  Real cth = fmin(fmax(z/r, -1.0), 1.0);
+  Real sth = sqrt(1.0 - SQR(cth));
+  Real phi = atan2(y, x) - atan2(a, r);
+  Real sph = sin(phi);
+  Real cph = cos(phi);
+  s[0] = r;
+  s[1] = acos(cth);
+  s[2] = phi;
+
+  // dx^i/ds^a
+  dx_ds[0][0] = cph*sth;
+  dx_ds[0][1] = (r*cph - a*sph)*cth;
+  dx_ds[0][2] = -(r*sph + a*cph)*sth;
+  dx_ds[1][0] = sph*sth;
+  dx_ds[1][1] = (r*sph + a*cph)*cth;
+  dx_ds[1][2] = (r*cph - a*sph)*sth;
+  dx_ds[2][0] = cth;
+  dx_ds[2][1] = -r*sth;
+  dx_ds[2][2] = 0.0;
+
+  // ds^a/dx^i, using 2r^2 - (x^2 + y^2 + z^2) + a^2 = r^2 + a^2 cos^2(theta)
+  Real sigma = SQR(r) + a2*SQR(cth);
+  ds_dx[0][0] = r*x/sigma;
+  ds_dx[0][1] = r*y/sigma;
+  ds_dx[0][2] = (r*z + a2*z/r)/sigma;
+  Real rho2 = SQR(x) + SQR(y);
+  for (int i=0; i<3; ++i) {
+    ds_dx[1][i] = (sth > 0.0) ? (cth*ds_dx[0][i] - ((i == 2) ? 1.0 : 0.0))/(r*sth) : 0.0;
+    ds_dx[2][i] = (rho2 > 0.0) ? a*ds_dx[0][i]/(SQR(r) + a2) : 0.0;
+  }
+  if (rho2 > 0.0) {
+    ds_dx[2][0] -= y/rho2;
+    ds_dx[2][1] += x/rho2;
+  }
+  *psqrtmdet = sigma;
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void ComputeADMDecomposition
 //! \brief computes ADM quantitiese in Cartesian Kerr-Schild coordinates
@@ -49,4 +49,41 @@ static int CellCenterIndex(Real x, int n, Real xmin, Real xmax) {
   return static_cast<int>(((x-xmin)/(xmax-xmin))*static_cast<Real>(n));
 }
 
+//----------------------------------------------------------------------------------------
+//! \struct MBLocations
+//  \brief extents and index offsets of one MeshBlock, copied once per team (or thread)
+// from the RegionSize in device memory into registers, so that cell positions in inner
+// loops do not reload size.d_view(m) for every cell.  Positions are computed with
+// CellCenterX() and LeftEdgeX(), so they are bitwise identical to calling those directly.
+
+struct MBLocations {
+  Real x1min, x1max, x2min, x2max, x3min, x3max;
+  int nx1, nx2, nx3;
+  int is, js, ks;
+
+  KOKKOS_INLINE_FUNCTION Real x1v(int i) const {return CellCenterX(i-is,nx1,x1min,x1max);}
+  KOKKOS_INLINE_FUNCTION Real x2v(int j) const {return CellCenterX(j-js,nx2,x2min,x2max);}
+  KOKKOS_INLINE_FUNCTION Real x3v(int k) const {return CellCenterX(k-ks,nx3,x3min,x3max);}
+  KOKKOS_INLINE_FUNCTION Real x1f(int i) const {return LeftEdgeX(i-is,nx1,x1min,x1max);}
+  KOKKOS_INLINE_FUNCTION Real x2f(int j) const {return LeftEdgeX(j-js,nx2,x2min,x2max);}
+  KOKKOS_INLINE_FUNCTION Real x3f(int k) const {return LeftEdgeX(k-ks,nx3,x3min,x3max);}
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn MBLocations LoadMBLocations()
+// returns MBLocations from a RegionSize and RegionIndcs (templated so that this file does
+// not depend on mesh.hpp)
+
+template <typename SizeT, typename IndcsT>
+KOKKOS_INLINE_FUNCTION
+static MBLocations LoadMBLocations(const SizeT &size, const IndcsT &indcs) {
+  MBLocations loc;
+  loc.x1min = size.x1min;  loc.x1max = size.x1max;
+  loc.x2min = size.x2min;  loc.x2max = size.x2max;
+  loc.x3min = size.x3min;  loc.x3max = size.x3max;
+  loc.nx1 = indcs.nx1;  loc.nx2 = indcs.nx2;  loc.nx3 = indcs.nx3;
+  loc.is = indcs.is;  loc.js = indcs.js;  loc.ks = indcs.ks;
+  return loc;
+}
+
 #endif // COORDINATES_CELL_LOCATIONS_HPP_
@@ -23,7 +23,12 @@
 Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
     pmy_pack(ppack),
     excision_floor("excision_floor",1,1,1,1),
-    excision_flux("excision_flux",1,1,1,1) {
+    excision_flux("excision_flux",1,1,1,1),
+    mb_excision("mb_excision",1),
+    nmb_unexcised(0),
+    unexcised_mbs("unexcised_mbs",1),
+    nmb_excised(0),
+    excised_mbs("excised_mbs",1) {
   // Check for relativistic dynamics
   // WGC: idea for handling new EOS
   is_dynamical_relativistic = (pin->DoesBlockExist("adm") || pin->DoesBlockExist("z4c"))
@@ -89,10 +94,119 @@ Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
       if (coord_data.excision_scheme == ExcisionScheme::fixed) {
         SetExcisionMasks(excision_floor, excision_flux);
       }
+      skip_excised_blocks = pin->GetOrAddBoolean("coord","skip_excised_blocks",false);
+    }
+  }
+  SetExcisedMeshBlocks();
+
+  // Logically rectangular curvilinear coordinates, currently only for non-relativistic
+  // hydrodynamics on a uniform Mesh
+  std::string system = pin->GetOrAddString("coord","system","cartesian");
+  if (system.compare("cartesian") == 0) {
+    coord_data.system = CoordSystem::cartesian;
+  } else if (system.compare("cylindrical") == 0) {
+    coord_data.system = CoordSystem::cylindrical;
+  } else if (system.compare("spherical_polar") == 0) {
+    coord_data.system = CoordSystem::spherical_polar;
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<coord>/system = '" << system << "' not implemented. "
+              << "Valid choices are [cartesian,cylindrical,spherical_polar]."
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if ((coord_data.system != CoordSystem::cartesian) &&
+      (is_special_relativistic || is_general_relativistic || is_dynamical_relativistic ||
+       pin->DoesBlockExist("mhd") || pin->DoesBlockExist("radiation") ||
+       pin->DoesBlockExist("particles") || pmy_pack->pmesh->multilevel)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<coord>/system = '" << system << "' can only be used "
+              << "with non-relativistic hydrodynamics on a uniform Mesh" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // Optionally cache the (stationary) metric at cell centers and faces.  The cache is
+  // rebuilt whenever the Coordinates are reconstructed, i.e. after AMR.
+  if (is_general_relativistic) {
+    std::string cache = pin->GetOrAddString("coord","metric_cache","none");
+    if (cache.compare("full") == 0 || cache.compare("compressed") == 0) {
+      coord_data.metric_cached = true;
+      coord_data.metric_compressed = (cache.compare("compressed") == 0);
+      SetMetricCache();
+    } else if (cache.compare("none") != 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<coord>/metric_cache = '" << cache
+                << "' must be one of none, full, compressed" << std::endl;
+      std::exit(EXIT_FAILURE);
     }
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::SetMetricCache()
+//! \brief Computes metric and inverse at all cell centers and faces (including ghost
+//! zones) of all MeshBlocks in this pack, and stores them in the cache in coord_data.
+
+void Coordinates::SetMetricCache() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int n1 = indcs.nx1 + 2*(indcs.ng);
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb = pmy_pack->nmb_thispack;
+  int nmet = (coord_data.metric_compressed)? NMETRIC_COMPRESSED : NMETRIC_FULL;
+  Kokkos::realloc(coord_data.gcc,  nmb, nmet, n3, n2, n1);
+  Kokkos::realloc(coord_data.gx1f, nmb, nmet, n3, n2, n1+1);
+  Kokkos::realloc(coord_data.gx2f, nmb, nmet, n3, n2+1, n1);
+  Kokkos::realloc(coord_data.gx3f, nmb, nmet, n3+1, n2, n1);
+
+  auto &size = pmy_pack->pmb->mb_size;
+  bool flat = coord_data.is_minkowski;
+  Real spin = coord_data.bh_spin;
+  bool compressed = coord_data.metric_compressed;
+  auto gcc_ = coord_data.gcc;
+  auto gx1f_ = coord_data.gx1f;
+  auto gx2f_ = coord_data.gx2f;
+  auto gx3f_ = coord_data.gx3f;
+  // single loop over the union of cell and face indices in all directions
+  par_for("metric_cache", DevExeSpace(), 0, (nmb-1), 0, n3, 0, n2, 0, n1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+    Real x1f = LeftEdgeX  (i-is, indcs.nx1, x1min, x1max);
+
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+    Real x2f = LeftEdgeX  (j-js, indcs.nx2, x2min, x2max);
+
+    Real &x3min = size.d_view(m).x3min;
+    Real &x3max = size.d_view(m).x3max;
+    Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+    Real x3f = LeftEdgeX  (k-ks, indcs.nx3, x3min, x3max);
+
+    Real glower[4][4], gupper[4][4];
+    if (k < n3 && j < n2) {
+      ComputeMetricAndInverse(x1f, x2v, x3v, flat, spin, glower, gupper);
+      StoreMetric(compressed, glower, gupper, gx1f_, m, k, j, i);
+      if (i < n1) {
+        ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+        StoreMetric(compressed, glower, gupper, gcc_, m, k, j, i);
+      }
+    }
+    if (k < n3 && i < n1) {
+      ComputeMetricAndInverse(x1v, x2f, x3v, flat, spin, glower, gupper);
+      StoreMetric(compressed, glower, gupper, gx2f_, m, k, j, i);
+    }
+    if (j < n2 && i < n1) {
+      ComputeMetricAndInverse(x1v, x2v, x3f, flat, spin, glower, gupper);
+      StoreMetric(compressed, glower, gupper, gx3f_, m, k, j, i);
+    }
+  });
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn
 // Coordinate (geometric) source term function for GR hydrodynamics
@@ -105,6 +219,7 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim, const EOS_Data &e
   int js = indcs.js; int je = indcs.je;
   int ks = indcs.ks; int ke = indcs.ke;
   auto &size = pmy_pack->pmb->mb_size;
+  auto &coord = coord_data;
   auto &flat = coord_data.is_minkowski;
   auto &spin = coord_data.bh_spin;
 
@@ -127,7 +242,11 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim, const EOS_Data &e
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (coord.metric_cached) {
+      LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     // Extract primitives
     const Real &rho  = prim(m,IDN,k,j,i);
@@ -228,14 +347,18 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim,
   int js = indcs.js; int je = indcs.je;
   int ks = indcs.ks; int ke = indcs.ke;
   auto &size = pmy_pack->pmb->mb_size;
+  auto &coord = coord_data;
   auto &flat = coord_data.is_minkowski;
   auto &spin = coord_data.bh_spin;
 
   Real gamma_prime = eos.gamma / (eos.gamma - 1.0);
 
-  int nmb1 = pmy_pack->nmb_thispack - 1;
+  // only MBs not entirely excised (all MBs, unless <coord>/skip_excised_blocks)
+  int nmb1 = nmb_unexcised - 1;
+  auto &emb_ = unexcised_mbs;
   par_for("coord_src", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  KOKKOS_LAMBDA(const int ma, const int k, const int j, const int i) {
+    const int m = emb_.d_view(ma);
     // Extract components of metric
     Real &x1min = size.d_view(m).x1min;
     Real &x1max = size.d_view(m).x1max;
@@ -250,7 +373,11 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim,
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (coord.metric_cached) {
+      LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     // Extract primitives
     const Real &rho  = prim(m,IDN,k,j,i);
@@ -24,6 +24,13 @@ enum class ExcisionScheme {
   lapse
 };
 
+// Enumerator for the coordinate system of the Mesh (see curvilinear.hpp)
+enum class CoordSystem {
+  cartesian,
+  cylindrical,
+  spherical_polar
+};
+
 //----------------------------------------------------------------------------------------
 //! \struct CoordData
 //! \brief container for Coordinate variables and functions needed inside kernels. Storing
@@ -31,6 +38,9 @@ enum class ExcisionScheme {
 //! inside kernels.
 
 struct CoordData {
+  // (x1,x2,x3) are (R,phi,z) in cylindrical and (r,theta,phi) in spherical-polar coords
+  CoordSystem system = CoordSystem::cartesian;
+
   // following data is only used in GR calculations to compute metric
   bool is_minkowski;               // flag to specify Minkowski (flat) space
   Real bh_spin;                    // needed for GR metric
@@ -41,8 +51,80 @@ struct CoordData {
   Real flux_excise_r;              // reduce to first-order inside this radius
   ExcisionScheme excision_scheme;  // excision method
   Real excise_lapse;               // if excision_scheme = lapse, excise under this lapse
+
+  // optional cache of stationary metric at cell centers and faces (see LoadMetric)
+  bool metric_cached = false;      // flag to read metric from cache
+  bool metric_compressed = false;  // flag to store only independent components
+  DvceArray5D<Real> gcc;           // metric at cell centers
+  DvceArray5D<Real> gx1f, gx2f, gx3f;  // metric at x1/x2/x3-faces
 };
 
+// Number of values stored per location in the metric cache: g_{mu nu} followed by
+// g^{mu nu}, with 16 components each, or only the 10 with mu<=nu when compressed.
+// The lapse is sqrt(-1/g^{00}), and sqrt(-g)=1 in Cartesian Kerr-Schild, so neither is
+// stored.
+#define NMETRIC_FULL 32
+#define NMETRIC_COMPRESSED 20
+
+//----------------------------------------------------------------------------------------
+//! \fn void StoreMetric()
+//! \brief Writes metric and inverse metric into index (m,k,j,i) of metric cache gc.
+
+KOKKOS_INLINE_FUNCTION
+void StoreMetric(const bool compressed, Real glower[][4], Real gupper[][4],
+                 const DvceArray5D<Real> &gc, const int m, const int k, const int j,
+                 const int i) {
+  if (compressed) {
+    int n = 0;
+    for (int a=0; a<4; ++a) {
+      for (int b=a; b<4; ++b) {
+        gc(m,n,k,j,i) = glower[a][b];
+        gc(m,n+10,k,j,i) = gupper[a][b];
+        n++;
+      }
+    }
+  } else {
+    for (int a=0; a<4; ++a) {
+      for (int b=0; b<4; ++b) {
+        gc(m,4*a+b,k,j,i) = glower[a][b];
+        gc(m,4*a+b+16,k,j,i) = gupper[a][b];
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LoadMetric()
+//! \brief Reads metric and inverse metric at index (m,k,j,i) of metric cache gc.  Can be
+//! used in place of ComputeMetricAndInverse() when coord.metric_cached is true.
+
+KOKKOS_INLINE_FUNCTION
+void LoadMetric(const CoordData &coord, const DvceArray5D<Real> &gc, const int m,
+                const int k, const int j, const int i, Real glower[][4],
+                Real gupper[][4]) {
+  if (coord.metric_compressed) {
+    int n = 0;
+    for (int a=0; a<4; ++a) {
+      for (int b=a; b<4; ++b) {
+        glower[a][b] = gc(m,n,k,j,i);
+        glower[b][a] = glower[a][b];
+        gupper[a][b] = gc(m,n+10,k,j,i);
+        gupper[b][a] = gupper[a][b];
+        n++;
+      }
+    }
+  } else {
+    for (int a=0; a<4; ++a) {
+      for (int b=0; b<4; ++b) {
+        glower[a][b] = gc(m,4*a+b,k,j,i);
+        gupper[a][b] = gc(m,4*a+b+16,k,j,i);
+      }
+    }
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \class Coordinates
 //! \brief data and functions for coordinates
@@ -64,6 +146,16 @@ class Coordinates {
   DvceArray4D<bool> excision_floor;  // cell-centered mask for C2P flooring about horizon
   DvceArray4D<bool> excision_flux;   // cell-centered mask for FOFC about horizon
 
+  // MBs entirely inside the excision region are skipped by the MHD and DynGRMHD flux,
+  // FOFC, update, and source term kernels if <coord>/skip_excised_blocks is set.  Those
+  // kernels loop over the nmb_unexcised MBs listed in unexcised_mbs.
+  bool skip_excised_blocks = false;
+  DualArray1D<int> mb_excision;      // 0/1/2 if none/some/all cells of MB are excised
+  int nmb_unexcised;                 // number of MBs not entirely excised
+  DualArray1D<int> unexcised_mbs;    // indices of MBs not entirely excised
+  int nmb_excised;                   // number of MBs entirely excised
+  DualArray1D<int> excised_mbs;      // indices of MBs entirely excised
+
   // functions
   void CoordSrcTerms(const DvceArray5D<Real> &w0, const EOS_Data &eos, const Real dt,
                      DvceArray5D<Real> &u0);
@@ -72,6 +164,8 @@ class Coordinates {
   void SetExcisionMasks(DvceArray4D<bool> &floor, DvceArray4D<bool> &flux);
 
   void UpdateExcisionMasks();
+  void SetExcisedMeshBlocks();
+  void SetMetricCache();
 
  private:
   MeshBlockPack* pmy_pack;
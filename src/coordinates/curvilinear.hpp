@@ -0,0 +1,83 @@
+#ifndef COORDINATES_CURVILINEAR_HPP_
+#define COORDINATES_CURVILINEAR_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file curvilinear.hpp
+//! \brief inline functions for logically rectangular cylindrical (R,phi,z) and
+//! spherical-polar (r,theta,phi) coordinates, selected with <coord>/system.  Cells are
+//! uniformly spaced in the coordinates, so positions are still given by CellCenterX() and
+//! LeftEdgeX().  Volumes and areas are exact integrals over each cell, divided by the
+//! widths of the cell in the coordinates that do not appear in the factor, as in the
+//! CylindricalCoordinates and SphericalPolarCoordinates classes in Athena++.
+
+#include <math.h>
+
+#include "athena.hpp"
+#include "coordinates/coordinates.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void RadialFactors()
+//! \brief factors at cell with x1-faces at rm and rp.  Returns the area factor of each
+//! x1-face (R or r^2), the radial volume factor vol1 = int(a1 dr), and the radial factor
+//! in the area of x2-faces (dR or int(r dr)).
+
+KOKKOS_INLINE_FUNCTION
+void RadialFactors(const CoordSystem sys, const Real rm, const Real rp, Real &a1m,
+                   Real &a1p, Real &vol1, Real &b2) {
+  if (sys == CoordSystem::cylindrical) {
+    a1m = rm;
+    a1p = rp;
+    vol1 = 0.5*(rp*rp - rm*rm);
+    b2 = rp - rm;
+  } else {
+    a1m = rm*rm;
+    a1p = rp*rp;
+    vol1 = (rp*rp*rp - rm*rm*rm)/3.0;
+    b2 = 0.5*(rp*rp - rm*rm);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PolarFactors()
+//! \brief factors at cell with x2-faces at tm and tp.  Returns the polar factor in the
+//! area of each x2-face (1 or sin(theta)) and the polar volume factor vol2 (dphi or
+//! int(sin(theta) dtheta)).
+
+KOKKOS_INLINE_FUNCTION
+void PolarFactors(const CoordSystem sys, const Real tm, const Real tp, Real &s2m,
+                  Real &s2p, Real &vol2) {
+  if (sys == CoordSystem::cylindrical) {
+    s2m = 1.0;
+    s2p = 1.0;
+    vol2 = tp - tm;
+  } else {
+    s2m = sin(tm);
+    s2p = sin(tp);
+    vol2 = cos(tm) - cos(tp);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ScaleFactors()
+//! \brief scale factors h2,h3 such that the length of a cell in x2 and x3 is h2*dx2 and
+//! h3*dx3 at position (x1,x2)
+
+KOKKOS_INLINE_FUNCTION
+void ScaleFactors(const CoordSystem sys, const Real x1, const Real x2, Real &h2,
+                  Real &h3) {
+  if (sys == CoordSystem::cylindrical) {
+    h2 = x1;
+    h3 = 1.0;
+  } else if (sys == CoordSystem::spherical_polar) {
+    h2 = x1;
+    h3 = x1*fabs(sin(x2));
+  } else {
+    h2 = 1.0;
+    h3 = 1.0;
+  }
+}
+
+#endif // COORDINATES_CURVILINEAR_HPP_
@@ -4,7 +4,8 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file excision.cpp
-//! \brief sets boolean masks for horizon excision
+//! \brief sets boolean masks for horizon excision, and the lists of MeshBlocks that are
+//! entirely excised (and so may be skipped by the MHD and DynGRMHD kernels)
 
 #include <float.h>
 
@@ -187,5 +188,81 @@ void Coordinates::UpdateExcisionMasks() {
       floor(m,k,j,i) = excise;
       flux(m,k,j,i) = excise;
     });
+    SetExcisedMeshBlocks();
   }
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::SetExcisedMeshBlocks()
+//! \brief Classifies each MB as not, partially, or entirely excised, and sets the lists
+//! of MBs that are and are not entirely excised.  A MB is entirely excised if every cell,
+//! including the ghost zones, is masked both for flooring and for FOFC.  Unless
+//! <coord>/skip_excised_blocks is set, no MB is treated as excised, so that every MB is
+//! in unexcised_mbs.
+
+void Coordinates::SetExcisedMeshBlocks() {
+  int nmb = pmy_pack->nmb_thispack;
+  if (static_cast<int>(mb_excision.extent(0)) != nmb) {
+    Kokkos::realloc(mb_excision, nmb);
+    Kokkos::realloc(unexcised_mbs, nmb);
+    Kokkos::realloc(excised_mbs, nmb);
+  }
+
+  if (skip_excised_blocks) {
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    int &ng = indcs.ng;
+    int n1 = indcs.nx1 + 2*ng;
+    int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+    int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+    const int nkji = n3*n2*n1;
+    const int nji  = n2*n1;
+    auto &floor = excision_floor;
+    auto &flux = excision_flux;
+    auto &mb_excision_ = mb_excision;
+    par_for_outer("excised_mbs",DevExeSpace(), 0, 0, 0, (nmb-1),
+    KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+      int nsome = 0, nall = 0;
+      Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+      [=](const int idx, int &sum) {
+        int k = (idx)/nji;
+        int j = (idx - k*nji)/n1;
+        int i = (idx - k*nji - j*n1);
+        if (floor(m,k,j,i) || flux(m,k,j,i)) {sum++;}
+      },Kokkos::Sum<int>(nsome));
+      Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+      [=](const int idx, int &sum) {
+        int k = (idx)/nji;
+        int j = (idx - k*nji)/n1;
+        int i = (idx - k*nji - j*n1);
+        if (floor(m,k,j,i) && flux(m,k,j,i)) {sum++;}
+      },Kokkos::Sum<int>(nall));
+      Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+        mb_excision_.d_view(m) = (nall == nkji)? 2 : ((nsome > 0)? 1 : 0);
+      });
+    });
+    mb_excision.template modify<DevExeSpace>();
+    mb_excision.template sync<HostMemSpace>();
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      mb_excision.h_view(m) = 0;
+    }
+    mb_excision.template modify<HostMemSpace>();
+    mb_excision.template sync<DevExeSpace>();
+  }
+
+  // build lists of MBs on host
+  nmb_unexcised = 0;
+  nmb_excised = 0;
+  for (int m=0; m<nmb; ++m) {
+    if (mb_excision.h_view(m) == 2) {
+      excised_mbs.h_view(nmb_excised++) = m;
+    } else {
+      unexcised_mbs.h_view(nmb_unexcised++) = m;
+    }
+  }
+  unexcised_mbs.template modify<HostMemSpace>();
+  unexcised_mbs.template sync<DevExeSpace>();
+  excised_mbs.template modify<HostMemSpace>();
+  excised_mbs.template sync<DevExeSpace>();
+  return;
+}
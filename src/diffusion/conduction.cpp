@@ -5,7 +5,8 @@
 //========================================================================================
 //! \file conduction.cpp
 //! \brief Implements functions for Conduction class. This includes isotropic thermal
-//! conduction, in which heat flux is proportional to negative local temperature gradient.
+//! conduction, in which heat flux is proportional to negative local temperature gradient,
+//! and (in MHD) anisotropic conduction along magnetic field lines.
 //! Conduction may be added to Hydro and/or MHD independently.
 
 #include <float.h>
@@ -22,22 +23,9 @@
 #include "mhd/mhd.hpp"
 #include "eos/eos.hpp"
 #include "conduction.hpp"
+#include "face_gradient.hpp"
 #include "units/units.hpp"
 
-KOKKOS_INLINE_FUNCTION
-Real VanLeerLimiter(const Real a, const Real b) {
-  if (a*b > 0) {
-    return 2.0*a*b/(a+b);
-  } else {
-    return 0.0;
-  }
-}
-
-KOKKOS_INLINE_FUNCTION
-Real VL4Limiter(const Real a, const Real b, const Real c, const Real d) {
-  return VanLeerLimiter(VanLeerLimiter(a,b),VanLeerLimiter(c,d));
-}
-
 //----------------------------------------------------------------------------------------
 //! \fn Real KappaTemp()
 //! \brief Temperature-dependent conductivity given by Parker (1953) and Spitzer (1962)
@@ -81,6 +69,12 @@ Conduction::Conduction(std::string block, MeshBlockPack *pp, ParameterInput *pin
   kappa_ceiling = pin->GetOrAddReal(block,"cond_ceiling",
                   static_cast<Real>(std::numeric_limits<float>::max()));
   sat_hflux = pin->GetOrAddBoolean(block,"sat_hflux",false);
+  kappa_aniso = pin->GetOrAddReal(block,"aniso_conductivity",0.0);
+  if ((kappa_aniso > 0.0) && (block.compare("mhd") != 0)) {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "Anisotropic conduction only works in <mhd>" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -94,13 +88,14 @@ Conduction::~Conduction() {
 //! \brief Adds heat flux to face-centered fluxes of conserved variables
 
 void Conduction::AddHeatFlux(const DvceArray5D<Real> &w0, const EOS_Data &eos,
-  DvceFaceFld5D<Real> &flx) {
+  DvceFaceFld5D<FluxReal> &flx) {
   if (tdep_kappa) {
     TempDependentHeatFlux(w0, eos, flx);
   } else if (kappa > 0.0) {
     IsotropicHeatFlux(w0, eos, flx);
-  } else {
-    return;
+  }
+  if (kappa_aniso > 0.0) {
+    AnisotropicHeatFlux(w0, pmy_pack->pmhd->bcc0, eos, flx);
   }
   return;
 }
@@ -109,7 +104,7 @@ void Conduction::AddHeatFlux(const DvceArray5D<Real> &w0, const EOS_Data &eos,
 //! \brief Adds isotropic heat flux to face-centered fluxes of conserved variables
 
 void Conduction::IsotropicHeatFlux(const DvceArray5D<Real> &w0, const EOS_Data &eos,
-  DvceFaceFld5D<Real> &flx) {
+  DvceFaceFld5D<FluxReal> &flx) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
@@ -185,7 +180,7 @@ void Conduction::IsotropicHeatFlux(const DvceArray5D<Real> &w0, const EOS_Data &
 //! temperature-dependent conductivity
 
 void Conduction::TempDependentHeatFlux(const DvceArray5D<Real> &w0, const EOS_Data &eos,
-  DvceFaceFld5D<Real> &flx) {
+  DvceFaceFld5D<FluxReal> &flx) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
@@ -399,6 +394,55 @@ void Conduction::TempDependentHeatFlux(const DvceArray5D<Real> &w0, const EOS_Da
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void AnisotropicHeatFlux()
+//! \brief Adds heat flux along magnetic field lines, q = -kappa_aniso b (b.grad T), to
+//! face-centered fluxes of conserved variables.  The unit vector b is the average of
+//! the cell-centered fields on either side of face, and transverse temperature gradients
+//! are slope limited (Sharma & Hammett 2007) so that the heat flux does not create new
+//! temperature extrema.
+
+void Conduction::AnisotropicHeatFlux(const DvceArray5D<Real> &w0,
+  const DvceArray5D<Real> &bcc, const EOS_Data &eos, DvceFaceFld5D<FluxReal> &flx) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto size = pmy_pack->pmb->mb_size;
+  const bool use_e = eos.use_e;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  Real gm1 = eos.gamma-1.0;
+  Real kappa_ = kappa_aniso;
+
+  // fluxes on faces normal to each direction d
+  int ndir = (three_d)? 3 : ((multi_d)? 2 : 1);
+  for (int d=0; d<ndir; ++d) {
+    auto flx_ = (d == 0)? flx.x1f : ((d == 1)? flx.x2f : flx.x3f);
+    int di = (d == 0)? 1 : 0, dj = (d == 1)? 1 : 0, dk = (d == 2)? 1 : 0;
+    par_for("aniso_cond", DevExeSpace(), 0, nmb1, ks, ke+dk, js, je+dj, is, ie+di,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      auto temp = [&](const int kk, const int jj, const int ii) {
+        return (use_e)? w0(m,IEN,kk,jj,ii)/w0(m,IDN,kk,jj,ii)*gm1 : w0(m,ITM,kk,jj,ii);
+      };
+      Real dx[3] = {size.d_view(m).dx1, size.d_view(m).dx2, size.d_view(m).dx3};
+      Real gt[3];
+      FaceGradient(temp, d, k, j, i, dx, multi_d, three_d, gt);
+
+      Real b[3];
+      for (int n=0; n<3; ++n) {
+        b[n] = 0.5*(bcc(m,IBX+n,k,j,i) + bcc(m,IBX+n,k-dk,j-dj,i-di));
+      }
+      Real b2 = SQR(b[0]) + SQR(b[1]) + SQR(b[2]);
+      if (b2 > 0.0) {
+        flx_(m,IEN,k,j,i) -= kappa_*b[d]*(b[0]*gt[0] + b[1]*gt[1] + b[2]*gt[2])/b2;
+      }
+    });
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Conduction::NewTimeStep()
 //! \brief Compute new time step for thermal conduction.
@@ -424,6 +468,7 @@ void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
   Real kappa0 = kappa;
   bool tdepkappa = tdep_kappa;
   Real kappaceil = kappa_ceiling;
+  Real kappa_aniso_ = kappa_aniso;
   Real fac;
   if (pmy_pack->pmesh->three_d) {
     fac = 1.0/6.0;
@@ -440,7 +485,7 @@ void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
   dtnew = static_cast<Real>(std::numeric_limits<float>::max());
 
   // find smallest timestep for thermal conduction in each cell
-  Kokkos::parallel_reduce("cond_newdt", Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  Kokkos::parallel_reduce("cond_newdt", Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
   KOKKOS_LAMBDA(const int &idx, Real &min_dt) {
     // compute m,k,j,i indices of thread and call function
     int m = (idx)/nkji;
@@ -460,6 +505,7 @@ void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
       }
       kappa_ = KappaTemp(temp*temp_unit,kappaceil)/kappa_unit;
     }
+    kappa_ += kappa_aniso_;
 
     min_dt = fmin(min_dt, SQR(size.d_view(m).dx1)/kappa_*w0_(m,IDN,k,j,i)/gm1);
     if (multi_d) {
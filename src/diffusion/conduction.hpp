@@ -7,7 +7,8 @@
 //========================================================================================
 //! \file conduction.hpp
 //! \brief Contains data and functions that implement various formulations for conduction.
-//  Currently only isotropic conduction implemented
+//  Isotropic (constant or temperature-dependent) and anisotropic (along magnetic field
+//  lines, MHD only) conduction are implemented
 
 #include <string>
 
@@ -29,14 +30,17 @@ class Conduction {
   bool tdep_kappa;    // temperature-dependent conductivity
   Real kappa_ceiling; // ceiling of thermal conductivity
   bool sat_hflux;     // saturtion of heat flux
+  Real kappa_aniso;   // thermal conductivity along magnetic field lines (MHD only)
 
   // function to add heat fluxes to Hydro and/or MHD fluxes
   void AddHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
-                   DvceFaceFld5D<Real> &f);
+                   DvceFaceFld5D<FluxReal> &f);
   void IsotropicHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
-                         DvceFaceFld5D<Real> &f);
+                         DvceFaceFld5D<FluxReal> &f);
   void TempDependentHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
-                             DvceFaceFld5D<Real> &f);
+                             DvceFaceFld5D<FluxReal> &f);
+  void AnisotropicHeatFlux(const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc,
+                           const EOS_Data &eos, DvceFaceFld5D<FluxReal> &f);
   void NewTimeStep(const DvceArray5D<Real> &w, const EOS_Data &eos_data);
 
  private:
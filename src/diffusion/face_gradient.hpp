@@ -0,0 +1,65 @@
+#ifndef DIFFUSION_FACE_GRADIENT_HPP_
+#define DIFFUSION_FACE_GRADIENT_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file face_gradient.hpp
+//  \brief Inlined functions to compute gradients at cell faces, with slope-limited
+//  transverse components as in Sharma & Hammett (2007).  Used by the anisotropic
+//  (field-aligned) conduction and viscosity.
+
+#include "athena.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn VanLeerLimiter()
+//  \brief harmonic mean of two slopes, or zero if they have opposite signs
+
+KOKKOS_INLINE_FUNCTION
+Real VanLeerLimiter(const Real a, const Real b) {
+  if (a*b > 0) {
+    return 2.0*a*b/(a+b);
+  } else {
+    return 0.0;
+  }
+}
+
+KOKKOS_INLINE_FUNCTION
+Real VL4Limiter(const Real a, const Real b, const Real c, const Real d) {
+  return VanLeerLimiter(VanLeerLimiter(a,b),VanLeerLimiter(c,d));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn FaceGradient()
+//  \brief Calculates the gradient of the cell-centered quantity f(k,j,i) at the face
+//  normal to direction d (0,1,2 for x1,x2,x3) between cells (k,j,i) and (k,j,i)-e_d.
+//  The normal component is the centered difference across the face.  Each transverse
+//  component is the van Leer limited average of the four one-sided differences in the
+//  two cells adjacent to the face, which keeps field-aligned fluxes monotone.
+
+template <typename F>
+KOKKOS_INLINE_FUNCTION
+void FaceGradient(const F &f, const int d, const int k, const int j, const int i,
+                  const Real dx[3], const bool multi_d, const bool three_d, Real g[3]) {
+  const int di[3] = {1, 0, 0};
+  const int dj[3] = {0, 1, 0};
+  const int dk[3] = {0, 0, 1};
+  const int il = i - di[d], jl = j - dj[d], kl = k - dk[d];
+  Real fr = f(k,j,i);
+  Real fl = f(kl,jl,il);
+  for (int t=0; t<3; ++t) {
+    if (t == d) {
+      g[t] = (fr - fl)/dx[t];
+    } else if ((t == 0) || (t == 1 && multi_d) || (t == 2 && three_d)) {
+      g[t] = VL4Limiter(f(k+dk[t],j+dj[t],i+di[t]) - fr,
+                        fr - f(k-dk[t],j-dj[t],i-di[t]),
+                        f(kl+dk[t],jl+dj[t],il+di[t]) - fl,
+                        fl - f(kl-dk[t],jl-dj[t],il-di[t]))/dx[t];
+    } else {
+      g[t] = 0.0;
+    }
+  }
+}
+
+#endif // DIFFUSION_FACE_GRADIENT_HPP_
@@ -168,7 +168,7 @@ void Resistivity::OhmicEField(const DvceFaceFld4D<Real> &b0, DvceEdgeFld4D<Real>
 
 
 void Resistivity::OhmicEnergyFlux(const DvceFaceFld4D<Real> &b,
-                                  DvceFaceFld5D<Real> &flx) {
+                                  DvceFaceFld5D<FluxReal> &flx) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
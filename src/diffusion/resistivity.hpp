@@ -28,7 +28,7 @@ class Resistivity {
 
   // functions to add resistive E-Field and energy flux
   void OhmicEField(const DvceFaceFld4D<Real> &b0, DvceEdgeFld4D<Real> &efld);
-  void OhmicEnergyFlux(const DvceFaceFld4D<Real> &b, DvceFaceFld5D<Real> &flx);
+  void OhmicEnergyFlux(const DvceFaceFld4D<Real> &b, DvceFaceFld5D<FluxReal> &flx);
 
  private:
   MeshBlockPack* pmy_pack;
@@ -5,7 +5,8 @@
 //========================================================================================
 //! \file viscosity.cpp
 //  \brief Implements functions for Viscosity class. This includes isotropic shear
-//  viscosity in a Newtonian fluid (in which stress is proportional to shear).
+//  viscosity in a Newtonian fluid (in which stress is proportional to shear), and (in
+//  MHD) Braginskii viscosity along magnetic field lines.
 //  Viscosity may be added to Hydro and/or MHD independently.
 
 #include <algorithm>
@@ -18,7 +19,9 @@
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "eos/eos.hpp"
+#include "mhd/mhd.hpp"
 #include "viscosity.hpp"
+#include "face_gradient.hpp"
 
 //----------------------------------------------------------------------------------------
 // ctor:
@@ -29,8 +32,16 @@
 Viscosity::Viscosity(std::string block, MeshBlockPack *pp,
                      ParameterInput *pin) :
   pmy_pack(pp) {
-  // Read coefficient of isotropic kinematic shear viscosity (must be present)
-  nu_iso = pin->GetReal(block,"viscosity");
+  // Read coefficients of isotropic and Braginskii kinematic viscosity
+  nu_iso = pin->GetOrAddReal(block,"viscosity",0.0);
+  nu_aniso = pin->GetOrAddReal(block,"aniso_viscosity",0.0);
+  aniso_limit = pin->GetOrAddBoolean(block,"aniso_visc_limit",false);
+  if ((nu_aniso > 0.0) && (block.compare("mhd") != 0)) {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "Braginskii viscosity only works in <mhd>" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  Real nu = nu_iso + nu_aniso;
 
   // viscous timestep on MeshBlock(s) in this pack
   dtnew = std::numeric_limits<float>::max();
@@ -44,9 +55,9 @@ Viscosity::Viscosity(std::string block, MeshBlockPack *pp,
     fac = 0.5;
   }
   for (int m=0; m<(pp->nmb_thispack); ++m) {
-    dtnew = std::min(dtnew, fac*SQR(size.h_view(m).dx1)/nu_iso);
-    if (pp->pmesh->multi_d) {dtnew = std::min(dtnew, fac*SQR(size.h_view(m).dx2)/nu_iso);}
-    if (pp->pmesh->three_d) {dtnew = std::min(dtnew, fac*SQR(size.h_view(m).dx3)/nu_iso);}
+    dtnew = std::min(dtnew, fac*SQR(size.h_view(m).dx1)/nu);
+    if (pp->pmesh->multi_d) {dtnew = std::min(dtnew, fac*SQR(size.h_view(m).dx2)/nu);}
+    if (pp->pmesh->three_d) {dtnew = std::min(dtnew, fac*SQR(size.h_view(m).dx3)/nu);}
   }
 }
 
@@ -56,12 +67,28 @@ Viscosity::Viscosity(std::string block, MeshBlockPack *pp,
 Viscosity::~Viscosity() {
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void AddViscousFlux
+//  \brief Adds isotropic and/or Braginskii viscous fluxes to face-centered fluxes of
+//  conserved variables
+
+void Viscosity::AddViscousFlux(const DvceArray5D<Real> &w0, const EOS_Data &eos,
+  DvceFaceFld5D<FluxReal> &flx) {
+  if (nu_iso > 0.0) {
+    IsotropicViscousFlux(w0, nu_iso, eos, flx);
+  }
+  if (nu_aniso > 0.0) {
+    BraginskiiViscousFlux(w0, pmy_pack->pmhd->bcc0, eos, flx);
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void AddIsoViscousFlux
 //  \brief Adds viscous fluxes to face-centered fluxes of conserved variables
 
 void Viscosity::IsotropicViscousFlux(const DvceArray5D<Real> &w0, const Real nu_iso,
-  const EOS_Data &eos, DvceFaceFld5D<Real> &flx) {
+  const EOS_Data &eos, DvceFaceFld5D<FluxReal> &flx) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
@@ -216,3 +243,75 @@ void Viscosity::IsotropicViscousFlux(const DvceArray5D<Real> &w0, const Real nu_
 
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void BraginskiiViscousFlux
+//  \brief Adds Braginskii viscous fluxes to face-centered fluxes of conserved variables.
+//  The viscous stress is Dp (bb - I/3), where b is the unit vector along the magnetic
+//  field and the pressure anisotropy Dp = 3 rho nu_aniso (bb:grad(v) - div(v)/3).  The
+//  field is averaged from the cells on either side of the face, and transverse velocity
+//  gradients are slope limited (Sharma & Hammett 2007).  With aniso_visc_limit, Dp is
+//  bounded by the mirror (B^2/2) and firehose (-B^2) thresholds.
+
+void Viscosity::BraginskiiViscousFlux(const DvceArray5D<Real> &w0,
+  const DvceArray5D<Real> &bcc, const EOS_Data &eos, DvceFaceFld5D<FluxReal> &flx) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto size = pmy_pack->pmb->mb_size;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  bool is_ideal = eos.is_ideal;
+  bool limit = aniso_limit;
+  Real nu_ = nu_aniso;
+
+  // fluxes on faces normal to each direction d
+  int ndir = (three_d)? 3 : ((multi_d)? 2 : 1);
+  for (int d=0; d<ndir; ++d) {
+    auto flx_ = (d == 0)? flx.x1f : ((d == 1)? flx.x2f : flx.x3f);
+    int di = (d == 0)? 1 : 0, dj = (d == 1)? 1 : 0, dk = (d == 2)? 1 : 0;
+    par_for("brag_visc", DevExeSpace(), 0, nmb1, ks, ke+dk, js, je+dj, is, ie+di,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real b[3], v[3];
+      for (int n=0; n<3; ++n) {
+        b[n] = 0.5*(bcc(m,IBX+n,k,j,i) + bcc(m,IBX+n,k-dk,j-dj,i-di));
+        v[n] = 0.5*(w0(m,IVX+n,k,j,i) + w0(m,IVX+n,k-dk,j-dj,i-di));
+      }
+      Real b2 = SQR(b[0]) + SQR(b[1]) + SQR(b[2]);
+      if (b2 <= 0.0) return;
+
+      // bb:grad(v) and div(v) from gradients of each velocity component at face
+      Real dx[3] = {size.d_view(m).dx1, size.d_view(m).dx2, size.d_view(m).dx3};
+      Real bbgv = 0.0, divv = 0.0;
+      for (int n=0; n<3; ++n) {
+        auto vel = [&](const int kk, const int jj, const int ii) {
+          return w0(m,IVX+n,kk,jj,ii);
+        };
+        Real gv[3];
+        FaceGradient(vel, d, k, j, i, dx, multi_d, three_d, gv);
+        bbgv += b[n]*(b[0]*gv[0] + b[1]*gv[1] + b[2]*gv[2]);
+        divv += gv[n];
+      }
+      bbgv /= b2;
+
+      Real dens = 0.5*(w0(m,IDN,k,j,i) + w0(m,IDN,k-dk,j-dj,i-di));
+      Real dp = 3.0*nu_*dens*(bbgv - divv/3.0);
+      if (limit) {
+        dp = fmin(fmax(dp, -b2), 0.5*b2);
+      }
+
+      // Sum viscous fluxes into fluxes of conserved variables; including energy fluxes
+      Real bv = (b[0]*v[0] + b[1]*v[1] + b[2]*v[2])/b2;
+      for (int n=0; n<3; ++n) {
+        Real delta = (n == d)? (1.0/3.0) : 0.0;
+        flx_(m,IVX+n,k,j,i) -= dp*(b[d]*b[n]/b2 - delta);
+      }
+      if (is_ideal) {
+        flx_(m,IEN,k,j,i) -= dp*(b[d]*bv - v[d]/3.0);
+      }
+    });
+  }
+  return;
+}
@@ -7,8 +7,8 @@
 //========================================================================================
 //! \file viscosity.hpp
 //  \brief Contains data and functions that implement various formulations for
-//  viscosity. Currently only Navier-Stokes (uniform, isotropic) shear viscosity
-//  is implemented. TODO: add Braginskii viscosity
+//  viscosity. Navier-Stokes (uniform, isotropic) shear viscosity, and (in MHD)
+//  Braginskii viscosity along magnetic field lines are implemented.
 
 #include <string>
 
@@ -28,10 +28,16 @@ class Viscosity {
   // data
   Real dtnew;
   Real nu_iso;     // coefficient of isotropic kinematic shear viscosity
+  Real nu_aniso;   // coefficient of Braginskii kinematic viscosity (MHD only)
+  bool aniso_limit;  // limit pressure anisotropy by mirror/firehose thresholds
 
-  // function to add viscous fluxes to Hydro and/or MHD fluxes
+  // functions to add viscous fluxes to Hydro and/or MHD fluxes
+  void AddViscousFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
+                      DvceFaceFld5D<FluxReal> &f);
   void IsotropicViscousFlux(const DvceArray5D<Real> &w, const Real nu,
-                            const EOS_Data &eos, DvceFaceFld5D<Real> &f);
+                            const EOS_Data &eos, DvceFaceFld5D<FluxReal> &f);
+  void BraginskiiViscousFlux(const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc,
+                             const EOS_Data &eos, DvceFaceFld5D<FluxReal> &f);
 
  private:
   MeshBlockPack* pmy_pack;
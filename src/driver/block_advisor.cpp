@@ -0,0 +1,212 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file block_advisor.cpp
+//! \brief Implements trial runs with candidate MeshBlock sizes at startup
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "pgen/pgen.hpp"
+#include "utils/memory_tracker.hpp"
+#include "driver/driver.hpp"
+#include "driver/block_advisor.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace block_advisor {
+
+namespace {
+struct Trial {
+  int nx1, nx2, nx3;
+  int nmb = 0;           // number of MeshBlocks (all levels)
+  double memory = 0.0;   // peak device memory per rank (MB), 0 if not tracked
+  double rate = 0.0;     // zone-cycles/s, 0 if no cycles were run
+};
+
+//----------------------------------------------------------------------------------------
+// builds the Mesh, physics, ProblemGenerator and Driver of a new run from a copy of pin
+// with MeshBlocks of size t and no outputs, and times ncycle cycles after nwarm cycles
+
+void RunTrial(ParameterInput *pin, Trial &t, const int nwarm, const int ncycle) {
+  ParameterInput *ptpin = new ParameterInput;
+  std::stringstream ss;
+  pin->ParameterDump(ss);
+  ptpin->LoadFromStream(ss);
+  ptpin->SetString("job", "block_advisor", "none");
+  ptpin->SetInteger("meshblock", "nx1", t.nx1);
+  ptpin->SetInteger("meshblock", "nx2", t.nx2);
+  ptpin->SetInteger("meshblock", "nx3", t.nx3);
+  ptpin->SetInteger("time", "nlim", -1);
+  ptpin->SetInteger("time", "ndiag", 1 << 30);
+  // outputs are only made when dt > 0 or dcycle > 0
+  for (auto &ib : ptpin->block) {
+    if (ib.block_name.compare(0, 6, "output") != 0) continue;
+    if (ptpin->DoesParameterExist(ib.block_name, "dcycle")) {
+      ptpin->SetInteger(ib.block_name, "dcycle", 0);
+    }
+    ptpin->SetReal(ib.block_name, "dt", -1.0);
+  }
+
+  (void) memory_tracker::TakeDevicePeak();
+  memory_tracker::SetScope("block_advisor");
+  Kokkos::Timer wall_clock;
+  Mesh *pmesh = new Mesh(ptpin);
+  pmesh->BuildTreeFromScratch(ptpin);
+  pmesh->AddCoordinatesAndPhysics(ptpin);
+  pmesh->pgen = std::make_unique<ProblemGenerator>(ptpin, pmesh);
+  Driver *pdriver = new Driver(ptpin, pmesh, 0.0, &wall_clock);
+  Outputs *pout = new Outputs(ptpin, pmesh);
+  pdriver->Initialize(pmesh, ptpin, pout, false);
+
+  pdriver->nlim = nwarm;
+  pdriver->Execute(pmesh, ptpin, pout);
+  Kokkos::fence();
+  int ncycle0 = pmesh->ncycle;
+  Kokkos::Timer timer;
+  pdriver->nlim = nwarm + ncycle;
+  pdriver->Execute(pmesh, ptpin, pout);
+  Kokkos::fence();
+  double time = timer.seconds();
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  t.nmb = pmesh->nmb_total;
+  double ncells = static_cast<double>(pmesh->nmb_total)*pmesh->NumberOfMeshBlockCells();
+  if (pmesh->ncycle > ncycle0 && time > 0.0) {
+    t.rate = static_cast<double>(pmesh->ncycle - ncycle0)*ncells/time;
+  }
+  t.memory = memory_tracker::TakeDevicePeak();
+
+  delete pout;
+  delete pdriver;
+  delete pmesh;
+  delete ptpin;
+  memory_tracker::SetScope("other");
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void Run()
+//! \brief Candidates and trials are the same on every rank, since the input parameters
+//! and reduced timings are identical, so every rank chooses the same size.
+
+void Run(ParameterInput *pin) {
+  std::string mode = pin->GetOrAddString("job", "block_advisor", "none");
+  if (mode.compare("none") == 0) return;
+  if (mode.compare("report") != 0 && mode.compare("apply") != 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<job>/block_advisor=" << mode << " not implemented. "
+              << "Valid choices are [none,report,apply]." << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  int nwarm = pin->GetOrAddInteger("job", "block_advisor_warmup", 2);
+  int ncycle = pin->GetOrAddInteger("job", "block_advisor_cycles", 10);
+  double max_memory = pin->GetOrAddReal("job", "block_advisor_max_memory", 0.0);
+  std::string sizes = pin->GetOrAddString("job", "block_advisor_sizes",
+                                          "8,16,32,64,128");
+  if (max_memory > 0.0) {memory_tracker::Enable();}
+
+  int mesh_nx1 = pin->GetInteger("mesh", "nx1");
+  int mesh_nx2 = pin->GetInteger("mesh", "nx2");
+  int mesh_nx3 = pin->GetInteger("mesh", "nx3");
+  bool multi_d = (mesh_nx2 > 1), three_d = (mesh_nx3 > 1);
+  bool multilevel =
+      (pin->GetOrAddString("mesh_refinement", "refinement", "none").compare("none") != 0);
+
+  // size in input file first, so that it is chosen when all are equally fast
+  std::vector<Trial> trials;
+  Trial input;
+  input.nx1 = pin->GetOrAddInteger("meshblock", "nx1", mesh_nx1);
+  input.nx2 = (multi_d)? pin->GetOrAddInteger("meshblock", "nx2", mesh_nx2) : 1;
+  input.nx3 = (three_d)? pin->GetOrAddInteger("meshblock", "nx3", mesh_nx3) : 1;
+  trials.push_back(input);
+  std::stringstream list(sizes);
+  std::string item;
+  while (std::getline(list, item, ',')) {
+    int s = std::atoi(item.c_str());
+    if (s <= 0) continue;
+    Trial t;
+    t.nx1 = std::min(s, mesh_nx1);
+    t.nx2 = (multi_d)? std::min(s, mesh_nx2) : 1;
+    t.nx3 = (three_d)? std::min(s, mesh_nx3) : 1;
+    if ((mesh_nx1 % t.nx1 != 0) || (mesh_nx2 % t.nx2 != 0) || (mesh_nx3 % t.nx3 != 0)) {
+      continue;
+    }
+    if ((t.nx1 < 4) || (t.nx2 < 4 && multi_d) || (t.nx3 < 4 && three_d)) continue;
+    if (multilevel && ((t.nx1 % 2 != 0) || (t.nx2 % 2 != 0 && multi_d) ||
+                       (t.nx3 % 2 != 0 && three_d))) continue;
+    int nroot = (mesh_nx1/t.nx1)*(mesh_nx2/t.nx2)*(mesh_nx3/t.nx3);
+    if (nroot < global_variable::nranks) continue;
+    bool found = false;
+    for (auto &u : trials) {
+      if (u.nx1 == t.nx1 && u.nx2 == t.nx2 && u.nx3 == t.nx3) {found = true;}
+    }
+    if (!(found)) {trials.push_back(t);}
+  }
+
+  if (global_variable::my_rank == 0) {
+    std::cout << "\nBlock size advisor: timing " << ncycle << " cycles after " << nwarm
+              << " warm-up cycles with " << trials.size() << " MeshBlock sizes"
+              << std::endl;
+  }
+  for (auto &t : trials) {RunTrial(pin, t, nwarm, ncycle);}
+
+  int best = -1;
+  for (std::size_t n=0; n<trials.size(); ++n) {
+    if (max_memory > 0.0 && trials[n].memory > max_memory) continue;
+    if (trials[n].rate > 0.0 && (best < 0 || trials[n].rate > trials[best].rate)) {
+      best = static_cast<int>(n);
+    }
+  }
+
+  if (global_variable::my_rank == 0) {
+    std::printf("\n  %-16s %8s %14s %14s\n", "meshblock", "nmb", "memory(MB)",
+                "zone-cycles/s");
+    for (std::size_t n=0; n<trials.size(); ++n) {
+      char size[64];
+      std::snprintf(size, sizeof(size), "%dx%dx%d", trials[n].nx1, trials[n].nx2,
+                    trials[n].nx3);
+      std::printf("  %-16s %8d %14.1f %14.4e", size, trials[n].nmb, trials[n].memory,
+                  trials[n].rate);
+      if (n == 0) {std::printf("  (input)");}
+      if (static_cast<int>(n) == best) {std::printf("  <- best");}
+      if (max_memory > 0.0 && trials[n].memory > max_memory) {
+        std::printf("  (exceeds block_advisor_max_memory)");
+      }
+      std::printf("\n");
+    }
+    if (best < 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "No MeshBlock size completed a trial within the memory limit, "
+                << "keeping the size in the input file" << std::endl;
+    } else if (mode.compare("apply") == 0) {
+      std::cout << "Using <meshblock> nx1=" << trials[best].nx1 << " nx2="
+                << trials[best].nx2 << " nx3=" << trials[best].nx3 << std::endl;
+    }
+    std::cout << std::endl;
+  }
+
+  if (best >= 0 && mode.compare("apply") == 0) {
+    pin->SetInteger("meshblock", "nx1", trials[best].nx1);
+    if (multi_d) {pin->SetInteger("meshblock", "nx2", trials[best].nx2);}
+    if (three_d) {pin->SetInteger("meshblock", "nx3", trials[best].nx3);}
+  }
+}
+
+} // namespace block_advisor
@@ -0,0 +1,32 @@
+#ifndef DRIVER_BLOCK_ADVISOR_HPP_
+#define DRIVER_BLOCK_ADVISOR_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file block_advisor.hpp
+//! \brief Trial runs at startup to choose the MeshBlock size of a new run.
+//!
+//! Enabled with <job>/block_advisor = report or apply.  For each candidate size the Mesh,
+//! physics, ProblemGenerator and Driver are built from a copy of the input parameters
+//! (without outputs), block_advisor_warmup cycles are run to exclude the first launch of
+//! each kernel, and then block_advisor_cycles cycles are timed.  The trial is deleted
+//! before the next one, and the size with the most zone-cycles/s is reported.  With
+//! "apply" it also replaces <meshblock>/nx1,nx2,nx3 in the input parameters.
+//!
+//! Candidates are cubes (squares in 2D) of edge block_advisor_sizes (a comma-separated
+//! list, by default powers of two from 8 to 128), limited to the Mesh size in each
+//! dimension, plus the size in the input file.  Sizes that do not divide the Mesh, that
+//! are not even with SMR/AMR, or that give fewer MeshBlocks than ranks are skipped.  When
+//! block_advisor_max_memory (MB of device memory per rank) is positive, memory tracking
+//! is enabled and sizes whose trial exceeds it are rejected.
+
+#include "parameter_input.hpp"
+
+namespace block_advisor {
+// runs trials and reports the best size on rank 0.  Collective over all ranks.
+void Run(ParameterInput *pin);
+} // namespace block_advisor
+
+#endif // DRIVER_BLOCK_ADVISOR_HPP_
@@ -6,11 +6,15 @@
 //! \file driver.cpp
 //  \brief implementation of functions in class Driver
 
+#include <sched.h>   // sched_yield()
+
+#include <cmath>     // ceil(), pow(), sqrt()
 #include <iostream>
 #include <iomanip>    // std::setprecision()
 #include <limits>
 #include <algorithm>
 #include <string> // string
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -19,10 +23,21 @@
 #include "outputs/outputs.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
+#include "eos/eos.hpp"
+#include "diffusion/viscosity.hpp"
+#include "diffusion/conduction.hpp"
 #include "z4c/z4c.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
 #include "ion-neutral/ion-neutral.hpp"
 #include "radiation/radiation.hpp"
+#include "particles/particles.hpp"
+#include "bvals/bvals.hpp"
+#include "shearing_box/shearing_box.hpp"
+#include "shearing_box/orbital_advection.hpp"
+#include "utils/profiling_region.hpp"
+#include "utils/host_tasks.hpp"
+#include "utils/memory_tracker.hpp"
+#include "utils/team_tuner.hpp"
 #include "driver.hpp"
 
 #if MPI_PARALLEL_ENABLED
@@ -50,6 +65,13 @@
 // The 2x RHS evaluations of Div(F) and source terms per stage is avoided by adding
 // another weighted average / caching of these terms each stage. The API and framework
 // is extensible to three register 3S* methods, although none are currently implemented.
+//
+// Physics that store the RHS in a separate register (currently only z4c) can instead use
+// the 2N-storage methods of Williamson (1980), in which at each stage l:
+//
+//    R^{l} = a_l*R^{l-1} + L(U^{l-1}),   U^{l} = U^{l-1} + b_l*dt*R^{l},
+//
+// so only U and R are stored, and the register U^{0} needed by 2S methods is dropped.
 
 // Notation: exclusively using "stage", equivalent in lit. to "substage" or "substep"
 // (infrequently "step"), to refer to the intermediate values of U^{l} between each
@@ -61,9 +83,20 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
   ndiag(1),
   nmb_updated_(0),
   npart_updated_(0),
+  nrejected_(0),
   lb_efficiency_(0),
+  overlap_comm_(false),
   pwall_clock_(ptimer),
   wall_time(wtlim),
+  use_delta(false),
+  low_storage_2n(false),
+  adaptive_dt(false),
+  err_order(0),
+  multirate_(1),
+  mr_start_(true),
+  mr_end_(false),
+  task_scheduler(TaskScheduler::serial),
+  task_wait(TaskWait::spin),
   impl_src("ru",1,1,1,1,1,1) {
   // set time-evolution option (no default)
   {
@@ -126,6 +159,40 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
       gam0[2] = 2.0/3.0;
       gam1[2] = 1.0/3.0;
       beta[2] = 2.0/3.0;
+    } else if (integrator == "rk32") {
+      // SSPRK (3,3) with embedded second-order Heun's method, for adaptive timesteps
+      // The Heun solution is 2*U^{2} - U^{0}, so setting u1 = U^{0} - 2*U^{2} in the last
+      // stage (delta[2]) gives the error estimate of the step u0 + u1 = U^{3} - U_heun
+      // without an additional register.  gam0[2] is modified to compensate.
+      nimp_stages = 0;
+      nexp_stages = 3;
+      cfl_limit = 1.0;
+      gam0[0] = 0.0;
+      gam1[0] = 1.0;
+      beta[0] = 1.0;
+
+      gam0[1] = 0.25;
+      gam1[1] = 0.75;
+      beta[1] = 0.25;
+
+      gam0[2] = 4.0/3.0;
+      gam1[2] = 1.0/3.0;
+      beta[2] = 2.0/3.0;
+
+      delta[0] = 0.0;
+      delta[1] = 0.0;
+      delta[2] = -2.0;
+      use_delta = true;
+      adaptive_dt = true;
+      err_order = 2;
+
+      auto pmbp = pmesh->pmb_pack;
+      if (pmbp->prad != nullptr || pmbp->pionn != nullptr || pmbp->ppart != nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+           << std::endl << "integrator=" << integrator << " is only implemented for "
+           << "hydro, MHD, and z4c" << std::endl;
+        exit(EXIT_FAILURE);
+      }
     } else if (integrator == "rk4") {
       // RK4()4[2S] from Table 2 of Ketcheson (2010)
       // Non-SSP, explicit four-stage, fourth-order RK
@@ -158,6 +225,88 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
       delta[1] = 0.217683334308543;
       delta[2] = 1.065841341361089;
       delta[3] = 0.0;
+      use_delta = true;
+    } else if (integrator == "ssprk43") {
+      // SSPRK (4,3): Spiteri & Ruuth (2002), Ketcheson (2008)
+      // Explicit four-stage, third-order SSPRK with SSP coefficient 2, so that
+      // c_eff = c/nstages = 1/2, 50% larger than SSPRK (3,3).  u1 only stores U^{0}.
+      nimp_stages = 0;
+      nexp_stages = 4;
+      cfl_limit = 2.0;
+      gam0[0] = 0.0;
+      gam1[0] = 1.0;
+      beta[0] = 0.5;
+
+      gam0[1] = 1.0;
+      gam1[1] = 0.0;
+      beta[1] = 0.5;
+
+      gam0[2] = 1.0/3.0;
+      gam1[2] = 2.0/3.0;
+      beta[2] = 1.0/6.0;
+
+      gam0[3] = 1.0;
+      gam1[3] = 0.0;
+      beta[3] = 0.5;
+    } else if (integrator == "ssprk104") {
+      // SSPRK (10,4): Ketcheson (2008)
+      // Explicit ten-stage, fourth-order SSPRK with SSP coefficient 6, so that
+      // c_eff = c/nstages = 0.6 (compared to ~0.35 for rk4).  The two-register algorithm
+      // (registers q1, q2) is mapped to the 2S form above: stage 5 directly forms the
+      // combination 0.6*U^{0} + 0.4*q1 at which stage 6 is evaluated, and u1 is then
+      // set to U^{0} - 1.8*U^{5} = -2*q2 (delta[5]) as needed by the last stage.
+      nimp_stages = 0;
+      nexp_stages = 10;
+      cfl_limit = 6.0;
+      for (int l=0; l<nexp_stages; ++l) {
+        gam0[l] = 1.0;
+        gam1[l] = 0.0;
+        beta[l] = 1.0/6.0;
+        delta[l] = 0.0;
+      }
+      gam0[0] = 0.0;
+      gam1[0] = 1.0;
+
+      gam0[4] = 0.4;
+      gam1[4] = 0.6;
+      beta[4] = 1.0/15.0;
+
+      gam0[9] = 0.6;
+      gam1[9] = -0.5;
+      beta[9] = 0.1;
+
+      delta[0] = 1.0;
+      delta[5] = -1.8;
+      use_delta = true;
+    } else if (integrator == "lsrk54") {
+      // RK4(3)5[2N]: Carpenter & Kennedy (1994), solution 3
+      // Explicit five-stage, fourth-order 2N-storage RK (non-SSP).  Only supported by
+      // z4c, which then does not allocate u1.  cfl_limit is stability limit with 1st
+      // order upwind fluxes, computed as for rk4 above.
+      nimp_stages = 0;
+      nexp_stages = 5;
+      cfl_limit = 2.2213;
+      low_storage_2n = true;
+      a_2n[0] = 0.0;
+      a_2n[1] = -567301805773.0/1357537059087.0;
+      a_2n[2] = -2404267990393.0/2016746695238.0;
+      a_2n[3] = -3550918686646.0/2091501179385.0;
+      a_2n[4] = -1275806237668.0/842570457699.0;
+
+      b_2n[0] = 1432997174477.0/9575080441755.0;
+      b_2n[1] = 5161836677717.0/13612068292357.0;
+      b_2n[2] = 1720146321549.0/2090206949498.0;
+      b_2n[3] = 3134564353537.0/4481467310338.0;
+      b_2n[4] = 2277821191437.0/14882151754819.0;
+
+      auto pmbp = pmesh->pmb_pack;
+      if (pmbp->pz4c == nullptr || pmbp->phydro != nullptr || pmbp->pmhd != nullptr ||
+          pmbp->prad != nullptr || pmbp->ppart != nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+           << std::endl << "integrator=" << integrator << " is only implemented for "
+           << "z4c without other physics" << std::endl;
+        exit(EXIT_FAILURE);
+      }
     } else if (integrator == "imex2") {
       // IMEX-SSP2(3,2,2): Pareschi & Russo (2005) Table III.
       // two-stage explicit, three-stage implicit, second-order ImEx
@@ -273,9 +422,146 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
          << std::endl << "integrator=" << integrator << " not implemented. "
-         << "Valid choices are [rk1,rk2,rk3,rk4,imex2,imex3]." << std::endl;
+         << "Valid choices are [rk1,rk2,rk3,rk32,rk4,ssprk43,ssprk104,lsrk54,imex2,"
+         << "imex2+,imex3]." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // tolerances of error control with embedded RK pairs.  The error norm of the step is
+    // the maximum over all active cells and variables of |err|/(atol + rtol*|U|), and
+    // steps with norm > 1 are rejected and repeated with a smaller timestep.
+    if (adaptive_dt) {
+      err_rtol = pin->GetOrAddReal("time", "err_rtol", 1.0e-3);
+      err_atol = pin->GetOrAddReal("time", "err_atol", 1.0e-6);
+      err_safety = pin->GetOrAddReal("time", "err_safety", 0.9);
+      err_maxreject = pin->GetOrAddInteger("time", "err_maxreject", 10);
+      if (err_rtol < 0.0 || err_atol < 0.0 || (err_rtol + err_atol) <= 0.0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+           << std::endl << "err_rtol and err_atol must be >= 0, and not both zero"
+           << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+
+    // fraction of dt reached by the state after each stage, from the same weighted
+    // averages of the registers u0 and u1 as are used in the update
+    {
+      Real t0 = 0.0, t1 = 0.0;
+      tstage[0] = 0.0;
+      for (int s=0; s<nexp_stages; ++s) {
+        if (s == 0) {
+          t1 = t0;
+        } else if (use_delta) {
+          t1 += delta[s]*t0;
+        }
+        t0 = gam0[s]*t0 + gam1[s]*t1 + beta[s];
+        tstage[s+1] = t0;
+      }
+    }
+
+    // Hydro u1_release_cycles releases u1 of cold MBs, which error control reads for all
+    if (adaptive_dt && (pmesh->pmb_pack->phydro != nullptr) &&
+        (pmesh->pmb_pack->phydro->u1_release_cycles > 0)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "<hydro>/u1_release_cycles cannot be used with integrator="
+         << integrator << std::endl;
       exit(EXIT_FAILURE);
     }
+
+    // multirate coupling of z4c and dynamical GRMHD
+    if ((pmesh->pmb_pack->pz4c != nullptr) && (pmesh->pmb_pack->pz4c->multirate > 1)) {
+      multirate_ = pmesh->pmb_pack->pz4c->multirate;
+      if (pmesh->pmb_pack->pdyngr == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+           << std::endl << "<z4c>/multirate > 1 requires dynamical GRMHD" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      if (adaptive_dt || low_storage_2n || nimp_stages > 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+           << std::endl << "<z4c>/multirate > 1 cannot be used with integrator="
+           << integrator << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      if (pmesh->adaptive || pmesh->lb_automatic) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+           << std::endl << "<z4c>/multirate > 1 cannot be used with AMR or automatic "
+           << "load balancing" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+
+    // RKL1/RKL2 super time-stepping of viscosity and conduction (Meyer et al. 2014)
+    sts_integrator = pin->GetOrAddString("time", "sts_integrator", "none");
+    if (sts_integrator.compare("none") != 0 && sts_integrator.compare("rkl1") != 0 &&
+        sts_integrator.compare("rkl2") != 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "sts_integrator=" << sts_integrator << " not implemented. "
+         << "Valid choices are [none,rkl1,rkl2]." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // select scheduler used to dispatch Tasks.  With the concurrent scheduler, ready
+    // Tasks are launched on separate execution space instances (streams on GPUs)
+    std::string sched = pin->GetOrAddString("time", "task_scheduler", "serial");
+    if (sched.compare("serial") == 0) {
+      task_scheduler = TaskScheduler::serial;
+    } else if (sched.compare("concurrent") == 0) {
+      task_scheduler = TaskScheduler::concurrent;
+      int nstreams = pin->GetOrAddInteger("time", "task_streams", 4);
+      if (nstreams < 1) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+           << std::endl << "task_streams=" << nstreams << " must be >= 1" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      std::vector<int> weights(nstreams, 1);
+      task_exec_spaces = Kokkos::Experimental::partition_space(DevExeSpace(), weights);
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "task_scheduler=" << sched << " not implemented. "
+         << "Valid choices are [serial,concurrent]." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // select how to wait when a sweep over all TaskLists completes no Tasks, so that
+    // only Tasks waiting on communication remain.  With "yield" the thread is yielded
+    // to the OS, and with "block" all kernels are fenced and then the rank blocks in
+    // MPI_Waitsome until a receive completes, rather than spinning on MPI_Test.
+    std::string wait = pin->GetOrAddString("time", "task_wait", "spin");
+    if (wait.compare("spin") == 0) {
+      task_wait = TaskWait::spin;
+    } else if (wait.compare("yield") == 0) {
+      task_wait = TaskWait::yield;
+    } else if (wait.compare("block") == 0) {
+      task_wait = TaskWait::block;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "task_wait=" << wait << " not implemented. "
+         << "Valid choices are [spin,yield,block]." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    // messages received through shared memory do not complete any MPI request
+    if ((task_wait == TaskWait::block) &&
+        pin->GetOrAddBoolean("mesh", "shared_memory_exchange", false)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "task_wait=block cannot be used with "
+         << "<mesh>/shared_memory_exchange" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // replay kernels of small Tasks (CopyCons, Restrict) from device graphs captured
+    // once per stage, and captured again after AMR or load balancing (CUDA/HIP only)
+    task_graphs = pin->GetOrAddBoolean("time", "task_graphs", false);
+
+    for (auto &it : pmesh->pmb_pack->tl_map) {
+      it.second->SetScheduler(task_scheduler, &task_exec_spaces);
+      if (task_graphs) {it.second->EnableGraphs(&(pmesh->mesh_version));}
+      // automatic load balancing measures wall time spent in Tasks.  Timing a Task
+      // requires a fence after it, so only one cycle in every lb_sample_cycles is timed.
+      if (pmesh->lb_automatic) {
+        it.second->EnableSampledProfiling(&(pmesh->ncycle), pmesh->lb_sample_cycles,
+                                          pmesh->lb_cost_window);
+      }
+    }
   }
 }
 
@@ -284,8 +570,11 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
 //! \brief Perform tasks over all MeshBlocks for the TaskList specified by string "tl".
 //! Integer argument "stage" can be used to indicate at which step in overall algorithm
 //! these tasks are to be performed, e.g. which stage of a multi-stage RK integrator.
+//! When a pass over the TaskList completes no Tasks, the remaining Tasks are waiting on
+//! communication, and WaitForProgress() is called unless task_wait=spin.
 
 void Driver::ExecuteTaskList(Mesh *pm, std::string tl, int stage) {
+  ProfilingRegion region(tl);
   MeshBlockPack* pmbp = pm->pmb_pack;
   for (int p=0; p<(pm->nmb_packs_thisrank); ++p) {
     if (!(pmbp->tl_map[tl]->Empty())) {pmbp->tl_map[tl]->Reset();}
@@ -296,14 +585,332 @@ void Driver::ExecuteTaskList(Mesh *pm, std::string tl, int stage) {
       npack_left--;
     } else {
       if (!pmbp->tl_map[tl]->IsComplete()) {
+        int ncompleted = pmbp->tl_map[tl]->NumberCompleted();
         auto status = pmbp->tl_map[tl]->DoAvailable(this, stage);
-        if (status == TaskListStatus::complete) { npack_left--; }
+        if (status == TaskListStatus::complete) {
+          npack_left--;
+        } else if ((pmbp->tl_map[tl]->NumberCompleted() == ncompleted) &&
+                   (task_wait != TaskWait::spin)) {
+          WaitForProgress(pm);
+        }
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::WaitForProgress()
+//! \brief Called when a pass over a TaskList completed no Tasks, so that remaining
+//! Tasks are waiting on communication.  With task_wait=block, all kernels are fenced
+//! (so that sends which depend on them are not delayed by the wait) and the rank then
+//! blocks in MPI_Waitsome on all receives that are active in the boundary values,
+//! shearing box, orbital advection, and particle objects on this rank.  Completed
+//! requests are written back in place, so the MPI_Test in the receive Tasks then
+//! succeeds (and finds the same request state MPI_Test itself would have produced).
+//! When there are no active receives, or task_wait=yield, the thread is yielded.
+
+void Driver::WaitForProgress(Mesh *pm) {
+#if MPI_PARALLEL_ENABLED
+  if (task_wait == TaskWait::block) {
+    Kokkos::fence();
+    MeshBlockPack *pmbp = pm->pmb_pack;
+    std::vector<MPI_Request*> preqs;
+    if (pmbp->phydro != nullptr) {
+      pmbp->phydro->pbval_u->AddRecvRequests(preqs);
+      if (pmbp->phydro->porb_u != nullptr) {pmbp->phydro->porb_u->AddRecvRequests(preqs);}
+      if (pmbp->phydro->psbox_u != nullptr) {
+        pmbp->phydro->psbox_u->AddRecvRequests(preqs);
+      }
+    }
+    if (pmbp->pmhd != nullptr) {
+      pmbp->pmhd->pbval_u->AddRecvRequests(preqs);
+      pmbp->pmhd->pbval_b->AddRecvRequests(preqs);
+      if (pmbp->pmhd->porb_u != nullptr) {pmbp->pmhd->porb_u->AddRecvRequests(preqs);}
+      if (pmbp->pmhd->porb_b != nullptr) {pmbp->pmhd->porb_b->AddRecvRequests(preqs);}
+      if (pmbp->pmhd->psbox_u != nullptr) {pmbp->pmhd->psbox_u->AddRecvRequests(preqs);}
+      if (pmbp->pmhd->psbox_b != nullptr) {pmbp->pmhd->psbox_b->AddRecvRequests(preqs);}
+    }
+    if (pmbp->prad != nullptr) {pmbp->prad->pbval_i->AddRecvRequests(preqs);}
+    if (pmbp->pmsg_group != nullptr) {pmbp->pmsg_group->AddRecvRequests(preqs);}
+    if (pmbp->pz4c != nullptr) {
+      pmbp->pz4c->pbval_u->AddRecvRequests(preqs);
+      pmbp->pz4c->pbval_weyl->AddRecvRequests(preqs);
+    }
+    if (pmbp->ppart != nullptr) {pmbp->ppart->pbval_part->AddRecvRequests(preqs);}
+
+    // copy active requests into contiguous array for MPI_Waitsome
+    std::vector<MPI_Request> reqs;
+    std::vector<MPI_Request*> pactive;
+    for (auto preq : preqs) {
+      if (*preq != MPI_REQUEST_NULL) {
+        reqs.push_back(*preq);
+        pactive.push_back(preq);
+      }
+    }
+    if (!(reqs.empty())) {
+      int nreq = static_cast<int>(reqs.size());
+      int outcount;
+      std::vector<int> indices(nreq);
+      int ierr = MPI_Waitsome(nreq, reqs.data(), &outcount, indices.data(),
+                              MPI_STATUSES_IGNORE);
+      if (ierr != MPI_SUCCESS) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MPI error in waiting on non-blocking receives"
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      for (int n=0; n<nreq; ++n) {*(pactive[n]) = reqs[n];}
+      // outcount is MPI_UNDEFINED if all requests were inactive persistent requests
+      if (outcount != MPI_UNDEFINED) {return;}
+    }
+  }
+#endif
+  sched_yield();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::NumberOfSTSStages()
+//! \brief Returns the smallest number of RKL1/RKL2 stages s that is stable over the
+//! timestep dt, given the minimum explicit timestep dt_par of the diffusion terms
+//! integrated with super time-stepping over all ranks.  The stability limits are
+//! dt <= dt_par*(s^2+s)/2 (RKL1) and dt <= dt_par*(s^2+s-2)/4 (RKL2).  Returns 0 if no
+//! physics uses STS.
+
+int Driver::NumberOfSTSStages(Mesh *pm) {
+  if (sts_integrator.compare("none") == 0) return 0;
+  hydro::Hydro *phydro = pm->pmb_pack->phydro;
+  mhd::MHD *pmhd = pm->pmb_pack->pmhd;
+  bool use_sts = false;
+  Real dt_par = std::numeric_limits<float>::max();
+  if ((phydro != nullptr) && phydro->use_sts) {
+    use_sts = true;
+    if (phydro->pvisc != nullptr) {
+      dt_par = std::min(dt_par, (pm->cfl_no)*(phydro->pvisc->dtnew));
+    }
+    if (phydro->pcond != nullptr) {
+      dt_par = std::min(dt_par, (pm->cfl_no)*(phydro->pcond->dtnew));
+    }
+  }
+  if ((pmhd != nullptr) && pmhd->use_sts) {
+    use_sts = true;
+    if (pmhd->pvisc != nullptr) {
+      dt_par = std::min(dt_par, (pm->cfl_no)*(pmhd->pvisc->dtnew));
+    }
+    if (pmhd->pcond != nullptr) {
+      dt_par = std::min(dt_par, (pm->cfl_no)*(pmhd->pcond->dtnew));
+    }
+  }
+  if (!(use_sts)) return 0;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &dt_par, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+  Real ratio = (pm->dt)/dt_par;
+  int s;
+  if (sts_integrator.compare("rkl1") == 0) {
+    s = static_cast<int>(std::ceil(0.5*(std::sqrt(1.0 + 8.0*ratio) - 1.0)));
+    s = std::max(s, 1);
+  } else {
+    s = static_cast<int>(std::ceil(0.5*(std::sqrt(9.0 + 16.0*ratio) - 1.0)));
+    s = std::max(s, 2);
+  }
+  return s;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::STSCoefficients()
+//! \brief Returns coefficients of stage j of RKL1/RKL2 super time-stepping with
+//! nsts_stages stages (Meyer, Balsara, & Aslam 2014, eqs. 9 and 17), such that
+//!   Y_j = mu Y_{j-1} + nu Y_{j-2} + (1-mu-nu) Y_0 + mu_t dt L(Y_{j-1}) + gam_t dt L(Y_0)
+
+void Driver::STSCoefficients(int j, Real &mu, Real &nu, Real &mu_t, Real &gam_t) {
+  Real s = static_cast<Real>(nsts_stages);
+  Real rj = static_cast<Real>(j);
+  if (sts_integrator.compare("rkl1") == 0) {
+    Real w1 = 2.0/(s*s + s);
+    mu = (2.0*rj - 1.0)/rj;
+    nu = (1.0 - rj)/rj;
+    mu_t = w1*mu;
+    gam_t = 0.0;
+  } else {
+    Real w1 = 4.0/(s*s + s - 2.0);
+    if (j == 1) {
+      mu = 1.0;
+      nu = 0.0;
+      mu_t = w1/3.0;
+      gam_t = 0.0;
+    } else {
+      // b_j = (j^2+j-2)/(2j(j+1)) for j>=2, with b_0 = b_1 = b_2 = 1/3
+      Real b[3];
+      for (int n=0; n<3; ++n) {
+        Real rn = static_cast<Real>(j - n);
+        b[n] = ((j - n) < 2)? (1.0/3.0) : (rn*rn + rn - 2.0)/(2.0*rn*(rn + 1.0));
       }
+      mu = (2.0*rj - 1.0)/rj*b[0]/b[1];
+      nu = -(rj - 1.0)/rj*b[0]/b[2];
+      mu_t = w1*mu;
+      gam_t = -(1.0 - b[1])*mu_t;
     }
   }
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Real Driver::EmbeddedErrorNorm()
+//! \brief Returns the maximum over all active cells in MeshBlockPack pmbp and the first
+//! nvar variables of |u0 + u1|/(atol + rtol*|u0|), where after the last stage of an
+//! embedded RK pair u0 + u1 is the error estimate of the step.  Called by the
+//! NewTimeStep() task of each physics module.
+
+Real Driver::EmbeddedErrorNorm(MeshBlockPack *pmbp, const DvceArray5D<Real> &u0,
+                               const DvceArray5D<Real> &u1, const int nvar) {
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmnkji = (pmbp->nmb_thispack)*nvar*nx3*nx2*nx1;
+  const int nnkji = nvar*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  Real atol = err_atol, rtol = err_rtol;
+
+  Real err = 0.0;
+  Kokkos::parallel_reduce("ErrNorm",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmnkji),
+  KOKKOS_LAMBDA(const int &idx, Real &max_err) {
+    // compute m,n,k,j,i indices of thread
+    int m = (idx)/nnkji;
+    int n = (idx - m*nnkji)/nkji;
+    int k = (idx - m*nnkji - n*nkji)/nji;
+    int j = (idx - m*nnkji - n*nkji - k*nji)/nx1;
+    int i = (idx - m*nnkji - n*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+
+    Real u = u0(m,n,k,j,i);
+    max_err = fmax(fabs(u + u1(m,n,k,j,i))/(atol + rtol*fabs(u)), max_err);
+  }, Kokkos::Max<Real>(err));
+  return err;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool Driver::AcceptStep()
+//! \brief Error control with embedded RK pairs, called after "stagen" of the last stage
+//! once each physics module has computed the error norm of the step.  Returns false if
+//! the norm exceeds one (unless nreject steps have already been rejected this cycle), in
+//! which case dt is reduced.  Otherwise sets the upper limit on the next timestep.  Both
+//! use the standard controller dt*safety*err^(-1/(p+1)) limited to [0.2,2]*dt, with p
+//! the order of the embedded method.
+
+bool Driver::AcceptStep(Mesh *pm, int nreject) {
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  Real err = 0.0;
+  if (pmbp->phydro != nullptr) {err = std::max(err, pmbp->phydro->errnew);}
+  if (pmbp->pmhd != nullptr) {err = std::max(err, pmbp->pmhd->errnew);}
+  if (pmbp->pz4c != nullptr) {err = std::max(err, pmbp->pz4c->errnew);}
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &err, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+  // NaN norm (e.g. from unstable step) gives the minimum factor
+  Real fac = 2.0;
+  if (err != 0.0) {
+    fac = err_safety*std::pow(err, -1.0/static_cast<Real>(err_order + 1));
+    fac = std::min(2.0, std::max(0.2, fac));
+  }
+  if ((err <= 1.0) || (nreject >= err_maxreject)) {
+    pm->dt_err = fac*(pm->dt);
+    return true;
+  }
+  pm->dt *= fac;
+  return false;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Driver::RejectStep()
+//! \brief Restores conserved variables (and face-centered fields) saved at the start of a
+//! rejected step, and fills ghost zones and primitives so the step can be repeated.
+
+void Driver::RejectStep(Mesh *pm) {
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  if (pmbp->phydro != nullptr) {
+    Kokkos::deep_copy(DevExeSpace(), pmbp->phydro->u0, pmbp->phydro->u_start);
+  }
+  if (pmbp->pmhd != nullptr) {
+    Kokkos::deep_copy(DevExeSpace(), pmbp->pmhd->u0, pmbp->pmhd->u_start);
+    Kokkos::deep_copy(DevExeSpace(), pmbp->pmhd->b0.x1f, pmbp->pmhd->b_start.x1f);
+    Kokkos::deep_copy(DevExeSpace(), pmbp->pmhd->b0.x2f, pmbp->pmhd->b_start.x2f);
+    Kokkos::deep_copy(DevExeSpace(), pmbp->pmhd->b0.x3f, pmbp->pmhd->b_start.x3f);
+  }
+  if (pmbp->pz4c != nullptr) {
+    // ghost zones of u_start are valid, so ADM variables can be restored everywhere
+    Kokkos::deep_copy(DevExeSpace(), pmbp->pz4c->u0, pmbp->pz4c->u_start);
+    (void) pmbp->pz4c->ConvertZ4cToADM(this, 0);
+  }
+  InitBoundaryValuesAndPrimitives(pm);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Driver::MultirateTimeStep()
+//! \brief With multirate coupling of z4c and dynamical GRMHD, sets the macro step of the
+//! spacetime at the start of each macro step to multirate*dt (limited by tlim), and
+//! shortens the timestep of the matter so the last cycle ends exactly at its end.
+
+void Driver::MultirateTimeStep(Mesh *pm) {
+  if (mr_start_) {
+    mr_time0 = pm->time;
+    mr_dtmacro = std::min(static_cast<Real>(multirate_)*pm->dt, tlim - pm->time);
+  }
+  Real mr_tend = mr_time0 + mr_dtmacro;
+  // avoid a very short extra cycle at the end of the macro step
+  if (pm->time + pm->dt > mr_tend - 1.0e-6*pm->dt) {
+    pm->dt = mr_tend - pm->time;
+    mr_end_ = true;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Driver::ExecuteMultirateStages()
+//! \brief Time-integrator stages with multirate coupling of z4c and dynamical GRMHD.  At
+//! the start of each macro step the spacetime is advanced over the whole macro step with
+//! Tmunu extrapolated in time, and the matter is then advanced over this cycle with the
+//! ADM variables interpolated in time (by the MHD_MRADM task in each stage).
+
+void Driver::ExecuteMultirateStages(Mesh *pm) {
+  z4c::Z4c *pz4c = pm->pmb_pack->pz4c;
+  if (mr_start_) {
+    pz4c->MultirateStartMacroStep(this);
+    Real dt = pm->dt;
+    pm->dt = mr_dtmacro;
+    for (int stage=1; stage<=(nexp_stages); ++stage) {
+      pz4c->MultirateExtrapolateTmunu(tstage[stage-1]);
+      ExecuteTaskList(pm, "z4c_before_stagen", stage);
+      ExecuteTaskList(pm, "z4c_stagen", stage);
+      ExecuteTaskList(pm, "z4c_after_stagen", stage);
+    }
+    pm->dt = dt;
+    pz4c->MultirateEndMacroStep();
+    mr_start_ = false;
+  }
+
+  // ADM variables at the start of this cycle
+  pz4c->MultirateInterpolateADM((pm->time - mr_time0)/mr_dtmacro);
+  for (int stage=1; stage<=(nexp_stages); ++stage) {
+    ExecuteTaskList(pm, "mhd_before_stagen", stage);
+    ExecuteTaskList(pm, "mhd_stagen", stage);
+    ExecuteTaskList(pm, "mhd_after_stagen", stage);
+    pm->pcounter.nstages++;
+  }
+  if (mr_end_) {
+    mr_start_ = true;
+    mr_end_ = false;
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 // Driver::Initialize()
 // Tasks to be performed before execution of Driver, such as setting ghost zones (BCs),
@@ -316,6 +923,9 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
   //---- Step 2.  Compute time step (if problem involves time evolution)
   hydro::Hydro *phydro = pmesh->pmb_pack->phydro;
   mhd::MHD *pmhd = pmesh->pmb_pack->pmhd;
+  // with overlapped communication ghost zones are only filled at start of each stage
+  overlap_comm_ = ((phydro != nullptr) && phydro->overlap_comm) ||
+                  ((pmhd != nullptr) && pmhd->overlap_comm);
   radiation::Radiation *prad = pmesh->pmb_pack->prad;
   z4c::Z4c *pz4c = pmesh->pmb_pack->pz4c;
   if (time_evolution != TimeEvolution::tstatic) {
@@ -345,6 +955,7 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
 
   //---- Step 4.  Initialize various counters, timers, etc.
   run_time_.reset();
+  memory_tracker::ResetTransfers();
   nmb_updated_ = 0;
 
   // allocate memory for stiff source terms with ImEx integrators
@@ -362,7 +973,10 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
     int ncells1 = indcs.nx1 + 2*(indcs.ng);
     int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
     int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(impl_src, nimp_stages, nmb, 8, ncells3, ncells2, ncells1);
+    // stiff source terms of momenta and densities, and with ideal EOS energies
+    int nsrc = (pmesh->pmb_pack->pmhd->peos->eos_data.is_ideal &&
+                pmesh->pmb_pack->phydro->peos->eos_data.is_ideal)? 10 : 8;
+    Kokkos::realloc(impl_src, nimp_stages, nmb, nsrc, ncells3, ncells2, ncells1);
   }
 
   return;
@@ -389,30 +1003,84 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
     }
     while ((pmesh->time < tlim) && (pmesh->ncycle < nlim || nlim < 0) &&
            (elapsed_time < wall_time)) {
+      ProfilingRegion cycle_region("Cycle");
       if (global_variable::my_rank == 0) {OutputCycleDiagnostics(pmesh);}
+      if (multirate_ > 1) {MultirateTimeStep(pmesh);}
+
+      // flag whether any output will be made at the end of this cycle (same test as
+      // below), so tasks that only compute data for outputs can be skipped otherwise
+      output_due = false;
+      for (auto &out : pout->pout_list) {
+        float time_32 = static_cast<float>(pmesh->time + pmesh->dt);
+        float next_32 = static_cast<float>(out->out_params.last_time+out->out_params.dt);
+        float tlim_32 = static_cast<float>(tlim);
+        int &dcycle_ = out->out_params.dcycle;
+        if (((out->out_params.dt > 0.0) && ((time_32 >= next_32) && (time_32<tlim_32))) ||
+            ((dcycle_ > 0) && ((pmesh->ncycle + 1)%(dcycle_) == 0)) ) {
+          output_due = true;
+        }
+      }
 
       // Execute TaskLists
       // Work before time integrator indicated by "0" in stage
       ExecuteTaskList(pmesh, "before_timeintegrator", 0);
 
-      // time-integrator tasks for each stage of integrator
-      for (int stage=1; stage<=(nexp_stages); ++stage) {
+      // time-integrator tasks for each stage of integrator.  With embedded RK pairs, the
+      // error of the step is known after "stagen" of the last stage, and rejected steps
+      // are repeated from the first stage with a smaller dt.
+      int nreject = 0;
+      if (multirate_ > 1) {ExecuteMultirateStages(pmesh);}
+      // messages of different physics are only combined inside the explicit stages
+      MeshBoundaryMessageGroup *pgroup = pmesh->pmb_pack->pmsg_group;
+      if (pgroup != nullptr) {pgroup->enabled = true;}
+      for (int stage=1; (multirate_ == 1) && (stage<=(nexp_stages)); ++stage) {
         ExecuteTaskList(pmesh, "before_stagen", stage);
         ExecuteTaskList(pmesh, "stagen", stage);
+        pmesh->pcounter.nstages++;
+        if (adaptive_dt && (stage == nexp_stages)) {
+          step_rejected = !(AcceptStep(pmesh, nreject));
+        }
         ExecuteTaskList(pmesh, "after_stagen", stage);
+        if (step_rejected) {
+          RejectStep(pmesh);
+          step_rejected = false;
+          nreject++;
+          stage = 0;
+        }
+      }
+      nrejected_ += nreject;
+      if (pgroup != nullptr) {pgroup->enabled = false;}
+
+      // operator-split super time-stepping of diffusion terms over the full timestep
+      nsts_stages = NumberOfSTSStages(pmesh);
+      for (int stage=1; stage<=(nsts_stages); ++stage) {
+        ExecuteTaskList(pmesh, "before_sts", stage);
+        ExecuteTaskList(pmesh, "sts", stage);
+        ExecuteTaskList(pmesh, "after_sts", stage);
       }
 
+      // With async_dt, start the global reduction of the new timestep as soon as the
+      // local dt is known, and overlap it with the remaining work in this cycle
+      if (pmesh->async_dt) {pmesh->StartNewTimeStep();}
+
       // Work after time integrator indicated by "1" in stage
       ExecuteTaskList(pmesh, "after_timeintegrator", 1);
 
+      // measure cost of MeshBlocks for automatic load balancing (in sampled cycles)
+      if (pmesh->lb_automatic && (pmesh->ncycle % pmesh->lb_sample_cycles) == 0) {
+        pmesh->UpdateMeasuredCosts();
+      }
+
       // Work outside of TaskLists:
       // increment time, ncycle, etc.
       pmesh->time = pmesh->time + pmesh->dt;
       pmesh->ncycle++;
       nmb_updated_ += pmesh->nmb_total;
       npart_updated_ += pmesh->nprtcl_total;
-      // load balancing efficiency
-      if (global_variable::nranks > 1) {
+      // load balancing efficiency (measured from costs with automatic load balancing)
+      if (pmesh->lb_automatic) {
+        lb_efficiency_ += pmesh->lb_efficiency;
+      } else if (global_variable::nranks > 1) {
         int minnmb = std::numeric_limits<int>::max();
         for (int i=0; i<global_variable::nranks; ++i) {
           minnmb = std::min(minnmb, pmesh->nmb_eachrank[i]);
@@ -421,25 +1089,68 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
             static_cast<float>(pmesh->nmb_total);
       }
 
-      // Test for/make outputs
-      for (auto &out : pout->pout_list) {
-        // compare at floating point (32-bit) precision to reduce effect of round off
-        float time_32 = static_cast<float>(pmesh->time);
-        float next_32 = static_cast<float>(out->out_params.last_time+out->out_params.dt);
-        float tlim_32 = static_cast<float>(tlim);
-        int &dcycle_ = out->out_params.dcycle;
+      // with overlapped communication ghost zones are stale at the end of the cycle, so
+      // they must be filled before any output or AMR
+      bool stale_ghosts = overlap_comm_;
 
-        if (((out->out_params.dt > 0.0) && ((time_32 >= next_32) && (time_32<tlim_32))) ||
-            ((dcycle_ > 0) && ((pmesh->ncycle)%(dcycle_) == 0)) ) {
-          out->LoadOutputData(pmesh);
-          out->WriteOutputFile(pmesh, pin);
+      // Test for/make outputs
+      {
+        ProfilingRegion output_region("Outputs");
+        // accumulate data of time-averaged outputs
+        for (auto &out : pout->pout_list) {
+          if (out->SampleDue(pmesh)) {
+            if (stale_ghosts) {
+              InitBoundaryValuesAndPrimitives(pmesh);
+              stale_ghosts = false;
+            }
+            out->AccumulateData(pmesh, pin);
+          }
+        }
+        for (auto &out : pout->pout_list) {
+          // compare at floating point (32-bit) precision to reduce effect of round off
+          float time_32 = static_cast<float>(pmesh->time);
+          OutputParameters &op = out->out_params;
+          float next_32 = static_cast<float>(op.last_time + op.dt);
+          float tlim_32 = static_cast<float>(tlim);
+          int &dcycle_ = op.dcycle;
+
+          if (((op.dt > 0.0) && ((time_32 >= next_32) && (time_32<tlim_32))) ||
+              ((dcycle_ > 0) && ((pmesh->ncycle)%(dcycle_) == 0)) ) {
+            if (stale_ghosts) {
+              InitBoundaryValuesAndPrimitives(pmesh);
+              stale_ghosts = false;
+            }
+            out->LoadOutputData(pmesh);
+            out->WriteOutputFile(pmesh, pin);
+          }
         }
       }
 
       // AMR
-      if (pmesh->adaptive) {pmesh->pmr->AdaptiveMeshRefinement(this, pin);}
+      if (stale_ghosts && (pmesh->adaptive || pmesh->lb_automatic)) {
+        InitBoundaryValuesAndPrimitives(pmesh);
+      }
+      {
+        ScopedTimer amr_timer(pmesh->pcounter.t_amr);
+        if (pmesh->adaptive) {
+          ProfilingRegion amr_region("AMR");
+          pmesh->pmr->AdaptiveMeshRefinement(this, pin);
+        }
+        // automatic load balancing using measured costs
+        if (pmesh->lb_automatic) {
+          ProfilingRegion lb_region("LoadBalance");
+          pmesh->pmr->RebalanceMeshBlocks(this, pin);
+        }
+      }
       // compute new timestep AFTER all Meshblocks refined/derefined
-      pmesh->NewTimeStep(tlim);
+      if (pmesh->async_dt) {
+        pmesh->FinishNewTimeStep(tlim);
+      } else {
+        pmesh->NewTimeStep(tlim);
+      }
+
+      team_tuner::EndCycle();
+      memory_tracker::EndCycle();
 
       // Update wall clock time if needed.
       if (wall_time > 0.) {
@@ -456,15 +1167,36 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
 //!  and printing diagnostic messages
 
 void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
-  // cycle through output Types and load data / write files
-  //  This design allows for asynchronous outputs to implemented in the future.
+  // write team sizes tuned so far, if tuning has not already ended
+  team_tuner::Finish();
+
+  // fill ghost zones left stale at end of last cycle with overlapped communication
+  if (overlap_comm_ && (time_evolution != TimeEvolution::tstatic)) {
+    InitBoundaryValuesAndPrimitives(pmesh);
+  }
+
+  // Z4c constraints are only computed in cycles with outputs, so update them for the
+  // final outputs
+  if ((time_evolution != TimeEvolution::tstatic) && (pmesh->pmb_pack->pz4c != nullptr)) {
+    output_due = true;
+    pmesh->pmb_pack->pz4c->ADMConstraints_(this, nexp_stages);
+  }
+
+  // cycle through output Types and load data / write files.  Binary outputs with
+  //  async=true are completed by a background thread, which is joined when the output
+  //  is destroyed.
   for (auto &out : pout->pout_list) {
     out->LoadOutputData(pmesh);
     out->WriteOutputFile(pmesh, pin);
   }
+  // complete rows of diagnostic files written by host threads
+  host_tasks::Join();
 
   // call any problem specific functions to do work after main loop
   if (pmesh->pgen->pgen_final_func != nullptr) {
+    // error functions may store solutions in u1 for every MB
+    auto phydro = pmesh->pmb_pack->phydro;
+    if (phydro != nullptr) {phydro->WakeColdMeshBlocks();}
     (pmesh->pgen->pgen_final_func)(pin, pmesh);
   }
 
@@ -473,9 +1205,11 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
   if (time_evolution != TimeEvolution::tstatic) {
 #if MPI_PARALLEL_ENABLED
     // Collect number of MeshBlocks communicated during load balancing across all ranks
-    if (pmesh->adaptive) {
+    if (pmesh->adaptive || pmesh->lb_automatic) {
       MPI_Allreduce(MPI_IN_PLACE, &(pmesh->pmr->nmb_sent_thisrank), 1, MPI_INT, MPI_SUM,
                     MPI_COMM_WORLD);
+      MPI_Allreduce(MPI_IN_PLACE, &(pmesh->pmr->nbytes_sent_thisrank), 1, MPI_DOUBLE,
+                    MPI_SUM, MPI_COMM_WORLD);
     }
 #endif
     if (global_variable::my_rank == 0) {
@@ -497,8 +1231,16 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
           << std::endl << pmesh->pmr->nmb_created << " MeshBlocks created, "
           << pmesh->pmr->nmb_deleted << " deleted by AMR" << std::endl;
 #if MPI_PARALLEL_ENABLED
-        std::cout << pmesh->pmr->nmb_sent_thisrank << " communicated for load balancing, "
-          <<"load balancing efficiency = " << (lb_efficiency_/pmesh->ncycle) << std::endl;
+        std::cout << pmesh->pmr->nmb_sent_thisrank << " communicated for load balancing ("
+          << pmesh->pmr->nbytes_sent_thisrank/1048576.0 << " MB), load balancing "
+          << "efficiency = " << (lb_efficiency_/pmesh->ncycle) << std::endl;
+#endif
+      } else if (pmesh->lb_automatic) {
+#if MPI_PARALLEL_ENABLED
+        std::cout << std::endl << pmesh->pmr->nmb_sent_thisrank << " MeshBlocks ("
+          << pmesh->pmr->nbytes_sent_thisrank/1048576.0 << " MB) communicated for load "
+          << "balancing, measured load balancing efficiency = "
+          << (lb_efficiency_/pmesh->ncycle) << std::endl;
 #endif
       }
 
@@ -510,11 +1252,23 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
       float pups = static_cast<float>(npart_updated_) / exe_time;
 
       std::cout << std::endl << "MeshBlock-cycles = " << nmb_updated_ << std::endl;
+      if (adaptive_dt) {
+        std::cout << "steps rejected by error control = " << nrejected_ << std::endl;
+      }
       std::cout << "cpu time used  = " << exe_time << std::endl;
       std::cout << "zone-cycles/cpu_second = " << zcps << std::endl;
       std::cout << "particle-updates/cpu_second = " << pups << std::endl;
+      // same results as key=value pairs on one line, parsed by the performance checks
+      // of the test suite (tst/run_test_suite.py --perf)
+      std::cout << "ATHENA_PERF zone_cycles_per_s=" << zcps
+                << " particle_updates_per_s=" << pups << " cpu_seconds=" << exe_time
+                << " meshblock_cycles=" << nmb_updated_
+                << " cells_per_meshblock=" << pmesh->NumberOfMeshBlockCells()
+                << " nranks=" << global_variable::nranks << std::endl;
     }
   }
+  // host<->device copies per cycle and peak device memory (with <job>/memory_report)
+  memory_tracker::ReportTransfers();
   return;
 }
 
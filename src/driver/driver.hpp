@@ -15,8 +15,10 @@
 #include <ctime>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "parameter_input.hpp"
+#include "tasklist/task_list.hpp"
 #include "outputs/outputs.hpp"
 #include "pgen/pgen.hpp"
 
@@ -40,13 +42,38 @@ class Driver {
   std::string integrator;          // integrator name (rk1, rk2, rk3)
   int nimp_stages;                 // number of implicit stages (ImEx only)
   int nexp_stages;                 // number of explicit stages (both SSP-RK and ImEx)
-  Real gam0[4], gam1[4], beta[4];  // weights and fractional timestep per explicit stage
-  Real delta[4];                   // weights for updating the intermediate stage (u1)
+  Real gam0[10], gam1[10], beta[10];  // weights and fractional timestep per stage
+  Real delta[10];                  // weights for updating the intermediate stage (u1)
+  bool use_delta;                  // delta is non-zero after the first stage
+  // 2N-storage (Williamson) integrators, with R = a_2n*R + L(u) and u += b_2n*dt*R
+  bool low_storage_2n;
+  Real a_2n[10], b_2n[10];
+  // error control with embedded RK pairs, in which u0 + u1 after the last stage is the
+  // difference between the solution and that of the embedded method of order err_order
+  bool adaptive_dt;
+  int err_order;
+  Real err_rtol, err_atol;         // relative and absolute tolerances of error norm
+  Real err_safety;                 // safety factor of new timestep
+  int err_maxreject;               // maximum number of rejected steps in one cycle
+  bool step_rejected = false;      // step will be repeated (set after last "stagen")
+  Real tstage[11];                 // fraction of dt reached by state after each stage
+  // multirate coupling of z4c and dynamical GRMHD, in which the spacetime is advanced
+  // over the macro step [mr_time0, mr_time0 + mr_dtmacro] once every <z4c>/multirate
+  // cycles of the matter (see z4c/z4c_multirate.cpp)
+  Real mr_time0 = 0.0, mr_dtmacro = 1.0;
   Real a_twid[4][4], a_impl;       // matrix elements for implicit stages in ImEx
   Real cfl_limit;                  // maximum CFL number for integrator
   Real gamma;                      // gamma value for the IMEX_new integrator
+  // operator-split super time-stepping (STS) of diffusion terms
+  std::string sts_integrator;      // STS integrator name (none, rkl1, rkl2)
+  int nsts_stages = 0;             // number of STS stages in this cycle
   Kokkos::Timer* pwall_clock_;     // timer for tracking the wall clock
   Real wall_time;
+  TaskScheduler task_scheduler;    // algorithm used to dispatch Tasks in TaskLists
+  std::vector<DevExeSpace> task_exec_spaces;  // instances used by concurrent scheduler
+  TaskWait task_wait;              // how to wait when TaskLists make no progress
+  bool task_graphs = false;        // replay kernels of some Tasks from device graphs
+  bool output_due = true;          // outputs will be made at the end of this cycle
 
   // functions
   void ExecuteTaskList(Mesh *pm, std::string tl, int stage);
@@ -54,13 +81,35 @@ class Driver {
   void Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout);
   void Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout);
   void InitBoundaryValuesAndPrimitives(Mesh *pm);
+  void STSCoefficients(int stage, Real &mu, Real &nu, Real &mu_t, Real &gam_t);
+  Real EmbeddedErrorNorm(MeshBlockPack *pmbp, const DvceArray5D<Real> &u0,
+                         const DvceArray5D<Real> &u1, const int nvar);
+  // true if integrator uses 2N-storage, so physics modules need not allocate u1
+  static bool LowStorage2N(const std::string &integrator) {
+    return (integrator.compare("lsrk54") == 0);
+  }
+  // true if integrator is an embedded pair, so physics modules must save u0 at the start
+  // of each step in case the step is rejected
+  static bool EmbeddedPair(const std::string &integrator) {
+    return (integrator.compare("rk32") == 0);
+  }
 
  private:
   Kokkos::Timer run_time_;      // generalized timer for cpu/gpu/etc
   std::uint64_t nmb_updated_;   // running total of MB updated during run
   std::uint64_t npart_updated_; // running total of particles updated during run
+  int nrejected_;               // running total of steps rejected by error control
   float lb_efficiency_;         // measure of how efficient was load balancing
+  bool overlap_comm_;           // ghost zones not filled at end of cycle (overlap_comm)
   void OutputCycleDiagnostics(Mesh *pm);
+  int NumberOfSTSStages(Mesh *pm);
+  bool AcceptStep(Mesh *pm, int nreject);
+  int multirate_;               // ratio of matter to spacetime cycles (1 if disabled)
+  bool mr_start_, mr_end_;      // this cycle starts/ends a multirate macro step
+  void MultirateTimeStep(Mesh *pm);
+  void ExecuteMultirateStages(Mesh *pm);
+  void RejectStep(Mesh *pm);
+  void WaitForProgress(Mesh *pm);
   Real UpdateWallClock();
 };
 #endif // DRIVER_DRIVER_HPP_
@@ -0,0 +1,168 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file ensemble.cpp
+//! \brief Implements runs of the members of an ensemble, one after another
+
+#include <unistd.h>   // chdir(), getcwd()
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "pgen/pgen.hpp"
+#include "utils/utils.hpp"
+#include "driver/driver.hpp"
+#include "driver/ensemble.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace ensemble {
+
+namespace {
+//----------------------------------------------------------------------------------------
+// reads the overrides of each member from fname on rank 0, and broadcasts them
+
+std::vector<std::string> ReadMembers(const std::string &fname) {
+  std::string text;
+  if (global_variable::my_rank == 0) {
+    std::ifstream is(fname);
+    if (!is.good()) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Ensemble file '" << fname << "' could not be opened"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    std::stringstream ss;
+    ss << is.rdbuf();
+    text = ss.str();
+  }
+#if MPI_PARALLEL_ENABLED
+  int nbytes = static_cast<int>(text.size());
+  MPI_Bcast(&nbytes, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (global_variable::my_rank != 0) text.resize(nbytes);
+  if (nbytes > 0) MPI_Bcast(&text[0], nbytes, MPI_CHAR, 0, MPI_COMM_WORLD);
+#endif
+  std::vector<std::string> members;
+  std::istringstream is(text);
+  std::string line;
+  while (std::getline(is, line)) {
+    std::size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') continue;
+    members.push_back(line.substr(first));
+  }
+  return members;
+}
+
+//----------------------------------------------------------------------------------------
+// applies the block/par=value overrides of one member to pin
+
+void ApplyOverrides(ParameterInput *pin, const std::string &overrides) {
+  std::istringstream ss(overrides);
+  std::string tok;
+  while (ss >> tok) {
+    std::size_t slash_posn = tok.find_first_of("/");
+    std::size_t equal_posn = tok.find_first_of("=");
+    if ((slash_posn == std::string::npos) || (equal_posn == std::string::npos) ||
+        (equal_posn < slash_posn)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Ensemble override '" << tok << "' is not of the form "
+                << "block/par=value" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    pin->SetString(tok.substr(0, slash_posn),
+                   tok.substr(slash_posn+1, (equal_posn - slash_posn - 1)),
+                   tok.substr(equal_posn+1, std::string::npos));
+  }
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn bool Enabled()
+
+bool Enabled(ParameterInput *pin) {
+  return pin->DoesParameterExist("job", "ensemble_file") &&
+         !(pin->GetString("job", "ensemble_file").empty());
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Run()
+//! \brief Builds and runs each member from a copy of pin with its overrides, as in main()
+//! for new runs.  Members are deleted before the next one is built.
+
+void Run(ParameterInput *pin, const std::string &run_dir, const Real wtlim) {
+  std::vector<std::string> members = ReadMembers(pin->GetString("job", "ensemble_file"));
+  int nmember = static_cast<int>(members.size());
+  if (nmember == 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Ensemble file '" << pin->GetString("job", "ensemble_file")
+              << "' does not define any members" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // members are run in subdirectories of run_dir, entered from the starting directory
+  char cwd[PATH_MAX];
+  if (getcwd(cwd, sizeof(cwd)) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Cannot get current directory" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  std::stringstream dump;
+  pin->ParameterDump(dump);
+  const std::string params = dump.str();
+  for (int n=0; n<nmember; ++n) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "\nEnsemble member " << n << " of " << nmember << ": " << members[n]
+                << std::endl;
+    }
+    ParameterInput *pmpin = new ParameterInput;
+    std::stringstream ss(params);
+    pmpin->LoadFromStream(ss);
+    pmpin->SetString("job", "ensemble_file", "");
+    ApplyOverrides(pmpin, members[n]);
+
+    Kokkos::Timer timer;
+    Mesh *pmesh = new Mesh(pmpin);
+    pmesh->BuildTreeFromScratch(pmpin);
+    pmesh->AddCoordinatesAndPhysics(pmpin);
+    pmesh->pgen = std::make_unique<ProblemGenerator>(pmpin, pmesh);
+
+    char member_dir[20];
+    std::snprintf(member_dir, sizeof(member_dir), "member_%04d", n);
+    ChangeRunDir(run_dir);
+    ChangeRunDir(member_dir);
+    Driver *pdriver = new Driver(pmpin, pmesh, wtlim, &timer);
+    Outputs *pout = new Outputs(pmpin, pmesh);
+    pdriver->Initialize(pmesh, pmpin, pout, false);
+    pdriver->Execute(pmesh, pmpin, pout);
+    pdriver->Finalize(pmesh, pmpin, pout);
+
+    delete pout;
+    delete pdriver;
+    delete pmesh;
+    delete pmpin;
+    if (chdir(cwd)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Cannot cd to directory '" << cwd << "'" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+}
+
+} // namespace ensemble
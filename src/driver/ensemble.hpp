@@ -0,0 +1,33 @@
+#ifndef DRIVER_ENSEMBLE_HPP_
+#define DRIVER_ENSEMBLE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file ensemble.hpp
+//! \brief Runs an ensemble of independent new runs (e.g. for parameter sweeps) in one
+//! process.
+//!
+//! Enabled with <job>/ensemble_file.  Each non-empty line of the file that does not start
+//! with '#' defines one member, as whitespace-separated block/par=value overrides of the
+//! input parameters (added if they do not exist).  Members are run one after another,
+//! each with its own Mesh, ProblemGenerator, Driver and Outputs built from a copy of the
+//! input parameters, in the directory member_NNNN inside the run directory, so outputs
+//! (and restart files) stay separate.  The wall time limit applies to each member.  All
+//! members are built and run in the same process, so Kokkos and MPI are initialized, and
+//! the job is scheduled, only once for the whole ensemble.
+
+#include <string>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+
+namespace ensemble {
+// returns true if pin requests an ensemble
+bool Enabled(ParameterInput *pin);
+// runs all members.  Collective over all ranks.
+void Run(ParameterInput *pin, const std::string &run_dir, const Real wtlim);
+} // namespace ensemble
+
+#endif // DRIVER_ENSEMBLE_HPP_
@@ -40,15 +40,26 @@ DynGRMHD* SelectDynGRMHDEOS(MeshBlockPack *ppack, ParameterInput *pin,
                             DynGRMHD_EOS eos_policy) {
   DynGRMHD* dyn_gr = nullptr;
   switch(eos_policy) {
+#if DYNGR_EOS_IDEAL_ENABLED
     case DynGRMHD_EOS::eos_ideal:
       dyn_gr = new DynGRMHDPS<Primitive::IdealGas, ErrorPolicy>(ppack, pin);
       break;
+#endif
+#if DYNGR_EOS_PIECEWISE_POLY_ENABLED
     case DynGRMHD_EOS::eos_piecewise_poly:
       dyn_gr = new DynGRMHDPS<Primitive::PiecewisePolytrope, ErrorPolicy>(ppack, pin);
       break;
+#endif
+#if DYNGR_EOS_COMPOSE_ENABLED
     case DynGRMHD_EOS::eos_compose:
       dyn_gr = new DynGRMHDPS<Primitive::EOSCompOSE, ErrorPolicy>(ppack, pin);
       break;
+#endif
+    default:
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mhd> dyn_eos was not compiled, reconfigure with "
+                << "Athena_DYNGR_EOS" << std::endl;
+      std::exit(EXIT_FAILURE);
   }
   return dyn_gr;
 }
@@ -94,7 +105,8 @@ DynGRMHD* BuildDynGRMHD(MeshBlockPack *ppack, ParameterInput *pin) {
   return dyn_gr;
 }
 
-DynGRMHD::DynGRMHD(MeshBlockPack *pp, ParameterInput *pin) : pmy_pack(pp) {
+DynGRMHD::DynGRMHD(MeshBlockPack *pp, ParameterInput *pin) :
+    face_metric("face_metric",1,1,1,1,1), pmy_pack(pp) {
   std::string rsolver = pin->GetString("mhd", "rsolver");
   if (rsolver.compare("llf") == 0) {
     rsolver_method = DynGRMHD_RSolver::llf_dyngr;
@@ -122,11 +134,115 @@ DynGRMHD::DynGRMHD(MeshBlockPack *pp, ParameterInput *pin) : pmy_pack(pp) {
   dmp_M = pin->GetOrAddReal("mhd", "dmp_M", 1.2);
 
   fixed_evolution = pin->GetOrAddBoolean("mhd", "fixed", false);
+
+  // With fused_tmunu, the stress-energy tensor is set by the primitive solve at the end
+  // of each stage, so SetTmunu only has to compute it after MBs have changed.
+  fused_tmunu = pin->GetOrAddBoolean("mhd", "fused_tmunu", false);
+  tmunu_version = -1;
 }
 
 DynGRMHD::~DynGRMHD() {
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void DynGRMHD::SetFaceMetric()
+//  \brief Averages the 3-metric, shift and lapse to every face with cells on both sides
+//  (with the same operations as adm::Face1Metric() etc., so results are unchanged).
+//  Arrays are reallocated when the number of MeshBlocks changes.
+
+void DynGRMHD::SetFaceMetric() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb = pmy_pack->nmb_thispack;
+  if (face_metric.x1f.extent_int(0) != nmb ||
+      face_metric.x1f.extent_int(4) != ncells1 + 1) {
+    Kokkos::realloc(face_metric.x1f, nmb, adm::NFACEMETRIC, ncells3, ncells2, ncells1+1);
+    Kokkos::realloc(face_metric.x2f, nmb, adm::NFACEMETRIC, ncells3, ncells2+1, ncells1);
+    Kokkos::realloc(face_metric.x3f, nmb, adm::NFACEMETRIC, ncells3+1, ncells2, ncells1);
+  }
+
+  auto &adm = pmy_pack->padm->adm;
+  auto &fmet1 = face_metric.x1f;
+  par_for("face_metric1", DevExeSpace(), 0, nmb-1, 0, ncells3-1, 0, ncells2-1,
+          1, ncells1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real g3d[NSPMETRIC], beta_u[3], alpha;
+    adm::Face1Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+    for (int n = 0; n < NSPMETRIC; ++n) {fmet1(m,n,k,j,i) = g3d[n];}
+    for (int a = 0; a < 3; ++a) {fmet1(m,NSPMETRIC+a,k,j,i) = beta_u[a];}
+    fmet1(m,NSPMETRIC+3,k,j,i) = alpha;
+  });
+  if (pmy_pack->pmesh->multi_d) {
+    auto &fmet2 = face_metric.x2f;
+    par_for("face_metric2", DevExeSpace(), 0, nmb-1, 0, ncells3-1, 1, ncells2-1,
+            0, ncells1-1,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real g3d[NSPMETRIC], beta_u[3], alpha;
+      adm::Face2Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      for (int n = 0; n < NSPMETRIC; ++n) {fmet2(m,n,k,j,i) = g3d[n];}
+      for (int a = 0; a < 3; ++a) {fmet2(m,NSPMETRIC+a,k,j,i) = beta_u[a];}
+      fmet2(m,NSPMETRIC+3,k,j,i) = alpha;
+    });
+  }
+  if (pmy_pack->pmesh->three_d) {
+    auto &fmet3 = face_metric.x3f;
+    par_for("face_metric3", DevExeSpace(), 0, nmb-1, 1, ncells3-1, 0, ncells2-1,
+            0, ncells1-1,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real g3d[NSPMETRIC], beta_u[3], alpha;
+      adm::Face3Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      for (int n = 0; n < NSPMETRIC; ++n) {fmet3(m,n,k,j,i) = g3d[n];}
+      for (int a = 0; a < 3; ++a) {fmet3(m,NSPMETRIC+a,k,j,i) = beta_u[a];}
+      fmet3(m,NSPMETRIC+3,k,j,i) = alpha;
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void DynGRMHD::C2PIterationsEachMB(std::vector<float> &iters)
+//  \brief Returns the mean number of primitive solver iterations per active cell in each
+//  MeshBlock of this pack, as measured in the last primitive solve.  All values are zero
+//  if the number of iterations is not being saved.
+
+void DynGRMHD::C2PIterationsEachMB(std::vector<float> &iters) {
+  int nmb = pmy_pack->nmb_thispack;
+  iters.assign(nmb, 0.0);
+  DvceArray5D<Real> *pdata = GetC2PData();
+  if (pdata == nullptr) return;
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, nx1 = indcs.nx1;
+  int &js = indcs.js, nx2 = indcs.nx2;
+  int &ks = indcs.ks, nx3 = indcs.nx3;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &c2p_data = *pdata;
+  DualArray1D<Real> iters_mb("c2p_iters", nmb);
+  par_for_outer("C2PIterEachMB",DevExeSpace(), 0, 0, 0, (nmb-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+    Real team_sum = 0.0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+    [=](const int idx, Real& sum) {
+      int k = (idx)/nji;
+      int j = (idx - k*nji)/nx1;
+      int i = (idx - k*nji - j*nx1) + is;
+      j += js;
+      k += ks;
+      sum += c2p_data(m,1,k,j,i);
+    },Kokkos::Sum<Real>(team_sum));
+    iters_mb.d_view(m) = team_sum/static_cast<Real>(nkji);
+  });
+  iters_mb.template modify<DevExeSpace>();
+  iters_mb.template sync<HostMemSpace>();
+  for (int m=0; m<nmb; ++m) {
+    iters[m] = static_cast<float>(iters_mb.h_view(m));
+  }
+  return;
+}
+
 template<class EOSPolicy, class ErrorPolicy>
 void DynGRMHDPS<EOSPolicy, ErrorPolicy>::QueueDynGRMHDTasks() {
   using namespace mhd;  // NOLINT(build/namespaces)
@@ -143,21 +259,25 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::QueueDynGRMHDTasks() {
   // Run task list
   pnr->QueueTask(&MHD::CopyCons, pmhd, MHD_CopyU, "MHD_CopyU", Task_Run);
 
-  // Select which CalculateFlux function to add based on rsolver_method.
+  // Select which CalculateFlux function to add based on rsolver_method and recon_method.
   // CalcFlux requires metric in flux - must happen before z4ctoadm updates the metric
-  if (rsolver_method == DynGRMHD_RSolver::llf_dyngr) {
-    pnr->QueueTask(
-           &DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes<DynGRMHD_RSolver::llf_dyngr>,
-           this, MHD_Flux, "MHD_Flux", Task_Run, {MHD_CopyU});
-  } else if (rsolver_method == DynGRMHD_RSolver::hlle_dyngr) {
-    pnr->QueueTask(
-           &DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes<DynGRMHD_RSolver::hlle_dyngr>,
-           this, MHD_Flux, "MHD_Flux", Task_Run, {MHD_CopyU});
-  } else { // put more rsolvers here
-    abort();
+  auto flux_kernel = SelectFluxKernel();
+  if (flux_kernel == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "DynGRMHD Riemann solver and reconstruction method were "
+              << "not compiled, reconfigure with Athena_FLUX_RECON or "
+              << "Athena_DYNGR_RSOLVER" << std::endl;
+    std::exit(EXIT_FAILURE);
   }
+  pnr->QueueTask(flux_kernel, this, MHD_Flux, "MHD_Flux", Task_Run, {MHD_CopyU});
 
   // Now the rest of the MHD run tasks
+  if (fused_tmunu && pz4c != nullptr && pz4c->multirate > 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<mhd>/fused_tmunu cannot be used with multirate coupling "
+              << "to z4c, since the ADM variables are interpolated in time" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
   if (pz4c != nullptr) {
     pnr->QueueTask(&DynGRMHD::SetTmunu, this, MHD_SetTmunu, "MHD_SetTmunu",
                    Task_Run, {MHD_CopyU});
@@ -196,6 +316,11 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::QueueDynGRMHDTasks() {
                    "MHD_C2P", Task_Run, {MHD_Prolong, MHD_SetADM}, {Z4c_Excise});
     pnr->QueueTask(&DynGRMHD::UpdateExcisionMasks, this, MHD_Excise, "MHD_Excise",
                    Task_Run, {MHD_SetADM});
+  } else if (pz4c != nullptr && pz4c->multirate > 1) {
+    pnr->QueueTask(&DynGRMHD::MultirateADM, this, MHD_MRADM, "MHD_MRADM", Task_Run,
+                   {MHD_Prolong});
+    pnr->QueueTask(&DynGRMHDPS<EOSPolicy, ErrorPolicy>::ConToPrim, this, MHD_C2P,
+                   "MHD_C2P", Task_Run, {MHD_Prolong, MHD_MRADM}, {Z4c_Excise});
   } else {
     pnr->QueueTask(&DynGRMHDPS<EOSPolicy, ErrorPolicy>::ConToPrim, this, MHD_C2P,
                    "MHD_C2P", Task_Run, {MHD_Prolong}, {Z4c_Excise});
@@ -265,8 +390,13 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::ConToPrim(Driver *pdrive, int sta
   int n1m1 = indcs.nx1 + 2*ng - 1;
   int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
   int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  Tmunu *ptmunu = (fused_tmunu)? pmy_pack->ptmunu : nullptr;
   eos.ConsToPrim(pmy_pack->pmhd->u0, pmy_pack->pmhd->b0, pmy_pack->pmhd->bcc0,
-                 pmy_pack->pmhd->w0, 0, n1m1, 0, n2m1, 0, n3m1, false);
+                 pmy_pack->pmhd->w0, 0, n1m1, 0, n2m1, 0, n3m1, false, ptmunu);
+  if (ptmunu != nullptr) {
+    ptmunu->SetMatterBlocks();
+    tmunu_version = pmy_pack->pmesh->mesh_version;
+  }
   return TaskStatus::complete;
 }
 
@@ -291,12 +421,24 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::AddCoordTerms(const DvceArray5D<Real> &
     const DvceArray5D<Real> &bcc,
     const Real dt, DvceArray5D<Real> &rhs, int nghost) {
   switch (nghost) {
+#if DYNGR_NGHOST_2_ENABLED
     case 2: AddCoordTermsEOS<2>(prim, bcc, dt, rhs);
             break;
+#endif
+#if DYNGR_NGHOST_3_ENABLED
     case 3: AddCoordTermsEOS<3>(prim, bcc, dt, rhs);
             break;
+#endif
+#if DYNGR_NGHOST_4_ENABLED
     case 4: AddCoordTermsEOS<4>(prim, bcc, dt, rhs);
             break;
+#endif
+    default:
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "DynGRMHD source terms with nghost = " << nghost
+                << " were not compiled, reconfigure with Athena_DYNGR_NGHOST"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
   }
 }
 
@@ -363,11 +505,16 @@ TaskStatus DynGRMHD::ApplyPhysicalBCs(Driver *pdrive, int stage) {
 //----------------------------------------------------------------------------------------
 //! \fn  TaskStatus DynGRMHD::SetTmunu(Driver *pdrive, int stage)
 //! \brief Add the perfect fluid contribution to the stress-energy tensor. This is assumed
-//!  to be the first contribution, so it sets the values rather than adding.
+//!  to be the first contribution, so it sets the values rather than adding.  With
+//!  fused_tmunu, Tmunu is already set by ConToPrim unless MBs have changed since.
 TaskStatus DynGRMHD::SetTmunu(Driver *pdrive, int stage) {
   if (fixed_evolution) {
     return TaskStatus::complete;
   }
+  if (fused_tmunu && pdrive != nullptr &&
+      tmunu_version == pmy_pack->pmesh->mesh_version) {
+    return TaskStatus::complete;
+  }
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   //auto &size  = pmy_pack->pmb->mb_size;
   int &is = indcs.is; int &ie = indcs.ie;
@@ -425,6 +572,19 @@ TaskStatus DynGRMHD::SetTmunu(Driver *pdrive, int stage) {
       }
     }
   });
+  pmy_pack->ptmunu->SetMatterBlocks();
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus DynGRMHD::MultirateADM
+//! \brief With multirate coupling to z4c, interpolates the ADM variables in time to the
+//! end of this stage, before they are used by ConToPrim and the next stage.
+
+TaskStatus DynGRMHD::MultirateADM(Driver *pdrive, int stage) {
+  Mesh *pm = pmy_pack->pmesh;
+  Real time = pm->time + pdrive->tstage[stage]*pm->dt;
+  pmy_pack->pz4c->MultirateInterpolateADM((time - pdrive->mr_time0)/pdrive->mr_dtmacro);
   return TaskStatus::complete;
 }
 
@@ -461,7 +621,9 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::AddCoordTermsEOS(const DvceArray5D<Real
   int &js = indcs.js; int &je = indcs.je;
   int &ks = indcs.ks; int &ke = indcs.ke;
 
-  int nmb = pmy_pack->nmb_thispack;
+  // only MBs not entirely excised (all MBs, unless <coord>/skip_excised_blocks)
+  int nmb = pmy_pack->pcoord->nmb_unexcised;
+  auto &emb_ = pmy_pack->pcoord->unexcised_mbs;
 
   auto &adm = pmy_pack->padm->adm;
   auto &eos_ = eos.ps.GetEOS();
@@ -488,7 +650,8 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::AddCoordTermsEOS(const DvceArray5D<Real
   }
 
   par_for("coord_src", DevExeSpace(), 0, nmb-1, ks, ke, js, je, is, ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  KOKKOS_LAMBDA(const int ma, const int k, const int j, const int i) {
+    const int m = emb_.d_view(ma);
     // Extract the metric and coordinate quantities.
     Real g3d[NSPMETRIC] = {adm.g_dd(m,0,0,k,j,i), adm.g_dd(m,0,1,k,j,i),
                            adm.g_dd(m,0,2,k,j,i), adm.g_dd(m,1,1,k,j,i),
@@ -606,30 +769,55 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::AddCoordTermsEOS(const DvceArray5D<Real
   });
 }
 
-// Instantiated templates
-template class DynGRMHDPS<Primitive::IdealGas, Primitive::ResetFloor>;
-template class DynGRMHDPS<Primitive::PiecewisePolytrope, Primitive::ResetFloor>;
-template class DynGRMHDPS<Primitive::EOSCompOSE, Primitive::ResetFloor>;
-
-// Macro for defining CoordTerms templates
-#define INSTANTIATE_COORD_TERMS(EOSPolicy, ErrorPolicy) \
-template \
-void DynGRMHDPS<EOSPolicy, ErrorPolicy>::AddCoordTermsEOS<2>( \
-      const DvceArray5D<Real> &prim, \
-      const DvceArray5D<Real> &bcc, const Real dt, DvceArray5D<Real> &rhs); \
-template \
-void DynGRMHDPS<EOSPolicy, ErrorPolicy>::AddCoordTermsEOS<3>( \
-      const DvceArray5D<Real> &prim, \
-      const DvceArray5D<Real> &bcc, const Real dt, DvceArray5D<Real> &rhs); \
+// Macros for defining CoordTerms templates, for each number of ghost zones compiled
+#define INSTANTIATE_COORD_TERMS_NG(EOSPolicy, ErrorPolicy, NG) \
 template \
-void DynGRMHDPS<EOSPolicy, ErrorPolicy>::AddCoordTermsEOS<4>( \
+void DynGRMHDPS<EOSPolicy, ErrorPolicy>::AddCoordTermsEOS<NG>( \
       const DvceArray5D<Real> &prim, \
       const DvceArray5D<Real> &bcc, const Real dt, DvceArray5D<Real> &rhs);
 
-INSTANTIATE_COORD_TERMS(Primitive::IdealGas, Primitive::ResetFloor);
-INSTANTIATE_COORD_TERMS(Primitive::PiecewisePolytrope, Primitive::ResetFloor);
-INSTANTIATE_COORD_TERMS(Primitive::EOSCompOSE, Primitive::ResetFloor);
+#if DYNGR_NGHOST_2_ENABLED
+#define INSTANTIATE_COORD_TERMS_2(EOSPolicy, ErrorPolicy) \
+  INSTANTIATE_COORD_TERMS_NG(EOSPolicy, ErrorPolicy, 2)
+#else
+#define INSTANTIATE_COORD_TERMS_2(EOSPolicy, ErrorPolicy)
+#endif
+#if DYNGR_NGHOST_3_ENABLED
+#define INSTANTIATE_COORD_TERMS_3(EOSPolicy, ErrorPolicy) \
+  INSTANTIATE_COORD_TERMS_NG(EOSPolicy, ErrorPolicy, 3)
+#else
+#define INSTANTIATE_COORD_TERMS_3(EOSPolicy, ErrorPolicy)
+#endif
+#if DYNGR_NGHOST_4_ENABLED
+#define INSTANTIATE_COORD_TERMS_4(EOSPolicy, ErrorPolicy) \
+  INSTANTIATE_COORD_TERMS_NG(EOSPolicy, ErrorPolicy, 4)
+#else
+#define INSTANTIATE_COORD_TERMS_4(EOSPolicy, ErrorPolicy)
+#endif
+
+#define INSTANTIATE_COORD_TERMS(EOSPolicy, ErrorPolicy) \
+  INSTANTIATE_COORD_TERMS_2(EOSPolicy, ErrorPolicy) \
+  INSTANTIATE_COORD_TERMS_3(EOSPolicy, ErrorPolicy) \
+  INSTANTIATE_COORD_TERMS_4(EOSPolicy, ErrorPolicy)
+
+// Instantiated templates, for each EOS policy compiled
+#if DYNGR_EOS_IDEAL_ENABLED
+template class DynGRMHDPS<Primitive::IdealGas, Primitive::ResetFloor>;
+INSTANTIATE_COORD_TERMS(Primitive::IdealGas, Primitive::ResetFloor)
+#endif
+#if DYNGR_EOS_PIECEWISE_POLY_ENABLED
+template class DynGRMHDPS<Primitive::PiecewisePolytrope, Primitive::ResetFloor>;
+INSTANTIATE_COORD_TERMS(Primitive::PiecewisePolytrope, Primitive::ResetFloor)
+#endif
+#if DYNGR_EOS_COMPOSE_ENABLED
+template class DynGRMHDPS<Primitive::EOSCompOSE, Primitive::ResetFloor>;
+INSTANTIATE_COORD_TERMS(Primitive::EOSCompOSE, Primitive::ResetFloor)
+#endif
 
 #undef INSTANTIATE_COORD_TERMS
+#undef INSTANTIATE_COORD_TERMS_4
+#undef INSTANTIATE_COORD_TERMS_3
+#undef INSTANTIATE_COORD_TERMS_2
+#undef INSTANTIATE_COORD_TERMS_NG
 
 } // namespace dyngr
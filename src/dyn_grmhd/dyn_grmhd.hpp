@@ -8,6 +8,8 @@
 //! \file dyn_grmhd.hpp
 //  \brief definitions for DynGRMHD class
 
+#include <vector>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "tasklist/task_list.hpp"
@@ -78,6 +80,7 @@ class DynGRMHD {
 
   TaskStatus SetTmunu(Driver *d, int stage);
   TaskStatus SetADMVariables(Driver *d, int stage);
+  TaskStatus MultirateADM(Driver *d, int stage);
   TaskStatus UpdateExcisionMasks(Driver *d, int stage);
   TaskStatus ApplyPhysicalBCs(Driver *d, int stage);
 
@@ -94,6 +97,17 @@ class DynGRMHD {
   virtual void AddCoordTerms(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
                              const Real dt, DvceArray5D<Real> &u0, int nghost) = 0;
 
+  // 3-metric, shift and lapse at faces (in the layout of adm::LoadFaceMetric()),
+  // computed once per stage by SetFaceMetric() and shared by the flux and FOFC kernels
+  DvceFaceFld5D<Real> face_metric;
+  void SetFaceMetric();
+
+  // data saved from the last primitive solve in each cell (nullptr if not saved)
+  virtual DvceArray5D<Real> *GetC2PData() = 0;
+  void C2PIterationsEachMB(std::vector<float> &iters);
+  // totals over MeshBlocks on this rank of the C2PStat counts (nullptr if not counted)
+  virtual const std::vector<double> *GetC2PCountTotals() = 0;
+
   // DynGRMHD policies
   DynGRMHD_RSolver rsolver_method;
   DynGRMHD_RSolver fofc_method;
@@ -106,6 +120,8 @@ class DynGRMHD {
   bool enforce_maximum;     // enforce local maximum principle during FOFC
   Real dmp_M;               // threshold multiplier for discrete maximum principle.
   bool fixed_evolution;     // Disable mhd evolution
+  bool fused_tmunu;         // set Tmunu in the ConToPrim kernel of the previous stage
+  int tmunu_version;        // Mesh::mesh_version when Tmunu was last set by ConToPrim
 };
 
 template<class EOSPolicy, class ErrorPolicy>
@@ -118,9 +134,12 @@ class DynGRMHDPS : public DynGRMHD {
   // Dynamical EOS
   PrimitiveSolverHydro<EOSPolicy, ErrorPolicy> eos;
 
-  // CalculateFluxes function templated over Riemann Solvers
-  template<DynGRMHD_RSolver T>
+  // CalculateFluxes function templated over Riemann Solvers and reconstruction.
+  // Kernel for the chosen combination is selected once from the flux registry.
+  template<DynGRMHD_RSolver T, ReconstructionMethod R>
   TaskStatus CalcFluxes(Driver *d, int stage);
+  using FluxKernel = TaskStatus (DynGRMHDPS::*)(Driver *d, int stage);
+  FluxKernel SelectFluxKernel();
 
   template<DynGRMHD_RSolver T>
   void FOFC(Driver *d, int stage);
@@ -137,6 +156,13 @@ class DynGRMHDPS : public DynGRMHD {
   virtual void AddCoordTerms(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
                              const Real dt, DvceArray5D<Real> &u0, int nghost);
 
+  virtual DvceArray5D<Real> *GetC2PData() {
+    return (eos.c2p_warm_start || eos.c2p_save_iter)? &(eos.c2p_data) : nullptr;
+  }
+  virtual const std::vector<double> *GetC2PCountTotals() {
+    return (eos.c2p_stats)? &(eos.C2PCountTotals()) : nullptr;
+  }
+
   template<int NGHOST>
   void AddCoordTermsEOS(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
                         const Real dt, DvceArray5D<Real> &u0);
@@ -23,6 +23,7 @@
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
 #include "reconstruct/wenoz.hpp"
+#include "reconstruct/flux_registry.hpp"
 #include "dyn_grmhd/rsolvers/llf_dyn_grmhd.hpp"
 #include "dyn_grmhd/rsolvers/hlle_dyn_grmhd.hpp"
 // include PrimitiveSolver stuff
@@ -33,9 +34,12 @@ namespace dyngr {
 //----------------------------------------------------------------------------------------
 //! \fn  void Hydro::CalcFluxes
 //! \brief Calls reconstruction and Riemann solver functions to compute hydro fluxes
-//! Note this function is templated over RS for better performance on GPUs.
+//! Note this function is templated over RS and reconstruction method for better
+//! performance on GPUs: the switch over reconstruction methods is resolved at compile
+//! time.
 
-template<class EOSPolicy, class ErrorPolicy> template <DynGRMHD_RSolver rsolver_method_>
+template<class EOSPolicy, class ErrorPolicy>
+template <DynGRMHD_RSolver rsolver_method_, ReconstructionMethod recon_method_>
 TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int stage) {
   RegionIndcs indcs_ = pmy_pack->pmesh->mb_indcs;
   int is = indcs_.is, ie = indcs_.ie;
@@ -45,25 +49,26 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
 
   int nhyd = pmy_pack->pmhd->nmhd;
   int nvars = pmy_pack->pmhd->nmhd + pmy_pack->pmhd->nscalars;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-  const auto recon_method_ = pmy_pack->pmhd->recon_method;
+  // loop over MBs not entirely excised (all MBs, unless <coord>/skip_excised_blocks)
+  int nmb1 = pmy_pack->pcoord->nmb_unexcised - 1;
+  auto &emb_ = pmy_pack->pcoord->unexcised_mbs;
   auto size_ = pmy_pack->pmb->mb_size;
   auto coord_ = pmy_pack->pcoord->coord_data;
   auto &w0_ = pmy_pack->pmhd->w0;
   auto &b0_ = pmy_pack->pmhd->bcc0;
-  auto &adm = pmy_pack->padm->adm;
   auto &eos_ = pmy_pack->pmhd->peos->eos_data;
   auto &dyn_eos_ = eos;
   auto &use_fofc = pmy_pack->pmhd->use_fofc;
-  bool extrema = false;
-  if (recon_method_ == ReconstructionMethod::ppmx) {
-    extrema = true;
-  }
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
   // Short-circuit the flux calculation if everything is to be fixed.
   if (fixed_evolution) {
     return TaskStatus::complete;
   }
 
+  // metric at faces, shared by the Riemann solvers here and in FOFC
+  SetFaceMetric();
+  auto &fmet_ = face_metric;
+
   //--------------------------------------------------------------------------------------
   // i-direction
 
@@ -89,7 +94,8 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
 
   par_for_outer("dyngrflux_x1",DevExeSpace(), scr_size, scr_level,
       0, nmb1, kl, ku, jl, ju,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+  KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int k, const int j) {
+    const int m = emb_.d_view(ma);
     ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
     ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
     ScrArray2D<Real> bl(member.team_scratch(scr_level), 3, ncells1);
@@ -133,15 +139,15 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     auto &e21 = e21_;
     auto &nhyd_ = nhyd;
     auto nscal_ = nvars - nhyd;
-    auto &adm_ = adm;
+    auto &fmet = fmet_.x1f;
     //int il = is; int iu = ie+1;
     if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
       LLF_DYNGR<IVX>(member, dyn_eos, indcs, size, coord, m, k, j, il, iu,
-                wl, wr, bl, br, bx, nhyd_, nscal_, adm_,
+                wl, wr, bl, br, bx, nhyd_, nscal_, fmet,
                 flx1, e31, e21);
     } else if constexpr (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
       HLLE_DYNGR<IVX>(member, dyn_eos, indcs, size, coord, m, k, j, il, iu,
-                wl, wr, bl, br, bx, nhyd_, nscal_, adm_,
+                wl, wr, bl, br, bx, nhyd_, nscal_, fmet,
                 flx1, e31, e21);
     }
     member.team_barrier();
@@ -182,7 +188,8 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     if (use_fofc) { jl = js-2, ju = je+2; }
 
     par_for_outer("dyngrflux_x2",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+    KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int k) {
+      const int m = emb_.d_view(ma);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -245,15 +252,15 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
         auto &e32  = e32_;
         auto &nhyd_ = nhyd;
         auto nscal_ = nvars - nhyd;
-        auto &adm_ = adm;
+        auto &fmet = fmet_.x2f;
         //int il = is; int iu = ie;
         if (j>(jl)) {
           if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
             LLF_DYNGR<IVY>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, by, nhyd_, nscal_, adm_, flx2, e12, e32);
+                      wl, wr, bl, br, by, nhyd_, nscal_, fmet, flx2, e12, e32);
           } else if constexpr (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
             HLLE_DYNGR<IVY>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, by, nhyd_, nscal_, adm_, flx2, e12, e32);
+                      wl, wr, bl, br, by, nhyd_, nscal_, fmet, flx2, e12, e32);
           }
         }
         member.team_barrier();
@@ -290,7 +297,8 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     if (use_fofc) { kl = ks-2, ku = ke+2; }
 
     par_for_outer("dyngrflux_x3",DevExeSpace(), scr_size, scr_level, 0, nmb1, js-1, je+1,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int j) {
+    KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int j) {
+      const int m = emb_.d_view(ma);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -351,17 +359,17 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
         auto &bz   = bz_;
         auto &e23  = e23_;
         auto &e13  = e13_;
-        auto &adm_ = adm;
+        auto &fmet = fmet_.x3f;
         auto &nhyd_ = nhyd;
         auto nscal_ = nvars - nhyd;
         //int il = is; int iu = ie;
         if (k>(kl)) {
           if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
             LLF_DYNGR<IVZ>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, bz, nhyd_, nscal_, adm_, flx3, e23, e13);
+                      wl, wr, bl, br, bz, nhyd_, nscal_, fmet, flx3, e23, e13);
           } else if constexpr (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
             HLLE_DYNGR<IVZ>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, bz, nhyd_, nscal_, adm_, flx3, e23, e13);
+                      wl, wr, bl, br, bz, nhyd_, nscal_, fmet, flx3, e23, e13);
           }
         }
         member.team_barrier();
@@ -391,18 +399,44 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
   return TaskStatus::complete;
 }
 
-// function definitions for each template parameter
-// Macro for instantiating every flux function for each Riemann solver
+//----------------------------------------------------------------------------------------
+//! \fn DynGRMHDPS::FluxKernel DynGRMHDPS::SelectFluxKernel
+//! \brief Returns the CalcFluxes task for the Riemann solver and reconstruction method
+//! of this DynGRMHD, or nullptr if that combination was not compiled.  Expanding this
+//! table also instantiates every kernel that is compiled.
+
+#define DYNGR_FLUX_KERNEL(RS, RC)                                       \
+  if (rsolver_method == RS && recon_method == RC) {                     \
+    return &DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes<RS, RC>;     \
+  }
+
+template<class EOSPolicy, class ErrorPolicy>
+typename DynGRMHDPS<EOSPolicy, ErrorPolicy>::FluxKernel
+DynGRMHDPS<EOSPolicy, ErrorPolicy>::SelectFluxKernel() {
+  const auto recon_method = pmy_pack->pmhd->recon_method;
+#if DYNGR_RSOLVER_LLF_ENABLED
+  FLUX_FOR_EACH_RECON(DYNGR_FLUX_KERNEL, DynGRMHD_RSolver::llf_dyngr)
+#endif
+#if DYNGR_RSOLVER_HLLE_ENABLED
+  FLUX_FOR_EACH_RECON(DYNGR_FLUX_KERNEL, DynGRMHD_RSolver::hlle_dyngr)
+#endif
+  return nullptr;
+}
+
+// Macro for instantiating the flux kernel table (and so every flux kernel)
 #define INSTANTIATE_CALC_FLUXES(EOSPolicy, ErrorPolicy) \
 template \
-TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::\
-            CalcFluxes<DynGRMHD_RSolver::llf_dyngr>(Driver *pdriver, int stage); \
-template \
-TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::\
-            CalcFluxes<DynGRMHD_RSolver::hlle_dyngr>(Driver *pdriver, int stage);
+DynGRMHDPS<EOSPolicy, ErrorPolicy>::FluxKernel \
+DynGRMHDPS<EOSPolicy, ErrorPolicy>::SelectFluxKernel();
 
+#if DYNGR_EOS_IDEAL_ENABLED
 INSTANTIATE_CALC_FLUXES(Primitive::IdealGas, Primitive::ResetFloor)
+#endif
+#if DYNGR_EOS_PIECEWISE_POLY_ENABLED
 INSTANTIATE_CALC_FLUXES(Primitive::PiecewisePolytrope, Primitive::ResetFloor)
+#endif
+#if DYNGR_EOS_COMPOSE_ENABLED
 INSTANTIATE_CALC_FLUXES(Primitive::EOSCompOSE, Primitive::ResetFloor)
+#endif
 
 } // namespace dyngr
@@ -155,9 +155,15 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
   auto &eos_ = eos;
   auto &use_excise_ = pmy_pack->pcoord->coord_data.bh_excise;
   auto &excision_flux_ = pmy_pack->pcoord->excision_flux;
+  // MBs entirely excised are not evolved, so need no first-order fluxes
+  int nmb_flx = pmy_pack->pcoord->nmb_unexcised;
+  auto &emb_ = pmy_pack->pcoord->unexcised_mbs;
   auto &w0_ = pmy_pack->pmhd->w0;
   auto &b0_ = pmy_pack->pmhd->b0;
-  auto &adm = pmy_pack->padm->adm;
+  // metric at faces, as set by CalcFluxes() in this stage
+  auto &fmet1 = face_metric.x1f;
+  auto &fmet2 = face_metric.x2f;
+  auto &fmet3 = face_metric.x3f;
 
   // Index bounds
   int il = is-1, iu = ie+1, jl = js, ju = je, kl = ks, ku = ke;
@@ -166,8 +172,9 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
 
   // Replace fluxes with first-order LLF fluxes at i,j,k faces for any cell where FOFC
   // and/or excision is used (if GR+excising)
-  par_for("FOFC-flx", DevExeSpace(), 0, nmb-1, kl, ku, jl, ju, il, iu,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  par_for("FOFC-flx", DevExeSpace(), 0, nmb_flx-1, kl, ku, jl, ju, il, iu,
+  KOKKOS_LAMBDA(const int ma, const int k, const int j, const int i) {
+    const int m = emb_.d_view(ma);
     // Check for FOFC flag
     bool fofc_flag = false;
     if (use_fofc_) { fofc_flag = fofc_(m,k,j,i); }
@@ -189,7 +196,7 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
 
       // Compute the metric terms at i-1/2
       Real g3d[NSPMETRIC], beta_u[3], alpha;
-      adm::Face1Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      adm::LoadFaceMetric(m, k, j, i, fmet1, g3d, beta_u, alpha);
 
       // compute new 1st-order LLF flux at i-face
       Real flux[NCONS], bflux[NMAG];
@@ -226,7 +233,7 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
         blj[IBY] = brj[IBY] = b0_.x2f(m, k, j, i);
 
         // Compute the metric terms at j-1/2
-        adm::Face2Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+        adm::LoadFaceMetric(m, k, j, i, fmet2, g3d, beta_u, alpha);
 
         // Compute new 1st-order LLF flux at j-face
         if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
@@ -263,7 +270,7 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
         bmk[IBZ] = bpk[IBZ] = b0_.x3f(m, k, j, i);
 
         // Compute the metric terms at k-1/2
-        adm::Face3Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+        adm::LoadFaceMetric(m, k, j, i, fmet3, g3d, beta_u, alpha);
 
         // Compute new 1st-order LLF flux at k-face
         if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
@@ -293,8 +300,9 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
 
   // Replace fluxes with first-order LLF fluxes at i+1,j+1,k+1 faces for any cell where
   // FOFC and/or excision is used (if GR+excising)
-  par_for("FOFC-flx", DevExeSpace(), 0, nmb-1, kl, ku, jl, ju, il, iu,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  par_for("FOFC-flx", DevExeSpace(), 0, nmb_flx-1, kl, ku, jl, ju, il, iu,
+  KOKKOS_LAMBDA(const int ma, const int k, const int j, const int i) {
+    const int m = emb_.d_view(ma);
     // Check for FOFC flag
     bool fofc_flag = false;
     if (use_fofc_) { fofc_flag = fofc_(m,k,j,i); }
@@ -316,7 +324,7 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
 
       // Compute the metric terms at i+1/2
       Real g3d[NSPMETRIC], beta_u[3], alpha;
-      adm::Face1Metric(m, k, j, i+1, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      adm::LoadFaceMetric(m, k, j, i+1, fmet1, g3d, beta_u, alpha);
 
       // compute new 1st-order LLF flux at (i+1)-face
       Real flux[NCONS], bflux[NMAG];
@@ -353,8 +361,7 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
         blj[IBY] = brj[IBY] = b0_.x2f(m, k, j+1, i);
 
         // Compute the metric terms at j+1/2
-        adm::Face2Metric(m, k, j+1, i, adm.g_dd, adm.beta_u, adm.alpha,
-                         g3d, beta_u, alpha);
+        adm::LoadFaceMetric(m, k, j+1, i, fmet2, g3d, beta_u, alpha);
 
         // Compute new 1st-order LLF flux at j-face
         if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
@@ -391,8 +398,7 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
         bmk[IBZ] = bpk[IBZ] = b0_.x3f(m, k+1, j, i);
 
         // Compute the metric terms at k+1/2
-        adm::Face3Metric(m, k+1, j, i, adm.g_dd, adm.beta_u, adm.alpha,
-                         g3d, beta_u, alpha);
+        adm::LoadFaceMetric(m, k+1, j, i, fmet3, g3d, beta_u, alpha);
 
         // Compute new 1st-order LLF flux at k-face
         if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
@@ -423,23 +429,41 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
 
   // reset FOFC flag (do not reset excision flag)
   if (use_fofc_) {
-    Kokkos::deep_copy(fofc_, false);
+    Kokkos::deep_copy(TaskExecSpace(), fofc_, false);
   }
 
   return;
 }
 
-// function definitions for each template parameter
-#define INSTANTIATE_FOFC(EOSPolicy, ErrorPolicy) \
+// function definitions for each template parameter compiled
+#if DYNGR_RSOLVER_LLF_ENABLED
+#define INSTANTIATE_FOFC_LLF(EOSPolicy, ErrorPolicy) \
 template \
 void DynGRMHDPS<EOSPolicy, ErrorPolicy>::\
-  FOFC<DynGRMHD_RSolver::llf_dyngr>(Driver *pdriver, int stage);\
+  FOFC<DynGRMHD_RSolver::llf_dyngr>(Driver *pdriver, int stage);
+#else
+#define INSTANTIATE_FOFC_LLF(EOSPolicy, ErrorPolicy)
+#endif
+#if DYNGR_RSOLVER_HLLE_ENABLED
+#define INSTANTIATE_FOFC_HLLE(EOSPolicy, ErrorPolicy) \
 template \
 void DynGRMHDPS<EOSPolicy, ErrorPolicy>::\
   FOFC<DynGRMHD_RSolver::hlle_dyngr>(Driver *pdriver, int stage);
+#else
+#define INSTANTIATE_FOFC_HLLE(EOSPolicy, ErrorPolicy)
+#endif
+#define INSTANTIATE_FOFC(EOSPolicy, ErrorPolicy) \
+  INSTANTIATE_FOFC_LLF(EOSPolicy, ErrorPolicy) \
+  INSTANTIATE_FOFC_HLLE(EOSPolicy, ErrorPolicy)
 
+#if DYNGR_EOS_IDEAL_ENABLED
 INSTANTIATE_FOFC(Primitive::IdealGas, Primitive::ResetFloor)
+#endif
+#if DYNGR_EOS_PIECEWISE_POLY_ENABLED
 INSTANTIATE_FOFC(Primitive::PiecewisePolytrope, Primitive::ResetFloor)
+#endif
+#if DYNGR_EOS_COMPOSE_ENABLED
 INSTANTIATE_FOFC(Primitive::EOSCompOSE, Primitive::ResetFloor)
+#endif
 
 } // namespace dyngr
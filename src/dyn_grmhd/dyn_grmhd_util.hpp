@@ -44,7 +44,7 @@ void ExtractBField(Real bu_pt[NMAG], const DvceArray5D<Real> bcc,
 }
 
 KOKKOS_INLINE_FUNCTION
-void InsertFluxes(const Real flux_pt[NCONS], const DvceArray5D<Real>& flx,
+void InsertFluxes(const Real flux_pt[NCONS], const DvceArray5D<FluxReal>& flx,
                   const int m, const int k, const int j, const int i) {
   flx(m, IDN, k, j, i) = flux_pt[CDN];
   flx(m, IM1, k, j, i) = flux_pt[CSX];
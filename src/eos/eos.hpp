@@ -203,6 +203,14 @@ class EquationOfState {
   MeshBlockPack* pmy_pack;
   EOS_Data eos_data;
 
+  // with <hydro>/fused_newdt (or <mhd>), ConsToPrim also reduces the signal-crossing
+  // times in each direction over the active cells into newdt when newdt_in_c2p is set,
+  // and then sets newdt_done.  Only implemented by the nonrelativistic EOS.
+  bool newdt_in_c2p = false;
+  bool newdt_kinematic = false;  // signal speeds are |v| (kinematic time evolution)
+  bool newdt_done = false;
+  Real newdt[3];
+
   // virtual functions to convert cons to prim in either Hydro or MHD (depending on
   // arguments), overwritten in derived eos classes
   virtual void ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
@@ -379,6 +387,13 @@ class IdealGRMHD : public EquationOfState {
   using EquationOfState::PrimToCons;
 
   IdealGRMHD(MeshBlockPack *pp, ParameterInput *pin);
+
+  // batched C2P: lock-step pass over all cells, then a second pass over unconverged cells
+  bool c2p_batched;
+  int c2p_lockstep_iter;              // iteration budget of first (lock-step) pass
+  DvceArray1D<int> c2p_worklist;      // indices of cells deferred to second pass
+  DvceArray1D<int> c2p_nwork;         // number of cells in worklist
+
   void ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
                   DvceArray5D<Real> &prim, DvceArray5D<Real> &bcc,
                   const bool only_testfloors,
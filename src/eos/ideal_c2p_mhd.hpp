@@ -122,13 +122,15 @@ Real Equation44(const Real mu, const Real b2, const Real rpar, const Real r, con
 //! \brief Converts single state of conserved variables into primitive variables for
 //! special relativistic MHD with an ideal gas EOS. Note input CONSERVED state contains
 //! cell-centered magnetic fields, but PRIMITIVE state returned via arguments does not.
+//! Each root find is limited to max_iterations; a smaller budget can be passed when
+//! unconverged cells will be retried (see IdealGRMHD::ConsToPrim).
 
 KOKKOS_INLINE_FUNCTION
 void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, Real rpar,
                           HydPrim1D &w, bool &dfloor_used, bool &efloor_used,
-                          bool &c2p_failure, int &max_iter) {
+                          bool &c2p_failure, int &max_iter,
+                          const int max_iterations = 25) {
   // Parameters
-  const int max_iterations = 25;
   const Real tol = 1.0e-12;
   const Real gm1 = eos.gamma - 1.0;
 
@@ -46,11 +46,14 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   auto &size = pmy_pack->pmb->mb_size;
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
-  int &nmb = pmy_pack->nmb_thispack;
+  // only convert in active MBs (all MBs unless <hydro>/sparse_blocks is enabled)
+  int nmb = pmy_pack->phydro->ActiveMeshBlocks();
+  auto &amb = pmy_pack->phydro->active_mbs;
   auto &fofc_ = pmy_pack->phydro->fofc;
   auto eos = eos_data;
   Real gm1 = eos_data.gamma - 1.0;
 
+  auto &coord = pmy_pack->pcoord->coord_data;
   auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
   auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
   auto &use_excise = pmy_pack->pcoord->coord_data.bh_excise;
@@ -65,12 +68,14 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   const int nmkji = nmb*nkji;
 
   int nfloord_=0, nfloore_=0, nceilv_=0, nfail_=0, maxit_=0;
-  Kokkos::parallel_reduce("grhyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  auto &evc = pmy_pack->pmesh->ecounter.mb;
+  Kokkos::parallel_reduce("grhyd_c2p",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
   KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumv, int &sumf, int &max_it) {
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/ni;
-    int i = (idx - m*nkji - k*nji - j*ni) + il;
+    int ma = (idx)/nkji;
+    int k = (idx - ma*nkji)/nji;
+    int j = (idx - ma*nkji - k*nji)/ni;
+    int i = (idx - ma*nkji - k*nji - j*ni) + il;
+    int m = amb.d_view(ma);
     j += jl;
     k += kl;
 
@@ -96,7 +101,11 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (coord.metric_cached) {
+      LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     HydPrim1D w;
     bool dfloor_used=false, efloor_used=false;
@@ -153,13 +162,29 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
       if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
         fofc_(m,k,j,i) = true;
         sumd++;  // use dfloor as counter for when either is true
+        Kokkos::atomic_add(&evc(m,EVC_FOFC), 1);
       }
     } else {
-      if (dfloor_used) {sumd++;}
-      if (efloor_used) {sume++;}
-      if (vceiling_used) {sumv++;}
-      if (c2p_failure) {sumf++;}
+      if (dfloor_used) {
+        sumd++;
+        Kokkos::atomic_add(&evc(m,EVC_DFLOOR), 1);
+      }
+      if (efloor_used) {
+        sume++;
+        Kokkos::atomic_add(&evc(m,EVC_EFLOOR), 1);
+      }
+      if (vceiling_used) {
+        sumv++;
+        Kokkos::atomic_add(&evc(m,EVC_VCEIL), 1);
+      }
+      if (c2p_failure) {
+        sumf++;
+        Kokkos::atomic_add(&evc(m,EVC_FAIL), 1);
+      }
       max_it = (iter_used > max_it) ? iter_used : max_it;
+      if (iter_used > evc(m,EVC_MAXIT)) {
+        Kokkos::atomic_max(&evc(m,EVC_MAXIT), iter_used);
+      }
 
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
@@ -211,6 +236,7 @@ void IdealGRHydro::PrimToCons(const DvceArray5D<Real> &prim, DvceArray5D<Real> &
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &js = indcs.js, &ks = indcs.ks;
   auto &size = pmy_pack->pmb->mb_size;
+  auto &coord = pmy_pack->pcoord->coord_data;
   auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
   auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
   int &nhyd  = pmy_pack->phydro->nhydro;
@@ -234,7 +260,11 @@ void IdealGRHydro::PrimToCons(const DvceArray5D<Real> &prim, DvceArray5D<Real> &
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (coord.metric_cached) {
+      LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     // Load single state of primitive variables
     HydPrim1D w;
@@ -8,6 +8,9 @@
 
 #include <float.h>
 
+#include <cstdlib>
+#include <iostream>
+
 #include "athena.hpp"
 #include "mhd/mhd.hpp"
 #include "eos.hpp"
@@ -21,19 +24,34 @@
 // ctor: also calls EOS base class constructor
 
 IdealGRMHD::IdealGRMHD(MeshBlockPack *pp, ParameterInput *pin) :
-    EquationOfState("mhd", pp, pin) {
+    EquationOfState("mhd", pp, pin),
+    c2p_worklist("c2p_worklist",1),
+    c2p_nwork("c2p_nwork",1) {
   eos_data.is_ideal = true;
   eos_data.gamma = pin->GetReal("mhd","gamma");
   eos_data.iso_cs = 0.0;
   eos_data.use_e = true;  // ideal gas EOS always uses internal energy
   eos_data.use_t = false;
   eos_data.gamma_max = pin->GetOrAddReal("mhd","gamma_max",(FLT_MAX));  // gamma ceiling
+
+  // batched C2P (keeps GPU warps converged when iteration counts vary between cells)
+  c2p_batched = pin->GetOrAddBoolean("mhd","c2p_batched",false);
+  c2p_lockstep_iter = pin->GetOrAddInteger("mhd","c2p_lockstep_iter",8);
+  if (c2p_lockstep_iter < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<mhd>/c2p_lockstep_iter must be at least 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void ConsToPrim()
 //! \brief Converts conserved into primitive variables.
 //! Operates over range of cells given in argument list.
+//! With <mhd>/c2p_batched=true the inversion is done in two passes.  The first does at
+//! most c2p_lockstep_iter iterations in every cell, so threads in a warp finish together,
+//! and appends the cells that have not converged to a worklist.  The second pass redoes
+//! the inversion of only these cells with the full iteration budget.
 
 void IdealGRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
                             DvceArray5D<Real> &prim, DvceArray5D<Real> &bcc,
@@ -50,6 +68,7 @@ void IdealGRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &
   auto eos = eos_data;
   Real gm1 = eos_data.gamma - 1.0;
 
+  auto &coord = pmy_pack->pcoord->coord_data;
   auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
   auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
   auto &use_excise = pmy_pack->pcoord->coord_data.bh_excise;
@@ -63,157 +82,216 @@ void IdealGRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &
   const int nkji = (ku - kl + 1)*nji;
   const int nmkji = nmb*nkji;
 
-  int nfloord_=0, nfloore_=0, nceilv_=0, nfail_=0, maxit_=0;
-  Kokkos::parallel_reduce("grmhd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumv, int &sumf, int &max_it) {
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/ni;
-    int i = (idx - m*nkji - k*nji - j*ni) + il;
-    j += jl;
-    k += kl;
-
-    // load single state conserved variables
-    MHDCons1D u;
-    u.d  = cons(m,IDN,k,j,i);
-    u.mx = cons(m,IM1,k,j,i);
-    u.my = cons(m,IM2,k,j,i);
-    u.mz = cons(m,IM3,k,j,i);
-    u.e  = cons(m,IEN,k,j,i);
-
-    // load cell-centered fields into conserved state
-    // use input CC fields if only testing floors with FOFC
-    if (only_testfloors) {
-      u.bx = bcc(m,IBX,k,j,i);
-      u.by = bcc(m,IBY,k,j,i);
-      u.bz = bcc(m,IBZ,k,j,i);
-    // else use simple linear average of face-centered fields
-    } else {
-      u.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
-      u.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
-      u.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
+  int npass = 1;
+  if (c2p_batched) {
+    npass = 2;
+    if (c2p_worklist.extent_int(0) < nmkji) {
+      Kokkos::realloc(c2p_worklist, nmkji);
     }
+    Kokkos::deep_copy(TaskExecSpace(), c2p_nwork, 0);
+  }
+  auto &worklist_ = c2p_worklist;
+  auto &nwork_ = c2p_nwork;
+
+  int nfloord_=0, nfloore_=0, nceilv_=0, nfail_=0, maxit_=0, ndefer_=0;
+  int ncells = nmkji;
+  for (int pass=0; pass<npass; ++pass) {
+    // first pass of batched C2P defers unconverged cells, any other pass must finish them
+    const bool defer = (pass < npass-1);
+    const int maxit = (defer)? c2p_lockstep_iter : 25;
+    int nd=0, ne=0, nv=0, nf=0, mi=0, nw=0;
+    auto &evc = pmy_pack->pmesh->ecounter.mb;
+    Kokkos::parallel_reduce("grmhd_c2p",Kokkos::RangePolicy<>(TaskExecSpace(), 0, ncells),
+    KOKKOS_LAMBDA(const int &iw, int &sumd, int &sume, int &sumv, int &sumf, int &max_it,
+                  int &sumw) {
+      const int idx = (pass == 0)? iw : worklist_(iw);
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/ni;
+      int i = (idx - m*nkji - k*nji - j*ni) + il;
+      j += jl;
+      k += kl;
+
+      // load single state conserved variables
+      MHDCons1D u;
+      u.d  = cons(m,IDN,k,j,i);
+      u.mx = cons(m,IM1,k,j,i);
+      u.my = cons(m,IM2,k,j,i);
+      u.mz = cons(m,IM3,k,j,i);
+      u.e  = cons(m,IEN,k,j,i);
+
+      // load cell-centered fields into conserved state
+      // use input CC fields if only testing floors with FOFC
+      if (only_testfloors) {
+        u.bx = bcc(m,IBX,k,j,i);
+        u.by = bcc(m,IBY,k,j,i);
+        u.bz = bcc(m,IBZ,k,j,i);
+      // else use simple linear average of face-centered fields
+      } else {
+        u.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
+        u.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
+        u.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
+      }
 
-    // Extract components of metric
-    Real &x1min = size.d_view(m).x1min;
-    Real &x1max = size.d_view(m).x1max;
-    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+      // Extract components of metric
+      Real &x1min = size.d_view(m).x1min;
+      Real &x1max = size.d_view(m).x1max;
+      Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
 
-    Real &x2min = size.d_view(m).x2min;
-    Real &x2max = size.d_view(m).x2max;
-    Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+      Real &x2min = size.d_view(m).x2min;
+      Real &x2max = size.d_view(m).x2max;
+      Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
 
-    Real &x3min = size.d_view(m).x3min;
-    Real &x3max = size.d_view(m).x3max;
-    Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+      Real &x3min = size.d_view(m).x3min;
+      Real &x3max = size.d_view(m).x3max;
+      Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
-    Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
-
-    HydPrim1D w;
-    bool dfloor_used=false, efloor_used=false;
-    bool vceiling_used=false, c2p_failure=false;
-    int iter_used=0;
-
-    // Only execute cons2prim if outside excised region
-    bool excised = false;
-    if (use_excise) {
-      if (excision_floor_(m,k,j,i)) {
-        w.d = dexcise_;
-        w.vx = 0.0;
-        w.vy = 0.0;
-        w.vz = 0.0;
-        w.e = pexcise_/gm1;
-        excised = true;
+      Real glower[4][4], gupper[4][4];
+      if (coord.metric_cached) {
+        LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+      } else {
+        ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
       }
-      if (only_testfloors) {
-        if (excision_flux_(m,k,j,i)) {
+
+      HydPrim1D w;
+      bool dfloor_used=false, efloor_used=false;
+      bool vceiling_used=false, c2p_failure=false;
+      int iter_used=0;
+
+      // Only execute cons2prim if outside excised region
+      bool excised = false;
+      if (use_excise) {
+        if (excision_floor_(m,k,j,i)) {
+          w.d = dexcise_;
+          w.vx = 0.0;
+          w.vy = 0.0;
+          w.vz = 0.0;
+          w.e = pexcise_/gm1;
           excised = true;
         }
+        if (only_testfloors) {
+          if (excision_flux_(m,k,j,i)) {
+            excised = true;
+          }
+        }
       }
-    }
 
-    if (!(excised)) {
-      // calculate SR conserved quantities
-      MHDCons1D u_sr;
-      Real s2, b2, rpar;
-      TransformToSRMHD(u,glower,gupper,s2,b2,rpar,u_sr);
-
-      // call c2p function
-      // (inline function in ideal_c2p_mhd.hpp file)
-      SingleC2P_IdealSRMHD(u_sr, eos, s2, b2, rpar, w,
-                           dfloor_used, efloor_used, c2p_failure, iter_used);
-
-      // apply velocity ceiling if necessary
-      Real tmp = glower[1][1]*SQR(w.vx)
-               + glower[2][2]*SQR(w.vy)
-               + glower[3][3]*SQR(w.vz)
-               + 2.0*glower[1][2]*w.vx*w.vy + 2.0*glower[1][3]*w.vx*w.vz
-               + 2.0*glower[2][3]*w.vy*w.vz;
-      Real lor = sqrt(1.0+tmp);
-      if (lor > eos.gamma_max) {
-        vceiling_used = true;
-        Real factor = sqrt((SQR(eos.gamma_max)-1.0)/(SQR(lor)-1.0));
-        w.vx *= factor;
-        w.vy *= factor;
-        w.vz *= factor;
-      }
-    }
+      if (!(excised)) {
+        // calculate SR conserved quantities
+        MHDCons1D u_sr;
+        Real s2, b2, rpar;
+        TransformToSRMHD(u,glower,gupper,s2,b2,rpar,u_sr);
+
+        // call c2p function
+        // (inline function in ideal_c2p_mhd.hpp file)
+        SingleC2P_IdealSRMHD(u_sr, eos, s2, b2, rpar, w,
+                             dfloor_used, efloor_used, c2p_failure, iter_used, maxit);
+
+        // defer unconverged cells to next pass; cons are untouched so it starts afresh
+        if (defer && c2p_failure) {
+          worklist_(Kokkos::atomic_fetch_add(&nwork_(0), 1)) = idx;
+          sumw++;
+          Kokkos::atomic_add(&evc(m,EVC_C2P_WORK), 1);
+          return;
+        }
 
-    // set FOFC flag and quit loop if this function called only to check floors
-    if (only_testfloors) {
-      if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
-        fofc_(m,k,j,i) = true;
-        sumd++;  // use dfloor as counter for when either is true
-      }
-    } else {
-      if (dfloor_used) {sumd++;}
-      if (efloor_used) {sume++;}
-      if (vceiling_used) {sumv++;}
-      if (c2p_failure) {sumf++;}
-      max_it = (iter_used > max_it) ? iter_used : max_it;
-
-      // store primitive state in 3D array
-      prim(m,IDN,k,j,i) = w.d;
-      prim(m,IVX,k,j,i) = w.vx;
-      prim(m,IVY,k,j,i) = w.vy;
-      prim(m,IVZ,k,j,i) = w.vz;
-      prim(m,IEN,k,j,i) = w.e;
-
-      // store cell-centered fields in 3D array
-      bcc(m,IBX,k,j,i) = u.bx;
-      bcc(m,IBY,k,j,i) = u.by;
-      bcc(m,IBZ,k,j,i) = u.bz;
-
-      // reset conserved variables if floor, ceiling, failure, or excision encountered
-      if (dfloor_used || efloor_used || vceiling_used || c2p_failure || excised) {
-        MHDPrim1D w_in;
-        w_in.d  = w.d;
-        w_in.vx = w.vx;
-        w_in.vy = w.vy;
-        w_in.vz = w.vz;
-        w_in.e  = w.e;
-        w_in.bx = u.bx;
-        w_in.by = u.by;
-        w_in.bz = u.bz;
-
-        HydCons1D u_out;
-        SingleP2C_IdealGRMHD(glower, gupper, w_in, eos.gamma, u_out);
-        cons(m,IDN,k,j,i) = u_out.d;
-        cons(m,IM1,k,j,i) = u_out.mx;
-        cons(m,IM2,k,j,i) = u_out.my;
-        cons(m,IM3,k,j,i) = u_out.mz;
-        cons(m,IEN,k,j,i) = u_out.e;
-        u.d = u_out.d;  // (needed if there are scalars below)
+        // apply velocity ceiling if necessary
+        Real tmp = glower[1][1]*SQR(w.vx)
+                 + glower[2][2]*SQR(w.vy)
+                 + glower[3][3]*SQR(w.vz)
+                 + 2.0*glower[1][2]*w.vx*w.vy + 2.0*glower[1][3]*w.vx*w.vz
+                 + 2.0*glower[2][3]*w.vy*w.vz;
+        Real lor = sqrt(1.0+tmp);
+        if (lor > eos.gamma_max) {
+          vceiling_used = true;
+          Real factor = sqrt((SQR(eos.gamma_max)-1.0)/(SQR(lor)-1.0));
+          w.vx *= factor;
+          w.vy *= factor;
+          w.vz *= factor;
+        }
       }
 
-      // convert scalars (if any)
-      for (int n=nmhd; n<(nmhd+nscal); ++n) {
-        prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+      // set FOFC flag and quit loop if this function called only to check floors
+      if (only_testfloors) {
+        if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
+          fofc_(m,k,j,i) = true;
+          sumd++;  // use dfloor as counter for when either is true
+          Kokkos::atomic_add(&evc(m,EVC_FOFC), 1);
+        }
+      } else {
+        if (dfloor_used) {
+          sumd++;
+          Kokkos::atomic_add(&evc(m,EVC_DFLOOR), 1);
+        }
+        if (efloor_used) {
+          sume++;
+          Kokkos::atomic_add(&evc(m,EVC_EFLOOR), 1);
+        }
+        if (vceiling_used) {
+          sumv++;
+          Kokkos::atomic_add(&evc(m,EVC_VCEIL), 1);
+        }
+        if (c2p_failure) {
+          sumf++;
+          Kokkos::atomic_add(&evc(m,EVC_FAIL), 1);
+        }
+        max_it = (iter_used > max_it) ? iter_used : max_it;
+        if (iter_used > evc(m,EVC_MAXIT)) {
+          Kokkos::atomic_max(&evc(m,EVC_MAXIT), iter_used);
+        }
+
+        // store primitive state in 3D array
+        prim(m,IDN,k,j,i) = w.d;
+        prim(m,IVX,k,j,i) = w.vx;
+        prim(m,IVY,k,j,i) = w.vy;
+        prim(m,IVZ,k,j,i) = w.vz;
+        prim(m,IEN,k,j,i) = w.e;
+
+        // store cell-centered fields in 3D array
+        bcc(m,IBX,k,j,i) = u.bx;
+        bcc(m,IBY,k,j,i) = u.by;
+        bcc(m,IBZ,k,j,i) = u.bz;
+
+        // reset conserved variables if floor, ceiling, failure, or excision encountered
+        if (dfloor_used || efloor_used || vceiling_used || c2p_failure || excised) {
+          MHDPrim1D w_in;
+          w_in.d  = w.d;
+          w_in.vx = w.vx;
+          w_in.vy = w.vy;
+          w_in.vz = w.vz;
+          w_in.e  = w.e;
+          w_in.bx = u.bx;
+          w_in.by = u.by;
+          w_in.bz = u.bz;
+
+          HydCons1D u_out;
+          SingleP2C_IdealGRMHD(glower, gupper, w_in, eos.gamma, u_out);
+          cons(m,IDN,k,j,i) = u_out.d;
+          cons(m,IM1,k,j,i) = u_out.mx;
+          cons(m,IM2,k,j,i) = u_out.my;
+          cons(m,IM3,k,j,i) = u_out.mz;
+          cons(m,IEN,k,j,i) = u_out.e;
+          u.d = u_out.d;  // (needed if there are scalars below)
+        }
+
+        // convert scalars (if any)
+        for (int n=nmhd; n<(nmhd+nscal); ++n) {
+          prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+        }
       }
+    }, Kokkos::Sum<int>(nd), Kokkos::Sum<int>(ne), Kokkos::Sum<int>(nv),
+       Kokkos::Sum<int>(nf), Kokkos::Max<int>(mi), Kokkos::Sum<int>(nw));
+    nfloord_ += nd;
+    nfloore_ += ne;
+    nceilv_  += nv;
+    nfail_   += nf;
+    maxit_ = (mi > maxit_)? mi : maxit_;
+    if (defer) {
+      ndefer_ = nw;
+      ncells = nw;
+      if (ncells == 0) break;
     }
-  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nceilv_),
-     Kokkos::Sum<int>(nfail_), Kokkos::Max<int>(maxit_));
+  }
 
   // store appropriate counters
   if (only_testfloors) {
@@ -224,6 +302,7 @@ void IdealGRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &
     pmy_pack->pmesh->ecounter.neos_vceil  += nceilv_;
     pmy_pack->pmesh->ecounter.neos_fail   += nfail_;
     pmy_pack->pmesh->ecounter.maxit_c2p = maxit_;
+    pmy_pack->pmesh->ecounter.nc2p_work += ndefer_;
   }
 
   return;
@@ -240,6 +319,7 @@ void IdealGRMHD::PrimToCons(const DvceArray5D<Real> &prim, const DvceArray5D<Rea
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &js = indcs.js, &ks = indcs.ks;
   auto &size = pmy_pack->pmb->mb_size;
+  auto &coord = pmy_pack->pcoord->coord_data;
   auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
   auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
   int &nmhd  = pmy_pack->pmhd->nmhd;
@@ -263,7 +343,11 @@ void IdealGRMHD::PrimToCons(const DvceArray5D<Real> &prim, const DvceArray5D<Rea
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    if (coord.metric_cached) {
+      LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    }
 
     // Load single state of primitive variables
     MHDPrim1D w;
@@ -6,10 +6,13 @@
 //! \file ideal_hyd.cpp
 //! \brief derived class that implements ideal gas EOS in nonrelativistic hydro
 
+#include <limits>
+
 #include "athena.hpp"
 #include "hydro/hydro.hpp"
 #include "eos/eos.hpp"
 #include "eos/ideal_c2p_hyd.hpp"
+#include "eos/newdt_c2p.hpp"
 
 //----------------------------------------------------------------------------------------
 // ctor: also calls EOS base class constructor
@@ -34,7 +37,9 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
                             const int kl, const int ku) {
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
-  int &nmb = pmy_pack->nmb_thispack;
+  // only convert in active MBs (all MBs unless <hydro>/sparse_blocks is enabled)
+  int nmb = pmy_pack->phydro->ActiveMeshBlocks();
+  auto &amb = pmy_pack->phydro->active_mbs;
   auto &eos = eos_data;
   auto &fofc_ = pmy_pack->phydro->fofc;
 
@@ -44,12 +49,24 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   const int nmkji = nmb*nkji;
 
   int nfloord_=0, nfloore_=0, nfloort_=0;
-  Kokkos::parallel_reduce("hyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumt) {
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/ni;
-    int i = (idx - m*nkji - k*nji - j*ni) + il;
+  // with fused_newdt, also reduce signal-crossing times over the active cells
+  bool newdt_ = newdt_in_c2p && !(only_testfloors);
+  bool kinematic_ = newdt_kinematic;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  const CoordSystem sys = pmy_pack->pcoord->coord_data.system;
+  Real dt1 = std::numeric_limits<float>::max();
+  Real dt2 = std::numeric_limits<float>::max();
+  Real dt3 = std::numeric_limits<float>::max();
+  auto &evc = pmy_pack->pmesh->ecounter.mb;
+  Kokkos::parallel_reduce("hyd_c2p",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumt,
+                Real &min_dt1, Real &min_dt2, Real &min_dt3) {
+    int ma = (idx)/nkji;
+    int k = (idx - ma*nkji)/nji;
+    int j = (idx - ma*nkji - k*nji)/ni;
+    int i = (idx - ma*nkji - k*nji - j*ni) + il;
+    int m = amb.d_view(ma);
     j += jl;
     k += kl;
 
@@ -72,20 +89,24 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
       if (dfloor_used || efloor_used || tfloor_used) {
         fofc_(m,k,j,i) = true;
         sumd++;  // use dfloor as counter for when either is true
+        Kokkos::atomic_add(&evc(m,EVC_FOFC), 1);
       }
     } else {
       // update counter, reset conserved if floor was hit
       if (dfloor_used) {
         cons(m,IDN,k,j,i) = u.d;
         sumd++;
+        Kokkos::atomic_add(&evc(m,EVC_DFLOOR), 1);
       }
       if (efloor_used) {
         cons(m,IEN,k,j,i) = u.e;
         sume++;
+        Kokkos::atomic_add(&evc(m,EVC_EFLOOR), 1);
       }
       if (tfloor_used) {
         cons(m,IEN,k,j,i) = u.e;
         sumt++;
+        Kokkos::atomic_add(&evc(m,EVC_TFLOOR), 1);
       }
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
@@ -101,8 +122,16 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
         }
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
+      // signal-crossing times (fused_newdt)
+      if (newdt_) {
+        Real cs = (kinematic_)? 0.0 :
+                  eos.IdealHydroSoundSpeed(w.d, eos.IdealGasPressure(w.e));
+        CellNewDt(sys, mbsize.d_view(m), indcs, k, j, i, fabs(w.vx) + cs,
+                  fabs(w.vy) + cs, fabs(w.vz) + cs, min_dt1, min_dt2, min_dt3);
+      }
     }
-  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nfloort_));
+  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nfloort_),
+  Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2), Kokkos::Min<Real>(dt3));
 
   // store appropriate counters
   if (only_testfloors) {
@@ -113,6 +142,14 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
     pmy_pack->pmesh->ecounter.neos_tfloor += nfloort_;
   }
 
+  // store timestep for NewTimeStep()
+  if (newdt_) {
+    newdt[0] = dt1;
+    newdt[1] = dt2;
+    newdt[2] = dt3;
+    newdt_done = true;
+  }
+
   return;
 }
 
@@ -6,10 +6,13 @@
 //! \file ideal_mhd.cpp
 //! \brief derived class that implements ideal gas EOS in nonrelativistic mhd
 
+#include <limits>
+
 #include "athena.hpp"
 #include "mhd/mhd.hpp"
 #include "eos.hpp"
 #include "eos/ideal_c2p_mhd.hpp"
+#include "eos/newdt_c2p.hpp"
 
 //----------------------------------------------------------------------------------------
 // ctor: also calls EOS base class constructor
@@ -45,8 +48,19 @@ void IdealMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
   const int nmkji = nmb*nkji;
 
   int nfloord_=0, nfloore_=0, nfloort_=0;
-  Kokkos::parallel_reduce("mhd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumt) {
+  // with fused_newdt, also reduce signal-crossing times over the active cells
+  bool newdt_ = newdt_in_c2p && !(only_testfloors);
+  bool kinematic_ = newdt_kinematic;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  const CoordSystem sys = pmy_pack->pcoord->coord_data.system;
+  Real dt1 = std::numeric_limits<float>::max();
+  Real dt2 = std::numeric_limits<float>::max();
+  Real dt3 = std::numeric_limits<float>::max();
+  auto &evc = pmy_pack->pmesh->ecounter.mb;
+  Kokkos::parallel_reduce("mhd_c2p",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumt,
+                Real &min_dt1, Real &min_dt2, Real &min_dt3) {
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
     int j = (idx - m*nkji - k*nji)/ni;
@@ -86,20 +100,24 @@ void IdealMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
       if (dfloor_used || efloor_used || tfloor_used) {
         fofc_(m,k,j,i) = true;
         sumd++;  // use dfloor as counter for when either is true
+        Kokkos::atomic_add(&evc(m,EVC_FOFC), 1);
       }
     } else {
       // update counter, reset conserved if floor was hit
       if (dfloor_used) {
         cons(m,IDN,k,j,i) = u.d;
         sumd++;
+        Kokkos::atomic_add(&evc(m,EVC_DFLOOR), 1);
       }
       if (efloor_used) {
         cons(m,IEN,k,j,i) = u.e;
         sume++;
+        Kokkos::atomic_add(&evc(m,EVC_EFLOOR), 1);
       }
       if (tfloor_used) {
         cons(m,IEN,k,j,i) = u.e;
         sumt++;
+        Kokkos::atomic_add(&evc(m,EVC_TFLOOR), 1);
       }
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
@@ -119,8 +137,21 @@ void IdealMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
         }
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
+      // signal-crossing times (fused_newdt)
+      if (newdt_) {
+        Real cf1 = 0.0, cf2 = 0.0, cf3 = 0.0;
+        if (!(kinematic_)) {
+          Real p = eos.IdealGasPressure(w.e);
+          cf1 = eos.IdealMHDFastSpeed(w.d, p, u.bx, u.by, u.bz);
+          cf2 = eos.IdealMHDFastSpeed(w.d, p, u.by, u.bz, u.bx);
+          cf3 = eos.IdealMHDFastSpeed(w.d, p, u.bz, u.bx, u.by);
+        }
+        CellNewDt(sys, mbsize.d_view(m), indcs, k, j, i, fabs(w.vx) + cf1,
+                  fabs(w.vy) + cf2, fabs(w.vz) + cf3, min_dt1, min_dt2, min_dt3);
+      }
     }
-  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nfloort_));
+  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nfloort_),
+  Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2), Kokkos::Min<Real>(dt3));
 
   // store appropriate counters
   if (only_testfloors) {
@@ -131,6 +162,14 @@ void IdealMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
     pmy_pack->pmesh->ecounter.neos_tfloor += nfloort_;
   }
 
+  // store timestep for NewTimeStep()
+  if (newdt_) {
+    newdt[0] = dt1;
+    newdt[1] = dt2;
+    newdt[2] = dt3;
+    newdt_done = true;
+  }
+
   return;
 }
 
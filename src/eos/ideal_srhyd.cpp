@@ -58,7 +58,9 @@ void IdealSRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
                               const int kl, const int ku) {
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
-  int &nmb = pmy_pack->nmb_thispack;
+  // only convert in active MBs (all MBs unless <hydro>/sparse_blocks is enabled)
+  int nmb = pmy_pack->phydro->ActiveMeshBlocks();
+  auto &amb = pmy_pack->phydro->active_mbs;
   auto &fofc_ = pmy_pack->phydro->fofc;
   auto eos = eos_data;
 
@@ -68,12 +70,14 @@ void IdealSRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   const int nmkji = nmb*nkji;
 
   int nfloord_=0, nfloore_=0, nceilv_=0, nfail_=0, maxit_=0;
-  Kokkos::parallel_reduce("srhyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  auto &evc = pmy_pack->pmesh->ecounter.mb;
+  Kokkos::parallel_reduce("srhyd_c2p",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
   KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumv, int &sumf, int &max_it) {
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/ni;
-    int i = (idx - m*nkji - k*nji - j*ni) + il;
+    int ma = (idx)/nkji;
+    int k = (idx - ma*nkji)/nji;
+    int j = (idx - ma*nkji - k*nji)/ni;
+    int i = (idx - ma*nkji - k*nji - j*ni) + il;
+    int m = amb.d_view(ma);
     j += jl;
     k += kl;
 
@@ -111,13 +115,29 @@ void IdealSRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
       if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
         fofc_(m,k,j,i) = true;
         sumd++;  // use dfloor as counter for when either is true
+        Kokkos::atomic_add(&evc(m,EVC_FOFC), 1);
       }
     } else {
-      if (dfloor_used) {sumd++;}
-      if (efloor_used) {sume++;}
-      if (vceiling_used) {sumv++;}
-      if (c2p_failure) {sumf++;}
+      if (dfloor_used) {
+        sumd++;
+        Kokkos::atomic_add(&evc(m,EVC_DFLOOR), 1);
+      }
+      if (efloor_used) {
+        sume++;
+        Kokkos::atomic_add(&evc(m,EVC_EFLOOR), 1);
+      }
+      if (vceiling_used) {
+        sumv++;
+        Kokkos::atomic_add(&evc(m,EVC_VCEIL), 1);
+      }
+      if (c2p_failure) {
+        sumf++;
+        Kokkos::atomic_add(&evc(m,EVC_FAIL), 1);
+      }
       max_it = (iter_used > max_it) ? iter_used : max_it;
+      if (iter_used > evc(m,EVC_MAXIT)) {
+        Kokkos::atomic_max(&evc(m,EVC_MAXIT), iter_used);
+      }
 
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
@@ -6,11 +6,14 @@
 //! \file isothermal_hyd.cpp
 //! \brief derived class that implements isothermal EOS for nonrelativistic hydro
 
+#include <limits>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "hydro/hydro.hpp"
 #include "eos/eos.hpp"
+#include "eos/newdt_c2p.hpp"
 
 //----------------------------------------------------------------------------------------
 // ctor: also calls EOS base class constructor
@@ -71,7 +74,9 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
                                  const int kl, const int ku) {
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
-  int &nmb = pmy_pack->nmb_thispack;
+  // only convert in active MBs (all MBs unless <hydro>/sparse_blocks is enabled)
+  int nmb = pmy_pack->phydro->ActiveMeshBlocks();
+  auto &amb = pmy_pack->phydro->active_mbs;
   auto &fofc_ = pmy_pack->phydro->fofc;
   Real dfloor = eos_data.dfloor;
 
@@ -81,12 +86,24 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
   const int nmkji = nmb*nkji;
 
   int nfloord_=0;
-  Kokkos::parallel_reduce("isohyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd) {
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/ni;
-    int i = (idx - m*nkji - k*nji - j*ni) + il;
+  // with fused_newdt, also reduce signal-crossing times over the active cells
+  bool newdt_ = newdt_in_c2p && !(only_testfloors);
+  bool kinematic_ = newdt_kinematic;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  const CoordSystem sys = pmy_pack->pcoord->coord_data.system;
+  Real dt1 = std::numeric_limits<float>::max();
+  Real dt2 = std::numeric_limits<float>::max();
+  Real dt3 = std::numeric_limits<float>::max();
+  Real iso_cs = eos_data.iso_cs;
+  auto &evc = pmy_pack->pmesh->ecounter.mb;
+  Kokkos::parallel_reduce("isohyd_c2p",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, int &sumd, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
+    int ma = (idx)/nkji;
+    int k = (idx - ma*nkji)/nji;
+    int j = (idx - ma*nkji - k*nji)/ni;
+    int i = (idx - ma*nkji - k*nji - j*ni) + il;
+    int m = amb.d_view(ma);
     j += jl;
     k += kl;
 
@@ -105,6 +122,7 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
     if (dfloor_used) {
       cons(m,IDN,k,j,i) = u.d;
       sumd++;
+      Kokkos::atomic_add(&evc(m,(only_testfloors)? EVC_FOFC : EVC_DFLOOR), 1);
     }
 
     // set FOFC flag and quit loop if this function called only to check floors
@@ -120,8 +138,15 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
       for (int n=nhyd; n<(nhyd+nscal); ++n) {
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
+      // signal-crossing times (fused_newdt)
+      if (newdt_) {
+        Real cs = (kinematic_)? 0.0 : iso_cs;
+        CellNewDt(sys, mbsize.d_view(m), indcs, k, j, i, fabs(w.vx) + cs,
+                  fabs(w.vy) + cs, fabs(w.vz) + cs, min_dt1, min_dt2, min_dt3);
+      }
     }
-  }, Kokkos::Sum<int>(nfloord_));
+  }, Kokkos::Sum<int>(nfloord_),
+  Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2), Kokkos::Min<Real>(dt3));
 
   // store appropriate counters
   if (only_testfloors) {
@@ -130,6 +155,14 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
     pmy_pack->pmesh->ecounter.neos_dfloor += nfloord_;
   }
 
+  // store timestep for NewTimeStep()
+  if (newdt_) {
+    newdt[0] = dt1;
+    newdt[1] = dt2;
+    newdt[2] = dt3;
+    newdt_done = true;
+  }
+
   return;
 }
 
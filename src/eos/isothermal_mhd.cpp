@@ -6,11 +6,14 @@
 //! \file isothermal_mhd.cpp
 //! \brief derived class that implements isothermal EOS for nonrelativistic mhd
 
+#include <limits>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "mhd/mhd.hpp"
 #include "eos.hpp"
+#include "eos/newdt_c2p.hpp"
 
 //----------------------------------------------------------------------------------------
 // ctor: also calls EOS base class constructor
@@ -84,8 +87,19 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
   const int nmkji = nmb*nkji;
 
   int nfloord_=0;
-  Kokkos::parallel_reduce("isomhd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd) {
+  // with fused_newdt, also reduce signal-crossing times over the active cells
+  bool newdt_ = newdt_in_c2p && !(only_testfloors);
+  bool kinematic_ = newdt_kinematic;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  const CoordSystem sys = pmy_pack->pcoord->coord_data.system;
+  Real dt1 = std::numeric_limits<float>::max();
+  Real dt2 = std::numeric_limits<float>::max();
+  Real dt3 = std::numeric_limits<float>::max();
+  auto &eos = eos_data;
+  auto &evc = pmy_pack->pmesh->ecounter.mb;
+  Kokkos::parallel_reduce("isomhd_c2p",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, int &sumd, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
     int j = (idx - m*nkji - k*nji)/ni;
@@ -114,6 +128,7 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
     if (dfloor_used) {
       cons(m,IDN,k,j,i) = u.d;
       sumd++;
+      Kokkos::atomic_add(&evc(m,(only_testfloors)? EVC_FOFC : EVC_DFLOOR), 1);
     }
 
     // set FOFC flag and quit loop if this function called only to check floors
@@ -133,8 +148,20 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
       for (int n=nmhd; n<(nmhd+nscal); ++n) {
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
+      // signal-crossing times (fused_newdt)
+      if (newdt_) {
+        Real cf1 = 0.0, cf2 = 0.0, cf3 = 0.0;
+        if (!(kinematic_)) {
+          cf1 = eos.IdealMHDFastSpeed(w.d, u.bx, u.by, u.bz);
+          cf2 = eos.IdealMHDFastSpeed(w.d, u.by, u.bz, u.bx);
+          cf3 = eos.IdealMHDFastSpeed(w.d, u.bz, u.bx, u.by);
+        }
+        CellNewDt(sys, mbsize.d_view(m), indcs, k, j, i, fabs(w.vx) + cf1,
+                  fabs(w.vy) + cf2, fabs(w.vz) + cf3, min_dt1, min_dt2, min_dt3);
+      }
     }
-  }, Kokkos::Sum<int>(nfloord_));
+  }, Kokkos::Sum<int>(nfloord_),
+  Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2), Kokkos::Min<Real>(dt3));
 
   // store appropriate counters
   if (only_testfloors) {
@@ -143,6 +170,14 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
     pmy_pack->pmesh->ecounter.neos_dfloor += nfloord_;
   }
 
+  // store timestep for NewTimeStep()
+  if (newdt_) {
+    newdt[0] = dt1;
+    newdt[1] = dt2;
+    newdt[2] = dt3;
+    newdt_done = true;
+  }
+
   return;
 }
 
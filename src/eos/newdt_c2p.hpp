@@ -0,0 +1,41 @@
+#ifndef EOS_NEWDT_C2P_HPP_
+#define EOS_NEWDT_C2P_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file newdt_c2p.hpp
+//! \brief inline function used by the nonrelativistic EOS to reduce the new timestep
+//! inside ConsToPrim with <hydro>/fused_newdt or <mhd>/fused_newdt
+
+#include <math.h>
+
+#include "athena.hpp"
+#include "coordinates/coordinates.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "coordinates/curvilinear.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void CellNewDt()
+//! \brief adds the signal-crossing times of active cell (k,j,i) with maximum signal
+//! speeds max_dv1,2,3 to the minima dt1,2,3.  Ghost cells are skipped, so that the result
+//! is the same as that of the NewTimeStep() sweep over the active cells.
+
+KOKKOS_INLINE_FUNCTION
+void CellNewDt(const CoordSystem sys, const RegionSize &size, const RegionIndcs &indcs,
+               const int k, const int j, const int i, const Real max_dv1,
+               const Real max_dv2, const Real max_dv3, Real &dt1, Real &dt2, Real &dt3) {
+  if (i < indcs.is || i > indcs.ie || j < indcs.js || j > indcs.je ||
+      k < indcs.ks || k > indcs.ke) return;
+  Real h2 = 1.0, h3 = 1.0;
+  if (sys != CoordSystem::cartesian) {
+    const MBLocations loc = LoadMBLocations(size, indcs);
+    ScaleFactors(sys, loc.x1v(i), loc.x2v(j), h2, h3);
+  }
+  dt1 = fmin((size.dx1/max_dv1), dt1);
+  dt2 = fmin((h2*size.dx2/max_dv2), dt2);
+  dt3 = fmin((h3*size.dx3/max_dv3), dt3);
+}
+
+#endif // EOS_NEWDT_C2P_HPP_
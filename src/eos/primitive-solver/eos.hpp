@@ -19,6 +19,8 @@
 //    Real Enthalpy(Real n, Real T, Real *Y)
 //    Real MinimumEnthalpy()
 //    Real SoundSpeed(Real n, Real T, Real *Y)
+//    void Thermo(Real n, Real T, Real *Y, Real *P, Real *h, Real *cs)
+//    void PressureEnthalpy(Real n, Real T, Real *Y, Real *P, Real *h)
 //    Real SpecificInternalEnergy(Real n, Real T, Real *Y)
 //    Real MinimumPressure(Real n, Real *Y)
 //    Real MaximumPressure(Real n, Real *Y)
@@ -74,6 +76,8 @@ class EOS : public EOSPolicy, public ErrorPolicy {
   using EOSPolicy::Entropy;
   using EOSPolicy::Enthalpy;
   using EOSPolicy::SoundSpeed;
+  using EOSPolicy::Thermo;
+  using EOSPolicy::PressureEnthalpy;
   using EOSPolicy::SpecificInternalEnergy;
   using EOSPolicy::MinimumEnthalpy;
   using EOSPolicy::MinimumPressure;
@@ -242,6 +246,46 @@ class EOS : public EOSPolicy, public ErrorPolicy {
            eos_units.VelocityConversion(code_units);
   }
 
+  //! \fn void GetThermo(Real n, Real T, Real *Y, Real *P, Real *h, Real *cs)
+  //  \brief Get the pressure, enthalpy per mass, and sound speed from the number
+  //         density, temperature, and particle fractions in a single EOS call.
+  //
+  //  For tabulated EOSs this needs only one table lookup, rather than one for
+  //  each of GetPressure, GetEnthalpy, and GetSoundSpeed.
+  //
+  //  \param[in]  n  The number density
+  //  \param[in]  T  The temperature
+  //  \param[in]  Y  An array of size n_species of the particle fractions.
+  //  \param[out] P  The pressure
+  //  \param[out] h  The enthalpy per mass
+  //  \param[out] cs The sound speed
+  KOKKOS_INLINE_FUNCTION void GetThermo(Real n, Real T, Real *Y, Real *P, Real *h,
+                                        Real *cs) const {
+    Thermo(n, T*code_units.TemperatureConversion(eos_units), Y, P, h, cs);
+    *P = (*P)*eos_units.PressureConversion(code_units);
+    *h = (*h)/mb *
+         (eos_units.EnergyConversion(code_units)/eos_units.MassConversion(code_units));
+    *cs = (*cs)*eos_units.VelocityConversion(code_units);
+  }
+
+  //! \fn void GetPressureEnthalpy(Real n, Real T, Real *Y, Real *P, Real *h)
+  //  \brief Get the pressure and enthalpy per mass from the number density,
+  //         temperature, and particle fractions in a single EOS call, without the
+  //         sound speed.
+  //
+  //  \param[in]  n  The number density
+  //  \param[in]  T  The temperature
+  //  \param[in]  Y  An array of size n_species of the particle fractions.
+  //  \param[out] P  The pressure
+  //  \param[out] h  The enthalpy per mass
+  KOKKOS_INLINE_FUNCTION void GetPressureEnthalpy(Real n, Real T, Real *Y, Real *P,
+                                                  Real *h) const {
+    PressureEnthalpy(n, T*code_units.TemperatureConversion(eos_units), Y, P, h);
+    *P = (*P)*eos_units.PressureConversion(code_units);
+    *h = (*h)/mb *
+         (eos_units.EnergyConversion(code_units)/eos_units.MassConversion(code_units));
+  }
+
   //! \fn Real GetSpecificInternalEnergy(Real n, Real T, Real *Y)
   //  \brief Get the energy per mass from the number density, temperature,
   //         and particle fractions.
@@ -8,188 +8,400 @@
 
 #include <math.h>
 
+#include <sys/stat.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <limits>
 #include <iostream>
 #include <cstddef>
 #include <string>
 
+#include "globals.hpp"
 #include "eos_compose.hpp"
 #include "utils/tr_table.hpp"
 
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
 using namespace Primitive; // NOLINT
 
-void EOSCompOSE::ReadTableFromFile(std::string fname) {
+namespace {
+//! Pre-processed tables are cached in a binary file holding a CacheHeader, the scalars
+//! listed below, and then log nb, yq, log T and the table in the layout of m_table.
+//! Caches are only valid on machines with the same endianness and precision.
+constexpr char kCacheMagic[8] = {'A', 'T', 'H', 'E', 'O', 'S', 'C', '1'};
+enum CacheScalars {CS_MB, CS_MIN_N, CS_MAX_N, CS_MIN_Y, CS_MAX_Y, CS_MIN_T, CS_MAX_T,
+                   CS_ID_LOG_NB, CS_ID_YQ, CS_ID_LOG_T, CS_MIN_H, NCACHE_SCALARS};
+
+struct CacheHeader {
+  char magic[8];
+  std::int32_t real_size, nvars, nn, ny, nt, unused;
+  std::int64_t src_size, src_mtime;   // size and modification time of source table
+  std::uint64_t checksum;             // of scalars and tables
+};
+
+//! FNV-1a hash of 8-byte words, as used for restart checksums
+std::uint64_t HashBytes(const void *buf, std::size_t nbytes, std::uint64_t h) {
+  const unsigned char *p = static_cast<const unsigned char*>(buf);
+  for (std::size_t i=0; i<nbytes; i+=sizeof(std::uint64_t)) {
+    std::uint64_t w = 0;
+    std::memcpy(&w, p + i, std::min(sizeof(std::uint64_t), nbytes - i));
+    h = (h ^ w)*0x100000001b3ULL;
+  }
+  return h;
+}
+
+#if MPI_PARALLEL_ENABLED
+//! Broadcasts n Reals from rank 0, in pieces small enough for an int count
+void BcastReals(Real *buf, std::size_t n) {
+  const std::size_t nmax = 1 << 28;
+  for (std::size_t i=0; i<n; i+=nmax) {
+    int cnt = static_cast<int>(std::min(nmax, n - i));
+    MPI_Bcast(buf + i, cnt, MPI_ATHENA_REAL, 0, MPI_COMM_WORLD);
+  }
+}
+#endif
+} // namespace
+
+void EOSCompOSE::ReadTableFromFile(std::string fname, std::string cache_fname) {
   if (m_initialized==false) {
-    TableReader::Table table;
-    auto read_result = table.ReadTable(fname);
-    if (read_result.error != TableReader::ReadResult::SUCCESS) {
-      std::cout << "Table could not be read.\n";
-      assert (false);
+    // Scalars set from the table, in the order they are cached and broadcast
+    Real *scalars[NCACHE_SCALARS] = {&mb, &min_n, &max_n, &min_Y[0], &max_Y[0],
+                                     &min_T, &max_T, &m_id_log_nb, &m_id_yq,
+                                     &m_id_log_t, &m_min_h};
+    Real sbuf[NCACHE_SCALARS];
+    int dims[3] = {0, 0, 0};
+    HostArray1D<Real> host_log_nb, host_yq, host_log_t;
+    HostArray4D<Real> host_table;
+
+    // Only rank 0 touches the file system.  It reads the cache if it is present and
+    // matches the source table, and otherwise reads and pre-processes the table.
+    if (global_variable::my_rank == 0) {
+      struct stat src_stat;
+      std::int64_t src_size = -1, src_mtime = -1;
+      if (stat(fname.c_str(), &src_stat) == 0) {
+        src_size = static_cast<std::int64_t>(src_stat.st_size);
+        src_mtime = static_cast<std::int64_t>(src_stat.st_mtime);
+      }
+      bool cached = false;
+      if (!cache_fname.empty()) {
+        cached = ReadTableCache(cache_fname, src_size, src_mtime, sbuf, dims,
+                                host_log_nb, host_yq, host_log_t, host_table);
+      }
+      if (!cached) {
+        ReadTableSource(fname, host_log_nb, host_yq, host_log_t, host_table);
+        dims[0] = m_nn;
+        dims[1] = m_ny;
+        dims[2] = m_nt;
+        for (int n=0; n<NCACHE_SCALARS; ++n) {
+          sbuf[n] = *scalars[n];
+        }
+        if (!cache_fname.empty()) {
+          WriteTableCache(cache_fname, src_size, src_mtime, sbuf, dims,
+                          host_log_nb, host_yq, host_log_t, host_table);
+        }
+      }
     }
-    // Make sure table has correct dimentions
-    assert(table.GetNDimensions()==3);
-    // TODO(PH) check that required fields are present?
 
-    // Read baryon (neutron) mass
-    auto& table_scalars = table.GetScalars();
-    mb = table_scalars.at("mn");
+#if MPI_PARALLEL_ENABLED
+    // Broadcast pre-processed table to all ranks
+    MPI_Bcast(dims, 3, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(sbuf, NCACHE_SCALARS, MPI_ATHENA_REAL, 0, MPI_COMM_WORLD);
+    if (global_variable::my_rank != 0) {
+      Kokkos::realloc(host_log_nb, dims[0]);
+      Kokkos::realloc(host_yq,     dims[1]);
+      Kokkos::realloc(host_log_t,  dims[2]);
+      Kokkos::realloc(host_table, dims[0], dims[1], dims[2], ECNVARS);
+    }
+    BcastReals(host_log_nb.data(), host_log_nb.size());
+    BcastReals(host_yq.data(),     host_yq.size());
+    BcastReals(host_log_t.data(),  host_log_t.size());
+    BcastReals(host_table.data(),  host_table.size());
+#endif
 
-    // Get table dimesnions
-    auto& point_info = table.GetPointInfo();
-    m_nn = point_info[0].second;
-    m_ny = point_info[1].second;
-    m_nt = point_info[2].second;
+    m_nn = dims[0];
+    m_ny = dims[1];
+    m_nt = dims[2];
+    for (int n=0; n<NCACHE_SCALARS; ++n) {
+      *scalars[n] = sbuf[n];
+    }
 
-    // (Re)Allocate device storage
+    // (Re)Allocate device storage, and copy from host to device
     Kokkos::realloc(m_log_nb, m_nn);
     Kokkos::realloc(m_yq,     m_ny);
     Kokkos::realloc(m_log_t,  m_nt);
-    Kokkos::realloc(m_table, ECNVARS, m_nn, m_ny, m_nt);
-
-    // Create host storage to read into
-    HostArray1D<Real>::HostMirror host_log_nb = create_mirror_view(m_log_nb);
-    HostArray1D<Real>::HostMirror host_yq =     create_mirror_view(m_yq);
-    HostArray1D<Real>::HostMirror host_log_t =  create_mirror_view(m_log_t);
-    HostArray4D<Real>::HostMirror host_table =  create_mirror_view(m_table);
-
-    { // read nb
-      Real * table_nb = table["nb"];
-      for (size_t in=0; in<m_nn; ++in) {
-        host_log_nb(in) = log(table_nb[in]);
-      }
-      m_id_log_nb = 1.0/(host_log_nb(1) - host_log_nb(0));
-      min_n = table_nb[0];
-      max_n = table_nb[m_nn-1];
+    Kokkos::realloc(m_table, m_nn, m_ny, m_nt, ECNVARS);
+    Kokkos::deep_copy(m_log_nb, host_log_nb);
+    Kokkos::deep_copy(m_yq,     host_yq);
+    Kokkos::deep_copy(m_log_t,  host_log_t);
+    Kokkos::deep_copy(m_table,  host_table);
+
+    m_initialized = true;
+  } // if (m_initialized==false)
+}
+
+//----------------------------------------------------------------------------------------
+//! \brief Reads the CompOSE table fname and pre-processes it into host arrays, setting
+//! the dimensions and scalars of the table.
+
+void EOSCompOSE::ReadTableSource(std::string fname, HostArray1D<Real> &host_log_nb,
+    HostArray1D<Real> &host_yq, HostArray1D<Real> &host_log_t,
+    HostArray4D<Real> &host_table) {
+  TableReader::Table table;
+  auto read_result = table.ReadTable(fname);
+  if (read_result.error != TableReader::ReadResult::SUCCESS) {
+    std::cout << "Table could not be read.\n";
+    assert (false);
+  }
+  // Make sure table has correct dimentions
+  assert(table.GetNDimensions()==3);
+  // TODO(PH) check that required fields are present?
+
+  // Read baryon (neutron) mass
+  auto& table_scalars = table.GetScalars();
+  mb = table_scalars.at("mn");
+
+  // Get table dimesnions
+  auto& point_info = table.GetPointInfo();
+  m_nn = point_info[0].second;
+  m_ny = point_info[1].second;
+  m_nt = point_info[2].second;
+
+  // (Re)Allocate host storage to read into
+  Kokkos::realloc(host_log_nb, m_nn);
+  Kokkos::realloc(host_yq,     m_ny);
+  Kokkos::realloc(host_log_t,  m_nt);
+  Kokkos::realloc(host_table, m_nn, m_ny, m_nt, ECNVARS);
+
+  { // read nb
+    Real * table_nb = table["nb"];
+    for (size_t in=0; in<m_nn; ++in) {
+      host_log_nb(in) = log(table_nb[in]);
     }
+    m_id_log_nb = 1.0/(host_log_nb(1) - host_log_nb(0));
+    min_n = table_nb[0];
+    max_n = table_nb[m_nn-1];
+  }
 
-    { // read yq
-      Real * table_yq = table["yq"];
-      for (size_t iy=0; iy<m_ny; ++iy) {
-        host_yq(iy) = table_yq[iy];
-      }
-      m_id_yq = 1.0/(host_yq(1) - host_yq(0));
-      min_Y[0] = table_yq[0];
-      max_Y[0] = table_yq[m_ny-1];
+  { // read yq
+    Real * table_yq = table["yq"];
+    for (size_t iy=0; iy<m_ny; ++iy) {
+      host_yq(iy) = table_yq[iy];
     }
+    m_id_yq = 1.0/(host_yq(1) - host_yq(0));
+    min_Y[0] = table_yq[0];
+    max_Y[0] = table_yq[m_ny-1];
+  }
 
-    { // read T
-      Real * table_t = table["t"];
-      for (size_t it=0; it<m_nt; ++it) {
-        host_log_t(it) = log(table_t[it]);
-      }
-      m_id_log_t = 1.0/(host_log_t(1) - host_log_t(0));
-      min_T = table_t[1];      // These are different
-      max_T = table_t[m_nt-2]; // on purpose
+  { // read T
+    Real * table_t = table["t"];
+    for (size_t it=0; it<m_nt; ++it) {
+      host_log_t(it) = log(table_t[it]);
     }
+    m_id_log_t = 1.0/(host_log_t(1) - host_log_t(0));
+    min_T = table_t[1];      // These are different
+    max_T = table_t[m_nt-2]; // on purpose
+  }
 
-    { // Read Q1 -> log(P)
-      Real * table_Q1 = table["Q1"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECLOGP,in,iy,it) = log(table_Q1[iflat]) + host_log_nb(in);
-          }
+  { // Read Q1 -> log(P)
+    Real * table_Q1 = table["Q1"];
+    for (size_t in=0; in<m_nn; ++in) {
+      for (size_t iy=0; iy<m_ny; ++iy) {
+        for (size_t it=0; it<m_nt; ++it) {
+          size_t iflat = it + m_nt*(iy + m_ny*in);
+          host_table(in,iy,it,ECLOGP) = log(table_Q1[iflat]) + host_log_nb(in);
         }
       }
     }
+  }
 
-    { // Read Q2 -> S
-      Real * table_Q2 = table["Q2"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECENT,in,iy,it) = table_Q2[iflat];
-          }
+  { // Read Q2 -> S
+    Real * table_Q2 = table["Q2"];
+    for (size_t in=0; in<m_nn; ++in) {
+      for (size_t iy=0; iy<m_ny; ++iy) {
+        for (size_t it=0; it<m_nt; ++it) {
+          size_t iflat = it + m_nt*(iy + m_ny*in);
+          host_table(in,iy,it,ECENT) = table_Q2[iflat];
         }
       }
     }
+  }
 
-    { // Read Q3-> mu_b
-      Real * table_Q3 = table["Q3"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECMUB,in,iy,it) = (table_Q3[iflat]+1)*mb;
-          }
+  { // Read Q3-> mu_b
+    Real * table_Q3 = table["Q3"];
+    for (size_t in=0; in<m_nn; ++in) {
+      for (size_t iy=0; iy<m_ny; ++iy) {
+        for (size_t it=0; it<m_nt; ++it) {
+          size_t iflat = it + m_nt*(iy + m_ny*in);
+          host_table(in,iy,it,ECMUB) = (table_Q3[iflat]+1)*mb;
         }
       }
     }
+  }
 
-    { // Read Q4-> mu_q
-      Real * table_Q4 = table["Q4"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECMUB,in,iy,it) = table_Q4[iflat]*mb;
-          }
+  { // Read Q4-> mu_q
+    Real * table_Q4 = table["Q4"];
+    for (size_t in=0; in<m_nn; ++in) {
+      for (size_t iy=0; iy<m_ny; ++iy) {
+        for (size_t it=0; it<m_nt; ++it) {
+          size_t iflat = it + m_nt*(iy + m_ny*in);
+          host_table(in,iy,it,ECMUB) = table_Q4[iflat]*mb;
         }
       }
     }
+  }
 
-    { // Read Q5-> mu_le
-      Real * table_Q5 = table["Q5"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECMUL,in,iy,it) = table_Q5[iflat]*mb;
-          }
+  { // Read Q5-> mu_le
+    Real * table_Q5 = table["Q5"];
+    for (size_t in=0; in<m_nn; ++in) {
+      for (size_t iy=0; iy<m_ny; ++iy) {
+        for (size_t it=0; it<m_nt; ++it) {
+          size_t iflat = it + m_nt*(iy + m_ny*in);
+          host_table(in,iy,it,ECMUL) = table_Q5[iflat]*mb;
         }
       }
     }
+  }
 
-    { // Read Q7-> log(e)
-      Real * table_Q7 = table["Q7"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECLOGE,in,iy,it) = log(mb*(table_Q7[iflat] + 1)) + host_log_nb(in);
-          }
+  { // Read Q7-> log(e)
+    Real * table_Q7 = table["Q7"];
+    for (size_t in=0; in<m_nn; ++in) {
+      for (size_t iy=0; iy<m_ny; ++iy) {
+        for (size_t it=0; it<m_nt; ++it) {
+          size_t iflat = it + m_nt*(iy + m_ny*in);
+          host_table(in,iy,it,ECLOGE) = log(mb*(table_Q7[iflat] + 1)) + host_log_nb(in);
         }
       }
     }
+  }
 
-    { // Read cs2-> cs
-      Real * table_cs2 = table["cs2"];
-      for (size_t in=0; in<m_nn; ++in) {
-        for (size_t iy=0; iy<m_ny; ++iy) {
-          for (size_t it=0; it<m_nt; ++it) {
-            size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECCS,in,iy,it) = sqrt(table_cs2[iflat]);
-          }
+  { // Read cs2-> cs
+    Real * table_cs2 = table["cs2"];
+    for (size_t in=0; in<m_nn; ++in) {
+      for (size_t iy=0; iy<m_ny; ++iy) {
+        for (size_t it=0; it<m_nt; ++it) {
+          size_t iflat = it + m_nt*(iy + m_ny*in);
+          host_table(in,iy,it,ECCS) = sqrt(table_cs2[iflat]);
         }
       }
     }
+  }
 
-    // Copy from host to device
-    Kokkos::deep_copy(m_log_nb, host_log_nb);
-    Kokkos::deep_copy(m_yq,     host_yq);
-    Kokkos::deep_copy(m_log_t,  host_log_t);
-    Kokkos::deep_copy(m_table,  host_table);
-
-    m_initialized = true;
-
-    m_min_h = std::numeric_limits<Real>::max();
-    // Compute minimum enthalpy
-    for (int in = 0; in < m_nn; ++in) {
-      Real const nb = exp(host_log_nb(in));
-      for (int it = 0; it < m_nt; ++it) {
-        for (int iy = 0; iy < m_ny; ++iy) {
-          // This would use GPU memory, and we are currently on the CPU, so Enthalpy is
-          // hardcoded
-          Real e = exp(host_table(ECLOGE,in,iy,it));
-          Real p = exp(host_table(ECLOGP,in,iy,it));
-          Real h = (e + p) / nb;
-          m_min_h = fmin(m_min_h, h);
-        }
+  m_min_h = std::numeric_limits<Real>::max();
+  // Compute minimum enthalpy
+  for (int in = 0; in < m_nn; ++in) {
+    Real const nb = exp(host_log_nb(in));
+    for (int it = 0; it < m_nt; ++it) {
+      for (int iy = 0; iy < m_ny; ++iy) {
+        // This would use GPU memory, and we are currently on the CPU, so Enthalpy is
+        // hardcoded
+        Real e = exp(host_table(in,iy,it,ECLOGE));
+        Real p = exp(host_table(in,iy,it,ECLOGP));
+        Real h = (e + p) / nb;
+        m_min_h = fmin(m_min_h, h);
       }
     }
-  } // if (m_initialized==false)
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \brief Reads a cache of a pre-processed table written by WriteTableCache().  Returns
+//! false if the file is missing, was written from a different source table or with a
+//! different precision, or fails its checksum.
+
+bool EOSCompOSE::ReadTableCache(std::string cache_fname, std::int64_t src_size,
+    std::int64_t src_mtime, Real *scalars, int *dims, HostArray1D<Real> &host_log_nb,
+    HostArray1D<Real> &host_yq, HostArray1D<Real> &host_log_t,
+    HostArray4D<Real> &host_table) {
+  std::ifstream file(cache_fname, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  CacheHeader hdr;
+  file.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+  if (!file.good() || std::memcmp(hdr.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+      hdr.real_size != static_cast<std::int32_t>(sizeof(Real)) ||
+      hdr.nvars != ECNVARS || hdr.nn < 2 || hdr.ny < 2 || hdr.nt < 4 ||
+      hdr.src_size != src_size || hdr.src_mtime != src_mtime) {
+    std::cout << "Cache " << cache_fname << " does not match table, ignoring it.\n";
+    return false;
+  }
+  Kokkos::realloc(host_log_nb, hdr.nn);
+  Kokkos::realloc(host_yq,     hdr.ny);
+  Kokkos::realloc(host_log_t,  hdr.nt);
+  Kokkos::realloc(host_table, hdr.nn, hdr.ny, hdr.nt, ECNVARS);
+  file.read(reinterpret_cast<char*>(scalars), NCACHE_SCALARS*sizeof(Real));
+  file.read(reinterpret_cast<char*>(host_log_nb.data()), host_log_nb.size()*sizeof(Real));
+  file.read(reinterpret_cast<char*>(host_yq.data()),     host_yq.size()*sizeof(Real));
+  file.read(reinterpret_cast<char*>(host_log_t.data()),  host_log_t.size()*sizeof(Real));
+  file.read(reinterpret_cast<char*>(host_table.data()),  host_table.size()*sizeof(Real));
+  if (!file.good()) {
+    std::cout << "Cache " << cache_fname << " is truncated, ignoring it.\n";
+    return false;
+  }
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  h = HashBytes(scalars, NCACHE_SCALARS*sizeof(Real), h);
+  h = HashBytes(host_log_nb.data(), host_log_nb.size()*sizeof(Real), h);
+  h = HashBytes(host_yq.data(),     host_yq.size()*sizeof(Real), h);
+  h = HashBytes(host_log_t.data(),  host_log_t.size()*sizeof(Real), h);
+  h = HashBytes(host_table.data(),  host_table.size()*sizeof(Real), h);
+  if (h != hdr.checksum) {
+    std::cout << "Cache " << cache_fname << " fails checksum, ignoring it.\n";
+    return false;
+  }
+  dims[0] = hdr.nn;
+  dims[1] = hdr.ny;
+  dims[2] = hdr.nt;
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \brief Writes the pre-processed table to cache_fname.  The cache is written to a
+//! temporary file which is then renamed, so concurrent jobs never read a partial cache.
+
+void EOSCompOSE::WriteTableCache(std::string cache_fname, std::int64_t src_size,
+    std::int64_t src_mtime, const Real *scalars, const int *dims,
+    const HostArray1D<Real> &host_log_nb, const HostArray1D<Real> &host_yq,
+    const HostArray1D<Real> &host_log_t, const HostArray4D<Real> &host_table) {
+  CacheHeader hdr;
+  std::memset(&hdr, 0, sizeof(hdr));
+  std::memcpy(hdr.magic, kCacheMagic, sizeof(kCacheMagic));
+  hdr.real_size = static_cast<std::int32_t>(sizeof(Real));
+  hdr.nvars = ECNVARS;
+  hdr.nn = dims[0];
+  hdr.ny = dims[1];
+  hdr.nt = dims[2];
+  hdr.src_size = src_size;
+  hdr.src_mtime = src_mtime;
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  h = HashBytes(scalars, NCACHE_SCALARS*sizeof(Real), h);
+  h = HashBytes(host_log_nb.data(), host_log_nb.size()*sizeof(Real), h);
+  h = HashBytes(host_yq.data(),     host_yq.size()*sizeof(Real), h);
+  h = HashBytes(host_log_t.data(),  host_log_t.size()*sizeof(Real), h);
+  h = HashBytes(host_table.data(),  host_table.size()*sizeof(Real), h);
+  hdr.checksum = h;
+
+  std::string tmp_fname = cache_fname + ".tmp";
+  std::ofstream file(tmp_fname, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  file.write(reinterpret_cast<const char*>(scalars), NCACHE_SCALARS*sizeof(Real));
+  file.write(reinterpret_cast<const char*>(host_log_nb.data()),
+             host_log_nb.size()*sizeof(Real));
+  file.write(reinterpret_cast<const char*>(host_yq.data()), host_yq.size()*sizeof(Real));
+  file.write(reinterpret_cast<const char*>(host_log_t.data()),
+             host_log_t.size()*sizeof(Real));
+  file.write(reinterpret_cast<const char*>(host_table.data()),
+             host_table.size()*sizeof(Real));
+  file.close();
+  if (!file.good() || std::rename(tmp_fname.c_str(), cache_fname.c_str()) != 0) {
+    // not fatal, the table is simply read from the source again next time
+    std::cout << "Table cache " << cache_fname << " could not be written.\n";
+    std::remove(tmp_fname.c_str());
+  }
 }
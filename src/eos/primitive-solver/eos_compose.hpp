@@ -14,7 +14,14 @@
 
 ///  \warning This code assumes the table to be uniformly spaced in
 ///           log nb, log t, and yq
-
+///
+///  The table is stored with the variable index fastest, so that all variables at
+///  one (nb, yq, t) point share a cache line.  Quantities needed together (e.g. the
+///  pressure, energy, and sound speed) are then interpolated from a single set of
+///  indices and weights by Thermo(), with the 8 corner loads each fetching every
+///  variable at once.
+
+#include <cstdint>
 #include <string>
 #include <limits>
 
@@ -44,7 +51,7 @@ class EOSCompOSE : public EOSPolicyInterface {
       m_log_nb("log nb",1),
       m_log_t("log T",1),
       m_yq("yq",1),
-      m_table("EoS table",1,1,1,1) {
+      m_table("EoS table",1,1,1,ECNVARS) {
     n_species = 1;
     eos_units = MakeNuclear();
     m_initialized = false;
@@ -111,9 +118,11 @@ class EOSCompOSE : public EOSPolicyInterface {
 
   /// Calculate the enthalpy per baryon using.
   KOKKOS_INLINE_FUNCTION Real Enthalpy(Real n, Real T, Real *Y) const {
-    Real const P = Pressure(n, T, Y);
-    Real const e = Energy(n, T, Y);
-    return (P + e)/n;
+    assert (m_initialized);
+    const int ivs[2] = {ECLOGP, ECLOGE};
+    Real f[2];
+    eval_vars(lookup_at_lnty(log(n), log(T), Y[0]), 2, ivs, f);
+    return (exp(f[0]) + exp(f[1]))/n;
   }
 
   /// Calculate the sound speed.
@@ -122,6 +131,30 @@ class EOSCompOSE : public EOSPolicyInterface {
     return eval_at_nty(ECCS, n, T, Y[0]);
   }
 
+  /// Calculate the pressure, enthalpy per baryon, and sound speed from a single
+  /// table lookup.
+  KOKKOS_INLINE_FUNCTION void Thermo(Real n, Real T, Real *Y, Real *P, Real *h,
+                                     Real *cs) const {
+    assert (m_initialized);
+    const int ivs[3] = {ECLOGP, ECLOGE, ECCS};
+    Real f[3];
+    eval_vars(lookup_at_lnty(log(n), log(T), Y[0]), 3, ivs, f);
+    *P = exp(f[0]);
+    *h = (*P + exp(f[1]))/n;
+    *cs = f[2];
+  }
+
+  /// Calculate the pressure and enthalpy per baryon from a single table lookup.
+  KOKKOS_INLINE_FUNCTION void PressureEnthalpy(Real n, Real T, Real *Y, Real *P,
+                                               Real *h) const {
+    assert (m_initialized);
+    const int ivs[2] = {ECLOGP, ECLOGE};
+    Real f[2];
+    eval_vars(lookup_at_lnty(log(n), log(T), Y[0]), 2, ivs, f);
+    *P = exp(f[0]);
+    *h = (*P + exp(f[1]))/n;
+  }
+
   /// Calculate the specific internal energy per unit mass
   KOKKOS_INLINE_FUNCTION Real SpecificInternalEnergy(Real n, Real T, Real *Y) const {
     return Energy(n, T, Y)/(mb*n) - 1;
@@ -174,8 +207,10 @@ class EOSCompOSE : public EOSPolicyInterface {
   }
 
  public:
-  /// Reads the table file.
-  void ReadTableFromFile(std::string fname);
+  /// Reads the table file.  Only rank 0 reads from disk, and broadcasts the table to
+  /// all other ranks.  If cache_fname is not empty, the pre-processed table is read from
+  /// (or, if missing or stale, written to) that binary cache instead of the source.
+  void ReadTableFromFile(std::string fname, std::string cache_fname = "");
 
   /// Get the raw number density
   KOKKOS_INLINE_FUNCTION DvceArray1D<Real> const GetRawLogNumberDensity() const {
@@ -190,14 +225,14 @@ class EOSCompOSE : public EOSPolicyInterface {
   KOKKOS_INLINE_FUNCTION DvceArray1D<Real> const GetRawLogTemperature() const {
     return m_log_t;
   }
-  /// Get the raw table data
+  /// Get the raw table data, indexed as (in, iy, it, iv)
   KOKKOS_INLINE_FUNCTION DvceArray4D<Real> const GetRawTable() const {
     return m_table;
   }
 
   // Indexing used to access the data
   KOKKOS_INLINE_FUNCTION ptrdiff_t index(int iv, int in, int iy, int it) const {
-    return it + m_nt*(iy + m_ny*(in + m_nn*iv));
+    return iv + ECNVARS*(it + m_nt*(iy + m_ny*in));
   }
 
   /// Check if the EOS has been initialized properly.
@@ -224,6 +259,19 @@ class EOSCompOSE : public EOSPolicyInterface {
   }
 
  private:
+  /// Reading and caching of the pre-processed table on the host
+  void ReadTableSource(std::string fname, HostArray1D<Real> &host_log_nb,
+      HostArray1D<Real> &host_yq, HostArray1D<Real> &host_log_t,
+      HostArray4D<Real> &host_table);
+  bool ReadTableCache(std::string cache_fname, std::int64_t src_size,
+      std::int64_t src_mtime, Real *scalars, int *dims, HostArray1D<Real> &host_log_nb,
+      HostArray1D<Real> &host_yq, HostArray1D<Real> &host_log_t,
+      HostArray4D<Real> &host_table);
+  void WriteTableCache(std::string cache_fname, std::int64_t src_size,
+      std::int64_t src_mtime, const Real *scalars, const int *dims,
+      const HostArray1D<Real> &host_log_nb, const HostArray1D<Real> &host_yq,
+      const HostArray1D<Real> &host_log_t, const HostArray4D<Real> &host_table);
+
   /// Low level evaluation function, not intended for outside use
   KOKKOS_INLINE_FUNCTION Real eval_at_nty(int vi, Real n, Real T, Real Yq) const {
     return eval_at_lnty(vi, log(n), log(T), Yq);
@@ -231,22 +279,66 @@ class EOSCompOSE : public EOSPolicyInterface {
   /// Low level evaluation function, not intended for outside use
   KOKKOS_INLINE_FUNCTION Real eval_at_lnty(int iv, Real log_n, Real log_t, Real yq)
       const {
+    Real f;
+    eval_vars(lookup_at_lnty(log_n, log_t, yq), 1, &iv, &f);
+    return f;
+  }
+
+  /// Indices and weights for trilinear interpolation at one point in the table
+  struct TableLookup {
     int in, iy, it;
     Real wn0, wn1, wy0, wy1, wt0, wt1;
+  };
+
+  /// Compute the interpolation indices and weights at a point
+  KOKKOS_INLINE_FUNCTION TableLookup lookup_at_lnty(Real log_n, Real log_t, Real yq)
+      const {
+    TableLookup lk;
+    weight_idx_ln(&lk.wn0, &lk.wn1, &lk.in, log_n);
+    weight_idx_yq(&lk.wy0, &lk.wy1, &lk.iy, yq);
+    weight_idx_lt(&lk.wt0, &lk.wt1, &lk.it, log_t);
+    return lk;
+  }
 
-    weight_idx_ln(&wn0, &wn1, &in, log_n);
-    weight_idx_yq(&wy0, &wy1, &iy, yq);
-    weight_idx_lt(&wt0, &wt1, &it, log_t);
+  /// Compute the interpolation indices and weights in density and composition only, for
+  /// searches over the temperature index
+  KOKKOS_INLINE_FUNCTION TableLookup lookup_at_lny(Real log_n, Real yq) const {
+    TableLookup lk;
+    weight_idx_ln(&lk.wn0, &lk.wn1, &lk.in, log_n);
+    weight_idx_yq(&lk.wy0, &lk.wy1, &lk.iy, yq);
+    lk.it = 0;
+    lk.wt0 = 1.0;
+    lk.wt1 = 0.0;
+    return lk;
+  }
 
-    return
-      wn0 * (wy0 * (wt0 * m_table(iv, in+0, iy+0, it+0)   +
-                    wt1 * m_table(iv, in+0, iy+0, it+1))  +
-             wy1 * (wt0 * m_table(iv, in+0, iy+1, it+0)   +
-                    wt1 * m_table(iv, in+0, iy+1, it+1))) +
-      wn1 * (wy0 * (wt0 * m_table(iv, in+1, iy+0, it+0)   +
-                    wt1 * m_table(iv, in+1, iy+0, it+1))  +
-             wy1 * (wt0 * m_table(iv, in+1, iy+1, it+0)   +
-                    wt1 * m_table(iv, in+1, iy+1, it+1)));
+  /// Interpolate variable iv in density and composition at temperature index it, using
+  /// the density and composition weights of lk
+  KOKKOS_INLINE_FUNCTION Real eval_at_it(const TableLookup &lk, const int it,
+                                         const int iv) const {
+    const int in = lk.in, iy = lk.iy;
+    return lk.wn0 * (lk.wy0 * m_table(in+0, iy+0, it, iv)  +
+                     lk.wy1 * m_table(in+0, iy+1, it, iv)) +
+           lk.wn1 * (lk.wy0 * m_table(in+1, iy+0, it, iv)  +
+                     lk.wy1 * m_table(in+1, iy+1, it, iv));
+  }
+
+  /// Interpolate the nv variables ivs[] at the point described by lk into f[]
+  KOKKOS_INLINE_FUNCTION void eval_vars(const TableLookup &lk, const int nv,
+                                        const int *ivs, Real *f) const {
+    const int in = lk.in, iy = lk.iy, it = lk.it;
+    for (int v = 0; v < nv; ++v) {
+      const int iv = ivs[v];
+      f[v] =
+        lk.wn0 * (lk.wy0 * (lk.wt0 * m_table(in+0, iy+0, it+0, iv)   +
+                            lk.wt1 * m_table(in+0, iy+0, it+1, iv))  +
+                  lk.wy1 * (lk.wt0 * m_table(in+0, iy+1, it+0, iv)   +
+                            lk.wt1 * m_table(in+0, iy+1, it+1, iv))) +
+        lk.wn1 * (lk.wy0 * (lk.wt0 * m_table(in+1, iy+0, it+0, iv)   +
+                            lk.wt1 * m_table(in+1, iy+0, it+1, iv))  +
+                  lk.wy1 * (lk.wt0 * m_table(in+1, iy+1, it+0, iv)   +
+                            lk.wt1 * m_table(in+1, iy+1, it+1, iv)));
+    }
   }
 
   /// Evaluate interpolation weight for density
@@ -278,19 +370,10 @@ class EOSCompOSE : public EOSPolicyInterface {
   /// Low level function, not intended for outside use
   KOKKOS_INLINE_FUNCTION Real temperature_from_var(int iv, Real var, Real n, Real Yq)
       const {
-    int in, iy;
-    Real wn0, wn1, wy0, wy1;
-    weight_idx_ln(&wn0, &wn1, &in, log(n));
-    weight_idx_yq(&wy0, &wy1, &iy, Yq);
+    const TableLookup lk = lookup_at_lny(log(n), Yq);
 
     auto f = [=](int it){
-      Real var_pt =
-        wn0 * (wy0 * m_table(iv, in+0, iy+0, it)  +
-               wy1 * m_table(iv, in+0, iy+1, it)) +
-        wn1 * (wy0 * m_table(iv, in+1, iy+0, it)  +
-               wy1 * m_table(iv, in+1, iy+1, it));
-
-      return var - var_pt;
+      return var - eval_at_it(lk, it, iv);
     };
 
     int ilo = 0;
@@ -361,7 +444,7 @@ class EOSCompOSE : public EOSPolicyInterface {
   // of table
   bool m_initialized;
 
-  // Table storage on DEVICE.
+  // Table storage on DEVICE.  m_table is indexed (in, iy, it, iv).
   DvceArray1D<Real> m_log_nb;
   DvceArray1D<Real> m_yq;
   DvceArray1D<Real> m_log_t;
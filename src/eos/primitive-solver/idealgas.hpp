@@ -89,6 +89,21 @@ class IdealGas : public EOSPolicyInterface {
     return sqrt(gamma*gammam1*T/(gammam1*mb + gamma*T));
   }
 
+  /// Calculate the pressure, enthalpy per baryon, and sound speed together.
+  KOKKOS_INLINE_FUNCTION void Thermo(Real n, Real T, Real *Y, Real *P, Real *h,
+                                     Real *cs) const {
+    *P = Pressure(n, T, Y);
+    *h = Enthalpy(n, T, Y);
+    *cs = SoundSpeed(n, T, Y);
+  }
+
+  /// Calculate the pressure and enthalpy per baryon together.
+  KOKKOS_INLINE_FUNCTION void PressureEnthalpy(Real n, Real T, Real *Y, Real *P,
+                                               Real *h) const {
+    *P = Pressure(n, T, Y);
+    *h = Enthalpy(n, T, Y);
+  }
+
   /// Calculate the internal energy per mass
   KOKKOS_INLINE_FUNCTION Real SpecificInternalEnergy(Real n, Real T, Real *Y) const {
     return T/(mb*gammam1);
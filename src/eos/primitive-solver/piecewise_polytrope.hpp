@@ -123,6 +123,37 @@ class PiecewisePolytrope : public EOSPolicyInterface {
     return sqrt((csq_cold_w + csq_th_w)/(h_th + h_cold));
   }
 
+  /// Calculate the pressure and enthalpy per baryon together, finding the piece and
+  /// evaluating the cold pressure only once.
+  KOKKOS_INLINE_FUNCTION void PressureEnthalpy(Real n, Real T, Real *Y, Real *P,
+                                               Real *h) const {
+    int p = FindPiece(n);
+    Real P_cold = GetColdPressure(n, p);
+    Real e_cold = mb*n*(1.0 + eps_pieces[p]) + P_cold/(gamma_pieces[p] - 1.0);
+
+    *P = P_cold + n*T;
+    *h = (e_cold + P_cold)/n + gamma_thermal/(gamma_thermal - 1.0)*T;
+  }
+
+  /// Calculate the pressure, enthalpy per baryon, and sound speed together, finding the
+  /// piece and evaluating the cold pressure only once.
+  KOKKOS_INLINE_FUNCTION void Thermo(Real n, Real T, Real *Y, Real *P, Real *h,
+                                     Real *cs) const {
+    int p = FindPiece(n);
+    Real rho = n*mb;
+    Real P_cold = GetColdPressure(n, p);
+    Real e_cold = mb*n*(1.0 + eps_pieces[p]) + P_cold/(gamma_pieces[p] - 1.0);
+
+    *P = P_cold + n*T;
+    *h = (e_cold + P_cold)/n + gamma_thermal/(gamma_thermal - 1.0)*T;
+
+    Real h_cold = (e_cold + P_cold)/rho;
+    Real h_th = gamma_thermal/(gamma_thermal - 1.0)*T/mb;
+    Real csq_cold_w = gamma_pieces[p]*P_cold/rho;
+    Real csq_th_w = (gamma_thermal - 1.0)*h_th;
+    *cs = sqrt((csq_cold_w + csq_th_w)/(h_th + h_cold));
+  }
+
   /// Calculate the internal energy per mass.
   KOKKOS_INLINE_FUNCTION Real SpecificInternalEnergy(Real n, Real T, Real *Y) const {
     int p = FindPiece(n);
@@ -211,6 +242,7 @@ class PiecewisePolytrope : public EOSPolicyInterface {
     density_pieces[0] = densities[1]/mb;
     gamma_pieces[0] = gammas[0];
     pressure_pieces[0] = P0;
+    eps_pieces[0] = 0.0;
 
     for (int i = 1; i < n; i++) {
       density_pieces[i] = densities[i]/mb;
@@ -225,6 +257,16 @@ class PiecewisePolytrope : public EOSPolicyInterface {
                       (1.0/(gammas[i-1] - 1.0) - 1.0/(gammas[i] - 1.0));
     }
 
+    // Pad the unused pieces with thresholds no density or pressure can reach, so that
+    // FindPiece() and GetDensityFromColdPressure() can compare against all MAX_PIECES
+    // thresholds.
+    for (int i = n; i < MAX_PIECES; i++) {
+      density_pieces[i] = DBL_MAX;
+      pressure_pieces[i] = DBL_MAX;
+      gamma_pieces[i] = gamma_pieces[n-1];
+      eps_pieces[i] = eps_pieces[n-1];
+    }
+
     // Because we're adding in a finite-temperature component via the ideal gas,
     // the only restriction on our temperature is that it needs to be nonnegative.
     min_T = 0.0;
@@ -260,15 +302,17 @@ class PiecewisePolytrope : public EOSPolicyInterface {
     return gamma_thermal;
   }
 
-  /// Find the index of the piece that the density aligns with.
+  /// Find the index of the piece that the density aligns with.  The piece is the number
+  /// of thresholds below n, counted over all MAX_PIECES thresholds (unused pieces are
+  /// padded in InitializeFromData) so the loop has a fixed trip count, is unrolled by
+  /// the compiler, and compiles to comparisons and selects rather than branches.
   KOKKOS_INLINE_FUNCTION int FindPiece(Real n) const {
     // WARNING: assumes the EOS is initialized!
-    for (int i = 0; i < n_pieces-1; ++i) {
-      if (n < density_pieces[i+1]) {
-        return i;
-      }
+    int p = 0;
+    for (int i = 1; i < MAX_PIECES; ++i) {
+      p += (n >= density_pieces[i]) ? 1 : 0;
     }
-    return n_pieces - 1;
+    return (p < n_pieces) ? p : n_pieces - 1;
   }
 
   /// Polytropic Energy Density
@@ -283,13 +327,11 @@ class PiecewisePolytrope : public EOSPolicyInterface {
 
   /// Inverse of GetColdPressure
   KOKKOS_INLINE_FUNCTION Real GetDensityFromColdPressure(Real p) const {
-    int ip = n_pieces - 1;
-    for (int i = 0; i < n_pieces-1; ++i) {
-      if (p < pressure_pieces[i+1]) {
-        ip = i;
-        break;
-      }
+    int ip = 0;
+    for (int i = 1; i < MAX_PIECES; ++i) {
+      ip += (p >= pressure_pieces[i]) ? 1 : 0;
     }
+    ip = (ip < n_pieces) ? ip : n_pieces - 1;
     return density_pieces[ip]*pow((p/pressure_pieces[ip]), 1.0/gamma_pieces[ip]);
   }
 
@@ -135,8 +135,8 @@ class PrimitiveSolver {
       Real That = peos->GetTemperatureFromE(nhat, ehat, Y);
       peos->ApplyTemperatureLimits(That);
       //ehat = peos->GetEnergy(nhat, That, Y);
-      Real Phat = peos->GetPressure(nhat, That, Y);
-      Real hhat = peos->GetEnthalpy(nhat, That, Y);
+      Real Phat, hhat;
+      peos->GetPressureEnthalpy(nhat, That, Y, &Phat, &hhat);
 
       // Now we can get two different estimates for nu = h/W.
       Real nu_a = hhat*iWhat;
@@ -201,12 +201,20 @@ class PrimitiveSolver {
 
  public:
   Real tol;
+  /// Relative half-width of the bracket around a guess for mu used to warm start the
+  /// root solve.
+  Real warm_width;
+  /// If true, the failure response is not applied when the root cannot be bracketed or
+  /// found, so that the solve can be retried (e.g. with more iterations) by the caller.
+  bool defer_root_failure;
 
   /// Constructor
   //PrimitiveSolver(EOS<EOSPolicy, ErrorPolicy> *eos) : peos(eos) {
   PrimitiveSolver() {
     //root = NumTools::Root();
     tol = 1e-15;
+    warm_width = 1e-2;
+    defer_root_failure = false;
     root.iterations = 30;
   }
 
@@ -220,11 +228,16 @@ class PrimitiveSolver {
   //  \param[in,out] bu    The magnetic field
   //  \param[in]     g3d   The 3x3 spatial metric
   //  \param[in]     g3u   The 3x3 inverse spatial metric
+  //  \param[in]     mu_guess  An estimate of the root (e.g., the root found in this
+  //                           cell by the last solve), or zero if there is none. If
+  //                           given, the root is first sought in a narrow bracket
+  //                           around it, falling back to the full bracket on failure.
   //
   //  \return information about the solve
   KOKKOS_INLINE_FUNCTION
   SolverResult ConToPrim(Real prim[NPRIM], Real cons[NCONS], Real b[NMAG],
-                         Real g3d[NSPMETRIC], Real g3u[NSPMETRIC]) const;
+                         Real g3d[NSPMETRIC], Real g3u[NSPMETRIC],
+                         Real mu_guess = 0.0) const;
 
   //! \brief Get the conserved variables from the primitive variables.
   //
@@ -364,8 +377,9 @@ Error PrimitiveSolver<EOSPolicy, ErrorPolicy>::CheckDensityValid(Real& mul, Real
 template<typename EOSPolicy, typename ErrorPolicy>
 KOKKOS_INLINE_FUNCTION
 SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM],
-      Real cons[NCONS], Real b[NMAG], Real g3d[NSPMETRIC], Real g3u[NSPMETRIC]) const {
-  SolverResult solver_result{Error::SUCCESS, 0, false, false, false};
+      Real cons[NCONS], Real b[NMAG], Real g3d[NSPMETRIC], Real g3u[NSPMETRIC],
+      Real mu_guess) const {
+  SolverResult solver_result{Error::SUCCESS, 0, false, false, false, 0.0};
 
   // Extract the undensitized conserved variables.
   Real D = cons[CDN];
@@ -479,48 +493,72 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
   Real min_h = eos.GetMinimumEnthalpy();
   Real mul = 0.0;
   Real muh = 1.0/min_h;
-  // Check if a tighter upper bound exists.
-  if (rsqr > min_h*min_h) {
-    Real mu = 0.0;
-    // We don't need the bound to be that tight, so we reduce
-    // the accuracy of the root solve for speed reasons.
-    Real mulc = mul;
-    Real mulh = muh;
-    bool result = root.NewtonSafe(UpperRoot, mulc, mulh, mu, 1e-10,
-                                  bsqr, rsqr, rbsqr, min_h);
-    // Scream if the bracketing failed.
-    if (!result) {
-      HandleFailure(prim, cons, b, g3d);
-      solver_result.error = Error::BRACKETING_FAILED;
-      return solver_result;
-    } else {
-      // To avoid problems with the case where the root and the upper bound collide,
-      // we will perturb the bound slightly upward.
-      // TODO(JF): Is there a more rigorous way of treating this?
-      muh = mu*(1. + 1e-10);
+  Real n, P, T, mu;
+  unsigned int count = 0;
+  bool result = false;
+
+  // If we have a guess for mu, first try to solve within a narrow bracket around it.
+  // This skips the root solves needed to tighten the full bracket, and should converge
+  // in far fewer iterations when the state has changed little since the guess was made.
+  // The narrow bracket is only tried when CheckDensityValid would not alter the bounds
+  // or flag an error, and if it does not contain the root the full bracket is used.
+  if (mu_guess > 0.0 && warm_width > 0.0) {
+    Real W_max = sqrt(1.0 + rsqr/(min_h*min_h));
+    Real rho_max = eos.GetMaximumDensity()*eos.GetBaryonMass();
+    Real rho_min = eos.GetMinimumDensity()*eos.GetBaryonMass();
+    Real mulw = fmax(mul, mu_guess*(1.0 - warm_width));
+    Real muhw = fmin(muh, mu_guess*(1.0 + warm_width));
+    if (D <= rho_max && D >= W_max*rho_min && mulw < muhw) {
+      result = root.FalsePosition(RootFunction, mulw, muhw, mu, tol, count,
+                                  D, q, bsqr, rsqr, rbsqr, Y, &eos, &n, &T, &P);
+      solver_result.iterations += count;
     }
   }
 
-  // Check the corner case where the density is outside the permitted
-  // bounds according to the ErrorPolicy.
-  error = CheckDensityValid(mul, muh, D, bsqr, rsqr, rbsqr, min_h);
-  // TODO(JF): This is probably something that should be handled by the ErrorPolicy.
-  if (error != Error::SUCCESS) {
-    HandleFailure(prim, cons, b, g3d);
-    solver_result.error = error;
-    return solver_result;
-  }
+  if (!result) {
+    // Check if a tighter upper bound exists.
+    if (rsqr > min_h*min_h) {
+      Real muc = 0.0;
+      // We don't need the bound to be that tight, so we reduce
+      // the accuracy of the root solve for speed reasons.
+      Real mulc = mul;
+      Real mulh = muh;
+      bool bracketed = root.NewtonSafe(UpperRoot, mulc, mulh, muc, 1e-10,
+                                       bsqr, rsqr, rbsqr, min_h);
+      // Scream if the bracketing failed.
+      if (!bracketed) {
+        if (!defer_root_failure) {
+          HandleFailure(prim, cons, b, g3d);
+        }
+        solver_result.error = Error::BRACKETING_FAILED;
+        return solver_result;
+      } else {
+        // To avoid problems with the case where the root and the upper bound collide,
+        // we will perturb the bound slightly upward.
+        // TODO(JF): Is there a more rigorous way of treating this?
+        muh = muc*(1. + 1e-10);
+      }
+    }
 
+    // Check the corner case where the density is outside the permitted
+    // bounds according to the ErrorPolicy.
+    error = CheckDensityValid(mul, muh, D, bsqr, rsqr, rbsqr, min_h);
+    // TODO(JF): This is probably something that should be handled by the ErrorPolicy.
+    if (error != Error::SUCCESS) {
+      HandleFailure(prim, cons, b, g3d);
+      solver_result.error = error;
+      return solver_result;
+    }
 
-  // Do the root solve.
-  Real n, P, T, mu;
-  bool result = root.FalsePosition(RootFunction, mul, muh, mu, tol,
-                                   D, q, bsqr, rsqr, rbsqr, Y, &eos, &n, &T, &P);
-  // WARNING: the reported number of iterations is not thread-safe and should only be
-  // trusted on single-thread benchmarks.
-  solver_result.iterations = root.iterations;
+    // Do the root solve.
+    result = root.FalsePosition(RootFunction, mul, muh, mu, tol, count,
+                                D, q, bsqr, rsqr, rbsqr, Y, &eos, &n, &T, &P);
+    solver_result.iterations += count;
+  }
   if (!result) {
-    HandleFailure(prim, cons, b, g3d);
+    if (!defer_root_failure) {
+      HandleFailure(prim, cons, b, g3d);
+    }
     solver_result.error = Error::NO_SOLUTION;
     return solver_result;
   }
@@ -550,6 +588,8 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
   solver_result.cons_adjusted = solver_result.cons_adjusted || floored ||
                                 solver_result.cons_floor;
 
+  solver_result.mu = mu;
+
   prim[PRH] = n;
   prim[PPR] = P;
   prim[PTM] = T;
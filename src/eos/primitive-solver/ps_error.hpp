@@ -8,6 +8,8 @@
 //! \file ps_error.hpp
 //  \brief defines an enumerator struct for error types.
 
+#include "ps_types.hpp"
+
 namespace Primitive {
 enum struct Error {
   SUCCESS,
@@ -28,6 +30,7 @@ struct SolverResult {
   bool cons_floor;
   bool prim_floor;
   bool cons_adjusted;
+  Real mu;  // root of the primitive solve, or zero if the root was not found
 };
 
 } // namespace Primitive
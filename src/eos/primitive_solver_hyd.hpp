@@ -14,10 +14,12 @@
 #include <math.h>
 
 // C++ headers
+#include <algorithm>
 #include <string>
 #include <type_traits>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 // PrimitiveSolver headers
 #include "eos/primitive-solver/eos.hpp"
@@ -36,6 +38,15 @@
 #include "mhd/mhd.hpp"
 #include "coordinates/coordinates.hpp"
 #include "coordinates/cell_locations.hpp"
+#include "z4c/tmunu.hpp"
+
+// Outcomes of primitive solves counted in each MeshBlock if <mhd>/c2p_stats is set:
+// failures with each Primitive::Error returned by the solver (with primitive and
+// conserved flooring failures combined), successful solves in which the primitive or
+// conserved variables were floored, and cells retried after a failed fast solve.
+enum C2PStat {C2P_RHO_TOO_BIG, C2P_RHO_TOO_SMALL, C2P_NANS_IN_CONS, C2P_MAG_TOO_BIG,
+              C2P_BRACKETING_FAILED, C2P_NO_SOLUTION, C2P_FLOOR_FAILED, C2P_FLOORED,
+              C2P_RETRIED, NC2P_STATS};
 
 template<class EOSPolicy, class ErrorPolicy>
 class PrimitiveSolverHydro {
@@ -76,9 +87,11 @@ class PrimitiveSolverHydro {
         std::exit(EXIT_FAILURE);
       }
 
-      // Get table filename, then read the table,
+      // Get table filename (and optional cache of the pre-processed table), then read
+      // the table
       std::string fname = pin->GetString(block, "table");
-      ps.GetEOSMutable().ReadTableFromFile(fname);
+      std::string cache_fname = pin->GetOrAddString(block, "table_cache", "");
+      ps.GetEOSMutable().ReadTableFromFile(fname, cache_fname);
 
       // Ensure table was read properly
       assert(ps.GetEOSMutable().IsInitialized());
@@ -91,9 +104,35 @@ class PrimitiveSolverHydro {
   unsigned int nerrs;
   unsigned int errcap;
 
+  // Data saved from the last primitive solve in each cell, allocated only if either
+  // c2p_warm_start or c2p_save_iter is set: the root mu (n=0), used to warm start the
+  // next solve, and the number of root-finding iterations (n=1).
+  bool c2p_warm_start;
+  bool c2p_save_iter;
+  int c2p_version;               // Mesh::nghbr_version when c2p_data was last valid
+  DvceArray5D<Real> c2p_data;
+
+  // Counts (nmb, NC2P_STATS) of the outcomes of full primitive solves in each MeshBlock
+  // since they were last added to c2p_totals by C2PCountTotals(), allocated only if
+  // c2p_stats is set.
+  bool c2p_stats;
+  int stats_version;             // Mesh::nghbr_version when c2p_counts was allocated
+  DvceArray2D<int> c2p_counts;
+  std::vector<double> c2p_totals;
+
+  // If c2p_fast_iter > 0, every cell is first solved with at most c2p_fast_iter
+  // root-finding iterations, without applying the failure response.  Cells in which the
+  // root was not bracketed or found are then compacted into c2p_retry_list, and only
+  // those are solved again with c2p_iter iterations (and floored if that fails too), so
+  // threads solving the rare failing cells do not stall the rest of the kernel.
+  int c2p_fast_iter;
+  DvceArray1D<int> c2p_retry_flag, c2p_retry_list;
+
   PrimitiveSolverHydro(std::string block, MeshBlockPack *pp, ParameterInput *pin) :
 //        pmy_pack(pp), ps{&eos} {
-        pmy_pack(pp), nerrs(0) {
+        pmy_pack(pp), nerrs(0), c2p_version(-1), c2p_data("c2p_data",1,1,1,1,1),
+        stats_version(-1), c2p_counts("c2p_counts",1,1), c2p_totals(NC2P_STATS, 0.0),
+        c2p_retry_flag("c2p_retry_flag",1), c2p_retry_list("c2p_retry_list",1) {
     SetPolicyParams(block, pin);
     Real mb = ps.GetEOS().GetBaryonMass();
     ps.GetEOSMutable().SetDensityFloor(pin->GetOrAddReal(block, "dfloor", (FLT_MIN))/mb);
@@ -103,6 +142,25 @@ class PrimitiveSolverHydro {
     ps.GetRootSolverMutable().iterations = pin->GetOrAddInteger(block, "c2p_iter", 50);
     errcap = pin->GetOrAddInteger(block, "c2perrs", 1000);
 
+    // Seed the root solve in each cell from the last solve there, and/or save the number
+    // of iterations in each cell (for outputs and load balancing).
+    c2p_warm_start = pin->GetOrAddBoolean(block, "c2p_warm_start", false);
+    c2p_save_iter = pin->GetOrAddBoolean(block, "c2p_save_iter", false);
+    ps.warm_width = pin->GetOrAddReal(block, "c2p_warm_width", 1e-2);
+    if (c2p_warm_start || c2p_save_iter) {
+      auto &indcs = pmy_pack->pmesh->mb_indcs;
+      int nmb = std::max((pmy_pack->nmb_thispack), (pmy_pack->pmesh->nmb_maxperrank));
+      int ncells1 = indcs.nx1 + 2*(indcs.ng);
+      int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+      int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+      Kokkos::realloc(c2p_data, nmb, 2, ncells3, ncells2, ncells1);
+    }
+
+    // Count failures and floors of the primitive solve in each MeshBlock, and optionally
+    // try a cheaper solve in all cells before retrying only the cells where it failed.
+    c2p_stats = pin->GetOrAddBoolean(block, "c2p_stats", false);
+    c2p_fast_iter = pin->GetOrAddInteger(block, "c2p_fast_iter", 0);
+
     // Calculate maximum allowed velocity
     Real Wmax = pin->GetOrAddReal(block, "gamma_max", 50.0);
     Real vmax = sqrt(1.0 - 1.0/(Wmax*Wmax));
@@ -271,7 +329,8 @@ class PrimitiveSolverHydro {
   void ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &bfc,
                   DvceArray5D<Real> &bcc0, DvceArray5D<Real> &prim,
                   const int il, const int iu, const int jl, const int ju,
-                  const int kl, const int ku, bool floors_only=false) {
+                  const int kl, const int ku, bool floors_only=false,
+                  Tmunu *ptmunu=nullptr) {
     int &nhyd = pmy_pack->pmhd->nmhd;
     int &nscal = pmy_pack->pmhd->nscalars;
     int &nmb = pmy_pack->nmb_thispack;
@@ -286,7 +345,6 @@ class PrimitiveSolverHydro {
 
     auto &adm  = pmy_pack->padm->adm;
     auto &eos_ = ps.GetEOS();
-    auto &ps_  = ps;
 
     const int ni = (iu - il + 1);
     const int nji = (ju - jl + 1)*ni;
@@ -294,7 +352,6 @@ class PrimitiveSolverHydro {
     const int nmkji = nmb*nkji;
 
     const int rank = global_variable::my_rank;
-    const int nerrs_ = nerrs;
     const int errcap_ = errcap;
 
     Real mb = eos_.GetBaryonMass();
@@ -308,194 +365,316 @@ class PrimitiveSolverHydro {
       ps.GetEOSMutable().SetConservedFloorFailure(true);
     }
 
-    // FIXME(JMF): We can short-circuit the primitive solve if FOFC is already enabled
-    // due to a maximum principle violation.
-    int count_errs=0;
-    Kokkos::parallel_reduce("pshyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-    KOKKOS_LAMBDA(const int &idx, int &sumerrs) {
-      int m = (idx)/nkji;
-      int k = (idx - m*nkji)/nji;
-      int j = (idx - m*nkji - k*nji)/ni;
-      int i = (idx - m*nkji - k*nji - j*ni) + il;
-      j += jl;
-      k += kl;
-
-      // Add in a short circuit where FOFC is guaranteed.
-      if (floors_only && fofc_(m, k, j, i)) {
-        return;
+    // Data saved from the last solve in each cell is invalid once MeshBlocks have been
+    // refined, derefined, or moved between ranks.  Data is only saved by full solves,
+    // not when only testing the floors.
+    if ((c2p_warm_start || c2p_save_iter) &&
+        (c2p_version != pmy_pack->pmesh->nghbr_version)) {
+      Kokkos::deep_copy(TaskExecSpace(), c2p_data, 0.0);
+      c2p_version = pmy_pack->pmesh->nghbr_version;
+    }
+    auto &c2p_data_ = c2p_data;
+    const bool warm_start = c2p_warm_start;
+    const bool save_data = (c2p_warm_start || c2p_save_iter) && !floors_only;
+
+    // Counts of outcomes are kept for the MeshBlocks currently on this rank, so once
+    // MeshBlocks have changed the old counts are added to the totals and reset.
+    const bool stats = c2p_stats && !floors_only;
+    if (stats && (stats_version != pmy_pack->pmesh->nghbr_version)) {
+      C2PCountTotals();
+      int nmb_alloc = std::max(nmb, pmy_pack->pmesh->nmb_maxperrank);
+      if (static_cast<int>(c2p_counts.extent(0)) < nmb_alloc) {
+        Kokkos::realloc(c2p_counts, nmb_alloc, static_cast<int>(NC2P_STATS));
       }
-      if (floors_only && excise) {
-        if (excision_flux_(m,k,j,i)) {
+      stats_version = pmy_pack->pmesh->nghbr_version;
+    }
+    auto &counts_ = c2p_counts;
+
+    // With tiered retries, the first pass solves every cell with the fast solver, and
+    // the second only the cells in which it failed, compacted into c2p_retry_list.
+    const bool tiered = (c2p_fast_iter > 0) && !floors_only;
+    if (tiered && static_cast<int>(c2p_retry_flag.extent(0)) < nmkji) {
+      Kokkos::realloc(c2p_retry_flag, nmkji);
+      Kokkos::realloc(c2p_retry_list, nmkji);
+    }
+    auto &flag_ = c2p_retry_flag;
+    auto &list_ = c2p_retry_list;
+
+    // If ptmunu is given, the stress-energy tensor is set in active cells from the final
+    // primitives, conserved variables and metric of each cell, as in DynGRMHD::SetTmunu.
+    const bool set_tmunu = (ptmunu != nullptr) && !floors_only;
+    Tmunu::Tmunu_vars tmunu_;
+    if (set_tmunu) tmunu_ = ptmunu->tmunu;
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    const int is = indcs.is, ie = indcs.ie;
+    const int js = indcs.js, je = indcs.je;
+    const int ks = indcs.ks, ke = indcs.ke;
+    int nretry = 0;
+    int count_errs = 0;
+    for (int pass = 0; pass < ((tiered)? 2 : 1); ++pass) {
+      const bool fast = tiered && (pass == 0);
+      const bool retry = (pass == 1);
+      auto ps_ = ps;
+      if (fast) {
+        ps_.GetRootSolverMutable().iterations = c2p_fast_iter;
+        ps_.defer_root_failure = true;
+      }
+      const int nerrs_ = nerrs + count_errs;
+      const int ncells = (retry)? nretry : nmkji;
+      int pass_errs = 0;
+      // FIXME(JMF): We can short-circuit the primitive solve if FOFC is already enabled
+      // due to a maximum principle violation.
+      Kokkos::parallel_reduce("pshyd_c2p",
+                              Kokkos::RangePolicy<>(TaskExecSpace(), 0, ncells),
+      KOKKOS_LAMBDA(const int &l, int &sumerrs) {
+        const int idx = (retry)? list_(l) : l;
+        int m = (idx)/nkji;
+        int k = (idx - m*nkji)/nji;
+        int j = (idx - m*nkji - k*nji)/ni;
+        int i = (idx - m*nkji - k*nji - j*ni) + il;
+        j += jl;
+        k += kl;
+
+        // Add in a short circuit where FOFC is guaranteed.
+        if (floors_only && fofc_(m, k, j, i)) {
           return;
         }
-      }
+        if (floors_only && excise) {
+          if (excision_flux_(m,k,j,i)) {
+            return;
+          }
+        }
 
-      // Extract the metric
-      Real g3d[NSPMETRIC], g3u[NSPMETRIC], detg, sdetg;
-      g3d[S11] = adm.g_dd(m, 0, 0, k, j, i);
-      g3d[S12] = adm.g_dd(m, 0, 1, k, j, i);
-      g3d[S13] = adm.g_dd(m, 0, 2, k, j, i);
-      g3d[S22] = adm.g_dd(m, 1, 1, k, j, i);
-      g3d[S23] = adm.g_dd(m, 1, 2, k, j, i);
-      g3d[S33] = adm.g_dd(m, 2, 2, k, j, i);
-      detg = Primitive::GetDeterminant(g3d);
-      sdetg = sqrt(detg);
-      Real isdetg = 1.0/sdetg;
-      adm::SpatialInv(1.0/detg,
-                  g3d[S11], g3d[S12], g3d[S13], g3d[S22], g3d[S23], g3d[S33],
-                 &g3u[S11], &g3u[S12], &g3u[S13], &g3u[S22], &g3u[S23], &g3u[S33]);
-
-      // Extract the conserved variables
-      Real cons_pt[NCONS], cons_pt_old[NCONS], prim_pt[NPRIM];
-      cons_pt[CDN] = cons_pt_old[CDN] = cons(m, IDN, k, j, i)*isdetg;
-      cons_pt[CSX] = cons_pt_old[CSX] = cons(m, IM1, k, j, i)*isdetg;
-      cons_pt[CSY] = cons_pt_old[CSY] = cons(m, IM2, k, j, i)*isdetg;
-      cons_pt[CSZ] = cons_pt_old[CSZ] = cons(m, IM3, k, j, i)*isdetg;
-      cons_pt[CTA] = cons_pt_old[CTA] = cons(m, IEN, k, j, i)*isdetg;
-      for (int n = 0; n < nscal; n++) {
-        cons_pt[CYD + n] = cons_pt_old[CYD + n] = cons(m, nhyd + n, k, j, i)*isdetg;
-      }
-      // If we're only testing the floors, we can use the CC fields.
-      Real b3u[NMAG];
-      if (floors_only) {
-        b3u[IBX] = bcc0(m, IBX, k, j, i)*isdetg;
-        b3u[IBY] = bcc0(m, IBY, k, j, i)*isdetg;
-        b3u[IBZ] = bcc0(m, IBZ, k, j, i)*isdetg;
-      } else {
-        // Otherwise we don't have the correct CC fields yet, so use
-        // the FC fields.
-        bcc0(m, IBX, k, j, i) = 0.5*(bfc.x1f(m,k,j,i) + bfc.x1f(m,k,j,i+1));
-        bcc0(m, IBY, k, j, i) = 0.5*(bfc.x2f(m,k,j,i) + bfc.x2f(m,k,j+1,i));
-        bcc0(m, IBZ, k, j, i) = 0.5*(bfc.x3f(m,k,j,i) + bfc.x3f(m,k+1,j,i));
-        b3u[IBX] = bcc0(m, IBX, k, j, i)*isdetg;
-        b3u[IBY] = bcc0(m, IBY, k, j, i)*isdetg;
-        b3u[IBZ] = bcc0(m, IBZ, k, j, i)*isdetg;
-      }
+        // Extract the metric
+        Real g3d[NSPMETRIC], g3u[NSPMETRIC], detg, sdetg;
+        g3d[S11] = adm.g_dd(m, 0, 0, k, j, i);
+        g3d[S12] = adm.g_dd(m, 0, 1, k, j, i);
+        g3d[S13] = adm.g_dd(m, 0, 2, k, j, i);
+        g3d[S22] = adm.g_dd(m, 1, 1, k, j, i);
+        g3d[S23] = adm.g_dd(m, 1, 2, k, j, i);
+        g3d[S33] = adm.g_dd(m, 2, 2, k, j, i);
+        detg = Primitive::GetDeterminant(g3d);
+        sdetg = sqrt(detg);
+        Real isdetg = 1.0/sdetg;
+        adm::SpatialInv(1.0/detg,
+                    g3d[S11], g3d[S12], g3d[S13], g3d[S22], g3d[S23], g3d[S33],
+                   &g3u[S11], &g3u[S12], &g3u[S13], &g3u[S22], &g3u[S23], &g3u[S33]);
+
+        // Extract the conserved variables
+        Real cons_pt[NCONS], cons_pt_old[NCONS], prim_pt[NPRIM];
+        cons_pt[CDN] = cons_pt_old[CDN] = cons(m, IDN, k, j, i)*isdetg;
+        cons_pt[CSX] = cons_pt_old[CSX] = cons(m, IM1, k, j, i)*isdetg;
+        cons_pt[CSY] = cons_pt_old[CSY] = cons(m, IM2, k, j, i)*isdetg;
+        cons_pt[CSZ] = cons_pt_old[CSZ] = cons(m, IM3, k, j, i)*isdetg;
+        cons_pt[CTA] = cons_pt_old[CTA] = cons(m, IEN, k, j, i)*isdetg;
+        for (int n = 0; n < nscal; n++) {
+          cons_pt[CYD + n] = cons_pt_old[CYD + n] = cons(m, nhyd + n, k, j, i)*isdetg;
+        }
+        // If we're only testing the floors, we can use the CC fields.
+        Real b3u[NMAG];
+        if (floors_only) {
+          b3u[IBX] = bcc0(m, IBX, k, j, i)*isdetg;
+          b3u[IBY] = bcc0(m, IBY, k, j, i)*isdetg;
+          b3u[IBZ] = bcc0(m, IBZ, k, j, i)*isdetg;
+        } else {
+          // Otherwise we don't have the correct CC fields yet, so use
+          // the FC fields.
+          bcc0(m, IBX, k, j, i) = 0.5*(bfc.x1f(m,k,j,i) + bfc.x1f(m,k,j,i+1));
+          bcc0(m, IBY, k, j, i) = 0.5*(bfc.x2f(m,k,j,i) + bfc.x2f(m,k,j+1,i));
+          bcc0(m, IBZ, k, j, i) = 0.5*(bfc.x3f(m,k,j,i) + bfc.x3f(m,k+1,j,i));
+          b3u[IBX] = bcc0(m, IBX, k, j, i)*isdetg;
+          b3u[IBY] = bcc0(m, IBY, k, j, i)*isdetg;
+          b3u[IBZ] = bcc0(m, IBZ, k, j, i)*isdetg;
+        }
 
-      // If we're in an excised region, set the primitives to some default value.
-      Primitive::SolverResult result;
-      if (excise) {
-        if (excision_floor_(m,k,j,i)) {
-          prim_pt[PRH] = dexcise_/mb;
-          prim_pt[PVX] = 0.0;
-          prim_pt[PVY] = 0.0;
-          prim_pt[PVZ] = 0.0;
-          prim_pt[PPR] = pexcise_;
-          for (int n = 0; n < nscal; n++) {
-            // FIXME: Particle abundances should probably be set to a
-            // default inside an excised region.
-            prim_pt[PYF + n] = cons_pt[CYD]/cons_pt[CDN];
+        // If we're in an excised region, set the primitives to some default value.
+        Primitive::SolverResult result;
+        Real mu_guess = (warm_start)? c2p_data_(m, 0, k, j, i) : 0.0;
+        if (excise) {
+          if (excision_floor_(m,k,j,i)) {
+            prim_pt[PRH] = dexcise_/mb;
+            prim_pt[PVX] = 0.0;
+            prim_pt[PVY] = 0.0;
+            prim_pt[PVZ] = 0.0;
+            prim_pt[PPR] = pexcise_;
+            for (int n = 0; n < nscal; n++) {
+              // FIXME: Particle abundances should probably be set to a
+              // default inside an excised region.
+              prim_pt[PYF + n] = cons_pt[CYD]/cons_pt[CDN];
+            }
+            prim_pt[PTM] =
+              eos_.GetTemperatureFromP(prim_pt[PRH], prim_pt[PPR], &prim_pt[PYF]);
+            result.error = Primitive::Error::SUCCESS;
+            result.iterations = 0;
+            result.cons_floor = false;
+            result.prim_floor = false;
+            result.cons_adjusted = true;
+            result.mu = 0.0;
+            ps_.PrimToCon(prim_pt, cons_pt, b3u, g3d);
+          } else {
+            result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u, mu_guess);
           }
-          prim_pt[PTM] =
-            eos_.GetTemperatureFromP(prim_pt[PRH], prim_pt[PPR], &prim_pt[PYF]);
-          result.error = Primitive::Error::SUCCESS;
-          result.iterations = 0;
-          result.cons_floor = false;
-          result.prim_floor = false;
-          result.cons_adjusted = true;
-          ps_.PrimToCon(prim_pt, cons_pt, b3u, g3d);
         } else {
-          result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u);
+          result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u, mu_guess);
         }
-      } else {
-        result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u);
-      }
-
-      if (result.error != Primitive::Error::SUCCESS && floors_only) {
-        fofc_(m,k,j,i) = true;
-      } else if (!floors_only) {
-        if (result.error != Primitive::Error::SUCCESS && (nerrs_ + sumerrs < errcap_)) {
-          // TODO(JF): put in a proper error response here.
-          sumerrs++;
-          Kokkos::printf("An error occurred during the primitive solve: %s\n"
-                 "  Location: (%d, %d, %d, %d)\n"
-                 "  Conserved vars: \n"
-                 "    D   = %.17g\n"
-                 "    Sx  = %.17g\n"
-                 "    Sy  = %.17g\n"
-                 "    Sz  = %.17g\n"
-                 "    tau = %.17g\n"
-                 "    Dye = %.17g\n"
-                 "    Bx  = %.17g\n"
-                 "    By  = %.17g\n"
-                 "    Bz  = %.17g\n"
-                 "  Metric vars: \n"
-                 "    detg = %.17g\n"
-                 "    g_dd = {%.17g, %.17g, %.17g, %.17g, %.17g, %.17g}\n"
-                 "    alp  = %.17g\n"
-                 "    beta = {%.17g, %.17g, %.17g}\n"
-                 "    psi4 = %.17g\n"
-                 "    K_dd = {%.17g, %.17g, %.17g, %.17g, %.17g, %.17g}\n",
-                 ErrorToString(result.error),
-                 m, k, j, i,
-                 cons_pt_old[CDN], cons_pt_old[CSX], cons_pt_old[CSY], cons_pt_old[CSZ],
-                 cons_pt_old[CTA], cons_pt_old[CYD], b3u[IBX], b3u[IBY], b3u[IBZ], detg,
-                 g3d[S11], g3d[S12], g3d[S13], g3d[S22], g3d[S23], g3d[S33],
-                 adm.alpha(m, k, j, i),
-                 adm.beta_u(m, 0, k, j, i),
-                 adm.beta_u(m, 1, k, j, i), adm.beta_u(m, 2, k, j, i),
-                 adm.psi4(m, k, j, i),
-                 adm.vK_dd(m, 0, 0, k, j, i), adm.vK_dd(m, 0, 1, k, j, i),
-                 adm.vK_dd(m, 0, 2, k, j, i),
-                 adm.vK_dd(m, 1, 1, k, j, i), adm.vK_dd(m, 1, 2, k, j, i),
-                 adm.vK_dd(m, 2, 2, k, j, i));
-          if (nerrs_ + sumerrs == errcap_) {
-            Kokkos::printf("%d C2P errors have been detected on rank %d."
-                   "All future C2P errors\n"
-                   "on this rank will be suppressed. Fix your code!\n",
-                   nerrs_ + sumerrs,rank);
+        if (fast) {
+          // defer cells in which the fast root solve failed to the retry list
+          bool failed = (result.error == Primitive::Error::BRACKETING_FAILED ||
+                         result.error == Primitive::Error::NO_SOLUTION);
+          flag_(idx) = (failed)? 1 : 0;
+          if (failed) {
+            return;
           }
         }
-        // Regardless of failure, we need to copy the primitives.
-        prim(m, IDN, k, j, i) = prim_pt[PRH]*mb;
-        prim(m, IVX, k, j, i) = prim_pt[PVX];
-        prim(m, IVY, k, j, i) = prim_pt[PVY];
-        prim(m, IVZ, k, j, i) = prim_pt[PVZ];
-        prim(m, IPR, k, j, i) = prim_pt[PPR];
-        for (int n = 0; n < nscal; n++) {
-          prim(m, nhyd + n, k, j, i) = prim_pt[PYF + n];
+        if (save_data) {
+          c2p_data_(m, 0, k, j, i) = result.mu;
+          c2p_data_(m, 1, k, j, i) = static_cast<Real>(result.iterations);
+        }
+        if (stats) {
+          int stat = C2PStatIndex(result);
+          if (stat >= 0) {
+            Kokkos::atomic_add(&counts_(m, stat), 1);
+          }
+          if (retry) {
+            Kokkos::atomic_add(&counts_(m, static_cast<int>(C2P_RETRIED)), 1);
+          }
         }
 
-        // If the conservative variables were floored or adjusted for consistency,
-        // we need to copy the conserved variables, too.
-        if (result.cons_floor || result.cons_adjusted) {
-          /*if (fabs((cons_pt[CDN] - cons_pt_old[CDN])/cons_pt_old[CDN]) > 1e-12) {
-            Real &x1min = size.d_view(m).x1min;
-            Real &x1max = size.d_view(m).x1max;
-            Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
-
-            Real &x2min = size.d_view(m).x2min;
-            Real &x2max = size.d_view(m).x2max;
-            Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
-
-            Real &x3min = size.d_view(m).x3min;
-            Real &x3max = size.d_view(m).x3max;
-            Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
-            bool is_ghost = (i < is) || (i > ie) ||
-                            (j < js) || (j > je) ||
-                            (k < ks) || (k > ke);
-
-            printf("Density was nontrivially adjusted on MeshBlock %d!\n"
-                   "  Grid index: (i=%d, j=%d, k=%d)\n"
-                   "  Physical position: (%g, %g, %g)\n"
-                   "  D (old): %.17g\n"
-                   "  D (new): %.17g\n"
-                   "  Ghost zone? %s\n",
-                   m, i, j, k,
-                   x1v, x2v, x3v, cons_pt_old[CDN], cons_pt[CDN],
-                   is_ghost ? "true" : "false");
-          }*/
-          cons(m, IDN, k, j, i) = cons_pt[CDN]*sdetg;
-          cons(m, IM1, k, j, i) = cons_pt[CSX]*sdetg;
-          cons(m, IM2, k, j, i) = cons_pt[CSY]*sdetg;
-          cons(m, IM3, k, j, i) = cons_pt[CSZ]*sdetg;
-          cons(m, IEN, k, j, i) = cons_pt[CTA]*sdetg;
+        if (result.error != Primitive::Error::SUCCESS && floors_only) {
+          fofc_(m,k,j,i) = true;
+        } else if (!floors_only) {
+          if (result.error != Primitive::Error::SUCCESS && (nerrs_ + sumerrs < errcap_)) {
+            // TODO(JF): put in a proper error response here.
+            sumerrs++;
+            Kokkos::printf("An error occurred during the primitive solve: %s\n"
+                   "  Location: (%d, %d, %d, %d)\n"
+                   "  Conserved vars: \n"
+                   "    D   = %.17g\n"
+                   "    Sx  = %.17g\n"
+                   "    Sy  = %.17g\n"
+                   "    Sz  = %.17g\n"
+                   "    tau = %.17g\n"
+                   "    Dye = %.17g\n"
+                   "    Bx  = %.17g\n"
+                   "    By  = %.17g\n"
+                   "    Bz  = %.17g\n"
+                   "  Metric vars: \n"
+                   "    detg = %.17g\n"
+                   "    g_dd = {%.17g, %.17g, %.17g, %.17g, %.17g, %.17g}\n"
+                   "    alp  = %.17g\n"
+                   "    beta = {%.17g, %.17g, %.17g}\n"
+                   "    psi4 = %.17g\n"
+                   "    K_dd = {%.17g, %.17g, %.17g, %.17g, %.17g, %.17g}\n",
+                   ErrorToString(result.error),
+                   m, k, j, i,
+                   cons_pt_old[CDN], cons_pt_old[CSX], cons_pt_old[CSY], cons_pt_old[CSZ],
+                   cons_pt_old[CTA], cons_pt_old[CYD], b3u[IBX], b3u[IBY], b3u[IBZ], detg,
+                   g3d[S11], g3d[S12], g3d[S13], g3d[S22], g3d[S23], g3d[S33],
+                   adm.alpha(m, k, j, i),
+                   adm.beta_u(m, 0, k, j, i),
+                   adm.beta_u(m, 1, k, j, i), adm.beta_u(m, 2, k, j, i),
+                   adm.psi4(m, k, j, i),
+                   adm.vK_dd(m, 0, 0, k, j, i), adm.vK_dd(m, 0, 1, k, j, i),
+                   adm.vK_dd(m, 0, 2, k, j, i),
+                   adm.vK_dd(m, 1, 1, k, j, i), adm.vK_dd(m, 1, 2, k, j, i),
+                   adm.vK_dd(m, 2, 2, k, j, i));
+            if (nerrs_ + sumerrs == errcap_) {
+              Kokkos::printf("%d C2P errors have been detected on rank %d."
+                     "All future C2P errors\n"
+                     "on this rank will be suppressed. Fix your code!\n",
+                     nerrs_ + sumerrs,rank);
+            }
+          }
+          // Regardless of failure, we need to copy the primitives.
+          prim(m, IDN, k, j, i) = prim_pt[PRH]*mb;
+          prim(m, IVX, k, j, i) = prim_pt[PVX];
+          prim(m, IVY, k, j, i) = prim_pt[PVY];
+          prim(m, IVZ, k, j, i) = prim_pt[PVZ];
+          prim(m, IPR, k, j, i) = prim_pt[PPR];
           for (int n = 0; n < nscal; n++) {
-            cons(m, nhyd + n, k, j, i) = cons_pt[CYD + n]*sdetg;
+            prim(m, nhyd + n, k, j, i) = prim_pt[PYF + n];
+          }
+
+          // If the conservative variables were floored or adjusted for consistency,
+          // we need to copy the conserved variables, too.
+          if (result.cons_floor || result.cons_adjusted) {
+            /*if (fabs((cons_pt[CDN] - cons_pt_old[CDN])/cons_pt_old[CDN]) > 1e-12) {
+              Real &x1min = size.d_view(m).x1min;
+              Real &x1max = size.d_view(m).x1max;
+              Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+              Real &x2min = size.d_view(m).x2min;
+              Real &x2max = size.d_view(m).x2max;
+              Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+
+              Real &x3min = size.d_view(m).x3min;
+              Real &x3max = size.d_view(m).x3max;
+              Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+              bool is_ghost = (i < is) || (i > ie) ||
+                              (j < js) || (j > je) ||
+                              (k < ks) || (k > ke);
+
+              printf("Density was nontrivially adjusted on MeshBlock %d!\n"
+                     "  Grid index: (i=%d, j=%d, k=%d)\n"
+                     "  Physical position: (%g, %g, %g)\n"
+                     "  D (old): %.17g\n"
+                     "  D (new): %.17g\n"
+                     "  Ghost zone? %s\n",
+                     m, i, j, k,
+                     x1v, x2v, x3v, cons_pt_old[CDN], cons_pt[CDN],
+                     is_ghost ? "true" : "false");
+            }*/
+            cons(m, IDN, k, j, i) = cons_pt[CDN]*sdetg;
+            cons(m, IM1, k, j, i) = cons_pt[CSX]*sdetg;
+            cons(m, IM2, k, j, i) = cons_pt[CSY]*sdetg;
+            cons(m, IM3, k, j, i) = cons_pt[CSZ]*sdetg;
+            cons(m, IEN, k, j, i) = cons_pt[CTA]*sdetg;
+            for (int n = 0; n < nscal; n++) {
+              cons(m, nhyd + n, k, j, i) = cons_pt[CYD + n]*sdetg;
+            }
+          }
+
+          if (set_tmunu && i >= is && i <= ie && j >= js && j <= je &&
+              k >= ks && k <= ke) {
+            const Real *u = (result.cons_floor || result.cons_adjusted)? cons_pt :
+                                                                         cons_pt_old;
+            const Real vu[3] = {prim_pt[PVX], prim_pt[PVY], prim_pt[PVZ]};
+            Real v_d[3], B_d[3];
+            Primitive::LowerVector(v_d, vu, g3d);
+            Primitive::LowerVector(B_d, b3u, g3d);
+            Real iW = 1.0/sqrt(1.0 + Primitive::Contract(vu, v_d));
+            Real Bv = Primitive::Contract(b3u, v_d);
+            Real bsq = (Primitive::Contract(b3u, B_d) + Bv*Bv)*(iW*iW);
+            Real ptot = prim_pt[PPR] + 0.5*bsq;
+
+            // g3d index of (a,b) with b >= a is S11, S12, S13, S22, S23, S33
+            tmunu_.E(m, k, j, i) = u[CTA] + u[CDN];
+            for (int a = 0; a < 3; ++a) {
+              tmunu_.S_d(m, a, k, j, i) = u[CSX + a];
+              for (int b = a; b < 3; ++b) {
+                tmunu_.S_dd(m, a, b, k, j, i) = u[CSX + a]*v_d[b]*iW
+                      - (B_d[a] + Bv*v_d[a])*(iW*iW)*B_d[b]
+                      + ptot*g3d[(a*(5 - a))/2 + b];
+              }
+            }
           }
         }
+      }, Kokkos::Sum<int>(pass_errs));
+      count_errs += pass_errs;
+
+      // compact cells to be retried into a list of flat (m,k,j,i) indices
+      if (fast) {
+        Kokkos::parallel_scan("pshyd_c2p_retry",
+                              Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
+        KOKKOS_LAMBDA(const int idx, int &index, const bool is_final) {
+          if (flag_(idx)) {
+            if (is_final) { list_(index) = idx; }
+            ++index;
+          }
+        }, nretry);
+        if (nretry == 0) {break;}
       }
-    }, Kokkos::Sum<int>(count_errs));
+    }
 
     if (floors_only) {
       ps.GetEOSMutable().SetPrimitiveFloorFailure(prim_failure);
@@ -526,10 +705,10 @@ class PrimitiveSolverHydro {
     Real g11 = gii - g01*beta_u[index];
 
     // Calculate the sound speed and the Alfven speed
-    Real cs = ps.GetEOS().GetSoundSpeed(prim[PRH], prim[PTM], &prim[PYF]);
+    Real P, h, cs;
+    ps.GetEOS().GetThermo(prim[PRH], prim[PTM], &prim[PYF], &P, &h, &cs);
     Real csq = cs*cs;
-    Real H = ps.GetEOS().GetBaryonMass()*prim[PRH]*
-             ps.GetEOS().GetEnthalpy(prim[PRH], prim[PTM], &prim[PYF]);
+    Real H = ps.GetEOS().GetBaryonMass()*prim[PRH]*h;
     Real vasq = bsq/(bsq + H);
     Real cmsq = csq + vasq - csq*vasq;
 
@@ -545,6 +724,47 @@ class PrimitiveSolverHydro {
     lambda_m = (a1 >= 0.0) ? (-a1 - s) / 2.0 : -2.0 * a0 / (a1 - s);
   }
 
+  // Adds the counts of outcomes of primitive solves in all MeshBlocks to c2p_totals,
+  // resets the counts, and returns the totals (all zero if c2p_stats is not set).
+  const std::vector<double>& C2PCountTotals() {
+    if (c2p_stats && stats_version >= 0) {
+      auto counts = Kokkos::create_mirror_view_and_copy(HostMemSpace(), c2p_counts);
+      for (int m = 0; m < static_cast<int>(counts.extent(0)); ++m) {
+        for (int n = 0; n < NC2P_STATS; ++n) {
+          c2p_totals[n] += static_cast<double>(counts(m, n));
+        }
+      }
+      Kokkos::deep_copy(TaskExecSpace(), c2p_counts, 0);
+    }
+    return c2p_totals;
+  }
+
+  // The category of C2PStat counted for the result of a primitive solve (or -1 if none)
+  KOKKOS_INLINE_FUNCTION
+  static int C2PStatIndex(const Primitive::SolverResult &result) {
+    switch (result.error) {
+      case Primitive::Error::SUCCESS:
+        return (result.cons_floor || result.prim_floor)? C2P_FLOORED : -1;
+      case Primitive::Error::RHO_TOO_BIG:
+        return C2P_RHO_TOO_BIG;
+      case Primitive::Error::RHO_TOO_SMALL:
+        return C2P_RHO_TOO_SMALL;
+      case Primitive::Error::NANS_IN_CONS:
+        return C2P_NANS_IN_CONS;
+      case Primitive::Error::MAG_TOO_BIG:
+        return C2P_MAG_TOO_BIG;
+      case Primitive::Error::BRACKETING_FAILED:
+        return C2P_BRACKETING_FAILED;
+      case Primitive::Error::NO_SOLUTION:
+        return C2P_NO_SOLUTION;
+      case Primitive::Error::CONS_FLOOR:
+      case Primitive::Error::PRIM_FLOOR:
+        return C2P_FLOOR_FAILED;
+      default:
+        return -1;
+    }
+  }
+
   // A function for converting PrimitiveSolver errors to strings
   KOKKOS_INLINE_FUNCTION
   static const char * ErrorToString(Primitive::Error e) {
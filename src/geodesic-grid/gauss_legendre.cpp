@@ -9,6 +9,7 @@
 #include <cmath>
 #include <iostream>
 #include <list>
+#include <vector>
 
 #include "athena.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -32,7 +33,9 @@ GaussLegendreGrid::GaussLegendreGrid(MeshBlockPack *pmy_pack, int ntheta, Real r
   cart_pos("cart_pos",1,1),
   interp_indcs("interp_indcs",1,1),
   interp_wghts("interp_wghts",1,1,1),
-  interp_vals("interp_vals",1) {
+  interp_vals("interp_vals",1),
+  interp_vals_multi("interp_vals_multi",1,1),
+  interp_vars_("interp_vars",1) {
   // reallocate and set interpolation coordinates, indices, and weights
   int &ng = pmy_pack->pmesh->mb_indcs.ng;
   nangles = 2*ntheta*ntheta;
@@ -47,6 +50,7 @@ GaussLegendreGrid::GaussLegendreGrid(MeshBlockPack *pmy_pack, int ntheta, Real r
   InitializeRadius();
   SetInterpolationIndices();
   SetInterpolationWeights();
+  interp_version_ = pmy_pack->pmesh->mesh_version;
   return;
 }
 
@@ -261,3 +265,75 @@ void GaussLegendreGrid::InterpolateToSphere(int var_ind, DvceArray5D<Real> &val)
 
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void GaussLegendreGrid::UpdateInterpolation
+//! \brief Recomputes the interpolation indices and weights only if the MeshBlocks have
+//! changed (with AMR or load balancing) since they were last set
+
+void GaussLegendreGrid::UpdateInterpolation() {
+  if (interp_version_ != pmy_pack->pmesh->mesh_version) {
+    SetInterpolationIndices();
+    SetInterpolationWeights();
+    interp_version_ = pmy_pack->pmesh->mesh_version;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void GaussLegendreGrid::InterpolateToSphere
+//! \brief interpolate variables vars of Cartesian data to surface of sphere with one
+//! kernel, and one copy to the host.  Results are stored in interp_vals_multi.
+
+void GaussLegendreGrid::InterpolateToSphere(const std::vector<int> &vars,
+                                            DvceArray5D<Real> &val) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is; int &js = indcs.js; int &ks = indcs.ks;
+  int &ng = indcs.ng;
+  int nang1 = nangles - 1;
+  int nvars = vars.size();
+
+  // reallocate containers and set list of variables
+  if (interp_vals_multi.extent_int(1) != nvars) {
+    Kokkos::realloc(interp_vals_multi,nangles,nvars);
+    Kokkos::realloc(interp_vars_,nvars);
+  }
+  for (int v=0; v<nvars; ++v) {
+    interp_vars_.h_view(v) = vars[v];
+  }
+  interp_vars_.template modify<HostMemSpace>();
+  interp_vars_.template sync<DevExeSpace>();
+
+  auto &iindcs = interp_indcs;
+  auto &iwghts = interp_wghts;
+  auto &ivals = interp_vals_multi;
+  auto &ivars = interp_vars_;
+  par_for("int2sph_multi",DevExeSpace(),0,nang1,0,nvars-1,
+  KOKKOS_LAMBDA(int n, int nv) {
+    int ii0 = iindcs.d_view(n,0);
+    int ii1 = iindcs.d_view(n,1);
+    int ii2 = iindcs.d_view(n,2);
+    int ii3 = iindcs.d_view(n,3);
+    int v = ivars.d_view(nv);
+
+    if (ii0==-1) {  // angle not on this rank
+      ivals.d_view(n,nv) = 0.0;
+    } else {
+      Real int_value = 0.0;
+      for (int i=0; i<2*ng; i++) {
+        for (int j=0; j<2*ng; j++) {
+          for (int k=0; k<2*ng; k++) {
+            Real iwght = iwghts.d_view(n,i,0)*iwghts.d_view(n,j,1)*iwghts.d_view(n,k,2);
+            int_value += iwght*val(ii0,v,ii3-(ng-k-ks)+1,ii2-(ng-j-js)+1,ii1-(ng-i-is)+1);
+          }
+        }
+      }
+      ivals.d_view(n,nv) = int_value;
+    }
+  });
+
+  // sync dual arrays
+  interp_vals_multi.template modify<DevExeSpace>();
+  interp_vals_multi.template sync<HostMemSpace>();
+
+  return;
+}
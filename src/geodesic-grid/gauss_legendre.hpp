@@ -8,6 +8,8 @@
 //! \file geodesic_grid.hpp
 //  \brief definitions for GaussLegendreGrid class
 
+#include <vector>
+
 #include "athena.hpp"
 #include "athena_tensor.hpp"
 
@@ -35,6 +37,10 @@ class GaussLegendreGrid {
 
     // interpolate scalar field to sphere
     void InterpolateToSphere(int nvars, DvceArray5D<Real> &val);
+    // interpolate several variables of val to sphere with one kernel
+    void InterpolateToSphere(const std::vector<int> &vars, DvceArray5D<Real> &val);
+    DualArray2D<Real> interp_vals_multi;  // (angle, variable) from above function
+    void UpdateInterpolation();  // reset indices/weights if MeshBlocks have changed
     DualArray2D<int> interp_indcs;   // indices of MeshBlock and zones therein for interp
     DualArray3D<Real> interp_wghts;  // weights for interpolation
 
@@ -44,5 +50,7 @@ class GaussLegendreGrid {
 
  private:
     MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
+    int interp_version_;  // Mesh::mesh_version when indices/weights were set
+    DualArray1D<int> interp_vars_;  // list of variables interpolated together
 };
 #endif // GEODESIC_GRID_GAUSS_LEGENDRE_HPP_
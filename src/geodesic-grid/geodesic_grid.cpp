@@ -8,7 +8,10 @@
 
 // C/C++ headers
 #include <float.h>
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <vector>
 
 // AthenaK headers
 #include "athena.hpp"
@@ -34,7 +37,10 @@ GeodesicGrid::GeodesicGrid(int nlev, bool rotate, bool fluxes) :
     cart_pos_mid("cart_pos_mid",1,1,1),
     polar_pos("polar_pos",1,1),
     polar_pos_mid("polar_pos_mid",1,1,1),
-    unit_flux("unit_flux",1,1,1) {
+    unit_flux("unit_flux",1,1,1),
+    hex_angles("hex_angles",1),
+    pent_angles("pent_angles",1),
+    arc_over_omega("arc_over_omega",1,1) {
   if (nlevel > 0) {  // construct geodesic mesh
     // number of angles
     nangles = 5*2*SQR(nlevel) + 2;
@@ -229,6 +235,26 @@ GeodesicGrid::GeodesicGrid(int nlev, bool rotate, bool fluxes) :
       }
     }
 
+    // group angles by number of neighbors, and store arc lengths over solid angles
+    int npent = 0;
+    for (int n=0; n<nangles; ++n) {
+      if (numn.h_view(n) == 5) {npent++;}
+    }
+    Kokkos::realloc(hex_angles, nangles-npent);
+    Kokkos::realloc(pent_angles, npent);
+    Kokkos::realloc(arc_over_omega, nangles, 6);
+    for (int n=0, nh=0, np=0; n<nangles; ++n) {
+      if (numn.h_view(n) == 5) {
+        pent_angles.h_view(np++) = n;
+      } else {
+        hex_angles.h_view(nh++) = n;
+      }
+      for (int nb=0; nb<6; ++nb) {
+        arc_over_omega.h_view(n,nb) = (nb < numn.h_view(n)) ?
+                                      arcl.h_view(n,nb)/solid_angles.h_view(n) : 0.0;
+      }
+    }
+
     // rotate geodesic mesh
     if (rotate_geo) {
       Real rotangles[2];
@@ -323,6 +349,12 @@ GeodesicGrid::GeodesicGrid(int nlev, bool rotate, bool fluxes) :
     ind_neighbors_edges.template sync<DevExeSpace>();
     arc_lengths.template modify<HostMemSpace>();
     arc_lengths.template sync<DevExeSpace>();
+    hex_angles.template modify<HostMemSpace>();
+    hex_angles.template sync<DevExeSpace>();
+    pent_angles.template modify<HostMemSpace>();
+    pent_angles.template sync<DevExeSpace>();
+    arc_over_omega.template modify<HostMemSpace>();
+    arc_over_omega.template sync<DevExeSpace>();
     solid_angles.template modify<HostMemSpace>();
     solid_angles.template sync<DevExeSpace>();
     cart_pos.template modify<HostMemSpace>();
@@ -668,3 +700,73 @@ void GeodesicGrid::GreatCircleParam(Real zeta1, Real zeta2, Real psi1, Real psi2
   apar = sqrt(SQR(atilde)+SQR(btilde));
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void GeodesicGrid::AngleOverlaps
+//! \brief find overlaps between the faces of this grid and of grid psrc (which may have a
+//! different level and orientation), for conservative remapping of intensities between
+//! the two.  The overlaps are estimated by sampling the sphere with the faces of a grid
+//! four times finer than either, each sample being assigned to the face of each grid
+//! whose center is nearest.  On return, the faces of psrc overlapping face n of this
+//! grid are index(l) for l = offset(n)...offset(n+1)-1, and frac(l) is the fraction of
+//! face n covered by each (summing to one).
+
+void GeodesicGrid::AngleOverlaps(GeodesicGrid *psrc, DualArray1D<int> &offset,
+                                 DualArray1D<int> &index, DualArray1D<Real> &frac) {
+  int nref = 4*std::max(std::max(nlevel, psrc->nlevel), 1);
+  GeodesicGrid ref(nref, false, false);
+
+  // index of face of grid g with center nearest to direction x
+  auto nearest = [](GeodesicGrid *g, const Real x[3]) {
+    int nmax = 0;
+    Real dmax = -FLT_MAX;
+    for (int n=0; n<g->nangles; ++n) {
+      Real d = x[0]*g->cart_pos.h_view(n,0) + x[1]*g->cart_pos.h_view(n,1) +
+               x[2]*g->cart_pos.h_view(n,2);
+      if (d > dmax) {
+        dmax = d;
+        nmax = n;
+      }
+    }
+    return nmax;
+  };
+
+  // accumulate solid angle of samples shared by each pair of faces
+  std::vector<std::map<int, Real>> overlaps(nangles);
+  for (int r=0; r<ref.nangles; ++r) {
+    Real x[3] = {ref.cart_pos.h_view(r,0), ref.cart_pos.h_view(r,1),
+                 ref.cart_pos.h_view(r,2)};
+    overlaps[nearest(this, x)][nearest(psrc, x)] += ref.solid_angles.h_view(r);
+  }
+
+  int nlist = 0;
+  for (int n=0; n<nangles; ++n) {
+    nlist += overlaps[n].size();
+  }
+  Kokkos::realloc(offset, nangles+1);
+  Kokkos::realloc(index, nlist);
+  Kokkos::realloc(frac, nlist);
+  int l = 0;
+  for (int n=0; n<nangles; ++n) {
+    offset.h_view(n) = l;
+    Real total = 0.0;
+    for (auto &it : overlaps[n]) {
+      total += it.second;
+    }
+    for (auto &it : overlaps[n]) {
+      index.h_view(l) = it.first;
+      frac.h_view(l) = it.second/total;
+      ++l;
+    }
+  }
+  offset.h_view(nangles) = l;
+
+  // sync dual arrays
+  offset.template modify<HostMemSpace>();
+  offset.template sync<DevExeSpace>();
+  index.template modify<HostMemSpace>();
+  index.template sync<DevExeSpace>();
+  frac.template modify<HostMemSpace>();
+  frac.template sync<DevExeSpace>();
+  return;
+}
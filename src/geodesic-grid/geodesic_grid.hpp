@@ -29,6 +29,11 @@ class GeodesicGrid {
   DualArray2D<Real> polar_pos;            // polar coordinates at face center
   DualArray3D<Real> polar_pos_mid;        // polar coordinates at face edges
   DualArray3D<Real> unit_flux;            // angular unit vectors computed at face edges
+  // angles grouped by number of neighbors, so that loops over the edges of the angles in
+  // each group have a fixed length (there are always 12 pentagons, the rest hexagons)
+  DualArray1D<int>  hex_angles;           // indices of angles with 6 neighbors
+  DualArray1D<int>  pent_angles;          // indices of angles with 5 neighbors
+  DualArray2D<Real> arc_over_omega;       // arc lengths divided by solid angle of face
 
   // functions
   void GridCartPosition(int n, Real& x, Real& y, Real& z);
@@ -42,6 +47,8 @@ class GeodesicGrid {
   void RotateGrid(Real znew, Real pnew);
   void UnitFluxDir(Real zv, Real pv, Real zf, Real pf, Real& dz, Real& dp);
   void GreatCircleParam(Real z1, Real z2, Real p1, Real p2, Real& apar, Real& psi0);
+  void AngleOverlaps(GeodesicGrid *psrc, DualArray1D<int> &offset,
+                     DualArray1D<int> &index, DualArray1D<Real> &frac);
 
  private:
   int nlevel;       // level of the geodesic mesh (==0 is 1 angle per octant for testing)
@@ -41,6 +41,7 @@ SphericalGrid::SphericalGrid(MeshBlockPack *ppack, int nlev, Real rad):
   SetInterpolationCoordinates();
   SetInterpolationIndices();
   SetInterpolationWeights();
+  interp_version_ = pmy_pack->pmesh->mesh_version;
 
   return;
 }
@@ -210,15 +211,26 @@ void SphericalGrid::SetInterpolationWeights() {
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void SphericalGrid::InterpolateToSphere
-//! \brief interpolate Cartesian data to surface of sphere
+//! \fn void SphericalGrid::UpdateInterpolation
+//! \brief The search for the MeshBlock containing each point, and the interpolation
+//! weights, only change when MeshBlocks are created/destroyed or moved between ranks by
+//! AMR and load balancing, so they are only recomputed when Mesh::mesh_version changes.
 
-void SphericalGrid::InterpolateToSphere(int nvars, DvceArray5D<Real> &val) {
-  // reinitialize interpolation indices and weights if AMR
-  if (pmy_pack->pmesh->adaptive) {
+void SphericalGrid::UpdateInterpolation() {
+  if (interp_version_ != pmy_pack->pmesh->mesh_version) {
     SetInterpolationIndices();
     SetInterpolationWeights();
+    interp_version_ = pmy_pack->pmesh->mesh_version;
   }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SphericalGrid::InterpolateToSphere
+//! \brief interpolate Cartesian data to surface of sphere
+
+void SphericalGrid::InterpolateToSphere(int nvars, DvceArray5D<Real> &val) {
+  // reinitialize interpolation indices and weights if MeshBlocks changed
+  UpdateInterpolation();
 
   // capturing variables for kernel
   auto &indcs = pmy_pack->pmesh->mb_indcs;
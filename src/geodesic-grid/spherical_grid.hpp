@@ -28,6 +28,7 @@ class SphericalGrid: public GeodesicGrid {
     DualArray2D<Real> interp_coord;  // Cartesian coordinates for grid points
     DualArray2D<Real> interp_vals;   // container for data interpolated to sphere
     void InterpolateToSphere(int nvars, DvceArray5D<Real> &val);  // interpolate to sphere
+    void UpdateInterpolation();  // reset indices/weights if MeshBlocks have changed
 
  private:
     MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
@@ -36,6 +37,7 @@ class SphericalGrid: public GeodesicGrid {
     void SetInterpolationCoordinates();  // set indexing for interpolation
     void SetInterpolationIndices();      // set indexing for interpolation
     void SetInterpolationWeights();      // set weights for interpolation
+    int interp_version_;  // Mesh::mesh_version when indices/weights were set
 };
 
 #endif // GEODESIC_GRID_SPHERICAL_GRID_HPP_
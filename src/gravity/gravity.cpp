@@ -0,0 +1,187 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file gravity.cpp
+//! \brief implementation of Gravity class constructor, tasks, and gravitational source
+//! terms.  The multigrid solver is implemented in multigrid.cpp
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "gravity.hpp"
+
+//----------------------------------------------------------------------------------------
+// constructor, parses input file and initializes data structures and parameters
+
+Gravity::Gravity(MeshBlockPack *pp, ParameterInput *pin) :
+  ncycles(0),
+  pmy_pack(pp),
+  mesh_version_(-1),
+  nmb_(0),
+  mb_lx_("mb_lx",1,1),
+  face_sbuf_("mg_sbuf",1,1,1),
+  face_rbuf_("mg_rbuf",1,1,1) {
+  Mesh *pm = pp->pmesh;
+  four_pi_G = pin->GetReal("gravity", "four_pi_G");
+  std::string cycle = pin->GetOrAddString("gravity", "cycle", "V");
+  if (cycle.compare("V") == 0) {
+    fcycle = false;
+  } else if (cycle.compare("F") == 0) {
+    fcycle = true;
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<gravity>/cycle = '" << cycle << "' not implemented. "
+              << "Valid choices are [V,F]" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  npre = pin->GetOrAddInteger("gravity", "npre", 1);
+  npost = pin->GetOrAddInteger("gravity", "npost", 1);
+  ncoarse = pin->GetOrAddInteger("gravity", "ncoarse", 20);
+  max_cycles = pin->GetOrAddInteger("gravity", "max_cycles", 10);
+  threshold = pin->GetOrAddReal("gravity", "threshold", 1.0e-6);
+
+  // only Newtonian Hydro or MHD, integrated with their own task lists
+  if ((pp->phydro == nullptr && pp->pmhd == nullptr) || pp->pionn != nullptr ||
+      pp->prad != nullptr || pp->pz4c != nullptr || pp->padm != nullptr ||
+      pp->pcoord->is_special_relativistic || pp->pcoord->is_general_relativistic) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<gravity> requires non-relativistic <hydro> or <mhd>, "
+              << "and cannot be used with ion-neutral, radiation, or z4c" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // MeshBlocks of the root grid map directly onto the root level of the hierarchy
+  if (pm->multilevel) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<gravity> multigrid solver is only implemented for "
+              << "uniform meshes (no SMR/AMR)" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_dup(MPI_COMM_WORLD, &comm_mg_);
+#endif
+  AllocateLevels();
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+Gravity::~Gravity() {
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_free(&comm_mg_);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::IncludeTasks
+//! \brief Adds the solve for the potential at the start of each stage to the
+//! "before_stagen" list, and the gravitational source terms to the "stagen" list (after
+//! the RK update, but before other source terms).  Called by MeshBlockPack::AddPhysics()
+//! after the task lists of Hydro or MHD have been assembled.
+
+void Gravity::IncludeTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
+  TaskID none(0);
+  tl["before_stagen"]->AddTask(&Gravity::SolvePotential, this, none,
+                               "Gravity::SolvePotential");
+  if (pmy_pack->phydro != nullptr) {
+    auto &id = pmy_pack->phydro->id;
+    tl["stagen"]->InsertTask(&Gravity::AddSource, this, id.rkupdt, id.srctrms,
+                             "Gravity::AddSource");
+  }
+  if (pmy_pack->pmhd != nullptr) {
+    auto &id = pmy_pack->pmhd->id;
+    tl["stagen"]->InsertTask(&Gravity::AddSource, this, id.rkupdt, id.srctrms,
+                             "Gravity::AddSource");
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Gravity::SolvePotential
+//! \brief Solves for the potential from the density at the start of the stage.  Cycles
+//! start from the potential of the previous solve, and are repeated until converged.
+
+TaskStatus Gravity::SolvePotential(Driver *pdrive, int stage) {
+  if (mesh_version_ != pmy_pack->pmesh->mesh_version || nmb_ != pmy_pack->nmb_thispack) {
+    AllocateLevels();
+  }
+  SetSource();
+
+  Real src_norm;
+  Real def_norm = DefectNorm(blk_[0], src_norm);
+  ncycles = 0;
+  while ((ncycles < max_cycles) && (def_norm > threshold*src_norm)) {
+    BlockCycle(0, fcycle);
+    def_norm = DefectNorm(blk_[0], src_norm);
+    ncycles++;
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Gravity::AddSource
+//! \brief Adds gravitational force -rho grad(phi) to the momentum, and its work
+//! -rho v.grad(phi) to the total energy (ideal EOS), using primitives at the start of
+//! the stage and centered differences of the potential.
+
+TaskStatus Gravity::AddSource(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  Real bdt = (pdrive->beta[stage-1])*(pmy_pack->pmesh->dt);
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+
+  DvceArray5D<Real> w0, u0;
+  EquationOfState *peos;
+  if (pmy_pack->phydro != nullptr) {
+    w0 = pmy_pack->phydro->w0;
+    u0 = pmy_pack->phydro->u0;
+    peos = pmy_pack->phydro->peos;
+  } else {
+    w0 = pmy_pack->pmhd->w0;
+    u0 = pmy_pack->pmhd->u0;
+    peos = pmy_pack->pmhd->peos;
+  }
+  bool is_ideal = peos->eos_data.is_ideal;
+
+  // offsets of indices of potential relative to MeshBlock indices
+  auto &lev = blk_[0];
+  int di = lev.is - is, dj = lev.js - js, dk = lev.ks - ks;
+  Real hidx1 = 0.5/lev.dx1, hidx2 = 0.5/lev.dx2, hidx3 = 0.5/lev.dx3;
+  auto phi_ = phi;
+
+  par_for("grav_src", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int pi = i + di, pj = j + dj, pk = k + dk;
+    Real g1 = (phi_(m,0,pk,pj,pi+1) - phi_(m,0,pk,pj,pi-1))*hidx1;
+    Real g2 = 0.0, g3 = 0.0;
+    if (multi_d) {g2 = (phi_(m,0,pk,pj+1,pi) - phi_(m,0,pk,pj-1,pi))*hidx2;}
+    if (three_d) {g3 = (phi_(m,0,pk+1,pj,pi) - phi_(m,0,pk-1,pj,pi))*hidx3;}
+    Real rho_bdt = w0(m,IDN,k,j,i)*bdt;
+    u0(m,IM1,k,j,i) -= rho_bdt*g1;
+    u0(m,IM2,k,j,i) -= rho_bdt*g2;
+    u0(m,IM3,k,j,i) -= rho_bdt*g3;
+    if (is_ideal) {
+      u0(m,IEN,k,j,i) -= rho_bdt*(w0(m,IVX,k,j,i)*g1 + w0(m,IVY,k,j,i)*g2 +
+                                  w0(m,IVZ,k,j,i)*g3);
+    }
+  });
+  return TaskStatus::complete;
+}
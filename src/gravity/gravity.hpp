@@ -0,0 +1,107 @@
+#ifndef GRAVITY_GRAVITY_HPP_
+#define GRAVITY_GRAVITY_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file gravity.hpp
+//! \brief Self-gravity of Hydro or MHD.  The potential phi satisfying
+//!   Laplacian(phi) = four_pi_G (rho - rho_mean)
+//! is computed at the start of each stage with a geometric multigrid solver, and the
+//! gravitational force -rho grad(phi) (and work -rho v.grad(phi)) is added as a source
+//! term after the RK update.  rho_mean is only subtracted with fully periodic boundaries;
+//! otherwise phi=0 on the faces of the domain.
+//!
+//! The multigrid hierarchy follows the MeshBlocks: each MeshBlock is coarsened by factors
+//! of two (with ghost cells exchanged between MeshBlocks at every level) until its cells
+//! can no longer be halved.  The coarsest cells of all MeshBlocks are then gathered into
+//! a single root grid on every rank, which is coarsened further and solved redundantly.
+//! V- or F-cycles (<gravity>/cycle) with red-black Gauss-Seidel smoothing are repeated
+//! until the L2 norm of the defect falls below <gravity>/threshold times that of the
+//! source.  Only uniform meshes (no SMR/AMR) are supported.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "tasklist/task_list.hpp"
+#include "mesh/mesh.hpp"
+
+class Driver;
+
+//----------------------------------------------------------------------------------------
+//! \struct MGLevel
+//! \brief data on one level of the multigrid hierarchy, with one ghost cell in each
+//! active dimension.  Arrays are dimensioned (nmb, 1, n3, n2, n1).
+
+struct MGLevel {
+  int nx1, nx2, nx3;            // number of active cells
+  int is, ie, js, je, ks, ke;   // indices of active cells
+  Real dx1, dx2, dx3;           // cell sizes
+  DvceArray5D<Real> u;          // solution (or correction on coarser levels)
+  DvceArray5D<Real> src;        // right-hand side
+  DvceArray5D<Real> def;        // defect src - Laplacian(u)
+};
+
+//----------------------------------------------------------------------------------------
+//! \class Gravity
+//! \brief data and functions for self-gravity with a multigrid Poisson solver
+
+class Gravity {
+ public:
+  Gravity(MeshBlockPack *pp, ParameterInput *pin);
+  ~Gravity();
+
+  Real four_pi_G;           // 4 pi times gravitational constant (code units)
+  bool fcycle;              // use F-cycles (otherwise V-cycles)
+  int npre, npost;          // number of pre/post smoothing sweeps on each level
+  int ncoarse;              // number of sweeps on coarsest level of root grid
+  int max_cycles;           // maximum number of cycles in each solve
+  Real threshold;           // convergence criterion on relative L2 norm of defect
+  int ncycles;              // number of cycles used in last solve
+  DvceArray5D<Real> phi;    // potential (u of finest level), indexed (m,0,k,j,i)
+
+  // functions...
+  void IncludeTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  // ...in "before_stagen" task list
+  TaskStatus SolvePotential(Driver *d, int stage);
+  // ...in "stagen" task list
+  TaskStatus AddSource(Driver *d, int stage);
+
+ private:
+  MeshBlockPack *pmy_pack;   // ptr to MeshBlockPack containing this Gravity
+  std::vector<MGLevel> blk_;   // levels of MeshBlocks, blk_[0] is the finest
+  std::vector<MGLevel> root_;  // levels of root grid, root_[0] holds coarsest MB cells
+  int mesh_version_;           // Mesh::mesh_version when levels were allocated
+  int nmb_;                    // number of MBs when levels were allocated
+  DualArray2D<int> mb_lx_;     // logical location of each MB at root level
+  HostArray5D<Real> root_host_;  // host copy of root_[0].src used to gather root grid
+  // buffers of ghost cells across the six faces of each MB, dimensioned (nmb,6,ndata)
+  DvceArray3D<Real> face_sbuf_, face_rbuf_;
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm comm_mg_;
+  std::vector<MPI_Request> sreq_, rreq_;
+#endif
+
+  // functions in multigrid.cpp
+  void AllocateLevels();
+  MGLevel NewLevel(int nmb, int nx1, int nx2, int nx3, Real dx1, Real dx2, Real dx3);
+  void SetSource();
+  void Smooth(MGLevel &lev, int nmb, int color);
+  void CalculateDefect(MGLevel &lev, int nmb);
+  Real DefectNorm(MGLevel &lev, Real &src_norm);
+  void Restrict(MGLevel &fine, MGLevel &coarse, int nmb);
+  void ProlongateAndCorrect(MGLevel &coarse, MGLevel &fine, int nmb);
+  void ExchangeGhosts(MGLevel &lev);
+  void ApplyRootBCs(MGLevel &lev);
+  void Relax(int l, bool root, int nsweeps);
+  void BlockCycle(int l, bool f);
+  void RootCycle(int l, bool f);
+  void SolveRoot(bool f);
+};
+
+#endif // GRAVITY_GRAVITY_HPP_
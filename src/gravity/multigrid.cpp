@@ -0,0 +1,592 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file multigrid.cpp
+//! \brief geometric multigrid solver for the Poisson equation of self-gravity.  All
+//! levels are stored on the device.  Levels of MeshBlocks exchange one layer of ghost
+//! cells across faces (only faces are needed by the 7-point Laplacian and the
+//! prolongation used here), while ghost cells of the root grid are set directly from the
+//! boundary conditions of the Mesh.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "gravity.hpp"
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn bool FaceCell
+//! \brief Returns indices of q-th cell adjacent to face f (0-5 = inner/outer x1,x2,x3)
+//! of a level, either the active cell (ghost=false) or ghost cell (ghost=true).  Returns
+//! false if q is beyond the number of cells on the face.
+
+KOKKOS_INLINE_FUNCTION
+bool FaceCell(int f, int q, bool ghost, int is, int ie, int js, int je, int ks, int ke,
+              int &k, int &j, int &i) {
+  int ni = ie - is + 1, nj = je - js + 1, nk = ke - ks + 1;
+  int dir = f/2;
+  bool outer = (f%2 == 1);
+  if (dir == 0) {
+    if (q >= nj*nk) return false;
+    j = js + q%nj;
+    k = ks + q/nj;
+    i = (outer) ? ((ghost) ? ie+1 : ie) : ((ghost) ? is-1 : is);
+  } else if (dir == 1) {
+    if (q >= ni*nk) return false;
+    i = is + q%ni;
+    k = ks + q/ni;
+    j = (outer) ? ((ghost) ? je+1 : je) : ((ghost) ? js-1 : js);
+  } else {
+    if (q >= ni*nj) return false;
+    i = is + q%ni;
+    j = js + q/ni;
+    k = (outer) ? ((ghost) ? ke+1 : ke) : ((ghost) ? ks-1 : ks);
+  }
+  return true;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn MGLevel Gravity::NewLevel
+//! \brief Returns a level with the given number of active cells, allocated and zeroed
+
+MGLevel Gravity::NewLevel(int nmb, int nx1, int nx2, int nx3, Real dx1, Real dx2,
+                          Real dx3) {
+  MGLevel lev;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  lev.nx1 = nx1;
+  lev.nx2 = nx2;
+  lev.nx3 = nx3;
+  lev.is = 1;  lev.ie = nx1;
+  lev.js = (multi_d) ? 1 : 0;  lev.je = (multi_d) ? nx2 : 0;
+  lev.ks = (three_d) ? 1 : 0;  lev.ke = (three_d) ? nx3 : 0;
+  lev.dx1 = dx1;
+  lev.dx2 = dx2;
+  lev.dx3 = dx3;
+  int n1 = nx1 + 2;
+  int n2 = (multi_d) ? (nx2 + 2) : 1;
+  int n3 = (three_d) ? (nx3 + 2) : 1;
+  Kokkos::realloc(lev.u, nmb, 1, n3, n2, n1);
+  Kokkos::realloc(lev.src, nmb, 1, n3, n2, n1);
+  Kokkos::realloc(lev.def, nmb, 1, n3, n2, n1);
+  Kokkos::deep_copy(TaskExecSpace(), lev.u, 0.0);
+  Kokkos::deep_copy(TaskExecSpace(), lev.src, 0.0);
+  Kokkos::deep_copy(TaskExecSpace(), lev.def, 0.0);
+  return lev;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::AllocateLevels
+//! \brief Builds the multigrid hierarchy.  MeshBlocks are coarsened while the number of
+//! cells in every active dimension is even, and the root grid (of the coarsest cells of
+//! all MeshBlocks) likewise.  Rebuilt whenever MeshBlocks are redistributed over ranks.
+
+void Gravity::AllocateLevels() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  int nmb = pmy_pack->nmb_thispack;
+  auto &size = pmy_pack->pmb->mb_size;
+
+  auto even = [&](int n1, int n2, int n3) {
+    return (n1%2 == 0) && (!(multi_d) || n2%2 == 0) && (!(three_d) || n3%2 == 0);
+  };
+
+  // levels of MeshBlocks
+  blk_.clear();
+  int n1 = indcs.nx1, n2 = indcs.nx2, n3 = indcs.nx3;
+  Real dx1 = size.h_view(0).dx1, dx2 = size.h_view(0).dx2, dx3 = size.h_view(0).dx3;
+  blk_.push_back(NewLevel(nmb, n1, n2, n3, dx1, dx2, dx3));
+  while (even(n1, n2, n3)) {
+    n1 /= 2;  dx1 *= 2.0;
+    if (multi_d) {n2 /= 2;  dx2 *= 2.0;}
+    if (three_d) {n3 /= 2;  dx3 *= 2.0;}
+    blk_.push_back(NewLevel(nmb, n1, n2, n3, dx1, dx2, dx3));
+  }
+  phi = blk_[0].u;
+
+  // levels of root grid, the finest holding the coarsest cells of all MeshBlocks
+  root_.clear();
+  n1 *= pm->nmb_rootx1;
+  n2 *= pm->nmb_rootx2;
+  n3 *= pm->nmb_rootx3;
+  root_.push_back(NewLevel(1, n1, n2, n3, dx1, dx2, dx3));
+  while (even(n1, n2, n3)) {
+    n1 /= 2;  dx1 *= 2.0;
+    if (multi_d) {n2 /= 2;  dx2 *= 2.0;}
+    if (three_d) {n3 /= 2;  dx3 *= 2.0;}
+    root_.push_back(NewLevel(1, n1, n2, n3, dx1, dx2, dx3));
+  }
+  root_host_ = Kokkos::create_mirror_view(root_[0].src);
+
+  // logical locations of MeshBlocks at the root level
+  Kokkos::realloc(mb_lx_, std::max(nmb, 1), 3);
+  for (int m=0; m<nmb; ++m) {
+    auto &lloc = pm->lloc_eachmb[pmy_pack->gids + m];
+    mb_lx_.h_view(m,0) = lloc.lx1;
+    mb_lx_.h_view(m,1) = lloc.lx2;
+    mb_lx_.h_view(m,2) = lloc.lx3;
+  }
+  mb_lx_.template modify<HostMemSpace>();
+  mb_lx_.template sync<DevExeSpace>();
+
+  // buffers for ghost cells across faces of MeshBlocks, sized for finest level
+  int nface = std::max(indcs.nx2*indcs.nx3, indcs.nx1*std::max(indcs.nx2, indcs.nx3));
+  Kokkos::realloc(face_sbuf_, std::max(nmb, 1), 6, nface);
+  Kokkos::realloc(face_rbuf_, std::max(nmb, 1), 6, nface);
+
+  mesh_version_ = pm->mesh_version;
+  nmb_ = nmb;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::SetSource
+//! \brief Sets right-hand side of the finest level from the density, subtracting the
+//! mean density with fully periodic boundaries
+
+void Gravity::SetSource() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int nmb = nmb_;
+  auto &lev = blk_[0];
+  int lis = lev.is, lie = lev.ie, ljs = lev.js, lje = lev.je, lks = lev.ks, lke = lev.ke;
+  auto w0 = (pmy_pack->phydro != nullptr) ? pmy_pack->phydro->w0 : pmy_pack->pmhd->w0;
+
+  Real rho_mean = 0.0;
+  if (pm->strictly_periodic) {
+    int nx1 = lev.nx1, nx2 = lje - ljs + 1, nx3 = lke - lks + 1;
+    const int nkji = nx3*nx2*nx1, nji = nx2*nx1;
+    Real sum = 0.0;
+    Kokkos::parallel_reduce("mg_mean",
+                            Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmb*nkji),
+    KOKKOS_LAMBDA(const int &idx, Real &sum_rho) {
+      int m = idx/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      sum_rho += w0(m,IDN,k+ks,j+js,i);
+    }, Kokkos::Sum<Real>(sum));
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &sum, 1, MPI_ATHENA_REAL, MPI_SUM, comm_mg_);
+#endif
+    rho_mean = sum/(static_cast<Real>(pm->nmb_total)*static_cast<Real>(nkji));
+  }
+
+  auto src = lev.src;
+  Real fpg = four_pi_G;
+  par_for("mg_src", DevExeSpace(), 0, nmb-1, lks, lke, ljs, lje, lis, lie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real rho = w0(m,IDN,k-lks+ks,j-ljs+js,i-lis+is);
+    src(m,0,k,j,i) = fpg*(rho - rho_mean);
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::Smooth
+//! \brief One red-black Gauss-Seidel sweep over cells of the given color
+
+void Gravity::Smooth(MGLevel &lev, int nmb, int color) {
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  Real idx1 = 1.0/(lev.dx1*lev.dx1);
+  Real idx2 = (multi_d) ? 1.0/(lev.dx2*lev.dx2) : 0.0;
+  Real idx3 = (three_d) ? 1.0/(lev.dx3*lev.dx3) : 0.0;
+  Real idiag = 1.0/(2.0*(idx1 + idx2 + idx3));
+  auto u = lev.u;
+  auto src = lev.src;
+  par_for("mg_smooth", DevExeSpace(), 0, nmb-1, lev.ks, lev.ke, lev.js, lev.je,
+          lev.is, lev.ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    if (((i + j + k) & 1) != color) return;
+    Real sum = (u(m,0,k,j,i+1) + u(m,0,k,j,i-1))*idx1 - src(m,0,k,j,i);
+    if (multi_d) {sum += (u(m,0,k,j+1,i) + u(m,0,k,j-1,i))*idx2;}
+    if (three_d) {sum += (u(m,0,k+1,j,i) + u(m,0,k-1,j,i))*idx3;}
+    u(m,0,k,j,i) = sum*idiag;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::CalculateDefect
+//! \brief Computes defect src - Laplacian(u) in active cells
+
+void Gravity::CalculateDefect(MGLevel &lev, int nmb) {
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  Real idx1 = 1.0/(lev.dx1*lev.dx1);
+  Real idx2 = (multi_d) ? 1.0/(lev.dx2*lev.dx2) : 0.0;
+  Real idx3 = (three_d) ? 1.0/(lev.dx3*lev.dx3) : 0.0;
+  auto u = lev.u;
+  auto src = lev.src;
+  auto def = lev.def;
+  par_for("mg_defect", DevExeSpace(), 0, nmb-1, lev.ks, lev.ke, lev.js, lev.je,
+          lev.is, lev.ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real uc = u(m,0,k,j,i);
+    Real lap = (u(m,0,k,j,i+1) + u(m,0,k,j,i-1) - 2.0*uc)*idx1;
+    if (multi_d) {lap += (u(m,0,k,j+1,i) + u(m,0,k,j-1,i) - 2.0*uc)*idx2;}
+    if (three_d) {lap += (u(m,0,k+1,j,i) + u(m,0,k-1,j,i) - 2.0*uc)*idx3;}
+    def(m,0,k,j,i) = src(m,0,k,j,i) - lap;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real Gravity::DefectNorm
+//! \brief Returns L2 norm of defect of a level of MeshBlocks over the whole Mesh, and
+//! the L2 norm of its source in src_norm
+
+Real Gravity::DefectNorm(MGLevel &lev, Real &src_norm) {
+  CalculateDefect(lev, nmb_);
+  int nmb = nmb_;
+  int is = lev.is, js = lev.js, ks = lev.ks;
+  int nx1 = lev.ie - lev.is + 1, nx2 = lev.je - lev.js + 1, nx3 = lev.ke - lev.ks + 1;
+  const int nkji = nx3*nx2*nx1, nji = nx2*nx1;
+  auto def = lev.def;
+  auto src = lev.src;
+  Real sums[2] = {0.0, 0.0};
+  Kokkos::parallel_reduce("mg_norm", Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmb*nkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum_def, Real &sum_src) {
+    int m = idx/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    sum_def += def(m,0,k,j,i)*def(m,0,k,j,i);
+    sum_src += src(m,0,k,j,i)*src(m,0,k,j,i);
+  }, Kokkos::Sum<Real>(sums[0]), Kokkos::Sum<Real>(sums[1]));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, sums, 2, MPI_ATHENA_REAL, MPI_SUM, comm_mg_);
+#endif
+  src_norm = std::sqrt(sums[1]);
+  return std::sqrt(sums[0]);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::Restrict
+//! \brief Sets source of coarse level to the average of the defect of the fine level
+//! over the 2, 4, or 8 fine cells, and zeros the coarse correction (and its ghost cells)
+
+void Gravity::Restrict(MGLevel &fine, MGLevel &coarse, int nmb) {
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  Real fac = (three_d) ? 0.125 : ((multi_d) ? 0.25 : 0.5);
+  int fis = fine.is, fjs = fine.js, fks = fine.ks;
+  int cis = coarse.is, cjs = coarse.js, cks = coarse.ks;
+  auto def = fine.def;
+  auto src = coarse.src;
+  Kokkos::deep_copy(TaskExecSpace(), coarse.u, 0.0);
+  par_for("mg_restrict", DevExeSpace(), 0, nmb-1, coarse.ks, coarse.ke, coarse.js,
+          coarse.je, coarse.is, coarse.ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int fi = 2*(i - cis) + fis;
+    int fj = (multi_d) ? 2*(j - cjs) + fjs : fjs;
+    int fk = (three_d) ? 2*(k - cks) + fks : fks;
+    Real sum = def(m,0,fk,fj,fi) + def(m,0,fk,fj,fi+1);
+    if (multi_d) {sum += def(m,0,fk,fj+1,fi) + def(m,0,fk,fj+1,fi+1);}
+    if (three_d) {
+      sum += def(m,0,fk+1,fj,fi) + def(m,0,fk+1,fj,fi+1) +
+             def(m,0,fk+1,fj+1,fi) + def(m,0,fk+1,fj+1,fi+1);
+    }
+    src(m,0,k,j,i) = fac*sum;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::ProlongateAndCorrect
+//! \brief Adds the coarse correction, linearly interpolated to fine cells, to the fine
+//! solution.  The interpolant only uses face neighbors of the coarse cell, so only face
+//! ghost cells of the coarse level must be valid:
+//!   u_f += u_c + (1/4) sum_d (u_c(d-neighbor toward fine cell) - u_c)
+
+void Gravity::ProlongateAndCorrect(MGLevel &coarse, MGLevel &fine, int nmb) {
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  int fis = fine.is, fjs = fine.js, fks = fine.ks;
+  int cis = coarse.is, cjs = coarse.js, cks = coarse.ks;
+  auto uc = coarse.u;
+  auto uf = fine.u;
+  par_for("mg_prolong", DevExeSpace(), 0, nmb-1, fine.ks, fine.ke, fine.js, fine.je,
+          fine.is, fine.ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int ci = (i - fis)/2 + cis;
+    int oi = ((i - fis)%2 == 0) ? -1 : 1;
+    int cj = cjs, oj = 0, ck = cks, ok = 0;
+    if (multi_d) {
+      cj = (j - fjs)/2 + cjs;
+      oj = ((j - fjs)%2 == 0) ? -1 : 1;
+    }
+    if (three_d) {
+      ck = (k - fks)/2 + cks;
+      ok = ((k - fks)%2 == 0) ? -1 : 1;
+    }
+    Real c = uc(m,0,ck,cj,ci);
+    Real corr = c + 0.25*(uc(m,0,ck,cj,ci+oi) - c);
+    if (multi_d) {corr += 0.25*(uc(m,0,ck,cj+oj,ci) - c);}
+    if (three_d) {corr += 0.25*(uc(m,0,ck+ok,cj,ci) - c);}
+    uf(m,0,k,j,i) += corr;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::ExchangeGhosts
+//! \brief Sets the face ghost cells of a level of MeshBlocks, from neighbors on this rank
+//! (directly from their send buffers), from neighbors on other ranks (with MPI), or
+//! with phi=0 on faces of the Mesh that are not periodic
+
+void Gravity::ExchangeGhosts(MGLevel &lev) {
+  int nmb = nmb_;
+  Mesh *pm = pmy_pack->pmesh;
+  int nfaces = (pm->three_d) ? 6 : ((pm->multi_d) ? 4 : 2);
+  int ni = lev.ie - lev.is + 1, nj = lev.je - lev.js + 1, nk = lev.ke - lev.ks + 1;
+  int nq = std::max(nj*nk, ni*std::max(nj, nk));   // max number of cells on a face
+  int is = lev.is, ie = lev.ie, js = lev.js, je = lev.je, ks = lev.ks, ke = lev.ke;
+  int my_rank = global_variable::my_rank;
+  int gids = pmy_pack->gids;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto u = lev.u;
+  auto sbuf = face_sbuf_;
+  auto rbuf = face_rbuf_;
+  // index of neighbor across face f in NeighborBlock arrays (see nghbr_index.hpp)
+  auto nface_index = [](int f) {return (f < 4) ? 4*f : 24 + 4*(f - 4);};
+
+#if MPI_PARALLEL_ENABLED
+  // post receives for faces with neighbors on other ranks, tagged by (m, f) of receiver
+  rreq_.clear();
+  sreq_.clear();
+  for (int m=0; m<nmb; ++m) {
+    for (int f=0; f<nfaces; ++f) {
+      auto &nb = nghbr.h_view(m, nface_index(f));
+      if (nb.gid >= 0 && nb.rank != my_rank) {
+        rreq_.push_back(MPI_REQUEST_NULL);
+        auto rptr = Kokkos::subview(rbuf, m, f, Kokkos::ALL);
+        MPI_Irecv(rptr.data(), nq, MPI_ATHENA_REAL, nb.rank, 6*m + f, comm_mg_,
+                  &(rreq_.back()));
+      }
+    }
+  }
+#endif
+
+  // pack active cells adjacent to every face
+  par_for("mg_pack", DevExeSpace(), 0, nmb-1, 0, nfaces-1, 0, nq-1,
+  KOKKOS_LAMBDA(const int m, const int f, const int q) {
+    int k, j, i;
+    if (FaceCell(f, q, false, is, ie, js, je, ks, ke, k, j, i)) {
+      sbuf(m,f,q) = u(m,0,k,j,i);
+    }
+  });
+
+#if MPI_PARALLEL_ENABLED
+  TaskExecSpace().fence();
+  for (int m=0; m<nmb; ++m) {
+    for (int f=0; f<nfaces; ++f) {
+      auto &nb = nghbr.h_view(m, nface_index(f));
+      if (nb.gid >= 0 && nb.rank != my_rank) {
+        // neighbor receives across its opposite face (f^1)
+        int lid = nb.gid - pm->gids_eachrank[nb.rank];
+        sreq_.push_back(MPI_REQUEST_NULL);
+        auto sptr = Kokkos::subview(sbuf, m, f, Kokkos::ALL);
+        MPI_Isend(sptr.data(), nq, MPI_ATHENA_REAL, nb.rank, 6*lid + (f^1), comm_mg_,
+                  &(sreq_.back()));
+      }
+    }
+  }
+  MPI_Waitall(static_cast<int>(rreq_.size()), rreq_.data(), MPI_STATUSES_IGNORE);
+#endif
+
+  // unpack ghost cells
+  auto nghbr_d = nghbr.d_view;
+  par_for("mg_unpack", DevExeSpace(), 0, nmb-1, 0, nfaces-1, 0, nq-1,
+  KOKKOS_LAMBDA(const int m, const int f, const int q) {
+    int gk, gj, gi, k, j, i;
+    if (!(FaceCell(f, q, true, is, ie, js, je, ks, ke, gk, gj, gi))) return;
+    FaceCell(f, q, false, is, ie, js, je, ks, ke, k, j, i);
+    int n = (f < 4) ? 4*f : 24 + 4*(f - 4);
+    auto nb = nghbr_d(m,n);
+    if (nb.gid < 0) {
+      u(m,0,gk,gj,gi) = -u(m,0,k,j,i);
+    } else if (nb.rank == my_rank) {
+      u(m,0,gk,gj,gi) = sbuf(nb.gid - gids, (f^1), q);
+    } else {
+      u(m,0,gk,gj,gi) = rbuf(m,f,q);
+    }
+  });
+
+#if MPI_PARALLEL_ENABLED
+  MPI_Waitall(static_cast<int>(sreq_.size()), sreq_.data(), MPI_STATUSES_IGNORE);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::ApplyRootBCs
+//! \brief Sets the face ghost cells of a level of the root grid, which spans the whole
+//! Mesh: periodic, or phi=0 on the face
+
+void Gravity::ApplyRootBCs(MGLevel &lev) {
+  Mesh *pm = pmy_pack->pmesh;
+  int nfaces = (pm->three_d) ? 6 : ((pm->multi_d) ? 4 : 2);
+  int ni = lev.ie - lev.is + 1, nj = lev.je - lev.js + 1, nk = lev.ke - lev.ks + 1;
+  int nq = std::max(nj*nk, ni*std::max(nj, nk));   // max number of cells on a face
+  int is = lev.is, ie = lev.ie, js = lev.js, je = lev.je, ks = lev.ks, ke = lev.ke;
+  bool periodic[3];
+  periodic[0] = (pm->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::periodic);
+  periodic[1] = (pm->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::periodic);
+  periodic[2] = (pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic);
+  bool per1 = periodic[0], per2 = periodic[1], per3 = periodic[2];
+  auto u = lev.u;
+  par_for("mg_rootbc", DevExeSpace(), 0, nfaces-1, 0, nq-1,
+  KOKKOS_LAMBDA(const int f, const int q) {
+    int gk, gj, gi, k, j, i;
+    if (!(FaceCell(f, q, true, is, ie, js, je, ks, ke, gk, gj, gi))) return;
+    bool per = (f < 2) ? per1 : ((f < 4) ? per2 : per3);
+    if (per) {
+      FaceCell((f^1), q, false, is, ie, js, je, ks, ke, k, j, i);
+      u(0,0,gk,gj,gi) = u(0,0,k,j,i);
+    } else {
+      FaceCell(f, q, false, is, ie, js, je, ks, ke, k, j, i);
+      u(0,0,gk,gj,gi) = -u(0,0,k,j,i);
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::Relax
+//! \brief Applies nsweeps red-black Gauss-Seidel sweeps to level l of the MeshBlocks or
+//! of the root grid, updating ghost cells after each color
+
+void Gravity::Relax(int l, bool root, int nsweeps) {
+  MGLevel &lev = (root) ? root_[l] : blk_[l];
+  int nmb = (root) ? 1 : nmb_;
+  for (int n=0; n<nsweeps; ++n) {
+    for (int color=0; color<2; ++color) {
+      Smooth(lev, nmb, color);
+      if (root) {
+        ApplyRootBCs(lev);
+      } else {
+        ExchangeGhosts(lev);
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::BlockCycle
+//! \brief V-cycle (or F-cycle) from level l of the MeshBlocks.  On the coarsest level of
+//! MeshBlocks the correction is computed on the root grid.
+
+void Gravity::BlockCycle(int l, bool f) {
+  int nlev = static_cast<int>(blk_.size());
+  if (l == nlev-1) {
+    SolveRoot(f);
+    return;
+  }
+  Relax(l, false, npre);
+  CalculateDefect(blk_[l], nmb_);
+  Restrict(blk_[l], blk_[l+1], nmb_);
+  BlockCycle(l+1, f);
+  if (f) {BlockCycle(l+1, false);}
+  ProlongateAndCorrect(blk_[l+1], blk_[l], nmb_);
+  ExchangeGhosts(blk_[l]);
+  Relax(l, false, npost);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::RootCycle
+//! \brief V-cycle (or F-cycle) from level l of the root grid.  The coarsest level is
+//! solved approximately with ncoarse sweeps.
+
+void Gravity::RootCycle(int l, bool f) {
+  int nlev = static_cast<int>(root_.size());
+  if (l == nlev-1) {
+    Relax(l, true, ncoarse);
+    return;
+  }
+  Relax(l, true, npre);
+  CalculateDefect(root_[l], 1);
+  Restrict(root_[l], root_[l+1], 1);
+  RootCycle(l+1, f);
+  if (f) {RootCycle(l+1, false);}
+  ProlongateAndCorrect(root_[l+1], root_[l], 1);
+  ApplyRootBCs(root_[l]);
+  Relax(l, true, npost);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::SolveRoot
+//! \brief Gathers the defect of the coarsest level of MeshBlocks into the root grid on
+//! every rank, solves for the correction on the root grid, and adds it to the coarsest
+//! level of MeshBlocks
+
+void Gravity::SolveRoot(bool f) {
+  int nmb = nmb_;
+  MGLevel &blk = blk_.back();
+  MGLevel &root = root_[0];
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  int bis = blk.is, bjs = blk.js, bks = blk.ks;
+  int ris = root.is, rjs = root.js, rks = root.ks;
+  int c1 = blk.nx1, c2 = blk.nx2, c3 = blk.nx3;
+  auto lx = mb_lx_.d_view;
+
+  // gather defect (each rank sets cells of its own MeshBlocks, others are zero)
+  CalculateDefect(blk, nmb);
+  Kokkos::deep_copy(TaskExecSpace(), root.src, 0.0);
+  Kokkos::deep_copy(TaskExecSpace(), root.u, 0.0);
+  auto def = blk.def;
+  auto rsrc = root.src;
+  par_for("mg_gather", DevExeSpace(), 0, nmb-1, blk.ks, blk.ke, blk.js, blk.je,
+          blk.is, blk.ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int ri = ris + lx(m,0)*c1 + (i - bis);
+    int rj = (multi_d) ? rjs + lx(m,1)*c2 + (j - bjs) : rjs;
+    int rk = (three_d) ? rks + lx(m,2)*c3 + (k - bks) : rks;
+    rsrc(0,0,rk,rj,ri) = def(m,0,k,j,i);
+  });
+#if MPI_PARALLEL_ENABLED
+  Kokkos::deep_copy(TaskExecSpace(), root_host_, root.src);
+  TaskExecSpace().fence();
+  MPI_Allreduce(MPI_IN_PLACE, root_host_.data(), static_cast<int>(root_host_.size()),
+                MPI_ATHENA_REAL, MPI_SUM, comm_mg_);
+  Kokkos::deep_copy(TaskExecSpace(), root.src, root_host_);
+#endif
+
+  // solve for correction on root grid (redundantly on every rank)
+  RootCycle(0, f);
+
+  // scatter correction to coarsest level of MeshBlocks
+  auto ub = blk.u;
+  auto ur = root.u;
+  par_for("mg_scatter", DevExeSpace(), 0, nmb-1, blk.ks, blk.ke, blk.js, blk.je,
+          blk.is, blk.ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int ri = ris + lx(m,0)*c1 + (i - bis);
+    int rj = (multi_d) ? rjs + lx(m,1)*c2 + (j - bjs) : rjs;
+    int rk = (three_d) ? rks + lx(m,2)*c3 + (k - bks) : rks;
+    ub(m,0,k,j,i) += ur(0,0,rk,rj,ri);
+  });
+  ExchangeGhosts(blk);
+  return;
+}
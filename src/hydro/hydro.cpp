@@ -13,10 +13,12 @@
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
 #include "eos/eos.hpp"
 #include "diffusion/viscosity.hpp"
 #include "diffusion/conduction.hpp"
 #include "srcterms/srcterms.hpp"
+#include "chemistry/chemistry.hpp"
 #include "shearing_box/shearing_box.hpp"
 #include "shearing_box/orbital_advection.hpp"
 #include "bvals/bvals.hpp"
@@ -31,11 +33,21 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
     u0("cons",1,1,1,1,1),
     w0("prim",1,1,1,1,1),
     coarse_u0("ccons",1,1,1,1,1),
-    coarse_w0("cprim",1,1,1,1,1),
     u1("cons1",1,1,1,1,1),
     uflx("uflx",1,1,1,1,1),
     utest("utest",1,1,1,1,1),
-    fofc("fofc",1,1,1,1) {
+    fofc("fofc",1,1,1,1),
+    fofc_list("fofc_list",1),
+    active_mbs("active_mbs",1),
+    mb_active("mb_active",1),
+    u1_slot("u1_slot",1),
+    recon_hi_mbs("recon_hi_mbs",1),
+    recon_lo_mbs("recon_lo_mbs",1),
+    mb_recon_hi("mb_recon_hi",1),
+    active_version_(-1),
+    active_nmb_(-1),
+    flux_mbs_("flux_mbs",1),
+    nmb_flux_(0) {
   // Total number of MeshBlocks on this rank to be used in array dimensioning
   int nmb = std::max((ppack->nmb_thispack), (ppack->pmesh->nmb_maxperrank));
 
@@ -90,6 +102,11 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
   // Source terms (constructor parses input file to initialize only srcterms needed)
   psrc = new SourceTerms("hydro", ppack, pin);
 
+  // Operator-split reaction network acting on passive scalars (if requested)
+  if (pin->DoesBlockExist("chemistry")) {
+    pchem = new Chemistry(ppack, pin, nscalars);
+  }
+
   // (3) read time-evolution option [already error checked in driver constructor]
   // Then initialize memory and algorithms for reconstruction and Riemann solvers
   std::string evolution_t = pin->GetString("time","evolution");
@@ -113,11 +130,12 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
     int n_ccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
     int n_ccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
     Kokkos::realloc(coarse_u0, nmb, (nhydro+nscalars), n_ccells3, n_ccells2, n_ccells1);
-    Kokkos::realloc(coarse_w0, nmb, (nhydro+nscalars), n_ccells3, n_ccells2, n_ccells1);
   }
 
   // allocate boundary buffers for conserved (cell-centered) variables
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
+  pbval_u->SetSameLevelGhosts(pin, "hydro");
+  pbval_u->SetReducedPrecision(pin, "hydro");
   pbval_u->InitializeBuffers((nhydro+nscalars));
 
   // Orbital advection and shearing box BCs (if requested in input file)
@@ -134,6 +152,55 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
     // determine if FOFC is enabled
     use_fofc = pin->GetOrAddBoolean("hydro","fofc",false);
 
+    // overlap exchange of ghost zones with computation of fluxes on interior faces
+    overlap_comm = pin->GetOrAddBoolean("hydro","overlap_comm",false);
+    if (overlap_comm && (psbox_u != nullptr)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/overlap_comm cannot be used with shearing box"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // integrate viscosity and conduction with operator-split super time-stepping.
+    // Ghost zones must be current at end of each timestep, and the STS stages do not
+    // include the orbital advection and shearing box tasks
+    if ((pin->GetOrAddString("time","sts_integrator","none").compare("none") != 0) &&
+        ((pvisc != nullptr) || (pcond != nullptr))) {
+      use_sts = true;
+      if (overlap_comm || (psbox_u != nullptr)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<time>/sts_integrator cannot be used with overlap_comm or "
+          << "shearing box" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // fuse flux calculation with RK update.  Only possible if fluxes are not needed
+    // anywhere else, i.e. with no FOFC, diffusion, or flux correction at fine/coarse
+    // boundaries
+    use_fused_update = pin->GetOrAddBoolean("hydro","fused_update",false);
+    bool excise = (pmy_pack->pcoord->is_general_relativistic &&
+                   pmy_pack->pcoord->coord_data.bh_excise);
+    if (use_fused_update &&
+        (use_fofc || overlap_comm || (pvisc != nullptr) || (pcond != nullptr) ||
+         (pmy_pack->pmesh->multilevel) || excise)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/fused_update cannot be used with FOFC, overlap_comm, "
+        << "viscosity, conduction, SMR/AMR, or BH excision" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // only the flux divergence of the standard RK update includes the area and volume
+    // factors of curvilinear coordinates
+    if ((pmy_pack->pcoord->coord_data.system != CoordSystem::cartesian) &&
+        (use_fused_update || use_fofc || (pvisc != nullptr) || (pcond != nullptr) ||
+         (psbox_u != nullptr) || (porb_u != nullptr))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<coord>/system = cylindrical or spherical_polar cannot be used "
+        << "with fused_update, FOFC, viscosity, conduction, or shearing box" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
     // select reconstruction method (default PLM)
     std::string xorder = pin->GetOrAddString("hydro","reconstruct","plm");
     if (xorder.compare("dc") == 0) {
@@ -180,6 +247,221 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
       std::exit(EXIT_FAILURE);
     }
 
+    // advect passive scalars in a separate kernel with dc or plm reconstruction
+    separate_scalars = pin->GetOrAddBoolean("hydro","separate_scalars",false);
+    scalar_recon = ReconstructionMethod::plm;
+    scalar_chunk = pin->GetOrAddInteger("hydro","scalar_chunk",8);
+    if (separate_scalars) {
+      std::string sorder = pin->GetOrAddString("hydro","scalar_reconstruct","plm");
+      if (sorder.compare("dc") == 0) {
+        scalar_recon = ReconstructionMethod::dc;
+      } else if (sorder.compare("plm") != 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro>/scalar_reconstruct = '" << sorder
+                  << "' not implemented. Valid choices are [dc,plm]." << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (scalar_chunk < 1) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/scalar_chunk must be positive" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (use_fused_update) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/separate_scalars cannot be used with fused_update"
+          << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // check that enough ghost cells are exchanged at the same level for the stencil
+    {
+      int nreq = (recon_method == ReconstructionMethod::dc)? 1 :
+                 ((recon_method == ReconstructionMethod::plm)? 2 : 3);
+      if (use_fofc) {nreq += 1;}
+      if (separate_scalars && (scalar_recon == ReconstructionMethod::plm)) {
+        nreq = std::max(nreq, 2);
+      }
+      if (pbval_u->nghost_same < nreq) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << xorder << " reconstruction requires <hydro>/nghost_exchange >= "
+          << nreq << ", but nghost_exchange=" << pbval_u->nghost_same << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // compute fluxes using tiles of primitives stored in team scratch memory.  Tile
+    // dimensions (in active cells) should be tuned to the available scratch memory.  The
+    // defaults keep the ghost cells loaded to ~2.6x the active cells of each tile with
+    // PPM in 3D (about 75 KB of scratch for the tile of five variables).
+    use_tiled_recon = pin->GetOrAddBoolean("hydro","tiled_recon",false);
+    if (use_tiled_recon) {
+      auto &indcs = pmy_pack->pmesh->mb_indcs;
+      tile_nx1 = std::min(pin->GetOrAddInteger("hydro","tile_nx1",16), indcs.nx1);
+      tile_nx2 = std::min(pin->GetOrAddInteger("hydro","tile_nx2",8), indcs.nx2);
+      tile_nx3 = std::min(pin->GetOrAddInteger("hydro","tile_nx3",4), indcs.nx3);
+      if (tile_nx1 < 1 || tile_nx2 < 1 || tile_nx3 < 1) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/tile_nx1,tile_nx2,tile_nx3 must be positive"
+          << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      size_t scr_max = Kokkos::TeamPolicy<>::scratch_size_max(0);
+      if (TiledFluxScratchSize() > scr_max) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Tiles of " << tile_nx1 << "x" << tile_nx2 << "x" << tile_nx3
+          << " cells for <hydro>/tiled_recon need " << TiledFluxScratchSize()
+          << " bytes of team scratch memory, but the device limit is " << scr_max
+          << " bytes.  Reduce <hydro>/tile_nx1, tile_nx2, or tile_nx3" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // skip MBs in which state is at floors (or completely excised) in flux, update, and
+    // C2P kernels.  MBs are rechecked at the start of every cycle.
+    sparse_blocks = pin->GetOrAddBoolean("hydro","sparse_blocks",false);
+    sparse_tol = pin->GetOrAddReal("hydro","sparse_tol",1.0e-3);
+    if (sparse_blocks && (use_fused_update || use_tiled_recon)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/sparse_blocks cannot be used with fused_update or "
+        << "tiled_recon" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    // MBs asleep for u1_release_cycles consecutive cycles release their slot in u1.  Only
+    // the RK update kernels (which loop over active MBs) may then access u1.
+    u1_release_cycles = pin->GetOrAddInteger("hydro","u1_release_cycles",0);
+    if (u1_release_cycles < 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/u1_release_cycles must be >= 0" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (u1_release_cycles > 0 &&
+        (!(sparse_blocks) || use_fofc || use_sts || pin->DoesBlockExist("ion-neutral") ||
+         pin->GetOrAddBoolean("time","task_graphs",false))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/u1_release_cycles requires sparse_blocks, and cannot "
+        << "be used with FOFC, STS, ion-neutral, or task_graphs" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // hybrid reconstruction: MBs not selected by density/gradient criteria (which work
+    // like those in <mesh_refinement>) use reconstruct_lo on interior faces.  MBs are
+    // reselected at the start of every cycle.
+    if (pin->DoesParameterExist("hydro","reconstruct_lo")) {
+      std::string xorder_lo = pin->GetString("hydro","reconstruct_lo");
+      if (xorder_lo.compare("dc") == 0) {
+        recon_lo = ReconstructionMethod::dc;
+      } else if (xorder_lo.compare("plm") == 0) {
+        recon_lo = ReconstructionMethod::plm;
+      } else {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro> reconstruct_lo = '" << xorder_lo
+                  << "' must be dc or plm" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      use_hybrid_recon = (recon_lo != recon_method);
+      hybrid_dens  = pin->GetOrAddReal("hydro","hybrid_dens",0.0);
+      hybrid_ddens = pin->GetOrAddReal("hydro","hybrid_ddens",0.0);
+      hybrid_dpres = pin->GetOrAddReal("hydro","hybrid_dpres",0.0);
+      if (use_hybrid_recon &&
+          (hybrid_dens == 0.0 && hybrid_ddens == 0.0 && hybrid_dpres == 0.0)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/reconstruct_lo requires at least one of "
+          << "hybrid_dens, hybrid_ddens, or hybrid_dpres" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (hybrid_dpres != 0.0 && !(peos->eos_data.is_ideal)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/hybrid_dpres requires an ideal gas EOS" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (use_hybrid_recon && (use_fused_update || use_tiled_recon)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/reconstruct_lo cannot be used with fused_update or "
+          << "tiled_recon" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // exchange ghost zones only every stages_per_exchange stages, trading redundant
+    // computation in deeper ghost zones for fewer messages.  Only the flux divergence is
+    // applied in the ghost zones, so all other terms that are only computed in the
+    // active zones, and communication other than same-level ghost zones, are excluded.
+    stages_per_exchange = pin->GetOrAddInteger("hydro","stages_per_exchange",1);
+    halo_depth = (recon_method == ReconstructionMethod::dc)? 1 :
+                 ((recon_method == ReconstructionMethod::plm)? 2 : 3);
+    if (separate_scalars && (scalar_recon == ReconstructionMethod::plm)) {
+      halo_depth = std::max(halo_depth, 2);
+    }
+    if (stages_per_exchange < 1) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/stages_per_exchange must be positive" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (stages_per_exchange > 1 &&
+        (use_fofc || overlap_comm || use_fused_update || use_tiled_recon ||
+         sparse_blocks || use_hybrid_recon || pmy_pack->pmesh->multilevel ||
+         (psbox_u != nullptr) || (((pvisc != nullptr) || (pcond != nullptr)) &&
+         !(use_sts)) || psrc->const_accel || psrc->ism_cooling ||
+         psrc->tab_cooling || psrc->rel_cooling ||
+         pmy_pack->pcoord->is_general_relativistic ||
+         (pbval_u->nghost_same < pmy_pack->pmesh->mb_indcs.ng))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/stages_per_exchange > 1 cannot be used with FOFC, "
+        << "overlap_comm, fused_update, tiled_recon, sparse_blocks, reconstruct_lo, "
+        << "SMR/AMR, shearing box, explicit diffusion, source terms, GR, or "
+        << "nghost_exchange < nghost" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // reduce new timestep in C2P of last stage.  Sleeping MBs are skipped by C2P.
+    use_fused_newdt = pin->GetOrAddBoolean("hydro","fused_newdt",false);
+    if (use_fused_newdt && sparse_blocks) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/fused_newdt cannot be used with sparse_blocks"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // convert to primitives in RK update kernel.  Only possible if u0 is not modified
+    // between the update and ConToPrim, i.e. with no source terms or orbital advection,
+    // and with no other physics coupled to the fluid.
+    use_fused_c2p = pin->GetOrAddBoolean("hydro","fused_c2p",false);
+    if (use_fused_c2p &&
+        (!(peos->eos_data.is_ideal) || pmy_pack->pcoord->is_special_relativistic ||
+         pmy_pack->pcoord->is_general_relativistic || use_fused_update ||
+         overlap_comm || sparse_blocks ||
+         (pmy_pack->pcoord->coord_data.system != CoordSystem::cartesian) ||
+         (porb_u != nullptr) || psrc->const_accel || psrc->ism_cooling ||
+         psrc->tab_cooling || psrc->rel_cooling || pin->DoesBlockExist("radiation") ||
+         pin->DoesBlockExist("gravity") || pin->DoesBlockExist("ion-neutral"))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/fused_c2p requires a nonrelativistic ideal gas EOS in "
+        << "Cartesian coordinates, and cannot be used with fused_update, overlap_comm, "
+        << "sparse_blocks, orbital advection, source terms, radiation, gravity, or "
+        << "ion-neutral" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // update MBs with neighbors on other ranks first and send their ghost zones before
+    // updating all other MBs.  Only the flux and RK update kernels loop over subsets of
+    // MBs, so everything else that is applied after the fluxes is excluded.
+    boundary_first = pin->GetOrAddBoolean("hydro","boundary_first",false);
+    if (boundary_first &&
+        (use_fofc || overlap_comm || use_fused_update || use_tiled_recon ||
+         sparse_blocks || use_hybrid_recon || pmy_pack->pmesh->multilevel ||
+         (psbox_u != nullptr) || (porb_u != nullptr) ||
+         (((pvisc != nullptr) || (pcond != nullptr)) && !(use_sts)) ||
+         psrc->const_accel || psrc->ism_cooling || psrc->tab_cooling ||
+         psrc->rel_cooling || pmy_pack->pcoord->is_general_relativistic)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/boundary_first cannot be used with FOFC, "
+        << "overlap_comm, fused_update, tiled_recon, sparse_blocks, reconstruct_lo, "
+        << "SMR/AMR, shearing box, orbital advection, explicit diffusion, source terms, "
+        << "or GR" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
     // select Riemann solver (no default).  Test for compatibility of options
     std::string rsolver = pin->GetString("hydro","rsolver");
     // Special relativistic dynamic solvers
@@ -266,6 +548,27 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
       }
     }
 
+    // select flux kernel compiled for this combination of RS, reconstruction, and EOS
+    flux_kernel = SelectFluxKernel(recon_method);
+    if (flux_kernel == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<hydro> rsolver = '" << rsolver << "' with "
+                << "reconstruct = '" << xorder << "' was not compiled for this EOS, "
+                << "reconfigure with Athena_FLUX_RECON and Athena_FLUX_EOS" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    update_kernel = SelectUpdateKernel();
+    if (use_hybrid_recon) {
+      flux_kernel_lo = SelectFluxKernel(recon_lo);
+      if (flux_kernel_lo == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro> rsolver = '" << rsolver << "' with "
+                  << "reconstruct_lo was not compiled for this EOS, reconfigure with "
+                  << "Athena_FLUX_RECON and Athena_FLUX_EOS" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
     // Final memory allocations
     {
       // allocate second registers, fluxes
@@ -274,15 +577,29 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
       int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
       int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
       Kokkos::realloc(u1,       nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(uflx.x1f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(uflx.x2f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(uflx.x3f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      // fluxes are never stored with fused update
+      if (!(use_fused_update)) {
+        Kokkos::realloc(uflx.x1f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+        Kokkos::realloc(uflx.x2f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+        Kokkos::realloc(uflx.x3f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      }
 
       // allocate array of flags used with FOFC
       if (use_fofc) {
         Kokkos::realloc(fofc,  nmb, ncells3, ncells2, ncells1);
         Kokkos::realloc(utest, nmb, nhydro, ncells3, ncells2, ncells1);
       }
+
+      // allocate registers used by super time-stepping
+      if (use_sts) {
+        Kokkos::realloc(u_sts0,  nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+        Kokkos::realloc(u_stsl0, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      }
+
+      // allocate register for restarting rejected steps of embedded RK pairs
+      if (Driver::EmbeddedPair(pin->GetOrAddString("time", "integrator", "rk2"))) {
+        Kokkos::realloc(u_start, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      }
     }
   }
 }
@@ -296,6 +613,7 @@ Hydro::~Hydro() {
   if (pvisc != nullptr) {delete pvisc;}
   if (pcond != nullptr) {delete pcond;}
   if (psrc != nullptr) {delete psrc;}
+  if (pchem != nullptr) {delete pchem;}
 }
 
 } // namespace hydro
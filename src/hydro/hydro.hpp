@@ -11,6 +11,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
@@ -23,6 +24,7 @@ class Coordinates;
 class Viscosity;
 class Conduction;
 class SourceTerms;
+class Chemistry;
 class OrbitalAdvectionCC;
 class ShearingBoxCC;
 class Driver;
@@ -40,6 +42,7 @@ struct HydroTaskIDs {
   TaskID irecv;
   TaskID copyu;
   TaskID flux;
+  TaskID fluxi;   // fluxes on interior faces (only with overlapped communication)
   TaskID sendf;
   TaskID recvf;
   TaskID rkupdt;
@@ -54,9 +57,29 @@ struct HydroTaskIDs {
   TaskID bcs;
   TaskID prol;
   TaskID c2p;
+  TaskID c2ps;    // ConToPrim in ghost zones (only with overlapped communication)
   TaskID newdt;
+  TaskID chem;    // operator-split reaction network (only with <chemistry> block)
   TaskID csend;
   TaskID crecv;
+  TaskID sparse;  // sets list of active MBs (only with sparse_blocks)
+  TaskID hybrid;  // selects reconstruction of each MB (only with reconstruct_lo)
+  TaskID rkupdto; // update of MBs with off-rank neighbors (only with boundary_first)
+  TaskID sendo;   // send of MBs with off-rank neighbors (only with boundary_first)
+  // tasks in super time-stepping (STS) stages
+  TaskID sts_irecv;
+  TaskID sts_flux;
+  TaskID sts_sendf;
+  TaskID sts_recvf;
+  TaskID sts_updt;
+  TaskID sts_restu;
+  TaskID sts_sendu;
+  TaskID sts_recvu;
+  TaskID sts_bcs;
+  TaskID sts_prol;
+  TaskID sts_c2p;
+  TaskID sts_csend;
+  TaskID sts_crecv;
 };
 
 namespace hydro {
@@ -80,7 +103,6 @@ class Hydro {
   DvceArray5D<Real> w0;   // primitive variables
 
   DvceArray5D<Real> coarse_u0;  // conserved variables on 2x coarser grid (for SMR/AMR)
-  DvceArray5D<Real> coarse_w0;  // primitive variables on 2x coarser grid (for SMR/AMR)
 
   // Boundary communication buffers and functions for u
   MeshBoundaryValuesCC *pbval_u;
@@ -93,55 +115,200 @@ class Hydro {
   Viscosity *pvisc = nullptr;
   Conduction *pcond = nullptr;
   SourceTerms *psrc = nullptr;
+  Chemistry *pchem = nullptr;
 
   // following only used for time-evolving flow
   DvceArray5D<Real> u1;       // conserved variables at intermediate step
-  DvceFaceFld5D<Real> uflx;   // fluxes of conserved quantities on cell faces
+  DvceFaceFld5D<FluxReal> uflx;   // fluxes of conserved quantities on cell faces
   Real dtnew;
+  Real errnew = 0.0;          // error norm of step with embedded RK pairs
+  DvceArray5D<Real> u_start;  // conserved variables at start of step (embedded RK pairs)
 
   // following used for FOFC
   DvceArray4D<bool> fofc;  // flag for each cell to indicate if FOFC is needed
   bool use_fofc = false;   // flag to enable FOFC
   DvceArray5D<Real> utest;  // scratch array for FOFC
+  DvceArray1D<int> fofc_list;  // flat (m,k,j,i) indices of cells flagged for FOFC
+
+  // exchange ghost zones at start of each stage, overlapped with interior fluxes
+  bool overlap_comm = false;
+
+  // exchange ghost zones only every stages_per_exchange stages (and at the end of each
+  // step).  Fluxes and updates in other stages are also computed redundantly in the part
+  // of the ghost zones that is still valid, see HaloExtension()
+  int stages_per_exchange = 1;
+  int halo_depth = 0;       // cells of ghost zones consumed by each stage
+
+  // update MBs with neighbors on other ranks first, and send their ghost zones while
+  // all other MBs are updated
+  bool boundary_first = false;
+
+  // compute signal speeds for the new timestep in the C2P kernel of the last stage,
+  // instead of in a separate sweep over w0 in NewTimeStep
+  bool use_fused_newdt = false;
+
+  // convert updated conserved variables to primitives in the RK update kernel (ideal
+  // gas EOS), so that ConToPrim only converts the ghost zones
+  bool use_fused_c2p = false;
+
+  // fuse computation of fluxes with RK update, so that fluxes are never stored
+  bool use_fused_update = false;
+
+  // compute fluxes using tiles of primitives stored in team scratch memory
+  bool use_tiled_recon = false;
+  int tile_nx1, tile_nx2, tile_nx3;  // dimensions of tiles in active cells
+
+  // advect passive scalars in a separate kernel after the hydro fluxes (and FOFC), using
+  // the mass fluxes and low-order reconstruction of chunks of scalar_chunk scalars, so
+  // that scratch memory of the flux kernels does not grow with the number of scalars
+  bool separate_scalars = false;
+  ReconstructionMethod scalar_recon;
+  int scalar_chunk;
+
+  // skip MBs whose state is at the floors (or that are completely excised) in flux,
+  // update, and C2P kernels, which loop over the nmb_active MBs listed in active_mbs
+  bool sparse_blocks = false;
+  Real sparse_tol;               // relative tolerance of state to floors
+  int nmb_active;                // number of active MBs in this MeshBlockPack
+  DualArray1D<int> active_mbs;   // indices of active MBs, first nmb_active are used
+  DualArray1D<int> mb_active;    // flag for each MB (1=active, 0=asleep)
+  // u1 release: MBs asleep for at least u1_release_cycles consecutive cycles are cold,
+  // and have no slot in the RK register u1, which only stores the non-cold MBs
+  int u1_release_cycles = 0;           // disabled if 0
+  int nmb_cold = 0;              // number of cold MBs in this MeshBlockPack
+  DualArray1D<int> u1_slot;      // index of each MB in u1 (-1 if cold)
+
+  // hybrid reconstruction: active MBs selected by refinement-like criteria (evaluated
+  // with HydroRefinementVote) use recon_method, all others the cheaper recon_lo on
+  // interior faces.  Faces whose stencils involve ghost zones always use recon_method, so
+  // that both MBs sharing a face compute the same flux.
+  bool use_hybrid_recon = false;
+  ReconstructionMethod recon_lo;
+  Real hybrid_dens, hybrid_ddens, hybrid_dpres;  // density max, density/pressure gradient
+  int nmb_recon_hi = 0;            // number of active MBs using recon_method
+  int nmb_recon_lo = 0;            // number of active MBs using recon_lo
+  DualArray1D<int> recon_hi_mbs;   // indices of active MBs using recon_method
+  DualArray1D<int> recon_lo_mbs;   // indices of active MBs using recon_lo
+  DualArray1D<int> mb_recon_hi;    // flag for each MB (1=recon_method, 0=recon_lo)
+
+  // integrate viscosity and conduction with super time-stepping after the explicit
+  // stages of each cycle (<time>/sts_integrator = rkl1 or rkl2)
+  bool use_sts = false;
+  DvceArray5D<Real> u_sts0;    // conserved variables at start of STS
+  DvceArray5D<Real> u_stsl0;   // dt times diffusion operator acting on u_sts0
 
   // container to hold names of TaskIDs
   HydroTaskIDs id;
 
   // functions...
   void AssembleHydroTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  void AssembleOverlappedTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  void AssembleBoundaryFirstTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  void AssembleSTSTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
   // ...in "before_stagen_tl" list
   TaskStatus InitRecv(Driver *d, int stage);
   // ...in "stagen_tl" list
   TaskStatus CopyCons(Driver *d, int stage);
   TaskStatus Fluxes(Driver *d, int stage);
+  TaskStatus FluxesInterior(Driver *d, int stage);
+  TaskStatus FluxesShell(Driver *d, int stage);
   TaskStatus SendFlux(Driver *d, int stage);
   TaskStatus RecvFlux(Driver *d, int stage);
   TaskStatus RKUpdate(Driver *d, int stage);
+  TaskStatus UpdateOffRank(Driver *d, int stage);
+  TaskStatus UpdateOnRank(Driver *d, int stage);
   TaskStatus HydroSrcTerms(Driver *d, int stage);
   TaskStatus SendU_OA(Driver *d, int stage);
   TaskStatus RecvU_OA(Driver *d, int stage);
   TaskStatus RestrictU(Driver *d, int stage);
   TaskStatus SendU(Driver *d, int stage);
+  TaskStatus SendUOffRank(Driver *d, int stage);
+  TaskStatus SendUOnRank(Driver *d, int stage);
   TaskStatus RecvU(Driver *d, int stage);
   TaskStatus SendU_Shr(Driver *d, int stage);
   TaskStatus RecvU_Shr(Driver *d, int stage);
   TaskStatus ApplyPhysicalBCs(Driver* pdrive, int stage);
   TaskStatus Prolongate(Driver* pdrive, int stage);
   TaskStatus ConToPrim(Driver *d, int stage);
+  TaskStatus ConToPrimInterior(Driver *d, int stage);
+  TaskStatus ConToPrimShell(Driver *d, int stage);
   TaskStatus NewTimeStep(Driver *d, int stage);
+  // ...in "before_timeintegrator" list
+  TaskStatus SetActiveMeshBlocks(Driver *d, int stage);
+  TaskStatus SelectReconstruction(Driver *d, int stage);
+  // ...in "after_timeintegrator" list
+  TaskStatus ChemistryStep(Driver *d, int stage);
   // ...in "after_stagen_tl" list
   TaskStatus ClearSend(Driver *d, int stage);
   TaskStatus ClearRecv(Driver *d, int stage);  // also in Driver::Initialize
+  // ...in "sts" list
+  TaskStatus STSFluxes(Driver *d, int stage);
+  TaskStatus STSUpdate(Driver *d, int stage);
+
+  // CalculateFluxes function templated over Riemann Solvers, reconstruction, EOS, and
+  // number of variables (0 for any number, otherwise nhydro+nscalars).  Kernel for the
+  // chosen combination is selected once from the flux registry.
+  template <Hydro_RSolver T, ReconstructionMethod R, bool ideal, int nvars = 0>
+  void CalculateFluxes(Driver *d, int stage, BlockRegion region);
+  using FluxKernel = void (Hydro::*)(Driver *d, int stage, BlockRegion region);
+  FluxKernel SelectFluxKernel(ReconstructionMethod recon);
+  FluxKernel flux_kernel = nullptr;
+  FluxKernel flux_kernel_lo = nullptr;  // kernel using recon_lo (hybrid reconstruction)
+
+  // flux calculation with tiles in scratch memory, also templated over Riemann Solvers
+  template <Hydro_RSolver T>
+  void CalculateFluxesTiled(Driver *d, int stage);
+  size_t TiledFluxScratchSize();
+
+  // RK update in Cartesian coordinates templated over the number of dimensions.  Kernel
+  // for the dimensionality of the Mesh is selected once in the constructor.
+  template <int ndim>
+  TaskStatus CartesianRKUpdate(Driver *d, int stage);
+  using UpdateKernel = TaskStatus (Hydro::*)(Driver *d, int stage);
+  UpdateKernel SelectUpdateKernel();
+  UpdateKernel update_kernel = nullptr;
 
-  // CalculateFluxes function templated over Riemann Solvers
+  // RK update fused with C2P (with fused_c2p)
+  TaskStatus RKUpdateC2P(Driver *d, int stage);
+
+  // RK update in cylindrical and spherical-polar coordinates
+  TaskStatus CurvilinearRKUpdate(Driver *d, int stage);
+
+  // fluxes of passive scalars from mass fluxes (with separate_scalars)
+  void CalculateScalarFluxes(Driver *d, int stage);
+
+  // fused flux calculation and RK update, also templated over Riemann Solvers
+  TaskStatus FusedRKUpdate(Driver *d, int stage);
   template <Hydro_RSolver T>
-  void CalculateFluxes(Driver *d, int stage);
+  void CalculateFusedUpdate(Driver *d, int stage);
 
   // first-order flux correction
   void FOFC(Driver *d, int stage);
 
+  // number of active MBs, resets active_mbs to all MBs if MBs in pack have changed
+  int ActiveMeshBlocks();
+  // makes all MBs active and restores slots of cold MBs in u1 (e.g. at end of run)
+  void WakeColdMeshBlocks();
+
+  // ghost zones exchanged at end of given stage, and number of ghost cells updated in it
+  bool ExchangeStage(Driver *d, int stage);
+  int HaloExtension(Driver *d, int stage);
+
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
+  int active_version_;      // Mesh::nghbr_version when active_mbs was last set
+  int active_nmb_;          // number of MBs in pack when active_mbs was last set
+  std::vector<int> nsleep_; // number of consecutive cycles each MB has been asleep
+  int nslot_hwm_ = 0;       // most slots in u1 needed in current u1_release_cycles
+  int ncycle_hwm_ = 0;      // number of cycles since u1 was last resized to nslot_hwm_
+  void SetColdMeshBlocks();
+  bool c2p_fused_ = false;  // active cells already converted by RKUpdateC2P this stage
+  DualArray1D<int> flux_mbs_;  // indices of MBs looped over by flux kernels
+  int nmb_flux_;               // number of MBs in flux_mbs_
+  TaskStatus FluxesInRegion(Driver *d, int stage, BlockRegion region);
+  DualArray1D<int> all_mbs_;   // active_mbs while it lists a subset (boundary_first)
+  TaskStatus UpdateInRegion(Driver *d, int stage, PackRegion region);
+  void ConToPrimInRegion(BlockRegion region);
 };
 
 } // namespace hydro
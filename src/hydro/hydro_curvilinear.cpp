@@ -0,0 +1,131 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hydro_curvilinear.cpp
+//! \brief Explicit RK update of Hydro conserved variables in cylindrical (R,phi,z) or
+//! spherical-polar (r,theta,phi) coordinates.  The flux divergence uses the areas and
+//! volumes of curvilinear cells, and the geometric source terms of the momenta are added
+//! in the same kernel, since they depend on the fluxes.  Following Athena++, the pressure
+//! terms are discretized with the same area factors as the flux divergence, so that a
+//! uniform pressure is in exact equilibrium, and the terms with the r- and theta-fluxes
+//! of the angular momenta are written such that angular momentum is conserved to
+//! round-off.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "coordinates/coordinates.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "coordinates/curvilinear.hpp"
+#include "hydro.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn  void Hydro::CurvilinearRKUpdate
+//  \brief Explicit RK update including flux divergence and geometric source terms
+
+TaskStatus Hydro::CurvilinearRKUpdate(Driver *pdriver, int stage) {
+  // update also extends into ghost zones in stages without exchange of ghost zones
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ext = HaloExtension(pdriver, stage);
+  int ext2 = (pmy_pack->pmesh->multi_d)? ext : 0;
+  int ext3 = (pmy_pack->pmesh->three_d)? ext : 0;
+  int is = indcs.is - ext, ie = indcs.ie + ext;
+  int js = indcs.js - ext2, je = indcs.je + ext2;
+  int ks = indcs.ks - ext3, ke = indcs.ke + ext3;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  int nmb1 = ActiveMeshBlocks() - 1;  // only update active MBs
+  auto &amb_ = active_mbs;
+  int nvar = nhydro + nscalars;
+  auto u0_ = u0;
+  auto u1_ = u1;
+  auto &u1s_ = u1_slot;  // slot of each MB in u1
+  auto w0_ = w0;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &eos = peos->eos_data;
+  const CoordSystem sys = pmy_pack->pcoord->coord_data.system;
+  const bool sph = (sys == CoordSystem::spherical_polar);
+
+  int scr_level = 0;
+  size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
+
+  par_for_outer("h_update_curv",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nvar-1,ks,ke,
+                js,je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int n, const int k,
+                const int j) {
+    const int m = amb_.d_view(ma);
+    const int s = u1s_.d_view(m);
+    ScrArray1D<Real> divf(member.team_scratch(scr_level), ncells1);
+    const MBLocations loc = LoadMBLocations(mbsize.d_view(m), indcs);
+    const Real dx2 = mbsize.d_view(m).dx2;
+    const Real dx3 = mbsize.d_view(m).dx3;
+
+    // polar factors are the same for all i
+    Real s2m, s2p, vol2;
+    PolarFactors(sys, loc.x2f(j), loc.x2f(j+1), s2m, s2p, vol2);
+    // <cot(theta)> and its angular-momentum conserving form in spherical-polar coords
+    Real src1_j = (s2p - s2m)/vol2;
+    Real src2_j = (s2p - s2m)/((s2p + s2m)*vol2);
+
+    par_for_inner(member, is, ie, [&](const int i) {
+      Real rm = loc.x1f(i), rp = loc.x1f(i+1);
+      Real a1m, a1p, vol1, b2;
+      RadialFactors(sys, rm, rp, a1m, a1p, vol1, b2);
+
+      // flux divergence.  Fluxes are summed in pairs to symmetrize round-off error
+      Real dfdx = (a1p*flx1(m,n,k,j,i+1) - a1m*flx1(m,n,k,j,i))/vol1;
+      if (multi_d) {
+        dfdx += b2*(s2p*flx2(m,n,k,j+1,i) - s2m*flx2(m,n,k,j,i))/(vol1*vol2);
+      }
+      if (three_d) {
+        // x3-face area is vol1*dphi (cylindrical) or b2*dtheta (spherical-polar)
+        Real a3 = (sph)? b2*dx2 : vol1*vol2;
+        dfdx += a3*(flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/(vol1*vol2*dx3);
+      }
+
+      // geometric source terms, <1/r> and its angular-momentum conserving form
+      if (n == IM1 || n == IM2 || (sph && n == IM3)) {
+        Real src1_i = b2/vol1;
+        Real src2_i = (rp - rm)/((rp + rm)*vol1);
+        const Real &rho = w0_(m,IDN,k,j,i);
+        Real pgas = (eos.is_ideal)? eos.IdealGasPressure(w0_(m,IEN,k,j,i)) :
+                                    rho*SQR(eos.iso_cs);
+        if (n == IM1) {
+          Real m_ii = rho*SQR(w0_(m,IVY,k,j,i)) + pgas;
+          if (sph) {m_ii += rho*SQR(w0_(m,IVZ,k,j,i)) + pgas;}
+          dfdx -= src1_i*m_ii;
+        } else if (n == IM2) {
+          dfdx += src2_i*(a1m*flx1(m,IM2,k,j,i) + a1p*flx1(m,IM2,k,j,i+1));
+          if (sph) {
+            dfdx -= src1_i*src1_j*(rho*SQR(w0_(m,IVZ,k,j,i)) + pgas);
+          }
+        } else {
+          dfdx += src2_i*(a1m*flx1(m,IM3,k,j,i) + a1p*flx1(m,IM3,k,j,i+1));
+          if (multi_d) {
+            dfdx += src1_i*src2_j*(s2m*flx2(m,IM3,k,j,i) + s2p*flx2(m,IM3,k,j+1,i));
+          }
+        }
+      }
+      divf(i) = dfdx;
+    });
+    member.team_barrier();
+
+    par_for_inner(member, is, ie, [&](const int i) {
+      u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(s,n,k,j,i) - beta_dt*divf(i);
+    });
+  });
+  return TaskStatus::complete;
+}
+} // namespace hydro
@@ -17,6 +17,7 @@
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
 #include "reconstruct/wenoz.hpp"
+#include "reconstruct/flux_registry.hpp"
 #include "hydro/rsolvers/advect_hyd.hpp"
 #include "hydro/rsolvers/llf_hyd.hpp"
 #include "hydro/rsolvers/hlle_hyd.hpp"
@@ -32,30 +33,47 @@ namespace hydro {
 //----------------------------------------------------------------------------------------
 //! \fn void Hydro::CalculateFluxes
 //! \brief Calls reconstruction and Riemann solver functions to compute hydro fluxes
-//! Note this function is templated over RS for better performance on GPUs.
-
-template <Hydro_RSolver rsolver_method_>
-void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
+//! Note this function is templated over RS, reconstruction method, and EOS (ideal or
+//! isothermal) for better performance on GPUs: the switch over reconstruction methods
+//! and the EOS branches in the RS are resolved at compile time.  When nvars_>0 it is
+//! the number of variables nhydro+nscalars, so loops over variables in reconstruction
+//! have a fixed trip count and can be unrolled.
+//! Fluxes are computed only on faces in the requested region of each MeshBlock, where
+//! interior faces are those whose reconstruction stencils do not involve ghost zones.
+
+template <Hydro_RSolver rsolver_method_, ReconstructionMethod recon_method_, bool ideal_,
+          int nvars_>
+void Hydro::CalculateFluxes(Driver *pdriver, int stage, BlockRegion region) {
   RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
   int is = indcs_.is, ie = indcs_.ie;
   int js = indcs_.js, je = indcs_.je;
   int ks = indcs_.ks, ke = indcs_.ke;
+  int ng = indcs_.ng;
   int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
+  // fluxes also computed in ghost zones in stages without exchange of ghost zones
+  int ext = HaloExtension(pdriver, stage);
+  int ext2 = (pmy_pack->pmesh->multi_d)? ext : 0;
+  int ext3 = (pmy_pack->pmesh->three_d)? ext : 0;
 
   int &nhyd_  = nhydro;
-  int nvars = nhydro + nscalars;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-  const auto recon_method_ = recon_method;
-  bool extrema = false;
-  if (recon_method == ReconstructionMethod::ppmx) {
-    extrema = true;
-  }
+  int nvars = (nvars_ > 0)? nvars_ : nhydro + ((separate_scalars)? 0 : nscalars);
+  // loop over MBs in flux_mbs_ only (all active MBs, unless using hybrid reconstruction)
+  int nmb1 = nmb_flux_ - 1;
+  auto &amb_ = flux_mbs_;
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
 
   auto &eos_ = peos->eos_data;
   auto &size_ = pmy_pack->pmb->mb_size;
   auto &coord_ = pmy_pack->pcoord->coord_data;
   auto &w0_ = w0;
 
+  // compute fluxes over all faces using tiles of primitives in scratch memory.  FOFC
+  // needs fluxes on faces outside the active zones, so is not supported with tiles.
+  if (use_tiled_recon && (region == BlockRegion::all) && !(use_fofc)) {
+    CalculateFluxesTiled<rsolver_method_>(pdriver, stage);
+    return;
+  }
+
   //--------------------------------------------------------------------------------------
   // i-direction
 
@@ -64,7 +82,7 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
   auto &flx1_ = uflx.x1f;
 
   // set the loop limits for 1D/2D/3D problems
-  int il = is, iu = ie+1, jl = js, ju = je, kl = ks, ku = ke;
+  int il = is-ext, iu = ie+1+ext, jl = js-ext2, ju = je+ext2, kl = ks-ext3, ku = ke+ext3;
   if (use_fofc) {
     il = is-1, iu = ie+2;
     if (pmy_pack->pmesh->two_d) {
@@ -74,25 +92,37 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
     }
   }
 
+  // compute fluxes on faces in requested region, possibly split into boxes
+  IndexBox fbox[6];
+  int nbox = BlockRegionBoxes(region, {il, iu, jl, ju, kl, ku},
+                              {is+ng, ie+1-ng, js, je, ks, ke}, fbox);
+  for (int b=0; b<nbox; ++b) {
+  il = fbox[b].il, iu = fbox[b].iu;
+  jl = fbox[b].jl, ju = fbox[b].ju;
+  kl = fbox[b].kl, ku = fbox[b].ku;
+  int sil = (il > is-ext)? il : is-ext;  // limits for scalars
+  int siu = (iu < ie+1+ext)? iu : ie+1+ext;
   par_for_outer("hflux_x1",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku, jl, ju,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+  KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int k, const int j) {
+    const int m = amb_.d_view(ma);
     ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
     ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
 
     // Reconstruct qR[i] and qL[i+1]
     switch (recon_method_) {
       case ReconstructionMethod::dc:
-        DonorCellX1(member, m, k, j, il-1, iu, w0_, wl, wr);
+        DonorCellX1<nvars_>(member, m, k, j, il-1, iu, w0_, wl, wr);
         break;
       case ReconstructionMethod::plm:
-        PiecewiseLinearX1(member, m, k, j, il-1, iu, w0_, wl, wr);
+        PiecewiseLinearX1<nvars_>(member, m, k, j, il-1, iu, w0_, wl, wr);
         break;
       case ReconstructionMethod::ppm4:
       case ReconstructionMethod::ppmx:
-        PiecewiseParabolicX1(member,eos_,extrema,true, m, k, j, il-1, iu, w0_, wl, wr);
+        PiecewiseParabolicX1<nvars_>(member,eos_,extrema,true, m, k, j, il-1, iu, w0_,
+                                     wl, wr);
         break;
       case ReconstructionMethod::wenoz:
-        WENOZX1(member, eos_, true, m, k, j, il-1, iu, w0_, wl, wr);
+        WENOZX1<nvars_>(member, eos_, true, m, k, j, il-1, iu, w0_, wl, wr);
         break;
       default:
         break;
@@ -103,6 +133,7 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
     // compute fluxes over [is,ie+1]
     // NOTE(@pdmullen): Capture variables prior to if constexpr.  Required for cuda 11.6+.
     auto eos = eos_;
+    eos.is_ideal = ideal_;
     auto indcs = indcs_;
     auto size = size_;
     auto coord = coord_;
@@ -133,7 +164,7 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
     // calculate fluxes of scalars (if any)
     if (nvars > nhyd_) {
       for (int n=nhyd_; n<nvars; ++n) {
-        par_for_inner(member, is, ie+1, [&](const int i) {
+        par_for_inner(member, sil, siu, [&](const int i) {
           if (flx1_(m,IDN,k,j,i) >= 0.0) {
             flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wl(n,i);
           } else {
@@ -143,6 +174,7 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
       }
     }
   });
+  } // end loop over boxes
 
   //--------------------------------------------------------------------------------------
   // j-direction
@@ -152,7 +184,7 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
     auto &flx2_ = uflx.x2f;
 
     // set the loop limits for 1D/2D/3D problems
-    il = is, iu = ie, jl = js-1, ju = je+1, kl = ks, ku = ke;
+    il = is-ext, iu = ie+ext, jl = js-1-ext, ju = je+1+ext, kl = ks-ext3, ku = ke+ext3;
     if (use_fofc) {
       jl = js-2, ju = je+2;
       if (pmy_pack->pmesh->two_d) {
@@ -162,8 +194,18 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
       }
     }
 
+    // compute fluxes on faces in requested region, possibly split into boxes
+    int nbox = BlockRegionBoxes(region, {il, iu, jl+1, ju, kl, ku},
+                                {is, ie, js+ng, je+1-ng, ks, ke}, fbox);
+    for (int b=0; b<nbox; ++b) {
+    il = fbox[b].il, iu = fbox[b].iu;
+    jl = fbox[b].jl-1, ju = fbox[b].ju;  // loop over j starts at jl-1
+    kl = fbox[b].kl, ku = fbox[b].ku;
+    int sil = (il > is-ext)? il : is-ext;  // limits for scalars
+    int siu = (iu < ie+ext)? iu : ie+ext;
     par_for_outer("hflux_x2",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+    KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int k) {
+      const int m = amb_.d_view(ma);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -181,17 +223,18 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         // Reconstruct qR[j] and qL[j+1]
         switch (recon_method_) {
           case ReconstructionMethod::dc:
-            DonorCellX2(member, m, k, j, il, iu, w0_, wl_jp1, wr);
+            DonorCellX2<nvars_>(member, m, k, j, il, iu, w0_, wl_jp1, wr);
             break;
           case ReconstructionMethod::plm:
-            PiecewiseLinearX2(member, m, k, j, il, iu, w0_, wl_jp1, wr);
+            PiecewiseLinearX2<nvars_>(member, m, k, j, il, iu, w0_, wl_jp1, wr);
             break;
           case ReconstructionMethod::ppm4:
           case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX2(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_jp1, wr);
+            PiecewiseParabolicX2<nvars_>(member,eos_,extrema,true,m,k,j,il,iu, w0_,
+                                         wl_jp1, wr);
             break;
           case ReconstructionMethod::wenoz:
-            WENOZX2(member, eos_, true, m, k, j, il, iu, w0_, wl_jp1, wr);
+            WENOZX2<nvars_>(member, eos_, true, m, k, j, il, iu, w0_, wl_jp1, wr);
             break;
           default:
             break;
@@ -202,6 +245,7 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         if (j>jl) {
           // NOTE(@pdmullen): Capture variables prior to if constexpr.
           auto eos = eos_;
+          eos.is_ideal = ideal_;
           auto indcs = indcs_;
           auto size = size_;
           auto coord = coord_;
@@ -231,9 +275,9 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         }
 
         // calculate fluxes of scalars (if any)
-        if (nvars > nhyd_) {
+        if ((nvars > nhyd_) && (j>jl)) {
           for (int n=nhyd_; n<nvars; ++n) {
-            par_for_inner(member, is, ie, [&](const int i) {
+            par_for_inner(member, sil, siu, [&](const int i) {
               if (flx2_(m,IDN,k,j,i) >= 0.0) {
                 flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wl(n,i);
               } else {
@@ -244,6 +288,7 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         }
       } // end of loop over j
     });
+    } // end loop over boxes
   }
 
   //--------------------------------------------------------------------------------------
@@ -254,11 +299,21 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
     auto &flx3_ = uflx.x3f;
 
     // set the loop limits
-    il = is, iu = ie, jl = js, ju = je, kl = ks-1, ku = ke+1;
+    il = is-ext, iu = ie+ext, jl = js-ext, ju = je+ext, kl = ks-1-ext, ku = ke+1+ext;
     if (use_fofc) { il = is-1, iu = ie+1, jl = js-1, ju = je+1, kl = ks-2, ku = ke+2; }
 
+    // compute fluxes on faces in requested region, possibly split into boxes
+    int nbox = BlockRegionBoxes(region, {il, iu, jl, ju, kl+1, ku},
+                                {is, ie, js, je, ks+ng, ke+1-ng}, fbox);
+    for (int b=0; b<nbox; ++b) {
+    il = fbox[b].il, iu = fbox[b].iu;
+    jl = fbox[b].jl, ju = fbox[b].ju;
+    kl = fbox[b].kl-1, ku = fbox[b].ku;  // loop over k starts at kl-1
+    int sil = (il > is-ext)? il : is-ext;  // limits for scalars
+    int siu = (iu < ie+ext)? iu : ie+ext;
     par_for_outer("hflux_x3",DevExeSpace(), scr_size, scr_level, 0, nmb1, jl, ju,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int j) {
+    KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int j) {
+      const int m = amb_.d_view(ma);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -276,17 +331,18 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         // Reconstruct qR[k] and qL[k+1]
         switch (recon_method_) {
           case ReconstructionMethod::dc:
-            DonorCellX3(member, m, k, j, il, iu, w0_, wl_kp1, wr);
+            DonorCellX3<nvars_>(member, m, k, j, il, iu, w0_, wl_kp1, wr);
             break;
           case ReconstructionMethod::plm:
-            PiecewiseLinearX3(member, m, k, j, il, iu, w0_, wl_kp1, wr);
+            PiecewiseLinearX3<nvars_>(member, m, k, j, il, iu, w0_, wl_kp1, wr);
             break;
           case ReconstructionMethod::ppm4:
           case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX3(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_kp1, wr);
+            PiecewiseParabolicX3<nvars_>(member,eos_,extrema,true,m,k,j,il,iu, w0_,
+                                         wl_kp1, wr);
             break;
           case ReconstructionMethod::wenoz:
-            WENOZX3(member, eos_, true, m, k, j, il, iu, w0_, wl_kp1, wr);
+            WENOZX3<nvars_>(member, eos_, true, m, k, j, il, iu, w0_, wl_kp1, wr);
             break;
           default:
             break;
@@ -297,6 +353,7 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         if (k>kl) {
           // NOTE(@pdmullen): Capture variables prior to if constexpr.
           auto eos = eos_;
+          eos.is_ideal = ideal_;
           auto indcs = indcs_;
           auto size = size_;
           auto coord = coord_;
@@ -326,9 +383,9 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         }
 
         // calculate fluxes of scalars (if any)
-        if (nvars > nhyd_) {
+        if ((nvars > nhyd_) && (k>kl)) {
           for (int n=nhyd_; n<nvars; ++n) {
-            par_for_inner(member, is, ie, [&](const int i) {
+            par_for_inner(member, sil, siu, [&](const int i) {
               if (flx3_(m,IDN,k,j,i) >= 0.0) {
                 flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wl(n,i);
               } else {
@@ -339,21 +396,50 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         }
       } // end loop over k
     });
+    } // end loop over boxes
   }
 
   return;
 }
 
-// function definitions for each template parameter
-template void Hydro::CalculateFluxes<Hydro_RSolver::advect>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::llf>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hlle>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hllc>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::roe>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::llf_sr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hlle_sr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hllc_sr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::llf_gr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hlle_gr>(Driver *pdriver, int stage);
+//----------------------------------------------------------------------------------------
+//! \fn Hydro::FluxKernel Hydro::SelectFluxKernel
+//! \brief Returns the CalculateFluxes kernel for the Riemann solver and EOS of this
+//! Hydro with the given reconstruction method, or nullptr if that combination was not
+//! compiled.
+//! Kernels specialized for the number of variables are used when one is compiled, the
+//! generic kernel otherwise.
+//! Expanding this table also instantiates every kernel that is compiled.
+
+#define HYDRO_FLUX_KERNEL_NV(RS, EOS, RC, NV)                                   \
+  if (rsolver_method == RS && recon == RC && ideal == EOS && nvars == NV) {     \
+    return &Hydro::CalculateFluxes<RS, RC, EOS, NV>;                            \
+  }
+#define HYDRO_FLUX_KERNEL(RS, EOS, RC)                                  \
+  FLUX_FOR_EACH_NVARS(HYDRO_FLUX_KERNEL_NV, RS, EOS, RC)                \
+  if (rsolver_method == RS && recon == RC && ideal == EOS) {            \
+    return &Hydro::CalculateFluxes<RS, RC, EOS, 0>;                     \
+  }
+
+Hydro::FluxKernel Hydro::SelectFluxKernel(ReconstructionMethod recon) {
+  // only these RS depend on the EOS, all others are compiled once (with ideal=true)
+  bool ideal = true;
+  if (rsolver_method == Hydro_RSolver::llf || rsolver_method == Hydro_RSolver::hlle ||
+      rsolver_method == Hydro_RSolver::roe) {
+    ideal = peos->eos_data.is_ideal;
+  }
+  int nvars = nhydro + ((separate_scalars)? 0 : nscalars);
+  FLUX_FOR_EACH_RECON(HYDRO_FLUX_KERNEL, Hydro_RSolver::advect, true)
+  FLUX_FOR_EACH_EOS(FLUX_FOR_EACH_RECON, HYDRO_FLUX_KERNEL, Hydro_RSolver::llf)
+  FLUX_FOR_EACH_EOS(FLUX_FOR_EACH_RECON, HYDRO_FLUX_KERNEL, Hydro_RSolver::hlle)
+  FLUX_FOR_EACH_EOS(FLUX_FOR_EACH_RECON, HYDRO_FLUX_KERNEL, Hydro_RSolver::roe)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, HYDRO_FLUX_KERNEL, Hydro_RSolver::hllc)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, HYDRO_FLUX_KERNEL, Hydro_RSolver::llf_sr)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, HYDRO_FLUX_KERNEL, Hydro_RSolver::hlle_sr)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, HYDRO_FLUX_KERNEL, Hydro_RSolver::hllc_sr)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, HYDRO_FLUX_KERNEL, Hydro_RSolver::llf_gr)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, HYDRO_FLUX_KERNEL, Hydro_RSolver::hlle_gr)
+  return nullptr;
+}
 
 } // namespace hydro
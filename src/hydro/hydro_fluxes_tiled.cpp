@@ -0,0 +1,204 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hydro_fluxes_tiled.cpp
+//! \brief Calculate 3D fluxes for hydro using tiles of primitives stored in team scratch
+//! memory.  Each team loads a brick of primitives (including the cells needed by the
+//! reconstruction stencil) once, and then reconstructs in all three directions from it.
+//! This avoids reading the neighbours of each cell from global memory in every
+//! direction, which is most important for the wide stencils of PPM and WENOZ.  Only the
+//! ghost cells along each direction are loaded (a ScrStarTile), since reconstruction
+//! never reads the edge and corner ghost cells of the tile.  The shape of the tiles is
+//! set by <hydro>/tile_nx1,tile_nx2,tile_nx3, and should be tuned for each architecture
+//! within the limit of available scratch memory.
+
+#include <iostream>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
+#include "hydro.hpp"
+#include "eos/eos.hpp"
+#include "reconstruct/reconstruct.hpp"
+#include "reconstruct/scratch_tile.hpp"
+#include "hydro/rsolvers/hydro_rsolver.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn size_t Hydro::TiledFluxScratchSize
+//! \brief Returns size of team scratch memory (in bytes) needed by CalculateFluxesTiled
+
+size_t Hydro::TiledFluxScratchSize() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int nvars = nhydro + ((separate_scalars)? 0 : nscalars);
+  int gj = (pmy_pack->pmesh->multi_d)? indcs.ng : 0;
+  int gk = (pmy_pack->pmesh->three_d)? indcs.ng : 0;
+  return ScrStarTile::shmem_size(nvars, tile_nx3, tile_nx2, tile_nx1, gk, gj, indcs.ng) +
+         ScrArray2D<Real>::shmem_size(nvars, ncells1) * 3;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateFluxesTiled
+//! \brief Calls reconstruction and Riemann solver functions to compute hydro fluxes
+//! over all faces of each MeshBlock, with one team per tile.  Each tile computes fluxes
+//! on faces at the lower boundary and interior of the tile, plus the faces at the upper
+//! boundary of the MeshBlock.  Fluxes are identical to those from CalculateFluxes().
+
+template <Hydro_RSolver rsolver_method_>
+void Hydro::CalculateFluxesTiled(Driver *pdriver, int stage) {
+  RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
+  int is = indcs_.is, ie = indcs_.ie;
+  int js = indcs_.js, je = indcs_.je;
+  int ks = indcs_.ks, ke = indcs_.ke;
+  int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  int nhyd_  = nhydro;
+  int nvars = nhydro + ((separate_scalars)? 0 : nscalars);
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  const auto recon_method_ = recon_method;
+  bool extrema = false;
+  if (recon_method == ReconstructionMethod::ppmx) {
+    extrema = true;
+  }
+
+  auto &eos_ = peos->eos_data;
+  auto &size_ = pmy_pack->pmb->mb_size;
+  auto &coord_ = pmy_pack->pcoord->coord_data;
+  auto &w0_ = w0;
+  auto &flx1_ = uflx.x1f;
+  auto &flx2_ = uflx.x2f;
+  auto &flx3_ = uflx.x3f;
+
+  // dimensions of tiles (in active cells) and number of tiles in each direction
+  int tni = tile_nx1, tnj = tile_nx2, tnk = tile_nx3;
+  int nti = (indcs_.nx1 + tni - 1)/tni;
+  int ntj = (indcs_.nx2 + tnj - 1)/tnj;
+  int ntk = (indcs_.nx3 + tnk - 1)/tnk;
+  // number of ghost cells loaded on each side of tile
+  int gi = indcs_.ng;
+  int gj = (multi_d)? indcs_.ng : 0;
+  int gk = (three_d)? indcs_.ng : 0;
+  int tile_size = nvars*ScrStarTile::VarSize(tnk, tnj, tni, gk, gj, gi);
+
+  size_t scr_size = TiledFluxScratchSize();
+  int scr_level = 0;
+  par_for_outer("hflux_tiled",DevExeSpace(), scr_size, scr_level, 0, nmb1, 0, ntk-1,
+                0, ntj-1, 0, nti-1,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int tk, const int tj,
+                const int ti) {
+    // active cells in this tile
+    int kl = ks + tk*tnk, ku = (kl + tnk - 1 < ke)? (kl + tnk - 1) : ke;
+    int jl = js + tj*tnj, ju = (jl + tnj - 1 < je)? (jl + tnj - 1) : je;
+    int il = is + ti*tni, iu = (il + tni - 1 < ie)? (il + tni - 1) : ie;
+
+    // load primitives in tile (plus ghost cells) into scratch
+    ScrStarTile w;
+    w.q = ScrArray1D<Real>(member.team_scratch(scr_level), tile_size);
+    w.nvar = nvars;
+    w.nk = ku - kl + 1;
+    w.nj = ju - jl + 1;
+    w.ni = iu - il + 1;
+    w.gk = gk;
+    w.gj = gj;
+    w.gi = gi;
+    w.k0 = kl;
+    w.j0 = jl;
+    w.i0 = il;
+    w.Load(member, w0_, m);
+
+    ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
+    // NOTE(@pdmullen): Capture variables prior to if constexpr.  Required for cuda 11.6+.
+    auto eos = eos_;
+    auto indcs = indcs_;
+    auto size = size_;
+    auto coord = coord_;
+    auto flx1 = flx1_;
+    auto flx2 = flx2_;
+    auto flx3 = flx3_;
+
+    // i-direction: fluxes over [il,iu] plus face ie+1 in last tile
+    int ifu = (iu == ie)? ie+1 : iu;
+    for (int k=kl; k<=ku; ++k) {
+      for (int j=jl; j<=ju; ++j) {
+        // Reconstruct qR[i] and qL[i+1]
+        Reconstruct(member, recon_method_, eos, extrema, 1, m, k, j, il-1, ifu, w,
+                    scr1, scr2);
+        member.team_barrier();
+        RiemannSolve<rsolver_method_>(member, eos, indcs, size, coord, m, k, j, il, ifu,
+                                      IVX, nhyd_, nvars, scr1, scr2, flx1);
+      }
+    }
+
+    // j-direction: fluxes over [jl,ju] plus face je+1 in last tile
+    if (multi_d) {
+      int jfu = (ju == je)? je+1 : ju;
+      for (int k=kl; k<=ku; ++k) {
+        for (int j=jl-1; j<=jfu; ++j) {
+          // Permute scratch arrays.
+          auto wl     = scr1;
+          auto wl_jp1 = scr2;
+          auto wr     = scr3;
+          if ((j%2) == 0) {
+            wl     = scr2;
+            wl_jp1 = scr1;
+          }
+          // Reconstruct qR[j] and qL[j+1]
+          Reconstruct(member, recon_method_, eos, extrema, 2, m, k, j, il, iu, w,
+                      wl_jp1, wr);
+          member.team_barrier();
+          if (j > jl-1) {
+            RiemannSolve<rsolver_method_>(member, eos, indcs, size, coord, m, k, j, il,
+                                          iu, IVY, nhyd_, nvars, wl, wr, flx2);
+          }
+        }
+      }
+    }
+
+    // k-direction: fluxes over [kl,ku] plus face ke+1 in last tile
+    if (three_d) {
+      int kfu = (ku == ke)? ke+1 : ku;
+      for (int j=jl; j<=ju; ++j) {
+        for (int k=kl-1; k<=kfu; ++k) {
+          // Permute scratch arrays.
+          auto wl     = scr1;
+          auto wl_kp1 = scr2;
+          auto wr     = scr3;
+          if ((k%2) == 0) {
+            wl     = scr2;
+            wl_kp1 = scr1;
+          }
+          // Reconstruct qR[k] and qL[k+1]
+          Reconstruct(member, recon_method_, eos, extrema, 3, m, k, j, il, iu, w,
+                      wl_kp1, wr);
+          member.team_barrier();
+          if (k > kl-1) {
+            RiemannSolve<rsolver_method_>(member, eos, indcs, size, coord, m, k, j, il,
+                                          iu, IVZ, nhyd_, nvars, wl, wr, flx3);
+          }
+        }
+      }
+    }
+  });
+  return;
+}
+
+// function definitions for each template parameter
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::advect>(Driver *d, int stage);
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::llf>(Driver *d, int stage);
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::hlle>(Driver *d, int stage);
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::hllc>(Driver *d, int stage);
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::roe>(Driver *d, int stage);
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::llf_sr>(Driver *d, int stage);
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::hlle_sr>(Driver *d, int stage);
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::hllc_sr>(Driver *d, int stage);
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::llf_gr>(Driver *d, int stage);
+template void Hydro::CalculateFluxesTiled<Hydro_RSolver::hlle_gr>(Driver *d, int stage);
+
+} // namespace hydro
@@ -0,0 +1,247 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hydro_fused_update.cpp
+//! \brief Fused reconstruction, Riemann solve, and explicit RK update of Hydro conserved
+//! variables.  Fluxes are computed in team scratch memory and used directly to compute
+//! the flux divergence, so that the face-centered arrays of fluxes (uflx) are never
+//! written to, or read from, global memory.  This greatly reduces the memory traffic per
+//! stage, at the cost of computing fluxes on x3-faces twice.  Can only be used when the
+//! fluxes are not needed elsewhere (no FOFC, diffusion, or flux correction with SMR/AMR).
+
+#include <iostream>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "coordinates/coordinates.hpp"
+#include "hydro.hpp"
+#include "eos/eos.hpp"
+#include "reconstruct/reconstruct.hpp"
+#include "hydro/rsolvers/hydro_rsolver.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \struct ScrFlux
+//! \brief Wraps a scratch array so that it can be passed to the Riemann solvers in place
+//! of a DvceArray5D of fluxes.  Fluxes are stored only for a single row of faces, so the
+//! (m,k,j) indices are ignored.
+
+struct ScrFlux {
+  ScrArray2D<Real> flx;
+  KOKKOS_INLINE_FUNCTION
+  Real &operator()(const int m, const int n, const int k, const int j,
+                   const int i) const {
+    return flx(n,i);
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Hydro::FusedRKUpdate
+//! \brief Wrapper function that calls fused update templated over Riemann solver
+
+TaskStatus Hydro::FusedRKUpdate(Driver *pdriver, int stage) {
+  if (rsolver_method == Hydro_RSolver::advect) {
+    CalculateFusedUpdate<Hydro_RSolver::advect>(pdriver, stage);
+  } else if (rsolver_method == Hydro_RSolver::llf) {
+    CalculateFusedUpdate<Hydro_RSolver::llf>(pdriver, stage);
+  } else if (rsolver_method == Hydro_RSolver::hlle) {
+    CalculateFusedUpdate<Hydro_RSolver::hlle>(pdriver, stage);
+  } else if (rsolver_method == Hydro_RSolver::hllc) {
+    CalculateFusedUpdate<Hydro_RSolver::hllc>(pdriver, stage);
+  } else if (rsolver_method == Hydro_RSolver::roe) {
+    CalculateFusedUpdate<Hydro_RSolver::roe>(pdriver, stage);
+  } else if (rsolver_method == Hydro_RSolver::llf_sr) {
+    CalculateFusedUpdate<Hydro_RSolver::llf_sr>(pdriver, stage);
+  } else if (rsolver_method == Hydro_RSolver::hlle_sr) {
+    CalculateFusedUpdate<Hydro_RSolver::hlle_sr>(pdriver, stage);
+  } else if (rsolver_method == Hydro_RSolver::hllc_sr) {
+    CalculateFusedUpdate<Hydro_RSolver::hllc_sr>(pdriver, stage);
+  } else if (rsolver_method == Hydro_RSolver::llf_gr) {
+    CalculateFusedUpdate<Hydro_RSolver::llf_gr>(pdriver, stage);
+  } else if (rsolver_method == Hydro_RSolver::hlle_gr) {
+    CalculateFusedUpdate<Hydro_RSolver::hlle_gr>(pdriver, stage);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateFusedUpdate
+//! \brief Explicit RK update of conserved variables with fluxes computed on the fly.
+//! Each team updates one (m,k) plane, looping over j.  Fluxes on x2-faces are carried
+//! from one row to the next, so each is computed once.  Fluxes on x3-faces are computed
+//! for both faces of every row.  The flux divergence is summed in exactly the same order
+//! as in RKUpdate(), so results are identical to the unfused path.
+
+template <Hydro_RSolver rsolver_method_>
+void Hydro::CalculateFusedUpdate(Driver *pdriver, int stage) {
+  RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
+  int is = indcs_.is, ie = indcs_.ie;
+  int js = indcs_.js, je = indcs_.je;
+  int ks = indcs_.ks, ke = indcs_.ke;
+  int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  int nhyd_  = nhydro;
+  int nvars = nhydro + nscalars;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  const auto recon_method_ = recon_method;
+  bool extrema = false;
+  if (recon_method == ReconstructionMethod::ppmx) {
+    extrema = true;
+  }
+
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+
+  auto &eos_ = peos->eos_data;
+  auto &size_ = pmy_pack->pmb->mb_size;
+  auto &coord_ = pmy_pack->pcoord->coord_data;
+  auto &w0_ = w0;
+  auto u0_ = u0;
+  auto u1_ = u1;
+
+  // With multi_d, loop over j is offset by one row, so that fluxes on both x2-faces of
+  // row j are available when it is updated
+  int joff = (multi_d)? 1 : 0;
+
+  // scratch arrays: 5 for L/R states, 2 for x2-fluxes, 1 for x1/x3-fluxes
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvars, ncells1) * 8;
+  int scr_level = 0;
+  par_for_outer("hfused",DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ke,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+    ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> scr4(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> scr5(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> f2a(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> f2b(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> flx(member.team_scratch(scr_level), nvars, ncells1);
+    // NOTE(@pdmullen): Capture variables prior to if constexpr.  Required for cuda 11.6+.
+    auto eos = eos_;
+    auto indcs = indcs_;
+    auto size = size_;
+    auto coord = coord_;
+
+    for (int jj=js-joff; jj<=je+joff; ++jj) {
+      // Permute scratch arrays.  Flux on lower x2-face of row (jj-1) is in f2lo, and the
+      // flux divergence of that row is accumulated in f2lo once it has been used.
+      auto f2lo = f2a;
+      auto f2hi = f2b;
+      if ((jj%2) == 0) {
+        f2lo = f2b;
+        f2hi = f2a;
+      }
+
+      // compute fluxes on x2-face jj
+      if (multi_d) {
+        auto wl     = scr1;
+        auto wl_jp1 = scr2;
+        auto wr     = scr3;
+        if ((jj%2) == 0) {
+          wl     = scr2;
+          wl_jp1 = scr1;
+        }
+        // Reconstruct qR[jj] and qL[jj+1]
+        Reconstruct(member, recon_method_, eos, extrema, 2, m, k, jj, is, ie, w0_,
+                    wl_jp1, wr);
+        member.team_barrier();
+        if (jj > js-1) {
+          RiemannSolve<rsolver_method_>(member, eos, indcs, size, coord, m, k, jj, is, ie,
+                                        IVY, nhyd_, nvars, wl, wr, ScrFlux{f2hi});
+        }
+      }
+
+      int j = jj - joff;
+      if (j < js) continue;
+
+      // Store dF2/dx2 in f2lo
+      if (multi_d) {
+        Real &dx2 = size.d_view(m).dx2;
+        for (int n=0; n<nvars; ++n) {
+          par_for_inner(member, is, ie, [&](const int i) {
+            f2lo(n,i) = (f2hi(n,i) - f2lo(n,i))/dx2;
+          });
+        }
+        member.team_barrier();
+      }
+
+      // compute fluxes on x1-faces over [is,ie+1], and add dF1/dx1
+      // Fluxes are summed in same order as in RKUpdate() to reproduce round-off error
+      {
+        auto wl = scr3;
+        auto wr = scr4;
+        Reconstruct(member, recon_method_, eos, extrema, 1, m, k, j, is-1, ie+1,
+                    w0_, wl, wr);
+        member.team_barrier();
+        RiemannSolve<rsolver_method_>(member, eos, indcs, size, coord, m, k, j, is, ie+1,
+                                      IVX, nhyd_, nvars, wl, wr, ScrFlux{flx});
+        Real &dx1 = size.d_view(m).dx1;
+        for (int n=0; n<nvars; ++n) {
+          par_for_inner(member, is, ie, [&](const int i) {
+            Real divf1 = (flx(n,i+1) - flx(n,i))/dx1;
+            f2lo(n,i) = (multi_d)? (divf1 + f2lo(n,i)) : divf1;
+          });
+        }
+        member.team_barrier();
+      }
+
+      // compute fluxes on both x3-faces of row, and add dF3/dx3
+      if (three_d) {
+        auto wl_k   = scr4;
+        auto wl_kp1 = scr3;
+        auto wr     = scr5;
+        // Reconstruct qL[k] (from cell k-1), then qR[k] and qL[k+1]
+        Reconstruct(member, recon_method_, eos, extrema, 3, m, k-1, j, is, ie, w0_,
+                    wl_k, wr);
+        member.team_barrier();
+        Reconstruct(member, recon_method_, eos, extrema, 3, m, k, j, is, ie, w0_,
+                    wl_kp1, wr);
+        member.team_barrier();
+        RiemannSolve<rsolver_method_>(member, eos, indcs, size, coord, m, k, j, is, ie,
+                                      IVZ, nhyd_, nvars, wl_k, wr, ScrFlux{flx});
+        // Reconstruct qR[k+1] (qL[k+2] is discarded), flux on face k+1 returned in scr4
+        Reconstruct(member, recon_method_, eos, extrema, 3, m, k+1, j, is, ie, w0_,
+                    wl_k, wr);
+        member.team_barrier();
+        RiemannSolve<rsolver_method_>(member, eos, indcs, size, coord, m, k+1, j, is, ie,
+                                      IVZ, nhyd_, nvars, wl_kp1, wr, ScrFlux{wl_k});
+        Real &dx3 = size.d_view(m).dx3;
+        for (int n=0; n<nvars; ++n) {
+          par_for_inner(member, is, ie, [&](const int i) {
+            f2lo(n,i) += (wl_k(n,i) - flx(n,i))/dx3;
+          });
+        }
+        member.team_barrier();
+      }
+
+      // update conserved variables in row
+      for (int n=0; n<nvars; ++n) {
+        par_for_inner(member, is, ie, [&](const int i) {
+          u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(m,n,k,j,i) - beta_dt*f2lo(n,i);
+        });
+      }
+      member.team_barrier();
+    } // end of loop over j
+  });
+  return;
+}
+
+// function definitions for each template parameter
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::advect>(Driver *d, int stage);
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::llf>(Driver *d, int stage);
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::hlle>(Driver *d, int stage);
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::hllc>(Driver *d, int stage);
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::roe>(Driver *d, int stage);
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::llf_sr>(Driver *d, int stage);
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::hlle_sr>(Driver *d, int stage);
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::hllc_sr>(Driver *d, int stage);
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::llf_gr>(Driver *d, int stage);
+template void Hydro::CalculateFusedUpdate<Hydro_RSolver::hlle_gr>(Driver *d, int stage);
+
+} // namespace hydro
@@ -16,6 +16,8 @@
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
 #include "eos/eos.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "coordinates/curvilinear.hpp"
 #include "hydro.hpp"
 #include "diffusion/conduction.hpp"
 #include "srcterms/srcterms.hpp"
@@ -47,13 +49,20 @@ TaskStatus Hydro::NewTimeStep(Driver *pdrive, int stage) {
   auto &is_special_relativistic_ = pmy_pack->pcoord->is_special_relativistic;
   auto &is_general_relativistic_ = pmy_pack->pcoord->is_general_relativistic;
   auto &is_dynamical_relativistic_ = pmy_pack->pcoord->is_dynamical_relativistic;
+  const CoordSystem sys = pmy_pack->pcoord->coord_data.system;
   const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
 
-  if (pdrive->time_evolution == TimeEvolution::kinematic) {
+  if (peos->newdt_done) {
+    // signal speeds already reduced in ConsToPrim of this stage (fused_newdt)
+    dt1 = peos->newdt[0];
+    dt2 = peos->newdt[1];
+    dt3 = peos->newdt[2];
+    peos->newdt_done = false;
+  } else if (pdrive->time_evolution == TimeEvolution::kinematic) {
     // find smallest (dx/v) in each direction for advection problems
-    Kokkos::parallel_reduce("HydroNudt1",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    Kokkos::parallel_reduce("HydroNudt1",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
     KOKKOS_LAMBDA(const int &idx, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
       // compute m,k,j,i indices of thread and call function
       int m = (idx)/nkji;
@@ -63,13 +72,19 @@ TaskStatus Hydro::NewTimeStep(Driver *pdrive, int stage) {
       k += ks;
       j += js;
 
+      // lengths of cell in x2 and x3 in curvilinear coordinates
+      Real h2 = 1.0, h3 = 1.0;
+      if (sys != CoordSystem::cartesian) {
+        const MBLocations loc = LoadMBLocations(mbsize.d_view(m), indcs);
+        ScaleFactors(sys, loc.x1v(i), loc.x2v(j), h2, h3);
+      }
       min_dt1 = fmin((mbsize.d_view(m).dx1/fabs(w0_(m,IVX,k,j,i))), min_dt1);
-      min_dt2 = fmin((mbsize.d_view(m).dx2/fabs(w0_(m,IVY,k,j,i))), min_dt2);
-      min_dt3 = fmin((mbsize.d_view(m).dx3/fabs(w0_(m,IVZ,k,j,i))), min_dt3);
+      min_dt2 = fmin((h2*mbsize.d_view(m).dx2/fabs(w0_(m,IVY,k,j,i))), min_dt2);
+      min_dt3 = fmin((h3*mbsize.d_view(m).dx3/fabs(w0_(m,IVZ,k,j,i))), min_dt3);
     }, Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2),Kokkos::Min<Real>(dt3));
   } else {
     // find smallest dx/(v +/- Cs) in each direction for hydrodynamic problems
-    Kokkos::parallel_reduce("HydroNudt2",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    Kokkos::parallel_reduce("HydroNudt2",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
     KOKKOS_LAMBDA(const int &idx, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
       // compute m,k,j,i indices of thread and call function
       int m = (idx)/nkji;
@@ -112,9 +127,14 @@ TaskStatus Hydro::NewTimeStep(Driver *pdrive, int stage) {
         max_dv2 = fabs(w0_(m,IVY,k,j,i)) + cs;
         max_dv3 = fabs(w0_(m,IVZ,k,j,i)) + cs;
       }
+      Real h2 = 1.0, h3 = 1.0;
+      if (sys != CoordSystem::cartesian) {
+        const MBLocations loc = LoadMBLocations(mbsize.d_view(m), indcs);
+        ScaleFactors(sys, loc.x1v(i), loc.x2v(j), h2, h3);
+      }
       min_dt1 = fmin((mbsize.d_view(m).dx1/max_dv1), min_dt1);
-      min_dt2 = fmin((mbsize.d_view(m).dx2/max_dv2), min_dt2);
-      min_dt3 = fmin((mbsize.d_view(m).dx3/max_dv3), min_dt3);
+      min_dt2 = fmin((h2*mbsize.d_view(m).dx2/max_dv2), min_dt2);
+      min_dt3 = fmin((h3*mbsize.d_view(m).dx3/max_dv3), min_dt3);
     }, Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2),Kokkos::Min<Real>(dt3));
   }
 
@@ -130,6 +150,11 @@ TaskStatus Hydro::NewTimeStep(Driver *pdrive, int stage) {
   // compute source terms timestep
   psrc->NewTimeStep(w0, peos->eos_data);
 
+  // error norm of step with embedded RK pairs
+  if (pdrive->adaptive_dt) {
+    errnew = pdrive->EmbeddedErrorNorm(pmy_pack, u0, u1, nhydro+nscalars);
+  }
+
   return TaskStatus::complete;
 }
 } // namespace hydro
@@ -0,0 +1,197 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hydro_scalar_fluxes.cpp
+//! \brief Calculate fluxes of passive scalars separately from the hydro fluxes (with
+//! <hydro>/separate_scalars=true).  Scalars are upwinded with the sign of the mass flux
+//! and multiplied by it, as in CalculateFluxes(), so that they are advected consistently
+//! with the density.  Each team reconstructs only scalar_chunk scalars, so the scratch
+//! memory is independent of the number of scalars, and the hydro flux kernels need
+//! scratch memory for nhydro variables only.
+
+#include <iostream>
+#include <utility>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "hydro.hpp"
+#include "reconstruct/dc.hpp"
+#include "reconstruct/plm.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateScalarFluxes
+//! \brief Computes fluxes of scalars on all faces at which CalculateFluxes() computes
+//! them, from the mass fluxes in uflx.  Must be called after the mass fluxes are final,
+//! i.e. after FOFC.
+
+void Hydro::CalculateScalarFluxes(Driver *pdriver, int stage) {
+  RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
+  int is = indcs_.is, ie = indcs_.ie;
+  int js = indcs_.js, je = indcs_.je;
+  int ks = indcs_.ks, ke = indcs_.ke;
+  int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
+  // fluxes also computed in ghost zones in stages without exchange of ghost zones
+  int ext = HaloExtension(pdriver, stage);
+  int ext2 = (pmy_pack->pmesh->multi_d)? ext : 0;
+  int ext3 = (pmy_pack->pmesh->three_d)? ext : 0;
+
+  int nhyd_ = nhydro;
+  int nvars = nhydro + nscalars;
+  int nchunk_ = scalar_chunk;
+  int nchunk1 = (nscalars + nchunk_ - 1)/nchunk_ - 1;
+  int nmb1 = nmb_flux_ - 1;
+  auto &amb_ = flux_mbs_;
+  const auto recon_ = scalar_recon;
+  auto &w0_ = w0;
+
+  //--------------------------------------------------------------------------------------
+  // i-direction
+
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nchunk_, ncells1) * 2;
+  int scr_level = 0;
+  auto &flx1_ = uflx.x1f;
+  int il = is-ext, iu = ie+1+ext, jl = js-ext2, ju = je+ext2, kl = ks-ext3, ku = ke+ext3;
+
+  par_for_outer("hflux_scalar_x1",DevExeSpace(), scr_size, scr_level, 0, nmb1,
+                0, nchunk1, kl, ku, jl, ju,
+  KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int c, const int k,
+                const int j) {
+    const int m = amb_.d_view(ma);
+    const int n0 = nhyd_ + c*nchunk_;
+    const int n1 = (n0 + nchunk_ < nvars)? n0 + nchunk_ : nvars;
+    auto s0 = Kokkos::subview(w0_, Kokkos::ALL, std::make_pair(n0, n1), Kokkos::ALL,
+                              Kokkos::ALL, Kokkos::ALL);
+    ScrArray2D<Real> sl(member.team_scratch(scr_level), nchunk_, ncells1);
+    ScrArray2D<Real> sr(member.team_scratch(scr_level), nchunk_, ncells1);
+
+    // Reconstruct qR[i] and qL[i+1]
+    if (recon_ == ReconstructionMethod::dc) {
+      DonorCellX1(member, m, k, j, il-1, iu, s0, sl, sr);
+    } else {
+      PiecewiseLinearX1(member, m, k, j, il-1, iu, s0, sl, sr);
+    }
+    member.team_barrier();
+
+    for (int n=n0; n<n1; ++n) {
+      par_for_inner(member, il, iu, [&](const int i) {
+        if (flx1_(m,IDN,k,j,i) >= 0.0) {
+          flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*sl(n-n0,i);
+        } else {
+          flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*sr(n-n0,i);
+        }
+      });
+    }
+  });
+
+  //--------------------------------------------------------------------------------------
+  // j-direction
+
+  if (pmy_pack->pmesh->multi_d) {
+    scr_size = ScrArray2D<Real>::shmem_size(nchunk_, ncells1) * 3;
+    auto &flx2_ = uflx.x2f;
+    il = is-ext, iu = ie+ext, jl = js-ext, ju = je+1+ext, kl = ks-ext3, ku = ke+ext3;
+
+    par_for_outer("hflux_scalar_x2",DevExeSpace(), scr_size, scr_level, 0, nmb1,
+                  0, nchunk1, kl, ku,
+    KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int c, const int k) {
+      const int m = amb_.d_view(ma);
+      const int n0 = nhyd_ + c*nchunk_;
+      const int n1 = (n0 + nchunk_ < nvars)? n0 + nchunk_ : nvars;
+      auto s0 = Kokkos::subview(w0_, Kokkos::ALL, std::make_pair(n0, n1), Kokkos::ALL,
+                                Kokkos::ALL, Kokkos::ALL);
+      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nchunk_, ncells1);
+      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nchunk_, ncells1);
+      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nchunk_, ncells1);
+
+      for (int j=jl-1; j<=ju; ++j) {
+        // Permute scratch arrays.
+        auto sl     = scr1;
+        auto sl_jp1 = scr2;
+        auto sr     = scr3;
+        if ((j%2) == 0) {
+          sl     = scr2;
+          sl_jp1 = scr1;
+        }
+
+        // Reconstruct qR[j] and qL[j+1]
+        if (recon_ == ReconstructionMethod::dc) {
+          DonorCellX2(member, m, k, j, il, iu, s0, sl_jp1, sr);
+        } else {
+          PiecewiseLinearX2(member, m, k, j, il, iu, s0, sl_jp1, sr);
+        }
+        member.team_barrier();
+
+        if (j > jl-1) {
+          for (int n=n0; n<n1; ++n) {
+            par_for_inner(member, il, iu, [&](const int i) {
+              if (flx2_(m,IDN,k,j,i) >= 0.0) {
+                flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*sl(n-n0,i);
+              } else {
+                flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*sr(n-n0,i);
+              }
+            });
+          }
+        }
+      } // end of loop over j
+    });
+  }
+
+  //--------------------------------------------------------------------------------------
+  // k-direction. Note order of k,j loops switched
+
+  if (pmy_pack->pmesh->three_d) {
+    scr_size = ScrArray2D<Real>::shmem_size(nchunk_, ncells1) * 3;
+    auto &flx3_ = uflx.x3f;
+    il = is-ext, iu = ie+ext, jl = js-ext, ju = je+ext, kl = ks-ext, ku = ke+1+ext;
+
+    par_for_outer("hflux_scalar_x3",DevExeSpace(), scr_size, scr_level, 0, nmb1,
+                  0, nchunk1, jl, ju,
+    KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int c, const int j) {
+      const int m = amb_.d_view(ma);
+      const int n0 = nhyd_ + c*nchunk_;
+      const int n1 = (n0 + nchunk_ < nvars)? n0 + nchunk_ : nvars;
+      auto s0 = Kokkos::subview(w0_, Kokkos::ALL, std::make_pair(n0, n1), Kokkos::ALL,
+                                Kokkos::ALL, Kokkos::ALL);
+      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nchunk_, ncells1);
+      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nchunk_, ncells1);
+      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nchunk_, ncells1);
+
+      for (int k=kl-1; k<=ku; ++k) {
+        // Permute scratch arrays.
+        auto sl     = scr1;
+        auto sl_kp1 = scr2;
+        auto sr     = scr3;
+        if ((k%2) == 0) {
+          sl     = scr2;
+          sl_kp1 = scr1;
+        }
+
+        // Reconstruct qR[k] and qL[k+1]
+        if (recon_ == ReconstructionMethod::dc) {
+          DonorCellX3(member, m, k, j, il, iu, s0, sl_kp1, sr);
+        } else {
+          PiecewiseLinearX3(member, m, k, j, il, iu, s0, sl_kp1, sr);
+        }
+        member.team_barrier();
+
+        if (k > kl-1) {
+          for (int n=n0; n<n1; ++n) {
+            par_for_inner(member, il, iu, [&](const int i) {
+              if (flx3_(m,IDN,k,j,i) >= 0.0) {
+                flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*sl(n-n0,i);
+              } else {
+                flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*sr(n-n0,i);
+              }
+            });
+          }
+        }
+      } // end of loop over k
+    });
+  }
+  return;
+}
+
+} // namespace hydro
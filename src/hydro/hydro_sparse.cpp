@@ -0,0 +1,290 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hydro_sparse.cpp
+//! \brief Implements functions for sparse activation of MeshBlocks.  MBs in which the
+//! state in every cell is at the density (and pressure) floors, such as MBs in the
+//! atmosphere far from an accretion flow, or that are completely excised inside a BH
+//! horizon, are put to sleep.  Sleeping MBs are skipped by the flux, RK update, and C2P
+//! kernels, which loop over the list of active MBs.  Boundary values of sleeping MBs are
+//! still exchanged, so that a MB is woken as soon as matter above the floors enters its
+//! ghost zones.
+//! MBs that have been asleep for <hydro>/u1_release_cycles consecutive cycles become
+//! cold, and release their slot in the RK register u1, which only holds data within a
+//! cycle and is never needed for sleeping MBs.  u1 is kept at the high-water mark of the
+//! number of slots needed over the last u1_release_cycles cycles, so it shrinks at most
+//! once in that interval, and frees one copy of the conserved variables for each MB that
+//! stayed cold.  A cold MB that wakes gets a slot again at the start of the next cycle.
+//! Also implements selection of the reconstruction method of each active MB for hybrid
+//! reconstruction, which uses the same lists of MBs.
+
+#include <algorithm>  // max()
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/refinement_criteria.hpp"
+#include "driver/driver.hpp"
+#include "coordinates/coordinates.hpp"
+#include "eos/eos.hpp"
+#include "hydro.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn int Hydro::ActiveMeshBlocks
+//! \brief Returns number of active MBs, whose indices are the first nmb_active elements
+//! of active_mbs.  If the MBs in the pack have changed since the list was set (e.g. with
+//! AMR), all MBs are made active until the next call to SetActiveMeshBlocks(), and every
+//! MB gets its own slot in u1.
+
+int Hydro::ActiveMeshBlocks() {
+  int nmb = pmy_pack->nmb_thispack;
+  if ((active_version_ == pmy_pack->pmesh->nghbr_version) && (active_nmb_ == nmb)) {
+    return nmb_active;
+  }
+
+  Kokkos::realloc(active_mbs, nmb);
+  Kokkos::realloc(mb_active, nmb);
+  Kokkos::realloc(u1_slot, nmb);
+  for (int m=0; m<nmb; ++m) {
+    active_mbs.h_view(m) = m;
+    mb_active.h_view(m) = 1;
+    u1_slot.h_view(m) = m;
+  }
+  active_mbs.template modify<HostMemSpace>();
+  active_mbs.template sync<DevExeSpace>();
+  mb_active.template modify<HostMemSpace>();
+  mb_active.template sync<DevExeSpace>();
+  u1_slot.template modify<HostMemSpace>();
+  u1_slot.template sync<DevExeSpace>();
+  if (u1_release_cycles > 0) {
+    nsleep_.assign(nmb, 0);
+    nmb_cold = 0;
+    nslot_hwm_ = 0;
+    ncycle_hwm_ = 0;
+    int nmb_max = std::max(nmb, pmy_pack->pmesh->nmb_maxperrank);
+    if (u1.extent_int(0) < nmb_max) {
+      Kokkos::realloc(u1, nmb_max, u1.extent_int(1), u1.extent_int(2), u1.extent_int(3),
+                      u1.extent_int(4));
+    }
+  }
+  nmb_active = nmb;
+  active_version_ = pmy_pack->pmesh->nghbr_version;
+  active_nmb_ = nmb;
+  return nmb_active;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::SetActiveMeshBlocks
+//! \brief Sets list of active MBs at start of each cycle.  A MB is asleep if in all
+//! active cells the density and pressure are within sparse_tol of the floors, and the
+//! density is at the floor in the ghost zones as well.  Primitives in the ghost zones of
+//! sleeping MBs are not updated, so only conserved density is tested there.  Since
+//! conserved density is never smaller than the primitive density, this is a conservative
+//! test.  Cells inside the excision radius are ignored, so MBs completely inside the
+//! horizon are always asleep.
+
+TaskStatus Hydro::SetActiveMeshBlocks(Driver *pdrive, int stage) {
+  ActiveMeshBlocks();  // reset list if MBs have changed
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  const int nkji = n3*n2*n1;
+  const int nji  = n2*n1;
+  int nmb = pmy_pack->nmb_thispack;
+
+  auto &eos = peos->eos_data;
+  bool ideal = eos.is_ideal;
+  bool use_e = eos.use_e;
+  Real dthresh = eos.dfloor*(1.0 + sparse_tol);
+  Real pthresh = eos.pfloor*(1.0 + sparse_tol);
+  Real tthresh = eos.tfloor*(1.0 + sparse_tol);
+  bool excise = (pmy_pack->pcoord->is_general_relativistic &&
+                 pmy_pack->pcoord->coord_data.bh_excise);
+  auto &excision_floor_ = pmy_pack->pcoord->excision_floor;
+  auto &u0_ = u0;
+  auto &w0_ = w0;
+  auto &mb_active_ = mb_active;
+
+  par_for_outer("sparse_check",DevExeSpace(), 0, 0, 0, (nmb-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+    int nabove = 0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+    [=](const int idx, int &sum) {
+      int k = (idx)/nji;
+      int j = (idx - k*nji)/n1;
+      int i = (idx - k*nji - j*n1);
+      if (excise) {
+        if (excision_floor_(m,k,j,i)) return;
+      }
+      bool above = (u0_(m,IDN,k,j,i) > dthresh);
+      bool active_cell = (i >= is && i <= ie && j >= js && j <= je && k >= ks && k <= ke);
+      if (!above && active_cell) {
+        above = (w0_(m,IDN,k,j,i) > dthresh);
+        if (ideal) {
+          Real p = (use_e)? eos.IdealGasPressure(w0_(m,IEN,k,j,i)) :
+                            w0_(m,IDN,k,j,i)*w0_(m,IEN,k,j,i);
+          above = above || ((p > pthresh) && (p > tthresh*w0_(m,IDN,k,j,i)));
+        }
+      }
+      if (above) {sum++;}
+    },Kokkos::Sum<int>(nabove));
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+      mb_active_.d_view(m) = (nabove > 0)? 1 : 0;
+    });
+  });
+
+  // copy flags to host and build list of active MBs
+  mb_active.template modify<DevExeSpace>();
+  mb_active.template sync<HostMemSpace>();
+  nmb_active = 0;
+  for (int m=0; m<nmb; ++m) {
+    if (mb_active.h_view(m) != 0) {
+      active_mbs.h_view(nmb_active++) = m;
+    }
+  }
+  active_mbs.template modify<HostMemSpace>();
+  active_mbs.template sync<DevExeSpace>();
+  if (u1_release_cycles > 0) {SetColdMeshBlocks();}
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::SetColdMeshBlocks
+//! \brief Counts the consecutive cycles each MB has been asleep, and reassigns the slots
+//! in u1 of the non-cold MBs whenever the set of cold MBs changes.  u1 only grows when
+//! more slots are needed than it holds, and shrinks to the high-water mark of the slots
+//! needed every u1_release_cycles cycles.  Called at the start of each cycle after the
+//! list of active MBs is set, so that the contents of u1 (which are set from u0 in the
+//! first stage) need not be preserved.
+
+void Hydro::SetColdMeshBlocks() {
+  int nmb = pmy_pack->nmb_thispack;
+  bool changed = false;
+  int ncold = 0;
+  for (int m=0; m<nmb; ++m) {
+    nsleep_[m] = (mb_active.h_view(m) != 0)? 0 : (nsleep_[m] + 1);
+    bool cold = (nsleep_[m] >= u1_release_cycles);
+    if (cold != (u1_slot.h_view(m) < 0)) {changed = true;}
+    if (cold) {ncold++;}
+  }
+  int nslot = std::max(nmb - ncold, 1);
+  if (changed) {
+    int islot = 0;
+    for (int m=0; m<nmb; ++m) {
+      u1_slot.h_view(m) = (nsleep_[m] >= u1_release_cycles)? -1 : islot++;
+    }
+    u1_slot.template modify<HostMemSpace>();
+    u1_slot.template sync<DevExeSpace>();
+    nmb_cold = ncold;
+  }
+
+  // grow u1 only if needed, shrink it to the high-water mark once per interval
+  nslot_hwm_ = std::max(nslot_hwm_, nslot);
+  int nsize = std::max(u1.extent_int(0), nslot);
+  if (++ncycle_hwm_ >= u1_release_cycles) {
+    nsize = nslot_hwm_;
+    ncycle_hwm_ = 0;
+    nslot_hwm_ = 0;
+  }
+  if (nsize != u1.extent_int(0)) {
+    Kokkos::realloc(u1, nsize, u1.extent_int(1), u1.extent_int(2), u1.extent_int(3),
+                    u1.extent_int(4));
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::WakeColdMeshBlocks
+//! \brief Makes all MBs active, and reallocates u1 with a slot for every MB.  Called
+//! before functions that use u1 for all MBs, such as the error functions of pgens.
+
+void Hydro::WakeColdMeshBlocks() {
+  if (u1_release_cycles <= 0) return;
+  active_version_ = -1;  // forces ActiveMeshBlocks() to reset the lists
+  ActiveMeshBlocks();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::SelectReconstruction
+//! \brief Splits list of active MBs at start of each cycle into those using recon_method
+//! and those using recon_lo (hybrid reconstruction).  A MB uses recon_method if any of
+//! its active cells would be flagged for refinement by HydroRefinementVote with the
+//! <hydro>/hybrid_dens, hybrid_ddens, and hybrid_dpres thresholds.
+
+TaskStatus Hydro::SelectReconstruction(Driver *pdrive, int stage) {
+  int nmb_act = ActiveMeshBlocks();  // reset list if MBs have changed
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  int nmb = pmy_pack->nmb_thispack;
+  if (static_cast<int>(mb_recon_hi.extent(0)) < nmb) {
+    Kokkos::realloc(mb_recon_hi, nmb);
+    Kokkos::realloc(recon_hi_mbs, nmb);
+    Kokkos::realloc(recon_lo_mbs, nmb);
+  }
+
+  HydroRefinementVote vote;
+  vote.u0 = u0;
+  vote.w0 = w0;
+  vote.d_thresh  = hybrid_dens;
+  vote.dd_thresh = hybrid_ddens;
+  vote.dp_thresh = hybrid_dpres;
+  vote.multi_d = pmy_pack->pmesh->multi_d;
+  vote.three_d = pmy_pack->pmesh->three_d;
+  vote.size = pmy_pack->pmb->mb_size;
+  vote.lookahead = 0.0;
+  vote.ng = indcs.ng;
+  auto &amb_ = active_mbs;
+  auto &mb_recon_hi_ = mb_recon_hi;
+
+  par_for_outer("hybrid_check",DevExeSpace(), 0, 0, 0, (nmb_act-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int ma) {
+    const int m = amb_.d_view(ma);
+    int team_vote = -1;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+    [=](const int idx, int& vmax) {
+      int k = (idx)/nji;
+      int j = (idx - k*nji)/nx1;
+      int i = (idx - k*nji - j*nx1) + is;
+      j += js;
+      k += ks;
+      int v = vote(m,k,j,i);
+      if (v > vmax) {vmax = v;}
+    },Kokkos::Max<int>(team_vote));
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+      mb_recon_hi_.d_view(m) = (team_vote > 0)? 1 : 0;
+    });
+  });
+
+  // copy flags to host and build lists of MBs (in the same order as active_mbs)
+  mb_recon_hi.template modify<DevExeSpace>();
+  mb_recon_hi.template sync<HostMemSpace>();
+  nmb_recon_hi = 0;
+  nmb_recon_lo = 0;
+  for (int ma=0; ma<nmb_act; ++ma) {
+    int m = active_mbs.h_view(ma);
+    if (mb_recon_hi.h_view(m) != 0) {
+      recon_hi_mbs.h_view(nmb_recon_hi++) = m;
+    } else {
+      recon_lo_mbs.h_view(nmb_recon_lo++) = m;
+    }
+  }
+  recon_hi_mbs.template modify<HostMemSpace>();
+  recon_hi_mbs.template sync<DevExeSpace>();
+  recon_lo_mbs.template modify<HostMemSpace>();
+  recon_lo_mbs.template sync<DevExeSpace>();
+  return TaskStatus::complete;
+}
+
+} // namespace hydro
@@ -6,6 +6,7 @@
 //! \file hydro_tasks.cpp
 //! \brief functions that control Hydro tasks stored in tasklists in MeshBlockPack
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -21,6 +22,7 @@
 #include "diffusion/viscosity.hpp"
 #include "diffusion/conduction.hpp"
 #include "srcterms/srcterms.hpp"
+#include "chemistry/chemistry.hpp"
 #include "bvals/bvals.hpp"
 #include "shearing_box/shearing_box.hpp"
 #include "shearing_box/orbital_advection.hpp"
@@ -43,48 +45,223 @@ namespace hydro {
 //! are completed over ALL MeshBlocks for each stage, such as clearing all MPI calls, etc.
 //!
 //! In addition there are "before_timeintegrator" and "after_timeintegrator" task lists
-//! in the tl map, which are generally used for operator split tasks.
+//! in the tl map, which are generally used for operator split tasks, and "before_sts",
+//! "sts", and "after_sts" task lists used for super time-stepping of diffusion terms.
 
 void Hydro::AssembleHydroTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
   TaskID none(0);
 
   // assemble "before_stagen" task list
-  id.irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, this, none);
+  id.irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, this, none,
+                                          "Hydro::InitRecv");
 
-  // assemble "stagen" task list
-  id.copyu     = tl["stagen"]->AddTask(&Hydro::CopyCons, this, none);
-  id.flux      = tl["stagen"]->AddTask(&Hydro::Fluxes,this,id.copyu);
-  id.sendf     = tl["stagen"]->AddTask(&Hydro::SendFlux, this, id.flux);
-  id.recvf     = tl["stagen"]->AddTask(&Hydro::RecvFlux, this, id.sendf);
-  id.rkupdt    = tl["stagen"]->AddTask(&Hydro::RKUpdate, this, id.recvf);
-  id.srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, this, id.rkupdt);
-  id.sendu_oa  = tl["stagen"]->AddTask(&Hydro::SendU_OA, this, id.srctrms);
-  id.recvu_oa  = tl["stagen"]->AddTask(&Hydro::RecvU_OA, this, id.sendu_oa);
-  id.restu     = tl["stagen"]->AddTask(&Hydro::RestrictU, this, id.recvu_oa);
-  id.sendu     = tl["stagen"]->AddTask(&Hydro::SendU, this, id.restu);
-  id.recvu     = tl["stagen"]->AddTask(&Hydro::RecvU, this, id.sendu);
-  id.sendu_shr = tl["stagen"]->AddTask(&Hydro::SendU_Shr, this, id.recvu);
-  id.recvu_shr = tl["stagen"]->AddTask(&Hydro::RecvU_Shr, this, id.sendu_shr);
-  id.bcs       = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, this, id.recvu_shr);
-  id.prol      = tl["stagen"]->AddTask(&Hydro::Prolongate, this, id.bcs);
-  id.c2p       = tl["stagen"]->AddTask(&Hydro::ConToPrim, this, id.prol);
-  id.newdt     = tl["stagen"]->AddTask(&Hydro::NewTimeStep, this, id.c2p);
+  // with sparse activation, update list of active MBs once at start of each cycle
+  if (sparse_blocks) {
+    id.sparse = tl["before_timeintegrator"]->AddTask(&Hydro::SetActiveMeshBlocks, this,
+                                                     none, "Hydro::SetActiveMeshBlocks");
+  }
+  // with hybrid reconstruction, select reconstruction of each active MB once per cycle
+  if (use_hybrid_recon) {
+    TaskID dep = (sparse_blocks)? id.sparse : none;
+    id.hybrid = tl["before_timeintegrator"]->AddTask(&Hydro::SelectReconstruction, this,
+                                                     dep, "Hydro::SelectReconstruction");
+  }
 
   // assemble "after_stagen" task list
-  id.csend = tl["after_stagen"]->AddTask(&Hydro::ClearSend, this, none);
+  id.csend = tl["after_stagen"]->AddTask(&Hydro::ClearSend, this, none,
+                                         "Hydro::ClearSend");
   // although RecvFlux/U functions check that all recvs complete, add ClearRecv to
   // task list anyways to catch potential bugs in MPI communication logic
-  id.crecv = tl["after_stagen"]->AddTask(&Hydro::ClearRecv, this, id.csend);
+  id.crecv = tl["after_stagen"]->AddTask(&Hydro::ClearRecv, this, id.csend,
+                                         "Hydro::ClearRecv");
+
+  // super time-stepping of diffusion terms uses separate task lists
+  if (use_sts) {AssembleSTSTasks(tl);}
+
+  // reaction network is integrated over the full timestep after the time integrator
+  if (pchem != nullptr) {
+    id.chem = tl["after_timeintegrator"]->AddTask(&Hydro::ChemistryStep, this, none,
+                                                  "Hydro::ChemistryStep");
+  }
+
+  // assemble "stagen" task list
+  if (overlap_comm) {
+    AssembleOverlappedTasks(tl);
+    return;
+  }
+  if (boundary_first) {
+    AssembleBoundaryFirstTasks(tl);
+    return;
+  }
+  id.copyu     = tl["stagen"]->AddTask(&Hydro::CopyCons, this, none, "Hydro::CopyCons");
+  id.flux      = tl["stagen"]->AddTask(&Hydro::Fluxes,this,id.copyu, "Hydro::Fluxes");
+  id.sendf     = tl["stagen"]->AddTask(&Hydro::SendFlux, this, id.flux,
+                                       "Hydro::SendFlux");
+  id.recvf     = tl["stagen"]->AddTask(&Hydro::RecvFlux, this, id.sendf,
+                                       "Hydro::RecvFlux");
+  id.rkupdt    = tl["stagen"]->AddTask(&Hydro::RKUpdate, this, id.recvf,
+                                       "Hydro::RKUpdate");
+  id.srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, this, id.rkupdt,
+                                       "Hydro::HydroSrcTerms");
+  id.sendu_oa  = tl["stagen"]->AddTask(&Hydro::SendU_OA, this, id.srctrms,
+                                       "Hydro::SendU_OA");
+  id.recvu_oa  = tl["stagen"]->AddTask(&Hydro::RecvU_OA, this, id.sendu_oa,
+                                       "Hydro::RecvU_OA");
+  id.restu     = tl["stagen"]->AddTask(&Hydro::RestrictU, this, id.recvu_oa,
+                                       "Hydro::RestrictU");
+  id.sendu     = tl["stagen"]->AddTask(&Hydro::SendU, this, id.restu, "Hydro::SendU");
+  id.recvu     = tl["stagen"]->AddTask(&Hydro::RecvU, this, id.sendu, "Hydro::RecvU");
+  id.sendu_shr = tl["stagen"]->AddTask(&Hydro::SendU_Shr, this, id.recvu,
+                                       "Hydro::SendU_Shr");
+  id.recvu_shr = tl["stagen"]->AddTask(&Hydro::RecvU_Shr, this, id.sendu_shr,
+                                       "Hydro::RecvU_Shr");
+  id.bcs       = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, this, id.recvu_shr,
+                                       "Hydro::ApplyPhysicalBCs");
+  id.prol      = tl["stagen"]->AddTask(&Hydro::Prolongate, this, id.bcs,
+                                       "Hydro::Prolongate");
+  id.c2p       = tl["stagen"]->AddTask(&Hydro::ConToPrim, this, id.prol,
+                                       "Hydro::ConToPrim");
+  id.newdt     = tl["stagen"]->AddTask(&Hydro::NewTimeStep, this, id.c2p,
+                                       "Hydro::NewTimeStep");
+  // kernels of these tasks can be replayed from device graphs (<time>/task_graphs)
+  tl["stagen"]->SetGraphCapture(id.copyu);
+  tl["stagen"]->SetGraphCapture(id.restu);
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Hydro::AssembleOverlappedTasks
+//! \brief Adds hydro tasks to "stagen" task list when communication of ghost zones is
+//! overlapped with computation (<hydro>/overlap_comm=true).  Ghost zones are exchanged
+//! at the START of each stage, and fluxes on faces whose reconstruction stencil lies
+//! entirely within the active zones are computed while messages are in flight.  Ghost
+//! zones are then filled, primitives computed in the ghost zones only, and the remaining
+//! fluxes computed.  Since the ghost zones are not updated at the end of the last stage,
+//! the Driver must call InitBoundaryValuesAndPrimitives() before any output or AMR.
+//! Tasks are added in the order they should be executed, so that the interior fluxes are
+//! computed before waiting on the receives.
+
+void Hydro::AssembleOverlappedTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
+  TaskID none(0);
+  id.copyu     = tl["stagen"]->AddTask(&Hydro::CopyCons, this, none, "Hydro::CopyCons");
+  id.restu     = tl["stagen"]->AddTask(&Hydro::RestrictU, this, none,
+                                       "Hydro::RestrictU");
+  id.sendu     = tl["stagen"]->AddTask(&Hydro::SendU, this, id.restu, "Hydro::SendU");
+  id.fluxi     = tl["stagen"]->AddTask(&Hydro::FluxesInterior, this, id.copyu,
+                                       "Hydro::FluxesInterior");
+  id.recvu     = tl["stagen"]->AddTask(&Hydro::RecvU, this, id.sendu, "Hydro::RecvU");
+  id.sendu_shr = tl["stagen"]->AddTask(&Hydro::SendU_Shr, this, id.recvu,
+                                       "Hydro::SendU_Shr");
+  id.recvu_shr = tl["stagen"]->AddTask(&Hydro::RecvU_Shr, this, id.sendu_shr,
+                                       "Hydro::RecvU_Shr");
+  id.bcs       = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, this, id.recvu_shr,
+                                       "Hydro::ApplyPhysicalBCs");
+  id.prol      = tl["stagen"]->AddTask(&Hydro::Prolongate, this, id.bcs,
+                                       "Hydro::Prolongate");
+  id.c2ps      = tl["stagen"]->AddTask(&Hydro::ConToPrimShell, this, id.prol,
+                                       "Hydro::ConToPrimShell");
+  TaskID fluxdep = id.fluxi | id.c2ps;
+  id.flux      = tl["stagen"]->AddTask(&Hydro::FluxesShell, this, fluxdep,
+                                       "Hydro::FluxesShell");
+  id.sendf     = tl["stagen"]->AddTask(&Hydro::SendFlux, this, id.flux,
+                                       "Hydro::SendFlux");
+  id.recvf     = tl["stagen"]->AddTask(&Hydro::RecvFlux, this, id.sendf,
+                                       "Hydro::RecvFlux");
+  id.rkupdt    = tl["stagen"]->AddTask(&Hydro::RKUpdate, this, id.recvf,
+                                       "Hydro::RKUpdate");
+  id.srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, this, id.rkupdt,
+                                       "Hydro::HydroSrcTerms");
+  id.sendu_oa  = tl["stagen"]->AddTask(&Hydro::SendU_OA, this, id.srctrms,
+                                       "Hydro::SendU_OA");
+  id.recvu_oa  = tl["stagen"]->AddTask(&Hydro::RecvU_OA, this, id.sendu_oa,
+                                       "Hydro::RecvU_OA");
+  id.c2p       = tl["stagen"]->AddTask(&Hydro::ConToPrimInterior, this, id.recvu_oa,
+                                       "Hydro::ConToPrimInterior");
+  id.newdt     = tl["stagen"]->AddTask(&Hydro::NewTimeStep, this, id.c2p,
+                                       "Hydro::NewTimeStep");
+  // kernels of these tasks can be replayed from device graphs (<time>/task_graphs)
+  tl["stagen"]->SetGraphCapture(id.copyu);
+  tl["stagen"]->SetGraphCapture(id.restu);
+  return;
+}
 
+//----------------------------------------------------------------------------------------
+//! \fn  void Hydro::AssembleBoundaryFirstTasks
+//! \brief Adds hydro tasks to "stagen" task list when MBs with neighbors on other ranks
+//! are updated first (<hydro>/boundary_first=true).  Fluxes and the RK update of these
+//! MBs are computed and their ghost zones sent before the remaining MBs are updated, so
+//! that MPI messages are in flight while the rest of the pack is computed.  Unlike
+//! overlap_comm, this needs no extra ghost-zone primitives, and helps even when the MBs
+//! are too small for interior faces to hide communication.  Tasks are added in the
+//! order they should be executed.
+
+void Hydro::AssembleBoundaryFirstTasks(std::map<std::string, std::shared_ptr<TaskList>>
+                                       tl) {
+  TaskID none(0);
+  id.copyu     = tl["stagen"]->AddTask(&Hydro::CopyCons, this, none, "Hydro::CopyCons");
+  id.rkupdto   = tl["stagen"]->AddTask(&Hydro::UpdateOffRank, this, id.copyu,
+                                       "Hydro::UpdateOffRank");
+  id.sendo     = tl["stagen"]->AddTask(&Hydro::SendUOffRank, this, id.rkupdto,
+                                       "Hydro::SendUOffRank");
+  id.rkupdt    = tl["stagen"]->AddTask(&Hydro::UpdateOnRank, this, id.sendo,
+                                       "Hydro::UpdateOnRank");
+  id.sendu     = tl["stagen"]->AddTask(&Hydro::SendUOnRank, this, id.rkupdt,
+                                       "Hydro::SendUOnRank");
+  id.recvu     = tl["stagen"]->AddTask(&Hydro::RecvU, this, id.sendu, "Hydro::RecvU");
+  id.bcs       = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, this, id.recvu,
+                                       "Hydro::ApplyPhysicalBCs");
+  id.c2p       = tl["stagen"]->AddTask(&Hydro::ConToPrim, this, id.bcs,
+                                       "Hydro::ConToPrim");
+  id.newdt     = tl["stagen"]->AddTask(&Hydro::NewTimeStep, this, id.c2p,
+                                       "Hydro::NewTimeStep");
+  // kernels of these tasks can be replayed from device graphs (<time>/task_graphs)
+  tl["stagen"]->SetGraphCapture(id.copyu);
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn bool Hydro::ExchangeStage
+//! \brief Returns true if ghost zones are exchanged at the end of this stage: after
+//! every stages_per_exchange stages, after the last stage, and always for stage<=0 (ICs)
+
+bool Hydro::ExchangeStage(Driver *pdrive, int stage) {
+  if ((stages_per_exchange == 1) || (stage <= 0)) return true;
+  return ((stage % stages_per_exchange) == 0) || (stage == pdrive->nexp_stages);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int Hydro::HaloExtension
+//! \brief Returns number of ghost cells beyond the active zones in which fluxes and the
+//! RK update are computed in this stage.  Each stage consumes halo_depth cells of valid
+//! ghost zones, so stages before the next exchange must update enough ghost cells for
+//! the remaining stages, and <mesh>/nghost must be at least
+//! halo_depth*(number of stages between exchanges).
+
+int Hydro::HaloExtension(Driver *pdrive, int stage) {
+  if (stages_per_exchange == 1) return 0;
+  int next = ((stage + stages_per_exchange - 1)/stages_per_exchange)*stages_per_exchange;
+  if (next > pdrive->nexp_stages) {next = pdrive->nexp_stages;}
+  int ext = (next - stage)*halo_depth;
+  if (ext + halo_depth > pmy_pack->pmesh->mb_indcs.ng) {
+    int nstg = std::min(stages_per_exchange, pdrive->nexp_stages);
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<hydro>/stages_per_exchange=" << stages_per_exchange
+      << " requires <mesh>/nghost >= " << nstg*halo_depth << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  return ext;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskList Hydro::InitRecv
 //! \brief Wrapper task list function to post non-blocking receives (with MPI), and
 //! initialize all boundary receive status flags to waiting (with or without MPI).
 
 TaskStatus Hydro::InitRecv(Driver *pdrive, int stage) {
+  // no communication in stages that update ghost zones redundantly
+  if (!(ExchangeStage(pdrive, stage))) return TaskStatus::complete;
+
   // post receives for U
   TaskStatus tstat = pbval_u->InitRecv(nhydro+nscalars);
   if (tstat != TaskStatus::complete) return tstat;
@@ -125,18 +302,54 @@ TaskStatus Hydro::InitRecv(Driver *pdrive, int stage) {
 //----------------------------------------------------------------------------------------
 //! \fn  void Hydro::CopyCons
 //! \brief Simple task list function that copies u0 --> u1 in first stage.  Extended to
-//!  handle RK register logic at given stage
+//!  handle RK register logic at given stage.  With u1_release_cycles, u1 only has slots
+//!  for non-cold MBs, and only active MBs (which are never cold) are copied.
 
 TaskStatus Hydro::CopyCons(Driver *pdrive, int stage) {
+  if (u1_release_cycles > 0) {
+    if (stage == 1 || pdrive->use_delta) {
+      auto &indcs = pmy_pack->pmesh->mb_indcs;
+      int ncells1 = indcs.nx1 + 2*(indcs.ng);
+      int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+      int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+      int nmb1 = ActiveMeshBlocks() - 1;
+      int nvar = nhydro + nscalars;
+      auto &amb_ = active_mbs;
+      auto &u1s_ = u1_slot;
+      auto &u0_ = u0;
+      auto &u1_ = u1;
+      Real delta = (stage == 1)? 0.0 : pdrive->delta[stage-1];
+      bool first = (stage == 1);
+      par_for("cold_copy_cons", TaskExecSpace(), 0, nmb1, 0, nvar-1, 0, (ncells3-1),
+              0, (ncells2-1), 0, (ncells1-1),
+      KOKKOS_LAMBDA(int ma, int n, int k, int j, int i) {
+        const int m = amb_.d_view(ma);
+        const int s = u1s_.d_view(m);
+        if (first) {
+          u1_(s,n,k,j,i) = u0_(m,n,k,j,i);
+        } else {
+          u1_(s,n,k,j,i) += delta*u0_(m,n,k,j,i);
+        }
+      });
+    }
+    return TaskStatus::complete;
+  }
   if (stage == 1) {
-    Kokkos::deep_copy(DevExeSpace(), u1, u0);
+    // copies use the instance bound to this Task, so they can be captured in graphs
+    const DevExeSpace exec_inst = TaskExecSpace();
+    Kokkos::deep_copy(exec_inst, u1, u0);
+    // save state at start of step in case step is rejected
+    if (pdrive->adaptive_dt) {Kokkos::deep_copy(exec_inst, u_start, u0);}
   } else {
-    if (pdrive->integrator == "rk4") {
-      // parallel loop to update u1 with u0 at later stages, only for rk4
+    if (pdrive->use_delta) {
+      // parallel loop to update u1 with u0 at later stages (e.g. rk4, ssprk104)
       auto &indcs = pmy_pack->pmesh->mb_indcs;
-      int is = indcs.is, ie = indcs.ie;
-      int js = indcs.js, je = indcs.je;
-      int ks = indcs.ks, ke = indcs.ke;
+      int ext = HaloExtension(pdrive, stage);
+      int ext2 = (pmy_pack->pmesh->multi_d)? ext : 0;
+      int ext3 = (pmy_pack->pmesh->three_d)? ext : 0;
+      int is = indcs.is - ext, ie = indcs.ie + ext;
+      int js = indcs.js - ext2, je = indcs.je + ext2;
+      int ks = indcs.ks - ext3, ke = indcs.ke + ext3;
       int nmb1 = pmy_pack->nmb_thispack - 1;
       int nvar = nhydro + nscalars;
       auto &u0 = pmy_pack->phydro->u0;
@@ -157,34 +370,62 @@ TaskStatus Hydro::CopyCons(Driver *pdrive, int stage) {
 //! of conserved variables
 
 TaskStatus Hydro::Fluxes(Driver *pdrive, int stage) {
-  // select which calculate_flux function to call based on rsolver_method
-  if (rsolver_method == Hydro_RSolver::advect) {
-    CalculateFluxes<Hydro_RSolver::advect>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::llf) {
-    CalculateFluxes<Hydro_RSolver::llf>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hlle) {
-    CalculateFluxes<Hydro_RSolver::hlle>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hllc) {
-    CalculateFluxes<Hydro_RSolver::hllc>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::roe) {
-    CalculateFluxes<Hydro_RSolver::roe>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::llf_sr) {
-    CalculateFluxes<Hydro_RSolver::llf_sr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hlle_sr) {
-    CalculateFluxes<Hydro_RSolver::hlle_sr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hllc_sr) {
-    CalculateFluxes<Hydro_RSolver::hllc_sr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::llf_gr) {
-    CalculateFluxes<Hydro_RSolver::llf_gr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hlle_gr) {
-    CalculateFluxes<Hydro_RSolver::hlle_gr>(pdrive, stage);
-  }
-
-  // Add viscous, heat-flux, etc fluxes
-  if (pvisc != nullptr) {
-    pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
-  }
-  if (pcond != nullptr) {
+  // with fused update, fluxes are computed in RKUpdate
+  if (use_fused_update) return TaskStatus::complete;
+  return FluxesInRegion(pdrive, stage, BlockRegion::all);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::FluxesInterior
+//! \brief Wrapper task list function that computes fluxes on faces that depend only on
+//! active zones.  Used when communication is overlapped with computation.
+
+TaskStatus Hydro::FluxesInterior(Driver *pdrive, int stage) {
+  return FluxesInRegion(pdrive, stage, BlockRegion::interior);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::FluxesShell
+//! \brief Wrapper task list function that computes fluxes on faces not computed by
+//! FluxesInterior, then adds diffusive fluxes and FOFC over all faces.
+
+TaskStatus Hydro::FluxesShell(Driver *pdrive, int stage) {
+  return FluxesInRegion(pdrive, stage, BlockRegion::shell);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::FluxesInRegion
+//! \brief Computes fluxes over faces in given region.  Diffusive fluxes and FOFC need
+//! primitives in the ghost zones, so they are only added for the all and shell regions.
+//! With hybrid reconstruction, MBs using recon_lo are computed with it only on interior
+//! faces, and with recon_method on the shell.
+
+TaskStatus Hydro::FluxesInRegion(Driver *pdrive, int stage, BlockRegion region) {
+  // call flux kernel selected for this RS, reconstruction method, and EOS
+  if (use_hybrid_recon) {
+    flux_mbs_ = recon_hi_mbs;
+    nmb_flux_ = nmb_recon_hi;
+    (this->*flux_kernel)(pdrive, stage, region);
+    flux_mbs_ = recon_lo_mbs;
+    nmb_flux_ = nmb_recon_lo;
+    if (region != BlockRegion::shell) {
+      (this->*flux_kernel_lo)(pdrive, stage, BlockRegion::interior);
+    }
+    if (region != BlockRegion::interior) {
+      (this->*flux_kernel)(pdrive, stage, BlockRegion::shell);
+    }
+  } else {
+    flux_mbs_ = active_mbs;
+    nmb_flux_ = ActiveMeshBlocks();
+    (this->*flux_kernel)(pdrive, stage, region);
+  }
+  if (region == BlockRegion::interior) return TaskStatus::complete;
+
+  // Add viscous, heat-flux, etc fluxes (unless integrated with STS)
+  if ((pvisc != nullptr) && !(use_sts)) {
+    pvisc->AddViscousFlux(w0, peos->eos_data, uflx);
+  }
+  if ((pcond != nullptr) && !(use_sts)) {
     pcond->AddHeatFlux(w0, peos->eos_data, uflx);
   }
 
@@ -197,9 +438,65 @@ TaskStatus Hydro::Fluxes(Driver *pdrive, int stage) {
     }
   }
 
+  // fluxes of passive scalars from final mass fluxes, over all faces
+  if (separate_scalars && (nscalars > 0)) {
+    flux_mbs_ = active_mbs;
+    nmb_flux_ = ActiveMeshBlocks();
+    CalculateScalarFluxes(pdrive, stage);
+  }
+
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::UpdateOffRank
+//! \brief Wrapper task list function that computes fluxes and the RK update of MBs with
+//! neighbors on other ranks (with boundary_first)
+
+TaskStatus Hydro::UpdateOffRank(Driver *pdrive, int stage) {
+  return UpdateInRegion(pdrive, stage, PackRegion::offrank);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::UpdateOnRank
+//! \brief Wrapper task list function that computes fluxes and the RK update of all other
+//! MBs (with boundary_first)
+
+TaskStatus Hydro::UpdateOnRank(Driver *pdrive, int stage) {
+  return UpdateInRegion(pdrive, stage, PackRegion::onrank);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::UpdateInRegion
+//! \brief Computes fluxes and the RK update of the MBs in given region, by temporarily
+//! replacing the list of active MBs looped over by the flux and update kernels.  The list
+//! of all MBs is restored after the onrank MBs, which are always updated last.
+
+TaskStatus Hydro::UpdateInRegion(Driver *pdrive, int stage, PackRegion region) {
+  auto &pmb = pmy_pack->pmb;
+  if (region == PackRegion::offrank) {
+    ActiveMeshBlocks();  // reset list of all MBs if MBs have changed
+    all_mbs_ = active_mbs;
+    active_mbs = pmb->offrank_mbs;
+    nmb_active = pmb->nmb_offrank;
+  } else {
+    active_mbs = pmb->onrank_mbs;
+    nmb_active = pmb->nmb_onrank;
+  }
+
+  TaskStatus tstat = TaskStatus::complete;
+  if (nmb_active > 0) {
+    FluxesInRegion(pdrive, stage, BlockRegion::all);
+    tstat = RKUpdate(pdrive, stage);
+  }
+
+  if (region == PackRegion::onrank) {
+    active_mbs = all_mbs_;
+    nmb_active = pmy_pack->nmb_thispack;
+  }
+  return tstat;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskList Hydro::SendFlux
 //! \brief Wrapper task list function to pack/send restricted values of fluxes of
@@ -237,13 +534,15 @@ TaskStatus Hydro::RecvFlux(Driver *pdrive, int stage) {
 TaskStatus Hydro::HydroSrcTerms(Driver *pdrive, int stage) {
   Real beta_dt = (pdrive->beta[stage-1])*(pmy_pack->pmesh->dt);
 
-  // Add source terms for various physics.  Must be computed from primitives.
-  if (psrc->const_accel)  psrc->ConstantAccel(w0, peos->eos_data,  beta_dt, u0);
-  if (psrc->ism_cooling)  psrc->ISMCooling(w0, peos->eos_data, beta_dt, u0);
-  if (psrc->rel_cooling)  psrc->RelCooling(w0, peos->eos_data, beta_dt, u0);
-
-  // Add shearing box source terms for cell-centered hydro variables
-  if (psbox_u != nullptr) psbox_u->SourceTermsCC(w0, peos->eos_data, beta_dt, u0);
+  // Add source terms for various physics, and shearing box source terms for
+  // cell-centered hydro variables, in one kernel.  Must be computed from primitives.
+  // Skipped if pgen applies them together with its own terms in user_srcs_func.
+  auto &pgen = pmy_pack->pmesh->pgen;
+  if (!(pgen->user_srcs && pgen->user_srcs_fused) && (psrc->const_accel ||
+      psrc->ism_cooling || psrc->tab_cooling || psrc->rel_cooling ||
+      psbox_u != nullptr)) {
+    psrc->AddSrcTerms(w0, peos->eos_data, beta_dt, psbox_u, u0);
+  }
 
   // Add coordinate source terms in GR.  Again, must be computed with only primitives.
   if (pmy_pack->pcoord->is_general_relativistic) {
@@ -258,6 +557,17 @@ TaskStatus Hydro::HydroSrcTerms(Driver *pdrive, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::ChemistryStep
+//! \brief Wrapper task list function to integrate the reaction network over the full
+//! timestep, operator split from the time integrator.  Updates both u0 and w0 in all
+//! cells, including ghost zones, so no further communication is needed.
+
+TaskStatus Hydro::ChemistryStep(Driver *pdrive, int stage) {
+  pchem->Integrate(w0, u0, peos->eos_data, nhydro, pmy_pack->pmesh->dt);
+  return TaskStatus::complete;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskList Hydro::SendU_OA
 //! \brief Wrapper task list function to pack/send data for orbital advection
@@ -308,15 +618,37 @@ TaskStatus Hydro::RestrictU(Driver *pdrive, int stage) {
 //! \brief Wrapper task list function to pack/send cell-centered conserved variables
 
 TaskStatus Hydro::SendU(Driver *pdrive, int stage) {
+  if (!(ExchangeStage(pdrive, stage))) return TaskStatus::complete;
   TaskStatus tstat = pbval_u->PackAndSendCC(u0, coarse_u0);
   return tstat;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::SendUOffRank
+//! \brief Wrapper task list function to pack/send cell-centered conserved variables of
+//! MBs with neighbors on other ranks, including all MPI messages (with boundary_first)
+
+TaskStatus Hydro::SendUOffRank(Driver *pdrive, int stage) {
+  if (!(ExchangeStage(pdrive, stage))) return TaskStatus::complete;
+  return pbval_u->PackAndSendCC(u0, coarse_u0, PackRegion::offrank);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::SendUOnRank
+//! \brief Wrapper task list function to copy cell-centered conserved variables of all
+//! other MBs into the receive buffers of their neighbors (with boundary_first)
+
+TaskStatus Hydro::SendUOnRank(Driver *pdrive, int stage) {
+  if (!(ExchangeStage(pdrive, stage))) return TaskStatus::complete;
+  return pbval_u->PackAndSendCC(u0, coarse_u0, PackRegion::onrank);
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskList Hydro::RecvU
 //! \brief Wrapper task list function to receive/unpack cell-centered conserved variables
 
 TaskStatus Hydro::RecvU(Driver *pdrive, int stage) {
+  if (!(ExchangeStage(pdrive, stage))) return TaskStatus::complete;
   TaskStatus tstat = pbval_u->RecvAndUnpackCC(u0, coarse_u0);
   return tstat;
 }
@@ -379,9 +711,7 @@ TaskStatus Hydro::Prolongate(Driver *pdrive, int stage) {
   if (pmy_pack->pmesh->multilevel) {  // only prolongate with SMR/AMR
     pbval_u->FillCoarseInBndryCC(u0, coarse_u0);
     if (pmy_pack->pmesh->pmr->prolong_prims) {
-      pbval_u->ConsToPrimCoarseBndry(coarse_u0, coarse_w0);
-      pbval_u->ProlongateCC(w0, coarse_w0);
-      pbval_u->PrimToConsFineBndry(w0, u0);
+      pbval_u->ProlongatePrimsCC(u0, coarse_u0, w0);
     } else {
       pbval_u->ProlongateCC(u0, coarse_u0);
     }
@@ -391,7 +721,8 @@ TaskStatus Hydro::Prolongate(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn TaskList Hydro::ConToPrim
-//! \brief Wrapper task list function to call ConsToPrim over entire mesh (including gz)
+//! \brief Wrapper task list function to call ConsToPrim over entire mesh (including gz).
+//! With fused_newdt, the signal speeds for NewTimeStep are reduced in the last stage.
 
 TaskStatus Hydro::ConToPrim(Driver *pdrive, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -399,10 +730,59 @@ TaskStatus Hydro::ConToPrim(Driver *pdrive, int stage) {
   int n1m1 = indcs.nx1 + 2*ng - 1;
   int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
   int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  // active cells already converted by RKUpdateC2P in this stage (fused_c2p)
+  if (c2p_fused_) {
+    c2p_fused_ = false;
+    ConToPrimInRegion(BlockRegion::shell);
+    return TaskStatus::complete;
+  }
+  peos->newdt_in_c2p = use_fused_newdt && (stage == pdrive->nexp_stages);
+  peos->newdt_kinematic = (pdrive->time_evolution == TimeEvolution::kinematic);
   peos->ConsToPrim(u0, w0, false, 0, n1m1, 0, n2m1, 0, n3m1);
+  peos->newdt_in_c2p = false;
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::ConToPrimInterior
+//! \brief Wrapper task list function to call ConsToPrim over active zones only.  Used
+//! when communication is overlapped with computation.
+
+TaskStatus Hydro::ConToPrimInterior(Driver *pdrive, int stage) {
+  ConToPrimInRegion(BlockRegion::interior);
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::ConToPrimShell
+//! \brief Wrapper task list function to call ConsToPrim over ghost zones only.  Used
+//! when communication is overlapped with computation.
+
+TaskStatus Hydro::ConToPrimShell(Driver *pdrive, int stage) {
+  ConToPrimInRegion(BlockRegion::shell);
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::ConToPrimInRegion
+//! \brief Calls ConsToPrim over each box of cells in given region of MeshBlocks
+
+void Hydro::ConToPrimInRegion(BlockRegion region) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &ng = indcs.ng;
+  int n1m1 = indcs.nx1 + 2*ng - 1;
+  int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
+  int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  IndexBox cbox[6];
+  int nbox = BlockRegionBoxes(region, {0, n1m1, 0, n2m1, 0, n3m1},
+               {indcs.is, indcs.ie, indcs.js, indcs.je, indcs.ks, indcs.ke}, cbox);
+  for (int b=0; b<nbox; ++b) {
+    peos->ConsToPrim(u0, w0, false, cbox[b].il, cbox[b].iu, cbox[b].jl, cbox[b].ju,
+                     cbox[b].kl, cbox[b].ku);
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskList Hydro::ClearSend
 //! \brief Wrapper task list function that checks all MPI sends have completed. Used in
@@ -413,6 +793,7 @@ TaskStatus Hydro::ConToPrim(Driver *pdrive, int stage) {
 //! If stage=(-4):              clears sends of                 U_Shr
 
 TaskStatus Hydro::ClearSend(Driver *pdrive, int stage) {
+  if (!(ExchangeStage(pdrive, stage))) return TaskStatus::complete;
   TaskStatus tstat;
   // check sends of U complete
   if ((stage >= 0) || (stage == -1)) {
@@ -460,6 +841,7 @@ TaskStatus Hydro::ClearSend(Driver *pdrive, int stage) {
 //! If stage=(-4):              clears recvs of                 U_Shr
 
 TaskStatus Hydro::ClearRecv(Driver *pdrive, int stage) {
+  if (!(ExchangeStage(pdrive, stage))) return TaskStatus::complete;
   TaskStatus tstat;
   // check receives of U complete
   if ((stage >= 0) || (stage == -1)) {
@@ -9,10 +9,16 @@
 //! average and partial time step update of flux divergence. Source terms are added in
 //! the HydroSrcTerms() function.
 
+#include <limits>
+
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
 #include "eos/eos.hpp"
+#include "eos/ideal_c2p_hyd.hpp"
+#include "eos/newdt_c2p.hpp"
+#include "coordinates/coordinates.hpp"
+#include "pgen/pgen.hpp"
 #include "hydro.hpp"
 
 namespace hydro {
@@ -21,21 +27,55 @@ namespace hydro {
 //  \brief Explicit RK update including flux divergence terms
 
 TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
+  // fluxes are computed on the fly with fused update
+  if (use_fused_update) {return FusedRKUpdate(pdriver, stage);}
+  if (pmy_pack->pcoord->coord_data.system != CoordSystem::cartesian) {
+    return CurvilinearRKUpdate(pdriver, stage);
+  }
+  // user source terms modify u0 after the update, so C2P cannot be fused with it
+  if (use_fused_c2p && !(pmy_pack->pmesh->pgen->user_srcs)) {
+    return RKUpdateC2P(pdriver, stage);
+  }
+  return (this->*update_kernel)(pdriver, stage);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  Hydro::UpdateKernel Hydro::SelectUpdateKernel
+//  \brief Returns the RK update kernel compiled for the dimensionality of the Mesh
+
+Hydro::UpdateKernel Hydro::SelectUpdateKernel() {
+  if (pmy_pack->pmesh->three_d) {return &Hydro::CartesianRKUpdate<3>;}
+  if (pmy_pack->pmesh->multi_d) {return &Hydro::CartesianRKUpdate<2>;}
+  return &Hydro::CartesianRKUpdate<1>;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Hydro::CartesianRKUpdate
+//  \brief Explicit RK update including flux divergence terms in Cartesian coordinates.
+//  Templated over the number of dimensions ndim_, so that the flux differences in unused
+//  directions are removed at compile time.
+
+template <int ndim_>
+TaskStatus Hydro::CartesianRKUpdate(Driver *pdriver, int stage) {
+  // update also extends into ghost zones in stages without exchange of ghost zones
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  int is = indcs.is, ie = indcs.ie;
-  int js = indcs.js, je = indcs.je;
-  int ks = indcs.ks, ke = indcs.ke;
+  int ext = HaloExtension(pdriver, stage);
+  int ext2 = (ndim_ > 1)? ext : 0;
+  int ext3 = (ndim_ > 2)? ext : 0;
+  int is = indcs.is - ext, ie = indcs.ie + ext;
+  int js = indcs.js - ext2, je = indcs.je + ext2;
+  int ks = indcs.ks - ext3, ke = indcs.ke + ext3;
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
-  bool &multi_d = pmy_pack->pmesh->multi_d;
-  bool &three_d = pmy_pack->pmesh->three_d;
 
   Real &gam0 = pdriver->gam0[stage-1];
   Real &gam1 = pdriver->gam1[stage-1];
   Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
-  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nmb1 = ActiveMeshBlocks() - 1;  // only update active MBs
+  auto &amb_ = active_mbs;
   int nvar = nhydro + nscalars;
   auto u0_ = u0;
   auto u1_ = u1;
+  auto &u1s_ = u1_slot;  // slot of each MB in u1
   auto flx1 = uflx.x1f;
   auto flx2 = uflx.x2f;
   auto flx3 = uflx.x3f;
@@ -48,7 +88,10 @@ TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
   size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
 
   par_for_outer("h_update",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nvar-1,ks,ke,js,je,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int j) {
+  KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int n, const int k,
+                const int j) {
+    const int m = amb_.d_view(ma);
+    const int s = u1s_.d_view(m);
     ScrArray1D<Real> divf(member.team_scratch(scr_level), ncells1);
 
     // compute dF1/dx1
@@ -59,7 +102,7 @@ TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
 
     // Add dF2/dx2
     // Fluxes must be summed in pairs to symmetrize round-off error in each dir
-    if (multi_d) {
+    if constexpr (ndim_ > 1) {
       par_for_inner(member, is, ie, [&](const int i) {
         divf(i) += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
       });
@@ -68,7 +111,7 @@ TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
 
     // Add dF3/dx3
     // Fluxes must be summed in pairs to symmetrize round-off error in each dir
-    if (three_d) {
+    if constexpr (ndim_ > 2) {
       par_for_inner(member, is, ie, [&](const int i) {
         divf(i) += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
       });
@@ -76,9 +119,146 @@ TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
     }
 
     par_for_inner(member, is, ie, [&](const int i) {
-      u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(m,n,k,j,i) - beta_dt*divf(i);
+      u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(s,n,k,j,i) - beta_dt*divf(i);
     });
   });
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Hydro::RKUpdateC2P
+//  \brief Explicit RK update including flux divergence terms, fused with the conversion
+//  to primitives (ideal gas EOS) in the same kernel, so that u0 is read once.  Only the
+//  active cells (and any ghost cells updated redundantly) are converted here, and
+//  ConToPrim then only converts the remaining ghost cells.  With fused_newdt, the signal
+//  speeds for NewTimeStep are also reduced in the last stage.
+
+TaskStatus Hydro::RKUpdateC2P(Driver *pdriver, int stage) {
+  // update also extends into ghost zones in stages without exchange of ghost zones
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ext = HaloExtension(pdriver, stage);
+  int ext2 = (pmy_pack->pmesh->multi_d)? ext : 0;
+  int ext3 = (pmy_pack->pmesh->three_d)? ext : 0;
+  int is = indcs.is - ext, ie = indcs.ie + ext;
+  int js = indcs.js - ext2, je = indcs.je + ext2;
+  int ks = indcs.ks - ext3, ke = indcs.ke + ext3;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  int nmb = ActiveMeshBlocks();  // only update active MBs
+  auto &amb_ = active_mbs;
+  int &nhyd = nhydro;
+  int &nscal = nscalars;
+  auto u0_ = u0;
+  auto u1_ = u1;
+  auto &u1s_ = u1_slot;  // slot of each MB in u1
+  auto w0_ = w0;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &eos = peos->eos_data;
+
+  // with fused_newdt, also reduce signal-crossing times over the active cells
+  bool newdt_ = use_fused_newdt && (stage == pdriver->nexp_stages);
+  bool kinematic_ = (pdriver->time_evolution == TimeEvolution::kinematic);
+  const CoordSystem sys = pmy_pack->pcoord->coord_data.system;
+  Real dt1 = std::numeric_limits<float>::max();
+  Real dt2 = std::numeric_limits<float>::max();
+  Real dt3 = std::numeric_limits<float>::max();
+
+  const int ni   = (ie - is + 1);
+  const int nji  = (je - js + 1)*ni;
+  const int nkji = (ke - ks + 1)*nji;
+  const int nmkji = nmb*nkji;
+
+  int nfloord_=0, nfloore_=0, nfloort_=0;
+  auto &evc = pmy_pack->pmesh->ecounter.mb;
+  Kokkos::parallel_reduce("h_update_c2p",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumt,
+                Real &min_dt1, Real &min_dt2, Real &min_dt3) {
+    int ma = (idx)/nkji;
+    int k = (idx - ma*nkji)/nji;
+    int j = (idx - ma*nkji - k*nji)/ni;
+    int i = (idx - ma*nkji - k*nji - j*ni) + is;
+    int m = amb_.d_view(ma);
+    const int s = u1s_.d_view(m);
+    j += js;
+    k += ks;
+
+    // RK update.  Fluxes must be summed in pairs to symmetrize round-off error in each
+    // dir, in the same order as in RKUpdate
+    for (int n=0; n<(nhyd+nscal); ++n) {
+      Real divf = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
+      if (multi_d) {
+        divf += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+      }
+      if (three_d) {
+        divf += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+      }
+      u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(s,n,k,j,i) - beta_dt*divf;
+    }
+
+    // C2P of updated state, as in IdealHydro::ConsToPrim
+    HydCons1D u;
+    u.d  = u0_(m,IDN,k,j,i);
+    u.mx = u0_(m,IM1,k,j,i);
+    u.my = u0_(m,IM2,k,j,i);
+    u.mz = u0_(m,IM3,k,j,i);
+    u.e  = u0_(m,IEN,k,j,i);
+    HydPrim1D w;
+    bool dfloor_used=false, efloor_used=false, tfloor_used=false;
+    SingleC2P_IdealHyd(u, eos, w, dfloor_used, efloor_used, tfloor_used);
+    if (dfloor_used) {
+      u0_(m,IDN,k,j,i) = u.d;
+      sumd++;
+      Kokkos::atomic_add(&evc(m,EVC_DFLOOR), 1);
+    }
+    if (efloor_used) {
+      u0_(m,IEN,k,j,i) = u.e;
+      sume++;
+      Kokkos::atomic_add(&evc(m,EVC_EFLOOR), 1);
+    }
+    if (tfloor_used) {
+      u0_(m,IEN,k,j,i) = u.e;
+      sumt++;
+      Kokkos::atomic_add(&evc(m,EVC_TFLOOR), 1);
+    }
+    w0_(m,IDN,k,j,i) = w.d;
+    w0_(m,IVX,k,j,i) = w.vx;
+    w0_(m,IVY,k,j,i) = w.vy;
+    w0_(m,IVZ,k,j,i) = w.vz;
+    w0_(m,IEN,k,j,i) = w.e;
+    for (int n=nhyd; n<(nhyd+nscal); ++n) {
+      if (u0_(m,n,k,j,i) < 0.0) {
+        u0_(m,n,k,j,i) = 0.0;
+      }
+      w0_(m,n,k,j,i) = u0_(m,n,k,j,i)/u.d;
+    }
+
+    // signal-crossing times (fused_newdt)
+    if (newdt_) {
+      Real cs = (kinematic_)? 0.0 :
+                eos.IdealHydroSoundSpeed(w.d, eos.IdealGasPressure(w.e));
+      CellNewDt(sys, mbsize.d_view(m), indcs, k, j, i, fabs(w.vx) + cs,
+                fabs(w.vy) + cs, fabs(w.vz) + cs, min_dt1, min_dt2, min_dt3);
+    }
+  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nfloort_),
+  Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2), Kokkos::Min<Real>(dt3));
+
+  pmy_pack->pmesh->ecounter.neos_dfloor += nfloord_;
+  pmy_pack->pmesh->ecounter.neos_efloor += nfloore_;
+  pmy_pack->pmesh->ecounter.neos_tfloor += nfloort_;
+  if (newdt_) {
+    peos->newdt[0] = dt1;
+    peos->newdt[1] = dt2;
+    peos->newdt[2] = dt3;
+    peos->newdt_done = true;
+  }
+  c2p_fused_ = true;
+  return TaskStatus::complete;
+}
 } // namespace hydro
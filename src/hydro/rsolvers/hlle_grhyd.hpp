@@ -22,20 +22,22 @@ namespace hydro {
 //! \fn void HLLE_GR
 //! \brief HLLE for GR hydrodynamics
 
+template <typename FlxArray>
 KOKKOS_INLINE_FUNCTION
 void HLLE_GR(TeamMember_t const &member, const EOS_Data &eos,
      const RegionIndcs &indcs,const DualArray1D<RegionSize> &size,const CoordData &coord,
      const int m, const int k, const int j, const int il, const int iu, const int ivx,
-     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, DvceArray5D<Real> flx) {
+     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, FlxArray flx) {
   int ivy = IVX + ((ivx-IVX)+1)%3;
   int ivz = IVX + ((ivx-IVX)+2)%3;
   const Real gamma_prime = eos.gamma/(eos.gamma - 1.0);
   auto &flat = coord.is_minkowski;
   auto &spin = coord.bh_spin;
 
-  int is = indcs.is;
-  int js = indcs.js;
-  int ks = indcs.ks;
+  // positions in transverse directions are the same for all i
+  const MBLocations loc = LoadMBLocations(size.d_view(m), indcs);
+  const Real x2j = (ivx == IVY)? loc.x2f(j) : loc.x2v(j);
+  const Real x3k = (ivx == IVZ)? loc.x3f(k) : loc.x3v(k);
   par_for_inner(member, il, iu, [&](const int i) {
     // References to left primitives
     Real &wl_idn=wl(IDN,i);
@@ -54,28 +56,15 @@ void HLLE_GR(TeamMember_t const &member, const EOS_Data &eos,
     wr_ipr = eos.IdealGasPressure(wr(IEN,i));
 
     // Extract components of metric
-    Real &x1min = size.d_view(m).x1min;
-    Real &x1max = size.d_view(m).x1max;
-    Real &x2min = size.d_view(m).x2min;
-    Real &x2max = size.d_view(m).x2max;
-    Real &x3min = size.d_view(m).x3min;
-    Real &x3max = size.d_view(m).x3max;
-    Real x1v,x2v,x3v;
-    if (ivx == IVX) {
-      x1v = LeftEdgeX  (i-is, indcs.nx1, x1min, x1max);
-      x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
-      x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
-    } else if (ivx == IVY) {
-      x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
-      x2v = LeftEdgeX  (j-js, indcs.nx2, x2min, x2max);
-      x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+    Real x1v = (ivx == IVX)? loc.x1f(i) : loc.x1v(i);
+    Real x2v = x2j, x3v = x3k;
+    Real glower[4][4], gupper[4][4];
+    if (coord.metric_cached) {
+      auto &gf = (ivx == IVX)? coord.gx1f : ((ivx == IVY)? coord.gx2f : coord.gx3f);
+      LoadMetric(coord, gf, m, k, j, i, glower, gupper);
     } else {
-      x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
-      x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
-      x3v = LeftEdgeX  (k-ks, indcs.nx3, x3min, x3max);
+      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
     }
-    Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
 
     // Calculate 4-velocity in left state (contravariant compt)
     Real q = glower[ivx][ivx] * SQR(wl_ivx) + glower[ivy][ivy] * SQR(wl_ivy) +
@@ -0,0 +1,76 @@
+#ifndef HYDRO_RSOLVERS_HYDRO_RSOLVER_HPP_
+#define HYDRO_RSOLVERS_HYDRO_RSOLVER_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hydro_rsolver.hpp
+//! \brief selects hydro Riemann solver at compile time, and computes fluxes of passive
+//! scalars.  Used by flux kernels that call Riemann solvers in more than one place.
+
+#include "hydro/rsolvers/advect_hyd.hpp"
+#include "hydro/rsolvers/llf_hyd.hpp"
+#include "hydro/rsolvers/hlle_hyd.hpp"
+#include "hydro/rsolvers/hllc_hyd.hpp"
+#include "hydro/rsolvers/roe_hyd.hpp"
+#include "hydro/rsolvers/llf_srhyd.hpp"
+#include "hydro/rsolvers/hlle_srhyd.hpp"
+#include "hydro/rsolvers/hllc_srhyd.hpp"
+#include "hydro/rsolvers/llf_grhyd.hpp"
+#include "hydro/rsolvers/hlle_grhyd.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn void RiemannSolve
+//! \brief Calls Riemann solver selected by template parameter over faces [il,iu], then
+//! computes fluxes of passive scalars (if any) by upwinding.  Flux array can be either a
+//! DvceArray5D or any type with the same (m,n,k,j,i) access operator.
+
+template <Hydro_RSolver rsolver_method_, typename FlxArray>
+KOKKOS_INLINE_FUNCTION
+void RiemannSolve(TeamMember_t const &member, const EOS_Data &eos,
+     const RegionIndcs &indcs, const DualArray1D<RegionSize> &size,
+     const CoordData &coord, const int m, const int k, const int j, const int il,
+     const int iu, const int ivx, const int nhyd, const int nvars,
+     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, FlxArray flx) {
+  if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
+    Advect(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
+    LLF(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
+    HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
+    HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
+    Roe(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
+    LLF_SR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
+    HLLE_SR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
+    HLLC_SR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
+    LLF_GR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
+    HLLE_GR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  }
+  member.team_barrier();
+
+  // calculate fluxes of scalars (if any)
+  if (nvars > nhyd) {
+    for (int n=nhyd; n<nvars; ++n) {
+      par_for_inner(member, il, iu, [&](const int i) {
+        if (flx(m,IDN,k,j,i) >= 0.0) {
+          flx(m,n,k,j,i) = flx(m,IDN,k,j,i)*wl(n,i);
+        } else {
+          flx(m,n,k,j,i) = flx(m,IDN,k,j,i)*wr(n,i);
+        }
+      });
+    }
+    member.team_barrier();
+  }
+  return;
+}
+} // namespace hydro
+#endif // HYDRO_RSOLVERS_HYDRO_RSOLVER_HPP_
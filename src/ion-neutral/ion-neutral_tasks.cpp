@@ -36,54 +36,72 @@ void IonNeutral::AssembleIonNeutralTasks(
   Hydro *phyd = pmy_pack->phydro;
 
   // assemble "before_stagen_tl" task list
-  id.i_irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, pmhd, none);
-  id.n_irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, phyd, none);
+  id.i_irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, pmhd, none, "MHD::InitRecv");
+  id.n_irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, phyd, none,
+                                            "Hydro::InitRecv");
 
   // assemble "stagen_tl" task list
   // FirstTwoImpRK task does CopyCons
-  id.impl_2x = tl["stagen"]->AddTask(&IonNeutral::FirstTwoImpRK, this, none);
-
-  id.i_flux   = tl["stagen"]->AddTask(&MHD::Fluxes, pmhd, id.impl_2x);
-  id.i_sendf  = tl["stagen"]->AddTask(&MHD::SendFlux, pmhd, id.i_flux);
-  id.i_recvf  = tl["stagen"]->AddTask(&MHD::RecvFlux, pmhd, id.i_sendf);
-  id.i_rkupdt = tl["stagen"]->AddTask(&MHD::RKUpdate, pmhd, id.i_recvf);
-  id.i_srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, pmhd, id.i_rkupdt);
-
-  id.n_flux   = tl["stagen"]->AddTask(&Hydro::Fluxes, phyd, id.i_srctrms);
-  id.n_sendf  = tl["stagen"]->AddTask(&Hydro::SendFlux, phyd, id.n_flux);
-  id.n_recvf  = tl["stagen"]->AddTask(&Hydro::RecvFlux, phyd, id.n_sendf);
-  id.n_rkupdt = tl["stagen"]->AddTask(&Hydro::RKUpdate, phyd, id.n_recvf);
-  id.n_srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, phyd, id.n_rkupdt);
-
-  id.impl     = tl["stagen"]->AddTask(&IonNeutral::ImpRKUpdate, this, id.n_srctrms);
-  id.i_restu  = tl["stagen"]->AddTask(&MHD::RestrictU, pmhd, id.impl);
-  id.n_restu  = tl["stagen"]->AddTask(&Hydro::RestrictU, phyd, id.i_restu);
-
-  id.i_sendu  = tl["stagen"]->AddTask(&MHD::SendU, pmhd, id.n_restu);
-  id.n_sendu  = tl["stagen"]->AddTask(&Hydro::SendU, phyd, id.n_restu);
-  id.i_recvu  = tl["stagen"]->AddTask(&MHD::RecvU, pmhd, id.i_sendu);
-  id.n_recvu  = tl["stagen"]->AddTask(&Hydro::RecvU, phyd, id.n_sendu);
-
-  id.efld     = tl["stagen"]->AddTask(&MHD::CornerE, pmhd, id.i_recvu);
-  id.sende    = tl["stagen"]->AddTask(&MHD::SendE, pmhd, id.efld);
-  id.recve    = tl["stagen"]->AddTask(&MHD::RecvE, pmhd, id.sende);
-  id.ct       = tl["stagen"]->AddTask(&MHD::CT, pmhd, id.recve);
-  id.restb    = tl["stagen"]->AddTask(&MHD::RestrictB, pmhd, id.ct);
-  id.sendb    = tl["stagen"]->AddTask(&MHD::SendB, pmhd, id.restb);
-  id.recvb    = tl["stagen"]->AddTask(&MHD::RecvB, pmhd, id.sendb);
-
-  id.i_bcs    = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, pmhd, id.recvb);
-  id.n_bcs    = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, phyd, id.n_recvu);
-  id.i_prol   = tl["stagen"]->AddTask(&MHD::Prolongate, pmhd, id.i_bcs);
-  id.n_prol   = tl["stagen"]->AddTask(&Hydro::Prolongate, phyd, id.n_bcs);
-  id.i_c2p    = tl["stagen"]->AddTask(&MHD::ConToPrim, pmhd, id.i_prol);
-  id.n_c2p    = tl["stagen"]->AddTask(&Hydro::ConToPrim, phyd, id.n_prol);
-  id.i_newdt  = tl["stagen"]->AddTask(&MHD::NewTimeStep, pmhd, id.i_c2p);
-  id.n_newdt  = tl["stagen"]->AddTask(&Hydro::NewTimeStep, phyd, id.n_c2p);
+  id.impl_2x = tl["stagen"]->AddTask(&IonNeutral::FirstTwoImpRK, this, none,
+                                     "IonNeutral::FirstTwoImpRK");
+
+  id.i_flux   = tl["stagen"]->AddTask(&MHD::Fluxes, pmhd, id.impl_2x, "MHD::Fluxes");
+  id.i_sendf  = tl["stagen"]->AddTask(&MHD::SendFlux, pmhd, id.i_flux, "MHD::SendFlux");
+  id.i_recvf  = tl["stagen"]->AddTask(&MHD::RecvFlux, pmhd, id.i_sendf, "MHD::RecvFlux");
+  id.i_rkupdt = tl["stagen"]->AddTask(&MHD::RKUpdate, pmhd, id.i_recvf, "MHD::RKUpdate");
+  id.i_srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, pmhd, id.i_rkupdt,
+                                         "MHD::MHDSrcTerms");
+
+  id.n_flux   = tl["stagen"]->AddTask(&Hydro::Fluxes, phyd, id.i_srctrms,
+                                      "Hydro::Fluxes");
+  id.n_sendf  = tl["stagen"]->AddTask(&Hydro::SendFlux, phyd, id.n_flux,
+                                      "Hydro::SendFlux");
+  id.n_recvf  = tl["stagen"]->AddTask(&Hydro::RecvFlux, phyd, id.n_sendf,
+                                      "Hydro::RecvFlux");
+  id.n_rkupdt = tl["stagen"]->AddTask(&Hydro::RKUpdate, phyd, id.n_recvf,
+                                      "Hydro::RKUpdate");
+  id.n_srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, phyd, id.n_rkupdt,
+                                         "Hydro::HydroSrcTerms");
+
+  id.impl     = tl["stagen"]->AddTask(&IonNeutral::ImpRKUpdate, this, id.n_srctrms,
+                                      "IonNeutral::ImpRKUpdate");
+  id.i_restu  = tl["stagen"]->AddTask(&IonNeutral::RestrictU, this, id.impl,
+                                      "IonNeutral::RestrictU");
+  id.n_restu  = id.i_restu;
+
+  id.i_sendu  = tl["stagen"]->AddTask(&MHD::SendU, pmhd, id.n_restu, "MHD::SendU");
+  id.n_sendu  = tl["stagen"]->AddTask(&Hydro::SendU, phyd, id.n_restu, "Hydro::SendU");
+  id.i_recvu  = tl["stagen"]->AddTask(&MHD::RecvU, pmhd, id.i_sendu, "MHD::RecvU");
+  id.n_recvu  = tl["stagen"]->AddTask(&Hydro::RecvU, phyd, id.n_sendu, "Hydro::RecvU");
+
+  id.efld     = tl["stagen"]->AddTask(&MHD::CornerE, pmhd, id.i_recvu, "MHD::CornerE");
+  id.sende    = tl["stagen"]->AddTask(&MHD::SendE, pmhd, id.efld, "MHD::SendE");
+  id.recve    = tl["stagen"]->AddTask(&MHD::RecvE, pmhd, id.sende, "MHD::RecvE");
+  id.ct       = tl["stagen"]->AddTask(&MHD::CT, pmhd, id.recve, "MHD::CT");
+  id.restb    = tl["stagen"]->AddTask(&MHD::RestrictB, pmhd, id.ct, "MHD::RestrictB");
+  id.sendb    = tl["stagen"]->AddTask(&MHD::SendB, pmhd, id.restb, "MHD::SendB");
+  id.recvb    = tl["stagen"]->AddTask(&MHD::RecvB, pmhd, id.sendb, "MHD::RecvB");
+
+  id.i_bcs    = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, pmhd, id.recvb,
+                                      "MHD::ApplyPhysicalBCs");
+  id.n_bcs    = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, phyd, id.n_recvu,
+                                      "Hydro::ApplyPhysicalBCs");
+  id.i_prol   = tl["stagen"]->AddTask(&MHD::Prolongate, pmhd, id.i_bcs,
+                                      "MHD::Prolongate");
+  id.n_prol   = tl["stagen"]->AddTask(&Hydro::Prolongate, phyd, id.n_bcs,
+                                      "Hydro::Prolongate");
+  id.i_c2p    = tl["stagen"]->AddTask(&MHD::ConToPrim, pmhd, id.i_prol, "MHD::ConToPrim");
+  id.n_c2p    = tl["stagen"]->AddTask(&Hydro::ConToPrim, phyd, id.n_prol,
+                                      "Hydro::ConToPrim");
+  id.i_newdt  = tl["stagen"]->AddTask(&MHD::NewTimeStep, pmhd, id.i_c2p,
+                                      "MHD::NewTimeStep");
+  id.n_newdt  = tl["stagen"]->AddTask(&Hydro::NewTimeStep, phyd, id.n_c2p,
+                                      "Hydro::NewTimeStep");
 
   // assemble "after_stagen_tl" task list
-  id.i_clear = tl["after_stagen"]->AddTask(&MHD::ClearSend, pmhd, none);
-  id.n_clear = tl["after_stagen"]->AddTask(&Hydro::ClearSend, phyd, none);
+  id.i_clear = tl["after_stagen"]->AddTask(&MHD::ClearSend, pmhd, none, "MHD::ClearSend");
+  id.n_clear = tl["after_stagen"]->AddTask(&Hydro::ClearSend, phyd, none,
+                                           "Hydro::ClearSend");
 
   return;
 }
@@ -100,11 +118,11 @@ TaskStatus IonNeutral::FirstTwoImpRK(Driver *pdrive, int stage) {
   hydro::Hydro *phyd = pmy_pack->phydro;
 
   // copy conserved hydro and MHD variables
-  Kokkos::deep_copy(DevExeSpace(), phyd->u1, phyd->u0);
-  Kokkos::deep_copy(DevExeSpace(), pmhd->u1, pmhd->u0);
-  Kokkos::deep_copy(DevExeSpace(), pmhd->b1.x1f, pmhd->b0.x1f);
-  Kokkos::deep_copy(DevExeSpace(), pmhd->b1.x2f, pmhd->b0.x2f);
-  Kokkos::deep_copy(DevExeSpace(), pmhd->b1.x3f, pmhd->b0.x3f);
+  Kokkos::deep_copy(TaskExecSpace(), phyd->u1, phyd->u0);
+  Kokkos::deep_copy(TaskExecSpace(), pmhd->u1, pmhd->u0);
+  Kokkos::deep_copy(TaskExecSpace(), pmhd->b1.x1f, pmhd->b0.x1f);
+  Kokkos::deep_copy(TaskExecSpace(), pmhd->b1.x2f, pmhd->b0.x2f);
+  Kokkos::deep_copy(TaskExecSpace(), pmhd->b1.x3f, pmhd->b0.x3f);
 
   // Solve implicit equations first time (nexp_stage = -1)
   auto status = ImpRKUpdate(pdrive, -1);
@@ -133,11 +151,20 @@ TaskStatus IonNeutral::FirstTwoImpRK(Driver *pdrive, int stage) {
 //  such as flux divergence).  This means soure terms must only be evaluated using
 //  conserved variables (u0), as primitives (w0) are not updated until end of TaskList.
 //
+//  The stiff source terms of previous stages are added, the implicit equations solved,
+//  and the source terms of this stage computed in a single kernel, so that the
+//  conserved variables of both fluids are read and written only once per stage.
+//
+//  With an ideal EOS in both fluids, the total energies are also updated, so that the
+//  change in kinetic energy of each fluid (including the frictional heating, which is
+//  shared equally between ions and neutrals) conserves the total energy of both fluids.
+//
 //  Note indices of source term array correspond to:
 //     ru(0) -> ui(IM1)     ru(3) -> un(IM1)
 //     ru(1) -> ui(IM2)     ru(4) -> un(IM2)
 //     ru(2) -> ui(IM3)     ru(5) -> un(IM3)
 //     ru(6) -> ui(IDN)     ru(7) -> un(IDN)
+//     ru(8) -> ui(IEN)     ru(9) -> un(IEN)   [ideal EOS only]
 //  where ui=pmhd->u0 and un=phydro->u0
 
 
@@ -151,143 +178,144 @@ TaskStatus IonNeutral::ImpRKUpdate(Driver *pdriver, int estage) {
   int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
   int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*indcs.ng) : 1;
   int nmb1 = pmy_pack->nmb_thispack - 1;
-
-  // Add stiff source term (ion-neutral drag) evaluated with values from previous stages,
-  // i.e. the R(U^1), R(U^2), etc. terms, to partially updated conserved variables.
-  // Only required for istage = (2,3,4,[5])
   mhd::MHD *pmhd = pmy_pack->pmhd;
   hydro::Hydro *phyd = pmy_pack->phydro;
-  if (istage > 1) {
-    int scr_level = 0;
-    size_t scr_size = 0;
-    auto ui = pmhd->u0;
-    auto un = phyd->u0;
-    auto &a_twid = pdriver->a_twid;
-    Real dt = pmy_pack->pmesh->dt;
-    auto ru_ = pdriver->impl_src;
-    par_for_outer("imex_exp",DevExeSpace(),scr_size,scr_level,0,nmb1,0,(n3-1),0,(n2-1),
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
-      for (int s=0; s<=(istage-2); ++s) {
-        Real adt = a_twid[istage-2][s]*dt;
-        par_for_inner(member, 0, (n1-1), [&](const int i) {
-          ui(m,IM1,k,j,i) += adt*ru_(s,m,0,k,j,i);
-          ui(m,IM2,k,j,i) += adt*ru_(s,m,1,k,j,i);
-          ui(m,IM3,k,j,i) += adt*ru_(s,m,2,k,j,i);
-          un(m,IM1,k,j,i) += adt*ru_(s,m,3,k,j,i);
-          un(m,IM2,k,j,i) += adt*ru_(s,m,4,k,j,i);
-          un(m,IM3,k,j,i) += adt*ru_(s,m,5,k,j,i);
-          ui(m,IDN,k,j,i) += adt*ru_(s,m,6,k,j,i);
-          un(m,IDN,k,j,i) += adt*ru_(s,m,7,k,j,i);
-        });
-      }
-    });
+  Real dt = pmy_pack->pmesh->dt;
+
+  // Weights of stiff source terms (ion-neutral drag) evaluated with values from
+  // previous stages, i.e. the R(U^1), R(U^2), etc. terms, added to partially updated
+  // conserved variables.  Only required for istage = (2,3,4,[5])
+  int nprev = (istage > 1)? (istage - 1) : 0;
+  Real adt[4] = {0.0, 0.0, 0.0, 0.0};
+  for (int s=0; s<nprev; ++s) {
+    adt[s] = pdriver->a_twid[istage-2][s]*dt;
+  }
+
+  // Implicit equations, and source terms for use in later stages, are solved/computed
+  // only for istage = (1,2,3,[4])
+  bool do_impl = (estage < pdriver->nexp_stages);
+  int snew = istage - 1;
+  Real impl_adt;
+  // Condition to set gamma_adt, xi_adt, and alpha_adt to zero
+  if (istage < 3 && pdriver->integrator == "imex2+") {
+    impl_adt = 0.0;
+  } else {
+    impl_adt = (pdriver->a_impl)*dt;
   }
+  Real gamma_adt = drag_coeff*impl_adt;
+  Real xi_adt = ionization_coeff*impl_adt;
+  Real alpha_adt = recombination_coeff*impl_adt;
+  Real drag = drag_coeff;
+  Real xi = ionization_coeff;
+  Real alpha = recombination_coeff;
+  bool energy = (pmhd->peos->eos_data.is_ideal && phyd->peos->eos_data.is_ideal);
+
+  auto ui = pmhd->u0;
+  auto un = phyd->u0;
+  auto ru_ = pdriver->impl_src;
+  par_for("imex_2fluid",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real rho_i = ui(m,IDN,k,j,i);
+    Real rho_n = un(m,IDN,k,j,i);
+    Real mi[3] = {ui(m,IM1,k,j,i), ui(m,IM2,k,j,i), ui(m,IM3,k,j,i)};
+    Real mn[3] = {un(m,IM1,k,j,i), un(m,IM2,k,j,i), un(m,IM3,k,j,i)};
+    Real ei = 0.0, en = 0.0;
+    if (energy) {
+      ei = ui(m,IEN,k,j,i);
+      en = un(m,IEN,k,j,i);
+    }
 
-  // Update ion/neutral momentum equations with analytic solution of implicit difference
-  // equations for ion-neutral drag.
-  // Only required for istage = (1,2,3,[4])
-  if (estage < pdriver->nexp_stages) {
-    Real gamma_adt;
-    Real xi_adt;
-    Real alpha_adt;
-
-    // Condition to set gamma_adt, xi_adt, and alpha_adt to zero
-    if (istage < 3 && pdriver->integrator == "imex2+") {
-      gamma_adt = 0.0;
-      xi_adt = 0.0;
-      alpha_adt = 0.0;
-    } else {
-      gamma_adt = drag_coeff * (pdriver->a_impl) * (pmy_pack->pmesh->dt);
-      xi_adt = ionization_coeff * (pdriver->a_impl) * (pmy_pack->pmesh->dt);
-      alpha_adt = recombination_coeff * (pdriver->a_impl) * (pmy_pack->pmesh->dt);
+    // add stiff source terms from previous stages
+    for (int s=0; s<nprev; ++s) {
+      for (int n=0; n<3; ++n) {
+        mi[n] += adt[s]*ru_(s,m,n,k,j,i);
+        mn[n] += adt[s]*ru_(s,m,3+n,k,j,i);
+      }
+      rho_i += adt[s]*ru_(s,m,6,k,j,i);
+      rho_n += adt[s]*ru_(s,m,7,k,j,i);
+      if (energy) {
+        ei += adt[s]*ru_(s,m,8,k,j,i);
+        en += adt[s]*ru_(s,m,9,k,j,i);
+      }
     }
 
-    //Real gamma_adt = drag_coeff*(pdriver->a_impl)*(pmy_pack->pmesh->dt);
-    //Real xi_adt = ionization_coeff*(pdriver->a_impl)*(pmy_pack->pmesh->dt);
-    //Real alpha_adt = recombination_coeff*(pdriver->a_impl)*(pmy_pack->pmesh->dt)
-    auto ui = pmhd->u0;
-    auto un = phyd->u0;
-    par_for("imex_imp",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
-    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-      Real rho_i = ui(m,IDN,k,j,i);
+    if (do_impl) {
+      // Update ion/neutral densities and momenta with analytic solution of implicit
+      // difference equations for ion-neutral drag, ionization, and recombination
+      Real rho_tot = rho_i + rho_n;
       if (alpha_adt > 0) { // to avoid division by zero
         Real d = 1./4./alpha_adt/alpha_adt + xi_adt/2./alpha_adt/alpha_adt
-                 + xi_adt*xi_adt/4./alpha_adt/alpha_adt + ui(m,IDN,k,j,i)/alpha_adt +
-                 xi_adt/alpha_adt * (ui(m,IDN,k,j,i)+un(m,IDN,k,j,i));
+                 + xi_adt*xi_adt/4./alpha_adt/alpha_adt + rho_i/alpha_adt +
+                 xi_adt/alpha_adt * rho_tot;
         rho_i = -1./2./alpha_adt - xi_adt/2./alpha_adt + sqrt(d);
       }
-      Real rho_n = ui(m,IDN,k,j,i) + un(m,IDN,k,j,i) - rho_i;
-      ui(m,IDN,k,j,i) = rho_i;
-      un(m,IDN,k,j,i) = rho_n;
-
-      Real denom = 1.0 + gamma_adt*(rho_i+rho_n) + xi_adt + alpha_adt*rho_i;
-      // compute new ion/neutral momenta in x1
-      Real sum = (ui(m,IM1,k,j,i) + un(m,IM1,k,j,i));
-      Real u_i = (ui(m,IM1,k,j,i) +
-                 (gamma_adt*rho_i + xi_adt)*sum)/denom;
-      Real u_n = sum - u_i;
-      ui(m,IM1,k,j,i) = u_i;
-      un(m,IM1,k,j,i) = u_n;
-      // compute new ion/neutral momenta in x2
-      sum = (ui(m,IM2,k,j,i) + un(m,IM2,k,j,i));
-      u_i = (ui(m,IM2,k,j,i) +
-                 (gamma_adt*rho_i + xi_adt)*sum)/denom;
-      u_n = sum - u_i;
-      ui(m,IM2,k,j,i) = u_i;
-      un(m,IM2,k,j,i) = u_n;
-      // compute new ion/neutral momenta in x3
-      sum = (ui(m,IM3,k,j,i) + un(m,IM3,k,j,i));
-      u_i = (ui(m,IM3,k,j,i) +
-                 (gamma_adt*rho_i + xi_adt)*sum)/denom;
-      u_n = sum - u_i;
-      ui(m,IM3,k,j,i) = u_i;
-      un(m,IM3,k,j,i) = u_n;
-    });
-  }
+      rho_n = rho_tot - rho_i;
 
-  // Compute stiff source term (ion-neutral drag) using variables updated in this stage,
-  // i.e R(U^n), for use in later stages.  Only required for istage = (1,2,3,[4])
-  if (estage < pdriver->nexp_stages) {
-    int s = istage-1;
-    auto ui = pmhd->u0;
-    auto un = phyd->u0;
-    auto drag = drag_coeff;
-    auto xi = ionization_coeff;
-    auto alpha = recombination_coeff;
-    auto ru_ = pdriver->impl_src;
-    par_for("imex_rup",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
-    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-      // drag term in IM1 component of ion momentum
-      ru_(s,m,0,k,j,i) = drag*(ui(m,IDN,k,j,i)*un(m,IM1,k,j,i) -
-                              un(m,IDN,k,j,i)*ui(m,IM1,k,j,i)) +
-                              xi*un(m,IM1,k,j,i) - alpha*ui(m,IDN,k,j,i)*ui(m,IM1,k,j,i);
-      // drag term in IM2 component of ion momentum
-      ru_(s,m,1,k,j,i) = drag*(ui(m,IDN,k,j,i)*un(m,IM2,k,j,i) -
-                              un(m,IDN,k,j,i)*ui(m,IM2,k,j,i)) +
-                              xi*un(m,IM2,k,j,i) - alpha*ui(m,IDN,k,j,i)*ui(m,IM2,k,j,i);
-      // drag term in IM3 component of ion momentum
-      ru_(s,m,2,k,j,i) = drag*(ui(m,IDN,k,j,i)*un(m,IM3,k,j,i) -
-                              un(m,IDN,k,j,i)*ui(m,IM3,k,j,i)) +
-                              xi*un(m,IM3,k,j,i) - alpha*ui(m,IDN,k,j,i)*ui(m,IM3,k,j,i);
-      // drag term in IM1 component of neutral momentum
-      ru_(s,m,3,k,j,i) = drag*(un(m,IDN,k,j,i)*ui(m,IM1,k,j,i) -
-                              ui(m,IDN,k,j,i)*un(m,IM1,k,j,i)) -
-                              xi*un(m,IM1,k,j,i) + alpha*ui(m,IDN,k,j,i)*ui(m,IM1,k,j,i);
-      // drag term in IM2 component of neutral momentum
-      ru_(s,m,4,k,j,i) = drag*(un(m,IDN,k,j,i)*ui(m,IM2,k,j,i) -
-                              ui(m,IDN,k,j,i)*un(m,IM2,k,j,i)) -
-                              xi*un(m,IM2,k,j,i) + alpha*ui(m,IDN,k,j,i)*ui(m,IM2,k,j,i);
-      // drag term in IM3 component of neutral momentum
-      ru_(s,m,5,k,j,i) = drag*(un(m,IDN,k,j,i)*ui(m,IM3,k,j,i) -
-                              ui(m,IDN,k,j,i)*un(m,IM3,k,j,i)) -
-                              xi*un(m,IM3,k,j,i) + alpha*ui(m,IDN,k,j,i)*ui(m,IM3,k,j,i);
-      // drag term in IDN component of ion momentum
-      ru_(s,m,6,k,j,i) = xi*un(m,IDN,k,j,i) - alpha*ui(m,IDN,k,j,i)*ui(m,IDN,k,j,i);
-      // drag term in IDN component of neutral momentum
-      ru_(s,m,7,k,j,i) =-xi*un(m,IDN,k,j,i) + alpha*ui(m,IDN,k,j,i)*ui(m,IDN,k,j,i);
-    });
-  }
+      Real denom = 1.0 + gamma_adt*rho_tot + xi_adt + alpha_adt*rho_i;
+      for (int n=0; n<3; ++n) {
+        Real sum = mi[n] + mn[n];
+        mi[n] = (mi[n] + (gamma_adt*rho_i + xi_adt)*sum)/denom;
+        mn[n] = sum - mi[n];
+      }
 
+      // Compute stiff source terms using variables updated in this stage, i.e R(U^n),
+      // for use in later stages.  Source terms of neutrals are minus those of ions.
+      Real r[4];
+      for (int n=0; n<3; ++n) {
+        r[n] = drag*(rho_i*mn[n] - rho_n*mi[n]) + xi*mn[n] - alpha*rho_i*mi[n];
+        ru_(snew,m,n,k,j,i) = r[n];
+        ru_(snew,m,3+n,k,j,i) = -r[n];
+      }
+      r[3] = xi*rho_n - alpha*rho_i*rho_i;
+      ru_(snew,m,6,k,j,i) = r[3];
+      ru_(snew,m,7,k,j,i) = -r[3];
+
+      // rate of change of total energy of ions from half of the difference in rates of
+      // change of kinetic energy of the two fluids.  Since R(E) does not depend on E,
+      // the implicit update of E is explicit in the updated densities and momenta.
+      if (energy) {
+        Real dkei = (mi[0]*r[0] + mi[1]*r[1] + mi[2]*r[2])/rho_i
+                  - 0.5*(SQR(mi[0]) + SQR(mi[1]) + SQR(mi[2]))*r[3]/SQR(rho_i);
+        Real dken = -(mn[0]*r[0] + mn[1]*r[1] + mn[2]*r[2])/rho_n
+                  + 0.5*(SQR(mn[0]) + SQR(mn[1]) + SQR(mn[2]))*r[3]/SQR(rho_n);
+        Real re = 0.5*(dkei - dken);
+        ei += impl_adt*re;
+        en -= impl_adt*re;
+        ru_(snew,m,8,k,j,i) = re;
+        ru_(snew,m,9,k,j,i) = -re;
+      }
+    }
+
+    ui(m,IDN,k,j,i) = rho_i;
+    un(m,IDN,k,j,i) = rho_n;
+    ui(m,IM1,k,j,i) = mi[0];
+    ui(m,IM2,k,j,i) = mi[1];
+    ui(m,IM3,k,j,i) = mi[2];
+    un(m,IM1,k,j,i) = mn[0];
+    un(m,IM2,k,j,i) = mn[1];
+    un(m,IM3,k,j,i) = mn[2];
+    if (energy) {
+      ui(m,IEN,k,j,i) = ei;
+      un(m,IEN,k,j,i) = en;
+    }
+  });
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void IonNeutral::RestrictU
+//  \brief Restricts conserved variables of both the ions (MHD) and neutrals (Hydro) with
+//  a single kernel launch.
+
+TaskStatus IonNeutral::RestrictU(Driver *pdrive, int stage) {
+  // Only execute Mesh function with SMR/AMR
+  if (pmy_pack->pmesh->multilevel) {
+    RestrictionBatch rb;
+    rb.AddCC(pmy_pack->pmhd->u0, pmy_pack->pmhd->coarse_u0);
+    rb.AddCC(pmy_pack->phydro->u0, pmy_pack->phydro->coarse_u0);
+    pmy_pack->pmesh->pmr->RestrictBatch(rb);
+  }
   return TaskStatus::complete;
 }
 
@@ -35,10 +35,15 @@
 #include "athena.hpp"
 #include "globals.hpp"
 #include "utils/utils.hpp"
+#include "utils/host_tasks.hpp"
+#include "utils/memory_tracker.hpp"
+#include "utils/team_tuner.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs/outputs.hpp"
 #include "driver/driver.hpp"
+#include "driver/block_advisor.hpp"
+#include "driver/ensemble.hpp"
 
 // MPI/OpenMP headers
 #if MPI_PARALLEL_ENABLED
@@ -227,10 +232,11 @@ int main(int argc, char *argv[]) {
 
   //--- Step 3. --------------------------------------------------------------------------
   // Construct ParameterInput object and load data either from restart or input file.
-  // With MPI, the input is read by every rank in parallel using MPI-IO.
+  // With MPI, the restart file is read by every rank in parallel using MPI-IO, while the
+  // input file is read and parsed on rank 0 and then broadcast to all other ranks.
 
   ParameterInput* pinput = new ParameterInput;
-  IOWrapper infile, restartfile;
+  IOWrapper restartfile;
   // read parameters from restart file
   bool single_file_per_rank = false; // DBF: flag for single_file_per_rank for rst files
   if (res_flag) {
@@ -267,9 +273,7 @@ int main(int argc, char *argv[]) {
   // read parameters from input file.  If both -r and -i are specified, this will
   // override parameters from the restart file
   if (iarg_flag) {
-    infile.Open(input_file.c_str(), IOWrapper::FileMode::read);
-    pinput->LoadFromFile(infile);
-    infile.Close();
+    pinput->LoadFromFileOnRoot(input_file);
   }
   pinput->ModifyFromCmdline(argc, argv);
 
@@ -290,6 +294,44 @@ int main(int argc, char *argv[]) {
   // on this rank.  Latter cannot be performed in Mesh constructor since it requires
   // pointer to Mesh.
 
+  // optionally choose the MeshBlock size of new runs from trial runs with candidate sizes
+  if (!res_flag) {
+    block_advisor::Run(pinput);
+  }
+  // optionally account for memory allocated by each module (from here on)
+  if (pinput->GetOrAddBoolean("job", "memory_report", false)) {
+    memory_tracker::Enable();
+    memory_tracker::SetScope("mesh");
+  }
+  // optionally tune team sizes of par_for_outer kernels during the first cycles
+  if (pinput->GetOrAddBoolean("job", "autotune", false)) {
+    team_tuner::Enable(
+        pinput->GetOrAddString("job", "autotune_file", team_tuner::DefaultFile()),
+        pinput->GetOrAddInteger("job", "autotune_samples", 3),
+        pinput->GetOrAddInteger("job", "autotune_cycles", 20));
+  }
+  // optionally write rows of diagnostic files with a pool of host threads
+  int host_threads = pinput->GetOrAddInteger("job", "host_threads", 0);
+  if (host_threads > 0) {
+    host_tasks::Enable(host_threads);
+  }
+  // optionally run an ensemble of independent new runs instead of a single run
+  if (!marg_flag && ensemble::Enabled(pinput)) {
+    if (res_flag) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<job>/ensemble_file cannot be used with restarts"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    ensemble::Run(pinput, run_dir, wtlim);
+    delete pinput;
+    host_tasks::Finish();
+    Kokkos::finalize();
+#if MPI_PARALLEL_ENABLED
+    MPI_Finalize();
+#endif
+    return(0);
+  }
   Mesh* pmesh = new Mesh(pinput);
   if (!res_flag) {
     pmesh->BuildTreeFromScratch(pinput);
@@ -324,7 +366,9 @@ int main(int argc, char *argv[]) {
     pmesh->pgen = std::make_unique<ProblemGenerator>(pinput,
                                                      pmesh,
                                                      restartfile,
-                                                     single_file_per_rank);
+                                                     single_file_per_rank,
+                                                     restart_file.substr(0,
+                                                       restart_file.rfind('/') + 1));
     restartfile.Close(single_file_per_rank);
   }
   //--- Step 6. --------------------------------------------------------------------------
@@ -334,6 +378,8 @@ int main(int argc, char *argv[]) {
   ChangeRunDir(run_dir);
   Driver* pdriver = new Driver(pinput, pmesh, wtlim, &timer);
   Outputs* pout = new Outputs(pinput, pmesh);
+  memory_tracker::SetScope("other");
+  memory_tracker::Report("at startup");
 
 
 
@@ -355,6 +401,7 @@ int main(int argc, char *argv[]) {
   delete pdriver;
   delete pmesh;
   delete pinput;
+  host_tasks::Finish();
   Kokkos::finalize();
 #if MPI_PARALLEL_ENABLED
   MPI_Finalize();
@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <cinttypes>
+#include <cstring> // memcpy
 #include <limits> // numeric_limits<>
 #include <memory> // make_unique<>
 
@@ -238,8 +239,8 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
   gids_eachrank = new int[global_variable::nranks];
   nmb_eachrank = new int[global_variable::nranks];
 
-  // following returns LogicalLocation list sorted by Z-ordering, and total # of MBs
-  ptree->CreateZOrderedLLList(lloc_eachmb, nullptr, nmb_total);
+  // following returns LogicalLocation list sorted by SFC ordering, and total # of MBs
+  ptree->CreateSFCOrderedLLList(lloc_eachmb, nullptr, nmb_total);
 
 #if MPI_PARALLEL_ENABLED
   // check there is at least one MeshBlock per MPI rank
@@ -266,9 +267,9 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
   pmb_pack->AddMeshBlocks(pin);
   pmb_pack->pmb->SetNeighbors(ptree, rank_eachmb);
 
-  // Fix maximum number of MeshBlocks per rank with AMR
+  // Fix maximum number of MeshBlocks per rank with AMR (or automatic load balancing)
   nmb_maxperrank = nmb_thisrank;
-  if (adaptive) {
+  if (adaptive || lb_automatic) {
     if (pin->DoesParameterExist("mesh_refinement", "max_nmb_per_rank")) {
       nmb_maxperrank = pin->GetReal("mesh_refinement", "max_nmb_per_rank");
       if (nmb_maxperrank < nmb_thisrank) {
@@ -278,7 +279,7 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
           << "<mesh_refinement>/max_nmb_per_rank=" << nmb_maxperrank << std::endl;
         std::exit(EXIT_FAILURE);
       }
-    } else {
+    } else if (adaptive) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
         << std::endl << "With AMR maximum number of MeshBlocks per rank must be "
         << "specified in input file using <mesh_refinement>/max_nmb_per_rank"
@@ -295,6 +296,9 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
   }
 #endif
 
+  // event counters in each MeshBlock
+  ecounter.mb = DvceArray2D<int>("ecounter_mb", nmb_maxperrank, NEVENT_COUNTERS);
+
   // Create new MeshRefinement object with either SMR or AMR (SMR needs Restrict fns)
   if (multilevel) {
     pmr = new MeshRefinement(this, pin);
@@ -305,6 +309,7 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
   dt   = std::numeric_limits<float>::max();
   cfl_no = pin->GetReal("time", "cfl_number");
   ncycle = 0;
+  async_dt = pin->GetOrAddBoolean("time", "async_dt", false);
   if (global_variable::my_rank == 0) {PrintMeshDiagnostics();}
 
   return;
@@ -441,16 +446,32 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile,
   for (int i=0; i<nmb_total; i++) {ptree->AddNodeWithoutRefinement(lloc_eachmb[i]);}
 
   // check the tree structure by making sure total # of MBs counted in tree same as the
-  // number read from the restart file.
+  // number read from the restart file, and that MBs are in the same (SFC) order.
   {
     int nnb;
-    ptree->CreateZOrderedLLList(lloc_eachmb, nullptr, nnb);
+    ptree->CountMeshBlocks(nnb);
     if (nnb != nmb_total) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
         << std::endl << "Tree reconstruction failed. Total number of blocks in "
         << "reconstructed tree=" << nnb << ", number in file=" << nmb_total << std::endl;
       std::exit(EXIT_FAILURE);
     }
+    LogicalLocation *lloc_file = new LogicalLocation[nmb_total];
+    std::memcpy(lloc_file, lloc_eachmb, nmb_total*sizeof(LogicalLocation));
+    ptree->CreateSFCOrderedLLList(lloc_eachmb, nullptr, nnb);
+    for (int i=0; i<nmb_total; i++) {
+      if (lloc_file[i].lx1 != lloc_eachmb[i].lx1 ||
+          lloc_file[i].lx2 != lloc_eachmb[i].lx2 ||
+          lloc_file[i].lx3 != lloc_eachmb[i].lx3 ||
+          lloc_file[i].level != lloc_eachmb[i].level) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Order of MeshBlocks in restart file differs from order given "
+          << "by <loadbalancing>/ordering. Restart using the ordering with which the "
+          << "file was written." << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+    delete [] lloc_file;
   }
 
 #ifdef MPI_PARALLEL_ENABLED
@@ -477,9 +498,9 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile,
   pmb_pack->AddMeshBlocks(pin);
   pmb_pack->pmb->SetNeighbors(ptree, rank_eachmb);
 
-  // Fix maximum number of MeshBlocks per rank with AMR
+  // Fix maximum number of MeshBlocks per rank with AMR (or automatic load balancing)
   nmb_maxperrank = nmb_thisrank;
-  if (adaptive) {
+  if (adaptive || lb_automatic) {
     if (pin->DoesParameterExist("mesh_refinement", "max_nmb_per_rank")) {
       nmb_maxperrank = pin->GetReal("mesh_refinement", "max_nmb_per_rank");
       if (nmb_maxperrank < nmb_thisrank) {
@@ -489,7 +510,7 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile,
           << "<mesh_refinement>/max_nmb_per_rank=" << nmb_maxperrank << std::endl;
         std::exit(EXIT_FAILURE);
       }
-    } else {
+    } else if (adaptive) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
         << std::endl << "With AMR maximum number of MeshBlocks per rank must be "
         << "specified in input file using <mesh_refinement>/max_nmb_per_rank"
@@ -498,6 +519,9 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile,
     }
   }
 
+  // event counters in each MeshBlock
+  ecounter.mb = DvceArray2D<int>("ecounter_mb", nmb_maxperrank, NEVENT_COUNTERS);
+
   // Create new MeshRefinement object with either SMR or AMR (SMR needs Restrict fns)
   if (multilevel) {
     pmr = new MeshRefinement(this, pin);
@@ -505,5 +529,6 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile,
 
   // set remaining parameters, output diagnostics
   cfl_no = pin->GetReal("time", "cfl_number");
+  async_dt = pin->GetOrAddBoolean("time", "async_dt", false);
   if (global_variable::my_rank == 0) {PrintMeshDiagnostics();}
 }
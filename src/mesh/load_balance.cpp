@@ -11,18 +11,67 @@
 #include <limits> // numeric_limits<>
 #include <algorithm> // max
 #include <utility> // make_pair
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "mesh.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
+#include "chemistry/chemistry.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
+#include "particles/particles.hpp"
 #include "z4c/z4c.hpp"
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
 #endif
 
+//----------------------------------------------------------------------------------------
+//! \fn void SplitCostList(float *clist, int is, int ie, int *wlist, int np, int *plist)
+//! \brief Divides elements [is,ie) of the input cost list into np contiguous parts, such
+//! that the cost of each part is proportional to its weight in wlist (the number of ranks
+//! in the part).  Every part is given at least as many elements as its weight.  The list
+//! is created from the end, so that the first part (containing the master rank) has less
+//! load.  Output: plist[i] = part to which element i is assigned.
+
+static void SplitCostList(float *clist, int is, int ie, int *wlist, int np, int *plist) {
+  float totalcost = 0.0;
+  int totalwght = 0;
+  for (int i=is; i<ie; i++) {totalcost += clist[i];}
+  for (int p=0; p<np; p++) {totalwght += wlist[p];}
+  if ((ie - is) < totalwght) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "There is at least one process which has no MeshBlock"
+              << std::endl << "Decrease the number of processes or use smaller "
+              << "MeshBlocks." << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  int j = np - 1;
+  int wght = totalwght;  // total weight of parts [0,j]
+  float targetcost = totalcost*static_cast<float>(wlist[j])/static_cast<float>(wght);
+  float mycost = 0.0;
+  int mycount = 0;
+  for (int i=ie-1; i>=is; i--) {
+    mycost += clist[i];
+    mycount++;
+    plist[i] = j;
+    // move to the next part when target is reached, or when the remaining elements are
+    // just enough to give every remaining rank one element
+    if (j > 0 && ((mycost >= targetcost && mycount >= wlist[j]) ||
+                  (i - is) == (wght - wlist[j]))) {
+      totalcost -= mycost;
+      wght -= wlist[j];
+      j--;
+      mycost = 0.0;
+      mycount = 0;
+      targetcost = totalcost*static_cast<float>(wlist[j])/static_cast<float>(wght);
+    }
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Mesh::LoadBalance(double *clist, int *rlist, int *slist, int *nlist, int nb)
 //! \brief Calculate distribution of MeshBlocks across ranks based on input cost list
@@ -33,40 +82,46 @@
 //!         nlist = number of MBs on each rank (array of length nrank)
 //! With multiple ranks in MPI, this function is needed even on a uniform mesh and not
 //! just for SMR/AMR, which is why it is part of the Mesh and not MeshRefinement class.
+//! MeshBlocks are always assigned to ranks in contiguous ranges of gid (which are ordered
+//! along a space-filling curve).  With the node_aware partitioner the list is first
+//! divided between nodes, in proportion to the number of ranks on each, and then between
+//! the ranks on each node, so that boundaries between nodes are placed using the costs
+//! of all MeshBlocks within each node, rather than the accumulated rounding of all ranks
+//! preceding them.
 
 void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb) {
   float min_cost = std::numeric_limits<float>::max();
-  float max_cost = 0.0, totalcost = 0.0;
-  // find min/max and total cost in clist
+  float max_cost = 0.0;
+  // find min/max cost in clist
   for (int i=0; i<nb; i++) {
-    totalcost += clist[i];
     min_cost = std::min(min_cost,clist[i]);
     max_cost = std::max(max_cost,clist[i]);
   }
 
-  int j = (global_variable::nranks) - 1;
-  float targetcost = totalcost/global_variable::nranks;
-  float mycost = 0.0;
-  // create rank list from the end: the master MPI rank should have less load
-  for (int i=nb-1; i>=0; i--) {
-    if (targetcost == 0.0) {
-      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "There is at least one process which has no MeshBlock"
-                << std::endl << "Decrease the number of processes or use smaller "
-                << "MeshBlocks." << std::endl;
-      std::exit(EXIT_FAILURE);
-    }
-    mycost += clist[i];
-    rlist[i] = j;
-    if (mycost >= targetcost && j>0) {
-      j--;
-      totalcost -= mycost;
-      mycost = 0.0;
-      targetcost = totalcost/(j+1);
+  int nnodes = static_cast<int>(nranks_eachnode.size());
+  if (partitioner == PartitionMethod::node_aware && nnodes > 1) {
+    // divide list between nodes, weighted by number of ranks on each node
+    int *nodelist = new int[nb];
+    SplitCostList(clist, 0, nb, nranks_eachnode.data(), nnodes, nodelist);
+    // then divide contiguous range of MBs on each node between the ranks on that node
+    int is = 0, rs = 0;
+    for (int n=0; n<nnodes; n++) {
+      int ie = is;
+      while (ie < nb && nodelist[ie] == n) {ie++;}
+      std::vector<int> ones(nranks_eachnode[n], 1);
+      SplitCostList(clist, is, ie, ones.data(), nranks_eachnode[n], rlist);
+      for (int i=is; i<ie; i++) {rlist[i] += rs;}
+      is = ie;
+      rs += nranks_eachnode[n];
     }
+    delete [] nodelist;
+  } else {
+    std::vector<int> ones(global_variable::nranks, 1);
+    SplitCostList(clist, 0, nb, ones.data(), global_variable::nranks, rlist);
   }
+
   slist[0] = 0;
-  j = 0;
+  int j = 0;
   for (int i=1; i<nb; i++) { // make the list of nbstart and nblocks
     if (rlist[i] != rlist[i-1]) {
       nlist[j] = i-slist[j];
@@ -86,6 +141,274 @@ void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb)
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::IncrementalLoadBalance(float *clist, int *olist, int *rlist,
+//!                                       int *slist, int *nlist, int nb)
+//! \brief As LoadBalance, but starting from the current assignment of MeshBlocks given
+//! by olist = rank of each MB before the regrid (non-decreasing in gid).  If no rank
+//! has more than (1 + lb_imbalance) times the mean cost, the current assignment is kept
+//! and no MeshBlocks migrate.  Otherwise the boundary between each pair of ranks is
+//! moved, one MB at a time, from its current position towards the one computed by
+//! LoadBalance, but only until the cost of the rank before it is within lb_imbalance of
+//! the mean.  So only MBs near the boundaries of overloaded ranks migrate, rather than
+//! all MBs whose rank changes when the list is split from scratch.  Boundaries between
+//! nodes of the node_aware partitioner are not preserved.  If the result still exceeds
+//! the tolerance, or the maximum number of MBs on any rank, LoadBalance output is used.
+
+void Mesh::IncrementalLoadBalance(float *clist, int *olist, int *rlist, int *slist,
+                                  int *nlist, int nb) {
+  // balanced distribution gives target of each boundary, and is used as fallback
+  LoadBalance(clist, rlist, slist, nlist, nb);
+  int nr = global_variable::nranks;
+  if (nr == 1) return;
+
+  // prefix sums of costs, so that cost of MBs [is,ie) is csum[ie] - csum[is]
+  std::vector<double> csum(nb+1, 0.0);
+  for (int i=0; i<nb; i++) {csum[i+1] = csum[i] + clist[i];}
+  double meancost = csum[nb]/static_cast<double>(nr);
+  double maxcost = (1.0 + lb_imbalance)*meancost;
+  double mincost = std::max(0.0, 1.0 - lb_imbalance)*meancost;
+  // maximum number of MBs can differ between ranks, so use smallest on all ranks
+  int maxnmb = nmb_maxperrank;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &maxnmb, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  auto acceptable = [&](const std::vector<int> &b) {
+    for (int r=0; r<nr; r++) {
+      int n = b[r+1] - b[r];
+      if (n < 1 || n > maxnmb || (csum[b[r+1]] - csum[b[r]]) > maxcost) return false;
+    }
+    return true;
+  };
+
+  // first gid on each rank in current assignment (bnd[nr] = nb)
+  std::vector<int> bnd(nr+1, nb);
+  for (int r=nr-1, i=nb; r>=0; r--) {
+    while (i > 0 && olist[i-1] >= r) {i--;}
+    bnd[r] = i;
+  }
+
+  if (!(acceptable(bnd))) {
+    // sweep boundaries from first rank, every remaining rank keeps at least one MB
+    for (int r=0; r<nr-1; r++) {
+      int lo = bnd[r] + 1, hi = nb - (nr - r - 1);
+      int target = std::min(std::max(slist[r+1], lo), hi);
+      int ie = std::min(std::max(bnd[r+1], lo), hi);
+      while (ie != target) {
+        double cost = csum[ie] - csum[bnd[r]];
+        if (cost <= maxcost && cost >= mincost && (ie - bnd[r]) <= maxnmb) break;
+        ie += (target > ie) ? 1 : -1;
+      }
+      bnd[r+1] = ie;
+    }
+    if (!(acceptable(bnd))) return;
+  }
+
+  for (int r=0; r<nr; r++) {
+    slist[r] = bnd[r];
+    nlist[r] = bnd[r+1] - bnd[r];
+    for (int i=bnd[r]; i<bnd[r+1]; i++) {rlist[i] = r;}
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::SetNodeLayout()
+//! \brief Finds the number of ranks on each (shared-memory) node for the node_aware
+//! partitioner.  Since MeshBlocks are assigned to ranks in contiguous ranges of gid, this
+//! only keeps neighboring MeshBlocks on the same node if the ranks on each node are
+//! numbered contiguously (e.g. "--map-by core" or SLURM "--distribution=block").  If not,
+//! a warning is issued and the greedy partitioner is used instead.
+
+void Mesh::SetNodeLayout() {
+  nranks_eachnode.clear();
+#if MPI_PARALLEL_ENABLED
+  // label each node by the lowest rank on it
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                      MPI_INFO_NULL, &node_comm);
+  int node_id = global_variable::my_rank;
+  MPI_Bcast(&node_id, 1, MPI_INT, 0, node_comm);
+  MPI_Comm_free(&node_comm);
+  std::vector<int> node_eachrank(global_variable::nranks);
+  MPI_Allgather(&node_id, 1, MPI_INT, node_eachrank.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+  bool contiguous = true;
+  int nr = 1;
+  for (int n=1; n<global_variable::nranks; n++) {
+    if (node_eachrank[n] == node_eachrank[n-1]) {
+      nr++;
+    } else {
+      // first rank on a new node must be the lowest rank on that node
+      if (node_eachrank[n] != n) {contiguous = false;}
+      nranks_eachnode.push_back(nr);
+      nr = 1;
+    }
+  }
+  nranks_eachnode.push_back(nr);
+
+  if (!(contiguous)) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+          << "Ranks are not numbered contiguously on each node, so "
+          << "<loadbalancing>/partitioner=node_aware will be ignored" << std::endl;
+    }
+    partitioner = PartitionMethod::greedy;
+    nranks_eachnode.clear();
+  }
+#else
+  nranks_eachnode.push_back(1);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::UpdateMeasuredCosts()
+//! \brief With automatic load balancing, measures the cost of the MeshBlocks on this rank
+//! from the wall time spent in Tasks that completed during the last cycle, and smooths
+//! the result into cost_eachmb.  Tasks are only timed (with a fence after each) in one
+//! cycle every lb_sample_cycles, and this function is only called in those cycles.
+//! Since each Task processes all MeshBlocks in a MeshBlockPack with a single kernel,
+//! this time cannot be attributed to individual MeshBlocks, and so it is divided evenly
+//! between all MeshBlocks on this rank.
+//! Repeated rebalancing then moves MeshBlocks away from expensive ranks.  Costs are
+//! smoothed using a running mean over the first lb_cost_window samples, and using an
+//! exponential moving average with the same window afterwards.
+//! With dynamical GRMHD, a fraction lb_c2p_fraction of the time is instead divided in
+//! proportion to the mean number of primitive solver iterations in each MeshBlock.
+//! Similarly with a reaction network, a fraction lb_chem_fraction of the time is divided
+//! in proportion to the mean number of Rosenbrock steps per cell in each MeshBlock.
+//! With particles, the cost of each MeshBlock is (cells x cost per cell) + (particles x
+//! cost per particle), where the cost per particle is measured from the time spent in
+//! particle Tasks, and the cost per cell from the time spent in all other Tasks.
+
+void Mesh::UpdateMeasuredCosts() {
+  double work_time = 0.0, prtcl_time = 0.0;
+  for (auto &it : pmb_pack->tl_map) {
+    work_time += it.second->GetWorkTime();
+    prtcl_time += it.second->GetWorkTime("Particles::");
+    it.second->ResetWorkTime();
+  }
+
+  // particles in each MeshBlock, and measured cost per particle
+  std::vector<float> nprtcl_mb(nmb_thisrank, 0.0);
+  float prtcl_cost = 0.0;
+  if (pmb_pack->ppart != nullptr && nprtcl_thisrank > 0) {
+    pmb_pack->ppart->ParticlesEachMB(nprtcl_mb);
+    prtcl_cost = static_cast<float>(prtcl_time)/static_cast<float>(nprtcl_thisrank);
+    work_time -= prtcl_time;
+  }
+  int ncells = mb_indcs.nx1*mb_indcs.nx2*mb_indcs.nx3;
+  float cell_cost = static_cast<float>(work_time)/static_cast<float>(nmb_thisrank*ncells);
+  float mbcost = cell_cost*static_cast<float>(ncells);
+
+  // relative cost of each MeshBlock, with mean of one
+  std::vector<float> relcost(nmb_thisrank, 1.0);
+  if (lb_c2p_fraction > 0.0 && pmb_pack->pdyngr != nullptr) {
+    std::vector<float> iters;
+    pmb_pack->pdyngr->C2PIterationsEachMB(iters);
+    float mean_iters = 0.0;
+    for (int m=0; m<nmb_thisrank; ++m) {mean_iters += iters[m];}
+    mean_iters /= static_cast<float>(nmb_thisrank);
+    if (mean_iters > 0.0) {
+      for (int m=0; m<nmb_thisrank; ++m) {
+        relcost[m] = (1.0 - lb_c2p_fraction) + lb_c2p_fraction*iters[m]/mean_iters;
+      }
+    }
+  }
+  Chemistry *pchem = nullptr;
+  if (pmb_pack->phydro != nullptr) {pchem = pmb_pack->phydro->pchem;}
+  if (pmb_pack->pmhd != nullptr && pmb_pack->pmhd->pchem != nullptr) {
+    pchem = pmb_pack->pmhd->pchem;
+  }
+  if (lb_chem_fraction > 0.0 && pchem != nullptr) {
+    std::vector<float> work;
+    pchem->WorkEachMB(work);
+    float mean_work = 0.0;
+    for (int m=0; m<nmb_thisrank; ++m) {mean_work += work[m];}
+    mean_work /= static_cast<float>(nmb_thisrank);
+    if (mean_work > 0.0) {
+      for (int m=0; m<nmb_thisrank; ++m) {
+        relcost[m] *= (1.0 - lb_chem_fraction) + lb_chem_fraction*work[m]/mean_work;
+      }
+    }
+  }
+
+  lb_nsample++;
+  float wght = 1.0/static_cast<float>(std::min(lb_nsample, lb_cost_window));
+  int gids = gids_eachrank[global_variable::my_rank];
+  for (int m=0; m<nmb_thisrank; ++m) {
+    cost_eachmb[gids+m] = (1.0 - wght)*cost_eachmb[gids+m] +
+                          wght*(mbcost*relcost[m] + prtcl_cost*nprtcl_mb[m]);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::GatherMeasuredCosts()
+//! \brief Passes measured costs of MeshBlocks on each rank between all ranks, so every
+//! rank has a complete and updated copy of cost_eachmb.
+
+void Mesh::GatherMeasuredCosts() {
+#if MPI_PARALLEL_ENABLED
+  MPI_Allgatherv(MPI_IN_PLACE, nmb_eachrank[global_variable::my_rank], MPI_FLOAT,
+                 cost_eachmb, nmb_eachrank, gids_eachrank, MPI_FLOAT, MPI_COMM_WORLD);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool Mesh::CheckMeasuredLoadBalance()
+//! \brief Every lb_interval cycles (once costs have been measured over at least one
+//! window) computes the load balancing efficiency = (mean cost per rank)/(max cost per
+//! rank) using measured costs.  Returns true if the efficiency is below lb_tolerance,
+//! and a new distribution of MeshBlocks over ranks with these costs both differs from
+//! the current one and does not exceed the maximum number of MeshBlocks on any rank.
+//! Must be called on all ranks, since the costs are communicated.
+
+bool Mesh::CheckMeasuredLoadBalance() {
+  if (global_variable::nranks == 1) return false;
+  if ((ncycle % lb_interval) != 0 || lb_nsample < lb_cost_window) return false;
+
+  GatherMeasuredCosts();
+  float totalcost = 0.0, maxcost = 0.0;
+  for (int n=0; n<global_variable::nranks; ++n) {
+    float rankcost = 0.0;
+    for (int m=gids_eachrank[n]; m<(gids_eachrank[n] + nmb_eachrank[n]); ++m) {
+      rankcost += cost_eachmb[m];
+    }
+    totalcost += rankcost;
+    maxcost = std::max(maxcost, rankcost);
+  }
+  if (maxcost <= 0.0) return false;
+  lb_efficiency = totalcost/(static_cast<float>(global_variable::nranks)*maxcost);
+  if (lb_efficiency >= lb_tolerance) return false;
+
+  // compute trial distribution, and check it is new and fits on every rank
+  int *rlist = new int[nmb_total];
+  int *slist = new int[global_variable::nranks];
+  int *nlist = new int[global_variable::nranks];
+  if (lb_incremental) {
+    IncrementalLoadBalance(cost_eachmb, rank_eachmb, rlist, slist, nlist, nmb_total);
+  } else {
+    LoadBalance(cost_eachmb, rlist, slist, nlist, nmb_total);
+  }
+  bool changed = false;
+  for (int n=0; n<global_variable::nranks; ++n) {
+    if (nlist[n] != nmb_eachrank[n]) {changed = true;}
+  }
+  // maximum number of MBs can differ between ranks, so reduce over all ranks
+  int fits = (nlist[global_variable::my_rank] <= nmb_maxperrank) ? 1 : 0;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &fits, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  delete [] rlist;
+  delete [] slist;
+  delete [] nlist;
+
+  return (changed && (fits == 1));
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::InitRecvAMR()
 //! \brief Allocates and initializes receive buffers, and posts non-blocking receives,
@@ -95,6 +418,9 @@ void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb)
 
 void MeshRefinement::InitRecvAMR(int nleaf) {
 #if MPI_PARALLEL_ENABLED
+  // set chunks of variables sent as separate messages, used by all functions below
+  SetAMRChunks();
+
   // Step 1. (InitRecvAMR)
   // loop over new MBs on this rank, count number of MeshBlocks received by this rank
   nmb_recv = 0;
@@ -128,8 +454,8 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
 
   // allocate array of recv buffers
   Kokkos::realloc(recvbuf, nmb_recv);
-  recv_req = new MPI_Request[nmb_recv];
-  for (int n=0; n<nmb_recv; ++n) {
+  recv_req = new MPI_Request[namr_chunks*nmb_recv];
+  for (int n=0; n<namr_chunks*nmb_recv; ++n) {
     recv_req[n] = MPI_REQUEST_NULL;
   }
 
@@ -147,6 +473,9 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
   if (pmy_mesh->pmb_pack->pz4c != nullptr) {
     ncc_tosend += (pmy_mesh->pmb_pack->pz4c->nz4c);
   }
+  for (auto &e : pmy_mesh->pmb_pack->extra_cc) {
+    ncc_tosend += e.u->extent_int(1);
+  }
 
   // Step 2. (InitRecvAMR)
   // loop over new MBs on this rank, initialize recv buffers
@@ -255,19 +584,21 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
       }
     }
   }
-  // Sync dual array, reallocate receive data array
+  // Sync dual array, grow receive data array if needed (it is kept between regrids, so
+  // device memory is not freed and reallocated every time)
   recvbuf.template modify<HostMemSpace>();
   recvbuf.template sync<DevExeSpace>();
   {
     int ndata = recvbuf.h_view((nmb_recv-1)).offset + recvbuf.h_view((nmb_recv-1)).cnt;
-    Kokkos::realloc(recv_data, ndata);
+    if (recv_data.extent_int(0) < ndata) {
+      Kokkos::realloc(recv_data, ndata);
+    }
   }
 
   // Step 3. (InitRecvAMR)
-  // loop over new MBs on this rank, post non-blocking recvs
-  // Receive requests will only be accessed on host, so no need to sync after this step.
+  // loop over new MBs on this rank, store sending rank and tag of each recv buffer
+  // Ranks and tags will only be accessed on host, so no need to sync after this step.
   rb_idx = 0;   // recv buffer index
-  bool no_errors=true;
   for (int newm=nmbs; newm<=nmbe; newm++) {
     int oldm = newtoold[newm];
     LogicalLocation &old_lloc = pmy_mesh->lloc_eachmb[oldm];
@@ -281,52 +612,48 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
           int ox1 = ((lloc.lx1 & 1) == 1);
           int ox2 = ((lloc.lx2 & 1) == 1);
           int ox3 = ((lloc.lx3 & 1) == 1);
-          int vs = recvbuf.h_view(rb_idx).offset;
-          int ve = vs + recvbuf.h_view(rb_idx).cnt;
-          auto pdata = Kokkos::subview(recv_data, std::make_pair(vs,ve));
-          // create tag using local ID of *receiving* MeshBlock, post receive
-          int tag = CreateAMR_MPI_Tag(newm-nmbs, ox1, ox2, ox3);
-          // post non-blocking receive
-          int ierr = MPI_Irecv(pdata.data(), recvbuf.h_view(rb_idx).cnt,
-                     MPI_ATHENA_REAL, pmy_mesh->rank_eachmb[oldm+l], tag, amr_comm,
-                     &(recv_req[rb_idx]));
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
+          // create tag using local ID of *receiving* MeshBlock
+          recvbuf.h_view(rb_idx).tag = CreateAMR_MPI_Tag(newm-nmbs, ox1, ox2, ox3);
+          recvbuf.h_view(rb_idx).rank = pmy_mesh->rank_eachmb[oldm+l];
           rb_idx++;
         }
       }
     } else if (old_lloc.level == new_lloc.level) {   // old MB at same level
       if (pmy_mesh->rank_eachmb[oldm] != global_variable::my_rank) {
-        int vs = recvbuf.h_view(rb_idx).offset;
-        int ve = vs + recvbuf.h_view(rb_idx).cnt;
-        auto pdata = Kokkos::subview(recv_data, std::make_pair(vs,ve));
-        // create tag using local ID of *receiving* MeshBlock, post receive
-        int tag = CreateAMR_MPI_Tag(newm-nmbs, 0, 0, 0);
-        // post non-blocking receive
-        int ierr = MPI_Irecv(pdata.data(), recvbuf.h_view(rb_idx).cnt, MPI_ATHENA_REAL,
-                   pmy_mesh->rank_eachmb[oldm], tag, amr_comm,
-                   &(recv_req[rb_idx]));
-        if (ierr != MPI_SUCCESS) {no_errors=false;}
+        // create tag using local ID of *receiving* MeshBlock
+        recvbuf.h_view(rb_idx).tag = CreateAMR_MPI_Tag(newm-nmbs, 0, 0, 0);
+        recvbuf.h_view(rb_idx).rank = pmy_mesh->rank_eachmb[oldm];
         rb_idx++;
       }
     } else {                                        // old MB was refined
       // recv whenever refined MB changes rank, or if any leaf on different rank than root
       if ((new_rank_eachmb[oldtonew[oldm]] != global_variable::my_rank) ||
           (pmy_mesh->rank_eachmb[oldm] != global_variable::my_rank)) {
-        int vs = recvbuf.h_view(rb_idx).offset;
-        int ve = vs + recvbuf.h_view(rb_idx).cnt;
-        auto pdata = Kokkos::subview(recv_data, std::make_pair(vs,ve));
-        // create tag using local ID of *receiving* MeshBlock, post receive
-        int tag = CreateAMR_MPI_Tag(newm-nmbs, 0, 0, 0);
-        // post non-blocking receive
-        int ierr = MPI_Irecv(pdata.data(), recvbuf.h_view(rb_idx).cnt, MPI_ATHENA_REAL,
-                   pmy_mesh->rank_eachmb[oldm], tag, amr_comm,
-                   &(recv_req[rb_idx]));
-        if (ierr != MPI_SUCCESS) {no_errors=false;}
+        // create tag using local ID of *receiving* MeshBlock
+        recvbuf.h_view(rb_idx).tag = CreateAMR_MPI_Tag(newm-nmbs, 0, 0, 0);
+        recvbuf.h_view(rb_idx).rank = pmy_mesh->rank_eachmb[oldm];
         rb_idx++;
       }
     }
   }
 
+  // Step 4. (InitRecvAMR)
+  // post non-blocking recvs for each chunk of variables in every buffer.  All chunks of
+  // a buffer have the same source and tag, so MPI message ordering guarantees they are
+  // matched in the order sent.
+  bool no_errors=true;
+  for (int c=0; c<namr_chunks; ++c) {
+    for (int n=0; n<nmb_recv; ++n) {
+      int vs = amr_chunks[c].Start(recvbuf.h_view(n));
+      int ve = vs + amr_chunks[c].Count(recvbuf.h_view(n));
+      auto pdata = Kokkos::subview(recv_data, std::make_pair(vs,ve));
+      int ierr = MPI_Irecv(pdata.data(), (ve - vs), MPI_ATHENA_REAL,
+                           recvbuf.h_view(n).rank, recvbuf.h_view(n).tag, amr_comm,
+                           &(recv_req[c*nmb_recv + n]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+  }
+
   // Quit if MPI error detected
   if (!(no_errors)) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
@@ -380,8 +707,8 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
 
   // allocate array of send buffers
   Kokkos::realloc(sendbuf, nmb_send);
-  send_req = new MPI_Request[nmb_send];
-  for (int n=0; n<nmb_send; ++n) {
+  send_req = new MPI_Request[namr_chunks*nmb_send];
+  for (int n=0; n<namr_chunks*nmb_send; ++n) {
     send_req[n] = MPI_REQUEST_NULL;
   }
 
@@ -399,6 +726,9 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
   if (pmy_mesh->pmb_pack->pz4c != nullptr) {
     ncc_tosend += (pmy_mesh->pmb_pack->pz4c->nz4c);
   }
+  for (auto &e : pmy_mesh->pmb_pack->extra_cc) {
+    ncc_tosend += e.u->extent_int(1);
+  }
 
   // Step 2. (PackAndSendAMR)
   // loop over old MBs on this rank, initialize send buffers
@@ -509,41 +839,20 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
       }
     }
   }
-  // Sync dual array, reallocate send data array
+  // Sync dual array, grow send data array if needed (kept between regrids)
   sendbuf.template modify<HostMemSpace>();
   sendbuf.template sync<DevExeSpace>();
   {
     int ndata = sendbuf.h_view((nmb_send-1)).offset + sendbuf.h_view((nmb_send-1)).cnt;
-    Kokkos::realloc(send_data, ndata);
+    if (send_data.extent_int(0) < ndata) {
+      Kokkos::realloc(send_data, ndata);
+    }
+    nbytes_sent_thisrank += static_cast<double>(ndata)*sizeof(Real);
   }
 
   // Step 3. (PackAndSendAMR)
-  // Pack data into send buffers in parallel
-  hydro::Hydro* phydro = pmy_mesh->pmb_pack->phydro;
-  mhd::MHD* pmhd = pmy_mesh->pmb_pack->pmhd;
-  z4c::Z4c* pz4c = pmy_mesh->pmb_pack->pz4c;
-
-  int ncc_sent = 0, nfc_sent = 0;
-  if (phydro != nullptr) {
-    PackAMRBuffersCC(phydro->u0, phydro->coarse_u0, ncc_sent, nfc_sent);
-    ncc_sent += phydro->nhydro + phydro->nscalars;
-  }
-  if (pmhd != nullptr) {
-    PackAMRBuffersCC(pmhd->u0, pmhd->coarse_u0, ncc_sent, nfc_sent);
-    ncc_sent += pmhd->nmhd + pmhd->nscalars;
-    PackAMRBuffersFC(pmhd->b0, pmhd->coarse_b0, ncc_sent, nfc_sent);
-    nfc_sent += 1;
-  }
-  if (pz4c != nullptr) {
-    PackAMRBuffersCC(pz4c->u0, pz4c->coarse_u0, ncc_sent, nfc_sent);
-    ncc_sent += pz4c->nz4c;
-  }
-
-  // Step 4. (PackAndSendAMR)
-  // loop over old MBs on this rank, send data using MPI non-blocking sends
-  // Send requests will only be accessed on host, so no need to sync after this step.
-  Kokkos::fence();
-  bool no_errors=true;
+  // loop over old MBs on this rank, store receiving rank and tag of each send buffer
+  // Ranks and tags will only be accessed on host, so no need to sync after this step.
   sb_idx = 0;     // send buffer index
   for (int oldm=ombs; oldm<=ombe; oldm++) {
     int newm = oldtonew[oldm];
@@ -554,67 +863,73 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
         // send if refined MB changes rank, or if any leaf on different rank than root
         if ((new_rank_eachmb[newm] != global_variable::my_rank) ||
             (new_rank_eachmb[newm + l] != global_variable::my_rank)) {
-          int vs = sendbuf.h_view(sb_idx).offset;
-          int ve = vs + sendbuf.h_view(sb_idx).cnt;
-          auto pdata = Kokkos::subview(send_data, std::make_pair(vs,ve));
           // create tag using local ID of *receiving* MeshBlock
           int lid = (newm + l) - new_gids_eachrank[new_rank_eachmb[newm+l]];
-          int tag = CreateAMR_MPI_Tag(lid, 0, 0, 0);
-          // post non-blocking send
-          int ierr = MPI_Isend(pdata.data(), sendbuf.h_view(sb_idx).cnt, MPI_ATHENA_REAL,
-                     new_rank_eachmb[newm+l], tag, amr_comm,
-                     &(send_req[sb_idx]));
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
+          sendbuf.h_view(sb_idx).tag = CreateAMR_MPI_Tag(lid, 0, 0, 0);
+          sendbuf.h_view(sb_idx).rank = new_rank_eachmb[newm+l];
           sb_idx++;
         }
       }
     } else {   // same level or de-refinement
       if (old_lloc.level == new_lloc.level) {   // old MB at same level
         if (new_rank_eachmb[newm] != global_variable::my_rank) {
-          int vs = sendbuf.h_view(sb_idx).offset;
-          int ve = vs + sendbuf.h_view(sb_idx).cnt;
-          auto pdata = Kokkos::subview(send_data, std::make_pair(vs,ve));
           // create tag using local ID of *receiving* MeshBlock
           int lid = newm - new_gids_eachrank[new_rank_eachmb[newm]];
-          int tag = CreateAMR_MPI_Tag(lid, 0, 0, 0);
-          // post non-blocking send
-          int ierr = MPI_Isend(pdata.data(), sendbuf.h_view(sb_idx).cnt, MPI_ATHENA_REAL,
-                     new_rank_eachmb[newm], tag, amr_comm,
-                     &(send_req[sb_idx]));
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
+          sendbuf.h_view(sb_idx).tag = CreateAMR_MPI_Tag(lid, 0, 0, 0);
+          sendbuf.h_view(sb_idx).rank = new_rank_eachmb[newm];
           sb_idx++;
         }
       } else {                                  // old MB was de-refined
         // send whenever root MB changes rank, or if any leaf on different rank than root
         if ((pmy_mesh->rank_eachmb[newtoold[newm]] != global_variable::my_rank) ||
             (new_rank_eachmb[newm] != global_variable::my_rank)) {
-          int vs = sendbuf.h_view(sb_idx).offset;
-          int ve = vs + sendbuf.h_view(sb_idx).cnt;
-          auto pdata = Kokkos::subview(send_data, std::make_pair(vs,ve));
           // create tag using local ID of *receiving* MeshBlock
           int ox1 = ((old_lloc.lx1 & 1) == 1);
           int ox2 = ((old_lloc.lx2 & 1) == 1);
           int ox3 = ((old_lloc.lx3 & 1) == 1);
           int lid = newm - new_gids_eachrank[new_rank_eachmb[newm]];
-          int tag = CreateAMR_MPI_Tag(lid, ox1, ox2, ox3);
-          // post non-blocking send
-          int ierr = MPI_Isend(pdata.data(), sendbuf.h_view(sb_idx).cnt, MPI_ATHENA_REAL,
-                     new_rank_eachmb[newm], tag, amr_comm,
-                     &(send_req[sb_idx]));
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
+          sendbuf.h_view(sb_idx).tag = CreateAMR_MPI_Tag(lid, ox1, ox2, ox3);
+          sendbuf.h_view(sb_idx).rank = new_rank_eachmb[newm];
           sb_idx++;
         }
       }
     }
   }
 
-  // Quit if MPI error detected
-  if (!(no_errors)) {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl << "MPI error in posting non-blocking receives with AMR"
-              << std::endl;
-    std::exit(EXIT_FAILURE);
+  // Step 4. (PackAndSendAMR)
+  // Pack data into send buffers in parallel, and post non-blocking sends of each chunk of
+  // variables as soon as it is packed.  With pipelined migration this overlaps sending
+  // the data of one array with packing the next.
+  hydro::Hydro* phydro = pmy_mesh->pmb_pack->phydro;
+  mhd::MHD* pmhd = pmy_mesh->pmb_pack->pmhd;
+  z4c::Z4c* pz4c = pmy_mesh->pmb_pack->pz4c;
+
+  int ncc_sent = 0, nfc_sent = 0, nchunk = 0;
+  if (phydro != nullptr) {
+    PackAMRBuffersCC(phydro->u0, phydro->coarse_u0, ncc_sent, nfc_sent);
+    ncc_sent += phydro->nhydro + phydro->nscalars;
+    PostSendAMR(ncc_sent, nfc_sent, nchunk);
+  }
+  if (pmhd != nullptr) {
+    PackAMRBuffersCC(pmhd->u0, pmhd->coarse_u0, ncc_sent, nfc_sent);
+    ncc_sent += pmhd->nmhd + pmhd->nscalars;
+    PostSendAMR(ncc_sent, nfc_sent, nchunk);
+    PackAMRBuffersFC(pmhd->b0, pmhd->coarse_b0, ncc_sent, nfc_sent);
+    nfc_sent += 1;
+    PostSendAMR(ncc_sent, nfc_sent, nchunk);
   }
+  if (pz4c != nullptr) {
+    PackAMRBuffersCC(pz4c->u0, pz4c->coarse_u0, ncc_sent, nfc_sent);
+    ncc_sent += pz4c->nz4c;
+    PostSendAMR(ncc_sent, nfc_sent, nchunk);
+  }
+  // extra CC arrays are sent as one chunk
+  auto &extra_cc = pmy_mesh->pmb_pack->extra_cc;
+  for (auto &e : extra_cc) {
+    PackAMRBuffersCC(*(e.u), *(e.coarse_u), ncc_sent, nfc_sent);
+    ncc_sent += e.u->extent_int(1);
+  }
+  if (!(extra_cc.empty())) {PostSendAMR(ncc_sent, nfc_sent, nchunk);}
 #endif
   return;
 }
@@ -787,42 +1102,39 @@ void MeshRefinement::PackAMRBuffersFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real
 
 void MeshRefinement::ClearRecvAndUnpackAMR() {
 #if MPI_PARALLEL_ENABLED
-  // Wait for all receives to finish
-  bool no_errors=true;
-  for (int n=0; n<nmb_recv; ++n) {
-    int ierr = MPI_Wait(&(recv_req[n]), MPI_STATUS_IGNORE);
-    if (ierr != MPI_SUCCESS) {no_errors=false;}
-  }
-  // Quit if MPI error detected
-  if (!(no_errors)) {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl << "MPI error in posting non-blocking receives with AMR"
-              << std::endl;
-    std::exit(EXIT_FAILURE);
-  }
-  delete [] recv_req;
-
-  // Unpack data
+  // Unpack data, waiting for each chunk of variables to be received just before it is
+  // unpacked.  With pipelined migration unpacking one array overlaps receiving the next.
   hydro::Hydro* phydro = pmy_mesh->pmb_pack->phydro;
   mhd::MHD* pmhd = pmy_mesh->pmb_pack->pmhd;
   z4c::Z4c* pz4c = pmy_mesh->pmb_pack->pz4c;
 
-  int ncc_recv=0, nfc_recv=0;
+  int ncc_recv=0, nfc_recv=0, nchunk=0;
 
   if (phydro != nullptr) {
+    WaitRecvAMR(ncc_recv, nfc_recv, nchunk);
     UnpackAMRBuffersCC(phydro->u0, phydro->coarse_u0, ncc_recv, nfc_recv);
     ncc_recv += phydro->nhydro + phydro->nscalars;
   }
   if (pmhd != nullptr) {
+    WaitRecvAMR(ncc_recv, nfc_recv, nchunk);
     UnpackAMRBuffersCC(pmhd->u0, pmhd->coarse_u0, ncc_recv, nfc_recv);
     ncc_recv += pmhd->nmhd + pmhd->nscalars;
+    WaitRecvAMR(ncc_recv, nfc_recv, nchunk);
     UnpackAMRBuffersFC(pmhd->b0, pmhd->coarse_b0, ncc_recv, nfc_recv);
     nfc_recv += 1;
   }
   if (pz4c != nullptr) {
+    WaitRecvAMR(ncc_recv, nfc_recv, nchunk);
     UnpackAMRBuffersCC(pz4c->u0, pz4c->coarse_u0, ncc_recv, nfc_recv);
     ncc_recv += pz4c->nz4c;
   }
+  auto &extra_cc = pmy_mesh->pmb_pack->extra_cc;
+  if (!(extra_cc.empty())) {WaitRecvAMR(ncc_recv, nfc_recv, nchunk);}
+  for (auto &e : extra_cc) {
+    UnpackAMRBuffersCC(*(e.u), *(e.coarse_u), ncc_recv, nfc_recv);
+    ncc_recv += e.u->extent_int(1);
+  }
+  delete [] recv_req;
 #endif
   return;
 }
@@ -996,7 +1308,7 @@ void MeshRefinement::UnpackAMRBuffersFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Re
 void MeshRefinement::ClearSendAMR() {
 #if MPI_PARALLEL_ENABLED
   bool no_errors=true;
-  for (int n=0; n<nmb_send; ++n) {
+  for (int n=0; n<namr_chunks*nmb_send; ++n) {
     int ierr = MPI_Wait(&(send_req[n]), MPI_STATUS_IGNORE);
     if (ierr != MPI_SUCCESS) {no_errors=false;}
   }
@@ -1011,3 +1323,111 @@ void MeshRefinement::ClearSendAMR() {
 #endif
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::SetAMRChunks()
+//! \brief Sets the chunks of variables in each AMR buffer that are communicated as
+//! separate messages.  Chunks are stored in the same order variables are packed.
+
+void MeshRefinement::SetAMRChunks() {
+#if MPI_PARALLEL_ENABLED
+  hydro::Hydro* phydro = pmy_mesh->pmb_pack->phydro;
+  mhd::MHD* pmhd = pmy_mesh->pmb_pack->pmhd;
+  z4c::Z4c* pz4c = pmy_mesh->pmb_pack->pz4c;
+
+  namr_chunks = 0;
+  int ncc = 0, nfc = 0;
+  auto add_chunk = [&](int nvcc, int nvfc) {
+    if (pipelined_migration || namr_chunks == 0) {
+      amr_chunks[namr_chunks++] = {ncc, nfc, 0, 0};
+    }
+    amr_chunks[namr_chunks-1].nvcc += nvcc;
+    amr_chunks[namr_chunks-1].nvfc += nvfc;
+    ncc += nvcc;
+    nfc += nvfc;
+  };
+  if (phydro != nullptr) {
+    add_chunk(phydro->nhydro + phydro->nscalars, 0);
+  }
+  if (pmhd != nullptr) {
+    add_chunk(pmhd->nmhd + pmhd->nscalars, 0);
+    add_chunk(0, 1);
+  }
+  if (pz4c != nullptr) {
+    add_chunk(pz4c->nz4c, 0);
+  }
+  int nextra = 0;
+  for (auto &e : pmy_mesh->pmb_pack->extra_cc) {nextra += e.u->extent_int(1);}
+  if (nextra > 0) {
+    add_chunk(nextra, 0);
+  }
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::PostSendAMR()
+//! \brief Posts non-blocking sends for all chunks of variables ending at (ncc,nfc), that
+//! is chunks which have been completely packed.  Index nchunk of the next chunk to be
+//! sent is incremented.
+
+void MeshRefinement::PostSendAMR(int ncc, int nfc, int &nchunk) {
+#if MPI_PARALLEL_ENABLED
+  bool no_errors=true;
+  bool fenced=false;
+  while (nchunk < namr_chunks &&
+         amr_chunks[nchunk].ncc + amr_chunks[nchunk].nvcc == ncc &&
+         amr_chunks[nchunk].nfc + amr_chunks[nchunk].nvfc == nfc) {
+    // wait for pack kernels to finish before first send
+    if (!(fenced)) {
+      Kokkos::fence();
+      fenced = true;
+    }
+    for (int n=0; n<nmb_send; ++n) {
+      int vs = amr_chunks[nchunk].Start(sendbuf.h_view(n));
+      int ve = vs + amr_chunks[nchunk].Count(sendbuf.h_view(n));
+      auto pdata = Kokkos::subview(send_data, std::make_pair(vs,ve));
+      int ierr = MPI_Isend(pdata.data(), (ve - vs), MPI_ATHENA_REAL,
+                           sendbuf.h_view(n).rank, sendbuf.h_view(n).tag, amr_comm,
+                           &(send_req[nchunk*nmb_send + n]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+    nchunk++;
+  }
+
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in posting non-blocking sends with AMR"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::WaitRecvAMR()
+//! \brief Waits for non-blocking receives of all chunks of variables starting at
+//! (ncc,nfc) to finish.  Index nchunk of the next chunk to be received is incremented.
+
+void MeshRefinement::WaitRecvAMR(int ncc, int nfc, int &nchunk) {
+#if MPI_PARALLEL_ENABLED
+  bool no_errors=true;
+  while (nchunk < namr_chunks &&
+         amr_chunks[nchunk].ncc == ncc && amr_chunks[nchunk].nfc == nfc) {
+    int ierr = MPI_Waitall(nmb_recv, &(recv_req[nchunk*nmb_recv]), MPI_STATUSES_IGNORE);
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    nchunk++;
+  }
+
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in posting non-blocking receives with AMR"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return;
+}
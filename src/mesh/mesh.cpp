@@ -28,6 +28,8 @@
 #include "particles/particles.hpp"
 #include "srcterms/srcterms.hpp"
 #include "outputs/io_wrapper.hpp"
+#include "utils/memory_tracker.hpp"
+#include "utils/profiling_region.hpp"
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
@@ -49,9 +51,26 @@ Mesh::Mesh(ParameterInput *pin) :
   multi_d(false),
   strictly_periodic(true),
   nmb_packs_thisrank(1),
+  nghbr_version(0),
+  mesh_version(0),
   nprtcl_thisrank(0),
   nprtcl_total(0),
-  dtold(0.) {
+  sfc_ordering(SFCOrdering::zorder),
+  partitioner(PartitionMethod::greedy),
+  lb_automatic(false),
+  lb_interval(10),
+  lb_sample_cycles(5),
+  lb_cost_window(10),
+  lb_nsample(0),
+  lb_tolerance(0.8),
+  lb_efficiency(1.0),
+  lb_c2p_fraction(0.0),
+  lb_chem_fraction(0.0),
+  lb_incremental(false),
+  lb_imbalance(0.1),
+  dtold(0.),
+  async_dt(false),
+  dt_version_(-1) {
   // Set physical size and number of cells in mesh (root level)
   mesh_size.x1min = pin->GetReal("mesh", "x1min");
   mesh_size.x1max = pin->GetReal("mesh", "x1max");
@@ -183,6 +202,83 @@ Mesh::Mesh(ParameterInput *pin) :
     std::exit(EXIT_FAILURE);
   }
 
+  // read space-filling curve used to order MeshBlocks, and method used to partition them
+  {
+    std::string sfc = pin->GetOrAddString("loadbalancing","ordering","zorder");
+    if (sfc.compare("zorder") == 0) {
+      sfc_ordering = SFCOrdering::zorder;
+    } else if (sfc.compare("hilbert") == 0) {
+      sfc_ordering = SFCOrdering::hilbert;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<loadbalancing>/ordering=" << sfc << " not implemented. "
+          << "Valid choices are [zorder,hilbert]." << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    std::string part = pin->GetOrAddString("loadbalancing","partitioner","greedy");
+    if (part.compare("greedy") == 0) {
+      partitioner = PartitionMethod::greedy;
+    } else if (part.compare("node_aware") == 0) {
+      partitioner = PartitionMethod::node_aware;
+      SetNodeLayout();
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<loadbalancing>/partitioner=" << part << " not implemented. "
+          << "Valid choices are [greedy,node_aware]." << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
+  // read parameters controlling automatic load balancing using measured costs.  Data
+  // in MeshBlocks can only be redistributed with SMR/AMR (using MeshRefinement class).
+  if (pin->GetOrAddString("loadbalancing","balancer","default") == "automatic") {
+    if (multilevel) {
+      lb_automatic = true;
+      lb_interval = pin->GetOrAddInteger("loadbalancing","interval",10);
+      lb_sample_cycles = pin->GetOrAddInteger("loadbalancing","sample_cycles",5);
+      lb_cost_window = pin->GetOrAddInteger("loadbalancing","window",10);
+      lb_tolerance = pin->GetOrAddReal("loadbalancing","tolerance",0.8);
+      lb_c2p_fraction = pin->GetOrAddReal("loadbalancing","c2p_fraction",0.0);
+      lb_chem_fraction = pin->GetOrAddReal("loadbalancing","chem_fraction",0.0);
+      if (lb_interval < 1 || lb_sample_cycles < 1 || lb_cost_window < 1) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "<loadbalancing>/interval, sample_cycles and window must "
+            << "all be >= 1"
+            << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (lb_tolerance <= 0.0 || lb_tolerance > 1.0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "<loadbalancing>/tolerance must be in range (0,1]"
+            << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (lb_c2p_fraction < 0.0 || lb_c2p_fraction > 1.0 ||
+          lb_chem_fraction < 0.0 || lb_chem_fraction > 1.0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "<loadbalancing>/c2p_fraction and chem_fraction must be in "
+            << "range [0,1]" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    } else if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+          << "<loadbalancing>/balancer=automatic requires SMR or AMR, and will be "
+          << "ignored" << std::endl;
+    }
+  }
+
+  // read parameters of incremental load balancing, which moves as few MeshBlocks as
+  // possible when the Mesh is redistributed (only possible with SMR/AMR)
+  if (multilevel) {
+    lb_incremental = pin->GetOrAddBoolean("loadbalancing","incremental",false);
+    lb_imbalance = pin->GetOrAddReal("loadbalancing","imbalance",0.1);
+    if (lb_imbalance < 0.0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<loadbalancing>/imbalance must be >= 0" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
   // error check physical size of mesh (root level) from input file.
   if (mesh_size.x1max <= mesh_size.x1min) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
@@ -386,17 +482,18 @@ void Mesh::PrintMeshDiagnostics() {
   // if more than one rank: compute/output # of blocks and cost per rank
   if (global_variable::nranks > 1) {
     int nb_per_rank[global_variable::nranks];    // NOLINT(runtime/arrays)
-    int cost_per_rank[global_variable::nranks];  // NOLINT(runtime/arrays)
+    float cost_per_rank[global_variable::nranks];  // NOLINT(runtime/arrays)
     for (int i=0; i<global_variable::nranks; ++i) {
       nb_per_rank[i] = 0;
-      cost_per_rank[i] = 0;
+      cost_per_rank[i] = 0.0;
     }
     for (int i=0; i<nmb_total; i++) {
       nb_per_rank[rank_eachmb[i]]++;
       cost_per_rank[rank_eachmb[i]] += cost_eachmb[i];
     }
-    int mincost = std::numeric_limits<int>::max();
-    int maxcost = 0, totalcost = 0;
+    // costs are floats since they may be measured with automatic load balancing
+    float mincost = std::numeric_limits<float>::max();
+    float maxcost = 0.0, totalcost = 0.0;
     for (int i=0; i<global_variable::nranks; ++i) {
       std::cout << "  Rank = " << i << ": " << nb_per_rank[i] <<" MeshBlocks, cost = "
                 << cost_per_rank[i] << std::endl;
@@ -408,8 +505,8 @@ void Mesh::PrintMeshDiagnostics() {
     // output normalized costs per rank
     std::cout << "Load Balancing:" << std::endl;
     std::cout << "  Maximum normalized cost = "
-      << static_cast<float>(maxcost)/static_cast<float>(mincost) << ", Average = "
-      << static_cast<float>(totalcost)/static_cast<float>(global_variable::nranks*mincost)
+      << maxcost/mincost << ", Average = "
+      << totalcost/(static_cast<float>(global_variable::nranks)*mincost)
       << std::endl;
   }
 }
@@ -563,68 +660,118 @@ std::string Mesh::GetBoundaryString(BoundaryFlag input_flag) {
 
 //----------------------------------------------------------------------------------------
 // \fn Mesh::NewTimeStep()
+// Computes new timestep from minimum over all MeshBlocks on all ranks.  With blocking
+// communication this is simply StartNewTimeStep() followed by FinishNewTimeStep().
 
 void Mesh::NewTimeStep(const Real tlim) {
-  // save old timestep
-  dtold = dt;
-  if (dt == std::numeric_limits<float>::max()) {
-    dtold = 0.;
-  }
+  StartNewTimeStep();
+  FinishNewTimeStep(tlim);
+  return;
+}
 
+//----------------------------------------------------------------------------------------
+// \fn Mesh::StartNewTimeStep()
+// Finds minimum dt over all MeshBlocks on this rank, and starts the (non-blocking)
+// reduction over all ranks.  Mesh::dt is unchanged until FinishNewTimeStep(), so that
+// work overlapped with the reduction (outputs, after_timeintegrator tasks) sees the dt
+// of the cycle just completed.
+
+void Mesh::StartNewTimeStep() {
+  ProfilingRegion region("StartNewTimeStep");
   // cycle over all MeshBlocks on this rank and find minimum dt
   // Requires at least ONE of the physics modules to be defined.
   // limit increase in timestep to 2x old value
-  dt = 2.0*dt;
-
+  Real &newdt = dt_send_;
+  newdt = 2.0*dt;
   // Hydro timestep
   if (pmb_pack->phydro != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->dtnew) );
-    // viscosity timestep
-    if (pmb_pack->phydro->pvisc != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->pvisc->dtnew) );
+    newdt = std::min(newdt, (cfl_no)*(pmb_pack->phydro->dtnew) );
+    // viscosity timestep (not needed when integrated with super time-stepping)
+    if ((pmb_pack->phydro->pvisc != nullptr) && !(pmb_pack->phydro->use_sts)) {
+      newdt = std::min(newdt, (cfl_no)*(pmb_pack->phydro->pvisc->dtnew) );
     }
     // thermal conduction timestep
-    if (pmb_pack->phydro->pcond != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->pcond->dtnew) );
+    if ((pmb_pack->phydro->pcond != nullptr) && !(pmb_pack->phydro->use_sts)) {
+      newdt = std::min(newdt, (cfl_no)*(pmb_pack->phydro->pcond->dtnew) );
     }
     // source terms timestep
-    dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->psrc->dtnew) );
+    newdt = std::min(newdt, (cfl_no)*(pmb_pack->phydro->psrc->dtnew) );
   }
   // MHD timestep
   if (pmb_pack->pmhd != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->dtnew) );
-    // viscosity timestep
-    if (pmb_pack->pmhd->pvisc != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->pvisc->dtnew) );
+    newdt = std::min(newdt, (cfl_no)*(pmb_pack->pmhd->dtnew) );
+    // viscosity timestep (not needed when integrated with super time-stepping)
+    if ((pmb_pack->pmhd->pvisc != nullptr) && !(pmb_pack->pmhd->use_sts)) {
+      newdt = std::min(newdt, (cfl_no)*(pmb_pack->pmhd->pvisc->dtnew) );
     }
     // resistivity timestep
     if (pmb_pack->pmhd->presist != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->presist->dtnew) );
+      newdt = std::min(newdt, (cfl_no)*(pmb_pack->pmhd->presist->dtnew) );
     }
     // thermal conduction timestep
-    if (pmb_pack->pmhd->pcond != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->pcond->dtnew) );
+    if ((pmb_pack->pmhd->pcond != nullptr) && !(pmb_pack->pmhd->use_sts)) {
+      newdt = std::min(newdt, (cfl_no)*(pmb_pack->pmhd->pcond->dtnew) );
     }
     // source terms timestep
-    dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->psrc->dtnew) );
+    newdt = std::min(newdt, (cfl_no)*(pmb_pack->pmhd->psrc->dtnew) );
   }
   // z4c timestep
   if (pmb_pack->pz4c != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->pz4c->dtnew) );
+    if (pmb_pack->pz4c->multirate > 1) {
+      // spacetime is advanced with timestep multirate*dt
+      newdt = std::min(newdt, (pmb_pack->pz4c->multirate_cfl)*(pmb_pack->pz4c->dtnew)/
+                              static_cast<Real>(pmb_pack->pz4c->multirate) );
+    } else {
+      newdt = std::min(newdt, (cfl_no)*(pmb_pack->pz4c->dtnew) );
+    }
   }
   // Radiation timestep
   if (pmb_pack->prad != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->prad->dtnew) );
+    newdt = std::min(newdt, (cfl_no)*(pmb_pack->prad->dtnew) );
   }
   // Particles timestep
   if (pmb_pack->ppart != nullptr) {
-    dt = std::min(dt, (pmb_pack->ppart->dtnew) );
+    newdt = std::min(newdt, (pmb_pack->ppart->dtnew) );
   }
+  // limit set by error control with embedded RK pairs
+  newdt = std::min(newdt, dt_err);
+
+  dt_version_ = mesh_version;
 
 #if MPI_PARALLEL_ENABLED
   // get minimum dt over all MPI ranks
-  MPI_Allreduce(MPI_IN_PLACE, &dt, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Iallreduce(&dt_send_, &dt_recv_, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD,
+                 &dt_req_);
+#else
+  dt_recv_ = dt_send_;
 #endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+// \fn Mesh::FinishNewTimeStep()
+// Completes reduction of new dt started by StartNewTimeStep().  If MeshBlocks have been
+// refined or moved since the reduction was started, the result is stale and dt is
+// recomputed with the new MeshBlocks (with blocking communication).
+
+void Mesh::FinishNewTimeStep(const Real tlim) {
+  ProfilingRegion region("FinishNewTimeStep");
+#if MPI_PARALLEL_ENABLED
+  MPI_Wait(&dt_req_, MPI_STATUS_IGNORE);
+#endif
+  if (dt_version_ != mesh_version) {
+    StartNewTimeStep();
+#if MPI_PARALLEL_ENABLED
+    MPI_Wait(&dt_req_, MPI_STATUS_IGNORE);
+#endif
+  }
+
+  // save old timestep
+  dtold = dt;
+  if (dt == std::numeric_limits<float>::max()) {
+    dtold = 0.;
+  }
+  dt = dt_recv_;
 
   // limit last time step to stop at tlim *exactly*
   if ( (time < tlim) && ((time + dt) > tlim) ) {dt = tlim - time;}
@@ -638,9 +785,11 @@ void Mesh::NewTimeStep(const Real tlim) {
 void Mesh::AddCoordinatesAndPhysics(ParameterInput *pinput) {
   // cycle over MeshBlockPacks on this rank and add Coordinates and Physics
   for (int n=0; n<nmb_packs_thisrank; ++n) {
+    memory_tracker::SetScope("coordinates");
     pmb_pack->AddCoordinates(pinput);
     pmb_pack->AddPhysics(pinput);
   }
+  memory_tracker::SetScope("pgen");
 
   // Determine total number of particles across all ranks
   particles::Particles *ppart = pmb_pack->ppart;
@@ -12,8 +12,10 @@
 //! are grouped together into MeshBlockPacks for better performance on GPUs.
 
 #include <cstdint>  // int32_t
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 
@@ -65,14 +67,60 @@ struct LogicalLocation {
 
 //----------------------------------------------------------------------------------------
 //! \struct EventCounters
-//! \brief stores various counters used as diagnostics throughout the code
+//! \brief stores various counters used as diagnostics throughout the code.  The totals
+//! over this rank are accumulated on the host.  The same events are also counted in
+//! each MeshBlock on the device (in mb, indexed by local MB and EventCounterIndex), which
+//! gives their location.  Counts in mb are reset by eventlog outputs and by regridding.
+
+enum EventCounterIndex {EVC_DFLOOR, EVC_EFLOOR, EVC_TFLOOR, EVC_VCEIL, EVC_FAIL,
+                        EVC_MAXIT, EVC_FOFC, EVC_C2P_WORK, NEVENT_COUNTERS};
 
 struct EventCounters {
   int nfofc, neos_dfloor, neos_efloor, neos_tfloor, neos_vceil, neos_fail, maxit_c2p;
+  int nc2p_work;  // cells deferred to second pass of batched C2P
+  DvceArray2D<int> mb;  // counts (maximum for EVC_MAXIT) in each MB on this rank
   EventCounters() : nfofc(0), neos_dfloor(0), neos_efloor(0), neos_tfloor(0),
-                    neos_vceil(0), neos_fail(0), maxit_c2p(0) {}
+                    neos_vceil(0), neos_fail(0), maxit_c2p(0), nc2p_work(0) {}
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct PerfCounters
+//! \brief stores wall time and communication volume on this rank, accumulated between
+//! "perf" outputs (which reset them)
+
+struct PerfCounters {
+  double t_comm;             // host wall time (s) in boundary communication functions
+  double t_amr;              // wall time (s) in mesh refinement and load balancing
+  std::int64_t nbytes_sent;  // bytes sent to other ranks in boundary communication
+  int nstages;               // stages of the time integrator executed (incl. rejected)
+  PerfCounters() : t_comm(0.0), t_amr(0.0), nbytes_sent(0), nstages(0) {}
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct ScopedTimer
+//! \brief adds wall time elapsed during its lifetime to a counter
+
+struct ScopedTimer {
+  explicit ScopedTimer(double &t) : total(t) {}
+  ~ScopedTimer() {total += timer.seconds();}
+  double &total;
+  Kokkos::Timer timer;
 };
 
+//----------------------------------------------------------------------------------------
+//! \enum SFCOrdering
+//! \brief space-filling curve used to order MeshBlocks (and so to assign their gids)
+
+enum class SFCOrdering {zorder, hilbert};
+
+//----------------------------------------------------------------------------------------
+//! \enum PartitionMethod
+//! \brief method used to divide list of ordered MeshBlocks into contiguous parts for each
+//! rank. With node_aware the list is first divided between (shared-memory) nodes, then
+//! between the ranks on each node.
+
+enum class PartitionMethod {greedy, node_aware};
+
 // Forward declarations required due to recursive definitions amongst mesh classes
 class MeshBlock;
 class MeshBlockPack;
@@ -98,6 +146,8 @@ class Mesh {
   friend class MeshRefinement;
   // needs to access tree to find target MB offset by shear
   friend class ShearingBox;
+  // needs to access tree to find MB containing interpolation points
+  friend class PointInterpolator;
 
  public:
   explicit Mesh(ParameterInput *pin);
@@ -123,6 +173,9 @@ class Mesh {
   int root_level; // logical level of root (physical) grid (e.g. Fig. 3 of method paper)
   int max_level;  // logical level of maximum refinement grid in Mesh
 
+  int nghbr_version;       // incremented each time neighbors of MeshBlocks are reset
+  int mesh_version;        // incremented (on all ranks) each time MBs are redistributed
+
   int nprtcl_thisrank;     // number of particles this rank
   int nprtcl_total;        // total number of particles across all ranks
 
@@ -137,9 +190,31 @@ class Mesh {
   // following 1x arrays allocated with length [nranks] in AddCoordinatesAndPhysics()
   int *nprtcl_eachrank;    // number of particles on each rank
 
+  // parameters controlling ordering and partitioning of MeshBlocks over ranks
+  SFCOrdering sfc_ordering;         // space-filling curve used to order MeshBlocks
+  PartitionMethod partitioner;      // method to divide ordered MeshBlocks between ranks
+  std::vector<int> nranks_eachnode; // number of ranks on each node (node_aware only)
+
+  // parameters and data for automatic load balancing using measured costs
+  bool lb_automatic;       // true if cost of each MeshBlock is measured during run
+  int lb_interval;         // # of cycles between checks of load balancing efficiency
+  int lb_sample_cycles;    // # of cycles between cycles in which costs are measured
+  int lb_cost_window;      // # of measurements over which measured costs are smoothed
+  int lb_nsample;          // # of sampled cycles in which costs have been measured
+  float lb_tolerance;      // rebalance when measured efficiency drops below this value
+  float lb_efficiency;     // most recently measured load balancing efficiency
+  float lb_c2p_fraction;   // fraction of cost split between MeshBlocks by C2P iterations
+  float lb_chem_fraction;  // fraction of cost split between MeshBlocks by chemistry work
+  bool lb_incremental;     // true to keep ranks of existing MeshBlocks where possible
+  float lb_imbalance;      // allowed excess of max cost per rank over mean (incremental)
+
   Real time, dt, dtold, cfl_no;
+  bool async_dt;           // overlap global reduction of new dt with end of cycle work
+  // upper limit on dt set by error control with embedded RK pairs
+  Real dt_err = std::numeric_limits<float>::max();
   int ncycle;
   EventCounters ecounter;
+  PerfCounters pcounter;
 
   int nmb_packs_thisrank;                  // number of MBPacks on this rank
   MeshBlockPack* pmb_pack;                 // container for MeshBlocks on this rank
@@ -153,9 +228,16 @@ class Mesh {
   void PrintMeshDiagnostics();
   void WriteMeshStructure();
   void NewTimeStep(const Real tlim);
+  void StartNewTimeStep();
+  void FinishNewTimeStep(const Real tlim);
   void AddCoordinatesAndPhysics(ParameterInput *pinput);
   BoundaryFlag GetBoundaryFlag(const std::string& input_string);
   std::string GetBoundaryString(BoundaryFlag input_flag);
+  // functions for automatic load balancing (in file load_balance.cpp)
+  void UpdateMeasuredCosts();
+  void GatherMeasuredCosts();
+  bool CheckMeasuredLoadBalance();
+  void SetNodeLayout();
 
   // comparison function for sorting LogicalLocations based on level
   static bool GreaterLevel(const LogicalLocation & left, const LogicalLocation &right) {
@@ -175,6 +257,13 @@ class Mesh {
 
  private:
   std::unique_ptr<MeshBlockTree> ptree;  // pointer to root node in binary/quad/oct-tree
+  Real dt_send_, dt_recv_;  // local/global new dt while reduction is in flight
+  int dt_version_;          // mesh_version when reduction of new dt was started
+#if MPI_PARALLEL_ENABLED
+  MPI_Request dt_req_;
+#endif
   void LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb);
+  void IncrementalLoadBalance(float *clist, int *olist, int *rlist, int *slist,
+                              int *nlist, int nb);
 };
 #endif  // MESH_MESH_HPP_
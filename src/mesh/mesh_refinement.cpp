@@ -12,14 +12,18 @@
 #include <cstdint>   // int32_t
 #include <iostream>
 #include <cmath>     // abs
-#include <algorithm> // sort
+#include <algorithm> // sort, min, max
 #include <utility>   // pair
+#include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh.hpp"
 #include "mesh_refinement.hpp"
+#include "refinement_criteria.hpp"
+#include "nghbr_index.hpp"
 
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
@@ -27,8 +31,10 @@
 #include "coordinates/adm.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
+#include "particles/particles.hpp"
 #include "prolongation.hpp"
 #include "restriction.hpp"
+#include "utils/memory_tracker.hpp"
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
@@ -42,17 +48,26 @@ MeshRefinement::MeshRefinement(Mesh *pm, ParameterInput *pin) :
   pmy_mesh(pm),
   refine_flag("rflag",pm->nmb_total),
   ncyc_since_ref("cyc_since_ref",pm->nmb_total),
+  nderef_checks("nderef_checks",pm->nmb_total),
   nmb_created(0),
   nmb_deleted(0),
   nmb_sent_thisrank(0),
+  nbytes_sent_thisrank(0.0),
   ncyc_check_amr(1),
   refinement_interval(5),
   prolong_prims(false),
+  pipelined_migration(false),
+  derefine_count(1),
+  refine_buffer(false),
+  lookahead_cycles(0.0),
+  restrict_bndry_only(false),
+  coarse_nghbr_mask("cmask",1),
   d_threshold_(0.0),
   dd_threshold_(0.0),
   dp_threshold_(0.0),
   dv_threshold_(0.0),
-  check_cons_(false) {
+  check_cons_(false),
+  cmask_version_(-1) {
   if (pin->DoesBlockExist("mesh_refinement")) {
     // read interval (in cycles) between check of AMR and derefinement
     ncyc_check_amr = pin->GetOrAddReal("mesh_refinement", "ncycle_check", 1);
@@ -61,6 +76,19 @@ MeshRefinement::MeshRefinement(Mesh *pm, ParameterInput *pin) :
     if (pin->DoesParameterExist("mesh_refinement", "prolong_primitives")) {
       prolong_prims = pin->GetBoolean("mesh_refinement", "prolong_primitives");
     }
+    // read flag to pipeline packing, sending, and unpacking of each array with AMR
+    pipelined_migration = pin->GetOrAddBoolean("mesh_refinement", "pipelined_migration",
+                                               false);
+    // read parameters to reduce refine/derefine thrashing: number of successive checks
+    // before derefinement, buffer of MBs around refined MBs that cannot be derefined,
+    // and number of cycles over which motion of features is predicted by refinement
+    derefine_count = pin->GetOrAddInteger("mesh_refinement", "derefine_count", 1);
+    refine_buffer = pin->GetOrAddBoolean("mesh_refinement", "refine_buffer", false);
+    lookahead_cycles = pin->GetOrAddReal("mesh_refinement", "lookahead_cycles", 0.0);
+    // read flag to restrict only coarse cells that are sent to coarser neighbors or used
+    // in prolongation, rather than the full MeshBlock
+    restrict_bndry_only = pin->GetOrAddBoolean("mesh_refinement",
+                                               "restrict_boundary_only", false);
     // read refinement criteria thresholds
     if (pin->DoesParameterExist("mesh_refinement", "dens_max")) {
       d_threshold_ = pin->GetReal("mesh_refinement", "dens_max");
@@ -80,17 +108,11 @@ MeshRefinement::MeshRefinement(Mesh *pm, ParameterInput *pin) :
     }
   }
 
-  if (pm->adaptive) {  // allocate arrays for AMR
-    nref_eachrank = new int[global_variable::nranks];
-    nderef_eachrank = new int[global_variable::nranks];
-    nref_rsum = new int[global_variable::nranks];
-    nderef_rsum = new int[global_variable::nranks];
-  }
-
   // be sure Views are initialized to zero
   for (int m=0; m<(pm->nmb_total); ++m) {
     refine_flag.h_view(m) = 0;
     ncyc_since_ref(m) = 0;
+    nderef_checks(m) = 0;
   }
   refine_flag.template modify<HostMemSpace>();
   refine_flag.template sync<DevExeSpace>();
@@ -108,12 +130,6 @@ MeshRefinement::MeshRefinement(Mesh *pm, ParameterInput *pin) :
 // destructor
 
 MeshRefinement::~MeshRefinement() {
-  if (pmy_mesh->adaptive) { // deallocate arrays for AMR
-    delete [] nref_eachrank;
-    delete [] nderef_eachrank;
-    delete [] nref_rsum;
-    delete [] nderef_rsum;
-  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -130,22 +146,11 @@ void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin
 
   // Refine/derefine mesh and evolved data, set boundary conditions/timestep on new mesh
   if (nnew != 0 || ndel != 0) { // at least one (de)refinement flagged
+    memory_tracker::SetScope("amr");
     RedistAndRefineMeshBlocks(pin, nnew, ndel);
-    pdriver->InitBoundaryValuesAndPrimitives(pmy_mesh);
-
-    MeshBlockPack* pmbp = pmy_mesh->pmb_pack;
-    if (pmbp->phydro != nullptr) {
-      (void) pmbp->phydro->NewTimeStep(pdriver, pdriver->nexp_stages);
-    }
-    if (pmbp->pmhd != nullptr) {
-      (void) pmbp->pmhd->NewTimeStep(pdriver, pdriver->nexp_stages);
-    }
-    if (pmbp->prad != nullptr) {
-      (void) pmbp->prad->NewTimeStep(pdriver, pdriver->nexp_stages);
-    }
-    if (pmbp->pz4c != nullptr) {
-      (void) pmbp->pz4c->NewTimeStep(pdriver, pdriver->nexp_stages);
-    }
+    InitNewMeshBlocks(pdriver);
+    memory_tracker::SetScope("other");
+    memory_tracker::Report("after regrid at cycle=" + std::to_string(pmy_mesh->ncycle));
 
     nmb_created += nnew;
     nmb_deleted += ndel;
@@ -153,6 +158,53 @@ void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::RebalanceMeshBlocks()
+//! \brief Driver function for automatic load balancing.  Redistributes MeshBlocks over
+//! ranks (without refinement) using measured costs when the measured load balancing
+//! efficiency drops below the tolerance.
+
+void MeshRefinement::RebalanceMeshBlocks(Driver *pdriver, ParameterInput *pin) {
+  if (!(pmy_mesh->CheckMeasuredLoadBalance())) return;
+
+  if (global_variable::my_rank == 0) {
+    std::cout << "Rebalancing MeshBlocks at cycle=" << pmy_mesh->ncycle
+              << ", measured load balancing efficiency = " << pmy_mesh->lb_efficiency
+              << std::endl;
+  }
+  memory_tracker::SetScope("amr");
+  RedistAndRefineMeshBlocks(pin, 0, 0);
+  InitNewMeshBlocks(pdriver);
+  memory_tracker::SetScope("other");
+  memory_tracker::Report("after rebalancing at cycle=" +
+                         std::to_string(pmy_mesh->ncycle));
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::InitNewMeshBlocks()
+//! \brief Sets boundary conditions, primitives, and timestep on MeshBlocks after they
+//! have been redistributed and/or refined
+
+void MeshRefinement::InitNewMeshBlocks(Driver *pdriver) {
+  pdriver->InitBoundaryValuesAndPrimitives(pmy_mesh);
+
+  MeshBlockPack* pmbp = pmy_mesh->pmb_pack;
+  if (pmbp->phydro != nullptr) {
+    (void) pmbp->phydro->NewTimeStep(pdriver, pdriver->nexp_stages);
+  }
+  if (pmbp->pmhd != nullptr) {
+    (void) pmbp->pmhd->NewTimeStep(pdriver, pdriver->nexp_stages);
+  }
+  if (pmbp->prad != nullptr) {
+    (void) pmbp->prad->NewTimeStep(pdriver, pdriver->nexp_stages);
+  }
+  if (pmbp->pz4c != nullptr) {
+    (void) pmbp->pz4c->NewTimeStep(pdriver, pdriver->nexp_stages);
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn bool MeshRefinement::CheckForRefinement()
 //! \brief Checks for refinement/de-refinement and sets refine_flag(m) for all
@@ -165,7 +217,9 @@ void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin
 //!   TODO(@user) (5) current density above a threshold (MHD)
 //! These are controlled by input parameters in the <mesh_refinement> block.
 //! User-defined refinement conditions can also be enrolled by setting the *usr_ref_func
-//! pointer in the problem generator.
+//! pointer in the problem generator, which can use FlagRefinement() to evaluate its own
+//! criteria (composed with HydroRefinementVote if needed) in a single kernel.
+//! Flags are only copied between device and host once, after all criteria are evaluated.
 
 void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
   // reallocate and zero refine_flag in host space and sync with device
@@ -182,86 +236,23 @@ void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
   }
   if ((pmbp->pmesh->ncycle)%(ncyc_check_amr) != 0) {return;}  // not cycle to check
 
-  // capture variables for kernels
-  auto &multi_d = pmy_mesh->multi_d;
-  auto &three_d = pmy_mesh->three_d;
-  auto &indcs = pmy_mesh->mb_indcs;
-  int &is = indcs.is, nx1 = indcs.nx1;
-  int &js = indcs.js, nx2 = indcs.nx2;
-  int &ks = indcs.ks, nx3 = indcs.nx3;
-  const int nkji = nx3*nx2*nx1;
-  const int nji  = nx2*nx1;
-
   // check (on device) Hydro/MHD refinement conditions for cons vars over all MeshBlocks
-  auto refine_flag_ = refine_flag;
-  auto &dens_thresh  = d_threshold_;
-  auto &ddens_thresh = dd_threshold_;
-  auto &dpres_thresh = dp_threshold_;
+  // All conditions are evaluated in a single kernel (see refinement_criteria.hpp)
   int nmb = pmbp->nmb_thispack;
   int mbs = pmy_mesh->gids_eachrank[global_variable::my_rank];
   if (((pmbp->phydro != nullptr) || (pmbp->pmhd != nullptr)) && check_cons_) {
-    auto &u0 = (pmbp->phydro != nullptr)? pmbp->phydro->u0 : pmbp->pmhd->u0;
-    auto &w0 = (pmbp->phydro != nullptr)? pmbp->phydro->w0 : pmbp->pmhd->w0;
-
-    par_for_outer("ConsRefineCond",DevExeSpace(), 0, 0, 0, (nmb-1),
-    KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
-      // density threshold
-      if (dens_thresh!= 0.0) {
-        Real team_dmax=0.0;
-        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real& dmax) {
-          int k = (idx)/nji;
-          int j = (idx - k*nji)/nx1;
-          int i = (idx - k*nji - j*nx1) + is;
-          j += js;
-          k += ks;
-          dmax = fmax(u0(m,IDN,k,j,i), dmax);
-        },Kokkos::Max<Real>(team_dmax));
-
-        if (team_dmax > dens_thresh) {refine_flag_.d_view(m+mbs) = 1;}
-        if (team_dmax < dens_thresh) {refine_flag_.d_view(m+mbs) = -1;}
-      }
-
-      // density gradient threshold
-      if (ddens_thresh != 0.0) {
-        Real team_ddmax;
-        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real& ddmax) {
-          int k = (idx)/nji;
-          int j = (idx - k*nji)/nx1;
-          int i = (idx - k*nji - j*nx1) + is;
-          j += js;
-          k += ks;
-          Real d2 = SQR(u0(m,IDN,k,j,i+1) - u0(m,IDN,k,j,i-1));
-          if (multi_d) {d2 += SQR(u0(m,IDN,k,j+1,i) - u0(m,IDN,k,j-1,i));}
-          if (three_d) {d2 += SQR(u0(m,IDN,k+1,j,i) - u0(m,IDN,k-1,j,i));}
-          ddmax = fmax((sqrt(d2)/u0(m,IDN,k,j,i)), ddmax);
-        },Kokkos::Max<Real>(team_ddmax));
-
-        if (team_ddmax > ddens_thresh) {refine_flag_.d_view(m+mbs) = 1;}
-        if (team_ddmax < 0.25*ddens_thresh) {refine_flag_.d_view(m+mbs) = -1;}
-      }
-
-      // pressure gradient threshold
-      if (dpres_thresh != 0.0) {
-        Real team_dpmax;
-        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real& dpmax) {
-          int k = (idx)/nji;
-          int j = (idx - k*nji)/nx1;
-          int i = (idx - k*nji - j*nx1) + is;
-          j += js;
-          k += ks;
-          Real d2 = SQR(w0(m,IEN,k,j,i+1) - w0(m,IEN,k,j,i-1));
-          if (multi_d) {d2 += SQR(w0(m,IEN,k,j+1,i) - w0(m,IEN,k,j-1,i));}
-          if (three_d) {d2 += SQR(w0(m,IEN,k+1,j,i) - w0(m,IEN,k-1,j,i));}
-          dpmax = fmax((sqrt(d2)/w0(m,IEN,k,j,i)), dpmax);
-        },Kokkos::Max<Real>(team_dpmax));
-
-        if (team_dpmax > dpres_thresh) {refine_flag_.d_view(m+mbs) = 1;}
-        if (team_dpmax < 0.25*dpres_thresh) {refine_flag_.d_view(m+mbs) = -1;}
-      }
-    });
+    HydroRefinementVote vote;
+    vote.u0 = (pmbp->phydro != nullptr)? pmbp->phydro->u0 : pmbp->pmhd->u0;
+    vote.w0 = (pmbp->phydro != nullptr)? pmbp->phydro->w0 : pmbp->pmhd->w0;
+    vote.d_thresh  = d_threshold_;
+    vote.dd_thresh = dd_threshold_;
+    vote.dp_thresh = dp_threshold_;
+    vote.multi_d = pmy_mesh->multi_d;
+    vote.three_d = pmy_mesh->three_d;
+    vote.size = pmbp->pmb->mb_size;
+    vote.lookahead = lookahead_cycles*(pmy_mesh->dt);
+    vote.ng = pmy_mesh->mb_indcs.ng;
+    FlagRefinement(pmbp, true, vote, SetFlagFromVote());
   }
 
   // Check (on device) user-defined refinement condition(s), if any
@@ -287,11 +278,48 @@ void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
     if (ncyc_since_ref(m+mbs) < refinement_interval) {refine_flag.h_view(m+mbs) = 0;}
   }
 #if MPI_PARALLEL_ENABLED
-  // Pass refine_flag between all ranks
-    MPI_Allgatherv(MPI_IN_PLACE, pmy_mesh->nmb_eachrank[global_variable::my_rank],
-                   MPI_INT, refine_flag.h_view.data(), pmy_mesh->nmb_eachrank,
-                   pmy_mesh->gids_eachrank, MPI_INT, MPI_COMM_WORLD);
+  // Pass refine_flag between all ranks.  Only (gid, flag) pairs of MBs that are flagged
+  // are sent, since usually few are, rather than the flags of all nmb_total MBs.  Flags
+  // of MBs on other ranks are still zero here.
+  {
+    std::vector<int> flagged;
+    for (int m=0; m<nmb; ++m) {
+      if (refine_flag.h_view(m+mbs) != 0) {
+        flagged.push_back(m+mbs);
+        flagged.push_back(refine_flag.h_view(m+mbs));
+      }
+    }
+    std::vector<int> nflagged(global_variable::nranks), displ(global_variable::nranks);
+    int nsend = static_cast<int>(flagged.size());
+    MPI_Allgather(&nsend, 1, MPI_INT, nflagged.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    int ntotal = 0;
+    for (int n=0; n<global_variable::nranks; ++n) {
+      displ[n] = ntotal;
+      ntotal += nflagged[n];
+    }
+    if (ntotal > 0) {
+      std::vector<int> all_flagged(ntotal);
+      MPI_Allgatherv(flagged.data(), nsend, MPI_INT, all_flagged.data(), nflagged.data(),
+                     displ.data(), MPI_INT, MPI_COMM_WORLD);
+      for (int n=0; n<ntotal; n+=2) {
+        refine_flag.h_view(all_flagged[n]) = all_flagged[n+1];
+      }
+    }
+  }
 #endif
+  // Prevent (on host) derefinement of MBs adjacent to MBs flagged for refinement, and
+  // only allow derefinement of MBs flagged on derefine_count successive checks.  This is
+  // done for all MBs identically on every rank, since flags are now the same everywhere.
+  if (refine_buffer) {ApplyRefinementBuffer();}
+  for (int m=0; m<(pmy_mesh->nmb_total); ++m) {
+    if (refine_flag.h_view(m) < 0) {
+      nderef_checks(m) += 1;
+      if (nderef_checks(m) < derefine_count) {refine_flag.h_view(m) = 0;}
+    } else {
+      nderef_checks(m) = 0;
+    }
+  }
+
   // sync host array with device
   refine_flag.template modify<HostMemSpace>();
   refine_flag.template sync<DevExeSpace>();
@@ -299,10 +327,52 @@ void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::ApplyRefinementBuffer()
+//! \brief Clears derefinement flags of all MeshBlocks that share a face, edge, or corner
+//! with a MeshBlock flagged for refinement, so that refined regions are surrounded by a
+//! buffer that is not derefined while features move between neighboring MeshBlocks.
+
+void MeshRefinement::ApplyRefinementBuffer() {
+  int nox2 = (pmy_mesh->multi_d)? 1 : 0;
+  int nox3 = (pmy_mesh->three_d)? 1 : 0;
+  std::vector<MeshBlockTree*> nbrs;
+  for (int m=0; m<(pmy_mesh->nmb_total); ++m) {
+    if (refine_flag.h_view(m) <= 0) continue;
+    LogicalLocation &lloc = pmy_mesh->lloc_eachmb[m];
+    for (int ox3=-nox3; ox3<=nox3; ++ox3) {
+      for (int ox2=-nox2; ox2<=nox2; ++ox2) {
+        for (int ox1=-1; ox1<=1; ++ox1) {
+          if (ox1 == 0 && ox2 == 0 && ox3 == 0) continue;
+          MeshBlockTree* nt = pmy_mesh->ptree->FindNeighbor(lloc, ox1, ox2, ox3);
+          if (nt == nullptr) continue;
+          // neighbor is either a leaf, or a node whose leaves are at finer level
+          nbrs.clear();
+          if (nt->pleaf_ == nullptr) {
+            nbrs.push_back(nt);
+          } else {
+            for (int l=0; l<(MeshBlockTree::nleaf_); ++l) {
+              if (nt->pleaf_[l]->pleaf_ == nullptr) {nbrs.push_back(nt->pleaf_[l]);}
+            }
+          }
+          for (auto &nb : nbrs) {
+            if (nb->gid_ >= 0 && refine_flag.h_view(nb->gid_) < 0) {
+              refine_flag.h_view(nb->gid_) = 0;
+            }
+          }
+        }
+      }
+    }
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel)
 //! \brief collect refinement flags and manipulate the MeshBlockTree with AMR
-//! Returns total number of MBs refined/derefined in arguments.
+//! Returns total number of MBs refined/derefined in arguments.  Refinement flags of all
+//! MBs, and their logical locations, are already known on every rank (the flags are
+//! passed between ranks in CheckForRefinement()), so no communication is needed here.
 
 void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
   // compute nleaf= number of leaf MeshBlocks per refined block
@@ -310,24 +380,11 @@ void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
   if (pmy_mesh->two_d) {nleaf = 4;}
   if (pmy_mesh->three_d) {nleaf = 8;}
 
-  // count the number of the blocks to be (de)refined on this rank
-  nref_eachrank[global_variable::my_rank] = 0;
-  nderef_eachrank[global_variable::my_rank] = 0;
-  int mbs = pmy_mesh->gids_eachrank[global_variable::my_rank];
-  for (int i=0; i<(pmy_mesh->nmb_thisrank); ++i) {
-    if (refine_flag.h_view(i+mbs) ==  1) nref_eachrank[global_variable::my_rank]++;
-    if (refine_flag.h_view(i+mbs) == -1) nderef_eachrank[global_variable::my_rank]++;
-  }
-#if MPI_PARALLEL_ENABLED
-  MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, nref_eachrank,   1, MPI_INT, MPI_COMM_WORLD);
-  MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, nderef_eachrank, 1, MPI_INT, MPI_COMM_WORLD);
-#endif
-
   // count the number of the blocks to be (de)refined over all ranks
   int tnref = 0, tnderef = 0;
-  for (int n=0; n<global_variable::nranks; n++) {
-    tnref  += nref_eachrank[n];
-    tnderef += nderef_eachrank[n];
+  for (int m=0; m<(pmy_mesh->nmb_total); ++m) {
+    if (refine_flag.h_view(m) ==  1) tnref++;
+    if (refine_flag.h_view(m) == -1) tnderef++;
   }
   // nothing to do (only derefine if all MeshBlocks within a leaf are flagged)
   if (tnref == 0 && tnderef < nleaf) {
@@ -344,68 +401,37 @@ void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
     cllderef = new LogicalLocation[tnderef/nleaf];
   }
 
-  // calculate running sum of number of MBs to be refined/de-refined
-  nref_rsum[0] = 0;
-  nderef_rsum[0] = 0;
-  for (int n=1; n<global_variable::nranks; n++) {
-    nref_rsum[n] = nref_rsum[n-1] + nref_eachrank[n-1];
-    nderef_rsum[n] = nderef_rsum[n-1] + nderef_eachrank[n-1];
-  }
-
-  // collect logical locations of MBs to be refined/derefined into arrays
+  // collect logical locations of MBs to be refined/derefined into arrays, in order of
+  // gid (the same order as with the lists of each rank concatenated in rank order)
   {
-    int iref = nref_rsum[global_variable::my_rank];
-    int ideref = nderef_rsum[global_variable::my_rank];
-    for (int i=0; i<(pmy_mesh->nmb_thisrank); ++i) {
-      int gid = pmy_mesh->pmb_pack->pmb->mb_gid.h_view(i);
-      if (refine_flag.h_view(i+mbs) ==  1) {
-        llref[iref++] = pmy_mesh->lloc_eachmb[gid];;
-      } else if (refine_flag.h_view(i+mbs) == -1 && tnderef >= nleaf) {
-        llderef[ideref++] = pmy_mesh->lloc_eachmb[gid];
+    int iref = 0, ideref = 0;
+    for (int m=0; m<(pmy_mesh->nmb_total); ++m) {
+      if (refine_flag.h_view(m) ==  1) {
+        llref[iref++] = pmy_mesh->lloc_eachmb[m];
+      } else if (refine_flag.h_view(m) == -1 && tnderef >= nleaf) {
+        llderef[ideref++] = pmy_mesh->lloc_eachmb[m];
       }
     }
   }
-#if MPI_PARALLEL_ENABLED
-  // Now pass Logical Locations of MBs updated between all ranks.
-  MPI_Datatype lloc_type;
-  MPI_Type_contiguous(4, MPI_INT32_T, &lloc_type);
-  MPI_Type_commit(&lloc_type);
-  if (tnref > 0) {
-    MPI_Allgatherv(MPI_IN_PLACE, nref_eachrank[global_variable::my_rank], lloc_type,
-                   llref, nref_eachrank, nref_rsum, lloc_type, MPI_COMM_WORLD);
-  }
-  if (tnderef >= nleaf) {
-    MPI_Allgatherv(MPI_IN_PLACE, nderef_eachrank[global_variable::my_rank], lloc_type,
-                   llderef, nderef_eachrank, nderef_rsum, lloc_type, MPI_COMM_WORLD);
-  }
-  MPI_Type_free(&lloc_type);
-#endif
 
-  // Each rank now has a complete list of the LLs of MBs refined/derefined on other ranks
   // calculate the list of the newly derefined blocks
   int ctnd = 0;
   if (tnderef >= nleaf) {
-    int lk = 0, lj = 0;
-    if (pmy_mesh->multi_d) lj = 1;
-    if (pmy_mesh->three_d) lk = 1;
     for (int n=0; n<tnderef; n++) {
       if ((llderef[n].lx1 & 1) == 0 &&
           (llderef[n].lx2 & 1) == 0 &&
           (llderef[n].lx3 & 1) == 0) {
-        int r = n, rr = 0;
-        for (std::int32_t k=0; k<=lk; k++) {
-          for (std::int32_t j=0; j<=lj; j++) {
-            for (std::int32_t i=0; i<=1; i++) {
-              if (r < tnderef) {
-                if ((llderef[n].lx1+i) == llderef[r].lx1 &&
-                    (llderef[n].lx2+j) == llderef[r].lx2 &&
-                    (llderef[n].lx3+k) == llderef[r].lx3 &&
-                     llderef[n].level  == llderef[r].level) {
-                  rr++;
-                }
-                r++;
-              }
-            }
+        // leaves of a node are contiguous in the list, but their order depends on the
+        // SFC ordering, so count siblings within nleaf entries on either side of n
+        int rs = std::max(0, n-nleaf+1);
+        int re = std::min(tnderef-1, n+nleaf-1);
+        int rr = 0;
+        for (int r=rs; r<=re; r++) {
+          if ((llderef[n].lx1 >> 1) == (llderef[r].lx1 >> 1) &&
+              (llderef[n].lx2 >> 1) == (llderef[r].lx2 >> 1) &&
+              (llderef[n].lx3 >> 1) == (llderef[r].lx3 >> 1) &&
+               llderef[n].level     ==  llderef[r].level) {
+            rr++;
           }
         }
         if (rr == nleaf) {
@@ -465,18 +491,47 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   Mesh* pm = pmy_mesh;
   int old_nmb = pm->nmb_total;
   int new_nmb = old_nmb + nnew - ndel;
+  pm->mesh_version++;
+  // event counters in each MB are not moved with the MBs, so are reset
+  Kokkos::deep_copy(pm->ecounter.mb, 0);
   // compute nleaf = number of leaf MeshBlocks per refined block
   int nleaf = 2;
   if (pm->two_d) nleaf = 4;
   if (pm->three_d) nleaf = 8;
 
-  // Step 1. Create Z-ordered list of logical locations for new MBs, and newtoold list
+  // When only boundary cells are restricted in the task list, restrict all cells of the
+  // MBs before data from the coarse arrays is used to derefine them.
+  if (restrict_bndry_only && ndel > 0) {
+    restrict_bndry_only = false;
+    if (pm->pmb_pack->phydro != nullptr) {
+      RestrictCC(pm->pmb_pack->phydro->u0, pm->pmb_pack->phydro->coarse_u0);
+    }
+    if (pm->pmb_pack->pmhd != nullptr) {
+      RestrictCC(pm->pmb_pack->pmhd->u0, pm->pmb_pack->pmhd->coarse_u0);
+      RestrictFC(pm->pmb_pack->pmhd->b0, pm->pmb_pack->pmhd->coarse_b0);
+    }
+    if (pm->pmb_pack->pz4c != nullptr) {
+      RestrictCC(pm->pmb_pack->pz4c->u0, pm->pmb_pack->pz4c->coarse_u0, true);
+    }
+    restrict_bndry_only = true;
+  }
+  // Extra CC arrays (e.g. of time-averaged outputs) are not restricted in the task list,
+  // so all their cells are restricted here.
+  auto &extra_cc = pm->pmb_pack->extra_cc;
+  if (ndel > 0 && !(extra_cc.empty())) {
+    bool bndry_only = restrict_bndry_only;
+    restrict_bndry_only = false;
+    for (auto &e : extra_cc) {RestrictCC(*(e.u), *(e.coarse_u));}
+    restrict_bndry_only = bndry_only;
+  }
+
+  // Step 1. Create SFC-ordered list of logical locations for new MBs, and newtoold list
   // mapping (new MB gid [n])-->(old gid) for all MBs. Index of array [n] is new gid,
   // value is old gid.
   new_lloc_eachmb = new LogicalLocation[new_nmb];
   newtoold = new int[new_nmb];
   int new_nmb_total;
-  pm->ptree->CreateZOrderedLLList(new_lloc_eachmb, newtoold, new_nmb_total);
+  pm->ptree->CreateSFCOrderedLLList(new_lloc_eachmb, newtoold, new_nmb_total);
   if (new_nmb_total != new_nmb) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
         << "Number of MeshBlocks in new tree = " << new_nmb_total << " but expected "
@@ -507,16 +562,42 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
 
   // Step 3.
   // Calculate new load balance. Initialize new cost array with the simplest estimate
-  // possible: all the blocks are equal
-  // TODO(@user): implement variable cost per MeshBlock as needed
+  // possible: all the blocks are equal.  With automatic load balancing use measured
+  // costs instead: refined MBs inherit the cost of their parent, and derefined MBs the
+  // average cost of their children.
   new_cost_eachmb = new float[new_nmb];
   new_rank_eachmb = new int[new_nmb];
   new_gids_eachrank = new int[global_variable::nranks];
   new_nmb_eachrank = new int[global_variable::nranks];
 
-  for (int i=0; i<new_nmb; i++) {new_cost_eachmb[i] = 1.0;}
-  pm->LoadBalance(new_cost_eachmb, new_rank_eachmb, new_gids_eachrank, new_nmb_eachrank,
-                  new_nmb_total);
+  if (pm->lb_automatic) {
+    pm->GatherMeasuredCosts();
+    for (int newm=0; newm<new_nmb; newm++) {
+      int oldm = newtoold[newm];
+      if (pm->lloc_eachmb[oldm].level > new_lloc_eachmb[newm].level) {  // derefined
+        float cost = 0.0;
+        for (int l=0; l<nleaf; l++) {cost += pm->cost_eachmb[oldm+l];}
+        new_cost_eachmb[newm] = cost/static_cast<float>(nleaf);
+      } else {
+        new_cost_eachmb[newm] = pm->cost_eachmb[oldm];
+      }
+    }
+  } else {
+    for (int i=0; i<new_nmb; i++) {new_cost_eachmb[i] = 1.0;}
+  }
+  if (pm->lb_incremental) {
+    // each new MB inherits rank of old MB it was created from
+    int *old_rank_eachmb = new int[new_nmb];
+    for (int newm=0; newm<new_nmb; newm++) {
+      old_rank_eachmb[newm] = pm->rank_eachmb[newtoold[newm]];
+    }
+    pm->IncrementalLoadBalance(new_cost_eachmb, old_rank_eachmb, new_rank_eachmb,
+                               new_gids_eachrank, new_nmb_eachrank, new_nmb_total);
+    delete [] old_rank_eachmb;
+  } else {
+    pm->LoadBalance(new_cost_eachmb, new_rank_eachmb, new_gids_eachrank,
+                    new_nmb_eachrank, new_nmb_total);
+  }
   if (new_nmb_eachrank[global_variable::my_rank] > pm->nmb_maxperrank) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
         << "Number of MeshBlocks in this rank on new tree = "
@@ -574,6 +655,7 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
     if (pz4c != nullptr) {
       DerefineCCSameRank(pz4c->u0, pz4c->coarse_u0);
     }
+    for (auto &e : extra_cc) {DerefineCCSameRank(*(e.u), *(e.coarse_u));}
   }
 
   // Step 6.
@@ -591,6 +673,7 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   } else if (padm != nullptr) {
     CopyCC(padm->u_adm);
   }
+  for (auto &e : extra_cc) {CopyCC(*(e.u));}
   // Step 7.
   // Copy evolved physics variables for MBs flagged for refinement from source fine array
   // to target coarse array, when both are on same rank.
@@ -605,6 +688,7 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
     if (pz4c != nullptr) {
       CopyForRefinementCC(pz4c->u0, pz4c->coarse_u0);
     }
+    for (auto &e : extra_cc) {CopyForRefinementCC(*(e.u), *(e.coarse_u));}
   }
 
   // Step 8.
@@ -637,8 +721,12 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
     if (pz4c != nullptr) {
       RefineCC(new_to_old, pz4c->u0, pz4c->coarse_u0, true);
     }
+    for (auto &e : extra_cc) {RefineCC(new_to_old, *(e.u), *(e.coarse_u));}
   }
 
+  // Move particles with their MBs, while old MBs still exist
+  if (pm->pmb_pack->ppart != nullptr) {RedistParticles(nleaf);}
+
   // Update new number of cycles since refinement
   HostArray1D<int> new_ncyc_since_ref("nnref",new_nmb_total);
   for (int m=0; m<(new_nmb_total); ++m) {
@@ -652,6 +740,19 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   Kokkos::realloc(ncyc_since_ref, new_nmb_total);
   Kokkos::deep_copy(ncyc_since_ref, new_ncyc_since_ref);
 
+  // Update number of successive checks MBs have been flagged for derefinement
+  HostArray1D<int> new_nderef_checks("nnderef",new_nmb_total);
+  for (int m=0; m<(new_nmb_total); ++m) {
+    int oldm = newtoold[m];
+    if (refine_flag.h_view(oldm) != 0) {
+      new_nderef_checks(m) = 0;
+    } else {
+      new_nderef_checks(m) = nderef_checks(oldm);
+    }
+  }
+  Kokkos::realloc(nderef_checks, new_nmb_total);
+  Kokkos::deep_copy(nderef_checks, new_nderef_checks);
+
   // Step 10.
   // Update data in Mesh/MeshBlockPack/MeshBlock classes with new grid properties
   delete [] pm->lloc_eachmb;
@@ -671,11 +772,14 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   pm->pmb_pack->gide = pm->pmb_pack->gids + pm->nmb_eachrank[global_variable::my_rank]-1;
   pm->pmb_pack->nmb_thispack = pm->pmb_pack->gide - pm->pmb_pack->gids + 1;
 
-  delete (pm->pmb_pack->pmb);
+  // old MeshBlocks are kept until new neighbors are set, so that data cached from the
+  // neighbors is only rebuilt when they have changed
+  MeshBlock *pold_mb = pm->pmb_pack->pmb;
   delete (pm->pmb_pack->pcoord);
   pm->pmb_pack->AddMeshBlocks(pin);
   pm->pmb_pack->AddCoordinates(pin);
-  pm->pmb_pack->pmb->SetNeighbors(pm->ptree, pm->rank_eachmb);
+  pm->pmb_pack->pmb->SetNeighbors(pm->ptree, pm->rank_eachmb, pold_mb);
+  delete pold_mb;
 
   // clean-up and return
   delete [] newtoold;
@@ -690,6 +794,46 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::RedistParticles
+//! \brief Sets new GID and rank of the MB containing the particles in each octant of the
+//! old MBs on this rank (the children of refined MBs differ between octants), and moves
+//! particles to their new MBs.  Called by RedistAndRefineMeshBlocks() before the old MBs
+//! are deleted.
+
+void MeshRefinement::RedistParticles(int nleaf) {
+  Mesh* pm = pmy_mesh;
+  int nmb = pm->pmb_pack->nmb_thispack;
+  int gids = pm->pmb_pack->gids;
+  DualArray2D<int> new_gid("new_gid", nmb, 8);
+  DualArray2D<int> new_rank("new_rank", nmb, 8);
+  for (int m=0; m<nmb; ++m) {
+    int oldm = gids + m;
+    int newm = oldtonew[oldm];
+    for (int o=0; o<8; ++o) {
+      new_gid.h_view(m,o) = newm;
+      new_rank.h_view(m,o) = new_rank_eachmb[newm];
+    }
+    // children of refined MB are contiguous and start at oldtonew[oldm], but their order
+    // depends on the SFC, so octant is set from logical location of each child
+    if (refine_flag.h_view(oldm) > 0) {
+      for (int l=0; l<nleaf; ++l) {
+        LogicalLocation &lloc = new_lloc_eachmb[newm+l];
+        int o = (lloc.lx1 & 1) + ((pm->multi_d)? 2*(lloc.lx2 & 1) : 0) +
+                ((pm->three_d)? 4*(lloc.lx3 & 1) : 0);
+        new_gid.h_view(m,o) = newm + l;
+        new_rank.h_view(m,o) = new_rank_eachmb[newm + l];
+      }
+    }
+  }
+  new_gid.template modify<HostMemSpace>();
+  new_gid.template sync<DevExeSpace>();
+  new_rank.template modify<HostMemSpace>();
+  new_rank.template sync<DevExeSpace>();
+  pm->pmb_pack->ppart->pbval_part->RedistributeParticles(new_gid, new_rank);
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::DerefineCCSameRank
 //! \brief For any MeshBlock m flagged for derefinment (refine_flag = -nleaf), copies
@@ -1202,10 +1346,23 @@ void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
   auto& restrict_2nd = weights.restrict_2nd;
   auto& restrict_4th = weights.restrict_4th;
   auto& restrict_4th_edge = weights.restrict_4th_edge;
+  // with restrict_bndry_only, skip cells not near coarser neighbors.  For z4c, the
+  // higher-order prolongation uses coarse data from all neighbors (including the coarse
+  // data appended to messages between MBs at the same level, which are only used by MBs
+  // that also touch the coarser neighbor), so all cells are restricted, but only in MBs
+  // with a coarser neighbor.
+  bool bndry_only = restrict_bndry_only && !is_z4c;
+  bool mb_only = restrict_bndry_only && is_z4c;
+  if (restrict_bndry_only) {SetCoarseNeighborMask();}
+  auto &cmask = coarse_nghbr_mask;
+  int w = indcs.ng + 1;
   // restrict in 1D
   if (pmy_mesh->one_d) {
     par_for("restrictCC-1D",DevExeSpace(), 0,nmb-1, 0,nvar-1, cis,cie,
     KOKKOS_LAMBDA(const int m, const int n, const int i) {
+      if (mb_only && cmask.d_view(m) == 0) return;
+      if (bndry_only &&
+          !CoarseCellNeeded(cmask.d_view(m),cks,cjs,i,cis,cie,cjs,cje,cks,cke,w)) return;
       int finei = 2*i - cis;  // correct when cis=is
       cu(m,n,cks,cjs,i) = 0.5*(u(m,n,cks,cjs,finei) + u(m,n,cks,cjs,finei+1));
     });
@@ -1213,6 +1370,9 @@ void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
   } else if (pmy_mesh->two_d) {
     par_for("restrictCC-2D",DevExeSpace(), 0,nmb-1, 0,nvar-1, cjs,cje, cis,cie,
     KOKKOS_LAMBDA(const int m, const int n, const int j, const int i) {
+      if (mb_only && cmask.d_view(m) == 0) return;
+      if (bndry_only &&
+          !CoarseCellNeeded(cmask.d_view(m),cks,j,i,cis,cie,cjs,cje,cks,cke,w)) return;
       int finei = 2*i - cis;  // correct when cis=is
       int finej = 2*j - cjs;  // correct when cjs=js
       cu(m,n,cks,j,i) = 0.25*(u(m,n,cks,finej  ,finei) + u(m,n,cks,finej  ,finei+1)
@@ -1223,6 +1383,9 @@ void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
   } else {
     par_for("restrictCC-3D",DevExeSpace(), 0,nmb-1, 0,nvar-1, cks,cke, cjs,cje, cis,cie,
     KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
+      if (mb_only && cmask.d_view(m) == 0) return;
+      if (bndry_only &&
+          !CoarseCellNeeded(cmask.d_view(m),k,j,i,cis,cie,cjs,cje,cks,cke,w)) return;
       int finei = 2*i - cis;  // correct when cis=is
       int finej = 2*j - cjs;  // correct when cjs=js
       int finek = 2*k - cks;  // correct when cks=ks
@@ -1260,11 +1423,18 @@ void MeshRefinement::RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb)
   auto &cje = pmy_mesh->mb_indcs.cje;
   auto &cks = pmy_mesh->mb_indcs.cks;
   auto &cke = pmy_mesh->mb_indcs.cke;
+  // with restrict_bndry_only, skip faces not near coarser neighbors
+  bool bndry_only = restrict_bndry_only;
+  if (bndry_only) {SetCoarseNeighborMask();}
+  auto &cmask = coarse_nghbr_mask;
+  int w = pmy_mesh->mb_indcs.ng + 1;
 
   // restrict in 1D
   if (pmy_mesh->one_d) {
     par_for("restrictFC-1D",DevExeSpace(), 0,nmb-1, cis,cie,
     KOKKOS_LAMBDA(const int m, const int i) {
+      if (bndry_only &&
+          !CoarseCellNeeded(cmask.d_view(m),cks,cjs,i,cis,cie,cjs,cje,cks,cke,w)) return;
       int finei = 2*i - cis;  // correct when cis=is
       // restrict B1
       cb.x1f(m,cks,cjs,i) = b.x1f(m,cks,cjs,finei);
@@ -1285,6 +1455,8 @@ void MeshRefinement::RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb)
   } else if (pmy_mesh->two_d) {
     par_for("restrictFC-2D",DevExeSpace(), 0,nmb-1, cjs,cje, cis,cie,
     KOKKOS_LAMBDA(const int m, const int j, const int i) {
+      if (bndry_only &&
+          !CoarseCellNeeded(cmask.d_view(m),cks,j,i,cis,cie,cjs,cje,cks,cke,w)) return;
       int finei = 2*i - cis;  // correct when cis=is
       int finej = 2*j - cjs;  // correct when cjs=js
       // restrict B1
@@ -1310,6 +1482,8 @@ void MeshRefinement::RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb)
   } else {
     par_for("restrictFC-3D",DevExeSpace(), 0,nmb-1, cks,cke, cjs,cje, cis,cie,
     KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      if (bndry_only &&
+          !CoarseCellNeeded(cmask.d_view(m),k,j,i,cis,cie,cjs,cje,cks,cke,w)) return;
       int finei = 2*i - cis;  // correct when cis=is
       int finej = 2*j - cjs;  // correct when cjs=js
       int finek = 2*k - cks;  // correct when cks=ks
@@ -1345,6 +1519,209 @@ void MeshRefinement::RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb)
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void RestrictionBatch::AddCC
+//! \brief Adds a cell-centered array and its coarse array to a batch of restrictions
+
+void RestrictionBatch::AddCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca, bool z4c) {
+  if (ncc == nmax_cc) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Number of cell-centered arrays in RestrictionBatch exceeds maximum "
+              << nmax_cc << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  cc[ncc] = a;
+  coarse_cc[ncc] = ca;
+  is_z4c[ncc] = z4c;
+  nvar[ncc+1] = nvar[ncc] + a.extent_int(1);
+  ncc++;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestrictionBatch::AddFC
+//! \brief Adds a face-centered field and its coarse field to a batch of restrictions
+
+void RestrictionBatch::AddFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb) {
+  if (has_fc) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Only one face-centered field can be added to RestrictionBatch"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  bx1f = b.x1f;  bx2f = b.x2f;  bx3f = b.x3f;
+  cbx1f = cb.x1f;  cbx2f = cb.x2f;  cbx3f = cb.x3f;
+  has_fc = true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::RestrictBatch
+//! \brief Restricts all arrays in a RestrictionBatch to the coarse mesh with one kernel.
+//! Results are identical to calling RestrictCC() for each CC array and RestrictFC() for
+//! the FC field, but the index ranges of the restriction are computed once and only one
+//! kernel is launched, which reduces launch overheads when several arrays are restricted.
+//! The averages are written for 1D/2D/3D at once by looping over the fine cells in only
+//! the dimensions that are used.
+
+void MeshRefinement::RestrictBatch(const RestrictionBatch &rb) {
+  if (rb.ncc == 0 && !rb.has_fc) {return;}
+  int nmb = (rb.ncc > 0)? rb.cc[0].extent_int(0) : rb.bx1f.extent_int(0);
+  int nvcc = rb.nvar[rb.ncc];
+  int ntot = nvcc + ((rb.has_fc)? 3 : 0);
+
+  auto &indcs = pmy_mesh->mb_indcs;
+  int cis = indcs.cis, cie = indcs.cie;
+  int cjs = indcs.cjs, cje = indcs.cje;
+  int cks = indcs.cks, cke = indcs.cke;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int ng = indcs.ng;
+  bool multi_d = pmy_mesh->multi_d;
+  bool three_d = pmy_mesh->three_d;
+  auto& restrict_2nd = weights.restrict_2nd;
+  auto& restrict_4th = weights.restrict_4th;
+  auto& restrict_4th_edge = weights.restrict_4th_edge;
+
+  // number of fine cells/faces in each dimension that are averaged
+  int dj = (multi_d)? 1 : 0;
+  int dk = (three_d)? 1 : 0;
+  Real wcc = 1.0/static_cast<Real>(2*(1+dj)*(1+dk));
+  Real wx1 = 1.0/static_cast<Real>((1+dj)*(1+dk));
+  Real wx2 = 1.0/static_cast<Real>(2*(1+dk));
+  Real wx3 = 1.0/static_cast<Real>(2*(1+dj));
+  // with restrict_bndry_only, skip cells not near coarser neighbors (for z4c, skip MBs
+  // without a coarser neighbor, as in RestrictCC)
+  bool bndry_only = restrict_bndry_only;
+  if (bndry_only) {SetCoarseNeighborMask();}
+  auto &cmask = coarse_nghbr_mask;
+  int w = ng + 1;
+
+  par_for("restrict-batch",DevExeSpace(), 0,nmb-1, 0,ntot-1, cks,cke, cjs,cje, cis,cie,
+  KOKKOS_LAMBDA(const int m, const int nv, const int k, const int j, const int i) {
+    int fi = 2*i - cis;                     // correct when cis=is
+    int fj = (multi_d)? (2*j - cjs) : j;    // correct when cjs=js
+    int fk = (three_d)? (2*k - cks) : k;    // correct when cks=ks
+    bool skip = bndry_only &&
+                !CoarseCellNeeded(cmask.d_view(m),k,j,i,cis,cie,cjs,cje,cks,cke,w);
+    if (nv < nvcc) {
+      // cell-centered variables: find array that contains variable nv
+      int a = 0;
+      while (nv >= rb.nvar[a+1]) {a++;}
+      if (skip && (!rb.is_z4c[a] || cmask.d_view(m) == 0)) return;
+      int n = nv - rb.nvar[a];
+      const auto &u = rb.cc[a];
+      const auto &cu = rb.coarse_cc[a];
+      if (rb.is_z4c[a] && three_d) {
+        switch (ng) {
+          case 2: cu(m,n,k,j,i) = RestrictInterpolation<2>(m,n,fk,fj,fi,
+                          nx1,nx2,nx3,u,restrict_2nd,restrict_4th,restrict_4th_edge);
+                  break;
+          case 4: cu(m,n,k,j,i) = RestrictInterpolation<4>(m,n,fk,fj,fi,
+                          nx1,nx2,nx3,u,restrict_2nd,restrict_4th,restrict_4th_edge);
+                  break;
+        }
+      } else {
+        Real sum = 0.0;
+        for (int ck=0; ck<=dk; ++ck) {
+          for (int cj=0; cj<=dj; ++cj) {
+            sum += u(m,n,fk+ck,fj+cj,fi) + u(m,n,fk+ck,fj+cj,fi+1);
+          }
+        }
+        cu(m,n,k,j,i) = wcc*sum;
+      }
+    } else if (skip) {
+      return;
+    } else if (nv == nvcc) {
+      // restrict B1
+      Real sum = 0.0;
+      for (int ck=0; ck<=dk; ++ck) {
+        for (int cj=0; cj<=dj; ++cj) {sum += rb.bx1f(m,fk+ck,fj+cj,fi);}
+      }
+      rb.cbx1f(m,k,j,i) = wx1*sum;
+      if (i==cie) {
+        sum = 0.0;
+        for (int ck=0; ck<=dk; ++ck) {
+          for (int cj=0; cj<=dj; ++cj) {sum += rb.bx1f(m,fk+ck,fj+cj,fi+2);}
+        }
+        rb.cbx1f(m,k,j,i+1) = wx1*sum;
+      }
+    } else if (nv == nvcc+1) {
+      // restrict B2.  In 1D both faces of the coarse cell are set to the same value
+      Real sum = 0.0;
+      for (int ck=0; ck<=dk; ++ck) {
+        sum += rb.bx2f(m,fk+ck,fj,fi) + rb.bx2f(m,fk+ck,fj,fi+1);
+      }
+      rb.cbx2f(m,k,j,i) = wx2*sum;
+      if (!multi_d) {
+        rb.cbx2f(m,k,j+1,i) = wx2*sum;
+      } else if (j==cje) {
+        sum = 0.0;
+        for (int ck=0; ck<=dk; ++ck) {
+          sum += rb.bx2f(m,fk+ck,fj+2,fi) + rb.bx2f(m,fk+ck,fj+2,fi+1);
+        }
+        rb.cbx2f(m,k,j+1,i) = wx2*sum;
+      }
+    } else {
+      // restrict B3.  In 1D/2D both faces of the coarse cell are set to the same value
+      Real sum = 0.0;
+      for (int cj=0; cj<=dj; ++cj) {
+        sum += rb.bx3f(m,fk,fj+cj,fi) + rb.bx3f(m,fk,fj+cj,fi+1);
+      }
+      rb.cbx3f(m,k,j,i) = wx3*sum;
+      if (!three_d) {
+        rb.cbx3f(m,k+1,j,i) = wx3*sum;
+      } else if (k==cke) {
+        sum = 0.0;
+        for (int cj=0; cj<=dj; ++cj) {
+          sum += rb.bx3f(m,fk+2,fj+cj,fi) + rb.bx3f(m,fk+2,fj+cj,fi+1);
+        }
+        rb.cbx3f(m,k+1,j,i) = wx3*sum;
+      }
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::SetCoarseNeighborMask()
+//! \brief Sets bit mask of directions in which each MB has a neighbor at a coarser level,
+//! used to restrict only coarse cells near these boundaries with restrict_bndry_only.
+//! The mask is only rebuilt when the neighbors of MBs have changed.
+
+void MeshRefinement::SetCoarseNeighborMask() {
+  MeshBlock *pmb = pmy_mesh->pmb_pack->pmb;
+  int nmb = pmy_mesh->pmb_pack->nmb_thispack;
+  if ((cmask_version_ == pmy_mesh->nghbr_version) &&
+      (coarse_nghbr_mask.extent_int(0) == nmb)) {return;}
+
+  Kokkos::realloc(coarse_nghbr_mask, nmb);
+  int nj = (pmy_mesh->multi_d)? 1 : 0;
+  int nk = (pmy_mesh->three_d)? 1 : 0;
+  for (int m=0; m<nmb; ++m) {
+    int mask = 0;
+    for (int ox3=-nk; ox3<=nk; ++ox3) {
+      for (int ox2=-nj; ox2<=nj; ++ox2) {
+        for (int ox1=-1; ox1<=1; ++ox1) {
+          if (ox1 == 0 && ox2 == 0 && ox3 == 0) continue;
+          // coarser neighbor may be stored in buffer of any subblock on faces/edges
+          for (int f2=0; f2<=1; ++f2) {
+            for (int f1=0; f1<=1; ++f1) {
+              int n = NeighborIndex(ox1,ox2,ox3,f1,f2);
+              if ((n >= 0) && (n < pmb->nnghbr) && (pmb->nghbr.h_view(m,n).gid >= 0) &&
+                  (pmb->nghbr.h_view(m,n).lev < pmb->mb_lev.h_view(m))) {
+                mask |= (1 << ((ox1+1) + 3*(ox2+1) + 9*(ox3+1)));
+              }
+            }
+          }
+        }
+      }
+    }
+    coarse_nghbr_mask.h_view(m) = mask;
+  }
+  coarse_nghbr_mask.template modify<HostMemSpace>();
+  coarse_nghbr_mask.template sync<DevExeSpace>();
+  cmask_version_ = pmy_mesh->nghbr_version;
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::InitInterpWghts()
 //! \brief interpolation weights for prolongation and restriction
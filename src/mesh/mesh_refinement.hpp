@@ -30,10 +30,45 @@ struct AMRBuffer {
   int cnt;                   // total number of elements stored in buffer incl all vars
   int offset=0;              // starting index of data for this buffer
   int lid;                   // local ID (gid - gids) of MeshBlock on this rank
+  int rank, tag;             // rank and MPI tag of messages to/from this buffer
   bool use_coarse=false;     // pack/unpack from coarse array when true
 };
+
+//----------------------------------------------------------------------------------------
+//! \struct AMRChunk
+//! \brief range of variables in each AMRBuffer that is communicated as one message.
+//! Without pipelining there is a single chunk containing all variables, otherwise there
+//! is one chunk per array (hydro, MHD cell-centered, MHD face-centered, z4c), and one
+//! for all extra CC arrays (see ExtraArrayCC).
+
+struct AMRChunk {
+  int ncc, nfc;              // number of CC and FC variables in buffer before this chunk
+  int nvcc, nvfc;            // number of CC and FC variables in this chunk
+  int Start(const AMRBuffer &b) const {return b.offset + ncc*b.cntcc + nfc*b.cntfc;}
+  int Count(const AMRBuffer &b) const {return nvcc*b.cntcc + nvfc*b.cntfc;}
+};
 #endif
 
+//----------------------------------------------------------------------------------------
+//! \struct RestrictionBatch
+//! \brief list of cell-centered arrays (and at most one face-centered field) with their
+//! coarse arrays, which are all restricted with a single kernel launch by
+//! MeshRefinement::RestrictBatch().  The variables of all CC arrays are flattened into
+//! one index, with nvar[a] the index of the first variable of array a.  The three
+//! components of the FC field (if any) follow the CC variables.
+
+struct RestrictionBatch {
+  static constexpr int nmax_cc = 4;   // maximum number of CC arrays in a batch
+  int ncc = 0;
+  int nvar[nmax_cc+1] = {0};
+  bool is_z4c[nmax_cc] = {false};
+  DvceArray5D<Real> cc[nmax_cc], coarse_cc[nmax_cc];
+  bool has_fc = false;
+  DvceArray4D<Real> bx1f, bx2f, bx3f, cbx1f, cbx2f, cbx3f;
+  void AddCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca, bool z4c=false);
+  void AddFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
+};
+
 //----------------------------------------------------------------------------------------
 //! \class MeshRefinement
 //! \brief data/functions associated with SMR/AMR
@@ -47,19 +82,24 @@ class MeshRefinement {
   int nmb_created;           // # of MeshBlocks created via AMR across all ranks
   int nmb_deleted;           // # of MeshBlocks deleted via AMR across all ranks
   int nmb_sent_thisrank;     // # of MeshBlocks sent during load balancing on this rank
+  double nbytes_sent_thisrank;  // # of bytes of MeshBlock data sent in load balancing
   int ncyc_check_amr;        // # of cycles between checking mesh for ref/derefinement
   int refinement_interval;   // # of cycles between allowing successive ref/derefinement
   bool prolong_prims;        // flag to enable prolongation of primitive vars
+  bool pipelined_migration;  // flag to send each array in separate message with AMR
+  int derefine_count;        // # of successive checks MB must be flagged to derefine
+  bool refine_buffer;        // flag to prevent derefinement of MBs next to refined MBs
+  Real lookahead_cycles;     // # of cycles over which to predict motion of features
+  bool restrict_bndry_only;  // flag to restrict only coarse cells near coarser nghbrs
 
-  // following 2x Views are dimensioned [nmb_total]
+  // following 3x Views are dimensioned [nmb_total]
   DualArray1D<int> refine_flag;    // refinement flag for each MeshBlock
   HostArray1D<int> ncyc_since_ref; // # of cycles since MB last refined/derefined
+  HostArray1D<int> nderef_checks;  // # of successive checks MB flagged to derefine
+
+  // bit (ox1+1) + 3*(ox2+1) + 9*(ox3+1) set when MB has coarser nghbr in that direction
+  DualArray1D<int> coarse_nghbr_mask;  // dimensioned [nmb_thispack]
 
-  // following 4x arrays allocated with length [nranks] only with AMR
-  int *nref_eachrank;     // number of MBs refined per rank
-  int *nderef_eachrank;   // number of MBs de-refined per rank
-  int *nref_rsum;         // running sum of number of MBs refined per rank
-  int *nderef_rsum;       // running sum of number of MBs de-refined per rank
   // following 2x arrays allocated with length [nmb_new] and [nmb_old]] only with AMR
   int *newtoold;          // mapping of new gid (index n) to old gid
   int *oldtonew;          // mapping of old gid (index n) to new gid
@@ -88,15 +128,25 @@ class MeshRefinement {
   int nmb_send, nmb_recv;
   MPI_Comm amr_comm;                         // unique communicator for AMR
   DualArray1D<AMRBuffer> sendbuf, recvbuf; // send/recv buffers
-  MPI_Request *send_req, *recv_req;
+  MPI_Request *send_req, *recv_req;          // dimensioned [namr_chunks*nmb_send/recv]
   DvceArray1D<Real> send_data, recv_data;    // send/recv device data
+  int namr_chunks;                           // number of messages sent per MeshBlock
+  AMRChunk amr_chunks[5];
 #endif
 
   // functions
   void CheckForRefinement(MeshBlockPack* pmbp);
+  void ApplyRefinementBuffer();
+  // evaluate refinement criteria on device (template defined in refinement_criteria.hpp)
+  template <typename CellVote, typename BlockAdjust>
+  void FlagRefinement(MeshBlockPack *pmbp, const bool use_cells, const CellVote &vote,
+                      const BlockAdjust &adjust);
   void AdaptiveMeshRefinement(Driver *pdrive, ParameterInput *pin);
+  void RebalanceMeshBlocks(Driver *pdrive, ParameterInput *pin);
+  void InitNewMeshBlocks(Driver *pdrive);
   void UpdateMeshBlockTree(int &nnew, int &ndel);
   void RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, int ndel);
+  void RedistParticles(int nleaf);
 
   void DerefineCCSameRank(DvceArray5D<Real> &a, DvceArray5D<Real> &ca);
   void DerefineFCSameRank(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
@@ -114,6 +164,8 @@ class MeshRefinement {
   void RestrictCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca, bool is_z4c=false);
   void RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
   void HighOrderRestrictCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca);
+  void RestrictBatch(const RestrictionBatch &rb);
+  void SetCoarseNeighborMask();
 
   // functions for load balancing (in file load_balance.cpp)
   void InitRecvAMR(int nleaf);
@@ -124,6 +176,9 @@ class MeshRefinement {
   void UnpackAMRBuffersCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca, int ncc,int nfc);
   void UnpackAMRBuffersFC(DvceFaceFld4D<Real> &b,DvceFaceFld4D<Real> &cb,int ncc,int nfc);
   void ClearSendAMR();
+  void SetAMRChunks();
+  void PostSendAMR(int ncc, int nfc, int &nchunk);
+  void WaitRecvAMR(int ncc, int nfc, int &nchunk);
 
   // initialize interpolation weights
   void InitInterpWghts();
@@ -133,5 +188,6 @@ class MeshRefinement {
   Mesh *pmy_mesh;
   Real d_threshold_, dd_threshold_, dp_threshold_, dv_threshold_, chi_threshold_;
   bool check_cons_;
+  int cmask_version_;        // Mesh::nghbr_version when coarse_nghbr_mask was set
 };
 #endif // MESH_MESH_REFINEMENT_HPP_
@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -27,7 +28,8 @@ MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
   mb_gid("mb_gid",nmb),
   mb_lev("mb_lev",nmb),
   mb_size("mbsize",nmb),
-  mb_bcs("mbbcs",nmb,6) {
+  mb_bcs("mbbcs",nmb,6),
+  physbc_face("physbcface",6*nmb) {
   Mesh* pm = pmy_pack->pmesh;
   auto &ms = pm->mesh_size;
 
@@ -118,16 +120,36 @@ MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
                             static_cast<Real>(pm->mb_indcs.nx3);
   }
 
+  // list faces with physical BCs, ordered by direction.  Periodic, shearing-box and
+  // user BCs are not applied by the boundary condition kernels, so are not included.
+  int nface = 0;
+  for (int d=0; d<3; ++d) {
+    physbc_start[d] = nface;
+    for (int m=0; m<nmb; ++m) {
+      for (int face=2*d; face<2*d+2; ++face) {
+        BoundaryFlag bc = mb_bcs.h_view(m,face);
+        if (bc == BoundaryFlag::reflect || bc == BoundaryFlag::inflow ||
+            bc == BoundaryFlag::outflow || bc == BoundaryFlag::diode ||
+            bc == BoundaryFlag::vacuum) {
+          physbc_face.h_view(nface++) = 6*m + face;
+        }
+      }
+    }
+  }
+  physbc_start[3] = nface;
+
   // For each DualArray: mark host views as modified, and then sync to device array
   mb_gid.template modify<HostMemSpace>();
   mb_lev.template modify<HostMemSpace>();
   mb_size.template modify<HostMemSpace>();
   mb_bcs.template modify<HostMemSpace>();
+  physbc_face.template modify<HostMemSpace>();
 
   mb_gid.template sync<DevExeSpace>();
   mb_lev.template sync<DevExeSpace>();
   mb_size.template sync<DevExeSpace>();
   mb_bcs.template sync<DevExeSpace>();
+  physbc_face.template sync<DevExeSpace>();
 }
 
 //----------------------------------------------------------------------------------------
@@ -138,8 +160,11 @@ MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
 // Information about Neighbors are stored in a 2D Dual view of NeighborBlock structs
 // Indices of the view are (m,n) = (no. of MBs, no. of neighbors)
 // Based on SearchAndSetNeighbors() function in /src/bvals/bvals_base.cpp in C++ version
+// If the MeshBlocks replaced by this one after AMR are passed in (pold), data cached from
+// the neighbors (e.g. aggregated messages) is only rebuilt if the neighbors changed.
 
-void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklist) {
+void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklist,
+                             MeshBlock *pold) {
   // min number of array elements needed to store MeshBlock neighbors withe SMR/AMR
   // Note not all buffers will be allocated for all nghbrs
   if (pmy_pack->pmesh->one_d) {nnghbr = 8;}
@@ -168,7 +193,11 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
     if (pmy_pack->pmesh->three_d) nfz = 2;
   }
 
-  // Search MeshBlock tree and find neighbors
+  // Search MeshBlock tree and find neighbors.  Each MeshBlock only writes its own row of
+  // nghbr and the tree is only read, so MeshBlocks can be searched by many threads.
+#if OPENMP_PARALLEL_ENABLED
+#pragma omp parallel for schedule(static)
+#endif
   for (int b=0; b<nmb; ++b) {
     LogicalLocation lloc = pmy_pack->pmesh->lloc_eachmb[mb_gid.h_view(b)];
 
@@ -426,5 +455,54 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
   nghbr.template modify<HostMemSpace>();
   nghbr.template sync<DevExeSpace>();
 
+  // split MBs into those with and without neighbors on other ranks
+  Kokkos::realloc(offrank_mbs, nmb);
+  Kokkos::realloc(onrank_mbs, nmb);
+  int my_rank = global_variable::my_rank;
+  nmb_offrank = 0;
+  nmb_onrank = 0;
+  for (int m=0; m<nmb; ++m) {
+    bool offrank = false;
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0 && nghbr.h_view(m,n).rank != my_rank) {
+        offrank = true;
+      }
+    }
+    if (offrank) {
+      offrank_mbs.h_view(nmb_offrank++) = m;
+    } else {
+      onrank_mbs.h_view(nmb_onrank++) = m;
+    }
+  }
+  offrank_mbs.template modify<HostMemSpace>();
+  offrank_mbs.template sync<DevExeSpace>();
+  onrank_mbs.template modify<HostMemSpace>();
+  onrank_mbs.template sync<DevExeSpace>();
+
+  // check if MeshBlocks on this rank and all their neighbors are unchanged, which is
+  // common after AMR when the MBs that were refined/derefined are all on other ranks
+  bool changed = true;
+  if (pold != nullptr && pold->nnghbr == nnghbr &&
+      pold->nghbr.extent_int(0) == nmb && pold->mb_gid.extent_int(0) == nmb) {
+    changed = false;
+    for (int m=0; m<nmb && !(changed); ++m) {
+      if (pold->mb_gid.h_view(m) != mb_gid.h_view(m) ||
+          pold->mb_lev.h_view(m) != mb_lev.h_view(m)) {
+        changed = true;
+      }
+      for (int n=0; n<nnghbr; ++n) {
+        const NeighborBlock &nb = nghbr.h_view(m,n), &onb = pold->nghbr.h_view(m,n);
+        if (nb.gid != onb.gid || nb.lev != onb.lev || nb.rank != onb.rank ||
+            nb.dest != onb.dest) {
+          changed = true;
+        }
+      }
+    }
+  }
+
+  // signal that any data cached from the previous neighbors must be rebuilt
+  if (changed) {
+    pmy_pack->pmesh->nghbr_version++;
+  }
   return;
 }
@@ -42,8 +42,21 @@ class MeshBlock {
   DualArray2D<BoundaryFlag> mb_bcs;  // boundary conditions at 6 faces of each MeshBlock
   DualArray2D<NeighborBlock> nghbr;  // data on all (up to 56) neighbors for each MB
 
+  // compacted list of faces with physical BCs (reflect, inflow, outflow, diode, vacuum),
+  // stored as 6*m + BoundaryFace.  Faces normal to x1 (x2,x3) are first, in entries
+  // [physbc_start[0],physbc_start[1]) (and so on), so that boundary condition kernels
+  // in each direction are launched only over faces that need them.
+  DualArray1D<int> physbc_face;
+  int physbc_start[4];
+
+  // indices of MBs with at least one neighbor on another rank, and of all other MBs, so
+  // that the former can be updated and sent first (see PackRegion)
+  DualArray1D<int> offrank_mbs, onrank_mbs;
+  int nmb_offrank, nmb_onrank;
+
   // function to set data describing neighbors
-  void SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklist);
+  void SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklist,
+                    MeshBlock *pold=nullptr);
 
  private:
   // data
@@ -28,8 +28,11 @@
 #include "diffusion/resistivity.hpp"
 #include "radiation/radiation.hpp"
 #include "srcterms/turb_driver.hpp"
+#include "gravity/gravity.hpp"
 #include "particles/particles.hpp"
 #include "units/units.hpp"
+#include "bvals/bvals.hpp"
+#include "utils/memory_tracker.hpp"
 #include "meshblock_pack.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -46,6 +49,9 @@ MeshBlockPack::MeshBlockPack(Mesh *pm, int igids, int igide) :
   tl_map.insert(std::make_pair("before_stagen",std::make_shared<TaskList>()));
   tl_map.insert(std::make_pair("stagen",std::make_shared<TaskList>()));
   tl_map.insert(std::make_pair("after_stagen",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("before_sts",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("sts",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("after_sts",std::make_shared<TaskList>()));
 }
 
 //----------------------------------------------------------------------------------------
@@ -61,6 +67,7 @@ MeshBlockPack::~MeshBlockPack() {
   if (pdyngr != nullptr) {delete pdyngr;}
   if (pnr    != nullptr) {delete pnr;}
   if (pturb  != nullptr) {delete pturb;}
+  if (pgrav  != nullptr) {delete pgrav;}
   if (punit  != nullptr) {delete punit;}
   if (pz4c   != nullptr) {
     delete pz4c;
@@ -71,6 +78,7 @@ MeshBlockPack::~MeshBlockPack() {
     pz4c_cce.resize(0);
   }
   if (ppart  != nullptr) {delete ppart;}
+  if (pmsg_group != nullptr) {delete pmsg_group;}
   // must be last, since it calls ~BoundaryValues() which (MPI) uses pmy_pack->pmb->nnghbr
   delete pmb;
 }
@@ -115,6 +123,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // Create Hydro physics module.  Create TaskLists only for single-fluid hydro
   // (Note TaskLists stored in MeshBlockPack)
   if (pin->DoesBlockExist("hydro")) {
+    memory_tracker::SetScope("hydro");
     phydro = new hydro::Hydro(this, pin);
     nphysics++;
     if (!(pin->DoesBlockExist("mhd")) && !(pin->DoesBlockExist("radiation")) &&
@@ -128,6 +137,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (3) MHD
   // Create MHD physics module.  Create TaskLists only for single-fluid MHD
   if (pin->DoesBlockExist("mhd")) {
+    memory_tracker::SetScope("mhd");
     pmhd = new mhd::MHD(this, pin);
     nphysics++;
     if (!(pin->DoesBlockExist("hydro")) && !(pin->DoesBlockExist("radiation")) &&
@@ -142,6 +152,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // Create Ion-Neutral physics module and TaskLists. Error if <hydro> and <mhd> are not
   // both defined as well.
   if (pin->DoesBlockExist("ion-neutral")) {
+    memory_tracker::SetScope("ion-neutral");
     pionn = new ion_neutral::IonNeutral(this, pin);   // construct new MHD object
     if (pin->DoesBlockExist("hydro") && pin->DoesBlockExist("mhd") &&
         !(pin->DoesBlockExist("adm")) && !(pin->DoesBlockExist("z4c")) ) {
@@ -167,8 +178,24 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (5) RADIATION
   // Create radiation physics module.  Create tasklist.
   if (pin->DoesBlockExist("radiation")) {
+    memory_tracker::SetScope("radiation");
     prad = new radiation::Radiation(this, pin);
     nphysics++;
+#if MPI_PARALLEL_ENABLED
+    // optionally send ghost zones of radiation and fluid to each rank in one message.
+    // Radiation tasks are then ordered so the fluid is packed before radiation is
+    // received (see Radiation::AssembleRadTasks)
+    if (pin->GetOrAddBoolean("mesh","combine_messages",false) && !(prad->fixed_fluid) &&
+        (phydro != nullptr || pmhd != nullptr)) {
+      bool every_stage = (phydro == nullptr) || (phydro->stages_per_exchange == 1);
+      if (every_stage) {
+        pmsg_group = new MeshBoundaryMessageGroup(this);
+        pmsg_group->AddMember(prad->pbval_i);
+        if (phydro != nullptr) {pmsg_group->AddMember(phydro->pbval_u);}
+        if (pmhd != nullptr) {pmsg_group->AddMember(pmhd->pbval_u);}
+      }
+    }
+#endif
     prad->AssembleRadTasks(tl_map);
   } else {
     prad = nullptr;
@@ -181,6 +208,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // force and adding force to fluid are included in operator_split and stage_run
   // task lists respectively.
   if (pin->DoesBlockExist("turb_driving")) {
+    memory_tracker::SetScope("turb_driving");
     pturb = new TurbulenceDriver(this, pin);
     pturb->IncludeInitializeModesTask(tl_map["before_timeintegrator"], none);
     pturb->IncludeAddForcingTask(tl_map["stagen"], none);
@@ -191,6 +219,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (7) Z4c and ADM
   // Create Z4c and ADM physics module.
   if (pin->DoesBlockExist("z4c")) {
+    memory_tracker::SetScope("z4c");
     pz4c = new z4c::Z4c(this, pin);
     padm = new adm::ADM(this, pin);
     ptmunu = nullptr;
@@ -206,6 +235,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   } else {
     pz4c = nullptr;
     if (pin->DoesBlockExist("adm")) {
+      memory_tracker::SetScope("adm");
       padm = new adm::ADM(this, pin);
     } else {
       padm = nullptr;
@@ -221,11 +251,13 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   }
   if ((pin->DoesBlockExist("z4c") || pin->DoesBlockExist("adm")) &&
       (pin->DoesBlockExist("mhd")) ) {
+    memory_tracker::SetScope("dyn_grmhd");
     pdyngr = dyngr::BuildDynGRMHD(this, pin);
     ptmunu = new Tmunu(this, pin);
   }
 
   if (pz4c != nullptr || padm != nullptr) {
+    memory_tracker::SetScope("numrel");
     pnr = new numrel::NumericalRelativity(this, pin);
     pnr->AssembleNumericalRelativityTasks(tl_map);
   }
@@ -233,6 +265,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (8) PARTICLES
   // Create particles module.  Create tasklist.
   if (pin->DoesBlockExist("particles")) {
+    memory_tracker::SetScope("particles");
     ppart = new particles::Particles(this, pin);
     ppart->AssembleTasks(tl_map);
     nphysics++;
@@ -240,6 +273,41 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
     ppart = nullptr;
   }
 
+  // (9) SELF-GRAVITY
+  // Potential is solved with multigrid at the start of each stage, and source terms are
+  // added to Hydro or MHD, so tasks are included in their task lists (like turbulence).
+  if (pin->DoesBlockExist("gravity")) {
+    memory_tracker::SetScope("gravity");
+    pgrav = new Gravity(this, pin);
+    pgrav->IncludeTasks(tl_map);
+  } else {
+    pgrav = nullptr;
+  }
+
+  // Options of Hydro that update a halo of ghost zones redundantly, or that update and
+  // send MBs with off-rank neighbors first, assume that u0 is only changed by the flux
+  // and RK update kernels, which is not true for the source terms of physics built after
+  // Hydro.  They are therefore tested here.
+  if (phydro != nullptr) {
+    bool user_srcs = pin->GetOrAddBoolean("problem","user_srcs",false);
+    bool coupled_srcs = (pturb != nullptr) || (prad != nullptr) || (pionn != nullptr) ||
+                        (pgrav != nullptr) || user_srcs;
+    if ((phydro->stages_per_exchange > 1) && coupled_srcs) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/stages_per_exchange > 1 cannot be used with "
+          << "turbulence driving, radiation, ion-neutral, gravity, or user source terms"
+          << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (phydro->boundary_first && coupled_srcs) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<hydro>/boundary_first cannot be used with turbulence "
+          << "driving, radiation, ion-neutral, gravity, or user source terms"
+          << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
   // Check that at least ONE is requested and initialized.
   // Error if there are no physics blocks in the input file.
   if (nphysics == 0) {
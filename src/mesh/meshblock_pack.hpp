@@ -29,6 +29,8 @@ namespace radiation {class Radiation;}
 namespace dyngr {class DynGRMHD;}
 namespace numrel {class NumericalRelativity;}
 class TurbulenceDriver;
+class Gravity;
+class MeshBoundaryMessageGroup;
 namespace radiation {class Radiation;}
 namespace z4c {class Z4c;}
 namespace z4c {class CCE;}
@@ -36,6 +38,18 @@ namespace adm {class ADM;}
 namespace particles {class Particles;}
 namespace units {class Units;}
 
+//----------------------------------------------------------------------------------------
+//! \struct ExtraArrayCC
+//! \brief cell-centered array (with its coarse array) owned by an object other than the
+//! physics modules, e.g. the running sums of a time-averaged output, which is moved with
+//! its MeshBlocks by load balancing and AMR, and stored in restart files.
+
+struct ExtraArrayCC {
+  std::string name;              // unique name (e.g. output block), stored in restarts
+  DvceArray5D<Real> *u;          // array dimensioned (nmb,nvar,n3,n2,n1)
+  DvceArray5D<Real> *coarse_u;   // coarse array (only used with multilevel meshes)
+};
+
 //----------------------------------------------------------------------------------------
 //! \class MeshBlockPack
 //! \brief data/functions associated with a single block
@@ -71,16 +85,25 @@ class MeshBlockPack {
   numrel::NumericalRelativity *pnr=nullptr;
   ion_neutral::IonNeutral *pionn=nullptr;
   TurbulenceDriver *pturb=nullptr;
+  Gravity *pgrav=nullptr;
   radiation::Radiation *prad=nullptr;
   std::vector<z4c::CCE *> pz4c_cce;
   particles::Particles *ppart=nullptr;
 
+  // combined boundary messages of several physics (only with <mesh>/combine_messages)
+  MeshBoundaryMessageGroup *pmsg_group=nullptr;
+
   // units (needed to convert code units to cgs for, e.g., cooling or radiation)
   units::Units *punit=nullptr;
 
   // map for task lists which operate over all MeshBlocks in this MeshBlockPack
   std::map<std::string, std::shared_ptr<TaskList>> tl_map;
 
+  // extra CC arrays registered by their owners, and arrays read from a restart file
+  // (indexed by name) until they are claimed by the objects that register them
+  std::vector<ExtraArrayCC> extra_cc;
+  std::map<std::string, DvceArray5D<Real>> extra_cc_rst;
+
   // functions
   void AddPhysics(ParameterInput *pin);
   void AddMeshBlocks(ParameterInput *pin);
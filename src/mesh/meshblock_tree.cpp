@@ -6,10 +6,11 @@
 //! \file meshblock_tree.cpp
 //  \brief implementation of constructor and functions in the MeshBlockTree class
 
+#include <algorithm> // min
 #include <cstdint>
 #include <iostream>
-#include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
@@ -20,6 +21,8 @@
 Mesh* MeshBlockTree::pmesh_;
 MeshBlockTree* MeshBlockTree::proot_;
 int MeshBlockTree::nleaf_;
+std::unordered_map<LogicalLocation, MeshBlockTree*, MeshBlockTree::LocationHash,
+                   MeshBlockTree::LocationEqual> MeshBlockTree::nodes_;
 
 //----------------------------------------------------------------------------------------
 //! \fn MeshBlockTree::MeshBlockTree()
@@ -32,6 +35,7 @@ MeshBlockTree::MeshBlockTree(Mesh *pmesh) :
   lloc_.lx2 = 0;
   lloc_.lx3 = 0;
   lloc_.level = 0;
+  nodes_[lloc_] = this;
 }
 
 //----------------------------------------------------------------------------------------
@@ -44,6 +48,7 @@ MeshBlockTree::MeshBlockTree(MeshBlockTree *parent, int ox1, int ox2, int ox3) :
   lloc_.lx2 = (parent->lloc_.lx2<<1) + ox2;
   lloc_.lx3 = (parent->lloc_.lx3<<1) + ox3;
   lloc_.level = parent->lloc_.level + 1;
+  nodes_[lloc_] = this;
 }
 
 //----------------------------------------------------------------------------------------
@@ -55,6 +60,8 @@ MeshBlockTree::~MeshBlockTree() {
     for (int i=0; i<nleaf_; i++) { delete pleaf_[i]; }
     delete [] pleaf_;
   }
+  auto it = nodes_.find(lloc_);
+  if (it != nodes_.end() && it->second == this) {nodes_.erase(it);}
 }
 
 //----------------------------------------------------------------------------------------
@@ -295,7 +302,9 @@ void MeshBlockTree::Derefine(int &ndel) {
     }
   }
 
-  gid_ = pleaf_[0]->gid_; // now this is a leaf; inherit the first leaf's GID
+  // now this is a leaf; inherit the GID of the leaf that is first in SFC order
+  gid_ = pleaf_[0]->gid_;
+  for (int n=1; n<nleaf_; n++) {gid_ = std::min(gid_, pleaf_[n]->gid_);}
   for (int n=0; n<nleaf_; n++) {
     delete pleaf_[n];
   }
@@ -323,19 +332,37 @@ void MeshBlockTree::CountMeshBlocks(int& count) {
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void MeshBlockTree::CreateZOrderedLLList(LogicalLocation *list, int *pg, int& cnt)
-//! \brief Creates the Location list for tree sorted by Z-ordering, and creates new MB ids
+//! \fn void MeshBlockTree::CreateSFCOrderedLLList(LogicalLocation *list, int *pg,
+//!                                                int& cnt)
+//! \brief Creates the Location list for tree sorted by the space-filling curve (SFC) set
+//! by Mesh::sfc_ordering (either Z-ordering or Hilbert ordering), and creates new MB ids
 //! based on this order.  Should be called from root of tree. Called in BuildTreeXXX()
 //! functions when tree is constructed for first time, in which case second argument is
-//! 'nullptr' and this function creates gids for all MBs based on Z-ordering. Also called
-//! by ResdistributeAndRefineMeshBlocks() function with AMR with second argument pointing
-//! to an integer array that is used to store old gid of node on old tree, before creating
-//! a new gid based on Z-ordering in the new tree. Thus pglist[n] is a mapping of
-//! (new gid n) --> (old gid). Also returns total number of MBs in tree in third argument.
-
-void MeshBlockTree::CreateZOrderedLLList(LogicalLocation *list, int *pglist, int& count) {
+//! 'nullptr' and this function creates gids for all MBs based on SFC ordering. Also
+//! called by ResdistributeAndRefineMeshBlocks() function with AMR with second argument
+//! pointing to an integer array that is used to store old gid of node on old tree, before
+//! creating a new gid based on SFC ordering in the new tree. Thus pglist[n] is a mapping
+//! of (new gid n) --> (old gid). Also returns total number of MBs in tree in third
+//! argument.
+//! With either ordering the leaves of a node are always listed contiguously.
+
+void MeshBlockTree::CreateSFCOrderedLLList(LogicalLocation *list, int *pglist,
+                                           int& count) {
   if (lloc_.level == 0) {count=0;}
 
+  if (pmesh_->sfc_ordering == SFCOrdering::hilbert) {
+    AddHilbertOrderedLL(list, pglist, count, 0, 0);
+  } else {
+    AddZOrderedLL(list, pglist, count);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::AddZOrderedLL(LogicalLocation *list, int *pg, int& cnt)
+//! \brief Adds leaves of this node to Location list in Z-order, and sets their gids
+
+void MeshBlockTree::AddZOrderedLL(LogicalLocation *list, int *pglist, int& count) {
   if (pleaf_ == nullptr) {
     list[count]=lloc_;
     if (pglist != nullptr) {pglist[count]=gid_;}
@@ -343,7 +370,59 @@ void MeshBlockTree::CreateZOrderedLLList(LogicalLocation *list, int *pglist, int
     count++;
   } else {
     for (int n=0; n<nleaf_; n++) {
-      if (pleaf_[n] != nullptr) {pleaf_[n]->CreateZOrderedLLList(list, pglist, count);}
+      if (pleaf_[n] != nullptr) {pleaf_[n]->AddZOrderedLL(list, pglist, count);}
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::AddHilbertOrderedLL(LogicalLocation *list, int *pg, int& cnt,
+//!                                             int entry, int dir)
+//! \brief Adds leaves of this node to Location list in Hilbert order, and sets their
+//! gids.  The orientation of the curve within this node is given by the corner at which
+//! it enters (entry, with bits encoding ox1/ox2/ox3 as in pleaf_) and the direction in
+//! which it leaves that corner (dir), following Hamilton (2006) "Compact Hilbert
+//! Indices", Dalhousie Univ. tech. report CS-2006-07.  Works in 1D, 2D, and 3D.
+
+void MeshBlockTree::AddHilbertOrderedLL(LogicalLocation *list, int *pglist, int& count,
+                                        int entry, int dir) {
+  if (pleaf_ == nullptr) {
+    list[count]=lloc_;
+    if (pglist != nullptr) {pglist[count]=gid_;}
+    gid_=count;
+    count++;
+    return;
+  }
+
+  int ndim = 1;
+  if (nleaf_ == 4) ndim = 2;
+  if (nleaf_ == 8) ndim = 3;
+  int mask = nleaf_ - 1;
+  // rotate the ndim bits of x left by k
+  auto rotl = [=](int x, int k) {
+    k %= ndim;
+    return (k == 0) ? x : (((x << k) | (x >> (ndim - k))) & mask);
+  };
+  auto gray = [](int i) {return i ^ (i >> 1);};
+  auto trailing_ones = [](int i) {
+    int c = 0;
+    while (i & 1) {c++; i >>= 1;}
+    return c;
+  };
+
+  for (int w=0; w<nleaf_; w++) {
+    // position (index in pleaf_) of the w-th leaf along the curve
+    int n = rotl(gray(w), dir+1) ^ entry;
+    // entry corner and direction of the curve within this leaf
+    int w_entry = (w == 0) ? 0 : gray(2*((w-1)/2));
+    int w_dir = 0;
+    if (w > 0) {
+      w_dir = ((w % 2 == 0) ? trailing_ones(w-1) : trailing_ones(w)) % ndim;
+    }
+    if (pleaf_[n] != nullptr) {
+      pleaf_[n]->AddHilbertOrderedLL(list, pglist, count, entry ^ rotl(w_entry, dir+1),
+                                     (dir + w_dir + 1) % ndim);
     }
   }
   return;
@@ -356,14 +435,15 @@ void MeshBlockTree::CreateZOrderedLLList(LogicalLocation *list, int *pglist, int
 //!        If it is coarser or same level, return the pointer to that block.
 //!        If it is a finer block, return the pointer to its parent.
 //!        Note that this function must be called on a completed tree only
+//!        The node at the level of myloc, or else its parent, is looked up in nodes_,
+//!        which gives the same result as descending the tree.  Only reads the tree, so
+//!        it can be called by many threads at once.
 
 MeshBlockTree* MeshBlockTree::FindNeighbor(LogicalLocation myloc,
                                            int ox1, int ox2, int ox3, bool amrflag) {
-  std::stringstream msg;
   std::int32_t lx, ly, lz;
   int ll;
   int ox, oy, oz;
-  MeshBlockTree *bt = proot_;
   lx=myloc.lx1, ly=myloc.lx2, lz=myloc.lx3, ll=myloc.level;
 
   lx+=ox1; ly+=ox2; lz+=ox3;
@@ -415,29 +495,20 @@ MeshBlockTree* MeshBlockTree::FindNeighbor(LogicalLocation myloc,
 
   if (ll<1) return proot_; // single grid; return root
 
-  for (int level=0; level<ll; level++) {
-    if (bt->pleaf_ == nullptr) { // leaf
-      if (level == ll-1) {
-        return bt;
-      } else {
-        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-            << std::endl << "Neighbor search failed; MeshBlockTree broken." << std::endl;
-        exit(EXIT_FAILURE);
-        return nullptr;
-      }
-    }
-    // find a leaf in the next level
-    int sh=ll-level-1;
-    ox = ((lx>>sh) & 1) == 1;
-    oy = ((ly>>sh) & 1) == 1;
-    oz = ((lz>>sh) & 1) == 1;
-    bt=bt->GetLeaf(ox, oy, oz);
-    if (bt == nullptr) {
+  LogicalLocation nloc;
+  nloc.lx1 = lx, nloc.lx2 = ly, nloc.lx3 = lz, nloc.level = ll;
+  MeshBlockTree *bt = FindNode(nloc);
+  if (bt == nullptr) {
+    // no node at this level, so neighbor must be a coarser leaf (parent of nloc)
+    nloc.lx1 = lx>>1, nloc.lx2 = ly>>1, nloc.lx3 = lz>>1, nloc.level = ll-1;
+    MeshBlockTree *bp = FindNode(nloc);
+    if (bp == nullptr || bp->pleaf_ != nullptr) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << "Neighbor search failed; MeshBlockTree broken." << std::endl;
       exit(EXIT_FAILURE);
       return nullptr;
     }
+    return bp;
   }
   if (bt->pleaf_ == nullptr) { // leaf on the same level
     return bt;
@@ -461,10 +532,12 @@ MeshBlockTree* MeshBlockTree::FindNeighbor(LogicalLocation myloc,
 
 //----------------------------------------------------------------------------------------
 //! \fn MeshBlockTree* MeshBlockTree::FindMeshBlock(LogicalLocation tloc)
-//! \brief find MeshBlock with LogicalLocation tloc and return a pointer
+//! \brief find MeshBlock with LogicalLocation tloc and return a pointer.  Nodes below the
+//! root are looked up in nodes_.
 
 MeshBlockTree* MeshBlockTree::FindMeshBlock(LogicalLocation tloc) {
   if (tloc.level == lloc_.level) return this;
+  if (this == proot_) return FindNode(tloc);
   if (pleaf_ == nullptr) return nullptr;
   // get leaf index
   int sh = tloc.level - lloc_.level - 1;
@@ -15,6 +15,10 @@
 //
 // Original version of this foundational class written c2015-2016 by K. Tomida.
 
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
 //--------------------------------------------------------------------------------------
 //! \class MeshBlockTree
 //  \brief Objects are nodes in a binary tree structure.  Thus, the class name does not
@@ -26,6 +30,7 @@ class MeshBlockTree {
   friend class Mesh;
   friend class MeshBlock;
   friend class MeshBlockPack;
+  friend class MeshRefinement;
 
  public:
   explicit MeshBlockTree(Mesh *pmesh);
@@ -46,7 +51,7 @@ class MeshBlockTree {
   void Derefine(int &ndel);
   MeshBlockTree* FindMeshBlock(LogicalLocation tloc);
   void CountMeshBlocks(int& count);
-  void CreateZOrderedLLList(LogicalLocation *list, int *pglist, int& count);
+  void CreateSFCOrderedLLList(LogicalLocation *list, int *pglist, int& count);
   MeshBlockTree* FindNeighbor(LogicalLocation myloc, int ox1, int ox2, int ox3,
                               bool amrflag=false);
 
@@ -59,6 +64,36 @@ class MeshBlockTree {
   static Mesh *pmesh_;           // pointer to Mesh containing Tree
   static MeshBlockTree *proot_;  // pointer to leaf at root level
   static int nleaf_;             // number of leafs (2/4/8 for 1D/2D/3D)
+
+  // every node (leaf or not) of the tree indexed by its LogicalLocation, so that nodes
+  // and neighbors are found in O(1) rather than by descending the tree from the root.
+  // Nodes insert themselves when constructed and erase themselves when destroyed, so the
+  // map is updated incrementally by Refine() and Derefine().
+  struct LocationHash {
+    std::size_t operator()(const LogicalLocation &l) const {
+      std::uint64_t h = static_cast<std::uint32_t>(l.level);
+      h = h*0x9E3779B97F4A7C15ULL ^ static_cast<std::uint32_t>(l.lx1);
+      h = h*0x9E3779B97F4A7C15ULL ^ static_cast<std::uint32_t>(l.lx2);
+      h = h*0x9E3779B97F4A7C15ULL ^ static_cast<std::uint32_t>(l.lx3);
+      return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+  };
+  struct LocationEqual {
+    bool operator()(const LogicalLocation &a, const LogicalLocation &b) const {
+      return (a.lx1 == b.lx1 && a.lx2 == b.lx2 && a.lx3 == b.lx3 && a.level == b.level);
+    }
+  };
+  static std::unordered_map<LogicalLocation, MeshBlockTree*, LocationHash, LocationEqual>
+    nodes_;
+  static MeshBlockTree* FindNode(const LogicalLocation &loc) {
+    auto it = nodes_.find(loc);
+    return (it == nodes_.end())? nullptr : it->second;
+  }
+
+  // functions
+  void AddZOrderedLL(LogicalLocation *list, int *pglist, int& count);
+  void AddHilbertOrderedLL(LogicalLocation *list, int *pglist, int& count, int entry,
+                           int dir);
 };
 
 #endif // MESH_MESHBLOCK_TREE_HPP_
@@ -0,0 +1,156 @@
+#ifndef MESH_REFINEMENT_CRITERIA_HPP_
+#define MESH_REFINEMENT_CRITERIA_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file refinement_criteria.hpp
+//! \brief Framework for evaluating refinement criteria on the device in a single kernel.
+//! A criterion is a functor returning a vote for each active cell: 1 (refine), -1
+//! (derefine), or 0 (no change).  Criteria are composed by taking the max of their votes,
+//! so that a MeshBlock is refined if any criterion requests it, and derefined only if all
+//! criteria agree.  The vote of each MeshBlock is the max over its cells, computed with a
+//! single reduction, after which a per-MeshBlock functor (for criteria that depend only
+//! on the location/level of the MeshBlock) sets the final flag.  Flags stay on the device
+//! until they are copied to the host once in MeshRefinement::CheckForRefinement().
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \struct SetFlagFromVote
+//! \brief default per-MeshBlock functor: sets the flag to the vote over cells, unless the
+//! vote is zero, in which case the current flag is unchanged.
+
+struct SetFlagFromVote {
+  KOKKOS_INLINE_FUNCTION
+  int operator()(const int m, const int flag, const int vote) const {
+    return (vote != 0)? vote : flag;
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct HydroRefinementVote
+//! \brief default refinement criteria for Hydro/MHD, controlled by input parameters in
+//! the <mesh_refinement> block.  Criteria with a threshold of zero are not used.
+//! With lookahead>0, each cell also votes with the state upstream of it, at the distance
+//! the flow moves over the lookahead time (limited to the ghost zones), so that MBs are
+//! refined before features arrive, and are not derefined just before they arrive.
+
+struct HydroRefinementVote {
+  DvceArray5D<Real> u0, w0;
+  Real d_thresh, dd_thresh, dp_thresh;   // density max, density/pressure gradient
+  bool multi_d, three_d;
+  DualArray1D<RegionSize> size;
+  Real lookahead;                        // time over which features are advected
+  int ng;
+
+  KOKKOS_INLINE_FUNCTION
+  int operator()(const int m, const int k, const int j, const int i) const {
+    int vote = CellVote(m,k,j,i);
+    if (lookahead > 0.0) {
+      int di = Upstream(w0(m,IVX,k,j,i), size.d_view(m).dx1);
+      int dj = (multi_d)? Upstream(w0(m,IVY,k,j,i), size.d_view(m).dx2) : 0;
+      int dk = (three_d)? Upstream(w0(m,IVZ,k,j,i), size.d_view(m).dx3) : 0;
+      if (di != 0 || dj != 0 || dk != 0) {
+        int v = CellVote(m,k+dk,j+dj,i+di);
+        if (v > vote) {vote = v;}
+      }
+    }
+    return vote;
+  }
+
+  // offset (in cells) of upstream cell, limited so gradients stay within ghost zones
+  KOKKOS_INLINE_FUNCTION
+  int Upstream(const Real v, const Real dx) const {
+    Real s = fmin(fmax(-v*lookahead/dx, -static_cast<Real>(ng-1)),
+                  static_cast<Real>(ng-1));
+    return static_cast<int>((s < 0.0)? (s - 0.5) : (s + 0.5));
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  int CellVote(const int m, const int k, const int j, const int i) const {
+    int vote = -1;
+    // density threshold
+    if (d_thresh != 0.0) {
+      Real d = u0(m,IDN,k,j,i);
+      if (d > d_thresh) {
+        vote = 1;
+      } else if (d >= d_thresh && vote < 0) {
+        vote = 0;
+      }
+    }
+    // density gradient threshold
+    if (dd_thresh != 0.0) {
+      Real d2 = SQR(u0(m,IDN,k,j,i+1) - u0(m,IDN,k,j,i-1));
+      if (multi_d) {d2 += SQR(u0(m,IDN,k,j+1,i) - u0(m,IDN,k,j-1,i));}
+      if (three_d) {d2 += SQR(u0(m,IDN,k+1,j,i) - u0(m,IDN,k-1,j,i));}
+      Real dd = sqrt(d2)/u0(m,IDN,k,j,i);
+      if (dd > dd_thresh) {
+        vote = 1;
+      } else if (dd >= 0.25*dd_thresh && vote < 0) {
+        vote = 0;
+      }
+    }
+    // pressure gradient threshold
+    if (dp_thresh != 0.0) {
+      Real d2 = SQR(w0(m,IEN,k,j,i+1) - w0(m,IEN,k,j,i-1));
+      if (multi_d) {d2 += SQR(w0(m,IEN,k,j+1,i) - w0(m,IEN,k,j-1,i));}
+      if (three_d) {d2 += SQR(w0(m,IEN,k+1,j,i) - w0(m,IEN,k-1,j,i));}
+      Real dp = sqrt(d2)/w0(m,IEN,k,j,i);
+      if (dp > dp_thresh) {
+        vote = 1;
+      } else if (dp >= 0.25*dp_thresh && vote < 0) {
+        vote = 0;
+      }
+    }
+    return vote;
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::FlagRefinement()
+//! \brief Evaluates refinement criteria for all MeshBlocks in a pack with one kernel.  If
+//! use_cells is true, the CellVote functor (signature int(m,k,j,i)) is reduced over all
+//! active cells of each MeshBlock with a max.  The BlockAdjust functor (signature
+//! int(m, flag, vote)) then returns the new refine_flag given its current value and the
+//! vote (zero if use_cells is false).  Flags are only modified on the device.
+
+template <typename CellVote, typename BlockAdjust>
+void MeshRefinement::FlagRefinement(MeshBlockPack *pmbp, const bool use_cells,
+                                    const CellVote &vote, const BlockAdjust &adjust) {
+  auto &indcs = pmy_mesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  int nmb = pmbp->nmb_thispack;
+  int mbs = pmy_mesh->gids_eachrank[global_variable::my_rank];
+  auto refine_flag_ = refine_flag;
+
+  par_for_outer("FlagRefinement",DevExeSpace(), 0, 0, 0, (nmb-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+    int team_vote = 0;
+    if (use_cells) {
+      Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+      [=](const int idx, int& vmax) {
+        int k = (idx)/nji;
+        int j = (idx - k*nji)/nx1;
+        int i = (idx - k*nji - j*nx1) + is;
+        j += js;
+        k += ks;
+        int v = vote(m,k,j,i);
+        if (v > vmax) {vmax = v;}
+      },Kokkos::Max<int>(team_vote));
+    }
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+      refine_flag_.d_view(m+mbs) = adjust(m, refine_flag_.d_view(m+mbs), team_vote);
+    });
+  });
+  return;
+}
+
+#endif // MESH_REFINEMENT_CRITERIA_HPP_
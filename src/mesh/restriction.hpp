@@ -92,4 +92,34 @@ Real RestrictInterpolation(const int m, const int v, const int fk, const int fj,
   }
   return ivals;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn bool CoarseCellNeeded()
+//! \brief Returns true if coarse cell (k,j,i) lies within w cells of a face, edge, or
+//! corner of a MeshBlock at which the neighbor is at a coarser level, as encoded in
+//! MeshRefinement::coarse_nghbr_mask.  Only these cells are sent to coarser neighbors
+//! or used by the prolongation stencil at fine/coarse boundaries.
+
+KOKKOS_INLINE_FUNCTION
+bool CoarseCellNeeded(const int mask, const int k, const int j, const int i,
+                      const int cis, const int cie, const int cjs, const int cje,
+                      const int cks, const int cke, const int w) {
+  if (mask == 0) {return false;}
+  // offsets of neighbors the cell is adjacent to: bit 0 for -1, bit 1 for 0, bit 2 for +1
+  int ai = 2 | ((i < cis + w)? 1 : 0) | ((i > cie - w)? 4 : 0);
+  int aj = 2 | ((j < cjs + w)? 1 : 0) | ((j > cje - w)? 4 : 0);
+  int ak = 2 | ((k < cks + w)? 1 : 0) | ((k > cke - w)? 4 : 0);
+  for (int o3=0; o3<3; ++o3) {
+    if ((ak & (1 << o3)) == 0) continue;
+    for (int o2=0; o2<3; ++o2) {
+      if ((aj & (1 << o2)) == 0) continue;
+      for (int o1=0; o1<3; ++o1) {
+        if (((ai & (1 << o1)) != 0) && ((mask & (1 << (o1 + 3*o2 + 9*o3))) != 0)) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
 #endif // MESH_RESTRICTION_HPP_
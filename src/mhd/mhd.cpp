@@ -13,11 +13,13 @@
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
 #include "eos/eos.hpp"
 #include "diffusion/viscosity.hpp"
 #include "diffusion/resistivity.hpp"
 #include "diffusion/conduction.hpp"
 #include "srcterms/srcterms.hpp"
+#include "chemistry/chemistry.hpp"
 #include "shearing_box/shearing_box.hpp"
 #include "shearing_box/orbital_advection.hpp"
 #include "bvals/bvals.hpp"
@@ -34,12 +36,12 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
     b0("B_fc",1,1,1,1),
     bcc0("B_cc",1,1,1,1,1),
     coarse_u0("ccons",1,1,1,1,1),
-    coarse_w0("cprim",1,1,1,1,1),
     coarse_b0("cB_fc",1,1,1,1),
     u1("cons1",1,1,1,1,1),
     b1("B_fc1",1,1,1,1),
     uflx("uflx",1,1,1,1,1),
     efld("efld",1,1,1,1),
+    b_start("B_fc_start",1,1,1,1),
     wsaved("wsaved",1,1,1,1,1),
     bccsaved("bccsaved",1,1,1,1,1),
     e3x1("e3x1",1,1,1,1),
@@ -53,7 +55,8 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
     e3_cc("e3_cc",1,1,1,1),
     utest("utest",1,1,1,1,1),
     bcctest("bcctest",1,1,1,1,1),
-    fofc("fofc",1,1,1,1) {
+    fofc("fofc",1,1,1,1),
+    fofc_list("fofc_list",1) {
   // Total number of MeshBlocks on this rank to be used in array dimensioning
   int nmb = std::max((ppack->nmb_thispack), (ppack->pmesh->nmb_maxperrank));
 
@@ -93,7 +96,8 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
   nscalars = pin->GetOrAddInteger("mhd","nscalars",0);
 
   // Viscosity (only constructed if needed)
-  if (pin->DoesParameterExist("mhd","viscosity")) {
+  if (pin->DoesParameterExist("mhd","viscosity") ||
+      pin->DoesParameterExist("mhd","aniso_viscosity")) {
     pvisc = new Viscosity("mhd", ppack, pin);
   } else {
     pvisc = nullptr;
@@ -108,7 +112,8 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
 
   // Thermal conduction (only constructed if needed)
   if (pin->DoesParameterExist("mhd","conductivity") ||
-      pin->DoesParameterExist("mhd","tdep_conductivity")) {
+      pin->DoesParameterExist("mhd","tdep_conductivity") ||
+      pin->DoesParameterExist("mhd","aniso_conductivity")) {
     pcond = new Conduction("mhd", ppack, pin);
   } else {
     pcond = nullptr;
@@ -117,6 +122,11 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
   // Source terms (constructor parses input file to initialize only srcterms needed)
   psrc = new SourceTerms("mhd", ppack, pin);
 
+  // Operator-split reaction network acting on passive scalars (if requested)
+  if (pin->DoesBlockExist("chemistry")) {
+    pchem = new Chemistry(ppack, pin, nscalars);
+  }
+
   // (3) read time-evolution option [already error checked in driver constructor]
   // Then initialize memory and algorithms for reconstruction and Riemann solvers
   std::string evolution_t = pin->GetString("time","evolution");
@@ -146,7 +156,6 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
     int n_ccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
     int n_ccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
     Kokkos::realloc(coarse_u0, nmb, (nmhd+nscalars), n_ccells3, n_ccells2, n_ccells1);
-    Kokkos::realloc(coarse_w0, nmb, (nmhd+nscalars), n_ccells3, n_ccells2, n_ccells1);
     Kokkos::realloc(coarse_b0.x1f, nmb, n_ccells3, n_ccells2, n_ccells1+1);
     Kokkos::realloc(coarse_b0.x2f, nmb, n_ccells3, n_ccells2+1, n_ccells1);
     Kokkos::realloc(coarse_b0.x3f, nmb, n_ccells3+1, n_ccells2, n_ccells1);
@@ -154,8 +163,11 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
 
   // allocate boundary buffers for conserved (cell-centered) and face-centered variables
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
+  pbval_u->SetSameLevelGhosts(pin, "mhd");
+  pbval_u->SetReducedPrecision(pin, "mhd");
   pbval_u->InitializeBuffers((nmhd+nscalars));
   pbval_b = new MeshBoundaryValuesFC(ppack, pin);
+  pbval_b->SetSameLevelGhosts(pin, "mhd");
   pbval_b->InitializeBuffers(3);
 
   // Orbital advection and shearing box BCs (if requested in input file)
@@ -176,6 +188,63 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
     // determine if FOFC is enabled
     use_fofc = pin->GetOrAddBoolean("mhd","fofc",false);
 
+    // overlap exchange of ghost zones with computation of fluxes on interior faces
+    overlap_comm = pin->GetOrAddBoolean("mhd","overlap_comm",false);
+    if (overlap_comm && ((psbox_u != nullptr) ||
+                         (pmy_pack->pcoord->is_dynamical_relativistic))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<mhd>/overlap_comm cannot be used with shearing box or "
+        << "dynamical GR" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // integrate viscosity and conduction with operator-split super time-stepping.
+    // Resistivity is still integrated in the explicit stages.
+    if ((pin->GetOrAddString("time","sts_integrator","none").compare("none") != 0) &&
+        ((pvisc != nullptr) || (pcond != nullptr))) {
+      use_sts = true;
+      if (overlap_comm || (psbox_u != nullptr) ||
+          (pmy_pack->pcoord->is_dynamical_relativistic)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<time>/sts_integrator cannot be used with overlap_comm, "
+          << "shearing box, or dynamical GR" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // reduce new timestep in C2P of last stage
+    use_fused_newdt = pin->GetOrAddBoolean("mhd","fused_newdt",false);
+
+    // fuse calculation of corner electric fields with CT update.  Only possible if the
+    // corner fields are not modified after CornerE, i.e. with no resistivity, shearing
+    // box source terms, or flux correction at fine/coarse boundaries (with uniform grids
+    // the same-level flux correction in SendE/RecvE does not change E).
+    use_fused_ct = pin->GetOrAddBoolean("mhd","fused_ct",false);
+    if (use_fused_ct &&
+        ((presist != nullptr) || (psbox_u != nullptr) || (pmy_pack->pmesh->multilevel) ||
+         (pmy_pack->pcoord->is_dynamical_relativistic) || (pmy_pack->pmesh->one_d))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<mhd>/fused_ct cannot be used with resistivity, shearing box, "
+        << "SMR/AMR, dynamical GR, or in 1D" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (use_fused_ct && pmy_pack->pcoord->skip_excised_blocks) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<mhd>/fused_ct cannot be used with <coord>/skip_excised_blocks"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (use_fused_ct) {
+      ct_tile_nx2 = pin->GetOrAddInteger("mhd","fused_ct_tile_nx2",8);
+      if (ct_tile_nx2 < 1) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<mhd>/fused_ct_tile_nx2=" << ct_tile_nx2 << " must be > 0"
+          << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      ct_tile_nx2 = std::min(ct_tile_nx2, pmy_pack->pmesh->mb_indcs.nx2);
+    }
+
     // select reconstruction method (default PLM)
     std::string xorder = pin->GetOrAddString("mhd","reconstruct","plm");
     if (xorder.compare("dc") == 0) {
@@ -222,6 +291,19 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       std::exit(EXIT_FAILURE);
     }
 
+    // check that enough ghost cells are exchanged at the same level for the stencil
+    {
+      int nreq = (recon_method == ReconstructionMethod::dc)? 1 :
+                 ((recon_method == ReconstructionMethod::plm)? 2 : 3);
+      if (use_fofc) {nreq += 1;}
+      if (pbval_u->nghost_same < nreq) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << xorder << " reconstruction requires <mhd>/nghost_exchange >= "
+          << nreq << ", but nghost_exchange=" << pbval_u->nghost_same << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
     // select Riemann solver (no default).  Test for compatibility of options
     std::string rsolver = pin->GetString("mhd","rsolver");
     // Special relativistic solvers
@@ -231,6 +313,8 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
           rsolver_method = MHD_RSolver::llf_sr;
         } else if (rsolver.compare("hlle") == 0) {
           rsolver_method = MHD_RSolver::hlle_sr;
+        } else if (rsolver.compare("hlld") == 0) {
+          rsolver_method = MHD_RSolver::hlld_sr;
         // Error for anything else
         } else {
           std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
@@ -298,6 +382,17 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       }
     }
 
+    // select flux kernel compiled for this combination of RS, reconstruction, and EOS
+    flux_kernel = SelectFluxKernel();
+    if (flux_kernel == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mhd> rsolver = '" << rsolver << "' with "
+                << "reconstruct = '" << xorder << "' was not compiled for this EOS, "
+                << "reconfigure with Athena_FLUX_RECON and Athena_FLUX_EOS" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    update_kernel = SelectUpdateKernel();
+
     // Final memory allocations
     {
       // allocate second registers
@@ -337,6 +432,20 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
         Kokkos::realloc(bcctest, nmb, 3,    ncells3, ncells2, ncells1);
         Kokkos::deep_copy(fofc, false);
       }
+
+      // allocate registers used by super time-stepping
+      if (use_sts) {
+        Kokkos::realloc(u_sts0,  nmb, (nmhd+nscalars), ncells3, ncells2, ncells1);
+        Kokkos::realloc(u_stsl0, nmb, (nmhd+nscalars), ncells3, ncells2, ncells1);
+      }
+
+      // allocate registers for restarting rejected steps of embedded RK pairs
+      if (Driver::EmbeddedPair(pin->GetOrAddString("time", "integrator", "rk2"))) {
+        Kokkos::realloc(u_start,     nmb, (nmhd+nscalars), ncells3, ncells2, ncells1);
+        Kokkos::realloc(b_start.x1f, nmb, ncells3, ncells2, ncells1+1);
+        Kokkos::realloc(b_start.x2f, nmb, ncells3, ncells2+1, ncells1);
+        Kokkos::realloc(b_start.x3f, nmb, ncells3+1, ncells2, ncells1);
+      }
     }
   }
 }
@@ -352,6 +461,7 @@ MHD::~MHD() {
   if (presist!= nullptr) {delete presist;}
   if (pcond != nullptr) {delete pcond;}
   if (psrc!= nullptr) {delete psrc;}
+  if (pchem != nullptr) {delete pchem;}
 }
 
 //----------------------------------------------------------------------------------------
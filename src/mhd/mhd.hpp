@@ -24,6 +24,7 @@ class Viscosity;
 class Resistivity;
 class Conduction;
 class SourceTerms;
+class Chemistry;
 class OrbitalAdvectionCC;
 class OrbitalAdvectionFC;
 class ShearingBoxCC;
@@ -37,7 +38,7 @@ using MHDBoundaryFnPtr = void (*)(int m, Mesh* pm, MHD* pmhd, DvceArray5D<Real>
 
 // constants that enumerate MHD Riemann Solver options
 enum class MHD_RSolver {advect, llf, hlle, hlld, roe,   // non-relativistic
-                        llf_sr, hlle_sr,                // SR
+                        llf_sr, hlle_sr, hlld_sr,       // SR
                         llf_gr, hlle_gr};                       // GR
 
 //----------------------------------------------------------------------------------------
@@ -49,6 +50,7 @@ struct MHDTaskIDs {
   TaskID irecv;
   TaskID copyu;
   TaskID flux;
+  TaskID fluxi;   // fluxes on interior faces (only with overlapped communication)
   TaskID sendf;
   TaskID recvf;
   TaskID rkupdt;
@@ -75,9 +77,25 @@ struct MHDTaskIDs {
   TaskID bcs;
   TaskID prol;
   TaskID c2p;
+  TaskID c2ps;    // ConToPrim in ghost zones (only with overlapped communication)
   TaskID newdt;
+  TaskID chem;    // operator-split reaction network (only with <chemistry> block)
   TaskID csend;
   TaskID crecv;
+  // tasks in super time-stepping (STS) stages
+  TaskID sts_irecv;
+  TaskID sts_flux;
+  TaskID sts_sendf;
+  TaskID sts_recvf;
+  TaskID sts_updt;
+  TaskID sts_restu;
+  TaskID sts_sendu;
+  TaskID sts_recvu;
+  TaskID sts_bcs;
+  TaskID sts_prol;
+  TaskID sts_c2p;
+  TaskID sts_csend;
+  TaskID sts_crecv;
 };
 
 namespace mhd {
@@ -103,7 +121,6 @@ class MHD {
   DvceArray5D<Real> bcc0;  // cell-centered magnetic fields
 
   DvceArray5D<Real> coarse_u0;    // conserved variables on 2x coarser grid (for SMR/AMR)
-  DvceArray5D<Real> coarse_w0;    // primitive variables on 2x coarser grid (for SMR/AMR)
   DvceFaceFld4D<Real> coarse_b0;  // face-centered B-field on 2x coarser grid
 
   // Objects containing boundary communication buffers and routines for u and b
@@ -122,17 +139,21 @@ class MHD {
   Resistivity *presist = nullptr;
   Conduction *pcond = nullptr;
   SourceTerms *psrc = nullptr;
+  Chemistry *pchem = nullptr;
 
   // following only used for time-evolving flow
   DvceArray5D<Real> u1;       // conserved variables, second register
   DvceFaceFld4D<Real> b1;     // face-centered magnetic fields, second register
-  DvceFaceFld5D<Real> uflx;   // fluxes of conserved quantities on cell faces
+  DvceFaceFld5D<FluxReal> uflx;   // fluxes of conserved quantities on cell faces
   DvceEdgeFld4D<Real> efld;   // edge-centered electric fields (fluxes of B)
   // temporary variables used to store face-centered electric fields returned by RS
   DvceArray4D<Real> e3x1, e2x1;
   DvceArray4D<Real> e1x2, e3x2;
   DvceArray4D<Real> e2x3, e1x3;
   Real dtnew;
+  Real errnew = 0.0;            // error norm of step with embedded RK pairs
+  DvceArray5D<Real> u_start;    // u0 and b0 at start of step (embedded RK pairs)
+  DvceFaceFld4D<Real> b_start;
 
   // following used for time derivatives in computation of jcon
   bool wbcc_saved = false;
@@ -142,6 +163,24 @@ class MHD {
   // following used for FOFC algorithm
   DvceArray4D<bool> fofc;  // flag for each cell to indicate if FOFC is needed
   bool use_fofc = false;   // flag to enable FOFC
+  DvceArray1D<int> fofc_list;  // flat (m,k,j,i) indices of cells flagged for FOFC
+
+  // exchange ghost zones at start of each stage, overlapped with interior fluxes
+  bool overlap_comm = false;
+
+  // compute signal speeds for the new timestep in the C2P kernel of the last stage,
+  // instead of in a separate sweep over w0 and bcc0 in NewTimeStep
+  bool use_fused_newdt = false;
+
+  // compute corner electric fields in same kernel as CT update of face fields
+  bool use_fused_ct = false;
+  int ct_tile_nx2;  // number of rows of faces updated by each team
+
+  // integrate viscosity and conduction with super time-stepping after the explicit
+  // stages of each cycle (<time>/sts_integrator = rkl1 or rkl2)
+  bool use_sts = false;
+  DvceArray5D<Real> u_sts0;    // conserved variables at start of STS
+  DvceArray5D<Real> u_stsl0;   // dt times diffusion operator acting on u_sts0
 
   // container to hold names of TaskIDs
   MHDTaskIDs id;
@@ -149,6 +188,8 @@ class MHD {
   // functions...
   void SetSaveWBcc();
   void AssembleMHDTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  void AssembleOverlappedTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  void AssembleSTSTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
   // ...in "before_timeintegrator" task list
   TaskStatus SaveMHDState(Driver *d, int stage);
   // ...in "before_stagen_tl" task list
@@ -156,6 +197,8 @@ class MHD {
   // ...in "stagen_tl" task list
   TaskStatus CopyCons(Driver *d, int stage);
   TaskStatus Fluxes(Driver *d, int stage);
+  TaskStatus FluxesInterior(Driver *d, int stage);
+  TaskStatus FluxesShell(Driver *d, int stage);
   TaskStatus SendFlux(Driver *d, int stage);
   TaskStatus RecvFlux(Driver *d, int stage);
   TaskStatus RKUpdate(Driver *d, int stage);
@@ -172,9 +215,11 @@ class MHD {
   TaskStatus SendE(Driver *d, int stage);
   TaskStatus RecvE(Driver *d, int stage);
   TaskStatus CT(Driver *d, int stage);
+  TaskStatus FusedCT(Driver *d, int stage);
   TaskStatus SendB_OA(Driver *d, int stage);
   TaskStatus RecvB_OA(Driver *d, int stage);
   TaskStatus RestrictB(Driver *d, int stage);
+  TaskStatus RestrictUB(Driver *d, int stage);
   TaskStatus SendB(Driver *d, int stage);
   TaskStatus RecvB(Driver *d, int stage);
   TaskStatus SendB_Shr(Driver *d, int stage);
@@ -182,14 +227,37 @@ class MHD {
   TaskStatus ApplyPhysicalBCs(Driver* pdrive, int stage);
   TaskStatus Prolongate(Driver* pdrive, int stage);
   TaskStatus ConToPrim(Driver *d, int stage);
+  TaskStatus ConToPrimInterior(Driver *d, int stage);
+  TaskStatus ConToPrimShell(Driver *d, int stage);
   TaskStatus NewTimeStep(Driver *d, int stage);
+  // ...in "after_timeintegrator" task list
+  TaskStatus ChemistryStep(Driver *d, int stage);
   // ...in "after_stagen_tl" task list
   TaskStatus ClearSend(Driver *d, int stage);
   TaskStatus ClearRecv(Driver *d, int stage);  // also in Driver::Initialize
+  // ...in "before_sts", "sts", and "after_sts" lists
+  TaskStatus STSInitRecv(Driver *d, int stage);
+  TaskStatus STSFluxes(Driver *d, int stage);
+  TaskStatus STSUpdate(Driver *d, int stage);
+  TaskStatus STSClearSend(Driver *d, int stage);
+  TaskStatus STSClearRecv(Driver *d, int stage);
+
+  // CalculateFluxes function templated over Riemann Solvers, reconstruction, EOS, and
+  // number of variables (0 for any number, otherwise nmhd+nscalars).  Kernel for the
+  // chosen combination is selected once from the flux registry.
+  template <MHD_RSolver T, ReconstructionMethod R, bool ideal, int nvars = 0>
+  void CalculateFluxes(Driver *d, int stage, BlockRegion region);
+  using FluxKernel = void (MHD::*)(Driver *d, int stage, BlockRegion region);
+  FluxKernel SelectFluxKernel();
+  FluxKernel flux_kernel = nullptr;
 
-  // CalculateFluxes function templated over Riemann Solvers
-  template <MHD_RSolver T>
-  void CalculateFluxes(Driver *d, int stage);
+  // RK update templated over the number of dimensions.  Kernel for the dimensionality of
+  // the Mesh is selected once in the constructor.
+  template <int ndim>
+  TaskStatus CartesianRKUpdate(Driver *d, int stage);
+  using UpdateKernel = TaskStatus (MHD::*)(Driver *d, int stage);
+  UpdateKernel SelectUpdateKernel();
+  UpdateKernel update_kernel = nullptr;
 
   // first-order flux correction
   void FOFC(Driver *d, int stage);
@@ -198,6 +266,9 @@ class MHD {
 
  private:
   MeshBlockPack* pmy_pack;   // ptr to MeshBlockPack containing this MHD
+  TaskStatus FluxesInRegion(Driver *d, int stage, BlockRegion region);
+  void ConToPrimInRegion(BlockRegion region);
+  void CellCenterE();
   // temporary variables used to store face-centered electric fields returned by RS
   DvceArray4D<Real> e1_cc, e2_cc, e3_cc;
 };
@@ -24,14 +24,16 @@ namespace mhd {
 //  \brief calculate the corner electric fields.
 
 TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
+  // with fused CT, corner electric fields are computed in CT
+  if (use_fused_ct) return TaskStatus::complete;
+
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
   int ks = indcs.ks, ke = indcs.ke;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-  auto &size = pmy_pack->pmb->mb_size;
-  auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
-  auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  // loop over MBs not entirely excised (all MBs, unless <coord>/skip_excised_blocks)
+  int nmb1 = pmy_pack->pcoord->nmb_unexcised - 1;
+  auto &emb_ = pmy_pack->pcoord->unexcised_mbs;
 
   //---- 1-D problem:
   //  copy face-centered E-fields to edges and return.
@@ -45,7 +47,8 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
     auto e2x1_ = e2x1;
     auto e3x1_ = e3x1;
     par_for("emf1", DevExeSpace(), 0, nmb1, is, ie+1,
-    KOKKOS_LAMBDA(int m, int i) {
+    KOKKOS_LAMBDA(int ma, int i) {
+      const int m = emb_.d_view(ma);
       e2(m,ks  ,js  ,i) = e2x1_(m,ks,js,i);
       e2(m,ke+1,js  ,i) = e2x1_(m,ks,js,i);
       e3(m,ks  ,js  ,i) = e3x1_(m,ks,js,i);
@@ -56,6 +59,209 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
   //---- 2-D problem:
   // Copy face-centered E1 and E2 to edges, use GS07 algorithm to compute E3
 
+  if (pmy_pack->pmesh->two_d) {
+    CellCenterE();
+    auto e3cc_ = e3_cc;
+
+    // capture class variables for the kernels
+    auto e1 = efld.x1e;
+    auto e2 = efld.x2e;
+    auto e3 = efld.x3e;
+    auto e2x1_ = e2x1;
+    auto e3x1_ = e3x1;
+    auto e1x2_ = e1x2;
+    auto e3x2_ = e3x2;
+    auto flx1 = uflx.x1f;
+    auto flx2 = uflx.x2f;
+
+    // integrate E3 to corner using SG07
+    //  Note e1[is:ie,  js:je+1,ks:ke+1]
+    //       e2[is:ie+1,js:je,  ks:ke+1]
+    //       e3[is:ie+1,js:je+1,ks:ke  ]
+    par_for("emf2", DevExeSpace(), 0, nmb1, js, je+1, is, ie+1,
+    KOKKOS_LAMBDA(const int ma, const int j, const int i) {
+      const int m = emb_.d_view(ma);
+      e2(m,ks  ,j,i) = e2x1_(m,ks,j,i);
+      e2(m,ke+1,j,i) = e2x1_(m,ks,j,i);
+      e1(m,ks  ,j,i) = e1x2_(m,ks,j,i);
+      e1(m,ke+1,j,i) = e1x2_(m,ks,j,i);
+
+      Real e3_l2, e3_r2, e3_l1, e3_r1;
+      if (flx1(m,IDN,ks,j-1,i) >= 0.0) {
+        e3_l2 = e3x2_(m,ks,j,i-1) - e3cc_(m,ks,j-1,i-1);
+      } else {
+        e3_l2 = e3x2_(m,ks,j,i  ) - e3cc_(m,ks,j-1,i  );
+      }
+      if (flx1(m,IDN,ks,j,i) >= 0.0) {
+        e3_r2 = e3x2_(m,ks,j,i-1) - e3cc_(m,ks,j  ,i-1);
+      } else {
+        e3_r2 = e3x2_(m,ks,j,i  ) - e3cc_(m,ks,j  ,i  );
+      }
+      if (flx2(m,IDN,ks,j,i-1) >= 0.0) {
+        e3_l1 = e3x1_(m,ks,j-1,i) - e3cc_(m,ks,j-1,i-1);
+      } else {
+        e3_l1 = e3x1_(m,ks,j  ,i) - e3cc_(m,ks,j  ,i-1);
+      }
+      if (flx2(m,IDN,ks,j,i) >= 0.0) {
+        e3_r1 = e3x1_(m,ks,j-1,i) - e3cc_(m,ks,j-1,i  );
+      } else {
+        e3_r1 = e3x1_(m,ks,j  ,i) - e3cc_(m,ks,j  ,i  );
+      }
+      e3(m,ks,j,i) = 0.25*(e3_l1 + e3_r1 + e3_l2 + e3_r2 +
+             e3x2_(m,ks,j,i-1) + e3x2_(m,ks,j,i) + e3x1_(m,ks,j-1,i) + e3x1_(m,ks,j,i));
+    });
+  }
+
+  //---- 3-D problem:
+  // Use GS07 algorithm to compute all three of E1, E2, and E3
+
+  if (pmy_pack->pmesh->three_d) {
+    CellCenterE();
+    auto e1cc_ = e1_cc;
+    auto e2cc_ = e2_cc;
+    auto e3cc_ = e3_cc;
+
+    // capture class variables for the kernels
+    auto e1 = efld.x1e;
+    auto e2 = efld.x2e;
+    auto e3 = efld.x3e;
+    auto e2x1_ = e2x1;
+    auto e3x1_ = e3x1;
+    auto e1x2_ = e1x2;
+    auto e3x2_ = e3x2;
+    auto e1x3_ = e1x3;
+    auto e2x3_ = e2x3;
+    auto flx1 = uflx.x1f;
+    auto flx2 = uflx.x2f;
+    auto flx3 = uflx.x3f;
+
+    // Integrate E1, E2, E3 to corners
+    //  Note e1[is:ie,  js:je+1,ks:ke+1]
+    //       e2[is:ie+1,js:je,  ks:ke+1]
+    //       e3[is:ie+1,js:je+1,ks:ke  ]
+    par_for("emf3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je+1, is, ie+1,
+    KOKKOS_LAMBDA(const int ma, const int k, const int j, const int i) {
+      const int m = emb_.d_view(ma);
+      // integrate E1 to corner using SG07
+      Real e1_l3, e1_r3, e1_l2, e1_r2;
+      if (flx2(m,IDN,k-1,j,i) >= 0.0) {
+        e1_l3 = e1x3_(m,k,j-1,i) - e1cc_(m,k-1,j-1,i);
+      } else {
+        e1_l3 = e1x3_(m,k,j  ,i) - e1cc_(m,k-1,j  ,i);
+      }
+      if (flx2(m,IDN,k,j,i) >= 0.0) {
+        e1_r3 = e1x3_(m,k,j-1,i) - e1cc_(m,k  ,j-1,i);
+      } else {
+        e1_r3 = e1x3_(m,k,j  ,i) - e1cc_(m,k  ,j  ,i);
+      }
+      if (flx3(m,IDN,k,j-1,i) >= 0.0) {
+        e1_l2 = e1x2_(m,k-1,j,i) - e1cc_(m,k-1,j-1,i);
+      } else {
+        e1_l2 = e1x2_(m,k  ,j,i) - e1cc_(m,k  ,j-1,i);
+      }
+      if (flx3(m,IDN,k,j,i) >= 0.0) {
+        e1_r2 = e1x2_(m,k-1,j,i) - e1cc_(m,k-1,j  ,i);
+      } else {
+        e1_r2 = e1x2_(m,k  ,j,i) - e1cc_(m,k  ,j  ,i);
+      }
+      e1(m,k,j,i) = 0.25*(e1_l3 + e1_r3 + e1_l2 + e1_r2 +
+                e1x2_(m,k-1,j,i) + e1x2_(m,k,j,i) + e1x3_(m,k,j-1,i) + e1x3_(m,k,j,i));
+
+      // integrate E2 to corner using SG07
+      Real e2_l3, e2_r3, e2_l1, e2_r1;
+      if (flx1(m,IDN,k-1,j,i) >= 0.0) {
+        e2_l3 = e2x3_(m,k,j,i-1) - e2cc_(m,k-1,j,i-1);
+      } else {
+        e2_l3 = e2x3_(m,k,j,i  ) - e2cc_(m,k-1,j,i  );
+      }
+      if (flx1(m,IDN,k,j,i) >= 0.0) {
+        e2_r3 = e2x3_(m,k,j,i-1) - e2cc_(m,k  ,j,i-1);
+      } else {
+        e2_r3 = e2x3_(m,k,j,i  ) - e2cc_(m,k  ,j,i  );
+      }
+      if (flx3(m,IDN,k,j,i-1) >= 0.0) {
+        e2_l1 = e2x1_(m,k-1,j,i) - e2cc_(m,k-1,j,i-1);
+      } else {
+        e2_l1 = e2x1_(m,k  ,j,i) - e2cc_(m,k  ,j,i-1);
+      }
+      if (flx3(m,IDN,k,j,i) >= 0.0) {
+        e2_r1 = e2x1_(m,k-1,j,i) - e2cc_(m,k-1,j,i  );
+      } else {
+        e2_r1 = e2x1_(m,k  ,j,i) - e2cc_(m,k  ,j,i  );
+      }
+      e2(m,k,j,i) = 0.25*(e2_l3 + e2_r3 + e2_l1 + e2_r1 +
+                e2x3_(m,k,j,i-1) + e2x3_(m,k,j,i) + e2x1_(m,k-1,j,i) + e2x1_(m,k,j,i));
+
+      // integrate E3 to corner using SG07
+      Real e3_l2, e3_r2, e3_l1, e3_r1;
+      if (flx1(m,IDN,k,j-1,i) >= 0.0) {
+        e3_l2 = e3x2_(m,k,j,i-1) - e3cc_(m,k,j-1,i-1);
+      } else {
+        e3_l2 = e3x2_(m,k,j,i  ) - e3cc_(m,k,j-1,i  );
+      }
+      if (flx1(m,IDN,k,j,i) >= 0.0) {
+        e3_r2 = e3x2_(m,k,j,i-1) - e3cc_(m,k,j  ,i-1);
+      } else {
+        e3_r2 = e3x2_(m,k,j,i  ) - e3cc_(m,k,j  ,i  );
+      }
+      if (flx2(m,IDN,k,j,i-1) >= 0.0) {
+        e3_l1 = e3x1_(m,k,j-1,i) - e3cc_(m,k,j-1,i-1);
+      } else {
+        e3_l1 = e3x1_(m,k,j  ,i) - e3cc_(m,k,j  ,i-1);
+      }
+      if (flx2(m,IDN,k,j,i) >= 0.0) {
+        e3_r1 = e3x1_(m,k,j-1,i) - e3cc_(m,k,j-1,i  );
+      } else {
+        e3_r1 = e3x1_(m,k,j  ,i) - e3cc_(m,k,j  ,i  );
+      }
+      e3(m,k,j,i) = 0.25*(e3_l1 + e3_r1 + e3_l2 + e3_r2 +
+                e3x2_(m,k,j,i-1) + e3x2_(m,k,j,i) + e3x1_(m,k,j-1,i) + e3x1_(m,k,j,i));
+    });
+  }
+
+  // Corner electric fields vanish in MBs entirely excised (which are not evolved), so
+  // that their face-centered fields are left unchanged by CT.
+  int nmb_exc = pmy_pack->pcoord->nmb_excised;
+  if (nmb_exc > 0) {
+    auto e1 = efld.x1e;
+    auto e2 = efld.x2e;
+    auto e3 = efld.x3e;
+    auto &xmb_ = pmy_pack->pcoord->excised_mbs;
+    par_for("emf_excised", DevExeSpace(), 0, (nmb_exc-1), ks, ke+1, js, je+1, is, ie+1,
+    KOKKOS_LAMBDA(const int mx, const int k, const int j, const int i) {
+      const int m = xmb_.d_view(mx);
+      if (i <= ie) {e1(m,k,j,i) = 0.0;}
+      if (j <= je) {e2(m,k,j,i) = 0.0;}
+      if (k <= ke) {e3(m,k,j,i) = 0.0;}
+    });
+  }
+
+  // Add resistive electric field (if needed)
+  if (presist != nullptr) {
+    if (presist->eta_ohm > 0.0) {
+      presist->OhmicEField(b0, efld);
+    }
+    // TODO(@user): Add more resistive effects here
+  }
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MHD::CellCenterE
+//  \brief calculate the cell-centered electric fields E = -(v X B) in 2D and 3D, which
+//  are needed by the GS07 algorithm used to integrate E to cell corners.
+
+void MHD::CellCenterE() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
+  auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+
   if (pmy_pack->pmesh->two_d) {
     // Compute cell-centered E3 = -(v X B) = VyBx-VxBy
     auto w0_ = w0;
@@ -151,58 +357,8 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
                           w0_(m,IVX,ks,j,i)*bcc_(m,IBY,ks,j,i);
       });
     }
-
-    // capture class variables for the kernels
-    auto e1 = efld.x1e;
-    auto e2 = efld.x2e;
-    auto e3 = efld.x3e;
-    auto e2x1_ = e2x1;
-    auto e3x1_ = e3x1;
-    auto e1x2_ = e1x2;
-    auto e3x2_ = e3x2;
-    auto flx1 = uflx.x1f;
-    auto flx2 = uflx.x2f;
-
-    // integrate E3 to corner using SG07
-    //  Note e1[is:ie,  js:je+1,ks:ke+1]
-    //       e2[is:ie+1,js:je,  ks:ke+1]
-    //       e3[is:ie+1,js:je+1,ks:ke  ]
-    par_for("emf2", DevExeSpace(), 0, nmb1, js, je+1, is, ie+1,
-    KOKKOS_LAMBDA(const int m, const int j, const int i) {
-      e2(m,ks  ,j,i) = e2x1_(m,ks,j,i);
-      e2(m,ke+1,j,i) = e2x1_(m,ks,j,i);
-      e1(m,ks  ,j,i) = e1x2_(m,ks,j,i);
-      e1(m,ke+1,j,i) = e1x2_(m,ks,j,i);
-
-      Real e3_l2, e3_r2, e3_l1, e3_r1;
-      if (flx1(m,IDN,ks,j-1,i) >= 0.0) {
-        e3_l2 = e3x2_(m,ks,j,i-1) - e3cc_(m,ks,j-1,i-1);
-      } else {
-        e3_l2 = e3x2_(m,ks,j,i  ) - e3cc_(m,ks,j-1,i  );
-      }
-      if (flx1(m,IDN,ks,j,i) >= 0.0) {
-        e3_r2 = e3x2_(m,ks,j,i-1) - e3cc_(m,ks,j  ,i-1);
-      } else {
-        e3_r2 = e3x2_(m,ks,j,i  ) - e3cc_(m,ks,j  ,i  );
-      }
-      if (flx2(m,IDN,ks,j,i-1) >= 0.0) {
-        e3_l1 = e3x1_(m,ks,j-1,i) - e3cc_(m,ks,j-1,i-1);
-      } else {
-        e3_l1 = e3x1_(m,ks,j  ,i) - e3cc_(m,ks,j  ,i-1);
-      }
-      if (flx2(m,IDN,ks,j,i) >= 0.0) {
-        e3_r1 = e3x1_(m,ks,j-1,i) - e3cc_(m,ks,j-1,i  );
-      } else {
-        e3_r1 = e3x1_(m,ks,j  ,i) - e3cc_(m,ks,j  ,i  );
-      }
-      e3(m,ks,j,i) = 0.25*(e3_l1 + e3_r1 + e3_l2 + e3_r2 +
-             e3x2_(m,ks,j,i-1) + e3x2_(m,ks,j,i) + e3x1_(m,ks,j-1,i) + e3x1_(m,ks,j,i));
-    });
   }
 
-  //---- 3-D problem:
-  // Use GS07 algorithm to compute all three of E1, E2, and E3
-
   if (pmy_pack->pmesh->three_d) {
     // Compute cell-centered electric fields
     // E1=-(v X B)=VzBy-VyBz
@@ -316,112 +472,7 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
                          w0_(m,IVX,k,j,i)*bcc_(m,IBY,k,j,i);
       });
     }
-
-    // capture class variables for the kernels
-    auto e1 = efld.x1e;
-    auto e2 = efld.x2e;
-    auto e3 = efld.x3e;
-    auto e2x1_ = e2x1;
-    auto e3x1_ = e3x1;
-    auto e1x2_ = e1x2;
-    auto e3x2_ = e3x2;
-    auto e1x3_ = e1x3;
-    auto e2x3_ = e2x3;
-    auto flx1 = uflx.x1f;
-    auto flx2 = uflx.x2f;
-    auto flx3 = uflx.x3f;
-
-    // Integrate E1, E2, E3 to corners
-    //  Note e1[is:ie,  js:je+1,ks:ke+1]
-    //       e2[is:ie+1,js:je,  ks:ke+1]
-    //       e3[is:ie+1,js:je+1,ks:ke  ]
-    par_for("emf3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je+1, is, ie+1,
-    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-      // integrate E1 to corner using SG07
-      Real e1_l3, e1_r3, e1_l2, e1_r2;
-      if (flx2(m,IDN,k-1,j,i) >= 0.0) {
-        e1_l3 = e1x3_(m,k,j-1,i) - e1cc_(m,k-1,j-1,i);
-      } else {
-        e1_l3 = e1x3_(m,k,j  ,i) - e1cc_(m,k-1,j  ,i);
-      }
-      if (flx2(m,IDN,k,j,i) >= 0.0) {
-        e1_r3 = e1x3_(m,k,j-1,i) - e1cc_(m,k  ,j-1,i);
-      } else {
-        e1_r3 = e1x3_(m,k,j  ,i) - e1cc_(m,k  ,j  ,i);
-      }
-      if (flx3(m,IDN,k,j-1,i) >= 0.0) {
-        e1_l2 = e1x2_(m,k-1,j,i) - e1cc_(m,k-1,j-1,i);
-      } else {
-        e1_l2 = e1x2_(m,k  ,j,i) - e1cc_(m,k  ,j-1,i);
-      }
-      if (flx3(m,IDN,k,j,i) >= 0.0) {
-        e1_r2 = e1x2_(m,k-1,j,i) - e1cc_(m,k-1,j  ,i);
-      } else {
-        e1_r2 = e1x2_(m,k  ,j,i) - e1cc_(m,k  ,j  ,i);
-      }
-      e1(m,k,j,i) = 0.25*(e1_l3 + e1_r3 + e1_l2 + e1_r2 +
-                e1x2_(m,k-1,j,i) + e1x2_(m,k,j,i) + e1x3_(m,k,j-1,i) + e1x3_(m,k,j,i));
-
-      // integrate E2 to corner using SG07
-      Real e2_l3, e2_r3, e2_l1, e2_r1;
-      if (flx1(m,IDN,k-1,j,i) >= 0.0) {
-        e2_l3 = e2x3_(m,k,j,i-1) - e2cc_(m,k-1,j,i-1);
-      } else {
-        e2_l3 = e2x3_(m,k,j,i  ) - e2cc_(m,k-1,j,i  );
-      }
-      if (flx1(m,IDN,k,j,i) >= 0.0) {
-        e2_r3 = e2x3_(m,k,j,i-1) - e2cc_(m,k  ,j,i-1);
-      } else {
-        e2_r3 = e2x3_(m,k,j,i  ) - e2cc_(m,k  ,j,i  );
-      }
-      if (flx3(m,IDN,k,j,i-1) >= 0.0) {
-        e2_l1 = e2x1_(m,k-1,j,i) - e2cc_(m,k-1,j,i-1);
-      } else {
-        e2_l1 = e2x1_(m,k  ,j,i) - e2cc_(m,k  ,j,i-1);
-      }
-      if (flx3(m,IDN,k,j,i) >= 0.0) {
-        e2_r1 = e2x1_(m,k-1,j,i) - e2cc_(m,k-1,j,i  );
-      } else {
-        e2_r1 = e2x1_(m,k  ,j,i) - e2cc_(m,k  ,j,i  );
-      }
-      e2(m,k,j,i) = 0.25*(e2_l3 + e2_r3 + e2_l1 + e2_r1 +
-                e2x3_(m,k,j,i-1) + e2x3_(m,k,j,i) + e2x1_(m,k-1,j,i) + e2x1_(m,k,j,i));
-
-      // integrate E3 to corner using SG07
-      Real e3_l2, e3_r2, e3_l1, e3_r1;
-      if (flx1(m,IDN,k,j-1,i) >= 0.0) {
-        e3_l2 = e3x2_(m,k,j,i-1) - e3cc_(m,k,j-1,i-1);
-      } else {
-        e3_l2 = e3x2_(m,k,j,i  ) - e3cc_(m,k,j-1,i  );
-      }
-      if (flx1(m,IDN,k,j,i) >= 0.0) {
-        e3_r2 = e3x2_(m,k,j,i-1) - e3cc_(m,k,j  ,i-1);
-      } else {
-        e3_r2 = e3x2_(m,k,j,i  ) - e3cc_(m,k,j  ,i  );
-      }
-      if (flx2(m,IDN,k,j,i-1) >= 0.0) {
-        e3_l1 = e3x1_(m,k,j-1,i) - e3cc_(m,k,j-1,i-1);
-      } else {
-        e3_l1 = e3x1_(m,k,j  ,i) - e3cc_(m,k,j  ,i-1);
-      }
-      if (flx2(m,IDN,k,j,i) >= 0.0) {
-        e3_r1 = e3x1_(m,k,j-1,i) - e3cc_(m,k,j-1,i  );
-      } else {
-        e3_r1 = e3x1_(m,k,j  ,i) - e3cc_(m,k,j  ,i  );
-      }
-      e3(m,k,j,i) = 0.25*(e3_l1 + e3_r1 + e3_l2 + e3_r2 +
-                e3x2_(m,k,j,i-1) + e3x2_(m,k,j,i) + e3x1_(m,k,j-1,i) + e3x1_(m,k,j,i));
-    });
-  }
-
-  // Add resistive electric field (if needed)
-  if (presist != nullptr) {
-    if (presist->eta_ohm > 0.0) {
-      presist->OhmicEField(b0, efld);
-    }
-    // TODO(@user): Add more resistive effects here
   }
-
-  return TaskStatus::complete;
+  return;
 }
 } // namespace mhd
@@ -21,6 +21,9 @@ namespace mhd {
 //  Temporal update uses multi-step SSP integrators, e.g. RK2, RK3
 
 TaskStatus MHD::CT(Driver *pdriver, int stage) {
+  // corner electric fields are computed on the fly with fused CT
+  if (use_fused_ct) {return FusedCT(pdriver, stage);}
+
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
@@ -19,12 +19,14 @@
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
 #include "reconstruct/wenoz.hpp"
+#include "reconstruct/flux_registry.hpp"
 #include "mhd/rsolvers/advect_mhd.hpp"
 #include "mhd/rsolvers/llf_mhd.hpp"
 #include "mhd/rsolvers/hlle_mhd.hpp"
 #include "mhd/rsolvers/hlld_mhd.hpp"
 #include "mhd/rsolvers/llf_srmhd.hpp"
 #include "mhd/rsolvers/hlle_srmhd.hpp"
+#include "mhd/rsolvers/hlld_srmhd.hpp"
 #include "mhd/rsolvers/llf_grmhd.hpp"
 #include "mhd/rsolvers/hlle_grmhd.hpp"
 // #include "mhd/rsolvers/roe_mhd.hpp"
@@ -34,24 +36,30 @@ namespace mhd {
 //! \fn void MHD::CalculateFlux
 //! \brief Calculate fluxes of conserved variables, and face-centered area-averaged EMFs
 //! for evolution of magnetic field
-//! Note this function is templated over RS for better performance on GPUs.
-
-template <MHD_RSolver rsolver_method_>
-void MHD::CalculateFluxes(Driver *pdriver, int stage) {
+//! Note this function is templated over RS, reconstruction method, and EOS (ideal or
+//! isothermal) for better performance on GPUs: the switch over reconstruction methods
+//! and the EOS branches in the RS are resolved at compile time.  When nvars_>0 it is
+//! the number of variables nmhd+nscalars, so loops over variables in reconstruction
+//! have a fixed trip count and can be unrolled.  Cell-centered fields always have 3.
+//! Fluxes are computed only on faces in the requested region of each MeshBlock, where
+//! interior faces are those whose reconstruction stencils do not involve ghost zones.
+
+template <MHD_RSolver rsolver_method_, ReconstructionMethod recon_method_, bool ideal_,
+          int nvars_>
+void MHD::CalculateFluxes(Driver *pdriver, int stage, BlockRegion region) {
   RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
   int is = indcs_.is, ie = indcs_.ie;
   int js = indcs_.js, je = indcs_.je;
   int ks = indcs_.ks, ke = indcs_.ke;
+  int ng = indcs_.ng;
   int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
 
   int &nmhd_ = nmhd;
-  int nvars = nmhd + nscalars;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-  const auto recon_method_ = recon_method;
-  bool extrema = false;
-  if (recon_method == ReconstructionMethod::ppmx) {
-    extrema = true;
-  }
+  int nvars = (nvars_ > 0)? nvars_ : nmhd + nscalars;
+  // loop over MBs not entirely excised (all MBs, unless <coord>/skip_excised_blocks)
+  int nmb1 = pmy_pack->pcoord->nmb_unexcised - 1;
+  auto &emb_ = pmy_pack->pcoord->unexcised_mbs;
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
 
   auto &eos_ = peos->eos_data;
   auto &size_ = pmy_pack->pmb->mb_size;
@@ -82,8 +90,18 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
   int il = is, iu = ie+1;
   if (use_fofc) { il = is-1, iu = ie+2; }
 
+  // compute fluxes on faces in requested region, possibly split into boxes
+  IndexBox fbox[6];
+  int nbox = BlockRegionBoxes(region, {il, iu, jl, ju, kl, ku},
+                              {is+ng, ie+1-ng, js, je, ks, ke}, fbox);
+  for (int b=0; b<nbox; ++b) {
+  il = fbox[b].il, iu = fbox[b].iu;
+  jl = fbox[b].jl, ju = fbox[b].ju;
+  kl = fbox[b].kl, ku = fbox[b].ku;
+  int sil = (il > is)? il : is, siu = (iu < ie+1)? iu : ie+1;  // limits for scalars
   par_for_outer("mhd_flux1",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku, jl, ju,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+  KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int k, const int j) {
+    const int m = emb_.d_view(ma);
     ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
     ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
     ScrArray2D<Real> bl(member.team_scratch(scr_level), 3, ncells1);
@@ -92,21 +110,23 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
     // Reconstruct qR[i] and qL[i+1], for both W and Bcc
     switch (recon_method_) {
       case ReconstructionMethod::dc:
-        DonorCellX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        DonorCellX1(member, m, k, j, il-1, iu, b0_, bl, br);
+        DonorCellX1<nvars_>(member, m, k, j, il-1, iu, w0_, wl, wr);
+        DonorCellX1<3>(member, m, k, j, il-1, iu, b0_, bl, br);
         break;
       case ReconstructionMethod::plm:
-        PiecewiseLinearX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        PiecewiseLinearX1(member, m, k, j, il-1, iu, b0_, bl, br);
+        PiecewiseLinearX1<nvars_>(member, m, k, j, il-1, iu, w0_, wl, wr);
+        PiecewiseLinearX1<3>(member, m, k, j, il-1, iu, b0_, bl, br);
         break;
       case ReconstructionMethod::ppm4:
       case ReconstructionMethod::ppmx:
-        PiecewiseParabolicX1(member,eos_,extrema,true,  m, k, j, il-1, iu, w0_, wl, wr);
-        PiecewiseParabolicX1(member,eos_,extrema,false, m, k, j, il-1, iu, b0_, bl, br);
+        PiecewiseParabolicX1<nvars_>(member,eos_,extrema,true,  m, k, j, il-1, iu, w0_,
+                                     wl, wr);
+        PiecewiseParabolicX1<3>(member,eos_,extrema,false, m, k, j, il-1, iu, b0_, bl,
+                                br);
         break;
       case ReconstructionMethod::wenoz:
-        WENOZX1(member, eos_, true,  m, k, j, il-1, iu, w0_, wl, wr);
-        WENOZX1(member, eos_, false, m, k, j, il-1, iu, b0_, bl, br);
+        WENOZX1<nvars_>(member, eos_, true,  m, k, j, il-1, iu, w0_, wl, wr);
+        WENOZX1<3>(member, eos_, false, m, k, j, il-1, iu, b0_, bl, br);
         break;
       default:
         break;
@@ -119,6 +139,7 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
     // (IBZ) component of flx = E_{y} = -(v x B)_{y} =  (v1*b3 - v3*b1)
     // NOTE(@pdmullen): Capture variables prior to if constexpr.  Required for cuda 11.6+.
     auto eos = eos_;
+    eos.is_ideal = ideal_;
     auto indcs = indcs_;
     auto size = size_;
     auto coord = coord_;
@@ -138,6 +159,8 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
       LLF_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
     } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_sr) {
       HLLE_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
+    } else if constexpr (rsolver_method_ == MHD_RSolver::hlld_sr) {
+      HLLD_SR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
     } else if constexpr (rsolver_method_ == MHD_RSolver::llf_gr) {
       LLF_GR(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx1,e31,e21);
     } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_gr) {
@@ -148,7 +171,7 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
     // calculate fluxes of scalars (if any)
     if (nvars > nmhd_) {
       for (int n=nmhd_; n<nvars; ++n) {
-        par_for_inner(member, is, ie+1, [&](const int i) {
+        par_for_inner(member, sil, siu, [&](const int i) {
           if (flx1_(m,IDN,k,j,i) >= 0.0) {
             flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wl(n,i);
           } else {
@@ -158,6 +181,7 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
       }
     }
   });
+  } // end loop over boxes
 
   //--------------------------------------------------------------------------------------
   // j-direction
@@ -179,8 +203,18 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
     jl = js-1, ju = je+1;
     if (use_fofc) { jl = js-2, ju = je+2; }
 
+    il = is-1, iu = ie+1;
+    // compute fluxes on faces in requested region, possibly split into boxes
+    int nbox = BlockRegionBoxes(region, {il, iu, jl+1, ju, kl, ku},
+                                {is, ie, js+ng, je+1-ng, ks, ke}, fbox);
+    for (int b=0; b<nbox; ++b) {
+    il = fbox[b].il, iu = fbox[b].iu;
+    jl = fbox[b].jl-1, ju = fbox[b].ju;  // loop over j starts at jl-1
+    kl = fbox[b].kl, ku = fbox[b].ku;
+    int sil = (il > is)? il : is, siu = (iu < ie)? iu : ie;  // limits for scalars
     par_for_outer("mhd_flux2",DevExeSpace(),scr_size,scr_level,0,nmb1, kl, ku,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+    KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int k) {
+      const int m = emb_.d_view(ma);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -206,21 +240,22 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
         // Reconstruct qR[j] and qL[j+1], for both W and Bcc
         switch (recon_method_) {
           case ReconstructionMethod::dc:
-            DonorCellX2(member, m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
-            DonorCellX2(member, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
+            DonorCellX2<nvars_>(member, m, k, j, il, iu, w0_, wl_jp1, wr);
+            DonorCellX2<3>(member, m, k, j, il, iu, b0_, bl_jp1, br);
             break;
           case ReconstructionMethod::plm:
-            PiecewiseLinearX2(member, m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
-            PiecewiseLinearX2(member, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
+            PiecewiseLinearX2<nvars_>(member, m, k, j, il, iu, w0_, wl_jp1, wr);
+            PiecewiseLinearX2<3>(member, m, k, j, il, iu, b0_, bl_jp1, br);
             break;
           case ReconstructionMethod::ppm4:
           case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX2(member,eos_,extrema,true, m,k,j,is-1,ie+1,w0_,wl_jp1,wr);
-            PiecewiseParabolicX2(member,eos_,extrema,false,m,k,j,is-1,ie+1,b0_,bl_jp1,br);
+            PiecewiseParabolicX2<nvars_>(member,eos_,extrema,true, m,k,j,il,iu,w0_,
+                                         wl_jp1,wr);
+            PiecewiseParabolicX2<3>(member,eos_,extrema,false,m,k,j,il,iu,b0_,bl_jp1,br);
             break;
           case ReconstructionMethod::wenoz:
-            WENOZX2(member, eos_, true,  m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
-            WENOZX2(member, eos_, false, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
+            WENOZX2<nvars_>(member, eos_, true,  m, k, j, il, iu, w0_, wl_jp1, wr);
+            WENOZX2<3>(member, eos_, false, m, k, j, il, iu, b0_, bl_jp1, br);
             break;
           default:
             break;
@@ -233,6 +268,7 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
         if (j>jl) {
           // NOTE(@pdmullen): Capture variables prior to if constexpr.
           auto eos = eos_;
+          eos.is_ideal = ideal_;
           auto indcs = indcs_;
           auto size = size_;
           auto coord = coord_;
@@ -242,36 +278,39 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
           auto e32 = e32_;
           if constexpr (rsolver_method_ == MHD_RSolver::advect) {
             Advect(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+                    m,k,j,il,iu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
           } else if constexpr (rsolver_method_ == MHD_RSolver::llf) {
             LLF(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+                    m,k,j,il,iu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
           } else if constexpr (rsolver_method_ == MHD_RSolver::hlle) {
             HLLE(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+                    m,k,j,il,iu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
           } else if constexpr (rsolver_method_ == MHD_RSolver::hlld) {
             HLLD(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+                    m,k,j,il,iu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
           } else if constexpr (rsolver_method_ == MHD_RSolver::llf_sr) {
             LLF_SR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+                    m,k,j,il,iu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
           } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_sr) {
             HLLE_SR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+                    m,k,j,il,iu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+          } else if constexpr (rsolver_method_ == MHD_RSolver::hlld_sr) {
+            HLLD_SR(member,eos,indcs,size,coord,
+                    m,k,j,il,iu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
           } else if constexpr (rsolver_method_ == MHD_RSolver::llf_gr) {
             LLF_GR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+                    m,k,j,il,iu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
           } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_gr) {
             HLLE_GR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVY,wl,wr,bl,br,by,flx2,e12,e32);
+                    m,k,j,il,iu,IVY,wl,wr,bl,br,by,flx2,e12,e32);
           }
           member.team_barrier();
         }
 
         // calculate fluxes of scalars (if any)
-        if (nvars > nmhd_) {
+        if ((nvars > nmhd_) && (j>jl)) {
           for (int n=nmhd_; n<nvars; ++n) {
-            par_for_inner(member, is, ie, [&](const int i) {
+            par_for_inner(member, sil, siu, [&](const int i) {
               if (flx2_(m,IDN,k,j,i) >= 0.0) {
                 flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wl(n,i);
               } else {
@@ -282,6 +321,7 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
         }
       } // end of loop over j
     });
+    } // end loop over boxes
   }
 
   //--------------------------------------------------------------------------------------
@@ -299,8 +339,18 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
     kl = ks-1, ku = ke+1;
     if (use_fofc) { kl = ks-2, ku = ke+2; }
 
-    par_for_outer("mhd_flux3",DevExeSpace(), scr_size, scr_level, 0, nmb1, js-1, je+1,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int j) {
+    il = is-1, iu = ie+1, jl = js-1, ju = je+1;
+    // compute fluxes on faces in requested region, possibly split into boxes
+    int nbox = BlockRegionBoxes(region, {il, iu, jl, ju, kl+1, ku},
+                                {is, ie, js, je, ks+ng, ke+1-ng}, fbox);
+    for (int b=0; b<nbox; ++b) {
+    il = fbox[b].il, iu = fbox[b].iu;
+    jl = fbox[b].jl, ju = fbox[b].ju;
+    kl = fbox[b].kl-1, ku = fbox[b].ku;  // loop over k starts at kl-1
+    int sil = (il > is)? il : is, siu = (iu < ie)? iu : ie;  // limits for scalars
+    par_for_outer("mhd_flux3",DevExeSpace(), scr_size, scr_level, 0, nmb1, jl, ju,
+    KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int j) {
+      const int m = emb_.d_view(ma);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -326,21 +376,22 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
         // Reconstruct qR[k] and qL[k+1], for both W and Bcc
         switch (recon_method_) {
           case ReconstructionMethod::dc:
-            DonorCellX3(member, m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
-            DonorCellX3(member, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
+            DonorCellX3<nvars_>(member, m, k, j, il, iu, w0_, wl_kp1, wr);
+            DonorCellX3<3>(member, m, k, j, il, iu, b0_, bl_kp1, br);
             break;
           case ReconstructionMethod::plm:
-            PiecewiseLinearX3(member, m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
-            PiecewiseLinearX3(member, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
+            PiecewiseLinearX3<nvars_>(member, m, k, j, il, iu, w0_, wl_kp1, wr);
+            PiecewiseLinearX3<3>(member, m, k, j, il, iu, b0_, bl_kp1, br);
             break;
           case ReconstructionMethod::ppm4:
           case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX3(member,eos_,extrema,true, m,k,j,is-1,ie+1,w0_,wl_kp1,wr);
-            PiecewiseParabolicX3(member,eos_,extrema,false,m,k,j,is-1,ie+1,b0_,bl_kp1,br);
+            PiecewiseParabolicX3<nvars_>(member,eos_,extrema,true, m,k,j,il,iu,w0_,
+                                         wl_kp1,wr);
+            PiecewiseParabolicX3<3>(member,eos_,extrema,false,m,k,j,il,iu,b0_,bl_kp1,br);
             break;
           case ReconstructionMethod::wenoz:
-            WENOZX3(member, eos_, true,  m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
-            WENOZX3(member, eos_, false, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
+            WENOZX3<nvars_>(member, eos_, true,  m, k, j, il, iu, w0_, wl_kp1, wr);
+            WENOZX3<3>(member, eos_, false, m, k, j, il, iu, b0_, bl_kp1, br);
             break;
           default:
             break;
@@ -353,6 +404,7 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
         if (k>kl) {
           // NOTE(@pdmullen): Capture variables prior to if constexpr.
           auto eos = eos_;
+          eos.is_ideal = ideal_;
           auto indcs = indcs_;
           auto size = size_;
           auto coord = coord_;
@@ -362,36 +414,39 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
           auto e13 = e13_;
           if constexpr (rsolver_method_ == MHD_RSolver::advect) {
             Advect(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+                    m,k,j,il,iu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
           } else if constexpr (rsolver_method_ == MHD_RSolver::llf) {
             LLF(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+                    m,k,j,il,iu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
           } else if constexpr (rsolver_method_ == MHD_RSolver::hlle) {
             HLLE(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+                    m,k,j,il,iu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
           } else if constexpr (rsolver_method_ == MHD_RSolver::hlld) {
             HLLD(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+                    m,k,j,il,iu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
           } else if constexpr (rsolver_method_ == MHD_RSolver::llf_sr) {
             LLF_SR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+                    m,k,j,il,iu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
           } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_sr) {
             HLLE_SR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+                    m,k,j,il,iu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+          } else if constexpr (rsolver_method_ == MHD_RSolver::hlld_sr) {
+            HLLD_SR(member,eos,indcs,size,coord,
+                    m,k,j,il,iu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
           } else if constexpr (rsolver_method_ == MHD_RSolver::llf_gr) {
             LLF_GR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+                    m,k,j,il,iu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
           } else if constexpr (rsolver_method_ == MHD_RSolver::hlle_gr) {
             HLLE_GR(member,eos,indcs,size,coord,
-                    m,k,j,is-1,ie+1,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
+                    m,k,j,il,iu,IVZ,wl,wr,bl,br,bz,flx3,e23,e13);
           }
           member.team_barrier();
         }
 
         // calculate fluxes of scalars (if any)
-        if (nvars > nmhd_) {
+        if ((nvars > nmhd_) && (k>kl)) {
           for (int n=nmhd_; n<nvars; ++n) {
-            par_for_inner(member, is, ie, [&](const int i) {
+            par_for_inner(member, sil, siu, [&](const int i) {
               if (flx3_(m,IDN,k,j,i) >= 0.0) {
                 flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wl(n,i);
               } else {
@@ -402,19 +457,48 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
         }
       } // end loop over k
     });
+    } // end loop over boxes
   }
 
   return;
 }
 
-// function definitions for each template parameter
-template void MHD::CalculateFluxes<MHD_RSolver::advect>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::llf>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::hlle>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::hlld>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::llf_sr>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::hlle_sr>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::llf_gr>(Driver *pdriver, int stage);
-template void MHD::CalculateFluxes<MHD_RSolver::hlle_gr>(Driver *pdriver, int stage);
+//----------------------------------------------------------------------------------------
+//! \fn MHD::FluxKernel MHD::SelectFluxKernel
+//! \brief Returns the CalculateFluxes kernel for the Riemann solver, reconstruction
+//! method, and EOS of this MHD, or nullptr if that combination was not compiled.
+//! Kernels specialized for the number of variables are used when one is compiled, the
+//! generic kernel otherwise.
+//! Expanding this table also instantiates every kernel that is compiled.
+
+#define MHD_FLUX_KERNEL_NV(RS, EOS, RC, NV)                                          \
+  if (rsolver_method == RS && recon_method == RC && ideal == EOS && nvars == NV) {   \
+    return &MHD::CalculateFluxes<RS, RC, EOS, NV>;                                   \
+  }
+#define MHD_FLUX_KERNEL(RS, EOS, RC)                                    \
+  FLUX_FOR_EACH_NVARS(MHD_FLUX_KERNEL_NV, RS, EOS, RC)                  \
+  if (rsolver_method == RS && recon_method == RC && ideal == EOS) {     \
+    return &MHD::CalculateFluxes<RS, RC, EOS, 0>;                       \
+  }
+
+MHD::FluxKernel MHD::SelectFluxKernel() {
+  // only these RS depend on the EOS, all others are compiled once (with ideal=true)
+  bool ideal = true;
+  if (rsolver_method == MHD_RSolver::llf || rsolver_method == MHD_RSolver::hlle ||
+      rsolver_method == MHD_RSolver::hlld) {
+    ideal = peos->eos_data.is_ideal;
+  }
+  int nvars = nmhd + nscalars;
+  FLUX_FOR_EACH_RECON(MHD_FLUX_KERNEL, MHD_RSolver::advect, true)
+  FLUX_FOR_EACH_EOS(FLUX_FOR_EACH_RECON, MHD_FLUX_KERNEL, MHD_RSolver::llf)
+  FLUX_FOR_EACH_EOS(FLUX_FOR_EACH_RECON, MHD_FLUX_KERNEL, MHD_RSolver::hlle)
+  FLUX_FOR_EACH_EOS(FLUX_FOR_EACH_RECON, MHD_FLUX_KERNEL, MHD_RSolver::hlld)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, MHD_FLUX_KERNEL, MHD_RSolver::llf_sr)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, MHD_FLUX_KERNEL, MHD_RSolver::hlle_sr)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, MHD_FLUX_KERNEL, MHD_RSolver::hlld_sr)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, MHD_FLUX_KERNEL, MHD_RSolver::llf_gr)
+  FLUX_FOR_IDEAL_EOS(FLUX_FOR_EACH_RECON, MHD_FLUX_KERNEL, MHD_RSolver::hlle_gr)
+  return nullptr;
+}
 
 } // namespace mhd
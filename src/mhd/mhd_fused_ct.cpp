@@ -0,0 +1,270 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file mhd_fused_ct.cpp
+//! \brief Fused integration of electric fields to cell corners (GS07 algorithm, as in
+//! CornerE) and CT update of face-centered magnetic fields.  Corner electric fields are
+//! computed in team scratch memory and used directly to update the face fields, so that
+//! the edge-centered array efld is never written to, or read from, global memory.  Can
+//! only be used when the corner fields need not be synchronized between MeshBlocks (no
+//! SMR/AMR, shearing box, or resistivity), since then the same-level flux correction of
+//! E performed by SendE/RecvE does not change them.
+
+#include <iostream>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "mhd.hpp"
+
+namespace mhd {
+//----------------------------------------------------------------------------------------
+//! \fn Real CornerE1, CornerE2, CornerE3
+//! \brief Integrate E1, E2, E3 to corner (m,k,j,i) using GS07 in 3D.  Arithmetic is
+//! identical to that in CornerE() so that results are unchanged by the fused update.
+//! CornerE3() is also used in 2D, with k=ks.
+
+KOKKOS_INLINE_FUNCTION
+Real CornerE1(const int m, const int k, const int j, const int i,
+              const DvceArray5D<FluxReal> &flx2, const DvceArray5D<FluxReal> &flx3,
+              const DvceArray4D<Real> &e1x2_, const DvceArray4D<Real> &e1x3_,
+              const DvceArray4D<Real> &e1cc_) {
+  Real e1_l3, e1_r3, e1_l2, e1_r2;
+  if (flx2(m,IDN,k-1,j,i) >= 0.0) {
+    e1_l3 = e1x3_(m,k,j-1,i) - e1cc_(m,k-1,j-1,i);
+  } else {
+    e1_l3 = e1x3_(m,k,j  ,i) - e1cc_(m,k-1,j  ,i);
+  }
+  if (flx2(m,IDN,k,j,i) >= 0.0) {
+    e1_r3 = e1x3_(m,k,j-1,i) - e1cc_(m,k  ,j-1,i);
+  } else {
+    e1_r3 = e1x3_(m,k,j  ,i) - e1cc_(m,k  ,j  ,i);
+  }
+  if (flx3(m,IDN,k,j-1,i) >= 0.0) {
+    e1_l2 = e1x2_(m,k-1,j,i) - e1cc_(m,k-1,j-1,i);
+  } else {
+    e1_l2 = e1x2_(m,k  ,j,i) - e1cc_(m,k  ,j-1,i);
+  }
+  if (flx3(m,IDN,k,j,i) >= 0.0) {
+    e1_r2 = e1x2_(m,k-1,j,i) - e1cc_(m,k-1,j  ,i);
+  } else {
+    e1_r2 = e1x2_(m,k  ,j,i) - e1cc_(m,k  ,j  ,i);
+  }
+  return 0.25*(e1_l3 + e1_r3 + e1_l2 + e1_r2 +
+               e1x2_(m,k-1,j,i) + e1x2_(m,k,j,i) + e1x3_(m,k,j-1,i) + e1x3_(m,k,j,i));
+}
+
+KOKKOS_INLINE_FUNCTION
+Real CornerE2(const int m, const int k, const int j, const int i,
+              const DvceArray5D<FluxReal> &flx1, const DvceArray5D<FluxReal> &flx3,
+              const DvceArray4D<Real> &e2x1_, const DvceArray4D<Real> &e2x3_,
+              const DvceArray4D<Real> &e2cc_) {
+  Real e2_l3, e2_r3, e2_l1, e2_r1;
+  if (flx1(m,IDN,k-1,j,i) >= 0.0) {
+    e2_l3 = e2x3_(m,k,j,i-1) - e2cc_(m,k-1,j,i-1);
+  } else {
+    e2_l3 = e2x3_(m,k,j,i  ) - e2cc_(m,k-1,j,i  );
+  }
+  if (flx1(m,IDN,k,j,i) >= 0.0) {
+    e2_r3 = e2x3_(m,k,j,i-1) - e2cc_(m,k  ,j,i-1);
+  } else {
+    e2_r3 = e2x3_(m,k,j,i  ) - e2cc_(m,k  ,j,i  );
+  }
+  if (flx3(m,IDN,k,j,i-1) >= 0.0) {
+    e2_l1 = e2x1_(m,k-1,j,i) - e2cc_(m,k-1,j,i-1);
+  } else {
+    e2_l1 = e2x1_(m,k  ,j,i) - e2cc_(m,k  ,j,i-1);
+  }
+  if (flx3(m,IDN,k,j,i) >= 0.0) {
+    e2_r1 = e2x1_(m,k-1,j,i) - e2cc_(m,k-1,j,i  );
+  } else {
+    e2_r1 = e2x1_(m,k  ,j,i) - e2cc_(m,k  ,j,i  );
+  }
+  return 0.25*(e2_l3 + e2_r3 + e2_l1 + e2_r1 +
+               e2x3_(m,k,j,i-1) + e2x3_(m,k,j,i) + e2x1_(m,k-1,j,i) + e2x1_(m,k,j,i));
+}
+
+KOKKOS_INLINE_FUNCTION
+Real CornerE3(const int m, const int k, const int j, const int i,
+              const DvceArray5D<FluxReal> &flx1, const DvceArray5D<FluxReal> &flx2,
+              const DvceArray4D<Real> &e3x1_, const DvceArray4D<Real> &e3x2_,
+              const DvceArray4D<Real> &e3cc_) {
+  Real e3_l2, e3_r2, e3_l1, e3_r1;
+  if (flx1(m,IDN,k,j-1,i) >= 0.0) {
+    e3_l2 = e3x2_(m,k,j,i-1) - e3cc_(m,k,j-1,i-1);
+  } else {
+    e3_l2 = e3x2_(m,k,j,i  ) - e3cc_(m,k,j-1,i  );
+  }
+  if (flx1(m,IDN,k,j,i) >= 0.0) {
+    e3_r2 = e3x2_(m,k,j,i-1) - e3cc_(m,k,j  ,i-1);
+  } else {
+    e3_r2 = e3x2_(m,k,j,i  ) - e3cc_(m,k,j  ,i  );
+  }
+  if (flx2(m,IDN,k,j,i-1) >= 0.0) {
+    e3_l1 = e3x1_(m,k,j-1,i) - e3cc_(m,k,j-1,i-1);
+  } else {
+    e3_l1 = e3x1_(m,k,j  ,i) - e3cc_(m,k,j  ,i-1);
+  }
+  if (flx2(m,IDN,k,j,i) >= 0.0) {
+    e3_r1 = e3x1_(m,k,j-1,i) - e3cc_(m,k,j-1,i  );
+  } else {
+    e3_r1 = e3x1_(m,k,j  ,i) - e3cc_(m,k,j  ,i  );
+  }
+  return 0.25*(e3_l1 + e3_r1 + e3_l2 + e3_r2 +
+               e3x2_(m,k,j,i-1) + e3x2_(m,k,j,i) + e3x1_(m,k,j-1,i) + e3x1_(m,k,j,i));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MHD::FusedCT
+//! \brief CT update of face-centered fields with corner electric fields computed on the
+//! fly.  Each team updates face fields in a tile of <mhd>/fused_ct_tile_nx2 rows of one
+//! (m,k) plane, looping over j.  E1 and E3 on the upper edges of each row are carried to
+//! the next row, so only the first row of each tile recomputes them.  E1 and E2 in
+//! plane k+1 are computed again by the team for the next plane.  Only for 2D/3D.
+
+TaskStatus MHD::FusedCT(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+
+  // cell-centered electric fields are stored in global memory, as for CornerE
+  CellCenterE();
+
+  // capture class variables for the kernels
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto e2x1_ = e2x1;
+  auto e3x1_ = e3x1;
+  auto e1x2_ = e1x2;
+  auto e3x2_ = e3x2;
+  auto e1x3_ = e1x3;
+  auto e2x3_ = e2x3;
+  auto e1cc_ = e1_cc;
+  auto e2cc_ = e2_cc;
+  auto e3cc_ = e3_cc;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto bx1f = b0.x1f;
+  auto bx2f = b0.x2f;
+  auto bx3f = b0.x3f;
+  auto bx1f_old = b1.x1f;
+  auto bx2f_old = b1.x2f;
+  auto bx3f_old = b1.x3f;
+
+  int tnj = ct_tile_nx2;
+  int ntj = (indcs.nx2 + tnj - 1)/tnj;
+
+  // scratch arrays: 2 each for E1 and E3 on lower/upper edges of row, 1 for E1 in plane
+  // k+1, and 2 for E2 in planes k and k+1
+  size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1) * 7;
+  int scr_level = 0;
+  par_for_outer("fused_ct",DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ke+1,
+                0, ntj-1,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int tj) {
+    ScrArray1D<Real> e1a(member.team_scratch(scr_level), ncells1);
+    ScrArray1D<Real> e1b(member.team_scratch(scr_level), ncells1);
+    ScrArray1D<Real> e3a(member.team_scratch(scr_level), ncells1);
+    ScrArray1D<Real> e3b(member.team_scratch(scr_level), ncells1);
+    ScrArray1D<Real> e1kp1(member.team_scratch(scr_level), ncells1);
+    ScrArray1D<Real> e2k(member.team_scratch(scr_level), ncells1);
+    ScrArray1D<Real> e2kp1(member.team_scratch(scr_level), ncells1);
+
+    // rows of faces in this tile, plus upper x2-face of MeshBlock in last tile
+    int jl = js + tj*tnj, ju = (jl + tnj - 1 < je)? (jl + tnj - 1) : je;
+    int jfu = (ju == je)? je+1 : ju;
+    // B1 and B2 are only updated in planes [ks,ke], B3 in planes [ks,ke+1]
+    bool kface = (k <= ke);
+
+    // E1 and E3 on lower edges of first row
+    {
+      auto e1lo = ((jl%2) == 0)? e1a : e1b;
+      auto e3lo = ((jl%2) == 0)? e3a : e3b;
+      par_for_inner(member, is, ie+1, [&](const int i) {
+        if (i <= ie) {
+          e1lo(i) = (three_d)? CornerE1(m,k,jl,i,flx2,flx3,e1x2_,e1x3_,e1cc_) :
+                               e1x2_(m,ks,jl,i);
+        }
+        if (kface) {
+          e3lo(i) = CornerE3(m,k,jl,i,flx1,flx2,e3x1_,e3x2_,e3cc_);
+        }
+      });
+    }
+
+    for (int j=jl; j<=jfu; ++j) {
+      // Permute scratch arrays.  Edges at j are stored in "lo", and at j+1 in "hi".
+      auto e1lo = e1a;
+      auto e1hi = e1b;
+      auto e3lo = e3a;
+      auto e3hi = e3b;
+      if ((j%2) != 0) {
+        e1lo = e1b;
+        e1hi = e1a;
+        e3lo = e3b;
+        e3hi = e3a;
+      }
+
+      // compute remaining corner electric fields needed to update row
+      par_for_inner(member, is, ie+1, [&](const int i) {
+        if (j <= ju) {
+          if (i <= ie) {
+            e1hi(i) = (three_d)? CornerE1(m,k,j+1,i,flx2,flx3,e1x2_,e1x3_,e1cc_) :
+                                 e1x2_(m,ks,j+1,i);
+          }
+          e2k(i) = (three_d)? CornerE2(m,k,j,i,flx1,flx3,e2x1_,e2x3_,e2cc_) :
+                              e2x1_(m,ks,j,i);
+          if (kface) {
+            e3hi(i) = CornerE3(m,k,j+1,i,flx1,flx2,e3x1_,e3x2_,e3cc_);
+            if (three_d) {
+              e2kp1(i) = CornerE2(m,k+1,j,i,flx1,flx3,e2x1_,e2x3_,e2cc_);
+            }
+          }
+        }
+        if (kface && three_d && (i <= ie)) {
+          e1kp1(i) = CornerE1(m,k+1,j,i,flx2,flx3,e1x2_,e1x3_,e1cc_);
+        }
+      });
+      member.team_barrier();
+
+      // update faces in row, with same arithmetic as CT()
+      Real &dx1 = mbsize.d_view(m).dx1;
+      Real &dx2 = mbsize.d_view(m).dx2;
+      Real &dx3 = mbsize.d_view(m).dx3;
+      par_for_inner(member, is, ie+1, [&](const int i) {
+        if (kface && (j <= ju)) {
+          bx1f(m,k,j,i) = gam0*bx1f(m,k,j,i) + gam1*bx1f_old(m,k,j,i);
+          bx1f(m,k,j,i) -= beta_dt*(e3hi(i) - e3lo(i))/dx2;
+          if (three_d) {
+            bx1f(m,k,j,i) += beta_dt*(e2kp1(i) - e2k(i))/dx3;
+          }
+        }
+        if (i <= ie) {
+          if (kface) {
+            bx2f(m,k,j,i) = gam0*bx2f(m,k,j,i) + gam1*bx2f_old(m,k,j,i);
+            bx2f(m,k,j,i) += beta_dt*(e3lo(i+1) - e3lo(i))/dx1;
+            if (three_d) {
+              bx2f(m,k,j,i) -= beta_dt*(e1kp1(i) - e1lo(i))/dx3;
+            }
+          }
+          if (j <= ju) {
+            bx3f(m,k,j,i) = gam0*bx3f(m,k,j,i) + gam1*bx3f_old(m,k,j,i);
+            bx3f(m,k,j,i) -= beta_dt*(e2k(i+1) - e2k(i))/dx1;
+            bx3f(m,k,j,i) += beta_dt*(e1hi(i) - e1lo(i))/dx2;
+          }
+        }
+      });
+      member.team_barrier();
+    } // end of loop over j
+  });
+
+  return TaskStatus::complete;
+}
+} // namespace mhd
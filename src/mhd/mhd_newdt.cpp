@@ -51,9 +51,15 @@ TaskStatus MHD::NewTimeStep(Driver *pdriver, int stage) {
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
 
-  if (pdriver->time_evolution == TimeEvolution::kinematic) {
+  if (peos->newdt_done) {
+    // signal speeds already reduced in ConsToPrim of this stage (fused_newdt)
+    dt1 = peos->newdt[0];
+    dt2 = peos->newdt[1];
+    dt3 = peos->newdt[2];
+    peos->newdt_done = false;
+  } else if (pdriver->time_evolution == TimeEvolution::kinematic) {
     // find smallest (dx/v) in each direction for advection problems
-    Kokkos::parallel_reduce("MHDNudt1",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    Kokkos::parallel_reduce("MHDNudt1",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
     KOKKOS_LAMBDA(const int &idx, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
       // compute m,k,j,i indices of thread and call function
       int m = (idx)/nkji;
@@ -71,7 +77,7 @@ TaskStatus MHD::NewTimeStep(Driver *pdriver, int stage) {
     // find smallest dx/(v +/- Cf) in each direction for mhd problems
     auto &bcc0_ = bcc0;
 
-    Kokkos::parallel_reduce("MHDNudt2",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    Kokkos::parallel_reduce("MHDNudt2",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
     KOKKOS_LAMBDA(const int &idx, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
       // compute m,k,j,i indices of thread and call function
       int m = (idx)/nkji;
@@ -165,6 +171,11 @@ TaskStatus MHD::NewTimeStep(Driver *pdriver, int stage) {
   // compute source terms timestep
   psrc->NewTimeStep(w0, peos->eos_data);
 
+  // error norm of step with embedded RK pairs
+  if (pdriver->adaptive_dt) {
+    errnew = pdriver->EmbeddedErrorNorm(pmy_pack, u0, u1, nmhd+nscalars);
+  }
+
   return TaskStatus::complete;
 }
 } // namespace mhd
@@ -0,0 +1,202 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file mhd_sts.cpp
+//! \brief Operator-split super time-stepping (STS) of viscosity and thermal conduction
+//! with the RKL1 and RKL2 Runge-Kutta-Legendre methods of Meyer, Balsara, & Aslam (2014).
+//! After the explicit stages of each cycle, the diffusion terms are integrated over the
+//! full timestep with s stages, where s is set by the Driver from the ratio of dt to the
+//! explicit timestep of the diffusion terms.  Each stage j computes
+//!   Y_j = mu_j Y_{j-1} + nu_j Y_{j-2} + (1-mu_j-nu_j) Y_0 + mu~_j dt L(Y_{j-1})
+//!       + gam~_j dt L(Y_0)
+//! where L is the divergence of the diffusive fluxes.  Y_{j-1} is stored in u0, Y_{j-2}
+//! in u1, and Y_0 and dt L(Y_0) in u_sts0 and u_stsl0.  Stages use the same flux,
+//! boundary, and ConToPrim functions as the explicit stages.  Only the conserved
+//! variables are updated and communicated; the magnetic field (and resistivity) is
+//! advanced in the explicit stages.
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "diffusion/viscosity.hpp"
+#include "diffusion/conduction.hpp"
+#include "mhd.hpp"
+
+namespace mhd {
+//----------------------------------------------------------------------------------------
+//! \fn  void MHD::AssembleSTSTasks
+//! \brief Adds mhd tasks to the "before_sts", "sts", and "after_sts" task lists that
+//! are run by the Driver for each STS stage.
+
+void MHD::AssembleSTSTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
+  TaskID none(0);
+  id.sts_irecv = tl["before_sts"]->AddTask(&MHD::STSInitRecv, this, none,
+                                           "MHD::STSInitRecv");
+
+  id.sts_flux  = tl["sts"]->AddTask(&MHD::STSFluxes, this, none, "MHD::STSFluxes");
+  id.sts_sendf = tl["sts"]->AddTask(&MHD::SendFlux, this, id.sts_flux,
+                                    "MHD::SendFlux");
+  id.sts_recvf = tl["sts"]->AddTask(&MHD::RecvFlux, this, id.sts_sendf,
+                                    "MHD::RecvFlux");
+  id.sts_updt  = tl["sts"]->AddTask(&MHD::STSUpdate, this, id.sts_recvf,
+                                    "MHD::STSUpdate");
+  id.sts_restu = tl["sts"]->AddTask(&MHD::RestrictU, this, id.sts_updt,
+                                    "MHD::RestrictU");
+  id.sts_sendu = tl["sts"]->AddTask(&MHD::SendU, this, id.sts_restu, "MHD::SendU");
+  id.sts_recvu = tl["sts"]->AddTask(&MHD::RecvU, this, id.sts_sendu, "MHD::RecvU");
+  id.sts_bcs   = tl["sts"]->AddTask(&MHD::ApplyPhysicalBCs, this, id.sts_recvu,
+                                    "MHD::ApplyPhysicalBCs");
+  id.sts_prol  = tl["sts"]->AddTask(&MHD::Prolongate, this, id.sts_bcs,
+                                    "MHD::Prolongate");
+  id.sts_c2p   = tl["sts"]->AddTask(&MHD::ConToPrim, this, id.sts_prol,
+                                    "MHD::ConToPrim");
+
+  id.sts_csend = tl["after_sts"]->AddTask(&MHD::STSClearSend, this, none,
+                                          "MHD::STSClearSend");
+  id.sts_crecv = tl["after_sts"]->AddTask(&MHD::STSClearRecv, this, id.sts_csend,
+                                          "MHD::STSClearRecv");
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::STSInitRecv
+//! \brief Posts receives for U (and with SMR/AMR its fluxes), the only variables
+//! communicated in STS stages.
+
+TaskStatus MHD::STSInitRecv(Driver *pdrive, int stage) {
+  TaskStatus tstat = pbval_u->InitRecv(nmhd+nscalars);
+  if (tstat != TaskStatus::complete) return tstat;
+  if (pmy_pack->pmesh->multilevel) {
+    tstat = pbval_u->InitFluxRecv(nmhd+nscalars);
+  }
+  return tstat;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::STSClearSend
+//! \brief Checks sends of U (and with SMR/AMR its fluxes) in STS stages have completed.
+
+TaskStatus MHD::STSClearSend(Driver *pdrive, int stage) {
+  TaskStatus tstat = pbval_u->ClearSend();
+  if (tstat != TaskStatus::complete) return tstat;
+  if (pmy_pack->pmesh->multilevel) {
+    tstat = pbval_u->ClearFluxSend();
+  }
+  return tstat;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::STSClearRecv
+//! \brief Checks receives of U (and with SMR/AMR its fluxes) in STS stages have
+//! completed.
+
+TaskStatus MHD::STSClearRecv(Driver *pdrive, int stage) {
+  TaskStatus tstat = pbval_u->ClearRecv();
+  if (tstat != TaskStatus::complete) return tstat;
+  if (pmy_pack->pmesh->multilevel) {
+    tstat = pbval_u->ClearFluxRecv();
+  }
+  return tstat;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::STSFluxes
+//! \brief Computes only the viscous and heat fluxes.  In the first stage, also saves
+//! the conserved variables at the start of the STS.
+
+TaskStatus MHD::STSFluxes(Driver *pdrive, int stage) {
+  if (stage == 1) {
+    Kokkos::deep_copy(TaskExecSpace(), u_sts0, u0);
+  }
+
+  Kokkos::deep_copy(TaskExecSpace(), uflx.x1f, 0.0);
+  if (pmy_pack->pmesh->multi_d) {Kokkos::deep_copy(TaskExecSpace(), uflx.x2f, 0.0);}
+  if (pmy_pack->pmesh->three_d) {Kokkos::deep_copy(TaskExecSpace(), uflx.x3f, 0.0);}
+  if (pvisc != nullptr) {
+    pvisc->AddViscousFlux(w0, peos->eos_data, uflx);
+  }
+  if (pcond != nullptr) {
+    pcond->AddHeatFlux(w0, peos->eos_data, uflx);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MHD::STSUpdate
+//  \brief Update of conserved variables for one stage of RKL1 or RKL2 STS
+
+TaskStatus MHD::STSUpdate(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  Real mu, nu, mu_t, gam_t;
+  pdriver->STSCoefficients(stage, mu, nu, mu_t, gam_t);
+  Real dt = pmy_pack->pmesh->dt;
+  bool first_stage = (stage == 1);
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nvar = nmhd + nscalars;
+  auto u0_ = u0;
+  auto u1_ = u1;
+  auto y0_ = u_sts0;
+  auto l0_ = u_stsl0;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+
+  int scr_level = 0;
+  size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
+
+  par_for_outer("m_sts_update",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nvar-1,ks,ke,
+                js,je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k,
+                const int j) {
+    ScrArray1D<Real> divf(member.team_scratch(scr_level), ncells1);
+
+    // compute dF1/dx1
+    par_for_inner(member, is, ie, [&](const int i) {
+      divf(i) = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
+    });
+    member.team_barrier();
+
+    // Add dF2/dx2
+    if (multi_d) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        divf(i) += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+      });
+      member.team_barrier();
+    }
+
+    // Add dF3/dx3
+    if (three_d) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        divf(i) += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+      });
+      member.team_barrier();
+    }
+
+    // u0 stores Y_{j-1} and u1 stores Y_{j-2}, so both are shifted after update
+    par_for_inner(member, is, ie, [&](const int i) {
+      Real dtl = -dt*divf(i);
+      if (first_stage) {l0_(m,n,k,j,i) = dtl;}
+      Real y = u0_(m,n,k,j,i);
+      u0_(m,n,k,j,i) = mu*y + nu*u1_(m,n,k,j,i) + (1.0 - mu - nu)*y0_(m,n,k,j,i)
+                     + mu_t*dtl + gam_t*l0_(m,n,k,j,i);
+      u1_(m,n,k,j,i) = y;
+    });
+  });
+  return TaskStatus::complete;
+}
+} // namespace mhd
@@ -22,6 +22,7 @@
 #include "diffusion/resistivity.hpp"
 #include "diffusion/conduction.hpp"
 #include "srcterms/srcterms.hpp"
+#include "chemistry/chemistry.hpp"
 #include "bvals/bvals.hpp"
 #include "shearing_box/shearing_box.hpp"
 #include "shearing_box/orbital_advection.hpp"
@@ -39,48 +40,147 @@ void MHD::AssembleMHDTasks(std::map<std::string, std::shared_ptr<TaskList>> tl)
   TaskID none(0);
 
   // assemble "before_timeintegrator" task list
-  id.savest = tl["before_timeintegrator"]->AddTask(&MHD::SaveMHDState, this, none);
+  id.savest = tl["before_timeintegrator"]->AddTask(&MHD::SaveMHDState, this, none,
+                                                   "MHD::SaveMHDState");
 
   // assemble "before_stagen" task list
-  id.irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, this, none);
-
-  // assemble "stagen" task list
-  id.copyu     = tl["stagen"]->AddTask(&MHD::CopyCons, this, none);
-  id.flux      = tl["stagen"]->AddTask(&MHD::Fluxes, this, id.copyu);
-  id.sendf     = tl["stagen"]->AddTask(&MHD::SendFlux, this, id.flux);
-  id.recvf     = tl["stagen"]->AddTask(&MHD::RecvFlux, this, id.sendf);
-  id.rkupdt    = tl["stagen"]->AddTask(&MHD::RKUpdate, this, id.recvf);
-  id.srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, this, id.rkupdt);
-  id.sendu_oa  = tl["stagen"]->AddTask(&MHD::SendU_OA, this, id.srctrms);
-  id.recvu_oa  = tl["stagen"]->AddTask(&MHD::RecvU_OA, this, id.sendu_oa);
-  id.restu     = tl["stagen"]->AddTask(&MHD::RestrictU, this, id.recvu_oa);
-  id.sendu     = tl["stagen"]->AddTask(&MHD::SendU, this, id.restu);
-  id.recvu     = tl["stagen"]->AddTask(&MHD::RecvU, this, id.sendu);
-  id.sendu_shr = tl["stagen"]->AddTask(&MHD::SendU_Shr, this, id.recvu);
-  id.recvu_shr = tl["stagen"]->AddTask(&MHD::RecvU_Shr, this, id.sendu_shr);
-  id.efld      = tl["stagen"]->AddTask(&MHD::CornerE, this, id.recvu_shr);
-  id.efldsrc   = tl["stagen"]->AddTask(&MHD::EFieldSrc, this, id.efld);
-  id.sende     = tl["stagen"]->AddTask(&MHD::SendE, this, id.efldsrc);
-  id.recve     = tl["stagen"]->AddTask(&MHD::RecvE, this, id.sende);
-  id.ct        = tl["stagen"]->AddTask(&MHD::CT, this, id.recve);
-  id.sendb_oa  = tl["stagen"]->AddTask(&MHD::SendB_OA, this, id.ct);
-  id.recvb_oa  = tl["stagen"]->AddTask(&MHD::RecvB_OA, this, id.sendb_oa);
-  id.restb     = tl["stagen"]->AddTask(&MHD::RestrictB, this, id.recvb_oa);
-  id.sendb     = tl["stagen"]->AddTask(&MHD::SendB, this, id.restb);
-  id.recvb     = tl["stagen"]->AddTask(&MHD::RecvB, this, id.sendb);
-  id.sendb_shr = tl["stagen"]->AddTask(&MHD::SendB_Shr, this, id.recvb);
-  id.recvb_shr = tl["stagen"]->AddTask(&MHD::RecvB_Shr, this, id.sendb_shr);
-  id.bcs       = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, this, id.recvb_shr);
-  id.prol      = tl["stagen"]->AddTask(&MHD::Prolongate, this, id.bcs);
-  id.c2p       = tl["stagen"]->AddTask(&MHD::ConToPrim, this, id.prol);
-  id.newdt     = tl["stagen"]->AddTask(&MHD::NewTimeStep, this, id.c2p);
+  id.irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, this, none, "MHD::InitRecv");
 
   // assemble "after_stagen" task list
-  id.csend = tl["after_stagen"]->AddTask(&MHD::ClearSend, this, none);
+  id.csend = tl["after_stagen"]->AddTask(&MHD::ClearSend, this, none, "MHD::ClearSend");
   // although RecvFlux/U/E/B functions check that all recvs complete, add ClearRecv to
   // task list anyways to catch potential bugs in MPI communication logic
-  id.crecv = tl["after_stagen"]->AddTask(&MHD::ClearRecv, this, id.csend);
+  id.crecv = tl["after_stagen"]->AddTask(&MHD::ClearRecv, this, id.csend,
+                                         "MHD::ClearRecv");
+
+  // super time-stepping of diffusion terms uses separate task lists
+  if (use_sts) {AssembleSTSTasks(tl);}
+
+  // reaction network is integrated over the full timestep after the time integrator
+  if (pchem != nullptr) {
+    id.chem = tl["after_timeintegrator"]->AddTask(&MHD::ChemistryStep, this, none,
+                                                  "MHD::ChemistryStep");
+  }
+
+  // assemble "stagen" task list
+  if (overlap_comm) {
+    AssembleOverlappedTasks(tl);
+    return;
+  }
+  // With pipelined orbital advection, E-fields and CT are computed while messages of U
+  // for orbital advection are in flight, and U is communicated while messages of B are
+  // in flight.  E-fields depend only on fluxes and primitives, not on updated U.
+  bool pipe_oa = (porb_u != nullptr) && porb_u->pipelined;
+  id.copyu     = tl["stagen"]->AddTask(&MHD::CopyCons, this, none, "MHD::CopyCons");
+  id.flux      = tl["stagen"]->AddTask(&MHD::Fluxes, this, id.copyu, "MHD::Fluxes");
+  id.sendf     = tl["stagen"]->AddTask(&MHD::SendFlux, this, id.flux, "MHD::SendFlux");
+  id.recvf     = tl["stagen"]->AddTask(&MHD::RecvFlux, this, id.sendf, "MHD::RecvFlux");
+  id.rkupdt    = tl["stagen"]->AddTask(&MHD::RKUpdate, this, id.recvf, "MHD::RKUpdate");
+  id.srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, this, id.rkupdt,
+                                       "MHD::MHDSrcTerms");
+  id.sendu_oa  = tl["stagen"]->AddTask(&MHD::SendU_OA, this, id.srctrms, "MHD::SendU_OA");
+  id.recvu_oa  = tl["stagen"]->AddTask(&MHD::RecvU_OA, this, id.sendu_oa,
+                                       "MHD::RecvU_OA");
+  id.restu     = tl["stagen"]->AddTask(&MHD::RestrictU, this, id.recvu_oa,
+                                       "MHD::RestrictU");
+  id.sendu     = tl["stagen"]->AddTask(&MHD::SendU, this, id.restu, "MHD::SendU");
+  id.recvu     = tl["stagen"]->AddTask(&MHD::RecvU, this, id.sendu, "MHD::RecvU");
+  id.sendu_shr = tl["stagen"]->AddTask(&MHD::SendU_Shr, this, id.recvu, "MHD::SendU_Shr");
+  id.recvu_shr = tl["stagen"]->AddTask(&MHD::RecvU_Shr, this, id.sendu_shr,
+                                       "MHD::RecvU_Shr");
+  TaskID efdep = (pipe_oa)? id.sendu_oa : id.recvu_shr;
+  id.efld      = tl["stagen"]->AddTask(&MHD::CornerE, this, efdep, "MHD::CornerE");
+  id.efldsrc   = tl["stagen"]->AddTask(&MHD::EFieldSrc, this, id.efld, "MHD::EFieldSrc");
+  id.sende     = tl["stagen"]->AddTask(&MHD::SendE, this, id.efldsrc, "MHD::SendE");
+  id.recve     = tl["stagen"]->AddTask(&MHD::RecvE, this, id.sende, "MHD::RecvE");
+  id.ct        = tl["stagen"]->AddTask(&MHD::CT, this, id.recve, "MHD::CT");
+  id.sendb_oa  = tl["stagen"]->AddTask(&MHD::SendB_OA, this, id.ct, "MHD::SendB_OA");
+  id.recvb_oa  = tl["stagen"]->AddTask(&MHD::RecvB_OA, this, id.sendb_oa,
+                                       "MHD::RecvB_OA");
+  id.restb     = tl["stagen"]->AddTask(&MHD::RestrictB, this, id.recvb_oa,
+                                       "MHD::RestrictB");
+  id.sendb     = tl["stagen"]->AddTask(&MHD::SendB, this, id.restb, "MHD::SendB");
+  id.recvb     = tl["stagen"]->AddTask(&MHD::RecvB, this, id.sendb, "MHD::RecvB");
+  id.sendb_shr = tl["stagen"]->AddTask(&MHD::SendB_Shr, this, id.recvb, "MHD::SendB_Shr");
+  id.recvb_shr = tl["stagen"]->AddTask(&MHD::RecvB_Shr, this, id.sendb_shr,
+                                       "MHD::RecvB_Shr");
+  TaskID bcsdep = (pipe_oa)? (id.recvu_shr | id.recvb_shr) : id.recvb_shr;
+  id.bcs       = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, this, bcsdep,
+                                       "MHD::ApplyPhysicalBCs");
+  id.prol      = tl["stagen"]->AddTask(&MHD::Prolongate, this, id.bcs, "MHD::Prolongate");
+  id.c2p       = tl["stagen"]->AddTask(&MHD::ConToPrim, this, id.prol, "MHD::ConToPrim");
+  id.newdt     = tl["stagen"]->AddTask(&MHD::NewTimeStep, this, id.c2p,
+                                       "MHD::NewTimeStep");
+  // kernels of these tasks can be replayed from device graphs (<time>/task_graphs)
+  tl["stagen"]->SetGraphCapture(id.copyu);
+  tl["stagen"]->SetGraphCapture(id.restu);
+  tl["stagen"]->SetGraphCapture(id.restb);
+
+  return;
+}
 
+//----------------------------------------------------------------------------------------
+//! \fn  void MHD::AssembleOverlappedTasks
+//! \brief Adds MHD tasks to "stagen" task list when communication of ghost zones is
+//! overlapped with computation (<mhd>/overlap_comm=true).  Ghost zones of both U and B
+//! are exchanged at the START of each stage, and fluxes on faces whose reconstruction
+//! stencil lies entirely within the active zones are computed while messages are in
+//! flight.  See Hydro::AssembleOverlappedTasks() for more details.
+
+void MHD::AssembleOverlappedTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
+  TaskID none(0);
+  id.copyu     = tl["stagen"]->AddTask(&MHD::CopyCons, this, none, "MHD::CopyCons");
+  id.restu     = tl["stagen"]->AddTask(&MHD::RestrictUB, this, none, "MHD::RestrictUB");
+  id.restb     = id.restu;
+  id.sendu     = tl["stagen"]->AddTask(&MHD::SendU, this, id.restu, "MHD::SendU");
+  id.sendb     = tl["stagen"]->AddTask(&MHD::SendB, this, id.restb, "MHD::SendB");
+  id.fluxi     = tl["stagen"]->AddTask(&MHD::FluxesInterior, this, id.copyu,
+                                       "MHD::FluxesInterior");
+  id.recvu     = tl["stagen"]->AddTask(&MHD::RecvU, this, id.sendu, "MHD::RecvU");
+  id.sendu_shr = tl["stagen"]->AddTask(&MHD::SendU_Shr, this, id.recvu, "MHD::SendU_Shr");
+  id.recvu_shr = tl["stagen"]->AddTask(&MHD::RecvU_Shr, this, id.sendu_shr,
+                                       "MHD::RecvU_Shr");
+  id.recvb     = tl["stagen"]->AddTask(&MHD::RecvB, this, id.sendb, "MHD::RecvB");
+  id.sendb_shr = tl["stagen"]->AddTask(&MHD::SendB_Shr, this, id.recvb, "MHD::SendB_Shr");
+  id.recvb_shr = tl["stagen"]->AddTask(&MHD::RecvB_Shr, this, id.sendb_shr,
+                                       "MHD::RecvB_Shr");
+  TaskID bcsdep = id.recvu_shr | id.recvb_shr;
+  id.bcs       = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, this, bcsdep,
+                                       "MHD::ApplyPhysicalBCs");
+  id.prol      = tl["stagen"]->AddTask(&MHD::Prolongate, this, id.bcs, "MHD::Prolongate");
+  id.c2ps      = tl["stagen"]->AddTask(&MHD::ConToPrimShell, this, id.prol,
+                                       "MHD::ConToPrimShell");
+  TaskID fluxdep = id.fluxi | id.c2ps;
+  id.flux      = tl["stagen"]->AddTask(&MHD::FluxesShell, this, fluxdep,
+                                       "MHD::FluxesShell");
+  id.sendf     = tl["stagen"]->AddTask(&MHD::SendFlux, this, id.flux, "MHD::SendFlux");
+  id.recvf     = tl["stagen"]->AddTask(&MHD::RecvFlux, this, id.sendf, "MHD::RecvFlux");
+  id.rkupdt    = tl["stagen"]->AddTask(&MHD::RKUpdate, this, id.recvf, "MHD::RKUpdate");
+  id.srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, this, id.rkupdt,
+                                       "MHD::MHDSrcTerms");
+  id.sendu_oa  = tl["stagen"]->AddTask(&MHD::SendU_OA, this, id.srctrms, "MHD::SendU_OA");
+  id.recvu_oa  = tl["stagen"]->AddTask(&MHD::RecvU_OA, this, id.sendu_oa,
+                                       "MHD::RecvU_OA");
+  // with pipelined orbital advection, see comments in AssembleMHDTasks()
+  bool pipe_oa = (porb_u != nullptr) && porb_u->pipelined;
+  TaskID efdep = (pipe_oa)? id.sendu_oa : id.recvu_oa;
+  id.efld      = tl["stagen"]->AddTask(&MHD::CornerE, this, efdep, "MHD::CornerE");
+  id.efldsrc   = tl["stagen"]->AddTask(&MHD::EFieldSrc, this, id.efld, "MHD::EFieldSrc");
+  id.sende     = tl["stagen"]->AddTask(&MHD::SendE, this, id.efldsrc, "MHD::SendE");
+  id.recve     = tl["stagen"]->AddTask(&MHD::RecvE, this, id.sende, "MHD::RecvE");
+  id.ct        = tl["stagen"]->AddTask(&MHD::CT, this, id.recve, "MHD::CT");
+  id.sendb_oa  = tl["stagen"]->AddTask(&MHD::SendB_OA, this, id.ct, "MHD::SendB_OA");
+  id.recvb_oa  = tl["stagen"]->AddTask(&MHD::RecvB_OA, this, id.sendb_oa,
+                                       "MHD::RecvB_OA");
+  TaskID c2pdep = (pipe_oa)? (id.recvu_oa | id.recvb_oa) : id.recvb_oa;
+  id.c2p       = tl["stagen"]->AddTask(&MHD::ConToPrimInterior, this, c2pdep,
+                                       "MHD::ConToPrimInterior");
+  id.newdt     = tl["stagen"]->AddTask(&MHD::NewTimeStep, this, id.c2p,
+                                       "MHD::NewTimeStep");
+  // kernels of these tasks can be replayed from device graphs (<time>/task_graphs)
+  tl["stagen"]->SetGraphCapture(id.copyu);
+  tl["stagen"]->SetGraphCapture(id.restu);
+  tl["stagen"]->SetGraphCapture(id.restb);
   return;
 }
 
@@ -91,8 +191,8 @@ void MHD::AssembleMHDTasks(std::map<std::string, std::shared_ptr<TaskList>> tl)
 
 TaskStatus MHD::SaveMHDState(Driver *pdrive, int stage) {
   if (wbcc_saved) {
-    Kokkos::deep_copy(DevExeSpace(), wsaved, w0);
-    Kokkos::deep_copy(DevExeSpace(), bccsaved, bcc0);
+    Kokkos::deep_copy(TaskExecSpace(), wsaved, w0);
+    Kokkos::deep_copy(TaskExecSpace(), bccsaved, bcc0);
   }
   return TaskStatus::complete;
 }
@@ -120,9 +220,12 @@ TaskStatus MHD::InitRecv(Driver *pdrive, int stage) {
       tstat = pbval_u->InitFluxRecv(nmhd+nscalars);
       if (tstat != TaskStatus::complete) return tstat;
     }
-    // post receives for fluxes of B, which are used even with uniform grids
-    tstat = pbval_b->InitFluxRecv(3);
-    if (tstat != TaskStatus::complete) return tstat;
+    // post receives for fluxes of B, which are used even with uniform grids (but are
+    // never sent with fused CT)
+    if (!(use_fused_ct)) {
+      tstat = pbval_b->InitFluxRecv(3);
+      if (tstat != TaskStatus::complete) return tstat;
+    }
   }
 
   // with orbital advection post receives for U and B
@@ -158,14 +261,48 @@ TaskStatus MHD::InitRecv(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::CopyCons
-//! \brief Simple task list function that copies u0 --> u1, and b0 --> b1 in first stage
+//! \brief Simple task list function that copies u0 --> u1, and b0 --> b1 in first stage.
+//! At later stages of integrators with use_delta (e.g. rk4, ssprk104), u1 += delta*u0
+//! and b1 += delta*b0.
 
 TaskStatus MHD::CopyCons(Driver *pdrive, int stage) {
   if (stage == 1) {
-    Kokkos::deep_copy(DevExeSpace(), u1, u0);
-    Kokkos::deep_copy(DevExeSpace(), b1.x1f, b0.x1f);
-    Kokkos::deep_copy(DevExeSpace(), b1.x2f, b0.x2f);
-    Kokkos::deep_copy(DevExeSpace(), b1.x3f, b0.x3f);
+    // copies use the instance bound to this Task, so they can be captured in graphs
+    const DevExeSpace exec_inst = TaskExecSpace();
+    Kokkos::deep_copy(exec_inst, u1, u0);
+    Kokkos::deep_copy(exec_inst, b1.x1f, b0.x1f);
+    Kokkos::deep_copy(exec_inst, b1.x2f, b0.x2f);
+    Kokkos::deep_copy(exec_inst, b1.x3f, b0.x3f);
+    // save state at start of step in case step is rejected
+    if (pdrive->adaptive_dt) {
+      Kokkos::deep_copy(exec_inst, u_start, u0);
+      Kokkos::deep_copy(exec_inst, b_start.x1f, b0.x1f);
+      Kokkos::deep_copy(exec_inst, b_start.x2f, b0.x2f);
+      Kokkos::deep_copy(exec_inst, b_start.x3f, b0.x3f);
+    }
+  } else if (pdrive->use_delta) {
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    int is = indcs.is, ie = indcs.ie;
+    int js = indcs.js, je = indcs.je;
+    int ks = indcs.ks, ke = indcs.ke;
+    int nmb1 = pmy_pack->nmb_thispack - 1;
+    int nvar = nmhd + nscalars;
+    Real delta = pdrive->delta[stage-1];
+    if (delta == 0.0) return TaskStatus::complete;
+    auto &u0_ = u0;
+    auto &u1_ = u1;
+    par_for("mhd_copy_cons", DevExeSpace(),0, nmb1, 0, nvar-1, ks, ke, js, je, is, ie,
+    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      u1_(m,n,k,j,i) += delta*u0_(m,n,k,j,i);
+    });
+    auto &b0_ = b0;
+    auto &b1_ = b1;
+    par_for("mhd_copy_b", DevExeSpace(),0, nmb1, ks, ke+1, js, je+1, is, ie+1,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      if (k <= ke && j <= je) {b1_.x1f(m,k,j,i) += delta*b0_.x1f(m,k,j,i);}
+      if (k <= ke && i <= ie) {b1_.x2f(m,k,j,i) += delta*b0_.x2f(m,k,j,i);}
+      if (j <= je && i <= ie) {b1_.x3f(m,k,j,i) += delta*b0_.x3f(m,k,j,i);}
+    });
   }
   return TaskStatus::complete;
 }
@@ -176,33 +313,46 @@ TaskStatus MHD::CopyCons(Driver *pdrive, int stage) {
 //! of conserved variables
 
 TaskStatus MHD::Fluxes(Driver *pdrive, int stage) {
-  // select which calculate_flux function to call based on rsolver_method
-  if (rsolver_method == MHD_RSolver::advect) {
-    CalculateFluxes<MHD_RSolver::advect>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::llf) {
-    CalculateFluxes<MHD_RSolver::llf>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::hlle) {
-    CalculateFluxes<MHD_RSolver::hlle>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::hlld) {
-    CalculateFluxes<MHD_RSolver::hlld>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::llf_sr) {
-    CalculateFluxes<MHD_RSolver::llf_sr>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::hlle_sr) {
-    CalculateFluxes<MHD_RSolver::hlle_sr>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::llf_gr) {
-    CalculateFluxes<MHD_RSolver::llf_gr>(pdrive, stage);
-  } else if (rsolver_method == MHD_RSolver::hlle_gr) {
-    CalculateFluxes<MHD_RSolver::hlle_gr>(pdrive, stage);
-  }
-
-  // Add viscous, resistive, heat-flux, etc fluxes
-  if (pvisc != nullptr) {
-    pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
+  return FluxesInRegion(pdrive, stage, BlockRegion::all);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::FluxesInterior
+//! \brief Wrapper task list function that computes fluxes on faces that depend only on
+//! active zones.  Used when communication is overlapped with computation.
+
+TaskStatus MHD::FluxesInterior(Driver *pdrive, int stage) {
+  return FluxesInRegion(pdrive, stage, BlockRegion::interior);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::FluxesShell
+//! \brief Wrapper task list function that computes fluxes on faces not computed by
+//! FluxesInterior, then adds diffusive fluxes and FOFC over all faces.
+
+TaskStatus MHD::FluxesShell(Driver *pdrive, int stage) {
+  return FluxesInRegion(pdrive, stage, BlockRegion::shell);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::FluxesInRegion
+//! \brief Computes fluxes over faces in given region.  Diffusive fluxes and FOFC need
+//! primitives in the ghost zones, so they are only added for the all and shell regions.
+
+TaskStatus MHD::FluxesInRegion(Driver *pdrive, int stage, BlockRegion region) {
+  // call flux kernel selected for this RS, reconstruction method, and EOS
+  (this->*flux_kernel)(pdrive, stage, region);
+  if (region == BlockRegion::interior) return TaskStatus::complete;
+
+  // Add viscous, resistive, heat-flux, etc fluxes.  Viscous and heat fluxes are not
+  // added if they are integrated with STS
+  if ((pvisc != nullptr) && !(use_sts)) {
+    pvisc->AddViscousFlux(w0, peos->eos_data, uflx);
   }
   if ((presist != nullptr) && (peos->eos_data.is_ideal)) {
     presist->OhmicEnergyFlux(b0, uflx);
   }
-  if (pcond != nullptr) {
+  if ((pcond != nullptr) && !(use_sts)) {
     pcond->AddHeatFlux(w0, peos->eos_data, uflx);
   }
 
@@ -255,13 +405,15 @@ TaskStatus MHD::RecvFlux(Driver *pdrive, int stage) {
 TaskStatus MHD::MHDSrcTerms(Driver *pdrive, int stage) {
   Real beta_dt = (pdrive->beta[stage-1])*(pmy_pack->pmesh->dt);
 
-  // Add source terms for various physics
-  if (psrc->const_accel)  psrc->ConstantAccel(w0, peos->eos_data, beta_dt, u0);
-  if (psrc->ism_cooling)  psrc->ISMCooling(w0, peos->eos_data, beta_dt, u0);
-  if (psrc->rel_cooling)  psrc->RelCooling(w0, peos->eos_data, beta_dt, u0);
-
-  // Add shearing box source terms for CC MHD variables
-  if (psbox_u != nullptr) psbox_u->SourceTermsCC(w0, bcc0, peos->eos_data, beta_dt, u0);
+  // Add source terms for various physics, and shearing box source terms for CC MHD
+  // variables, in one kernel.  Skipped if pgen applies them together with its own
+  // terms in user_srcs_func.
+  auto &pgen = pmy_pack->pmesh->pgen;
+  if (!(pgen->user_srcs && pgen->user_srcs_fused) && (psrc->const_accel ||
+      psrc->ism_cooling || psrc->tab_cooling || psrc->rel_cooling ||
+      psbox_u != nullptr)) {
+    psrc->AddSrcTerms(w0, bcc0, peos->eos_data, beta_dt, psbox_u, u0);
+  }
 
   // Add coordinate source terms in GR.  Again, must be computed with only primitives.
   if (pmy_pack->pcoord->is_general_relativistic &&
@@ -279,6 +431,17 @@ TaskStatus MHD::MHDSrcTerms(Driver *pdrive, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskList MHD::ChemistryStep
+//! \brief Wrapper task list function to integrate the reaction network over the full
+//! timestep, operator split from the time integrator.  Updates both u0 and w0 in all
+//! cells, including ghost zones, so no further communication is needed.
+
+TaskStatus MHD::ChemistryStep(Driver *pdrive, int stage) {
+  pchem->Integrate(w0, u0, peos->eos_data, nmhd, pmy_pack->pmesh->dt);
+  return TaskStatus::complete;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskList MHD::SendU_OA
 //! \brief Wrapper task list function to pack/send data for orbital advection
@@ -394,6 +557,8 @@ TaskStatus MHD::EFieldSrc(Driver *pdrive, int stage) {
 //! MeshBlocks), and at fine/coarse boundaries with SMR/AMR using restricted values of E.
 
 TaskStatus MHD::SendE(Driver *pdrive, int stage) {
+  // corner electric fields are never stored with fused CT
+  if (use_fused_ct) return TaskStatus::complete;
   TaskStatus tstat = TaskStatus::complete;
   tstat = pbval_b->PackAndSendFluxFC(efld);
   return tstat;
@@ -405,6 +570,7 @@ TaskStatus MHD::SendE(Driver *pdrive, int stage) {
 //! (i.e. edge-centered electric field E) at MeshBlock boundaries
 
 TaskStatus MHD::RecvE(Driver *pdrive, int stage) {
+  if (use_fused_ct) return TaskStatus::complete;
   TaskStatus tstat = TaskStatus::complete;
   tstat = pbval_b->RecvAndUnpackFluxFC(efld);
   return tstat;
@@ -521,10 +687,9 @@ TaskStatus MHD::Prolongate(Driver *pdrive, int stage) {
     pbval_u->FillCoarseInBndryCC(u0, coarse_u0);
     pbval_b->FillCoarseInBndryFC(b0, coarse_b0);
     if (pmy_pack->pmesh->pmr->prolong_prims) {
-      pbval_u->ConsToPrimCoarseBndry(coarse_u0, coarse_b0, coarse_w0);
-      pbval_u->ProlongateCC(w0, coarse_w0);
+      // fine fields are needed to convert prolongated primitives to conserved variables
       pbval_b->ProlongateFC(b0, coarse_b0);
-      pbval_u->PrimToConsFineBndry(w0, b0, u0);
+      pbval_u->ProlongatePrimsCC(u0, coarse_u0, b0, coarse_b0, w0);
     } else {
       pbval_u->ProlongateCC(u0, coarse_u0);
       pbval_b->ProlongateFC(b0, coarse_b0);
@@ -535,7 +700,8 @@ TaskStatus MHD::Prolongate(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::ConToPrim
-//! \brief Wrapper task list function to call ConsToPrim over entire mesh (including gz)
+//! \brief Wrapper task list function to call ConsToPrim over entire mesh (including gz).
+//! With fused_newdt, the signal speeds for NewTimeStep are reduced in the last stage.
 
 TaskStatus MHD::ConToPrim(Driver *pdrive, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -543,10 +709,53 @@ TaskStatus MHD::ConToPrim(Driver *pdrive, int stage) {
   int n1m1 = indcs.nx1 + 2*ng - 1;
   int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
   int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  peos->newdt_in_c2p = use_fused_newdt && (stage == pdrive->nexp_stages);
+  peos->newdt_kinematic = (pdrive->time_evolution == TimeEvolution::kinematic);
   peos->ConsToPrim(u0, b0, w0, bcc0, false, 0, n1m1, 0, n2m1, 0, n3m1);
+  peos->newdt_in_c2p = false;
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::ConToPrimInterior
+//! \brief Wrapper task list function to call ConsToPrim over active zones only.  Used
+//! when communication is overlapped with computation.
+
+TaskStatus MHD::ConToPrimInterior(Driver *pdrive, int stage) {
+  ConToPrimInRegion(BlockRegion::interior);
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::ConToPrimShell
+//! \brief Wrapper task list function to call ConsToPrim over ghost zones only.  Used
+//! when communication is overlapped with computation.
+
+TaskStatus MHD::ConToPrimShell(Driver *pdrive, int stage) {
+  ConToPrimInRegion(BlockRegion::shell);
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MHD::ConToPrimInRegion
+//! \brief Calls ConsToPrim over each box of cells in given region of MeshBlocks
+
+void MHD::ConToPrimInRegion(BlockRegion region) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &ng = indcs.ng;
+  int n1m1 = indcs.nx1 + 2*ng - 1;
+  int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
+  int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  IndexBox cbox[6];
+  int nbox = BlockRegionBoxes(region, {0, n1m1, 0, n2m1, 0, n3m1},
+               {indcs.is, indcs.ie, indcs.js, indcs.je, indcs.ks, indcs.ke}, cbox);
+  for (int b=0; b<nbox; ++b) {
+    peos->ConsToPrim(u0, b0, w0, bcc0, false, cbox[b].il, cbox[b].iu, cbox[b].jl,
+                     cbox[b].ju, cbox[b].kl, cbox[b].ku);
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::ClearSend
 //! \brief Wrapper task list function that checks all MPI sends have completed. Used in
@@ -576,8 +785,10 @@ TaskStatus MHD::ClearSend(Driver *pdrive, int stage) {
       if (tstat != TaskStatus::complete) return tstat;
     }
     // check sends of restricted fluxes of B complete even for uniform grids
-    tstat = pbval_b->ClearFluxSend();
-    if (tstat != TaskStatus::complete) return tstat;
+    if (!(use_fused_ct)) {
+      tstat = pbval_b->ClearFluxSend();
+      if (tstat != TaskStatus::complete) return tstat;
+    }
   }
 
   // with orbital advection check sends for U and B complete
@@ -636,8 +847,10 @@ TaskStatus MHD::ClearRecv(Driver *pdrive, int stage) {
       if (tstat != TaskStatus::complete) return tstat;
     }
     // with SMR/AMR check receives of restricted fluxes of B complete
-    tstat = pbval_b->ClearFluxRecv();
-    if (tstat != TaskStatus::complete) return tstat;
+    if (!(use_fused_ct)) {
+      tstat = pbval_b->ClearFluxRecv();
+      if (tstat != TaskStatus::complete) return tstat;
+    }
   }
 
   // with orbital advection check receives of U and B are complete
@@ -679,4 +892,20 @@ TaskStatus MHD::RestrictB(Driver *pdrive, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::RestrictUB
+//! \brief Wrapper function that restricts both conserved variables and magnetic field
+//! with one kernel.  Used when U and B are restricted at the same point in the task list.
+
+TaskStatus MHD::RestrictUB(Driver *pdrive, int stage) {
+  // Only execute Mesh function with SMR/AMR
+  if (pmy_pack->pmesh->multilevel) {
+    RestrictionBatch rb;
+    rb.AddCC(u0, coarse_u0);
+    rb.AddFC(b0, coarse_b0);
+    pmy_pack->pmesh->pmr->RestrictBatch(rb);
+  }
+  return TaskStatus::complete;
+}
+
 } // namespace mhd
@@ -12,6 +12,7 @@
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
+#include "coordinates/coordinates.hpp"
 #include "eos/eos.hpp"
 #include "mhd.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
@@ -22,18 +23,39 @@ namespace mhd {
 //  \brief Explicit RK update including flux divergence terms
 
 TaskStatus MHD::RKUpdate(Driver *pdriver, int stage) {
+  return (this->*update_kernel)(pdriver, stage);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  MHD::UpdateKernel MHD::SelectUpdateKernel
+//  \brief Returns the RK update kernel compiled for the dimensionality of the Mesh
+
+MHD::UpdateKernel MHD::SelectUpdateKernel() {
+  if (pmy_pack->pmesh->three_d) {return &MHD::CartesianRKUpdate<3>;}
+  if (pmy_pack->pmesh->multi_d) {return &MHD::CartesianRKUpdate<2>;}
+  return &MHD::CartesianRKUpdate<1>;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MHD::CartesianRKUpdate
+//  \brief Explicit RK update including flux divergence terms.  Templated over the number
+//  of dimensions ndim_, so that the flux differences in unused directions are removed at
+//  compile time.
+
+template <int ndim_>
+TaskStatus MHD::CartesianRKUpdate(Driver *pdriver, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
   int ks = indcs.ks, ke = indcs.ke;
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
-  bool &multi_d = pmy_pack->pmesh->multi_d;
-  bool &three_d = pmy_pack->pmesh->three_d;
 
   Real &gam0 = pdriver->gam0[stage-1];
   Real &gam1 = pdriver->gam1[stage-1];
   Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
-  int nmb1 = pmy_pack->nmb_thispack - 1;
+  // only update MBs not entirely excised (all MBs, unless <coord>/skip_excised_blocks)
+  int nmb1 = pmy_pack->pcoord->nmb_unexcised - 1;
+  auto &emb_ = pmy_pack->pcoord->unexcised_mbs;
   int nv1 = nmhd + nscalars - 1;
   auto u0_ = u0;
   auto u1_ = u1;
@@ -49,7 +71,9 @@ TaskStatus MHD::RKUpdate(Driver *pdriver, int stage) {
   size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
 
   par_for_outer("mhd_update",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nv1,ks,ke,js,je,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int j) {
+  KOKKOS_LAMBDA(TeamMember_t member, const int ma, const int n, const int k,
+                const int j) {
+    const int m = emb_.d_view(ma);
     ScrArray1D<Real> divf(member.team_scratch(scr_level), ncells1);
 
     // compute dF1/dx1
@@ -60,7 +84,7 @@ TaskStatus MHD::RKUpdate(Driver *pdriver, int stage) {
 
     // Add dF2/dx2
     // Fluxes must be summed in pairs to symmetrize round-off error in each dir
-    if (multi_d) {
+    if constexpr (ndim_ > 1) {
       par_for_inner(member, is, ie, [&](const int i) {
         divf(i) += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
       });
@@ -69,7 +93,7 @@ TaskStatus MHD::RKUpdate(Driver *pdriver, int stage) {
 
     // Add dF3/dx3
     // Fluxes must be summed in pairs to symmetrize round-off error in each dir
-    if (three_d) {
+    if constexpr (ndim_ > 2) {
       par_for_inner(member, is, ie, [&](const int i) {
         divf(i) += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
       });
@@ -25,18 +25,18 @@ void HLLD(TeamMember_t const &member, const EOS_Data &eos,
      const int m, const int k, const int j, const int il, const int iu, const int ivx,
      const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr,
      const ScrArray2D<Real> &bl, const ScrArray2D<Real> &br, const DvceArray4D<Real> &bx,
-     DvceArray5D<Real> flx, DvceArray4D<Real> ey, DvceArray4D<Real> ez) {
+     DvceArray5D<FluxReal> flx, DvceArray4D<Real> ey, DvceArray4D<Real> ez) {
   int ivy = IVX + ((ivx-IVX)+1)%3;
   int ivz = IVX + ((ivx-IVX)+2)%3;
   int iby = ((ivx-IVX) + 1)%3;
   int ibz = ((ivx-IVX) + 2)%3;
-  Real spd[5];         // signal speeds, left to right
 
   //------------------------ ADIABATIC HLLD solver ---------------------------------------
   if (eos.is_ideal) {
     Real gm1 = eos.gamma - 1.0;
     Real igm1 = 1.0/gm1;
-    par_for_inner(member, il, iu, [&](const int i) {
+    par_for_inner_simd(member, il, iu, [&](const int i) {
+      Real spd[5];         // signal speeds, left to right
       //--- Step 1.  Create local references for L/R states (helps compiler vectorize)
 
       Real &wl_idn=wl(IDN,i);
@@ -289,61 +289,28 @@ void HLLD(TeamMember_t const &member, const EOS_Data &eos,
       urst.by = spd[4] * (urst.by - ur.by);
       urst.bz = spd[4] * (urst.bz - ur.bz);
 
-      if (spd[0] >= 0.0) {
-        // return Fl if flow is supersonic
-        flxi.d = fl.d;
-        flxi.mx = fl.mx;
-        flxi.my = fl.my;
-        flxi.mz = fl.mz;
-        flxi.e  = fl.e;
-        flxi.by = fl.by;
-        flxi.bz = fl.bz;
-      } else if (spd[4] <= 0.0) {
-        // return Fr if flow is supersonic
-        flxi.d = fr.d;
-        flxi.mx = fr.mx;
-        flxi.my = fr.my;
-        flxi.mz = fr.mz;
-        flxi.e  = fr.e;
-        flxi.by = fr.by;
-        flxi.bz = fr.bz;
-      } else if (spd[1] >= 0.0) {
-        // return Fl*
-        flxi.d = fl.d  + ulst.d;
-        flxi.mx = fl.mx + ulst.mx;
-        flxi.my = fl.my + ulst.my;
-        flxi.mz = fl.mz + ulst.mz;
-        flxi.e  = fl.e  + ulst.e;
-        flxi.by = fl.by + ulst.by;
-        flxi.bz = fl.bz + ulst.bz;
-      } else if (spd[2] >= 0.0) {
-        // return Fl**
-        flxi.d = fl.d  + ulst.d + uldst.d;
-        flxi.mx = fl.mx + ulst.mx + uldst.mx;
-        flxi.my = fl.my + ulst.my + uldst.my;
-        flxi.mz = fl.mz + ulst.mz + uldst.mz;
-        flxi.e  = fl.e  + ulst.e + uldst.e;
-        flxi.by = fl.by + ulst.by + uldst.by;
-        flxi.bz = fl.bz + ulst.bz + uldst.bz;
-      } else if (spd[3] > 0.0) {
-        // return Fr**
-        flxi.d = fr.d + urst.d + urdst.d;
-        flxi.mx = fr.mx + urst.mx + urdst.mx;
-        flxi.my = fr.my + urst.my + urdst.my;
-        flxi.mz = fr.mz + urst.mz + urdst.mz;
-        flxi.e  = fr.e + urst.e + urdst.e;
-        flxi.by = fr.by + urst.by + urdst.by;
-        flxi.bz = fr.bz + urst.bz + urdst.bz;
-      } else {
-        // return Fr*
-        flxi.d = fr.d  + urst.d;
-        flxi.mx = fr.mx + urst.mx;
-        flxi.my = fr.my + urst.my;
-        flxi.mz = fr.mz + urst.mz;
-        flxi.e  = fr.e  + urst.e;
-        flxi.by = fr.by + urst.by;
-        flxi.bz = fr.bz + urst.bz;
-      }
+      // Select flux in the region containing x/t=0, adding the jumps across each wave
+      // between it and the outermost state.  Masks are used rather than an if/else chain
+      // over the regions (Fl, Fr, Fl*, Fl**, Fr**, Fr*), so that the loop vectorizes.
+      const bool lside = (spd[0] >= 0.0) || ((spd[4] > 0.0) && (spd[2] >= 0.0));
+      const bool lst  = lside && (spd[0] < 0.0);        // add jump across left fast wave
+      const bool ldst = lst && (spd[1] < 0.0);          // ... and left Alfven wave
+      const bool rst  = !(lside) && (spd[4] > 0.0);     // add jump across right fast wave
+      const bool rdst = rst && (spd[3] > 0.0);          // ... and right Alfven wave
+      flxi.d  = (lside? fl.d  : fr.d) + (lst? ulst.d  : 0.0) + (ldst? uldst.d  : 0.0)
+                                      + (rst? urst.d  : 0.0) + (rdst? urdst.d  : 0.0);
+      flxi.mx = (lside? fl.mx : fr.mx) + (lst? ulst.mx : 0.0) + (ldst? uldst.mx : 0.0)
+                                       + (rst? urst.mx : 0.0) + (rdst? urdst.mx : 0.0);
+      flxi.my = (lside? fl.my : fr.my) + (lst? ulst.my : 0.0) + (ldst? uldst.my : 0.0)
+                                       + (rst? urst.my : 0.0) + (rdst? urdst.my : 0.0);
+      flxi.mz = (lside? fl.mz : fr.mz) + (lst? ulst.mz : 0.0) + (ldst? uldst.mz : 0.0)
+                                       + (rst? urst.mz : 0.0) + (rdst? urdst.mz : 0.0);
+      flxi.e  = (lside? fl.e  : fr.e) + (lst? ulst.e  : 0.0) + (ldst? uldst.e  : 0.0)
+                                      + (rst? urst.e  : 0.0) + (rdst? urdst.e  : 0.0);
+      flxi.by = (lside? fl.by : fr.by) + (lst? ulst.by : 0.0) + (ldst? uldst.by : 0.0)
+                                       + (rst? urst.by : 0.0) + (rdst? urdst.by : 0.0);
+      flxi.bz = (lside? fl.bz : fr.bz) + (lst? ulst.bz : 0.0) + (ldst? uldst.bz : 0.0)
+                                       + (rst? urst.bz : 0.0) + (rdst? urdst.bz : 0.0);
 
       flx(m,IDN,k,j,i) = flxi.d;
       flx(m,ivx,k,j,i) = flxi.mx;
@@ -358,7 +325,8 @@ void HLLD(TeamMember_t const &member, const EOS_Data &eos,
   } else {
     auto &dfloor_ = eos.dfloor;
     Real iso_cs = eos.iso_cs;
-    par_for_inner(member, il, iu, [&](const int i) {
+    par_for_inner_simd(member, il, iu, [&](const int i) {
+      Real spd[5];         // signal speeds, left to right
       //--- Step 1.  Load L/R states into local variables
 
       Real &wl_idn=wl(IDN,i);
@@ -0,0 +1,405 @@
+#ifndef MHD_RSOLVERS_HLLD_SRMHD_HPP_
+#define MHD_RSOLVERS_HLLD_SRMHD_HPP_
+//========================================================================================
+// Athena++ (Kokkos version) astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hlld_srmhd.hpp
+//! \brief HLLD Riemann solver for special relativistic MHD, following Mignone, Ugliano,
+//! & Bodo 2009, MNRAS 393 1141 (MUB).  The total pressure in the intermediate states is
+//! found with a fixed maximum number of secant iterations.  Interfaces where the
+//! iteration does not converge, or where the intermediate states are unphysical or the
+//! wavespeeds are out of order, fall back to the HLLE flux.
+
+#include <algorithm>  // max(), min()
+#include <cmath>      // sqrt()
+
+// maximum number of secant iterations, and relative tolerance in total pressure
+#define HLLD_SR_MAX_ITER 20
+#define HLLD_SR_TOL 1.0e-10
+
+namespace mhd {
+//----------------------------------------------------------------------------------------
+//! \struct HLLDSRAState
+//! \brief variables in one of the outer intermediate (Alfven) states of the HLLD fan
+
+struct HLLDSRAState {
+  MHDCons1D u;           // conserved variables
+  Real vx, vy, vz;       // 3-velocity
+  Real w;                // total enthalpy (MUB 31)
+  Real eta;              // MUB 35
+  Real kx, ky, kz;       // MUB 43, kx is the Alfven speed
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn bool HLLDSRAlfvenState
+//! \brief Computes the outer intermediate state from r = lambda*U - F of the outer state
+//! (MUB 26) and the guess ptot for the total pressure, using MUB 23-33 and 43.  Argument
+//! sgn is -1 for the left state and +1 for the right.  Returns false if unphysical.
+
+KOKKOS_INLINE_FUNCTION
+bool HLLDSRAlfvenState(const MHDCons1D &r, const Real lambda, const Real bx,
+                       const Real ptot, const Real sgn, HLLDSRAState &a) {
+  Real qa = r.mx - lambda*r.e + ptot*(1.0 - SQR(lambda));                // MUB 26
+  Real qg = SQR(r.by) + SQR(r.bz);                                       // MUB 27
+  Real qc = r.my*r.by + r.mz*r.bz;                                       // MUB 28
+  Real qq = -qa - qg + SQR(bx)*(1.0 - SQR(lambda));                      // MUB 29
+  Real qx = bx*(qa*lambda*bx + qc) - (qa + qg)*(lambda*ptot + r.e);      // MUB 30
+  Real iqx = 1.0/qx;
+  a.vx = (bx*(qa*bx + lambda*qc) - (qa + qg)*(ptot + r.mx))*iqx;         // MUB 23
+  a.vy = (qq*r.my + r.by*(qc + bx*(lambda*r.mx - r.e)))*iqx;
+  a.vz = (qq*r.mz + r.bz*(qc + bx*(lambda*r.mx - r.e)))*iqx;
+  Real idl = 1.0/(lambda - a.vx);
+  a.u.by = (r.by - bx*a.vy)*idl;                                         // MUB 21
+  a.u.bz = (r.bz - bx*a.vz)*idl;
+  Real vb = a.vx*bx + a.vy*a.u.by + a.vz*a.u.bz;
+  a.u.d = r.d*idl;                                                       // MUB 32
+  a.u.e = (r.e + ptot*a.vx - vb*bx)*idl;                                 // MUB 33
+  a.u.mx = (a.u.e + ptot)*a.vx - vb*bx;                                  // MUB 34
+  a.u.my = (a.u.e + ptot)*a.vy - vb*a.u.by;
+  a.u.mz = (a.u.e + ptot)*a.vz - vb*a.u.bz;
+  a.w = ptot + (r.e - (a.vx*r.mx + a.vy*r.my + a.vz*r.mz))*idl;          // MUB 31
+  a.eta = sgn*copysign(sqrt(fabs(a.w)), bx);                             // MUB 35
+  Real iden = 1.0/(lambda*ptot + r.e + bx*a.eta);                        // MUB 43
+  a.kx = (r.mx + ptot + lambda*bx*a.eta)*iden;
+  a.ky = (r.my + r.by*a.eta)*iden;
+  a.kz = (r.mz + r.bz*a.eta)*iden;
+  return (a.w > 0.0);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real HLLDSRResidual
+//! \brief Computes both Alfven states for total pressure ptot, and returns the jump in
+//! normal velocity across the contact (MUB 48), simplified to the jump in vx between
+//! the Alfven states if bx vanishes.  The transverse field (times the jump in kx) and
+//! the factors Y of MUB 47 needed to construct the central states are also returned.
+
+KOKKOS_INLINE_FUNCTION
+Real HLLDSRResidual(const MHDCons1D &rl, const MHDCons1D &rr, const Real lambda_l,
+                    const Real lambda_r, const Real bx, const Real ptot,
+                    const bool small_bx, HLLDSRAState &al, HLLDSRAState &ar,
+                    Real &sy, Real &sz, Real &yl, Real &yr, bool &phys) {
+  phys  = HLLDSRAlfvenState(rl, lambda_l, bx, ptot, -1.0, al);
+  phys &= HLLDSRAlfvenState(rr, lambda_r, bx, ptot,  1.0, ar);
+  // B^c times (kx_r - kx_l) (MUB 45)
+  Real dkx = ar.kx - al.kx;
+  Real sx = bx*dkx;
+  sy = (ar.u.by*(ar.kx - ar.vx) + bx*ar.vy) - (al.u.by*(al.kx - al.vx) + bx*al.vy);
+  sz = (ar.u.bz*(ar.kx - ar.vx) + bx*ar.vz) - (al.u.bz*(al.kx - al.vx) + bx*al.vz);
+  Real ksq_l = SQR(al.kx) + SQR(al.ky) + SQR(al.kz);
+  Real ksq_r = SQR(ar.kx) + SQR(ar.ky) + SQR(ar.kz);
+  yl = (1.0 - ksq_l)/(al.eta*dkx - (al.kx*sx + al.ky*sy + al.kz*sz));
+  yr = (1.0 - ksq_r)/(ar.eta*dkx - (ar.kx*sx + ar.ky*sy + ar.kz*sz));
+  if (small_bx) {
+    return ar.vx - al.vx;
+  }
+  return dkx*(1.0 - bx*(yr - yl));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HLLD_SR
+//! \brief The HLLD Riemann solver for SR MHD
+
+KOKKOS_INLINE_FUNCTION
+void HLLD_SR(TeamMember_t const &member, const EOS_Data &eos,
+     const RegionIndcs &indcs,const DualArray1D<RegionSize> &size,const CoordData &coord,
+     const int m, const int k, const int j, const int il, const int iu, const int ivx,
+     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr,
+     const ScrArray2D<Real> &bl, const ScrArray2D<Real> &br, const DvceArray4D<Real> &bx,
+     DvceArray5D<FluxReal> flx, DvceArray4D<Real> ey, DvceArray4D<Real> ez) {
+  int ivy = IVX + ((ivx-IVX) + 1)%3;
+  int ivz = IVX + ((ivx-IVX) + 2)%3;
+  int iby = ((ivx-IVX) + 1)%3;
+  int ibz = ((ivx-IVX) + 2)%3;
+  const Real gm1 = (eos.gamma - 1.0);
+  const Real gamma_prime = eos.gamma/gm1;
+
+  par_for_inner(member, il, iu, [&](const int i) {
+    // Extract left primitives
+    Real rho_l = wl(IDN,i);
+    Real ux_l = wl(ivx,i);
+    Real uy_l = wl(ivy,i);
+    Real uz_l = wl(ivz,i);
+    Real u_l[4];
+    u_l[0] = std::sqrt(1.0 + SQR(ux_l) + SQR(uy_l) + SQR(uz_l));
+    u_l[1] = ux_l;
+    u_l[2] = uy_l;
+    u_l[3] = uz_l;
+    Real bb2_l = bl(iby,i);
+    Real bb3_l = bl(ibz,i);
+
+    // Extract right primitives
+    Real rho_r = wr(IDN,i);
+    Real ux_r = wr(ivx,i);
+    Real uy_r = wr(ivy,i);
+    Real uz_r = wr(ivz,i);
+    Real u_r[4];
+    u_r[0] = std::sqrt(1.0 + SQR(ux_r) + SQR(uy_r) + SQR(uz_r));
+    u_r[1] = ux_r;
+    u_r[2] = uy_r;
+    u_r[3] = uz_r;
+    Real bb2_r = br(iby,i);
+    Real bb3_r = br(ibz,i);
+
+    Real pgas_l, pgas_r;
+    pgas_l = eos.IdealGasPressure(wl(IEN,i));
+    pgas_r = eos.IdealGasPressure(wr(IEN,i));
+
+    // Extract normal magnetic field
+    Real bb1 = bx(m,k,j,i);
+
+    // Calculate 4-magnetic field in left state
+    Real b_l[4];
+    b_l[0] = bb1*u_l[1] + bb2_l*u_l[2] + bb3_l*u_l[3];
+    b_l[1] = (bb1 + b_l[0] * u_l[1]) / u_l[0];
+    b_l[2] = (bb2_l + b_l[0] * u_l[2]) / u_l[0];
+    b_l[3] = (bb3_l + b_l[0] * u_l[3]) / u_l[0];
+    Real b_sq_l = -SQR(b_l[0]) + SQR(b_l[1]) + SQR(b_l[2]) + SQR(b_l[3]);
+
+    // Calculate 4-magnetic field in right state
+    Real b_r[4];
+    b_r[0] = bb1*u_r[1] + bb2_r*u_r[2] + bb3_r*u_r[3];
+    b_r[1] = (bb1 + b_r[0] * u_r[1]) / u_r[0];
+    b_r[2] = (bb2_r + b_r[0] * u_r[2]) / u_r[0];
+    b_r[3] = (bb3_r + b_r[0] * u_r[3]) / u_r[0];
+    Real b_sq_r = -SQR(b_r[0]) + SQR(b_r[1]) + SQR(b_r[2]) + SQR(b_r[3]);
+
+    // Calculate left wavespeeds
+    Real lm_l, lp_l;
+    eos.IdealSRMHDFastSpeeds(rho_l, pgas_l, u_l[1], u_l[0], b_sq_l, lp_l, lm_l);
+
+    // Calculate right wavespeeds
+    Real lm_r, lp_r;
+    eos.IdealSRMHDFastSpeeds(rho_r, pgas_r, u_r[1], u_r[0], b_sq_r, lp_r, lm_r);
+
+    // Calculate extremal wavespeeds
+    Real lambda_l = fmin(lm_l, lm_r);  // (MB 55)
+    Real lambda_r = fmax(lp_l, lp_r);  // (MB 55)
+
+    // Calculate conserved quantities in L region (MUB 8)
+    MHDCons1D consl;
+    Real wgas_l = rho_l + gamma_prime * pgas_l;
+    Real wtot_l = wgas_l + b_sq_l;
+    Real ptot_l = pgas_l + 0.5*b_sq_l;
+    consl.d  = rho_l * u_l[0];
+    consl.e  = wtot_l * u_l[0] * u_l[0] - b_l[0] * b_l[0] - ptot_l;
+    consl.mx = wtot_l * u_l[1] * u_l[0] - b_l[1] * b_l[0];
+    consl.my = wtot_l * u_l[2] * u_l[0] - b_l[2] * b_l[0];
+    consl.mz = wtot_l * u_l[3] * u_l[0] - b_l[3] * b_l[0];
+    consl.by = b_l[2] * u_l[0] - b_l[0] * u_l[2];
+    consl.bz = b_l[3] * u_l[0] - b_l[0] * u_l[3];
+
+    // Calculate fluxes in L region (MUB 15)
+    MHDCons1D fl;
+    fl.d  = rho_l * u_l[1];
+    fl.e  = wtot_l * u_l[0] * u_l[1] - b_l[0] * b_l[1];
+    fl.mx = wtot_l * u_l[1] * u_l[1] - b_l[1] * b_l[1] + ptot_l;
+    fl.my = wtot_l * u_l[2] * u_l[1] - b_l[2] * b_l[1];
+    fl.mz = wtot_l * u_l[3] * u_l[1] - b_l[3] * b_l[1];
+    fl.by = b_l[2] * u_l[1] - b_l[1] * u_l[2];
+    fl.bz = b_l[3] * u_l[1] - b_l[1] * u_l[3];
+
+    // Calculate conserved quantities in R region (MUB 8)
+    MHDCons1D consr;
+    Real wgas_r = rho_r + gamma_prime * pgas_r;
+    Real wtot_r = wgas_r + b_sq_r;
+    Real ptot_r = pgas_r + 0.5*b_sq_r;
+    consr.d  = rho_r * u_r[0];
+    consr.e  = wtot_r * u_r[0] * u_r[0] - b_r[0] * b_r[0] - ptot_r;
+    consr.mx = wtot_r * u_r[1] * u_r[0] - b_r[1] * b_r[0];
+    consr.my = wtot_r * u_r[2] * u_r[0] - b_r[2] * b_r[0];
+    consr.mz = wtot_r * u_r[3] * u_r[0] - b_r[3] * b_r[0];
+    consr.by = b_r[2] * u_r[0] - b_r[0] * u_r[2];
+    consr.bz = b_r[3] * u_r[0] - b_r[0] * u_r[3];
+
+    // Calculate fluxes in R region (MUB 15)
+    MHDCons1D fr;
+    fr.d  = rho_r * u_r[1];
+    fr.e  = wtot_r * u_r[0] * u_r[1] - b_r[0] * b_r[1];
+    fr.mx = wtot_r * u_r[1] * u_r[1] - b_r[1] * b_r[1] + ptot_r;
+    fr.my = wtot_r * u_r[2] * u_r[1] - b_r[2] * b_r[1];
+    fr.mz = wtot_r * u_r[3] * u_r[1] - b_r[3] * b_r[1];
+    fr.by = b_r[2] * u_r[1] - b_r[1] * u_r[2];
+    fr.bz = b_r[3] * u_r[1] - b_r[1] * u_r[3];
+
+    // Calculate R = lambda*U - F in outer states (MUB 12)
+    MHDCons1D rl, rr;
+    rl.d  = lambda_l*consl.d  - fl.d;
+    rl.mx = lambda_l*consl.mx - fl.mx;
+    rl.my = lambda_l*consl.my - fl.my;
+    rl.mz = lambda_l*consl.mz - fl.mz;
+    rl.e  = lambda_l*consl.e  - fl.e;
+    rl.by = lambda_l*consl.by - fl.by;
+    rl.bz = lambda_l*consl.bz - fl.bz;
+    rr.d  = lambda_r*consr.d  - fr.d;
+    rr.mx = lambda_r*consr.mx - fr.mx;
+    rr.my = lambda_r*consr.my - fr.my;
+    rr.mz = lambda_r*consr.mz - fr.mz;
+    rr.e  = lambda_r*consr.e  - fr.e;
+    rr.by = lambda_r*consr.by - fr.by;
+    rr.bz = lambda_r*consr.bz - fr.bz;
+
+    // Calculate conserved quantities and fluxes in HLL region (MB2005 9,11)
+    MHDCons1D cons_hll, flux_hll;
+    Real qb = 1.0/(lambda_r - lambda_l);
+    cons_hll.mx = (rr.mx - rl.mx)*qb;
+    cons_hll.e  = (rr.e  - rl.e )*qb;
+    flux_hll.d  = (lambda_l*rr.d  - lambda_r*rl.d )*qb;
+    flux_hll.mx = (lambda_l*rr.mx - lambda_r*rl.mx)*qb;
+    flux_hll.my = (lambda_l*rr.my - lambda_r*rl.my)*qb;
+    flux_hll.mz = (lambda_l*rr.mz - lambda_r*rl.mz)*qb;
+    flux_hll.e  = (lambda_l*rr.e  - lambda_r*rl.e )*qb;
+    flux_hll.by = (lambda_l*rr.by - lambda_r*rl.by)*qb;
+    flux_hll.bz = (lambda_l*rr.bz - lambda_r*rl.bz)*qb;
+
+    // Initial guess for total pressure from HLL state (MUB 53), or mean of outer total
+    // pressures when the field is strong
+    Real qa1 = cons_hll.e - flux_hll.mx;
+    Real qa0 = cons_hll.mx*flux_hll.e - flux_hll.mx*cons_hll.e;
+    Real qs = sqrt(fmax(SQR(qa1) - 4.0*qa0, 0.0));
+    Real ptot_0 = (qa1 >= 0.0) ? -2.0*qa0/(qa1 + qs) : 0.5*(-qa1 + qs);
+    if (!(ptot_0 > 0.0) || SQR(bb1) > 0.1*ptot_0) {
+      ptot_0 = 0.5*(ptot_l + ptot_r);
+    }
+    bool small_bx = (SQR(bb1) < 1.0e-12*ptot_0);
+
+    // Iterate total pressure with secant method
+    HLLDSRAState al, ar;
+    Real sy, sz, yl, yr;
+    bool phys;
+    Real ptot_a = ptot_0;
+    Real ptot_b = ptot_0*(1.0 + 1.0e-4);
+    Real res_a = HLLDSRResidual(rl, rr, lambda_l, lambda_r, bb1, ptot_a, small_bx,
+                                al, ar, sy, sz, yl, yr, phys);
+    Real res_b = HLLDSRResidual(rl, rr, lambda_l, lambda_r, bb1, ptot_b, small_bx,
+                                al, ar, sy, sz, yl, yr, phys);
+    bool converged = false;
+    for (int n=0; n<HLLD_SR_MAX_ITER; ++n) {
+      if (fabs(ptot_b - ptot_a) <= HLLD_SR_TOL*ptot_b || res_b == 0.0) {
+        converged = true;
+        break;
+      }
+      Real ptot_n = ptot_b - res_b*(ptot_b - ptot_a)/(res_b - res_a);
+      if (!(ptot_n > 0.0)) {ptot_n = 0.5*ptot_b;}
+      ptot_a = ptot_b;
+      res_a = res_b;
+      ptot_b = ptot_n;
+      res_b = HLLDSRResidual(rl, rr, lambda_l, lambda_r, bb1, ptot_b, small_bx,
+                             al, ar, sy, sz, yl, yr, phys);
+    }
+    Real ptot_c = ptot_b;
+
+    // Calculate contact velocity (MUB 47) and Alfven speeds
+    Real dkx = ar.kx - al.kx;
+    Real sx = bb1*dkx;
+    Real vcx, vcy, vcz;
+    if (small_bx) {
+      vcx = 0.5*(al.vx + ar.vx);
+      vcy = 0.0;
+      vcz = 0.0;
+    } else {
+      vcx = 0.5*((al.kx - sx*yl) + (ar.kx - sx*yr));
+      vcy = 0.5*((al.ky - sy*yl) + (ar.ky - sy*yr));
+      vcz = 0.5*((al.kz - sz*yl) + (ar.kz - sz*yr));
+    }
+    Real lambda_al = small_bx ? vcx : al.kx;
+    Real lambda_ar = small_bx ? vcx : ar.kx;
+
+    // Calculate fluxes in outer intermediate states (MUB 11)
+    MHDCons1D flux_al, flux_ar;
+    flux_al.d  = fl.d  + lambda_l*(al.u.d  - consl.d );
+    flux_al.mx = fl.mx + lambda_l*(al.u.mx - consl.mx);
+    flux_al.my = fl.my + lambda_l*(al.u.my - consl.my);
+    flux_al.mz = fl.mz + lambda_l*(al.u.mz - consl.mz);
+    flux_al.e  = fl.e  + lambda_l*(al.u.e  - consl.e );
+    flux_al.by = fl.by + lambda_l*(al.u.by - consl.by);
+    flux_al.bz = fl.bz + lambda_l*(al.u.bz - consl.bz);
+    flux_ar.d  = fr.d  + lambda_r*(ar.u.d  - consr.d );
+    flux_ar.mx = fr.mx + lambda_r*(ar.u.mx - consr.mx);
+    flux_ar.my = fr.my + lambda_r*(ar.u.my - consr.my);
+    flux_ar.mz = fr.mz + lambda_r*(ar.u.mz - consr.mz);
+    flux_ar.e  = fr.e  + lambda_r*(ar.u.e  - consr.e );
+    flux_ar.by = fr.by + lambda_r*(ar.u.by - consr.by);
+    flux_ar.bz = fr.bz + lambda_r*(ar.u.bz - consr.bz);
+
+    // Calculate conserved quantities and fluxes in central states (MUB 11,50-52).  With
+    // vanishing bx the Alfven waves merge with the contact, and the central states are
+    // not needed.
+    MHDCons1D flux_cl = flux_al, flux_cr = flux_ar;
+    if (!(small_bx)) {
+      Real idkx = 1.0/dkx;
+      Real bcy = sy*idkx;
+      Real bcz = sz*idkx;
+      Real vbc = vcx*bb1 + vcy*bcy + vcz*bcz;
+      MHDCons1D ucl, ucr;
+      Real idl = 1.0/(lambda_al - vcx);
+      ucl.d  = al.u.d*(lambda_al - al.vx)*idl;
+      ucl.e  = (lambda_al*al.u.e - al.u.mx + ptot_c*vcx - vbc*bb1)*idl;
+      ucl.mx = (ucl.e + ptot_c)*vcx - vbc*bb1;
+      ucl.my = (ucl.e + ptot_c)*vcy - vbc*bcy;
+      ucl.mz = (ucl.e + ptot_c)*vcz - vbc*bcz;
+      Real idr = 1.0/(lambda_ar - vcx);
+      ucr.d  = ar.u.d*(lambda_ar - ar.vx)*idr;
+      ucr.e  = (lambda_ar*ar.u.e - ar.u.mx + ptot_c*vcx - vbc*bb1)*idr;
+      ucr.mx = (ucr.e + ptot_c)*vcx - vbc*bb1;
+      ucr.my = (ucr.e + ptot_c)*vcy - vbc*bcy;
+      ucr.mz = (ucr.e + ptot_c)*vcz - vbc*bcz;
+
+      flux_cl.d  = flux_al.d  + lambda_al*(ucl.d  - al.u.d );
+      flux_cl.mx = flux_al.mx + lambda_al*(ucl.mx - al.u.mx);
+      flux_cl.my = flux_al.my + lambda_al*(ucl.my - al.u.my);
+      flux_cl.mz = flux_al.mz + lambda_al*(ucl.mz - al.u.mz);
+      flux_cl.e  = flux_al.e  + lambda_al*(ucl.e  - al.u.e );
+      flux_cl.by = flux_al.by + lambda_al*(bcy    - al.u.by);
+      flux_cl.bz = flux_al.bz + lambda_al*(bcz    - al.u.bz);
+      flux_cr.d  = flux_ar.d  + lambda_ar*(ucr.d  - ar.u.d );
+      flux_cr.mx = flux_ar.mx + lambda_ar*(ucr.mx - ar.u.mx);
+      flux_cr.my = flux_ar.my + lambda_ar*(ucr.my - ar.u.my);
+      flux_cr.mz = flux_ar.mz + lambda_ar*(ucr.mz - ar.u.mz);
+      flux_cr.e  = flux_ar.e  + lambda_ar*(ucr.e  - ar.u.e );
+      flux_cr.by = flux_ar.by + lambda_ar*(bcy    - ar.u.by);
+      flux_cr.bz = flux_ar.bz + lambda_ar*(bcz    - ar.u.bz);
+    }
+
+    // Use HLLE flux if iteration failed, states are unphysical, or wavespeeds are not
+    // ordered (which also catches NaNs)
+    bool use_hlld = converged && phys && (lambda_l <= lambda_al) && (lambda_al <= vcx) &&
+                    (vcx <= lambda_ar) && (lambda_ar <= lambda_r);
+
+    // Determine region of wavefan
+    MHDCons1D *flux_interface;
+    if (lambda_l >= 0.0) {  // L region
+      flux_interface = &fl;
+    } else if (lambda_r <= 0.0) { // R region
+      flux_interface = &fr;
+    } else if (!(use_hlld)) {  // HLL region
+      flux_interface = &flux_hll;
+    } else if (lambda_al >= 0.0) {  // aL region
+      flux_interface = &flux_al;
+    } else if (vcx >= 0.0) {  // cL region
+      flux_interface = &flux_cl;
+    } else if (lambda_ar >= 0.0) {  // cR region
+      flux_interface = &flux_cr;
+    } else {  // aR region
+      flux_interface = &flux_ar;
+    }
+
+    // Set fluxes
+    flx(m,IDN,k,j,i) = flux_interface->d;
+    flx(m,ivx,k,j,i) = flux_interface->mx;
+    flx(m,ivy,k,j,i) = flux_interface->my;
+    flx(m,ivz,k,j,i) = flux_interface->mz;
+    flx(m,IEN,k,j,i) = flux_interface->e;
+
+    ey(m,k,j,i) = -flux_interface->by;
+    ez(m,k,j,i) =  flux_interface->bz;
+
+    // We evolve tau = E - D
+    flx(m,IEN,k,j,i) -= flx(m,IDN,k,j,i);
+  });
+
+  return;
+}
+} // namespace mhd
+#endif // MHD_RSOLVERS_HLLD_SRMHD_HPP_
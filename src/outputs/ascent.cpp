@@ -0,0 +1,202 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file ascent.cpp
+//! \brief in-situ visualization with Ascent.  At each output, every MeshBlock on this
+//! rank is published as one domain of a Conduit Blueprint mesh with a uniform coordset
+//! (including ghost zones, which are marked with the "ascent_ghosts" field), and the
+//! actions in <output>/actions_file (scenes, pipelines, extracts) are executed.  Fields
+//! wrap the device arrays of the output variables without copies when the arrays are
+//! contiguous in (k,j,i) (FieldLayout is LayoutRight), so that with GPU builds of Ascent
+//! the data stays on the device.  Otherwise variables are first copied on the device into
+//! a contiguous array.  Only compiled if configured with -D Athena_ENABLE_ASCENT=ON.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+#if ASCENT_ENABLED
+#include <ascent.hpp>
+#include <conduit.hpp>
+#endif
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+AscentOutput::AscentOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op),
+  ghosts("ascent_ghosts",1),
+  staged("ascent_staged",1,1,1,1,1) {
+#if !(ASCENT_ENABLED)
+  std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+            << "Output file_type 'ascent' in <" << op.block_name << "> requires the code "
+            << "to be configured with -D Athena_ENABLE_ASCENT=ON" << std::endl;
+  std::exit(EXIT_FAILURE);
+#else
+  if (op.slice1 || op.slice2 || op.slice3) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Slices are not supported by output file_type 'ascent' in <"
+              << op.block_name << ">, use a slice in the Ascent actions instead"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // mask of ghost cells, which is the same for all MBs
+  auto &indcs = pm->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int n1 = indcs.nx1 + 2*(indcs.ng);
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  Kokkos::realloc(ghosts, n3*n2*n1);
+  auto ghosts_ = ghosts;
+  par_for("ascent_ghosts", DevExeSpace(), 0, n3-1, 0, n2-1, 0, n1-1,
+  KOKKOS_LAMBDA(int k, int j, int i) {
+    bool active = (i >= is && i <= ie && j >= js && j <= je && k >= ks && k <= ke);
+    ghosts_((k*n2 + j)*n1 + i) = (active)? 0 : 1;
+  });
+
+  conduit::Node opts;
+#if MPI_PARALLEL_ENABLED
+  opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_WORLD);
+#endif
+  opts["actions_file"] = pin->GetOrAddString(op.block_name, "actions_file",
+                                             "ascent_actions.yaml");
+  opts["default_dir"] = pin->GetOrAddString(op.block_name, "default_dir", ".");
+  opts["exceptions"] = "forward";
+  pascent = new ascent::Ascent();
+  pascent->open(opts);
+  mesh_node = new conduit::Node();
+#endif // ASCENT_ENABLED
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor: closes Ascent
+
+AscentOutput::~AscentOutput() {
+#if ASCENT_ENABLED
+  if (pascent != nullptr) {
+    pascent->close();
+    delete pascent;
+  }
+  delete mesh_node;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void AscentOutput::LoadOutputData()
+//! \brief Computes derived variables, and describes the MBs and output variables as a
+//! Blueprint mesh.  No data is copied to the host.
+
+void AscentOutput::LoadOutputData(Mesh *pm) {
+#if ASCENT_ENABLED
+  if (out_params.contains_derived) {
+    ComputeDerivedVariable(out_params.variable, pm);
+  }
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  auto &indcs = pm->mb_indcs;
+  int &ng = indcs.ng;
+  int nmb = pmbp->nmb_thispack;
+  int nvar = outvars.size();
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  conduit::index_t ncells = n3*n2*n1;
+
+#if FIELD_LAYOUT_LEFT
+  // copy variables into contiguous (m,n,k,j,i) array on device
+  if (staged.extent_int(0) != nmb || staged.extent_int(1) != nvar) {
+    Kokkos::realloc(staged, nmb, nvar, n3, n2, n1);
+  }
+  auto staged_ = staged;
+  for (int n=0; n<nvar; ++n) {
+    auto a_ = *(outvars[n].data_ptr);
+    int index = outvars[n].data_index;
+    par_for("ascent_stage", DevExeSpace(), 0, nmb-1, 0, n3-1, 0, n2-1, 0, n1-1,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      staged_(m,n,k,j,i) = a_(m,index,k,j,i);
+    });
+  }
+#endif
+
+  auto &size = pmbp->pmb->mb_size;
+  conduit::Node &mesh = *mesh_node;
+  mesh.reset();
+  for (int m=0; m<nmb; ++m) {
+    conduit::Node &dom = mesh.append();
+    dom["state/domain_id"] = pmbp->gids + m;
+    dom["state/cycle"] = pm->ncycle;
+    dom["state/time"] = pm->time;
+
+    // uniform coordinates of cell faces, including ghost zones
+    conduit::Node &coords = dom["coordsets/coords"];
+    coords["type"] = "uniform";
+    coords["dims/i"] = n1 + 1;
+    coords["origin/x"] = size.h_view(m).x1min - ng*size.h_view(m).dx1;
+    coords["spacing/dx"] = size.h_view(m).dx1;
+    if (pm->multi_d) {
+      coords["dims/j"] = n2 + 1;
+      coords["origin/y"] = size.h_view(m).x2min - ng*size.h_view(m).dx2;
+      coords["spacing/dy"] = size.h_view(m).dx2;
+    }
+    if (pm->three_d) {
+      coords["dims/k"] = n3 + 1;
+      coords["origin/z"] = size.h_view(m).x3min - ng*size.h_view(m).dx3;
+      coords["spacing/dz"] = size.h_view(m).dx3;
+    }
+    dom["topologies/topo/type"] = "uniform";
+    dom["topologies/topo/coordset"] = "coords";
+
+    conduit::Node &fields = dom["fields"];
+    fields["ascent_ghosts/association"] = "element";
+    fields["ascent_ghosts/topology"] = "topo";
+    fields["ascent_ghosts/values"].set_external(ghosts.data(), ncells);
+    for (int n=0; n<nvar; ++n) {
+      conduit::Node &fld = fields[outvars[n].label];
+      fld["association"] = "element";
+      fld["topology"] = "topo";
+      // pointers are computed on the host, since the arrays may be in device memory
+#if FIELD_LAYOUT_LEFT
+      fld["values"].set_external(staged.data() + (m*nvar + n)*ncells, ncells);
+#else
+      auto &a = *(outvars[n].data_ptr);
+      fld["values"].set_external(a.data() + (m*a.extent_int(1) + outvars[n].data_index)
+                                 *ncells, ncells);
+#endif
+    }
+  }
+#endif // ASCENT_ENABLED
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void AscentOutput::WriteOutputFile()
+//! \brief Publishes the mesh to Ascent and executes the actions in the actions file
+
+void AscentOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+#if ASCENT_ENABLED
+  Kokkos::fence();  // wrapped arrays must be complete before Ascent reads them
+  pascent->publish(*mesh_node);
+  conduit::Node actions;  // empty, so the actions file is used
+  pascent->execute(actions);
+#endif // ASCENT_ENABLED
+
+  // increment counters for next output, and store in ParameterInput object
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
@@ -7,6 +7,7 @@
 //
 
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>   // std::string, to_string()
 #include <cstdio> // snprintf
@@ -22,17 +23,21 @@
 #include "globals.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
 #include "coordinates/adm.hpp"
 #include "z4c/tmunu.hpp"
 #include "z4c/z4c.hpp"
 #include "srcterms/srcterms.hpp"
 #include "srcterms/turb_driver.hpp"
+#include "chemistry/chemistry.hpp"
 #include "outputs.hpp"
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
 #endif
 
+std::map<std::string, BaseTypeOutput::StagedSelection> BaseTypeOutput::staged_data;
+
 //----------------------------------------------------------------------------------------
 // BaseTypeOutput base class constructor
 // Creates vector of output variable data
@@ -42,10 +47,11 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
     outarray("cc_outvar",1,1,1,1,1),
     outfield("fc_outvar",1,1,1,1),
     out_params(opar) {
-  // exit for history, restart, or event log files
+  // exit for history, restart, event log, or task profile files
   if (out_params.file_type.compare("hst") == 0 ||
       out_params.file_type.compare("rst") == 0 ||
       out_params.file_type.compare("log") == 0 ||
+      out_params.file_type.compare("prof") == 0 ||
       out_params.file_type.compare("trk") == 0) {return;}
 
   // initialize vector containing number of output MBs per rank
@@ -159,6 +165,26 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
        << std::endl << "Input file is likely missing corresponding block" << std::endl;
     exit(EXIT_FAILURE);
   }
+  if ((ivar==152) && ((pm->pmb_pack->pdyngr == nullptr) ||
+                      (pm->pmb_pack->pdyngr->GetC2PData() == nullptr))) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+       << "Output of C2P iterations requested in <output> block '"
+       << out_params.block_name << "' but they are not being saved." << std::endl
+       << "Set <mhd>/c2p_save_iter=true with dynamical GRMHD" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  Chemistry *pchem = nullptr;
+  if (pm->pmb_pack->phydro != nullptr) {pchem = pm->pmb_pack->phydro->pchem;}
+  if (pm->pmb_pack->pmhd != nullptr && pm->pmb_pack->pmhd->pchem != nullptr) {
+    pchem = pm->pmb_pack->pmhd->pchem;
+  }
+  if ((ivar==153) && (pchem == nullptr)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+       << "Output of chemistry work requested in <output> block '"
+       << out_params.block_name << "' but no Chemistry object has been constructed."
+       << std::endl << "Input file is likely missing a <chemistry> block" << std::endl;
+    exit(EXIT_FAILURE);
+  }
 
   // Now load STL vector of output variables
   outvars.clear();
@@ -585,6 +611,16 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
       outvars.emplace_back("force3",2,&(pm->pmb_pack->pturb->force));
     }
 
+    // number of primitive solver iterations in each cell
+    if (variable.compare("dyn_c2p_iter") == 0) {
+      outvars.emplace_back("c2p_iter",1,pm->pmb_pack->pdyngr->GetC2PData());
+    }
+
+    // number of Rosenbrock steps of reaction network in each cell
+    if (variable.compare("chem_work") == 0) {
+      outvars.emplace_back("chem_work",0,&(pchem->work));
+    }
+
     // ADM variables, excluding gauge
     for (int v = 0; v < adm::ADM::nadm - 4; ++v) {
       if (variable.compare("adm") == 0 ||
@@ -794,31 +830,105 @@ void BaseTypeOutput::LoadOutputData(Mesh *pm) {
   if (out_params.contains_derived) {
     ComputeDerivedVariable(out_params.variable, pm);
   }
-
-  // Now copy data to host (outarray) over all variables and MeshBlocks
+  if (nout_mbs == 0) {return;}
+
+  // Slices and MB subsets are extracted on the device, so only output data is copied.
+  SetOutputMeshBlockIndices(pm);
+  int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
+  int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
+  int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
+  if (d_outarray.extent_int(0) != nout_vars || d_outarray.extent_int(1) != nout_mbs ||
+      d_outarray.extent_int(2) != nout3 || d_outarray.extent_int(3) != nout2 ||
+      d_outarray.extent_int(4) != nout1) {
+    Kokkos::realloc(d_outarray, nout_vars, nout_mbs, nout3, nout2, nout1);
+  }
+  auto &d_out = d_outarray;
+  auto &mbindcs = outmb_indcs;
+
+  // Variables already staged on host in this cycle by an output with the same selection
+  // of cells are copied on the host.  Only the others are extracted on the device and
+  // copied to the host, at once if there are no staged variables.
+  auto &stage = staged_data[OutputSelectionKey()];
+  if (stage.ncycle != pm->ncycle || stage.time != pm->time) {
+    stage.ncycle = pm->ncycle;
+    stage.time = pm->time;
+    stage.vars.clear();
+  }
+  std::vector<int> nload;
   for (int n=0; n<nout_vars; ++n) {
-    for (int m=0; m<nout_mbs; ++m) {
-      int mbi = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
-      std::pair<int,int> irange = std::make_pair(outmbs[m].ois, outmbs[m].oie+1);
-      std::pair<int,int> jrange = std::make_pair(outmbs[m].ojs, outmbs[m].oje+1);
-      std::pair<int,int> krange = std::make_pair(outmbs[m].oks, outmbs[m].oke+1);
-      int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
-      int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
-      int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
-
-      // copy output variable to new device View
-      DvceArray3D<Real> d_output_var("d_out_var",nout3,nout2,nout1);
-      auto d_slice = Kokkos::subview(*(outvars[n].data_ptr), mbi, outvars[n].data_index,
-                                     krange,jrange,irange);
-      Kokkos::deep_copy(d_output_var,d_slice);
-
-      // copy new device View to host mirror View
-      DvceArray3D<Real>::HostMirror h_output_var = Kokkos::create_mirror(d_output_var);
-      Kokkos::deep_copy(h_output_var,d_output_var);
-
-      // copy host mirror to 5D host View containing all output variables
-      auto h_slice = Kokkos::subview(outarray,n,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(h_slice,h_output_var);
+    auto key = std::make_pair(outvars[n].data_ptr->data(), outvars[n].data_index);
+    auto staged = stage.vars.find(key);
+    if (staged != stage.vars.end() &&
+        staged->second.data.extent_int(1) == nout_mbs &&
+        staged->second.data.extent_int(2) == nout3 &&
+        staged->second.data.extent_int(3) == nout2 &&
+        staged->second.data.extent_int(4) == nout1) {
+      Kokkos::deep_copy(
+        Kokkos::subview(outarray, n, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL),
+        Kokkos::subview(staged->second.data, staged->second.n, Kokkos::ALL, Kokkos::ALL,
+                        Kokkos::ALL, Kokkos::ALL));
+    } else {
+      nload.push_back(n);
     }
   }
+
+  for (int n : nload) {
+    // copy output variable into device outarray, converting to output precision
+    auto var = *(outvars[n].data_ptr);
+    int index = outvars[n].data_index;
+    par_for("out_var", DevExeSpace(), 0, nout_mbs-1, 0, nout3-1, 0, nout2-1, 0, nout1-1,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      d_out(n,m,k,j,i) = var(mbindcs.d_view(m,0), index, k + mbindcs.d_view(m,3),
+                             j + mbindcs.d_view(m,2), i + mbindcs.d_view(m,1));
+    });
+  }
+  if (static_cast<int>(nload.size()) == nout_vars) {
+    Kokkos::deep_copy(outarray, d_outarray);
+  } else {
+    for (int n : nload) {
+      Kokkos::deep_copy(
+        Kokkos::subview(outarray, n, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL),
+        Kokkos::subview(d_outarray, n, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
+                        Kokkos::ALL));
+    }
+  }
+  for (int n : nload) {
+    auto key = std::make_pair(outvars[n].data_ptr->data(), outvars[n].data_index);
+    stage.vars[key] = {outarray, n};
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// BaseTypeOutput::OutputSelectionKey()
+// returns a string identifying the cells selected for output (ghost zones, slices, and
+// MeshBlock), which together with the cycle determines the output MBs and indices
+
+std::string BaseTypeOutput::OutputSelectionKey() const {
+  std::stringstream key;
+  key.precision(17);
+  key << out_params.include_gzs << "," << out_params.gid;
+  if (out_params.slice1) {key << ",x1=" << out_params.slice_x1;}
+  if (out_params.slice2) {key << ",x2=" << out_params.slice_x2;}
+  if (out_params.slice3) {key << ",x3=" << out_params.slice_x3;}
+  return key.str();
+}
+
+//----------------------------------------------------------------------------------------
+// BaseTypeOutput::SetOutputMeshBlockIndices()
+// stores index in MeshBlockPack and starting indices of each output MB in outmb_indcs,
+// so output data can be extracted from all MBs with one kernel per variable
+
+void BaseTypeOutput::SetOutputMeshBlockIndices(Mesh *pm) {
+  int nout_mbs = outmbs.size();
+  if (outmb_indcs.extent_int(0) != nout_mbs) {
+    Kokkos::realloc(outmb_indcs, nout_mbs, 4);
+  }
+  for (int m=0; m<nout_mbs; ++m) {
+    outmb_indcs.h_view(m,0) = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
+    outmb_indcs.h_view(m,1) = outmbs[m].ois;
+    outmb_indcs.h_view(m,2) = outmbs[m].ojs;
+    outmb_indcs.h_view(m,3) = outmbs[m].oks;
+  }
+  outmb_indcs.template modify<HostMemSpace>();
+  outmb_indcs.template sync<DevExeSpace>();
 }
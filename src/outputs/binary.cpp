@@ -6,16 +6,28 @@
 //! \file binary.cpp
 //! \brief writes output data in binary format, which simply consists of each MeshBlock
 //! written contiguously in order of "gid" in binary format.
+//!
+//! With <output>/block_index=true (the default, except with aggregate=true) the data is
+//! followed by an index of the MeshBlocks in the file, so that readers can locate any MB
+//! without scanning the file.  The index consists of, for each MB in the file (in the
+//! order written), its gid, the offset of its record from the start of the file, and the
+//! size of its record in bytes; followed by the number of MBs; all as uint64.  The last
+//! 8 bytes of the file are the characters "ATHBIDX1".  Readers that find these 8 bytes at
+//! the end of a file should stop reading MB records at 16+24*(number of MBs) bytes
+//! before the end of the file.
 
 #include <sys/stat.h>  // mkdir
 
+#include <cstdint>
 #include <cstdio>      // fwrite(), fclose(), fopen(), fnprintf(), snprintf()
 #include <cstdlib>
+#include <cstring>     // memcpy()
 #include <iomanip>
 #include <iostream>
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <algorithm> // min
 
@@ -24,6 +36,7 @@
 #include "coordinates/cell_locations.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs.hpp"
+#include "output_compression.hpp"
 
 //----------------------------------------------------------------------------------------
 // Constructor: also calls BaseTypeOutput base class constructor
@@ -36,17 +49,95 @@ MeshBinaryOutput::MeshBinaryOutput(ParameterInput *pin, Mesh *pm, OutputParamete
   // achieve the best performance and not to crash the filesystem
   mkdir("bin",0775);
   bool single_file_per_rank = op.single_file_per_rank;
+
+  // With <output>/aggregate=true, ranks are divided into groups of the ranks on each node
+  // (at most <output>/ranks_per_file ranks per group), and the data of each group is
+  // gathered to the first rank in the group which writes one file.  Groups are numbered
+  // in order of their first rank.  Without aggregation each rank is its own group.
+  group_index = global_variable::my_rank;
+  group_eachrank.resize(global_variable::nranks);
+  std::iota(group_eachrank.begin(), group_eachrank.end(), 0);
+#if MPI_PARALLEL_ENABLED
+  group_comm = MPI_COMM_SELF;
+  if (out_params.aggregate) {
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                        MPI_INFO_NULL, &node_comm);
+    int node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+    int color = (out_params.ranks_per_file > 0)? node_rank/out_params.ranks_per_file : 0;
+    MPI_Comm_split(node_comm, color, node_rank, &group_comm);
+    MPI_Comm_free(&node_comm);
+
+    int first_rank = global_variable::my_rank;
+    MPI_Bcast(&first_rank, 1, MPI_INT, 0, group_comm);
+    MPI_Allgather(&first_rank, 1, MPI_INT, group_eachrank.data(), 1, MPI_INT,
+                  MPI_COMM_WORLD);
+    std::vector<int> first_ranks(group_eachrank);
+    std::sort(first_ranks.begin(), first_ranks.end());
+    first_ranks.erase(std::unique(first_ranks.begin(), first_ranks.end()),
+                      first_ranks.end());
+    for (auto &g : group_eachrank) {
+      g = std::lower_bound(first_ranks.begin(), first_ranks.end(), g)
+        - first_ranks.begin();
+    }
+  }
+#else
+  if (out_params.aggregate) {group_eachrank[0] = 0;}
+#endif
+  group_index = group_eachrank[global_variable::my_rank];
+
   if (single_file_per_rank) {
     char rank_dir[20];
-    std::snprintf(rank_dir, sizeof(rank_dir), "bin/rank_%08d/", global_variable::my_rank);
+    if (out_params.aggregate) {
+      std::snprintf(rank_dir, sizeof(rank_dir), "bin/group_%08d/", group_index);
+    } else {
+      std::snprintf(rank_dir, sizeof(rank_dir), "bin/rank_%08d/",
+                    global_variable::my_rank);
+    }
     mkdir(rank_dir, 0775);
   }
+
+#if MPI_PARALLEL_ENABLED
+  // MPI-IO to a shared file (or gathering data to aggregated files) from the writer
+  // thread requires MPI_THREAD_MULTIPLE.  Shared files use their own communicator so
+  // that collectives of the writer thread never mix with the main thread's.
+  write_comm = MPI_COMM_WORLD;
+  if (out_params.async && (!single_file_per_rank || out_params.aggregate)) {
+    int provided;
+    MPI_Query_thread(&provided);
+    if (provided < MPI_THREAD_MULTIPLE) {
+      if (global_variable::my_rank == 0) {
+        std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Asynchronous output in <" << out_params.block_name
+                  << "> requires MPI_THREAD_MULTIPLE when writing a single file or "
+                  << "aggregated files, files will be written synchronously" << std::endl;
+      }
+      out_params.async = false;
+    } else if (!single_file_per_rank) {
+      MPI_Comm_dup(MPI_COMM_WORLD, &write_comm);
+    }
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor: waits for last file to be written
+
+MeshBinaryOutput::~MeshBinaryOutput() {
+  if (writer.joinable()) {writer.join();}
+#if MPI_PARALLEL_ENABLED
+  if (write_comm != MPI_COMM_WORLD) {MPI_Comm_free(&write_comm);}
+  if (group_comm != MPI_COMM_SELF) {MPI_Comm_free(&group_comm);}
+#endif
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBinaryOutput:::WriteOutputFile(Mesh *pm)
-//  \brief Cycles over all MeshBlocks and writes OutputData in binary format
-//   All MeshBlocks are written to the same file.
+//  \brief Cycles over all MeshBlocks and packs OutputData in binary format, then writes
+//   the file.  All MeshBlocks are written to the same file.  With <output>/async=true,
+//   the packed data is written by a background thread, so the time loop only waits if
+//   the previous file of this output is still being written.
 
 void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // check if slicing
@@ -58,11 +149,15 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   bool single_file_per_rank = out_params.single_file_per_rank;
   std::string fname;
   if (single_file_per_rank) {
-    // Generate a directory and filename for each rank
+    // Generate a directory and filename for each rank (or group of ranks)
     char rank_dir[20];
     char number[7];
     std::snprintf(number, sizeof(number), ".%05d", out_params.file_number);
-    std::snprintf(rank_dir, sizeof(rank_dir), "rank_%08d/", global_variable::my_rank);
+    if (out_params.aggregate) {
+      std::snprintf(rank_dir, sizeof(rank_dir), "group_%08d/", group_index);
+    } else {
+      std::snprintf(rank_dir, sizeof(rank_dir), "rank_%08d/", global_variable::my_rank);
+    }
     fname = std::string("bin/") + std::string(rank_dir) + out_params.file_basename
           + "." + out_params.file_id + number + ".bin";
   } else {
@@ -73,34 +168,36 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
           + "." + out_params.file_id + number + ".bin";
   }
 
-  IOWrapper binfile;
+  BinaryFile file;
+  file.fname = fname;
   std::size_t header_offset=0;
-  binfile.Open(fname.c_str(), IOWrapper::FileMode::write, single_file_per_rank);
 
   // Basic parts of the format:
   // 1. Size of the header
   // 2. Current time
   // 3. List of variables in the file
   // 4. Header (input file information)
+  // Compressed files (version=1.2) have an additional preheader line
+  bool compress = (out_params.compression.compare("zstd") == 0);
   {
     std::stringstream msg;
-    msg << "Athena binary output version=1.1" << std::endl
+    msg << "Athena binary output version=" << ((compress)? "1.2" : "1.1") << std::endl
         // preheader size includes "size of preheader" line up to "number of variables"
-        << "  size of preheader=5" << std::endl
+        << "  size of preheader=" << ((compress)? 6 : 5) << std::endl
         << "  time=" << pm->time << std::endl
         << "  cycle=" << pm->ncycle << std::endl
         << "  size of location=" << sizeof(Real) << std::endl
-        << "  size of variable=" << sizeof(float) << std::endl
-        << "  number of variables=" << outvars.size() << std::endl
+        << "  size of variable=" << sizeof(float) << std::endl;
+    if (compress) {
+      msg << "  compression=zstd" << std::endl;
+    }
+    msg << "  number of variables=" << outvars.size() << std::endl
         << "  variables:  ";
     for (int n=0; n<outvars.size(); n++) {
       msg << outvars[n].label.c_str() << "  ";
     }
     msg << std::endl;
-    if (global_variable::my_rank == 0 || single_file_per_rank) {
-      binfile.Write_any_type(msg.str().c_str(),msg.str().size(),"byte",
-                             single_file_per_rank);
-    }
+    file.header += msg.str();
     header_offset += msg.str().size();
   }
   {
@@ -110,11 +207,8 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     pin->ParameterDump(ost);
     std::string sbuf=ost.str();
     msg << "  header offset=" << sbuf.size()*sizeof(char)  << std::endl;
-    if (global_variable::my_rank == 0 || single_file_per_rank) {
-      binfile.Write_any_type(msg.str().c_str(),msg.str().size(),"byte",
-                             single_file_per_rank);
-      binfile.Write_any_type(sbuf.c_str(),sbuf.size(),"byte", single_file_per_rank);
-    }
+    file.header += msg.str();
+    file.header += sbuf;
     header_offset += sbuf.size()*sizeof(char);
     header_offset += msg.str().size();
   }
@@ -141,8 +235,9 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   int nb_mbs = pm->nmb_eachrank[global_variable::my_rank];
 
   // allocate 1D vector of floats used to convert and output data
-  char *data = new char[nb_mbs*data_size];
-  float *single_data = new float[cells];
+  file.data.resize(nb_mbs*data_size);
+  char *data = file.data.data();
+  std::vector<float> single_data(cells);
 
   // Loop over MeshBlocks
   for (int m=0; m<nout_mbs; ++m) {
@@ -224,83 +319,70 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
           }
         }
       }
-      memcpy(pdata,single_data,cells*sizeof(float));
+      memcpy(pdata,single_data.data(),cells*sizeof(float));
       pdata+=cells*sizeof(float);
     }
   }
 
-  // now write binary data
+  // set offsets at which data is written
+  file.data_size = data_size;
+  file.by_meshblock = false;
+  file.noutmbs_min = 0;
   if (bin_slice) {
     std::vector<int> rank_offset(global_variable::nranks, 0);
     std::partial_sum(noutmbs.begin(),std::prev(noutmbs.end()),
                      std::next(rank_offset.begin()));
-    std::size_t myoffset = header_offset+data_size*rank_offset[global_variable::my_rank];
+    file.myoffset = header_offset+data_size*rank_offset[global_variable::my_rank];
 
     if (single_file_per_rank) {
-      myoffset = header_offset;  // Reset offset for individual files
-    }
-
-    if (noutmbs_min > 0) {
-      binfile.Write_any_type_at_all(data,(data_size*nout_mbs),myoffset,"byte",
-                                    single_file_per_rank);
-    } else {
-      if (nout_mbs > 0) {
-        binfile.Write_any_type_at(data,(data_size*nout_mbs),myoffset,"byte",
-                                    single_file_per_rank);
-      }
+      file.myoffset = header_offset;  // Reset offset for individual files
     }
+    file.nout_mbs = nout_mbs;
+    file.collective = (noutmbs_min > 0);
   } else {
+    file.myoffset = header_offset;
+    if (!single_file_per_rank) {
+      file.myoffset += data_size*ns_mbs;
+    }
+    file.nout_mbs = nb_mbs;
+    file.collective = true;
     // check if elements larger than 2^31
-    if (data_size*nb_mbs<=2147483648) {
-      // now write binary data in parallel
-      std::size_t myoffset = header_offset;
-      if (!single_file_per_rank) {
-        myoffset += data_size*ns_mbs;
-      }
-      binfile.Write_any_type_at_all(data,(data_size*nb_mbs),myoffset,"byte",
-                                    single_file_per_rank);
-    } else {
+    if (data_size*nb_mbs > 2147483648) {
       // write data over each MeshBlock sequentially and in parallel
-      // calculate max/min number of MeshBlocks across all ranks
-      noutmbs_max = pm->nmb_eachrank[0];
-      noutmbs_min = pm->nmb_eachrank[0];
+      // calculate min number of MeshBlocks across all ranks
+      file.by_meshblock = true;
+      file.noutmbs_min = pm->nmb_eachrank[0];
       for (int i=0; i<(global_variable::nranks); ++i) {
-        noutmbs_max = std::max(noutmbs_max,pm->nmb_eachrank[i]);
-        noutmbs_min = std::min(noutmbs_min,pm->nmb_eachrank[i]);
-      }
-      for (int m=0;  m<noutmbs_max; ++m) {
-        char *pdata=&(data[m*data_size]);
-        std::size_t myoffset = header_offset + data_size*m;
-        if (!single_file_per_rank) {
-          myoffset += data_size*ns_mbs;
-        }
-        // every rank has a MB to write, so write collectively
-        if (m < noutmbs_min) {
-          if (binfile.Write_any_type_at_all(pdata,(data_size),myoffset,"byte",
-                                              single_file_per_rank) != data_size) {
-            std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "binary data not written correctly to binary file, "
-                << "binary file is broken." << std::endl;
-            exit(EXIT_FAILURE);
-          }
-        // some ranks are finished writing, so use non-collective write
-        } else if (m < pm->nmb_thisrank) {
-          if (binfile.Write_any_type_at(pdata,(data_size),myoffset,"byte",
-                                          single_file_per_rank) != data_size) {
-            std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                 << std::endl << "binary data not written correctly to binary file, "
-                 << "binary file is broken." << std::endl;
-            exit(EXIT_FAILURE);
-          }
-        }
+        file.noutmbs_min = std::min(file.noutmbs_min,pm->nmb_eachrank[i]);
       }
     }
   }
 
-  // close the output file and clean up ptrs to data
-  binfile.Close(single_file_per_rank);
-  delete [] data;
-  delete [] single_data;
+  if (out_params.block_index) {
+    for (int m=0; m<file.nout_mbs; ++m) {
+      file.gids.push_back((bin_slice)? outmbs[m].mb_gid : ns_mbs + m);
+    }
+  }
+
+  // with compression, data is compressed by WriteBinaryFile() (on the writer thread if
+  // async), with the rounding of each variable set here
+  if (compress) {
+    std::vector<std::string> labels;
+    for (auto &var : outvars) {labels.push_back(var.label);}
+    file.nbits = CompressionMantissaBits(pin, out_params.block_name,
+                                         out_params.lossy_tolerance, labels);
+    file.nvars = nout_vars;
+    file.ncells = cells;
+  }
+
+  // with aggregation, write index of aggregated files
+  if (out_params.aggregate && global_variable::my_rank == 0) {
+    std::vector<int> nmbs_eachrank(global_variable::nranks);
+    for (int r=0; r<global_variable::nranks; ++r) {
+      nmbs_eachrank[r] = (bin_slice)? noutmbs[r] : pm->nmb_eachrank[r];
+    }
+    WriteGroupIndex(nmbs_eachrank, header_offset, data_size);
+  }
 
   // increment counters
   out_params.file_number++;
@@ -312,5 +394,267 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
   pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
 
+  // write file, in background if async (after previous file has been written)
+  if (writer.joinable()) {writer.join();}
+  if (out_params.async) {
+    writer = std::thread([this, f = std::move(file)]() {WriteBinaryFile(f);});
+  } else {
+    WriteBinaryFile(file);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBinaryOutput::WriteBinaryFile()
+//  \brief Writes header and packed data of one file.  Only uses data stored in file, so
+//   that it can be called from the writer thread.
+
+void MeshBinaryOutput::WriteBinaryFile(const BinaryFile &file) {
+  bool compress = (out_params.compression.compare("zstd") == 0);
+  std::vector<char> cdata;
+  if (compress) {
+    const std::size_t prefix_size = 10*sizeof(int32_t) + 6*sizeof(Real);
+    cdata = CompressRecords(file.data.data(), file.nout_mbs, file.data_size, prefix_size,
+                            file.nvars, file.ncells, file.nbits,
+                            out_params.compression_level);
+  }
+  if (out_params.aggregate) {
+    if (compress) {
+      WriteAggregatedFile(file, cdata.data(), cdata.size());
+    } else {
+      WriteAggregatedFile(file, file.data.data(), file.data_size*file.nout_mbs);
+    }
+    return;
+  }
+  bool single_file_per_rank = out_params.single_file_per_rank;
+  IOWrapper binfile;
+#if MPI_PARALLEL_ENABLED
+  binfile.SetCommunicator(write_comm);
+#endif
+  binfile.Open(file.fname.c_str(), IOWrapper::FileMode::write, single_file_per_rank);
+  if (global_variable::my_rank == 0 || single_file_per_rank) {
+    binfile.Write_any_type(file.header.c_str(),file.header.size(),"byte",
+                           single_file_per_rank);
+  }
+  if (compress) {
+    std::uint64_t myoffset = WriteCompressedData(binfile, cdata, file.header.size(),
+                                                 single_file_per_rank);
+    if (out_params.block_index) {
+      // sizes of compressed records: indices/coordinates, then size and data of each var
+      std::vector<std::uint64_t> offsets, sizes;
+      const std::size_t prefix_size = 10*sizeof(int32_t) + 6*sizeof(Real);
+      std::size_t pos = 0;
+      for (int m=0; m<file.nout_mbs; ++m) {
+        std::size_t start = pos;
+        pos += prefix_size;
+        for (int n=0; n<file.nvars; ++n) {
+          std::uint64_t csize;
+          std::memcpy(&csize, &cdata[pos], sizeof(std::uint64_t));
+          pos += sizeof(std::uint64_t) + csize;
+        }
+        offsets.push_back(myoffset + start);
+        sizes.push_back(pos - start);
+      }
+      WriteBlockIndex(binfile, file, offsets, sizes);
+    }
+    binfile.Close(single_file_per_rank);
+    return;
+  }
+
+  // now write binary data
+  const char *data = file.data.data();
+  std::size_t data_size = file.data_size;
+  if (!file.by_meshblock) {
+    if (file.collective) {
+      binfile.Write_any_type_at_all(data,(data_size*file.nout_mbs),file.myoffset,"byte",
+                                    single_file_per_rank);
+    } else if (file.nout_mbs > 0) {
+      binfile.Write_any_type_at(data,(data_size*file.nout_mbs),file.myoffset,"byte",
+                                single_file_per_rank);
+    }
+  } else {
+    for (int m=0;  m<file.nout_mbs; ++m) {
+      const char *pdata=&(data[m*data_size]);
+      std::size_t myoffset = file.myoffset + data_size*m;
+      // every rank has a MB to write, so write collectively
+      if (m < file.noutmbs_min) {
+        if (binfile.Write_any_type_at_all(pdata,(data_size),myoffset,"byte",
+                                            single_file_per_rank) != data_size) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "binary data not written correctly to binary file, "
+              << "binary file is broken." << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      // some ranks are finished writing, so use non-collective write
+      } else {
+        if (binfile.Write_any_type_at(pdata,(data_size),myoffset,"byte",
+                                        single_file_per_rank) != data_size) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+               << std::endl << "binary data not written correctly to binary file, "
+               << "binary file is broken." << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      }
+    }
+  }
+
+  if (out_params.block_index) {
+    std::vector<std::uint64_t> offsets, sizes;
+    for (int m=0; m<file.nout_mbs; ++m) {
+      offsets.push_back(file.myoffset + data_size*m);
+      sizes.push_back(data_size);
+    }
+    WriteBlockIndex(binfile, file, offsets, sizes);
+  }
+
+  // close the output file
+  binfile.Close(single_file_per_rank);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBinaryOutput::WriteBlockIndex()
+//  \brief Gathers gid, offset and size of the records of all MBs in the file to rank 0
+//   (or not at all if single_file_per_rank), which appends the index after the last
+//   record.  Collective over all ranks writing the file.
+
+void MeshBinaryOutput::WriteBlockIndex(IOWrapper &binfile, const BinaryFile &file,
+                                       const std::vector<std::uint64_t> &offsets,
+                                       const std::vector<std::uint64_t> &sizes) {
+  bool single_file_per_rank = out_params.single_file_per_rank;
+  std::vector<std::uint64_t> index;
+  for (int m=0; m<file.nout_mbs; ++m) {
+    index.push_back(file.gids[m]);
+    index.push_back(offsets[m]);
+    index.push_back(sizes[m]);
+  }
+#if MPI_PARALLEL_ENABLED
+  if (!single_file_per_rank) {
+    int nlocal = index.size();
+    std::vector<int> counts(global_variable::nranks), displs(global_variable::nranks, 0);
+    MPI_Gather(&nlocal, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, write_comm);
+    std::vector<std::uint64_t> all_index;
+    if (global_variable::my_rank == 0) {
+      std::partial_sum(counts.begin(), std::prev(counts.end()),
+                       std::next(displs.begin()));
+      all_index.resize(displs.back() + counts.back());
+    }
+    MPI_Gatherv(index.data(), nlocal, MPI_UINT64_T, all_index.data(), counts.data(),
+                displs.data(), MPI_UINT64_T, 0, write_comm);
+    index = std::move(all_index);
+  }
+#endif
+  if (global_variable::my_rank != 0 && !single_file_per_rank) {return;}
+
+  // index starts after the end of the last record (or the header if there are none)
+  std::uint64_t nmbs = index.size()/3;
+  std::uint64_t end = file.header.size();
+  for (std::uint64_t m=0; m<nmbs; ++m) {
+    end = std::max(end, index[3*m+1] + index[3*m+2]);
+  }
+  index.push_back(nmbs);
+  std::size_t nbytes = index.size()*sizeof(std::uint64_t);
+  std::vector<char> footer(nbytes + 8);
+  std::memcpy(footer.data(), index.data(), nbytes);
+  std::memcpy(footer.data() + nbytes, "ATHBIDX1", 8);
+  if (binfile.Write_any_type_at(footer.data(), footer.size(), end, "byte",
+                                single_file_per_rank) != footer.size()) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "block index not written correctly to binary file, "
+              << "binary file is broken." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBinaryOutput::WriteAggregatedFile()
+//  \brief Gathers (packed or compressed) data of all ranks in group to first rank of
+//   group, which writes the header followed by the data of each rank in order.  Data is
+//   received from one rank at a time (in messages smaller than 2^31 bytes), so the first
+//   rank only needs to store data of one other rank at a time.
+
+void MeshBinaryOutput::WriteAggregatedFile(const BinaryFile &file, const char *data,
+                                           std::size_t nbytes) {
+  int group_rank = 0;
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_rank(group_comm, &group_rank);
+  const std::size_t max_msg = (1 << 30);
+#endif
+  if (group_rank == 0) {
+    IOWrapper binfile;
+    binfile.Open(file.fname.c_str(), IOWrapper::FileMode::write, true);
+    binfile.Write_any_type(file.header.c_str(), file.header.size(), "byte", true);
+    bool ok = (binfile.Write_any_type(data, nbytes, "byte", true) == nbytes);
+#if MPI_PARALLEL_ENABLED
+    std::vector<char> buf;
+    int group_size;
+    MPI_Comm_size(group_comm, &group_size);
+    for (int r=1; r<group_size; ++r) {
+      std::uint64_t size64;
+      MPI_Recv(&size64, 1, MPI_UINT64_T, r, 0, group_comm, MPI_STATUS_IGNORE);
+      nbytes = size64;
+      buf.resize(nbytes);
+      for (std::size_t os=0; os<nbytes; os+=max_msg) {
+        int cnt = static_cast<int>(std::min(max_msg, nbytes - os));
+        MPI_Recv(buf.data() + os, cnt, MPI_BYTE, r, 0, group_comm, MPI_STATUS_IGNORE);
+      }
+      ok = ok && (binfile.Write_any_type(buf.data(), nbytes, "byte", true) == nbytes);
+    }
+#endif
+    if (!ok) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "binary data not written correctly to binary file, "
+                << "binary file is broken." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    binfile.Close(true);
+#if MPI_PARALLEL_ENABLED
+  } else {
+    std::uint64_t size64 = nbytes;
+    MPI_Send(&size64, 1, MPI_UINT64_T, 0, 0, group_comm);
+    for (std::size_t os=0; os<nbytes; os+=max_msg) {
+      int cnt = static_cast<int>(std::min(max_msg, nbytes - os));
+      MPI_Send(data + os, cnt, MPI_BYTE, 0, 0, group_comm);
+    }
+#endif
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBinaryOutput::WriteGroupIndex()
+//  \brief Writes text file listing, for every rank, the aggregated file that contains its
+//   MBs, the number of MBs, and the byte offset of its first MB in that file.  Offsets of
+//   compressed data are not known on this rank, and are written as -1.
+
+void MeshBinaryOutput::WriteGroupIndex(const std::vector<int> &nmbs_eachrank,
+                                       std::size_t header_size, std::size_t data_size) {
+  char number[7];
+  std::snprintf(number, sizeof(number), ".%05d", out_params.file_number);
+  std::string fname = std::string("bin/") + out_params.file_basename
+                    + "." + out_params.file_id + number + ".idx";
+  FILE *pfile;
+  if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Output file '" << fname << "' could not be opened"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::fprintf(pfile, "# aggregated files bin/group_XXXXXXXX/%s.%s%s.bin\n",
+               out_params.file_basename.c_str(), out_params.file_id.c_str(), number);
+  std::fprintf(pfile, "# rank  group  nmbs  offset\n");
+  bool compress = (out_params.compression.compare("zstd") == 0);
+  std::vector<std::size_t> group_offset(global_variable::nranks, header_size);
+  for (int r=0; r<global_variable::nranks; ++r) {
+    int g = group_eachrank[r];
+    if (compress) {
+      std::fprintf(pfile, "%d %d %d -1\n", r, g, nmbs_eachrank[r]);
+    } else {
+      std::fprintf(pfile, "%d %d %d %zu\n", r, g, nmbs_eachrank[r], group_offset[g]);
+    }
+    group_offset[g] += data_size*nmbs_eachrank[r];
+  }
+  std::fclose(pfile);
   return;
 }
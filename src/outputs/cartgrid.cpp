@@ -8,10 +8,13 @@
 
 #include <sys/stat.h>  // mkdir
 
+#include <cmath>
 #include <cstdio> // snprintf
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -19,6 +22,7 @@
 #include "outputs.hpp"
 #include "parameter_input.hpp"
 #include "utils/cart_grid.hpp"
+#include "utils/point_interpolator.hpp"
 
 CartesianGridOutput::CartesianGridOutput(ParameterInput *pin, Mesh *pm,
                                          OutputParameters op)
@@ -48,97 +52,110 @@ CartesianGridOutput::CartesianGridOutput(ParameterInput *pin, Mesh *pm,
     md.numpoints[d] = numpoints[d];
   }
   md.is_cheb = is_cheb;
+
+  // results are only needed on the root rank, which writes the file.  Points are
+  // ordered as in CartesianGrid, with x3 fastest.
+  int npts = (global_variable::my_rank == 0) ?
+             numpoints[0] * numpoints[1] * numpoints[2] : 0;
+  HostArray2D<Real> pos("cart_pos", npts, 3);
+  for (int n = 0; n < npts; ++n) {
+    int nz = n % pcart->nx3;
+    int ny = (n / pcart->nx3) % pcart->nx2;
+    int nx = n / (pcart->nx3 * pcart->nx2);
+    pos(n, 0) = pcart->min_x1 + nx * pcart->d_x1;
+    pos(n, 1) = pcart->min_x2 + ny * pcart->d_x2;
+    pos(n, 2) = pcart->min_x3 + nz * pcart->d_x3;
+    if (is_cheb) {
+      pos(n, 0) = pcart->center_x1 +
+                  pcart->extent_x1 * std::cos(nx * M_PI / (pcart->nx1 - 1));
+      pos(n, 1) = pcart->center_x2 +
+                  pcart->extent_x2 * std::cos(ny * M_PI / (pcart->nx2 - 1));
+      pos(n, 2) = pcart->center_x3 +
+                  pcart->extent_x3 * std::cos(nz * M_PI / (pcart->nx3 - 1));
+    }
+  }
+  // The interpolation plan (owning MeshBlocks and weights of all points) is kept until
+  // MeshBlocks change, so each output is one kernel per source array plus one exchange
+  pinterp = new PointInterpolator(pm->pmb_pack);
+  pinterp->SetPoints(pos);
+  Kokkos::realloc(outarray, outvars.size(), 1, numpoints[0], numpoints[1],
+                  numpoints[2]);
 }
 
-CartesianGridOutput::~CartesianGridOutput() { delete pcart; }
+CartesianGridOutput::~CartesianGridOutput() {
+  if (writer.joinable()) {writer.join();}
+  delete pcart;
+  delete pinterp;
+}
 
 void CartesianGridOutput::LoadOutputData(Mesh *pm) {
-  // If AMR is enabled we need to reset the CartesianGrid
-  if (pm->adaptive) {
-    pcart->SetInterpolationIndices();
-    pcart->SetInterpolationWeights();
-  }
-
   int nout_vars = outvars.size();
-  Kokkos::realloc(outarray, nout_vars, 1, md.numpoints[0], md.numpoints[1],
-                  md.numpoints[2]);
 
   // Calculate derived variables, if required
   if (out_params.contains_derived) {
     ComputeDerivedVariable(out_params.variable, pm);
   }
 
+  // interpolate all variables together.  Results are returned to the root rank only
+  std::vector<std::pair<const DvceArray5D<Real>*, int>> vars;
   for (int n = 0; n < nout_vars; ++n) {
-    pcart->InterpolateToGrid(outvars[n].data_index, *(outvars[n].data_ptr));
-    auto v_slice =
-        Kokkos::subview(outarray, n, 0, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-    Kokkos::deep_copy(v_slice, pcart->interp_vals.h_view);
+    vars.emplace_back(outvars[n].data_ptr, outvars[n].data_index);
   }
-#if MPI_PARALLEL_ENABLED
-  // Note that InterpolateToGrid will set zero values for points not owned by
-  // current rank
-  int count = nout_vars * md.numpoints[0] * md.numpoints[1] * md.numpoints[2];
-  if (0 == global_variable::my_rank) {
-    MPI_Reduce(MPI_IN_PLACE, outarray.data(), count, MPI_ATHENA_REAL, MPI_SUM,
-               0, MPI_COMM_WORLD);
-  } else {
-    MPI_Reduce(outarray.data(), outarray.data(), count, MPI_ATHENA_REAL,
-               MPI_SUM, 0, MPI_COMM_WORLD);
+  pinterp->Interpolate(vars);
+  for (int n = 0; n < nout_vars; ++n) {
+    for (int p = 0; p < pinterp->npoints; ++p) {
+      int k = p / (md.numpoints[1] * md.numpoints[2]);
+      int j = (p / md.numpoints[2]) % md.numpoints[1];
+      int i = p % md.numpoints[2];
+      outarray(n, 0, k, j, i) = pinterp->vals(p, n);
+    }
   }
-#endif
 }
 
 void CartesianGridOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
-#if MPI_PARALLEL_ENABLED
   if (0 == global_variable::my_rank) {
-#endif
-
     // Assemble filename
     char fname[BUFSIZ];
     std::snprintf(fname, BUFSIZ, "cart/%s.%s.%05d.bin",
                   out_params.file_basename.c_str(), out_params.file_id.c_str(),
                   out_params.file_number);
 
-    // Open file
-    std::ofstream ofile(fname, std::ios::binary);
-
-    // Write metadata
     md.cycle = pm->ncycle;
     md.time = pm->time;
     md.noutvars = outvars.size();
-    ofile.write(reinterpret_cast<char *>(&md), sizeof(MetaData));
 
-    // Write list of variables
-    {
-      std::stringstream msg;
-      for (int n = 0; n < md.noutvars - 1; ++n) {
-        msg << outvars[n].label << " ";
-      }
-      msg << outvars[md.noutvars - 1].label;
-      std::string smsg = msg.str();
-      int len = smsg.size();
-      ofile.write(reinterpret_cast<char *>(&len), sizeof(int));
-      ofile.write(smsg.c_str(), len);
+    // list of variables
+    std::stringstream msg;
+    for (int n = 0; n < md.noutvars - 1; ++n) {
+      msg << outvars[n].label << " ";
     }
-
-    // Write actual data
+    msg << outvars[md.noutvars - 1].label;
+
+    // Copy data in output order and precision.  Note that we are accessing the array
+    // with the convention of CartesianGrid which is opposite from the one used in the
+    // rest of the code, but we write the output as k, j, i
+    std::vector<float> data;
+    data.reserve(static_cast<std::size_t>(md.noutvars) * md.numpoints[0] *
+                 md.numpoints[1] * md.numpoints[2]);
     for (int n = 0; n < md.noutvars; ++n) {
       for (int k = 0; k < md.numpoints[2]; ++k) {
         for (int j = 0; j < md.numpoints[1]; ++j) {
           for (int i = 0; i < md.numpoints[0]; ++i) {
-            // Note that we are accessing the array with the convention of
-            // CartesianGrid which is opposite from the one used in the rest of
-            // the code, but we write the output as k, j, i
-            float var = outarray(n, 0, i, j, k);
-            ofile.write(reinterpret_cast<char *>(&var), sizeof(float));
+            data.push_back(static_cast<float>(outarray(n, 0, i, j, k)));
           }
         }
       }
     }
 
-#if MPI_PARALLEL_ENABLED
+    // write file, in background if async (after previous file has been written)
+    if (writer.joinable()) {writer.join();}
+    if (out_params.async) {
+      writer = std::thread([this, f = std::string(fname), m = md, l = msg.str(),
+                            d = std::move(data)]() {WriteCartFile(f, m, l, d);});
+    } else {
+      WriteCartFile(fname, md, msg.str(), data);
+    }
   }
-#endif
 
   // increment counters
   out_params.file_number++;
@@ -150,3 +167,19 @@ void CartesianGridOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
   pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void CartesianGridOutput::WriteCartFile()
+//  \brief Writes metadata, list of variables, and data of one file.  Only uses its
+//   arguments, so that it can be called from the writer thread.
+
+void CartesianGridOutput::WriteCartFile(const std::string &fname, const MetaData &mdata,
+                                        const std::string &labels,
+                                        const std::vector<float> &data) {
+  std::ofstream ofile(fname, std::ios::binary);
+  ofile.write(reinterpret_cast<const char *>(&mdata), sizeof(MetaData));
+  int len = labels.size();
+  ofile.write(reinterpret_cast<char *>(&len), sizeof(int));
+  ofile.write(labels.c_str(), len);
+  ofile.write(reinterpret_cast<const char *>(data.data()), data.size()*sizeof(float));
+}
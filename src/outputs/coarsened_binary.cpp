@@ -5,7 +5,9 @@
 //========================================================================================
 //! \file coarsened_binary.cpp
 //! \brief writes output data in binary format, which simply consists of each MeshBlock
-//! written contiguously in order of "gid" in binary format.
+//! written contiguously in order of "gid" in binary format.  With <output>/pyramid_levels
+//! > 1, levels of detail coarsened by further factors of 2 are computed on the device
+//! and written to the same file, each as a complete record, coarsest first.
 
 #include <sys/stat.h>  // mkdir
 
@@ -25,6 +27,7 @@
 #include "coordinates/cell_locations.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs.hpp"
+#include "output_compression.hpp"
 
 //----------------------------------------------------------------------------------------
 // Constructor: also calls BaseTypeOutput base class constructor
@@ -170,123 +173,108 @@ void CoarsenedBinaryOutput::LoadOutputData(Mesh *pm) {
     ComputeDerivedVariable(out_params.variable, pm);
   }
 
-  // Now copy data to host (outarray) over all variables and MeshBlocks
+  if (nout_mbs == 0) {return;}
+
+  // Slices and MB subsets are extracted, and data coarsened, on the device, so only
+  // coarsened data is copied to the host
+  SetOutputMeshBlockIndices(pm);
+  int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
+  int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
+  int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
+  int cf = out_params.coarsen_factor;
+  int cf_max = cf << (out_params.pyramid_levels - 1);
+  if (nout1 % cf_max != 0 || nout2 % cf_max != 0 || nout3 % cf_max != 0) {
+    std::cout << "Error: Full data dimensions are not divisible by coarsen_factor"
+    << ((out_params.pyramid_levels > 1)? " times 2^(pyramid_levels-1)" : "")
+    << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  int coarsened_nout1 = nout1/cf;
+  int coarsened_nout2 = nout2/cf;
+  int coarsened_nout3 = nout3/cf;
+  if (d_outarray.extent_int(0) != nout_vars_with_moments ||
+      d_outarray.extent_int(1) != nout_mbs ||
+      d_outarray.extent_int(2) != coarsened_nout3 ||
+      d_outarray.extent_int(3) != coarsened_nout2 ||
+      d_outarray.extent_int(4) != coarsened_nout1) {
+    Kokkos::realloc(d_outarray, nout_vars_with_moments, nout_mbs, coarsened_nout3,
+                    coarsened_nout2, coarsened_nout1);
+  }
+
+  // Each coarse cell averages the cf^3 fine cells it contains (and with compute_moments
+  // also their 2nd-4th powers), accumulated in Real then converted to output precision
+  int number_of_moments = (out_params.compute_moments)? 4 : 1;
+  Real ocf3 = 1.0/static_cast<Real>(cf*cf*cf);
+  auto &d_out = d_outarray;
+  auto &mbindcs = outmb_indcs;
   for (int n=0; n<nout_vars; ++n) {
-    for (int m=0; m<nout_mbs; ++m) {
-      int mbi = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
-      std::pair<int,int> irange = std::make_pair(outmbs[m].ois, outmbs[m].oie+1);
-      std::pair<int,int> jrange = std::make_pair(outmbs[m].ojs, outmbs[m].oje+1);
-      std::pair<int,int> krange = std::make_pair(outmbs[m].oks, outmbs[m].oke+1);
-      std::pair<int,int> moment_range;
-      if (out_params.compute_moments) {
-        moment_range = std::make_pair(n*4, n*4+4);
-      } else {
-        moment_range = std::make_pair(n, n+1);
-      }
-      int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
-      int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
-      int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
-      int coarsened_nout1 = nout1/out_params.coarsen_factor;
-      int coarsened_nout2 = nout2/out_params.coarsen_factor;
-      int coarsened_nout3 = nout3/out_params.coarsen_factor;
-
-      // copy output variable to new device View
-      DvceArray3D<Real> d_output_var("d_out_var",nout3,nout2,nout1);
-      auto d_slice = Kokkos::subview(*(outvars[n].data_ptr), mbi, outvars[n].data_index,
-                                     krange,jrange,irange);
-      Kokkos::deep_copy(d_output_var,d_slice);
-      Kokkos::fence(); // Ensure complete copy
-
-
-      int number_of_moments = 1;
-      if (out_params.compute_moments) {
-        number_of_moments = 4;
+    auto var = *(outvars[n].data_ptr);
+    int index = outvars[n].data_index;
+    int nmom = number_of_moments;
+    par_for("coarsen_variable", DevExeSpace(), 0, nout_mbs-1, 0, coarsened_nout3-1,
+            0, coarsened_nout2-1, 0, coarsened_nout1-1,
+    KOKKOS_LAMBDA(int m, int k_c, int j_c, int i_c) {
+      int mbi = mbindcs.d_view(m,0);
+      int is = mbindcs.d_view(m,1) + i_c*cf;
+      int js = mbindcs.d_view(m,2) + j_c*cf;
+      int ks = mbindcs.d_view(m,3) + k_c*cf;
+      Real sum[4] = {0.0, 0.0, 0.0, 0.0};
+      for (int kk=0; kk<cf; ++kk) {
+        for (int jj=0; jj<cf; ++jj) {
+          for (int ii=0; ii<cf; ++ii) {
+            Real u = var(mbi, index, ks+kk, js+jj, is+ii);
+            Real un = u;
+            sum[0] += un;
+            for (int l=1; l<nmom; ++l) {
+              un *= u;
+              sum[l] += un;
+            }
+          }
+        }
       }
-      DvceArray4D<Real> d_output_var_coarsened("d_output_var_coarsened",
-        number_of_moments, coarsened_nout3, coarsened_nout2, coarsened_nout1);
-
-      // Coarsen the d_slice and store the result in d_output_var
-      // CoarsenVariable(d_output_var, d_output_var_coarsened, out_params.coarsen_factor);
-      int coarsen_factor = out_params.coarsen_factor;
-      int coarsen_factor_cubed = coarsen_factor * coarsen_factor * coarsen_factor;
-
-      if (nout1 % coarsen_factor != 0 || nout2 % coarsen_factor != 0
-                                      || nout3 % coarsen_factor != 0) {
-          std::cout << "Error: Full data dimensions are not divisible by coarsen_factor"
-          << std::endl;
-          exit(EXIT_FAILURE);
+      for (int l=0; l<nmom; ++l) {
+        d_out(n*nmom + l, m, k_c, j_c, i_c) = sum[l]*ocf3;
       }
+    });
+  }
 
-      int total_iterations = coarsened_nout3
-        * coarsened_nout2 * coarsened_nout1 * coarsen_factor_cubed;
-
-      bool compute_moments = out_params.compute_moments;
-      Kokkos::parallel_for("coarsen_variable",
-       Kokkos::RangePolicy<DevExeSpace>(0, total_iterations),
-      KOKKOS_LAMBDA(const int idx) {
-        // Calculate the 3D indices for the coarsened data
-        int total_coarsened_elements = coarsened_nout1*coarsened_nout2*coarsened_nout3;
-        int k_c = (idx / (coarsened_nout2 * coarsened_nout1)) % coarsened_nout3;
-        int j_c = (idx / coarsened_nout1) % coarsened_nout2;
-        int i_c = idx % coarsened_nout1;
-
-        // Calculate the offset within the coarsen_factor_cubed cube
-        int offset = idx / total_coarsened_elements;
-        int kk = offset / (coarsen_factor * coarsen_factor);
-        int jj = (offset / coarsen_factor) % coarsen_factor;
-        int ii = offset % coarsen_factor;
-
-        // Calculate the corresponding indices in the full data
-        int k = k_c * coarsen_factor + kk;
-        int j = j_c * coarsen_factor + jj;
-        int i = i_c * coarsen_factor + ii;
-
-        // Perform the coarsening operation
-        if(k < nout3 && j < nout2 && i < nout1) {
-          Kokkos::atomic_add(&d_output_var_coarsened(0, k_c, j_c, i_c),
-            d_output_var(k, j, i));
-          if (compute_moments) {
-            Kokkos::atomic_add(&d_output_var_coarsened(1, k_c, j_c, i_c),
-              d_output_var(k, j, i)*d_output_var(k, j, i));
-            Kokkos::atomic_add(&d_output_var_coarsened(2, k_c, j_c, i_c),
-              d_output_var(k, j, i)*d_output_var(k, j, i)*d_output_var(k, j, i));
-            Kokkos::atomic_add(&d_output_var_coarsened(3, k_c, j_c, i_c),
-               d_output_var(k, j, i)*d_output_var(k, j, i)
-              *d_output_var(k, j, i)*d_output_var(k, j, i));
+  // Each further level of detail is restricted on the device from the previous one by
+  // averaging 2x2x2 cells, as in the restriction of CC variables in MeshRefinement
+  int nlev = out_params.pyramid_levels;
+  d_pyramid.resize(nlev-1);
+  pyramid.resize(nlev-1);
+  for (int l=1; l<nlev; ++l) {
+    auto prev = (l == 1)? d_outarray : d_pyramid[l-2];
+    int nc1 = prev.extent_int(4)/2;
+    int nc2 = prev.extent_int(3)/2;
+    int nc3 = prev.extent_int(2)/2;
+    auto &lev = d_pyramid[l-1];
+    if (lev.extent_int(0) != nout_vars_with_moments || lev.extent_int(1) != nout_mbs ||
+        lev.extent_int(2) != nc3 || lev.extent_int(3) != nc2 ||
+        lev.extent_int(4) != nc1) {
+      Kokkos::realloc(lev, nout_vars_with_moments, nout_mbs, nc3, nc2, nc1);
+    }
+    auto lev_ = lev;
+    par_for("pyramid_level", DevExeSpace(), 0, nout_vars_with_moments-1, 0, nout_mbs-1,
+            0, nc3-1, 0, nc2-1, 0, nc1-1,
+    KOKKOS_LAMBDA(int n, int m, int k, int j, int i) {
+      Real sum = 0.0;
+      for (int kk=0; kk<2; ++kk) {
+        for (int jj=0; jj<2; ++jj) {
+          for (int ii=0; ii<2; ++ii) {
+            sum += prev(n, m, 2*k+kk, 2*j+jj, 2*i+ii);
           }
         }
-      });
-      // Normalize the coarsened data
-      int normalize_iterations = number_of_moments * coarsened_nout3
-                                * coarsened_nout2 * coarsened_nout1;
-      Kokkos::parallel_for("normalize_coarsened_variable",
-        Kokkos::RangePolicy<DevExeSpace>(0, normalize_iterations),
-      KOKKOS_LAMBDA(const int idx) {
-        int moment_idx = idx / (coarsened_nout3 * coarsened_nout2 * coarsened_nout1);
-        int k = (idx / (coarsened_nout2 * coarsened_nout1)) % coarsened_nout3;
-        int j = (idx / coarsened_nout1) % coarsened_nout2;
-        int i = idx % coarsened_nout1;
-
-        d_output_var_coarsened(moment_idx, k, j, i) /= coarsen_factor_cubed;
-      });
-
-
-      // Now, create a host mirror for the coarsened data.
-      DvceArray4D<Real>::HostMirror h_output_var = Kokkos::create_mirror(
-        d_output_var_coarsened
-      );
-
-      // Copy the coarsened data to the host mirror.
-      Kokkos::deep_copy(h_output_var, d_output_var_coarsened);
-      Kokkos::fence(); // Ensure complete copy before using h_output_var on the host
-
-      // copy host mirror to 5D host View containing all output variables
-      // if (out_params.compute_moments) {
-      auto h_slice = Kokkos::subview(outarray,
-        moment_range,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL
-      );
-      Kokkos::deep_copy(h_slice,h_output_var);
-    }
+      }
+      lev_(n,m,k,j,i) = 0.125*sum;
+    });
+  }
+  Kokkos::deep_copy(outarray, d_outarray);
+  for (int l=1; l<nlev; ++l) {
+    Kokkos::realloc(pyramid[l-1], d_pyramid[l-1].extent_int(0),
+                    d_pyramid[l-1].extent_int(1), d_pyramid[l-1].extent_int(2),
+                    d_pyramid[l-1].extent_int(3), d_pyramid[l-1].extent_int(4));
+    Kokkos::deep_copy(pyramid[l-1], d_pyramid[l-1]);
   }
 }
 
@@ -326,9 +314,46 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   fname.append(".cbin");
 
   IOWrapper cbinfile;
-  std::size_t header_offset=0;
   cbinfile.Open(fname.c_str(), IOWrapper::FileMode::write, single_file_per_rank);
 
+  // With pyramid_levels > 1 every level of detail is stored as a complete record
+  // (preheader, input parameters, data), coarsest level first, so that readers can load
+  // coarse data progressively.
+  std::size_t offset = 0;
+  for (int l=out_params.pyramid_levels-1; l>=0; --l) {
+    offset = WriteLevel(pm, pin, cbinfile, offset, (l == 0)? outarray : pyramid[l-1],
+                        out_params.coarsen_factor << l);
+  }
+
+  // close the output file
+  cbinfile.Close(single_file_per_rank);
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::size_t CoarsenedBinaryOutput:::WriteLevel()
+//  \brief Writes one level of detail with coarsening factor cf, stored in data, at offset
+//   in the file.  Returns the offset of the end of the record.
+
+std::size_t CoarsenedBinaryOutput::WriteLevel(Mesh *pm, ParameterInput *pin,
+                                              IOWrapper &cbinfile, std::size_t offset,
+                                              const HostIOArray5D<OutReal> &data_in,
+                                              int cf) {
+  bool single_file_per_rank = out_params.single_file_per_rank;
+  bool pyramid_output = (out_params.pyramid_levels > 1);
+  std::size_t header_offset=offset;
+
   int number_of_moments = 1;
   if (out_params.compute_moments) {
     number_of_moments = 4;
@@ -339,17 +364,26 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // 2. Current time
   // 3. List of variables in the file
   // 4. Header (input file information)
+  // Compressed files (version=1.2) and levels of a pyramid have an additional preheader
+  // line each
+  bool compress = (out_params.compression.compare("zstd") == 0);
   {std::stringstream msg;
-  msg << "Athena binary output version=1.1" << std::endl
+  msg << "Athena binary output version=" << ((compress)? "1.2" : "1.1") << std::endl
       // preheader size includes "size of preheader" line up to "number of variables"
-      << "  size of preheader=7" << std::endl
+      << "  size of preheader=" << 7 + compress + pyramid_output << std::endl
       << "  time=" << pm->time << std::endl
       << "  cycle=" << pm->ncycle << std::endl
       << "  number of moments=" << number_of_moments << std::endl
-      << "  coarsening factor=" << out_params.coarsen_factor << std::endl
+      << "  coarsening factor=" << cf << std::endl
       << "  size of location=" << sizeof(Real) << std::endl
-      << "  size of variable=" << sizeof(float) << std::endl
-      << "  number of variables=" << outvars.size()*number_of_moments << std::endl
+      << "  size of variable=" << sizeof(float) << std::endl;
+  if (compress) {
+    msg << "  compression=zstd" << std::endl;
+  }
+  if (pyramid_output) {
+    msg << "  pyramid levels=" << out_params.pyramid_levels << std::endl;
+  }
+  msg << "  number of variables=" << outvars.size()*number_of_moments << std::endl
       << "  variables:  ";
   if (out_params.compute_moments) {
     // need to write the label for each of the 4 moments
@@ -366,8 +400,8 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   }
   msg << std::endl;
   if (global_variable::my_rank == 0 || single_file_per_rank) {
-    cbinfile.Write_any_type(msg.str().c_str(),msg.str().size(), "byte",
-                            single_file_per_rank);
+    cbinfile.Write_any_type_at(msg.str().c_str(),msg.str().size(), header_offset, "byte",
+                               single_file_per_rank);
   }
   header_offset += msg.str().size();}
   {std::stringstream msg;
@@ -377,9 +411,10 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   std::string sbuf=ost.str();
   msg << "  header offset=" << sbuf.size()*sizeof(char)  << std::endl;
   if (global_variable::my_rank == 0 || single_file_per_rank) {
-    cbinfile.Write_any_type(msg.str().c_str(),msg.str().size(), "byte",
-                            single_file_per_rank);
-    cbinfile.Write_any_type(sbuf.c_str(),sbuf.size(), "byte", single_file_per_rank);
+    cbinfile.Write_any_type_at(msg.str().c_str(),msg.str().size(), header_offset, "byte",
+                               single_file_per_rank);
+    cbinfile.Write_any_type_at(sbuf.c_str(),sbuf.size(), header_offset + msg.str().size(),
+                               "byte", single_file_per_rank);
   }
   header_offset += sbuf.size()*sizeof(char);
   header_offset += msg.str().size();}
@@ -392,9 +427,9 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     nout_vars *= 4;
   }
   int nout_mbs = outmbs.size();
-  int nout1 = ((outmbs[0].oie - outmbs[0].ois + 1)/out_params.coarsen_factor);
-  int nout2 = ((outmbs[0].oje - outmbs[0].ojs + 1)/out_params.coarsen_factor);
-  int nout3 = ((outmbs[0].oke - outmbs[0].oks + 1)/out_params.coarsen_factor);
+  int nout1 = ((outmbs[0].oie - outmbs[0].ois + 1)/cf);
+  int nout2 = ((outmbs[0].oje - outmbs[0].ojs + 1)/cf);
+  int nout3 = ((outmbs[0].oke - outmbs[0].oks + 1)/cf);
   int cells = nout1*nout2*nout3;
 
 
@@ -489,7 +524,7 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       for (int k=oks; k<=oke; k++) {
         for (int j=ojs; j<=oje; j++) {
           for (int i=ois; i<=oie; i++) {
-            tmp_data = static_cast<float>(outarray(n,m,k-oks,j-ojs,i-ois));
+            tmp_data = static_cast<float>(data_in(n,m,k-oks,j-ojs,i-ois));
             single_data[cnt] = tmp_data;
             cnt++;
           }
@@ -501,8 +536,34 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   }
 
   // now write Coarsenedbinary data
+  std::size_t end_offset = header_offset
+                         + data_size*((single_file_per_rank)? nb_mbs : pm->nmb_total);
+  if (compress) {
+    // compress each variable on each MB, and write data of all ranks contiguously
+    std::vector<std::string> labels;
+    const char *moments[4] = {"_1st", "_2nd", "_3rd", "_4th"};
+    for (auto &var : outvars) {
+      for (int n=0; n<number_of_moments; ++n) {
+        labels.push_back(var.label + ((out_params.compute_moments)? moments[n] : ""));
+      }
+    }
+    std::vector<int> nbits = CompressionMantissaBits(pin, out_params.block_name,
+                                                     out_params.lossy_tolerance, labels);
+    const std::size_t prefix_size = 10*sizeof(int32_t) + 6*sizeof(Real);
+    std::vector<char> cdata = CompressRecords(data, nout_mbs, data_size, prefix_size,
+                                              nout_vars, cells, nbits,
+                                              out_params.compression_level);
+    WriteCompressedData(cbinfile, cdata, header_offset, single_file_per_rank);
+    std::uint64_t nbytes = cdata.size();
+#if MPI_PARALLEL_ENABLED
+    if (!single_file_per_rank) {
+      MPI_Allreduce(MPI_IN_PLACE, &nbytes, 1, MPI_UINT64_T, MPI_SUM,
+                    cbinfile.GetCommunicator());
+    }
+#endif
+    end_offset = header_offset + nbytes;
   // check if elements larger than 2^31
-  if (data_size*nb_mbs<=2147483648) {
+  } else if (data_size*nb_mbs<=2147483648) {
     // now write Coarsenedbinary data in parallel
     std::size_t myoffset=header_offset;
     if (!single_file_per_rank) {
@@ -558,20 +619,7 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     }
   }
 
-  // close the output file and clean up ptrs to data
-  cbinfile.Close(single_file_per_rank);
   delete [] data;
   delete [] single_data;
-
-  // increment counters
-  out_params.file_number++;
-  if (out_params.last_time < 0.0) {
-    out_params.last_time = pm->time;
-  } else {
-    out_params.last_time += out_params.dt;
-  }
-  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
-  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
-
-  return;
+  return end_offset;
 }
@@ -13,12 +13,15 @@
 //!   - magnitude of current density J^2  [non-relativistic]
 
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>   // std::string, to_string()
+#include <utility>  // make_pair
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "coordinates/cartesian_ks.hpp"
+#include "coordinates/coordinates.hpp"
 #include "coordinates/cell_locations.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "mesh/mesh.hpp"
@@ -31,8 +34,12 @@
 #include "outputs.hpp"
 #include "utils/current.hpp"
 
+std::map<std::string, BaseTypeOutput::DerivedVarEntry> BaseTypeOutput::derived_cache;
+
 //----------------------------------------------------------------------------------------
 // BaseTypeOutput::ComputeDerivedVariable()
+// Each derived variable is computed at most once per cycle: outputs (vtk, bin, pdf, cart,
+// etc.) requesting a variable already computed this cycle copy it from the stored array.
 
 void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
   int nmb = pm->pmb_pack->nmb_thispack;
@@ -53,6 +60,27 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
   int &i_dv = out_params.i_derived;
   int &n_dv = out_params.n_derived;
 
+  // reuse variable if already computed in this cycle, copying its slots into the
+  // derived_var of this output (which may hold other variables in its remaining slots)
+  auto cached = derived_cache.find(name);
+  if (cached != derived_cache.end() && cached->second.ncycle == pm->ncycle &&
+      cached->second.time == pm->time && cached->second.var.extent_int(0) == nmb &&
+      (i_dv + cached->second.nvar) <= n_dv) {
+    auto &entry = cached->second;
+    if (derived_var.extent(4) <= 1)
+      Kokkos::realloc(derived_var, nmb, n_dv, n3, n2, n1);
+    auto src = Kokkos::subview(entry.var, Kokkos::ALL,
+                               std::make_pair(entry.i_dv, entry.i_dv + entry.nvar),
+                               Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+    auto dst = Kokkos::subview(derived_var, Kokkos::ALL,
+                               std::make_pair(i_dv, i_dv + entry.nvar),
+                               Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+    Kokkos::deep_copy(DevExeSpace(), dst, src);
+    i_dv = (i_dv + entry.nvar) % n_dv;
+    return;
+  }
+  int i_dv_in = i_dv;
+
   // temperature = pressure / density
   if (name.compare("temperature") == 0) {
     if (derived_var.extent(4) <= 1)
@@ -351,7 +379,11 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
 
       // Extract components of metric
       Real glower[4][4], gupper[4][4];
-      ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+      if (coord.metric_cached) {
+        LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+      } else {
+        ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+      }
 
       // Get 4-velocity for current step
       const Real &uu1 = w0_(m,IVX,k,j,i);
@@ -1017,7 +1049,8 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
     Real &spin = coord.bh_spin;
 
     // Radiation
-    int nang1 = pm->pmb_pack->prad->prgeo->nangles - 1;
+    int nang = pm->pmb_pack->prad->prgeo->nangles;
+    int nint1 = pm->pmb_pack->prad->nintens - 1;
     auto nh_c_ = pm->pmb_pack->prad->nh_c;
     auto tet_c_ = pm->pmb_pack->prad->tet_c;
     auto tetcov_c_ = pm->pmb_pack->prad->tetcov_c;
@@ -1049,7 +1082,11 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
 
       // Extract components of metric
       Real glower[4][4], gupper[4][4];
-      ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+      if (coord.metric_cached) {
+        LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+      } else {
+        ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+      }
 
       // coordinate component n^0
       Real n0 = tet_c_(m,0,0,k,j,i);
@@ -1058,15 +1095,17 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
       for (int n1=0, n12=0; n1<4; ++n1) {
         for (int n2=n1; n2<4; ++n2, ++n12) {
           dv(m,n12,k,j,i) = 0.0;
-          for (int n=0; n<=nang1; ++n) {
+          // moments are summed over all frequency groups
+          for (int n=0; n<=nint1; ++n) {
+            const int a = n % nang;
             Real nmun1 = 0.0; Real nmun2 = 0.0; Real n_0 = 0.0;
             for (int d=0; d<4; ++d) {
-              nmun1 += tet_c_   (m,d,n1,k,j,i)*nh_c_.d_view(n,d);
-              nmun2 += tet_c_   (m,d,n2,k,j,i)*nh_c_.d_view(n,d);
-              n_0   += tetcov_c_(m,d,0, k,j,i)*nh_c_.d_view(n,d);
+              nmun1 += tet_c_   (m,d,n1,k,j,i)*nh_c_.d_view(a,d);
+              nmun2 += tet_c_   (m,d,n2,k,j,i)*nh_c_.d_view(a,d);
+              n_0   += tetcov_c_(m,d,0, k,j,i)*nh_c_.d_view(a,d);
             }
             dv(m,n12,k,j,i) += (nmun1*nmun2*(i0_(m,n,k,j,i)/(n0*n_0))*
-                                solid_angles_.d_view(n));
+                                solid_angles_.d_view(a));
           }
         }
       }
@@ -1207,5 +1246,9 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
       pdens(m,0,kp,jp,ip) += 1.0;
     });
   }
+  // store slots of variable for other outputs in this cycle
+  if (i_dv > i_dv_in) {
+    derived_cache[name] = {pm->ncycle, pm->time, i_dv_in, (i_dv - i_dv_in), derived_var};
+  }
   i_dv = i_dv % n_dv; // reset derived variable index
 }
@@ -6,110 +6,159 @@
 //! \file eventlog.cpp
 //! \brief writes diagnostic data collected by various event counters implemented
 //! throughout the code to a log file.  Checks whether there is data to be written
-//! every time step, but only writes data if one or more counters are non-zero
+//! every time step, but only writes data if one or more counters are non-zero.
+//! With MPI the counters are summed over ranks with a single non-blocking reduction,
+//! so each row is written at the next output (or at the end of the run), and does not
+//! stall the time loop.  With <output>/per_block = true the counters of every MeshBlock
+//! (since the last output or regrid) are also gathered, and those of MeshBlocks with
+//! any non-zero counter are written to "basename.mb.log", which shows where floors, C2P
+//! iterations and FOFC occur.
 
+#include <algorithm>  // max
 #include <cstdio>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
+#include "utils/host_tasks.hpp"
 #include "outputs.hpp"
 
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void SumMaxEvents()
+//! \brief MPI reduction operator for sets of event counters: sums all counters, except
+//! for the maximum number of C2P iterations
+
+void SumMaxEvents(void *in, void *inout, int *len, MPI_Datatype *type) {
+  int *a = static_cast<int*>(in);
+  int *b = static_cast<int*>(inout);
+  for (int l=0; l<(*len); ++l) {
+    for (int n=0; n<NEVENT_COUNTERS; ++n) {
+      int idx = l*NEVENT_COUNTERS + n;
+      b[idx] = (n == EVC_MAXIT)? std::max(a[idx], b[idx]) : (a[idx] + b[idx]);
+    }
+  }
+}
+} // namespace
+#endif
+
 //----------------------------------------------------------------------------------------
 // ctor: also calls BaseTypeOutput base class constructor
 
 EventLogOutput::EventLogOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
-  BaseTypeOutput(pin, pm, op) {
+  BaseTypeOutput(pin, pm, op),
+  ebuf(NEVENT_COUNTERS, 0),
+  esum(NEVENT_COUNTERS, 0),
+  ebuf_cycle(0) {
   header_written = false;
+  per_block = pin->GetOrAddBoolean(op.block_name, "per_block", false);
+#if MPI_PARALLEL_ENABLED
+  MPI_Type_contiguous(NEVENT_COUNTERS, MPI_INT, &evc_type);
+  MPI_Type_commit(&evc_type);
+  MPI_Op_create(&SumMaxEvents, 1, &sum_max_op);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor: completes reductions and writes rows of last output
+
+EventLogOutput::~EventLogOutput() {
+  if (ebuf_pending) {
+#if MPI_PARALLEL_ENABLED
+    MPI_Waitall(2, ereq, MPI_STATUSES_IGNORE);
+#endif
+    WriteEventRows();
+  }
+  host_tasks::Wait(rows_done);
+#if MPI_PARALLEL_ENABLED
+  MPI_Op_free(&sum_max_op);
+  MPI_Type_free(&evc_type);
+#endif
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void EventLogOutput::LoadOutputData()
-//! \brief sums event counter data across MPI ranks
+//! \brief completes reductions (and writes rows) of previous output, then copies event
+//! counters on this rank (and in each MeshBlock) into buffers for the next reductions
 
 void EventLogOutput::LoadOutputData(Mesh *pm) {
+  if (ebuf_pending) {
 #if MPI_PARALLEL_ENABLED
-  // perform in-place sum or max over all MPI ranks, depending on counter
-  int* pdfloor = &(pm->ecounter.neos_dfloor);
-  int* pefloor = &(pm->ecounter.neos_efloor);
-  int* ptfloor = &(pm->ecounter.neos_tfloor);
-  int* pvceil  = &(pm->ecounter.neos_vceil);
-  int* pfail   = &(pm->ecounter.neos_fail);
-  int* pmaxit  = &(pm->ecounter.maxit_c2p);
-  int* pfofc   = &(pm->ecounter.nfofc);
-  MPI_Allreduce(MPI_IN_PLACE, pdfloor, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pefloor, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, ptfloor, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pvceil,  1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pfail,   1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pmaxit,  1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pfofc,   1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Waitall(2, ereq, MPI_STATUSES_IGNORE);
 #endif
+    WriteEventRows();
+  }
 
-  // check if there is any data to be written
-  no_output = true;
-  if (pm->ecounter.neos_dfloor > 0 ||
-      pm->ecounter.neos_efloor > 0 ||
-      pm->ecounter.neos_tfloor > 0 ||
-      pm->ecounter.neos_vceil  > 0 ||
-      pm->ecounter.neos_fail   > 0 ||
-      pm->ecounter.nfofc > 0 ||
-      pm->ecounter.maxit_c2p > 0) {
-    no_output=false;
+  auto &ec = pm->ecounter;
+  ebuf[EVC_DFLOOR] = ec.neos_dfloor;
+  ebuf[EVC_EFLOOR] = ec.neos_efloor;
+  ebuf[EVC_TFLOOR] = ec.neos_tfloor;
+  ebuf[EVC_VCEIL] = ec.neos_vceil;
+  ebuf[EVC_FAIL] = ec.neos_fail;
+  ebuf[EVC_MAXIT] = ec.maxit_c2p;
+  ebuf[EVC_FOFC] = ec.nfofc;
+  ebuf[EVC_C2P_WORK] = ec.nc2p_work;
+  ebuf_cycle = pm->ncycle;
+
+  if (per_block) {
+    int nmb = pm->pmb_pack->nmb_thispack;
+    auto mb = Kokkos::subview(ec.mb, std::make_pair(0, nmb), Kokkos::ALL);
+    auto mb_host = Kokkos::create_mirror_view_and_copy(HostMemSpace(), mb);
+    mbbuf.resize(nmb*NEVENT_COUNTERS);
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<NEVENT_COUNTERS; ++n) {
+        mbbuf[m*NEVENT_COUNTERS + n] = mb_host(m,n);
+      }
+    }
+    // layout of gathered counters, and levels, of all MBs at time of output
+    if (global_variable::my_rank == 0) {
+      mball.resize(pm->nmb_total*NEVENT_COUNTERS);
+      mblevel.resize(pm->nmb_total);
+      for (int m=0; m<pm->nmb_total; ++m) {
+        mblevel[m] = pm->lloc_eachmb[m].level - pm->root_level;
+      }
+      mbcounts.resize(global_variable::nranks);
+      mbdispls.resize(global_variable::nranks);
+      for (int r=0; r<global_variable::nranks; ++r) {
+        mbcounts[r] = pm->nmb_eachrank[r]*NEVENT_COUNTERS;
+        mbdispls[r] = pm->gids_eachrank[r]*NEVENT_COUNTERS;
+      }
+    }
   }
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void EventLogOutput::WriteOutputFile()
-//! \brief writes event counter data to log file
+//! \brief starts reductions over all MPI ranks of event counters copied by
+//! LoadOutputData(), and resets counters.  Without MPI the rows are written immediately.
 
 void EventLogOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
-  if (header_written && no_output) return;
-
-  // only the master rank writes the file
-  if (global_variable::my_rank == 0) {
-    // create filename: "file_basename" + ".log"
-    // There is no file number or id in event log output filenames.
-    std::string fname;
-    fname.assign(out_params.file_basename);
-    fname.append(".log");
-
-    // open file for output
-    FILE *pfile;
-    if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
-      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
-      exit(EXIT_FAILURE);
-    }
-
-    // Write header, if it has not been written already
-    if (!(header_written)) {
-      std::fprintf(pfile,"# Athena event counter data\n");
-      std::fprintf(pfile,"#  cycle eos_dfloor eos_efloor eos_tfloor eos_vceil");
-      std::fprintf(pfile," eos_fail c2p_it fofc");
-      std::fprintf(pfile,"\n");  // terminate line
-      header_written = true;
-    }
-
-    // write event counters
-    if (!(no_output)) {
-      std::fprintf(pfile, "%8d", pm->ncycle);
-      std::fprintf(pfile, " %8d", pm->ecounter.neos_dfloor);
-      std::fprintf(pfile, " %8d", pm->ecounter.neos_efloor);
-      std::fprintf(pfile, " %8d", pm->ecounter.neos_tfloor);
-      std::fprintf(pfile, " %8d", pm->ecounter.neos_vceil);
-      std::fprintf(pfile, " %8d", pm->ecounter.neos_fail);
-      std::fprintf(pfile, " %6d", pm->ecounter.maxit_c2p);
-      std::fprintf(pfile, " %8d", pm->ecounter.nfofc);
-      std::fprintf(pfile,"\n"); // terminate line
-    }
-    std::fclose(pfile);
+#if MPI_PARALLEL_ENABLED
+  MPI_Ireduce(ebuf.data(), esum.data(), 1, evc_type, sum_max_op, 0, MPI_COMM_WORLD,
+              &ereq[0]);
+  ereq[1] = MPI_REQUEST_NULL;
+  if (per_block) {
+    int nsend = static_cast<int>(mbbuf.size());
+    MPI_Igatherv(mbbuf.data(), nsend, MPI_INT, mball.data(), mbcounts.data(),
+                 mbdispls.data(), MPI_INT, 0, MPI_COMM_WORLD, &ereq[1]);
   }
+  ebuf_pending = true;
+#else
+  esum = ebuf;
+  mball = mbbuf;
+  ebuf_pending = true;
+  WriteEventRows();
+#endif
 
   // reset counters
   pm->ecounter.neos_dfloor = 0;
@@ -119,6 +168,8 @@ void EventLogOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   pm->ecounter.neos_fail = 0;
   pm->ecounter.maxit_c2p = 0;
   pm->ecounter.nfofc = 0;
+  pm->ecounter.nc2p_work = 0;
+  Kokkos::deep_copy(pm->ecounter.mb, 0);
 
   // increment output time, clean up
   if (out_params.last_time < 0.0) {
@@ -129,3 +180,101 @@ void EventLogOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void EventLogOutput::WriteEventRows()
+//! \brief root rank appends reduced counters to log file if any are non-zero, and
+//! counters of each MeshBlock with non-zero counters to the per-block log file.  With
+//! <job>/host_threads the rows are written by a host thread from copies of the buffers,
+//! after the rows of the previous output.
+
+void EventLogOutput::WriteEventRows() {
+  ebuf_pending = false;
+  // only the master rank writes the file
+  if (global_variable::my_rank != 0) return;
+
+  rows_done = host_tasks::Submit([this, sum = esum,
+                                  all = (per_block)? mball : std::vector<int>(),
+                                  level = mblevel, cycle = ebuf_cycle]() {
+    AppendEventRows(sum, all, level, cycle);
+  }, rows_done);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void EventLogOutput::AppendEventRows()
+//! \brief appends rows of reduced counters sum, and of counters of each MB all, at cycle
+
+void EventLogOutput::AppendEventRows(const std::vector<int> &sum,
+                                     const std::vector<int> &all,
+                                     const std::vector<int> &level, int cycle) {
+  // check if there is any data to be written
+  no_output = true;
+  for (int n=0; n<NEVENT_COUNTERS; ++n) {
+    if (sum[n] > 0) {no_output = false;}
+  }
+  if (header_written && no_output) return;
+
+  // create filename: "file_basename" + ".log"
+  // There is no file number or id in event log output filenames.
+  std::string fname;
+  fname.assign(out_params.file_basename);
+  fname.append(".log");
+
+  // open file for output
+  FILE *pfile;
+  if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Write header, if it has not been written already
+  if (!(header_written)) {
+    std::fprintf(pfile,"# Athena event counter data\n");
+    std::fprintf(pfile,"#  cycle eos_dfloor eos_efloor eos_tfloor eos_vceil");
+    std::fprintf(pfile," eos_fail c2p_it fofc c2p_work");
+    std::fprintf(pfile,"\n");  // terminate line
+    header_written = true;
+  }
+
+  // write event counters
+  if (!(no_output)) {
+    std::fprintf(pfile, "%8d", cycle);
+    for (int n=0; n<NEVENT_COUNTERS; ++n) {
+      std::fprintf(pfile, (n == EVC_MAXIT)? " %6d" : " %8d", sum[n]);
+    }
+    std::fprintf(pfile,"\n"); // terminate line
+  }
+  std::fclose(pfile);
+  if (!(per_block) || no_output) return;
+
+  // write event counters of each MeshBlock with non-zero counters
+  fname.assign(out_params.file_basename);
+  fname.append(".mb.log");
+  if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (!(mb_header_written)) {
+    std::fprintf(pfile,"# Athena event counter data in each MeshBlock\n");
+    std::fprintf(pfile,"#  cycle      gid level eos_dfloor eos_efloor eos_tfloor");
+    std::fprintf(pfile," eos_vceil eos_fail c2p_it fofc c2p_work\n");
+    mb_header_written = true;
+  }
+  int nmb = static_cast<int>(level.size());
+  for (int m=0; m<nmb; ++m) {
+    const int *cnt = &(all[m*NEVENT_COUNTERS]);
+    bool nonzero = false;
+    for (int n=0; n<NEVENT_COUNTERS; ++n) {
+      if (cnt[n] != 0) {nonzero = true;}
+    }
+    if (!(nonzero)) continue;
+    std::fprintf(pfile, "%8d %8d %5d", cycle, m, level[m]);
+    for (int n=0; n<NEVENT_COUNTERS; ++n) {
+      std::fprintf(pfile, (n == EVC_MAXIT)? " %6d" : " %8d", cnt[n]);
+    }
+    std::fprintf(pfile,"\n");
+  }
+  std::fclose(pfile);
+}
@@ -0,0 +1,291 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hdf5.cpp
+//! \brief writes output data in (parallel) HDF5 format.  All ranks write to a single
+//! file with collective I/O.  Cell-centered data is stored in the dataset "uov" with
+//! dimensions (variable, MeshBlock, k, j, i) in chunks of one variable on one MeshBlock,
+//! which may be compressed.  The MeshBlock refinement levels, logical locations, and face
+//! coordinates, and metadata (time, cycle, variable names, etc.) are stored alongside.
+//! Only compiled if configured with -D Athena_ENABLE_HDF5=ON.
+//!
+//! With MPI, the number of ranks that actually access the file system is set by the
+//! MPI-IO collective buffering hint cb_nodes (<output>/aggregators), which defaults to
+//! one aggregator per node, so that large runs do not overwhelm the metadata servers.
+
+#include <sys/stat.h>  // mkdir
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+#if HDF5_OUTPUT_ENABLED
+#include <hdf5.h>
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void WriteAttribute()
+//  \brief writes 1D attribute of n elements of type to object loc (collectively)
+
+void WriteAttribute(hid_t loc, const char *name, hid_t type, hsize_t n, const void *buf) {
+  hid_t space = H5Screate_simple(1, &n, nullptr);
+  hid_t attr = H5Acreate2(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(attr, type, buf);
+  H5Aclose(attr);
+  H5Sclose(space);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteDataset()
+//  \brief creates dataset with global dimensions gdims, and writes the block of
+//  dimensions count starting at start from this rank (no data if count[0]=0)
+
+void WriteDataset(hid_t file, const char *name, hid_t memtype, hid_t filetype, int rank,
+                  const hsize_t *gdims, const hsize_t *start, const hsize_t *count,
+                  const void *buf, hid_t dcpl, hid_t dxpl) {
+  hid_t filespace = H5Screate_simple(rank, gdims, nullptr);
+  hid_t dset = H5Dcreate2(file, name, filetype, filespace, H5P_DEFAULT, dcpl,
+                          H5P_DEFAULT);
+  hsize_t nelem = 1;
+  for (int n=0; n<rank; ++n) {nelem *= count[n];}
+  hid_t memspace = H5Screate_simple(1, &nelem, nullptr);
+  if (nelem > 0) {
+    H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+  } else {
+    H5Sselect_none(filespace);
+    H5Sselect_none(memspace);
+  }
+  H5Dwrite(dset, memtype, memspace, filespace, dxpl, buf);
+  H5Sclose(memspace);
+  H5Dclose(dset);
+  H5Sclose(filespace);
+}
+
+// HDF5 types of Real and OutReal
+hid_t RealType() {
+  return (sizeof(Real) == sizeof(float))? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
+}
+hid_t OutRealType() {
+  return (sizeof(OutReal) == sizeof(float))? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
+}
+} // namespace
+#endif // HDF5_OUTPUT_ENABLED
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+MeshHDF5Output::MeshHDF5Output(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+#if !(HDF5_OUTPUT_ENABLED)
+  std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+            << "Output file_type 'hdf5' in <" << op.block_name << "> requires the code "
+            << "to be configured with -D Athena_ENABLE_HDF5=ON" << std::endl;
+  std::exit(EXIT_FAILURE);
+#else
+  mkdir("hdf5",0775);
+
+  // default number of aggregators is number of nodes (ranks sharing memory)
+  naggregators = out_params.aggregators;
+#if MPI_PARALLEL_ENABLED
+  if (naggregators <= 0) {
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                        MPI_INFO_NULL, &node_comm);
+    int node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+    naggregators = (node_rank == 0)? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &naggregators, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Comm_free(&node_comm);
+  }
+#endif
+#endif // HDF5_OUTPUT_ENABLED
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshHDF5Output:::WriteOutputFile(Mesh *pm)
+//  \brief Writes OutputData of all MeshBlocks to a single HDF5 file
+
+void MeshHDF5Output::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+#if HDF5_OUTPUT_ENABLED
+  // create filename: "hdf5/file_basename" + "." + "file_id" + "." + XXXXX + ".h5"
+  // where XXXXX = 5-digit file_number
+  char number[7];
+  std::snprintf(number, sizeof(number), ".%05d", out_params.file_number);
+  std::string fname = std::string("hdf5/") + out_params.file_basename
+                    + "." + out_params.file_id + number + ".h5";
+
+  // number of output variables and MBs, and offset of MBs of this rank in file
+  int nout_vars = outvars.size();
+  int nout_mbs = outmbs.size();
+  int ntot_mbs = std::accumulate(noutmbs.begin(), noutmbs.end(), 0);
+  int mb_offset = std::accumulate(noutmbs.begin(),
+                                  noutmbs.begin() + global_variable::my_rank, 0);
+  // number of cells in each direction is same on all output MBs, but ranks without
+  // output MBs do not know it
+  int nout[3] = {0, 0, 0};
+  if (nout_mbs > 0) {
+    nout[0] = outmbs[0].oie - outmbs[0].ois + 1;
+    nout[1] = outmbs[0].oje - outmbs[0].ojs + 1;
+    nout[2] = outmbs[0].oke - outmbs[0].oks + 1;
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, nout, 3, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+  // open file for collective access through MPI-IO, with aggregation and collective
+  // metadata operations
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+#if MPI_PARALLEL_ENABLED
+  MPI_Info info;
+  MPI_Info_create(&info);
+  MPI_Info_set(info, "romio_cb_write", "enable");
+  MPI_Info_set(info, "cb_nodes", std::to_string(naggregators).c_str());
+  H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, info);
+  H5Pset_all_coll_metadata_ops(fapl, true);
+  H5Pset_coll_metadata_write(fapl, true);
+  H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+#endif
+  hid_t file = H5Fcreate(fname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  if (file < 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Could not open file '" << fname << "'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // metadata
+  {
+    int nmb_size[3] = {nout[0], nout[1], nout[2]};
+    int max_level = pm->max_level - pm->root_level;
+    WriteAttribute(file, "Time", RealType(), 1, &(pm->time));
+    WriteAttribute(file, "NCycle", H5T_NATIVE_INT, 1, &(pm->ncycle));
+    WriteAttribute(file, "NumMeshBlocks", H5T_NATIVE_INT, 1, &ntot_mbs);
+    WriteAttribute(file, "MeshBlockSize", H5T_NATIVE_INT, 3, nmb_size);
+    WriteAttribute(file, "MaxLevel", H5T_NATIVE_INT, 1, &max_level);
+    WriteAttribute(file, "NumVariables", H5T_NATIVE_INT, 1, &nout_vars);
+    std::size_t len = 1;
+    for (auto &var : outvars) {len = std::max(len, var.label.size() + 1);}
+    std::vector<char> names(len*nout_vars, '\0');
+    for (int n=0; n<nout_vars; ++n) {
+      outvars[n].label.copy(&names[n*len], len - 1);
+    }
+    hid_t strtype = H5Tcopy(H5T_C_S1);
+    H5Tset_size(strtype, len);
+    WriteAttribute(file, "VariableNames", strtype, nout_vars, names.data());
+    H5Tclose(strtype);
+  }
+
+  // MeshBlock levels, logical locations, and face coordinates
+  {
+    std::vector<int> levels(nout_mbs);
+    std::vector<std::int64_t> llocs(3*nout_mbs);
+    std::vector<Real> x1f(nout_mbs*(nout[0]+1));
+    std::vector<Real> x2f(nout_mbs*(nout[1]+1));
+    std::vector<Real> x3f(nout_mbs*(nout[2]+1));
+    auto &indcs = pm->mb_indcs;
+    for (int m=0; m<nout_mbs; ++m) {
+      auto &omb = outmbs[m];
+      LogicalLocation &loc = pm->lloc_eachmb[omb.mb_gid];
+      levels[m] = loc.level - pm->root_level;
+      llocs[3*m] = loc.lx1;
+      llocs[3*m+1] = loc.lx2;
+      llocs[3*m+2] = loc.lx3;
+      for (int i=0; i<=nout[0]; ++i) {
+        x1f[m*(nout[0]+1) + i] = LeftEdgeX(omb.ois + i - indcs.is, indcs.nx1,
+                                           omb.x1min, omb.x1max);
+      }
+      for (int j=0; j<=nout[1]; ++j) {
+        x2f[m*(nout[1]+1) + j] = LeftEdgeX(omb.ojs + j - indcs.js, indcs.nx2,
+                                           omb.x2min, omb.x2max);
+      }
+      for (int k=0; k<=nout[2]; ++k) {
+        x3f[m*(nout[2]+1) + k] = LeftEdgeX(omb.oks + k - indcs.ks, indcs.nx3,
+                                           omb.x3min, omb.x3max);
+      }
+    }
+    hsize_t gdims[2] = {static_cast<hsize_t>(ntot_mbs), 3};
+    hsize_t start[2] = {static_cast<hsize_t>(mb_offset), 0};
+    hsize_t count[2] = {static_cast<hsize_t>(nout_mbs), 3};
+    WriteDataset(file, "Levels", H5T_NATIVE_INT, H5T_NATIVE_INT, 1, gdims, start,
+                 count, levels.data(), H5P_DEFAULT, dxpl);
+    WriteDataset(file, "LogicalLocations", H5T_NATIVE_INT64, H5T_NATIVE_INT64, 2,
+                 gdims, start, count, llocs.data(), H5P_DEFAULT, dxpl);
+    const char *xf_names[3] = {"x1f", "x2f", "x3f"};
+    const Real *xf_data[3] = {x1f.data(), x2f.data(), x3f.data()};
+    for (int d=0; d<3; ++d) {
+      gdims[1] = count[1] = nout[d] + 1;
+      WriteDataset(file, xf_names[d], RealType(), RealType(), 2, gdims, start, count,
+                   xf_data[d], H5P_DEFAULT, dxpl);
+    }
+  }
+
+  // cell-centered data, chunked by variable and MeshBlock, stored as floats
+  {
+    hsize_t gdims[5] = {static_cast<hsize_t>(nout_vars), static_cast<hsize_t>(ntot_mbs),
+                        static_cast<hsize_t>(nout[2]), static_cast<hsize_t>(nout[1]),
+                        static_cast<hsize_t>(nout[0])};
+    hsize_t chunk[5] = {1, 1, gdims[2], gdims[3], gdims[4]};
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    if (ntot_mbs > 0) {
+      H5Pset_chunk(dcpl, 5, chunk);
+      if (out_params.compression_level > 0) {
+        H5Pset_deflate(dcpl, out_params.compression_level);
+      }
+    }
+    hid_t filespace = H5Screate_simple(5, gdims, nullptr);
+    hid_t dset = H5Dcreate2(file, "uov", H5T_NATIVE_FLOAT, filespace, H5P_DEFAULT, dcpl,
+                            H5P_DEFAULT);
+    // outarray(n,m,k,j,i) is contiguous over (m,k,j,i) for each variable n
+    hsize_t count[5] = {1, static_cast<hsize_t>(nout_mbs), gdims[2], gdims[3], gdims[4]};
+    hsize_t nelem = count[1]*count[2]*count[3]*count[4];
+    hid_t memspace = H5Screate_simple(1, &nelem, nullptr);
+    if (nelem == 0) {H5Sselect_none(memspace);}
+    for (int n=0; n<nout_vars; ++n) {
+      hsize_t start[5] = {static_cast<hsize_t>(n), static_cast<hsize_t>(mb_offset),
+                          0, 0, 0};
+      if (nelem > 0) {
+        H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+      } else {
+        H5Sselect_none(filespace);
+      }
+      const OutReal *buf = (nelem > 0)? &outarray(n,0,0,0,0) : nullptr;
+      H5Dwrite(dset, OutRealType(), memspace, filespace, dxpl, buf);
+    }
+    H5Sclose(memspace);
+    H5Dclose(dset);
+    H5Sclose(filespace);
+    H5Pclose(dcpl);
+  }
+
+  // close the output file
+  H5Fclose(file);
+  H5Pclose(dxpl);
+  H5Pclose(fapl);
+#if MPI_PARALLEL_ENABLED
+  MPI_Info_free(&info);
+#endif
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+#endif // HDF5_OUTPUT_ENABLED
+  return;
+}
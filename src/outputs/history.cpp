@@ -13,6 +13,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -21,7 +22,9 @@
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "z4c/z4c.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
 #include "coordinates/adm.hpp"
+#include "utils/host_tasks.hpp"
 #include "outputs.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -51,12 +54,26 @@ HistoryOutput::HistoryOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
   }
 }
 
+//----------------------------------------------------------------------------------------
+// Destructor: with async=true, completes reduction and writes rows of last hst output
+
+HistoryOutput::~HistoryOutput() {
+  if (hbuf_pending) {
+#if MPI_PARALLEL_ENABLED
+    MPI_Wait(&hbuf_req, MPI_STATUS_IGNORE);
+#endif
+    WriteHistoryRows();
+  }
+  host_tasks::Wait(rows_done);
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void HistoryOutput::LoadOutputData()
 //  \brief Wrapper function that cycles through hist_data vector and calls
 //  appropriate LoadXXXData() function for that physics
 
 void HistoryOutput::LoadOutputData(Mesh *pm) {
+  host_tasks::Wait(rows_done);
   for (auto &data : hist_data) {
     if (data.physics == PhysicsModule::HydroDynamics) {
       LoadHydroHistoryData(&data, pm);
@@ -343,79 +360,72 @@ void HistoryOutput::LoadMHDHistoryData(HistoryData *pdata, Mesh *pm) {
     pdata->hdata[n] = sum_this_mb.the_array[n];
   }
 
+  // with DynGRMHD and <mhd>/c2p_stats, append the number of cells since the start of the
+  // run in which the primitive solve failed (by type of failure), was floored, or was
+  // retried after a failed fast solve
+  if (pm->pmb_pack->pdyngr != nullptr) {
+    auto *c2p_totals = pm->pmb_pack->pdyngr->GetC2PCountTotals();
+    if (c2p_totals != nullptr) {
+      const char *c2p_labels[NC2P_STATS] = {
+        "c2p-rhobig", "c2p-rhosmall", "c2p-nans", "c2p-magbig", "c2p-bracket",
+        "c2p-nosoln", "c2p-floorfail", "c2p-floored", "c2p-retried"};
+      int n0 = pdata->nhist;
+      pdata->nhist += NC2P_STATS;
+      if (pdata->nhist > NHISTORY_VARIABLES) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MHD history with c2p_stats has more than "
+                  << "NHISTORY_VARIABLES variables" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      for (int n=0; n<NC2P_STATS; ++n) {
+        pdata->label[n0+n] = c2p_labels[n];
+        pdata->hdata[n0+n] = static_cast<Real>((*c2p_totals)[n]);
+      }
+    }
+  }
+
   return;
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void HistoryOutput::WriteOutputFile()
-//  \brief Cycles through hist_data vector and writes history file for each component
+//  \brief Packs hdata of all physics modules into hbuf, sums it over all MPI ranks, and
+//  writes history file for each component.  With <output>/async=true, rows from the
+//  previous hst output are written first, and the sum of the current data is only
+//  started, so that time loop does not wait for the reduction.
 
 void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
-  for (auto &data : hist_data) {
-    // first, perform in-place sum over all MPI ranks
+  // complete reduction, and write rows, of previous output
+  if (hbuf_pending) {
 #if MPI_PARALLEL_ENABLED
-    if (global_variable::my_rank == 0) {
-      MPI_Reduce(MPI_IN_PLACE, &(data.hdata[0]), data.nhist, MPI_ATHENA_REAL,
-         MPI_SUM, 0, MPI_COMM_WORLD);
-    } else {
-      MPI_Reduce(&(data.hdata[0]), &(data.hdata[0]), data.nhist,
-         MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
-    }
+    MPI_Wait(&hbuf_req, MPI_STATUS_IGNORE);
 #endif
+    WriteHistoryRows();
+  }
 
-    // only the master rank writes the file
-    if (global_variable::my_rank == 0) {
-      // create filename: "file_basename" + ".physics" + ".hst"
-      // There is no file number or id in history output filenames.
-      std::string fname;
-      fname.assign(out_params.file_basename);
-      switch (data.physics) {
-        case PhysicsModule::HydroDynamics:
-          fname.append(".hydro");
-          break;
-        case PhysicsModule::MagnetoHydroDynamics:
-          fname.append(".mhd");
-          break;
-        case PhysicsModule::SpaceTimeDynamics:
-          fname.append(".z4c");
-        case PhysicsModule::UserDefined:
-          fname.append(".user");
-          break;
-        default:
-          break;
-      }
-      fname.append(".hst");
-
-      // open file for output
-      FILE *pfile;
-      if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
-        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
-        exit(EXIT_FAILURE);
-      }
-
-      // Write header, if it has not been written already
-      if (!(data.header_written)) {
-        int iout = 1;
-        std::fprintf(pfile,"# Athena++ history data\n");
-        std::fprintf(pfile,"#  [%d]=time      ", iout++);
-        std::fprintf(pfile,"[%d]=dt       ", iout++);
-        for (int n=0; n<data.nhist; ++n) {
-          std::fprintf(pfile,"[%d]=%.10s    ", iout++, data.label[n].c_str());
-        }
-        std::fprintf(pfile,"\n");                              // terminate line
-        data.header_written = true;
-      }
+  // pack data of all physics modules
+  hbuf.clear();
+  for (auto &data : hist_data) {
+    hbuf.insert(hbuf.end(), data.hdata, data.hdata + data.nhist);
+  }
+  hbuf_time = pm->time;
+  hbuf_dt = pm->dt;
 
-      // write history variables
-      std::fprintf(pfile, out_params.data_format.c_str(), pm->time);
-      std::fprintf(pfile, out_params.data_format.c_str(), pm->dt);
-      for (int n=0; n<data.nhist; ++n)
-        std::fprintf(pfile, out_params.data_format.c_str(), data.hdata[n]);
-      std::fprintf(pfile,"\n"); // terminate line
-      std::fclose(pfile);
-    }
-  } // End loop over hist_data vector
+  // in-place sum over all MPI ranks
+#if MPI_PARALLEL_ENABLED
+  void *sendbuf = (global_variable::my_rank == 0)? MPI_IN_PLACE : hbuf.data();
+  if (out_params.async) {
+    MPI_Ireduce(sendbuf, hbuf.data(), hbuf.size(), MPI_ATHENA_REAL, MPI_SUM, 0,
+                MPI_COMM_WORLD, &hbuf_req);
+  } else {
+    MPI_Reduce(sendbuf, hbuf.data(), hbuf.size(), MPI_ATHENA_REAL, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+  }
+#endif
+  hbuf_pending = true;
+  if (!(out_params.async)) {
+    WriteHistoryRows();
+  }
 
   // increment counters, clean up
   if (out_params.last_time < 0.0) {
@@ -426,3 +436,81 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void HistoryOutput::WriteHistoryRows()
+//  \brief Root rank writes the summed data in hbuf to the history file of each component.
+//  With <job>/host_threads the rows are written by a host thread, after the rows of the
+//  previous output.
+
+void HistoryOutput::WriteHistoryRows() {
+  hbuf_pending = false;
+  // only the master rank writes the file
+  if (global_variable::my_rank != 0) {return;}
+
+  rows_done = host_tasks::Submit([this, buf = hbuf, time = hbuf_time, dt = hbuf_dt]() {
+    AppendHistoryRows(buf, time, dt);
+  }, rows_done);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HistoryOutput::AppendHistoryRows()
+//  \brief Appends one row of data in buf to the history file of each component
+
+void HistoryOutput::AppendHistoryRows(const std::vector<Real> &buf, Real time,
+                                      Real dt) {
+  int offset = 0;
+  for (auto &data : hist_data) {
+    // create filename: "file_basename" + ".physics" + ".hst"
+    // There is no file number or id in history output filenames.
+    std::string fname;
+    fname.assign(out_params.file_basename);
+    switch (data.physics) {
+      case PhysicsModule::HydroDynamics:
+        fname.append(".hydro");
+        break;
+      case PhysicsModule::MagnetoHydroDynamics:
+        fname.append(".mhd");
+        break;
+      case PhysicsModule::SpaceTimeDynamics:
+        fname.append(".z4c");
+      case PhysicsModule::UserDefined:
+        fname.append(".user");
+        break;
+      default:
+        break;
+    }
+    fname.append(".hst");
+
+    // open file for output
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // Write header, if it has not been written already
+    if (!(data.header_written)) {
+      int iout = 1;
+      std::fprintf(pfile,"# Athena++ history data\n");
+      std::fprintf(pfile,"#  [%d]=time      ", iout++);
+      std::fprintf(pfile,"[%d]=dt       ", iout++);
+      for (int n=0; n<data.nhist; ++n) {
+        std::fprintf(pfile,"[%d]=%.10s    ", iout++, data.label[n].c_str());
+      }
+      std::fprintf(pfile,"\n");                              // terminate line
+      data.header_written = true;
+    }
+
+    // write history variables
+    std::fprintf(pfile, out_params.data_format.c_str(), time);
+    std::fprintf(pfile, out_params.data_format.c_str(), dt);
+    for (int n=0; n<data.nhist; ++n)
+      std::fprintf(pfile, out_params.data_format.c_str(), buf[offset + n]);
+    std::fprintf(pfile,"\n"); // terminate line
+    std::fclose(pfile);
+    offset += data.nhist;
+  } // End loop over hist_data vector
+  return;
+}
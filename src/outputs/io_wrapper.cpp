@@ -6,8 +6,10 @@
 //! \file io_wrapper.cpp
 //! \brief functions that provide wrapper for MPI-IO versus serial input/output
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -17,12 +19,19 @@
 #include "athena.hpp"
 #include "io_wrapper.hpp"
 
+#if GDS_ENABLED
+#include <fcntl.h>
+#include <unistd.h>
+#include <cufile.h>
+#endif
+
 //----------------------------------------------------------------------------------------
 //! \fn int IOWrapper::Open(const char* fname, FileMode rw)
 //! \brief wrapper for {MPI_File_open} versus {std::fopen} including error check
 //! This function must not be called by multiple threads in shared memory parallel regions
 
 int IOWrapper::Open(const char* fname, FileMode rw, bool single_file_per_rank) {
+  fname_ = fname;
   const char* mode;
   switch (rw) {
     case FileMode::read:
@@ -582,6 +591,16 @@ std::size_t IOWrapper::Write_any_type_at_all(const void *buf, IOWrapperSizeT cnt
 //  \brief wrapper for {MPI_File_close} versus {std::fclose}
 
 int IOWrapper::Close(bool single_file_per_rank) {
+#if GDS_ENABLED
+  if (gds_handle_ != nullptr) {
+    cuFileHandleDeregister(reinterpret_cast<CUfileHandle_t>(gds_handle_));
+    gds_handle_ = nullptr;
+  }
+  if (gds_fd_ >= 0) {
+    close(gds_fd_);
+    gds_fd_ = -1;
+  }
+#endif
 #if MPI_PARALLEL_ENABLED
   if (!single_file_per_rank) {
     return MPI_File_close(&fh_);
@@ -593,6 +612,71 @@ int IOWrapper::Close(bool single_file_per_rank) {
 #endif
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn bool IOWrapper::DeviceIOAvailable()
+//  \brief Returns true if the cuFile driver (GPUDirect Storage) could be opened, so that
+//  data can be written from device memory with Write_device_at().
+
+bool IOWrapper::DeviceIOAvailable() {
+#if GDS_ENABLED
+  static int available = -1;  // -1 until the driver is opened
+  if (available < 0) {
+    CUfileError_t status = cuFileDriverOpen();
+    available = (status.err == CU_FILE_SUCCESS)? 1 : 0;
+  }
+  return (available == 1);
+#else
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::size_t IOWrapper::Write_device_at()
+//  \brief Writes cnt bytes from device memory dbuf at offset with cuFile, bypassing host
+//  memory.  The file is reopened with O_DIRECT and registered on the first call.  Only
+//  possible for files written by a single rank (with stdio).  Data is written in chunks
+//  aligned at multiples of the chunk size in the file, so that all but the first chunk
+//  start at aligned offsets.  Returns the number of bytes written.
+
+std::size_t IOWrapper::Write_device_at(const void *dbuf, IOWrapperSizeT cnt,
+                                       IOWrapperSizeT offset, bool single_file_per_rank) {
+#if GDS_ENABLED
+#if MPI_PARALLEL_ENABLED
+  if (!single_file_per_rank) {return 0;}
+#endif
+  if (gds_handle_ == nullptr) {
+    // data written with stdio must reach the file before it is written with O_DIRECT
+    std::fflush(reinterpret_cast<FILE*>(fh_));
+    gds_fd_ = open(fname_.c_str(), O_WRONLY | O_DIRECT);
+    if (gds_fd_ < 0) {return 0;}
+    CUfileDescr_t descr;
+    std::memset(&descr, 0, sizeof(CUfileDescr_t));
+    descr.handle.fd = gds_fd_;
+    descr.type = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+    CUfileHandle_t handle;
+    if (cuFileHandleRegister(&handle, &descr).err != CU_FILE_SUCCESS) {
+      close(gds_fd_);
+      gds_fd_ = -1;
+      return 0;
+    }
+    gds_handle_ = reinterpret_cast<void*>(handle);
+  }
+  const IOWrapperSizeT chunk = (1 << 24);
+  IOWrapperSizeT nwritten = 0;
+  while (nwritten < cnt) {
+    IOWrapperSizeT pos = offset + nwritten;
+    IOWrapperSizeT n = std::min(chunk - (pos % chunk), cnt - nwritten);
+    ssize_t ret = cuFileWrite(reinterpret_cast<CUfileHandle_t>(gds_handle_), dbuf, n,
+                              pos, nwritten);
+    if (ret != static_cast<ssize_t>(n)) {break;}
+    nwritten += n;
+  }
+  return nwritten;
+#else
+  return 0;
+#endif
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn int IOWrapper::Seek(IOWrapperSizeT offset, bool single_file_per_rank)
 //  \brief wrapper for {MPI_File_seek} versus {std::fseek}
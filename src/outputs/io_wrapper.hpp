@@ -26,6 +26,7 @@ class IOWrapper {
 #if MPI_PARALLEL_ENABLED
   IOWrapper() : fh_(nullptr), comm_(MPI_COMM_WORLD) {}
   void SetCommunicator(MPI_Comm scomm) { comm_=scomm;}
+  MPI_Comm GetCommunicator() { return comm_;}
 #else
   IOWrapper() {fh_=nullptr;}
 #endif
@@ -54,12 +55,20 @@ class IOWrapper {
                             bool single_file_per_rank = false);
   std::size_t Read_Reals_at_all(void *buf, IOWrapperSizeT count, IOWrapperSizeT offset,
                                 bool single_file_per_rank = false);
+  // writes cnt bytes from device memory with cuFile (GPUDirect Storage), only for files
+  // written by a single rank.  Returns number of bytes written (0 if not possible).
+  std::size_t Write_device_at(const void *dbuf, IOWrapperSizeT cnt, IOWrapperSizeT offset,
+                              bool single_file_per_rank = false);
+  static bool DeviceIOAvailable();
   int Close(bool single_file_per_rank = false);
   int Seek(IOWrapperSizeT offset, bool single_file_per_rank = false);
   IOWrapperSizeT GetPosition(bool single_file_per_rank = false);
 
  private:
   IOWrapperFile fh_;
+  std::string fname_;          // name of open file
+  int gds_fd_ = -1;            // file opened with O_DIRECT for cuFile writes
+  void *gds_handle_ = nullptr; // cuFile handle of gds_fd_
 #if MPI_PARALLEL_ENABLED
   MPI_Comm comm_;
 #endif
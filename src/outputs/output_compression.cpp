@@ -0,0 +1,171 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file output_compression.cpp
+//! \brief byte-shuffle + zstd compression (optionally with error-bounded rounding of the
+//! mantissa) of binary output data.  Only functional if configured with
+//! -D Athena_ENABLE_ZSTD=ON.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "outputs.hpp"
+#include "output_compression.hpp"
+
+#if ZSTD_ENABLED
+#include <zstd.h>
+#endif
+
+//----------------------------------------------------------------------------------------
+//! \fn void ReadCompressionParameters()
+//  \brief Reads <output>/compression (none or zstd), compression_level, and
+//  lossy_tolerance of bin and cbin outputs.
+
+void ReadCompressionParameters(ParameterInput *pin, OutputParameters &op) {
+  op.compression = pin->GetOrAddString(op.block_name, "compression", "none");
+  if (op.compression.compare("none") != 0 && op.compression.compare("zstd") != 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Unrecognized compression = '" << op.compression << "' in output block '"
+              << op.block_name << "', choose [none,zstd]" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (op.compression.compare("zstd") == 0) {
+#if !(ZSTD_ENABLED)
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "compression = zstd in output block '" << op.block_name << "' requires "
+              << "the code to be configured with -D Athena_ENABLE_ZSTD=ON" << std::endl;
+    std::exit(EXIT_FAILURE);
+#endif
+    op.compression_level = pin->GetOrAddInteger(op.block_name, "compression_level", 3);
+    op.lossy_tolerance = pin->GetOrAddReal(op.block_name, "lossy_tolerance", 0.0);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::vector<int> CompressionMantissaBits()
+//  \brief Rounding a float to nbits mantissa bits gives a relative error of at most
+//  2^-(nbits+1), so returns smallest such nbits below tolerance for each variable.
+
+std::vector<int> CompressionMantissaBits(ParameterInput *pin, const std::string &block,
+                                         Real tolerance,
+                                         const std::vector<std::string> &labels) {
+  std::vector<int> nbits;
+  for (auto &label : labels) {
+    Real tol = tolerance;
+    if (pin->DoesParameterExist(block, "lossy_tolerance_" + label)) {
+      tol = pin->GetReal(block, "lossy_tolerance_" + label);
+    }
+    int n = 23;
+    if (tol > 0.0) {
+      n = static_cast<int>(std::ceil(-std::log2(tol) - 1.0));
+      n = std::min(std::max(n, 0), 23);
+    }
+    nbits.push_back(n);
+  }
+  return nbits;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::vector<char> CompressRecords()
+//  \brief Compresses the data of each variable in each MB record separately, so that
+//  MBs can still be read one at a time.
+
+std::vector<char> CompressRecords(const char *data, int nmbs, std::size_t record_size,
+                                  std::size_t prefix_size, int nvars, int ncells,
+                                  const std::vector<int> &nbits, int level) {
+  std::vector<char> cdata;
+#if ZSTD_ENABLED
+  ZSTD_CCtx *cctx = ZSTD_createCCtx();
+  std::size_t nbytes = ncells*sizeof(float);
+  std::vector<unsigned char> shuffled(nbytes);
+  std::size_t bound = ZSTD_compressBound(nbytes);
+  for (int m=0; m<nmbs; ++m) {
+    const char *prec = data + m*record_size;
+    cdata.insert(cdata.end(), prec, prec + prefix_size);
+    for (int n=0; n<nvars; ++n) {
+      const char *pvar = prec + prefix_size + n*nbytes;
+      // round mantissa (except inf/nan) and shuffle bytes, so that bytes of same
+      // significance of all cells are contiguous
+      int drop = 23 - nbits[n];
+      std::uint32_t half = (drop > 0)? (1u << (drop - 1)) : 0;
+      std::uint32_t mask = ~((1u << drop) - 1u);
+      for (int i=0; i<ncells; ++i) {
+        std::uint32_t bits;
+        std::memcpy(&bits, pvar + i*sizeof(float), sizeof(float));
+        if (drop > 0 && (bits & 0x7f800000u) != 0x7f800000u) {
+          std::uint32_t rounded = (bits + half) & mask;
+          bits = ((rounded & 0x7f800000u) != 0x7f800000u)? rounded : (bits & mask);
+        }
+        for (int b=0; b<4; ++b) {
+          shuffled[b*ncells + i] = static_cast<unsigned char>((bits >> (8*b)) & 0xffu);
+        }
+      }
+      std::size_t pos = cdata.size();
+      cdata.resize(pos + sizeof(std::uint64_t) + bound);
+      std::size_t csize = ZSTD_compressCCtx(cctx, &cdata[pos + sizeof(std::uint64_t)],
+                                            bound, shuffled.data(), nbytes, level);
+      if (ZSTD_isError(csize)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "zstd compression failed: "
+                  << ZSTD_getErrorName(csize) << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::uint64_t size64 = csize;
+      std::memcpy(&cdata[pos], &size64, sizeof(std::uint64_t));
+      cdata.resize(pos + sizeof(std::uint64_t) + csize);
+    }
+  }
+  ZSTD_freeCCtx(cctx);
+#endif
+  return cdata;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::uint64_t WriteCompressedData()
+//  \brief Since the size of compressed data differs between ranks, the offset of each
+//  rank is computed with a prefix sum.  Data is written in pieces smaller than 2^31
+//  bytes, with the same number of (collective) writes on all ranks.  Returns the offset
+//  of the data of this rank in the file.
+
+std::uint64_t WriteCompressedData(IOWrapper &file, const std::vector<char> &cdata,
+                                  std::size_t header_size, bool single_file_per_rank) {
+  const std::uint64_t max_write = (1 << 30);
+  std::uint64_t nbytes = cdata.size();
+  std::uint64_t myoffset = header_size;
+  std::uint64_t nwrites = (nbytes + max_write - 1)/max_write;
+#if MPI_PARALLEL_ENABLED
+  if (!single_file_per_rank) {
+    MPI_Comm comm = file.GetCommunicator();
+    std::uint64_t offset = 0;
+    MPI_Exscan(&nbytes, &offset, 1, MPI_UINT64_T, MPI_SUM, comm);
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank > 0) {myoffset += offset;}
+    MPI_Allreduce(MPI_IN_PLACE, &nwrites, 1, MPI_UINT64_T, MPI_MAX, comm);
+  }
+#endif
+  for (std::uint64_t n=0; n<nwrites; ++n) {
+    std::uint64_t os = std::min(n*max_write, nbytes);
+    std::uint64_t cnt = std::min(max_write, nbytes - os);
+    if (file.Write_any_type_at_all(cdata.data() + os, cnt, myoffset + os, "byte",
+                                   single_file_per_rank) != cnt) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "compressed data not written correctly to binary file, "
+                << "binary file is broken." << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  return myoffset;
+}
@@ -0,0 +1,48 @@
+#ifndef OUTPUTS_OUTPUT_COMPRESSION_HPP_
+#define OUTPUTS_OUTPUT_COMPRESSION_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file output_compression.hpp
+//  \brief functions to compress the packed MeshBlock data of binary outputs (bin and
+//  cbin) with <output>/compression=zstd.  Each variable on each MB is byte-shuffled and
+//  compressed with zstd.  With <output>/lossy_tolerance > 0 (or lossy_tolerance_<var> for
+//  a single variable), floats are first rounded to the fewest mantissa bits for which the
+//  relative error is below the tolerance, which is lossy but improves compression.
+//
+//  In compressed files (version=1.2, with "compression=zstd" in the preheader), each MB
+//  is stored as its 10 int32 indices/locations and 6 Real coordinates, followed for each
+//  variable by the size of the compressed data (uint64) and the compressed data.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "io_wrapper.hpp"
+
+struct OutputParameters;
+
+// reads and checks compression parameters of binary outputs from <output> block
+void ReadCompressionParameters(ParameterInput *pin, OutputParameters &op);
+
+// returns number of float mantissa bits to keep for each of the labels (23 = lossless)
+std::vector<int> CompressionMantissaBits(ParameterInput *pin, const std::string &block,
+                                         Real tolerance,
+                                         const std::vector<std::string> &labels);
+
+// compresses nmbs MB records of record_size bytes, each consisting of prefix_size bytes
+// of indices/coordinates followed by nvars arrays of ncells floats
+std::vector<char> CompressRecords(const char *data, int nmbs, std::size_t record_size,
+                                  std::size_t prefix_size, int nvars, int ncells,
+                                  const std::vector<int> &nbits, int level);
+
+// writes compressed data of this rank after the data of all lower ranks (or at offset
+// header_size if single_file_per_rank), and returns the offset at which it was written
+std::uint64_t WriteCompressedData(IOWrapper &file, const std::vector<char> &cdata,
+                         std::size_t header_size, bool single_file_per_rank);
+
+#endif // OUTPUTS_OUTPUT_COMPRESSION_HPP_
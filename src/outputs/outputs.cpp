@@ -18,7 +18,7 @@
 //! Required parameters that must be specified in an <output[n]> block are:
 //!   - variable  = [list of currently implemented strings for specifing output variables
 //!                  is defined at start of outputs.hpp file]
-//!   - file_type = tab,vtk,hst,bin,rst
+//!   - file_type = tab,vtk,hst,bin,avg,hdf5,ascent,rst,log,prof
 //!   - dt        = problem time between outputs
 //!
 //! EXAMPLE of an <output[n]> block for a TAB dump:
@@ -51,6 +51,7 @@
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs.hpp"
+#include "output_compression.hpp"
 
 //----------------------------------------------------------------------------------------
 // Outputs constructor
@@ -59,7 +60,8 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
   // loop over input block names.  Find those that start with "output", read parameters,
   // and add to linked list of BaseTypeOutputs.
 
-  int num_hst=0, num_rst=0, num_log=0; // count # of hst,rst,log outputs
+  // count # of hst,rst,log,prof,perf outputs
+  int num_hst=0, num_rst=0, num_log=0, num_prof=0, num_perf=0;
   for (auto it = pin->block.begin(); it != pin->block.end(); ++it) {
     if (it->block_name.compare(0, 6, "output") == 0) {
       OutputParameters opar;  // define temporary OutputParameters struct
@@ -92,9 +94,14 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
       if (opar.file_type.compare("hst") != 0 &&
           opar.file_type.compare("rst") != 0 &&
           opar.file_type.compare("log") != 0 &&
+          opar.file_type.compare("prof") != 0 &&
+          opar.file_type.compare("perf") != 0 &&
           opar.file_type.compare("trk") != 0) {
         opar.variable = pin->GetString(opar.block_name, "variable");
-        opar.file_id = pin->GetOrAddString(opar.block_name,"id",opar.variable);
+        // time averages are written to binary files, so use a different default id
+        std::string id = opar.variable;
+        if (opar.file_type.compare("avg") == 0) {id += "_avg";}
+        opar.file_id = pin->GetOrAddString(opar.block_name,"id",id);
       }
 
       // read ghost cell option
@@ -182,9 +189,14 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
       // set output variable and optional file id (default is output variable name)
       if (opar.file_type.compare("hst") != 0 &&
           opar.file_type.compare("rst") != 0 &&
-          opar.file_type.compare("log") != 0) {
+          opar.file_type.compare("log") != 0 &&
+          opar.file_type.compare("prof") != 0 &&
+          opar.file_type.compare("perf") != 0) {
         opar.variable = pin->GetString(opar.block_name, "variable");
-        opar.file_id = pin->GetOrAddString(opar.block_name,"id",opar.variable);
+        // time averages are written to binary files, so use a different default id
+        std::string id = opar.variable;
+        if (opar.file_type.compare("avg") == 0) {id += "_avg";}
+        opar.file_id = pin->GetOrAddString(opar.block_name,"id",id);
       }
 
       // check that pdf variables are single variables
@@ -206,6 +218,7 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
       // set optional boolean to output only user-defined history variables
       if (opar.file_type.compare("hst") == 0) {
         opar.user_hist_only =pin->GetOrAddBoolean(opar.block_name,"user_hist_only",false);
+        opar.async = pin->GetOrAddBoolean(opar.block_name, "async", false);
         if (opar.user_hist_only && !(pm->pgen->user_hist)) {
           std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
               << std::endl << "User-history file requested in output block '"
@@ -232,7 +245,16 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         pnode = new EventLogOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
         num_log++;
+      } else if (opar.file_type.compare("prof") == 0) {
+        pnode = new TaskProfileOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+        num_prof++;
+      } else if (opar.file_type.compare("perf") == 0) {
+        pnode = new PerfOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+        num_perf++;
       } else if (opar.file_type.compare("vtk") == 0) {
+        opar.partitioned = pin->GetOrAddBoolean(opar.block_name, "partitioned", false);
         pnode = new MeshVTKOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
       } else if (opar.file_type.compare("pvtk") == 0) {
@@ -247,6 +269,14 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         opar.coarsen_factor = pin->GetInteger(opar.block_name,"coarsen_factor");
         opar.compute_moments = pin->GetOrAddBoolean(opar.block_name,
           "compute_moments", false);
+        opar.pyramid_levels = pin->GetOrAddInteger(opar.block_name, "pyramid_levels", 1);
+        if (opar.pyramid_levels < 1) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                    << std::endl << "pyramid_levels in output block '"
+                    << opar.block_name << "' must be >= 1" << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+        ReadCompressionParameters(pin, opar);
         pnode = new CoarsenedBinaryOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
       } else if (opar.file_type.compare("pdf") == 0) {
@@ -255,6 +285,7 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         opar.nbin = pin->GetInteger(opar.block_name,"nbin");
         opar.logscale = pin->GetOrAddBoolean(opar.block_name,"logscale",true);
         opar.mass_weighted = pin->GetOrAddBoolean(opar.block_name,"mass_weighted",false);
+        opar.accumulate = pin->GetOrAddBoolean(opar.block_name,"accumulate",false);
         // check and set second variable option.
         if (pin->DoesParameterExist(opar.block_name,"variable_2")) {
           opar.variable_2 = pin->GetString(opar.block_name, "variable_2");
@@ -271,12 +302,40 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         }
         pnode = new PDFOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
-      } else if (opar.file_type.compare("bin") == 0) {
+      } else if (opar.file_type.compare("pspec") == 0) {
+        pnode = new PowerSpectrumOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("bin") == 0 ||
+                 opar.file_type.compare("avg") == 0) {
         opar.single_file_per_rank = pin->GetOrAddBoolean(opar.block_name,
           "single_file_per_rank", false);
-        pnode = new MeshBinaryOutput(pin,pm,opar);
+        opar.async = pin->GetOrAddBoolean(opar.block_name, "async", false);
+        ReadCompressionParameters(pin, opar);
+        if (opar.single_file_per_rank) {
+          opar.aggregate = pin->GetOrAddBoolean(opar.block_name, "aggregate", false);
+          opar.ranks_per_file = pin->GetOrAddInteger(opar.block_name, "ranks_per_file",
+                                                     0);
+        }
+        if (!opar.aggregate) {
+          opar.block_index = pin->GetOrAddBoolean(opar.block_name, "block_index", true);
+        }
+        if (opar.file_type.compare("avg") == 0) {
+          pnode = new TimeAverageOutput(pin,pm,opar);
+        } else {
+          pnode = new MeshBinaryOutput(pin,pm,opar);
+        }
+        pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("hdf5") == 0) {
+        opar.compression_level = pin->GetOrAddInteger(opar.block_name,
+          "compression_level", 0);
+        opar.aggregators = pin->GetOrAddInteger(opar.block_name, "aggregators", 0);
+        pnode = new MeshHDF5Output(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("ascent") == 0) {
+        pnode = new AscentOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
       } else if (opar.file_type.compare("cart") == 0) {
+        opar.async = pin->GetOrAddBoolean(opar.block_name, "async", false);
         pnode = new CartesianGridOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
       } else if (opar.file_type.compare("sph") == 0) {
@@ -287,6 +346,45 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
       // output types are up-to-date in restart file
         opar.single_file_per_rank = pin->GetOrAddBoolean(opar.block_name,
           "single_file_per_rank", false);
+        opar.checksum = pin->GetOrAddBoolean(opar.block_name, "checksum", false);
+        opar.local_dir = pin->GetOrAddString(opar.block_name, "local_dir", "");
+        if (!opar.local_dir.empty()) {
+          opar.local_retain = pin->GetOrAddInteger(opar.block_name, "local_retain", 2);
+          opar.drain_every = pin->GetOrAddInteger(opar.block_name, "drain_every", 1);
+          if (opar.local_retain < 1 || opar.drain_every < 1) {
+            std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "local_retain and drain_every in output block '"
+                << opar.block_name << "' must be >= 1" << std::endl;
+            exit(EXIT_FAILURE);
+          }
+        }
+        // delta checkpoints refer to a base in the same directory, so cannot be used
+        // with local_dir, which removes and only selectively drains checkpoints
+        opar.delta_every = pin->GetOrAddInteger(opar.block_name, "delta_every", 1);
+        opar.delta_tol = pin->GetOrAddReal(opar.block_name, "delta_tol", 0.0);
+        if (opar.delta_every < 1 || opar.delta_tol < 0.0 ||
+            (opar.delta_every > 1 && !opar.local_dir.empty())) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "delta_every in output block '" << opar.block_name
+              << "' must be >= 1 and delta_tol >= 0, and delta checkpoints cannot be "
+              << "used with local_dir" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        // GPUDirect Storage writes data of MBs in files written by a single rank directly
+        // from device memory, so host copies needed for checksums and deltas do not exist
+        opar.gds = pin->GetOrAddBoolean(opar.block_name, "gds", false);
+#if MPI_PARALLEL_ENABLED
+        bool gds_file = (opar.single_file_per_rank || !opar.local_dir.empty());
+#else
+        bool gds_file = true;
+#endif
+        if (opar.gds && (opar.checksum || opar.delta_every > 1 || !gds_file)) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "gds in output block '" << opar.block_name << "' requires "
+              << "single_file_per_rank (with MPI), and cannot be used with checksum or "
+              << "delta_every" << std::endl;
+          exit(EXIT_FAILURE);
+        }
         pnode = new RestartOutput(pin,pm,opar);
         pout_list.push_back(pnode);
         num_rst++;
@@ -300,10 +398,10 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
   }
 
   // check there were no more than one history, event log, or restart files requested
-  if (num_hst > 1 || num_rst > 1 || num_log > 1) {
+  if (num_hst > 1 || num_rst > 1 || num_log > 1 || num_prof > 1 || num_perf > 1) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
-              << "More than one history, event log, or restart output block found in "
-              << "input file" << std::endl;
+              << "More than one history, event log, task profile, perf, or restart "
+              << "output block found in input file" << std::endl;
     exit(EXIT_FAILURE);
   }
 }
@@ -316,5 +414,6 @@ Outputs::~Outputs() {
   for (BaseTypeOutput* pnode : pout_list) {
     delete pnode;
   }
+  BaseTypeOutput::ClearOutputCaches();
   pout_list.clear();
 }
@@ -8,20 +8,28 @@
 //! \file outputs.hpp
 //  \brief provides classes to handle ALL types of data output
 
+#include <cstdint>
+#include <cstdio>
+#include <future>  // NOLINT(build/c++11)
+#include <map>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
 #include <vector>
 
-#include "Kokkos_ScatterView.hpp"
-
 #include "athena.hpp"
 #include "io_wrapper.hpp"
 
 #define NHISTORY_VARIABLES 20
+
+// Ascent and Conduit types, only defined if configured with -D Athena_ENABLE_ASCENT=ON
+namespace ascent {class Ascent;}
+namespace conduit {class Node;}
 #if NHISTORY_VARIABLES > NREDUCTION_VARIABLES
     #error NHISTORY > NREDUCTION in outputs.hpp
 #endif
 
-#define NOUTPUT_CHOICES 152
+#define NOUTPUT_CHOICES 154
 // choices for output variables used in <ouput> blocks in input file
 // TO ADD MORE CHOICES:
 //   - add more strings to array below, change NOUTPUT_CHOICES above appropriately
@@ -96,12 +104,20 @@ static const char *var_choice[NOUTPUT_CHOICES] = {
   "tmunu",
 
   // Particles (150-151)
-  "prtcl_all", "prtcl_d"
+  "prtcl_all", "prtcl_d",
+
+  // Dynamical GRMHD primitive solver iterations (152)
+  "dyn_c2p_iter",
+
+  // Rosenbrock steps of reaction network in each cell (153)
+  "chem_work"
 };
 
 
 // forward declarations
 class Mesh;
+class MeshFFT;
+class PointInterpolator;
 class ParameterInput;
 
 //----------------------------------------------------------------------------------------
@@ -132,6 +148,7 @@ struct OutputParameters {
   int coarsen_factor;
   bool compute_moments; // if true then will compute
   // <q>, <q^2>, <q^3>, <q^4> for each variable q
+  int pyramid_levels=1; // number of levels of detail, each coarsened by another 2
   // DBF parameters for PDF:
   // number of derived variables, index of current derived variable
   int n_derived=0, i_derived=0;
@@ -141,7 +158,25 @@ struct OutputParameters {
   int nbin=0, nbin2=0;
   bool logscale=true, logscale2=true;
   bool mass_weighted=false;
+  bool accumulate=false;    // sum PDFs over all outputs, kept on device (pdf only)
   bool single_file_per_rank=false; // DBF: parameter for single file per rank
+  bool async=false;   // write bin and cart files in background thread, or complete
+                      // reduction of hst data at next hst output
+  bool checksum=false;      // write per-variable checksums (rst outputs only)
+  bool aggregate=false;     // with single_file_per_rank, one file per node (bin only)
+  bool block_index=false;   // append index of offsets of MBs to file (bin only)
+  bool partitioned=false;   // one XML piece per rank and .pvtu master file (vtk only)
+  int ranks_per_file=0;     // max ranks per aggregated file, 0=all ranks on node
+  std::string compression="none";  // "zstd" to compress data (bin and cbin only)
+  Real lossy_tolerance=0.0;        // max relative error of compressed data, 0=lossless
+  int compression_level=0;  // deflate level of chunks (hdf5 outputs only)
+  int aggregators=0;        // number of MPI-IO aggregators, 0=one per node (hdf5 only)
+  std::string local_dir="";  // node-local directory for checkpoints (rst only)
+  int local_retain=2;       // number of checkpoints kept in local_dir (rst only)
+  int drain_every=1;        // copy every n-th checkpoint from local_dir to rst/
+  int delta_every=1;        // every n-th checkpoint is full, others are deltas (rst only)
+  Real delta_tol=0.0;       // max relative change of MBs omitted from delta checkpoints
+  bool gds=false;           // write from device memory with GPUDirect Storage (rst only)
 };
 
 //----------------------------------------------------------------------------------------
@@ -219,10 +254,18 @@ class BaseTypeOutput {
 
   // function which computes derived output variables like vorticity and current density
   void ComputeDerivedVariable(std::string name, Mesh *pm);
+  // releases derived variables and staged data shared between outputs (before Kokkos is
+  // finalized)
+  static void ClearOutputCaches() {derived_cache.clear(); staged_data.clear();}
+  // sets outmb_indcs from outmbs (on host and device)
+  void SetOutputMeshBlockIndices(Mesh *pm);
 
   // virtual functions may be over-ridden in derived classes
   virtual void LoadOutputData(Mesh *pm);
   virtual void WriteOutputFile(Mesh *pm, ParameterInput *pin) = 0;
+  // outputs of time averages accumulate data in every cycle in which SampleDue() is true
+  virtual bool SampleDue(Mesh *pm) {return false;}
+  virtual void AccumulateData(Mesh *pm, ParameterInput *pin) {}
 
   // Functions to detect big endian machine, and to byte-swap 32-bit words.  The vtk
   // legacy format requires data to be stored as big-endian.
@@ -239,9 +282,36 @@ class BaseTypeOutput {
 
  protected:
   // CC output data on host with dims (n,m,k,j,i) except
-  // for restarts, where dims are (m,n,k,j,i)
-  HostArray5D<Real> outarray;
-  HostArray5D<Real> outarray_hyd, outarray_mhd, outarray_rad,
+  // for restarts, where dims are (m,n,k,j,i).  Restart data is always stored as Real.
+  HostIOArray5D<OutReal> outarray;
+  DvceIOArray5D<OutReal> d_outarray;  // outarray on device, copied to host at once
+  DualArray2D<int> outmb_indcs;     // index in pack and ois,ojs,oks of each output MB
+  // Derived variables computed in the current cycle, indexed by name.  Every output
+  // requesting an already computed variable in the same cycle copies its slots from the
+  // derived_var array of the output that computed it.
+  struct DerivedVarEntry {
+    int ncycle;
+    Real time;
+    int i_dv, nvar;  // first slot and number of slots of variable in var
+    DvceArray5D<Real> var;
+  };
+  static std::map<std::string, DerivedVarEntry> derived_cache;
+  // Output data copied to host in the current cycle, for each selection of output cells
+  // (ghost zones, slices, MB) and each variable (device array and index).  Outputs in the
+  // same cycle with the same selection copy staged variables on the host, so each
+  // variable is copied from the device at most once per cycle.
+  struct StagedVarEntry {
+    HostIOArray5D<OutReal> data;  // outarray of the output that staged the variable
+    int n;                        // index of variable in data
+  };
+  struct StagedSelection {
+    int ncycle = -1;
+    Real time = 0.0;
+    std::map<std::pair<const Real*, int>, StagedVarEntry> vars;
+  };
+  static std::map<std::string, StagedSelection> staged_data;
+  std::string OutputSelectionKey() const;
+  HostIOArray5D<Real> outarray_hyd, outarray_mhd, outarray_rad,
                     outarray_force, outarray_z4c, outarray_adm;
   HostFaceFld4D<Real> outfield;  // FC output field on host
   std::vector<int> noutmbs;   // with MPI, number of output MBs across all ranks
@@ -274,6 +344,7 @@ class FormattedTableOutput : public BaseTypeOutput {
 class HistoryOutput : public BaseTypeOutput {
  public:
   HistoryOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~HistoryOutput();
 
   // vector of length [# of physics modules] containing hdata arrays
   std::vector<HistoryData> hist_data;
@@ -283,6 +354,22 @@ class HistoryOutput : public BaseTypeOutput {
   void LoadMHDHistoryData(HistoryData *pdata, Mesh *pm);
   void LoadZ4cHistoryData(HistoryData *pdata, Mesh *pm);
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  // hdata of all physics modules packed together, so they are reduced over ranks with
+  // one MPI call.  With async=true the (non-blocking) reduction started at one hst output
+  // is completed, and its rows written, at the next one.
+  std::vector<Real> hbuf;
+  Real hbuf_time, hbuf_dt;  // time and dt of data in hbuf
+  bool hbuf_pending=false;  // true if hbuf holds data not yet written
+#if MPI_PARALLEL_ENABLED
+  MPI_Request hbuf_req;
+#endif
+  // rows are appended to the files from a copy of hbuf by a host task (see
+  // utils/host_tasks.hpp), which must complete before hist_data is changed
+  std::shared_future<void> rows_done;
+  void WriteHistoryRows();
+  void AppendHistoryRows(const std::vector<Real> &buf, Real time, Real dt);
 };
 
 //----------------------------------------------------------------------------------------
@@ -298,6 +385,13 @@ class CoarsenedBinaryOutput : public BaseTypeOutput {
   //                            const int coarsen_factor);
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  // levels of detail coarser than outarray by 2,4,8,... (with pyramid_levels > 1)
+  std::vector<DvceIOArray5D<OutReal>> d_pyramid;
+  std::vector<HostIOArray5D<OutReal>> pyramid;
+  std::size_t WriteLevel(Mesh *pm, ParameterInput *pin, IOWrapper &file,
+                         std::size_t offset, const HostIOArray5D<OutReal> &data, int cf);
 };
 
 //----------------------------------------------------------------------------------------
@@ -314,14 +408,16 @@ struct PDFData {
   Real step_size, step_size2;
   bool mass_weighted;
   bool logscale, logscale2;
+  bool accumulate;  // if true, histogram is summed over all outputs instead of reset
 
-  DvceArray2D<Real> result_; // resulting histogram
-  Kokkos::Experimental::ScatterView<Real **, LayoutWrapper> scatter_result;
+  DvceArray2D<Real> result_;       // resulting histogram on this rank
+  HostArray2D<Real> result_host;   // histogram summed over all ranks (on root)
 
   PDFData(int dim, int nbinVal, int nbin2Val)
     : pdf_dimension(dim), nbin(nbinVal), nbin2(nbin2Val),
       bins("bins", nbin + 1), bins2("bins2", nbin2 + 1),
-      bins_written(false), mass_weighted(false), logscale(false), logscale2(false) {
+      bins_written(false), mass_weighted(false), logscale(false), logscale2(false),
+      accumulate(false) {
   }
 };
 
@@ -339,6 +435,27 @@ class PDFOutput : public BaseTypeOutput {
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
 };
 
+//----------------------------------------------------------------------------------------
+//! \class PowerSpectrumOutput
+//  \brief derived BaseTypeOutput class for shell-averaged power spectra of variables,
+//  computed in-situ with a distributed FFT (uniform meshes only)
+
+class PowerSpectrumOutput : public BaseTypeOutput {
+ public:
+  PowerSpectrumOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~PowerSpectrumOutput();
+
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  MeshFFT *pfft;                // FFT of variables over whole mesh
+  int nshell;                   // number of shells of width dk
+  Real dk;                      // width of shells (smallest wavenumber of mesh)
+  DvceArray2D<Real> spec_;      // power in each shell for each variable (and # of modes)
+  HostArray2D<Real> spec_host_; // power summed over all ranks (on root)
+};
+
 //----------------------------------------------------------------------------------------
 //! \class MeshVTKOutput
 //  \brief derived BaseTypeOutput class for mesh data in VTK (legacy) format
@@ -347,6 +464,9 @@ class MeshVTKOutput : public BaseTypeOutput {
  public:
   MeshVTKOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+ private:
+  void WriteLegacyFile(Mesh *pm);
+  void WritePartitionedFiles(Mesh *pm);
 };
 
 //----------------------------------------------------------------------------------------
@@ -371,9 +491,118 @@ class ParticleVTKOutput : public BaseTypeOutput {
 class MeshBinaryOutput : public BaseTypeOutput {
  public:
   MeshBinaryOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~MeshBinaryOutput();
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  // everything needed to write one file, so that it can be written by another thread
+  // while the host buffers (outarray) are reused for the next output
+  struct BinaryFile {
+    std::string fname;
+    std::string header;           // preheader, header offset, and input parameters
+    std::vector<char> data;       // packed data of all output MBs on this rank
+    std::size_t data_size;        // bytes per MB
+    std::size_t myoffset;         // offset of data of this rank in file
+    int nout_mbs;                 // number of output MBs on this rank
+    bool collective;              // all ranks write data (slices only)
+    bool by_meshblock;            // write one MB at a time (files larger than 2^31)
+    int noutmbs_min;              // min number of MBs on any rank (by_meshblock only)
+    int nvars=0, ncells=0;        // variables and cells per MB (compression only)
+    std::vector<int> nbits;       // mantissa bits kept per variable (compression only)
+    std::vector<std::uint64_t> gids;  // gid of each output MB (block_index only)
+  };
+  void WriteBinaryFile(const BinaryFile &file);
+  void WriteAggregatedFile(const BinaryFile &file, const char *data, std::size_t nbytes);
+  void WriteGroupIndex(const std::vector<int> &nmbs_eachrank, std::size_t header_size,
+                       std::size_t data_size);
+  void WriteBlockIndex(IOWrapper &binfile, const BinaryFile &file,
+                       const std::vector<std::uint64_t> &offsets,
+                       const std::vector<std::uint64_t> &sizes);
+  std::thread writer;             // thread writing last file (async only)
+  int group_index;                // index of aggregated file of this rank (aggregate)
+  std::vector<int> group_eachrank;  // index of aggregated file of each rank (aggregate)
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm write_comm;            // communicator used by the writer thread
+  MPI_Comm group_comm;            // ranks writing to same aggregated file (aggregate)
+#endif
+};
+
+//----------------------------------------------------------------------------------------
+//! \class TimeAverageOutput
+//  \brief derived MeshBinaryOutput class for time averages of variables.  Time-weighted
+//  sums are accumulated on the device every sample_dcycle cycles, and the averages over
+//  the time since the last output are written in binary format at each output.
+class TimeAverageOutput : public MeshBinaryOutput {
+ public:
+  TimeAverageOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~TimeAverageOutput();
+  bool SampleDue(Mesh *pm) override;
+  void AccumulateData(Mesh *pm, ParameterInput *pin) override;
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  // variables stored in one device array, which are summed with a single kernel
+  struct SourceArray {
+    DvceArray5D<Real> *data_ptr;
+    DualArray1D<int> index;      // index of each variable in data_ptr
+    DualArray1D<int> sum_index;  // index of each variable in sums
+  };
+  Mesh *pmy_mesh;
+  int sample_dcycle;              // number of cycles between samples
+  Real sum_time;                  // time over which sums have been accumulated
+  Real last_sample;               // time of last sample
+  DvceArray5D<Real> sums, coarse_sums;  // (nmb,nvar,n3,n2,n1), moved with MBs by AMR
+  std::vector<SourceArray> sources;
+  void AddSample(Mesh *pm, Real weight);
+};
+
+//----------------------------------------------------------------------------------------
+//! \class AscentOutput
+//  \brief derived BaseTypeOutput class for in-situ visualization with Ascent.  Each
+//  MeshBlock is published as a domain of a Conduit Blueprint mesh that wraps the device
+//  arrays of the output variables, and the actions in <output>/actions_file are executed
+//  (e.g. rendering images) at each output.
+class AscentOutput : public BaseTypeOutput {
+ public:
+  AscentOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~AscentOutput();
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  ascent::Ascent *pascent = nullptr;
+  conduit::Node *mesh_node = nullptr;  // Blueprint mesh with one domain per MB
+  DvceArray1D<int> ghosts;        // 1 in ghost cells of a MB, 0 in active cells
+  DvceIOArray5D<Real> staged;     // contiguous copies of variables (only LayoutLeft)
+};
+
+//----------------------------------------------------------------------------------------
+//! \class MeshHDF5Output
+//  \brief derived BaseTypeOutput class for mesh data in (parallel) HDF5 format
+class MeshHDF5Output : public BaseTypeOutput {
+ public:
+  MeshHDF5Output(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+ private:
+  int naggregators;  // number of ranks writing to file system with collective I/O
 };
 
+// marks per-variable checksums stored after the MeshBlock data of restart files
+constexpr char kRestartChecksumMagic[] = "ATHCHECK";
+// length of names of extra CC arrays (see ExtraArrayCC) stored in restart files
+constexpr int kExtraArrayNameLength = 64;
+// marks delta checkpoints, which store only the MBs changed since a base checkpoint
+constexpr char kRestartDeltaMagic[] = "ATHDELTA";
+// length of name of base checkpoint stored in delta checkpoints
+constexpr int kRestartBaseNameLength = 256;
+
+// checksums of each variable over the MBs on this rank of arrays read/written to restarts
+std::vector<std::uint64_t> RestartChecksums(Mesh *pm, const HostIOArray5D<Real> &hydro,
+    const HostIOArray5D<Real> &mhd, const HostFaceFld4D<Real> &b0,
+    const HostIOArray5D<Real> &rad, const HostIOArray5D<Real> &force,
+    const HostIOArray5D<Real> &z4c, const HostIOArray5D<Real> &adm);
+
 //----------------------------------------------------------------------------------------
 //! \class RestartOutput
 //  \brief derived BaseTypeOutput class for restarts
@@ -381,8 +610,33 @@ class MeshBinaryOutput : public BaseTypeOutput {
 class RestartOutput : public BaseTypeOutput {
  public:
   RestartOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~RestartOutput();
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  // with <output>/local_dir, checkpoints are written to node-local storage and copied
+  // ("drained") to rst/ by a background thread
+  std::thread drainer;                  // thread copying last checkpoint to rst/
+  std::vector<std::string> local_files; // checkpoints currently stored in local_dir
+  std::string last_local, last_pfs;     // last checkpoint and its path in rst/
+  bool last_drained=true;               // true if last checkpoint has been copied
+  std::vector<HostIOArray5D<Real>> outarray_extra;  // extra CC arrays (see ExtraArrayCC)
+  // with <output>/delta_every, the data of the last full (base) checkpoint is kept, and
+  // checkpoints in between store only MBs that changed by more than delta_tol since
+  bool have_base=false;                 // true if base_data holds the last base
+  int ndelta=0;                         // number of deltas written since the base
+  std::string base_name;                // file name (without directory) of the base
+  IOWrapperSizeT base_offset=0;         // offset of MB data in base (before gid offset)
+  IOWrapperSizeT base_size=0;           // size of data of each MB in base
+  std::vector<char> base_data;          // data of MBs on this rank, as stored in base
+  std::vector<char> base_tree;          // lloc_eachmb and nmb_eachrank of base
+  void PackMeshBlock(Mesh *pm, int m, char *pdata, bool unpack);
+  // with <output>/gds, data of MBs is written directly from device memory if possible
+  bool use_gds=false;
+  void WriteDeviceData(Mesh *pm, IOWrapper &resfile, IOWrapperSizeT offset,
+                       IOWrapperSizeT data_size);
+  bool DeltaPossible(Mesh *pm, IOWrapperSizeT data_size);
 };
 
 // Forward declaration
@@ -410,7 +664,11 @@ class CartesianGridOutput : public BaseTypeOutput {
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
  private:
   CartesianGrid *pcart;
+  PointInterpolator *pinterp;  // interpolates to grid points (requested on root only)
   MetaData md;
+  std::thread writer;          // thread writing last file (async only)
+  void WriteCartFile(const std::string &fname, const MetaData &mdata,
+                     const std::string &labels, const std::vector<float> &data);
 };
 
 // Forward declaration
@@ -428,7 +686,14 @@ class SphericalSurfaceOutput : public BaseTypeOutput {
   //! Write the data to file
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
  private:
-  SphericalSurface *psurf;
+  SphericalSurface *psurf;     // angles of surface points (at first radius)
+  std::vector<Real> radii;     // radii of spheres
+  PointInterpolator *pinterp;  // interpolates to surface points (requested on root only)
+  bool fluxes;                 // compute fluxes through spheres
+  DvceArray5D<Real> flux_dens;   // radial flux densities of mass, energy, B
+  std::vector<Real> flux_vals;   // fluxes (mdot, edot, phi) through each sphere
+  void ComputeFluxDensities(Mesh *pm);
+  void WriteFluxes(Mesh *pm);
 };
 //----------------------------------------------------------------------------------------
 //! \class EventLogOutput
@@ -437,6 +702,7 @@ class SphericalSurfaceOutput : public BaseTypeOutput {
 class EventLogOutput : public BaseTypeOutput {
  public:
   EventLogOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~EventLogOutput();
 
   // various flags to denote output status
   bool header_written=false;
@@ -444,6 +710,97 @@ class EventLogOutput : public BaseTypeOutput {
 
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  bool per_block;              // also write counters of each MeshBlock
+  bool mb_header_written=false;
+  // counters on this rank, and reduced over ranks (on root).  The (non-blocking)
+  // reductions started at one output are completed, and rows written, at the next one.
+  std::vector<int> ebuf, esum;
+  int ebuf_cycle;              // cycle of pending row
+  bool ebuf_pending=false;     // true if reductions hold data not yet written
+  // counters of each MB on this rank, and of all MBs ordered by gid (on root), with
+  // levels of all MBs
+  std::vector<int> mbbuf, mball, mblevel;
+  std::vector<int> mbcounts, mbdispls;  // arguments of gather, fixed until completed
+#if MPI_PARALLEL_ENABLED
+  MPI_Request ereq[2];
+  MPI_Datatype evc_type;       // all counters of one rank or MB
+  MPI_Op sum_max_op;           // sums all counters, except maximum of EVC_MAXIT
+#endif
+  std::shared_future<void> rows_done;  // host task appending rows from copies of buffers
+  void WriteEventRows();
+  void AppendEventRows(const std::vector<int> &sum, const std::vector<int> &all,
+                       const std::vector<int> &level, int cycle);
+};
+
+//----------------------------------------------------------------------------------------
+//! \class TaskProfileOutput
+//  \brief derived BaseTypeOutput class for timing data of each Task in each TaskList
+
+class TaskProfileOutput : public BaseTypeOutput {
+ public:
+  TaskProfileOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ protected:
+  int last_cycle;   // cycle at which timers were last reset
+  int ncycles;      // number of cycles over which current times were accumulated
+  int sample_cycles;  // Tasks timed only every sample_cycles cycles if > 0
+  // following vectors store data for each TaskList, in order of tl_map
+  std::vector<std::string> tl_names;
+  std::vector<std::vector<std::string>> task_names;
+  std::vector<std::vector<double>> tmean, tmax;  // time per cycle, mean/max over ranks
+  std::vector<std::vector<bool>> on_path;        // true for Tasks on critical path
+  std::vector<double> cpath_mean, cpath_max;     // critical path, mean/max over ranks
+  // with sampling: number of samples, rank with maximum time and peak time of each Task
+  std::vector<int> nsamples;
+  std::vector<std::vector<int>> tmax_rank;
+  std::vector<std::vector<double>> tpeak;
+  // time per sampled cycle in all Tasks on the slowest rank, and mean over ranks
+  double slow_time = 0.0, mean_time = 0.0;
+  int slow_rank = 0;
+  std::string slow_host;
+  // value and rank for MPI_MAXLOC reductions (layout of MPI_DOUBLE_INT)
+  struct DoubleInt {
+    double time;
+    int rank;
+  };
+  void WriteSampledProfile(FILE *pfile);
+};
+
+//----------------------------------------------------------------------------------------
+//! \class PerfOutput
+//  \brief derived BaseTypeOutput class for cycle-level performance telemetry
+
+class PerfOutput : public BaseTypeOutput {
+ public:
+  PerfOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~PerfOutput();
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  // t_cycle, t_comp, t_comm, t_amr, bytes_sent, gbytes_s, gflops_s, roofline
+  static constexpr int nperf = 8;
+  Kokkos::Timer timer;      // wall time since last output
+  Real peak_bandwidth, peak_gflops;  // of device, used for roofline fraction
+  int last_cycle;           // cycle of last output
+  bool header_written=false;
+  // per-cycle values on this rank (followed by negated values, so that the minimum
+  // over ranks is found with the same MPI_MAX reduction as the maximum), and their
+  // maximum and sum over ranks.  The (non-blocking) reductions started at one perf
+  // output are completed, and the row written, at the next one.
+  double pval[2*nperf], pmax[2*nperf], psum[nperf];
+  int pbuf_cycle, pbuf_ncycles;  // cycle and number of cycles of pending row
+  Real pbuf_time;                // time of pending row
+  double pbuf_nzones;            // number of zones updated per cycle in pending row
+  bool pbuf_pending=false;       // true if reductions hold data not yet written
+#if MPI_PARALLEL_ENABLED
+  MPI_Request preq[2];
+#endif
+  void WritePerfRow();
 };
 
 //----------------------------------------------------------------------------------------
@@ -453,8 +810,10 @@ class EventLogOutput : public BaseTypeOutput {
 class TrackedParticleOutput : public BaseTypeOutput {
  public:
   TrackedParticleOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~TrackedParticleOutput();
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
  protected:
   int ntrack;           // total number of tracked particles across all ranks
   int ntrack_thisrank;  // number of tracked particles this rank (guess)
@@ -462,6 +821,27 @@ class TrackedParticleOutput : public BaseTypeOutput {
   bool header_written;
   std::vector<int> npout_eachrank;
   HostArray1D<TrackedParticleData> outpart;
+
+  // With <output>/stream=true, tracked particles are appended to device buffers at every
+  // output, and each rank appends the buffered outputs as one batch (when the buffers
+  // are full) to its own file, written in columns by a background thread.
+  bool stream;
+  std::string stream_fname;  // file written by this rank
+  int buffer_size;           // capacity of device buffers (number of particle records)
+  int nbuf;                  // number of records in device buffers
+  DvceArray2D<Real> buf_rdata;  // (x,y,z,vx,vy,vz) of each record
+  DvceArray1D<int> buf_tag;     // tag of each record
+  std::vector<int32_t> buf_cycle, buf_nrec;  // cycle and records of each output
+  std::vector<double> buf_time;              // time of each output
+  struct TrackedBatch {
+    std::vector<int32_t> cycle, nrec, tag;
+    std::vector<double> time;
+    std::vector<float> data;   // six columns of records
+  };
+  void AppendToStream(Mesh *pm);
+  void FlushStream();
+  void WriteTrackedBatch(const TrackedBatch &batch);
+  std::thread writer;        // thread writing last batch
 };
 
 //----------------------------------------------------------------------------------------
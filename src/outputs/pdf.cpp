@@ -17,6 +17,9 @@
 //
 //  These bins are written to their own file when the first output is written
 //  the pdfs are written to their own file for each output
+//
+//  With accumulate=true the pdf is not reset between outputs, so each file contains the
+//  pdf summed over all outputs so far (since the start of this run).
 
 #include <sys/stat.h>  // mkdir
 
@@ -36,9 +39,26 @@
 #include "z4c/z4c.hpp"
 #include "outputs.hpp"
 
-// ScatterView is not part of Kokkos core interface
-#include "Kokkos_ScatterView.hpp"
+// maximum size of histogram accumulated in team scratch memory before being added to
+// result in global memory
+#define PDF_MAX_SCRATCH_BYTES 32768
 
+//----------------------------------------------------------------------------------------
+//! \fn int PDFBin()
+//  \brief Returns index of bin containing val, with 0 and nbin+1 for values outside range
+
+KOKKOS_INLINE_FUNCTION
+int PDFBin(const Real val, const Kokkos::View<Real*> &bins, const int nbin,
+           const Real step, const bool logscale) {
+  if (val < bins(0)) {
+    return 0;
+  } else if (val >= bins(nbin)) {
+    return nbin + 1;
+  } else if (logscale) {
+    return static_cast<int>(std::log10(val/bins(0))/step) + 1;
+  }
+  return static_cast<int>((val - bins(0))/step) + 1;
+}
 
 //----------------------------------------------------------------------------------------
 // Constructor: also calls BaseTypeOutput base class constructor
@@ -58,6 +78,7 @@ PDFOutput::PDFOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
 
   pdf_data.mass_weighted = op.mass_weighted;
   pdf_data.logscale = op.logscale;
+  pdf_data.accumulate = op.accumulate;
 
   // throw an error if the user tries to use logscale
   // with a negative bin_min for both 1D and 2D
@@ -146,9 +167,7 @@ PDFOutput::PDFOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
   } else if (pdf_data.pdf_dimension == 1) {
     pdf_data.result_ = DvceArray2D<Real>("result", 1, op.nbin+2);
   }
-  pdf_data.scatter_result = Kokkos::Experimental::ScatterView<Real **, LayoutWrapper>(
-    pdf_data.result_
-  );
+  pdf_data.result_host = Kokkos::create_mirror_view(pdf_data.result_);
 }
 
 
@@ -199,36 +218,16 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
   int js = indcs.js; int je = indcs.je;
   int ks = indcs.ks; int ke = indcs.ke;
 
-  auto result  = pdf_data.result_;
-  auto scatter = pdf_data.scatter_result;
-
+  auto result = pdf_data.result_;
   int nmb = pm->pmb_pack->nmb_thispack;
-  int nx1 = indcs.nx1 + 2*indcs.ng;
-  int nx2 = indcs.nx2 + 2*indcs.ng;
-  int nx3 = indcs.nx3 + 2*indcs.ng;
-
-  // Copy MeshBlock data from host to device
-  DvceArray5D<Real> outvars_device("outvars_device", outvars.size(), nmb, nx3, nx2, nx1);
-  for (std::size_t i = 0; i < outvars.size(); ++i) {
-      auto d_slice = Kokkos::subview(*(outvars[i].data_ptr),
-      Kokkos::ALL(), outvars[i].data_index, Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL());
-      auto d_target_slice = Kokkos::subview(outvars_device, i,
-      Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL());
-      Kokkos::deep_copy(d_target_slice, d_slice);
-  }
-  Kokkos::fence();
 
-  //
-
-  // Reset ScatterView from previous output
-  scatter.reset();
-  // Also reset the histogram from previous call.
-  // Currently still required for consistent results between host and device backends, see
-  // https://github.com/kokkos/kokkos/issues/6363
-  Kokkos::deep_copy(result, 0);
-  Kokkos::fence();
+  // reset histogram from previous output, unless accumulating over outputs
+  if (!(pdf_data.accumulate)) {
+    Kokkos::deep_copy(result, 0.0);
+  }
 
-  // Capture the necessary data from pdf_data
+  // Capture the necessary data from pdf_data.  Variables are read directly from their
+  // arrays, without copying them.
   auto bins = pdf_data.bins;
   auto bins2 = pdf_data.bins2;
   auto step_size = pdf_data.step_size;
@@ -239,66 +238,75 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
   bool logscale = pdf_data.logscale;
   bool logscale2 = pdf_data.logscale2;
   bool mass_weighted = pdf_data.mass_weighted;
+  auto xvar = *(outvars[0].data_ptr);
+  int xindex = outvars[0].data_index;
+  auto yvar = (pdf_dimension == 2)? *(outvars[1].data_ptr) : xvar;
+  int yindex = (pdf_dimension == 2)? outvars[1].data_index : xindex;
+
+  // Each team bins one (m,k) plane of cells.  If the histogram is small enough it is
+  // accumulated in team scratch memory, and then added to the result, so that atomic
+  // updates of global memory are (nearly) free of contention.
+  const int nx = nbin_ + 2;
+  const int ny = result.extent_int(0);
+  const int nbins_total = nx*ny;
+  const bool use_scratch = (nbins_total*sizeof(Real) <= PDF_MAX_SCRATCH_BYTES);
+  size_t scr_size = use_scratch? ScrArray1D<Real>::shmem_size(nbins_total) : 0;
+  int scr_level = 0;
+  const int ni = ie - is + 1;
+  const int nji = (je - js + 1)*ni;
+  par_for_outer("pdf", DevExeSpace(), scr_size, scr_level, 0, nmb-1, ks, ke,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+    ScrArray1D<Real> hist;
+    if (use_scratch) {
+      hist = ScrArray1D<Real>(member.team_scratch(scr_level), nbins_total);
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nbins_total),
+      [&](const int n) {
+        hist(n) = 0.0;
+      });
+      member.team_barrier();
+    }
 
-  par_for("pdf", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    auto &x_val = outvars_device(0, m, k, j, i);
-    int x_bin = -1;
-    // First handle edge cases explicitly
-    if (x_val < bins(0)) {
-      x_bin = 0;
-    } else if (x_val >= bins(nbin_)) {
-      x_bin = nbin_ + 1;
-    } else {
-      if (logscale == false) {
-        x_bin = static_cast<int>((x_val - bins(0)) / step_size) + 1;
-      } else if (logscale == true) {
-        x_bin = static_cast<int>(std::log10(x_val / bins(0)) / step_size) + 1;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nji), [&](const int idx) {
+      int j = idx/ni + js;
+      int i = idx - (j - js)*ni + is;
+      int x_bin = PDFBin(xvar(m,xindex,k,j,i), bins, nbin_, step_size, logscale);
+      // needs to be zero as for the 1D histogram we need 0 as first index of the 2D
+      // result array
+      int y_bin = 0;
+      if (pdf_dimension == 2) {
+        y_bin = PDFBin(yvar(m,yindex,k,j,i), bins2, nbin2_, step_size2, logscale2);
       }
-    }
-    // needs to be zero as for the 1D histogram we need 0 as first index of the 2D
-    // result array
-    int y_bin = 0;
-    if (pdf_dimension == 2) {
-      auto &y_val = outvars_device(1, m, k, j, i);
-
-      y_bin = -1; // reset to impossible value
-      // First handle edge cases explicitly
-      if (y_val < bins2(0)) {
-        y_bin = 0;
-      } else if (y_val >= bins2(nbin2_)) {
-        y_bin = nbin2_ + 1;
+      Real weight = mass_weighted ? vol*u0_(m,IDN,k,j,i) : vol;
+      if (use_scratch) {
+        Kokkos::atomic_add(&hist(y_bin*nx + x_bin), weight);
       } else {
-        // for lin and log directly pick index
-        if (logscale2 == false) {
-          y_bin = static_cast<int>((y_val - bins2(0)) / step_size2) + 1;
-        } else if (logscale2 == true) {
-          y_bin = static_cast<int>(std::log10(y_val/bins2(0)) / step_size2) + 1;
-        }
+        Kokkos::atomic_add(&result(y_bin, x_bin), weight);
       }
+    });
+
+    if (use_scratch) {
+      member.team_barrier();
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nbins_total),
+      [&](const int n) {
+        if (hist(n) != 0.0) {
+          Kokkos::atomic_add(&result(n/nx, n%nx), hist(n));
+        }
+      });
     }
-    auto res = scatter.access();
-    Real weight = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
-    weight *= mass_weighted == false
-              ? 1.0
-              : u0_(m, IDN, k, j, i);
-    res(y_bin, x_bin) += weight;
   });
 
-  // "reduce" results from scatter view to original view.
-  // May be a no-op depending on backend.
-  Kokkos::Experimental::contribute(result, scatter); //.KokkosView()
-  // Kokkos::Experimental::contribute(result.KokkosView(), scatter);
-  Kokkos::fence(); // May not be required
-
-  // Now reduce over ranks
+  // Now reduce over ranks on host into result_host, so that histogram on device stays
+  // the sum over this rank only (required when accumulating)
+  auto &result_host = pdf_data.result_host;
+  Kokkos::deep_copy(result_host, result);
 #if MPI_PARALLEL_ENABLED
   if (global_variable::my_rank == 0) {
-    MPI_Reduce(MPI_IN_PLACE, result.data(), result.size(),
-                                   MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, result_host.data(), result_host.size(),
+               MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
   } else {
-    MPI_Reduce(result.data(), result.data(), result.size(),
-                                   MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(result_host.data(), result_host.data(), result_host.size(),
+               MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
   }
 #endif
 }
@@ -387,11 +395,8 @@ void PDFOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       exit(EXIT_FAILURE);
     }
 
-    // Create a host mirror of the pdf_data.result_ array
-    auto result_host = Kokkos::create_mirror_view(pdf_data.result_);
-
-    // Copy the data from the device to the host
-    Kokkos::deep_copy(result_host, pdf_data.result_);
+    // histogram summed over all ranks in LoadOutputData()
+    auto &result_host = pdf_data.result_host;
 
     // write history variables
     std::fprintf(pfile, "# time= ");
@@ -0,0 +1,191 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file perf.cpp
+//! \brief writes cycle-level performance telemetry to a text file "basename.perf".  At
+//! each output the following, averaged per cycle over the cycles since the last output,
+//! are measured on every rank:
+//!   t_cycle:    wall time of a cycle
+//!   t_comp:     t_cycle - t_comm - t_amr
+//!   t_comm:     host wall time in boundary communication functions (including packing
+//!               and unpacking kernels, and waiting for messages)
+//!   t_amr:      wall time in mesh refinement and automatic load balancing
+//!   bytes_sent: bytes sent to other ranks in boundary communication
+//!   gbytes_s:   device memory bandwidth (GB/s) achieved in t_comp, and
+//!   gflops_s:   floating-point rate (GFLOP/s) achieved in t_comp, both from the
+//!               theoretical cost of the hot kernels in each stage (utils/roofline.hpp)
+//!   roofline:   fraction of the roofline achieved, given the peak bandwidth (GB/s) and
+//!               flop rate (GFLOP/s) of the device as peak_bandwidth and peak_gflops in
+//!               the output block (zero if not given)
+//! and their mean, minimum, and maximum over ranks are written, together with the
+//! zone-cycles/second set by the slowest rank.  With MPI the reductions over ranks are
+//! non-blocking, so each row is written at the next perf output (or at the end of the
+//! run), and does not stall the time loop.
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/roofline.hpp"
+#include "outputs.hpp"
+
+//----------------------------------------------------------------------------------------
+// ctor: also calls BaseTypeOutput base class constructor
+
+PerfOutput::PerfOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op),
+  last_cycle(pm->ncycle),
+  pbuf_cycle(-1),
+  pbuf_ncycles(0) {
+  pm->pcounter = PerfCounters();
+  peak_bandwidth = pin->GetOrAddReal(op.block_name, "peak_bandwidth", 0.0);
+  peak_gflops = pin->GetOrAddReal(op.block_name, "peak_gflops", 0.0);
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor: completes reductions and writes row of last perf output
+
+PerfOutput::~PerfOutput() {
+  if (pbuf_pending) {
+#if MPI_PARALLEL_ENABLED
+    MPI_Waitall(2, preq, MPI_STATUSES_IGNORE);
+#endif
+    WritePerfRow();
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PerfOutput::LoadOutputData()
+//! \brief completes reductions (and writes row) of previous output, then computes the
+//! per-cycle values on this rank since the last output.  Counters are reset afterwards.
+
+void PerfOutput::LoadOutputData(Mesh *pm) {
+  if (pbuf_pending) {
+#if MPI_PARALLEL_ENABLED
+    MPI_Waitall(2, preq, MPI_STATUSES_IGNORE);
+#endif
+    WritePerfRow();
+  }
+
+  int ncycles = pm->ncycle - last_cycle;
+  if (ncycles <= 0) return;
+  double dn = static_cast<double>(ncycles);
+  double t_cycle = timer.seconds()/dn;
+  double t_comm = pm->pcounter.t_comm/dn;
+  double t_amr = pm->pcounter.t_amr/dn;
+  pval[0] = t_cycle;
+  pval[1] = t_cycle - t_comm - t_amr;
+  pval[2] = t_comm;
+  pval[3] = t_amr;
+  pval[4] = static_cast<double>(pm->pcounter.nbytes_sent)/dn;
+  // achieved rates from theoretical cost of cells updated on this rank in t_comp
+  roofline::KernelCost cost = roofline::StageCost(pm->pmb_pack);
+  double cells = static_cast<double>(pm->pcounter.nstages)*
+                 static_cast<double>(pm->nmb_thisrank)*
+                 static_cast<double>(pm->NumberOfMeshBlockCells());
+  double cells_per_s = (pval[1] > 0.0) ? cells/(dn*pval[1]) : 0.0;
+  roofline::MachinePeak peak;
+  peak.bytes_per_s = 1.0e9*peak_bandwidth;
+  peak.flops_per_s = 1.0e9*peak_gflops;
+  pval[5] = 1.0e-9*cost.bytes*cells_per_s;
+  pval[6] = 1.0e-9*cost.flops*cells_per_s;
+  pval[7] = roofline::RooflineFraction(cost, cells_per_s, peak);
+  for (int n=0; n<nperf; ++n) {
+    pval[nperf + n] = -pval[n];
+  }
+  pbuf_cycle = pm->ncycle;
+  pbuf_ncycles = ncycles;
+  pbuf_time = pm->time;
+  pbuf_nzones = static_cast<double>(pm->nmb_total)*
+                static_cast<double>(pm->NumberOfMeshBlockCells());
+
+  // reset counters and timer
+  pm->pcounter = PerfCounters();
+  timer.reset();
+  last_cycle = pm->ncycle;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PerfOutput::WriteOutputFile()
+//! \brief starts reductions over all MPI ranks of data computed in LoadOutputData().
+//! Without MPI the row is written immediately.
+
+void PerfOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  // only when some cycles have been measured (the same on all ranks)
+  if (pbuf_ncycles > 0 && pbuf_cycle == pm->ncycle) {
+#if MPI_PARALLEL_ENABLED
+    MPI_Iallreduce(pval, pmax, 2*nperf, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD, &preq[0]);
+    MPI_Iallreduce(pval, psum, nperf, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &preq[1]);
+    pbuf_pending = true;
+#else
+    for (int n=0; n<2*nperf; ++n) {pmax[n] = pval[n];}
+    for (int n=0; n<nperf; ++n) {psum[n] = pval[n];}
+    WritePerfRow();
+#endif
+  }
+
+  // increment output time, clean up
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PerfOutput::WritePerfRow()
+//! \brief root rank appends one row of reduced data to the perf file
+
+void PerfOutput::WritePerfRow() {
+  pbuf_pending = false;
+  // only the master rank writes the file
+  if (global_variable::my_rank != 0) {return;}
+
+  std::string fname;
+  fname.assign(out_params.file_basename);
+  fname.append(".perf");
+  FILE *pfile;
+  if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  const char *names[nperf] = {"t_cycle", "t_comp", "t_comm", "t_amr", "bytes_sent",
+                              "gbytes_s", "gflops_s", "roofline"};
+  if (!(header_written)) {
+    std::fprintf(pfile, "# Athena performance telemetry: nranks=%d\n",
+                 global_variable::nranks);
+    std::fprintf(pfile, "# times are wall-clock seconds per cycle, bytes per cycle; "
+                 "mean/min/max over ranks\n");
+    std::fprintf(pfile, "# [1]=cycle [2]=time [3]=ncycles [4]=zone-cycles/s");
+    int col = 5;
+    for (int n=0; n<nperf; ++n) {
+      std::fprintf(pfile, " [%d]=%s_mean [%d]=%s_min [%d]=%s_max", col, names[n],
+                   col+1, names[n], col+2, names[n]);
+      col += 3;
+    }
+    std::fprintf(pfile, "\n");
+    header_written = true;
+  }
+
+  // rate set by slowest rank
+  double zcps = (pmax[0] > 0.0) ? pbuf_nzones/pmax[0] : 0.0;
+  double nranks = static_cast<double>(global_variable::nranks);
+  std::fprintf(pfile, "%10d %14.7e %6d %12.5e", pbuf_cycle, pbuf_time, pbuf_ncycles,
+               zcps);
+  for (int n=0; n<nperf; ++n) {
+    std::fprintf(pfile, " %12.5e %12.5e %12.5e", psum[n]/nranks, -pmax[nperf + n],
+                 pmax[n]);
+  }
+  std::fprintf(pfile, "\n");
+  std::fclose(pfile);
+}
@@ -0,0 +1,193 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file power_spectrum.cpp
+//  \brief writes shell-averaged power spectra of output variables, computed in-situ with
+//  the distributed FFT in utils/fft_mesh.cpp, so that spectra can be followed at high
+//  cadence without dumping the full data.
+//
+//  Modes are binned into spherical shells of width dk = 2 pi/L (with L the largest
+//  extent of the mesh), with shell n containing (n-1/2)dk <= |k| < (n+1/2)dk.  The power
+//  of each variable q is normalized as |q_k|^2/N^2 (with N the number of cells), so that
+//  the sum over shells is the volume average of q^2.  One column is written for each
+//  output variable, so e.g. the kinetic energy spectrum follows from variable=hydro_w as
+//  (P(vx)+P(vy)+P(vz))/2.  Uniform meshes only.
+
+#include <sys/stat.h>  // mkdir
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/fft_mesh.hpp"
+#include "outputs.hpp"
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+PowerSpectrumOutput::PowerSpectrumOutput(ParameterInput *pin, Mesh *pm,
+                                         OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+  if (out_params.slice1 || out_params.slice2 || out_params.slice3 ||
+      out_params.gid >= 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Power spectrum outputs cannot be sliced, or restricted to "
+              << "one MeshBlock" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  pfft = new MeshFFT(pm->pmb_pack);
+
+  // width of shells, and number of shells needed to contain largest wavenumber
+  Real lx[3] = {pm->mesh_size.x1max - pm->mesh_size.x1min,
+                pm->mesh_size.x2max - pm->mesh_size.x2min,
+                pm->mesh_size.x3max - pm->mesh_size.x3min};
+  int nx[3] = {pfft->nx1, pfft->nx2, pfft->nx3};
+  Real lmax = 0.0, kmax2 = 0.0;
+  for (int d=0; d<3; ++d) {
+    if (nx[d] > 1) {
+      lmax = std::max(lmax, lx[d]);
+      Real kd = M_PI*static_cast<Real>(nx[d])/lx[d];
+      kmax2 += kd*kd;
+    }
+  }
+  dk = 2.0*M_PI/lmax;
+  nshell = static_cast<int>(std::sqrt(kmax2)/dk + 0.5) + 1;
+
+  // last row of spectrum holds number of modes in each shell
+  int nvar = static_cast<int>(outvars.size());
+  spec_ = DvceArray2D<Real>("pspec", nvar+1, nshell);
+  spec_host_ = Kokkos::create_mirror_view(spec_);
+
+  // create directories for outputs. Comments in binary.cpp constructor explain why
+  mkdir("pspec",0775);
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+PowerSpectrumOutput::~PowerSpectrumOutput() {
+  delete pfft;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PowerSpectrumOutput::LoadOutputData()
+//  \brief Transforms each output variable, and sums power of modes into shells
+
+void PowerSpectrumOutput::LoadOutputData(Mesh *pm) {
+  // Calculate derived variables, if required
+  if (out_params.contains_derived) {
+    ComputeDerivedVariable(out_params.variable, pm);
+  }
+
+  auto spec = spec_;
+  Kokkos::deep_copy(spec, 0.0);
+  int nvar = static_cast<int>(outvars.size());
+  int nx1 = pfft->nx1, nx2 = pfft->nx2, nx3 = pfft->nx3;
+  Real kx1 = 2.0*M_PI/(pm->mesh_size.x1max - pm->mesh_size.x1min);
+  Real kx2 = 2.0*M_PI/(pm->mesh_size.x2max - pm->mesh_size.x2min);
+  Real kx3 = 2.0*M_PI/(pm->mesh_size.x3max - pm->mesh_size.x3min);
+  Real norm = 1.0/(static_cast<Real>(nx1)*static_cast<Real>(nx2)*static_cast<Real>(nx3));
+  norm *= norm;
+  Real dk_ = dk;
+  int nshell_ = nshell;
+  int nk = pfft->kbox.Size();
+
+  for (int v=0; v<nvar; ++v) {
+    pfft->Forward(*(outvars[v].data_ptr), outvars[v].data_index);
+    if (nk == 0) continue;
+    auto kbox = pfft->kbox;
+    auto kdata = pfft->kdata;
+    bool count = (v == 0);
+    par_for("pspec", DevExeSpace(), 0, nk-1, KOKKOS_LAMBDA(const int idx) {
+      int x[3];
+      kbox.Location(idx, x);
+      Real k1 = kx1*static_cast<Real>((2*x[0] < nx1) ? x[0] : x[0] - nx1);
+      Real k2 = kx2*static_cast<Real>((2*x[1] < nx2) ? x[1] : x[1] - nx2);
+      Real k3 = kx3*static_cast<Real>((2*x[2] < nx3) ? x[2] : x[2] - nx3);
+      int n = static_cast<int>(sqrt(k1*k1 + k2*k2 + k3*k3)/dk_ + 0.5);
+      n = (n < nshell_) ? n : nshell_ - 1;
+      Real re = kdata(2*idx), im = kdata(2*idx+1);
+      Kokkos::atomic_add(&spec(v,n), norm*(re*re + im*im));
+      if (count) {Kokkos::atomic_add(&spec(nvar,n), 1.0);}
+    });
+  }
+
+  // reduce over ranks on host into spec_host_
+  Kokkos::deep_copy(spec_host_, spec);
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, spec_host_.data(), spec_host_.size(),
+               MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(spec_host_.data(), spec_host_.data(), spec_host_.size(),
+               MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PowerSpectrumOutput::WriteOutputFile()
+//  \brief writes spectrum as a table with one row per shell: wavenumber, number of modes,
+//  and power of each output variable
+
+void PowerSpectrumOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  // only the master rank writes the file
+  if (global_variable::my_rank == 0) {
+    // create filename: "pspec/file_basename" + "." + "file_id" + "." + XXXXX + ".pspec"
+    // where XXXXX = 5-digit file_number
+    std::string fname;
+    char number[6];
+    std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+    fname.assign("pspec/");
+    fname.append(out_params.file_basename);
+    fname.append(".");
+    fname.append(out_params.file_id);
+    fname.append(".");
+    fname.append(number);
+    fname.append(".pspec");
+
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(),"w")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    int nvar = static_cast<int>(outvars.size());
+    std::fprintf(pfile, "# Athena power spectrum at time=%e  cycle=%d\n",
+                 pm->time, pm->ncycle);
+    std::fprintf(pfile, "# [1]=k  [2]=nmodes");
+    for (int v=0; v<nvar; ++v) {
+      std::fprintf(pfile, "  [%d]=%s", v+3, outvars[v].label.c_str());
+    }
+    std::fprintf(pfile, "\n");
+    for (int n=0; n<nshell; ++n) {
+      std::fprintf(pfile, out_params.data_format.c_str(), n*dk);
+      std::fprintf(pfile, " %d", static_cast<int>(spec_host_(nvar,n)));
+      for (int v=0; v<nvar; ++v) {
+        std::fprintf(pfile, out_params.data_format.c_str(), spec_host_(v,n));
+      }
+      std::fprintf(pfile, "\n");
+    }
+    std::fclose(pfile);
+  }
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
@@ -4,18 +4,29 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file restart.cpp
-//! \brief writes restart files
+//! \brief writes restart files.  With <output>/delta_every = n > 1, only every n-th
+//! checkpoint is a full (base) checkpoint.  The others are delta checkpoints, which
+//! contain the same header, but store only the data of MBs that changed by more than a
+//! relative tolerance <output>/delta_tol (default 0, i.e. bitwise) since the base, plus
+//! the name of the base file from which the data of all other MBs is read on restart.
+//! A base is also written whenever the Mesh or the distribution of MBs over ranks has
+//! changed since the last base.
 
 #include <sys/stat.h>  // mkdir
 
 #include <algorithm>
+#include <cmath>
 #include <cstdio>      // fwrite(), fclose(), fopen(), fnprintf(), snprintf()
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility> // make_pair
+#include <vector>
 
 #include "athena.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -38,12 +49,88 @@ RestartOutput::RestartOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
   BaseTypeOutput(pin, pm, op) {
   // create directories for outputs. Comments in binary.cpp constructor explain why
   mkdir("rst",0775);
-  bool single_file_per_rank = op.single_file_per_rank;
+  bool single_file_per_rank = op.single_file_per_rank || !op.local_dir.empty();
   if (single_file_per_rank) {
     char rank_dir[20];
     std::snprintf(rank_dir, sizeof(rank_dir), "rst/rank_%08d/", global_variable::my_rank);
     mkdir(rank_dir, 0775);
   }
+  // with local_dir, each rank writes its own file to node-local storage (e.g. /dev/shm
+  // or NVMe), in the same rank_YYYYYYYY/ layout, so drained copies in rst/ are normal
+  // single_file_per_rank restarts
+  if (!op.local_dir.empty()) {
+    mkdir(op.local_dir.c_str(), 0775);
+    char rank_dir[20];
+    std::snprintf(rank_dir, sizeof(rank_dir), "/rank_%08d", global_variable::my_rank);
+    std::string local_rank_dir = op.local_dir + rank_dir;
+    mkdir(local_rank_dir.c_str(), 0775);
+    struct stat sb;
+    if (stat(local_rank_dir.c_str(), &sb) != 0 || !S_ISDIR(sb.st_mode)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Could not create directory '" << local_rank_dir
+                << "' for local checkpoints" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! n bool CopyCheckpoint()
+//  rief Copies file src to dst, returns false (leaving src in place) on failure.
+//  Only uses stdio, so it is safe to call from the drain thread.
+
+namespace {
+bool CopyCheckpoint(const std::string &src, const std::string &dst) {
+  std::FILE *fin = std::fopen(src.c_str(), "rb");
+  if (fin == nullptr) {return false;}
+  std::FILE *fout = std::fopen(dst.c_str(), "wb");
+  if (fout == nullptr) {
+    std::fclose(fin);
+    return false;
+  }
+  std::vector<char> buf(1 << 24);
+  bool ok = true;
+  std::size_t n;
+  while ((n = std::fread(buf.data(), 1, buf.size(), fin)) > 0) {
+    if (std::fwrite(buf.data(), 1, n, fout) != n) {
+      ok = false;
+      break;
+    }
+  }
+  if (std::ferror(fin)) {ok = false;}
+  std::fclose(fin);
+  if (std::fclose(fout) != 0) {ok = false;}
+  return ok;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::vector<char> MeshTree()
+//  \brief Returns the locations of all MBs and number of MBs on each rank as bytes, used
+//  to check that a delta checkpoint can refer to the base.
+
+std::vector<char> MeshTree(Mesh *pm) {
+  std::size_t nlloc = (pm->nmb_total)*sizeof(LogicalLocation);
+  std::size_t nrank = (global_variable::nranks)*sizeof(int);
+  std::vector<char> tree(nlloc + nrank);
+  std::memcpy(tree.data(), pm->lloc_eachmb, nlloc);
+  std::memcpy(tree.data() + nlloc, pm->nmb_eachrank, nrank);
+  return tree;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// destructor: waits for the drain thread, and copies the last checkpoint to rst/ if it
+// was not drained (so the final restart always reaches the parallel file system)
+
+RestartOutput::~RestartOutput() {
+  if (drainer.joinable()) {drainer.join();}
+  if (!last_drained) {
+    if (!CopyCheckpoint(last_local, last_pfs)) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Could not copy checkpoint '" << last_local << "' to '" << last_pfs
+                << "'" << std::endl;
+    }
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -59,6 +146,22 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
   int nout3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
   int nmb = pm->pmb_pack->nmb_thispack;
 
+  // With gds, data is written from device memory in WriteDeviceData(), so it is not
+  // copied to the host.  Otherwise (or if the cuFile driver cannot be opened, or the
+  // data of each MB is not contiguous on the device) fall back to host copies.
+  use_gds = out_params.gds && !(FIELD_LAYOUT_LEFT) && IOWrapper::DeviceIOAvailable();
+  if (out_params.gds && !use_gds) {
+    static bool warned = false;
+    if (!warned && global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "GPUDirect Storage not available for output block '"
+                << out_params.block_name << "', writing restarts from host memory"
+                << std::endl;
+    }
+    warned = true;
+  }
+  if (use_gds) {return;}
+
   // calculate total number of CC variables
   hydro::Hydro* phydro = pm->pmb_pack->phydro;
   mhd::MHD* pmhd = pm->pmb_pack->pmhd;
@@ -80,18 +183,18 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
   }
   // if the spacetime is evolved, we do not need to checkpoint/recover the ADM variables
   if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
+    nrad = prad->nintens;
   }
 
   // Note for restarts, outarrays are dimensioned (m,n,k,j,i)
   if (phydro != nullptr) {
     Kokkos::realloc(outarray_hyd, nmb, nhydro, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_hyd, Kokkos::subview(phydro->u0, std::make_pair(0,nmb),
+    DeepCopyLayout(outarray_hyd, Kokkos::subview(phydro->u0, std::make_pair(0,nmb),
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
   }
   if (pmhd != nullptr) {
     Kokkos::realloc(outarray_mhd, nmb, nmhd, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_mhd, Kokkos::subview(pmhd->u0, std::make_pair(0,nmb),
+    DeepCopyLayout(outarray_mhd, Kokkos::subview(pmhd->u0, std::make_pair(0,nmb),
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
     Kokkos::realloc(outfield.x1f, nmb, nout3, nout2, nout1+1);
     Kokkos::deep_copy(outfield.x1f, Kokkos::subview(pmhd->b0.x1f, std::make_pair(0,nmb),
@@ -105,21 +208,30 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
   }
   if (prad != nullptr) {
     Kokkos::realloc(outarray_rad, nmb, nrad, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_rad, Kokkos::subview(prad->i0, std::make_pair(0,nmb),
+    DeepCopyLayout(outarray_rad, Kokkos::subview(prad->i0, std::make_pair(0,nmb),
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
   }
   if (pturb != nullptr) {
     Kokkos::realloc(outarray_force, nmb, nforce, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_force, Kokkos::subview(pturb->force, std::make_pair(0,nmb),
+    DeepCopyLayout(outarray_force, Kokkos::subview(pturb->force, std::make_pair(0,nmb),
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
   }
   if (pz4c != nullptr) {
     Kokkos::realloc(outarray_z4c, nmb, nz4c, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_z4c, Kokkos::subview(pz4c->u0, std::make_pair(0,nmb),
+    DeepCopyLayout(outarray_z4c, Kokkos::subview(pz4c->u0, std::make_pair(0,nmb),
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
   } else if (padm != nullptr) {
     Kokkos::realloc(outarray_adm, nmb, nadm, nout3, nout2, nout1);
-    Kokkos::deep_copy(outarray_adm, Kokkos::subview(padm->u_adm, std::make_pair(0,nmb),
+    DeepCopyLayout(outarray_adm, Kokkos::subview(padm->u_adm, std::make_pair(0,nmb),
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
+  }
+  // extra CC arrays registered by other objects (e.g. sums of time-averaged outputs)
+  auto &extra_cc = pm->pmb_pack->extra_cc;
+  outarray_extra.resize(extra_cc.size());
+  for (std::size_t e=0; e<extra_cc.size(); ++e) {
+    auto &u = *(extra_cc[e].u);
+    Kokkos::realloc(outarray_extra[e], nmb, u.extent_int(1), nout3, nout2, nout1);
+    DeepCopyLayout(outarray_extra[e], Kokkos::subview(u, std::make_pair(0,nmb),
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
   }
 
@@ -132,6 +244,108 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::PackMeshBlock()
+//  \brief Copies the data of MB m in the output arrays to pdata, in the order it is
+//  stored in restart files (or the reverse if unpack is true)
+
+void RestartOutput::PackMeshBlock(Mesh *pm, int m, char *pdata, bool unpack) {
+  auto copy = [&](Real *a, std::size_t cnt) {
+    if (unpack) {
+      std::memcpy(a, pdata, cnt*sizeof(Real));
+    } else {
+      std::memcpy(pdata, a, cnt*sizeof(Real));
+    }
+    pdata += cnt*sizeof(Real);
+  };
+  auto copy_cc = [&](HostIOArray5D<Real> &a) {
+    copy(&a(m,0,0,0,0), a.size()/a.extent(0));
+  };
+  auto copy_fc = [&](HostArray4D<Real> &a) {
+    copy(&a(m,0,0,0), a.size()/a.extent(0));
+  };
+  auto pmbp = pm->pmb_pack;
+  if (pmbp->phydro != nullptr) {copy_cc(outarray_hyd);}
+  if (pmbp->pmhd != nullptr) {
+    copy_cc(outarray_mhd);
+    copy_fc(outfield.x1f);
+    copy_fc(outfield.x2f);
+    copy_fc(outfield.x3f);
+  }
+  if (pmbp->prad != nullptr) {copy_cc(outarray_rad);}
+  if (pmbp->pturb != nullptr) {copy_cc(outarray_force);}
+  if (pmbp->pz4c != nullptr) {
+    copy_cc(outarray_z4c);
+  } else if (pmbp->padm != nullptr) {
+    copy_cc(outarray_adm);
+  }
+  for (auto &outarray_e : outarray_extra) {copy_cc(outarray_e);}
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::WriteDeviceData()
+//  \brief Writes the data of all MBs on this rank (stored contiguously for each MB on the
+//  device, since FieldLayout is LayoutRight) with GPUDirect Storage, without copies to
+//  host memory.  Data is in the same order as written from host copies.
+
+void RestartOutput::WriteDeviceData(Mesh *pm, IOWrapper &resfile, IOWrapperSizeT offset,
+                                    IOWrapperSizeT data_size) {
+  Kokkos::fence();  // data must be complete on the device before it is read by cuFile
+  auto pmbp = pm->pmb_pack;
+  bool single_file_per_rank = out_params.single_file_per_rank ||
+                              !out_params.local_dir.empty();
+  for (int m=0; m<pm->nmb_thisrank; ++m) {
+    IOWrapperSizeT myoffset = offset + m*data_size;
+    auto write = [&](const Real *dptr, std::size_t cnt) {
+      IOWrapperSizeT nbytes = cnt*sizeof(Real);
+      if (resfile.Write_device_at(dptr, nbytes, myoffset, single_file_per_rank)
+          != nbytes) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MeshBlock data not written correctly with GPUDirect "
+                  << "Storage to rst file, restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      myoffset += nbytes;
+    };
+    auto write_cc = [&](const DvceArray5D<Real> &a, int nvar) {
+      write(a.data() + m*a.stride(0), nvar*a.extent(2)*a.extent(3)*a.extent(4));
+    };
+    auto write_fc = [&](const DvceArray4D<Real> &a) {
+      write(a.data() + m*a.stride(0), a.extent(1)*a.extent(2)*a.extent(3));
+    };
+    if (pmbp->phydro != nullptr) {
+      write_cc(pmbp->phydro->u0, pmbp->phydro->nhydro + pmbp->phydro->nscalars);
+    }
+    if (pmbp->pmhd != nullptr) {
+      write_cc(pmbp->pmhd->u0, pmbp->pmhd->nmhd + pmbp->pmhd->nscalars);
+      write_fc(pmbp->pmhd->b0.x1f);
+      write_fc(pmbp->pmhd->b0.x2f);
+      write_fc(pmbp->pmhd->b0.x3f);
+    }
+    if (pmbp->prad != nullptr) {write_cc(pmbp->prad->i0, pmbp->prad->nintens);}
+    if (pmbp->pturb != nullptr) {write_cc(pmbp->pturb->force, 3);}
+    if (pmbp->pz4c != nullptr) {
+      write_cc(pmbp->pz4c->u0, pmbp->pz4c->nz4c);
+    } else if (pmbp->padm != nullptr) {
+      write_cc(pmbp->padm->u_adm, pmbp->padm->nadm);
+    }
+    for (auto &e : pmbp->extra_cc) {write_cc(*(e.u), e.u->extent_int(1));}
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool RestartOutput::DeltaPossible()
+//  \brief Returns true if the next checkpoint can be a delta, i.e. with delta_every > 1,
+//  if a base has been written, fewer than delta_every-1 deltas have been written since,
+//  and the Mesh, its distribution over ranks, and the data of each MB are unchanged.
+//  The result is the same on all ranks.
+
+bool RestartOutput::DeltaPossible(Mesh *pm, IOWrapperSizeT data_size) {
+  if (out_params.delta_every < 2 || !have_base) {return false;}
+  if (ndelta + 1 >= out_params.delta_every || data_size != base_size) {return false;}
+  return (MeshTree(pm) == base_tree);
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void RestartOutput:::WriteOutputFile(Mesh *pm)
 //  \brief Cycles over all MeshBlocks and writes everything to a single restart file
@@ -156,7 +370,7 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     nmhd = pmhd->nmhd + pmhd->nscalars;
   }
   if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
+    nrad = prad->nintens;
   }
   if (pz4c != nullptr) {
     nz4c = pz4c->nz4c;
@@ -164,8 +378,9 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   } else if (padm != nullptr) {
     nadm = padm->nadm;
   }
-  bool single_file_per_rank = out_params.single_file_per_rank;
-  std::string fname;
+  bool local = !out_params.local_dir.empty();
+  bool single_file_per_rank = out_params.single_file_per_rank || local;
+  std::string fname, pfs_fname;
   if (single_file_per_rank) {
     // Generate a directory and filename for each rank
     // create filename: "rst/rank_YYYYYYY/file_basename" + "." + XXXXX + ".rst"
@@ -177,6 +392,13 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     std::snprintf(rank_dir, sizeof(rank_dir), "rank_%08d/", global_variable::my_rank);
     fname = std::string("rst/") + std::string(rank_dir) + out_params.file_basename
       + number + ".rst";
+    // with local_dir: "local_dir/rank_YYYYYYY/file_basename.XXXXX.rst", later copied
+    // to the path above
+    if (local) {
+      pfs_fname = fname;
+      fname = out_params.local_dir + "/" + std::string(rank_dir)
+        + out_params.file_basename + number + ".rst";
+    }
 
     // Debugging output to check directory and filename
     // std::cout << "Rank " << global_variable::my_rank << " generated filename: "
@@ -190,6 +412,7 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     fname = std::string("rst/") + out_params.file_basename + number + ".rst";
   }
   // increment counters now so values for *next* dump are stored in restart file
+  bool drain = local && (out_params.file_number % out_params.drain_every == 0);
   out_params.file_number++;
   if (out_params.last_time < 0.0) {
     out_params.last_time = pm->time;
@@ -198,6 +421,10 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   }
   pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
   pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  // number of extra CC arrays, read in ProblemGenerator constructor before Step 4 data
+  auto &extra_cc = pm->pmb_pack->extra_cc;
+  int nextra = extra_cc.size();
+  pin->SetInteger(out_params.block_name, "extra_arrays", nextra);
 
   // create string holding input parameters (copy of input file)
   std::stringstream ost;
@@ -262,6 +489,14 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       resfile.Write_any_type(&(pturb->rstate), sizeof(RNG_State), "byte",
                              single_file_per_rank);
     }
+    // name and number of variables of extra CC arrays
+    for (auto &e : extra_cc) {
+      char name[kExtraArrayNameLength] = {0};
+      std::strncpy(name, e.name.c_str(), kExtraArrayNameLength-1);
+      int nvar = e.u->extent_int(1);
+      resfile.Write_any_type(name, kExtraArrayNameLength, "byte", single_file_per_rank);
+      resfile.Write_any_type(&nvar, sizeof(int), "byte", single_file_per_rank);
+    }
   }
 
   //--- STEP 4.  All ranks write data over all MeshBlocks (5D arrays) in parallel
@@ -290,6 +525,9 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   } else if (padm != nullptr) {
     data_size += nout1*nout2*nout3*nadm*sizeof(Real);   // adm u_adm
   }
+  for (auto &e : extra_cc) {
+    data_size += nout1*nout2*nout3*e.u->extent_int(1)*sizeof(Real);  // extra arrays
+  }
   if (global_variable::my_rank == 0 || single_file_per_rank) {
     resfile.Write_any_type(&(data_size), sizeof(IOWrapperSizeT), "byte",
                             single_file_per_rank);
@@ -303,21 +541,124 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   IOWrapperSizeT step3size = 3*nco*sizeof(Real);
   if (pz4c != nullptr) step3size += sizeof(Real);
   if (pturb != nullptr) step3size += sizeof(RNG_State);
+  step3size += nextra*(kExtraArrayNameLength + sizeof(int));
 
   // write cell-centered variables in parallel
   IOWrapperSizeT offset_myrank = (step1size + step2size + step3size
                                   + sizeof(IOWrapperSizeT));
 
+  IOWrapperSizeT data_offset = offset_myrank;
   if (!single_file_per_rank) {
     offset_myrank += data_size*(pm->gids_eachrank[global_variable::my_rank]);
   }
 
   IOWrapperSizeT myoffset = offset_myrank;
 
+  // With delta_every, a delta checkpoint stores (after data_size) the magic string, the
+  // offset of MB data in the base and the name of the base, one flag per MB in the file
+  // (in order of gid) that is 1 if its data is stored in this file, and then the data of
+  // flagged MBs in order of gid.  Data of all other MBs is read from the base on restart.
+  int nmb = pm->nmb_thisrank;
+  IOWrapperSizeT nrec_file = (single_file_per_rank)? nmb : pm->nmb_total;
+  bool delta = DeltaPossible(pm, data_size);
+  if (delta) {
+    // compare each MB with the base.  MBs that are not stored are restored from the base
+    // in the output arrays, so that checksums are those of the state read on restart.
+    std::vector<char> flags(nmb, 0), recs, mbdata(data_size);
+    IOWrapperSizeT nreal = data_size/sizeof(Real);
+    Real tol = out_params.delta_tol;
+    for (int m=0; m<nmb; ++m) {
+      PackMeshBlock(pm, m, mbdata.data(), false);
+      char *pbase = &(base_data[m*data_size]);
+      bool changed = (std::memcmp(mbdata.data(), pbase, data_size) != 0);
+      if (changed && tol > 0.0) {
+        changed = false;
+        for (IOWrapperSizeT n=0; n<nreal && !changed; ++n) {
+          Real a, b;
+          std::memcpy(&a, &(mbdata[n*sizeof(Real)]), sizeof(Real));
+          std::memcpy(&b, pbase + n*sizeof(Real), sizeof(Real));
+          changed = !(std::abs(a - b) <= tol*std::abs(b));
+        }
+      }
+      if (changed) {
+        flags[m] = 1;
+        recs.insert(recs.end(), mbdata.begin(), mbdata.end());
+      } else {
+        PackMeshBlock(pm, m, pbase, true);
+      }
+    }
+
+    const IOWrapperSizeT nmagic = sizeof(kRestartDeltaMagic) - 1;
+    IOWrapperSizeT flag_offset = data_offset + nmagic + sizeof(IOWrapperSizeT)
+                                 + kRestartBaseNameLength;
+    if (global_variable::my_rank == 0 || single_file_per_rank) {
+      char name[kRestartBaseNameLength] = {0};
+      std::strncpy(name, base_name.c_str(), kRestartBaseNameLength-1);
+      resfile.Write_any_type_at(kRestartDeltaMagic, nmagic, data_offset, "byte",
+                                single_file_per_rank);
+      resfile.Write_any_type_at(&base_offset, sizeof(IOWrapperSizeT),
+                                data_offset + nmagic, "byte", single_file_per_rank);
+      resfile.Write_any_type_at(name, kRestartBaseNameLength,
+                                data_offset + nmagic + sizeof(IOWrapperSizeT), "byte",
+                                single_file_per_rank);
+    }
+    if (nmb > 0) {
+      IOWrapperSizeT my_flags = flag_offset + ((single_file_per_rank)? 0 :
+                                pm->gids_eachrank[global_variable::my_rank]);
+      resfile.Write_any_type_at(flags.data(), nmb, my_flags, "byte",
+                                single_file_per_rank);
+    }
+
+    // number of stored MBs on this rank, on lower ranks, and on all ranks
+    int nrec = recs.size()/data_size, nrec_below = 0, nrec_total = nrec;
+#if MPI_PARALLEL_ENABLED
+    if (!single_file_per_rank) {
+      MPI_Exscan(&nrec, &nrec_below, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+      if (global_variable::my_rank == 0) {nrec_below = 0;}
+      MPI_Allreduce(MPI_IN_PLACE, &nrec_total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    }
+#endif
+    data_offset = flag_offset + nrec_file;
+    nrec_file = nrec_total;
+
+    // write stored MBs with a few large collective writes (of less than 2^31 bytes each)
+    const IOWrapperSizeT max_write = (1 << 30);
+    int mbs_per_write = static_cast<int>(std::max(max_write/data_size,
+                                                  static_cast<IOWrapperSizeT>(1)));
+    int nwrites = (nrec + mbs_per_write - 1)/mbs_per_write;
+#if MPI_PARALLEL_ENABLED
+    if (!single_file_per_rank) {
+      MPI_Allreduce(MPI_IN_PLACE, &nwrites, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    }
+#endif
+    myoffset = data_offset + data_size*nrec_below;
+    for (int n=0; n<nwrites; ++n) {
+      int mbs = std::max(std::min(mbs_per_write, nrec - n*mbs_per_write), 0);
+      IOWrapperSizeT nbytes = data_size*mbs;
+      const char *prec = (mbs > 0)? &(recs[n*mbs_per_write*data_size]) : recs.data();
+      if (resfile.Write_any_type_at_all(prec, nbytes, myoffset, "byte",
+                                        single_file_per_rank) != nbytes) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MeshBlock data not written correctly to delta rst "
+                  << "file, restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      myoffset += nbytes;
+    }
+    ndelta++;
+  }
+
+  // otherwise write data of all MBs, directly from device memory with gds, or else one
+  // variable at a time from the host copies
+  if (!delta && use_gds) {
+    WriteDeviceData(pm, resfile, offset_myrank, data_size);
+  }
+  bool host_write = !delta && !use_gds;
+
   // write cell-centered variables, one MeshBlock at a time (but parallelized over all
   // ranks). MeshBlocks are written seperately to reduce number of data elements per write
   // call, to avoid exceeding 2^31 limit for very large grids per MPI rank.
-  if (phydro != nullptr) {
+  if (host_write && phydro != nullptr) {
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to write, so write collectively
       if (m < noutmbs_min) {
@@ -353,7 +694,7 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     offset_myrank += nout1*nout2*nout3*nhydro*sizeof(Real); // hydro u0
     myoffset = offset_myrank;
   }
-  if (pmhd != nullptr) {
+  if (host_write && pmhd != nullptr) {
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to write, so write collectively
       if (m < noutmbs_min) {
@@ -477,7 +818,7 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     myoffset = offset_myrank;
   }
 
-  if (prad != nullptr) {
+  if (host_write && prad != nullptr) {
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to write, so write collectively
       if (m < noutmbs_min) {
@@ -514,7 +855,7 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     myoffset = offset_myrank;
   }
 
-  if (pturb != nullptr) {
+  if (host_write && pturb != nullptr) {
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to write, so write collectively
       if (m < noutmbs_min) {
@@ -551,7 +892,7 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     myoffset = offset_myrank;
   }
 
-  if (pz4c != nullptr) {
+  if (host_write && pz4c != nullptr) {
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to write, so write collectively
       if (m < noutmbs_min) {
@@ -586,7 +927,7 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     }
     offset_myrank += nout1*nout2*nout3*nz4c*sizeof(Real); // z4c u0
     myoffset = offset_myrank;
-  } else if (padm != nullptr) {
+  } else if (host_write && padm != nullptr) {
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to write, so write collectively
       if (m < noutmbs_min) {
@@ -623,8 +964,175 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     myoffset = offset_myrank;
   }
 
+  if (host_write) {
+    for (auto &outarray_e : outarray_extra) {
+      for (int m=0;  m<noutmbs_max; ++m) {
+        // every rank has a MB to write, so write collectively
+        if (m < noutmbs_min) {
+          // get ptr to cell-centered MeshBlock data
+          auto mbptr = Kokkos::subview(outarray_e, m, Kokkos::ALL, Kokkos::ALL,
+                                       Kokkos::ALL, Kokkos::ALL);
+          int mbcnt = mbptr.size();
+          if (resfile.Write_any_type_at_all(mbptr.data(),mbcnt,myoffset,"Real",
+                                            single_file_per_rank) != mbcnt) {
+            std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                      << std::endl << "extra cell-centered data not written correctly"
+                      << " to rst file, restart file is broken." << std::endl;
+            exit(EXIT_FAILURE);
+          }
+          myoffset += data_size;
+
+        // some ranks are finished writing, so use non-collective write
+        } else if (m < pm->nmb_thisrank) {
+          // get ptr to MeshBlock data
+          auto mbptr = Kokkos::subview(outarray_e, m, Kokkos::ALL, Kokkos::ALL,
+                                       Kokkos::ALL, Kokkos::ALL);
+          int mbcnt = mbptr.size();
+          if (resfile.Write_any_type_at(mbptr.data(), mbcnt, myoffset,"Real",
+                                        single_file_per_rank) != mbcnt) {
+            std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                      << std::endl << "extra cell-centered data not written correctly"
+                      << " to rst file, restart file is broken." << std::endl;
+            exit(EXIT_FAILURE);
+          }
+          myoffset += data_size;
+        }
+      }
+      offset_myrank += nout1*nout2*nout3*outarray_e.extent_int(1)*sizeof(Real);
+      myoffset = offset_myrank;
+    }
+  }
+
+  // keep data of this full checkpoint as base of following deltas
+  if (!delta && out_params.delta_every > 1) {
+    base_data.resize(nmb*data_size);
+    for (int m=0; m<nmb; ++m) {
+      PackMeshBlock(pm, m, &(base_data[m*data_size]), false);
+    }
+    base_name = fname.substr(fname.rfind('/') + 1);
+    base_offset = data_offset;
+    base_size = data_size;
+    base_tree = MeshTree(pm);
+    have_base = true;
+    ndelta = 0;
+  }
+
+  //--- STEP 5.  Optionally, write per-variable checksums after data of all MeshBlocks
+  // These are verified (if present) in ProblemGenerator constructor for restarts.  With
+  // single_file_per_rank, each file stores checksums of the MBs in that file.
+  if (out_params.checksum) {
+    std::vector<std::uint64_t> chk = RestartChecksums(pm, outarray_hyd, outarray_mhd,
+                                                      outfield, outarray_rad,
+                                                      outarray_force, outarray_z4c,
+                                                      outarray_adm);
+#if MPI_PARALLEL_ENABLED
+    if (!single_file_per_rank) {
+      MPI_Allreduce(MPI_IN_PLACE, chk.data(), chk.size(), MPI_UINT64_T, MPI_SUM,
+                    MPI_COMM_WORLD);
+    }
+#endif
+    if (global_variable::my_rank == 0 || single_file_per_rank) {
+      IOWrapperSizeT chk_offset = data_offset + data_size*nrec_file;
+      int nchk = chk.size();
+      const IOWrapperSizeT nmagic = sizeof(kRestartChecksumMagic) - 1;
+      resfile.Write_any_type_at(kRestartChecksumMagic, nmagic, chk_offset, "byte",
+                                single_file_per_rank);
+      resfile.Write_any_type_at(&nchk, sizeof(int), chk_offset + nmagic, "byte",
+                                single_file_per_rank);
+      resfile.Write_any_type_at(chk.data(), nchk*sizeof(std::uint64_t),
+                                chk_offset + nmagic + sizeof(int), "byte",
+                                single_file_per_rank);
+    }
+  }
+
   // close file, clean up
   resfile.Close(single_file_per_rank);
 
+  //--- STEP 6.  With local_dir, remove local checkpoints beyond local_retain and start
+  // copying this one to rst/.  Previous copy must be finished first, since it may read
+  // a file that is removed.
+  if (local) {
+    if (drainer.joinable()) {drainer.join();}
+    local_files.push_back(fname);
+    while (static_cast<int>(local_files.size()) > out_params.local_retain) {
+      std::remove(local_files.front().c_str());
+      local_files.erase(local_files.begin());
+    }
+    last_local = fname;
+    last_pfs = pfs_fname;
+    last_drained = drain;
+    if (drain) {
+      drainer = std::thread([fname, pfs_fname]() {
+        if (!CopyCheckpoint(fname, pfs_fname)) {
+          std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                    << std::endl << "Could not copy checkpoint '" << fname << "' to '"
+                    << pfs_fname << "'" << std::endl;
+        }
+      });
+    }
+  }
+
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn std::vector<std::uint64_t> RestartChecksums()
+//! \brief Returns a 64-bit checksum of every variable (each component of CC arrays, and
+//! each face-centered field) over all MBs on this rank.  The checksum of each MB is
+//! seeded with its gid, and checksums of MBs are summed, so that the result for the
+//! whole Mesh (summed over ranks) does not depend on how MBs are distributed over ranks.
+
+std::vector<std::uint64_t> RestartChecksums(Mesh *pm, const HostIOArray5D<Real> &hydro,
+    const HostIOArray5D<Real> &mhd, const HostFaceFld4D<Real> &b0,
+    const HostIOArray5D<Real> &rad, const HostIOArray5D<Real> &force,
+    const HostIOArray5D<Real> &z4c, const HostIOArray5D<Real> &adm) {
+  int nmb = pm->pmb_pack->nmb_thispack;
+  int gids = pm->gids_eachrank[global_variable::my_rank];
+  // hash of 8-byte words of data (FNV-1a on words)
+  auto hash = [](const void *buf, std::size_t nbytes, std::uint64_t seed) {
+    const unsigned char *p = static_cast<const unsigned char*>(buf);
+    std::uint64_t h = 0xcbf29ce484222325ULL ^ seed;
+    for (std::size_t i=0; i<nbytes; i+=sizeof(std::uint64_t)) {
+      std::uint64_t w = 0;
+      std::memcpy(&w, p + i, std::min(sizeof(std::uint64_t), nbytes - i));
+      h = (h ^ w)*0x100000001b3ULL;
+    }
+    return h;
+  };
+  std::vector<std::uint64_t> chk;
+  auto add_cc = [&](const HostIOArray5D<Real> &a) {
+    int nvar = a.extent_int(1);
+    std::size_t nbytes = a.extent(2)*a.extent(3)*a.extent(4)*sizeof(Real);
+    std::size_t n0 = chk.size();
+    chk.resize(n0 + nvar, 0);
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nvar; ++n) {
+        chk[n0 + n] += hash(&a(m,n,0,0,0), nbytes, gids + m);
+      }
+    }
+  };
+  auto add_fc = [&](const HostArray4D<Real> &a) {
+    std::size_t nbytes = a.extent(1)*a.extent(2)*a.extent(3)*sizeof(Real);
+    std::uint64_t sum = 0;
+    for (int m=0; m<nmb; ++m) {
+      sum += hash(&a(m,0,0,0), nbytes, gids + m);
+    }
+    chk.push_back(sum);
+  };
+  auto pmbp = pm->pmb_pack;
+  if (pmbp->phydro != nullptr) {add_cc(hydro);}
+  if (pmbp->pmhd != nullptr) {
+    add_cc(mhd);
+    add_fc(b0.x1f);
+    add_fc(b0.x2f);
+    add_fc(b0.x3f);
+  }
+  if (pmbp->prad != nullptr) {add_cc(rad);}
+  if (pmbp->pturb != nullptr) {add_cc(force);}
+  if (pmbp->pz4c != nullptr) {
+    add_cc(z4c);
+  } else if (pmbp->padm != nullptr) {
+    add_cc(adm);
+  }
+  return chk;
+}
@@ -4,21 +4,40 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file spherical_surface.cpp
-//! \brief writes data on a SphericalSurface sub-grid in binary VTK format
+//! \brief writes data on concentric SphericalSurface sub-grids in binary VTK format (one
+//! file per radius).  The radius is set by <output>/radius, or with <output>/nradii > 1
+//! radii are spaced uniformly between <output>/rmin and rmax.  All variables at all radii
+//! are interpolated together, with one exchange of results.
+//!
+//! With <output>/fluxes=true, the mass and energy fluxes and the magnetic flux through
+//! each sphere are also computed (non-relativistic hydro or MHD only), and appended to
+//! the table sph/<basename>.<file_id>.flux.  Radial flux densities are computed in every
+//! cell on the device, interpolated together with the output variables, and integrated
+//! over each sphere on the root rank.
 
 #include "utils/spherical_surface.hpp"
 
 #include <sys/stat.h>  // mkdir
 
+#include <cmath>
 #include <cstdio>  // snprintf
 #include <fstream>
+#include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
 #include "parameter_input.hpp"
+#include "utils/point_interpolator.hpp"
 #include "outputs.hpp"
 
 
@@ -27,48 +46,158 @@ SphericalSurfaceOutput::SphericalSurfaceOutput(ParameterInput *pin, Mesh *pm,
     : BaseTypeOutput(pin, pm, op) {
   mkdir("sph", 0755);
 
-  Real rad = pin->GetReal(op.block_name, "radius");
+  int nradii = pin->GetOrAddInteger(op.block_name, "nradii", 1);
+  if (nradii > 1) {
+    Real rmin = pin->GetReal(op.block_name, "rmin");
+    Real rmax = pin->GetReal(op.block_name, "rmax");
+    for (int r = 0; r < nradii; ++r) {
+      radii.push_back(rmin + (rmax - rmin)*r/(nradii - 1));
+    }
+  } else {
+    radii.push_back(pin->GetReal(op.block_name, "radius"));
+  }
   int ntheta = pin->GetOrAddInteger(op.block_name, "ntheta", 32);
   Real xc = pin->GetOrAddReal(op.block_name, "xc", 0.0);
   Real yc = pin->GetOrAddReal(op.block_name, "yc", 0.0);
   Real zc = pin->GetOrAddReal(op.block_name, "zc", 0.0);
-  psurf = new SphericalSurface(pm->pmb_pack, ntheta, rad, xc, yc, zc);
-}
+  psurf = new SphericalSurface(pm->pmb_pack, ntheta, radii[0], xc, yc, zc);
 
-SphericalSurfaceOutput::~SphericalSurfaceOutput() { delete psurf; }
+  fluxes = pin->GetOrAddBoolean(op.block_name, "fluxes", false);
+  if (fluxes) {
+    auto pmbp = pm->pmb_pack;
+    if ((pmbp->phydro == nullptr && pmbp->pmhd == nullptr) ||
+        pmbp->pcoord->is_special_relativistic || pmbp->pcoord->is_general_relativistic) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "fluxes in <" << op.block_name << "> require "
+                << "non-relativistic Hydro or MHD" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
 
-void SphericalSurfaceOutput::LoadOutputData(Mesh *pm) {
-  // If AMR is enabled we need to reset the CartesianGrid
-  if (pm->adaptive) {
-    psurf->SetInterpolationIndices();
-    psurf->SetInterpolationWeights();
+  // points of all radii (in order of radius, then angle).  Results are only needed on
+  // the root rank, which writes the files
+  int nang = psurf->nangles;
+  int npts = (global_variable::my_rank == 0) ? nradii * nang : 0;
+  HostArray2D<Real> pos("sph_pos", npts, 3);
+  for (int n = 0; n < npts; ++n) {
+    Real &theta = psurf->polar_pos.h_view(n % nang, 0);
+    Real &phi = psurf->polar_pos.h_view(n % nang, 1);
+    Real rad = radii[n / nang];
+    pos(n, 0) = rad * cos(phi) * sin(theta) + xc;
+    pos(n, 1) = rad * sin(phi) * sin(theta) + yc;
+    pos(n, 2) = rad * cos(theta) + zc;
   }
+  pinterp = new PointInterpolator(pm->pmb_pack);
+  pinterp->SetPoints(pos);
+}
+
+SphericalSurfaceOutput::~SphericalSurfaceOutput() {
+  delete psurf;
+  delete pinterp;
+}
 
+void SphericalSurfaceOutput::LoadOutputData(Mesh *pm) {
   int nout_vars = outvars.size();
-  Kokkos::realloc(outarray, nout_vars, 1, 1, 1, psurf->nangles);
+  int nradii = radii.size();
+  int nang = psurf->nangles;
+  Kokkos::realloc(outarray, nout_vars, 1, 1, nradii, nang);
 
   // Calculate derived variables, if required
   if (out_params.contains_derived) {
     ComputeDerivedVariable(out_params.variable, pm);
   }
 
+  // interpolate all variables (and flux densities) at all radii together.  Results are
+  // returned to the root rank only (the interpolator handles changes of MeshBlocks)
+  std::vector<std::pair<const DvceArray5D<Real>*, int>> vars;
   for (int n = 0; n < nout_vars; ++n) {
-    psurf->InterpolateToSphere(outvars[n].data_index, *(outvars[n].data_ptr));
-    auto v_slice = Kokkos::subview(outarray, n, 0, 0, 0, Kokkos::ALL);
-    Kokkos::deep_copy(v_slice, psurf->interp_vals.h_view);
+    vars.emplace_back(outvars[n].data_ptr, outvars[n].data_index);
   }
-#if MPI_PARALLEL_ENABLED
-  // Note that InterpolateToSphere will set zero values for points not owned by
-  // current rank
-  int count = nout_vars * psurf->nangles;
-  if (0 == global_variable::my_rank) {
-    MPI_Reduce(MPI_IN_PLACE, outarray.data(), count, MPI_ATHENA_REAL, MPI_SUM,
-               0, MPI_COMM_WORLD);
-  } else {
-    MPI_Reduce(outarray.data(), outarray.data(), count, MPI_ATHENA_REAL,
-               MPI_SUM, 0, MPI_COMM_WORLD);
+  if (fluxes) {
+    ComputeFluxDensities(pm);
+    for (int n = 0; n < 3; ++n) {
+      vars.emplace_back(&flux_dens, n);
+    }
   }
-#endif
+  pinterp->Interpolate(vars);
+
+  // copy (and convert to output precision) on host
+  for (int n = 0; n < nout_vars; ++n) {
+    for (int p = 0; p < pinterp->npoints; ++p) {
+      outarray(n, 0, 0, p / nang, p % nang) = pinterp->vals(p, n);
+    }
+  }
+
+  // integrate flux densities over each sphere: mass and energy fluxes, and half the
+  // integral of |B^r| (the flux of B through each hemisphere, for a split monopole)
+  if (fluxes) {
+    flux_vals.assign(3*nradii, 0.0);
+    for (int p = 0; p < pinterp->npoints; ++p) {
+      int r = p / nang;
+      Real da = radii[r] * radii[r] * psurf->int_weights.h_view(p % nang);
+      flux_vals[3*r    ] += da * pinterp->vals(p, nout_vars);
+      flux_vals[3*r + 1] += da * pinterp->vals(p, nout_vars + 1);
+      flux_vals[3*r + 2] += 0.5 * da * std::abs(pinterp->vals(p, nout_vars + 2));
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SphericalSurfaceOutput::ComputeFluxDensities()
+//! \brief computes radial flux densities (about the center of the spheres) of mass,
+//! total energy, and magnetic field in every cell (including ghost cells, which are used
+//! in interpolation).  Energy flux is zero for isothermal EOS.
+
+void SphericalSurfaceOutput::ComputeFluxDensities(Mesh *pm) {
+  auto pmbp = pm->pmb_pack;
+  auto &indcs = pm->mb_indcs;
+  int &is = indcs.is; int &js = indcs.js; int &ks = indcs.ks;
+  int &nx1 = indcs.nx1; int &nx2 = indcs.nx2; int &nx3 = indcs.nx3;
+  int n1 = indcs.nx1 + 2*(indcs.ng);
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb = pmbp->nmb_thispack;
+  if (flux_dens.extent_int(0) != nmb) {
+    Kokkos::realloc(flux_dens, nmb, 3, n3, n2, n1);
+  }
+
+  bool is_mhd = (pmbp->pmhd != nullptr);
+  auto &eos = (is_mhd)? pmbp->pmhd->peos->eos_data : pmbp->phydro->peos->eos_data;
+  bool ideal = eos.is_ideal;
+  Real gm1 = eos.gamma - 1.0;
+  auto &u0_ = (is_mhd)? pmbp->pmhd->u0 : pmbp->phydro->u0;
+  auto &w0_ = (is_mhd)? pmbp->pmhd->w0 : pmbp->phydro->w0;
+  DvceArray5D<Real> bcc_;
+  if (is_mhd) {bcc_ = pmbp->pmhd->bcc0;}
+  auto &size = pmbp->pmb->mb_size;
+  Real xc = psurf->xc, yc = psurf->yc, zc = psurf->zc;
+  auto &fd = flux_dens;
+  par_for("sph_fluxdens", DevExeSpace(), 0, (nmb-1), 0, (n3-1), 0, (n2-1), 0, (n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real x = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max) - xc;
+    Real y = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max) - yc;
+    Real z = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max) - zc;
+    Real r = sqrt(x*x + y*y + z*z);
+    Real nx = 0.0, ny = 0.0, nz = 0.0;
+    if (r > 0.0) {nx = x/r; ny = y/r; nz = z/r;}
+
+    Real vr = w0_(m,IVX,k,j,i)*nx + w0_(m,IVY,k,j,i)*ny + w0_(m,IVZ,k,j,i)*nz;
+    Real br = 0.0, vb = 0.0, ptot = 0.0;
+    if (is_mhd) {
+      br = bcc_(m,IBX,k,j,i)*nx + bcc_(m,IBY,k,j,i)*ny + bcc_(m,IBZ,k,j,i)*nz;
+      vb = w0_(m,IVX,k,j,i)*bcc_(m,IBX,k,j,i) + w0_(m,IVY,k,j,i)*bcc_(m,IBY,k,j,i) +
+           w0_(m,IVZ,k,j,i)*bcc_(m,IBZ,k,j,i);
+      ptot = 0.5*(SQR(bcc_(m,IBX,k,j,i)) + SQR(bcc_(m,IBY,k,j,i)) +
+                  SQR(bcc_(m,IBZ,k,j,i)));
+    }
+    fd(m,0,k,j,i) = w0_(m,IDN,k,j,i)*vr;
+    fd(m,1,k,j,i) = 0.0;
+    if (ideal) {
+      ptot += gm1*w0_(m,IEN,k,j,i);
+      fd(m,1,k,j,i) = (u0_(m,IEN,k,j,i) + ptot)*vr - br*vb;
+    }
+    fd(m,2,k,j,i) = br;
+  });
 }
 
 void SphericalSurfaceOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
@@ -77,78 +206,83 @@ void SphericalSurfaceOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
 #if MPI_PARALLEL_ENABLED
   if (0 == global_variable::my_rank) {
 #endif
-    // Assemble filename
-    char fname[BUFSIZ];
-    std::snprintf(fname, BUFSIZ, "sph/%s.r=%.2f.%s.%05d.vtk",
-                  out_params.file_basename.c_str(), psurf->radius,
-                  out_params.file_id.c_str(), out_params.file_number);
-
-    // Open file
-    std::ofstream ofile(fname, std::ios::binary);
-
-    ofile << "# vtk DataFile Version 3.0" << std::endl;
-    ofile << "# AthenaK data at time=" << pm->time
-          << " cycle=" << pm->ncycle << " rad=" << psurf->radius
-          << " xc=" << psurf->xc << " yc=" << psurf->yc << " zc=" << psurf->zc
-          << std::endl;
-    ofile << "BINARY" << std::endl;
-    ofile << "DATASET STRUCTURED_GRID" << std::endl;
-    ofile << "DIMENSIONS 1 " << psurf->ntheta << " " << 2 * psurf->ntheta
-          << std::endl;
-    ofile << "POINTS " << psurf->nangles << " float\n";
-
-    for (int i = 0; i < psurf->nangles; ++i) {
-      float dline[3] = {static_cast<float>(psurf->radius),
-                        static_cast<float>(psurf->polar_pos.h_view(i, 0)),
-                        static_cast<float>(psurf->polar_pos.h_view(i, 1))};
-      if (!big_end) {
-        Swap4Bytes(&dline[0]);
-        Swap4Bytes(&dline[1]);
-        Swap4Bytes(&dline[2]);
-      }
+    for (int r = 0; r < static_cast<int>(radii.size()); ++r) {
+      // Assemble filename
+      char fname[BUFSIZ];
+      std::snprintf(fname, BUFSIZ, "sph/%s.r=%.2f.%s.%05d.vtk",
+                    out_params.file_basename.c_str(), radii[r],
+                    out_params.file_id.c_str(), out_params.file_number);
 
-      ofile.write(reinterpret_cast<char *>(&dline[0]), 3 * sizeof(float));
-    }
+      // Open file
+      std::ofstream ofile(fname, std::ios::binary);
 
-    float t = static_cast<float>(pm->time);
-    if (!big_end) {
-      Swap4Bytes(&t);
-    }
-    ofile << "\nFIELD FieldData 2\n";
-    ofile << "TIME 1 1 float\n";
-    ofile.write(reinterpret_cast<char *>(&t), sizeof(float));
-
-    ofile << "\nCYCLE 1 1 int\n";
-    int cycle = pm->ncycle;
-    if (!big_end) {
-      Swap4Bytes(&cycle);
-    }
-    ofile.write(reinterpret_cast<char *>(&cycle), sizeof(int));
+      ofile << "# vtk DataFile Version 3.0" << std::endl;
+      ofile << "# AthenaK data at time=" << pm->time
+            << " cycle=" << pm->ncycle << " rad=" << radii[r]
+            << " xc=" << psurf->xc << " yc=" << psurf->yc << " zc=" << psurf->zc
+            << std::endl;
+      ofile << "BINARY" << std::endl;
+      ofile << "DATASET STRUCTURED_GRID" << std::endl;
+      ofile << "DIMENSIONS 1 " << psurf->ntheta << " " << 2 * psurf->ntheta
+            << std::endl;
+      ofile << "POINTS " << psurf->nangles << " float\n";
+
+      for (int i = 0; i < psurf->nangles; ++i) {
+        float dline[3] = {static_cast<float>(radii[r]),
+                          static_cast<float>(psurf->polar_pos.h_view(i, 0)),
+                          static_cast<float>(psurf->polar_pos.h_view(i, 1))};
+        if (!big_end) {
+          Swap4Bytes(&dline[0]);
+          Swap4Bytes(&dline[1]);
+          Swap4Bytes(&dline[2]);
+        }
+
+        ofile.write(reinterpret_cast<char *>(&dline[0]), 3 * sizeof(float));
+      }
 
-    ofile << "\nPOINT_DATA " << psurf->nangles << std::endl;
-    ofile << "SCALARS weights float 1" << std::endl;
-    ofile << "LOOKUP_TABLE default" << std::endl;
-    for (int i = 0; i < psurf->nangles; ++i) {
-      float d = psurf->radius * psurf->radius * psurf->int_weights.h_view(i);
+      float t = static_cast<float>(pm->time);
       if (!big_end) {
-        Swap4Bytes(&d);
+        Swap4Bytes(&t);
       }
-      ofile.write(reinterpret_cast<char *>(&d), sizeof(float));
-    }
+      ofile << "\nFIELD FieldData 2\n";
+      ofile << "TIME 1 1 float\n";
+      ofile.write(reinterpret_cast<char *>(&t), sizeof(float));
+
+      ofile << "\nCYCLE 1 1 int\n";
+      int cycle = pm->ncycle;
+      if (!big_end) {
+        Swap4Bytes(&cycle);
+      }
+      ofile.write(reinterpret_cast<char *>(&cycle), sizeof(int));
 
-    int nout_vars = outvars.size();
-    for (int n = 0; n < nout_vars; ++n) {
-      ofile << "\nSCALARS " << outvars[n].label << " float 1" << std::endl;
+      ofile << "\nPOINT_DATA " << psurf->nangles << std::endl;
+      ofile << "SCALARS weights float 1" << std::endl;
       ofile << "LOOKUP_TABLE default" << std::endl;
       for (int i = 0; i < psurf->nangles; ++i) {
-        float d = outarray(n, 0, 0, 0, i);
+        float d = radii[r] * radii[r] * psurf->int_weights.h_view(i);
         if (!big_end) {
           Swap4Bytes(&d);
         }
         ofile.write(reinterpret_cast<char *>(&d), sizeof(float));
       }
+
+      int nout_vars = outvars.size();
+      for (int n = 0; n < nout_vars; ++n) {
+        ofile << "\nSCALARS " << outvars[n].label << " float 1" << std::endl;
+        ofile << "LOOKUP_TABLE default" << std::endl;
+        for (int i = 0; i < psurf->nangles; ++i) {
+          float d = outarray(n, 0, 0, r, i);
+          if (!big_end) {
+            Swap4Bytes(&d);
+          }
+          ofile.write(reinterpret_cast<char *>(&d), sizeof(float));
+        }
+      }
     }
 
+    if (fluxes) {
+      WriteFluxes(pm);
+    }
 #if MPI_PARALLEL_ENABLED
   }
 #endif
@@ -163,3 +297,30 @@ void SphericalSurfaceOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
   pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void SphericalSurfaceOutput::WriteFluxes()
+//! \brief appends fluxes through each sphere at this time to the table
+//! sph/<basename>.<file_id>.flux (with a header if it is the first output)
+
+void SphericalSurfaceOutput::WriteFluxes(Mesh *pm) {
+  std::string fname = "sph/" + out_params.file_basename + "." + out_params.file_id +
+                      ".flux";
+  FILE *pfile;
+  if ((pfile = std::fopen(fname.c_str(), "a")) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Output file '" << fname << "' could not be opened"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (out_params.file_number == 0) {
+    std::fprintf(pfile, "# AthenaK fluxes through spheres at xc=%e yc=%e zc=%e\n",
+                 psurf->xc, psurf->yc, psurf->zc);
+    std::fprintf(pfile, "# [1]=time [2]=cycle [3]=radius [4]=mdot [5]=edot [6]=phi\n");
+  }
+  for (int r = 0; r < static_cast<int>(radii.size()); ++r) {
+    std::fprintf(pfile, "%e %d %e %e %e %e\n", pm->time, pm->ncycle, radii[r],
+                 flux_vals[3*r], flux_vals[3*r + 1], flux_vals[3*r + 2]);
+  }
+  std::fclose(pfile);
+}
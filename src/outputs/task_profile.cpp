@@ -0,0 +1,249 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file task_profile.cpp
+//! \brief writes wall time spent in every Task of every TaskList, averaged per cycle over
+//! the interval since the last output, to a text file.  For each Task both the mean and
+//! the maximum time over all MPI ranks are reported, and their ratio measures the load
+//! imbalance.  The critical path (longest chain of dependent Tasks) through each TaskList
+//! is computed using the maximum times, and Tasks on this path are flagged.
+//!
+//! Creating this output enables fenced timing of every Task, which serializes kernels
+//! launched by separate Tasks.  It should therefore only be used for diagnostics.
+//!
+//! With sample_cycles=K > 0 Tasks are instead only timed in every Kth cycle, and the
+//! times of the last sample_slots sampled cycles are kept in a ring buffer in each
+//! TaskList.  Since fencing at most roughly doubles the cost of a sampled cycle, the
+//! overhead is bounded by about 1/K (e.g. K=100 for production runs, with dt or dcycle
+//! set to those of the hst output).  In this mode the rank with the largest
+//! time is reported for each Task, as well as the slowest rank overall (with its host
+//! name), to identify bad nodes.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "tasklist/task_list.hpp"
+#include "outputs.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+//----------------------------------------------------------------------------------------
+// ctor: also calls BaseTypeOutput base class constructor
+
+TaskProfileOutput::TaskProfileOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op),
+  last_cycle(pm->ncycle),
+  ncycles(0) {
+  sample_cycles = pin->GetOrAddInteger(op.block_name, "sample_cycles", 0);
+  int nslot = pin->GetOrAddInteger(op.block_name, "sample_slots", 64);
+  // when profiling is already enabled (e.g. sampled by automatic load balancing), the
+  // existing timers and sampling stride are used
+  bool enabled = false;
+  for (auto &it : pm->pmb_pack->tl_map) {
+    if (it.second->IsProfiling()) {
+      enabled = true;
+      sample_cycles = it.second->SampleStride();
+    }
+  }
+  for (auto &it : pm->pmb_pack->tl_map) {
+    if (enabled) break;
+    if (sample_cycles > 0) {
+      it.second->EnableSampledProfiling(&(pm->ncycle), sample_cycles, nslot);
+    } else {
+      it.second->EnableProfiling();
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TaskProfileOutput::LoadOutputData()
+//! \brief computes time per cycle spent in each Task, reduces over MPI ranks, and finds
+//! critical path through each TaskList.  Timers are reset afterwards.
+
+void TaskProfileOutput::LoadOutputData(Mesh *pm) {
+  ncycles = pm->ncycle - last_cycle;
+  tl_names.clear();
+  task_names.clear();
+  tmean.clear();
+  tmax.clear();
+  on_path.clear();
+  cpath_mean.clear();
+  cpath_max.clear();
+  nsamples.clear();
+  tmax_rank.clear();
+  tpeak.clear();
+  if (ncycles <= 0) return;
+
+  double task_time = 0.0;  // time per sampled cycle in all Tasks on this rank
+  for (auto &it : pm->pmb_pack->tl_map) {
+    auto &tl = it.second;
+    if (tl->Empty()) continue;
+    std::vector<double> times = tl->GetTaskTimes();
+    for (auto &t : times) {t /= static_cast<double>(ncycles);}
+    // with sampling, use mean and peak over sampled cycles in ring buffer
+    int nsamp = tl->NumberSamples();
+    std::vector<double> peak(times.size(), 0.0);
+    if (nsamp > 0) {
+      std::vector<std::vector<float>> samples = tl->GetTaskSamples();
+      for (std::size_t n=0; n<times.size(); ++n) {
+        double tsum_n = 0.0;
+        for (float t : samples[n]) {
+          tsum_n += t;
+          peak[n] = std::max(peak[n], static_cast<double>(t));
+        }
+        times[n] = tsum_n/static_cast<double>(nsamp);
+      }
+    }
+    if (sample_cycles > 0) {
+      for (auto &t : times) {task_time += t;}
+    }
+    std::vector<bool> path;
+    double cpath = tl->CriticalPath(times, path);
+
+    std::vector<double> tsum(times), tmx(times);
+    std::vector<int> tmx_rank(times.size(), global_variable::my_rank);
+    double cpath_sum = cpath, cpath_mx = cpath;
+#if MPI_PARALLEL_ENABLED
+    int ntask = times.size();
+    std::vector<DoubleInt> tloc(ntask);
+    for (int n=0; n<ntask; ++n) {
+      tloc[n].time = times[n];
+      tloc[n].rank = global_variable::my_rank;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, tsum.data(), ntask, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, tloc.data(), ntask, MPI_DOUBLE_INT, MPI_MAXLOC,
+                  MPI_COMM_WORLD);
+    for (int n=0; n<ntask; ++n) {
+      tmx[n] = tloc[n].time;
+      tmx_rank[n] = tloc[n].rank;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, peak.data(), ntask, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &cpath_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &cpath_mx, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    double nranks = static_cast<double>(global_variable::nranks);
+    for (auto &t : tsum) {t /= nranks;}
+    // critical path computed with the slowest rank for each Task
+    (void) tl->CriticalPath(tmx, path);
+
+    tl_names.push_back(it.first);
+    task_names.push_back(tl->GetTaskNames());
+    tmean.push_back(tsum);
+    tmax.push_back(tmx);
+    on_path.push_back(path);
+    cpath_mean.push_back(cpath_sum/nranks);
+    cpath_max.push_back(cpath_mx);
+    nsamples.push_back(nsamp);
+    tmax_rank.push_back(tmx_rank);
+    tpeak.push_back(peak);
+    tl->ResetTimes();
+    tl->ResetSamples();
+  }
+  last_cycle = pm->ncycle;
+  if (sample_cycles <= 0) return;
+
+  // slowest rank, and name of its host
+  slow_time = task_time;
+  mean_time = task_time;
+  slow_rank = global_variable::my_rank;
+  slow_host = "localhost";
+#if MPI_PARALLEL_ENABLED
+  DoubleInt tloc;
+  tloc.time = task_time;
+  tloc.rank = global_variable::my_rank;
+  MPI_Allreduce(MPI_IN_PLACE, &tloc, 1, MPI_DOUBLE_INT, MPI_MAXLOC, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &mean_time, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  mean_time /= static_cast<double>(global_variable::nranks);
+  slow_time = tloc.time;
+  slow_rank = tloc.rank;
+  char host[MPI_MAX_PROCESSOR_NAME] = {0};
+  int len;
+  MPI_Get_processor_name(host, &len);
+  MPI_Bcast(host, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, slow_rank, MPI_COMM_WORLD);
+  host[MPI_MAX_PROCESSOR_NAME-1] = '\0';
+  slow_host = host;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TaskProfileOutput::WriteSampledProfile()
+//! \brief writes profile from sampled cycles: mean over samples and ranks, maximum over
+//! ranks of the mean (and the rank), and peak over samples and ranks, of each Task
+
+void TaskProfileOutput::WriteSampledProfile(FILE *pfile) {
+  std::fprintf(pfile, "# sampled every %d cycles; times are means over samples\n",
+               sample_cycles);
+  for (std::size_t l=0; l<tl_names.size(); ++l) {
+    if (nsamples[l] == 0) continue;
+    std::fprintf(pfile, "# TaskList: %s  samples=%d  critical_path: mean=%e max=%e\n",
+                 tl_names[l].c_str(), nsamples[l], cpath_mean[l], cpath_max[l]);
+    std::fprintf(pfile, "#  %-40s %12s %12s %9s %8s %12s %s\n", "task", "t_mean",
+                 "t_max", "max/mean", "max_rank", "t_peak", "critical");
+    for (std::size_t n=0; n<task_names[l].size(); ++n) {
+      double ratio = (tmean[l][n] > 0.0) ? tmax[l][n]/tmean[l][n] : 1.0;
+      std::fprintf(pfile, "   %-40s %12.5e %12.5e %9.3f %8d %12.5e %s\n",
+                   task_names[l][n].c_str(), tmean[l][n], tmax[l][n], ratio,
+                   tmax_rank[l][n], tpeak[l][n], (on_path[l][n] ? "*" : ""));
+    }
+  }
+  std::fprintf(pfile, "# slowest rank: %d (%s)  task time: %e  mean over ranks: %e\n",
+               slow_rank, slow_host.c_str(), slow_time, mean_time);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TaskProfileOutput::WriteOutputFile()
+//! \brief appends task profile data to file "basename.prof"
+
+void TaskProfileOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  // only the master rank writes the file, and only when some cycles have been profiled
+  if (global_variable::my_rank == 0 && ncycles > 0) {
+    std::string fname;
+    fname.assign(out_params.file_basename);
+    fname.append(".prof");
+
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    std::fprintf(pfile, "# Athena task profile: cycle=%d time=%e ncycles=%d nranks=%d\n",
+                 pm->ncycle, pm->time, ncycles, global_variable::nranks);
+    std::fprintf(pfile, "# all times are wall-clock seconds per cycle\n");
+    if (sample_cycles > 0) {WriteSampledProfile(pfile);}
+    for (std::size_t l=0; l<tl_names.size() && sample_cycles <= 0; ++l) {
+      std::fprintf(pfile, "# TaskList: %s  critical_path: mean=%e max=%e\n",
+                   tl_names[l].c_str(), cpath_mean[l], cpath_max[l]);
+      std::fprintf(pfile, "#  %-40s %12s %12s %9s %s\n", "task", "t_mean", "t_max",
+                   "max/mean", "critical");
+      for (std::size_t n=0; n<task_names[l].size(); ++n) {
+        double ratio = (tmean[l][n] > 0.0) ? tmax[l][n]/tmean[l][n] : 1.0;
+        std::fprintf(pfile, "   %-40s %12.5e %12.5e %9.3f %s\n", task_names[l][n].c_str(),
+                     tmean[l][n], tmax[l][n], ratio, (on_path[l][n] ? "*" : ""));
+      }
+    }
+    std::fclose(pfile);
+  }
+
+  // increment output time, clean up
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
@@ -0,0 +1,212 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file time_average.cpp
+//! \brief writes time averages of output variables in binary format.  Variables (which
+//! may be derived variables) are summed on the device every <output>/sample_dcycle
+//! cycles, weighted by the time since the previous sample, so only the averages over
+//! the time since the last output (the averaging window) are copied to the host and
+//! written at each output.  Sums are moved with their MeshBlocks by load balancing and
+//! AMR, and stored in restart files, as extra CC arrays of the MeshBlockPack.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls MeshBinaryOutput base class constructor
+
+TimeAverageOutput::TimeAverageOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  MeshBinaryOutput(pin, pm, op),
+  pmy_mesh(pm),
+  sums("avg-sums",1,1,1,1,1),
+  coarse_sums("avg-csums",1,1,1,1,1) {
+  sample_dcycle = pin->GetOrAddInteger(op.block_name, "sample_dcycle", 1);
+  if (sample_dcycle < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "sample_dcycle in output block '" << op.block_name
+              << "' must be >= 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // group variables by the device array storing them, and replace output variables by
+  // the (normalized) sums
+  int nvar = outvars.size();
+  std::vector<std::vector<int>> index, sum_index;
+  for (int n=0; n<nvar; ++n) {
+    std::size_t s = 0;
+    while (s < sources.size() && sources[s].data_ptr != outvars[n].data_ptr) {++s;}
+    if (s == sources.size()) {
+      sources.push_back({outvars[n].data_ptr, DualArray1D<int>(), DualArray1D<int>()});
+      index.emplace_back();
+      sum_index.emplace_back();
+    }
+    index[s].push_back(outvars[n].data_index);
+    sum_index[s].push_back(n);
+  }
+  for (std::size_t s=0; s<sources.size(); ++s) {
+    int nv = index[s].size();
+    Kokkos::realloc(sources[s].index, nv);
+    Kokkos::realloc(sources[s].sum_index, nv);
+    for (int v=0; v<nv; ++v) {
+      sources[s].index.h_view(v) = index[s][v];
+      sources[s].sum_index.h_view(v) = sum_index[s][v];
+    }
+    sources[s].index.template modify<HostMemSpace>();
+    sources[s].index.template sync<DevExeSpace>();
+    sources[s].sum_index.template modify<HostMemSpace>();
+    sources[s].sum_index.template sync<DevExeSpace>();
+  }
+  for (int n=0; n<nvar; ++n) {
+    outvars[n] = OutputVariableInfo(outvars[n].label, n, &sums);
+  }
+
+  // allocate sums, dimensioned like evolved variables so they can be moved by AMR
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  auto &indcs = pm->mb_indcs;
+  int nmb = std::max(pmbp->nmb_thispack, pm->nmb_maxperrank);
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  Kokkos::realloc(sums, nmb, nvar, ncells3, ncells2, ncells1);
+  if (pm->multilevel) {
+    int n_ccells1 = indcs.cnx1 + 2*(indcs.ng);
+    int n_ccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
+    int n_ccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(coarse_sums, nmb, nvar, n_ccells3, n_ccells2, n_ccells1);
+  }
+
+  // on restarts, continue the averaging window stored in the restart file
+  sum_time = 0.0;
+  last_sample = pm->time;
+  auto rst = pmbp->extra_cc_rst.find(op.block_name);
+  if (rst != pmbp->extra_cc_rst.end()) {
+    if (rst->second.extent_int(1) != nvar) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Number of time-averaged variables in restart file for "
+                << "output block '" << op.block_name << "' differs from number of "
+                << "output variables" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    Kokkos::deep_copy(Kokkos::subview(sums, std::make_pair(0,pmbp->nmb_thispack),
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), rst->second);
+    pmbp->extra_cc_rst.erase(rst);
+    sum_time = pin->GetOrAddReal(op.block_name, "sum_time", 0.0);
+    last_sample = pin->GetOrAddReal(op.block_name, "last_sample", pm->time);
+  }
+  pmbp->extra_cc.push_back({op.block_name, &sums, &coarse_sums});
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor: removes sums from the extra CC arrays of the MeshBlockPack
+
+TimeAverageOutput::~TimeAverageOutput() {
+  auto &extra_cc = pmy_mesh->pmb_pack->extra_cc;
+  extra_cc.erase(std::remove_if(extra_cc.begin(), extra_cc.end(),
+                 [&](const ExtraArrayCC &e) {return e.u == &sums;}), extra_cc.end());
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool TimeAverageOutput::SampleDue()
+//! \brief Returns true every sample_dcycle cycles, if time has advanced since the last
+//! sample
+
+bool TimeAverageOutput::SampleDue(Mesh *pm) {
+  return ((pm->ncycle % sample_dcycle) == 0 && pm->time > last_sample);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TimeAverageOutput::AccumulateData()
+//! \brief Adds current values weighted by the time since the last sample to the sums.
+//! The state of the averaging window is stored in the input parameters, so that it is
+//! written to restart files.
+
+void TimeAverageOutput::AccumulateData(Mesh *pm, ParameterInput *pin) {
+  AddSample(pm, pm->time - last_sample);
+  sum_time += pm->time - last_sample;
+  last_sample = pm->time;
+  pin->SetReal(out_params.block_name, "sum_time", sum_time);
+  pin->SetReal(out_params.block_name, "last_sample", last_sample);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TimeAverageOutput::AddSample()
+//! \brief Adds variables (including ghost zones) times weight to sums, with one kernel
+//! for all variables stored in the same device array
+
+void TimeAverageOutput::AddSample(Mesh *pm, Real weight) {
+  if (out_params.contains_derived) {
+    ComputeDerivedVariable(out_params.variable, pm);
+  }
+  int nmb1 = pm->pmb_pack->nmb_thispack - 1;
+  int n1 = sums.extent_int(4), n2 = sums.extent_int(3), n3 = sums.extent_int(2);
+  auto s_ = sums;
+  for (auto &src : sources) {
+    auto a_ = *(src.data_ptr);
+    auto &index_ = src.index;
+    auto &sum_index_ = src.sum_index;
+    int nv1 = index_.extent_int(0) - 1;
+    par_for("avg_sum", DevExeSpace(), 0, nmb1, 0, nv1, 0, n3-1, 0, n2-1, 0, n1-1,
+    KOKKOS_LAMBDA(int m, int v, int k, int j, int i) {
+      s_(m,sum_index_.d_view(v),k,j,i) += weight*a_(m,index_.d_view(v),k,j,i);
+    });
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TimeAverageOutput::LoadOutputData()
+//! \brief Closes the averaging window at the current time, normalizes the sums in place
+//! and loads them as output data.  If no time has passed since the last output (e.g. at
+//! the start of a run) the current values are output.
+
+void TimeAverageOutput::LoadOutputData(Mesh *pm) {
+  if (pm->time > last_sample) {
+    AddSample(pm, pm->time - last_sample);
+    sum_time += pm->time - last_sample;
+    last_sample = pm->time;
+  }
+  if (sum_time <= 0.0) {
+    AddSample(pm, 1.0);
+    sum_time = 1.0;
+  }
+  auto s_ = sums;
+  Real norm = 1.0/sum_time;
+  int nmb1 = pm->pmb_pack->nmb_thispack - 1;
+  int nvar1 = sums.extent_int(1) - 1;
+  int n1 = sums.extent_int(4), n2 = sums.extent_int(3), n3 = sums.extent_int(2);
+  par_for("avg_norm", DevExeSpace(), 0, nmb1, 0, nvar1, 0, n3-1, 0, n2-1, 0, n1-1,
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    s_(m,n,k,j,i) *= norm;
+  });
+
+  // derived variables are already included in the sums
+  bool contains_derived = out_params.contains_derived;
+  out_params.contains_derived = false;
+  BaseTypeOutput::LoadOutputData(pm);
+  out_params.contains_derived = contains_derived;
+
+  // start next averaging window
+  Kokkos::deep_copy(sums, 0.0);
+  sum_time = 0.0;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TimeAverageOutput::WriteOutputFile()
+//! \brief Writes averages as binary output, and stores the reset averaging window in the
+//! input parameters
+
+void TimeAverageOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  MeshBinaryOutput::WriteOutputFile(pm, pin);
+  pin->SetReal(out_params.block_name, "sum_time", sum_time);
+  pin->SetReal(out_params.block_name, "last_sample", last_sample);
+}
@@ -5,6 +5,16 @@
 //========================================================================================
 //! \file track_prtcl.cpp
 //! \brief writes data for tracked particles in unformatted binary
+//!
+//! With <output>/stream=true, tracked particles are instead appended to device buffers at
+//! every output, and flushed in large batches by each rank (in a background thread) to
+//! its own append-only file trk/rank_XXXXXXXX/file_basename.ctrk, with no communication.
+//! Each batch is written in columns (native byte order) as:
+//!   int32 ncycles, int32 nrecords,
+//!   int32 cycle[ncycles], float64 time[ncycles], int32 nrec[ncycles],
+//!   int32 tag[nrecords], then float32 x,y,z,vx,vy,vz[nrecords] (one column each),
+//! where nrec is the number of records of each cycle, and records are ordered by cycle.
+//! The buffer capacity (in records) is set by <output>/buffer_size.
 
 #include <sys/stat.h>  // mkdir
 #include <vector>
@@ -16,6 +26,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -36,6 +47,27 @@ TrackedParticleOutput::TrackedParticleOutput(ParameterInput *pin, Mesh *pm,
   ntrack = pin->GetInteger(op.block_name,"nparticles");
   // TODO(@user) improve guess below?
   ntrack_thisrank = ntrack;
+
+  // streaming output to one file per rank
+  stream = pin->GetOrAddBoolean(op.block_name,"stream",false);
+  nbuf = 0;
+  if (stream) {
+    buffer_size = pin->GetOrAddInteger(op.block_name,"buffer_size",1048576);
+    char rank_dir[20];
+    std::snprintf(rank_dir, sizeof(rank_dir), "trk/rank_%08d/", global_variable::my_rank);
+    mkdir(rank_dir, 0775);
+    stream_fname = std::string(rank_dir) + op.file_basename + ".ctrk";
+    Kokkos::realloc(buf_rdata, buffer_size, 6);
+    Kokkos::realloc(buf_tag, buffer_size);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// destructor: writes records remaining in buffers, and waits for writer thread
+
+TrackedParticleOutput::~TrackedParticleOutput() {
+  if (stream) {FlushStream();}
+  if (writer.joinable()) {writer.join();}
 }
 
 //----------------------------------------------------------------------------------------
@@ -43,6 +75,10 @@ TrackedParticleOutput::TrackedParticleOutput(ParameterInput *pin, Mesh *pm,
 // Copies data for tracked particles on this rank to host outpart array
 
 void TrackedParticleOutput::LoadOutputData(Mesh *pm) {
+  if (stream) {
+    AppendToStream(pm);
+    return;
+  }
   // Load data for tracked particles on this rank into new device array
   DualArray1D<TrackedParticleData> tracked_prtcl("d_trked",ntrack_thisrank);
   int npart = pm->nprtcl_thisrank;
@@ -84,6 +120,17 @@ void TrackedParticleOutput::LoadOutputData(Mesh *pm) {
 //! With MPI, all particles are written to the same file.
 
 void TrackedParticleOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  // with streaming, data is only written when buffers are flushed
+  if (stream) {
+    if (out_params.last_time < 0.0) {
+      out_params.last_time = pm->time;
+    } else {
+      out_params.last_time += out_params.dt;
+    }
+    pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+    return;
+  }
+
   int big_end = IsBigEndian(); // =1 on big endian machine
 
   // create filename: "trk/file_basename".trk
@@ -172,3 +219,127 @@ void TrackedParticleOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void TrackedParticleOutput::AppendToStream(Mesh *pm)
+//! \brief Appends tracked particles on this rank to device buffers, flushing the buffers
+//! first if they cannot hold this output.  Only the number of tracked particles is
+//! copied to the host.
+
+void TrackedParticleOutput::AppendToStream(Mesh *pm) {
+  int npart = pm->nprtcl_thisrank;
+  auto &pr = pm->pmb_pack->ppart->prtcl_rdata;
+  auto &pi = pm->pmb_pack->ppart->prtcl_idata;
+  bool has_z = (pm->pmb_pack->ppart->nrdata > IPVZ);
+  int ntrack_ = ntrack;
+
+  int nrec = 0;
+  Kokkos::parallel_reduce("trk_count", Kokkos::RangePolicy<>(DevExeSpace(), 0, npart),
+  KOKKOS_LAMBDA(const int p, int &sum) {
+    if (pi(PTAG,p) < ntrack_) {++sum;}
+  }, nrec);
+
+  if (nbuf + nrec > buffer_size) {FlushStream();}
+  if (nrec > buffer_size) {
+    buffer_size = particles::GrowCapacity(buffer_size, nrec);
+    Kokkos::realloc(buf_rdata, buffer_size, 6);
+    Kokkos::realloc(buf_tag, buffer_size);
+  }
+
+  // append records in order of index in particle arrays, with a prefix scan
+  auto &rdata = buf_rdata;
+  auto &tag = buf_tag;
+  int nbuf_ = nbuf;
+  Kokkos::parallel_scan("trk_append", Kokkos::RangePolicy<>(DevExeSpace(), 0, npart),
+  KOKKOS_LAMBDA(const int p, int &index, const bool is_final) {
+    if (pi(PTAG,p) < ntrack_) {
+      if (is_final) {
+        int r = nbuf_ + index;
+        tag(r) = pi(PTAG,p);
+        rdata(r,0) = pr(IPX,p);
+        rdata(r,1) = pr(IPY,p);
+        rdata(r,2) = (has_z)? pr(IPZ,p) : 0.0;
+        rdata(r,3) = pr(IPVX,p);
+        rdata(r,4) = pr(IPVY,p);
+        rdata(r,5) = (has_z)? pr(IPVZ,p) : 0.0;
+      }
+      ++index;
+    }
+  });
+  nbuf += nrec;
+  buf_cycle.push_back(pm->ncycle);
+  buf_time.push_back(pm->time);
+  buf_nrec.push_back(nrec);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TrackedParticleOutput::FlushStream()
+//! \brief Copies buffered records to host, converts them to columns, and writes them in
+//! a background thread (after the previous batch has been written).
+
+void TrackedParticleOutput::FlushStream() {
+  if (buf_cycle.empty()) return;
+  TrackedBatch batch;
+  batch.cycle = std::move(buf_cycle);
+  batch.time = std::move(buf_time);
+  batch.nrec = std::move(buf_nrec);
+  buf_cycle.clear();
+  buf_time.clear();
+  buf_nrec.clear();
+
+  auto range = std::make_pair(0, nbuf);
+  auto h_tag = Kokkos::create_mirror_view_and_copy(HostMemSpace(),
+                                                   Kokkos::subview(buf_tag, range));
+  auto h_rdata = Kokkos::create_mirror_view_and_copy(HostMemSpace(),
+                 Kokkos::subview(buf_rdata, range, Kokkos::ALL));
+  batch.tag.assign(h_tag.data(), h_tag.data() + nbuf);
+  batch.data.resize(6*nbuf);
+  for (int r=0; r<nbuf; ++r) {
+    for (int n=0; n<6; ++n) {
+      batch.data[n*nbuf + r] = static_cast<float>(h_rdata(r,n));
+    }
+  }
+  nbuf = 0;
+
+  if (writer.joinable()) {writer.join();}
+  writer = std::thread([this, b = std::move(batch)]() {WriteTrackedBatch(b);});
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TrackedParticleOutput::WriteTrackedBatch()
+//! \brief Appends one batch to the file of this rank.  Only uses data stored in batch,
+//! so that it can be called from the writer thread.
+
+void TrackedParticleOutput::WriteTrackedBatch(const TrackedBatch &batch) {
+  FILE *pfile;
+  if ((pfile = std::fopen(stream_fname.c_str(),"ab")) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "Output file '" << stream_fname << "' could not be opened"
+      << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  int32_t ncycles = batch.cycle.size();
+  int32_t nrec = batch.tag.size();
+  bool ok = (std::fwrite(&ncycles, sizeof(int32_t), 1, pfile) == 1) &&
+            (std::fwrite(&nrec, sizeof(int32_t), 1, pfile) == 1);
+  ok = ok && (std::fwrite(batch.cycle.data(), sizeof(int32_t), ncycles, pfile) ==
+              static_cast<std::size_t>(ncycles));
+  ok = ok && (std::fwrite(batch.time.data(), sizeof(double), ncycles, pfile) ==
+              static_cast<std::size_t>(ncycles));
+  ok = ok && (std::fwrite(batch.nrec.data(), sizeof(int32_t), ncycles, pfile) ==
+              static_cast<std::size_t>(ncycles));
+  ok = ok && (std::fwrite(batch.tag.data(), sizeof(int32_t), nrec, pfile) ==
+              static_cast<std::size_t>(nrec));
+  ok = ok && (std::fwrite(batch.data.data(), sizeof(float), 6*nrec, pfile) ==
+              static_cast<std::size_t>(6*nrec));
+  if (!(ok)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "particle data not written correctly to tracked particle file '"
+        << stream_fname << "'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::fclose(pfile);
+  return;
+}
@@ -7,6 +7,8 @@
 //! \brief writes mesh data in (legacy) vtk format.
 //! Data is written in STRUCTURED_POINTS geometry, in BINARY format, and in FLOAT type
 //! Data over multiple MeshBlocks and MPI ranks is written to a single file using MPI-IO.
+//! With <output>/partitioned=true, each rank instead writes its own VTK XML piece, and
+//! rank 0 writes a .pvtu master file.
 
 // TODO(@user): create new communicator for MPI-IO for slicing, including only those ranks
 // that have MeshBlocks in slice.  Current design segfaults with slicing if there are
@@ -15,12 +17,14 @@
 #include <sys/stat.h>  // mkdir
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdio>      // fwrite(), fclose(), fopen(), fnprintf(), snprintf()
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 #include <limits> // numeric_limits<>
 
 #include "athena.hpp"
@@ -42,6 +46,31 @@ MeshVTKOutput::MeshVTKOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshVTKOutput:::WriteOutputFile(Mesh *pm)
+//! \brief Writes output data either in (legacy) vtk format to a single file, or with
+//! <output>/partitioned=true as one XML piece per rank and a .pvtu master file.
+
+void MeshVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  if (out_params.partitioned) {
+    WritePartitionedFiles(pm);
+  } else {
+    WriteLegacyFile(pm);
+  }
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshVTKOutput:::WriteLegacyFile(Mesh *pm)
 //! \brief Cycles over all MeshBlocks and writes output data in (legacy) vtk format.
 //! With MPI, all MeshBlocks are written to the same file in proper order.
 //!
@@ -52,7 +81,7 @@ MeshVTKOutput::MeshVTKOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
 //!  4. Dataset structure, including type and dimensions of data, and coordinates.
 //!  5. Data.  An arbitrary number of scalars and vectors can be written
 
-void MeshVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+void MeshVTKOutput::WriteLegacyFile(Mesh *pm) {
   int big_end = IsBigEndian(); // =1 on big endian machine
   // create filename: "vtk/file_basename"."file_id"."gid"."XXXXX".vtk
   // where XXXXX = 5-digit file_number, and gid only added if specified
@@ -313,16 +342,211 @@ void MeshVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     std::fclose(pfile);
     delete[] data;
   }
+  return;
+}
 
-  // increment counters
-  out_params.file_number++;
-  if (out_params.last_time < 0.0) {
-    out_params.last_time = pm->time;
-  } else {
-    out_params.last_time += out_params.dt;
+//----------------------------------------------------------------------------------------
+//! \fn void MeshVTKOutput:::WritePartitionedFiles(Mesh *pm)
+//! \brief Each rank writes its output MeshBlocks as one piece in VTK XML UnstructuredGrid
+//! format (.vtu) with its own (serial) file, and rank 0 writes a small .pvtu master file
+//! listing the pieces of all ranks.  Cells of each MB are stored as voxels (pixels or
+//! lines in 2D or 1D), so MBs on any level of refinement can be written.  Data is
+//! appended as raw binary in the byte order of the machine (declared in the file), so
+//! no byte swapping is needed, and each variable is written from outarray with a single
+//! fwrite.
+
+void MeshVTKOutput::WritePartitionedFiles(Mesh *pm) {
+  // create filenames: "vtk/file_basename"."file_id"."XXXXX"."RRRRRR".vtu for pieces,
+  // where XXXXX = 5-digit file_number and RRRRRR = 6-digit rank, and
+  // "vtk/file_basename"."file_id"."XXXXX".pvtu for master file
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+  std::string fbase = out_params.file_basename + "." + out_params.file_id + "." + number;
+  auto piece_name = [&fbase](int rank) {
+    char rank_str[8];
+    std::snprintf(rank_str, sizeof(rank_str), "%06d", rank);
+    return fbase + "." + rank_str + ".vtu";
+  };
+  const char *byte_order = (IsBigEndian())? "BigEndian" : "LittleEndian";
+  const char *var_type = (sizeof(OutReal) == sizeof(float))? "Float32" : "Float64";
+
+  // number of cells and points in each direction on output MBs (the same on all MBs),
+  // and VTK cell type (VERTEX, LINE, PIXEL or VOXEL) given by number of dimensions with
+  // more than one cell
+  auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
+  int nout_mbs = outmbs.size();
+  int nx[3] = {1, 1, 1};
+  if (nout_mbs > 0) {
+    nx[0] = outmbs[0].oie - outmbs[0].ois + 1;
+    nx[1] = outmbs[0].oje - outmbs[0].ojs + 1;
+    nx[2] = outmbs[0].oke - outmbs[0].oks + 1;
+  }
+  int np[3];
+  int ndim = 0;
+  std::int32_t corner[8];
+  corner[0] = 0;
+  for (int d=0, stride=1; d<3; ++d) {
+    np[d] = (nx[d] > 1)? (nx[d] + 1) : 1;
+    if (nx[d] > 1) {
+      // corners of cells in VTK order, with first active dimension varying fastest
+      for (int c=0; c<(1 << ndim); ++c) {corner[c + (1 << ndim)] = corner[c] + stride;}
+      ++ndim;
+    }
+    stride *= np[d];
+  }
+  const int ncorner = 1 << ndim;
+  const std::uint8_t cell_type[4] = {1, 3, 8, 11};
+  std::size_t ncells_mb = static_cast<std::size_t>(nx[0])*nx[1]*nx[2];
+  std::size_t npts_mb = static_cast<std::size_t>(np[0])*np[1]*np[2];
+  std::size_t ncells = nout_mbs*ncells_mb;
+  std::size_t npts = nout_mbs*npts_mb;
+
+  // coordinates of points (cell faces, or cell centers in dimensions with one cell) and
+  // cells of all output MBs
+  std::vector<float> points(3*npts);
+  std::vector<std::int32_t> connectivity(ncorner*ncells), offsets(ncells);
+  std::vector<std::uint8_t> types(ncells, cell_type[ndim]);
+  for (int m=0; m<nout_mbs; ++m) {
+    auto &omb = outmbs[m];
+    Real dx[3] = {(omb.x1max - omb.x1min)/indcs.nx1, (omb.x2max - omb.x2min)/indcs.nx2,
+                  (omb.x3max - omb.x3min)/indcs.nx3};
+    Real xl[3] = {omb.x1min + (omb.ois - indcs.is)*dx[0],
+                  omb.x2min + (omb.ojs - indcs.js)*dx[1],
+                  omb.x3min + (omb.oks - indcs.ks)*dx[2]};
+    for (int d=0; d<3; ++d) {
+      if (np[d] == 1) {xl[d] += 0.5*dx[d];}
+    }
+    std::size_t p = 3*m*npts_mb;
+    for (int k=0; k<np[2]; ++k) {
+      for (int j=0; j<np[1]; ++j) {
+        for (int i=0; i<np[0]; ++i) {
+          points[p++] = static_cast<float>(xl[0] + i*dx[0]);
+          points[p++] = static_cast<float>(xl[1] + j*dx[1]);
+          points[p++] = static_cast<float>(xl[2] + k*dx[2]);
+        }
+      }
+    }
+    std::size_t cell = m*ncells_mb;
+    for (int k=0; k<nx[2]; ++k) {
+      for (int j=0; j<nx[1]; ++j) {
+        for (int i=0; i<nx[0]; ++i) {
+          std::int32_t base = m*npts_mb + i + np[0]*(j + np[1]*k);
+          for (int c=0; c<ncorner; ++c) {
+            connectivity[ncorner*cell + c] = base + corner[c];
+          }
+          offsets[cell] = ncorner*(cell + 1);
+          ++cell;
+        }
+      }
+    }
+  }
+
+  // offsets of arrays in appended data, each preceded by its size as UInt64
+  int nout_vars = outvars.size();
+  std::size_t nbytes[4] = {points.size()*sizeof(float),
+                           connectivity.size()*sizeof(std::int32_t),
+                           offsets.size()*sizeof(std::int32_t), types.size()};
+  std::size_t var_bytes = ncells*sizeof(OutReal);
+  std::size_t array_offset[4];
+  std::size_t total = 0;
+  for (int a=0; a<4; ++a) {
+    array_offset[a] = total;
+    total += sizeof(std::uint64_t) + nbytes[a];
   }
-  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
-  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
 
+  // Write piece of this rank: XML header, then appended data
+  std::stringstream msg;
+  msg << "<?xml version=\"1.0\"?>" << std::endl
+      << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+      << byte_order << "\" header_type=\"UInt64\">" << std::endl
+      << "<UnstructuredGrid>" << std::endl
+      << std::scientific << std::setprecision(std::numeric_limits<Real>::max_digits10 - 1)
+      << "<FieldData>" << std::endl
+      << "<DataArray type=\"Float64\" Name=\"TIME\" NumberOfTuples=\"1\" "
+      << "format=\"ascii\">" << pm->time << "</DataArray>" << std::endl
+      << "<DataArray type=\"Int32\" Name=\"CYCLE\" NumberOfTuples=\"1\" "
+      << "format=\"ascii\">" << pm->ncycle << "</DataArray>" << std::endl
+      << "</FieldData>" << std::endl
+      << "<Piece NumberOfPoints=\"" << npts << "\" NumberOfCells=\"" << ncells << "\">"
+      << std::endl
+      << "<Points>" << std::endl
+      << "<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" "
+      << "offset=\"" << array_offset[0] << "\"/>" << std::endl
+      << "</Points>" << std::endl
+      << "<Cells>" << std::endl
+      << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\""
+      << array_offset[1] << "\"/>" << std::endl
+      << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\""
+      << array_offset[2] << "\"/>" << std::endl
+      << "<DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\""
+      << array_offset[3] << "\"/>" << std::endl
+      << "</Cells>" << std::endl
+      << "<CellData>" << std::endl;
+  for (int n=0; n<nout_vars; ++n) {
+    msg << "<DataArray type=\"" << var_type << "\" Name=\"" << outvars[n].label
+        << "\" format=\"appended\" offset=\""
+        << total + n*(sizeof(std::uint64_t) + var_bytes) << "\"/>" << std::endl;
+  }
+  msg << "</CellData>" << std::endl
+      << "</Piece>" << std::endl
+      << "</UnstructuredGrid>" << std::endl
+      << "<AppendedData encoding=\"raw\">" << std::endl << "_";
+
+  std::string fname = "vtk/" + piece_name(global_variable::my_rank);
+  FILE *pfile;
+  if ((pfile = std::fopen(fname.c_str(),"wb")) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+      exit(EXIT_FAILURE);
+  }
+  std::fwrite(msg.str().c_str(), sizeof(char), msg.str().size(), pfile);
+  const void *arrays[4] = {points.data(), connectivity.data(), offsets.data(),
+                           types.data()};
+  for (int a=0; a<4; ++a) {
+    std::uint64_t size = nbytes[a];
+    std::fwrite(&size, sizeof(size), 1, pfile);
+    std::fwrite(arrays[a], 1, nbytes[a], pfile);
+  }
+  // variables of all MBs are contiguous in outarray (n,m,k,j,i)
+  for (int n=0; n<nout_vars; ++n) {
+    std::uint64_t size = var_bytes;
+    std::fwrite(&size, sizeof(size), 1, pfile);
+    if (ncells > 0) {
+      std::fwrite(outarray.data() + n*ncells, sizeof(OutReal), ncells, pfile);
+    }
+  }
+  std::fprintf(pfile, "\n</AppendedData>\n</VTKFile>\n");
+  std::fclose(pfile);
+
+  // Write master file listing pieces of all ranks
+  if (global_variable::my_rank == 0) {
+    std::stringstream pmsg;
+    pmsg << "<?xml version=\"1.0\"?>" << std::endl
+         << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\""
+         << byte_order << "\" header_type=\"UInt64\">" << std::endl
+         << "<PUnstructuredGrid GhostLevel=\"0\">" << std::endl
+         << "<PPoints>" << std::endl
+         << "<PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>" << std::endl
+         << "</PPoints>" << std::endl
+         << "<PCellData>" << std::endl;
+    for (int n=0; n<nout_vars; ++n) {
+      pmsg << "<PDataArray type=\"" << var_type << "\" Name=\"" << outvars[n].label
+           << "\"/>" << std::endl;
+    }
+    pmsg << "</PCellData>" << std::endl;
+    for (int r=0; r<global_variable::nranks; ++r) {
+      pmsg << "<Piece Source=\"" << piece_name(r) << "\"/>" << std::endl;
+    }
+    pmsg << "</PUnstructuredGrid>" << std::endl
+         << "</VTKFile>" << std::endl;
+    std::string pname = "vtk/" + fbase + ".pvtu";
+    if ((pfile = std::fopen(pname.c_str(),"w")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << pname << "' could not be opened" <<std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::fprintf(pfile, "%s", pmsg.str().c_str());
+    std::fclose(pfile);
+  }
   return;
 }
@@ -18,6 +18,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "athena.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -38,7 +39,7 @@ ParticleVTKOutput::ParticleVTKOutput(ParameterInput *pin, Mesh *pm, OutputParame
 
 //----------------------------------------------------------------------------------------
 // ParticleVTKOutput::LoadOutputData()
-// Copies real and integer particle data to host for outputs
+// Copies positions and attributes flagged for output of particles to host for outputs
 
 void ParticleVTKOutput::LoadOutputData(Mesh *pm) {
   particles::Particles *pp = pm->pmb_pack->ppart;
@@ -47,17 +48,21 @@ void ParticleVTKOutput::LoadOutputData(Mesh *pm) {
   Kokkos::realloc(outpart_rdata, pp->nrdata, npout_thisrank);
   Kokkos::realloc(outpart_idata, pp->nidata, npout_thisrank);
 
-  // Create mirror view on device of host view of output particle real/int data
-  auto d_outpart_rdata = Kokkos::create_mirror_view(Kokkos::DefaultHostExecutionSpace(),
-                                                    outpart_rdata);
-  auto d_outpart_idata = Kokkos::create_mirror_view(Kokkos::DefaultHostExecutionSpace(),
-                                                    outpart_idata);
-  // Copy particle positions into device mirrors
-  Kokkos::deep_copy(d_outpart_rdata, pp->prtcl_rdata);
-  Kokkos::deep_copy(d_outpart_idata, pp->prtcl_idata);
-  // Copy particle positions from device mirror to host output array
-  Kokkos::deep_copy(outpart_rdata, d_outpart_rdata);
-  Kokkos::deep_copy(outpart_idata, d_outpart_idata);
+  // Copy each needed attribute of active particles (particle arrays may have larger
+  // capacity), which is contiguous in particle arrays, to host output arrays
+  auto prange = std::make_pair(0, npout_thisrank);
+  for (auto &attr : pp->attributes) {
+    bool position = attr.is_real && (attr.index == IPX || attr.index == IPY ||
+                                     attr.index == IPZ);
+    if (!(attr.output) && !(position)) continue;
+    if (attr.is_real) {
+      Kokkos::deep_copy(Kokkos::subview(outpart_rdata, attr.index, Kokkos::ALL),
+                        Kokkos::subview(pp->prtcl_rdata, attr.index, prange));
+    } else {
+      Kokkos::deep_copy(Kokkos::subview(outpart_idata, attr.index, Kokkos::ALL),
+                        Kokkos::subview(pp->prtcl_idata, attr.index, prange));
+    }
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -184,8 +189,9 @@ void ParticleVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // Write Part 6: scalar particle data
   bool have_written_pointdata_header = false;
 
-  // Write gid of points
-  for (int n=0; n<(pm->pmb_pack->ppart->nidata); ++n) {
+  // Write attributes flagged for output (gid and ptag by default)
+  for (auto &attr : pm->pmb_pack->ppart->attributes) {
+    if (!(attr.output)) continue;
     std::stringstream msg;
 
     if (!have_written_pointdata_header) {
@@ -193,13 +199,8 @@ void ParticleVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       msg << std::endl << std::endl << "POINT_DATA " << npout_total << std::endl;
     }
 
-    if (n == static_cast<int>(PGID)) {
-      msg << std::endl << "SCALARS gid float" << std::endl
-          << "LOOKUP_TABLE default" << std::endl;
-    } else if (n == static_cast<int>(PTAG)) {
-      msg << std::endl << "SCALARS ptag float" << std::endl
-          << "LOOKUP_TABLE default" << std::endl;
-    }
+    msg << std::endl << "SCALARS " << attr.name << " float" << std::endl
+        << "LOOKUP_TABLE default" << std::endl;
 
     if (global_variable::my_rank == 0) {
       partfile.Write_any_type_at(msg.str().c_str(),msg.str().size(),header_offset,"byte");
@@ -207,9 +208,10 @@ void ParticleVTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
 
     header_offset += msg.str().size();
 
-    // Loop over particles, load gid into data[]
+    // Loop over particles, load attribute into data[]
     for (int p=0; p<npout_thisrank; ++p) {
-      data[p] = static_cast<float>(outpart_idata(n,p));
+      data[p] = (attr.is_real)? static_cast<float>(outpart_rdata(attr.index,p)) :
+                                static_cast<float>(outpart_idata(attr.index,p));
     }
     // swap data for this variable into big endian order
     if (!big_end) {
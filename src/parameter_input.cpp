@@ -38,6 +38,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -64,10 +65,7 @@ ParameterInput::ParameterInput(std::string input_filename) : last_filename{} {
 #ifdef OPENMP_PARALLEL
   omp_init_lock(&lock_);
 #endif
-  IOWrapper infile;
-  infile.Open(input_filename.c_str(), IOWrapper::FileMode::read);
-  LoadFromFile(infile);
-  infile.Close();
+  LoadFromFileOnRoot(input_filename);
 }
 
 //----------------------------------------------------------------------------------------
@@ -84,10 +82,8 @@ ParameterInput::~ParameterInput() {
 //  \brief return pointer to InputLine containing specified parameter if it exists
 
 InputLine* InputBlock::GetPtrToLine(std::string name) {
-  for (auto it = line.begin(); it != line.end(); ++it) {
-    if (name.compare(it->param_name) == 0) return &*it;
-  }
-  return nullptr;
+  auto it = line_index.find(name);
+  return (it == line_index.end() ? nullptr : it->second);
 }
 
 //----------------------------------------------------------------------------------------
@@ -95,10 +91,8 @@ InputLine* InputBlock::GetPtrToLine(std::string name) {
 //  \brief return pointer to specified InputBlock if it exists
 
 InputBlock* ParameterInput::GetPtrToBlock(std::string name) {
-  for (auto it = block.begin(); it != block.end(); ++it) {
-    if (name.compare(it->block_name) == 0) return &*it;
-  }
-  return nullptr;
+  auto it = block_index_.find(name);
+  return (it == block_index_.end() ? nullptr : it->second);
 }
 
 //----------------------------------------------------------------------------------------
@@ -218,25 +212,98 @@ void ParameterInput::LoadFromFile(IOWrapper &input, bool single_file_per_rank) {
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn InputBlock* ParameterInput::FindOrAddBlock(std::string name)
-//  \brief find or add specified InputBlock.  Returns pointer to block.
-
-InputBlock* ParameterInput::FindOrAddBlock(std::string name) {
-  // if block contains no elements, create the first one
-  if (block.empty()) {
-    block.emplace_front(name);
-    return &block.front();
+//! \fn  void ParameterInput::LoadFromFileOnRoot(std::string input_filename)
+//  \brief Read the parameters from an input file on rank 0 only, then broadcast them
+//  (already parsed) to all other ranks as one binary blob.  Unlike LoadFromFile(), only
+//  rank 0 opens the file, so startup on many ranks does not load the filesystem.
+
+void ParameterInput::LoadFromFileOnRoot(std::string input_filename) {
+  std::string blob;
+  if (global_variable::my_rank == 0) {
+    std::ifstream is(input_filename);
+    if (!is.good()) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Input file '" << input_filename << "' could not be "
+                << "opened" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    LoadFromStream(is);
+    PackBlocks(blob);
+  }
+#if MPI_PARALLEL_ENABLED
+  int nbytes = static_cast<int>(blob.size());
+  MPI_Bcast(&nbytes, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (global_variable::my_rank != 0) blob.resize(nbytes);
+  MPI_Bcast(&blob[0], nbytes, MPI_CHAR, 0, MPI_COMM_WORLD);
+  if (global_variable::my_rank != 0) UnpackBlocks(blob);
+#endif
+  last_filename = input_filename;
+  return;
+}
 
-  // else search linked list of InputBlocks to see if name exists, return if found.
-  } else {
-    for (auto it = block.begin(); it != block.end(); ++it) {
-      if (name.compare(it->block_name) == 0) return &*it;
+//----------------------------------------------------------------------------------------
+//! \fn void ParameterInput::PackBlocks(std::string &blob)
+//  \brief pack all InputBlocks into a blob of null-terminated strings: the name of each
+//  block (prefixed with '<', which cannot start a parameter name), followed by the name,
+//  value, and comment of each parameter in the block.
+
+void ParameterInput::PackBlocks(std::string &blob) {
+  blob.clear();
+  for (auto itb = block.begin(); itb != block.end(); ++itb) {
+    blob.append("<" + itb->block_name);
+    blob.push_back('\0');
+    for (auto itl = itb->line.begin(); itl != itb->line.end(); ++itl) {
+      blob.append(itl->param_name);
+      blob.push_back('\0');
+      blob.append(itl->param_value);
+      blob.push_back('\0');
+      blob.append(itl->param_comment);
+      blob.push_back('\0');
     }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParameterInput::UnpackBlocks(const std::string &blob)
+//  \brief add all InputBlocks and parameters stored in a blob created by PackBlocks()
 
-    // Create new block at end of list if not found above, and return pointer to it
-    block.emplace_back(name);
-    return &block.back();
+void ParameterInput::UnpackBlocks(const std::string &blob) {
+  InputBlock *pib{};
+  std::size_t pos = 0;
+  // returns next null-terminated string in blob, and advances pos past it
+  auto next = [&blob, &pos]() {
+    std::size_t end = blob.find('\0', pos);
+    std::string s = blob.substr(pos, end - pos);
+    pos = end + 1;
+    return s;
+  };
+  while (pos < blob.size()) {
+    std::string name = next();
+    if (name.compare(0, 1, "<") == 0) {
+      pib = FindOrAddBlock(name.substr(1));
+    } else {
+      std::string value = next();
+      std::string comment = next();
+      AddParameter(pib, name, value, comment);
+    }
   }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn InputBlock* ParameterInput::FindOrAddBlock(std::string name)
+//  \brief find or add specified InputBlock.  Returns pointer to block.
+
+InputBlock* ParameterInput::FindOrAddBlock(std::string name) {
+  // search hash table of InputBlocks to see if name exists, return if found.
+  InputBlock *pb = GetPtrToBlock(name);
+  if (pb != nullptr) return pb;
+
+  // Create new block at end of list if not found above, and return pointer to it
+  block.emplace_back(name);
+  block_index_[name] = &block.back();
+  return &block.back();
 }
 
 //----------------------------------------------------------------------------------------
@@ -288,24 +355,25 @@ void ParameterInput::AddParameter(InputBlock *pb, std::string name, std::string
   // if line contains no elements, create the first one
   if (pb->line.empty()) {
     pb->line.emplace_front(name,value,comment);
+    pb->line_index[name] = &pb->line.front();
     pb->max_len_parname = name.length();
     pb->max_len_parvalue = value.length();
     return;
 
-  // else search linked list of InputBlocks to see if name exists, replace contents
+  // else search hash table of InputLines to see if name exists, replace contents
   // with new values if found and return.
   } else {
-    for (auto it = pb->line.begin(); it != pb->line.end(); ++it) {
-      if (name.compare(it->param_name) == 0) {   // param name already exists
-        it->param_value.assign(value);           // replace existing param value
-        it->param_comment.assign(comment);       // replace exisiting param comment
-        if (value.length() > pb->max_len_parvalue) pb->max_len_parvalue = value.length();
-        return;
-      }
+    InputLine *pl = pb->GetPtrToLine(name);
+    if (pl != nullptr) {                       // param name already exists
+      pl->param_value.assign(value);           // replace existing param value
+      pl->param_comment.assign(comment);       // replace exisiting param comment
+      if (value.length() > pb->max_len_parvalue) pb->max_len_parvalue = value.length();
+      return;
     }
 
   // Parameter not found, so create new node in linked list
     pb->line.emplace_back(name,value,comment);
+    pb->line_index[name] = &pb->line.back();
     if (name.length() > pb->max_len_parname) pb->max_len_parname = name.length();
     if (value.length() > pb->max_len_parvalue) pb->max_len_parvalue = value.length();
   }
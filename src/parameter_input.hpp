@@ -16,6 +16,7 @@
 #include <string>   // string
 #include <cstdlib>
 #include <list>
+#include <unordered_map>
 
 #include "athena.hpp"
 #include "outputs/io_wrapper.hpp"
@@ -53,6 +54,8 @@ class InputBlock {
   std::size_t max_len_parname;  // length of longest param_name, for nice-looking output
   std::size_t max_len_parvalue; // length of longest param_value, to format outputs
   std::list<InputLine> line;    // singly linked list of input lines (in this block)
+  // hash table of pointers to lines (in this block), indexed by param_name
+  std::unordered_map<std::string, InputLine*> line_index;
 
   // functions
   InputLine* GetPtrToLine(std::string name);
@@ -76,6 +79,7 @@ class ParameterInput {
   // functions
   void LoadFromStream(std::istream &is);
   void LoadFromFile(IOWrapper &input, bool single_file_per_rank=false);
+  void LoadFromFileOnRoot(std::string input_filename);
   void ModifyFromCmdline(int argc, char *argv[]);
   void ParameterDump(std::ostream& os);
   bool DoesBlockExist(std::string name);
@@ -95,12 +99,16 @@ class ParameterInput {
 
  private:
   std::string last_filename;  // last input file opened, to prevent duplicate reads
+  // hash table of pointers to InputBlocks, indexed by block_name
+  std::unordered_map<std::string, InputBlock*> block_index_;
 
   InputBlock* FindOrAddBlock(std::string name);
   InputBlock* GetPtrToBlock(std::string name);
   void ParseLine(std::string line, std::string &name, std::string &val,
                  std::string &comment);
   void AddParameter(InputBlock *pib, std::string name, std::string val, std::string comm);
+  void PackBlocks(std::string &blob);
+  void UnpackBlocks(const std::string &blob);
 
 #if OPENMP_PARALLEL_ENABLED
   // lock to implement OpenMP thread safety
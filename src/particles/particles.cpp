@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include <algorithm>
 
 #include "athena.hpp"
@@ -58,6 +59,43 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     std::string ppush = pin->GetString("particles","pusher");
     if (ppush.compare("drift") == 0) {
       pusher = ParticlesPusher::drift;
+    } else if (ppush.compare("lagrangian_tracer") == 0 ||
+               ppush.compare("lagrangian_mc") == 0) {
+      pusher = (ppush.compare("lagrangian_mc") == 0)? ParticlesPusher::lagrangian_mc :
+                                                      ParticlesPusher::lagrangian_tracer;
+      if (pmy_pack->phydro == nullptr && pmy_pack->pmhd == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Tracer particles require <hydro> or <mhd> block"
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (pusher == ParticlesPusher::lagrangian_mc) {
+        rng_seed = pin->GetOrAddInteger("particles","seed",1);
+      }
+      std::string interp = pin->GetOrAddString("particles","interpolation","trilinear");
+      tsc_interp = (interp.compare("tsc") == 0);
+    } else if (ppush.compare("boris") == 0) {
+      pusher = ParticlesPusher::boris;
+      if (pmy_pack->pmhd == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Boris pusher requires <mhd> block" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      q_over_m = pin->GetReal("particles","q_over_m");
+      speed_of_light = pin->GetOrAddReal("particles","speed_of_light",1.0);
+      gyro_cfl = pin->GetOrAddReal("particles","gyro_cfl",0.1);
+      max_subcycles = pin->GetOrAddInteger("particles","max_subcycles",100);
+      std::string interp = pin->GetOrAddString("particles","interpolation","trilinear");
+      if (interp.compare("tsc") == 0) {
+        tsc_interp = true;
+      } else if (interp.compare("trilinear") == 0) {
+        tsc_interp = false;
+      } else {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Particle interpolation = '" << interp
+                  << "' not recognized, choose [trilinear,tsc]" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                 << std::endl << "Particle pusher must be specified in <particles> block"
@@ -72,13 +110,23 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
               << "Particles only work in 2D/3D, but 1D problem initialized" <<std::endl;
     std::exit(EXIT_FAILURE);
   }
+  // attributes are registered in order of ParticlesIndex enum
+  nrdata = 0;
+  nidata = 0;
   switch (particle_type) {
     case ParticleType::cosmic_ray:
       {
-        int ndim=4;
-        if (pmy_pack->pmesh->three_d) {ndim+=2;}
-        nrdata = ndim;
-        nidata = 2;
+        AddAttribute("gid", false, true, true);
+        AddAttribute("ptag", false, true, true);
+        AddAttribute("x", true, true, false);
+        AddAttribute("vx", true, true, false);
+        AddAttribute("y", true, true, false);
+        AddAttribute("vy", true, true, false);
+        // boris pusher always evolves all three velocity components
+        if (pmy_pack->pmesh->three_d || pusher == ParticlesPusher::boris) {
+          AddAttribute("z", true, true, false);
+          AddAttribute("vz", true, true, false);
+        }
         break;
       }
     default:
@@ -87,6 +135,26 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
   Kokkos::realloc(prtcl_rdata, nrdata, nprtcl_thispack);
   Kokkos::realloc(prtcl_idata, nidata, nprtcl_thispack);
 
+  // reorder particles by cell every sort_interval cycles
+  sort_interval = pin->GetOrAddInteger("particles","sort_interval",0);
+
+  // shape of particles deposited to mesh
+  {
+    std::string dep = pin->GetOrAddString("particles","deposit","cic");
+    if (dep.compare("ngp") == 0) {
+      deposit_npts = 1;
+    } else if (dep.compare("cic") == 0) {
+      deposit_npts = 2;
+    } else if (dep.compare("tsc") == 0) {
+      deposit_npts = 3;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Particle deposit = '" << dep << "' not recognized, "
+                << "choose [ngp,cic,tsc]" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
   // allocate boundary object
   pbval_part = new ParticlesBoundaryValues(this, pin);
 }
@@ -97,6 +165,108 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
 Particles::~Particles() {
 }
 
+//----------------------------------------------------------------------------------------
+// ReserveParticles()
+// Grows capacity of particle arrays geometrically (keeping data) so they can hold n
+// particles.  Capacity is never reduced, so arrays are not reallocated every step.
+
+void Particles::ReserveParticles(const int n) {
+  int capacity = prtcl_rdata.extent_int(1);
+  if (n > capacity) {
+    capacity = GrowCapacity(capacity, n);
+    Kokkos::resize(prtcl_rdata, nrdata, capacity);
+    Kokkos::resize(prtcl_idata, nidata, capacity);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+// AddAttribute()
+// Registers a new Real (is_real=true) or int attribute of all particles, and returns its
+// row in prtcl_rdata or prtcl_idata.  Existing particles get value zero.  Can be called
+// by problem generators; if the attribute already exists its index is returned.
+
+int Particles::AddAttribute(const std::string &name, const bool is_real,
+                            const bool migrate, const bool output) {
+  for (auto &attr : attributes) {
+    if (attr.name.compare(name) == 0) {
+      if (attr.is_real != is_real) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Particle attribute '" << name << "' already added "
+                  << "with a different type" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      return attr.index;
+    }
+  }
+  int index = (is_real)? nrdata++ : nidata++;
+  attributes.push_back({name, is_real, index, migrate, output});
+  // add row to particle arrays, keeping data
+  if (is_real) {
+    Kokkos::resize(prtcl_rdata, nrdata, prtcl_rdata.extent_int(1));
+  } else {
+    Kokkos::resize(prtcl_idata, nidata, prtcl_idata.extent_int(1));
+  }
+
+  // update indices of attributes communicated when particles migrate
+  std::vector<int> rmig, imig;
+  for (auto &attr : attributes) {
+    if (attr.migrate) {
+      if (attr.is_real) {
+        rmig.push_back(attr.index);
+      } else {
+        imig.push_back(attr.index);
+      }
+    }
+  }
+  nrmigrate = rmig.size();
+  nimigrate = imig.size();
+  Kokkos::realloc(rmigrate, nrmigrate);
+  Kokkos::realloc(imigrate, nimigrate);
+  for (int n=0; n<nrmigrate; ++n) {rmigrate.h_view(n) = rmig[n];}
+  for (int n=0; n<nimigrate; ++n) {imigrate.h_view(n) = imig[n];}
+  rmigrate.template modify<HostMemSpace>();
+  rmigrate.template sync<DevExeSpace>();
+  imigrate.template modify<HostMemSpace>();
+  imigrate.template sync<DevExeSpace>();
+  return index;
+}
+
+//----------------------------------------------------------------------------------------
+// AttributeIndex()
+// Returns row of attribute with input name in prtcl_rdata or prtcl_idata, or -1 if it
+// has not been registered.
+
+int Particles::AttributeIndex(const std::string &name) const {
+  for (auto &attr : attributes) {
+    if (attr.name.compare(name) == 0) {return attr.index;}
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------------------------
+// ParticlesEachMB()
+// Returns number of particles in each MeshBlock of this pack, used to measure the cost of
+// each MeshBlock for automatic load balancing.
+
+void Particles::ParticlesEachMB(std::vector<float> &nprtcl) {
+  int nmb = pmy_pack->nmb_thispack;
+  int gids = pmy_pack->gids;
+  auto &pi = prtcl_idata;
+  DualArray1D<int> nprtcl_mb("nprtcl_mb", nmb);
+  par_for("prtcl_each_mb",DevExeSpace(),0,(nprtcl_thispack-1),
+  KOKKOS_LAMBDA(const int p) {
+    Kokkos::atomic_add(&nprtcl_mb.d_view(pi(PGID,p) - gids), 1);
+  });
+  nprtcl_mb.template modify<DevExeSpace>();
+  nprtcl_mb.template sync<HostMemSpace>();
+  nprtcl.assign(nmb, 0.0);
+  for (int m=0; m<nmb; ++m) {
+    nprtcl[m] = static_cast<float>(nprtcl_mb.h_view(m));
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 // CreatePaticleTags()
 // Assigns tags to particles (unique integer).  Note that tracked particles are always
@@ -8,9 +8,13 @@
 //! \file particles.hpp
 //  \brief definitions for Particles class
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
@@ -20,7 +24,7 @@
 // forward declarations
 
 // constants that enumerate ParticlesPusher options
-enum class ParticlesPusher {drift, leap_frog, lagrangian_tracer, lagrangian_mc};
+enum class ParticlesPusher {drift, leap_frog, lagrangian_tracer, lagrangian_mc, boris};
 
 // constants that enumerate ParticleTypes
 enum class ParticleType {cosmic_ray};
@@ -38,10 +42,67 @@ struct ParticlesTaskIDs {
   TaskID recvp;
   TaskID csend;
   TaskID crecv;
+  TaskID sort;
 };
 
 namespace particles {
 
+//----------------------------------------------------------------------------------------
+//! \fn int GrowCapacity
+//  \brief Returns capacity (of particle arrays or buffers) needed to hold n elements,
+//  grown geometrically by a factor 1.5 so that reallocations are rare.
+
+inline int GrowCapacity(const int capacity, const int n) {
+  return std::max(n, capacity + capacity/2);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InterpWeights
+//  \brief Sets first index and weights of npts=1 (NGP), 2 (trilinear/CIC) or 3 (TSC)
+//  point stencil at fractional cell-centered index x, keeping stencil within [0,n-1].
+//  Used both to interpolate cell data to particles, and to deposit particles to cells.
+
+KOKKOS_INLINE_FUNCTION
+void InterpWeights(const Real x, const int n, const int npts, int &i0, Real w[3]) {
+  if (npts == 3) {
+    int ic = static_cast<int>(std::floor(x + 0.5));
+    ic = (ic < 1)? 1 : ((ic > n-2)? n-2 : ic);
+    Real d = x - ic;
+    w[0] = 0.5*SQR(0.5 - d);
+    w[1] = 0.75 - SQR(d);
+    w[2] = 0.5*SQR(0.5 + d);
+    i0 = ic - 1;
+  } else if (npts == 2) {
+    i0 = static_cast<int>(std::floor(x));
+    i0 = (i0 < 0)? 0 : ((i0 > n-2)? n-2 : i0);
+    Real d = x - i0;
+    w[0] = 1.0 - d;
+    w[1] = d;
+    w[2] = 0.0;
+  } else {
+    i0 = static_cast<int>(std::floor(x + 0.5));
+    i0 = (i0 < 0)? 0 : ((i0 > n-1)? n-1 : i0);
+    w[0] = 1.0;
+    w[1] = 0.0;
+    w[2] = 0.0;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \struct ParticleAttribute
+//  \brief Attribute of particles, registered with Particles::AddAttribute().  Each is
+//  stored contiguously for all particles in row 'index' of prtcl_rdata (Real) or
+//  prtcl_idata (int).  Only attributes with migrate=true are communicated when particles
+//  move between ranks, and only those with output=true are written in particle outputs.
+
+struct ParticleAttribute {
+  std::string name;
+  bool is_real;
+  int index;
+  bool migrate;
+  bool output;
+};
+
 //----------------------------------------------------------------------------------------
 //! \class Particles
 
@@ -54,7 +115,13 @@ class Particles {
   // data
   ParticleType particle_type;
   int nprtcl_thispack;             // number of particles this MeshBlockPack
+  // particle arrays are allocated with capacity prtcl_rdata.extent(1) >= nprtcl_thispack
   int nrdata, nidata;
+  // registry of attributes (first entries are fixed by ParticlesIndex), and indices of
+  // Real and int attributes communicated when particles migrate
+  std::vector<ParticleAttribute> attributes;
+  DualArray1D<int> rmigrate, imigrate;
+  int nrmigrate=0, nimigrate=0;
 //  DvceArray1D<int>  prtcl_gid;     // GID of MeshBlock containing each par
 //  DvceArray2D<Real> prtcl_pos;     // positions
 //  DvceArray2D<Real> prtcl_vel;     // velocities
@@ -62,7 +129,20 @@ class Particles {
   DvceArray2D<int>  prtcl_idata;   // integer properties each particle (gid, tag, etc.)
   Real dtnew;
 
+  // particles are sorted by (MeshBlock, cell) every sort_interval cycles (0 = never)
+  int sort_interval;
+  DvceArray1D<int> cell_offsets;   // index of first particle in each cell after sort
+  bool sorted=false;               // true if cell_offsets valid (not pushed since sort)
+  int deposit_npts;                // points of deposit stencil: 1=NGP, 2=CIC, 3=TSC
+
   ParticlesPusher pusher;
+  // parameters of boris pusher: charge-to-mass ratio, speed of light, fraction of gyro
+  // period per sub-step, max number of sub-steps, and TSC (else trilinear) interpolation
+  Real q_over_m, speed_of_light, gyro_cfl;
+  int max_subcycles;
+  bool tsc_interp;
+  // seed of counter-based random numbers for lagrangian_mc tracers
+  std::uint64_t rng_seed;
 
   // Boundary communication buffers and functions for particles
   ParticlesBoundaryValues *pbval_part;
@@ -72,6 +152,11 @@ class Particles {
 
   // functions...
   void CreateParticleTags(ParameterInput *pin);
+  void ReserveParticles(const int n);
+  int AddAttribute(const std::string &name, const bool is_real, const bool migrate=true,
+                   const bool output=true);
+  int AttributeIndex(const std::string &name) const;
+  void ParticlesEachMB(std::vector<float> &nprtcl);
   void AssembleTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
   TaskStatus Push(Driver *pdriver, int stage);
   TaskStatus NewGID(Driver *pdriver, int stage);
@@ -81,9 +166,14 @@ class Particles {
   TaskStatus RecvP(Driver *pdriver, int stage);
   TaskStatus ClearSend(Driver *pdriver, int stage);
   TaskStatus ClearRecv(Driver *pdriver, int stage);
+  TaskStatus Sort(Driver *pdriver, int stage);
+  void SortParticles();
+  void DepositToMesh(DvceArray5D<Real> &dep);
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Particles
+  DvceArray1D<int> prtcl_key;      // index of cell containing each particle
+  DvceArray1D<int> cell_count;     // number of particles in each cell
 };
 
 } // namespace particles
@@ -0,0 +1,170 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file particles_deposit.cpp
+//! \brief Deposits particles to cell-centered arrays with NGP, CIC, or TSC shapes (set by
+//! <particles>/deposit).  When particles are sorted by cell, each team deposits the
+//! particles of one row of cells into a tile in team scratch memory, which is then added
+//! to the mesh array, so most atomic updates are in fast memory and free of contention.
+
+#include <iostream>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "bvals/bvals.hpp"
+#include "particles.hpp"
+
+// maximum size of tile in team scratch memory
+#define DEPOSIT_MAX_SCRATCH_BYTES 32768
+
+namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn void Particles::DepositToMesh
+//! \brief Deposits particles into dep(m,v,k,j,i), whose number of variables selects the
+//! quantities: v=0 number density, v=1-3 flux density n*v (current/charge), and v=4-6
+//! n*u with u=gamma*v (momentum/mass, gamma=1 unless pusher=boris).  Deposits into ghost
+//! zones are then added to the active cells of neighboring MeshBlocks, so only active
+//! cells of dep are valid.
+
+void Particles::DepositToMesh(DvceArray5D<Real> &dep) {
+  int nvar = dep.extent_int(1);
+  if (nvar != 1 && nvar != 4 && nvar != 7) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Particle deposit array must have 1, 4, or 7 variables"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  int ng = indcs.ng;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  int n1 = nx1 + 2*ng;
+  int n2 = (multi_d)? (nx2 + 2*ng) : 1;
+  int n3 = (three_d)? (nx3 + 2*ng) : 1;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  int gids = pmy_pack->gids;
+  int nmb = pmy_pack->nmb_thispack;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+  int npts = deposit_npts;
+  // with boris pusher velocities are stored as u=gamma*v, and always have 3 components
+  bool four_vel = (pusher == ParticlesPusher::boris);
+  bool has_vz = (three_d || four_vel);
+  Real c_ = (four_vel)? speed_of_light : 1.0;
+
+  Kokkos::deep_copy(TaskExecSpace(), dep, 0.0);
+
+  // deposit of particle p, either into tile (with origin at cell (tk,tj,0), dimensions
+  // (nvar,ntk,ntj,n1)) or, if stencil is outside tile, directly into dep.
+  auto deposit = KOKKOS_LAMBDA(const int p, ScrArray1D<Real> &tile, const bool use_tile,
+                               const int tk, const int tj, const int ntk, const int ntj) {
+    int m = pi(PGID,p) - gids;
+    int i0, j0 = 0, k0 = 0;
+    Real wx[3], wy[3] = {1.0, 0.0, 0.0}, wz[3] = {1.0, 0.0, 0.0};
+    InterpWeights((pr(IPX,p) - mbsize.d_view(m).x1min)/mbsize.d_view(m).dx1 - 0.5 + is,
+                  n1, npts, i0, wx);
+    if (multi_d) {
+      InterpWeights((pr(IPY,p) - mbsize.d_view(m).x2min)/mbsize.d_view(m).dx2 - 0.5 + js,
+                    n2, npts, j0, wy);
+    }
+    if (three_d) {
+      InterpWeights((pr(IPZ,p) - mbsize.d_view(m).x3min)/mbsize.d_view(m).dx3 - 0.5 + ks,
+                    n3, npts, k0, wz);
+    }
+    Real ovol = 1.0/(mbsize.d_view(m).dx1*mbsize.d_view(m).dx2*mbsize.d_view(m).dx3);
+    Real val[7];
+    val[0] = ovol;
+    if (nvar > 1) {
+      Real u[3] = {pr(IPVX,p), pr(IPVY,p), (has_vz)? pr(IPVZ,p) : 0.0};
+      Real gam = 1.0;
+      if (four_vel) {
+        gam = std::sqrt(1.0 + (SQR(u[0]) + SQR(u[1]) + SQR(u[2]))/SQR(c_));
+      }
+      for (int d=0; d<3; ++d) {
+        val[1+d] = ovol*u[d]/gam;
+        // for non-relativistic pushers u=v
+        if (nvar > 4) {val[4+d] = ovol*u[d];}
+      }
+    }
+    bool in_tile = use_tile && (k0 >= tk) && (k0 + ((three_d)? npts : 1) <= tk + ntk) &&
+                   (j0 >= tj) && (j0 + ((multi_d)? npts : 1) <= tj + ntj);
+    for (int kk=0; kk<((three_d)? npts : 1); ++kk) {
+      for (int jj=0; jj<((multi_d)? npts : 1); ++jj) {
+        for (int ii=0; ii<npts; ++ii) {
+          Real w = wx[ii]*wy[jj]*wz[kk];
+          int k = k0+kk, j = j0+jj, i = i0+ii;
+          for (int v=0; v<nvar; ++v) {
+            if (in_tile) {
+              Kokkos::atomic_add(&tile(((v*ntk + k - tk)*ntj + j - tj)*n1 + i), w*val[v]);
+            } else {
+              Kokkos::atomic_add(&dep(m,v,k,j,i), w*val[v]);
+            }
+          }
+        }
+      }
+    }
+  };
+
+  int ntk = (three_d)? 3 : 1;
+  int ntj = (multi_d)? 3 : 1;
+  int ntile = nvar*ntk*ntj*n1;
+  if (sorted && ntile*sizeof(Real) <= DEPOSIT_MAX_SCRATCH_BYTES) {
+    // one team per (m,k,j) row of active cells, whose particles are contiguous
+    auto &offsets = cell_offsets;
+    size_t scr_size = ScrArray1D<Real>::shmem_size(ntile);
+    int scr_level = 0;
+    par_for_outer("prtcl_deposit_tile", DevExeSpace(), scr_size, scr_level,
+                  0, nmb-1, 0, nx3-1, 0, nx2-1,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int kr, const int jr) {
+      ScrArray1D<Real> tile(member.team_scratch(scr_level), ntile);
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, ntile), [&](const int n) {
+        tile(n) = 0.0;
+      });
+      member.team_barrier();
+
+      int tk = (three_d)? kr + ks - 1 : 0;
+      int tj = (multi_d)? jr + js - 1 : 0;
+      int key0 = ((m*nx3 + kr)*nx2 + jr)*nx1;
+      int pbeg = offsets(key0), pend = offsets(key0 + nx1);
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, pbeg, pend),
+      [&](const int p) {
+        deposit(p, tile, true, tk, tj, ntk, ntj);
+      });
+      member.team_barrier();
+
+      // add tile to mesh array
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, ntile), [&](const int n) {
+        if (tile(n) != 0.0) {
+          int i = n % n1;
+          int j = (n/n1) % ntj;
+          int k = (n/(n1*ntj)) % ntk;
+          int v = n/(n1*ntj*ntk);
+          Kokkos::atomic_add(&dep(m,v,tk+k,tj+j,i), tile(n));
+        }
+      });
+    });
+  } else {
+    // particles in arbitrary order, deposit directly into mesh array
+    par_for("prtcl_deposit", DevExeSpace(), 0, (nprtcl_thispack-1),
+    KOKKOS_LAMBDA(const int p) {
+      ScrArray1D<Real> tile;
+      deposit(p, tile, false, 0, 0, ntk, ntj);
+    });
+  }
+
+  // add deposits in ghost zones to neighboring MeshBlocks
+  if (pmy_pack->phydro != nullptr) {
+    pmy_pack->phydro->pbval_u->SumGhostsCC(dep);
+  } else if (pmy_pack->pmhd != nullptr) {
+    pmy_pack->pmhd->pbval_u->SumGhostsCC(dep);
+  }
+  return;
+}
+} // namespace particles
@@ -4,11 +4,25 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file particle_pushers.cpp
-//  \brief
+//  \brief particle pushers.  For the boris pusher, (IPVX,IPVY,IPVZ) store the spatial
+//  components of the four-velocity u = gamma*v, and the electric field is the ideal MHD
+//  field E = -v_fluid x B.  lagrangian_tracer particles move with the fluid velocity
+//  interpolated to their position (midpoint method).  lagrangian_mc tracers hop by
+//  one cell width to a neighboring cell with probability equal to the fraction of the
+//  mass in the cell leaving through that face, computed from the mass fluxes in uflx.
+//  These are the fluxes of the last stage of the previous step (they are not recomputed),
+//  so hops are consistent with the mass fluxes of the update to within the weights of
+//  the integrator stages.
+
+#include <cmath>
+#include <cstdint>
 
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "utils/random.hpp"
 #include "particles.hpp"
 
 namespace particles {
@@ -17,6 +31,7 @@ namespace particles {
 //  \brief
 
 TaskStatus Particles::Push(Driver *pdriver, int stage) {
+  sorted = false;  // particles move, so cell_offsets no longer valid
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is;
   int js = indcs.js;
@@ -50,6 +65,203 @@ TaskStatus Particles::Push(Driver *pdriver, int stage) {
       });
 
     break;
+
+    // tracers moving with interpolated fluid velocity
+    case ParticlesPusher::lagrangian_tracer:
+      {
+      auto &w0_ = (pmy_pack->phydro != nullptr)? pmy_pack->phydro->w0 :
+                                                 pmy_pack->pmhd->w0;
+      int ng = indcs.ng;
+      int n1 = indcs.nx1 + 2*ng;
+      int n2 = (multi_d)? (indcs.nx2 + 2*ng) : 1;
+      int n3 = (three_d)? (indcs.nx3 + 2*ng) : 1;
+      bool tsc = tsc_interp;
+      int nst = (tsc)? 3 : 2;
+      par_for("part_tracer",DevExeSpace(),0,(nprtcl_thispack-1),
+      KOKKOS_LAMBDA(const int p) {
+        int m = pi(PGID,p) - gids;
+        Real x0[3] = {pr(IPX,p), (multi_d)? pr(IPY,p) : 0.0, (three_d)? pr(IPZ,p) : 0.0};
+        Real x[3] = {x0[0], x0[1], x0[2]};
+        // midpoint method: velocity at x0 gives x at dt/2, velocity there gives x at dt
+        for (int s=0; s<2; ++s) {
+          int i0, j0 = 0, k0 = 0;
+          Real wx[3], wy[3] = {1.0, 0.0, 0.0}, wz[3] = {1.0, 0.0, 0.0};
+          InterpWeights((x[0] - mbsize.d_view(m).x1min)/mbsize.d_view(m).dx1 - 0.5 + is,
+                        n1, nst, i0, wx);
+          if (multi_d) {
+            InterpWeights((x[1] - mbsize.d_view(m).x2min)/mbsize.d_view(m).dx2 - 0.5 + js,
+                          n2, nst, j0, wy);
+          }
+          if (three_d) {
+            InterpWeights((x[2] - mbsize.d_view(m).x3min)/mbsize.d_view(m).dx3 - 0.5 + ks,
+                          n3, nst, k0, wz);
+          }
+          Real v[3] = {0.0, 0.0, 0.0};
+          for (int kk=0; kk<((three_d)? nst : 1); ++kk) {
+            for (int jj=0; jj<((multi_d)? nst : 1); ++jj) {
+              for (int ii=0; ii<nst; ++ii) {
+                Real w = wx[ii]*wy[jj]*wz[kk];
+                v[0] += w*w0_(m,IVX,k0+kk,j0+jj,i0+ii);
+                v[1] += w*w0_(m,IVY,k0+kk,j0+jj,i0+ii);
+                v[2] += w*w0_(m,IVZ,k0+kk,j0+jj,i0+ii);
+              }
+            }
+          }
+          Real h = (s == 0)? 0.5*dt_ : dt_;
+          for (int d=0; d<3; ++d) {x[d] = x0[d] + h*v[d];}
+        }
+        pr(IPX,p) = x[0];
+        if (multi_d) {pr(IPY,p) = x[1];}
+        if (three_d) {pr(IPZ,p) = x[2];}
+      });
+      }
+    break;
+
+    // Monte Carlo tracers hopping between cells according to the mass fluxes
+    case ParticlesPusher::lagrangian_mc:
+      {
+      bool is_hydro = (pmy_pack->phydro != nullptr);
+      auto &u0_ = (is_hydro)? pmy_pack->phydro->u0 : pmy_pack->pmhd->u0;
+      auto &flx1 = (is_hydro)? pmy_pack->phydro->uflx.x1f : pmy_pack->pmhd->uflx.x1f;
+      auto &flx2 = (is_hydro)? pmy_pack->phydro->uflx.x2f : pmy_pack->pmhd->uflx.x2f;
+      auto &flx3 = (is_hydro)? pmy_pack->phydro->uflx.x3f : pmy_pack->pmhd->uflx.x3f;
+      // random number of each tracer depends only on (seed, cycle, tag), so that tracers
+      // follow the same paths independent of the number of ranks or order of threads
+      std::uint64_t seed = rng_seed;
+      std::uint32_t cycle = static_cast<std::uint32_t>(pmy_pack->pmesh->ncycle);
+      par_for("part_mc",DevExeSpace(),0,(nprtcl_thispack-1),
+      KOKKOS_LAMBDA(const int p) {
+        int m = pi(PGID,p) - gids;
+        Real dx[3] = {mbsize.d_view(m).dx1, mbsize.d_view(m).dx2, mbsize.d_view(m).dx3};
+        int i = static_cast<int>((pr(IPX,p) - mbsize.d_view(m).x1min)/dx[0]) + is;
+        int j = (multi_d)?
+                static_cast<int>((pr(IPY,p) - mbsize.d_view(m).x2min)/dx[1]) + js : js;
+        int k = (three_d)?
+                static_cast<int>((pr(IPZ,p) - mbsize.d_view(m).x3min)/dx[2]) + ks : ks;
+
+        // mass leaving cell through each face over dt, as fraction of mass in cell
+        Real mass = u0_(m,IDN,k,j,i)*dx[0]*dx[1]*dx[2];
+        Real a1 = dt_*dx[1]*dx[2]/mass;
+        Real a2 = dt_*dx[0]*dx[2]/mass;
+        Real a3 = dt_*dx[0]*dx[1]/mass;
+        Real prob[6] = {fmax(-a1*flx1(m,IDN,k,j,i  ), 0.0),
+                        fmax( a1*flx1(m,IDN,k,j,i+1), 0.0), 0.0, 0.0, 0.0, 0.0};
+        if (multi_d) {
+          prob[2] = fmax(-a2*flx2(m,IDN,k,j  ,i), 0.0);
+          prob[3] = fmax( a2*flx2(m,IDN,k,j+1,i), 0.0);
+        }
+        if (three_d) {
+          prob[4] = fmax(-a3*flx3(m,IDN,k  ,j,i), 0.0);
+          prob[5] = fmax( a3*flx3(m,IDN,k+1,j,i), 0.0);
+        }
+
+        Real r = RanCounter(seed, cycle, static_cast<std::uint64_t>(pi(PTAG,p)), 0);
+
+        // select face (if any), and move tracer into neighboring cell
+        Real cum = 0.0;
+        for (int f=0; f<6; ++f) {
+          cum += prob[f];
+          if (r < cum) {
+            int dir = f/2;
+            Real shift = (f % 2 == 0)? -dx[dir] : dx[dir];
+            int idx = (dir == 0)? IPX : ((dir == 1)? IPY : IPZ);
+            pr(idx,p) += shift;
+            break;
+          }
+        }
+      });
+      }
+    break;
+
+    // relativistic Boris push, with E and B gathered at the particle position in the same
+    // kernel, and sub-cycling so each sub-step resolves the gyro-period
+    case ParticlesPusher::boris:
+      {
+      auto &w0_ = pmy_pack->pmhd->w0;
+      auto &bcc_ = pmy_pack->pmhd->bcc0;
+      int ng = indcs.ng;
+      int n1 = indcs.nx1 + 2*ng;
+      int n2 = (multi_d)? (indcs.nx2 + 2*ng) : 1;
+      int n3 = (three_d)? (indcs.nx3 + 2*ng) : 1;
+      Real qm = q_over_m;
+      Real c_ = speed_of_light;
+      Real gyro_cfl_ = gyro_cfl;
+      int max_sub = max_subcycles;
+      bool tsc = tsc_interp;
+      int nst = (tsc)? 3 : 2;
+      par_for("part_boris",DevExeSpace(),0,(nprtcl_thispack-1),
+      KOKKOS_LAMBDA(const int p) {
+        int m = pi(PGID,p) - gids;
+        Real x1min = mbsize.d_view(m).x1min, dx1 = mbsize.d_view(m).dx1;
+        Real x2min = mbsize.d_view(m).x2min, dx2 = mbsize.d_view(m).dx2;
+        Real x3min = mbsize.d_view(m).x3min, dx3 = mbsize.d_view(m).dx3;
+        Real u[3] = {pr(IPVX,p), pr(IPVY,p), pr(IPVZ,p)};
+        int nsub = 1;
+        for (int s=0; s<nsub; ++s) {
+          // gather B and fluid velocity
+          int i0, j0 = 0, k0 = 0;
+          Real wx[3], wy[3] = {1.0, 0.0, 0.0}, wz[3] = {1.0, 0.0, 0.0};
+          InterpWeights((pr(IPX,p) - x1min)/dx1 - 0.5 + is, n1, nst, i0, wx);
+          if (multi_d) {
+            InterpWeights((pr(IPY,p) - x2min)/dx2 - 0.5 + js, n2, nst, j0, wy);
+          }
+          if (three_d) {
+            InterpWeights((pr(IPZ,p) - x3min)/dx3 - 0.5 + ks, n3, nst, k0, wz);
+          }
+          Real b[3] = {0.0, 0.0, 0.0}, v[3] = {0.0, 0.0, 0.0};
+          for (int kk=0; kk<((three_d)? nst : 1); ++kk) {
+            for (int jj=0; jj<((multi_d)? nst : 1); ++jj) {
+              for (int ii=0; ii<nst; ++ii) {
+                Real w = wx[ii]*wy[jj]*wz[kk];
+                int k = k0+kk, j = j0+jj, i = i0+ii;
+                b[0] += w*bcc_(m,IBX,k,j,i);
+                b[1] += w*bcc_(m,IBY,k,j,i);
+                b[2] += w*bcc_(m,IBZ,k,j,i);
+                v[0] += w*w0_(m,IVX,k,j,i);
+                v[1] += w*w0_(m,IVY,k,j,i);
+                v[2] += w*w0_(m,IVZ,k,j,i);
+              }
+            }
+          }
+          Real e[3] = {-(v[1]*b[2] - v[2]*b[1]),
+                       -(v[2]*b[0] - v[0]*b[2]),
+                       -(v[0]*b[1] - v[1]*b[0])};
+
+          // number of sub-steps set at first sub-step from gyro-frequency qB/(gamma m)
+          Real gam = std::sqrt(1.0 + (SQR(u[0]) + SQR(u[1]) + SQR(u[2]))/SQR(c_));
+          if (s == 0) {
+            Real omega = std::abs(qm)*std::sqrt(SQR(b[0]) + SQR(b[1]) + SQR(b[2]))/gam;
+            Real nreq = std::ceil(dt_*omega/(2.0*M_PI*gyro_cfl_));
+            nsub = (nreq < 1.0)? 1 : ((nreq > max_sub)? max_sub : static_cast<int>(nreq));
+          }
+          Real h = dt_/static_cast<Real>(nsub);
+
+          // half electric kick, magnetic rotation, half electric kick
+          for (int d=0; d<3; ++d) {u[d] += 0.5*h*qm*e[d];}
+          gam = std::sqrt(1.0 + (SQR(u[0]) + SQR(u[1]) + SQR(u[2]))/SQR(c_));
+          Real t[3];
+          for (int d=0; d<3; ++d) {t[d] = 0.5*h*qm*b[d]/gam;}
+          Real fac = 2.0/(1.0 + SQR(t[0]) + SQR(t[1]) + SQR(t[2]));
+          Real up[3] = {u[0] + (u[1]*t[2] - u[2]*t[1]),
+                        u[1] + (u[2]*t[0] - u[0]*t[2]),
+                        u[2] + (u[0]*t[1] - u[1]*t[0])};
+          u[0] += fac*(up[1]*t[2] - up[2]*t[1]);
+          u[1] += fac*(up[2]*t[0] - up[0]*t[2]);
+          u[2] += fac*(up[0]*t[1] - up[1]*t[0]);
+          for (int d=0; d<3; ++d) {u[d] += 0.5*h*qm*e[d];}
+
+          // drift
+          gam = std::sqrt(1.0 + (SQR(u[0]) + SQR(u[1]) + SQR(u[2]))/SQR(c_));
+          pr(IPX,p) += h*u[0]/gam;
+          if (multi_d) {pr(IPY,p) += h*u[1]/gam;}
+          if (three_d) {pr(IPZ,p) += h*u[2]/gam;}
+        }
+        pr(IPVX,p) = u[0];
+        pr(IPVY,p) = u[1];
+        pr(IPVZ,p) = u[2];
+      });
+      }
+    break;
   default:
     break;
   }
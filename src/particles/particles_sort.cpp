@@ -0,0 +1,117 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file particles_sort.cpp
+//! \brief Reorders particles by the (MeshBlock, cell) containing them, using a counting
+//! sort on the device.  After sorting, particles in the same cell are contiguous, so
+//! gathers from and deposits to cell data are coalesced, and cell_offsets gives the range
+//! of particles in each cell.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "particles.hpp"
+
+namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Particles::Sort
+//! \brief Wrapper task list function to sort particles every sort_interval cycles
+
+TaskStatus Particles::Sort(Driver *pdrive, int stage) {
+  if (sort_interval > 0 && (pmy_pack->pmesh->ncycle % sort_interval) == 0) {
+    SortParticles();
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Particles::SortParticles
+//! \brief Computes key (index of cell, ordered by m,k,j,i) of each particle, counts
+//! particles per cell, sets cell_offsets with an exclusive scan of the counts, and moves
+//! each particle to its slot in new arrays.  Order of particles within a cell is not
+//! preserved.  cell_offsets(n) is the index of the first particle in cell n, and is valid
+//! until the particles are pushed again.
+
+void Particles::SortParticles() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  int gids = pmy_pack->gids;
+  int nmb = pmy_pack->nmb_thispack;
+  int nkeys = nmb*nx3*nx2*nx1;
+  int npart = nprtcl_thispack;
+
+  if (cell_offsets.extent_int(0) != nkeys + 1) {
+    Kokkos::realloc(cell_offsets, nkeys + 1);
+    Kokkos::realloc(cell_count, nkeys);
+  }
+  if (prtcl_key.extent_int(0) < npart) {
+    Kokkos::realloc(prtcl_key, npart);
+  }
+  Kokkos::deep_copy(TaskExecSpace(), cell_count, 0);
+
+  // compute key of each particle, and count particles in each cell
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+  auto &keys = prtcl_key;
+  auto &count = cell_count;
+  par_for("prtcl_key",DevExeSpace(),0,(npart-1),
+  KOKKOS_LAMBDA(const int p) {
+    int m = pi(PGID,p) - gids;
+    int ip = (pr(IPX,p) - mbsize.d_view(m).x1min)/mbsize.d_view(m).dx1;
+    ip = (ip < 0)? 0 : ((ip >= nx1)? nx1-1 : ip);
+    int jp = 0, kp = 0;
+    if (multi_d) {
+      jp = (pr(IPY,p) - mbsize.d_view(m).x2min)/mbsize.d_view(m).dx2;
+      jp = (jp < 0)? 0 : ((jp >= nx2)? nx2-1 : jp);
+    }
+    if (three_d) {
+      kp = (pr(IPZ,p) - mbsize.d_view(m).x3min)/mbsize.d_view(m).dx3;
+      kp = (kp < 0)? 0 : ((kp >= nx3)? nx3-1 : kp);
+    }
+    int key = ((m*nx3 + kp)*nx2 + jp)*nx1 + ip;
+    keys(p) = key;
+    Kokkos::atomic_add(&count(key), 1);
+  });
+
+  // exclusive scan of counts gives index of first particle in each cell
+  auto &offsets = cell_offsets;
+  Kokkos::parallel_scan("prtcl_offsets", Kokkos::RangePolicy<>(TaskExecSpace(), 0, nkeys),
+  KOKKOS_LAMBDA(const int n, int &partial_sum, const bool is_final) {
+    if (is_final) {
+      offsets(n) = partial_sum;
+    }
+    partial_sum += count(n);
+    if (is_final && n == nkeys-1) {
+      offsets(nkeys) = partial_sum;
+    }
+  });
+  Kokkos::deep_copy(TaskExecSpace(), cell_count, 0);
+
+  // move each particle into the next free slot of its cell
+  DvceArray2D<Real> new_rdata("prtcl_rdata", nrdata, prtcl_rdata.extent_int(1));
+  DvceArray2D<int> new_idata("prtcl_idata", nidata, prtcl_idata.extent_int(1));
+  int nrdata_ = nrdata, nidata_ = nidata;
+  par_for("prtcl_sort",DevExeSpace(),0,(npart-1),
+  KOKKOS_LAMBDA(const int p) {
+    int key = keys(p);
+    int newp = offsets(key) + Kokkos::atomic_fetch_add(&count(key), 1);
+    for (int n=0; n<nrdata_; ++n) {
+      new_rdata(n,newp) = pr(n,p);
+    }
+    for (int n=0; n<nidata_; ++n) {
+      new_idata(n,newp) = pi(n,p);
+    }
+  });
+  prtcl_rdata = new_rdata;
+  prtcl_idata = new_idata;
+  sorted = true;
+  return;
+}
+} // namespace particles
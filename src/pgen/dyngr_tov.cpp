@@ -755,6 +755,9 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
       case 4: pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
               pmbp->pz4c->ADMConstraints<4>(pmbp);
               break;
+      case 5: pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+              pmbp->pz4c->ADMConstraints<5>(pmbp);
+              break;
     }
   }
 
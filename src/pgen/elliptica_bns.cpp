@@ -14,6 +14,7 @@
 #include <limits>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "coordinates/adm.hpp"
@@ -27,6 +28,7 @@
 #include "mesh/mesh.hpp"
 #include "mhd/mhd.hpp"
 #include "parameter_input.hpp"
+#include "utils/id_sample_grid.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
 
@@ -79,71 +81,80 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
     "adm_gxx,adm_gxy,adm_gxz,adm_gyy,adm_gyz,adm_gzz,"
     "adm_Kxx,adm_Kxy,adm_Kxz,adm_Kyy,adm_Kyz,adm_Kzz,"
     "grhd_rho,grhd_p,grhd_vx,grhd_vy,grhd_vz";
+  const int nfields = 21;
 
   int ncells1 = indcs.nx1 + 2 * (indcs.ng);
   int ncells2 = indcs.nx2 + 2 * (indcs.ng);
   int ncells3 = indcs.nx3 + 2 * (indcs.ng);
   int nmb     = pmbp->nmb_thispack;
 
-  int width = nmb * ncells1 * ncells2 * ncells3;
-
-  Real *x_coords = new Real[width];
-  Real *y_coords = new Real[width];
-  Real *z_coords = new Real[width];
-
-  std::cout << "Allocated coordinates of size " << width << std::endl;
-
-  // Populate coordinates for Elliptica
-  // TODO(JMF): Replace with a Kokkos loop on
-  // Kokkos::DefaultHostExecutionSpace() to improve performance.
-  int idx = 0;
-  for (int m = 0; m < nmb; m++) {
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    int nx1     = indcs.nx1;
-
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    int nx2     = indcs.nx2;
-
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
-    int nx3     = indcs.nx3;
-
-    for (int k = 0; k < ncells3; k++) {
-      Real z = CellCenterX(k - ks, nx3, x3min, x3max);
-      for (int j = 0; j < ncells2; j++) {
-        Real y = CellCenterX(j - js, nx2, x2min, x2max);
-        for (int i = 0; i < ncells1; i++) {
-          Real x = CellCenterX(i - is, nx1, x1min, x1max);
-
-          x_coords[idx] = x;
-          y_coords[idx] = y;
-          z_coords[idx] = z;
+  idr->set_param("ADM_B1I_form", "zero", idr);
 
-          // Increment flat index
-          idx++;
+  // Pointers to the Elliptica fields at all cells (with flat index over m,k,j,i), either
+  // computed directly by Elliptica, or interpolated from a coarse sample grid on which
+  // Elliptica is evaluated in parallel over ranks (with <problem>/id_sample = true)
+  std::vector<const Real *> src(nfields);
+  HostArray5D<Real> id_h;
+  if (pin->GetOrAddBoolean("problem", "id_sample", false)) {
+    IDSampleGrid grid(pmbp, pin, "problem", nfields);
+    grid.Sample([&](int npts, const Real *x, const Real *y, const Real *z, Real *vals) {
+      std::vector<Real> xs(x, x + npts), ys(y, y + npts), zs(z, z + npts);
+      idr->npoints  = npts;
+      idr->x_coords = xs.data();
+      idr->y_coords = ys.data();
+      idr->z_coords = zs.data();
+      elliptica_id_reader_interpolate(idr);
+      for (int n = 0; n < nfields; n++) {
+        for (int p = 0; p < npts; p++) {
+          vals[n*npts + p] = idr->field[n][p];
         }
       }
+    });
+    DvceArray5D<Real> id("id_elliptica", nfields, nmb, ncells3, ncells2, ncells1);
+    grid.InterpolateToMesh(id);
+    id_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), id);
+    for (int n = 0; n < nfields; n++) {
+      src[n] = &(id_h(n, 0, 0, 0, 0));
     }
-  }
-
-  idr->set_param("ADM_B1I_form", "zero", idr);
-
-  // Interpolate the data
-  idr->npoints  = width;
-  idr->x_coords = x_coords;
-  idr->y_coords = y_coords;
-  idr->z_coords = z_coords;
-  std::cout << "Coordinates assigned." << std::endl;
-  elliptica_id_reader_interpolate(idr);
-
-  // Free the coordinates, since we'll no longer need them.
-  delete[] x_coords;
-  delete[] y_coords;
-  delete[] z_coords;
+    std::cout << "Sampled data interpolated." << std::endl;
+  } else {
+    int width = nmb * ncells1 * ncells2 * ncells3;
+
+    Real *x_coords = new Real[width];
+    Real *y_coords = new Real[width];
+    Real *z_coords = new Real[width];
+
+    std::cout << "Allocated coordinates of size " << width << std::endl;
+
+    // Populate coordinates for Elliptica, using threads on the host
+    auto &size_h = size.h_view;
+    par_for_host("pgen_elliptica_coords", 0, nmb-1, 0, ncells3-1, 0, ncells2-1,
+                 0, ncells1-1,
+    [&](const int m, const int k, const int j, const int i) {
+      int idx = ((m*ncells3 + k)*ncells2 + j)*ncells1 + i;
+      x_coords[idx] = CellCenterX(i - is, indcs.nx1, size_h(m).x1min, size_h(m).x1max);
+      y_coords[idx] = CellCenterX(j - js, indcs.nx2, size_h(m).x2min, size_h(m).x2max);
+      z_coords[idx] = CellCenterX(k - ks, indcs.nx3, size_h(m).x3min, size_h(m).x3max);
+    });
 
-  std::cout << "Coordinates freed." << std::endl;
+    // Interpolate the data
+    idr->npoints  = width;
+    idr->x_coords = x_coords;
+    idr->y_coords = y_coords;
+    idr->z_coords = z_coords;
+    std::cout << "Coordinates assigned." << std::endl;
+    elliptica_id_reader_interpolate(idr);
+
+    // Free the coordinates, since we'll no longer need them.
+    delete[] x_coords;
+    delete[] y_coords;
+    delete[] z_coords;
+
+    std::cout << "Coordinates freed." << std::endl;
+    for (int n = 0; n < nfields; n++) {
+      src[n] = idr->field[n];
+    }
+  }
 
   // Capture variables for kernel; note that when Z4c is enabled, the gauge
   // variables are part of the Z4c class.
@@ -199,66 +210,58 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   std::cout << "Label indices saved." << std::endl;
 
-  // TODO(JMF): Replace with a Kokkos loop on
-  // Kokkos::DefaultHostExecutionSpace() to improve performance.
-  idx = 0;
-  for (int m = 0; m < nmb; m++) {
-    for (int k = 0; k < ncells3; k++) {
-      for (int j = 0; j < ncells2; j++) {
-        for (int i = 0; i < ncells1; i++) {
-          // Extract metric quantities
-          host_adm.alpha(m, k, j, i)     = idr->field[i_alpha][idx];
-          host_adm.beta_u(m, 0, k, j, i) = idr->field[i_betax][idx];
-          host_adm.beta_u(m, 1, k, j, i) = idr->field[i_betay][idx];
-          host_adm.beta_u(m, 2, k, j, i) = idr->field[i_betaz][idx];
-
-          Real g3d[NSPMETRIC];
-          host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = idr->field[i_gxx][idx];
-          host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = idr->field[i_gxy][idx];
-          host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = idr->field[i_gxz][idx];
-          host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = idr->field[i_gyy][idx];
-          host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = idr->field[i_gyz][idx];
-          host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = idr->field[i_gzz][idx];
-
-          host_adm.vK_dd(m, 0, 0, k, j, i) = idr->field[i_Kxx][idx];
-          host_adm.vK_dd(m, 0, 1, k, j, i) = idr->field[i_Kxy][idx];
-          host_adm.vK_dd(m, 0, 2, k, j, i) = idr->field[i_Kxz][idx];
-          host_adm.vK_dd(m, 1, 1, k, j, i) = idr->field[i_Kyy][idx];
-          host_adm.vK_dd(m, 1, 2, k, j, i) = idr->field[i_Kyz][idx];
-          host_adm.vK_dd(m, 2, 2, k, j, i) = idr->field[i_Kzz][idx];
-
-          // Extract hydro quantities
-          host_w0(m, IDN, k, j, i) = idr->field[i_rho][idx];
-          host_w0(m, IPR, k, j, i) = idr->field[i_p][idx];
-          Real vu[3]               = {
-            idr->field[i_vx][idx], idr->field[i_vy][idx],
-            idr->field[i_vz][idx]};
-
-          // Before we store the velocity, we need to make sure it's physical
-          // and calculate the Lorentz factor. If the velocity is superluminal,
-          // we make a last-ditch attempt to salvage the solution by rescaling
-          // it to vsq = 1.0 - 1e-15
-          Real vsq = Primitive::SquareVector(vu, g3d);
-          if (1.0 - vsq <= 0) {
-            std::cout << "The velocity is superluminal!" << std::endl
-                      << "Attempting to adjust..." << std::endl;
-            Real fac = sqrt((1.0 - 1e-15) / vsq);
-            vu[0] *= fac;
-            vu[1] *= fac;
-            vu[2] *= fac;
-            vsq = 1.0 - 1.0e-15;
-          }
-          Real W = sqrt(1.0 / (1.0 - vsq));
-
-          host_w0(m, IVX, k, j, i) = W * vu[0];
-          host_w0(m, IVY, k, j, i) = W * vu[1];
-          host_w0(m, IVZ, k, j, i) = W * vu[2];
-
-          idx++;
-        }
-      }
+  // Fill host mirrors, using threads on the host
+  par_for_host("pgen_elliptica", 0, nmb-1, 0, ncells3-1, 0, ncells2-1, 0, ncells1-1,
+  [&](const int m, const int k, const int j, const int i) {
+    int idx = ((m*ncells3 + k)*ncells2 + j)*ncells1 + i;
+    // Extract metric quantities
+    host_adm.alpha(m, k, j, i)     = src[i_alpha][idx];
+    host_adm.beta_u(m, 0, k, j, i) = src[i_betax][idx];
+    host_adm.beta_u(m, 1, k, j, i) = src[i_betay][idx];
+    host_adm.beta_u(m, 2, k, j, i) = src[i_betaz][idx];
+
+    Real g3d[NSPMETRIC];
+    host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = src[i_gxx][idx];
+    host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = src[i_gxy][idx];
+    host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = src[i_gxz][idx];
+    host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = src[i_gyy][idx];
+    host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = src[i_gyz][idx];
+    host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = src[i_gzz][idx];
+
+    host_adm.vK_dd(m, 0, 0, k, j, i) = src[i_Kxx][idx];
+    host_adm.vK_dd(m, 0, 1, k, j, i) = src[i_Kxy][idx];
+    host_adm.vK_dd(m, 0, 2, k, j, i) = src[i_Kxz][idx];
+    host_adm.vK_dd(m, 1, 1, k, j, i) = src[i_Kyy][idx];
+    host_adm.vK_dd(m, 1, 2, k, j, i) = src[i_Kyz][idx];
+    host_adm.vK_dd(m, 2, 2, k, j, i) = src[i_Kzz][idx];
+
+    // Extract hydro quantities
+    host_w0(m, IDN, k, j, i) = src[i_rho][idx];
+    host_w0(m, IPR, k, j, i) = src[i_p][idx];
+    Real vu[3]               = {
+      src[i_vx][idx], src[i_vy][idx],
+      src[i_vz][idx]};
+
+    // Before we store the velocity, we need to make sure it's physical
+    // and calculate the Lorentz factor. If the velocity is superluminal,
+    // we make a last-ditch attempt to salvage the solution by rescaling
+    // it to vsq = 1.0 - 1e-15
+    Real vsq = Primitive::SquareVector(vu, g3d);
+    if (1.0 - vsq <= 0) {
+      std::cout << "The velocity is superluminal!" << std::endl
+                << "Attempting to adjust..." << std::endl;
+      Real fac = sqrt((1.0 - 1e-15) / vsq);
+      vu[0] *= fac;
+      vu[1] *= fac;
+      vu[2] *= fac;
+      vsq = 1.0 - 1.0e-15;
     }
-  }
+    Real W = sqrt(1.0 / (1.0 - vsq));
+
+    host_w0(m, IVX, k, j, i) = W * vu[0];
+    host_w0(m, IVY, k, j, i) = W * vu[1];
+    host_w0(m, IVZ, k, j, i) = W * vu[2];
+  });
 
   std::cout << "Host mirrors filled." << std::endl;
 
@@ -323,6 +326,9 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
     case 4:
       pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
       break;
+    case 5:
+      pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+      break;
   }
 
   return;
@@ -55,6 +55,8 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
             break;
     case 4: pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
             break;
+    case 5: pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+            break;
   }
   pmbp->pz4c->Z4cToADM(pmbp);
   pmbp->pz4c->GaugePreCollapsedLapse(pmbp, pin);
@@ -65,6 +67,8 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
             break;
     case 4: pmbp->pz4c->ADMConstraints<4>(pmbp);
             break;
+    case 5: pmbp->pz4c->ADMConstraints<5>(pmbp);
+            break;
   }
   std::cout<<"Kerr Schild initialized."<<std::endl;
   return;
@@ -125,6 +125,13 @@ struct torus_pgen {
 
   torus_pgen torus;
 
+// Stationary geometry at the points of each spherical grid used by TorusFluxes, computed
+// on its first call: g_{mu nu} and g^{mu nu} (NMETRIC_FULL values), dr/dx^i, dx/dphi,
+// dy/dphi, and sqrt(-g) in spherical KS
+enum {IFG_DRDX = NMETRIC_FULL, IFG_DXDPH = NMETRIC_FULL+3, IFG_SQRTG = NMETRIC_FULL+5};
+constexpr int nflux_geom = NMETRIC_FULL + 6;
+std::vector<HostArray2D<Real>> flux_geom;
+
 } // namespace
 
 // Prototypes for user-defined BCs and history functions
@@ -1772,6 +1779,36 @@ void TorusFluxes(HistoryData *pdata, Mesh *pm) {
     }
   }
 
+  // compute geometry at the points of each spherical grid, once
+  if (static_cast<int>(flux_geom.size()) != nradii) {
+    flux_geom.clear();
+    for (int g=0; g<nradii; ++g) {
+      HostArray2D<Real> geom("torus_flux_geom", grids[g]->nangles, nflux_geom);
+      for (int n=0; n<grids[g]->nangles; ++n) {
+        Real x1 = grids[g]->interp_coord.h_view(n,0);
+        Real x2 = grids[g]->interp_coord.h_view(n,1);
+        Real x3 = grids[g]->interp_coord.h_view(n,2);
+        Real glower[4][4], gupper[4][4];
+        ComputeMetricAndInverse(x1,x2,x3,flat,spin,glower,gupper);
+        for (int a=0; a<4; ++a) {
+          for (int b=0; b<4; ++b) {
+            geom(n,4*a+b) = glower[a][b];
+            geom(n,4*a+b+16) = gupper[a][b];
+          }
+        }
+        Real s[3], ds_dx[3][3], dx_ds[3][3], sqrtmdet;
+        ComputeSphericalKS(x1,x2,x3,spin,s,ds_dx,dx_ds,&sqrtmdet);
+        for (int i=0; i<3; ++i) {
+          geom(n,IFG_DRDX+i) = ds_dx[0][i];
+        }
+        geom(n,IFG_DXDPH) = dx_ds[0][2];
+        geom(n,IFG_DXDPH+1) = dx_ds[1][2];
+        geom(n,IFG_SQRTG) = sqrtmdet;
+      }
+      flux_geom.push_back(geom);
+    }
+  }
+
   // go through angles at each radii:
   DualArray2D<Real> interpolated_bcc;  // needed for MHD
   for (int g=0; g<nradii; ++g) {
@@ -1792,16 +1829,16 @@ void TorusFluxes(HistoryData *pdata, Mesh *pm) {
     grids[g]->InterpolateToSphere(nvars, w0_);
 
     // compute fluxes
+    auto &geom = flux_geom[g];
     for (int n=0; n<grids[g]->nangles; ++n) {
-      // extract coordinate data at this angle
-      Real r = grids[g]->radius;
-      Real theta = grids[g]->polar_pos.h_view(n,0);
-      Real phi = grids[g]->polar_pos.h_view(n,1);
-      Real x1 = grids[g]->interp_coord.h_view(n,0);
-      Real x2 = grids[g]->interp_coord.h_view(n,1);
-      Real x3 = grids[g]->interp_coord.h_view(n,2);
+      // extract stored metric at this angle
       Real glower[4][4], gupper[4][4];
-      ComputeMetricAndInverse(x1,x2,x3,flat,spin,glower,gupper);
+      for (int a=0; a<4; ++a) {
+        for (int b=0; b<4; ++b) {
+          glower[a][b] = geom(n,4*a+b);
+          gupper[a][b] = geom(n,4*a+b+16);
+        }
+      }
 
       // extract interpolated primitives
       Real &int_dn = grids[g]->interp_vals.h_view(n,IDN);
@@ -1849,27 +1886,23 @@ void TorusFluxes(HistoryData *pdata, Mesh *pm) {
       Real b_sq = b0*b_0 + b1*b_1 + b2*b_2 + b3*b_3;
 
       // Transform CKS 4-velocity and 4-magnetic field to spherical KS
-      Real a2 = SQR(spin);
-      Real rad2 = SQR(x1)+SQR(x2)+SQR(x3);
-      Real r2 = SQR(r);
-      Real sth = sin(theta);
-      Real sph = sin(phi);
-      Real cph = cos(phi);
-      Real drdx = r*x1/(2.0*r2 - rad2 + a2);
-      Real drdy = r*x2/(2.0*r2 - rad2 + a2);
-      Real drdz = (r*x3 + a2*x3/r)/(2.0*r2-rad2+a2);
+      Real drdx = geom(n,IFG_DRDX);
+      Real drdy = geom(n,IFG_DRDX+1);
+      Real drdz = geom(n,IFG_DRDX+2);
+      Real dxdph = geom(n,IFG_DXDPH);
+      Real dydph = geom(n,IFG_DXDPH+1);
       // contravariant r component of 4-velocity
       Real ur  = drdx *u1 + drdy *u2 + drdz *u3;
       // contravariant r component of 4-magnetic field (returns zero if not MHD)
       Real br  = drdx *b1 + drdy *b2 + drdz *b3;
       // covariant phi component of 4-velocity
-      Real u_ph = (-r*sph-spin*cph)*sth*u_1 + (r*cph-spin*sph)*sth*u_2;
+      Real u_ph = dxdph*u_1 + dydph*u_2;
       // covariant phi component of 4-magnetic field (returns zero if not MHD)
-      Real b_ph = (-r*sph-spin*cph)*sth*b_1 + (r*cph-spin*sph)*sth*b_2;
+      Real b_ph = dxdph*b_1 + dydph*b_2;
 
       // integration params
       Real &domega = grids[g]->solid_angles.h_view(n);
-      Real sqrtmdet = (r2+SQR(spin*cos(theta)));
+      Real sqrtmdet = geom(n,IFG_SQRTG);
 
       // compute mass flux
       pdata->hdata[nflux*g+0] += -1.0*int_dn*ur*sqrtmdet*domega;
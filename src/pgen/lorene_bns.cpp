@@ -16,6 +16,7 @@
 #include <sstream>
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -30,14 +31,22 @@
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
+#include "utils/id_sample_grid.hpp"
 
 // Lorene
 #include "bin_ns.h"
 #include "unites.h"
 
+// Indices of the LORENE fields used to set the initial data
+enum LoreneField {ILOR_NNN, ILOR_BETAX, ILOR_BETAY, ILOR_BETAZ,
+                  ILOR_GXX, ILOR_GXY, ILOR_GXZ, ILOR_GYY, ILOR_GYZ, ILOR_GZZ,
+                  ILOR_KXX, ILOR_KXY, ILOR_KXZ, ILOR_KYY, ILOR_KYZ, ILOR_KZZ,
+                  ILOR_NBAR, ILOR_EPS, ILOR_UX, ILOR_UY, ILOR_UZ, NLOR};
+
 // Prototype for user-defined history function
 void BNSHistory(HistoryData *pdata, Mesh *pm);
 void LoreneBNSRefinementCondition(MeshBlockPack *pmbp);
+void LoreneFields(Lorene::Bin_NS *bns, const Real *src[NLOR]);
 
 //----------------------------------------------------------------------------------------
 //! \fn ProblemGenerator::UserProblem_()
@@ -90,61 +99,73 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   int ncells3 = indcs.nx3 + 2*(indcs.ng);
   int nmb = pmbp->nmb_thispack;
 
-  int width = nmb*ncells1*ncells2*ncells3;
-
-  Real *x_coords = new Real[width];
-  Real *y_coords = new Real[width];
-  Real *z_coords = new Real[width];
-
-  std::cout << "Allocated coordinates of size " << width << std::endl;
-
-  // Populate coordinates for LORENE
-  // TODO(JMF): Replace with a Kokkos loop on Kokkos::DefaultHostExecutionSpace() to
-  // improve performance.
-  int idx = 0;
-  for (int m = 0; m < nmb; m++) {
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    int nx1 = indcs.nx1;
-
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    int nx2 = indcs.nx2;
-
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
-    int nx3 = indcs.nx3;
-
-    for (int k = 0; k < ncells3; k++) {
-      Real z = CellCenterX(k - ks, nx3, x3min, x3max);
-      for (int j = 0; j < ncells2; j++) {
-        Real y = CellCenterX(j - js, nx2, x2min, x2max);
-        for (int i = 0; i < ncells1; i++) {
-          Real x = CellCenterX(i - is, nx1, x1min, x1max);
-
-          x_coords[idx] = coord_unit*x;
-          y_coords[idx] = coord_unit*y;
-          z_coords[idx] = coord_unit*z;
-
-          // Increment flat index
-          idx++;
+  // Pointers to the LORENE fields at all cells (with flat index over m,k,j,i), either
+  // computed directly by LORENE, or interpolated from a coarse sample grid on which
+  // LORENE is evaluated in parallel over ranks (with <problem>/id_sample = true)
+  const Real *src[NLOR];
+  Lorene::Bin_NS *bns = nullptr;
+  HostArray5D<Real> id_h;
+  if (pin->GetOrAddBoolean("problem", "id_sample", false)) {
+    IDSampleGrid grid(pmbp, pin, "problem", NLOR);
+    grid.Sample([&](int npts, const Real *x, const Real *y, const Real *z, Real *vals) {
+      std::vector<Real> xs(npts), ys(npts), zs(npts);
+      for (int p = 0; p < npts; p++) {
+        xs[p] = coord_unit*x[p];
+        ys[p] = coord_unit*y[p];
+        zs[p] = coord_unit*z[p];
+      }
+      Lorene::Bin_NS sbns(npts, xs.data(), ys.data(), zs.data(), fname.c_str());
+      const Real *ssrc[NLOR];
+      LoreneFields(&sbns, ssrc);
+      for (int n = 0; n < NLOR; n++) {
+        for (int p = 0; p < npts; p++) {
+          vals[n*npts + p] = ssrc[n][p];
         }
       }
+    });
+    DvceArray5D<Real> id("id_lorene", NLOR, nmb, ncells3, ncells2, ncells1);
+    grid.InterpolateToMesh(id);
+    id_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), id);
+    for (int n = 0; n < NLOR; n++) {
+      src[n] = &(id_h(n, 0, 0, 0, 0));
     }
+    std::cout << "Sampled data interpolated." << std::endl;
+  } else {
+    int width = nmb*ncells1*ncells2*ncells3;
+
+    Real *x_coords = new Real[width];
+    Real *y_coords = new Real[width];
+    Real *z_coords = new Real[width];
+
+    std::cout << "Allocated coordinates of size " << width << std::endl;
+
+    // Populate coordinates for LORENE, using threads on the host
+    auto &size_h = size.h_view;
+    par_for_host("pgen_lorene_coords", 0, nmb-1, 0, ncells3-1, 0, ncells2-1,
+                 0, ncells1-1,
+    [&](const int m, const int k, const int j, const int i) {
+      int idx = ((m*ncells3 + k)*ncells2 + j)*ncells1 + i;
+      Real x = CellCenterX(i - is, indcs.nx1, size_h(m).x1min, size_h(m).x1max);
+      Real y = CellCenterX(j - js, indcs.nx2, size_h(m).x2min, size_h(m).x2max);
+      Real z = CellCenterX(k - ks, indcs.nx3, size_h(m).x3min, size_h(m).x3max);
+      x_coords[idx] = coord_unit*x;
+      y_coords[idx] = coord_unit*y;
+      z_coords[idx] = coord_unit*z;
+    });
+
+    // Interpolate the data
+    std::cout << "Coordinates assigned." << std::endl;
+    bns = new Lorene::Bin_NS(width, x_coords, y_coords, z_coords, fname.c_str());
+
+    // Free the coordinates, since we'll no longer need them.
+    delete[] x_coords;
+    delete[] y_coords;
+    delete[] z_coords;
+
+    std::cout << "Coordinates freed." << std::endl;
+    LoreneFields(bns, src);
   }
 
-  // Interpolate the data
-  std::cout << "Coordinates assigned." << std::endl;
-  Lorene::Bin_NS *bns = new Lorene::Bin_NS(width, x_coords, y_coords, z_coords,
-                                          fname.c_str());
-
-  // Free the coordinates, since we'll no longer need them.
-  delete[] x_coords;
-  delete[] y_coords;
-  delete[] z_coords;
-
-  std::cout << "Coordinates freed." << std::endl;
-
   // Capture variables for kernel; note that when Z4c is enabled, the gauge variables
   // are part of the Z4c class.
   auto &u_adm = pmbp->padm->u_adm;
@@ -179,88 +200,65 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   std::cout << "Host mirrors created." << std::endl;
 
-  // TODO(JMF): Replace with a Kokkos loop on Kokkos::DefaultHostExecutionSpace() to
-  // improve performance.
-  idx = 0;
-  for (int m = 0; m < nmb; m++) {
-    for (int k = 0; k < ncells3; k++) {
-      for (int j = 0; j < ncells2; j++) {
-        for (int i = 0; i < ncells1; i++) {
-  /*const int nn = nmb;
-  const int nk = ncells3;
-  const int nj = ncells2;
-  const int ni = ncells1;
-  const int nnkji = nn * nk * nj * ni;
-  const int nkji = nk * nj * ni;
-  const int nji = nj * ni;
-  Kokkos::parallel_for("pgen_lorene",
-  Kokkos::RangePolicy<>(HostExeSpace(), 0, nnkji),
-  KOKKOS_LAMBDA(const int &idx) {
-          int m = (idx)/nkji;
-          int k = (idx - m*nkji)/nji;
-          int j = (idx - m*nkji - k*nji)/ni;
-          int i = (idx - m*nkji - k*nji - j*ni);*/
-          // Extract metric quantities
-          host_adm.alpha(m, k, j, i) = bns->nnn[idx];
-          host_adm.beta_u(m, 0, k, j, i) = bns->beta_x[idx];
-          host_adm.beta_u(m, 1, k, j, i) = bns->beta_y[idx];
-          host_adm.beta_u(m, 2, k, j, i) = bns->beta_z[idx];
-
-          Real g3d[NSPMETRIC];
-          host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = bns->g_xx[idx];
-          host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = bns->g_xy[idx];
-          host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = bns->g_xz[idx];
-          host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = bns->g_yy[idx];
-          host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = bns->g_yz[idx];
-          host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = bns->g_zz[idx];
-
-          host_adm.vK_dd(m, 0, 0, k, j, i) = coord_unit * bns->k_xx[idx];
-          host_adm.vK_dd(m, 0, 1, k, j, i) = coord_unit * bns->k_xy[idx];
-          host_adm.vK_dd(m, 0, 2, k, j, i) = coord_unit * bns->k_xz[idx];
-          host_adm.vK_dd(m, 1, 1, k, j, i) = coord_unit * bns->k_yy[idx];
-          host_adm.vK_dd(m, 1, 2, k, j, i) = coord_unit * bns->k_yz[idx];
-          host_adm.vK_dd(m, 2, 2, k, j, i) = coord_unit * bns->k_zz[idx];
-
-          // Extract hydro quantities
-          host_w0(m, IDN, k, j, i) = bns->nbar[idx] / rho_unit;
-          // Lorene only gives the specific internal energy, but PrimitiveSolver needs
-          // pressure. Because PrimitiveSolver is templated, it's difficult to call it
-          // directly. Thus, the easiest way is to save the internal energy density, IEN,
-          // whose index overlaps the pressure, IPR, move the data to the GPU, then
-          // make a call to a virtual DynGRMHD EOS function that will call the appropriate
-          // template function.
-          Real egas = host_w0(m, IDN, k, j, i) * bns->ener_spec[idx] / ener_unit;
-          host_w0(m, IEN, k, j, i) = egas;
-          Real vu[3] = {bns->u_euler_x[idx] / vel_unit,
-                        bns->u_euler_y[idx] / vel_unit,
-                        bns->u_euler_z[idx] / vel_unit};
-
-          // Before we store the velocity, we need to make sure it's physical and
-          // calculate the Lorentz factor. If the velocity is superluminal, we make a
-          // last-ditch attempt to salvage the solution by rescaling it to
-          // vsq = 1.0 - 1e-15
-          Real vsq = Primitive::SquareVector(vu, g3d);
-          if (1.0 - vsq <= 0) {
-            std::cout << "The velocity is superluminal!" << std::endl
-                      << "Attempting to adjust..." << std::endl;
-            Real fac = sqrt((1.0 - 1e-15)/vsq);
-            vu[0] *= fac;
-            vu[1] *= fac;
-            vu[2] *= fac;
-            vsq = 1.0 - 1.0e-15;
-          }
-          Real W = sqrt(1.0 / (1.0 - vsq));
-
-          host_w0(m, IVX, k, j, i) = W*vu[0];
-          host_w0(m, IVY, k, j, i) = W*vu[1];
-          host_w0(m, IVZ, k, j, i) = W*vu[2];
-
-          idx++;
-  //});
-        }
-      }
+  // Fill host mirrors, using threads on the host
+  par_for_host("pgen_lorene", 0, nmb-1, 0, ncells3-1, 0, ncells2-1, 0, ncells1-1,
+  [&](const int m, const int k, const int j, const int i) {
+    int idx = ((m*ncells3 + k)*ncells2 + j)*ncells1 + i;
+    // Extract metric quantities
+    host_adm.alpha(m, k, j, i) = src[ILOR_NNN][idx];
+    host_adm.beta_u(m, 0, k, j, i) = src[ILOR_BETAX][idx];
+    host_adm.beta_u(m, 1, k, j, i) = src[ILOR_BETAY][idx];
+    host_adm.beta_u(m, 2, k, j, i) = src[ILOR_BETAZ][idx];
+
+    Real g3d[NSPMETRIC];
+    host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = src[ILOR_GXX][idx];
+    host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = src[ILOR_GXY][idx];
+    host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = src[ILOR_GXZ][idx];
+    host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = src[ILOR_GYY][idx];
+    host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = src[ILOR_GYZ][idx];
+    host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = src[ILOR_GZZ][idx];
+
+    host_adm.vK_dd(m, 0, 0, k, j, i) = coord_unit * src[ILOR_KXX][idx];
+    host_adm.vK_dd(m, 0, 1, k, j, i) = coord_unit * src[ILOR_KXY][idx];
+    host_adm.vK_dd(m, 0, 2, k, j, i) = coord_unit * src[ILOR_KXZ][idx];
+    host_adm.vK_dd(m, 1, 1, k, j, i) = coord_unit * src[ILOR_KYY][idx];
+    host_adm.vK_dd(m, 1, 2, k, j, i) = coord_unit * src[ILOR_KYZ][idx];
+    host_adm.vK_dd(m, 2, 2, k, j, i) = coord_unit * src[ILOR_KZZ][idx];
+
+    // Extract hydro quantities
+    host_w0(m, IDN, k, j, i) = src[ILOR_NBAR][idx] / rho_unit;
+    // Lorene only gives the specific internal energy, but PrimitiveSolver needs
+    // pressure. Because PrimitiveSolver is templated, it's difficult to call it
+    // directly. Thus, the easiest way is to save the internal energy density, IEN,
+    // whose index overlaps the pressure, IPR, move the data to the GPU, then
+    // make a call to a virtual DynGRMHD EOS function that will call the appropriate
+    // template function.
+    Real egas = host_w0(m, IDN, k, j, i) * src[ILOR_EPS][idx] / ener_unit;
+    host_w0(m, IEN, k, j, i) = egas;
+    Real vu[3] = {src[ILOR_UX][idx] / vel_unit,
+                  src[ILOR_UY][idx] / vel_unit,
+                  src[ILOR_UZ][idx] / vel_unit};
+
+    // Before we store the velocity, we need to make sure it's physical and
+    // calculate the Lorentz factor. If the velocity is superluminal, we make a
+    // last-ditch attempt to salvage the solution by rescaling it to
+    // vsq = 1.0 - 1e-15
+    Real vsq = Primitive::SquareVector(vu, g3d);
+    if (1.0 - vsq <= 0) {
+      std::cout << "The velocity is superluminal!" << std::endl
+                << "Attempting to adjust..." << std::endl;
+      Real fac = sqrt((1.0 - 1e-15)/vsq);
+      vu[0] *= fac;
+      vu[1] *= fac;
+      vu[2] *= fac;
+      vsq = 1.0 - 1.0e-15;
     }
-  }
+    Real W = sqrt(1.0 / (1.0 - vsq));
+
+    host_w0(m, IVX, k, j, i) = W*vu[0];
+    host_w0(m, IVY, k, j, i) = W*vu[1];
+    host_w0(m, IVZ, k, j, i) = W*vu[2];
+  });
 
   std::cout << "Host mirrors filled." << std::endl;
 
@@ -325,6 +323,8 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
               break;
       case 4: pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
               break;
+      case 5: pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+              break;
     }
   }
 
@@ -388,3 +388,32 @@ void BNSHistory(HistoryData *pdata, Mesh *pm) {
 void LoreneBNSRefinementCondition(MeshBlockPack *pmbp) {
   pmbp->pz4c->pamr->Refine(pmbp);
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void LoreneFields()
+//! \brief Sets pointers to the LORENE fields, in the order given by enum LoreneField
+
+void LoreneFields(Lorene::Bin_NS *bns, const Real *src[NLOR]) {
+  src[ILOR_NNN]   = bns->nnn;
+  src[ILOR_BETAX] = bns->beta_x;
+  src[ILOR_BETAY] = bns->beta_y;
+  src[ILOR_BETAZ] = bns->beta_z;
+  src[ILOR_GXX]   = bns->g_xx;
+  src[ILOR_GXY]   = bns->g_xy;
+  src[ILOR_GXZ]   = bns->g_xz;
+  src[ILOR_GYY]   = bns->g_yy;
+  src[ILOR_GYZ]   = bns->g_yz;
+  src[ILOR_GZZ]   = bns->g_zz;
+  src[ILOR_KXX]   = bns->k_xx;
+  src[ILOR_KXY]   = bns->k_xy;
+  src[ILOR_KXZ]   = bns->k_xz;
+  src[ILOR_KYY]   = bns->k_yy;
+  src[ILOR_KYZ]   = bns->k_yz;
+  src[ILOR_KZZ]   = bns->k_zz;
+  src[ILOR_NBAR]  = bns->nbar;
+  src[ILOR_EPS]   = bns->ener_spec;
+  src[ILOR_UX]    = bns->u_euler_x;
+  src[ILOR_UY]    = bns->u_euler_y;
+  src[ILOR_UZ]    = bns->u_euler_z;
+  return;
+}
@@ -0,0 +1,217 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file part_benchmark.cpp
+//! \brief Problem generator for measuring the throughput of the particle module.
+//! Particles (number set by <particles>/ppc) are distributed evenly over MeshBlocks with
+//! random positions and velocities drawn from <problem>/vdist = uniform (each component
+//! in [-vmax,vmax]), gaussian (dispersion vmax/3, clipped at vmax), or beam (all moving
+//! with vmax along x1).  Random numbers are seeded with <problem>/seed, so runs with the
+//! same input file and MeshBlock decomposition are reproducible.  The MeshBlock
+//! decomposition and number of ranks are set as usual in <meshblock> and on the command
+//! line.
+//!
+//! At the end of the run, the number of particle updates per second, the fraction of
+//! particles sent to other ranks per step, and the wall time spent in the push, sort,
+//! pack (NewGID and SendP), and communication Tasks are reported.  Task times are the
+//! maximum over ranks.  Timing of Tasks is enabled by this pgen, so a task_profile output
+//! (which resets the timers) should not be used simultaneously.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "parameter_input.hpp"
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals/bvals.hpp"
+#include "particles/particles.hpp"
+#include "pgen/pgen.hpp"
+
+#include <Kokkos_Random.hpp>
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+// function to report benchmark results at end of run
+void ParticleBenchmarkReport(ParameterInput *pin, Mesh *pm);
+
+namespace {
+// wall clock timer and cycle at start of benchmark
+Kokkos::Timer bench_timer;
+int bench_ncycle_start = 0;
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::UserProblem_()
+//! \brief Problem Generator for particle benchmark
+
+void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->ppart == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Particle benchmark requires <particles> block in input file"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // enable timing of all Tasks, and start benchmark timer
+  for (auto &it : pmbp->tl_map) {
+    it.second->EnableProfiling();
+  }
+  pgen_final_func = ParticleBenchmarkReport;
+  bench_ncycle_start = pmy_mesh_->ncycle;
+  bench_timer.reset();
+  if (restart) return;
+
+  // read problem parameters
+  std::string vdist = pin->GetOrAddString("problem", "vdist", "uniform");
+  Real vmax = pin->GetOrAddReal("problem", "vmax", 1.0);
+  int seed = pin->GetOrAddInteger("problem", "seed", 1);
+  int ivdist;
+  if (vdist.compare("uniform") == 0) {
+    ivdist = 0;
+  } else if (vdist.compare("gaussian") == 0) {
+    ivdist = 1;
+  } else if (vdist.compare("beam") == 0) {
+    ivdist = 2;
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "vdist = '" << vdist << "' not recognized, choose "
+              << "[uniform,gaussian,beam]" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // capture variables for the kernel
+  auto &mbsize = pmbp->pmb->mb_size;
+  auto &pr = pmbp->ppart->prtcl_rdata;
+  auto &pi = pmbp->ppart->prtcl_idata;
+  auto &npart = pmbp->ppart->nprtcl_thispack;
+  auto gids = pmbp->gids;
+  int nmb = pmbp->nmb_thispack;
+
+  // initialize particles, with equal number in each MeshBlock
+  Kokkos::Random_XorShift64_Pool<> rand_pool64(seed + gids);
+  par_for("part_bench",DevExeSpace(),0,(npart-1),
+  KOKKOS_LAMBDA(const int p) {
+    auto rand_gen = rand_pool64.get_state();  // get random number state this thread
+    int m = p % nmb;
+    pi(PGID,p) = gids + m;
+
+    Real rand = rand_gen.frand();
+    pr(IPX,p) = (1. - rand)*mbsize.d_view(m).x1min + rand*mbsize.d_view(m).x1max;
+    pr(IPX,p) = fmin(pr(IPX,p),mbsize.d_view(m).x1max);
+    pr(IPX,p) = fmax(pr(IPX,p),mbsize.d_view(m).x1min);
+
+    rand = rand_gen.frand();
+    pr(IPY,p) = (1. - rand)*mbsize.d_view(m).x2min + rand*mbsize.d_view(m).x2max;
+    pr(IPY,p) = fmin(pr(IPY,p),mbsize.d_view(m).x2max);
+    pr(IPY,p) = fmax(pr(IPY,p),mbsize.d_view(m).x2min);
+
+    rand = rand_gen.frand();
+    pr(IPZ,p) = (1. - rand)*mbsize.d_view(m).x3min + rand*mbsize.d_view(m).x3max;
+    pr(IPZ,p) = fmin(pr(IPZ,p),mbsize.d_view(m).x3max);
+    pr(IPZ,p) = fmax(pr(IPZ,p),mbsize.d_view(m).x3min);
+
+    Real v[3];
+    for (int n=0; n<3; ++n) {
+      if (ivdist == 0) {
+        v[n] = vmax*2.0*(rand_gen.frand() - 0.5);
+      } else if (ivdist == 1) {
+        v[n] = fmin(fmax(rand_gen.normal(0.0, vmax/3.0), -vmax), vmax);
+      } else {
+        v[n] = (n == 0)? vmax : 0.0;
+      }
+    }
+    pr(IPVX,p) = v[0];
+    pr(IPVY,p) = v[1];
+    pr(IPVZ,p) = v[2];
+
+    rand_pool64.free_state(rand_gen);  // free state for use by other threads
+  });
+
+  // set timestep (which will remain constant for entire run), so that particles move
+  // at most one cell per step.  Assumes uniform mesh (no SMR or AMR)
+  Real &dtnew_ = pmbp->ppart->dtnew;
+  dtnew_ = std::min(mbsize.h_view(0).dx1, mbsize.h_view(0).dx2);
+  dtnew_ = std::min(dtnew_, mbsize.h_view(0).dx3);
+  dtnew_ /= std::max(vmax, static_cast<Real>(1.0e-20));
+
+  if (global_variable::my_rank == 0) {
+    auto &indcs = pmy_mesh_->mb_indcs;
+    std::cout << "Particle benchmark: " << pmy_mesh_->nprtcl_total << " particles, "
+              << pmy_mesh_->nmb_total << " MeshBlocks of " << indcs.nx1 << "x"
+              << indcs.nx2 << "x" << indcs.nx3 << " cells on "
+              << global_variable::nranks << " ranks, vdist=" << vdist << std::endl;
+  }
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ParticleBenchmarkReport()
+//! \brief Reports particle throughput, migration fraction, and time spent in particle
+//! Tasks since start of run (or restart).
+
+void ParticleBenchmarkReport(ParameterInput *pin, Mesh *pm) {
+  double wall_time = bench_timer.seconds();
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  int ncycles = pm->ncycle - bench_ncycle_start;
+
+  // times spent in push, sort, pack, and communication Tasks on this rank
+  double tprtcl[4] = {0.0, 0.0, 0.0, 0.0};
+  for (auto &it : pmbp->tl_map) {
+    std::vector<std::string> names = it.second->GetTaskNames();
+    std::vector<double> times = it.second->GetTaskTimes();
+    for (std::size_t n=0; n<names.size(); ++n) {
+      if (names[n].compare(0, 11, "Particles::") != 0) continue;
+      if (names[n].compare("Particles::Push") == 0) {
+        tprtcl[0] += times[n];
+      } else if (names[n].compare("Particles::Sort") == 0) {
+        tprtcl[1] += times[n];
+      } else if (names[n].compare("Particles::NewGID") == 0 ||
+                 names[n].compare("Particles::SendP") == 0) {
+        tprtcl[2] += times[n];
+      } else {
+        tprtcl[3] += times[n];
+      }
+    }
+  }
+  std::int64_t nsent = pmbp->ppart->pbval_part->nprtcl_sent_total;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, tprtcl, 4, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &wall_time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &nsent, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+  if (global_variable::my_rank == 0 && ncycles > 0) {
+    double nupdates = static_cast<double>(pm->nprtcl_total)*static_cast<double>(ncycles);
+    double ttotal = tprtcl[0] + tprtcl[1] + tprtcl[2] + tprtcl[3];
+    std::cout << std::endl << "Particle benchmark results over " << ncycles
+              << " cycles:" << std::endl << std::scientific << std::setprecision(4)
+              << "  particle updates/second (wall)      = " << nupdates/wall_time
+              << std::endl
+              << "  particle updates/second (particles) = "
+              << ((ttotal > 0.0)? nupdates/ttotal : 0.0) << std::endl
+              << "  fraction sent to other ranks/step   = "
+              << static_cast<double>(nsent)/nupdates << std::endl;
+    const char *labels[4] = {"push", "sort", "pack", "comm"};
+    for (int n=0; n<4; ++n) {
+      std::cout << "  " << labels[n] << " time (s) = " << tprtcl[n] << " ("
+                << std::fixed << std::setprecision(1)
+                << ((ttotal > 0.0)? 100.0*tprtcl[n]/ttotal : 0.0) << "%)"
+                << std::scientific << std::setprecision(4) << std::endl;
+    }
+    std::cout << std::defaultfloat;
+  }
+  return;
+}
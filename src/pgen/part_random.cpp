@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <sstream>
 #include <iostream>
 
@@ -15,8 +16,7 @@
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "particles/particles.hpp"
-
-#include <Kokkos_Random.hpp>
+#include "utils/random.hpp"
 
 //----------------------------------------------------------------------------------------
 //! \fn ProblemGenerator::UserProblem_()
@@ -41,35 +41,34 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   auto gids = pmy_mesh_->pmb_pack->gids;
   auto gide = pmy_mesh_->pmb_pack->gide;
 
-  // initialize particles
-  Kokkos::Random_XorShift64_Pool<> rand_pool64(pmbp->gids);
+  // initialize particles.  Counter-based random numbers depend only on the seed, the
+  // first MeshBlock in the pack, and the index of the particle (not on thread order).
+  std::uint64_t seed = pin->GetOrAddInteger("problem", "seed", 1);
   par_for("part_update",DevExeSpace(),0,(npart-1),
   KOKKOS_LAMBDA(const int p) {
-    auto rand_gen = rand_pool64.get_state();  // get random number state this thread
     // choose parent MeshBlock randomly
-    int m = static_cast<int>(rand_gen.frand()*(gide - gids + 1.0));
+    int m = static_cast<int>(RanCounter(seed, gids, p, 0)*(gide - gids + 1.0));
+    m = (m > gide - gids)? (gide - gids) : m;
     pi(PGID,p) = gids + m;
 
-    Real rand = rand_gen.frand();
+    Real rand = RanCounter(seed, gids, p, 1);
     pr(IPX,p) = (1. - rand)*mbsize.d_view(m).x1min + rand*mbsize.d_view(m).x1max;
     pr(IPX,p) = fmin(pr(IPX,p),mbsize.d_view(m).x1max);
     pr(IPX,p) = fmax(pr(IPX,p),mbsize.d_view(m).x1min);
 
-    rand = rand_gen.frand();
+    rand = RanCounter(seed, gids, p, 2);
     pr(IPY,p) = (1. - rand)*mbsize.d_view(m).x2min + rand*mbsize.d_view(m).x2max;
     pr(IPY,p) = fmin(pr(IPY,p),mbsize.d_view(m).x2max);
     pr(IPY,p) = fmax(pr(IPY,p),mbsize.d_view(m).x2min);
 
-    rand = rand_gen.frand();
+    rand = RanCounter(seed, gids, p, 3);
     pr(IPZ,p) = (1. - rand)*mbsize.d_view(m).x3min + rand*mbsize.d_view(m).x3max;
     pr(IPZ,p) = fmin(pr(IPZ,p),mbsize.d_view(m).x3max);
     pr(IPZ,p) = fmax(pr(IPZ,p),mbsize.d_view(m).x3min);
 
-    pr(IPVX,p) = 2.0*(rand_gen.frand() - 0.5);
-    pr(IPVY,p) = 2.0*(rand_gen.frand() - 0.5);
-    pr(IPVZ,p) = 2.0*(rand_gen.frand() - 0.5);
-
-    rand_pool64.free_state(rand_gen);  // free state for use by other threads
+    pr(IPVX,p) = 2.0*(RanCounter(seed, gids, p, 4) - 0.5);
+    pr(IPVY,p) = 2.0*(RanCounter(seed, gids, p, 5) - 0.5);
+    pr(IPVZ,p) = 2.0*(RanCounter(seed, gids, p, 6) - 0.5);
   });
 
   // set timestep (which will remain constant for entire run
@@ -13,6 +13,9 @@
 #include <utility>
 #include <algorithm>
 #include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
 
 #include "athena.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
@@ -27,6 +30,7 @@
 #include "z4c/z4c.hpp"
 #include "radiation/radiation.hpp"
 #include "srcterms/turb_driver.hpp"
+#include "outputs/outputs.hpp"
 #include "pgen.hpp"
 
 
@@ -36,6 +40,7 @@
 ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm) :
     user_bcs(false),
     user_srcs(false),
+    user_srcs_fused(false),
     user_hist(false),
     pmy_mesh_(pm) {
   // check for user-defined boundary conditions
@@ -89,9 +94,10 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm) :
 // and any data necessary for restart runs to continue correctly.
 
 ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resfile,
-                                   bool single_file_per_rank) :
+                                   bool single_file_per_rank, std::string rst_dir) :
     user_bcs(false),
     user_srcs(false),
+    user_srcs_fused(false),
     user_hist(false),
     pmy_mesh_(pm) {
   // check for user-defined boundary conditions
@@ -124,7 +130,9 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     nmhd = pmhd->nmhd + pmhd->nscalars;
   }
   if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
+    // intensities may be stored on a different angular mesh, see RemapAngles()
+    nrad = (prad->prgeo_rst != nullptr)? prad->prgeo_rst->nangles : prad->prgeo->nangles;
+    nrad *= prad->ngroups;
   }
   if (pz4c != nullptr) {
     nz4c = pz4c->nz4c;
@@ -191,6 +199,40 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     std::memcpy(&(pturb->rstate), &(rng_data[0]), sizeof(RNG_State));
   }
 
+  // root process reads name and number of variables of extra CC arrays (see
+  // ExtraArrayCC), whose number is stored in the parameters of the restart output
+  int nextra = 0;
+  for (auto &ib : pin->block) {
+    if (ib.block_name.compare(0, 6, "output") == 0 &&
+        pin->DoesParameterExist(ib.block_name, "extra_arrays")) {
+      nextra = pin->GetInteger(ib.block_name, "extra_arrays");
+    }
+  }
+  std::vector<std::string> extra_name(nextra);
+  std::vector<int> extra_nvar(nextra);
+  for (int e=0; e<nextra; ++e) {
+    char name[kExtraArrayNameLength] = {0};
+    if (global_variable::my_rank == 0 || single_file_per_rank) {
+      if (resfile.Read_bytes(name, 1, kExtraArrayNameLength, single_file_per_rank)
+          != static_cast<IOWrapperSizeT>(kExtraArrayNameLength) ||
+          resfile.Read_bytes(&(extra_nvar[e]), sizeof(int), 1, single_file_per_rank)
+          != 1) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Extra array data read from restart file is incorrect, "
+                  << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+#if MPI_PARALLEL_ENABLED
+    if (!single_file_per_rank) {
+      MPI_Bcast(name, kExtraArrayNameLength, MPI_CHAR, 0, MPI_COMM_WORLD);
+      MPI_Bcast(&(extra_nvar[e]), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    }
+#endif
+    name[kExtraArrayNameLength-1] = '\0';
+    extra_name[e] = std::string(name);
+  }
+
   // root process reads size of CC and FC data arrays from restart file
   IOWrapperSizeT variablesize = sizeof(IOWrapperSizeT);
   char *variabledata = new char[variablesize];
@@ -246,6 +288,9 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
   } else if (padm != nullptr) {
     data_size_ += nout1*nout2*nout3*nadm*sizeof(Real);   // adm u_adm
   }
+  for (int e=0; e<nextra; ++e) {
+    data_size_ += nout1*nout2*nout3*extra_nvar[e]*sizeof(Real);  // extra arrays
+  }
 
   if (data_size_ != data_size) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
@@ -255,364 +300,273 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     exit(EXIT_FAILURE);
   }
 
-  // read CC data into host array
-  int mygids = pm->gids_eachrank[global_variable::my_rank];
-  IOWrapperSizeT offset_myrank = headeroffset;
+  // All data of each MB is stored contiguously in the file, in order of gid.  Since the
+  // MBs of this rank set by LoadBalance() in Mesh::BuildTreeFromRestart() have
+  // consecutive gids, the data of all MBs on this rank is one contiguous block of the
+  // file, which is read with a few large collective reads (of less than 2^31 bytes each)
+  // and then unpacked into the arrays of each physics module.  This works for any
+  // number of ranks, independent of the number of ranks that wrote the file.
+  IOWrapperSizeT myoffset = headeroffset;
   if (!single_file_per_rank) {
-    offset_myrank += data_size_ * pm->gids_eachrank[global_variable::my_rank];
+    myoffset += data_size * pm->gids_eachrank[global_variable::my_rank];
   }
-  IOWrapperSizeT myoffset = offset_myrank;
+  // offset of checksums stored after data of all MBs (if any)
+  IOWrapperSizeT chk_offset = headeroffset + data_size *
+      ((single_file_per_rank)? pm->nmb_thisrank : pm->nmb_total);
 
-  HostArray5D<Real> ccin("rst-cc-in", 1, 1, 1, 1, 1);
+  HostIOArray5D<Real> hydro_in, mhd_in, rad_in, force_in, z4c_in, adm_in;
   HostFaceFld4D<Real> fcin("rst-fc-in", 1, 1, 1, 1);
-
-  // calculate max/min number of MeshBlocks across all ranks
-  int noutmbs_max = pm->nmb_eachrank[0];
-  int noutmbs_min = pm->nmb_eachrank[0];
-  for (int i=0; i<(global_variable::nranks); ++i) {
-    noutmbs_max = std::max(noutmbs_max,pm->nmb_eachrank[i]);
-    noutmbs_min = std::min(noutmbs_min,pm->nmb_eachrank[i]);
-  }
-
   if (phydro != nullptr) {
-    Kokkos::realloc(ccin, nmb, nhydro, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset, single_file_per_rank)
-            != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC hydro data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset, single_file_per_rank)
-            != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC hydro data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
-    Kokkos::deep_copy(Kokkos::subview(phydro->u0, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nhydro*sizeof(Real); // hydro u0
-    myoffset = offset_myrank;
+    Kokkos::realloc(hydro_in, nmb, nhydro, nout3, nout2, nout1);
   }
-
   if (pmhd != nullptr) {
-    Kokkos::realloc(ccin, nmb, nmhd, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                   Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset, single_file_per_rank)
-            != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC mhd data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset, single_file_per_rank)
-            != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC mhd data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
-    Kokkos::deep_copy(Kokkos::subview(pmhd->u0, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nmhd*sizeof(Real);   // mhd u0
-    myoffset = offset_myrank;
-
+    Kokkos::realloc(mhd_in, nmb, nmhd, nout3, nout2, nout1);
     Kokkos::realloc(fcin.x1f, nmb, nout3, nout2, nout1+1);
     Kokkos::realloc(fcin.x2f, nmb, nout3, nout2+1, nout1);
     Kokkos::realloc(fcin.x3f, nmb, nout3+1, nout2, nout1);
-    // read FC data into host array, again one MeshBlock at a time
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to x1-face field
-        auto x1fptr = Kokkos::subview(fcin.x1f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        int fldcnt = x1fptr.size();
-
-        if (resfile.Read_Reals_at_all(x1fptr.data(), fldcnt, myoffset,
-                                      single_file_per_rank) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x1f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x2-face field
-        auto x2fptr = Kokkos::subview(fcin.x2f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x2fptr.size();
-
-        if (resfile.Read_Reals_at_all(x2fptr.data(), fldcnt, myoffset,
-                                      single_file_per_rank) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x2f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x3-face field
-        auto x3fptr = Kokkos::subview(fcin.x3f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x3fptr.size();
-
-        if (resfile.Read_Reals_at_all(x3fptr.data(), fldcnt, myoffset,
-                                      single_file_per_rank) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x3f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        myoffset += data_size-(x1fptr.size()+x2fptr.size()+x3fptr.size())*sizeof(Real);
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to x1-face field
-        auto x1fptr = Kokkos::subview(fcin.x1f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        int fldcnt = x1fptr.size();
-
-        if (resfile.Read_Reals_at(x1fptr.data(), fldcnt, myoffset,
-                                      single_file_per_rank) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x1f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x2-face field
-        auto x2fptr = Kokkos::subview(fcin.x2f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x2fptr.size();
+  }
+  if (prad != nullptr) {
+    Kokkos::realloc(rad_in, nmb, nrad, nout3, nout2, nout1);
+  }
+  if (pturb != nullptr) {
+    Kokkos::realloc(force_in, nmb, nforce, nout3, nout2, nout1);
+  }
+  if (pz4c != nullptr) {
+    Kokkos::realloc(z4c_in, nmb, nz4c, nout3, nout2, nout1);
+  } else if (padm != nullptr) {
+    Kokkos::realloc(adm_in, nmb, nadm, nout3, nout2, nout1);
+  }
+  std::vector<HostIOArray5D<Real>> extra_in(nextra);
+  for (int e=0; e<nextra; ++e) {
+    Kokkos::realloc(extra_in[e], nmb, extra_nvar[e], nout3, nout2, nout1);
+  }
 
-        if (resfile.Read_Reals_at(x2fptr.data(), fldcnt, myoffset,
-                                      single_file_per_rank) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x2f field not read correctly from rst file, "
+  // unpack data of MB m, in the order written in restart.cpp
+  auto unpack_mb = [&](int m, const char *pdata) {
+    auto unpack = [&](Real *dst, std::size_t cnt) {
+      std::memcpy(dst, pdata, cnt*sizeof(Real));
+      pdata += cnt*sizeof(Real);
+    };
+    if (phydro != nullptr) {
+      unpack(&hydro_in(m,0,0,0,0), nhydro*nout3*nout2*nout1);
+    }
+    if (pmhd != nullptr) {
+      unpack(&mhd_in(m,0,0,0,0), nmhd*nout3*nout2*nout1);
+      unpack(&fcin.x1f(m,0,0,0), nout3*nout2*(nout1+1));
+      unpack(&fcin.x2f(m,0,0,0), nout3*(nout2+1)*nout1);
+      unpack(&fcin.x3f(m,0,0,0), (nout3+1)*nout2*nout1);
+    }
+    if (prad != nullptr) {
+      unpack(&rad_in(m,0,0,0,0), nrad*nout3*nout2*nout1);
+    }
+    if (pturb != nullptr) {
+      unpack(&force_in(m,0,0,0,0), nforce*nout3*nout2*nout1);
+    }
+    if (pz4c != nullptr) {
+      unpack(&z4c_in(m,0,0,0,0), nz4c*nout3*nout2*nout1);
+    } else if (padm != nullptr) {
+      unpack(&adm_in(m,0,0,0,0), nadm*nout3*nout2*nout1);
+    }
+    for (int e=0; e<nextra; ++e) {
+      unpack(&extra_in[e](m,0,0,0,0), extra_nvar[e]*nout3*nout2*nout1);
+    }
+  };
+
+  // delta checkpoints (see restart.cpp) store only the data of some MBs, after a header
+  // with the name of the base checkpoint that stores the data of all other MBs
+  const IOWrapperSizeT nmagic = sizeof(kRestartDeltaMagic) - 1;
+  char dmagic[sizeof(kRestartDeltaMagic)] = {0};
+  IOWrapperSizeT base_offset = 0;
+  char base_name[kRestartBaseNameLength] = {0};
+  if (global_variable::my_rank == 0 || single_file_per_rank) {
+    if (resfile.Read_bytes_at(dmagic, 1, nmagic, headeroffset, single_file_per_rank)
+        == nmagic && std::memcmp(dmagic, kRestartDeltaMagic, nmagic) == 0) {
+      resfile.Read_bytes_at(&base_offset, sizeof(IOWrapperSizeT), 1,
+                            headeroffset + nmagic, single_file_per_rank);
+      resfile.Read_bytes_at(base_name, 1, kRestartBaseNameLength,
+                            headeroffset + nmagic + sizeof(IOWrapperSizeT),
+                            single_file_per_rank);
+    }
+  }
+#if MPI_PARALLEL_ENABLED
+  if (!single_file_per_rank) {
+    MPI_Bcast(dmagic, nmagic, MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&base_offset, sizeof(IOWrapperSizeT), MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Bcast(base_name, kRestartBaseNameLength, MPI_CHAR, 0, MPI_COMM_WORLD);
+  }
+#endif
+  bool delta = (std::memcmp(dmagic, kRestartDeltaMagic, nmagic) == 0);
+
+  if (!delta) {
+    // number of MBs per read, and number of (collective) reads over all ranks
+    const IOWrapperSizeT max_read = (1 << 30);
+    int mbs_per_read = static_cast<int>(std::max(max_read/data_size,
+                                                 static_cast<IOWrapperSizeT>(1)));
+    int nreads = (nmb + mbs_per_read - 1)/mbs_per_read;
+#if MPI_PARALLEL_ENABLED
+    if (!single_file_per_rank) {
+      MPI_Allreduce(MPI_IN_PLACE, &nreads, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    }
+#endif
+    std::vector<char> rbuf(data_size*std::min(mbs_per_read, nmb));
+    for (int n=0; n<nreads; ++n) {
+      int mbs = std::max(std::min(mbs_per_read, nmb - n*mbs_per_read), 0);
+      IOWrapperSizeT nbytes = data_size*mbs;
+      if (resfile.Read_bytes_at_all(rbuf.data(), 1, nbytes, myoffset,
+                                    single_file_per_rank) != nbytes) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MeshBlock data not read correctly from rst file, "
+                  << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      myoffset += nbytes;
+      for (int mm=0; mm<mbs; ++mm) {
+        unpack_mb(n*mbs_per_read + mm, &(rbuf[mm*data_size]));
+      }
+    }
+  } else {
+    // flags of all MBs in the file, which are 1 for MBs stored in the delta
+    int nflags = (single_file_per_rank)? nmb : pm->nmb_total;
+    std::vector<char> flags(nflags);
+    IOWrapperSizeT flag_offset = headeroffset + nmagic + sizeof(IOWrapperSizeT)
+                                 + kRestartBaseNameLength;
+    if (resfile.Read_bytes_at(flags.data(), 1, nflags, flag_offset, single_file_per_rank)
+        != static_cast<std::size_t>(nflags)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "MeshBlock flags not read correctly from delta rst file, "
                 << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x3-face field
-        auto x3fptr = Kokkos::subview(fcin.x3f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x3fptr.size();
+      exit(EXIT_FAILURE);
+    }
+    IOWrapperSizeT rec_offset = flag_offset + nflags;
+    std::vector<int> nrec_below(nflags + 1, 0);
+    for (int f=0; f<nflags; ++f) {
+      nrec_below[f+1] = nrec_below[f] + ((flags[f] != 0)? 1 : 0);
+    }
+    chk_offset = rec_offset + data_size*nrec_below[nflags];
+
+    // read each MB from the delta or the base, which is in the same directory
+    std::string base_file = rst_dir + std::string(base_name);
+    IOWrapper basefile;
+    basefile.Open(base_file.c_str(), IOWrapper::FileMode::read, single_file_per_rank);
+    int gids = (single_file_per_rank)? 0 : pm->gids_eachrank[global_variable::my_rank];
+    std::vector<char> rbuf(data_size);
+    for (int m=0; m<nmb; ++m) {
+      int f = gids + m;
+      std::size_t nread = (flags[f] != 0)?
+          resfile.Read_bytes_at(rbuf.data(), 1, data_size,
+                                rec_offset + data_size*nrec_below[f],
+                                single_file_per_rank) :
+          basefile.Read_bytes_at(rbuf.data(), 1, data_size, base_offset + data_size*f,
+                                 single_file_per_rank);
+      if (nread != data_size) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MeshBlock data not read correctly from delta rst file "
+                  << "or its base '" << base_file << "', restart file is broken."
+                  << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      unpack_mb(m, rbuf.data());
+    }
+    basefile.Close(single_file_per_rank);
+  }
 
-        if (resfile.Read_Reals_at(x3fptr.data(), fldcnt, myoffset,
-                                      single_file_per_rank) != fldcnt) {
+  // verify per-variable checksums, if stored in the file
+  {
+    char magic[8] = {0};
+    int nchk = 0;
+    std::vector<std::uint64_t> chk_file;
+    if (global_variable::my_rank == 0 || single_file_per_rank) {
+      if (resfile.Read_bytes_at(magic, 1, sizeof(magic), chk_offset,
+                                single_file_per_rank) == sizeof(magic) &&
+          std::memcmp(magic, kRestartChecksumMagic, sizeof(magic)) == 0) {
+        resfile.Read_bytes_at(&nchk, sizeof(int), 1, chk_offset + sizeof(magic),
+                              single_file_per_rank);
+        chk_file.resize(nchk);
+        resfile.Read_bytes_at(chk_file.data(), sizeof(std::uint64_t), nchk,
+                              chk_offset + sizeof(magic) + sizeof(int),
+                              single_file_per_rank);
+      }
+    }
+#if MPI_PARALLEL_ENABLED
+    if (!single_file_per_rank) {
+      MPI_Bcast(&nchk, 1, MPI_INT, 0, MPI_COMM_WORLD);
+      chk_file.resize(nchk);
+      MPI_Bcast(chk_file.data(), nchk, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    }
+#endif
+    if (nchk > 0) {
+      std::vector<std::uint64_t> chk = RestartChecksums(pm, hydro_in, mhd_in, fcin,
+                                                        rad_in, force_in, z4c_in,
+                                                        adm_in);
+#if MPI_PARALLEL_ENABLED
+      if (!single_file_per_rank) {
+        MPI_Allreduce(MPI_IN_PLACE, chk.data(), chk.size(), MPI_UINT64_T, MPI_SUM,
+                      MPI_COMM_WORLD);
+      }
+#endif
+      if (chk.size() != chk_file.size()) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Number of checksums in restart file (" << nchk
+                  << ") differs from number of variables (" << chk.size() << ")"
+                  << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      for (int n=0; n<nchk; ++n) {
+        if (chk[n] != chk_file[n]) {
           std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x3f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
+                    << std::endl << "Checksum of variable " << n << " read from restart "
+                    << "file is incorrect, restart file is broken." << std::endl;
           exit(EXIT_FAILURE);
         }
-        myoffset += fldcnt*sizeof(Real);
-
-        myoffset += data_size-(x1fptr.size()+x2fptr.size()+x3fptr.size())*sizeof(Real);
       }
     }
+  }
+
+  // copy data to device
+  if (phydro != nullptr) {
+    DeepCopyLayout(Kokkos::subview(phydro->u0, std::make_pair(0,nmb), Kokkos::ALL,
+                   Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), hydro_in);
+  }
+  if (pmhd != nullptr) {
+    DeepCopyLayout(Kokkos::subview(pmhd->u0, std::make_pair(0,nmb), Kokkos::ALL,
+                   Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), mhd_in);
     Kokkos::deep_copy(Kokkos::subview(pmhd->b0.x1f, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL), fcin.x1f);
     Kokkos::deep_copy(Kokkos::subview(pmhd->b0.x2f, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL), fcin.x2f);
     Kokkos::deep_copy(Kokkos::subview(pmhd->b0.x3f, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL), fcin.x3f);
-    offset_myrank += (nout1+1)*nout2*nout3*sizeof(Real);    // mhd b0.x1f
-    offset_myrank += nout1*(nout2+1)*nout3*sizeof(Real);    // mhd b0.x2f
-    offset_myrank += nout1*nout2*(nout3+1)*sizeof(Real);    // mhd b0.x3f
-    myoffset = offset_myrank;
   }
-
   if (prad != nullptr) {
-    Kokkos::realloc(ccin, nmb, nrad, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset,
-                                      single_file_per_rank) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC rad data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset,
-                                      single_file_per_rank) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC rad data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
+    if (prad->prgeo_rst != nullptr) {
+      DvceArray5D<Real> i_rst("i_rst", nmb, nrad, nout3, nout2, nout1);
+      DeepCopyLayout(i_rst, rad_in);
+      prad->RemapAngles(i_rst);
+      delete prad->prgeo_rst;
+      prad->prgeo_rst = nullptr;
+    } else {
+      DeepCopyLayout(Kokkos::subview(prad->i0, std::make_pair(0,nmb), Kokkos::ALL,
+                     Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), rad_in);
     }
-    Kokkos::deep_copy(Kokkos::subview(prad->i0, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nrad*sizeof(Real);   // radiation i0
-    myoffset = offset_myrank;
   }
-
   if (pturb != nullptr) {
-    Kokkos::realloc(ccin, nmb, nforce, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset,
-                                      single_file_per_rank) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC turb data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset,
-                                      single_file_per_rank) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC turb data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
-    Kokkos::deep_copy(Kokkos::subview(pturb->force, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nforce*sizeof(Real); // forcing
-    myoffset = offset_myrank;
+    DeepCopyLayout(Kokkos::subview(pturb->force, std::make_pair(0,nmb), Kokkos::ALL,
+                   Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), force_in);
   }
-
   if (pz4c != nullptr) {
-    Kokkos::realloc(ccin, nmb, nz4c, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset,
-                                      single_file_per_rank) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC z4c data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset,
-                                      single_file_per_rank) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC z4c data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
-    Kokkos::deep_copy(Kokkos::subview(pz4c->u0, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nz4c*sizeof(Real);   // z4c u0
-    myoffset = offset_myrank;
-
+    DeepCopyLayout(Kokkos::subview(pz4c->u0, std::make_pair(0,nmb), Kokkos::ALL,
+                   Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), z4c_in);
     // We also need to reinitialize the ADM data.
     pz4c->Z4cToADM(pmy_mesh_->pmb_pack);
   } else if (padm != nullptr) {
-    Kokkos::realloc(ccin, nmb, nadm, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset,
-                                      single_file_per_rank) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC adm data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset,
-                                      single_file_per_rank) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC adm data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
-    Kokkos::deep_copy(Kokkos::subview(padm->u_adm, std::make_pair(0,nmb), Kokkos::ALL,
-                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nadm*sizeof(Real);   // adm u_adm
-    myoffset = offset_myrank;
+    DeepCopyLayout(Kokkos::subview(padm->u_adm, std::make_pair(0,nmb), Kokkos::ALL,
+                   Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), adm_in);
+  }
+  // extra arrays are kept until claimed by their owners (e.g. time-averaged outputs)
+  for (int e=0; e<nextra; ++e) {
+    DvceArray5D<Real> extra("extra_rst", nmb, extra_nvar[e], nout3, nout2, nout1);
+    DeepCopyLayout(extra, extra_in[e]);
+    pm->pmb_pack->extra_cc_rst[extra_name[e]] = extra;
   }
 
   // call problem generator again to re-initialize data, fn ptrs, as needed
@@ -901,8 +855,12 @@ void ProblemGenerator::CallProblemGenerator(ParameterInput *pin, bool is_restart
     BondiAccretion(pin, is_restart);
   } else if (pgen_fun_name.compare("tetrad") == 0) {
     CheckOrthonormalTetrad(pin, is_restart);
+  } else if (pgen_fun_name.compare("conduction_ring") == 0) {
+    ConductionRing(pin, is_restart);
   } else if (pgen_fun_name.compare("cshock") == 0) {
     CShock(pin, is_restart);
+  } else if (pgen_fun_name.compare("curvilinear") == 0) {
+    CurvilinearTest(pin, is_restart);
   } else if (pgen_fun_name.compare("hohlraum") == 0) {
     Hohlraum(pin, is_restart);
   } else if (pgen_fun_name.compare("linear_wave") == 0) {
@@ -915,8 +873,14 @@ void ProblemGenerator::CallProblemGenerator(ParameterInput *pin, bool is_restart
     MRI3d(pin, is_restart);
   } else if (pgen_fun_name.compare("orszag_tang") == 0) {
     OrszagTang(pin, is_restart);
+  } else if (pgen_fun_name.compare("poisson") == 0) {
+    Poisson(pin, is_restart);
   } else if (pgen_fun_name.compare("rad_linear_wave") == 0) {
     RadiationLinearWave(pin, is_restart);
+  } else if (pgen_fun_name.compare("rad_equilibrium") == 0) {
+    RadiationEquilibrium(pin, is_restart);
+  } else if (pgen_fun_name.compare("rad_interface") == 0) {
+    RadiationInterface(pin, is_restart);
   } else if (pgen_fun_name.compare("shock_tube") == 0) {
     ShockTube(pin, is_restart);
   } else if (pgen_fun_name.compare("shwave") == 0) {
@@ -10,6 +10,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "geodesic-grid/spherical_grid.hpp"
@@ -28,9 +29,10 @@ class ProblemGenerator {
  public:
   // constructor for new problems
   ProblemGenerator(ParameterInput *pin, Mesh *pmesh);
-  // constructor for restarts
+  // constructor for restarts.  rst_dir is the directory of the restart file, in which
+  // the base of delta checkpoints is found.
   ProblemGenerator(ParameterInput *pin, Mesh *pmesh, IOWrapper resfile,
-                   bool single_file_per_rank=false);
+                   bool single_file_per_rank=false, std::string rst_dir="");
   ~ProblemGenerator() = default;
 
   // true if user BCs are specified on any face
@@ -38,6 +40,8 @@ class ProblemGenerator {
 
   // true if user srcterms are specified
   bool user_srcs;
+  // true if user_srcs_func applies all per-cell srcterms with SourceTerms::AddSrcTerms()
+  bool user_srcs_fused;
 
   // true if user history outputs are specified
   bool user_hist;
@@ -60,7 +64,9 @@ class ProblemGenerator {
   void AlfvenWave(ParameterInput *pin, const bool restart);
   void BondiAccretion(ParameterInput *pin, const bool restart);
   void CheckOrthonormalTetrad(ParameterInput *pin, const bool restart);
+  void ConductionRing(ParameterInput *pin, const bool restart);
   void CShock(ParameterInput *pin, const bool restart);
+  void CurvilinearTest(ParameterInput *pin, const bool restart);
   void Diffusion(ParameterInput *pin, const bool restart);
   void Hohlraum(ParameterInput *pin, const bool restart);
   void LinearWave(ParameterInput *pin, const bool restart);
@@ -68,10 +74,13 @@ class ProblemGenerator {
   void Monopole(ParameterInput *pin, const bool restart);
   void MRI3d(ParameterInput *pin, const bool restart);
   void OrszagTang(ParameterInput *pin, const bool restart);
+  void Poisson(ParameterInput *pin, const bool restart);
   void ShockTube(ParameterInput *pin, const bool restart);
   void Shwave(ParameterInput *pin, const bool restart);
   void SphericalCollapse(ParameterInput *pin, const bool restart);
   void RadiationLinearWave(ParameterInput *pin, const bool restart);
+  void RadiationEquilibrium(ParameterInput *pin, const bool restart);
+  void RadiationInterface(ParameterInput *pin, const bool restart);
   void Z4cBoostedPuncture(ParameterInput *pin, const bool restart);
   void Z4cLinearWave(ParameterInput *pin, const bool restart);
 
@@ -17,6 +17,7 @@
 #include "hydro/hydro.hpp"
 #include "driver/driver.hpp"
 #include "radiation/radiation.hpp"
+#include "radiation/radiation_opacities.hpp"
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBlock::UserProblem(ParameterInput *pin)
@@ -41,12 +42,16 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   auto &coord = pmbp->pcoord->coord_data;
   int nmb1 = (pmbp->nmb_thispack-1);
   int nang1 = (pmbp->prad->prgeo->nangles-1);
+  int ngroups = pmbp->prad->ngroups;
+  auto &nu_edges = pmbp->prad->nu_edges;
 
   // get problem parameters
   Real erad = pin->GetReal("problem", "erad");
   Real temp = pin->GetReal("problem", "temp");
   Real v1 = pin->GetOrAddReal("problem", "v1", 0.0);
   Real lf = 1.0/sqrt(1.0-(SQR(v1)));
+  // with frequency groups, radiation is a black body at the radiation temperature
+  Real trad = sqrt(sqrt(erad/pmbp->prad->arad));
 
   // set primitive variables
   auto &w0 = pmbp->phydro->w0;
@@ -104,10 +109,14 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
       // Calculate intensity in fluid frame
       Real ii_f =  erad/(4.0*M_PI);
 
-      // Calculate intensity in tetrad frame
+      // Calculate intensity in tetrad frame, in each group
       Real n0 = tet_c_(m,0,0,k,j,i); Real n_0 = 0.0;
       for (int d=0; d<4; ++d) {  n_0 += tetcov_c_(m,d,0,k,j,i)*nh_c_.d_view(n,d);  }
-      i0(m,n,k,j,i) = n0*n_0*ii_f/SQR(SQR(n0_f));
+      for (int g=0; g<ngroups; ++g) {
+        Real frac = (ngroups > 1)?
+                    PlanckFraction(nu_edges.d_view(g), nu_edges.d_view(g+1), trad) : 1.0;
+        i0(m,g*(nang1+1)+n,k,j,i) = n0*n_0*frac*ii_f/SQR(SQR(n0_f));
+      }
     }
   });
 
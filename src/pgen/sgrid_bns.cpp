@@ -400,6 +400,9 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   case 4:
     pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
     break;
+  case 5:
+    pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+    break;
   }
 
   return;
@@ -153,6 +153,8 @@ void ProblemGenerator::SphericalCollapse(ParameterInput *pin, const bool restart
               break;
       case 4: pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
               break;
+      case 5: pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+              break;
     }
   }
 }
@@ -0,0 +1,260 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file conduction_ring.cpp
+//! \brief problem generator for the ring test of anisotropic conduction (Parrish & Stone
+//! 2005, Sharma & Hammett 2007).  A weak circular magnetic field is centered on the
+//! origin, and the temperature is raised from t0 to t0+dt0 in a patch of the annulus
+//! r1 < r < r2, |phi| < dphi, at uniform pressure.  Heat then diffuses along the field
+//! around the annulus.  Since the field is weak and pressure is uniform, motions are
+//! small.
+//! This file also contains a function called in Driver::Finalize() that writes the
+//! extrema of the temperature (which must stay within [t0,t0+dt0] with the slope-limited
+//! transverse gradients) and the fraction of the excess heat outside the annulus, which
+//! measures numerical diffusion perpendicular to the field.
+
+// C++ headers
+#include <cmath>      // sqrt()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <cstdlib>
+#include <iostream>   // endl
+#include <string>     // c_str()
+
+// Athena++ headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "mhd/mhd.hpp"
+#include "pgen/pgen.hpp"
+
+// Prototype for function to compute diagnostics of solution at end of run
+void ConductionRingErrors(ParameterInput *pin, Mesh *pm);
+
+// Anonymous namespace used to prevent name collisions outside of this file
+namespace {
+// input parameters, also used by diagnostic function
+struct RingVariables {
+  Real p0, t0, dt0, r1, r2, dphi, b0;
+};
+
+RingVariables rv;
+
+//----------------------------------------------------------------------------------------
+//! \fn Real A3()
+//! \brief z-component of vector potential of circular field with magnitude b0
+
+KOKKOS_INLINE_FUNCTION
+Real A3(const Real x1, const Real x2, const Real b0) {
+  return b0*sqrt(SQR(x1) + SQR(x2));
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::ConductionRing()
+//! \brief Problem Generator for the ring test of anisotropic conduction
+
+void ProblemGenerator::ConductionRing(ParameterInput *pin, const bool restart) {
+  pgen_final_func = ConductionRingErrors;
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->pmhd == nullptr || !(pmbp->pmhd->peos->eos_data.is_ideal)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Conduction ring test requires <mhd> with an ideal gas EOS" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // Read problem parameters
+  rv.p0 = pin->GetOrAddReal("problem", "p0", 1.0);
+  rv.t0 = pin->GetOrAddReal("problem", "t0", 10.0);
+  rv.dt0 = pin->GetOrAddReal("problem", "dt0", 2.0);
+  rv.r1 = pin->GetOrAddReal("problem", "r1", 0.5);
+  rv.r2 = pin->GetOrAddReal("problem", "r2", 0.7);
+  rv.dphi = pin->GetOrAddReal("problem", "dphi", M_PI/12.0);
+  rv.b0 = pin->GetOrAddReal("problem", "b0", 1.0e-3);
+  if (restart) return;
+
+  // capture variables for kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  EOS_Data &eos = pmbp->pmhd->peos->eos_data;
+  Real gm1 = eos.gamma - 1.0;
+  auto &u0 = pmbp->pmhd->u0;
+  auto &b0 = pmbp->pmhd->b0;
+  auto &size = pmbp->pmb->mb_size;
+  auto rv_ = rv;
+
+  par_for("pgen_ring1", DevExeSpace(), 0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    int nx1 = indcs.nx1;
+    Real x1v = CellCenterX(i-is, nx1, x1min, x1max);
+
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    int nx2 = indcs.nx2;
+    Real x2v = CellCenterX(j-js, nx2, x2min, x2max);
+
+    // temperature raised in patch of annulus, at uniform pressure
+    Real rad = sqrt(SQR(x1v) + SQR(x2v));
+    Real phi = atan2(x2v, x1v);
+    Real temp = rv_.t0;
+    if (rad > rv_.r1 && rad < rv_.r2 && fabs(phi) < rv_.dphi) {temp += rv_.dt0;}
+    u0(m,IDN,k,j,i) = rv_.p0/temp;
+    u0(m,IM1,k,j,i) = 0.0;
+    u0(m,IM2,k,j,i) = 0.0;
+    u0(m,IM3,k,j,i) = 0.0;
+
+    // Compute face-centered fields from curl(A).
+    Real x1f   = LeftEdgeX(i  -is, nx1, x1min, x1max);
+    Real x1fp1 = LeftEdgeX(i+1-is, nx1, x1min, x1max);
+    Real x2f   = LeftEdgeX(j  -js, nx2, x2min, x2max);
+    Real x2fp1 = LeftEdgeX(j+1-js, nx2, x2min, x2max);
+    Real dx1 = size.d_view(m).dx1;
+    Real dx2 = size.d_view(m).dx2;
+
+    b0.x1f(m,k,j,i) =  (A3(x1f,  x2fp1,rv_.b0) - A3(x1f,x2f,rv_.b0))/dx2;
+    b0.x2f(m,k,j,i) = -(A3(x1fp1,x2f  ,rv_.b0) - A3(x1f,x2f,rv_.b0))/dx1;
+    b0.x3f(m,k,j,i) = 0.0;
+
+    // Include extra face-component at edge of block in each direction
+    if (i==ie) {
+      b0.x1f(m,k,j,i+1) =  (A3(x1fp1,x2fp1,rv_.b0) - A3(x1fp1,x2f,rv_.b0))/dx2;
+    }
+    if (j==je) {
+      b0.x2f(m,k,j+1,i) = -(A3(x1fp1,x2fp1,rv_.b0) - A3(x1f,x2fp1,rv_.b0))/dx1;
+    }
+    if (k==ke) {
+      b0.x3f(m,k+1,j,i) = 0.0;
+    }
+  });
+
+  // initialize total energy (requires B to be defined across entire grid first)
+  par_for("pgen_ring2", DevExeSpace(), 0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    u0(m,IEN,k,j,i) = rv_.p0/gm1 +
+          0.5*(SQR(0.5*(b0.x1f(m,k,j,i) + b0.x1f(m,k,j,i+1))) +
+               SQR(0.5*(b0.x2f(m,k,j,i) + b0.x2f(m,k,j+1,i))) +
+               SQR(0.5*(b0.x3f(m,k,j,i) + b0.x3f(m,k+1,j,i))));
+  });
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ConductionRingErrors()
+//! \brief Computes the minimum and maximum temperature, and the fraction of the excess
+//! heat (e - rho t0/(gamma-1)) outside the annulus r1 < r < r2, and writes them to file.
+
+void ConductionRingErrors(ParameterInput *pin, Mesh *pm) {
+  // capture class variables for kernel
+  auto &indcs = pm->mb_indcs;
+  int &nx1 = indcs.nx1;
+  int &nx2 = indcs.nx2;
+  int &nx3 = indcs.nx3;
+  int &is = indcs.is;
+  int &js = indcs.js;
+  int &ks = indcs.ks;
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  auto &size = pmbp->pmb->mb_size;
+  EOS_Data &eos = pmbp->pmhd->peos->eos_data;
+  Real gm1 = eos.gamma - 1.0;
+  auto &u0 = pmbp->pmhd->u0;
+  auto &b0 = pmbp->pmhd->b0;
+  auto rv_ = rv;
+
+  const int nmkji = (pmbp->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  array_sum::GlobalSum sum_this_mb;
+  Real tmin = 0.0, tmax = 0.0;
+  Kokkos::parallel_reduce("ring-err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum, Real &min_t, Real &max_t) {
+    // compute m,k,j,i indices of thread
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+
+    Real x1v = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real x2v = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real rad = sqrt(SQR(x1v) + SQR(x2v));
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+
+    // internal energy and temperature
+    Real dens = u0(m,IDN,k,j,i);
+    Real eint = u0(m,IEN,k,j,i) - 0.5*(SQR(u0(m,IM1,k,j,i)) + SQR(u0(m,IM2,k,j,i)) +
+                                       SQR(u0(m,IM3,k,j,i)))/dens
+              - 0.5*(SQR(0.5*(b0.x1f(m,k,j,i) + b0.x1f(m,k,j,i+1))) +
+                     SQR(0.5*(b0.x2f(m,k,j,i) + b0.x2f(m,k,j+1,i))) +
+                     SQR(0.5*(b0.x3f(m,k,j,i) + b0.x3f(m,k+1,j,i))));
+    Real temp = gm1*eint/dens;
+    min_t = fmin(min_t, temp);
+    max_t = fmax(max_t, temp);
+
+    // excess heat in total and outside annulus
+    array_sum::GlobalSum evars;
+    for (int n=0; n<NREDUCTION_VARIABLES; ++n) {
+      evars.the_array[n] = 0.0;
+    }
+    Real heat = vol*(eint - dens*rv_.t0/gm1);
+    evars.the_array[0] = heat;
+    if (rad <= rv_.r1 || rad >= rv_.r2) {evars.the_array[1] = heat;}
+    mb_sum += evars;
+  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_mb), Kokkos::Min<Real>(tmin),
+     Kokkos::Max<Real>(tmax));
+
+  Real heat[2] = {sum_this_mb.the_array[0], sum_this_mb.the_array[1]};
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, heat, 2, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &tmin, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &tmax, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  Real frac_out = heat[1]/heat[0];
+
+  // root process opens output file and writes out diagnostics
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+
+    // The file exists -- reopen the file in append mode
+    if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+      if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+
+    // The file does not exist -- open the file in write mode and add headers
+    } else {
+      if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::fprintf(pfile, "# Nx1  Nx2  Nx3   Ncycle  T_min         T_max         ");
+      std::fprintf(pfile, "heat_outside\n");
+    }
+
+    // write diagnostics
+    std::fprintf(pfile, "%04d", pm->mesh_indcs.nx1);
+    std::fprintf(pfile, "  %04d", pm->mesh_indcs.nx2);
+    std::fprintf(pfile, "  %04d", pm->mesh_indcs.nx3);
+    std::fprintf(pfile, "  %05d  %e %e", pm->ncycle, tmin, tmax);
+    std::fprintf(pfile, "  %e\n", frac_out);
+    std::fclose(pfile);
+  }
+
+  return;
+}
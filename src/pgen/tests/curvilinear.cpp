@@ -0,0 +1,136 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file curvilinear.cpp
+//! \brief Problem generator for tests of hydrodynamics in cylindrical and spherical-polar
+//! coordinates (<coord>/system).  Two steady states can be initialized:
+//!  - type = uniform: uniform density and pressure at rest, which the curvilinear update
+//!    holds in equilibrium to round-off in both coordinate systems.
+//!  - type = rotating: a rotating ring in cylindrical coordinates, with
+//!    v_phi^2 = v0^2 R exp(-(R-r0)^2/w^2) and the pressure that balances the centrifugal
+//!    force, which is steady only to the truncation error of the scheme.
+//! The error function computes the difference between the final and initial solutions.
+
+// C++ headers
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Athena++ headers
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "pgen/pgen.hpp"
+
+// function to compute errors in solution at end of run
+void CurvilinearErrors(ParameterInput *pin, Mesh *pm);
+
+namespace {
+// global variable to control computation of initial conditions versus errors
+bool set_initial_conditions = true;
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::CurvilinearTest()
+//! \brief Sets initial conditions for tests of curvilinear coordinates.  Conserved
+//! variables are stored in u1 instead of u0 when computing the errors.
+
+void ProblemGenerator::CurvilinearTest(ParameterInput *pin, const bool restart) {
+  if (set_initial_conditions) {pgen_final_func = CurvilinearErrors;}
+  if (restart) return;
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->phydro == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Curvilinear coordinates test requires <hydro>" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  const CoordSystem sys = pmbp->pcoord->coord_data.system;
+
+  std::string type = pin->GetOrAddString("problem", "type", "uniform");
+  bool rotating;
+  if (type.compare("uniform") == 0) {
+    rotating = false;
+  } else if (type.compare("rotating") == 0) {
+    rotating = true;
+    if (sys != CoordSystem::cylindrical || !(pmbp->phydro->peos->eos_data.is_ideal)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<problem>/type = rotating requires <coord>/system = "
+                << "cylindrical and an ideal gas EOS" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<problem>/type = '" << type << "' not implemented. "
+              << "Valid choices are [uniform,rotating]." << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // get problem parameters
+  Real d0 = pin->GetOrAddReal("problem", "d0", 1.0);
+  Real p0 = pin->GetOrAddReal("problem", "p0", 1.0);
+  Real v0 = pin->GetOrAddReal("problem", "v0", 0.5);
+  Real r0 = pin->GetOrAddReal("problem", "r0", 1.0);
+  Real wr = pin->GetOrAddReal("problem", "width", 0.1);
+  Real r1 = pmy_mesh_->mesh_size.x1min;
+
+  // capture variables for kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  auto &size = pmbp->pmb->mb_size;
+  auto &eos = pmbp->phydro->peos->eos_data;
+  Real gm1 = eos.gamma - 1.0;
+  int nhyd = pmbp->phydro->nhydro;
+  int nscal = pmbp->phydro->nscalars;
+  auto &u = (set_initial_conditions)? pmbp->phydro->u0 : pmbp->phydro->u1;
+
+  par_for("pgen_curv", DevExeSpace(),0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m,int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    int nx1 = indcs.nx1;
+    Real x1v = CellCenterX(i-is, nx1, x1min, x1max);
+
+    Real dens = d0, pres = p0, vphi = 0.0;
+    if (rotating) {
+      // dP/dR = rho v_phi^2/R = rho v0^2 exp(-(R-r0)^2/w^2)
+      Real arg = (x1v - r0)/wr;
+      vphi = v0*sqrt(x1v*exp(-SQR(arg)));
+      pres = p0 + dens*SQR(v0)*0.5*sqrt(M_PI)*wr*(erf(arg) - erf((r1 - r0)/wr));
+    }
+
+    u(m,IDN,k,j,i) = dens;
+    u(m,IM1,k,j,i) = 0.0;
+    u(m,IM2,k,j,i) = dens*vphi;
+    u(m,IM3,k,j,i) = 0.0;
+    if (eos.is_ideal) {
+      u(m,IEN,k,j,i) = pres/gm1 + 0.5*dens*SQR(vphi);
+    }
+    for (int n=0; n<nscal; ++n) {
+      u(m,nhyd+n,k,j,i) = 0.0;
+    }
+  });
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CurvilinearErrors()
+//! \brief Computes errors in the steady state by calling the initialization function
+//! again to compute the initial conditions in u1, and then calling the generic error
+//! output function that subtracts the current solution from the ICs.
+
+void CurvilinearErrors(ParameterInput *pin, Mesh *pm) {
+  set_initial_conditions = false;
+  pm->pgen->CurvilinearTest(pin, false);
+  pm->pgen->OutputErrors(pin, pm);
+  return;
+}
@@ -0,0 +1,212 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file poisson.cpp
+//! \brief problem generator for tests of the multigrid Poisson solver of self-gravity.
+//! Sets up a sinusoidal density rho = d0*(1 + amp*sin(k.x)) at rest on a periodic mesh,
+//! with wavenumbers k = 2 pi (1/Lx1, 1/Lx2, 1/Lx3) in each active dimension.  The
+//! potential is then phi = -four_pi_G d0 amp sin(k.x)/|k|^2 (up to a constant).
+//! This file also contains a function to compute the errors in the potential of the last
+//! solve, called in Driver::Finalize().  With integrator=rk1 and nlim=1 this is the
+//! potential of the initial density.
+
+// C++ headers
+#include <cmath>      // sin()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <cstdlib>
+#include <iostream>   // endl
+#include <string>     // c_str()
+
+// Athena++ headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "gravity/gravity.hpp"
+#include "pgen/pgen.hpp"
+
+// Prototype for function to compute errors in solution at end of run
+void PoissonErrors(ParameterInput *pin, Mesh *pm);
+
+// Anonymous namespace used to prevent name collisions outside of this file
+namespace {
+// input parameters, also used by error function
+struct PoissonVariables {
+  Real d0, amp, k1, k2, k3;
+};
+
+PoissonVariables pv;
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::Poisson()
+//! \brief Problem Generator for sinusoidal density test of the Poisson solver
+
+void ProblemGenerator::Poisson(ParameterInput *pin, const bool restart) {
+  pgen_final_func = PoissonErrors;
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->pgrav == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Poisson test requires <gravity>" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // get problem parameters
+  auto &ms = pmy_mesh_->mesh_size;
+  pv.d0 = pin->GetOrAddReal("problem", "d0", 1.0);
+  pv.amp = pin->GetOrAddReal("problem", "amp", 0.1);
+  pv.k1 = 2.0*M_PI/(ms.x1max - ms.x1min);
+  pv.k2 = (pmy_mesh_->multi_d)? 2.0*M_PI/(ms.x2max - ms.x2min) : 0.0;
+  pv.k3 = (pmy_mesh_->three_d)? 2.0*M_PI/(ms.x3max - ms.x3min) : 0.0;
+  Real p0 = pin->GetOrAddReal("problem", "p0", 1.0);
+  if (restart) return;
+
+  // capture variables for kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  auto &size = pmbp->pmb->mb_size;
+  auto pv_ = pv;
+
+  EquationOfState *peos = (pmbp->phydro != nullptr)? pmbp->phydro->peos :
+                                                     pmbp->pmhd->peos;
+  auto &u0 = (pmbp->phydro != nullptr)? pmbp->phydro->u0 : pmbp->pmhd->u0;
+  auto &eos = peos->eos_data;
+  Real gm1 = eos.gamma - 1.0;
+
+  par_for("pgen_poisson", DevExeSpace(),0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m,int k, int j, int i) {
+    Real x1v = CellCenterX(i-is, indcs.nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real x2v = CellCenterX(j-js, indcs.nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real x3v = CellCenterX(k-ks, indcs.nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real kx = pv_.k1*x1v + pv_.k2*x2v + pv_.k3*x3v;
+    u0(m,IDN,k,j,i) = pv_.d0*(1.0 + pv_.amp*sin(kx));
+    u0(m,IM1,k,j,i) = 0.0;
+    u0(m,IM2,k,j,i) = 0.0;
+    u0(m,IM3,k,j,i) = 0.0;
+    if (eos.is_ideal) {
+      u0(m,IEN,k,j,i) = p0/gm1;
+    }
+  });
+
+  // face-centered fields (zero) for MHD
+  if (pmbp->pmhd != nullptr) {
+    Kokkos::deep_copy(pmbp->pmhd->b0.x1f, 0.0);
+    Kokkos::deep_copy(pmbp->pmhd->b0.x2f, 0.0);
+    Kokkos::deep_copy(pmbp->pmhd->b0.x3f, 0.0);
+  }
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PoissonErrors()
+//! \brief Computes L1 and L-infinity errors of the potential relative to the analytic
+//! solution, after subtracting the mean difference (the constant in phi is arbitrary),
+//! and writes them with the number of multigrid cycles of the last solve to file.
+
+void PoissonErrors(ParameterInput *pin, Mesh *pm) {
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  Gravity *pgrav = pmbp->pgrav;
+  auto &indcs = pm->mb_indcs;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  // phi has one ghost cell in each active dimension
+  int pis = 1;
+  int pjs = (pm->multi_d)? 1 : 0;
+  int pks = (pm->three_d)? 1 : 0;
+  auto &size = pmbp->pmb->mb_size;
+  auto &phi = pgrav->phi;
+  auto pv_ = pv;
+  Real amp_phi = -(pgrav->four_pi_G)*pv.d0*pv.amp/(SQR(pv.k1) + SQR(pv.k2) + SQR(pv.k3));
+
+  const int nmkji = (pmbp->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+
+  // first pass: volume-weighted mean difference, second pass: errors
+  Real sum_diff = 0.0;
+  Real l1_err = 0.0, linfty_err = 0.0;
+  for (int pass=0; pass<2; ++pass) {
+    Real vol_total = (pm->mesh_size.x1max - pm->mesh_size.x1min)*
+                     (pm->mesh_size.x2max - pm->mesh_size.x2min)*
+                     (pm->mesh_size.x3max - pm->mesh_size.x3min);
+    Real mean_diff = sum_diff/vol_total;
+    Real sum1 = 0.0, max1 = 0.0;
+    Kokkos::parallel_reduce("poisson-err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, Real &sum, Real &max_err) {
+      // compute m,k,j,i indices of thread
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1);
+
+      Real x1v = CellCenterX(i, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+      Real x2v = CellCenterX(j, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+      Real x3v = CellCenterX(k, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+      Real kx = pv_.k1*x1v + pv_.k2*x2v + pv_.k3*x3v;
+      Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+      Real diff = phi(m,0,k+pks,j+pjs,i+pis) - amp_phi*sin(kx);
+      if (pass == 0) {
+        sum += vol*diff;
+      } else {
+        sum += vol*fabs(diff - mean_diff);
+        max_err = fmax(max_err, fabs(diff - mean_diff));
+      }
+    }, Kokkos::Sum<Real>(sum1), Kokkos::Max<Real>(max1));
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &sum1, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &max1, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    if (pass == 0) {
+      sum_diff = sum1;
+    } else {
+      l1_err = sum1/vol_total;
+      linfty_err = max1;
+    }
+  }
+
+  // root process opens output file and writes out errors
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+
+    // The file exists -- reopen the file in append mode
+    if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+      if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+
+    // The file does not exist -- open the file in write mode and add headers
+    } else {
+      if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::fprintf(pfile, "# Nx1  Nx2  Nx3   Ncycle   phi_L1       phi_L-infty   ");
+      std::fprintf(pfile, "MG_cycles\n");
+    }
+
+    // write errors
+    std::fprintf(pfile, "%04d", pm->mesh_indcs.nx1);
+    std::fprintf(pfile, "  %04d", pm->mesh_indcs.nx2);
+    std::fprintf(pfile, "  %04d", pm->mesh_indcs.nx3);
+    std::fprintf(pfile, "  %05d  %e %e", pm->ncycle, l1_err, linfty_err);
+    std::fprintf(pfile, "  %d\n", pgrav->ncycles);
+    std::fclose(pfile);
+  }
+
+  return;
+}
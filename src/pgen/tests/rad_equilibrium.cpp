@@ -0,0 +1,140 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file rad_equilibrium.cpp
+//! \brief Uniform (magnetized) fluid coupled to black-body radiation, for tests of the
+//! radiation source terms.  The fluid moves with velocity v1 along x1, and the radiation
+//! is isotropic in the frame moving with v1_rad (default v1).  With erad = arad*temp^4
+//! and v1_rad = v1 the state is an exact equilibrium.  Otherwise the fluid is
+//! accelerated by the radiation, which tests the inertia (including b^2 for MHD) used by
+//! the implicit coupling.
+
+// C++ headers
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// Athena++ headers
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "radiation/radiation.hpp"
+#include "radiation/radiation_opacities.hpp"
+#include "pgen/pgen.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::RadiationEquilibrium()
+//! \brief Sets initial conditions for the radiation equilibrium test
+
+void ProblemGenerator::RadiationEquilibrium(ParameterInput *pin, const bool restart) {
+  if (restart) return;
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->prad == nullptr || (pmbp->phydro == nullptr && pmbp->pmhd == nullptr)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Radiation equilibrium test requires <radiation> and <hydro> or <mhd>"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // capture variables for kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  int nmb1 = (pmbp->nmb_thispack-1);
+  int nang1 = (pmbp->prad->prgeo->nangles-1);
+  int ngroups = pmbp->prad->ngroups;
+  auto &nu_edges = pmbp->prad->nu_edges;
+
+  // get problem parameters
+  Real dens = pin->GetOrAddReal("problem", "dens", 1.0);
+  Real temp = pin->GetReal("problem", "temp");
+  Real erad = pin->GetReal("problem", "erad");
+  Real v1 = pin->GetOrAddReal("problem", "v1", 0.0);
+  Real v1_rad = pin->GetOrAddReal("problem", "v1_rad", v1);
+  Real bx = pin->GetOrAddReal("problem", "b1", 0.0);
+  Real by = pin->GetOrAddReal("problem", "b2", 0.0);
+  Real bz = pin->GetOrAddReal("problem", "b3", 0.0);
+  Real lf = 1.0/sqrt(1.0 - SQR(v1));
+  Real lf_rad = 1.0/sqrt(1.0 - SQR(v1_rad));
+  // with frequency groups, radiation is a black body at the radiation temperature
+  Real trad = sqrt(sqrt(erad/pmbp->prad->arad));
+
+  // set primitive variables (and fields)
+  bool is_mhd = (pmbp->pmhd != nullptr);
+  Real gm1 = (is_mhd)? (pmbp->pmhd->peos->eos_data.gamma - 1.0) :
+                       (pmbp->phydro->peos->eos_data.gamma - 1.0);
+  auto &w0 = (is_mhd)? pmbp->pmhd->w0 : pmbp->phydro->w0;
+  auto &u0 = (is_mhd)? pmbp->pmhd->u0 : pmbp->phydro->u0;
+  par_for("pgen_rad_eq1",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    w0(m,IDN,k,j,i) = dens;
+    w0(m,IVX,k,j,i) = lf*v1;
+    w0(m,IVY,k,j,i) = 0.0;
+    w0(m,IVZ,k,j,i) = 0.0;
+    w0(m,IEN,k,j,i) = dens*temp/gm1;
+  });
+
+  if (is_mhd) {
+    auto &b0 = pmbp->pmhd->b0;
+    auto &bcc0 = pmbp->pmhd->bcc0;
+    par_for("pgen_rad_eq2",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      b0.x1f(m,k,j,i) = bx;
+      b0.x2f(m,k,j,i) = by;
+      b0.x3f(m,k,j,i) = bz;
+      if (i == n1-1) {b0.x1f(m,k,j,i+1) = bx;}
+      if (j == n2-1) {b0.x2f(m,k,j+1,i) = by;}
+      if (k == n3-1) {b0.x3f(m,k+1,j,i) = bz;}
+      bcc0(m,IBX,k,j,i) = bx;
+      bcc0(m,IBY,k,j,i) = by;
+      bcc0(m,IBZ,k,j,i) = bz;
+    });
+    pmbp->pmhd->peos->PrimToCons(w0, bcc0, u0, 0, (n1-1), 0, (n2-1), 0, (n3-1));
+  } else {
+    pmbp->phydro->peos->PrimToCons(w0, u0, 0, (n1-1), 0, (n2-1), 0, (n3-1));
+  }
+
+  // set intensities, isotropic in the frame moving with v1_rad
+  auto &norm_to_tet_ = pmbp->prad->norm_to_tet;
+  auto &nh_c_ = pmbp->prad->nh_c;
+  auto &tet_c_ = pmbp->prad->tet_c;
+  auto &tetcov_c_ = pmbp->prad->tetcov_c;
+  auto &i0 = pmbp->prad->i0;
+  par_for("pgen_rad_eq3",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    // radiation frame velocity in tetrad frame
+    Real uu[4] = {lf_rad, lf_rad*v1_rad, 0.0, 0.0};
+    Real u_tet_[4];
+    for (int a=0; a<4; ++a) {
+      u_tet_[a] = (norm_to_tet_(m,a,0,k,j,i)*uu[0] + norm_to_tet_(m,a,1,k,j,i)*uu[1] +
+                   norm_to_tet_(m,a,2,k,j,i)*uu[2] + norm_to_tet_(m,a,3,k,j,i)*uu[3]);
+    }
+
+    for (int n=0; n<=nang1; ++n) {
+      // direction in radiation frame
+      Real un_t =  (u_tet_[1]*nh_c_.d_view(n,1) + u_tet_[2]*nh_c_.d_view(n,2) +
+                    u_tet_[3]*nh_c_.d_view(n,3));
+      Real n0_f =  u_tet_[0]*nh_c_.d_view(n,0) - un_t;
+
+      // intensity in tetrad frame, in each group
+      Real ii_f =  erad/(4.0*M_PI);
+      Real n0 = tet_c_(m,0,0,k,j,i); Real n_0 = 0.0;
+      for (int d=0; d<4; ++d) {  n_0 += tetcov_c_(m,d,0,k,j,i)*nh_c_.d_view(n,d);  }
+      for (int g=0; g<ngroups; ++g) {
+        Real frac = (ngroups > 1)?
+                    PlanckFraction(nu_edges.d_view(g), nu_edges.d_view(g+1), trad) : 1.0;
+        i0(m,g*(nang1+1)+n,k,j,i) = n0*n_0*frac*ii_f/SQR(SQR(n0_f));
+      }
+    }
+  });
+
+  return;
+}
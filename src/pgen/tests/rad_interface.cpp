@@ -0,0 +1,114 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file rad_interface.cpp
+//! \brief Pulse of radiation crossing the boundary between optically thin and thick
+//! regions, for tests of the moment fallback (<radiation>/moment_fallback).  A fluid at
+//! rest has density d_thick for x1min_thick < x1 < x1max_thick and d_thin elsewhere.  The
+//! radiation is isotropic with energy density erad*(1 + amp*exp(-(x1-x0)^2/width^2)).
+//! With a scattering opacity, MeshBlocks in the dense region are evolved with moments,
+//! and the total radiation energy in a periodic box must be conserved.
+
+// C++ headers
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// Athena++ headers
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "radiation/radiation.hpp"
+#include "pgen/pgen.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::RadiationInterface()
+//! \brief Sets initial conditions for the thin/thick radiation interface test
+
+void ProblemGenerator::RadiationInterface(ParameterInput *pin, const bool restart) {
+  if (restart) return;
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->prad == nullptr || (pmbp->phydro == nullptr && pmbp->pmhd == nullptr)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Radiation interface test requires <radiation> and <hydro> or <mhd>"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // capture variables for kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  int nmb1 = (pmbp->nmb_thispack-1);
+  int nang1 = (pmbp->prad->prgeo->nangles-1);
+  auto &size = pmbp->pmb->mb_size;
+
+  // get problem parameters
+  Real d_thin = pin->GetOrAddReal("problem", "d_thin", 1.0);
+  Real d_thick = pin->GetOrAddReal("problem", "d_thick", 1.0e3);
+  Real x1min_thick = pin->GetOrAddReal("problem", "x1min_thick", 0.25);
+  Real x1max_thick = pin->GetOrAddReal("problem", "x1max_thick", 0.75);
+  Real temp = pin->GetOrAddReal("problem", "temp", 1.0);
+  Real erad = pin->GetOrAddReal("problem", "erad", 1.0);
+  Real amp = pin->GetOrAddReal("problem", "amp", 1.0);
+  Real x0 = pin->GetOrAddReal("problem", "x0", 0.25);
+  Real width = pin->GetOrAddReal("problem", "width", 0.05);
+
+  // set primitive variables (and fields), fluid at rest
+  bool is_mhd = (pmbp->pmhd != nullptr);
+  Real gm1 = (is_mhd)? (pmbp->pmhd->peos->eos_data.gamma - 1.0) :
+                       (pmbp->phydro->peos->eos_data.gamma - 1.0);
+  auto &w0 = (is_mhd)? pmbp->pmhd->w0 : pmbp->phydro->w0;
+  auto &u0 = (is_mhd)? pmbp->pmhd->u0 : pmbp->phydro->u0;
+  par_for("pgen_rad_int1",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real x1v = CellCenterX(i-is, indcs.nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real dens = (x1v > x1min_thick && x1v < x1max_thick)? d_thick : d_thin;
+    w0(m,IDN,k,j,i) = dens;
+    w0(m,IVX,k,j,i) = 0.0;
+    w0(m,IVY,k,j,i) = 0.0;
+    w0(m,IVZ,k,j,i) = 0.0;
+    w0(m,IEN,k,j,i) = dens*temp/gm1;
+  });
+
+  if (is_mhd) {
+    auto &b0 = pmbp->pmhd->b0;
+    auto &bcc0 = pmbp->pmhd->bcc0;
+    Kokkos::deep_copy(b0.x1f, 0.0);
+    Kokkos::deep_copy(b0.x2f, 0.0);
+    Kokkos::deep_copy(b0.x3f, 0.0);
+    Kokkos::deep_copy(bcc0, 0.0);
+    pmbp->pmhd->peos->PrimToCons(w0, bcc0, u0, 0, (n1-1), 0, (n2-1), 0, (n3-1));
+  } else {
+    pmbp->phydro->peos->PrimToCons(w0, u0, 0, (n1-1), 0, (n2-1), 0, (n3-1));
+  }
+
+  // set isotropic intensities
+  auto &nh_c_ = pmbp->prad->nh_c;
+  auto &tet_c_ = pmbp->prad->tet_c;
+  auto &tetcov_c_ = pmbp->prad->tetcov_c;
+  auto &i0 = pmbp->prad->i0;
+  par_for("pgen_rad_int2",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real x1v = CellCenterX(i-is, indcs.nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real ii = erad*(1.0 + amp*exp(-SQR((x1v - x0)/width)))/(4.0*M_PI);
+    Real n0 = tet_c_(m,0,0,k,j,i);
+    for (int n=0; n<=nang1; ++n) {
+      Real n_0 = 0.0;
+      for (int d=0; d<4; ++d) {  n_0 += tetcov_c_(m,d,0,k,j,i)*nh_c_.d_view(n,d);  }
+      i0(m,n,k,j,i) = n0*n_0*ii;
+    }
+  });
+
+  return;
+}
@@ -53,6 +53,8 @@ void ProblemGenerator::Z4cBoostedPuncture(ParameterInput *pin, const bool restar
             break;
     case 4: pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
             break;
+    case 5: pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+            break;
   }
   pmbp->pz4c->Z4cToADM(pmbp);
   pmbp->pz4c->GaugePreCollapsedLapse(pmbp, pin);
@@ -63,6 +65,8 @@ void ProblemGenerator::Z4cBoostedPuncture(ParameterInput *pin, const bool restar
             break;
     case 4: pmbp->pz4c->ADMConstraints<4>(pmbp);
             break;
+    case 5: pmbp->pz4c->ADMConstraints<5>(pmbp);
+            break;
   }
   std::cout<<"OnePuncture initialized."<<std::endl;
 
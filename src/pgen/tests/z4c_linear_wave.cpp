@@ -76,8 +76,10 @@ void ProblemGenerator::Z4cLinearWave(ParameterInput *pin, const bool restart) {
   // Wave amplitude
   Real amp = pin->GetOrAddReal("problem", "amp", 0.001);
 
-  // compute solution in u1 register. For initial conditions, set u1 -> u0.
-  auto &u1 = (set_initial_conditions)? pmbp->pz4c->u0 : pmbp->pz4c->u1;
+  // compute solution in u1 register. For initial conditions, set u1 -> u0.  With
+  // 2N-storage integrators u1 is not allocated, so u_rhs (no longer needed) is used.
+  auto &u1 = (set_initial_conditions)? pmbp->pz4c->u0 :
+             ((pmbp->pz4c->low_storage)? pmbp->pz4c->u_rhs : pmbp->pz4c->u1);
 
   // Initialize wavevector
   Real kx1 = pin->GetOrAddReal("problem", "kx1", 1. / x1size);
@@ -185,7 +187,7 @@ void Z4cLinearWaveErrors(ParameterInput *pin, Mesh *pm) {
     nvars = 6; // 6 metric components
     auto &pz4c = pmbp->pz4c;
     auto &u0_ = pmbp->pz4c->u0;
-    auto &u1_ = pmbp->pz4c->u1;
+    auto &u1_ = (pz4c->low_storage)? pz4c->u_rhs : pz4c->u1;
 
     const int nmkji = (pmbp->nmb_thispack)*nx3*nx2*nx1;
     const int nkji = nx3*nx2*nx1;
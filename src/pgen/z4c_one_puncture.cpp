@@ -53,6 +53,8 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
             break;
     case 4: pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
             break;
+    case 5: pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+            break;
   }
   pmbp->pz4c->Z4cToADM(pmbp);
   switch (indcs.ng) {
@@ -62,6 +64,8 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
             break;
     case 4: pmbp->pz4c->ADMConstraints<4>(pmbp);
             break;
+    case 5: pmbp->pz4c->ADMConstraints<5>(pmbp);
+            break;
   }
   std::cout<<"OnePuncture initialized."<<std::endl;
 
@@ -75,6 +75,9 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   case 4:
     pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
     break;
+  case 5:
+    pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+    break;
   }
 
   // Compute ADM constrains on initial data slice
@@ -88,6 +91,9 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   case 4:
     pmbp->pz4c->ADMConstraints<4>(pmbp);
     break;
+  case 5:
+    pmbp->pz4c->ADMConstraints<5>(pmbp);
+    break;
   }
 
   std::cout << "Loading initial data complete." << std::endl;
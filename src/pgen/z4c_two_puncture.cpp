@@ -181,6 +181,9 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
     case 4:
       pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
       break;
+    case 5:
+      pmbp->pz4c->ADMToZ4c<5>(pmbp, pin);
+      break;
   }
   TwoPunctures_finalise(data);
 
@@ -192,6 +195,8 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
             break;
     case 4: pmbp->pz4c->ADMConstraints<4>(pmbp);
             break;
+    case 5: pmbp->pz4c->ADMConstraints<5>(pmbp);
+            break;
   }
   std::cout << "TwoPuncture initialized." << std::endl;
   return;
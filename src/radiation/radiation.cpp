@@ -7,20 +7,25 @@
 //! \brief implementation of Radiation class constructor and assorted other functions
 
 #include <float.h>
+#include <math.h>
 
 #include <iostream>
 #include <string>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
 #include "srcterms/srcterms.hpp"
 #include "bvals/bvals.hpp"
 #include "coordinates/coordinates.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "units/units.hpp"
 #include "radiation/radiation.hpp"
+#include "radiation/radiation_tetrad.hpp"
 
 namespace radiation {
 //----------------------------------------------------------------------------------------
@@ -29,6 +34,12 @@ namespace radiation {
 Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     pmy_pack(ppack),
     i0("i0",1,1,1,1,1),
+    i0_ang("i0_ang",1,1,1,1,1),
+    mb_thick("mb_thick",1),
+    mom("mom",1,1,1,1,1),
+    mom_chi("mom_chi",1,1,1,1),
+    mflx("mflx",1,1,1,1,1),
+    nu_edges("nu_edges",1),
     i1("i1",1,1,1,1,1),
     iflx("iflx",1,1,1,1,1),
     divfa("divfa",1,1,1,1,1),
@@ -40,6 +51,7 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     tet_d2_x2f("tet_d2_x2f",1,1,1,1,1),
     tet_d3_x3f("tet_d3_x3f",1,1,1,1,1),
     na("na",1,1,1,1,1,1),
+    omega_sym("omega_sym",1,1,1,1,1),
     norm_to_tet("norm_to_tet",1,1,1,1,1,1),
     beam_mask("beam_mask",1,1,1,1,1) {
   // Check for general relativity
@@ -100,11 +112,75 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
       arad = pin->GetReal("radiation","arad");
     }
     affect_fluid = pin->GetOrAddBoolean("radiation","affect_fluid",true);
+
+    // fully implicit coupling of radiation energy and momentum with the fluid
+    implicit_coupling = pin->GetOrAddBoolean("radiation","implicit_coupling",false);
+    coupling_niter = pin->GetOrAddInteger("radiation","coupling_niter",10);
+    coupling_tol = pin->GetOrAddReal("radiation","coupling_tol",1.0e-10);
+    if (implicit_coupling && is_compton_enabled) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Compton is not supported with implicit_coupling" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (implicit_coupling && coupling_niter < 1) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<radiation>/coupling_niter must be at least 1" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // compute source term on a copy of the intensities with angles innermost
+    angle_blocked = pin->GetOrAddBoolean("radiation","angle_blocked",false);
+
+    // recover fluid primitives inside the source term kernel rather than in a separate
+    // ConsToPrim sweep over active cells
+    fused_c2p = pin->GetOrAddBoolean("radiation","fused_c2p",false);
+    if (fused_c2p && (!(is_mhd_enabled) || !(pmy_pack->pmhd->peos->eos_data.is_ideal) ||
+                      pmy_pack->pcoord->is_dynamical_relativistic)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<radiation>/fused_c2p requires <mhd> with an ideal gas EOS"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // evolve moments rather than intensities in optically thick MeshBlocks
+    moment_fallback = pin->GetOrAddBoolean("radiation","moment_fallback",false);
+    moment_tau = pin->GetOrAddReal("radiation","moment_tau",10.0);
+    if (moment_fallback && !(pmy_pack->pcoord->coord_data.is_minkowski)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<radiation>/moment_fallback only works in Minkowski spacetime"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (moment_fallback && pmy_pack->pmesh->multilevel) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<radiation>/moment_fallback does not yet work with SMR"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  } else {
+    implicit_coupling = false;
+    angle_blocked = false;
+    fused_c2p = false;
+    moment_fallback = false;
   }
 
   // Check for fluid evolution
   fixed_fluid = pin->GetOrAddBoolean("radiation","fixed_fluid",false);
 
+  // reduced speed of light (as fraction of c), which increases the radiation timestep
+  reduced_c = pin->GetOrAddReal("radiation","reduced_c",1.0);
+  if (reduced_c <= 0.0 || reduced_c > 1.0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<radiation>/reduced_c must be in (0,1]" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (reduced_c < 1.0 && !(pmy_pack->pcoord->coord_data.is_minkowski)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<radiation>/reduced_c < 1 only works in Minkowski spacetime"
+      << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
   // Other rad source terms (constructor parses input file to init only srcterms needed)
   beam_source = pin->GetOrAddBoolean("radiation","beam_source",false);
   psrc = new SourceTerms("radiation", ppack, pin);
@@ -113,9 +189,61 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   int nlevel = pin->GetInteger("radiation", "nlevel");
   rotate_geo = pin->GetOrAddBoolean("radiation","rotate_geo",true);
   angular_fluxes = pin->GetOrAddBoolean("radiation","angular_fluxes",true);
+  // store NOMEGA_SYM coefficients per cell rather than n^a per cell per angle
+  compress_na = pin->GetOrAddBoolean("radiation","compress_na",false);
   n_0_floor = pin->GetOrAddReal("radiation","n_0_floor",0.1);
   prgeo = new GeodesicGrid(nlevel, rotate_geo, angular_fluxes);
 
+  // Restart files store the level and orientation of the angular mesh they were written
+  // with.  If these differ from the current ones, intensities read from the restart file
+  // are remapped onto the new mesh by RemapAngles()
+  int nlevel_rst = pin->GetOrAddInteger("radiation", "restart_nlevel", nlevel);
+  bool rotate_rst = pin->GetOrAddBoolean("radiation", "restart_rotate_geo", rotate_geo);
+  if (nlevel_rst != nlevel || rotate_rst != rotate_geo) {
+    prgeo_rst = new GeodesicGrid(nlevel_rst, rotate_rst, false);
+  }
+  pin->SetInteger("radiation", "restart_nlevel", nlevel);
+  pin->SetBoolean("radiation", "restart_rotate_geo", rotate_geo);
+
+  // Frequency groups.  The first group extends down to zero and the last up to
+  // infinite frequency, with the ngroups-1 edges in between spaced logarithmically in
+  // [nu_min,nu_max].  Frequencies are in units of k_B/h times the code temperature.
+  // Opacities are the same in all groups, and emission is split between groups by the
+  // Planck function at the gas temperature (see AddSourceTerm).  Frequency shifts
+  // between groups (Doppler and gravitational) are neglected.
+  ngroups = pin->GetOrAddInteger("radiation","ngroups",1);
+  if (ngroups < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<radiation>/ngroups must be at least 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  nintens = ngroups*prgeo->nangles;
+  Kokkos::realloc(nu_edges, ngroups+1);
+  nu_edges.h_view(0) = 0.0;
+  nu_edges.h_view(ngroups) = FLT_MAX;
+  if (ngroups > 1) {
+    Real nu_min = pin->GetOrAddReal("radiation","nu_min",0.1);
+    Real nu_max = pin->GetOrAddReal("radiation","nu_max",10.0);
+    if (nu_min <= 0.0 || (ngroups > 2 && nu_max <= nu_min)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<radiation>/nu_min and nu_max must satisfy 0 < nu_min < nu_max"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    for (int g=1; g<ngroups; ++g) {
+      nu_edges.h_view(g) = (ngroups == 2)? nu_min :
+                           nu_min*pow(nu_max/nu_min, static_cast<Real>(g-1)/(ngroups-2));
+    }
+    if ((rad_source && (is_compton_enabled || moment_fallback)) || beam_source) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<radiation>/ngroups > 1 is not supported with Compton, "
+        << "moment_fallback, or beam_source" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  nu_edges.template modify<HostMemSpace>();
+  nu_edges.template sync<DevExeSpace>();
+
   int nmb = ppack->nmb_thispack;
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   {
@@ -129,7 +257,13 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   Kokkos::realloc(tet_d1_x1f,nmb,4,ncells3,ncells2,ncells1+1);
   Kokkos::realloc(tet_d2_x2f,nmb,4,ncells3,ncells2+1,ncells1);
   Kokkos::realloc(tet_d3_x3f,nmb,4,ncells3+1,ncells2,ncells1);
-  if (angular_fluxes) {Kokkos::realloc(na,nmb,prgeo->nangles,ncells3,ncells2,ncells1,6);}
+  if (angular_fluxes) {
+    if (compress_na) {
+      Kokkos::realloc(omega_sym,nmb,NOMEGA_SYM,ncells3,ncells2,ncells1);
+    } else {
+      Kokkos::realloc(na,nmb,prgeo->nangles,ncells3,ncells2,ncells1,6);
+    }
+  }
   if (is_hydro_enabled || is_mhd_enabled) {
     Kokkos::realloc(norm_to_tet,nmb,4,4,ncells3,ncells2,ncells1);
   }
@@ -145,7 +279,10 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
   int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
   int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-  Kokkos::realloc(i0,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+  Kokkos::realloc(i0,nmb,nintens,ncells3,ncells2,ncells1);
+  if (angle_blocked) {
+    Kokkos::realloc(i0_ang,nmb,indcs.nx3,indcs.nx2,indcs.nx1,nintens);
+  }
   }
 
   // allocate memory for conserved variables on coarse mesh
@@ -154,12 +291,13 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     int nccells1 = indcs.cnx1 + 2*(indcs.ng);
     int nccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
     int nccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(coarse_i0,nmb,prgeo->nangles,nccells3,nccells2,nccells1);
+    Kokkos::realloc(coarse_i0,nmb,nintens,nccells3,nccells2,nccells1);
   }
 
   // allocate boundary buffers for conserved (cell-centered) variables
   pbval_i = new MeshBoundaryValuesCC(ppack, pin, false);
-  pbval_i->InitializeBuffers(prgeo->nangles);
+  pbval_i->SetReducedPrecision(pin, "radiation");
+  pbval_i->InitializeBuffers(nintens);
 
   // for time-evolving problems, continue to construct methods, allocate arrays
   if (evolution_t.compare("stationary") != 0) {
@@ -198,16 +336,66 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     int ncells1 = indcs.nx1 + 2*(indcs.ng);
     int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
     int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(i1,      nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x1f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x2f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x3f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+    Kokkos::realloc(i1,      nmb,nintens,ncells3,ncells2,ncells1);
+    Kokkos::realloc(iflx.x1f,nmb,nintens,ncells3,ncells2,ncells1);
+    Kokkos::realloc(iflx.x2f,nmb,nintens,ncells3,ncells2,ncells1);
+    Kokkos::realloc(iflx.x3f,nmb,nintens,ncells3,ncells2,ncells1);
     if (angular_fluxes) {
-      Kokkos::realloc(divfa,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+      Kokkos::realloc(divfa,nmb,nintens,ncells3,ncells2,ncells1);
     }
     if (beam_source) {
       Kokkos::realloc(beam_mask,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
     }
+    if (moment_fallback) {
+      Kokkos::realloc(mb_thick,nmb);
+      Kokkos::realloc(mom,     nmb,4,ncells3,ncells2,ncells1);
+      Kokkos::realloc(mom_chi, nmb,ncells3,ncells2,ncells1);
+      Kokkos::realloc(mflx.x1f,nmb,4,ncells3,ncells2,ncells1);
+      Kokkos::realloc(mflx.x2f,nmb,4,ncells3,ncells2,ncells1);
+      Kokkos::realloc(mflx.x3f,nmb,4,ncells3,ncells2,ncells1);
+      Kokkos::deep_copy(mb_thick, 0);
+    }
+
+    // optionally store the fluxes of the fluid in the storage of the radiation fluxes
+    share_fluxes = pin->GetOrAddBoolean("radiation","share_fluxes",false);
+    if (share_fluxes) {ShareFluxes(pin);}
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::ShareFluxes()
+//! \brief Replaces each component of Hydro/MHD::uflx by a View of the same shape over the
+//! storage of the same component of iflx (when it is large enough), freeing the memory of
+//! the fluid fluxes.  This is only valid because of the order of tasks in the stagen list
+//! (see AssembleRadTasks): iflx is computed by CalculateFluxes and last read by
+//! RKUpdate, and the fluid fluxes are computed only after RKUpdate, and are last read
+//! (by RKUpdate and CornerE) before CalculateFluxes of the next stage.  Particles read
+//! the fluid fluxes in their own task list, so are not supported.
+
+void Radiation::ShareFluxes(ParameterInput *pin) {
+  hydro::Hydro *phyd = pmy_pack->phydro;
+  mhd::MHD *pmhd = pmy_pack->pmhd;
+  if ((phyd == nullptr && pmhd == nullptr) || fixed_fluid ||
+      pin->DoesBlockExist("particles")) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<radiation>/share_fluxes requires an evolved <hydro> or <mhd> "
+      << "fluid, and no <particles>" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  auto &uflx = (pmhd != nullptr)? pmhd->uflx : phyd->uflx;
+  auto share = [](const DvceArray5D<FluxReal> &src, DvceArray5D<FluxReal> &dst) {
+    if (src.span() < dst.span()) {return false;}
+    dst = DvceArray5D<FluxReal>(src.data(), dst.extent(0), dst.extent(1), dst.extent(2),
+                                dst.extent(3), dst.extent(4));
+    return true;
+  };
+  bool shared1 = share(iflx.x1f, uflx.x1f);
+  bool shared2 = share(iflx.x2f, uflx.x2f);
+  bool shared3 = share(iflx.x3f, uflx.x3f);
+  if (global_variable::my_rank == 0 && !(shared1 && shared2 && shared3)) {
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+      << "<radiation>/share_fluxes: not enough angles to hold fluid fluxes, only "
+      << (shared1 + shared2 + shared3) << " of 3 components shared" << std::endl;
   }
 }
 
@@ -217,6 +405,7 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
 Radiation::~Radiation() {
   delete pbval_i;
   delete prgeo;
+  if (prgeo_rst != nullptr) {delete prgeo_rst;}
   if (psrc != nullptr) {delete psrc;}
 }
 
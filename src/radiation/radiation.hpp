@@ -78,6 +78,22 @@ struct RadiationTaskIDs {
 
 namespace radiation {
 
+//----------------------------------------------------------------------------------------
+//! \struct AngleBlockedIntensity
+//! \brief accessor for intensities over active cells stored with the angle index
+//! innermost, i.e. (m,k,j,i,n).  Indexed as (m,n,k,j,i) like i0, so kernels templated
+//! over the intensity array can use either layout.
+
+struct AngleBlockedIntensity {
+  DvceArray5D<Real> a;
+  int ks, js, is;
+  KOKKOS_INLINE_FUNCTION
+  Real &operator()(const int m, const int n, const int k, const int j,
+                   const int i) const {
+    return a(m,k-ks,j-js,i-is,n);
+  }
+};
+
 //----------------------------------------------------------------------------------------
 //! \class Radiation
 
@@ -101,6 +117,23 @@ class Radiation {
   Real kappa_p;             // Planck - Rosseland mean coefficient
   bool power_opacity;       // flag to enable Kramer's law opacity for kappa_a
   bool is_compton_enabled;  // flag to enable/disable compton
+  bool implicit_coupling;   // flag to also iterate on fluid velocity in source term
+  int coupling_niter;       // max number of iterations for implicit coupling
+  Real coupling_tol;        // tolerance on fluid velocity for implicit coupling
+  bool angle_blocked;       // flag to compute source term with angles innermost
+  bool fused_c2p;           // flag to compute MHD primitives inside source term kernel
+
+  // Reduced speed of light approximation: transport and the radiation side of the
+  // source term use c_hat, while the fluid is still coupled with the physical c
+  Real reduced_c;           // ratio c_hat/c of reduced to physical speed of light
+
+  // Moment fallback in optically thick MeshBlocks (see radiation_moments.cpp)
+  bool moment_fallback;     // flag to evolve moments in optically thick MeshBlocks
+  Real moment_tau;          // min optical depth of cells for MeshBlock to be thick
+  DvceArray1D<int> mb_thick;    // flags MeshBlocks evolved with moments
+  DvceArray5D<Real> mom;        // moments E, F^i of intensity
+  DvceArray4D<Real> mom_chi;    // total opacity used for moments
+  DvceFaceFld5D<Real> mflx;     // fluxes of moments on zone faces
 
   // Extra physics (i.e., other srcterms)
   bool beam_source;
@@ -109,8 +142,17 @@ class Radiation {
   // Angular mesh
   bool rotate_geo;                    // rotate geodesic mesh
   bool angular_fluxes;                // flag to enable/disable angular fluxes
+  bool compress_na;                   // flag to recompute n^a from omega_sym on the fly
   Real n_0_floor;                     // floor on n_0
   GeodesicGrid *prgeo = nullptr;      // pointer to radiation angular mesh
+  GeodesicGrid *prgeo_rst = nullptr;  // angular mesh of restart file, if different
+
+  // Frequency groups.  The intensity of group g along angle n is stored in i0 (and all
+  // other intensity arrays) at index g*nangles + n, so that the kernels over angles
+  // loop over all groups with the same launches.
+  int ngroups;                        // number of frequency groups (1 for grey)
+  int nintens;                        // number of intensities per cell, ngroups*nangles
+  DualArray1D<Real> nu_edges;         // group edges in units of k_B/h times code temp
 
   // Tetrad arrays and functions
   DualArray2D<Real> nh_c;             // normal vector computed at face center
@@ -121,19 +163,23 @@ class Radiation {
   DvceArray5D<Real> tet_d2_x2f;       // tetrad components (subset) at x2f
   DvceArray5D<Real> tet_d3_x3f;       // tetrad components (subset) at x3f
   DvceArray6D<Real> na;               // n^a
+  DvceArray5D<Real> omega_sym;        // symmetric Ricci rotation coeffs (compress_na)
   DvceArray6D<Real> norm_to_tet;      // used in transform b/w normal frame and tet frame
   void SetOrthonormalTetrad();
+  void RemapAngles(const DvceArray5D<Real> &i_rst);
 
   // intensity arrays
   DvceArray5D<Real> i0;         // intensities
   DvceArray5D<Real> coarse_i0;  // intensities on 2x coarser grid (for SMR/AMR)
+  DvceArray5D<Real> i0_ang;     // active-cell intensities with angles innermost
 
   // Boundary communication buffers and functions for i
   MeshBoundaryValuesCC *pbval_i;
 
   // following only used for time-evolving flow
   DvceArray5D<Real> i1;         // intensity at intermediate step
-  DvceFaceFld5D<Real> iflx;     // spatial fluxes on zone faces
+  DvceFaceFld5D<FluxReal> iflx; // spatial fluxes on zone faces
+  bool share_fluxes = false;    // flag to store fluid fluxes in storage of iflx
   DvceArray5D<Real> divfa;      // angular flux divergence
   DvceArray5D<bool> beam_mask;  // boolean mask used for beam source term
   Real dtnew;
@@ -146,15 +192,24 @@ class Radiation {
 
   // functions...
   void AssembleRadTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  void ShareFluxes(ParameterInput *pin);
   // ...in "before_stagen_tl" task list
   TaskStatus InitRecv(Driver *d, int stage);
   // ...in "stagen_tl" task list
   TaskStatus CopyCons(Driver *d, int stage);
   TaskStatus CalculateFluxes(Driver *d, int stage);
+  template <int nnb>
+  void AngularFluxDivergence(const DualArray1D<int> &angles);
   TaskStatus SendFlux(Driver *d, int stage);
   TaskStatus RecvFlux(Driver *d, int stage);
   TaskStatus RKUpdate(Driver *d, int stage);
   TaskStatus AddRadiationSourceTerm(Driver *d, int stage);
+  template <typename IArray>
+  void AddSourceTerm(Driver *d, int stage, const IArray &iarr);
+  void TransposeIntensity(bool to_angle_blocked);
+  void SetMomentOpacity(bool select_blocks);
+  void CalculateMomentFluxes(int stage);
+  void MomentUpdate(Driver *d, int stage);
   TaskStatus RestrictI(Driver *d, int stage);
   TaskStatus SendI(Driver *d, int stage);
   TaskStatus RecvI(Driver *d, int stage);
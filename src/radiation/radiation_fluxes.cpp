@@ -14,6 +14,7 @@
 #include "eos/eos.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "radiation.hpp"
+#include "radiation_tetrad.hpp"
 #include "reconstruct/dc.hpp"
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
@@ -29,7 +30,10 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
   int &is = indcs.is, &ie = indcs.ie;
   int &js = indcs.js, &je = indcs.je;
   int &ks = indcs.ks, &ke = indcs.ke;
-  int nang1 = prgeo->nangles - 1;
+  // intensities of all groups are computed in the same kernels, with the geometry of
+  // angle a = n % nang
+  int nang = prgeo->nangles;
+  int nint1 = nintens - 1;
   int nmb1 = pmy_pack->nmb_thispack - 1;
 
   const auto &recon_method_ = recon_method;
@@ -37,17 +41,29 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
   auto &i0_ = i0;
   auto &nh_c_ = nh_c;
   auto &tet_c_ = tet_c;
+  // fluxes are proportional to the (reduced) speed of light
+  Real rc_ = reduced_c;
+
+  // optically thick MeshBlocks evolve moments, and skip the angle-resolved fluxes except
+  // on faces at MeshBlock boundaries, which are shared with (possibly thin) neighbors
+  bool moment_fallback_ = moment_fallback;
+  auto &mb_thick_ = mb_thick;
+  if (moment_fallback) {
+    SetMomentOpacity(stage == 1);
+  }
 
   //--------------------------------------------------------------------------------------
   // i-direction
 
   auto &t1d1 = tet_d1_x1f;
   auto &flx1 = iflx.x1f;
-  par_for("rflux_x1",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie+1,
+  par_for("rflux_x1",DevExeSpace(),0,nmb1,0,nint1,ks,ke,js,je,is,ie+1,
   KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    if (moment_fallback_ && mb_thick_(m) && i != is && i != ie+1) return;
     // calculate n^1 (hence determining upwinding direction)
-    Real n1 = t1d1(m,0,k,j,i)*nh_c_.d_view(n,0) + t1d1(m,1,k,j,i)*nh_c_.d_view(n,1)
-            + t1d1(m,2,k,j,i)*nh_c_.d_view(n,2) + t1d1(m,3,k,j,i)*nh_c_.d_view(n,3);
+    const int a = n % nang;
+    Real n1 = t1d1(m,0,k,j,i)*nh_c_.d_view(a,0) + t1d1(m,1,k,j,i)*nh_c_.d_view(a,1)
+            + t1d1(m,2,k,j,i)*nh_c_.d_view(a,2) + t1d1(m,3,k,j,i)*nh_c_.d_view(a,3);
 
     // convert to primitive n_0 I
     Real iim1, iicc, iim2, iip1, iim3, iip2;
@@ -90,7 +106,7 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
     }
 
     // compute x1flux
-    flx1(m,n,k,j,i) = n1*iiu;
+    flx1(m,n,k,j,i) = rc_*n1*iiu;
   });
 
   //--------------------------------------------------------------------------------------
@@ -99,11 +115,13 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
   if (pmy_pack->pmesh->multi_d) {
     auto &t2d2 = tet_d2_x2f;
     auto &flx2 = iflx.x2f;
-    par_for("rflux_x2",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je+1,is,ie,
+    par_for("rflux_x2",DevExeSpace(),0,nmb1,0,nint1,ks,ke,js,je+1,is,ie,
     KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      if (moment_fallback_ && mb_thick_(m) && j != js && j != je+1) return;
       // calculate n^2 (hence determining upwinding direction)
-      Real n2 = t2d2(m,0,k,j,i)*nh_c_.d_view(n,0) + t2d2(m,1,k,j,i)*nh_c_.d_view(n,1)
-              + t2d2(m,2,k,j,i)*nh_c_.d_view(n,2) + t2d2(m,3,k,j,i)*nh_c_.d_view(n,3);
+      const int a = n % nang;
+      Real n2 = t2d2(m,0,k,j,i)*nh_c_.d_view(a,0) + t2d2(m,1,k,j,i)*nh_c_.d_view(a,1)
+              + t2d2(m,2,k,j,i)*nh_c_.d_view(a,2) + t2d2(m,3,k,j,i)*nh_c_.d_view(a,3);
 
       // convert to primitive n_0 I
       Real iim1, iicc, iim2, iip1, iim3, iip2;
@@ -146,7 +164,7 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
       }
 
       // compute x2flux
-      flx2(m,n,k,j,i) = n2*iiu;
+      flx2(m,n,k,j,i) = rc_*n2*iiu;
     });
   }
 
@@ -156,11 +174,13 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
   if (pmy_pack->pmesh->three_d) {
     auto &t3d3 = tet_d3_x3f;
     auto &flx3 = iflx.x3f;
-    par_for("rflux_x3",DevExeSpace(),0,nmb1,0,nang1,ks,ke+1,js,je,is,ie,
+    par_for("rflux_x3",DevExeSpace(),0,nmb1,0,nint1,ks,ke+1,js,je,is,ie,
     KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      if (moment_fallback_ && mb_thick_(m) && k != ks && k != ke+1) return;
       // calculate n^3 (hence determining upwinding direction)
-      Real n3 = t3d3(m,0,k,j,i)*nh_c_.d_view(n,0) + t3d3(m,1,k,j,i)*nh_c_.d_view(n,1)
-              + t3d3(m,2,k,j,i)*nh_c_.d_view(n,2) + t3d3(m,3,k,j,i)*nh_c_.d_view(n,3);
+      const int a = n % nang;
+      Real n3 = t3d3(m,0,k,j,i)*nh_c_.d_view(a,0) + t3d3(m,1,k,j,i)*nh_c_.d_view(a,1)
+              + t3d3(m,2,k,j,i)*nh_c_.d_view(a,2) + t3d3(m,3,k,j,i)*nh_c_.d_view(a,3);
 
       // convert to primitive n_0 I
       Real iim1, iicc, iim2, iip1, iim3, iip2;
@@ -203,36 +223,88 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
       }
 
       // compute x3flux
-      flx3(m,n,k,j,i) = n3*iiu;
+      flx3(m,n,k,j,i) = rc_*n3*iiu;
     });
   }
 
+  // moment fluxes in optically thick MeshBlocks, which use the angle-resolved fluxes
+  // computed above on MeshBlock boundaries
+  if (moment_fallback) {
+    CalculateMomentFluxes(stage);
+  }
+
   //--------------------------------------------------------------------------------------
   // Angular Fluxes
 
   if (angular_fluxes) {
-    auto &numn = prgeo->num_neighbors;
-    auto &indn = prgeo->ind_neighbors;
-    auto &arcl = prgeo->arc_lengths;
-    auto &solid_angles_ = prgeo->solid_angles;
-
-    auto &na_ = na;
-    auto &divfa_ = divfa;
-
-    par_for("rflux_angular",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
-    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-      divfa_(m,n,k,j,i) = 0.0;
-      for (int nb=0; nb<numn.d_view(n); ++nb) {
-        Real flx_edge = na_(m,n,k,j,i,nb) *
-                        ((na_(m,n,k,j,i,nb) < 0.0) ?
-                         i0_(m,indn.d_view(n,nb),k,j,i)/tet_c_(m,0,0,k,j,i) :
-                         i0_(m,n,k,j,i)/tet_c_(m,0,0,k,j,i));
-        divfa_(m,n,k,j,i) += (arcl.d_view(n,nb)*flx_edge/solid_angles_.d_view(n));
-      }
-    });
+    // hexagons and pentagons are done separately, with loops of fixed length over edges
+    if (prgeo->hex_angles.extent_int(0) > 0) {
+      AngularFluxDivergence<6>(prgeo->hex_angles);
+    }
+    AngularFluxDivergence<5>(prgeo->pent_angles);
   }
 
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn  void Radiation::AngularFluxDivergence
+//! \brief Compute divergence of angular fluxes for the angles in list angles, all of
+//! which have nnb neighbors, in all frequency groups
+
+template <int nnb>
+void Radiation::AngularFluxDivergence(const DualArray1D<int> &angles) {
+  RegionIndcs &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int nlist = angles.extent_int(0);
+  int nang = prgeo->nangles;
+  int nlg1 = ngroups*nlist - 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+
+  auto &i0_ = i0;
+  auto &tet_c_ = tet_c;
+  bool moment_fallback_ = moment_fallback;
+  auto &mb_thick_ = mb_thick;
+
+  auto &indn = prgeo->ind_neighbors;
+  auto &arc_omega = prgeo->arc_over_omega;
+  auto &na_ = na;
+  auto &omega_sym_ = omega_sym;
+  bool compress_na_ = compress_na;
+  auto &nh_f_ = nh_f;
+  auto &uflux = prgeo->unit_flux;
+  auto &divfa_ = divfa;
+  Real rc_ = reduced_c;
+
+  par_for("rflux_angular",DevExeSpace(),0,nmb1,0,nlg1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int lg, int k, int j, int i) {
+    // fluxes only couple angles within the same group g
+    const int g = lg/nlist;
+    const int a = angles.d_view(lg - g*nlist);
+    const int n = g*nang + a;
+    divfa_(m,n,k,j,i) = 0.0;
+    if (moment_fallback_ && mb_thick_(m)) return;
+    Real iicc = i0_(m,n,k,j,i)/tet_c_(m,0,0,k,j,i);
+    Real div = 0.0;
+    for (int nb=0; nb<nnb; ++nb) {
+      Real na_nb;
+      if (compress_na_) {
+        Real nh[4] = {nh_f_.d_view(a,nb,0), nh_f_.d_view(a,nb,1),
+                      nh_f_.d_view(a,nb,2), nh_f_.d_view(a,nb,3)};
+        na_nb = AngularFluxCoefficient(omega_sym_, m, k, j, i, nh,
+                                       uflux.d_view(a,nb,0), uflux.d_view(a,nb,1));
+      } else {
+        na_nb = na_(m,a,k,j,i,nb);
+      }
+      Real flx_edge = na_nb *
+                      ((na_nb < 0.0) ?
+                       i0_(m,g*nang+indn.d_view(a,nb),k,j,i)/tet_c_(m,0,0,k,j,i) : iicc);
+      div += arc_omega.d_view(a,nb)*flx_edge;
+    }
+    divfa_(m,n,k,j,i) = rc_*div;
+  });
+}
+
 } // namespace radiation
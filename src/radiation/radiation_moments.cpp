@@ -0,0 +1,367 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file radiation_moments.cpp
+//! \brief Moment fallback for optically thick MeshBlocks.  In MeshBlocks in which the
+//! optical depth of every active cell exceeds <radiation>/moment_tau, the angle-resolved
+//! spatial fluxes are replaced by fluxes of the moments E, F^i of the intensity, using
+//! the P1 (Eddington) closure that M1 reduces to in the diffusion limit.  The numerical
+//! dissipation is scaled by 1/(cell optical depth) so that the scheme recovers the
+//! correct diffusion rate.  Intensities are kept in i0 in every MeshBlock: after each
+//! update they are reset from the moments with I = (E + 3 n.F)/(4pi), so boundary
+//! communication is unchanged.  On faces at MeshBlock boundaries the flux of moments is
+//! always the angle integral of the angle-resolved flux, which is computed from the same
+//! intensities as in the neighbor, so that the update is conservative across boundaries
+//! between thick and thin MeshBlocks.  The (implicit) source term is applied to i0 as
+//! usual.  Only implemented for Minkowski spacetime.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "units/units.hpp"
+#include "radiation.hpp"
+#include "radiation/radiation_opacities.hpp"
+
+namespace radiation {
+//----------------------------------------------------------------------------------------
+//! \fn void MomentFlux()
+//! \brief Dissipation-limited LLF flux of (E, F^1, F^2, F^3) in direction dir with the
+//! P1 closure P^ij = E/3 delta^ij and signal speed 1 (c=1), reduced by factor eps.
+
+KOKKOS_INLINE_FUNCTION
+void MomentFlux(const Real ul[4], const Real ur[4], const int dir, const Real eps,
+                Real flx[4]) {
+  Real fl[4], fr[4];
+  fl[0] = ul[dir];
+  fr[0] = ur[dir];
+  for (int v=1; v<4; ++v) {
+    fl[v] = (v == dir)? ul[0]/3.0 : 0.0;
+    fr[v] = (v == dir)? ur[0]/3.0 : 0.0;
+  }
+  for (int v=0; v<4; ++v) {
+    flx[v] = 0.5*(fl[v] + fr[v]) - 0.5*eps*(ur[v] - ul[v]);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::SetMomentOpacity(bool select_blocks)
+//! \brief Sets total (absorption plus scattering) opacity in every cell.  If
+//! select_blocks, also flags MeshBlocks in which the optical depth of every active cell
+//! exceeds moment_tau to be evolved with moments.
+
+void Radiation::SetMomentOpacity(bool select_blocks) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int n1 = indcs.nx1 + 2*(indcs.ng);
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto &size = pmy_pack->pmb->mb_size;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  // Extract units and opacity parameters
+  Real density_scale_ = 1.0, temperature_scale_ = 1.0, length_scale_ = 1.0;
+  Real mean_mol_weight_ = 1.0;
+  Real rosseland_coef_ = 1.0, planck_minus_rosseland_coef_ = 0.0;
+  if (are_units_enabled) {
+    density_scale_ = pmy_pack->punit->density_cgs();
+    temperature_scale_ = pmy_pack->punit->temperature_cgs();
+    length_scale_ = pmy_pack->punit->length_cgs();
+    mean_mol_weight_ = pmy_pack->punit->mu();
+    rosseland_coef_ = pmy_pack->punit->rosseland_coef_cgs;
+    planck_minus_rosseland_coef_ = pmy_pack->punit->planck_minus_rosseland_coef_cgs;
+  }
+  Real &kappa_a_ = kappa_a;
+  Real &kappa_s_ = kappa_s;
+  Real &kappa_p_ = kappa_p;
+  bool &power_opacity_ = power_opacity;
+
+  // Extract fluid primitives and adiabatic index
+  Real gm1;
+  DvceArray5D<Real> w0_;
+  if (is_hydro_enabled) {
+    gm1 = pmy_pack->phydro->peos->eos_data.gamma - 1.0;
+    w0_ = pmy_pack->phydro->w0;
+  } else {
+    gm1 = pmy_pack->pmhd->peos->eos_data.gamma - 1.0;
+    w0_ = pmy_pack->pmhd->w0;
+  }
+
+  auto &chi_ = mom_chi;
+  par_for("rad_mom_chi",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real &wdn = w0_(m,IDN,k,j,i);
+    Real tgas = gm1*w0_(m,IEN,k,j,i)/wdn;
+    Real sigma_a, sigma_s, sigma_p;
+    OpacityFunction(wdn, density_scale_,
+                    tgas, temperature_scale_,
+                    length_scale_, gm1, mean_mol_weight_,
+                    power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
+                    kappa_a_, kappa_s_, kappa_p_,
+                    sigma_a, sigma_s, sigma_p);
+    chi_(m,k,j,i) = sigma_a + sigma_s;
+  });
+
+  if (!(select_blocks)) return;
+
+  int nx1 = indcs.nx1, nx2 = indcs.nx2;
+  int nkji = indcs.nx3*nx2*nx1;
+  int nji  = nx2*nx1;
+  Real &tau_ = moment_tau;
+  auto &mb_thick_ = mb_thick;
+  par_for_outer("rad_mom_select",DevExeSpace(),0,0,0,nmb1,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m) {
+    Real dxmin = size.d_view(m).dx1;
+    if (multi_d) { dxmin = fmin(dxmin, size.d_view(m).dx2); }
+    if (three_d) { dxmin = fmin(dxmin, size.d_view(m).dx3); }
+    Real chimin;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, nkji),
+    [&](const int idx, Real &cmin) {
+      int k = (idx)/nji;
+      int j = (idx - k*nji)/nx1;
+      int i = (idx - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      cmin = fmin(cmin, chi_(m,k,j,i));
+    }, Kokkos::Min<Real>(chimin));
+    Kokkos::single(Kokkos::PerTeam(member), [&]() {
+      mb_thick_(m) = (chimin*dxmin > tau_)? 1 : 0;
+    });
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::CalculateMomentFluxes(int stage)
+//! \brief Computes moments of i0 and their fluxes on all faces of active cells in
+//! MeshBlocks flagged by mb_thick.  Fluxes on interior faces use the P1 closure, while
+//! fluxes on MeshBlock faces are moments of the angle-resolved fluxes in iflx, which
+//! must be computed first.  Opacities and mb_thick are set by SetMomentOpacity().
+
+void Radiation::CalculateMomentFluxes(int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int nang1 = prgeo->nangles - 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto &size = pmy_pack->pmb->mb_size;
+
+  auto &i0_ = i0;
+  auto &nh_c_ = nh_c;
+  auto &tt = tet_c;
+  auto &tc = tetcov_c;
+  auto &solid_angles_ = prgeo->solid_angles;
+  auto &mb_thick_ = mb_thick;
+  auto &mom_ = mom;
+  auto &chi_ = mom_chi;
+  Real rc_ = reduced_c;
+
+  par_for("rad_mom",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    if (!(mb_thick_(m))) return;
+    Real n0 = tt(m,0,0,k,j,i);
+    Real u[4] = {0.0};
+    for (int n=0; n<=nang1; ++n) {
+      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
+                 tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+      Real wi = i0_(m,n,k,j,i)/(n0*n_0)*solid_angles_.d_view(n);
+      u[0] += wi;
+      u[1] += nh_c_.d_view(n,1)*wi;
+      u[2] += nh_c_.d_view(n,2)*wi;
+      u[3] += nh_c_.d_view(n,3)*wi;
+    }
+    for (int v=0; v<4; ++v) { mom_(m,v,k,j,i) = u[v]; }
+  });
+
+  auto &flx1 = mflx.x1f;
+  auto &iflx_1 = iflx.x1f;
+  par_for("rad_mom_flx1",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie+1,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    if (!(mb_thick_(m))) return;
+    if (i == is || i == ie+1) {
+      // moments of angle-resolved flux, with tetrad of the adjacent active cell
+      int ic = (i == is)? i : i-1;
+      Real n0 = tt(m,0,0,k,j,ic);
+      Real t0 = tc(m,0,0,k,j,ic), t1 = tc(m,1,0,k,j,ic);
+      Real t2 = tc(m,2,0,k,j,ic), t3 = tc(m,3,0,k,j,ic);
+      Real f[4] = {0.0};
+      for (int n=0; n<=nang1; ++n) {
+        Real n_0 = t0*nh_c_.d_view(n,0) + t1*nh_c_.d_view(n,1) +
+                   t2*nh_c_.d_view(n,2) + t3*nh_c_.d_view(n,3);
+        Real wf = iflx_1(m,n,k,j,i)/(n0*n_0)*solid_angles_.d_view(n);
+        f[0] += wf;
+        f[1] += nh_c_.d_view(n,1)*wf;
+        f[2] += nh_c_.d_view(n,2)*wf;
+        f[3] += nh_c_.d_view(n,3)*wf;
+      }
+      for (int v=0; v<4; ++v) { flx1(m,v,k,j,i) = f[v]; }
+      return;
+    }
+    Real eps = fmin(1.0, 2.0/((chi_(m,k,j,i-1) + chi_(m,k,j,i))*size.d_view(m).dx1));
+    Real ul[4], ur[4], f[4];
+    for (int v=0; v<4; ++v) {
+      ul[v] = mom_(m,v,k,j,i-1);
+      ur[v] = mom_(m,v,k,j,i);
+    }
+    MomentFlux(ul, ur, 1, eps, f);
+    for (int v=0; v<4; ++v) { flx1(m,v,k,j,i) = rc_*f[v]; }
+  });
+
+  if (pmy_pack->pmesh->multi_d) {
+    auto &flx2 = mflx.x2f;
+    auto &iflx_2 = iflx.x2f;
+    par_for("rad_mom_flx2",DevExeSpace(),0,nmb1,ks,ke,js,je+1,is,ie,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      if (!(mb_thick_(m))) return;
+      if (j == js || j == je+1) {
+        // moments of angle-resolved flux, with tetrad of the adjacent active cell
+        int jc = (j == js)? j : j-1;
+        Real n0 = tt(m,0,0,k,jc,i);
+        Real t0 = tc(m,0,0,k,jc,i), t1 = tc(m,1,0,k,jc,i);
+        Real t2 = tc(m,2,0,k,jc,i), t3 = tc(m,3,0,k,jc,i);
+        Real f[4] = {0.0};
+        for (int n=0; n<=nang1; ++n) {
+          Real n_0 = t0*nh_c_.d_view(n,0) + t1*nh_c_.d_view(n,1) +
+                     t2*nh_c_.d_view(n,2) + t3*nh_c_.d_view(n,3);
+          Real wf = iflx_2(m,n,k,j,i)/(n0*n_0)*solid_angles_.d_view(n);
+          f[0] += wf;
+          f[1] += nh_c_.d_view(n,1)*wf;
+          f[2] += nh_c_.d_view(n,2)*wf;
+          f[3] += nh_c_.d_view(n,3)*wf;
+        }
+        for (int v=0; v<4; ++v) { flx2(m,v,k,j,i) = f[v]; }
+        return;
+      }
+      Real eps = fmin(1.0, 2.0/((chi_(m,k,j-1,i) + chi_(m,k,j,i))*size.d_view(m).dx2));
+      Real ul[4], ur[4], f[4];
+      for (int v=0; v<4; ++v) {
+        ul[v] = mom_(m,v,k,j-1,i);
+        ur[v] = mom_(m,v,k,j,i);
+      }
+      MomentFlux(ul, ur, 2, eps, f);
+      for (int v=0; v<4; ++v) { flx2(m,v,k,j,i) = rc_*f[v]; }
+    });
+  }
+
+  if (pmy_pack->pmesh->three_d) {
+    auto &flx3 = mflx.x3f;
+    auto &iflx_3 = iflx.x3f;
+    par_for("rad_mom_flx3",DevExeSpace(),0,nmb1,ks,ke+1,js,je,is,ie,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      if (!(mb_thick_(m))) return;
+      if (k == ks || k == ke+1) {
+        // moments of angle-resolved flux, with tetrad of the adjacent active cell
+        int kc = (k == ks)? k : k-1;
+        Real n0 = tt(m,0,0,kc,j,i);
+        Real t0 = tc(m,0,0,kc,j,i), t1 = tc(m,1,0,kc,j,i);
+        Real t2 = tc(m,2,0,kc,j,i), t3 = tc(m,3,0,kc,j,i);
+        Real f[4] = {0.0};
+        for (int n=0; n<=nang1; ++n) {
+          Real n_0 = t0*nh_c_.d_view(n,0) + t1*nh_c_.d_view(n,1) +
+                     t2*nh_c_.d_view(n,2) + t3*nh_c_.d_view(n,3);
+          Real wf = iflx_3(m,n,k,j,i)/(n0*n_0)*solid_angles_.d_view(n);
+          f[0] += wf;
+          f[1] += nh_c_.d_view(n,1)*wf;
+          f[2] += nh_c_.d_view(n,2)*wf;
+          f[3] += nh_c_.d_view(n,3)*wf;
+        }
+        for (int v=0; v<4; ++v) { flx3(m,v,k,j,i) = f[v]; }
+        return;
+      }
+      Real eps = fmin(1.0, 2.0/((chi_(m,k-1,j,i) + chi_(m,k,j,i))*size.d_view(m).dx3));
+      Real ul[4], ur[4], f[4];
+      for (int v=0; v<4; ++v) {
+        ul[v] = mom_(m,v,k-1,j,i);
+        ur[v] = mom_(m,v,k,j,i);
+      }
+      MomentFlux(ul, ur, 3, eps, f);
+      for (int v=0; v<4; ++v) { flx3(m,v,k,j,i) = rc_*f[v]; }
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::MomentUpdate(Driver *pdriver, int stage)
+//! \brief RK update of moments in MeshBlocks flagged by mb_thick, followed by resetting
+//! intensities from the updated moments using the P1 closure.
+
+void Radiation::MomentUpdate(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int nang1 = prgeo->nangles - 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+
+  auto &i0_ = i0;
+  auto &i1_ = i1;
+  auto &nh_c_ = nh_c;
+  auto &tt = tet_c;
+  auto &tc = tetcov_c;
+  auto &solid_angles_ = prgeo->solid_angles;
+  auto &mb_thick_ = mb_thick;
+  auto &mom_ = mom;
+  auto &flx1 = mflx.x1f;
+  auto &flx2 = mflx.x2f;
+  auto &flx3 = mflx.x3f;
+
+  par_for("r_update_mom",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    if (!(mb_thick_(m))) return;
+    // moments of intensity at start of step
+    Real n0 = tt(m,0,0,k,j,i);
+    Real u1[4] = {0.0};
+    for (int n=0; n<=nang1; ++n) {
+      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
+                 tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+      Real wi = i1_(m,n,k,j,i)/(n0*n_0)*solid_angles_.d_view(n);
+      u1[0] += wi;
+      u1[1] += nh_c_.d_view(n,1)*wi;
+      u1[2] += nh_c_.d_view(n,2)*wi;
+      u1[3] += nh_c_.d_view(n,3)*wi;
+    }
+
+    Real u[4];
+    for (int v=0; v<4; ++v) {
+      Real divf = (flx1(m,v,k,j,i+1) - flx1(m,v,k,j,i))/mbsize.d_view(m).dx1;
+      if (multi_d) {
+        divf += (flx2(m,v,k,j+1,i) - flx2(m,v,k,j,i))/mbsize.d_view(m).dx2;
+      }
+      if (three_d) {
+        divf += (flx3(m,v,k+1,j,i) - flx3(m,v,k,j,i))/mbsize.d_view(m).dx3;
+      }
+      u[v] = gam0*mom_(m,v,k,j,i) + gam1*u1[v] - beta_dt*divf;
+    }
+
+    // reset intensities with P1 closure
+    for (int n=0; n<=nang1; ++n) {
+      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
+                 tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+      Real ii = (u[0] + 3.0*(nh_c_.d_view(n,1)*u[1] + nh_c_.d_view(n,2)*u[2] +
+                             nh_c_.d_view(n,3)*u[3]))/(4.0*M_PI);
+      i0_(m,n,k,j,i) = n0*n_0*fmax(ii, 0.0);
+    }
+  });
+  return;
+}
+
+} // namespace radiation
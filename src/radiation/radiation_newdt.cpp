@@ -28,7 +28,8 @@ namespace radiation {
 //----------------------------------------------------------------------------------------
 // \!fn void Radiation::NewTimeStep()
 // \brief calculate the minimum timestep within a MeshBlockPack for radiation problems.
-//        Only computed once at beginning of calculation.
+//        Only computed once at beginning of calculation.  Signal speeds are the (reduced)
+//        speed of light.
 
 TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -52,6 +53,10 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
   bool &angular_fluxes_ = angular_fluxes;
   auto &nh_c_ = nh_c;
   auto &na_ = na;
+  auto &omega_sym_ = omega_sym;
+  bool compress_na_ = compress_na;
+  auto &nh_f_ = nh_f;
+  auto &uflux = prgeo->unit_flux;
   auto &tet_c_ = tet_c;
   auto &excise = pmy_pack->pcoord->coord_data.bh_excise;
   auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
@@ -59,7 +64,8 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
   auto &indn = prgeo->ind_neighbors;
 
   // find smallest (dx/c) and (dangle/na) in each direction for radiation problems
-  Kokkos::parallel_reduce("RadiationNudt",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  Kokkos::parallel_reduce("RadiationNudt",
+                          Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
   KOKKOS_LAMBDA(const int &idx,Real &min_dt1,Real &min_dt2,Real &min_dt3,Real &min_dta) {
     // compute m,k,j,i indices of thread and call function
     int m = (idx)/nkji;
@@ -83,7 +89,16 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
           Real zn = nh_c_.d_view(indn.d_view(n,nb),3);
           // compute timestep limitation
           Real n0 = tet_c_(m,0,0,k,j,i);
-          Real adt = fmin(tmp_min_dta,(acos(x*xn+y*yn+z*zn)/fabs(na_(m,n,k,j,i,nb)/n0)));
+          Real na_nb;
+          if (compress_na_) {
+            Real nh[4] = {nh_f_.d_view(n,nb,0), nh_f_.d_view(n,nb,1),
+                          nh_f_.d_view(n,nb,2), nh_f_.d_view(n,nb,3)};
+            na_nb = AngularFluxCoefficient(omega_sym_, m, k, j, i, nh,
+                                           uflux.d_view(n,nb,0), uflux.d_view(n,nb,1));
+          } else {
+            na_nb = na_(m,n,k,j,i,nb);
+          }
+          Real adt = fmin(tmp_min_dta,(acos(x*xn+y*yn+z*zn)/fabs(na_nb/n0)));
           // set timestep limitation if not excising this cell
           if (excise) {
             if (!(rad_mask_(m,k,j,i))) { tmp_min_dta = adt; }
@@ -105,6 +120,7 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
   if (pmy_pack->pmesh->multi_d) { dtnew = std::min(dtnew, dt2); }
   if (pmy_pack->pmesh->three_d) { dtnew = std::min(dtnew, dt3); }
   if (angular_fluxes_) { dtnew = std::min(dtnew, dta); }
+  dtnew /= reduced_c;
 
   return TaskStatus::complete;
 }
@@ -45,4 +45,41 @@ void OpacityFunction(// density and density scale
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Real PlanckIntegral
+//! \brief fraction of the frequency-integrated Planck function at frequencies below
+//! x = h nu/(k_B T), i.e. (15/pi^4) int_0^x t^3/(e^t - 1) dt.  Uses the series in
+//! Bernoulli numbers for small x, and the series in e^{-nx} otherwise.
+
+KOKKOS_INLINE_FUNCTION
+Real PlanckIntegral(const Real x) {
+  const Real norm = 15.0/(M_PI*M_PI*M_PI*M_PI);
+  if (x <= 0.0) {
+    return 0.0;
+  } else if (x < 1.0) {
+    Real x2 = x*x;
+    return norm*x2*x*(1.0/3.0 - x/8.0 + x2*(1.0/60.0 - x2*(1.0/5040.0 -
+                      x2*(1.0/272160.0 - x2*(1.0/13305600.0)))));
+  } else if (!(x < 100.0)) {  // also catches x = inf from zero temperature
+    return 1.0;
+  }
+  int nterm = 2 + static_cast<int>(36.0/x);
+  Real sum = 0.0;
+  for (int n=1; n<=nterm; ++n) {
+    Real rn = 1.0/static_cast<Real>(n);
+    sum += exp(-n*x)*rn*(x*x*x + rn*(3.0*x*x + rn*(6.0*x + 6.0*rn)));
+  }
+  return 1.0 - norm*sum;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real PlanckFraction
+//! \brief fraction of the frequency-integrated Planck function at temperature temp in
+//! the group with edges nu_lo < nu_hi (in units of k_B/h times the unit of temp)
+
+KOKKOS_INLINE_FUNCTION
+Real PlanckFraction(const Real nu_lo, const Real nu_hi, const Real temp) {
+  return PlanckIntegral(nu_hi/temp) - PlanckIntegral(nu_lo/temp);
+}
+
 #endif // RADIATION_RADIATION_OPACITIES_HPP_
@@ -0,0 +1,89 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file radiation_remap.cpp
+//! \brief Conservative remapping of intensities between angular meshes of different
+//! level or orientation.  Used to restart a calculation with a different <radiation>/
+//! nlevel (or rotate_geo), e.g. to continue a run at higher angular resolution once a
+//! beamed flow has developed, or at lower resolution once the radiation field has become
+//! diffusive.  The level and orientation the restart file was written with are stored in
+//! its input parameters as <radiation>/restart_nlevel and restart_rotate_geo.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "radiation.hpp"
+
+namespace radiation {
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::RemapAngles()
+//! \brief Sets i0 (including ghost cells) from intensities i_rst on the angles of
+//! prgeo_rst.  In each cell the tetrad-frame intensity of each new angle is the average
+//! of the old intensities weighted by the overlap of their faces (which both prolongs and
+//! restricts, and preserves isotropic intensities exactly), and is then rescaled so that
+//! the tetrad-frame radiation energy density is conserved exactly.  Each frequency group
+//! is remapped separately.
+
+void Radiation::RemapAngles(const DvceArray5D<Real> &i_rst) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int n1 = indcs.nx1 + 2*(indcs.ng);
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nang = prgeo->nangles;
+  int nang_rst = prgeo_rst->nangles;
+  int ngroups_ = ngroups;
+
+  // overlaps of faces of new angular mesh with those of old mesh
+  DualArray1D<int> offset("remap_offset", 1), index("remap_index", 1);
+  DualArray1D<Real> frac("remap_frac", 1);
+  prgeo->AngleOverlaps(prgeo_rst, offset, index, frac);
+
+  auto &i0_ = i0;
+  auto &nh_c_ = nh_c;
+  auto &tt = tet_c;
+  auto &tc = tetcov_c;
+  auto &solid_angles_ = prgeo->solid_angles;
+  auto &solid_angles_rst = prgeo_rst->solid_angles;
+  auto &cart_pos_rst = prgeo_rst->cart_pos;
+  par_for("rad_remap",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real n0 = tt(m,0,0,k,j,i);
+    for (int g=0; g<ngroups_; ++g) {
+      // tetrad-frame intensity along angle s of old mesh
+      auto iold = [&](const int s) {
+        Real n_0 = tc(m,0,0,k,j,i) + tc(m,1,0,k,j,i)*cart_pos_rst.d_view(s,0) +
+                   tc(m,2,0,k,j,i)*cart_pos_rst.d_view(s,1) +
+                   tc(m,3,0,k,j,i)*cart_pos_rst.d_view(s,2);
+        return i_rst(m,g*nang_rst+s,k,j,i)/(n0*n_0);
+      };
+      Real e_rst = 0.0;
+      for (int s=0; s<nang_rst; ++s) {
+        e_rst += iold(s)*solid_angles_rst.d_view(s);
+      }
+
+      // overlap-weighted averages, stored temporarily in i0
+      Real e_new = 0.0;
+      for (int n=0; n<nang; ++n) {
+        Real ii = 0.0;
+        for (int l=offset.d_view(n); l<offset.d_view(n+1); ++l) {
+          ii += frac.d_view(l)*iold(index.d_view(l));
+        }
+        i0_(m,g*nang+n,k,j,i) = ii;
+        e_new += ii*solid_angles_.d_view(n);
+      }
+
+      Real fac = (e_new > 0.0)? e_rst/e_new : 0.0;
+      for (int n=0; n<nang; ++n) {
+        Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)
+                 + tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+        i0_(m,g*nang+n,k,j,i) = n0*n_0*fac*i0_(m,g*nang+n,k,j,i);
+      }
+    }
+  });
+  return;
+}
+
+} // namespace radiation
@@ -13,6 +13,7 @@
 #include "coordinates/cell_locations.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "eos/eos.hpp"
+#include "eos/ideal_c2p_mhd.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "units/units.hpp"
@@ -26,10 +27,66 @@ namespace radiation {
 KOKKOS_INLINE_FUNCTION
 bool FourthPolyRoot(const Real coef4, const Real tconst, Real &root);
 
+//----------------------------------------------------------------------------------------
+//! \fn void FusedConsToPrim()
+//! \brief Primitives of one cell from the conserved variables and face-centered fields,
+//! computed exactly as in IdealGRMHD::ConsToPrim (including floors, velocity ceiling and
+//! excision), but without storing them or resetting the conserved variables.  Used by
+//! the source term with <radiation>/fused_c2p.
+
+KOKKOS_INLINE_FUNCTION
+void FusedConsToPrim(const DvceArray5D<Real> &cons, const DvceArray4D<Real> &b1f,
+                     const DvceArray4D<Real> &b2f, const DvceArray4D<Real> &b3f,
+                     const EOS_Data &eos, Real glower[][4], Real gupper[][4],
+                     const bool excised, const Real dexcise, const Real pexcise,
+                     const int m, const int k, const int j, const int i, HydPrim1D &w) {
+  if (excised) {
+    w.d = dexcise;
+    w.vx = 0.0;
+    w.vy = 0.0;
+    w.vz = 0.0;
+    w.e = pexcise/(eos.gamma - 1.0);
+    return;
+  }
+  MHDCons1D u;
+  u.d  = cons(m,IDN,k,j,i);
+  u.mx = cons(m,IM1,k,j,i);
+  u.my = cons(m,IM2,k,j,i);
+  u.mz = cons(m,IM3,k,j,i);
+  u.e  = cons(m,IEN,k,j,i);
+  u.bx = 0.5*(b1f(m,k,j,i) + b1f(m,k,j,i+1));
+  u.by = 0.5*(b2f(m,k,j,i) + b2f(m,k,j+1,i));
+  u.bz = 0.5*(b3f(m,k,j,i) + b3f(m,k+1,j,i));
+
+  MHDCons1D u_sr;
+  Real s2, b2, rpar;
+  TransformToSRMHD(u,glower,gupper,s2,b2,rpar,u_sr);
+  bool dfloor_used=false, efloor_used=false, c2p_failure=false;
+  int iter_used=0;
+  SingleC2P_IdealSRMHD(u_sr, eos, s2, b2, rpar, w,
+                       dfloor_used, efloor_used, c2p_failure, iter_used);
+
+  // apply velocity ceiling if necessary
+  Real tmp = glower[1][1]*SQR(w.vx)
+           + glower[2][2]*SQR(w.vy)
+           + glower[3][3]*SQR(w.vz)
+           + 2.0*glower[1][2]*w.vx*w.vy + 2.0*glower[1][3]*w.vx*w.vz
+           + 2.0*glower[2][3]*w.vy*w.vz;
+  Real lor = sqrt(1.0+tmp);
+  if (lor > eos.gamma_max) {
+    Real factor = sqrt((SQR(eos.gamma_max)-1.0)/(SQR(lor)-1.0));
+    w.vx *= factor;
+    w.vy *= factor;
+    w.vz *= factor;
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage)
-// \brief Add implicit radiation source term.  Based off of @c-white and @yanfeij's gr_rad
-// branch, radiation/coupling/emission.cpp commit be7f84565b.
+// \brief Add implicit radiation source term.  With <radiation>/angle_blocked the
+// intensities are first copied into i0_ang with angles innermost, so that the loops over
+// angles in each cell read contiguous memory, and copied back afterwards.
 
 TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   // Return if radiation source term disabled
@@ -37,6 +94,75 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     return TaskStatus::complete;
   }
 
+  if (angle_blocked) {
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    TransposeIntensity(true);
+    AddSourceTerm(pdriver, stage, AngleBlockedIntensity{i0_ang, indcs.ks, indcs.js,
+                                                        indcs.is});
+    TransposeIntensity(false);
+  } else {
+    AddSourceTerm(pdriver, stage, i0);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::TransposeIntensity(bool to_angle_blocked)
+// \brief Copies intensities in active cells between i0 (m,n,k,j,i) and i0_ang
+// (m,k,j,i,n).  Each team stages one (k,j) row of all intensities in scratch memory, so
+// that both the reads and the writes to global memory are contiguous.
+
+void Radiation::TransposeIntensity(bool to_angle_blocked) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, ks = indcs.ks;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nang = nintens;
+  auto &i0_ = i0;
+  auto &i0_ang_ = i0_ang;
+
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nang, nx1);
+  int scr_level = (scr_size > Kokkos::TeamPolicy<>::scratch_size_max(0))? 1 : 0;
+  par_for_outer("rad_transpose",DevExeSpace(),scr_size,scr_level,0,nmb1,
+                0,(indcs.nx3-1),0,(indcs.nx2-1),
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> row(member.team_scratch(scr_level), nang, nx1);
+    if (to_angle_blocked) {
+      par_for_inner(member, 0, nang*nx1-1, [&](const int idx) {
+        int n = idx/nx1, i = idx - n*nx1;
+        row(n,i) = i0_(m,n,k+ks,j+js,i+is);
+      });
+      member.team_barrier();
+      par_for_inner(member, 0, nang*nx1-1, [&](const int idx) {
+        int i = idx/nang, n = idx - i*nang;
+        i0_ang_(m,k,j,i,n) = row(n,i);
+      });
+    } else {
+      par_for_inner(member, 0, nang*nx1-1, [&](const int idx) {
+        int i = idx/nang, n = idx - i*nang;
+        row(n,i) = i0_ang_(m,k,j,i,n);
+      });
+      member.team_barrier();
+      par_for_inner(member, 0, nang*nx1-1, [&](const int idx) {
+        int n = idx/nx1, i = idx - n*nx1;
+        i0_(m,n,k+ks,j+js,i+is) = row(n,i);
+      });
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::AddSourceTerm(Driver *pdriver, int stage, const IArray &iarr)
+// \brief Add implicit radiation source term to intensities accessed through iarr, which
+// is either i0 or an AngleBlockedIntensity.  Based off of @c-white and @yanfeij's gr_rad
+// branch, radiation/coupling/emission.cpp commit be7f84565b.  With frequency groups the
+// opacities are grey, so the new gas temperature follows from the sums over all groups
+// exactly as for grey radiation, and each group then absorbs its own mean intensity and
+// receives the fraction of the emission given by the Planck function at that temperature.
+
+template <typename IArray>
+void Radiation::AddSourceTerm(Driver *pdriver, int stage, const IArray &iarr) {
   // Extract indices, size data, hydro/mhd/units flags, and coupling flags
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &ie = indcs.ie;
@@ -44,6 +170,10 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   int &ks = indcs.ks, &ke = indcs.ke;
   int nmb1 = pmy_pack->nmb_thispack - 1;
   int nang1 = prgeo->nangles - 1;
+  int nang_ = prgeo->nangles;
+  int ngroups_ = ngroups;
+  int nint1 = nintens - 1;
+  auto &nu_edges_ = nu_edges;
   auto &size = pmy_pack->pmb->mb_size;
   bool &is_hydro_enabled_ = is_hydro_enabled;
   bool &is_mhd_enabled_ = is_mhd_enabled;
@@ -85,7 +215,7 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   }
 
   // Extract radiation, radiation frame, and radiation angular mesh data
-  auto &i0_ = i0;
+  auto &i0_ = iarr;
   Real &kappa_a_ = kappa_a;
   Real &kappa_s_ = kappa_s;
   Real &kappa_p_ = kappa_p;
@@ -97,29 +227,352 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   auto &solid_angles_ = prgeo->solid_angles;
 
   // Extract hydro/mhd quantities
-  DvceArray5D<Real> u0_, w0_;
+  DvceArray5D<Real> u0_, w0_, bcc0_;
+  DvceArray4D<Real> b1f_, b2f_, b3f_;
   if (is_hydro_enabled_) {
     u0_ = pmy_pack->phydro->u0;
     w0_ = pmy_pack->phydro->w0;
   } else if (is_mhd_enabled_) {
     u0_ = pmy_pack->pmhd->u0;
     w0_ = pmy_pack->pmhd->w0;
+    bcc0_ = pmy_pack->pmhd->bcc0;
+    b1f_ = pmy_pack->pmhd->b0.x1f;
+    b2f_ = pmy_pack->pmhd->b0.x2f;
+    b3f_ = pmy_pack->pmhd->b0.x3f;
   }
 
-  // Extract timestep
+  // With fused_c2p the primitives (needed only in this kernel and recomputed in all
+  // cells by MHD::ConToPrim at the end of the stage) are computed in registers in each
+  // cell, rather than by a separate ConsToPrim sweep over the pack that stores them in
+  // w0.  Floors are then applied to the conserved variables only once, at the end.
+  const bool fused_c2p_ = fused_c2p && !(fixed_fluid_);
+  EOS_Data eos_;
+  Real dexcise_ = 0.0, pexcise_ = 0.0;
+  if (fused_c2p_) {
+    eos_ = pmy_pack->pmhd->peos->eos_data;
+    dexcise_ = coord.dexcise;
+    pexcise_ = coord.pexcise;
+  }
+
+  // Extract timestep.  With a reduced speed of light c_hat, intensities are updated over
+  // c_hat*dt (dtc_) while the gas is updated over dt, so the energy and momentum
+  // exchanged with the fluid are those of the radiation divided by c_hat/c.
   Real dt_ = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  Real dtc_ = reduced_c*dt_;
+  Real inv_rc_ = 1.0/reduced_c;
 
   // Call ConsToPrim over active zones prior to source term application
-  if (!(fixed_fluid_)) {
+  if (!(fixed_fluid_) && !(fused_c2p_)) {
     if (is_hydro_enabled_) {
       pmy_pack->phydro->peos->ConsToPrim(u0_,w0_,false,is,ie,js,je,ks,ke);
     } else if (is_mhd_enabled_) {
       auto &b0_ = pmy_pack->pmhd->b0;
-      auto &bcc0_ = pmy_pack->pmhd->bcc0;
       pmy_pack->pmhd->peos->ConsToPrim(u0_,b0_,w0_,bcc0_,false,is,ie,js,je,ks,ke);
     }
   }
 
+  // Fully implicit coupling of radiation energy and momentum with the fluid.  The
+  // absorption/emission/scattering update above is implicit in the intensities and gas
+  // temperature, but uses the fluid velocity at the start of the step to transform to
+  // the fluid frame.  Here that velocity is also iterated to convergence, including the
+  // momentum exchanged with the radiation.  One team per cell, with the per-cell sums
+  // over angles (and groups) done as team reductions.  With frequency groups, the
+  // per-group mean intensities are computed with one thread per group, and stored with
+  // the emission of each group in scratch memory.
+  if (implicit_coupling) {
+    int nint = nint1 + 1;
+    int &niter_ = coupling_niter;
+    Real &tol_ = coupling_tol;
+    size_t scr_size = 2*ScrArray1D<Real>::shmem_size(ngroups_);
+    par_for_outer("radiation_source_coupled",DevExeSpace(),scr_size,0,0,nmb1,ks,ke,js,je,
+                  is,ie,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j,
+                  const int i) {
+      ScrArray1D<Real> emission_g(member.team_scratch(0), ngroups_);
+      ScrArray1D<Real> jr_cm_g(member.team_scratch(0), ngroups_);
+      Real &x1min = size.d_view(m).x1min;
+      Real &x1max = size.d_view(m).x1max;
+      Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+      Real &x2min = size.d_view(m).x2min;
+      Real &x2max = size.d_view(m).x2max;
+      Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+
+      Real &x3min = size.d_view(m).x3min;
+      Real &x3max = size.d_view(m).x3max;
+      Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+
+      // compute metric and inverse
+      Real glower[4][4], gupper[4][4];
+      if (coord.metric_cached) {
+        LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+      } else {
+        ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+      }
+      Real alpha = sqrt(-1.0/gupper[0][0]);
+
+      // fluid state
+      Real wdn, wen, wv[3];
+      if (fused_c2p_) {
+        HydPrim1D w;
+        FusedConsToPrim(u0_, b1f_, b2f_, b3f_, eos_, glower, gupper,
+                        (excise && rad_mask_(m,k,j,i)), dexcise_, pexcise_,
+                        m, k, j, i, w);
+        wdn = w.d;
+        wen = w.e;
+        wv[0] = w.vx;
+        wv[1] = w.vy;
+        wv[2] = w.vz;
+      } else {
+        wdn = w0_(m,IDN,k,j,i);
+        wen = w0_(m,IEN,k,j,i);
+        wv[0] = w0_(m,IVX,k,j,i);
+        wv[1] = w0_(m,IVY,k,j,i);
+        wv[2] = w0_(m,IVZ,k,j,i);
+      }
+      Real pgas = gm1*wen;
+      Real tgas = pgas/wdn;
+      Real wtot = wdn + (gm1 + 1.0)*wen;
+
+      // magnetic contribution b^2 to the inertia of MHD fluids, with b^mu evaluated from
+      // the cell-centered field and the fluid velocity at the start of the step
+      if (is_mhd_enabled_) {
+        Real bb[3];
+        if (fused_c2p_) {
+          bb[0] = 0.5*(b1f_(m,k,j,i) + b1f_(m,k,j,i+1));
+          bb[1] = 0.5*(b2f_(m,k,j,i) + b2f_(m,k,j+1,i));
+          bb[2] = 0.5*(b3f_(m,k,j,i) + b3f_(m,k+1,j,i));
+        } else {
+          bb[0] = bcc0_(m,IBX,k,j,i);
+          bb[1] = bcc0_(m,IBY,k,j,i);
+          bb[2] = bcc0_(m,IBZ,k,j,i);
+        }
+        Real q = glower[1][1]*wv[0]*wv[0] + 2.0*glower[1][2]*wv[0]*wv[1]
+               + 2.0*glower[1][3]*wv[0]*wv[2] + glower[2][2]*wv[1]*wv[1]
+               + 2.0*glower[2][3]*wv[1]*wv[2] + glower[3][3]*wv[2]*wv[2];
+        Real gamma = sqrt(1.0 + q);
+        Real uu[4];
+        uu[0] = gamma/alpha;
+        for (int a=0; a<3; ++a) {uu[a+1] = wv[a] - alpha*gamma*gupper[0][a+1];}
+        Real bu[4];
+        bu[0] = 0.0;
+        for (int a=1; a<4; ++a) {
+          for (int b=0; b<4; ++b) {bu[0] += glower[a][b]*uu[b]*bb[a-1];}
+        }
+        for (int a=1; a<4; ++a) {bu[a] = (bb[a-1] + bu[0]*uu[a])/uu[0];}
+        Real b_sq = 0.0;
+        for (int a=0; a<4; ++a) {
+          for (int b=0; b<4; ++b) {b_sq += glower[a][b]*bu[a]*bu[b];}
+        }
+        wtot += b_sq;
+      }
+
+      // set opacities (independent of fluid velocity)
+      Real sigma_a, sigma_s, sigma_p;
+      OpacityFunction(wdn, density_scale_,
+                      tgas, temperature_scale_,
+                      length_scale_, gm1, mean_mol_weight_,
+                      power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
+                      kappa_a_, kappa_s_, kappa_p_,
+                      sigma_a, sigma_s, sigma_p);
+      Real dtcsiga = dtc_*sigma_a;
+      Real dtcsigs = dtc_*sigma_s;
+      Real dtcsigp = dtc_*sigma_p;
+
+      // coordinate component n^0, and coordinate components n_c of each angle
+      Real n0 = tt(m,0,0,k,j,i);
+      auto ncoord = [&](const int n, const int c) {
+        return (tc(m,0,c,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,c,k,j,i)*nh_c_.d_view(n,1) +
+                tc(m,2,c,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,c,k,j,i)*nh_c_.d_view(n,3));
+      };
+
+      // compute moments before coupling
+      array_sum::GlobalSum m_old;
+      Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, nint),
+      [&](const int n, array_sum::GlobalSum &sum) {
+        const int a = n % nang_;
+        Real n_0 = ncoord(a,0);
+        Real wi = i0_(m,n,k,j,i)*solid_angles_.d_view(a);
+        sum.the_array[0] += wi;
+        for (int c=1; c<4; ++c) {
+          sum.the_array[c] += ncoord(a,c)*wi/n_0;
+        }
+      }, Kokkos::Sum<array_sum::GlobalSum>(m_old));
+
+      // fluid frame of last converged iterate (with emission and jr_cm of each group in
+      // scratch), and updated intensity in that frame
+      Real u_tet[4] = {0.0};
+      auto new_intensity = [&](const int n) {
+        const int g = n/nang_, a = n - g*nang_;
+        Real n_0 = ncoord(a,0);
+        Real n0_cm = (u_tet[0]*nh_c_.d_view(a,0) - u_tet[1]*nh_c_.d_view(a,1) -
+                      u_tet[2]*nh_c_.d_view(a,2) - u_tet[3]*nh_c_.d_view(a,3));
+        Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
+        Real vncsigma2 = n0_cm/(n0 + (dtcsiga + dtcsigs)*n0_cm);
+        Real di_cm = ( ((dtcsigs-dtcsigp)*jr_cm_g(g)
+                      + (dtcsiga+dtcsigp)*emission_g(g)
+                      - (dtcsigs+dtcsiga)*intensity_cm)*vncsigma2 );
+        return n0*n_0*fmax(i0_(m,n,k,j,i)/(n0*n_0) +
+                           di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
+      };
+
+      // iterate on fluid velocity used to transform to fluid frame
+      Real uv[3] = {wv[0], wv[1], wv[2]};
+      bool solved = false;
+      for (int iter=0; iter<niter_; ++iter) {
+        Real q = glower[1][1]*uv[0]*uv[0] + 2.0*glower[1][2]*uv[0]*uv[1]
+               + 2.0*glower[1][3]*uv[0]*uv[2] + glower[2][2]*uv[1]*uv[1]
+               + 2.0*glower[2][3]*uv[1]*uv[2] + glower[3][3]*uv[2]*uv[2];
+        Real gamma = sqrt(1.0 + q);
+        Real u0 = gamma/alpha;
+        Real dtaucsiga = dt_*sigma_a/u0;
+        Real dtaucsigp = dt_*sigma_p/u0;
+
+        // compute fluid velocity in tetrad frame
+        Real ut[4];
+        for (int a=0; a<4; ++a) {
+          ut[a] = (norm_to_tet_(m,a,0,k,j,i)*gamma + norm_to_tet_(m,a,1,k,j,i)*uv[0] +
+                   norm_to_tet_(m,a,2,k,j,i)*uv[1] + norm_to_tet_(m,a,3,k,j,i)*uv[2]);
+        }
+
+        // Calculate polynomial coefficients.  Weights are summed over all groups, so
+        // the intensity summed over groups is ngroups times the ratio of the sums.
+        array_sum::GlobalSum suma;
+        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, nint),
+        [&](const int n, array_sum::GlobalSum &sum) {
+          const int a = n % nang_;
+          Real n_0 = ncoord(a,0);
+          Real n0_cm = (ut[0]*nh_c_.d_view(a,0) - ut[1]*nh_c_.d_view(a,1) -
+                        ut[2]*nh_c_.d_view(a,2) - ut[3]*nh_c_.d_view(a,3));
+          Real omega_cm = solid_angles_.d_view(a)/SQR(n0_cm);
+          Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
+          Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
+          sum.the_array[0] += omega_cm;
+          sum.the_array[1] += omega_cm*n0_cm*vncsigma;
+          sum.the_array[2] += intensity_cm*omega_cm*n0*vncsigma;
+        }, Kokkos::Sum<array_sum::GlobalSum>(suma));
+        Real wght_sum = suma.the_array[0]/ngroups_;
+        Real suma1 = suma.the_array[1]/suma.the_array[0];
+        Real suma2 = suma.the_array[2]/wght_sum;
+        Real suma3 = suma1*(dtcsigs - dtcsigp);
+        suma1 *= (dtcsiga + dtcsigp);
+
+        // compute coefficients and new gas temperature.  Keep last iterate on failure.
+        Real coef[2];
+        coef[1] = (dtaucsiga+dtaucsigp-(dtaucsiga+dtaucsigp)*suma1/(1.0-suma3))*
+                  arad_*gm1/wdn;
+        coef[0] = -tgas-(dtaucsiga+dtaucsigp)*suma2*gm1/(wdn*(1.0-suma3));
+        Real tgasnew = tgas;
+        if (fabs(coef[1]) > 1.0e-20) {
+          bool flag = FourthPolyRoot(coef[1], coef[0], tgasnew);
+          if (!(flag) || !(isfinite(tgasnew))) {break;}
+        } else {
+          tgasnew = -coef[0];
+        }
+        for (int a=0; a<4; ++a) {u_tet[a] = ut[a];}
+        Real emission = arad_*SQR(SQR(tgasnew));
+        member.team_barrier();
+        if (ngroups_ == 1) {
+          Kokkos::single(Kokkos::PerTeam(member), [&]() {
+            emission_g(0) = emission;
+            jr_cm_g(0) = (suma1*emission + suma2)/(1.0 - suma3);
+          });
+        } else {
+          Kokkos::parallel_for(Kokkos::TeamThreadRange(member, ngroups_),
+          [&](const int g) {
+            Real suma2_g = 0.0;
+            Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(member, nang_),
+            [&](const int a, Real &sum) {
+              int n = g*nang_ + a;
+              Real n0_cm = (ut[0]*nh_c_.d_view(a,0) - ut[1]*nh_c_.d_view(a,1) -
+                            ut[2]*nh_c_.d_view(a,2) - ut[3]*nh_c_.d_view(a,3));
+              Real omega_cm = solid_angles_.d_view(a)/SQR(n0_cm);
+              Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*ncoord(a,0)))*
+                                  SQR(SQR(n0_cm));
+              sum += intensity_cm*omega_cm*n0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
+            }, suma2_g);
+            Kokkos::single(Kokkos::PerThread(member), [&]() {
+              emission_g(g) = emission*PlanckFraction(nu_edges_.d_view(g),
+                                                      nu_edges_.d_view(g+1), tgasnew);
+              jr_cm_g(g) = (suma1*emission_g(g) + suma2_g/wght_sum)/(1.0 - suma3);
+            });
+          });
+        }
+        member.team_barrier();
+        solved = true;
+
+        // fluid frame does not change if radiation does not feed back on fluid
+        if (!(affect_fluid_) || fixed_fluid_) {break;}
+
+        // momentum exchanged with radiation in this frame gives change in u_j (holding
+        // enthalpy and u^0 fixed), raised with inverse spatial metric to new velocity
+        array_sum::GlobalSum m_new;
+        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, nint),
+        [&](const int n, array_sum::GlobalSum &sum) {
+          const int a = n % nang_;
+          Real wi = new_intensity(n)*solid_angles_.d_view(a)/ncoord(a,0);
+          for (int c=1; c<4; ++c) {
+            sum.the_array[c] += ncoord(a,c)*wi;
+          }
+        }, Kokkos::Sum<array_sum::GlobalSum>(m_new));
+        Real du[3], uvnew[3];
+        for (int a=0; a<3; ++a) {
+          du[a] = inv_rc_*(m_old.the_array[a+1] - m_new.the_array[a+1])/(wtot*u0);
+        }
+        Real dv2 = 0.0, v2 = 0.0;
+        for (int a=0; a<3; ++a) {
+          uvnew[a] = wv[a];
+          for (int b=0; b<3; ++b) {
+            uvnew[a] += (gupper[a+1][b+1] - gupper[0][a+1]*gupper[0][b+1]/gupper[0][0])*
+                        du[b];
+          }
+          dv2 += SQR(uvnew[a] - uv[a]);
+          v2 += SQR(uvnew[a]);
+        }
+        for (int a=0; a<3; ++a) {uv[a] = uvnew[a];}
+        if (dv2 <= SQR(tol_)*(1.0 + v2)) {break;}
+      }
+
+      // Update the specific intensity with converged fluid frame
+      if (solved) {
+        // compute moments after coupling
+        array_sum::GlobalSum m_new;
+        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, nint),
+        [&](const int n, array_sum::GlobalSum &sum) {
+          const int a = n % nang_;
+          Real n_0 = ncoord(a,0);
+          Real wi = new_intensity(n)*solid_angles_.d_view(a);
+          sum.the_array[0] += wi;
+          for (int c=1; c<4; ++c) {
+            sum.the_array[c] += ncoord(a,c)*wi/n_0;
+          }
+        }, Kokkos::Sum<array_sum::GlobalSum>(m_new));
+        member.team_barrier();
+
+        // update intensity, then handle excision (see notes below)
+        par_for_inner(member, 0, nint1, [&](const int n) {
+          Real inew = new_intensity(n);
+          if (excise) {
+            const int a = n % nang_;
+            if (rad_mask_(m,k,j,i) || fabs(ncoord(a,0)) < n_0_floor_) {inew = 0.0;}
+          }
+          i0_(m,n,k,j,i) = inew;
+        });
+
+        // update conserved fluid variables
+        if (affect_fluid_) {
+          Kokkos::single(Kokkos::PerTeam(member), [&]() {
+            u0_(m,IEN,k,j,i) += inv_rc_*(m_old.the_array[0] - m_new.the_array[0]);
+            u0_(m,IM1,k,j,i) += inv_rc_*(m_old.the_array[1] - m_new.the_array[1]);
+            u0_(m,IM2,k,j,i) += inv_rc_*(m_old.the_array[2] - m_new.the_array[2]);
+            u0_(m,IM3,k,j,i) += inv_rc_*(m_old.the_array[3] - m_new.the_array[3]);
+          });
+        }
+      }
+    });
+    return;
+  }
+
   // compute implicit source term
   par_for("radiation_source",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
   KOKKOS_LAMBDA(int m, int k, int j, int i) {
@@ -137,15 +590,31 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
 
     // compute metric and inverse
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+    if (coord.metric_cached) {
+      LoadMetric(coord, coord.gcc, m, k, j, i, glower, gupper);
+    } else {
+      ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+    }
     Real alpha = sqrt(-1.0/gupper[0][0]);
 
     // fluid state
-    Real &wdn = w0_(m,IDN,k,j,i);
-    Real &wvx = w0_(m,IVX,k,j,i);
-    Real &wvy = w0_(m,IVY,k,j,i);
-    Real &wvz = w0_(m,IVZ,k,j,i);
-    Real &wen = w0_(m,IEN,k,j,i);
+    Real wdn, wvx, wvy, wvz, wen;
+    if (fused_c2p_) {
+      HydPrim1D w;
+      FusedConsToPrim(u0_, b1f_, b2f_, b3f_, eos_, glower, gupper,
+                      (excise && rad_mask_(m,k,j,i)), dexcise_, pexcise_, m, k, j, i, w);
+      wdn = w.d;
+      wvx = w.vx;
+      wvy = w.vy;
+      wvz = w.vz;
+      wen = w.e;
+    } else {
+      wdn = w0_(m,IDN,k,j,i);
+      wvx = w0_(m,IVX,k,j,i);
+      wvy = w0_(m,IVY,k,j,i);
+      wvz = w0_(m,IVZ,k,j,i);
+      wen = w0_(m,IEN,k,j,i);
+    }
 
     // derived quantities
     Real pgas = gm1*wen;
@@ -164,12 +633,12 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
                     power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
                     kappa_a_, kappa_s_, kappa_p_,
                     sigma_a, sigma_s, sigma_p);
-    Real dtcsiga = dt_*sigma_a;
-    Real dtcsigs = dt_*sigma_s;
-    Real dtcsigp = dt_*sigma_p;
-    Real dtaucsiga = dtcsiga/u0;
-    Real dtaucsigs = dtcsigs/u0;
-    Real dtaucsigp = dtcsigp/u0;
+    Real dtcsiga = dtc_*sigma_a;
+    Real dtcsigs = dtc_*sigma_s;
+    Real dtcsigp = dtc_*sigma_p;
+    Real dtaucsiga = dt_*sigma_a/u0;
+    Real dtaucsigs = dt_*sigma_s/u0;
+    Real dtaucsigp = dt_*sigma_p/u0;
 
     // compute fluid velocity in tetrad frame
     Real u_tet[4];
@@ -185,22 +654,26 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     // coordinate component n^0
     Real n0 = tt(m,0,0,k,j,i);
 
-    // Calculate polynomial coefficients
+    // Calculate polynomial coefficients.  Weights depend only on the angle, so are
+    // summed over the first group, while intensities are summed over all groups.
     Real wght_sum = 0.0;
     Real suma1 = 0.0;
     Real suma2 = 0.0;
-    for (int n=0; n<=nang1; ++n) {
-      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
-                 tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-      Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
-                    u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
-      Real omega_cm = solid_angles_.d_view(n)/SQR(n0_cm);
+    for (int n=0; n<=nint1; ++n) {
+      const int a = n % nang_;
+      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(a,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(a,1) +
+                 tc(m,2,0,k,j,i)*nh_c_.d_view(a,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(a,3);
+      Real n0_cm = (u_tet[0]*nh_c_.d_view(a,0) - u_tet[1]*nh_c_.d_view(a,1) -
+                    u_tet[2]*nh_c_.d_view(a,2) - u_tet[3]*nh_c_.d_view(a,3));
+      Real omega_cm = solid_angles_.d_view(a)/SQR(n0_cm);
       Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
       Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
       Real vncsigma2 = n0_cm*vncsigma;
       Real ir_weight = intensity_cm*omega_cm;
-      wght_sum += omega_cm;
-      suma1 += omega_cm*vncsigma2;
+      if (n == a) {
+        wght_sum += omega_cm;
+        suma1 += omega_cm*vncsigma2;
+      }
       suma2 += ir_weight*n0*vncsigma;
     }
     suma1 /= wght_sum;
@@ -229,61 +702,83 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     // Update the specific intensity
     if (!(badcell)) {
       // Calculate emission coefficient and updated jr_cm
-      Real emission = arad_*SQR(SQR(tgasnew));
-      Real jr_cm = (suma1*emission + suma2)/(1.0 - suma3);
+      Real emission_tot = arad_*SQR(SQR(tgasnew));
       Real m_old[4] = {0.0}; Real m_new[4] = {0.0};
-      for (int n=0; n<=nang1; ++n) {
-        // compute coordinate normal components
-        Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-        Real n_1 = tc(m,0,1,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,1,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,1,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,1,k,j,i)*nh_c_.d_view(n,3);
-        Real n_2 = tc(m,0,2,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,2,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,2,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,2,k,j,i)*nh_c_.d_view(n,3);
-        Real n_3 = tc(m,0,3,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,3,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,3,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,3,k,j,i)*nh_c_.d_view(n,3);
-
-        // compute moments before coupling
-        m_old[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-        m_old[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_old[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_old[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-
-        // update intensity
-        Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
-                      u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
-        Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
-        Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
-        Real vncsigma2 = n0_cm*vncsigma;
-        Real di_cm = ( ((dtcsigs-dtcsigp)*jr_cm
-                      + (dtcsiga+dtcsigp)*emission
-                      - (dtcsigs+dtcsiga)*intensity_cm)*vncsigma2 );
-        i0_(m,n,k,j,i) = n0*n_0*fmax(i0_(m,n,k,j,i)/(n0*n_0) +
-                                     di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
+      for (int g=0; g<ngroups_; ++g) {
+        // emission and updated jr_cm of this group
+        Real emission = emission_tot, suma2_g = suma2;
+        if (ngroups_ > 1) {
+          emission *= PlanckFraction(nu_edges_.d_view(g), nu_edges_.d_view(g+1), tgasnew);
+          suma2_g = 0.0;
+          for (int a=0; a<=nang1; ++a) {
+            int n = g*nang_ + a;
+            Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(a,0) +
+                       tc(m,1,0,k,j,i)*nh_c_.d_view(a,1) +
+                       tc(m,2,0,k,j,i)*nh_c_.d_view(a,2) +
+                       tc(m,3,0,k,j,i)*nh_c_.d_view(a,3);
+            Real n0_cm = (u_tet[0]*nh_c_.d_view(a,0) - u_tet[1]*nh_c_.d_view(a,1) -
+                          u_tet[2]*nh_c_.d_view(a,2) - u_tet[3]*nh_c_.d_view(a,3));
+            Real omega_cm = solid_angles_.d_view(a)/SQR(n0_cm);
+            Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
+            suma2_g += intensity_cm*omega_cm*n0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
+          }
+          suma2_g /= wght_sum;
+        }
+        Real jr_cm = (suma1*emission + suma2_g)/(1.0 - suma3);
+        for (int a=0; a<=nang1; ++a) {
+          int n = g*nang_ + a;
+          // compute coordinate normal components
+          Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(a,0)+tc(m,1,0,k,j,i)*nh_c_.d_view(a,1)
+                   + tc(m,2,0,k,j,i)*nh_c_.d_view(a,2)+tc(m,3,0,k,j,i)*nh_c_.d_view(a,3);
+          Real n_1 = tc(m,0,1,k,j,i)*nh_c_.d_view(a,0)+tc(m,1,1,k,j,i)*nh_c_.d_view(a,1)
+                   + tc(m,2,1,k,j,i)*nh_c_.d_view(a,2)+tc(m,3,1,k,j,i)*nh_c_.d_view(a,3);
+          Real n_2 = tc(m,0,2,k,j,i)*nh_c_.d_view(a,0)+tc(m,1,2,k,j,i)*nh_c_.d_view(a,1)
+                   + tc(m,2,2,k,j,i)*nh_c_.d_view(a,2)+tc(m,3,2,k,j,i)*nh_c_.d_view(a,3);
+          Real n_3 = tc(m,0,3,k,j,i)*nh_c_.d_view(a,0)+tc(m,1,3,k,j,i)*nh_c_.d_view(a,1)
+                   + tc(m,2,3,k,j,i)*nh_c_.d_view(a,2)+tc(m,3,3,k,j,i)*nh_c_.d_view(a,3);
 
-        // compute moments after coupling
-        m_new[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-        m_new[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_new[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_new[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-
-        // handle excision
-        // NOTE(@pdmullen): The below zeroes all intensities within rks <= r_excision and
-        // zeroes intensities within angles where n_0 is about zero. When Compton is
-        // enabled, we delay the n_0_floor excision so that intensites updated via
-        // absorption and scattering inform the Compton update
-        if (excise) {
-          bool apply_excision = (rad_mask_(m,k,j,i) ||
-                                 (!(is_compton_enabled_) && fabs(n_0) < n_0_floor_));
-          if (apply_excision) { i0_(m,n,k,j,i) = 0.0; }
+          // compute moments before coupling
+          m_old[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(a));
+          m_old[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(a));
+          m_old[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(a));
+          m_old[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(a));
+
+          // update intensity
+          Real n0_cm = (u_tet[0]*nh_c_.d_view(a,0) - u_tet[1]*nh_c_.d_view(a,1) -
+                        u_tet[2]*nh_c_.d_view(a,2) - u_tet[3]*nh_c_.d_view(a,3));
+          Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
+          Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
+          Real vncsigma2 = n0_cm*vncsigma;
+          Real di_cm = ( ((dtcsigs-dtcsigp)*jr_cm
+                        + (dtcsiga+dtcsigp)*emission
+                        - (dtcsigs+dtcsiga)*intensity_cm)*vncsigma2 );
+          i0_(m,n,k,j,i) = n0*n_0*fmax(i0_(m,n,k,j,i)/(n0*n_0) +
+                                       di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
+
+          // compute moments after coupling
+          m_new[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(a));
+          m_new[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(a));
+          m_new[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(a));
+          m_new[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(a));
+
+          // handle excision
+          // NOTE(@pdmullen): The below zeroes all intensities within rks <= r_excision
+          // and zeroes intensities within angles where n_0 is about zero. When Compton is
+          // enabled, we delay the n_0_floor excision so that intensites updated via
+          // absorption and scattering inform the Compton update
+          if (excise) {
+            bool apply_excision = (rad_mask_(m,k,j,i) ||
+                                   (!(is_compton_enabled_) && fabs(n_0) < n_0_floor_));
+            if (apply_excision) { i0_(m,n,k,j,i) = 0.0; }
+          }
         }
       }
       // update conserved fluid variables
       if (affect_fluid_) {
-        u0_(m,IEN,k,j,i) += (m_old[0] - m_new[0]);
-        u0_(m,IM1,k,j,i) += (m_old[1] - m_new[1]);
-        u0_(m,IM2,k,j,i) += (m_old[2] - m_new[2]);
-        u0_(m,IM3,k,j,i) += (m_old[3] - m_new[3]);
+        u0_(m,IEN,k,j,i) += inv_rc_*(m_old[0] - m_new[0]);
+        u0_(m,IM1,k,j,i) += inv_rc_*(m_old[1] - m_new[1]);
+        u0_(m,IM2,k,j,i) += inv_rc_*(m_old[2] - m_new[2]);
+        u0_(m,IM3,k,j,i) += inv_rc_*(m_old[3] - m_new[3]);
       }
     }
 
@@ -367,10 +862,10 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
 
         // feedback on fluid
         if (affect_fluid_) {
-          u0_(m,IEN,k,j,i) += (m_old[0] - m_new[0]);
-          u0_(m,IM1,k,j,i) += (m_old[1] - m_new[1]);
-          u0_(m,IM2,k,j,i) += (m_old[2] - m_new[2]);
-          u0_(m,IM3,k,j,i) += (m_old[3] - m_new[3]);
+          u0_(m,IEN,k,j,i) += inv_rc_*(m_old[0] - m_new[0]);
+          u0_(m,IM1,k,j,i) += inv_rc_*(m_old[1] - m_new[1]);
+          u0_(m,IM2,k,j,i) += inv_rc_*(m_old[2] - m_new[2]);
+          u0_(m,IM3,k,j,i) += inv_rc_*(m_old[3] - m_new[3]);
         }
       } else {
         // NOTE(@pdmullen): At this point, it is possible that excision has not been
@@ -389,7 +884,7 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     }
   });
 
-  return TaskStatus::complete;
+  return;
 }
 
 //----------------------------------------------------------------------------------------
@@ -175,11 +175,13 @@ void Radiation::SetOrthonormalTetrad() {
     for (int d=0; d<4; ++d) { tet_d3_x3f_(m,d,k,j,i) = e[d][3]; }
   });
 
-  // Calculate n^angle
+  // Calculate n^angle, or only the symmetric part of omega from which it is recomputed
   if (angular_fluxes) {
     auto uflux = prgeo->unit_flux;
     auto nh_f_ = nh_f;
     auto na_ = na;
+    auto omega_sym_ = omega_sym;
+    bool compress_na_ = compress_na;
     par_for("na",DevExeSpace(),0,(nmb-1),0,(n3-1),0,(n2-1),0,(n1-1),
     KOKKOS_LAMBDA(int m, int k, int j, int i) {
       Real &x1min = size.d_view(m).x1min;
@@ -200,6 +202,10 @@ void Radiation::SetOrthonormalTetrad() {
       ComputeMetricDerivatives(x1v,x2v,x3v,flat,spin,dgx,dgy,dgz);
       Real e[4][4], e_cov[4][4], omega[4][4][4];
       ComputeTetrad(x1v,x2v,x3v,flat,spin,glower,gupper,dgx,dgy,dgz,e,e_cov,omega);
+      if (compress_na_) {
+        StoreSymmetricOmega(omega, omega_sym_, m, k, j, i);
+        return;
+      }
       for (int n=0; n<=nang1; ++n) {
         for (int nb=0; nb<num_neighbors_.d_view(n); ++nb) {
           Real iszetaf = 1.0/sqrt(1.0 - SQR(nh_f_.d_view(n,nb,3)));
@@ -180,4 +180,54 @@ void ComputeTetrad(Real x, Real y, Real z, const bool minkowski, const Real a,
   return;
 }
 
+// number of components of Ricci rotation coefficients omega[a][q][p] (symmetrized
+// over q,p) needed to compute the angular flux coefficients n^a
+#define NOMEGA_SYM 40
+
+//----------------------------------------------------------------------------------------
+//! \fn void StoreSymmetricOmega()
+//! \brief Stores the part of omega[a][q][p] symmetric in (q,p) in array om(m,:,k,j,i).
+//! Only this part contributes to n^a, since omega is contracted with n^q n^p.
+
+template <typename ViewType>
+KOKKOS_INLINE_FUNCTION
+void StoreSymmetricOmega(Real omega[][4][4], const ViewType &om,
+                         const int m, const int k, const int j, const int i) {
+  int idx = 0;
+  for (int a=0; a<4; ++a) {
+    for (int q=0; q<4; ++q) {
+      om(m,idx++,k,j,i) = omega[a][q][q];
+      for (int p=q+1; p<4; ++p) {
+        om(m,idx++,k,j,i) = omega[a][q][p] + omega[a][p][q];
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real AngularFluxCoefficient()
+//! \brief Computes n^a at the angle face with unit normal nh[] and unit flux uf0,uf1
+//! from the symmetric omega stored by StoreSymmetricOmega().  Equal to the value stored
+//! in Radiation::na, but requires only NOMEGA_SYM values per cell for all angles.
+
+template <typename ViewType>
+KOKKOS_INLINE_FUNCTION
+Real AngularFluxCoefficient(const ViewType &om, const int m, const int k, const int j,
+                            const int i, const Real nh[4], const Real uf0,
+                            const Real uf1) {
+  Real c[4];
+  int idx = 0;
+  for (int a=0; a<4; ++a) {
+    c[a] = 0.0;
+    for (int q=0; q<4; ++q) {
+      for (int p=q; p<4; ++p) {
+        c[a] += nh[q]*nh[p]*om(m,idx++,k,j,i);
+      }
+    }
+  }
+  Real iszetaf = 1.0/sqrt(1.0 - SQR(nh[3]));
+  return iszetaf*(nh[0]*c[3] - nh[3]*c[0])*uf0 + (nh[2]*c[1] - nh[1]*c[2])*uf1;
+}
+
 #endif // RADIATION_RADIATION_TETRAD_HPP_
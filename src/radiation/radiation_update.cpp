@@ -30,7 +30,8 @@ TaskStatus Radiation::RKUpdate(Driver *pdriver, int stage) {
   int &is = indcs.is, &ie = indcs.ie;
   int &js = indcs.js, &je = indcs.je;
   int &ks = indcs.ks, &ke = indcs.ke;
-  int nang1 = prgeo->nangles - 1;
+  int nang = prgeo->nangles;
+  int nint1 = nintens - 1;
   int nmb1 = pmy_pack->nmb_thispack - 1;
 
   auto &mbsize  = pmy_pack->pmb->mb_size;
@@ -59,8 +60,13 @@ TaskStatus Radiation::RKUpdate(Driver *pdriver, int stage) {
   auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
   Real &n_0_floor_ = n_0_floor;
 
-  par_for("r_update",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
+  // optically thick MeshBlocks are updated with moments (see radiation_moments.cpp)
+  bool moment_fallback_ = moment_fallback;
+  auto &mb_thick_ = mb_thick;
+
+  par_for("r_update",DevExeSpace(),0,nmb1,0,nint1,ks,ke,js,je,is,ie,
   KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    if (moment_fallback_ && mb_thick_(m)) return;
     // spatial fluxes
     Real divf_s = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
     if (multi_d) {
@@ -75,9 +81,10 @@ TaskStatus Radiation::RKUpdate(Driver *pdriver, int stage) {
     if (angular_fluxes_) { i0_(m,n,k,j,i) -= beta_dt*divfa_(m,n,k,j,i); }
 
     // zero intensity if negative
+    const int a = n % nang;
     Real n0  = tt(m,0,0,k,j,i);
-    Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
-               tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+    Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(a,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(a,1) +
+               tc(m,2,0,k,j,i)*nh_c_.d_view(a,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(a,3);
     i0_(m,n,k,j,i) = n0*n_0*fmax((i0_(m,n,k,j,i)/(n0*n_0)), 0.0);
 
     // handle excision
@@ -89,6 +96,10 @@ TaskStatus Radiation::RKUpdate(Driver *pdriver, int stage) {
     }
   });
 
+  if (moment_fallback) {
+    MomentUpdate(pdriver, stage);
+  }
+
   // add beam source term, if any
   if (psrc->beam)  psrc->BeamSource(i0_, beta_dt);
 
@@ -0,0 +1,86 @@
+#ifndef RECONSTRUCT_FLUX_REGISTRY_HPP_
+#define RECONSTRUCT_FLUX_REGISTRY_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file flux_registry.hpp
+//! \brief Macros that expand to the list of reconstruction methods and EOS types for
+//! which the flux kernels (templated over Riemann solver x reconstruction x EOS) are
+//! compiled.  The lists are set at configure time with Athena_FLUX_RECON and
+//! Athena_FLUX_EOS.  Each physics module expands them into a table of kernels, which
+//! both instantiates the templates and selects the kernel once at construction.
+//!
+//! FLUX_FOR_EACH_RECON(X, args...) expands to X(args..., recon) for each method, and
+//! FLUX_FOR_EACH_EOS(X, args...) to X(args..., ideal) with ideal=true/false for the
+//! ideal/isothermal EOS.  FLUX_FOR_IDEAL_EOS is for solvers that require an ideal gas.
+//! FLUX_FOR_EACH_NVARS(X, args...) expands to X(args..., nvars) for each number of
+//! variables (set with Athena_FLUX_NVARS) for which specialized kernels are compiled in
+//! addition to the generic kernel.  For example 4 (isothermal), 5 (ideal gas), and 6
+//! (ideal gas with one passive scalar).
+
+#include "athena.hpp"
+
+#if FLUX_RECON_DC_ENABLED
+#define FLUX_RECON_DC_(X, ...) X(__VA_ARGS__, ReconstructionMethod::dc)
+#else
+#define FLUX_RECON_DC_(X, ...)
+#endif
+#if FLUX_RECON_PLM_ENABLED
+#define FLUX_RECON_PLM_(X, ...) X(__VA_ARGS__, ReconstructionMethod::plm)
+#else
+#define FLUX_RECON_PLM_(X, ...)
+#endif
+#if FLUX_RECON_PPM_ENABLED
+#define FLUX_RECON_PPM_(X, ...) X(__VA_ARGS__, ReconstructionMethod::ppm4) \
+                                X(__VA_ARGS__, ReconstructionMethod::ppmx)
+#else
+#define FLUX_RECON_PPM_(X, ...)
+#endif
+#if FLUX_RECON_WENOZ_ENABLED
+#define FLUX_RECON_WENOZ_(X, ...) X(__VA_ARGS__, ReconstructionMethod::wenoz)
+#else
+#define FLUX_RECON_WENOZ_(X, ...)
+#endif
+
+#define FLUX_FOR_EACH_RECON(X, ...) FLUX_RECON_DC_(X, __VA_ARGS__)  \
+                                    FLUX_RECON_PLM_(X, __VA_ARGS__) \
+                                    FLUX_RECON_PPM_(X, __VA_ARGS__) \
+                                    FLUX_RECON_WENOZ_(X, __VA_ARGS__)
+
+#if FLUX_EOS_IDEAL_ENABLED
+#define FLUX_FOR_IDEAL_EOS(X, ...) X(__VA_ARGS__, true)
+#else
+#define FLUX_FOR_IDEAL_EOS(X, ...)
+#endif
+#if FLUX_EOS_ISOTHERMAL_ENABLED
+#define FLUX_FOR_ISOTHERMAL_EOS_(X, ...) X(__VA_ARGS__, false)
+#else
+#define FLUX_FOR_ISOTHERMAL_EOS_(X, ...)
+#endif
+
+#define FLUX_FOR_EACH_EOS(X, ...) FLUX_FOR_IDEAL_EOS(X, __VA_ARGS__) \
+                                  FLUX_FOR_ISOTHERMAL_EOS_(X, __VA_ARGS__)
+
+#if FLUX_NVARS_4_ENABLED
+#define FLUX_NVARS_4_(X, ...) X(__VA_ARGS__, 4)
+#else
+#define FLUX_NVARS_4_(X, ...)
+#endif
+#if FLUX_NVARS_5_ENABLED
+#define FLUX_NVARS_5_(X, ...) X(__VA_ARGS__, 5)
+#else
+#define FLUX_NVARS_5_(X, ...)
+#endif
+#if FLUX_NVARS_6_ENABLED
+#define FLUX_NVARS_6_(X, ...) X(__VA_ARGS__, 6)
+#else
+#define FLUX_NVARS_6_(X, ...)
+#endif
+
+#define FLUX_FOR_EACH_NVARS(X, ...) FLUX_NVARS_4_(X, __VA_ARGS__) \
+                                    FLUX_NVARS_5_(X, __VA_ARGS__) \
+                                    FLUX_NVARS_6_(X, __VA_ARGS__)
+
+#endif // RECONSTRUCT_FLUX_REGISTRY_HPP_
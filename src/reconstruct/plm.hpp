@@ -41,13 +41,15 @@ void PLM(const Real &q_im1, const Real &q_i, const Real &q_ip1,
 //! \brief Wrapper function for PLM reconstruction in x1-direction.
 //! This function should be called over [is-1,ie+1] to get BOTH L/R states over [is,ie]
 
+template <int nvar_ = 0, typename QArray>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseLinearX1(TeamMember_t const &member, const int m, const int k, const int j,
-     const int il, const int iu, const DvceArray5D<Real> &q,
+     const int il, const int iu, const QArray &q,
      ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
-  int nvar = q.extent_int(1);
+  int nq = q.extent_int(1), ns = ql.extent_int(0);
+  const int nvar = (nvar_ > 0)? nvar_ : ((nq < ns)? nq : ns);
   for (int n=0; n<nvar; ++n) {
-    par_for_inner(member, il, iu, [&](const int i) {
+    par_for_inner_simd(member, il, iu, [&](const int i) {
       PLM(q(m,n,k,j,i-1), q(m,n,k,j,i), q(m,n,k,j,i+1), ql(n,i+1), qr(n,i));
     });
   }
@@ -59,13 +61,15 @@ void PiecewiseLinearX1(TeamMember_t const &member, const int m, const int k, con
 //! \brief Wrapper function for PLM reconstruction in x2-direction.
 //! This function should be called over [js-1,je+1] to get BOTH L/R states over [js,je]
 
+template <int nvar_ = 0, typename QArray>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseLinearX2(TeamMember_t const &member, const int m, const int k, const int j,
-     const int il, const int iu, const DvceArray5D<Real> &q,
+     const int il, const int iu, const QArray &q,
      ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
-  int nvar = q.extent_int(1);
+  int nq = q.extent_int(1), ns = ql_jp1.extent_int(0);
+  const int nvar = (nvar_ > 0)? nvar_ : ((nq < ns)? nq : ns);
   for (int n=0; n<nvar; ++n) {
-    par_for_inner(member, il, iu, [&](const int i) {
+    par_for_inner_simd(member, il, iu, [&](const int i) {
       PLM(q(m,n,k,j-1,i), q(m,n,k,j,i), q(m,n,k,j+1,i), ql_jp1(n,i), qr_j(n,i));
     });
   }
@@ -77,13 +81,15 @@ void PiecewiseLinearX2(TeamMember_t const &member, const int m, const int k, con
 //! \brief Wrapper function for PLM reconstruction in x3-direction.
 //! This function should be called over [ks-1,ke+1] to get BOTH L/R states over [ks,ke]
 
+template <int nvar_ = 0, typename QArray>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseLinearX3(TeamMember_t const &member, const int m, const int k, const int j,
-     const int il, const int iu, const DvceArray5D<Real> &q,
+     const int il, const int iu, const QArray &q,
      ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
-  int nvar = q.extent_int(1);
+  int nq = q.extent_int(1), ns = ql_kp1.extent_int(0);
+  const int nvar = (nvar_ > 0)? nvar_ : ((nq < ns)? nq : ns);
   for (int n=0; n<nvar; ++n) {
-    par_for_inner(member, il, iu, [&](const int i) {
+    par_for_inner_simd(member, il, iu, [&](const int i) {
       PLM(q(m,n,k-1,j,i), q(m,n,k,j,i), q(m,n,k+1,j,i), ql_kp1(n,i), qr_k(n,i));
     });
   }
@@ -187,18 +187,20 @@ void PPMX(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_i
 //! \brief Wrapper function for PPM reconstruction in x1-direction.
 //! This function should be called over [is-1,ie+1] to get BOTH L/R states over [is,ie]
 
+template <int nvar_ = 0, typename QArray>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseParabolicX1(TeamMember_t const &member,
      const EOS_Data &eos, const bool extremum_preserving, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
-  int nvar = q.extent_int(1);
+     const QArray &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
+  int nq = q.extent_int(1), ns = ql.extent_int(0);
+  const int nvar = (nvar_ > 0)? nvar_ : ((nq < ns)? nq : ns);
   const Real &dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
   Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
   for (int n=0; n<nvar; ++n) {
     if (extremum_preserving) {
-      par_for_inner(member, il, iu, [&](const int i) {
+      par_for_inner_simd(member, il, iu, [&](const int i) {
         Real &qim2 = q(m,n,k,j,i-2);
         Real &qim1 = q(m,n,k,j,i-1);
         Real &qi   = q(m,n,k,j,i  );
@@ -217,7 +219,7 @@ void PiecewiseParabolicX1(TeamMember_t const &member,
         }
       });
     } else {
-      par_for_inner(member, il, iu, [&](const int i) {
+      par_for_inner_simd(member, il, iu, [&](const int i) {
         Real &qim2 = q(m,n,k,j,i-2);
         Real &qim1 = q(m,n,k,j,i-1);
         Real &qi   = q(m,n,k,j,i  );
@@ -235,18 +237,20 @@ void PiecewiseParabolicX1(TeamMember_t const &member,
 //! \brief Wrapper function for PPM reconstruction in x2-direction.
 //! This function should be called over [js-1,je+1] to get BOTH L/R states over [js,je]
 
+template <int nvar_ = 0, typename QArray>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseParabolicX2(TeamMember_t const &member,
      const EOS_Data &eos, const bool extremum_preserving, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
-  int nvar = q.extent_int(1);
+     const QArray &q, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
+  int nq = q.extent_int(1), ns = ql_jp1.extent_int(0);
+  const int nvar = (nvar_ > 0)? nvar_ : ((nq < ns)? nq : ns);
   const Real &dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
   Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
   for (int n=0; n<nvar; ++n) {
     if (extremum_preserving) {
-      par_for_inner(member, il, iu, [&](const int i) {
+      par_for_inner_simd(member, il, iu, [&](const int i) {
         Real &qjm2 = q(m,n,k,j-2,i);
         Real &qjm1 = q(m,n,k,j-1,i);
         Real &qj   = q(m,n,k,j  ,i);
@@ -265,7 +269,7 @@ void PiecewiseParabolicX2(TeamMember_t const &member,
         }
       });
     } else {
-      par_for_inner(member, il, iu, [&](const int i) {
+      par_for_inner_simd(member, il, iu, [&](const int i) {
         Real &qjm2 = q(m,n,k,j-2,i);
         Real &qjm1 = q(m,n,k,j-1,i);
         Real &qj   = q(m,n,k,j  ,i);
@@ -283,18 +287,20 @@ void PiecewiseParabolicX2(TeamMember_t const &member,
 //! \brief Wrapper function for PPM reconstruction in x3-direction.
 //! This function should be called over [ks-1,ke+1] to get BOTH L/R states over [ks,ke]
 
+template <int nvar_ = 0, typename QArray>
 KOKKOS_INLINE_FUNCTION
 void PiecewiseParabolicX3(TeamMember_t const &member,
      const EOS_Data &eos, const bool extremum_preserving, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
-  int nvar = q.extent_int(1);
+     const QArray &q, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
+  int nq = q.extent_int(1), ns = ql_kp1.extent_int(0);
+  const int nvar = (nvar_ > 0)? nvar_ : ((nq < ns)? nq : ns);
   const Real &dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
   Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
   for (int n=0; n<nvar; ++n) {
     if (extremum_preserving) {
-      par_for_inner(member, il, iu, [&](const int i) {
+      par_for_inner_simd(member, il, iu, [&](const int i) {
         Real &qkm2 = q(m,n,k-2,j,i);
         Real &qkm1 = q(m,n,k-1,j,i);
         Real &qk   = q(m,n,k  ,j,i);
@@ -313,7 +319,7 @@ void PiecewiseParabolicX3(TeamMember_t const &member,
         }
       });
     } else {
-      par_for_inner(member, il, iu, [&](const int i) {
+      par_for_inner_simd(member, il, iu, [&](const int i) {
         Real &qkm2 = q(m,n,k-2,j,i);
         Real &qkm1 = q(m,n,k-1,j,i);
         Real &qk   = q(m,n,k  ,j,i);
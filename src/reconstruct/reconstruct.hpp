@@ -0,0 +1,92 @@
+#ifndef RECONSTRUCT_RECONSTRUCT_HPP_
+#define RECONSTRUCT_RECONSTRUCT_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file reconstruct.hpp
+//! \brief selects reconstruction function by method and direction at run time.  Used by
+//! flux kernels that call reconstruction in more than one place.
+//!
+//! All reconstruction functions return L/R states of variables 0 to nvar-1, where nvar is
+//! their (optional) first template argument if it is nonzero, and otherwise the smaller
+//! of the number of variables in q and the number of rows of the scratch arrays.
+
+#include "athena.hpp"
+#include "eos/eos.hpp"
+#include "reconstruct/dc.hpp"
+#include "reconstruct/plm.hpp"
+#include "reconstruct/ppm.hpp"
+#include "reconstruct/wenoz.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruct()
+//! \brief Calls reconstruction function selected by recon in direction dir (1,2,3).
+//! Array q can be either a DvceArray5D or a ScrTile.  Floors are always applied with
+//! PPM and WENOZ, as in the Hydro and MHD flux functions.
+
+template <typename QArray>
+KOKKOS_INLINE_FUNCTION
+void Reconstruct(TeamMember_t const &member, const ReconstructionMethod recon,
+     const EOS_Data &eos, const bool extrema, const int dir, const int m, const int k,
+     const int j, const int il, const int iu, const QArray &q,
+     ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
+  if (dir == 1) {
+    switch (recon) {
+      case ReconstructionMethod::dc:
+        DonorCellX1(member, m, k, j, il, iu, q, ql, qr);
+        break;
+      case ReconstructionMethod::plm:
+        PiecewiseLinearX1(member, m, k, j, il, iu, q, ql, qr);
+        break;
+      case ReconstructionMethod::ppm4:
+      case ReconstructionMethod::ppmx:
+        PiecewiseParabolicX1(member, eos, extrema, true, m, k, j, il, iu, q, ql, qr);
+        break;
+      case ReconstructionMethod::wenoz:
+        WENOZX1(member, eos, true, m, k, j, il, iu, q, ql, qr);
+        break;
+      default:
+        break;
+    }
+  } else if (dir == 2) {
+    switch (recon) {
+      case ReconstructionMethod::dc:
+        DonorCellX2(member, m, k, j, il, iu, q, ql, qr);
+        break;
+      case ReconstructionMethod::plm:
+        PiecewiseLinearX2(member, m, k, j, il, iu, q, ql, qr);
+        break;
+      case ReconstructionMethod::ppm4:
+      case ReconstructionMethod::ppmx:
+        PiecewiseParabolicX2(member, eos, extrema, true, m, k, j, il, iu, q, ql, qr);
+        break;
+      case ReconstructionMethod::wenoz:
+        WENOZX2(member, eos, true, m, k, j, il, iu, q, ql, qr);
+        break;
+      default:
+        break;
+    }
+  } else {
+    switch (recon) {
+      case ReconstructionMethod::dc:
+        DonorCellX3(member, m, k, j, il, iu, q, ql, qr);
+        break;
+      case ReconstructionMethod::plm:
+        PiecewiseLinearX3(member, m, k, j, il, iu, q, ql, qr);
+        break;
+      case ReconstructionMethod::ppm4:
+      case ReconstructionMethod::ppmx:
+        PiecewiseParabolicX3(member, eos, extrema, true, m, k, j, il, iu, q, ql, qr);
+        break;
+      case ReconstructionMethod::wenoz:
+        WENOZX3(member, eos, true, m, k, j, il, iu, q, ql, qr);
+        break;
+      default:
+        break;
+    }
+  }
+  return;
+}
+#endif // RECONSTRUCT_RECONSTRUCT_HPP_
@@ -0,0 +1,158 @@
+#ifndef RECONSTRUCT_SCRATCH_TILE_HPP_
+#define RECONSTRUCT_SCRATCH_TILE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file scratch_tile.hpp
+//! \brief 3D bricks of cell-centered variables (including ghost cells) stored in team
+//! scratch memory.  Can be passed to the reconstruction functions in place of the
+//! DvceArray5D of primitives, so that reconstruction in all three directions reads the
+//! neighbours of each cell from scratch rather than from global memory.  ScrTile holds
+//! a full brick (as needed for mixed derivatives), ScrStarTile omits the edge and corner
+//! ghost cells that reconstruction never reads.
+
+#include "athena.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \struct ScrTile
+//! \brief Brick of nvar variables over cells [k0,k0+nk-1]x[j0,j0+nj-1]x[i0,i0+ni-1] of
+//! MeshBlock m, indexed with the same (m,n,k,j,i) indices as the global array.  Index m
+//! is ignored, since a tile only ever holds data from one MeshBlock.
+
+struct ScrTile {
+  ScrArray1D<Real> q;
+  int nvar, nk, nj, ni;
+  int k0, j0, i0;
+
+  // returns size in bytes of scratch memory needed for tile
+  static size_t shmem_size(const int nvar, const int nk, const int nj, const int ni) {
+    return ScrArray1D<Real>::shmem_size(nvar*nk*nj*ni);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  Real &operator()(const int m, const int n, const int k, const int j,
+                   const int i) const {
+    return q(((n*nk + (k-k0))*nj + (j-j0))*ni + (i-i0));
+  }
+  // only extent of variable index is needed by reconstruction functions
+  KOKKOS_INLINE_FUNCTION
+  int extent_int(const int r) const {
+    return (r == 1)? nvar : 1;
+  }
+
+  // loads tile from array a (of MeshBlock m) using all threads in team
+  KOKKOS_INLINE_FUNCTION
+  void Load(TeamMember_t const &member, const DvceArray5D<Real> &a, const int m) const {
+    const int nkji = nk*nj*ni;
+    par_for_inner(member, 0, nvar*nkji-1, [&](const int idx) {
+      int n = idx/nkji;
+      int k = (idx - n*nkji)/(nj*ni);
+      int j = (idx - n*nkji - k*nj*ni)/ni;
+      int i = idx - n*nkji - k*nj*ni - j*ni;
+      q(idx) = a(m,n,k+k0,j+j0,i+i0);
+    });
+    member.team_barrier();
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct ScrStarTile
+//! \brief Tile of nvar variables over active cells [k0,k0+nk-1]x[j0,j0+nj-1]x[i0,i0+ni-1]
+//! of MeshBlock m, plus gk, gj, gi ghost cells on each side in each direction, but
+//! without the edge and corner ghost cells (a "star" stencil).  This holds everything
+//! needed by reconstruction along each coordinate direction, which only ever offsets one
+//! index from the active cells.  Compared to a ScrTile with the same active cells, the
+//! scratch memory (and global memory read to load it) is much smaller for small tiles.
+//! Indexed with the same (m,n,k,j,i) indices as the global array; index m is ignored.
+//! For each variable, the active cells are stored first, followed by the ghost cells in
+//! the i-, j-, and k-directions.
+
+struct ScrStarTile {
+  ScrArray1D<Real> q;
+  int nvar, nk, nj, ni;
+  int gk, gj, gi;
+  int k0, j0, i0;
+
+  // number of values stored for each variable
+  KOKKOS_INLINE_FUNCTION
+  static int VarSize(const int nk, const int nj, const int ni, const int gk,
+                     const int gj, const int gi) {
+    return nk*nj*ni + 2*gi*nk*nj + 2*gj*nk*ni + 2*gk*nj*ni;
+  }
+  // returns size in bytes of scratch memory needed for tile
+  static size_t shmem_size(const int nvar, const int nk, const int nj, const int ni,
+                           const int gk, const int gj, const int gi) {
+    return ScrArray1D<Real>::shmem_size(nvar*VarSize(nk, nj, ni, gk, gj, gi));
+  }
+
+  // offset of cell (k,j,i) (relative to first active cell) within a variable
+  KOKKOS_INLINE_FUNCTION
+  int Offset(const int kk, const int jj, const int ii) const {
+    const int nact = nk*nj*ni;
+    if (ii < 0 || ii >= ni) {
+      int ih = (ii < 0)? (ii + gi) : (ii - ni + gi);
+      return nact + (kk*nj + jj)*2*gi + ih;
+    } else if (jj < 0 || jj >= nj) {
+      int jh = (jj < 0)? (jj + gj) : (jj - nj + gj);
+      return nact + 2*gi*nk*nj + (kk*2*gj + jh)*ni + ii;
+    } else if (kk < 0 || kk >= nk) {
+      int kh = (kk < 0)? (kk + gk) : (kk - nk + gk);
+      return nact + 2*gi*nk*nj + 2*gj*nk*ni + (kh*nj + jj)*ni + ii;
+    }
+    return (kk*nj + jj)*ni + ii;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  Real &operator()(const int m, const int n, const int k, const int j,
+                   const int i) const {
+    return q(n*VarSize(nk, nj, ni, gk, gj, gi) + Offset(k-k0, j-j0, i-i0));
+  }
+  // only extent of variable index is needed by reconstruction functions
+  KOKKOS_INLINE_FUNCTION
+  int extent_int(const int r) const {
+    return (r == 1)? nvar : 1;
+  }
+
+  // loads tile from array a (of MeshBlock m) using all threads in team, by inverting
+  // the storage order in Offset()
+  KOKKOS_INLINE_FUNCTION
+  void Load(TeamMember_t const &member, const DvceArray5D<Real> &a, const int m) const {
+    const int nv = VarSize(nk, nj, ni, gk, gj, gi);
+    const int nact = nk*nj*ni;
+    const int nhi = 2*gi*nk*nj, nhj = 2*gj*nk*ni;
+    par_for_inner(member, 0, nvar*nv-1, [&](const int idx) {
+      int n = idx/nv;
+      int r = idx - n*nv;
+      int k, j, i;
+      if (r < nact) {
+        k = r/(nj*ni);
+        j = (r - k*nj*ni)/ni;
+        i = r - k*nj*ni - j*ni;
+      } else if (r < nact + nhi) {
+        r -= nact;
+        int kj = r/(2*gi);
+        int ih = r - kj*2*gi;
+        k = kj/nj;
+        j = kj - k*nj;
+        i = (ih < gi)? (ih - gi) : (ih - gi + ni);
+      } else if (r < nact + nhi + nhj) {
+        r -= nact + nhi;
+        k = r/(2*gj*ni);
+        int jh = (r - k*2*gj*ni)/ni;
+        i = r - k*2*gj*ni - jh*ni;
+        j = (jh < gj)? (jh - gj) : (jh - gj + nj);
+      } else {
+        r -= nact + nhi + nhj;
+        int kh = r/(nj*ni);
+        j = (r - kh*nj*ni)/ni;
+        i = r - kh*nj*ni - j*ni;
+        k = (kh < gk)? (kh - gk) : (kh - gk + nk);
+      }
+      q(idx) = a(m,n,k+k0,j+j0,i+i0);
+    });
+    member.team_barrier();
+  }
+};
+#endif // RECONSTRUCT_SCRATCH_TILE_HPP_
@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -30,10 +31,12 @@
 OrbitalAdvection::OrbitalAdvection(MeshBlockPack *ppack, ParameterInput *pin) :
     maxjshift(1),
     shearing_box_r_phi(false),     // 2D r-phi not yet implemented
+    preq_version(-1),
     pmy_pack(ppack) {
   // Read shear rate and orbital frequency
   qshear = pin->GetReal("shearing_box","qshear");
   omega0 = pin->GetReal("shearing_box","omega0");
+  pipelined = pin->GetOrAddBoolean("shearing_box","pipelined_oa",false);
 
   // estimate maximum integer shift in x2-direction for orbital advection
   Real xmin = fabs(ppack->pmesh->mesh_size.x1min);
@@ -62,9 +65,97 @@ OrbitalAdvection::OrbitalAdvection(MeshBlockPack *ppack, ParameterInput *pin) :
 
 OrbitalAdvection::~OrbitalAdvection() {
 #if MPI_PARALLEL_ENABLED
+  int nmb = std::max((pmy_pack->nmb_thispack), (pmy_pack->pmesh->nmb_maxperrank));
   for (int n=0; n<2; ++n) {
+    if (pipelined) {
+      for (int m=0; m<nmb; ++m) {
+        if (sendbuf[n].vars_req[m] != MPI_REQUEST_NULL) {
+          MPI_Request_free(&(sendbuf[n].vars_req[m]));
+        }
+        if (recvbuf[n].vars_req[m] != MPI_REQUEST_NULL) {
+          MPI_Request_free(&(recvbuf[n].vars_req[m]));
+        }
+      }
+    }
     delete [] sendbuf[n].vars_req;
     delete [] recvbuf[n].vars_req;
   }
 #endif
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void OrbitalAdvection::SetPersistentRequests()
+//! \brief With pipelined orbital advection, creates persistent MPI requests for the
+//! send and recv buffers of every MB with an x2-face neighbor on another rank.  Since
+//! buffers and neighbors are fixed, requests are only rebuilt when the neighbors of MBs
+//! change.  Any previous requests have completed, since this function is only called at
+//! the start of communications.
+
+void OrbitalAdvection::SetPersistentRequests() {
+#if MPI_PARALLEL_ENABLED
+  if (preq_version == pmy_pack->pmesh->nghbr_version) return;
+  const int &nmb = pmy_pack->nmb_thispack;
+  const auto &nghbr = pmy_pack->pmb->nghbr;
+  const int nmbmax = std::max(nmb, pmy_pack->pmesh->nmb_maxperrank);
+  for (int n=0; n<2; ++n) {
+    for (int m=0; m<nmbmax; ++m) {
+      if (sendbuf[n].vars_req[m] != MPI_REQUEST_NULL) {
+        MPI_Request_free(&(sendbuf[n].vars_req[m]));
+      }
+      if (recvbuf[n].vars_req[m] != MPI_REQUEST_NULL) {
+        MPI_Request_free(&(recvbuf[n].vars_req[m]));
+      }
+    }
+  }
+
+  bool no_errors=true;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<2; ++n) {
+      // indices of x2-face buffers in nghbr view
+      int nnghbr;
+      if (n==0) {nnghbr=8;} else {nnghbr=12;}
+      if (nghbr.h_view(m,nnghbr).gid >= 0 &&
+          nghbr.h_view(m,nnghbr).rank != global_variable::my_rank) {
+        int drank = nghbr.h_view(m,nnghbr).rank;
+        using Kokkos::ALL;
+        // send uses tag of local ID and buffer index of *receiving* MeshBlock
+        int lid = nghbr.h_view(m,nnghbr).gid - pmy_pack->pmesh->gids_eachrank[drank];
+        int tag = CreateBvals_MPI_Tag(lid, nghbr.h_view(m,nnghbr).dest);
+        auto send_ptr = Kokkos::subview(sendbuf[n].vars, m, ALL, ALL, ALL, ALL);
+        int ierr = MPI_Send_init(send_ptr.data(), send_ptr.size(), MPI_ATHENA_REAL, drank,
+                                 tag, comm_orb_advect, &(sendbuf[n].vars_req[m]));
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+
+        // recv uses tag of local ID and buffer index of this MeshBlock
+        tag = CreateBvals_MPI_Tag(m, nnghbr);
+        auto recv_ptr = Kokkos::subview(recvbuf[n].vars, m, ALL, ALL, ALL, ALL);
+        ierr = MPI_Recv_init(recv_ptr.data(), recv_ptr.size(), MPI_ATHENA_REAL, drank,
+                             tag, comm_orb_advect, &(recvbuf[n].vars_req[m]));
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+      }
+    }
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in creating persistent requests" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  preq_version = pmy_pack->pmesh->nghbr_version;
+#endif
+  return;
+}
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn void OrbitalAdvection::AddRecvRequests()
+//! \brief Appends pointers to the requests of receives from x2-face neighbors
+
+void OrbitalAdvection::AddRecvRequests(std::vector<MPI_Request*> &reqs) {
+  int nmb = pmy_pack->nmb_thispack;
+  for (int n=0; n<2; ++n) {
+    for (int m=0; m<nmb; ++m) {reqs.push_back(&(recvbuf[n].vars_req[m]));}
+  }
+  return;
+}
+#endif
@@ -9,6 +9,8 @@
 //! \brief definitions for classes that implement orbital advection abstract base and
 //! derived classes (for CC and FC variables).
 
+#include <vector>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "shearing_box/shearing_box.hpp"
@@ -28,6 +30,11 @@ class OrbitalAdvection {
   int maxjshift;            // maximum integer shift of any cell in orbital advection
   Real qshear, omega0;      // Copies needed for all OA functions
   bool shearing_box_r_phi;  // NOT YET IMPLEMENTED
+  // With <shearing_box>/pipelined_oa=true, sends and receives use persistent MPI
+  // requests, and (in MHD) messages of U are in flight while E-fields and CT are
+  // computed, and messages of B while boundary values of U are communicated.
+  bool pipelined;
+  int preq_version;         // Mesh::nghbr_version when persistent requests were built
 
   // data buffers for orbital advection. Only two x2-faces communicate
   ShearingBoxBoundaryBuffer sendbuf[2], recvbuf[2];
@@ -39,8 +46,12 @@ class OrbitalAdvection {
 
   // functions
   TaskStatus InitRecv();
+  void SetPersistentRequests();
   TaskStatus ClearRecv();
   TaskStatus ClearSend();
+#if MPI_PARALLEL_ENABLED
+  void AddRecvRequests(std::vector<MPI_Request*> &reqs);
+#endif
 
  protected:
   // must use pointer to MBPack and not parent physics module since parent can be one of
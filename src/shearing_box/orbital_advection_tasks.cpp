@@ -21,7 +21,7 @@
 //----------------------------------------------------------------------------------------
 //! \fn void OrbitalAdvection::InitRecv
 //! \brief Posts non-blocking receives (with MPI) for boundary communications with
-//! orbital advection
+//! orbital advection.  With pipelined orbital advection, starts persistent receives.
 
 TaskStatus OrbitalAdvection::InitRecv() {
 #if MPI_PARALLEL_ENABLED
@@ -30,29 +30,44 @@ TaskStatus OrbitalAdvection::InitRecv() {
 
   // Initialize communications of variables
   bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<2; ++n) {
-      // indices of x2-face buffers in nghbr view
-      int nnghbr;
-      if (n==0) {nnghbr=8;} else {nnghbr=12;}
-      if (nghbr.h_view(m,nnghbr).gid >= 0) {
-        // rank of neighboring MeshBlock sending data
-        int srank = nghbr.h_view(m,nnghbr).rank;
+  if (pipelined) {
+    SetPersistentRequests();
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<2; ++n) {
+        int nnghbr;
+        if (n==0) {nnghbr=8;} else {nnghbr=12;}
+        if (nghbr.h_view(m,nnghbr).gid >= 0 &&
+            nghbr.h_view(m,nnghbr).rank != global_variable::my_rank) {
+          int ierr = MPI_Start(&(recvbuf[n].vars_req[m]));
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+        }
+      }
+    }
+  } else {
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<2; ++n) {
+        // indices of x2-face buffers in nghbr view
+        int nnghbr;
+        if (n==0) {nnghbr=8;} else {nnghbr=12;}
+        if (nghbr.h_view(m,nnghbr).gid >= 0) {
+          // rank of neighboring MeshBlock sending data
+          int srank = nghbr.h_view(m,nnghbr).rank;
 
-        // post non-blocking receive if neighboring MeshBlock on a different rank
-        if (srank != global_variable::my_rank) {
-          // create tag using local ID and buffer index of *receiving* MeshBlock
-          int tag = CreateBvals_MPI_Tag(m, nnghbr);
+          // post non-blocking receive if neighboring MeshBlock on a different rank
+          if (srank != global_variable::my_rank) {
+            // create tag using local ID and buffer index of *receiving* MeshBlock
+            int tag = CreateBvals_MPI_Tag(m, nnghbr);
 
-          // get pointer to variables
-          using Kokkos::ALL;
-          auto recv_ptr = Kokkos::subview(recvbuf[n].vars, m, ALL, ALL, ALL, ALL);
-          int data_size = recv_ptr.size();
+            // get pointer to variables
+            using Kokkos::ALL;
+            auto recv_ptr = Kokkos::subview(recvbuf[n].vars, m, ALL, ALL, ALL, ALL);
+            int data_size = recv_ptr.size();
 
-          // Post non-blocking receive for this buffer on this MeshBlock
-          int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, srank, tag,
-                               comm_orb_advect, &(recvbuf[n].vars_req[m]));
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
+            // Post non-blocking receive for this buffer on this MeshBlock
+            int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, srank, tag,
+                                 comm_orb_advect, &(recvbuf[n].vars_req[m]));
+            if (ierr != MPI_SUCCESS) {no_errors=false;}
+          }
         }
       }
     }
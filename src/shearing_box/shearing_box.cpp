@@ -7,11 +7,14 @@
 //! \brief constructor for ShearingBox abstract base class, and utility functions
 
 #include <algorithm>
+#include <array>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "hydro/hydro.hpp"
@@ -25,6 +28,14 @@ ShearingBox::ShearingBox(MeshBlockPack *ppack, ParameterInput *pin) :
     nmb_x1bndry("nmbx1",2),
     x1bndry_mbgid("x1gid",1,1),
     shearing_box_r_phi(false),     // 2D r-phi not yet implemented
+    nslab_local(0),
+    nslab_send(0),
+    nslab_recv(0),
+    slab_local("slab_local",1,4),
+    slab_send("slab_send",1,4),
+    slab_recv("slab_recv",1,4),
+    msg_sbuf("msg_sbuf",1),
+    msg_rbuf("msg_rbuf",1),
     pmy_pack(ppack) {
   // Read shear rate and orbital frequency
   qshear = pin->GetReal("shearing_box","qshear");
@@ -65,22 +76,12 @@ ShearingBox::ShearingBox(MeshBlockPack *ppack, ParameterInput *pin) :
   x1bndry_mbgid.template modify<HostMemSpace>();
   x1bndry_mbgid.template sync<DevExeSpace>();
 
-
-#if MPI_PARALLEL_ENABLED
-  // initialize vectors of MPI requests for ix1/ox1 boundaries in fixed length arrays
-  // each MB on x1-face can communicate with up to 3 nghbrs
+  // initialize integer shifts so that remap plan is built on first call to InitRecv
   for (int n=0; n<2; ++n) {
-    if (nmb_x1bndry(n) > 0) {
-      sendbuf[n].vars_req = new MPI_Request[3*nmb_x1bndry(n)];
-      recvbuf[n].vars_req = new MPI_Request[3*nmb_x1bndry(n)];
-      for (int m=0; m<nmb_x1bndry(0); ++m) {
-        for (int l=0; l<3; ++l) {
-          sendbuf[n].vars_req[3*m + l] = MPI_REQUEST_NULL;
-          recvbuf[n].vars_req[3*m + l] = MPI_REQUEST_NULL;
-        }
-      }
-    }
+    plan_joffset[n].assign(nmb_x1bndry(n), -1);
   }
+
+#if MPI_PARALLEL_ENABLED
   // create unique communicators for shearing box
   MPI_Comm_dup(MPI_COMM_WORLD, &comm_sbox);
 #endif
@@ -90,14 +91,6 @@ ShearingBox::ShearingBox(MeshBlockPack *ppack, ParameterInput *pin) :
 // ShearingBox base class destructor
 
 ShearingBox::~ShearingBox() {
-#if MPI_PARALLEL_ENABLED
-  for (int n=0; n<2; ++n) {
-    if (nmb_x1bndry(n) > 0) {
-      delete [] sendbuf[n].vars_req;
-      delete [] recvbuf[n].vars_req;
-    }
-  }
-#endif
 }
 
 //----------------------------------------------------------------------------------------
@@ -119,3 +112,340 @@ void ShearingBox::FindTargetMB(const int igid, const int jshift, int &gid,
   rank = pm->rank_eachmb[gid];
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn int ShearingBox::RemapSlabs()
+//! \brief Splits the send buffer of a MB at x1-boundary n that has sheared by an integer
+//! number of cells joffset into slabs.  Returns the number of slabs, the range of
+//! j-indices of each slab in the send and recv buffers, and the x2-offset (in MBs) of
+//! the target MB of each slab.  The sender of slab l of a MB is at offset -jshift[l].
+//! Algorithm is broken into three cases:
+//!  * Case1 and case3 are when the integer shift (jr<ng), so that the sending MB
+//!    overlaps the ghost cells of the two neighbors, and so requires copy/send
+//!    to three separate target MBs.
+//!  * Case2 is when the sending MB straddles the boundary between MBs, and so requires
+//!    copy/send to only two target MBs.
+
+int ShearingBox::RemapSlabs(const int n, const int joffset, std::pair<int,int> jsrc[3],
+                            std::pair<int,int> jdst[3], int jshift[3]) {
+  const auto &indcs = pmy_pack->pmesh->mb_indcs;
+  const int &js = indcs.js, &je = indcs.je;
+  const int &ng = indcs.ng;
+  const int &nx2 = indcs.nx2;
+  // This assumes every grid has same number of cells in x2-direction!
+  int ji = joffset/nx2;
+  int jr = joffset - ji*nx2;
+
+  if (jr < ng) {               //--- CASE 1 (in my nomenclature)
+    if (n==0) {
+      jsrc[0] = std::make_pair(js,js+ng-jr);
+      jsrc[1] = std::make_pair(js,je+1);
+      jsrc[2] = std::make_pair(je-(ng-1)-jr,je+1);
+      jdst[0] = std::make_pair(je+1+jr,je+ng+1);
+      jdst[1] = std::make_pair(js+jr,je+jr+1);
+      jdst[2] = std::make_pair(js-ng,js+jr);
+    } else {
+      jsrc[0] = std::make_pair(js,js+ng+jr);
+      jsrc[1] = std::make_pair(js,je+1);
+      jsrc[2] = std::make_pair(je-(ng-1)+jr,je+1);
+      jdst[0] = std::make_pair(je+1-jr,je+ng+1);
+      jdst[1] = std::make_pair(js-jr,je-jr+1);
+      jdst[2] = std::make_pair(js-ng,js-jr);
+    }
+    // ix1 boundary: send to (target-1) through (target+1)
+    // ox1 boundary: send to (target-1) through (target+1)
+    for (int l=0; l<3; ++l) {
+      if (n==0) {jshift[l] = ji+l-1;} else {jshift[l] = l-1-ji;}
+    }
+    return 3;
+  } else if (jr < (nx2-ng)) {  //--- CASE 2
+    if (n==0) {
+      jsrc[0] = std::make_pair(js,je+ng-jr+1);
+      jsrc[1] = std::make_pair(je-(ng-1)-jr,je+1);
+      jdst[0] = std::make_pair(js+jr,je+ng+1);
+      jdst[1] = std::make_pair(js-ng,js+jr);
+    } else {
+      jsrc[0] = std::make_pair(js,js+ng+jr);
+      jsrc[1] = std::make_pair(js-ng+jr,je+1);
+      jdst[0] = std::make_pair(je-jr+1,je+ng+1);
+      jdst[1] = std::make_pair(js-ng,je-jr+1);
+    }
+    // ix1 boundary: send to (target  ) through (target+1)
+    // ox1 boundary: send to (target-1) through (target  )
+    for (int l=0; l<2; ++l) {
+      if (n==0) {jshift[l] = ji+l;} else {jshift[l] = l-1-ji;}
+    }
+    return 2;
+  }
+  //--- CASE 3
+  if (n==0) {
+    jsrc[0] = std::make_pair(js,js+ng+(nx2-jr));
+    jsrc[1] = std::make_pair(js,je+1);
+    jsrc[2] = std::make_pair(je-(ng-1)+(nx2-jr),je+1);
+    jdst[0] = std::make_pair(je+1-(nx2-jr),je+ng+1);
+    jdst[1] = std::make_pair(js-(nx2-jr),je-(nx2-jr)+1);
+    jdst[2] = std::make_pair(js-ng,js-(nx2-jr));
+  } else {
+    jsrc[0] = std::make_pair(js,js+ng-(nx2-jr));
+    jsrc[1] = std::make_pair(js,je+1);
+    jsrc[2] = std::make_pair(je-(ng-1)-(nx2-jr),je+1);
+    jdst[0] = std::make_pair(je+1+(nx2-jr),je+ng+1);
+    jdst[1] = std::make_pair(js+(nx2-jr),je+(nx2-jr)+1);
+    jdst[2] = std::make_pair(js-ng,js+(nx2-jr));
+  }
+  // ix1 boundary: send to (target  ) through (target+2)
+  // ox1 boundary: send to (target-2) through (target  )
+  for (int l=0; l<3; ++l) {
+    if (n==0) {jshift[l] = ji+l;} else {jshift[l] = l-2-ji;}
+  }
+  return 3;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ShearingBox::SetRemapPlan()
+//! \brief Builds the list of slabs copied between MBs on this rank, packed into messages
+//! to other ranks, and unpacked from messages from other ranks, for the current yshear.
+//! Target MBs and ranks are only searched for when the integer shift of any MB changes,
+//! which for typical shear rates is once every few cycles.  Any previous communications
+//! have completed, since this function is only called at the start of communications.
+
+void ShearingBox::SetRemapPlan() {
+  const auto &mbsize = pmy_pack->pmb->mb_size;
+  bool changed = false;
+  for (int n=0; n<2; ++n) {
+    for (int m=0; m<nmb_x1bndry(n); ++m) {
+      int mm = x1bndry_mbgid.h_view(n,m) - pmy_pack->gids;
+      int joffset  = static_cast<int>(yshear/(mbsize.h_view(mm).dx2));
+      if (joffset != plan_joffset[n][m]) {
+        plan_joffset[n][m] = joffset;
+        changed = true;
+      }
+    }
+  }
+  if (!(changed)) return;
+
+  // Slabs of buffers (m,jl:ju) are contiguous, with size (ju-jl)*nrow.  Offset of slab
+  // with first index (m,jl) is (m*ncells2 + jl)*nrow
+  const int ncells2 = sendbuf[0].vars.extent_int(1);
+  const int nrow = sendbuf[0].vars.extent_int(2)*sendbuf[0].vars.extent_int(3)*
+                   sendbuf[0].vars.extent_int(4);
+
+  // collect (n, offset in send buffer, offset in recv buffer, size) of copies on this
+  // rank, and (rank, gid of receiving MB, n, l, offset in buffer, size) of messages
+  std::vector<std::array<int,4>> local;
+  std::vector<std::array<int,6>> sends, recvs;
+  for (int n=0; n<2; ++n) {
+    for (int m=0; m<nmb_x1bndry(n); ++m) {
+      int gid = x1bndry_mbgid.h_view(n,m);
+      std::pair<int,int> jsrc[3], jdst[3];
+      int jshift[3];
+      int nl = RemapSlabs(n, plan_joffset[n][m], jsrc, jdst, jshift);
+      for (int l=0; l<nl; ++l) {
+        int tgid, trank;
+        FindTargetMB(gid,jshift[l],tgid,trank);
+        int soff = (m*ncells2 + jsrc[l].first)*nrow;
+        int ssize = (jsrc[l].second - jsrc[l].first)*nrow;
+        if (trank == global_variable::my_rank) {
+          int tm = TargetIndex(n,tgid);
+          local.push_back({n, soff, (tm*ncells2 + jdst[l].first)*nrow, ssize});
+        } else {
+          sends.push_back({trank, tgid, n, l, soff, ssize});
+        }
+        int sgid, srank;
+        FindTargetMB(gid,-jshift[l],sgid,srank);
+        if (srank != global_variable::my_rank) {
+          recvs.push_back({srank, gid, n, l, (m*ncells2 + jdst[l].first)*nrow,
+                           (jdst[l].second - jdst[l].first)*nrow});
+        }
+      }
+    }
+  }
+  std::sort(sends.begin(), sends.end());
+  std::sort(recvs.begin(), recvs.end());
+
+  // set offsets of slabs in messages, and start/size of message for each rank
+  msg_srank.clear();
+  msg_sstart.clear();
+  msg_ssize.clear();
+  int stotal = 0;
+  for (auto &it : sends) {
+    if (msg_srank.empty() || msg_srank.back() != it[0]) {
+      msg_srank.push_back(it[0]);
+      msg_sstart.push_back(stotal);
+      msg_ssize.push_back(0);
+    }
+    it[1] = stotal;  // gid no longer needed, so store offset in message
+    msg_ssize.back() += it[5];
+    stotal += it[5];
+  }
+  msg_rrank.clear();
+  msg_rstart.clear();
+  msg_rsize.clear();
+  int rtotal = 0;
+  for (auto &it : recvs) {
+    if (msg_rrank.empty() || msg_rrank.back() != it[0]) {
+      msg_rrank.push_back(it[0]);
+      msg_rstart.push_back(rtotal);
+      msg_rsize.push_back(0);
+    }
+    it[1] = rtotal;
+    msg_rsize.back() += it[5];
+    rtotal += it[5];
+  }
+
+  // load slab arrays, which are only reallocated when they must grow
+  nslab_local = local.size();
+  nslab_send = sends.size();
+  nslab_recv = recvs.size();
+  if (slab_local.extent_int(0) < nslab_local) {
+    Kokkos::realloc(slab_local, nslab_local, 4);
+  }
+  if (slab_send.extent_int(0) < nslab_send) {
+    Kokkos::realloc(slab_send, nslab_send, 4);
+  }
+  if (slab_recv.extent_int(0) < nslab_recv) {
+    Kokkos::realloc(slab_recv, nslab_recv, 4);
+  }
+  for (int s=0; s<nslab_local; ++s) {
+    for (int v=0; v<4; ++v) {
+      slab_local.h_view(s,v) = local[s][v];
+    }
+  }
+  for (int s=0; s<nslab_send; ++s) {
+    slab_send.h_view(s,0) = sends[s][2];
+    slab_send.h_view(s,1) = sends[s][4];
+    slab_send.h_view(s,2) = sends[s][1];
+    slab_send.h_view(s,3) = sends[s][5];
+  }
+  for (int s=0; s<nslab_recv; ++s) {
+    slab_recv.h_view(s,0) = recvs[s][2];
+    slab_recv.h_view(s,1) = recvs[s][1];
+    slab_recv.h_view(s,2) = recvs[s][4];
+    slab_recv.h_view(s,3) = recvs[s][5];
+  }
+  slab_local.template modify<HostMemSpace>();
+  slab_local.template sync<DevExeSpace>();
+  slab_send.template modify<HostMemSpace>();
+  slab_send.template sync<DevExeSpace>();
+  slab_recv.template modify<HostMemSpace>();
+  slab_recv.template sync<DevExeSpace>();
+
+  // (re)allocate messages
+  if (msg_sbuf.extent_int(0) < stotal) {
+    Kokkos::realloc(msg_sbuf, stotal);
+  }
+  if (msg_rbuf.extent_int(0) < rtotal) {
+    Kokkos::realloc(msg_rbuf, rtotal);
+  }
+#if MPI_PARALLEL_ENABLED
+  msg_sreq.assign(msg_srank.size(), MPI_REQUEST_NULL);
+  msg_rreq.assign(msg_rrank.size(), MPI_REQUEST_NULL);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ShearingBox::CopySlabs()
+//! \brief Copies all slabs in rows of input slab array with one kernel.  Slabs at ix1
+//! (n=0) and ox1 (n=1) boundaries are copied from src0 to dst0, and src1 to dst1.
+
+void ShearingBox::CopySlabs(const DualArray2D<int> &slab, const int nslab,
+                            const DvceArray1D<Real> &src0, const DvceArray1D<Real> &src1,
+                            const DvceArray1D<Real> &dst0,
+                            const DvceArray1D<Real> &dst1) {
+  if (nslab == 0) return;
+  auto slab_ = slab.d_view;
+  par_for_outer("sbox_slabs",DevExeSpace(),0,0,0,(nslab-1),
+  KOKKOS_LAMBDA(TeamMember_t member, const int s) {
+    const int soff = slab_(s,1);
+    const int doff = slab_(s,2);
+    const int size = slab_(s,3);
+    if (slab_(s,0) == 0) {
+      par_for_inner(member, 0, (size-1), [&](const int i) {
+        dst0(doff+i) = src0(soff+i);
+      });
+    } else {
+      par_for_inner(member, 0, (size-1), [&](const int i) {
+        dst1(doff+i) = src1(soff+i);
+      });
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus ShearingBox::SendSlabs()
+//! \brief Shifts data in send buffers (already remapped by fractional cell offset) by
+//! integer number of cells.  Slabs sent to MBs on this rank are copied directly into
+//! recv buffers, and with MPI slabs sent to other ranks are packed into one message for
+//! each rank.
+
+TaskStatus ShearingBox::SendSlabs() {
+  // 1D views of send/recv buffers, so that slabs are indexed by offset
+  DvceArray1D<Real> sbuf0(sendbuf[0].vars.data(), sendbuf[0].vars.size());
+  DvceArray1D<Real> sbuf1(sendbuf[1].vars.data(), sendbuf[1].vars.size());
+  DvceArray1D<Real> rbuf0(recvbuf[0].vars.data(), recvbuf[0].vars.size());
+  DvceArray1D<Real> rbuf1(recvbuf[1].vars.data(), recvbuf[1].vars.size());
+  CopySlabs(slab_local, nslab_local, sbuf0, sbuf1, rbuf0, rbuf1);
+
+#if MPI_PARALLEL_ENABLED
+  CopySlabs(slab_send, nslab_send, sbuf0, sbuf1, msg_sbuf, msg_sbuf);
+  // Send messages once kernels have finished
+  TaskExecSpace().fence();
+  bool no_errors=true;
+  for (std::size_t r=0; r<msg_srank.size(); ++r) {
+    int ierr = MPI_Isend(msg_sbuf.data() + msg_sstart[r], msg_ssize[r], MPI_ATHENA_REAL,
+                         msg_srank[r], 0, comm_sbox, &(msg_sreq[r]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+  }
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in posting sends" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus ShearingBox::RecvSlabs()
+//! \brief With MPI, checks messages from other ranks have all arrived, then unpacks them
+//! into recv buffers.
+
+TaskStatus ShearingBox::RecvSlabs() {
+#if MPI_PARALLEL_ENABLED
+  bool bflag = false;
+  bool no_errors=true;
+  for (auto &req : msg_rreq) {
+    int test;
+    int ierr = MPI_Test(&req, &test, MPI_STATUS_IGNORE);
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+    if (!(static_cast<bool>(test))) {bflag = true;}
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in testing non-blocking receives"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // exit if recv boundary buffer communications have not completed
+  if (bflag) {return TaskStatus::incomplete;}
+
+  DvceArray1D<Real> rbuf0(recvbuf[0].vars.data(), recvbuf[0].vars.size());
+  DvceArray1D<Real> rbuf1(recvbuf[1].vars.data(), recvbuf[1].vars.size());
+  CopySlabs(slab_recv, nslab_recv, msg_rbuf, msg_rbuf, rbuf0, rbuf1);
+#endif
+  return TaskStatus::complete;
+}
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn void ShearingBox::AddRecvRequests()
+//! \brief Appends pointers to the requests of the messages received from other ranks
+
+void ShearingBox::AddRecvRequests(std::vector<MPI_Request*> &reqs) {
+  for (auto &req : msg_rreq) {reqs.push_back(&req);}
+  return;
+}
+#endif
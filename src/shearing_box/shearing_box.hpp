@@ -9,6 +9,9 @@
 //! \brief definitions for classes that implement shearing box abstract base and derived
 //! classes (for CC and FC variables).
 
+#include <utility>
+#include <vector>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "tasklist/task_list.hpp"
@@ -70,12 +73,42 @@ class ShearingBox {
   MPI_Comm comm_sbox;
 #endif
 
+  // Remap plan for the integer-cell part of the shift, which is only rebuilt when the
+  // integer shift changes.  The send buffer of each MB is split into 2 or 3 slabs in j
+  // (each contiguous in memory) which are either copied into the recv buffer of a MB on
+  // this rank, or packed into the single contiguous message sent to each other rank.
+  // Each row of the slab arrays stores (n, offset of source, offset of destination,
+  // size), so that all slabs of each kind are copied with one kernel.  Offsets and sizes
+  // are in units of Reals.  Sender and receiver sort slabs within messages by (gid, n,
+  // slab index) of the *receiving* MB.
+  std::vector<int> plan_joffset[2];   // integer shift of each MB when plan was built
+  int nslab_local, nslab_send, nslab_recv;
+  DualArray2D<int> slab_local, slab_send, slab_recv;
+  std::vector<int> msg_srank, msg_sstart, msg_ssize;  // ranks/offsets/sizes of sends
+  std::vector<int> msg_rrank, msg_rstart, msg_rsize;  // ranks/offsets/sizes of recvs
+  DvceArray1D<Real> msg_sbuf, msg_rbuf;               // contiguous send/recv messages
+#if MPI_PARALLEL_ENABLED
+  std::vector<MPI_Request> msg_sreq, msg_rreq;        // [msg_srank.size()], etc.
+#endif
+
   // functions
   TaskStatus InitRecv(Real time);
   TaskStatus ClearRecv();
   TaskStatus ClearSend();
   // function to find target MB offset by shear.  Returns GID and rank
   void FindTargetMB(const int igid, const int jshift, int &gid, int &rank);
+  // functions to build remap plan, and to copy/send and recv slabs in plan
+  int RemapSlabs(const int n, const int joffset, std::pair<int,int> jsrc[3],
+                 std::pair<int,int> jdst[3], int jshift[3]);
+  void SetRemapPlan();
+  void CopySlabs(const DualArray2D<int> &slab, const int nslab,
+                 const DvceArray1D<Real> &src0, const DvceArray1D<Real> &src1,
+                 const DvceArray1D<Real> &dst0, const DvceArray1D<Real> &dst1);
+  TaskStatus SendSlabs();
+  TaskStatus RecvSlabs();
+#if MPI_PARALLEL_ENABLED
+  void AddRecvRequests(std::vector<MPI_Request*> &reqs);
+#endif
   // function to find index in x1bndry array of MB with input GID
   int TargetIndex(const int n, const int tgid) {
     for (int m=0; m<nmb_x1bndry(n); ++m) {
@@ -101,12 +134,8 @@ class ShearingBoxCC : public ShearingBox {
   // functions to communicate CC data with shearing box BCs
   TaskStatus PackAndSendCC(DvceArray5D<Real> &a, ReconstructionMethod rcon);
   TaskStatus RecvAndUnpackCC(DvceArray5D<Real> &a);
-  // shearing box source terms for Hydro CC variables
-  void SourceTermsCC(const DvceArray5D<Real> &w0, const EOS_Data &eos_data,
-                     const Real bdt, DvceArray5D<Real> &u0);
-  // shearing box source terms for MHD CC variables
-  void SourceTermsCC(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
-                     const EOS_Data &eos_data, const Real bdt, DvceArray5D<Real> &u0);
+  // shearing box source terms for CC variables are applied with all other per-cell
+  // source terms by SourceTerms::AddSrcTerms() (see srcterms/srcterms_fused.hpp)
 };
 
 //----------------------------------------------------------------------------------------
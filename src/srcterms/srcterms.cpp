@@ -24,6 +24,8 @@
 #include "mhd/mhd.hpp"
 #include "parameter_input.hpp"
 #include "radiation/radiation.hpp"
+#include "shearing_box/shearing_box.hpp"
+#include "srcterms_fused.hpp"
 #include "turb_driver.hpp"
 #include "units/units.hpp"
 
@@ -32,6 +34,9 @@
 // Only source terms specified in input file are initialized.
 
 SourceTerms::SourceTerms(std::string block, MeshBlockPack *pp, ParameterInput *pin) :
+    cool_tab("cool_tab",1,1),
+    ncool_tab(0),
+    cool_tfloor(0.0),
     pmy_pack(pp) {
   // (1) (constant) gravitational acceleration
   const_accel = pin->GetOrAddBoolean(block, "const_accel", false);
@@ -63,6 +68,12 @@ SourceTerms::SourceTerms(std::string block, MeshBlockPack *pp, ParameterInput *p
     crate_rel = pin->GetReal(block, "crate_rel");
     cpower_rel = pin->GetOrAddReal(block, "cpower_rel", 1.);
   }
+
+  // (5) optically thin cooling with tabulated cooling curve
+  tab_cooling = pin->GetOrAddBoolean(block, "tab_cooling", false);
+  if (tab_cooling) {
+    ReadCoolingTable(block, pin);
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -72,115 +83,80 @@ SourceTerms::~SourceTerms() {
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn
-// Add constant acceleration
-// NOTE source terms must be computed using primitive (w0) and NOT conserved (u0) vars
-
-void SourceTerms::ConstantAccel(const DvceArray5D<Real> &w0, const EOS_Data &eos_data,
-                                const Real bdt, DvceArray5D<Real> &u0) {
-  auto &indcs = pmy_pack->pmesh->mb_indcs;
-  int is = indcs.is, ie = indcs.ie;
-  int js = indcs.js, je = indcs.je;
-  int ks = indcs.ks, ke = indcs.ke;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-
-  Real &g = const_accel_val;
-  int &dir = const_accel_dir;
-
-  par_for("const_acc", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    Real src = bdt*g*w0(m,IDN,k,j,i);
-    u0(m,dir,k,j,i) += src;
-    if (eos_data.is_ideal) { u0(m,IEN,k,j,i) += src*w0(m,dir,k,j,i); }
-  });
+//! \fn SrcTermsData SourceTerms::GetSrcData()
+//! \brief collects flags and coefficients of all enabled per-cell source terms (in code
+//! units) for use in the fused source term kernel.
+
+SrcTermsData SourceTerms::GetSrcData(const EOS_Data &eos_data, ShearingBoxCC *psbox) {
+  SrcTermsData d;
+  d.is_ideal = eos_data.is_ideal;
+  d.use_e = eos_data.use_e;
+  d.gm1 = eos_data.gamma - 1.0;
+
+  d.const_accel = const_accel;
+  d.accel_dir = (const_accel)? const_accel_dir : IM1;
+  d.accel = (const_accel)? const_accel_val : 0.0;
+
+  d.ism_cooling = ism_cooling;
+  d.tab_cooling = tab_cooling;
+  d.temp_unit = 1.0;
+  d.cool_unit = 1.0;
+  d.heat_rate = 0.0;
+  d.tab = cool_tab.d_view;
+  d.ntab = ncool_tab;
+  d.tfloor = cool_tfloor;
+  d.dydt = 0.0;
+  if (ism_cooling || tab_cooling) {
+    d.temp_unit = pmy_pack->punit->temperature_cgs();
+    Real n_unit = pmy_pack->punit->density_cgs()/pmy_pack->punit->mu()
+                  /pmy_pack->punit->atomic_mass_unit_cgs;
+    d.cool_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()
+                  /n_unit/n_unit;
+    Real heating_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()
+                        /n_unit;
+    if (ism_cooling) {d.heat_rate = hrate/heating_unit;}
+    if (tab_cooling) {
+      // rate of change of temporal evolution function Y per unit density
+      d.dydt = (cool_tab.h_view(ncool_tab-1,1)/cool_tab.h_view(ncool_tab-1,0))*d.gm1*
+               d.temp_unit/d.cool_unit;
+    }
+  }
 
-  return;
+  d.rel_cooling = rel_cooling;
+  d.crate_rel = (rel_cooling)? crate_rel : 0.0;
+  d.cpower_rel = (rel_cooling)? cpower_rel : 1.0;
+
+  d.sbox = (psbox != nullptr);
+  d.sbox_r_phi = false;
+  d.sbox_strat = false;
+  d.omega0 = 0.0;
+  d.qshear = 0.0;
+  if (psbox != nullptr) {
+    d.sbox_r_phi = (psbox->shearing_box_r_phi || pmy_pack->pmesh->three_d);
+    d.sbox_strat = (d.sbox_r_phi && psbox->is_stratified);
+    d.omega0 = psbox->omega0;
+    d.qshear = psbox->qshear;
+  }
+  return d;
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void SourceTerms::ISMCooling()
-//! \brief Add explict ISM cooling and heating source terms in the energy equations.
-// NOTE source terms must be computed using primitive (w0) and NOT conserved (u0) vars
-
-void SourceTerms::ISMCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos_data,
-                             const Real bdt, DvceArray5D<Real> &u0) {
-  auto &indcs = pmy_pack->pmesh->mb_indcs;
-  int is = indcs.is, ie = indcs.ie;
-  int js = indcs.js, je = indcs.je;
-  int ks = indcs.ks, ke = indcs.ke;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-  Real use_e = eos_data.use_e;
-  Real gamma = eos_data.gamma;
-  Real gm1 = gamma - 1.0;
-  Real heating_rate = hrate;
-  Real temp_unit = pmy_pack->punit->temperature_cgs();
-  Real n_unit = pmy_pack->punit->density_cgs()/pmy_pack->punit->mu()
-                /pmy_pack->punit->atomic_mass_unit_cgs;
-  Real cooling_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()
-                      /n_unit/n_unit;
-  Real heating_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()/n_unit;
-
-  par_for("cooling", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    // temperature in cgs unit
-    Real temp = 1.0;
-    if (use_e) {
-      temp = temp_unit*w0(m,IEN,k,j,i)/w0(m,IDN,k,j,i)*gm1;
-    } else {
-      temp = temp_unit*w0(m,ITM,k,j,i);
-    }
-
-    Real lambda_cooling = ISMCoolFn(temp)/cooling_unit;
-    Real gamma_heating = heating_rate/heating_unit;
-
-    u0(m,IEN,k,j,i) -= bdt * w0(m,IDN,k,j,i) *
-                        (w0(m,IDN,k,j,i) * lambda_cooling - gamma_heating);
-  });
-
+//! \fn void SourceTerms::AddSrcTerms()
+//! \brief Applies all enabled per-cell source terms for Hydro (first function) and MHD
+//! (second function) in one kernel.  See srcterms_fused.hpp.
+
+void SourceTerms::AddSrcTerms(const DvceArray5D<Real> &w0, const EOS_Data &eos_data,
+                              const Real bdt, ShearingBoxCC *psbox,
+                              DvceArray5D<Real> &u0) {
+  DvceArray5D<Real> no_bcc;
+  AddSrcTerms(w0, no_bcc, eos_data, bdt, psbox, NoUserSrc(), u0);
   return;
 }
 
-//----------------------------------------------------------------------------------------
-//! \fn void SourceTerms::RelCooling()
-//! \brief Add explict relativistic cooling in the energy and momentum equations.
-// NOTE source terms must be computed using primitive (w0) and NOT conserved (u0) vars
-
-void SourceTerms::RelCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos_data,
-                             const Real bdt, DvceArray5D<Real> &u0) {
-  auto &indcs = pmy_pack->pmesh->mb_indcs;
-  int is = indcs.is, ie = indcs.ie;
-  int js = indcs.js, je = indcs.je;
-  int ks = indcs.ks, ke = indcs.ke;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-  Real use_e = eos_data.use_e;
-  Real gamma = eos_data.gamma;
-  Real gm1 = gamma - 1.0;
-  Real cooling_rate = crate_rel;
-  Real cooling_power = cpower_rel;
-
-  par_for("cooling", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    // temperature in cgs unit
-    Real temp = 1.0;
-    if (use_e) {
-      temp = w0(m,IEN,k,j,i)/w0(m,IDN,k,j,i)*gm1;
-    } else {
-      temp = w0(m,ITM,k,j,i);
-    }
-
-    auto &ux = w0(m,IVX,k,j,i);
-    auto &uy = w0(m,IVY,k,j,i);
-    auto &uz = w0(m,IVZ,k,j,i);
-
-    auto ut = 1.0 + ux*ux + uy*uy + uz*uz;
-    ut = sqrt(ut);
-
-    u0(m,IEN,k,j,i) -= bdt*w0(m,IDN,k,j,i)*ut*pow((temp*cooling_rate), cooling_power);
-    u0(m,IM1,k,j,i) -= bdt*w0(m,IDN,k,j,i)*ux*pow((temp*cooling_rate), cooling_power);
-    u0(m,IM2,k,j,i) -= bdt*w0(m,IDN,k,j,i)*uy*pow((temp*cooling_rate), cooling_power);
-    u0(m,IM3,k,j,i) -= bdt*w0(m,IDN,k,j,i)*uz*pow((temp*cooling_rate), cooling_power);
-  });
-
+void SourceTerms::AddSrcTerms(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
+                              const EOS_Data &eos_data, const Real bdt,
+                              ShearingBoxCC *psbox, DvceArray5D<Real> &u0) {
+  AddSrcTerms(w0, bcc0, eos_data, bdt, psbox, NoUserSrc(), u0);
   return;
 }
 
@@ -11,6 +11,7 @@
 //!  (1) constant (gravitational) acceleration - for RTI
 //!  (2) shearing box in 2D (x-z), for both hydro and MHD
 //!  (3) random forcing to drive turbulence - implemented in TurbulenceDriver class
+//!  (4) optically thin cooling, either ISM cooling function or tabulated cooling curve
 
 #include <map>
 #include <string>
@@ -22,6 +23,8 @@
 // forward declarations
 class TurbulenceDriver;
 class Driver;
+class ShearingBoxCC;
+struct SrcTermsData;
 
 //----------------------------------------------------------------------------------------
 //! \class SourceTerms
@@ -38,6 +41,7 @@ class SourceTerms {
   bool ism_cooling;
   bool rel_cooling;
   bool beam;
+  bool tab_cooling;
 
   // new timestep
   Real dtnew;
@@ -56,14 +60,26 @@ class SourceTerms {
   // beam source
   Real dii_dt;
 
+  // tabulated cooling curve, stored as (T, Lambda, power-law index, Y) at each node
+  DualArray2D<Real> cool_tab;
+  int ncool_tab;
+  Real cool_tfloor;
+
   // functions
-  void ConstantAccel(const DvceArray5D<Real> &w0, const EOS_Data &eos,
-                     const Real dt, DvceArray5D<Real> &u0);
-  void ISMCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos,
-                  const Real dt, DvceArray5D<Real> &u0);
-  void RelCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos,
-                  const Real dt, DvceArray5D<Real> &u0);
+  // all per-cell source terms (and shearing box terms if psbox != nullptr) applied in
+  // one kernel, for Hydro and MHD.  Template version defined in srcterms_fused.hpp
+  void AddSrcTerms(const DvceArray5D<Real> &w0, const EOS_Data &eos, const Real dt,
+                   ShearingBoxCC *psbox, DvceArray5D<Real> &u0);
+  void AddSrcTerms(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
+                   const EOS_Data &eos, const Real dt, ShearingBoxCC *psbox,
+                   DvceArray5D<Real> &u0);
+  template <typename F>
+  void AddSrcTerms(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
+                   const EOS_Data &eos, const Real dt, ShearingBoxCC *psbox,
+                   const F &user_src, DvceArray5D<Real> &u0);
+  SrcTermsData GetSrcData(const EOS_Data &eos, ShearingBoxCC *psbox);
   void BeamSource(DvceArray5D<Real> &i0, const Real dt);
+  void ReadCoolingTable(std::string block, ParameterInput *pin);
   void NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos);
 
  private:
@@ -0,0 +1,189 @@
+#ifndef SRCTERMS_SRCTERMS_FUSED_HPP_
+#define SRCTERMS_SRCTERMS_FUSED_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file srcterms_fused.hpp
+//! \brief Per-cell evaluation of all source terms in the hydro/MHD equations that depend
+//! only on the primitives in the same cell, so that all enabled terms are applied in a
+//! single kernel rather than one sweep over w0 and u0 per term.  The coefficients of the
+//! enabled terms are collected on the host in SrcTermsData by SourceTerms::GetSrcData(),
+//! and the terms are applied in the order listed in AddCellSrcTerms().
+//!
+//! A pgen can add its own terms to the same kernel by passing a functor with
+//!   KOKKOS_INLINE_FUNCTION void operator()(const int m, const int k, const int j,
+//!     const int i, const Real bdt, const DvceArray5D<Real> &w0,
+//!     const DvceArray5D<Real> &u0) const
+//! to SourceTerms::AddSrcTerms() from its enrolled user_srcs_func, and setting
+//! user_srcs_fused=true in the ProblemGenerator so that the task list does not also
+//! apply the built-in terms.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "ismcooling.hpp"
+#include "tab_cooling.hpp"
+#include "srcterms.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \struct SrcTermsData
+//! \brief flags and coefficients of all per-cell source terms, captured by the kernel
+
+struct SrcTermsData {
+  bool is_ideal, use_e;
+  Real gm1;
+  // constant acceleration
+  bool const_accel;
+  int accel_dir;
+  Real accel;
+  // ISM cooling and heating
+  bool ism_cooling;
+  Real temp_unit, cool_unit, heat_rate;
+  // tabulated cooling
+  bool tab_cooling;
+  DvceArray2D<Real> tab;
+  int ntab;
+  Real tfloor, dydt;
+  // relativistic cooling
+  bool rel_cooling;
+  Real crate_rel, cpower_rel;
+  // shearing box (Coriolis, tidal, and vertical gravity)
+  bool sbox, sbox_r_phi, sbox_strat;
+  Real omega0, qshear;
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct NoUserSrc
+//! \brief empty functor used when pgen does not add its own per-cell terms
+
+struct NoUserSrc {
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int m, const int k, const int j, const int i, const Real bdt,
+                  const DvceArray5D<Real> &w0, const DvceArray5D<Real> &u0) const {}
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void AddCellSrcTerms()
+//! \brief adds all enabled source terms in cell (m,k,j,i) over bdt.  Magnetic field bcc
+//! is only used (for the shearing box) when is_mhd=true.  x3v is the cell center in x3.
+//! NOTE source terms must be computed using primitive (w0) and NOT conserved (u0) vars
+
+KOKKOS_INLINE_FUNCTION
+void AddCellSrcTerms(const SrcTermsData &d, const DvceArray5D<Real> &w0,
+                     const DvceArray5D<Real> &bcc, const bool is_mhd, const Real bdt,
+                     const Real x3v, const int m, const int k, const int j, const int i,
+                     const DvceArray5D<Real> &u0) {
+  Real den = w0(m,IDN,k,j,i);
+
+  // (1) constant acceleration
+  if (d.const_accel) {
+    Real src = bdt*d.accel*den;
+    u0(m,d.accel_dir,k,j,i) += src;
+    if (d.is_ideal) {u0(m,IEN,k,j,i) += src*w0(m,d.accel_dir,k,j,i);}
+  }
+
+  // temperature in code units, used by cooling terms
+  Real temp = 1.0;
+  if (d.ism_cooling || d.tab_cooling || d.rel_cooling) {
+    if (d.use_e) {
+      temp = w0(m,IEN,k,j,i)/den*d.gm1;
+    } else {
+      temp = w0(m,ITM,k,j,i);
+    }
+  }
+
+  // (2) ISM cooling and heating
+  if (d.ism_cooling) {
+    Real lambda_cooling = ISMCoolFn(d.temp_unit*temp)/d.cool_unit;
+    u0(m,IEN,k,j,i) -= bdt*den*(den*lambda_cooling - d.heat_rate);
+  }
+
+  // (3) tabulated cooling, integrated exactly over bdt
+  if (d.tab_cooling) {
+    Real temp_cgs = d.temp_unit*temp;
+    if (temp_cgs > d.tfloor) {
+      Real y = CoolY(d.tab, d.ntab, temp_cgs) + d.dydt*den*bdt;
+      Real tnew = fmax(CoolYInv(d.tab, d.ntab, y), d.tfloor);
+      u0(m,IEN,k,j,i) += den*(tnew - temp_cgs)/(d.temp_unit*d.gm1);
+    }
+  }
+
+  // (4) relativistic cooling
+  if (d.rel_cooling) {
+    Real ux = w0(m,IVX,k,j,i);
+    Real uy = w0(m,IVY,k,j,i);
+    Real uz = w0(m,IVZ,k,j,i);
+    Real ut = sqrt(1.0 + ux*ux + uy*uy + uz*uz);
+    Real cool = bdt*den*pow((temp*d.crate_rel), d.cpower_rel);
+    u0(m,IEN,k,j,i) -= cool*ut;
+    u0(m,IM1,k,j,i) -= cool*ux;
+    u0(m,IM2,k,j,i) -= cool*uy;
+    u0(m,IM3,k,j,i) -= cool*uz;
+  }
+
+  // (5) shearing box
+  if (d.sbox) {
+    Real mom1 = den*w0(m,IVX,k,j,i);
+    Real qo = d.qshear*d.omega0;
+    if (d.sbox_r_phi) {
+      // 3D or 2D r-phi source terms
+      Real mom2 = den*w0(m,IVY,k,j,i);
+      u0(m,IM1,k,j,i) += 2.0*bdt*d.omega0*mom2;
+      u0(m,IM2,k,j,i) -= (2.0-d.qshear)*bdt*d.omega0*mom1;
+      if (d.sbox_strat) {
+        u0(m,IM3,k,j,i) -= bdt*SQR(d.omega0)*den*x3v;
+      }
+      if (d.is_ideal) {
+        // For more accuracy, better to use flux values
+        Real bxby = (is_mhd)? bcc(m,IBX,k,j,i)*bcc(m,IBY,k,j,i) : 0.0;
+        u0(m,IEN,k,j,i) += bdt*(mom1*mom2/den - bxby)*qo;
+      }
+    } else {
+      // 2D r-z source terms
+      Real mom3 = den*w0(m,IVZ,k,j,i);
+      u0(m,IM1,k,j,i) += 2.0*bdt*d.omega0*mom3;
+      u0(m,IM3,k,j,i) -= (2.0-d.qshear)*bdt*d.omega0*mom1;
+      if (d.is_ideal) {
+        // For more accuracy, better to use flux values
+        Real bxbz = (is_mhd)? bcc(m,IBX,k,j,i)*bcc(m,IBZ,k,j,i) : 0.0;
+        u0(m,IEN,k,j,i) += bdt*(mom1*mom3/den - bxbz)*qo;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SourceTerms::AddSrcTerms()
+//! \brief Applies all enabled per-cell source terms, followed by the terms in functor
+//! user_src, in a single kernel.  Pass an unallocated bcc0 for Hydro.
+
+template <typename F>
+void SourceTerms::AddSrcTerms(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
+                              const EOS_Data &eos_data, const Real bdt,
+                              ShearingBoxCC *psbox, const F &user_src,
+                              DvceArray5D<Real> &u0) {
+  SrcTermsData d = GetSrcData(eos_data, psbox);
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nx3 = indcs.nx3;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto &size = pmy_pack->pmb->mb_size;
+  bool is_mhd = bcc0.is_allocated();
+
+  par_for("srcterms", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real x3v = 0.0;
+    if (d.sbox_strat) {
+      x3v = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    }
+    AddCellSrcTerms(d, w0, bcc0, is_mhd, bdt, x3v, m, k, j, i, u0);
+    user_src(m, k, j, i, bdt, w0, u0);
+  });
+  return;
+}
+
+#endif // SRCTERMS_SRCTERMS_FUSED_HPP_
@@ -0,0 +1,136 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file tab_cooling.cpp
+//! \brief Reads the cooling curve for optically thin cooling with a tabulated cooling
+//! curve, which is integrated exactly over the timestep in each cell (Townsend 2009) by
+//! the fused source term kernel (srcterms_fused.hpp).  Since the update is stable and
+//! accurate for any dt, this cooling does not limit the timestep.
+//!
+//! The table (<block>/cooling_table) is read with the TableReader, and must contain the
+//! field "log_lambda" (log10 of Lambda in erg cm^3/s) with "log_T" (log10 of temperature
+//! in K) as the last (fastest varying) point.  Any other points, for example metallicity
+//! or redshift, are interpolated linearly to the value of <block>/cooling_<point name>
+//! when the table is read.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "units/units.hpp"
+#include "utils/tr_table.hpp"
+#include "srcterms.hpp"
+#include "tab_cooling.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void SourceTerms::ReadCoolingTable()
+//! \brief reads cooling table, interpolates it to the input values of all points other
+//! than log_T, and computes power-law indices and temporal evolution function at nodes
+
+void SourceTerms::ReadCoolingTable(std::string block, ParameterInput *pin) {
+  if (pmy_pack->punit == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Tabulated cooling requires a <units> block in input file" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  std::string fname = pin->GetString(block, "cooling_table");
+  TableReader::Table table;
+  auto read_result = table.ReadTable(fname);
+  if (read_result.error != TableReader::ReadResult::SUCCESS) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Cooling table '" << fname << "' could not be read:" << std::endl
+              << read_result.message << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  auto &point_info = table.GetPointInfo();
+  int ndim = table.GetNDimensions();
+  if (ndim < 1 || point_info[ndim-1].first.compare("log_T") != 0 ||
+      point_info[ndim-1].second < 2 || !(table.HasField("log_lambda"))) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Cooling table '" << fname << "' must contain field log_lambda, with "
+              << "at least two values of log_T as its last point" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  int nt = point_info[ndim-1].second;
+  double *logt = table["log_T"];
+  double *loglam = table["log_lambda"];
+
+  // lower index and weight of upper index of interpolation in each other point
+  std::vector<int> ilo(ndim-1, 0), npts(ndim-1, 1);
+  std::vector<Real> wgt(ndim-1, 0.0);
+  for (int d=0; d<ndim-1; ++d) {
+    std::string name = point_info[d].first;
+    npts[d] = point_info[d].second;
+    double *pts = table[name];
+    Real x = pin->GetOrAddReal(block, "cooling_" + name, pts[0]);
+    x = std::min(std::max(x, static_cast<Real>(pts[0])),
+                 static_cast<Real>(pts[npts[d]-1]));
+    for (int n=0; n<npts[d]-1; ++n) {
+      if (pts[n+1] >= x) {
+        ilo[d] = n;
+        wgt[d] = (x - pts[n])/(pts[n+1] - pts[n]);
+        break;
+      }
+    }
+  }
+
+  // log10(Lambda) at each log_T, summed over 2^(ndim-1) corners of interpolation
+  std::vector<Real> llam(nt, 0.0);
+  for (int c=0; c<(1 << (ndim-1)); ++c) {
+    Real w = 1.0;
+    int offset = 0;
+    bool valid = true;
+    for (int d=0; d<ndim-1; ++d) {
+      int hi = (c >> d) & 1;
+      if (hi == 1 && ilo[d] + 1 >= npts[d]) {valid = false;}
+      w *= (hi == 1)? wgt[d] : (1.0 - wgt[d]);
+      offset = offset*npts[d] + ilo[d] + hi;
+    }
+    if (!(valid) || w == 0.0) continue;
+    for (int n=0; n<nt; ++n) {
+      llam[n] += w*loglam[static_cast<std::size_t>(offset)*nt + n];
+    }
+  }
+
+  // load nodes (T_k, Lambda_k, alpha_k, Y_k) of cooling curve, starting from top
+  ncool_tab = nt;
+  Kokkos::realloc(cool_tab, nt, 4);
+  auto &tab = cool_tab.h_view;
+  for (int n=0; n<nt; ++n) {
+    if (n > 0 && logt[n] <= logt[n-1]) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "log_T in cooling table '" << fname
+                << "' must be increasing" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    tab(n,0) = std::pow(10.0, logt[n]);
+    tab(n,1) = std::pow(10.0, llam[n]);
+  }
+  tab(nt-1,3) = 0.0;
+  for (int n=nt-2; n>=0; --n) {
+    tab(n,2) = (llam[n+1] - llam[n])/(logt[n+1] - logt[n]);
+    Real c = (tab(nt-1,1)/tab(n,1))*(tab(n,0)/tab(nt-1,0));
+    if (std::abs(tab(n,2) - 1.0) > 1.0e-10) {
+      tab(n,3) = tab(n+1,3) - c/(1.0 - tab(n,2))*
+                 (1.0 - std::pow(tab(n,0)/tab(n+1,0), tab(n,2) - 1.0));
+    } else {
+      tab(n,3) = tab(n+1,3) - c*std::log(tab(n,0)/tab(n+1,0));
+    }
+  }
+  tab(nt-1,2) = tab(nt-2,2);
+  cool_tab.template modify<HostMemSpace>();
+  cool_tab.template sync<DevExeSpace>();
+
+  // cooling is switched off below the floor, which is at least the lowest table value
+  cool_tfloor = pin->GetOrAddReal(block, "cooling_tfloor", 0.0);
+  cool_tfloor = std::max(cool_tfloor, static_cast<Real>(tab(0,0)));
+  return;
+}
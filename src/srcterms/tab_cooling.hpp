@@ -0,0 +1,74 @@
+#ifndef SRCTERMS_TAB_COOLING_HPP_
+#define SRCTERMS_TAB_COOLING_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file tab_cooling.hpp
+//! \brief functions to implement exact integration of tabulated cooling (Townsend 2009,
+//! ApJS 181, 391).  The cooling curve is treated as a power law between the N nodes of
+//! the table, and is stored as rows of (T_k, Lambda_k, alpha_k, Y_k), where alpha_k is
+//! the power-law index in [T_k,T_{k+1}), and Y_k the temporal evolution function
+//!   Y(T) = (Lambda_N/T_N) int_T^{T_N} dT'/Lambda(T')
+//! at T_k.  The power law of the last segment is extrapolated above T_N.
+
+#include "athena.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn int CoolSegment()
+//! \brief index k of segment of table containing temp, limited to 0 <= k <= n-2
+
+template <typename T>
+KOKKOS_INLINE_FUNCTION
+int CoolSegment(const T &tab, const int n, const Real temp) {
+  int lo = 0, hi = n-2;
+  while (lo < hi) {
+    int mid = (lo + hi + 1)/2;
+    if (tab(mid,0) <= temp) {lo = mid;} else {hi = mid-1;}
+  }
+  return lo;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real CoolY()
+//! \brief temporal evolution function Y(T), Eq. A6 in Townsend (2009)
+
+template <typename T>
+KOKKOS_INLINE_FUNCTION
+Real CoolY(const T &tab, const int n, const Real temp) {
+  int k = CoolSegment(tab, n, temp);
+  Real c = (tab(n-1,1)/tab(k,1))*(tab(k,0)/tab(n-1,0));
+  Real alpha = tab(k,2);
+  if (fabs(alpha - 1.0) > 1.0e-10) {
+    return tab(k,3) + c/(1.0 - alpha)*(1.0 - pow(tab(k,0)/temp, alpha - 1.0));
+  }
+  return tab(k,3) + c*log(tab(k,0)/temp);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real CoolYInv()
+//! \brief inverse of temporal evolution function, Eq. A7 in Townsend (2009).  Returns
+//! lowest temperature in table if y is beyond its range.
+
+template <typename T>
+KOKKOS_INLINE_FUNCTION
+Real CoolYInv(const T &tab, const int n, const Real y) {
+  if (y >= tab(0,3)) return tab(0,0);
+  // Y decreases with T, so find largest k with Y_k >= y
+  int lo = 0, hi = n-2;
+  while (lo < hi) {
+    int mid = (lo + hi + 1)/2;
+    if (tab(mid,3) >= y) {lo = mid;} else {hi = mid-1;}
+  }
+  Real c = (tab(n-1,1)/tab(lo,1))*(tab(lo,0)/tab(n-1,0));
+  Real alpha = tab(lo,2);
+  if (fabs(alpha - 1.0) > 1.0e-10) {
+    Real x = 1.0 - (1.0 - alpha)*(y - tab(lo,3))/c;
+    if (x <= 0.0) return tab(0,0);
+    return tab(lo,0)*pow(x, 1.0/(1.0 - alpha));
+  }
+  return tab(lo,0)*exp(-(y - tab(lo,3))/c);
+}
+
+#endif // SRCTERMS_TAB_COOLING_HPP_
@@ -7,9 +7,11 @@
 //  \brief implementation of functions in TurbulenceDriver
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <string>
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
@@ -64,6 +66,21 @@ TurbulenceDriver::TurbulenceDriver(MeshBlockPack *pp, ParameterInput *pin) :
   dedt = pin->GetOrAddReal("turb_driving", "dedt", 0.0);
   // correlation time
   tcorr = pin->GetOrAddReal("turb_driving", "tcorr", 0.0);
+  // random number generator of mode amplitudes
+  {
+    std::string rng = pin->GetOrAddString("turb_driving", "rng", "ran2");
+    if (rng.compare("ran2") == 0) {
+      counter_rng = false;
+    } else if (rng.compare("philox") == 0) {
+      counter_rng = true;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<turb_driving>/rng=" << rng << " not implemented. "
+                << "Valid choices are [ran2,philox]." << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    rng_seed = pin->GetOrAddInteger("turb_driving", "seed", 1);
+  }
 
   Real nlow_sqr = nlow*nlow;
   Real nhigh_sqr = nhigh*nhigh;
@@ -282,8 +299,10 @@ void TurbulenceDriver::Initialize() {
 
 void TurbulenceDriver::IncludeInitializeModesTask(std::shared_ptr<TaskList> tl,
                                                   TaskID start) {
-  auto id_init = tl->AddTask(&TurbulenceDriver::InitializeModes, this, start);
-  auto id_add = tl->AddTask(&TurbulenceDriver::AddForcing, this, id_init);
+  auto id_init = tl->AddTask(&TurbulenceDriver::InitializeModes, this, start,
+                             "TurbulenceDriver::InitializeModes");
+  auto id_add = tl->AddTask(&TurbulenceDriver::AddForcing, this, id_init,
+                            "TurbulenceDriver::AddForcing");
   return;
 }
 
@@ -298,15 +317,18 @@ void TurbulenceDriver::IncludeAddForcingTask(std::shared_ptr<TaskList> tl, TaskI
   if (pmy_pack->pionn == nullptr) {
     if (pmy_pack->phydro != nullptr) {
       auto id = tl->InsertTask(&TurbulenceDriver::AddForcing, this,
-                              pmy_pack->phydro->id.flux, pmy_pack->phydro->id.rkupdt);
+                              pmy_pack->phydro->id.flux, pmy_pack->phydro->id.rkupdt,
+                              "TurbulenceDriver::AddForcing");
     }
     if (pmy_pack->pmhd != nullptr) {
       auto id = tl->InsertTask(&TurbulenceDriver::AddForcing, this,
-                              pmy_pack->pmhd->id.flux, pmy_pack->pmhd->id.rkupdt);
+                              pmy_pack->pmhd->id.flux, pmy_pack->pmhd->id.rkupdt,
+                              "TurbulenceDriver::AddForcing");
     }
   } else {
     auto id = tl->InsertTask(&TurbulenceDriver::AddForcing, this,
-                            pmy_pack->pionn->id.n_flux, pmy_pack->pionn->id.n_rkupdt);
+                            pmy_pack->pionn->id.n_flux, pmy_pack->pionn->id.n_rkupdt,
+                            "TurbulenceDriver::AddForcing");
   }
 
   return;
@@ -332,14 +354,21 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   int &gnx3 = gindcs.nx3;
 
   // Now compute new force using new random amplitudes and phases
+  // Amplitudes are drawn in the same order on every rank.  With the counter-based
+  // generator draw n of each cycle depends only on (seed, ncycle, n), so a restarted run
+  // draws the same amplitudes without restoring the state of the generator.
+  std::uint64_t ndraw = 0;
+  auto ran_gaussian = [&]() -> Real {
+    if (counter_rng) {
+      return RanGaussianCounter(rng_seed, static_cast<std::uint32_t>(pm->ncycle),
+                                ndraw++, 0);
+    }
+    return RanGaussianSt(&(rstate));
+  };
 
-  // Zero out new force array
+  // New force array is set (not incremented) by sum over modes below
   auto force_tmp_ = force_tmp;
   int &nmb = pmy_pack->nmb_thispack;
-  par_for("force_init", DevExeSpace(),0,nmb-1,0,2,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-    force_tmp_(m,n,k,j,i) = 0.0;
-  });
 
   int nlow_sqr = SQR(nlow);
   int nhigh_sqr = SQR(nhigh);
@@ -422,23 +451,23 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
             if (nkz != 0) {
               ikz = 1.0/(dkz*((Real) nkz));
 
-              xccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xccs_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcsc_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xcss_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xscc_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xscs_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xssc_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xsss_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-
-              yccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              yccs_.h_view(nmode) = RanGaussianSt(&(rstate));
-              ycsc_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              ycss_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              yscc_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              yscs_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              yssc_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-              ysss_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
+              xccc_.h_view(nmode) = ran_gaussian();
+              xccs_.h_view(nmode) = ran_gaussian();
+              xcsc_.h_view(nmode) = (nky==0)           ? 0.0 : ran_gaussian();
+              xcss_.h_view(nmode) = (nky==0)           ? 0.0 : ran_gaussian();
+              xscc_.h_view(nmode) = (nkx==0)           ? 0.0 : ran_gaussian();
+              xscs_.h_view(nmode) = (nkx==0)           ? 0.0 : ran_gaussian();
+              xssc_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : ran_gaussian();
+              xsss_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : ran_gaussian();
+
+              yccc_.h_view(nmode) = ran_gaussian();
+              yccs_.h_view(nmode) = ran_gaussian();
+              ycsc_.h_view(nmode) = (nky==0)           ? 0.0 : ran_gaussian();
+              ycss_.h_view(nmode) = (nky==0)           ? 0.0 : ran_gaussian();
+              yscc_.h_view(nmode) = (nkx==0)           ? 0.0 : ran_gaussian();
+              yscs_.h_view(nmode) = (nkx==0)           ? 0.0 : ran_gaussian();
+              yssc_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : ran_gaussian();
+              ysss_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : ran_gaussian();
 
               // imcompressibility
               zccc_.h_view(nmode) =  ikz*( kx*xscs_.h_view(nmode)+ky*ycss_.h_view(nmode));
@@ -452,19 +481,19 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
             } else if (nky != 0) {  // kz == 0
               iky = 1.0/(dky*((Real) nky));
 
-              xccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcsc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xscc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xssc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
+              xccc_.h_view(nmode) = ran_gaussian();
+              xcsc_.h_view(nmode) = ran_gaussian();
+              xscc_.h_view(nmode) = (nkx==0) ? 0.0 : ran_gaussian();
+              xssc_.h_view(nmode) = (nkx==0) ? 0.0 : ran_gaussian();
               xccs_.h_view(nmode) = 0.0;
               xscs_.h_view(nmode) = 0.0;
               xcss_.h_view(nmode) = 0.0;
               xsss_.h_view(nmode) = 0.0;
 
-              zccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zcsc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zscc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              zssc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
+              zccc_.h_view(nmode) = ran_gaussian();
+              zcsc_.h_view(nmode) = ran_gaussian();
+              zscc_.h_view(nmode) = (nkx==0) ? 0.0 : ran_gaussian();
+              zssc_.h_view(nmode) = (nkx==0) ? 0.0 : ran_gaussian();
               zccs_.h_view(nmode) = 0.0;
               zcss_.h_view(nmode) = 0.0;
               zscs_.h_view(nmode) = 0.0;
@@ -480,8 +509,8 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
               yscs_.h_view(nmode) = 0.0;
               ysss_.h_view(nmode) = 0.0;
             } else {  // kz == ky == 0, kx != 0 by initial if statement
-              zccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zscc_.h_view(nmode) = RanGaussianSt(&(rstate));
+              zccc_.h_view(nmode) = ran_gaussian();
+              zscc_.h_view(nmode) = ran_gaussian();
               zcsc_.h_view(nmode) = 0.0;
               zssc_.h_view(nmode) = 0.0;
               zccs_.h_view(nmode) = 0.0;
@@ -489,8 +518,8 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
               zscs_.h_view(nmode) = 0.0;
               zsss_.h_view(nmode) = 0.0;
 
-              yccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              yscc_.h_view(nmode) = RanGaussianSt(&(rstate));
+              yccc_.h_view(nmode) = ran_gaussian();
+              yscc_.h_view(nmode) = ran_gaussian();
               ycsc_.h_view(nmode) = 0.0;
               yssc_.h_view(nmode) = 0.0;
               yccs_.h_view(nmode) = 0.0;
@@ -520,14 +549,14 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
             if (nky != 0) {
               iky = 1.0/(dky*((Real) nky));
 
-              xccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xccs_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcsc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcss_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xscc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xscs_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xssc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xsss_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
+              xccc_.h_view(nmode) = ran_gaussian();
+              xccs_.h_view(nmode) = ran_gaussian();
+              xcsc_.h_view(nmode) = ran_gaussian();
+              xcss_.h_view(nmode) = ran_gaussian();
+              xscc_.h_view(nmode) = (nkx==0) ? 0.0 : ran_gaussian();
+              xscs_.h_view(nmode) = (nkx==0) ? 0.0 : ran_gaussian();
+              xssc_.h_view(nmode) = (nkx==0) ? 0.0 : ran_gaussian();
+              xsss_.h_view(nmode) = (nkx==0) ? 0.0 : ran_gaussian();
 
               // incompressibility
               yccc_.h_view(nmode) =  iky*(kx*xssc_.h_view(nmode));
@@ -548,8 +577,8 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
               zssc_.h_view(nmode) = 0.0;
               zsss_.h_view(nmode) = 0.0;
             } else {  // ky == 0
-              yccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              yscc_.h_view(nmode) = RanGaussianSt(&(rstate));
+              yccc_.h_view(nmode) = ran_gaussian();
+              yscc_.h_view(nmode) = ran_gaussian();
               ycsc_.h_view(nmode) = 0.0;
               yssc_.h_view(nmode) = 0.0;
               yccs_.h_view(nmode) = 0.0;
@@ -667,37 +696,51 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   auto zcos_ = zcos;
   auto zsin_ = zsin;
 
-  for (int n=0; n<mode_count_; n++) {
-    par_for("force_compute", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-    KOKKOS_LAMBDA(int m, int k, int j, int i) {
-      force_tmp_(m,0,k,j,i) += xccc_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xccs_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xcsc_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xcss_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xscc_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xscs_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xssc_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xsss_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-
-      force_tmp_(m,1,k,j,i) += yccc_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yccs_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,1,k,j,i) += ycsc_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += ycss_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yscc_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yscs_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yssc_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += ysss_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-
-      force_tmp_(m,2,k,j,i) += zccc_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zccs_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zcsc_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zcss_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zscc_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zscs_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zssc_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zsss_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
+  // Sum all modes with a single kernel.  Each team computes a row (m,k,j) of cells: the
+  // products of the y- and z-factors with the amplitudes of each mode are independent of
+  // i, so they are stored in scratch as the coefficients of xcos and xsin for the three
+  // components.  Each cell then accumulates the sum over modes in registers.
+  int nmode_ = mode_count_;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(6, nmode_);
+  int scr_level = (scr_size > (1 << 15))? 1 : 0;
+  par_for_outer("force_compute", DevExeSpace(), scr_size, scr_level, 0, nmb-1, ks, ke,
+                js, je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> coef(member.team_scratch(scr_level), 6, nmode_);
+    par_for_inner(member, 0, nmode_-1, [&](const int n) {
+      Real cc = ycos_(m,n,j)*zcos_(m,n,k);
+      Real cs = ycos_(m,n,j)*zsin_(m,n,k);
+      Real sc = ysin_(m,n,j)*zcos_(m,n,k);
+      Real ss = ysin_(m,n,j)*zsin_(m,n,k);
+      coef(0,n) = xccc_.d_view(n)*cc + xccs_.d_view(n)*cs + xcsc_.d_view(n)*sc
+                + xcss_.d_view(n)*ss;
+      coef(1,n) = xscc_.d_view(n)*cc + xscs_.d_view(n)*cs + xssc_.d_view(n)*sc
+                + xsss_.d_view(n)*ss;
+      coef(2,n) = yccc_.d_view(n)*cc + yccs_.d_view(n)*cs + ycsc_.d_view(n)*sc
+                + ycss_.d_view(n)*ss;
+      coef(3,n) = yscc_.d_view(n)*cc + yscs_.d_view(n)*cs + yssc_.d_view(n)*sc
+                + ysss_.d_view(n)*ss;
+      coef(4,n) = zccc_.d_view(n)*cc + zccs_.d_view(n)*cs + zcsc_.d_view(n)*sc
+                + zcss_.d_view(n)*ss;
+      coef(5,n) = zscc_.d_view(n)*cc + zscs_.d_view(n)*cs + zssc_.d_view(n)*sc
+                + zsss_.d_view(n)*ss;
     });
-  }
+    member.team_barrier();
+
+    par_for_inner(member, is, ie, [&](const int i) {
+      Real f1 = 0.0, f2 = 0.0, f3 = 0.0;
+      for (int n=0; n<nmode_; ++n) {
+        Real xc = xcos_(m,n,i);
+        Real xs = xsin_(m,n,i);
+        f1 += coef(0,n)*xc + coef(1,n)*xs;
+        f2 += coef(2,n)*xc + coef(3,n)*xs;
+        f3 += coef(4,n)*xc + coef(5,n)*xs;
+      }
+      force_tmp_(m,0,k,j,i) = f1;
+      force_tmp_(m,1,k,j,i) = f2;
+      force_tmp_(m,2,k,j,i) = f3;
+    });
+  });
 
   DvceArray5D<Real> u0, u0_;
   if (pmy_pack->phydro != nullptr) u0 = (pmy_pack->phydro->u0);
@@ -712,48 +755,16 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   const int nmkji = nmb*nx3*nx2*nx1;
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
-  Real t0 = 0.0, t1 = 0.0, t2 = 0.0, t3 = 0.0;
-
-  Kokkos::parallel_reduce("net_mom_1", Kokkos::RangePolicy<>(DevExeSpace(),0,nmkji),
-  KOKKOS_LAMBDA(const int &idx, Real &sum_t0, Real &sum_t1,
-                                Real &sum_t2, Real &sum_t3) {
-    // compute n,k,j,i indices of thread
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/nx1;
-    int i = (idx - m*nkji - k*nji - j*nx1) + is;
-    k += ks;
-    j += js;
-    Real den = u0(m,IDN,k,j,i);
-    if (flag_twofl) {
-      den += u0_(m,IDN,k,j,i);
-    }
-    sum_t0 += den;
-    sum_t1 += den*force_tmp_(m,0,k,j,i);
-    sum_t2 += den*force_tmp_(m,1,k,j,i);
-    sum_t3 += den*force_tmp_(m,2,k,j,i);
-  }, Kokkos::Sum<Real>(t0), Kokkos::Sum<Real>(t1),
-     Kokkos::Sum<Real>(t2), Kokkos::Sum<Real>(t3));
-
-
-#if MPI_PARALLEL_ENABLED
-  Real m[4], gm[4];
-  m[0] = t0; m[1] = t1; m[2] = t2; m[3] = t3;
-  MPI_Allreduce(m, gm, 4, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  t0 = gm[0]; t1 = gm[1]; t2 = gm[2]; t3 = gm[3];
-#endif
-
-  par_for("force_remove_net_mom", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    force_tmp_(m,0,k,j,i) -= t1/t0;
-    force_tmp_(m,1,k,j,i) -= t2/t0;
-    force_tmp_(m,2,k,j,i) -= t3/t0;
-  });
 
-  t0 = 0.0;
-  t1 = 0.0;
-  Kokkos::parallel_reduce("net_mom_2", Kokkos::RangePolicy<>(DevExeSpace(),0,nmkji),
-  KOKKOS_LAMBDA(const int &idx, Real &sum_t0, Real &sum_t1) {
+  // All sums needed to remove the net momentum of the force and to normalize it are
+  // computed in a single reduction (and a single MPI_Allreduce), using that the force
+  // f' = f - <f>, with density-weighted mean <f> = sum(den*f)/sum(den), satisfies
+  //   sum(den*f'^2) = sum(den*f^2) - <f>.sum(den*f)
+  //   sum(mom.f')    = sum(mom.f) - <f>.sum(mom)
+  // Sums are: [0] den, [1-3] den*f, [4] den*f^2, [5] mom.f, [6-8] mom
+  array_sum::GlobalSum sum_this_pack;
+  Kokkos::parallel_reduce("net_mom_1", Kokkos::RangePolicy<>(TaskExecSpace(),0,nmkji),
+  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
     // compute n,k,j,i indices of thread
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
@@ -776,16 +787,34 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
     Real v2 = force_tmp_(m,1,k,j,i);
     Real v3 = force_tmp_(m,2,k,j,i);
 
-    sum_t0 += den*(v1*v1+v2*v2+v3*v3);
-    sum_t1 += mom1*v1+mom2*v2+mom3*v3;
-  }, Kokkos::Sum<Real>(t0), Kokkos::Sum<Real>(t1));
-
+    array_sum::GlobalSum fsum;
+    fsum.the_array[0] = den;
+    fsum.the_array[1] = den*v1;
+    fsum.the_array[2] = den*v2;
+    fsum.the_array[3] = den*v3;
+    fsum.the_array[4] = den*(v1*v1 + v2*v2 + v3*v3);
+    fsum.the_array[5] = mom1*v1 + mom2*v2 + mom3*v3;
+    fsum.the_array[6] = mom1;
+    fsum.the_array[7] = mom2;
+    fsum.the_array[8] = mom3;
+    mb_sum += fsum;
+  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_pack));
+
+  Real tsum[9];
+  for (int n=0; n<9; ++n) {
+    tsum[n] = sum_this_pack.the_array[n];
+  }
 #if MPI_PARALLEL_ENABLED
-  m[0] = t0; m[1] = t1;
-  MPI_Allreduce(m, gm, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  t0 = gm[0]; t1 = gm[1];
+  MPI_Allreduce(MPI_IN_PLACE, tsum, 9, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
 #endif
 
+  // mean force removed from force
+  Real fm1 = tsum[1]/tsum[0];
+  Real fm2 = tsum[2]/tsum[0];
+  Real fm3 = tsum[3]/tsum[0];
+  Real t0 = tsum[4] - (tsum[1]*fm1 + tsum[2]*fm2 + tsum[3]*fm3);
+  Real t1 = tsum[5] - (tsum[6]*fm1 + tsum[7]*fm2 + tsum[8]*fm3);
+
   t0 = std::max(t0, 1.0e-20);
   t1 = std::max(t1, 1.0e-20);
 
@@ -803,11 +832,12 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   }
   if (m0 == 0.0) s = 0.0;
 
+  // remove net momentum and normalize force in one pass
   par_for("force_norm", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
   KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    force_tmp_(m,0,k,j,i) *= s;
-    force_tmp_(m,1,k,j,i) *= s;
-    force_tmp_(m,2,k,j,i) *= s;
+    force_tmp_(m,0,k,j,i) = s*(force_tmp_(m,0,k,j,i) - fm1);
+    force_tmp_(m,1,k,j,i) = s*(force_tmp_(m,1,k,j,i) - fm2);
+    force_tmp_(m,2,k,j,i) = s*(force_tmp_(m,2,k,j,i) - fm3);
   });
 
   return TaskStatus::complete;
@@ -863,18 +893,31 @@ TaskStatus TurbulenceDriver::AddForcing(Driver *pdrive, int stage) {
   auto force_ = force;
   auto force_tmp_ = force_tmp;
 
-  par_for("force_OU_process",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    force_(m,0,k,j,i) = fcorr*force_(m,0,k,j,i) + gcorr*force_tmp_(m,0,k,j,i);
-    force_(m,1,k,j,i) = fcorr*force_(m,1,k,j,i) + gcorr*force_tmp_(m,1,k,j,i);
-    force_(m,2,k,j,i) = fcorr*force_(m,2,k,j,i) + gcorr*force_tmp_(m,2,k,j,i);
-  });
+  const int nmkji = nmb*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji = nx2*nx1;
 
-  par_for("push",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    Real v1 = force_(m,0,k,j,i);
-    Real v2 = force_(m,1,k,j,i);
-    Real v3 = force_(m,2,k,j,i);
+  // Update force with OU process and add it to momentum (and energy) in one pass, which
+  // also sums the density and momentum after the update needed to remove net momentum
+  // (without special relativity)
+  Real t0 = 0.0, t1 = 0.0, t2 = 0.0, t3 = 0.0;
+  Kokkos::parallel_reduce("push", Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum_t0, Real &sum_t1, Real &sum_t2,
+                Real &sum_t3) {
+    // compute n,k,j,i indices of thread
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+
+    Real v1 = fcorr*force_(m,0,k,j,i) + gcorr*force_tmp_(m,0,k,j,i);
+    Real v2 = fcorr*force_(m,1,k,j,i) + gcorr*force_tmp_(m,1,k,j,i);
+    Real v3 = fcorr*force_(m,2,k,j,i) + gcorr*force_tmp_(m,2,k,j,i);
+    force_(m,0,k,j,i) = v1;
+    force_(m,1,k,j,i) = v2;
+    force_(m,2,k,j,i) = v3;
 
     Real den = u0(m,IDN,k,j,i);
     if (flag_relativistic) {
@@ -894,18 +937,23 @@ TaskStatus TurbulenceDriver::AddForcing(Driver *pdrive, int stage) {
     u0(m,IM1,k,j,i) += den*v1*dt;
     u0(m,IM2,k,j,i) += den*v2*dt;
     u0(m,IM3,k,j,i) += den*v3*dt;
+    sum_t0 += u0(m,IDN,k,j,i);
+    sum_t1 += u0(m,IM1,k,j,i);
+    sum_t2 += u0(m,IM2,k,j,i);
+    sum_t3 += u0(m,IM3,k,j,i);
 
     if (flag_twofl) {
       den = u0_(m,IDN,k,j,i);
       u0_(m,IM1,k,j,i) += den*v1*dt;
       u0_(m,IM2,k,j,i) += den*v2*dt;
       u0_(m,IM3,k,j,i) += den*v3*dt;
+      sum_t0 += den;
+      sum_t1 += u0_(m,IM1,k,j,i);
+      sum_t2 += u0_(m,IM2,k,j,i);
+      sum_t3 += u0_(m,IM3,k,j,i);
     }
-  });
-
-  const int nmkji = nmb*nx3*nx2*nx1;
-  const int nkji = nx3*nx2*nx1;
-  const int nji = nx2*nx1;
+  }, Kokkos::Sum<Real>(t0), Kokkos::Sum<Real>(t1),
+     Kokkos::Sum<Real>(t2), Kokkos::Sum<Real>(t3));
 
   // Relativistic case will require a Lorentz transformation
   if (flag_relativistic) {
@@ -1002,8 +1050,8 @@ TaskStatus TurbulenceDriver::AddForcing(Driver *pdrive, int stage) {
     }
 
     // remove net momentum
-    Real t0 = 0.0, t1 = 0.0, t2 = 0.0, t3 = 0.0;
-    Kokkos::parallel_reduce("net_mom_3", Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    t0 = 0.0, t1 = 0.0, t2 = 0.0, t3 = 0.0;
+    Kokkos::parallel_reduce("net_mom_3", Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
     KOKKOS_LAMBDA(const int &idx, Real &sum_t0, Real &sum_t1, Real &sum_t2,
                   Real &sum_t3) {
       // compute n,k,j,i indices of thread
@@ -1145,37 +1193,7 @@ TaskStatus TurbulenceDriver::AddForcing(Driver *pdrive, int stage) {
     }
 
   } else {
-    // remove net momentum
-    Real t0 = 0.0, t1 = 0.0, t2 = 0.0, t3 = 0.0;
-    Kokkos::parallel_reduce("net_mom_3", Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-    KOKKOS_LAMBDA(const int &idx, Real &sum_t0, Real &sum_t1, Real &sum_t2,
-                  Real &sum_t3) {
-      // compute n,k,j,i indices of thread
-      int m = (idx)/nkji;
-      int k = (idx - m*nkji)/nji;
-      int j = (idx - m*nkji - k*nji)/nx1;
-      int i = (idx - m*nkji - k*nji - j*nx1) + is;
-      k += ks;
-      j += js;
-
-      Real den = u0(m,IDN,k,j,i);
-      Real mom1 = u0(m,IM1,k,j,i);
-      Real mom2 = u0(m,IM2,k,j,i);
-      Real mom3 = u0(m,IM3,k,j,i);
-      if (flag_twofl) {
-        den += u0_(m,IDN,k,j,i);
-        mom1 += u0_(m,IM1,k,j,i);
-        mom2 += u0_(m,IM2,k,j,i);
-        mom3 += u0_(m,IM3,k,j,i);
-      }
-
-      sum_t0 += den;
-      sum_t1 += mom1;
-      sum_t2 += mom2;
-      sum_t3 += mom3;
-    }, Kokkos::Sum<Real>(t0), Kokkos::Sum<Real>(t1),
-       Kokkos::Sum<Real>(t2), Kokkos::Sum<Real>(t3));
-
+    // remove net momentum, using density and momentum summed in push kernel
 #if MPI_PARALLEL_ENABLED
     Real m[4], gm[4];
     m[0] = t0; m[1] = t1; m[2] = t2; m[3] = t3;
@@ -9,6 +9,7 @@
 //  \brief defines turbulence driver class, which implements data and functions for
 //  randomly forced turbulence which evolves via an Ornstein-Uhlenbeck stochastic process
 
+#include <cstdint>
 #include <memory>
 
 #include "athena.hpp"
@@ -25,7 +26,9 @@ class TurbulenceDriver {
   ~TurbulenceDriver();
 
   DvceArray5D<Real> force, force_tmp;  // arrays used for turb forcing
-  RNG_State rstate;                    // random state
+  RNG_State rstate;                    // random state (ran2 generator)
+  bool counter_rng;                    // draw amplitudes with Philox counter-based RNG
+  std::uint64_t rng_seed;              // seed (key) of counter-based RNG
 
   DualArray1D<Real> xccc, xccs, xcsc, xcss, xscc, xscs, xssc, xsss;
   DualArray1D<Real> yccc, yccs, ycsc, ycss, yscc, yscs, yssc, ysss;
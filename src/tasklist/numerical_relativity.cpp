@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "numerical_relativity.hpp"
@@ -119,7 +120,7 @@ bool NumericalRelativity::AssembleNumericalRelativityTasks(
       TaskID dep(0);
       if (DependenciesMet(task, queue, dep) && !task.added) {
         task.added = true;
-        task.id = list->AddTask(task.func_, dep);
+        task.id = list->AddTask(task.func_, dep, task.name_string);
         cycle_added++;
         added++;
         /*std::cout << "Successfully added " << task.name_string << " to task list!\n"
@@ -152,6 +153,26 @@ void NumericalRelativity::PrintMissingTasks(std::vector<QueuedTask> &queue) {
   }
 }
 
+std::vector<QueuedTask> NumericalRelativity::FilterQueue(std::vector<QueuedTask> &queue,
+                                                        PhysicsDependency phys) {
+  std::vector<QueuedTask> filtered;
+  for (auto& task : queue) {
+    if (NeedsPhysics(task.name) != phys) {
+      continue;
+    }
+    // dependencies on tasks of the other physics are dropped
+    std::vector<TaskName> deps;
+    for (auto& dep : task.dependencies) {
+      if (NeedsPhysics(dep) == phys) {
+        deps.push_back(dep);
+      }
+    }
+    filtered.push_back(QueuedTask(task.name, task.name_string, false, TaskID(), deps,
+                                  task.func_));
+  }
+  return filtered;
+}
+
 void NumericalRelativity::AssembleNumericalRelativityTasks(
        std::map<std::string, std::shared_ptr<TaskList>>& tl) {
   // Assemble the task lists for all physics modules
@@ -185,6 +206,28 @@ void NumericalRelativity::AssembleNumericalRelativityTasks(
     PrintMissingTasks(end_queue);
     abort();
   }
+
+  // With multirate coupling, the Driver runs separate TaskLists for the spacetime and the
+  // matter, containing the same tasks as above without dependencies on the other physics
+  if (pmy_pack->pz4c != nullptr && pmy_pack->pdyngr != nullptr &&
+      pmy_pack->pz4c->multirate > 1) {
+    const std::string prefix[2] = {"z4c_", "mhd_"};
+    const PhysicsDependency phys[2] = {Phys_Z4c, Phys_MHD};
+    for (int n=0; n<2; ++n) {
+      std::vector<QueuedTask> start = FilterQueue(start_queue, phys[n]);
+      std::vector<QueuedTask> run = FilterQueue(run_queue, phys[n]);
+      std::vector<QueuedTask> end = FilterQueue(end_queue, phys[n]);
+      for (auto name : {"before_stagen", "stagen", "after_stagen"}) {
+        tl.insert(std::make_pair(prefix[n] + name, std::make_shared<TaskList>()));
+      }
+      if (!AssembleNumericalRelativityTasks(tl[prefix[n] + "before_stagen"], start) ||
+          !AssembleNumericalRelativityTasks(tl[prefix[n] + "stagen"], run) ||
+          !AssembleNumericalRelativityTasks(tl[prefix[n] + "after_stagen"], end)) {
+        std::cout << "NumericalRelativity: Failed to construct multirate TaskLists!\n";
+        abort();
+      }
+    }
+  }
 }
 
 } // namespace numrel
@@ -50,6 +50,7 @@ enum TaskName {
   MHD_BCS,
   MHD_Prolong,
   MHD_SetADM,
+  MHD_MRADM,
   MHD_Excise,
   MHD_C2P,
   MHD_Newdt,
@@ -183,6 +184,9 @@ class NumericalRelativity {
 
   bool AssembleNumericalRelativityTasks(std::shared_ptr<TaskList>& list,
          std::vector<QueuedTask> &queue);
+  // copy of queue with only the tasks of one physics, for multirate TaskLists
+  std::vector<QueuedTask> FilterQueue(std::vector<QueuedTask> &queue,
+                                      PhysicsDependency phys);
 };
 
 } // namespace numrel
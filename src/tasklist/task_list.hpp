@@ -13,70 +13,130 @@
 // This version includes improvements due to Josh Dolence and the Parthenon dev team, and
 // extensions by J.M.Stone.
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <bitset>
 #include <functional>
+#include <string>
 #include <vector>
 #include <list>
 #include <iterator>
+#include <map>
+
+#include "athena.hpp"
+#include "utils/profiling_region.hpp"
 
 class Driver;
 
-// Maximum size of TL
+// Device graphs (CUDA/HIP graphs) of the kernels launched by Tasks flagged with
+// SetGraphCapture() are captured and replayed, to reduce kernel launch overhead.  The
+// runtime API is selected with DEVGRAPH(), e.g. DEVGRAPH(GraphLaunch) = cudaGraphLaunch
+#if defined(KOKKOS_ENABLE_CUDA)
+#define TASK_GRAPHS_ENABLED 1
+#define DEVGRAPH(x) cuda##x
+#define DEVGRAPH_STREAM(inst) (inst).cuda_stream()
+#elif defined(KOKKOS_ENABLE_HIP)
+#define TASK_GRAPHS_ENABLED 1
+#define DEVGRAPH(x) hip##x
+#define DEVGRAPH_STREAM(inst) (inst).hip_stream()
+#else
+#define TASK_GRAPHS_ENABLED 0
+#endif
+
+// Number of bits stored in each word of the TaskID bit field.  TaskIDs grow by whole
+// words as tasks are added, so there is no upper limit on the size of a TaskList
 #define NUMBER_TASKID_BITS 64
 
 // constants = return codes for functions working on individual Tasks and TaskList
 enum class TaskStatus {fail, complete, incomplete};
 enum class TaskListStatus {running, stuck, complete, nothing_to_do};
+// constants that enumerate algorithms used to dispatch ready Tasks in a TaskList
+enum class TaskScheduler {serial, concurrent};
+// constants that enumerate how the Driver waits when a sweep over all TaskLists makes no
+// progress (i.e. only Tasks waiting on communication remain)
+enum class TaskWait {spin, yield, block};
 
 //----------------------------------------------------------------------------------------
 //! \class TaskID
 //  \brief container class for bit fields (used to encode Task IDs) and access functions
+//  The bit field is stored as a variable-length array of 64-bit words, where missing
+//  high-order words are treated as zero.  All operations cost O(number of words).
 
 class TaskID {
  public:
   TaskID() = default;
   // ctor, default id = 0.
   explicit TaskID(unsigned int id) {
-    if (id == 0) {
-      bitfld_.reset();      // set all bits to zero
-    } else {
-      bitfld_.set((--id));  // set [id-1] bit to one
+    if (id > 0) {
+      --id;
+      bitfld_.assign(id/NUMBER_TASKID_BITS + 1, 0);
+      bitfld_.back() = (static_cast<std::uint64_t>(1) << (id % NUMBER_TASKID_BITS));
     }
   }
 
   // functions (all implemented here)
-  void Clear() { bitfld_.reset(); }  // set all bits to zero
+  void Clear() { bitfld_.assign(bitfld_.size(), 0); }  // set all bits to zero
   // return true if input dependencies are clear
   bool CheckDependencies(const TaskID &dep) const {
-    return ((bitfld_ & dep.bitfld_) == dep.bitfld_);
+    for (std::size_t n=0; n<dep.bitfld_.size(); ++n) {
+      if ((Word(n) & dep.bitfld_[n]) != dep.bitfld_[n]) return false;
+    }
+    return true;
   }
   // output ID (useful for debugging)
-  void PrintID() {std::cout << "TaskID = " << bitfld_.to_string() << std::endl;}
+  void PrintID() {
+    std::string bits;
+    for (auto it = bitfld_.rbegin(); it != bitfld_.rend(); ++it) {
+      bits += std::bitset<NUMBER_TASKID_BITS>(*it).to_string();
+    }
+    if (bits.empty()) bits = std::bitset<NUMBER_TASKID_BITS>(0).to_string();
+    std::cout << "TaskID = " << bits << std::endl;
+  }
   // mark task with input TaskID as complete
-  void SetComplete(const TaskID &rhs) { bitfld_ |= rhs.bitfld_; }
+  void SetComplete(const TaskID &rhs) {
+    if (rhs.bitfld_.size() > bitfld_.size()) bitfld_.resize(rhs.bitfld_.size(), 0);
+    for (std::size_t n=0; n<rhs.bitfld_.size(); ++n) {bitfld_[n] |= rhs.bitfld_[n];}
+  }
 
   // overload some operators
-  bool operator== (const TaskID &rhs) const {return (bitfld_ == rhs.bitfld_); }
-  bool operator!= (const TaskID &rhs) const {return (bitfld_ != rhs.bitfld_); }
+  bool operator== (const TaskID &rhs) const {
+    std::size_t nwords = std::max(bitfld_.size(), rhs.bitfld_.size());
+    for (std::size_t n=0; n<nwords; ++n) {
+      if (Word(n) != rhs.Word(n)) return false;
+    }
+    return true;
+  }
+  bool operator!= (const TaskID &rhs) const {return !(*this == rhs); }
   TaskID operator| (const TaskID &rhs) const {
     TaskID ret;
-    ret.bitfld_ = (bitfld_ | rhs.bitfld_);
+    std::size_t nwords = std::max(bitfld_.size(), rhs.bitfld_.size());
+    ret.bitfld_.resize(nwords);
+    for (std::size_t n=0; n<nwords; ++n) {ret.bitfld_[n] = (Word(n) | rhs.Word(n));}
     return ret;
   }
   TaskID operator^ (const TaskID &rhs) const {
     TaskID ret;
-    ret.bitfld_ = (bitfld_ ^ rhs.bitfld_);
+    std::size_t nwords = std::max(bitfld_.size(), rhs.bitfld_.size());
+    ret.bitfld_.resize(nwords);
+    for (std::size_t n=0; n<nwords; ++n) {ret.bitfld_[n] = (Word(n) ^ rhs.Word(n));}
     return ret;
   }
   TaskID operator& (const TaskID &rhs) const {
     TaskID ret;
-    ret.bitfld_ = (bitfld_ & rhs.bitfld_);
+    std::size_t nwords = std::min(bitfld_.size(), rhs.bitfld_.size());
+    ret.bitfld_.resize(nwords);
+    for (std::size_t n=0; n<nwords; ++n) {ret.bitfld_[n] = (bitfld_[n] & rhs.bitfld_[n]);}
     return ret;
   }
 
  private:
-  std::bitset<NUMBER_TASKID_BITS> bitfld_;
+  std::vector<std::uint64_t> bitfld_;
+  // return n-th word of bit field, or zero if beyond stored length
+  std::uint64_t Word(std::size_t n) const {
+    return (n < bitfld_.size()) ? bitfld_[n] : 0;
+  }
 };
 
 //----------------------------------------------------------------------------------------
@@ -86,12 +146,29 @@ class TaskID {
 
 class Task {
  public:
-  Task(TaskID id, TaskID dep, std::function<TaskStatus(Driver*, int)> func) :
-  myid_(id), dep_(dep), func_(func) {}
+  Task(TaskID id, TaskID dep, std::function<TaskStatus(Driver*, int)> func,
+       const std::string &name) :
+  myid_(id), dep_(dep), func_(func), name_(name) {}
   // overloaded operator() calls task function
   TaskStatus operator()(Driver *d, int s) {return func_(d,s);}
   TaskID GetID() {return myid_;}
   TaskID GetDependency() {return dep_;}
+  const std::string &GetName() const {return name_;}
+  // accumulated wall time spent in this Task (only measured when profiling enabled)
+  void AddTime(double t) {time_ += t;}
+  double GetTime() const {return time_;}
+  void ResetTime() {time_ = 0.0;}
+  // wall time spent in calls that returned complete, used for automatic load balancing
+  void AddWorkTime(double t) {work_time_ += t;}
+  double GetWorkTime() const {return work_time_;}
+  void ResetWorkTime() {work_time_ = 0.0;}
+  // ring buffer of wall time spent in this Task in each of the last sampled cycles
+  void ClearSample(int slot, int nslot) {
+    if (samples_.size() != static_cast<std::size_t>(nslot)) {samples_.assign(nslot, 0.0);}
+    samples_[slot] = 0.0;
+  }
+  void AddSample(int slot, double t) {samples_[slot] += static_cast<float>(t);}
+  float GetSample(int slot) const {return samples_[slot];}
   void SetComplete() {complete_ = true;}
   void SetIncomplete() {complete_ = false;}
   bool IsComplete() {return complete_;}
@@ -99,6 +176,20 @@ class Task {
   void ChangeDependency(TaskID id, TaskID newdep) {
     if ((dep_ & id) == id) {dep_ = ((dep_ ^ id) | newdep);}
   }
+  // Task only launches kernels (no communication or host synchronization), its kernels
+  // depend only on the stage (not on dt or time) between changes of the Mesh, and it
+  // completes in one call, so its kernels can be captured in a device graph
+  void SetGraphCapture() {graph_capture_ = true;}
+  bool IsGraphCapture() const {return graph_capture_;}
+#if TASK_GRAPHS_ENABLED
+  // captured graph for each stage, and mesh version when it was captured
+  struct StageGraph {
+    int version = -1;
+    bool captured = false;
+    DEVGRAPH(GraphExec_t) exec;
+  };
+  StageGraph &Graph(int s) {return graphs_[s];}
+#endif
 
  private:
   TaskID myid_;    // encodes task ID in bitfld_
@@ -106,6 +197,14 @@ class Task {
   // bool lb_time_;   // flag to include this task in timing for automatic load balancing
   bool complete_ = false;
   std::function<TaskStatus(Driver*, int)> func_;  // ptr to Task function
+  std::string name_;  // name used in diagnostic (profiling) output
+  double time_ = 0.0;
+  double work_time_ = 0.0;
+  std::vector<float> samples_;
+  bool graph_capture_ = false;
+#if TASK_GRAPHS_ENABLED
+  std::map<int, StageGraph> graphs_;
+#endif
 };
 
 //----------------------------------------------------------------------------------------
@@ -139,17 +238,159 @@ class TaskList {
   void Reset() {
     tasks_completed_.Clear();  // TaskID Clear() fn
     for (auto &it : task_list_) { it.SetIncomplete(); }
+    ncompleted_ = 0;
+    // start new slot in ring buffer of samples at first execution in a sampled cycle
+    if ((psample_cycle_ != nullptr) && IsSampledCycle() &&
+        (*psample_cycle_ != sample_cycle_)) {
+      sample_cycle_ = *psample_cycle_;
+      sample_slot_ = (sample_slot_ + 1) % nsample_slot_;
+      nsamples_ = std::min(nsamples_ + 1, nsample_slot_);
+      for (auto &it : task_list_) {it.ClearSample(sample_slot_, nsample_slot_);}
+    }
+  }
+  // number of Tasks completed since last Reset(), used by the Driver to detect sweeps
+  // that made no progress
+  int NumberCompleted() {return ncompleted_;}
+
+  // select algorithm used by DoAvailable().  The concurrent scheduler requires a set of
+  // execution space instances that outlives the TaskList (stored in Driver).
+  void SetScheduler(TaskScheduler mode, std::vector<DevExeSpace> *pinstances) {
+    if (mode == TaskScheduler::concurrent && pinstances != nullptr &&
+        !(pinstances->empty())) {
+      scheduler_ = TaskScheduler::concurrent;
+      pexec_instances_ = pinstances;
+    } else {
+      scheduler_ = TaskScheduler::serial;
+      pexec_instances_ = nullptr;
+    }
+  }
+
+  // enable capture and replay of device graphs for Tasks flagged with SetGraphCapture().
+  // Graphs are captured again whenever *pversion (the Mesh version) changes.
+  void EnableGraphs(const int *pversion) {
+#if TASK_GRAPHS_ENABLED
+    pgraph_version_ = pversion;
+    if (capture_instance_.empty()) {
+      std::vector<int> weights(1, 1);
+      capture_instance_ = Kokkos::Experimental::partition_space(DevExeSpace(), weights);
+    }
+#endif
+  }
+  // flag Task with input ID for graph capture (see Task::SetGraphCapture())
+  void SetGraphCapture(TaskID id) {
+    for (auto &it : task_list_) {
+      if (it.GetID() == id) {it.SetGraphCapture();}
+    }
+  }
+
+  // enable timing of every Task.  Time is measured after fencing all kernels launched by
+  // the Task, so profiling serializes kernels even with the concurrent scheduler.
+  void EnableProfiling() {profile_ = true;}
+  bool IsProfiling() {return profile_;}
+  // enable timing of every Task only in cycles that are multiples of stride, where
+  // *pcycle is the current cycle, so that the cost of fencing is paid only in those
+  // cycles.  Times of each Task in the last nslot sampled cycles are kept in a ring
+  // buffer.
+  void EnableSampledProfiling(const int *pcycle, int stride, int nslot) {
+    profile_ = true;
+    psample_cycle_ = pcycle;
+    sample_stride_ = std::max(stride, 1);
+    nsample_slot_ = std::max(nslot, 1);
+  }
+  // stride between sampled cycles (zero if not sampling)
+  int SampleStride() const {return (psample_cycle_ == nullptr)? 0 : sample_stride_;}
+  bool IsSampledCycle() const {
+    return (psample_cycle_ == nullptr) || ((*psample_cycle_) % sample_stride_ == 0);
+  }
+  // number of sampled cycles in ring buffer since ResetSamples(), and time of each Task
+  // in each of them (most recent last)
+  int NumberSamples() const {return nsamples_;}
+  std::vector<std::vector<float>> GetTaskSamples() {
+    std::vector<std::vector<float>> samples;
+    for (auto &it : task_list_) {
+      samples.emplace_back();
+      for (int n=nsamples_-1; n>=0; --n) {
+        int slot = (sample_slot_ - n + nsample_slot_) % nsample_slot_;
+        samples.back().push_back(it.GetSample(slot));
+      }
+    }
+    return samples;
+  }
+  void ResetSamples() {nsamples_ = 0;}
+  void ResetTimes() { for (auto &it : task_list_) {it.ResetTime();} }
+  std::vector<std::string> GetTaskNames() {
+    std::vector<std::string> names;
+    for (auto &it : task_list_) {names.push_back(it.GetName());}
+    return names;
+  }
+  std::vector<double> GetTaskTimes() {
+    std::vector<double> times;
+    for (auto &it : task_list_) {times.push_back(it.GetTime());}
+    return times;
+  }
+  // wall time spent in calls to Tasks that returned complete (measured only when
+  // profiling).  Polling of incomplete Tasks (e.g. waiting on MPI receives) is excluded,
+  // so this measures the work done on this rank for automatic load balancing.
+  double GetWorkTime() {return work_time_;}
+  // work time of Tasks with names beginning with prefix (e.g. "Particles::")
+  double GetWorkTime(const std::string &prefix) {
+    double t = 0.0;
+    for (auto &it : task_list_) {
+      if (it.GetName().compare(0, prefix.size(), prefix) == 0) {t += it.GetWorkTime();}
+    }
+    return t;
+  }
+  void ResetWorkTime() {
+    work_time_ = 0.0;
+    for (auto &it : task_list_) {it.ResetWorkTime();}
+  }
+
+  // Returns length of the longest chain of dependent tasks (the critical path), where
+  // each task is weighted by the input times (one per task, in list order).  Tasks on
+  // the critical path are flagged in 'on_path'.  Relaxation is iterated since tasks added
+  // with InsertTask() may depend on tasks stored later in the list.
+  double CriticalPath(const std::vector<double> &times, std::vector<bool> &on_path) {
+    std::vector<TaskID> ids, deps;
+    for (auto &it : task_list_) {
+      ids.push_back(it.GetID());
+      deps.push_back(it.GetDependency());
+    }
+    int ntask = ids.size();
+    std::vector<double> finish(times);
+    std::vector<int> prev(ntask, -1);
+    bool changed = true;
+    for (int pass=0; (pass<ntask) && changed; ++pass) {
+      changed = false;
+      for (int n=0; n<ntask; ++n) {
+        for (int m=0; m<ntask; ++m) {
+          if ((m != n) && ((deps[n] & ids[m]) == ids[m]) &&
+              (finish[m] + times[n] > finish[n])) {
+            finish[n] = finish[m] + times[n];
+            prev[n] = m;
+            changed = true;
+          }
+        }
+      }
+    }
+    on_path.assign(ntask, false);
+    if (ntask == 0) return 0.0;
+    auto plast = std::max_element(finish.begin(), finish.end());
+    int last = std::distance(finish.begin(), plast);
+    for (int n=last; n>=0 && !(on_path[n]); n=prev[n]) {on_path[n] = true;}
+    return finish[last];
   }
 
   // cycle through task list once, do any tasks whose dependencies are clear
   TaskListStatus DoAvailable(Driver *d, int s) {
+    if (scheduler_ == TaskScheduler::concurrent) {return DoAvailableConcurrent(d,s);}
     for (auto &task : task_list_) {
       auto dep = task.GetDependency();
       if ( tasks_completed_.CheckDependencies(dep) && !(task.IsComplete()) ) {
-        TaskStatus status = task(d,s);  // calls Task function using overloaded operator()
+        TaskStatus status = RunTask(task,d,s);
         if (status == TaskStatus::complete) {
           task.SetComplete();              // set bool flag in task
           MarkTaskComplete(task.GetID());  // add TaskID to tasks_completed_
+          ncompleted_++;
         }
       }
     }
@@ -157,49 +398,83 @@ class TaskList {
     return TaskListStatus::running;
   }
 
+  // cycle through task list once, dispatching every task whose dependencies were clear
+  // at the start of the sweep.  Each of these tasks is independent of all others in the
+  // sweep, so each is bound to its own execution space instance and their kernels may
+  // run concurrently.  All instances are fenced before the next sweep, since tasks that
+  // become ready then may read data written by kernels launched here.
+  TaskListStatus DoAvailableConcurrent(Driver *d, int s) {
+    auto &instances = *pexec_instances_;
+    TaskID ready = tasks_completed_;
+    int ndispatched = 0;
+    for (auto &task : task_list_) {
+      auto dep = task.GetDependency();
+      if ( ready.CheckDependencies(dep) && !(task.IsComplete()) ) {
+        task_exec_space::Bind(&instances[ndispatched % instances.size()]);
+        TaskStatus status = RunTask(task,d,s);
+        task_exec_space::Unbind();
+        ndispatched++;
+        if (status == TaskStatus::complete) {
+          task.SetComplete();
+          MarkTaskComplete(task.GetID());
+          ncompleted_++;
+        }
+      }
+    }
+    int nused = std::min(ndispatched, static_cast<int>(instances.size()));
+    for (int n=0; n<nused; ++n) {instances[n].fence();}
+    if (IsComplete()) return TaskListStatus::complete;
+    return TaskListStatus::running;
+  }
+
   // ADD new Task with ID, given dependency, and a pointer to a static or non-member
   // function to the end of task list.  Returns ID of new task. Task function must have
   // arguments (Driver*, int). Usage:
   //     taskid = tl.AddTask(DoSomething, dependency, name);
+  // Optional name is used in diagnostic output; default is "task[n]".
   template <class F>
-  TaskID AddTask(F func, TaskID &dep) {
+  TaskID AddTask(F func, TaskID &dep, const std::string &name = "") {
     auto size = task_list_.size();
     TaskID id(size+1);
     task_list_.push_back(
-      Task(id, dep, [=](Driver *d, int s) mutable -> TaskStatus {return func(d,s);}));
+      Task(id, dep, [=](Driver *d, int s) mutable -> TaskStatus {return func(d,s);},
+           DefaultName(name)));
     return id;
   }
 
   // ADD new Task with ID, given dependency, and a pointer to a member function of
   // class T to the end of task list.  Returns ID of new task. Task function must have
   // arguments (Driver*, int).  Usage:
-  //     taskid = tl.AddTask(&T::DoSomething, T, dependency);
+  //     taskid = tl.AddTask(&T::DoSomething, T, dependency, name);
   template <class F, class T>
-  TaskID AddTask(F func, T *obj, TaskID &dep) {
+  TaskID AddTask(F func, T *obj, TaskID &dep, const std::string &name = "") {
     auto size = task_list_.size();
     TaskID id(size+1);
     task_list_.push_back( Task(id, dep,
-       [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s);}) );
+       [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s);},
+       DefaultName(name)) );
     return id;
   }
 
   // ADD new Task with ID, given dependency, and a std::function to the end of task
   // list. Returns ID of new task. Task function must have arguments (Driver*, int).
   // Usage:
-  //      taskid = tl.AddTask(DoSomething, dependency);
-  TaskID AddTask(std::function<TaskStatus(Driver*, int)> func, TaskID &dep) {
+  //      taskid = tl.AddTask(DoSomething, dependency, name);
+  TaskID AddTask(std::function<TaskStatus(Driver*, int)> func, TaskID &dep,
+                 const std::string &name = "") {
     auto size = task_list_.size();
     TaskID id(size+1);
-    task_list_.push_back(Task(id, dep, func));
+    task_list_.push_back(Task(id, dep, func, DefaultName(name)));
     return id;
   }
 
   // INSERT new Task with ID, given dependency, and a pointer to a member function of
   // class T in a position BEFORE the task with ID 'location'.  Returns ID of new task,
   // or taskID(0) if location not found. Usage:
-  //     taskid = tl.InsertTask(&T::DoSomething, T, dependency, location);
+  //     taskid = tl.InsertTask(&T::DoSomething, T, dependency, location, name);
   template <class F, class T>
-  TaskID InsertTask(F func, T *obj, TaskID &dep, TaskID &loc) {
+  TaskID InsertTask(F func, T *obj, TaskID &dep, TaskID &loc,
+                    const std::string &name = "") {
     std::list<Task>::iterator it;
     for (it=task_list_.begin(); it!=task_list_.end(); ++it) {
       if (it->GetID() == loc) {
@@ -207,7 +482,8 @@ class TaskList {
         TaskID id(size+1);
         auto old_dep = it->GetDependency();
         task_list_.insert(it, Task(id, dep,
-           [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s); }));
+           [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s); },
+           DefaultName(name)));
         // now change dependencies for all but this newly added Task
         for (auto it2=task_list_.begin(); it2!=task_list_.end(); ++it2) {
           if (it2->GetID() != id) {
@@ -223,6 +499,87 @@ class TaskList {
  protected:
   std::list<Task> task_list_;
   TaskID tasks_completed_;
+  TaskScheduler scheduler_ = TaskScheduler::serial;
+  std::vector<DevExeSpace> *pexec_instances_ = nullptr;  // used by concurrent scheduler
+  bool profile_ = false;
+  const int *psample_cycle_ = nullptr;  // sampled profiling enabled if not null
+  int sample_stride_ = 1, nsample_slot_ = 1;
+  int sample_cycle_ = -1, sample_slot_ = -1, nsamples_ = 0;
+  double work_time_ = 0.0;
+  int ncompleted_ = 0;
+  const int *pgraph_version_ = nullptr;          // graphs enabled if not null
+  std::vector<DevExeSpace> capture_instance_;    // stream used to capture graphs
+
+  // call Task function, timing it (and wrapping it in a Kokkos Tools region) if
+  // profiling.  Otherwise Tasks are wrapped in a region only if PROFILING_REGIONS_ENABLED
+
+  TaskStatus RunTask(Task &task, Driver *d, int s) {
+    if (!(profile_) || !(IsSampledCycle())) {
+      ProfilingRegion region(task.GetName());
+      return CallTask(task,d,s);
+    }
+    Kokkos::Profiling::pushRegion(task.GetName());
+    Kokkos::Timer timer;
+    TaskStatus status = CallTask(task,d,s);
+    TaskExecSpace().fence();
+    double t = timer.seconds();
+    task.AddTime(t);
+    if (psample_cycle_ != nullptr) {task.AddSample(sample_slot_, t);}
+    if (status == TaskStatus::complete) {
+      work_time_ += t;
+      task.AddWorkTime(t);
+    }
+    Kokkos::Profiling::popRegion();
+    return status;
+  }
+
+  // call Task function (using overloaded operator()), or replay its device graph.  The
+  // first call after the Mesh has changed runs the Task normally, so that any host-side
+  // setup (e.g. masks rebuilt after AMR) is not captured.  The second call captures the
+  // kernels on a separate stream, and this and later calls launch the graph on the
+  // stream the Task would have used.
+  TaskStatus CallTask(Task &task, Driver *d, int s) {
+#if TASK_GRAPHS_ENABLED
+    if ((pgraph_version_ != nullptr) && task.IsGraphCapture()) {
+      auto &g = task.Graph(s);
+      if (g.version != *pgraph_version_) {
+        if (g.captured) {(void) DEVGRAPH(GraphExecDestroy)(g.exec);}
+        g.captured = false;
+        g.version = *pgraph_version_;
+        return task(d,s);
+      }
+      const DevExeSpace *pbound = task_exec_space::Bound();
+      if (!(g.captured)) {
+        auto stream = DEVGRAPH_STREAM(capture_instance_[0]);
+        DEVGRAPH(Graph_t) graph;
+        (void) DEVGRAPH(StreamBeginCapture)(stream, DEVGRAPH(StreamCaptureModeRelaxed));
+        task_exec_space::Bind(&capture_instance_[0]);
+        team_tuner::Paused() = true;
+        TaskStatus status = task(d,s);
+        team_tuner::Paused() = false;
+        task_exec_space::Bind(pbound);
+        auto err = DEVGRAPH(StreamEndCapture)(stream, &graph);
+        if ((err != DEVGRAPH(Success)) || (status != TaskStatus::complete)) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                    << std::endl << "Capture of device graph failed for Task "
+                    << task.GetName() << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+        (void) DEVGRAPH(GraphInstantiateWithFlags)(&g.exec, graph, 0);
+        (void) DEVGRAPH(GraphDestroy)(graph);
+        g.captured = true;
+      }
+      const DevExeSpace launch = TaskExecSpace();
+      (void) DEVGRAPH(GraphLaunch)(g.exec, DEVGRAPH_STREAM(launch));
+      return TaskStatus::complete;
+    }
+#endif
+    return task(d,s);
+  }
+  std::string DefaultName(const std::string &name) {
+    if (!(name.empty())) return name;
+    return "task" + std::to_string(task_list_.size());
+  }
 };
 
 #endif  // TASKLIST_TASK_LIST_HPP_
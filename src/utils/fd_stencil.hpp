@@ -0,0 +1,124 @@
+#ifndef UTILS_FD_STENCIL_HPP_
+#define UTILS_FD_STENCIL_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file fd_stencil.hpp
+//! \brief Fused evaluation of all centered first and second derivatives of a variable.
+//!
+//! The operators in finite_diff.hpp each evaluate one derivative along one direction, so
+//! computing the gradient and Hessian of a variable reads the points along each axis
+//! (and the central point) several times.  FDGradient() and FDGradientHessian() gather
+//! every point of the stencil once, and evaluate all derivatives from those values.  The
+//! coefficients and the order in which terms are summed are exactly those of Dx, Dxx and
+//! Dxy, so results are bitwise identical (unless the compiler contracts the two forms
+//! into FMAs differently).
+//!
+//! The variable is passed as a function q(dk,dj,di) returning its value at offset
+//! (dk,dj,di) from the cell, e.g. for component (a,b) of a tensor in cell (m,k,j,i):
+//!   auto q = [&](int dk, int dj, int di) {return g_dd(m,a,b,k+dk,j+dj,i+di);};
+//! The Hessian is returned in the storage order of a symmetric rank 2 tensor, i.e.
+//! (00,01,02,11,12,22).
+
+#include "athena.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \struct FDCoeffs
+//! \brief coefficients of centered differences with NGHOST ghost cells (stencils of
+//! half-width nh = NGHOST-1).  C1(p) is the weight of point +p in the first derivative
+//! (point -p has weight -C1(p)), and C2(p) the weight of points +-p in the second.
+
+template <int NGHOST>
+struct FDCoeffs {
+  static constexpr int nh = NGHOST - 1;
+  KOKKOS_INLINE_FUNCTION
+  static constexpr Real C1(int const p) {
+    if constexpr (NGHOST == 2) {
+      return 1./2.;
+    } else if constexpr (NGHOST == 3) {
+      return (p == 1) ? 2./3. : -1./12.;
+    } else if constexpr (NGHOST == 4) {
+      return (p == 1) ? 3./4. : (p == 2) ? -3./20. : 1./60.;
+    } else {
+      return (p == 1) ? 4./5. : (p == 2) ? -1./5. : (p == 3) ? 4./105. : -1./280.;
+    }
+  }
+  KOKKOS_INLINE_FUNCTION
+  static constexpr Real C2(int const p) {
+    if constexpr (NGHOST == 2) {
+      return (p == 0) ? -2. : 1.;
+    } else if constexpr (NGHOST == 3) {
+      return (p == 0) ? -5./2. : (p == 1) ? 4./3. : -1./12.;
+    } else if constexpr (NGHOST == 4) {
+      return (p == 0) ? -49./18. : (p == 1) ? 3./2. : (p == 2) ? -3./20. : 1./90.;
+    } else {
+      return (p == 0) ? -205./72. : (p == 1) ? 8./5. : (p == 2) ? -1./5. :
+             (p == 3) ? 8./315. : -1./560.;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void FDGradient
+//! \brief first derivatives d1[a] = Dx<NGHOST>(a,...) of q along all three directions
+
+template <int NGHOST, typename F>
+KOKKOS_INLINE_FUNCTION
+void FDGradient(const F &q, const Real idx[], Real d1[3]) {
+  using C = FDCoeffs<NGHOST>;
+  for (int a = 0; a < 3; ++a) {
+    Real out = 0.0;
+    for (int p = C::nh; p > 0; --p) {
+      const Real qm = q(-p*(a == 2), -p*(a == 1), -p*(a == 0));
+      const Real qp = q( p*(a == 2),  p*(a == 1),  p*(a == 0));
+      out += (-C::C1(p)*qm + C::C1(p)*qp);
+    }
+    d1[a] = out*idx[a];
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void FDGradientHessian
+//! \brief first derivatives d1[a] = Dx<NGHOST>(a,...), and second derivatives d2 =
+//! Dxx<NGHOST>(a,...) (a == b) or Dxy<NGHOST>(a,b,...) (a < b) of q.  Points along each
+//! axis are shared by the first and second derivatives.
+
+template <int NGHOST, typename F>
+KOKKOS_INLINE_FUNCTION
+void FDGradientHessian(const F &q, const Real idx[], Real d1[3], Real d2[6]) {
+  using C = FDCoeffs<NGHOST>;
+  const Real q0 = q(0, 0, 0);
+  int n = 0;
+  for (int a = 0; a < 3; ++a) {
+    // first and pure second derivatives along a
+    Real out1 = 0.0, out2 = 0.0;
+    for (int p = C::nh; p > 0; --p) {
+      const Real qm = q(-p*(a == 2), -p*(a == 1), -p*(a == 0));
+      const Real qp = q( p*(a == 2),  p*(a == 1),  p*(a == 0));
+      out1 += (-C::C1(p)*qm + C::C1(p)*qp);
+      out2 += (C::C2(p)*qm + C::C2(p)*qp);
+    }
+    out2 += C::C2(0)*q0;
+    d1[a] = out1*idx[a];
+    d2[n++] = out2*idx[a]*idx[a];
+
+    // mixed second derivatives along a and b > a, from the corners of each plane
+    for (int b = a + 1; b < 3; ++b) {
+      Real out = 0.0;
+      for (int p = C::nh; p > 0; --p)
+      for (int r = C::nh; r > 0; --r) {
+        const int mk = p*(a == 2), mj = p*(a == 1), mi = p*(a == 0);
+        const int rk = r*(b == 2), rj = r*(b == 1), ri = r*(b == 0);
+        const Real cm = -C::C1(p), cp = C::C1(p);
+        const Real dm = -C::C1(r), dp = C::C1(r);
+        out += ((cm*dm)*q(-mk-rk, -mj-rj, -mi-ri) + (cm*dp)*q(-mk+rk, -mj+rj, -mi+ri))
+             + ((cp*dm)*q( mk-rk,  mj-rj,  mi-ri) + (cp*dp)*q( mk+rk,  mj+rj,  mi+ri));
+      }
+      d2[n++] = out*idx[a]*idx[b];
+    }
+  }
+}
+
+#endif // UTILS_FD_STENCIL_HPP_
@@ -0,0 +1,406 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file fft_mesh.cpp
+//! \brief implementation of distributed FFT of variables on uniform meshes
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/fft_mesh.hpp"
+
+//----------------------------------------------------------------------------------------
+// constructor: sets up process grid, pencils, and twiddle factors
+
+MeshFFT::MeshFFT(MeshBlockPack *pp) :
+  kdata("fft_kdata",1),
+  pmy_pack(pp),
+  mesh_version_(-1),
+  mbdata_("fft_mbdata",1) {
+  Mesh *pm = pp->pmesh;
+  if (pm->multilevel) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "FFT of mesh data is only implemented for uniform meshes "
+              << "(no SMR/AMR)" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  nx1 = pm->mesh_indcs.nx1;
+  nx2 = pm->mesh_indcs.nx2;
+  nx3 = pm->mesh_indcs.nx3;
+  int nx[3] = {nx1, nx2, nx3};
+  for (int d=0; d<3; ++d) {
+    if (nx[d] > 1) {axes_.push_back(d);}
+  }
+
+  // process grid as close to square as possible, with np_b=1 in 1D and 2D
+  int nranks = global_variable::nranks;
+  np_a = nranks;
+  np_b = 1;
+  if (pm->three_d) {
+    for (int p = static_cast<int>(std::sqrt(static_cast<Real>(nranks))); p > 0; --p) {
+      if (nranks % p == 0) {np_a = p; np_b = nranks/p; break;}
+    }
+  }
+
+  // twiddle factors (cos, sin)(2 pi m/nx), m=0...nx-1, along each transformed axis
+  for (auto d : axes_) {
+    DvceArray1D<Real> tw("fft_twiddle", 2*nx[d]);
+    auto tw_host = Kokkos::create_mirror_view(tw);
+    for (int m=0; m<nx[d]; ++m) {
+      Real arg = 2.0*M_PI*static_cast<Real>(m)/static_cast<Real>(nx[d]);
+      tw_host(2*m) = std::cos(arg);
+      tw_host(2*m+1) = std::sin(arg);
+    }
+    Kokkos::deep_copy(tw, tw_host);
+    twiddle_.push_back(tw);
+  }
+
+  // pencils of this rank do not change when MeshBlocks are redistributed
+  for (std::size_t s=0; s<axes_.size(); ++s) {
+    FFTBox box = Pencil(axes_[s], global_variable::my_rank);
+    pencil_.push_back(box);
+    pdata_.push_back(DvceArray1D<Real>("fft_pdata", std::max(2*box.Size(), 1)));
+    bool pow2 = ((nx[axes_[s]] & (nx[axes_[s]] - 1)) == 0);
+    work_.push_back(DvceArray1D<Real>("fft_work", pow2 ? 1 : std::max(2*box.Size(), 1)));
+  }
+  if (!(axes_.empty())) {
+    kbox = pencil_.back();
+    kdata = pdata_.back();
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_dup(MPI_COMM_WORLD, &comm_fft_);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+MeshFFT::~MeshFFT() {
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_free(&comm_fft_);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn FFTBox MeshFFT::Pencil
+//! \brief Returns pencil on given rank containing complete lines along axis.  The other
+//! two axes (in increasing order) are divided among np_a and np_b ranks respectively, so
+//! consecutive transposes only exchange data within rows (or columns) of process grid.
+
+FFTBox MeshFFT::Pencil(int axis, int rank) const {
+  int nx[3] = {nx1, nx2, nx3};
+  int e1 = (axis == 0) ? 1 : 0;
+  int e2 = (axis == 2) ? 1 : 2;
+  int ra = rank % np_a, rb = rank/np_a;
+  FFTBox box;
+  box.lo[axis] = 0;
+  box.n[axis] = nx[axis];
+  box.lo[e1] = (ra*nx[e1])/np_a;
+  box.n[e1] = ((ra+1)*nx[e1])/np_a - box.lo[e1];
+  box.lo[e2] = (rb*nx[e2])/np_b;
+  box.n[e2] = ((rb+1)*nx[e2])/np_b - box.lo[e2];
+  box.perm[0] = axis;
+  box.perm[1] = e1;
+  box.perm[2] = e2;
+  box.offset = 0;
+  return box;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshFFT::BuildMaps
+//! \brief Builds index maps of all transposes for the current distribution of MeshBlocks
+
+void MeshFFT::BuildMaps() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  int nranks = global_variable::nranks;
+
+  // MeshBlocks on each rank, stored in the order of the MeshBlockPack
+  std::vector<std::vector<FFTBox>> mbs(nranks);
+  int ncells = indcs.nx1*indcs.nx2*indcs.nx3;
+  for (int r=0; r<nranks; ++r) {
+    for (int m=0; m<pm->nmb_eachrank[r]; ++m) {
+      LogicalLocation &lloc = pm->lloc_eachmb[pm->gids_eachrank[r] + m];
+      FFTBox box;
+      box.lo[0] = lloc.lx1*indcs.nx1;
+      box.lo[1] = lloc.lx2*indcs.nx2;
+      box.lo[2] = lloc.lx3*indcs.nx3;
+      box.n[0] = indcs.nx1;
+      box.n[1] = indcs.nx2;
+      box.n[2] = indcs.nx3;
+      box.perm[0] = 0;
+      box.perm[1] = 1;
+      box.perm[2] = 2;
+      box.offset = m*ncells;
+      mbs[r].push_back(box);
+    }
+  }
+  mbdata_ = DvceArray1D<Real>("fft_mbdata", std::max(2*pmy_pack->nmb_thispack*ncells, 1));
+
+  trans_.clear();
+  trans_.resize(axes_.size());
+  std::vector<std::vector<FFTBox>> src = mbs, dst(nranks);
+  for (std::size_t s=0; s<axes_.size(); ++s) {
+    for (int r=0; r<nranks; ++r) {
+      dst[r].assign(1, Pencil(axes_[s], r));
+    }
+    BuildTranspose(src, dst, trans_[s]);
+    src = dst;
+  }
+  mesh_version_ = pm->mesh_version;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshFFT::BuildTranspose
+//! \brief Builds index maps and buffers to move data from boxes src[rank] to boxes
+//! dst[rank].  Overlaps of boxes are enumerated in the same order on both sides (boxes of
+//! src outermost, then those of dst, then x3, x2, x1), so that element n sent by one rank
+//! is element n received by the other.
+
+void MeshFFT::BuildTranspose(const std::vector<std::vector<FFTBox>> &src,
+                             const std::vector<std::vector<FFTBox>> &dst,
+                             FFTTranspose &t) {
+  int my_rank = global_variable::my_rank;
+  int nranks = global_variable::nranks;
+  std::vector<int> sidx, ridx;
+  t.scount.assign(nranks, 0);
+  t.sdispl.assign(nranks, 0);
+  t.rcount.assign(nranks, 0);
+  t.rdispl.assign(nranks, 0);
+
+  // appends index in box b or c (as selected by use_c) of all cells in overlap of b, c
+  auto overlap = [](const FFTBox &b, const FFTBox &c, bool use_c, std::vector<int> &idx) {
+    int lo[3], hi[3];
+    for (int d=0; d<3; ++d) {
+      lo[d] = std::max(b.lo[d], c.lo[d]);
+      hi[d] = std::min(b.lo[d] + b.n[d], c.lo[d] + c.n[d]);
+      if (hi[d] <= lo[d]) return 0;
+    }
+    int x[3];
+    for (x[2]=lo[2]; x[2]<hi[2]; ++x[2]) {
+      for (x[1]=lo[1]; x[1]<hi[1]; ++x[1]) {
+        for (x[0]=lo[0]; x[0]<hi[0]; ++x[0]) {
+          idx.push_back(use_c ? c.Index(x) : b.Index(x));
+        }
+      }
+    }
+    return (hi[0] - lo[0])*(hi[1] - lo[1])*(hi[2] - lo[2]);
+  };
+
+  for (int r=0; r<nranks; ++r) {
+    int nsend = 0, nrecv = 0;
+    for (auto &b : src[my_rank]) {
+      for (auto &c : dst[r]) {nsend += overlap(b, c, false, sidx);}
+    }
+    for (auto &b : src[r]) {
+      for (auto &c : dst[my_rank]) {nrecv += overlap(b, c, true, ridx);}
+    }
+    t.scount[r] = 2*nsend;
+    t.rcount[r] = 2*nrecv;
+    if (r > 0) {
+      t.sdispl[r] = t.sdispl[r-1] + t.scount[r-1];
+      t.rdispl[r] = t.rdispl[r-1] + t.rcount[r-1];
+    }
+  }
+
+  // copy maps to device, and allocate buffers
+  int ns = static_cast<int>(sidx.size()), nr = static_cast<int>(ridx.size());
+  t.sidx = DvceArray1D<int>("fft_sidx", std::max(ns, 1));
+  t.ridx = DvceArray1D<int>("fft_ridx", std::max(nr, 1));
+  auto sidx_host = Kokkos::create_mirror_view(t.sidx);
+  auto ridx_host = Kokkos::create_mirror_view(t.ridx);
+  for (int n=0; n<ns; ++n) {sidx_host(n) = sidx[n];}
+  for (int n=0; n<nr; ++n) {ridx_host(n) = ridx[n];}
+  Kokkos::deep_copy(t.sidx, sidx_host);
+  Kokkos::deep_copy(t.ridx, ridx_host);
+  t.sbuf = DvceArray1D<Real>("fft_sbuf", std::max(2*ns, 1));
+  t.rbuf = DvceArray1D<Real>("fft_rbuf", std::max(2*nr, 1));
+  t.sbuf_host = Kokkos::create_mirror_view(t.sbuf);
+  t.rbuf_host = Kokkos::create_mirror_view(t.rbuf);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshFFT::Transpose
+//! \brief Moves data from src to dst using transpose t, or from dst to src if reverse is
+//! true.  Buffers are staged through host memory, so MPI need not be GPU-aware.
+
+void MeshFFT::Transpose(FFTTranspose &t, DvceArray1D<Real> &src, DvceArray1D<Real> &dst,
+                        bool reverse) {
+  auto &fidx = (reverse) ? t.ridx : t.sidx;
+  auto &tidx = (reverse) ? t.sidx : t.ridx;
+  auto &fbuf = (reverse) ? t.rbuf : t.sbuf;
+  auto &tbuf = (reverse) ? t.sbuf : t.rbuf;
+  auto &fbuf_host = (reverse) ? t.rbuf_host : t.sbuf_host;
+  auto &tbuf_host = (reverse) ? t.sbuf_host : t.rbuf_host;
+  auto &from = (reverse) ? dst : src;
+  auto &to = (reverse) ? src : dst;
+  int nfrom = (reverse) ? (t.rdispl.back() + t.rcount.back())/2 :
+                          (t.sdispl.back() + t.scount.back())/2;
+  int nto = (reverse) ? (t.sdispl.back() + t.scount.back())/2 :
+                        (t.rdispl.back() + t.rcount.back())/2;
+
+  if (nfrom > 0) {
+    auto fidx_ = fidx;
+    auto fbuf_ = fbuf;
+    auto from_ = from;
+    par_for("fft_pack", DevExeSpace(), 0, nfrom-1, KOKKOS_LAMBDA(const int n) {
+      fbuf_(2*n) = from_(2*fidx_(n));
+      fbuf_(2*n+1) = from_(2*fidx_(n)+1);
+    });
+  }
+#if MPI_PARALLEL_ENABLED
+  Kokkos::deep_copy(fbuf_host, fbuf);
+  auto &fcount = (reverse) ? t.rcount : t.scount;
+  auto &fdispl = (reverse) ? t.rdispl : t.sdispl;
+  auto &tcount = (reverse) ? t.scount : t.rcount;
+  auto &tdispl = (reverse) ? t.sdispl : t.rdispl;
+  MPI_Alltoallv(fbuf_host.data(), fcount.data(), fdispl.data(), MPI_ATHENA_REAL,
+                tbuf_host.data(), tcount.data(), tdispl.data(), MPI_ATHENA_REAL,
+                comm_fft_);
+  Kokkos::deep_copy(tbuf, tbuf_host);
+#else
+  Kokkos::deep_copy(tbuf, fbuf);
+#endif
+  if (nto > 0) {
+    auto tidx_ = tidx;
+    auto tbuf_ = tbuf;
+    auto to_ = to;
+    par_for("fft_unpack", DevExeSpace(), 0, nto-1, KOKKOS_LAMBDA(const int n) {
+      to_(2*tidx_(n)) = tbuf_(2*n);
+      to_(2*tidx_(n)+1) = tbuf_(2*n+1);
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshFFT::TransformLines
+//! \brief Transforms all lines of pencil_[s] in place, with one thread per line.  Uses an
+//! iterative radix-2 FFT if the length of lines is a power of two, otherwise a direct
+//! DFT (computed into work_[s]).
+
+void MeshFFT::TransformLines(int s, bool inverse) {
+  auto &box = pencil_[s];
+  int n = box.n[box.perm[0]];
+  int nlines = (n > 0) ? box.Size()/n : 0;
+  if (nlines == 0) return;
+  bool pow2 = ((n & (n - 1)) == 0);
+  Real sgn = (inverse) ? 1.0 : -1.0;
+  auto data = pdata_[s];
+  auto work = work_[s];
+  auto tw = twiddle_[s];
+
+  par_for("fft_lines", DevExeSpace(), 0, nlines-1, KOKKOS_LAMBDA(const int l) {
+    int off = 2*l*n;
+    if (pow2) {
+      // bit-reversal permutation
+      for (int i=1, j=0; i<n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {j ^= bit;}
+        j ^= bit;
+        if (i < j) {
+          Real tr = data(off + 2*i), ti = data(off + 2*i + 1);
+          data(off + 2*i) = data(off + 2*j);
+          data(off + 2*i + 1) = data(off + 2*j + 1);
+          data(off + 2*j) = tr;
+          data(off + 2*j + 1) = ti;
+        }
+      }
+      // butterflies
+      for (int len=2; len<=n; len <<= 1) {
+        int half = len >> 1, step = n/len;
+        for (int i=0; i<n; i+=len) {
+          for (int k=0; k<half; ++k) {
+            Real wr = tw(2*k*step), wi = sgn*tw(2*k*step + 1);
+            int a = off + 2*(i + k), b = a + 2*half;
+            Real xr = data(b)*wr - data(b+1)*wi;
+            Real xi = data(b)*wi + data(b+1)*wr;
+            data(b) = data(a) - xr;
+            data(b+1) = data(a+1) - xi;
+            data(a) += xr;
+            data(a+1) += xi;
+          }
+        }
+      }
+    } else {
+      for (int q=0; q<n; ++q) {
+        Real sr = 0.0, si = 0.0;
+        int m = 0;  // (p*q) mod n
+        for (int p=0; p<n; ++p) {
+          Real wr = tw(2*m), wi = sgn*tw(2*m + 1);
+          sr += data(off + 2*p)*wr - data(off + 2*p + 1)*wi;
+          si += data(off + 2*p)*wi + data(off + 2*p + 1)*wr;
+          m += q;
+          if (m >= n) {m -= n;}
+        }
+        work(off + 2*q) = sr;
+        work(off + 2*q + 1) = si;
+      }
+      for (int q=0; q<2*n; ++q) {data(off + q) = work(off + q);}
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshFFT::Forward
+//! \brief Computes FFT of variable n of a into kdata.  Collective over all ranks.
+
+void MeshFFT::Forward(const DvceArray5D<Real> &a, int n) {
+  if (mesh_version_ != pmy_pack->pmesh->mesh_version) {BuildMaps();}
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie, nx1mb = indcs.nx1;
+  int js = indcs.js, je = indcs.je, nx2mb = indcs.nx2;
+  int ks = indcs.ks, ke = indcs.ke, nx3mb = indcs.nx3;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto mbdata = mbdata_;
+  par_for("fft_load", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int idx = ((m*nx3mb + (k - ks))*nx2mb + (j - js))*nx1mb + (i - is);
+    mbdata(2*idx) = a(m,n,k,j,i);
+    mbdata(2*idx+1) = 0.0;
+  });
+
+  for (std::size_t s=0; s<axes_.size(); ++s) {
+    Transpose(trans_[s], (s == 0) ? mbdata_ : pdata_[s-1], pdata_[s], false);
+    TransformLines(s, false);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshFFT::Inverse
+//! \brief Computes inverse FFT of kdata (which is overwritten), and stores real part in
+//! variable n of a.  Collective over all ranks.
+
+void MeshFFT::Inverse(DvceArray5D<Real> &a, int n) {
+  if (mesh_version_ != pmy_pack->pmesh->mesh_version) {BuildMaps();}
+  for (int s=static_cast<int>(axes_.size())-1; s>=0; --s) {
+    TransformLines(s, true);
+    Transpose(trans_[s], (s == 0) ? mbdata_ : pdata_[s-1], pdata_[s], true);
+  }
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie, nx1mb = indcs.nx1;
+  int js = indcs.js, je = indcs.je, nx2mb = indcs.nx2;
+  int ks = indcs.ks, ke = indcs.ke, nx3mb = indcs.nx3;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  Real norm = 1.0/(static_cast<Real>(nx1)*static_cast<Real>(nx2)*static_cast<Real>(nx3));
+  auto mbdata = mbdata_;
+  par_for("fft_store", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int idx = ((m*nx3mb + (k - ks))*nx2mb + (j - js))*nx1mb + (i - is);
+    a(m,n,k,j,i) = norm*mbdata(2*idx);
+  });
+  return;
+}
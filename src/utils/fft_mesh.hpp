@@ -0,0 +1,112 @@
+#ifndef UTILS_FFT_MESH_HPP_
+#define UTILS_FFT_MESH_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file fft_mesh.hpp
+//! \brief Distributed pencil-decomposed FFT of cell-centered variables on uniform meshes.
+//!
+//! The ranks are arranged in an np_a x np_b process grid.  Data is transposed from the
+//! MeshBlocks into "pencils" holding complete lines of cells along x1, which are
+//! transformed; then into pencils along x2, and finally along x3.  Each transpose is a
+//! single MPI_Alltoallv, with data packed and unpacked on the device through index maps
+//! computed once (and again whenever MeshBlocks are redistributed).  Lines are
+//! transformed with a radix-2 FFT if their length is a power of two, and a direct DFT
+//! otherwise.
+//!
+//! Modes are stored as interleaved (re,im) pairs in the pencils of the last transform.
+//! The forward transform is unnormalized, the inverse is divided by nx1*nx2*nx3.
+
+#include <vector>
+
+#include "athena.hpp"
+
+// Forward declarations
+class MeshBlockPack;
+
+//----------------------------------------------------------------------------------------
+//! \struct FFTBox
+//! \brief rectangular region of global cell (or mode) indices, stored contiguously with
+//! axis perm[0] fastest and perm[2] slowest, starting at element offset
+
+struct FFTBox {
+  int lo[3];     // first global index along each axis
+  int n[3];      // number of indices along each axis (may be zero)
+  int perm[3];   // axes in order of increasing stride
+  int offset;    // index of first element in storage
+
+  int Size() const {return n[0]*n[1]*n[2];}
+  // index in storage of global indices x[3] (which must lie in the box)
+  KOKKOS_INLINE_FUNCTION
+  int Index(const int x[3]) const {
+    return offset + ((x[perm[2]] - lo[perm[2]])*n[perm[1]] +
+                     (x[perm[1]] - lo[perm[1]]))*n[perm[0]] + (x[perm[0]] - lo[perm[0]]);
+  }
+  // global indices x[3] of element idx in storage
+  KOKKOS_INLINE_FUNCTION
+  void Location(int idx, int x[3]) const {
+    idx -= offset;
+    x[perm[0]] = lo[perm[0]] + idx%n[perm[0]];
+    idx /= n[perm[0]];
+    x[perm[1]] = lo[perm[1]] + idx%n[perm[1]];
+    x[perm[2]] = lo[perm[2]] + idx/n[perm[1]];
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct FFTTranspose
+//! \brief index maps and buffers used to move data between two decompositions.  Element
+//! n of the send (receive) buffer is element sidx(n) (ridx(n)) of the source (target).
+
+struct FFTTranspose {
+  DvceArray1D<int> sidx, ridx;
+  DvceArray1D<Real> sbuf, rbuf;
+  HostArray1D<Real> sbuf_host, rbuf_host;
+  std::vector<int> scount, sdispl, rcount, rdispl;  // in Reals, for MPI_Alltoallv
+};
+
+//----------------------------------------------------------------------------------------
+//! \class MeshFFT
+//! \brief forward and inverse FFT of one variable of a DvceArray5D over the whole mesh
+
+class MeshFFT {
+ public:
+  explicit MeshFFT(MeshBlockPack *pp);
+  ~MeshFFT();
+
+  int nx1, nx2, nx3;         // number of cells (and modes) in mesh along each axis
+  int np_a, np_b;            // dimensions of process grid
+  FFTBox kbox;               // modes held by this rank
+  DvceArray1D<Real> kdata;   // modes (re,im) held by this rank, in layout of kbox
+
+  // transforms variable n of a (active cells only) into kdata
+  void Forward(const DvceArray5D<Real> &a, int n);
+  // transforms kdata (which is overwritten) back into variable n of a
+  void Inverse(DvceArray5D<Real> &a, int n);
+
+ private:
+  MeshBlockPack *pmy_pack;   // ptr to MeshBlockPack containing data
+  int mesh_version_;         // Mesh::mesh_version when index maps were built
+  std::vector<int> axes_;    // axes with more than one cell, in order of transforms
+  std::vector<FFTBox> pencil_;               // pencil of this rank for each transform
+  std::vector<DvceArray1D<Real>> pdata_;     // data in each pencil
+  std::vector<DvceArray1D<Real>> work_;      // scratch for direct DFTs in each pencil
+  std::vector<DvceArray1D<Real>> twiddle_;   // cos,sin(2 pi m/nx) for each transform
+  std::vector<FFTTranspose> trans_;          // MBs->pencil_[0], pencil_[s-1]->pencil_[s]
+  DvceArray1D<Real> mbdata_;                 // data in MeshBlocks of this rank
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm comm_fft_;
+#endif
+
+  void BuildMaps();
+  FFTBox Pencil(int axis, int rank) const;
+  void BuildTranspose(const std::vector<std::vector<FFTBox>> &src,
+                      const std::vector<std::vector<FFTBox>> &dst, FFTTranspose &t);
+  void Transpose(FFTTranspose &t, DvceArray1D<Real> &src, DvceArray1D<Real> &dst,
+                 bool reverse);
+  void TransformLines(int s, bool inverse);
+};
+
+#endif // UTILS_FFT_MESH_HPP_
@@ -60,6 +60,31 @@ Real Dx(int const dir,
                +3./4.   * quant(m,k+( 1)*shiftk,
                                   j+( 1)*shiftj,
                                   i+( 1)*shifti));
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + ( +1./280.  * quant(m,k+(-4)*shiftk,
+                                  j+(-4)*shiftj,
+                                  i+(-4)*shifti)
+              -1./280.  * quant(m,k+( 4)*shiftk,
+                                  j+( 4)*shiftj,
+                                  i+( 4)*shifti))
+          + ( -4./105.  * quant(m,k+(-3)*shiftk,
+                                  j+(-3)*shiftj,
+                                  i+(-3)*shifti)
+              +4./105.  * quant(m,k+( 3)*shiftk,
+                                  j+( 3)*shiftj,
+                                  i+( 3)*shifti))
+          + (  +1./5.   * quant(m,k+(-2)*shiftk,
+                                  j+(-2)*shiftj,
+                                  i+(-2)*shifti)
+               -1./5.   * quant(m,k+( 2)*shiftk,
+                                  j+( 2)*shiftj,
+                                  i+( 2)*shifti))
+          + (  -4./5.   * quant(m,k+(-1)*shiftk,
+                                  j+(-1)*shiftj,
+                                  i+(-1)*shifti)
+               +4./5.   * quant(m,k+( 1)*shiftk,
+                                  j+( 1)*shiftj,
+                                  i+( 1)*shifti));
   }
   return out*idx[dir];
 }
@@ -116,6 +141,31 @@ Real Dx(int const dir,
                +3./4.   * quant(m,a,k+( 1)*shiftk,
                                     j+( 1)*shiftj,
                                     i+( 1)*shifti));
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + ( +1./280.  * quant(m,a,k+(-4)*shiftk,
+                                    j+(-4)*shiftj,
+                                    i+(-4)*shifti)
+              -1./280.  * quant(m,a,k+( 4)*shiftk,
+                                    j+( 4)*shiftj,
+                                    i+( 4)*shifti))
+          + ( -4./105.  * quant(m,a,k+(-3)*shiftk,
+                                    j+(-3)*shiftj,
+                                    i+(-3)*shifti)
+              +4./105.  * quant(m,a,k+( 3)*shiftk,
+                                    j+( 3)*shiftj,
+                                    i+( 3)*shifti))
+          + (  +1./5.   * quant(m,a,k+(-2)*shiftk,
+                                    j+(-2)*shiftj,
+                                    i+(-2)*shifti)
+               -1./5.   * quant(m,a,k+( 2)*shiftk,
+                                    j+( 2)*shiftj,
+                                    i+( 2)*shifti))
+          + (  -4./5.   * quant(m,a,k+(-1)*shiftk,
+                                    j+(-1)*shiftj,
+                                    i+(-1)*shifti)
+               +4./5.   * quant(m,a,k+( 1)*shiftk,
+                                    j+( 1)*shiftj,
+                                    i+( 1)*shifti));
   }
   return out*idx[dir];
 }
@@ -172,6 +222,31 @@ Real Dx(int const dir,
                +3./4.   * quant(m,a,b,k+( 1)*shiftk,
                                       j+( 1)*shiftj,
                                       i+( 1)*shifti));
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + ( +1./280.  * quant(m,a,b,k+(-4)*shiftk,
+                                      j+(-4)*shiftj,
+                                      i+(-4)*shifti)
+              -1./280.  * quant(m,a,b,k+( 4)*shiftk,
+                                      j+( 4)*shiftj,
+                                      i+( 4)*shifti))
+          + ( -4./105.  * quant(m,a,b,k+(-3)*shiftk,
+                                      j+(-3)*shiftj,
+                                      i+(-3)*shifti)
+              +4./105.  * quant(m,a,b,k+( 3)*shiftk,
+                                      j+( 3)*shiftj,
+                                      i+( 3)*shifti))
+          + (  +1./5.   * quant(m,a,b,k+(-2)*shiftk,
+                                      j+(-2)*shiftj,
+                                      i+(-2)*shifti)
+               -1./5.   * quant(m,a,b,k+( 2)*shiftk,
+                                      j+( 2)*shiftj,
+                                      i+( 2)*shifti))
+          + (  -4./5.   * quant(m,a,b,k+(-1)*shiftk,
+                                      j+(-1)*shiftj,
+                                      i+(-1)*shifti)
+               +4./5.   * quant(m,a,b,k+( 1)*shiftk,
+                                      j+( 1)*shiftj,
+                                      i+( 1)*shifti));
   }
   return out*idx[dir];
 }
@@ -237,6 +312,34 @@ Real Dxx(int const dir,
               -49./18.  * quant(m,k,
                                   j,
                                   i);
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + ( -1./560.  * quant(m,k+(-4)*shiftk,
+                                  j+(-4)*shiftj,
+                                  i+(-4)*shifti)
+              -1./560.  * quant(m,k+( 4)*shiftk,
+                                  j+( 4)*shiftj,
+                                  i+( 4)*shifti))
+          + ( +8./315.  * quant(m,k+(-3)*shiftk,
+                                  j+(-3)*shiftj,
+                                  i+(-3)*shifti)
+              +8./315.  * quant(m,k+( 3)*shiftk,
+                                  j+( 3)*shiftj,
+                                  i+( 3)*shifti))
+          + (  -1./5.   * quant(m,k+(-2)*shiftk,
+                                  j+(-2)*shiftj,
+                                  i+(-2)*shifti)
+               -1./5.   * quant(m,k+( 2)*shiftk,
+                                  j+( 2)*shiftj,
+                                  i+( 2)*shifti))
+          + (  +8./5.   * quant(m,k+(-1)*shiftk,
+                                  j+(-1)*shiftj,
+                                  i+(-1)*shifti)
+               +8./5.   * quant(m,k+( 1)*shiftk,
+                                  j+( 1)*shiftj,
+                                  i+( 1)*shifti))
+              -205./72. * quant(m,k,
+                                  j,
+                                  i);
   }
   return out*idx[dir]*idx[dir];
 }
@@ -302,6 +405,34 @@ Real Dxx(int const dir,
               -49./18.  * quant(m,a,k,
                                     j,
                                     i);
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + ( -1./560.  * quant(m,a,k+(-4)*shiftk,
+                                    j+(-4)*shiftj,
+                                    i+(-4)*shifti)
+              -1./560.  * quant(m,a,k+( 4)*shiftk,
+                                    j+( 4)*shiftj,
+                                    i+( 4)*shifti))
+          + ( +8./315.  * quant(m,a,k+(-3)*shiftk,
+                                    j+(-3)*shiftj,
+                                    i+(-3)*shifti)
+              +8./315.  * quant(m,a,k+( 3)*shiftk,
+                                    j+( 3)*shiftj,
+                                    i+( 3)*shifti))
+          + (  -1./5.   * quant(m,a,k+(-2)*shiftk,
+                                    j+(-2)*shiftj,
+                                    i+(-2)*shifti)
+               -1./5.   * quant(m,a,k+( 2)*shiftk,
+                                    j+( 2)*shiftj,
+                                    i+( 2)*shifti))
+          + (  +8./5.   * quant(m,a,k+(-1)*shiftk,
+                                    j+(-1)*shiftj,
+                                    i+(-1)*shifti)
+               +8./5.   * quant(m,a,k+( 1)*shiftk,
+                                    j+( 1)*shiftj,
+                                    i+( 1)*shifti))
+              -205./72. * quant(m,a,k,
+                                    j,
+                                    i);
   }
   return out*idx[dir]*idx[dir];
 }
@@ -367,6 +498,34 @@ Real Dxx(int const dir,
               -49./18.  * quant(m,a,b,k,
                                       j,
                                       i);
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + ( -1./560.  * quant(m,a,b,k+(-4)*shiftk,
+                                      j+(-4)*shiftj,
+                                      i+(-4)*shifti)
+              -1./560.  * quant(m,a,b,k+( 4)*shiftk,
+                                      j+( 4)*shiftj,
+                                      i+( 4)*shifti))
+          + ( +8./315.  * quant(m,a,b,k+(-3)*shiftk,
+                                      j+(-3)*shiftj,
+                                      i+(-3)*shifti)
+              +8./315.  * quant(m,a,b,k+( 3)*shiftk,
+                                      j+( 3)*shiftj,
+                                      i+( 3)*shifti))
+          + (  -1./5.   * quant(m,a,b,k+(-2)*shiftk,
+                                      j+(-2)*shiftj,
+                                      i+(-2)*shifti)
+               -1./5.   * quant(m,a,b,k+( 2)*shiftk,
+                                      j+( 2)*shiftj,
+                                      i+( 2)*shifti))
+          + (  +8./5.   * quant(m,a,b,k+(-1)*shiftk,
+                                      j+(-1)*shiftj,
+                                      i+(-1)*shifti)
+               +8./5.   * quant(m,a,b,k+( 1)*shiftk,
+                                      j+( 1)*shiftj,
+                                      i+( 1)*shifti))
+              -205./72. * quant(m,a,b,k,
+                                      j,
+                                      i);
   }
   return out*idx[dir]*idx[dir];
 }
@@ -642,6 +801,295 @@ Real Dxy(int const dirx, int const diry,
                                                       i+( 1)*shiftxi + ( 1)*shiftyi)
               )
             );
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + (
+            + (
+              + (  1./280. ) * (  1./280. ) * quant(m,k+(-4)*shiftxk + (-4)*shiftyk,
+                                                      j+(-4)*shiftxj + (-4)*shiftyj,
+                                                      i+(-4)*shiftxi + (-4)*shiftyi)
+              + (  1./280. ) * ( -1./280. ) * quant(m,k+(-4)*shiftxk + ( 4)*shiftyk,
+                                                      j+(-4)*shiftxj + ( 4)*shiftyj,
+                                                      i+(-4)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * (  1./280. ) * quant(m,k+( 4)*shiftxk + (-4)*shiftyk,
+                                                      j+( 4)*shiftxj + (-4)*shiftyj,
+                                                      i+( 4)*shiftxi + (-4)*shiftyi)
+              + ( -1./280. ) * ( -1./280. ) * quant(m,k+( 4)*shiftxk + ( 4)*shiftyk,
+                                                      j+( 4)*shiftxj + ( 4)*shiftyj,
+                                                      i+( 4)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  1./280. ) * ( -4./105. ) * quant(m,k+(-4)*shiftxk + (-3)*shiftyk,
+                                                      j+(-4)*shiftxj + (-3)*shiftyj,
+                                                      i+(-4)*shiftxi + (-3)*shiftyi)
+              + (  1./280. ) * (  4./105. ) * quant(m,k+(-4)*shiftxk + ( 3)*shiftyk,
+                                                      j+(-4)*shiftxj + ( 3)*shiftyj,
+                                                      i+(-4)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * ( -4./105. ) * quant(m,k+( 4)*shiftxk + (-3)*shiftyk,
+                                                      j+( 4)*shiftxj + (-3)*shiftyj,
+                                                      i+( 4)*shiftxi + (-3)*shiftyi)
+              + ( -1./280. ) * (  4./105. ) * quant(m,k+( 4)*shiftxk + ( 3)*shiftyk,
+                                                      j+( 4)*shiftxj + ( 3)*shiftyj,
+                                                      i+( 4)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  1./280. ) * (   1./5.  ) * quant(m,k+(-4)*shiftxk + (-2)*shiftyk,
+                                                      j+(-4)*shiftxj + (-2)*shiftyj,
+                                                      i+(-4)*shiftxi + (-2)*shiftyi)
+              + (  1./280. ) * (  -1./5.  ) * quant(m,k+(-4)*shiftxk + ( 2)*shiftyk,
+                                                      j+(-4)*shiftxj + ( 2)*shiftyj,
+                                                      i+(-4)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * (   1./5.  ) * quant(m,k+( 4)*shiftxk + (-2)*shiftyk,
+                                                      j+( 4)*shiftxj + (-2)*shiftyj,
+                                                      i+( 4)*shiftxi + (-2)*shiftyi)
+              + ( -1./280. ) * (  -1./5.  ) * quant(m,k+( 4)*shiftxk + ( 2)*shiftyk,
+                                                      j+( 4)*shiftxj + ( 2)*shiftyj,
+                                                      i+( 4)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  1./280. ) * (  -4./5.  ) * quant(m,k+(-4)*shiftxk + (-1)*shiftyk,
+                                                      j+(-4)*shiftxj + (-1)*shiftyj,
+                                                      i+(-4)*shiftxi + (-1)*shiftyi)
+              + (  1./280. ) * (   4./5.  ) * quant(m,k+(-4)*shiftxk + ( 1)*shiftyk,
+                                                      j+(-4)*shiftxj + ( 1)*shiftyj,
+                                                      i+(-4)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * (  -4./5.  ) * quant(m,k+( 4)*shiftxk + (-1)*shiftyk,
+                                                      j+( 4)*shiftxj + (-1)*shiftyj,
+                                                      i+( 4)*shiftxi + (-1)*shiftyi)
+              + ( -1./280. ) * (   4./5.  ) * quant(m,k+( 4)*shiftxk + ( 1)*shiftyk,
+                                                      j+( 4)*shiftxj + ( 1)*shiftyj,
+                                                      i+( 4)*shiftxi + ( 1)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * (  1./280. ) * quant(m,k+(-3)*shiftxk + (-4)*shiftyk,
+                                                      j+(-3)*shiftxj + (-4)*shiftyj,
+                                                      i+(-3)*shiftxi + (-4)*shiftyi)
+              + ( -4./105. ) * ( -1./280. ) * quant(m,k+(-3)*shiftxk + ( 4)*shiftyk,
+                                                      j+(-3)*shiftxj + ( 4)*shiftyj,
+                                                      i+(-3)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * (  1./280. ) * quant(m,k+( 3)*shiftxk + (-4)*shiftyk,
+                                                      j+( 3)*shiftxj + (-4)*shiftyj,
+                                                      i+( 3)*shiftxi + (-4)*shiftyi)
+              + (  4./105. ) * ( -1./280. ) * quant(m,k+( 3)*shiftxk + ( 4)*shiftyk,
+                                                      j+( 3)*shiftxj + ( 4)*shiftyj,
+                                                      i+( 3)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * ( -4./105. ) * quant(m,k+(-3)*shiftxk + (-3)*shiftyk,
+                                                      j+(-3)*shiftxj + (-3)*shiftyj,
+                                                      i+(-3)*shiftxi + (-3)*shiftyi)
+              + ( -4./105. ) * (  4./105. ) * quant(m,k+(-3)*shiftxk + ( 3)*shiftyk,
+                                                      j+(-3)*shiftxj + ( 3)*shiftyj,
+                                                      i+(-3)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * ( -4./105. ) * quant(m,k+( 3)*shiftxk + (-3)*shiftyk,
+                                                      j+( 3)*shiftxj + (-3)*shiftyj,
+                                                      i+( 3)*shiftxi + (-3)*shiftyi)
+              + (  4./105. ) * (  4./105. ) * quant(m,k+( 3)*shiftxk + ( 3)*shiftyk,
+                                                      j+( 3)*shiftxj + ( 3)*shiftyj,
+                                                      i+( 3)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * (   1./5.  ) * quant(m,k+(-3)*shiftxk + (-2)*shiftyk,
+                                                      j+(-3)*shiftxj + (-2)*shiftyj,
+                                                      i+(-3)*shiftxi + (-2)*shiftyi)
+              + ( -4./105. ) * (  -1./5.  ) * quant(m,k+(-3)*shiftxk + ( 2)*shiftyk,
+                                                      j+(-3)*shiftxj + ( 2)*shiftyj,
+                                                      i+(-3)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * (   1./5.  ) * quant(m,k+( 3)*shiftxk + (-2)*shiftyk,
+                                                      j+( 3)*shiftxj + (-2)*shiftyj,
+                                                      i+( 3)*shiftxi + (-2)*shiftyi)
+              + (  4./105. ) * (  -1./5.  ) * quant(m,k+( 3)*shiftxk + ( 2)*shiftyk,
+                                                      j+( 3)*shiftxj + ( 2)*shiftyj,
+                                                      i+( 3)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * (  -4./5.  ) * quant(m,k+(-3)*shiftxk + (-1)*shiftyk,
+                                                      j+(-3)*shiftxj + (-1)*shiftyj,
+                                                      i+(-3)*shiftxi + (-1)*shiftyi)
+              + ( -4./105. ) * (   4./5.  ) * quant(m,k+(-3)*shiftxk + ( 1)*shiftyk,
+                                                      j+(-3)*shiftxj + ( 1)*shiftyj,
+                                                      i+(-3)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * (  -4./5.  ) * quant(m,k+( 3)*shiftxk + (-1)*shiftyk,
+                                                      j+( 3)*shiftxj + (-1)*shiftyj,
+                                                      i+( 3)*shiftxi + (-1)*shiftyi)
+              + (  4./105. ) * (   4./5.  ) * quant(m,k+( 3)*shiftxk + ( 1)*shiftyk,
+                                                      j+( 3)*shiftxj + ( 1)*shiftyj,
+                                                      i+( 3)*shiftxi + ( 1)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * (  1./280. ) * quant(m,k+(-2)*shiftxk + (-4)*shiftyk,
+                                                      j+(-2)*shiftxj + (-4)*shiftyj,
+                                                      i+(-2)*shiftxi + (-4)*shiftyi)
+              + (   1./5.  ) * ( -1./280. ) * quant(m,k+(-2)*shiftxk + ( 4)*shiftyk,
+                                                      j+(-2)*shiftxj + ( 4)*shiftyj,
+                                                      i+(-2)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * (  1./280. ) * quant(m,k+( 2)*shiftxk + (-4)*shiftyk,
+                                                      j+( 2)*shiftxj + (-4)*shiftyj,
+                                                      i+( 2)*shiftxi + (-4)*shiftyi)
+              + (  -1./5.  ) * ( -1./280. ) * quant(m,k+( 2)*shiftxk + ( 4)*shiftyk,
+                                                      j+( 2)*shiftxj + ( 4)*shiftyj,
+                                                      i+( 2)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * ( -4./105. ) * quant(m,k+(-2)*shiftxk + (-3)*shiftyk,
+                                                      j+(-2)*shiftxj + (-3)*shiftyj,
+                                                      i+(-2)*shiftxi + (-3)*shiftyi)
+              + (   1./5.  ) * (  4./105. ) * quant(m,k+(-2)*shiftxk + ( 3)*shiftyk,
+                                                      j+(-2)*shiftxj + ( 3)*shiftyj,
+                                                      i+(-2)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * ( -4./105. ) * quant(m,k+( 2)*shiftxk + (-3)*shiftyk,
+                                                      j+( 2)*shiftxj + (-3)*shiftyj,
+                                                      i+( 2)*shiftxi + (-3)*shiftyi)
+              + (  -1./5.  ) * (  4./105. ) * quant(m,k+( 2)*shiftxk + ( 3)*shiftyk,
+                                                      j+( 2)*shiftxj + ( 3)*shiftyj,
+                                                      i+( 2)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * (   1./5.  ) * quant(m,k+(-2)*shiftxk + (-2)*shiftyk,
+                                                      j+(-2)*shiftxj + (-2)*shiftyj,
+                                                      i+(-2)*shiftxi + (-2)*shiftyi)
+              + (   1./5.  ) * (  -1./5.  ) * quant(m,k+(-2)*shiftxk + ( 2)*shiftyk,
+                                                      j+(-2)*shiftxj + ( 2)*shiftyj,
+                                                      i+(-2)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * (   1./5.  ) * quant(m,k+( 2)*shiftxk + (-2)*shiftyk,
+                                                      j+( 2)*shiftxj + (-2)*shiftyj,
+                                                      i+( 2)*shiftxi + (-2)*shiftyi)
+              + (  -1./5.  ) * (  -1./5.  ) * quant(m,k+( 2)*shiftxk + ( 2)*shiftyk,
+                                                      j+( 2)*shiftxj + ( 2)*shiftyj,
+                                                      i+( 2)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * (  -4./5.  ) * quant(m,k+(-2)*shiftxk + (-1)*shiftyk,
+                                                      j+(-2)*shiftxj + (-1)*shiftyj,
+                                                      i+(-2)*shiftxi + (-1)*shiftyi)
+              + (   1./5.  ) * (   4./5.  ) * quant(m,k+(-2)*shiftxk + ( 1)*shiftyk,
+                                                      j+(-2)*shiftxj + ( 1)*shiftyj,
+                                                      i+(-2)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * (  -4./5.  ) * quant(m,k+( 2)*shiftxk + (-1)*shiftyk,
+                                                      j+( 2)*shiftxj + (-1)*shiftyj,
+                                                      i+( 2)*shiftxi + (-1)*shiftyi)
+              + (  -1./5.  ) * (   4./5.  ) * quant(m,k+( 2)*shiftxk + ( 1)*shiftyk,
+                                                      j+( 2)*shiftxj + ( 1)*shiftyj,
+                                                      i+( 2)*shiftxi + ( 1)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * (  1./280. ) * quant(m,k+(-1)*shiftxk + (-4)*shiftyk,
+                                                      j+(-1)*shiftxj + (-4)*shiftyj,
+                                                      i+(-1)*shiftxi + (-4)*shiftyi)
+              + (  -4./5.  ) * ( -1./280. ) * quant(m,k+(-1)*shiftxk + ( 4)*shiftyk,
+                                                      j+(-1)*shiftxj + ( 4)*shiftyj,
+                                                      i+(-1)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * (  1./280. ) * quant(m,k+( 1)*shiftxk + (-4)*shiftyk,
+                                                      j+( 1)*shiftxj + (-4)*shiftyj,
+                                                      i+( 1)*shiftxi + (-4)*shiftyi)
+              + (   4./5.  ) * ( -1./280. ) * quant(m,k+( 1)*shiftxk + ( 4)*shiftyk,
+                                                      j+( 1)*shiftxj + ( 4)*shiftyj,
+                                                      i+( 1)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * ( -4./105. ) * quant(m,k+(-1)*shiftxk + (-3)*shiftyk,
+                                                      j+(-1)*shiftxj + (-3)*shiftyj,
+                                                      i+(-1)*shiftxi + (-3)*shiftyi)
+              + (  -4./5.  ) * (  4./105. ) * quant(m,k+(-1)*shiftxk + ( 3)*shiftyk,
+                                                      j+(-1)*shiftxj + ( 3)*shiftyj,
+                                                      i+(-1)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * ( -4./105. ) * quant(m,k+( 1)*shiftxk + (-3)*shiftyk,
+                                                      j+( 1)*shiftxj + (-3)*shiftyj,
+                                                      i+( 1)*shiftxi + (-3)*shiftyi)
+              + (   4./5.  ) * (  4./105. ) * quant(m,k+( 1)*shiftxk + ( 3)*shiftyk,
+                                                      j+( 1)*shiftxj + ( 3)*shiftyj,
+                                                      i+( 1)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * (   1./5.  ) * quant(m,k+(-1)*shiftxk + (-2)*shiftyk,
+                                                      j+(-1)*shiftxj + (-2)*shiftyj,
+                                                      i+(-1)*shiftxi + (-2)*shiftyi)
+              + (  -4./5.  ) * (  -1./5.  ) * quant(m,k+(-1)*shiftxk + ( 2)*shiftyk,
+                                                      j+(-1)*shiftxj + ( 2)*shiftyj,
+                                                      i+(-1)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * (   1./5.  ) * quant(m,k+( 1)*shiftxk + (-2)*shiftyk,
+                                                      j+( 1)*shiftxj + (-2)*shiftyj,
+                                                      i+( 1)*shiftxi + (-2)*shiftyi)
+              + (   4./5.  ) * (  -1./5.  ) * quant(m,k+( 1)*shiftxk + ( 2)*shiftyk,
+                                                      j+( 1)*shiftxj + ( 2)*shiftyj,
+                                                      i+( 1)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * (  -4./5.  ) * quant(m,k+(-1)*shiftxk + (-1)*shiftyk,
+                                                      j+(-1)*shiftxj + (-1)*shiftyj,
+                                                      i+(-1)*shiftxi + (-1)*shiftyi)
+              + (  -4./5.  ) * (   4./5.  ) * quant(m,k+(-1)*shiftxk + ( 1)*shiftyk,
+                                                      j+(-1)*shiftxj + ( 1)*shiftyj,
+                                                      i+(-1)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * (  -4./5.  ) * quant(m,k+( 1)*shiftxk + (-1)*shiftyk,
+                                                      j+( 1)*shiftxj + (-1)*shiftyj,
+                                                      i+( 1)*shiftxi + (-1)*shiftyi)
+              + (   4./5.  ) * (   4./5.  ) * quant(m,k+( 1)*shiftxk + ( 1)*shiftyk,
+                                                      j+( 1)*shiftxj + ( 1)*shiftyj,
+                                                      i+( 1)*shiftxi + ( 1)*shiftyi)
+              )
+            );
   }
   return out*idx[dirx]*idx[diry];
 }
@@ -917,8 +1365,297 @@ Real Dxy(int const dirx, int const diry,
                                                         i+( 1)*shiftxi + ( 1)*shiftyi)
               )
             );
-  }
-  return out*idx[dirx]*idx[diry];
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + (
+            + (
+              + (  1./280. ) * (  1./280. ) * quant(m,a,k+(-4)*shiftxk + (-4)*shiftyk,
+                                                        j+(-4)*shiftxj + (-4)*shiftyj,
+                                                        i+(-4)*shiftxi + (-4)*shiftyi)
+              + (  1./280. ) * ( -1./280. ) * quant(m,a,k+(-4)*shiftxk + ( 4)*shiftyk,
+                                                        j+(-4)*shiftxj + ( 4)*shiftyj,
+                                                        i+(-4)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * (  1./280. ) * quant(m,a,k+( 4)*shiftxk + (-4)*shiftyk,
+                                                        j+( 4)*shiftxj + (-4)*shiftyj,
+                                                        i+( 4)*shiftxi + (-4)*shiftyi)
+              + ( -1./280. ) * ( -1./280. ) * quant(m,a,k+( 4)*shiftxk + ( 4)*shiftyk,
+                                                        j+( 4)*shiftxj + ( 4)*shiftyj,
+                                                        i+( 4)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  1./280. ) * ( -4./105. ) * quant(m,a,k+(-4)*shiftxk + (-3)*shiftyk,
+                                                        j+(-4)*shiftxj + (-3)*shiftyj,
+                                                        i+(-4)*shiftxi + (-3)*shiftyi)
+              + (  1./280. ) * (  4./105. ) * quant(m,a,k+(-4)*shiftxk + ( 3)*shiftyk,
+                                                        j+(-4)*shiftxj + ( 3)*shiftyj,
+                                                        i+(-4)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * ( -4./105. ) * quant(m,a,k+( 4)*shiftxk + (-3)*shiftyk,
+                                                        j+( 4)*shiftxj + (-3)*shiftyj,
+                                                        i+( 4)*shiftxi + (-3)*shiftyi)
+              + ( -1./280. ) * (  4./105. ) * quant(m,a,k+( 4)*shiftxk + ( 3)*shiftyk,
+                                                        j+( 4)*shiftxj + ( 3)*shiftyj,
+                                                        i+( 4)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  1./280. ) * (   1./5.  ) * quant(m,a,k+(-4)*shiftxk + (-2)*shiftyk,
+                                                        j+(-4)*shiftxj + (-2)*shiftyj,
+                                                        i+(-4)*shiftxi + (-2)*shiftyi)
+              + (  1./280. ) * (  -1./5.  ) * quant(m,a,k+(-4)*shiftxk + ( 2)*shiftyk,
+                                                        j+(-4)*shiftxj + ( 2)*shiftyj,
+                                                        i+(-4)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * (   1./5.  ) * quant(m,a,k+( 4)*shiftxk + (-2)*shiftyk,
+                                                        j+( 4)*shiftxj + (-2)*shiftyj,
+                                                        i+( 4)*shiftxi + (-2)*shiftyi)
+              + ( -1./280. ) * (  -1./5.  ) * quant(m,a,k+( 4)*shiftxk + ( 2)*shiftyk,
+                                                        j+( 4)*shiftxj + ( 2)*shiftyj,
+                                                        i+( 4)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  1./280. ) * (  -4./5.  ) * quant(m,a,k+(-4)*shiftxk + (-1)*shiftyk,
+                                                        j+(-4)*shiftxj + (-1)*shiftyj,
+                                                        i+(-4)*shiftxi + (-1)*shiftyi)
+              + (  1./280. ) * (   4./5.  ) * quant(m,a,k+(-4)*shiftxk + ( 1)*shiftyk,
+                                                        j+(-4)*shiftxj + ( 1)*shiftyj,
+                                                        i+(-4)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * (  -4./5.  ) * quant(m,a,k+( 4)*shiftxk + (-1)*shiftyk,
+                                                        j+( 4)*shiftxj + (-1)*shiftyj,
+                                                        i+( 4)*shiftxi + (-1)*shiftyi)
+              + ( -1./280. ) * (   4./5.  ) * quant(m,a,k+( 4)*shiftxk + ( 1)*shiftyk,
+                                                        j+( 4)*shiftxj + ( 1)*shiftyj,
+                                                        i+( 4)*shiftxi + ( 1)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * (  1./280. ) * quant(m,a,k+(-3)*shiftxk + (-4)*shiftyk,
+                                                        j+(-3)*shiftxj + (-4)*shiftyj,
+                                                        i+(-3)*shiftxi + (-4)*shiftyi)
+              + ( -4./105. ) * ( -1./280. ) * quant(m,a,k+(-3)*shiftxk + ( 4)*shiftyk,
+                                                        j+(-3)*shiftxj + ( 4)*shiftyj,
+                                                        i+(-3)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * (  1./280. ) * quant(m,a,k+( 3)*shiftxk + (-4)*shiftyk,
+                                                        j+( 3)*shiftxj + (-4)*shiftyj,
+                                                        i+( 3)*shiftxi + (-4)*shiftyi)
+              + (  4./105. ) * ( -1./280. ) * quant(m,a,k+( 3)*shiftxk + ( 4)*shiftyk,
+                                                        j+( 3)*shiftxj + ( 4)*shiftyj,
+                                                        i+( 3)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * ( -4./105. ) * quant(m,a,k+(-3)*shiftxk + (-3)*shiftyk,
+                                                        j+(-3)*shiftxj + (-3)*shiftyj,
+                                                        i+(-3)*shiftxi + (-3)*shiftyi)
+              + ( -4./105. ) * (  4./105. ) * quant(m,a,k+(-3)*shiftxk + ( 3)*shiftyk,
+                                                        j+(-3)*shiftxj + ( 3)*shiftyj,
+                                                        i+(-3)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * ( -4./105. ) * quant(m,a,k+( 3)*shiftxk + (-3)*shiftyk,
+                                                        j+( 3)*shiftxj + (-3)*shiftyj,
+                                                        i+( 3)*shiftxi + (-3)*shiftyi)
+              + (  4./105. ) * (  4./105. ) * quant(m,a,k+( 3)*shiftxk + ( 3)*shiftyk,
+                                                        j+( 3)*shiftxj + ( 3)*shiftyj,
+                                                        i+( 3)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * (   1./5.  ) * quant(m,a,k+(-3)*shiftxk + (-2)*shiftyk,
+                                                        j+(-3)*shiftxj + (-2)*shiftyj,
+                                                        i+(-3)*shiftxi + (-2)*shiftyi)
+              + ( -4./105. ) * (  -1./5.  ) * quant(m,a,k+(-3)*shiftxk + ( 2)*shiftyk,
+                                                        j+(-3)*shiftxj + ( 2)*shiftyj,
+                                                        i+(-3)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * (   1./5.  ) * quant(m,a,k+( 3)*shiftxk + (-2)*shiftyk,
+                                                        j+( 3)*shiftxj + (-2)*shiftyj,
+                                                        i+( 3)*shiftxi + (-2)*shiftyi)
+              + (  4./105. ) * (  -1./5.  ) * quant(m,a,k+( 3)*shiftxk + ( 2)*shiftyk,
+                                                        j+( 3)*shiftxj + ( 2)*shiftyj,
+                                                        i+( 3)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * (  -4./5.  ) * quant(m,a,k+(-3)*shiftxk + (-1)*shiftyk,
+                                                        j+(-3)*shiftxj + (-1)*shiftyj,
+                                                        i+(-3)*shiftxi + (-1)*shiftyi)
+              + ( -4./105. ) * (   4./5.  ) * quant(m,a,k+(-3)*shiftxk + ( 1)*shiftyk,
+                                                        j+(-3)*shiftxj + ( 1)*shiftyj,
+                                                        i+(-3)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * (  -4./5.  ) * quant(m,a,k+( 3)*shiftxk + (-1)*shiftyk,
+                                                        j+( 3)*shiftxj + (-1)*shiftyj,
+                                                        i+( 3)*shiftxi + (-1)*shiftyi)
+              + (  4./105. ) * (   4./5.  ) * quant(m,a,k+( 3)*shiftxk + ( 1)*shiftyk,
+                                                        j+( 3)*shiftxj + ( 1)*shiftyj,
+                                                        i+( 3)*shiftxi + ( 1)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * (  1./280. ) * quant(m,a,k+(-2)*shiftxk + (-4)*shiftyk,
+                                                        j+(-2)*shiftxj + (-4)*shiftyj,
+                                                        i+(-2)*shiftxi + (-4)*shiftyi)
+              + (   1./5.  ) * ( -1./280. ) * quant(m,a,k+(-2)*shiftxk + ( 4)*shiftyk,
+                                                        j+(-2)*shiftxj + ( 4)*shiftyj,
+                                                        i+(-2)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * (  1./280. ) * quant(m,a,k+( 2)*shiftxk + (-4)*shiftyk,
+                                                        j+( 2)*shiftxj + (-4)*shiftyj,
+                                                        i+( 2)*shiftxi + (-4)*shiftyi)
+              + (  -1./5.  ) * ( -1./280. ) * quant(m,a,k+( 2)*shiftxk + ( 4)*shiftyk,
+                                                        j+( 2)*shiftxj + ( 4)*shiftyj,
+                                                        i+( 2)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * ( -4./105. ) * quant(m,a,k+(-2)*shiftxk + (-3)*shiftyk,
+                                                        j+(-2)*shiftxj + (-3)*shiftyj,
+                                                        i+(-2)*shiftxi + (-3)*shiftyi)
+              + (   1./5.  ) * (  4./105. ) * quant(m,a,k+(-2)*shiftxk + ( 3)*shiftyk,
+                                                        j+(-2)*shiftxj + ( 3)*shiftyj,
+                                                        i+(-2)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * ( -4./105. ) * quant(m,a,k+( 2)*shiftxk + (-3)*shiftyk,
+                                                        j+( 2)*shiftxj + (-3)*shiftyj,
+                                                        i+( 2)*shiftxi + (-3)*shiftyi)
+              + (  -1./5.  ) * (  4./105. ) * quant(m,a,k+( 2)*shiftxk + ( 3)*shiftyk,
+                                                        j+( 2)*shiftxj + ( 3)*shiftyj,
+                                                        i+( 2)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * (   1./5.  ) * quant(m,a,k+(-2)*shiftxk + (-2)*shiftyk,
+                                                        j+(-2)*shiftxj + (-2)*shiftyj,
+                                                        i+(-2)*shiftxi + (-2)*shiftyi)
+              + (   1./5.  ) * (  -1./5.  ) * quant(m,a,k+(-2)*shiftxk + ( 2)*shiftyk,
+                                                        j+(-2)*shiftxj + ( 2)*shiftyj,
+                                                        i+(-2)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * (   1./5.  ) * quant(m,a,k+( 2)*shiftxk + (-2)*shiftyk,
+                                                        j+( 2)*shiftxj + (-2)*shiftyj,
+                                                        i+( 2)*shiftxi + (-2)*shiftyi)
+              + (  -1./5.  ) * (  -1./5.  ) * quant(m,a,k+( 2)*shiftxk + ( 2)*shiftyk,
+                                                        j+( 2)*shiftxj + ( 2)*shiftyj,
+                                                        i+( 2)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * (  -4./5.  ) * quant(m,a,k+(-2)*shiftxk + (-1)*shiftyk,
+                                                        j+(-2)*shiftxj + (-1)*shiftyj,
+                                                        i+(-2)*shiftxi + (-1)*shiftyi)
+              + (   1./5.  ) * (   4./5.  ) * quant(m,a,k+(-2)*shiftxk + ( 1)*shiftyk,
+                                                        j+(-2)*shiftxj + ( 1)*shiftyj,
+                                                        i+(-2)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * (  -4./5.  ) * quant(m,a,k+( 2)*shiftxk + (-1)*shiftyk,
+                                                        j+( 2)*shiftxj + (-1)*shiftyj,
+                                                        i+( 2)*shiftxi + (-1)*shiftyi)
+              + (  -1./5.  ) * (   4./5.  ) * quant(m,a,k+( 2)*shiftxk + ( 1)*shiftyk,
+                                                        j+( 2)*shiftxj + ( 1)*shiftyj,
+                                                        i+( 2)*shiftxi + ( 1)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * (  1./280. ) * quant(m,a,k+(-1)*shiftxk + (-4)*shiftyk,
+                                                        j+(-1)*shiftxj + (-4)*shiftyj,
+                                                        i+(-1)*shiftxi + (-4)*shiftyi)
+              + (  -4./5.  ) * ( -1./280. ) * quant(m,a,k+(-1)*shiftxk + ( 4)*shiftyk,
+                                                        j+(-1)*shiftxj + ( 4)*shiftyj,
+                                                        i+(-1)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * (  1./280. ) * quant(m,a,k+( 1)*shiftxk + (-4)*shiftyk,
+                                                        j+( 1)*shiftxj + (-4)*shiftyj,
+                                                        i+( 1)*shiftxi + (-4)*shiftyi)
+              + (   4./5.  ) * ( -1./280. ) * quant(m,a,k+( 1)*shiftxk + ( 4)*shiftyk,
+                                                        j+( 1)*shiftxj + ( 4)*shiftyj,
+                                                        i+( 1)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * ( -4./105. ) * quant(m,a,k+(-1)*shiftxk + (-3)*shiftyk,
+                                                        j+(-1)*shiftxj + (-3)*shiftyj,
+                                                        i+(-1)*shiftxi + (-3)*shiftyi)
+              + (  -4./5.  ) * (  4./105. ) * quant(m,a,k+(-1)*shiftxk + ( 3)*shiftyk,
+                                                        j+(-1)*shiftxj + ( 3)*shiftyj,
+                                                        i+(-1)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * ( -4./105. ) * quant(m,a,k+( 1)*shiftxk + (-3)*shiftyk,
+                                                        j+( 1)*shiftxj + (-3)*shiftyj,
+                                                        i+( 1)*shiftxi + (-3)*shiftyi)
+              + (   4./5.  ) * (  4./105. ) * quant(m,a,k+( 1)*shiftxk + ( 3)*shiftyk,
+                                                        j+( 1)*shiftxj + ( 3)*shiftyj,
+                                                        i+( 1)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * (   1./5.  ) * quant(m,a,k+(-1)*shiftxk + (-2)*shiftyk,
+                                                        j+(-1)*shiftxj + (-2)*shiftyj,
+                                                        i+(-1)*shiftxi + (-2)*shiftyi)
+              + (  -4./5.  ) * (  -1./5.  ) * quant(m,a,k+(-1)*shiftxk + ( 2)*shiftyk,
+                                                        j+(-1)*shiftxj + ( 2)*shiftyj,
+                                                        i+(-1)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * (   1./5.  ) * quant(m,a,k+( 1)*shiftxk + (-2)*shiftyk,
+                                                        j+( 1)*shiftxj + (-2)*shiftyj,
+                                                        i+( 1)*shiftxi + (-2)*shiftyi)
+              + (   4./5.  ) * (  -1./5.  ) * quant(m,a,k+( 1)*shiftxk + ( 2)*shiftyk,
+                                                        j+( 1)*shiftxj + ( 2)*shiftyj,
+                                                        i+( 1)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * (  -4./5.  ) * quant(m,a,k+(-1)*shiftxk + (-1)*shiftyk,
+                                                        j+(-1)*shiftxj + (-1)*shiftyj,
+                                                        i+(-1)*shiftxi + (-1)*shiftyi)
+              + (  -4./5.  ) * (   4./5.  ) * quant(m,a,k+(-1)*shiftxk + ( 1)*shiftyk,
+                                                        j+(-1)*shiftxj + ( 1)*shiftyj,
+                                                        i+(-1)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * (  -4./5.  ) * quant(m,a,k+( 1)*shiftxk + (-1)*shiftyk,
+                                                        j+( 1)*shiftxj + (-1)*shiftyj,
+                                                        i+( 1)*shiftxi + (-1)*shiftyi)
+              + (   4./5.  ) * (   4./5.  ) * quant(m,a,k+( 1)*shiftxk + ( 1)*shiftyk,
+                                                        j+( 1)*shiftxj + ( 1)*shiftyj,
+                                                        i+( 1)*shiftxi + ( 1)*shiftyi)
+              )
+            );
+  }
+  return out*idx[dirx]*idx[diry];
 }
 
 
@@ -1192,6 +1929,295 @@ Real Dxy(int const dirx, int const diry,
                                                           i+( 1)*shiftxi + ( 1)*shiftyi)
               )
             );
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + (
+            + (
+              + (  1./280. ) * (  1./280. ) * quant(m,a,b,k+(-4)*shiftxk + (-4)*shiftyk,
+                                                          j+(-4)*shiftxj + (-4)*shiftyj,
+                                                          i+(-4)*shiftxi + (-4)*shiftyi)
+              + (  1./280. ) * ( -1./280. ) * quant(m,a,b,k+(-4)*shiftxk + ( 4)*shiftyk,
+                                                          j+(-4)*shiftxj + ( 4)*shiftyj,
+                                                          i+(-4)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * (  1./280. ) * quant(m,a,b,k+( 4)*shiftxk + (-4)*shiftyk,
+                                                          j+( 4)*shiftxj + (-4)*shiftyj,
+                                                          i+( 4)*shiftxi + (-4)*shiftyi)
+              + ( -1./280. ) * ( -1./280. ) * quant(m,a,b,k+( 4)*shiftxk + ( 4)*shiftyk,
+                                                          j+( 4)*shiftxj + ( 4)*shiftyj,
+                                                          i+( 4)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  1./280. ) * ( -4./105. ) * quant(m,a,b,k+(-4)*shiftxk + (-3)*shiftyk,
+                                                          j+(-4)*shiftxj + (-3)*shiftyj,
+                                                          i+(-4)*shiftxi + (-3)*shiftyi)
+              + (  1./280. ) * (  4./105. ) * quant(m,a,b,k+(-4)*shiftxk + ( 3)*shiftyk,
+                                                          j+(-4)*shiftxj + ( 3)*shiftyj,
+                                                          i+(-4)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * ( -4./105. ) * quant(m,a,b,k+( 4)*shiftxk + (-3)*shiftyk,
+                                                          j+( 4)*shiftxj + (-3)*shiftyj,
+                                                          i+( 4)*shiftxi + (-3)*shiftyi)
+              + ( -1./280. ) * (  4./105. ) * quant(m,a,b,k+( 4)*shiftxk + ( 3)*shiftyk,
+                                                          j+( 4)*shiftxj + ( 3)*shiftyj,
+                                                          i+( 4)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  1./280. ) * (   1./5.  ) * quant(m,a,b,k+(-4)*shiftxk + (-2)*shiftyk,
+                                                          j+(-4)*shiftxj + (-2)*shiftyj,
+                                                          i+(-4)*shiftxi + (-2)*shiftyi)
+              + (  1./280. ) * (  -1./5.  ) * quant(m,a,b,k+(-4)*shiftxk + ( 2)*shiftyk,
+                                                          j+(-4)*shiftxj + ( 2)*shiftyj,
+                                                          i+(-4)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * (   1./5.  ) * quant(m,a,b,k+( 4)*shiftxk + (-2)*shiftyk,
+                                                          j+( 4)*shiftxj + (-2)*shiftyj,
+                                                          i+( 4)*shiftxi + (-2)*shiftyi)
+              + ( -1./280. ) * (  -1./5.  ) * quant(m,a,b,k+( 4)*shiftxk + ( 2)*shiftyk,
+                                                          j+( 4)*shiftxj + ( 2)*shiftyj,
+                                                          i+( 4)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  1./280. ) * (  -4./5.  ) * quant(m,a,b,k+(-4)*shiftxk + (-1)*shiftyk,
+                                                          j+(-4)*shiftxj + (-1)*shiftyj,
+                                                          i+(-4)*shiftxi + (-1)*shiftyi)
+              + (  1./280. ) * (   4./5.  ) * quant(m,a,b,k+(-4)*shiftxk + ( 1)*shiftyk,
+                                                          j+(-4)*shiftxj + ( 1)*shiftyj,
+                                                          i+(-4)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + ( -1./280. ) * (  -4./5.  ) * quant(m,a,b,k+( 4)*shiftxk + (-1)*shiftyk,
+                                                          j+( 4)*shiftxj + (-1)*shiftyj,
+                                                          i+( 4)*shiftxi + (-1)*shiftyi)
+              + ( -1./280. ) * (   4./5.  ) * quant(m,a,b,k+( 4)*shiftxk + ( 1)*shiftyk,
+                                                          j+( 4)*shiftxj + ( 1)*shiftyj,
+                                                          i+( 4)*shiftxi + ( 1)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * (  1./280. ) * quant(m,a,b,k+(-3)*shiftxk + (-4)*shiftyk,
+                                                          j+(-3)*shiftxj + (-4)*shiftyj,
+                                                          i+(-3)*shiftxi + (-4)*shiftyi)
+              + ( -4./105. ) * ( -1./280. ) * quant(m,a,b,k+(-3)*shiftxk + ( 4)*shiftyk,
+                                                          j+(-3)*shiftxj + ( 4)*shiftyj,
+                                                          i+(-3)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * (  1./280. ) * quant(m,a,b,k+( 3)*shiftxk + (-4)*shiftyk,
+                                                          j+( 3)*shiftxj + (-4)*shiftyj,
+                                                          i+( 3)*shiftxi + (-4)*shiftyi)
+              + (  4./105. ) * ( -1./280. ) * quant(m,a,b,k+( 3)*shiftxk + ( 4)*shiftyk,
+                                                          j+( 3)*shiftxj + ( 4)*shiftyj,
+                                                          i+( 3)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * ( -4./105. ) * quant(m,a,b,k+(-3)*shiftxk + (-3)*shiftyk,
+                                                          j+(-3)*shiftxj + (-3)*shiftyj,
+                                                          i+(-3)*shiftxi + (-3)*shiftyi)
+              + ( -4./105. ) * (  4./105. ) * quant(m,a,b,k+(-3)*shiftxk + ( 3)*shiftyk,
+                                                          j+(-3)*shiftxj + ( 3)*shiftyj,
+                                                          i+(-3)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * ( -4./105. ) * quant(m,a,b,k+( 3)*shiftxk + (-3)*shiftyk,
+                                                          j+( 3)*shiftxj + (-3)*shiftyj,
+                                                          i+( 3)*shiftxi + (-3)*shiftyi)
+              + (  4./105. ) * (  4./105. ) * quant(m,a,b,k+( 3)*shiftxk + ( 3)*shiftyk,
+                                                          j+( 3)*shiftxj + ( 3)*shiftyj,
+                                                          i+( 3)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * (   1./5.  ) * quant(m,a,b,k+(-3)*shiftxk + (-2)*shiftyk,
+                                                          j+(-3)*shiftxj + (-2)*shiftyj,
+                                                          i+(-3)*shiftxi + (-2)*shiftyi)
+              + ( -4./105. ) * (  -1./5.  ) * quant(m,a,b,k+(-3)*shiftxk + ( 2)*shiftyk,
+                                                          j+(-3)*shiftxj + ( 2)*shiftyj,
+                                                          i+(-3)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * (   1./5.  ) * quant(m,a,b,k+( 3)*shiftxk + (-2)*shiftyk,
+                                                          j+( 3)*shiftxj + (-2)*shiftyj,
+                                                          i+( 3)*shiftxi + (-2)*shiftyi)
+              + (  4./105. ) * (  -1./5.  ) * quant(m,a,b,k+( 3)*shiftxk + ( 2)*shiftyk,
+                                                          j+( 3)*shiftxj + ( 2)*shiftyj,
+                                                          i+( 3)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + ( -4./105. ) * (  -4./5.  ) * quant(m,a,b,k+(-3)*shiftxk + (-1)*shiftyk,
+                                                          j+(-3)*shiftxj + (-1)*shiftyj,
+                                                          i+(-3)*shiftxi + (-1)*shiftyi)
+              + ( -4./105. ) * (   4./5.  ) * quant(m,a,b,k+(-3)*shiftxk + ( 1)*shiftyk,
+                                                          j+(-3)*shiftxj + ( 1)*shiftyj,
+                                                          i+(-3)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + (  4./105. ) * (  -4./5.  ) * quant(m,a,b,k+( 3)*shiftxk + (-1)*shiftyk,
+                                                          j+( 3)*shiftxj + (-1)*shiftyj,
+                                                          i+( 3)*shiftxi + (-1)*shiftyi)
+              + (  4./105. ) * (   4./5.  ) * quant(m,a,b,k+( 3)*shiftxk + ( 1)*shiftyk,
+                                                          j+( 3)*shiftxj + ( 1)*shiftyj,
+                                                          i+( 3)*shiftxi + ( 1)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * (  1./280. ) * quant(m,a,b,k+(-2)*shiftxk + (-4)*shiftyk,
+                                                          j+(-2)*shiftxj + (-4)*shiftyj,
+                                                          i+(-2)*shiftxi + (-4)*shiftyi)
+              + (   1./5.  ) * ( -1./280. ) * quant(m,a,b,k+(-2)*shiftxk + ( 4)*shiftyk,
+                                                          j+(-2)*shiftxj + ( 4)*shiftyj,
+                                                          i+(-2)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * (  1./280. ) * quant(m,a,b,k+( 2)*shiftxk + (-4)*shiftyk,
+                                                          j+( 2)*shiftxj + (-4)*shiftyj,
+                                                          i+( 2)*shiftxi + (-4)*shiftyi)
+              + (  -1./5.  ) * ( -1./280. ) * quant(m,a,b,k+( 2)*shiftxk + ( 4)*shiftyk,
+                                                          j+( 2)*shiftxj + ( 4)*shiftyj,
+                                                          i+( 2)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * ( -4./105. ) * quant(m,a,b,k+(-2)*shiftxk + (-3)*shiftyk,
+                                                          j+(-2)*shiftxj + (-3)*shiftyj,
+                                                          i+(-2)*shiftxi + (-3)*shiftyi)
+              + (   1./5.  ) * (  4./105. ) * quant(m,a,b,k+(-2)*shiftxk + ( 3)*shiftyk,
+                                                          j+(-2)*shiftxj + ( 3)*shiftyj,
+                                                          i+(-2)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * ( -4./105. ) * quant(m,a,b,k+( 2)*shiftxk + (-3)*shiftyk,
+                                                          j+( 2)*shiftxj + (-3)*shiftyj,
+                                                          i+( 2)*shiftxi + (-3)*shiftyi)
+              + (  -1./5.  ) * (  4./105. ) * quant(m,a,b,k+( 2)*shiftxk + ( 3)*shiftyk,
+                                                          j+( 2)*shiftxj + ( 3)*shiftyj,
+                                                          i+( 2)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * (   1./5.  ) * quant(m,a,b,k+(-2)*shiftxk + (-2)*shiftyk,
+                                                          j+(-2)*shiftxj + (-2)*shiftyj,
+                                                          i+(-2)*shiftxi + (-2)*shiftyi)
+              + (   1./5.  ) * (  -1./5.  ) * quant(m,a,b,k+(-2)*shiftxk + ( 2)*shiftyk,
+                                                          j+(-2)*shiftxj + ( 2)*shiftyj,
+                                                          i+(-2)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * (   1./5.  ) * quant(m,a,b,k+( 2)*shiftxk + (-2)*shiftyk,
+                                                          j+( 2)*shiftxj + (-2)*shiftyj,
+                                                          i+( 2)*shiftxi + (-2)*shiftyi)
+              + (  -1./5.  ) * (  -1./5.  ) * quant(m,a,b,k+( 2)*shiftxk + ( 2)*shiftyk,
+                                                          j+( 2)*shiftxj + ( 2)*shiftyj,
+                                                          i+( 2)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (   1./5.  ) * (  -4./5.  ) * quant(m,a,b,k+(-2)*shiftxk + (-1)*shiftyk,
+                                                          j+(-2)*shiftxj + (-1)*shiftyj,
+                                                          i+(-2)*shiftxi + (-1)*shiftyi)
+              + (   1./5.  ) * (   4./5.  ) * quant(m,a,b,k+(-2)*shiftxk + ( 1)*shiftyk,
+                                                          j+(-2)*shiftxj + ( 1)*shiftyj,
+                                                          i+(-2)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + (  -1./5.  ) * (  -4./5.  ) * quant(m,a,b,k+( 2)*shiftxk + (-1)*shiftyk,
+                                                          j+( 2)*shiftxj + (-1)*shiftyj,
+                                                          i+( 2)*shiftxi + (-1)*shiftyi)
+              + (  -1./5.  ) * (   4./5.  ) * quant(m,a,b,k+( 2)*shiftxk + ( 1)*shiftyk,
+                                                          j+( 2)*shiftxj + ( 1)*shiftyj,
+                                                          i+( 2)*shiftxi + ( 1)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * (  1./280. ) * quant(m,a,b,k+(-1)*shiftxk + (-4)*shiftyk,
+                                                          j+(-1)*shiftxj + (-4)*shiftyj,
+                                                          i+(-1)*shiftxi + (-4)*shiftyi)
+              + (  -4./5.  ) * ( -1./280. ) * quant(m,a,b,k+(-1)*shiftxk + ( 4)*shiftyk,
+                                                          j+(-1)*shiftxj + ( 4)*shiftyj,
+                                                          i+(-1)*shiftxi + ( 4)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * (  1./280. ) * quant(m,a,b,k+( 1)*shiftxk + (-4)*shiftyk,
+                                                          j+( 1)*shiftxj + (-4)*shiftyj,
+                                                          i+( 1)*shiftxi + (-4)*shiftyi)
+              + (   4./5.  ) * ( -1./280. ) * quant(m,a,b,k+( 1)*shiftxk + ( 4)*shiftyk,
+                                                          j+( 1)*shiftxj + ( 4)*shiftyj,
+                                                          i+( 1)*shiftxi + ( 4)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * ( -4./105. ) * quant(m,a,b,k+(-1)*shiftxk + (-3)*shiftyk,
+                                                          j+(-1)*shiftxj + (-3)*shiftyj,
+                                                          i+(-1)*shiftxi + (-3)*shiftyi)
+              + (  -4./5.  ) * (  4./105. ) * quant(m,a,b,k+(-1)*shiftxk + ( 3)*shiftyk,
+                                                          j+(-1)*shiftxj + ( 3)*shiftyj,
+                                                          i+(-1)*shiftxi + ( 3)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * ( -4./105. ) * quant(m,a,b,k+( 1)*shiftxk + (-3)*shiftyk,
+                                                          j+( 1)*shiftxj + (-3)*shiftyj,
+                                                          i+( 1)*shiftxi + (-3)*shiftyi)
+              + (   4./5.  ) * (  4./105. ) * quant(m,a,b,k+( 1)*shiftxk + ( 3)*shiftyk,
+                                                          j+( 1)*shiftxj + ( 3)*shiftyj,
+                                                          i+( 1)*shiftxi + ( 3)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * (   1./5.  ) * quant(m,a,b,k+(-1)*shiftxk + (-2)*shiftyk,
+                                                          j+(-1)*shiftxj + (-2)*shiftyj,
+                                                          i+(-1)*shiftxi + (-2)*shiftyi)
+              + (  -4./5.  ) * (  -1./5.  ) * quant(m,a,b,k+(-1)*shiftxk + ( 2)*shiftyk,
+                                                          j+(-1)*shiftxj + ( 2)*shiftyj,
+                                                          i+(-1)*shiftxi + ( 2)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * (   1./5.  ) * quant(m,a,b,k+( 1)*shiftxk + (-2)*shiftyk,
+                                                          j+( 1)*shiftxj + (-2)*shiftyj,
+                                                          i+( 1)*shiftxi + (-2)*shiftyi)
+              + (   4./5.  ) * (  -1./5.  ) * quant(m,a,b,k+( 1)*shiftxk + ( 2)*shiftyk,
+                                                          j+( 1)*shiftxj + ( 2)*shiftyj,
+                                                          i+( 1)*shiftxi + ( 2)*shiftyi)
+              )
+            )
+          + (
+            + (
+              + (  -4./5.  ) * (  -4./5.  ) * quant(m,a,b,k+(-1)*shiftxk + (-1)*shiftyk,
+                                                          j+(-1)*shiftxj + (-1)*shiftyj,
+                                                          i+(-1)*shiftxi + (-1)*shiftyi)
+              + (  -4./5.  ) * (   4./5.  ) * quant(m,a,b,k+(-1)*shiftxk + ( 1)*shiftyk,
+                                                          j+(-1)*shiftxj + ( 1)*shiftyj,
+                                                          i+(-1)*shiftxi + ( 1)*shiftyi)
+              )
+            + (
+              + (   4./5.  ) * (  -4./5.  ) * quant(m,a,b,k+( 1)*shiftxk + (-1)*shiftyk,
+                                                          j+( 1)*shiftxj + (-1)*shiftyj,
+                                                          i+( 1)*shiftxi + (-1)*shiftyi)
+              + (   4./5.  ) * (   4./5.  ) * quant(m,a,b,k+( 1)*shiftxk + ( 1)*shiftyk,
+                                                          j+( 1)*shiftxj + ( 1)*shiftyj,
+                                                          i+( 1)*shiftxi + ( 1)*shiftyi)
+              )
+            );
   }
   return out*idx[dirx]*idx[diry];
 }
@@ -1303,6 +2329,61 @@ Real Lx(int const dir,
                    +1./30.   * quant(m,k+(-2)*shiftk,
                                        j+(-2)*shiftj,
                                        i+(-2)*shifti);
+  } else if constexpr ( NGHOST == 5 ) {
+    dl = -1./280.  * quant(m,k+(-5)*shiftk,
+                             j+(-5)*shiftj,
+                             i+(-5)*shifti)
+                   +1./28.   * quant(m,k+(-4)*shiftk,
+                                       j+(-4)*shiftj,
+                                       i+(-4)*shifti)
+                    -1./6.   * quant(m,k+(-3)*shiftk,
+                                       j+(-3)*shiftj,
+                                       i+(-3)*shifti)
+                    +1./2.   * quant(m,k+(-2)*shiftk,
+                                       j+(-2)*shiftj,
+                                       i+(-2)*shifti)
+                    -5./4.   * quant(m,k+(-1)*shiftk,
+                                       j+(-1)*shiftj,
+                                       i+(-1)*shifti)
+                   +9./20.   * quant(m,k,
+                                       j,
+                                       i)
+                    +1./2.   * quant(m,k+(1)*shiftk,
+                                       j+(1)*shiftj,
+                                       i+(1)*shifti)
+                   -1./14.   * quant(m,k+(2)*shiftk,
+                                       j+(2)*shiftj,
+                                       i+(2)*shifti)
+                   +1./168.  * quant(m,k+(3)*shiftk,
+                                       j+(3)*shiftj,
+                                       i+(3)*shifti);
+    dr = +1./280.  * quant(m,k+(5)*shiftk,
+                             j+(5)*shiftj,
+                             i+(5)*shifti)
+                   -1./28.   * quant(m,k+(4)*shiftk,
+                                       j+(4)*shiftj,
+                                       i+(4)*shifti)
+                    +1./6.   * quant(m,k+(3)*shiftk,
+                                       j+(3)*shiftj,
+                                       i+(3)*shifti)
+                    -1./2.   * quant(m,k+(2)*shiftk,
+                                       j+(2)*shiftj,
+                                       i+(2)*shifti)
+                    +5./4.   * quant(m,k+(1)*shiftk,
+                                       j+(1)*shiftj,
+                                       i+(1)*shifti)
+                   -9./20.   * quant(m,k,
+                                       j,
+                                       i)
+                    -1./2.   * quant(m,k+(-1)*shiftk,
+                                       j+(-1)*shiftj,
+                                       i+(-1)*shifti)
+                   +1./14.   * quant(m,k+(-2)*shiftk,
+                                       j+(-2)*shiftj,
+                                       i+(-2)*shifti)
+                   -1./168.  * quant(m,k+(-3)*shiftk,
+                                       j+(-3)*shiftj,
+                                       i+(-3)*shifti);
   }
   return ((vx(m,a,k,j,i) < 0) ? (vx(m,a,k,j,i) * dl) : (vx(m,a,k,j,i) * dr)) * idx[dir];
 }
@@ -1414,6 +2495,61 @@ Real Lx(int const dir,
                    +1./30.   * quant(m,b,k+(-2)*shiftk,
                                          j+(-2)*shiftj,
                                          i+(-2)*shifti);
+  } else if constexpr ( NGHOST == 5 ) {
+    dl = -1./280.  * quant(m,b,k+(-5)*shiftk,
+                               j+(-5)*shiftj,
+                               i+(-5)*shifti)
+                   +1./28.   * quant(m,b,k+(-4)*shiftk,
+                                         j+(-4)*shiftj,
+                                         i+(-4)*shifti)
+                    -1./6.   * quant(m,b,k+(-3)*shiftk,
+                                         j+(-3)*shiftj,
+                                         i+(-3)*shifti)
+                    +1./2.   * quant(m,b,k+(-2)*shiftk,
+                                         j+(-2)*shiftj,
+                                         i+(-2)*shifti)
+                    -5./4.   * quant(m,b,k+(-1)*shiftk,
+                                         j+(-1)*shiftj,
+                                         i+(-1)*shifti)
+                   +9./20.   * quant(m,b,k,
+                                         j,
+                                         i)
+                    +1./2.   * quant(m,b,k+(1)*shiftk,
+                                         j+(1)*shiftj,
+                                         i+(1)*shifti)
+                   -1./14.   * quant(m,b,k+(2)*shiftk,
+                                         j+(2)*shiftj,
+                                         i+(2)*shifti)
+                   +1./168.  * quant(m,b,k+(3)*shiftk,
+                                         j+(3)*shiftj,
+                                         i+(3)*shifti);
+    dr = +1./280.  * quant(m,b,k+(5)*shiftk,
+                               j+(5)*shiftj,
+                               i+(5)*shifti)
+                   -1./28.   * quant(m,b,k+(4)*shiftk,
+                                         j+(4)*shiftj,
+                                         i+(4)*shifti)
+                    +1./6.   * quant(m,b,k+(3)*shiftk,
+                                         j+(3)*shiftj,
+                                         i+(3)*shifti)
+                    -1./2.   * quant(m,b,k+(2)*shiftk,
+                                         j+(2)*shiftj,
+                                         i+(2)*shifti)
+                    +5./4.   * quant(m,b,k+(1)*shiftk,
+                                         j+(1)*shiftj,
+                                         i+(1)*shifti)
+                   -9./20.   * quant(m,b,k,
+                                         j,
+                                         i)
+                    -1./2.   * quant(m,b,k+(-1)*shiftk,
+                                         j+(-1)*shiftj,
+                                         i+(-1)*shifti)
+                   +1./14.   * quant(m,b,k+(-2)*shiftk,
+                                         j+(-2)*shiftj,
+                                         i+(-2)*shifti)
+                   -1./168.  * quant(m,b,k+(-3)*shiftk,
+                                         j+(-3)*shiftj,
+                                         i+(-3)*shifti);
   }
   return ((vx(m,a,k,j,i) < 0) ? (vx(m,a,k,j,i) * dl) : (vx(m,a,k,j,i) * dr)) * idx[dir];
 }
@@ -1525,6 +2661,61 @@ Real Lx(int const dir,
                    +1./30.   * quant(m,b,c,k+(-2)*shiftk,
                                            j+(-2)*shiftj,
                                            i+(-2)*shifti);
+  } else if constexpr ( NGHOST == 5 ) {
+    dl = -1./280.  * quant(m,b,c,k+(-5)*shiftk,
+                                 j+(-5)*shiftj,
+                                 i+(-5)*shifti)
+                   +1./28.   * quant(m,b,c,k+(-4)*shiftk,
+                                           j+(-4)*shiftj,
+                                           i+(-4)*shifti)
+                    -1./6.   * quant(m,b,c,k+(-3)*shiftk,
+                                           j+(-3)*shiftj,
+                                           i+(-3)*shifti)
+                    +1./2.   * quant(m,b,c,k+(-2)*shiftk,
+                                           j+(-2)*shiftj,
+                                           i+(-2)*shifti)
+                    -5./4.   * quant(m,b,c,k+(-1)*shiftk,
+                                           j+(-1)*shiftj,
+                                           i+(-1)*shifti)
+                   +9./20.   * quant(m,b,c,k,
+                                           j,
+                                           i)
+                    +1./2.   * quant(m,b,c,k+(1)*shiftk,
+                                           j+(1)*shiftj,
+                                           i+(1)*shifti)
+                   -1./14.   * quant(m,b,c,k+(2)*shiftk,
+                                           j+(2)*shiftj,
+                                           i+(2)*shifti)
+                   +1./168.  * quant(m,b,c,k+(3)*shiftk,
+                                           j+(3)*shiftj,
+                                           i+(3)*shifti);
+    dr = +1./280.  * quant(m,b,c,k+(5)*shiftk,
+                                 j+(5)*shiftj,
+                                 i+(5)*shifti)
+                   -1./28.   * quant(m,b,c,k+(4)*shiftk,
+                                           j+(4)*shiftj,
+                                           i+(4)*shifti)
+                    +1./6.   * quant(m,b,c,k+(3)*shiftk,
+                                           j+(3)*shiftj,
+                                           i+(3)*shifti)
+                    -1./2.   * quant(m,b,c,k+(2)*shiftk,
+                                           j+(2)*shiftj,
+                                           i+(2)*shifti)
+                    +5./4.   * quant(m,b,c,k+(1)*shiftk,
+                                           j+(1)*shiftj,
+                                           i+(1)*shifti)
+                   -9./20.   * quant(m,b,c,k,
+                                           j,
+                                           i)
+                    -1./2.   * quant(m,b,c,k+(-1)*shiftk,
+                                           j+(-1)*shiftj,
+                                           i+(-1)*shifti)
+                   +1./14.   * quant(m,b,c,k+(-2)*shiftk,
+                                           j+(-2)*shiftj,
+                                           i+(-2)*shifti)
+                   -1./168.  * quant(m,b,c,k+(-3)*shiftk,
+                                           j+(-3)*shiftj,
+                                           i+(-3)*shifti);
   }
   return ((vx(m,a,k,j,i) < 0) ? (vx(m,a,k,j,i) * dl) : (vx(m,a,k,j,i) * dr)) * idx[dir];
 }
@@ -1608,6 +2799,40 @@ Real Diss(int const dir,
                 +70.    * quant(m,a,k,
                                     j,
                                     i);
+  } else if constexpr ( NGHOST == 5 ) {
+    out = + (     +1.   * quant(m,a,k+(-5)*shiftk,
+                                    j+(-5)*shiftj,
+                                    i+(-5)*shifti)
+                  +1.   * quant(m,a,k+( 5)*shiftk,
+                                    j+( 5)*shiftj,
+                                    i+( 5)*shifti))
+          + (    -10.   * quant(m,a,k+(-4)*shiftk,
+                                    j+(-4)*shiftj,
+                                    i+(-4)*shifti)
+                 -10.   * quant(m,a,k+( 4)*shiftk,
+                                    j+( 4)*shiftj,
+                                    i+( 4)*shifti))
+          + (    +45.   * quant(m,a,k+(-3)*shiftk,
+                                    j+(-3)*shiftj,
+                                    i+(-3)*shifti)
+                 +45.   * quant(m,a,k+( 3)*shiftk,
+                                    j+( 3)*shiftj,
+                                    i+( 3)*shifti))
+          + (   -120.   * quant(m,a,k+(-2)*shiftk,
+                                    j+(-2)*shiftj,
+                                    i+(-2)*shifti)
+                -120.   * quant(m,a,k+( 2)*shiftk,
+                                    j+( 2)*shiftj,
+                                    i+( 2)*shifti))
+          + (   +210.   * quant(m,a,k+(-1)*shiftk,
+                                    j+(-1)*shiftj,
+                                    i+(-1)*shifti)
+                +210.   * quant(m,a,k+( 1)*shiftk,
+                                    j+( 1)*shiftj,
+                                    i+( 1)*shifti))
+                -252.   * quant(m,a,k,
+                                    j,
+                                    i);
   }
   return out*idx[dir];
 }
@@ -0,0 +1,127 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file host_tasks.cpp
+//! \brief Implements the pool of host threads for diagnostics.  Tasks are taken from a
+//! single FIFO queue, so a task waiting for the task submitted before it (its "after"
+//! future) never waits for a task that has not been started.
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "utils/host_tasks.hpp"
+
+namespace host_tasks {
+
+namespace {
+struct PoolState {
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> queue;
+  std::mutex mtx;
+  std::condition_variable work_cv;  // signalled when tasks are queued, or on Finish()
+  std::condition_variable idle_cv;  // signalled when a task completes
+  int nbusy = 0;                    // number of tasks being run
+  bool stop = false;
+  ~PoolState() {Finish();}
+} state;
+
+void WorkerLoop() {
+  std::unique_lock<std::mutex> lock(state.mtx);
+  while (true) {
+    state.work_cv.wait(lock, [] {return state.stop || !state.queue.empty();});
+    if (state.queue.empty()) {return;}
+    std::function<void()> task = std::move(state.queue.front());
+    state.queue.pop_front();
+    state.nbusy++;
+    lock.unlock();
+    task();
+    lock.lock();
+    state.nbusy--;
+    state.idle_cv.notify_all();
+  }
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void host_tasks::Enable()
+
+void Enable(int nthreads) {
+  std::lock_guard<std::mutex> lock(state.mtx);
+  state.stop = false;
+  for (int n=0; n<nthreads; ++n) {
+    state.workers.emplace_back(WorkerLoop);
+  }
+}
+
+bool Enabled() {
+  return !(state.workers.empty());
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::shared_future<void> host_tasks::Submit()
+//! \brief Exceptions thrown by a task are stored in its future, and rethrown by Wait()
+
+std::shared_future<void> Submit(std::function<void()> task,
+                                std::shared_future<void> after) {
+  auto ptask = std::make_shared<std::packaged_task<void()>>(
+      [task = std::move(task), after]() {
+        if (after.valid()) {after.wait();}
+        task();
+      });
+  std::shared_future<void> f = ptask->get_future().share();
+  if (!Enabled()) {
+    (*ptask)();
+    return f;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state.mtx);
+    state.queue.emplace_back([ptask]() {(*ptask)();});
+  }
+  state.work_cv.notify_one();
+  return f;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void host_tasks::Wait()
+
+void Wait(std::shared_future<void> &f) {
+  if (f.valid()) {
+    std::shared_future<void> g = std::move(f);
+    f = std::shared_future<void>();
+    g.get();
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void host_tasks::Join()
+
+void Join() {
+  std::unique_lock<std::mutex> lock(state.mtx);
+  state.idle_cv.wait(lock, [] {return state.queue.empty() && state.nbusy == 0;});
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void host_tasks::Finish()
+
+void Finish() {
+  {
+    std::lock_guard<std::mutex> lock(state.mtx);
+    state.stop = true;
+  }
+  state.work_cv.notify_all();
+  for (auto &w : state.workers) {
+    if (w.joinable()) {w.join();}
+  }
+  state.workers.clear();
+}
+
+} // namespace host_tasks
@@ -0,0 +1,38 @@
+#ifndef UTILS_HOST_TASKS_HPP_
+#define UTILS_HOST_TASKS_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file host_tasks.hpp
+//! \brief Small pool of host threads for lightweight diagnostics (writing rows of
+//! history, event log, tracker and waveform files), so that the thread launching kernels
+//! does not wait for file I/O.
+//!
+//! Enabled with <job>/host_threads > 0.  Tasks must only use host data they own (usually
+//! copies captured by the task), and must not touch device memory or call MPI.  Each
+//! Submit() returns a future, which the owner of the data passes to Wait() before the
+//! data is changed or destroyed.  Passing the future of the previous task writing the
+//! same file as "after" keeps rows in order.  When not enabled, tasks are run
+//! immediately by the calling thread.
+
+#include <functional>
+#include <future>  // NOLINT(build/c++11)
+
+namespace host_tasks {
+// starts nthreads worker threads
+void Enable(int nthreads);
+bool Enabled();
+// queues task, which is run once the task that returned "after" (if any) has completed
+std::shared_future<void> Submit(std::function<void()> task,
+                                std::shared_future<void> after = {});
+// waits for the task that returned f (if any) to complete, and resets f
+void Wait(std::shared_future<void> &f);
+// waits for all queued tasks to complete
+void Join();
+// completes all queued tasks and stops the worker threads
+void Finish();
+} // namespace host_tasks
+
+#endif // UTILS_HOST_TASKS_HPP_
@@ -0,0 +1,286 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file id_sample_grid.cpp
+//  \brief Evaluates initial data from external libraries on a coarse uniform grid, and
+//  interpolates it to the MeshBlocks on the device
+
+// C/C++ headers
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// AthenaK headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "id_sample_grid.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn int LagrangeStencil()
+//! \brief Computes first index and weights of the np-point Lagrange interpolation stencil
+//! on the uniform grid xmin + i*dx (i=0,...,nx-1) for position x.  The stencil is
+//! centered on x where possible, and otherwise shifted to remain inside the grid.
+
+KOKKOS_INLINE_FUNCTION
+int LagrangeStencil(const Real x, const Real xmin, const Real dx, const int nx,
+                    const int np, Real *w) {
+  int i0 = static_cast<int>(floor((x - xmin)/dx)) - (np/2 - 1);
+  i0 = (i0 < 0) ? 0 : i0;
+  i0 = (i0 > nx - np) ? (nx - np) : i0;
+  for (int a=0; a<np; ++a) {
+    Real xa = xmin + (i0 + a)*dx;
+    w[a] = 1.0;
+    for (int b=0; b<np; ++b) {
+      if (b != a) {
+        Real xb = xmin + (i0 + b)*dx;
+        w[a] *= (x - xb)/(xa - xb);
+      }
+    }
+  }
+  return i0;
+}
+
+//----------------------------------------------------------------------------------------
+// constructor, initializes data structures and parameters
+
+IDSampleGrid::IDSampleGrid(MeshBlockPack *ppack, ParameterInput *pin, std::string block,
+                           int nv) :
+    nvars(nv),
+    vals("id_sample_vals",1,1,1,1),
+    pmy_pack(ppack) {
+  auto &msize = pmy_pack->pmesh->mesh_size;
+  auto &mindcs = pmy_pack->pmesh->mesh_indcs;
+  int &ng = pmy_pack->pmesh->mb_indcs.ng;
+
+  // number of points
+  nx1 = pin->GetInteger(block, "id_sample_nx1");
+  nx2 = pin->GetInteger(block, "id_sample_nx2");
+  nx3 = pin->GetInteger(block, "id_sample_nx3");
+
+  // bounds default to the mesh plus the ghost cells of the root level, which contains
+  // the ghost cells of MeshBlocks on all levels
+  Real dx1 = (msize.x1max - msize.x1min)/static_cast<Real>(mindcs.nx1);
+  Real dx2 = (msize.x2max - msize.x2min)/static_cast<Real>(mindcs.nx2);
+  Real dx3 = (msize.x3max - msize.x3min)/static_cast<Real>(mindcs.nx3);
+  min_x1 = pin->GetOrAddReal(block, "id_sample_x1min", msize.x1min - ng*dx1);
+  max_x1 = pin->GetOrAddReal(block, "id_sample_x1max", msize.x1max + ng*dx1);
+  min_x2 = pin->GetOrAddReal(block, "id_sample_x2min", msize.x2min - ng*dx2);
+  max_x2 = pin->GetOrAddReal(block, "id_sample_x2max", msize.x2max + ng*dx2);
+  min_x3 = pin->GetOrAddReal(block, "id_sample_x3min", msize.x3min - ng*dx3);
+  max_x3 = pin->GetOrAddReal(block, "id_sample_x3max", msize.x3max + ng*dx3);
+
+  order = pin->GetOrAddInteger(block, "id_sample_order", 4);
+  cache_file = pin->GetOrAddString(block, "id_sample_cache", "");
+
+  if (order < 2 || order > NIDSAMPLE_ORDER) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<" << block << ">/id_sample_order=" << order
+              << " must be between 2 and " << NIDSAMPLE_ORDER << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (nx1 < order || nx2 < order || nx3 < order) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Initial data sample grid must have at least "
+              << "<" << block << ">/id_sample_order=" << order << " points in each "
+              << "direction" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // resolution
+  d_x1 = (max_x1 - min_x1)/(nx1 - 1);
+  d_x2 = (max_x2 - min_x2)/(nx2 - 1);
+  d_x3 = (max_x3 - min_x3)/(nx3 - 1);
+
+  Kokkos::realloc(vals, nvars, nx3, nx2, nx1);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void IDSampleGrid::Sample()
+//! \brief Fills sample grid, either from cache_file or by evaluating func.  The points
+//! are divided into contiguous ranges over all ranks, so that each rank evaluates only
+//! 1/nranks of the grid, and the results are then gathered on all ranks.
+
+void IDSampleGrid::Sample(IDSampleFunc func) {
+  if (ReadCache()) return;
+
+  // divide points over ranks
+  int npts = nx1*nx2*nx3;
+  int &nranks = global_variable::nranks;
+  int &my_rank = global_variable::my_rank;
+  std::vector<int> counts(nranks), displs(nranks);
+  for (int r=0; r<nranks; ++r) {
+    displs[r] = static_cast<int>((static_cast<int64_t>(npts)*r)/nranks);
+  }
+  for (int r=0; r<nranks-1; ++r) {
+    counts[r] = displs[r+1] - displs[r];
+  }
+  counts[nranks-1] = npts - displs[nranks-1];
+  int p0 = displs[my_rank];
+  int np = counts[my_rank];
+
+  // evaluate data at points on this rank
+  if (np > 0) {
+    std::vector<Real> x(np), y(np), z(np), buf(static_cast<std::size_t>(nvars)*np);
+    for (int p=0; p<np; ++p) {
+      int ip = p0 + p;
+      int i = ip % nx1;
+      int j = (ip/nx1) % nx2;
+      int k = ip/(nx1*nx2);
+      x[p] = min_x1 + i*d_x1;
+      y[p] = min_x2 + j*d_x2;
+      z[p] = min_x3 + k*d_x3;
+    }
+    func(np, x.data(), y.data(), z.data(), buf.data());
+    for (int n=0; n<nvars; ++n) {
+      Real *pv = &(vals.h_view(n,0,0,0)) + p0;
+      for (int p=0; p<np; ++p) {
+        pv[p] = buf[static_cast<std::size_t>(n)*np + p];
+      }
+    }
+  }
+
+#if MPI_PARALLEL_ENABLED
+  // gather data at all points on all ranks
+  for (int n=0; n<nvars; ++n) {
+    MPI_Allgatherv(MPI_IN_PLACE, counts[my_rank], MPI_ATHENA_REAL,
+                   &(vals.h_view(n,0,0,0)), counts.data(), displs.data(),
+                   MPI_ATHENA_REAL, MPI_COMM_WORLD);
+  }
+#endif
+
+  // sync device array
+  vals.template modify<HostMemSpace>();
+  vals.template sync<DevExeSpace>();
+
+  WriteCache();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void IDSampleGrid::InterpolateToMesh()
+//! \brief Interpolates sampled data to all cells (including ghost cells) of MeshBlocks
+//! in this MeshBlockPack, on the device
+
+void IDSampleGrid::InterpolateToMesh(DvceArray5D<Real> &u) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &js = indcs.js, &ks = indcs.ks;
+  int mbnx1 = indcs.nx1, mbnx2 = indcs.nx2, mbnx3 = indcs.nx3;
+  int n1m1 = indcs.nx1 + 2*(indcs.ng) - 1;
+  int n2m1 = indcs.nx2 + 2*(indcs.ng) - 1;
+  int n3m1 = indcs.nx3 + 2*(indcs.ng) - 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto &size = pmy_pack->pmb->mb_size;
+
+  // capture class variables for kernel
+  auto &v = vals.d_view;
+  int nv = nvars, np = order;
+  int snx1 = nx1, snx2 = nx2, snx3 = nx3;
+  Real smin1 = min_x1, smin2 = min_x2, smin3 = min_x3;
+  Real sd1 = d_x1, sd2 = d_x2, sd3 = d_x3;
+
+  par_for("id_sample_interp", DevExeSpace(), 0, nmb1, 0, n3m1, 0, n2m1, 0, n1m1,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real x = CellCenterX(i-is, mbnx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real y = CellCenterX(j-js, mbnx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real z = CellCenterX(k-ks, mbnx3, size.d_view(m).x3min, size.d_view(m).x3max);
+
+    Real w1[NIDSAMPLE_ORDER], w2[NIDSAMPLE_ORDER], w3[NIDSAMPLE_ORDER];
+    int i0 = LagrangeStencil(x, smin1, sd1, snx1, np, w1);
+    int j0 = LagrangeStencil(y, smin2, sd2, snx2, np, w2);
+    int k0 = LagrangeStencil(z, smin3, sd3, snx3, np, w3);
+
+    for (int n=0; n<nv; ++n) {
+      Real val = 0.0;
+      for (int c=0; c<np; ++c) {
+        for (int b=0; b<np; ++b) {
+          Real w23 = w3[c]*w2[b];
+          for (int a=0; a<np; ++a) {
+            val += w23*w1[a]*v(n,k0+c,j0+b,i0+a);
+          }
+        }
+      }
+      u(n,m,k,j,i) = val;
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool IDSampleGrid::ReadCache()
+//! \brief Reads sampled data from cache_file on rank 0 and broadcasts it, if the file
+//! exists and was written for the same grid.  Returns true if data was read.
+
+bool IDSampleGrid::ReadCache() {
+  if (cache_file.empty()) return false;
+  int npts = nx1*nx2*nx3;
+  int found = 0;
+  if (global_variable::my_rank == 0) {
+    std::FILE *pfile = std::fopen(cache_file.c_str(), "rb");
+    if (pfile != nullptr) {
+      int hdr[4];
+      Real bnds[6];
+      if (std::fread(hdr, sizeof(int), 4, pfile) == 4 &&
+          std::fread(bnds, sizeof(Real), 6, pfile) == 6 &&
+          hdr[0] == nvars && hdr[1] == nx1 && hdr[2] == nx2 && hdr[3] == nx3 &&
+          bnds[0] == min_x1 && bnds[1] == max_x1 && bnds[2] == min_x2 &&
+          bnds[3] == max_x2 && bnds[4] == min_x3 && bnds[5] == max_x3) {
+        std::size_t ndata = static_cast<std::size_t>(nvars)*npts;
+        if (std::fread(vals.h_view.data(), sizeof(Real), ndata, pfile) == ndata) {
+          found = 1;
+        }
+      }
+      std::fclose(pfile);
+      if (found == 0) {
+        std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Initial data cache '" << cache_file << "' does not "
+                  << "match sample grid, and will be overwritten" << std::endl;
+      } else {
+        std::cout << "Initial data read from cache '" << cache_file << "'" << std::endl;
+      }
+    }
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Bcast(&found, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (found == 1) {
+    for (int n=0; n<nvars; ++n) {
+      MPI_Bcast(&(vals.h_view(n,0,0,0)), npts, MPI_ATHENA_REAL, 0, MPI_COMM_WORLD);
+    }
+  }
+#endif
+  if (found == 1) {
+    vals.template modify<HostMemSpace>();
+    vals.template sync<DevExeSpace>();
+  }
+  return (found == 1);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void IDSampleGrid::WriteCache()
+//! \brief Writes sampled data to cache_file on rank 0
+
+void IDSampleGrid::WriteCache() {
+  if (cache_file.empty() || global_variable::my_rank != 0) return;
+  std::FILE *pfile = std::fopen(cache_file.c_str(), "wb");
+  if (pfile == nullptr) {
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Initial data cache '" << cache_file << "' could not be "
+              << "opened for writing" << std::endl;
+    return;
+  }
+  int hdr[4] = {nvars, nx1, nx2, nx3};
+  Real bnds[6] = {min_x1, max_x1, min_x2, max_x2, min_x3, max_x3};
+  std::size_t ndata = static_cast<std::size_t>(nvars)*nx1*nx2*nx3;
+  std::fwrite(hdr, sizeof(int), 4, pfile);
+  std::fwrite(bnds, sizeof(Real), 6, pfile);
+  std::fwrite(vals.h_view.data(), sizeof(Real), ndata, pfile);
+  std::fclose(pfile);
+  return;
+}
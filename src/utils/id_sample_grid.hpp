@@ -0,0 +1,70 @@
+#ifndef UTILS_ID_SAMPLE_GRID_HPP_
+#define UTILS_ID_SAMPLE_GRID_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file id_sample_grid.hpp
+//  \brief definitions for IDSampleGrid class, used to import initial data computed by
+//  external (CPU-only) libraries.  Rather than calling the library for every cell of
+//  every MeshBlock, the data is evaluated once on a coarse uniform sample grid (with the
+//  points distributed over all ranks), optionally cached to disk, and then interpolated
+//  to all cells of the MeshBlocks on the device with Lagrange polynomials.
+//
+//  Parameters (read from the input block given to the constructor):
+//    id_sample_nx1/2/3     number of sample points in each direction
+//    id_sample_x1min/...   bounds of the sample grid (default: mesh plus ghost cells)
+//    id_sample_order       number of points in each direction of interpolation stencil
+//    id_sample_cache       file used to cache sampled data (default: none)
+
+#include <functional>
+#include <string>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+
+// maximum number of points in each direction of interpolation stencil
+#define NIDSAMPLE_ORDER 8
+
+// Forward declarations
+class MeshBlockPack;
+
+// Function evaluating the data at npts points (x[p],y[p],z[p]) in code units.  Value of
+// variable n at point p must be stored in vals[n*npts + p].
+using IDSampleFunc = std::function<void(int npts, const Real *x, const Real *y,
+                                        const Real *z, Real *vals)>;
+
+//----------------------------------------------------------------------------------------
+//! \class IDSampleGrid
+
+class IDSampleGrid {
+ public:
+  IDSampleGrid(MeshBlockPack *pmy_pack, ParameterInput *pin, std::string block, int nv);
+
+  // parameters for the grid
+  int nvars;                         // number of variables
+  int nx1, nx2, nx3;                 // number of points
+  Real min_x1, min_x2, min_x3;       // coordinates of first point
+  Real max_x1, max_x2, max_x3;       // coordinates of last point
+  Real d_x1, d_x2, d_x3;             // spacing
+  int order;                         // number of points in interpolation stencil
+  std::string cache_file;            // file storing sampled data ("" if none)
+
+  DualArray4D<Real> vals;            // sampled data (nvars, nx3, nx2, nx1)
+
+  // read data from cache_file if it matches this grid, or else evaluate func over all
+  // ranks (and save data to cache_file)
+  void Sample(IDSampleFunc func);
+  // interpolate data to all cells (including ghosts) of MeshBlocks in this pack.  Array
+  // must have dimensions (nvars, nmb, ncells3, ncells2, ncells1), so that each variable
+  // is stored contiguously with the flat (m,k,j,i) index used by the pgens
+  void InterpolateToMesh(DvceArray5D<Real> &u);
+
+ private:
+  MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this grid
+  bool ReadCache();
+  void WriteCache();
+};
+
+#endif // UTILS_ID_SAMPLE_GRID_HPP_
@@ -0,0 +1,259 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file memory_tracker.cpp
+//! \brief Implements per-module accounting of memory allocated through Kokkos Views
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "utils/memory_tracker.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace memory_tracker {
+
+namespace {
+// bytes currently allocated, and peak, in device and host memory by one scope
+struct ScopeUsage {
+  std::int64_t dvce = 0, dvce_peak = 0;
+  std::int64_t host = 0, host_peak = 0;
+};
+// a live allocation
+struct Allocation {
+  ScopeUsage *scope;
+  std::int64_t bytes;
+  bool dvce;
+};
+
+bool enabled = false;
+ScopeUsage *current = nullptr;
+ScopeUsage total;  // all scopes
+// std::map is ordered by name, so scopes are in the same order on every rank
+std::map<std::string, ScopeUsage> usage;
+std::unordered_map<const void*, Allocation> live;
+
+// host<->device copies of one call site
+struct Transfer {
+  std::int64_t bytes_cycle = 0;  // in current cycle
+  std::int64_t bytes = 0, bytes_max = 0;  // total, and maximum in one cycle
+  std::int64_t ncopy = 0;        // number of copies
+  int ncycle = 0;                // number of cycles with copies
+};
+// indexed by direction and label, e.g. "D2H refine_flag"
+std::map<std::string, Transfer> transfers;
+int ncycle_counted = 0;
+
+void Allocate(const Kokkos::Tools::SpaceHandle handle, const char *label,
+              const void *ptr, const std::uint64_t size) {
+  if (current == nullptr || ptr == nullptr) return;
+  Allocation a;
+  a.scope = current;
+  a.bytes = static_cast<std::int64_t>(size);
+  a.dvce = (std::strcmp(handle.name, DevMemSpace::name()) == 0);
+  if (a.dvce) {
+    current->dvce += a.bytes;
+    if (current->dvce > current->dvce_peak) {current->dvce_peak = current->dvce;}
+    total.dvce += a.bytes;
+    if (total.dvce > total.dvce_peak) {total.dvce_peak = total.dvce;}
+  } else {
+    current->host += a.bytes;
+    if (current->host > current->host_peak) {current->host_peak = current->host;}
+  }
+  live[ptr] = a;
+}
+
+void Deallocate(const Kokkos::Tools::SpaceHandle handle, const char *label,
+                const void *ptr, const std::uint64_t size) {
+  auto it = live.find(ptr);
+  if (it == live.end()) return;  // allocated before tracking was enabled
+  Allocation &a = it->second;
+  if (a.dvce) {
+    a.scope->dvce -= a.bytes;
+    total.dvce -= a.bytes;
+  } else {
+    a.scope->host -= a.bytes;
+  }
+  live.erase(it);
+}
+
+void BeginDeepCopy(const Kokkos::Tools::SpaceHandle dst_handle, const char *dst_name,
+                   const void *dst_ptr, const Kokkos::Tools::SpaceHandle src_handle,
+                   const char *src_name, const void *src_ptr, const std::uint64_t size) {
+  bool dst_dvce = (std::strcmp(dst_handle.name, DevMemSpace::name()) == 0);
+  bool src_dvce = (std::strcmp(src_handle.name, DevMemSpace::name()) == 0);
+  if (dst_dvce == src_dvce || size == 0) return;
+  std::string key = (dst_dvce)? (std::string("H2D ") + dst_name) :
+                                (std::string("D2H ") + src_name);
+  Transfer &t = transfers[key];
+  t.bytes_cycle += static_cast<std::int64_t>(size);
+  t.ncopy++;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void Enable()
+//! \brief registers allocation callbacks with Kokkos.  Views allocated before this call
+//! are not counted.
+
+void Enable() {
+  if (enabled) return;
+  enabled = true;
+  SetScope("other");
+  Kokkos::Tools::Experimental::set_allocate_data_callback(Allocate);
+  Kokkos::Tools::Experimental::set_deallocate_data_callback(Deallocate);
+  Kokkos::Tools::Experimental::set_begin_deep_copy_callback(BeginDeepCopy);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SetScope()
+
+void SetScope(const std::string &name) {
+  if (!(enabled)) return;
+  current = &usage[name];
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Report()
+//! \brief prints current and peak memory of each scope in MB, maximum over all ranks
+
+void Report(const std::string &when) {
+  if (!(enabled)) return;
+  std::vector<double> mb;
+  for (auto &it : usage) {
+    mb.push_back(static_cast<double>(it.second.dvce)/1048576.0);
+    mb.push_back(static_cast<double>(it.second.dvce_peak)/1048576.0);
+    mb.push_back(static_cast<double>(it.second.host)/1048576.0);
+    mb.push_back(static_cast<double>(it.second.host_peak)/1048576.0);
+  }
+#if MPI_PARALLEL_ENABLED
+  std::vector<double> mb_max(mb.size());
+  MPI_Reduce(mb.data(), mb_max.data(), mb.size(), MPI_DOUBLE, MPI_MAX, 0,
+             MPI_COMM_WORLD);
+  mb = mb_max;
+#endif
+  if (global_variable::my_rank != 0) return;
+
+  std::cout << std::endl << "Memory allocated per module " << when
+            << " (MB, maximum over ranks):" << std::endl;
+  std::printf("  %-16s %12s %12s %12s %12s\n", "module", "device", "device peak",
+              "host", "host peak");
+  double total[4] = {0.0, 0.0, 0.0, 0.0};
+  int n = 0;
+  for (auto &it : usage) {
+    std::printf("  %-16s %12.1f %12.1f %12.1f %12.1f\n", it.first.c_str(),
+                mb[4*n], mb[4*n+1], mb[4*n+2], mb[4*n+3]);
+    for (int l=0; l<4; ++l) {total[l] += mb[4*n+l];}
+    ++n;
+  }
+  std::printf("  %-16s %12.1f %12.1f %12.1f %12.1f\n", "total",
+              total[0], total[1], total[2], total[3]);
+  std::cout << std::flush;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn double TakeDevicePeak()
+//! \brief the peak is reset to the memory currently allocated, so that successive calls
+//! measure the peak of each phase of the run
+
+double TakeDevicePeak() {
+  if (!(enabled)) return 0.0;
+  double mb = static_cast<double>(total.dvce_peak)/1048576.0;
+  total.dvce_peak = total.dvce;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &mb, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  return mb;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ResetTransfers()
+
+void ResetTransfers() {
+  if (!(enabled)) return;
+  transfers.clear();
+  ncycle_counted = 0;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void EndCycle()
+
+void EndCycle() {
+  if (!(enabled)) return;
+  for (auto &it : transfers) {
+    Transfer &t = it.second;
+    if (t.bytes_cycle > 0) {
+      t.bytes += t.bytes_cycle;
+      t.bytes_max = std::max(t.bytes_max, t.bytes_cycle);
+      t.ncycle++;
+      t.bytes_cycle = 0;
+    }
+  }
+  ncycle_counted++;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ReportTransfers()
+//! \brief Call sites are those of rank 0, sorted by bytes transferred.  The total over
+//! all call sites, and the peak device memory, are also given as mean and maximum over
+//! ranks (with the rank of the maximum), since copies made by only some ranks are
+//! otherwise missed.
+
+void ReportTransfers() {
+  if (!(enabled)) return;
+  double my_data[2] = {0.0, static_cast<double>(total.dvce_peak)/1048576.0};
+  for (auto &it : transfers) {my_data[0] += static_cast<double>(it.second.bytes);}
+  my_data[0] /= 1048576.0*std::max(ncycle_counted, 1);
+  std::vector<double> data(2*global_variable::nranks);
+#if MPI_PARALLEL_ENABLED
+  MPI_Gather(my_data, 2, MPI_DOUBLE, data.data(), 2, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#else
+  data[0] = my_data[0];
+  data[1] = my_data[1];
+#endif
+  if (global_variable::my_rank != 0) return;
+
+  std::vector<std::pair<std::int64_t, std::string>> sites;
+  for (auto &it : transfers) {sites.emplace_back(it.second.bytes, it.first);}
+  std::sort(sites.rbegin(), sites.rend());
+  int nc = std::max(ncycle_counted, 1);
+  std::cout << std::endl << "Host<->device transfers in " << ncycle_counted
+            << " cycles by label of View (rank 0):" << std::endl;
+  std::printf("  %-36s %12s %12s %10s %10s\n", "label", "MB/cycle", "max MB/cycle",
+              "copies", "cycles");
+  for (auto &s : sites) {
+    Transfer &t = transfers[s.second];
+    std::printf("  %-36s %12.3f %12.3f %10" PRId64 " %10d\n", s.second.c_str(),
+                static_cast<double>(t.bytes)/1048576.0/nc,
+                static_cast<double>(t.bytes_max)/1048576.0, t.ncopy, t.ncycle);
+  }
+  std::printf("\n  %-24s %12s %12s %8s\n", "all ranks", "mean", "max", "rank");
+  const char *names[2] = {"transfers (MB/cycle)", "device peak (MB)"};
+  for (int l=0; l<2; ++l) {
+    double mean = 0.0;
+    int nmax = 0;
+    for (int n=0; n<global_variable::nranks; ++n) {
+      mean += data[2*n+l]/global_variable::nranks;
+      if (data[2*n+l] > data[2*nmax+l]) {nmax = n;}
+    }
+    std::printf("  %-24s %12.3f %12.3f %8d\n", names[l], mean, data[2*nmax+l], nmax);
+  }
+  std::cout << std::flush;
+}
+
+} // namespace memory_tracker
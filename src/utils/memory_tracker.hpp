@@ -0,0 +1,44 @@
+#ifndef UTILS_MEMORY_TRACKER_HPP_
+#define UTILS_MEMORY_TRACKER_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file memory_tracker.hpp
+//! \brief Accounting of memory allocated through Kokkos Views, per physics module.
+//!
+//! Enabled with <job>/memory_report = true.  Allocation and deallocation callbacks are
+//! then registered with Kokkos, and every View allocated is attributed to the current
+//! "scope" (set to the name of each physics module while it is constructed).  Report()
+//! prints the memory currently allocated, and the peak, in device and host memory for
+//! each scope (maximum over ranks).
+//!
+//! Copies between host and device memory (deep_copy, including those made by DualView
+//! sync and modify) are also counted through the deep-copy callback of Kokkos, by the
+//! label of the View copied to or from the device, which identifies the call site.
+//! EndCycle() closes the accounting of each cycle, so that ReportTransfers() can show
+//! which copies happen every cycle.  When not enabled all functions do nothing.
+
+#include <string>
+
+namespace memory_tracker {
+void Enable();
+// attributes Views allocated from now on to scope name.  Must be called in the same
+// order on all ranks, so that Report() can reduce over scopes.
+void SetScope(const std::string &name);
+// prints memory per scope on rank 0. Collective over all ranks.
+void Report(const std::string &when);
+// peak device memory (MB) allocated in all scopes since the previous call, maximum over
+// ranks.  Collective over all ranks.  Returns zero when not enabled.
+double TakeDevicePeak();
+// discards transfers counted so far, e.g. those made to set up the run
+void ResetTransfers();
+// called at the end of every cycle of the main loop
+void EndCycle();
+// prints host<->device transfers per cycle by call site, and peak device memory of each
+// rank, on rank 0.  Collective over all ranks.
+void ReportTransfers();
+} // namespace memory_tracker
+
+#endif // UTILS_MEMORY_TRACKER_HPP_
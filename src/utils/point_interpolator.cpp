@@ -0,0 +1,345 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file point_interpolator.cpp
+//! \brief implementation of batched interpolation of variables to arbitrary points
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/point_interpolator.hpp"
+
+//----------------------------------------------------------------------------------------
+// constructor
+
+PointInterpolator::PointInterpolator(MeshBlockPack *pp, int nst) :
+  npoints(0),
+  nstencil(nst),
+  vals("interp_vals",1,1),
+  pmy_pack(pp),
+  mesh_version_(-1),
+  pos_("interp_pos",1,3),
+  nown_(0),
+  own_sorted_("interp_sorted",1),
+  own_indcs_("interp_indcs",1,4),
+  own_wghts_("interp_wghts",1,1,3),
+  vars_("interp_vars",1),
+  own_vals_("interp_own_vals",1,1) {
+  int ng = pp->pmesh->mb_indcs.ng;
+  if (nstencil == 0) {nstencil = 2*ng;}
+  if ((nstencil % 2) != 0 || nstencil > 2*ng || nstencil < 2) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Interpolation stencil of " << nstencil << " cells must be "
+              << "even, and at most twice the number of ghost cells" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_dup(MPI_COMM_WORLD, &comm_interp_);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+PointInterpolator::~PointInterpolator() {
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm_free(&comm_interp_);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int PointInterpolator::FindMeshBlock
+//! \brief Returns gid of MeshBlock containing point x, or -1 if x is outside the mesh.
+//! Descends the MeshBlockTree one level at a time until reaching a leaf.
+
+int PointInterpolator::FindMeshBlock(const Real x[3]) {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &ms = pm->mesh_size;
+  Real xmin[3] = {ms.x1min, ms.x2min, ms.x3min};
+  Real xmax[3] = {ms.x1max, ms.x2max, ms.x3max};
+  int nroot[3] = {pm->nmb_rootx1, pm->nmb_rootx2, pm->nmb_rootx3};
+  bool active[3] = {true, pm->multi_d, pm->three_d};
+  for (int d=0; d<3; ++d) {
+    if (active[d] && (x[d] < xmin[d] || x[d] > xmax[d])) return -1;
+  }
+
+  int gid = -1;
+  for (int l=pm->root_level; l<=pm->max_level; ++l) {
+    int lx[3] = {0, 0, 0};
+    for (int d=0; d<3; ++d) {
+      if (!(active[d])) continue;
+      int n = nroot[d] << (l - pm->root_level);
+      lx[d] = static_cast<int>(std::floor((x[d] - xmin[d])/(xmax[d] - xmin[d])*n));
+      lx[d] = std::min(std::max(lx[d], 0), n - 1);
+    }
+    LogicalLocation loc;
+    loc.lx1 = lx[0];
+    loc.lx2 = lx[1];
+    loc.lx3 = lx[2];
+    loc.level = l;
+    MeshBlockTree *pnode = pm->ptree->FindMeshBlock(loc);
+    if (pnode == nullptr) break;  // leaf was found at previous level
+    gid = pnode->GetGID();
+  }
+  return gid;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointInterpolator::SetPoints
+//! \brief Sets positions (npoints, 3) of points requested by this rank, and locates them
+
+void PointInterpolator::SetPoints(const HostArray2D<Real> &pos) {
+  npoints = pos.extent_int(0);
+  pos_ = HostArray2D<Real>("interp_pos", std::max(npoints, 1), 3);
+  for (int n=0; n<npoints; ++n) {
+    for (int d=0; d<3; ++d) {pos_(n,d) = pos(n,d);}
+  }
+  mesh_version_ = -1;
+  UpdatePoints();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointInterpolator::UpdatePoints
+//! \brief Finds owning MeshBlock of each requested point, sends points to owning ranks,
+//! and computes interpolation indices and weights of points owned by this rank.  Only
+//! repeated if MeshBlocks have changed (with AMR or load balancing) since last call.
+
+void PointInterpolator::UpdatePoints() {
+  Mesh *pm = pmy_pack->pmesh;
+  if (mesh_version_ == pm->mesh_version) return;
+  int nranks = global_variable::nranks;
+
+  // owner of each requested point, and position of point in buffer grouped by owner
+  std::vector<int> gids(npoints), nsend(nranks, 0), sstart(nranks, 0);
+  for (int n=0; n<npoints; ++n) {
+    Real x[3] = {pos_(n,0), pos_(n,1), pos_(n,2)};
+    gids[n] = FindMeshBlock(x);
+    if (gids[n] >= 0) {nsend[pm->rank_eachmb[gids[n]]]++;}
+  }
+  for (int r=1; r<nranks; ++r) {sstart[r] = sstart[r-1] + nsend[r-1];}
+  int nsend_total = sstart[nranks-1] + nsend[nranks-1];
+  std::vector<Real> sbuf(4*nsend_total);
+  std::vector<int> cursor(sstart);
+  req_order_.assign(npoints, -1);
+  for (int n=0; n<npoints; ++n) {
+    if (gids[n] < 0) continue;
+    int r = pm->rank_eachmb[gids[n]];
+    int p = cursor[r]++;
+    req_order_[n] = p;
+    sbuf[4*p] = static_cast<Real>(gids[n] - pm->gids_eachrank[r]);
+    for (int d=0; d<3; ++d) {sbuf[4*p + d + 1] = pos_(n,d);}
+  }
+  req_ranks_.clear();
+  req_count_.clear();
+  for (int r=0; r<nranks; ++r) {
+    if (nsend[r] > 0) {
+      req_ranks_.push_back(r);
+      req_count_.push_back(nsend[r]);
+    }
+  }
+
+  // send points to owning ranks
+  std::vector<int> nrecv(nranks, 0);
+#if MPI_PARALLEL_ENABLED
+  MPI_Alltoall(nsend.data(), 1, MPI_INT, nrecv.data(), 1, MPI_INT, comm_interp_);
+#else
+  nrecv[0] = nsend[0];
+#endif
+  own_ranks_.clear();
+  own_count_.clear();
+  nown_ = 0;
+  for (int r=0; r<nranks; ++r) {
+    if (nrecv[r] > 0) {
+      own_ranks_.push_back(r);
+      own_count_.push_back(nrecv[r]);
+      nown_ += nrecv[r];
+    }
+  }
+  std::vector<Real> rbuf(4*nown_);
+#if MPI_PARALLEL_ENABLED
+  std::vector<MPI_Request> req;
+  for (std::size_t i=0, p=0; i<own_ranks_.size(); p+=own_count_[i], ++i) {
+    req.emplace_back();
+    MPI_Irecv(rbuf.data() + 4*p, 4*own_count_[i], MPI_ATHENA_REAL, own_ranks_[i], 0,
+              comm_interp_, &(req.back()));
+  }
+  for (std::size_t i=0; i<req_ranks_.size(); ++i) {
+    req.emplace_back();
+    MPI_Isend(sbuf.data() + 4*sstart[req_ranks_[i]], 4*req_count_[i], MPI_ATHENA_REAL,
+              req_ranks_[i], 0, comm_interp_, &(req.back()));
+  }
+  MPI_Waitall(static_cast<int>(req.size()), req.data(), MPI_STATUSES_IGNORE);
+#else
+  rbuf = sbuf;
+#endif
+
+  // sort owned points by MeshBlock, and copy them to the device in sorted order
+  std::vector<int> sorted(nown_);
+  std::iota(sorted.begin(), sorted.end(), 0);
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [&rbuf](int a, int b) {return rbuf[4*a] < rbuf[4*b];});
+  int nalloc = std::max(nown_, 1);
+  own_sorted_ = DvceArray1D<int>("interp_sorted", nalloc);
+  DvceArray2D<Real> pts("interp_pts", nalloc, 4);
+  auto sorted_host = Kokkos::create_mirror_view(own_sorted_);
+  auto pts_host = Kokkos::create_mirror_view(pts);
+  for (int s=0; s<nown_; ++s) {
+    sorted_host(s) = sorted[s];
+    for (int d=0; d<4; ++d) {pts_host(s,d) = rbuf[4*sorted[s] + d];}
+  }
+  Kokkos::deep_copy(own_sorted_, sorted_host);
+  Kokkos::deep_copy(pts, pts_host);
+
+  // compute first cell of stencil, and Lagrange weights, in each direction
+  own_indcs_ = DvceArray2D<int>("interp_indcs", nalloc, 4);
+  own_wghts_ = DvceArray3D<Real>("interp_wghts", nalloc, nstencil, 3);
+  mesh_version_ = pm->mesh_version;
+  if (nown_ == 0) return;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  bool multi_d = pm->multi_d, three_d = pm->three_d;
+  int nst = nstencil;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto iindcs = own_indcs_;
+  auto iwghts = own_wghts_;
+  par_for("interp_wghts", DevExeSpace(), 0, nown_-1, KOKKOS_LAMBDA(const int s) {
+    int m = static_cast<int>(pts(s,0));
+    iindcs(s,0) = m;
+    Real xmin[3] = {size.d_view(m).x1min, size.d_view(m).x2min, size.d_view(m).x3min};
+    Real dx[3] = {size.d_view(m).dx1, size.d_view(m).dx2, size.d_view(m).dx3};
+    int ioff[3] = {is, js, ks};
+    bool active[3] = {true, multi_d, three_d};
+    for (int d=0; d<3; ++d) {
+      if (active[d]) {
+        // position in units of dx relative to center of first cell in stencil
+        Real t = (pts(s,d+1) - xmin[d])/dx[d] - 0.5;
+        int start = static_cast<int>(floor(t)) - nst/2 + 1;
+        t -= static_cast<Real>(start);
+        iindcs(s,d+1) = ioff[d] + start;
+        for (int a=0; a<nst; ++a) {
+          Real w = 1.0;
+          for (int b=0; b<nst; ++b) {
+            if (b != a) {w *= (t - static_cast<Real>(b))/static_cast<Real>(a - b);}
+          }
+          iwghts(s,a,d) = w;
+        }
+      } else {
+        iindcs(s,d+1) = ioff[d];
+        for (int a=0; a<nst; ++a) {iwghts(s,a,d) = (a == 0) ? 1.0 : 0.0;}
+      }
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointInterpolator::Interpolate
+//! \brief Interpolates variables vars of val to all points with one kernel.  Results are
+//! returned to the requesting ranks, and stored in vals(npoints, nvars).
+
+void PointInterpolator::Interpolate(const DvceArray5D<Real> &val,
+                                    const std::vector<int> &vars) {
+  std::vector<std::pair<const DvceArray5D<Real>*, int>> list;
+  for (auto v : vars) {list.emplace_back(&val, v);}
+  Interpolate(list);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointInterpolator::Interpolate
+//! \brief Interpolates variables vars[v].second of arrays *(vars[v].first) to all points,
+//! with one kernel for each run of consecutive variables in the same array, and returns
+//! all results to the requesting ranks with a single exchange.  Results are stored in
+//! vals(npoints, nvars), in the order of vars.
+
+void PointInterpolator::Interpolate(
+    const std::vector<std::pair<const DvceArray5D<Real>*, int>> &vars) {
+  UpdatePoints();
+  int nvars = static_cast<int>(vars.size());
+  if (vals.extent_int(0) != std::max(npoints, 1) || vals.extent_int(1) != nvars) {
+    vals = HostArray2D<Real>("interp_vals", std::max(npoints, 1), nvars);
+  }
+  if (own_vals_host_.extent_int(0) != std::max(nown_, 1) ||
+      own_vals_host_.extent_int(1) != nvars) {
+    own_vals_ = DvceArray2D<Real>("interp_own_vals", std::max(nown_, 1), nvars);
+    own_vals_host_ = Kokkos::create_mirror_view(own_vals_);
+    vars_ = DvceArray1D<int>("interp_vars", nvars);
+  }
+  auto vars_host = Kokkos::create_mirror_view(vars_);
+  for (int v=0; v<nvars; ++v) {vars_host(v) = vars[v].second;}
+  Kokkos::deep_copy(vars_, vars_host);
+
+  // evaluate all variables at owned points, in order sorted by MeshBlock
+  for (int v0=0, v1=0; nown_ > 0 && v0<nvars; v0=v1) {
+    for (v1=v0; v1<nvars && vars[v1].first == vars[v0].first; ++v1) {}
+    const DvceArray5D<Real> &val = *(vars[v0].first);
+    int nst = nstencil;
+    int nj = (pmy_pack->pmesh->multi_d) ? nst : 1;
+    int nk = (pmy_pack->pmesh->three_d) ? nst : 1;
+    auto sorted = own_sorted_;
+    auto iindcs = own_indcs_;
+    auto iwghts = own_wghts_;
+    auto ivars = vars_;
+    auto ovals = own_vals_;
+    par_for("interp_vals", DevExeSpace(), 0, nown_-1, v0, v1-1,
+    KOKKOS_LAMBDA(const int s, const int v) {
+      int m = iindcs(s,0);
+      int i0 = iindcs(s,1), j0 = iindcs(s,2), k0 = iindcs(s,3);
+      int n = ivars(v);
+      Real sum = 0.0;
+      for (int k=0; k<nk; ++k) {
+        for (int j=0; j<nj; ++j) {
+          Real wjk = iwghts(s,j,1)*iwghts(s,k,2);
+          for (int i=0; i<nst; ++i) {
+            sum += iwghts(s,i,0)*wjk*val(m,n,k0+k,j0+j,i0+i);
+          }
+        }
+      }
+      ovals(sorted(s),v) = sum;
+    });
+  }
+  Kokkos::deep_copy(own_vals_host_, own_vals_);
+
+  // return results to requesting ranks
+  int nreq = 0;
+  for (auto c : req_count_) {nreq += c;}
+  if (req_vals_host_.extent_int(0) != std::max(nreq, 1) ||
+      req_vals_host_.extent_int(1) != nvars) {
+    req_vals_host_ = HostArray2D<Real>("interp_req_vals", std::max(nreq, 1), nvars);
+  }
+#if MPI_PARALLEL_ENABLED
+  std::vector<MPI_Request> req;
+  for (std::size_t i=0, p=0; i<req_ranks_.size(); p+=req_count_[i], ++i) {
+    req.emplace_back();
+    MPI_Irecv(req_vals_host_.data() + p*nvars, req_count_[i]*nvars, MPI_ATHENA_REAL,
+              req_ranks_[i], 1, comm_interp_, &(req.back()));
+  }
+  for (std::size_t i=0, p=0; i<own_ranks_.size(); p+=own_count_[i], ++i) {
+    req.emplace_back();
+    MPI_Isend(own_vals_host_.data() + p*nvars, own_count_[i]*nvars, MPI_ATHENA_REAL,
+              own_ranks_[i], 1, comm_interp_, &(req.back()));
+  }
+  MPI_Waitall(static_cast<int>(req.size()), req.data(), MPI_STATUSES_IGNORE);
+#else
+  for (int p=0; p<nreq; ++p) {
+    for (int v=0; v<nvars; ++v) {req_vals_host_(p,v) = own_vals_host_(p,v);}
+  }
+#endif
+
+  for (int n=0; n<npoints; ++n) {
+    for (int v=0; v<nvars; ++v) {
+      vals(n,v) = (req_order_[n] >= 0) ? req_vals_host_(req_order_[n],v) : 0.0;
+    }
+  }
+  return;
+}
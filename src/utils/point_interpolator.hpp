@@ -0,0 +1,75 @@
+#ifndef UTILS_POINT_INTERPOLATOR_HPP_
+#define UTILS_POINT_INTERPOLATOR_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file point_interpolator.hpp
+//! \brief Batched Lagrange interpolation of cell-centered variables to arbitrary points.
+//!
+//! Each rank requests interpolation to its own list of points (which may be empty, or
+//! the same on every rank).  In SetPoints() the MeshBlock containing each point is found
+//! from the MeshBlockTree, and the points are sent to the ranks owning those MeshBlocks,
+//! which sort them by MeshBlock and compute tensor-product weights on the device.
+//! Interpolate() then evaluates any number of variables at all points with one kernel,
+//! and returns the results to the requesting ranks with one sparse MPI exchange (only
+//! between pairs of ranks sharing points).  Points outside the mesh are given zero.
+
+#include <utility>
+#include <vector>
+
+#include "athena.hpp"
+
+// Forward declarations
+class MeshBlockPack;
+
+//----------------------------------------------------------------------------------------
+//! \class PointInterpolator
+
+class PointInterpolator {
+ public:
+  // nstencil = number of cells (even, at most 2*ng) used in each direction, 0 = 2*ng
+  explicit PointInterpolator(MeshBlockPack *pp, int nstencil = 0);
+  ~PointInterpolator();
+
+  int npoints;               // number of points requested by this rank
+  int nstencil;              // cells in stencil along each active dimension
+  HostArray2D<Real> vals;    // results (npoints, nvars) of last Interpolate()
+
+  // sets points (npoints, 3) requested by this rank.  Collective over all ranks.
+  void SetPoints(const HostArray2D<Real> &pos);
+  // recomputes MeshBlocks and weights of points if MeshBlocks have changed since last
+  // call.  Collective over all ranks.
+  void UpdatePoints();
+  // interpolates variables vars of val to all points.  Collective over all ranks.
+  void Interpolate(const DvceArray5D<Real> &val, const std::vector<int> &vars);
+  // interpolates variable vars[v].second of array *(vars[v].first) for all v, with one
+  // exchange of results.  Collective over all ranks.
+  void Interpolate(const std::vector<std::pair<const DvceArray5D<Real>*, int>> &vars);
+
+ private:
+  MeshBlockPack *pmy_pack;   // ptr to MeshBlockPack containing data
+  int mesh_version_;         // Mesh::mesh_version when points were located
+  HostArray2D<Real> pos_;    // positions of points requested by this rank
+
+  // points requested by this rank, ordered by owning rank
+  std::vector<int> req_ranks_, req_count_;  // owning ranks, and # of points on each
+  std::vector<int> req_order_;              // position of each point in that order
+  // points owned by this rank (requested by any rank), in order received
+  int nown_;
+  std::vector<int> own_ranks_, own_count_;  // requesting ranks, and # of points from each
+  DvceArray1D<int> own_sorted_;     // index in order received of points sorted by MB
+  DvceArray2D<int> own_indcs_;      // MB, and first cell of stencil in each direction
+  DvceArray3D<Real> own_wghts_;     // weights (npoint, nstencil, 3)
+  DvceArray1D<int> vars_;           // variables interpolated
+  DvceArray2D<Real> own_vals_;      // results at owned points, in order received
+  HostArray2D<Real> own_vals_host_, req_vals_host_;
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm comm_interp_;
+#endif
+
+  int FindMeshBlock(const Real x[3]);
+};
+
+#endif // UTILS_POINT_INTERPOLATOR_HPP_
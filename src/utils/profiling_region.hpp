@@ -0,0 +1,37 @@
+#ifndef UTILS_PROFILING_REGION_HPP_
+#define UTILS_PROFILING_REGION_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file profiling_region.hpp
+//! \brief Named regions around Tasks and the host phases of each cycle, for profilers.
+//!
+//! Enabled at compile time with -D Athena_PROFILING_REGIONS=ON.  A ProfilingRegion then
+//! pushes a Kokkos Tools region when constructed and pops it when destroyed, so regions
+//! nest like the scopes in which they are declared (cycle > TaskList > Task > kernels).
+//! Kokkos passes regions to whichever tools library is loaded with KOKKOS_TOOLS_LIBS,
+//! e.g. the nvtx-connector (NVTX ranges for Nsight Systems) or roctx-connector (ROCTX
+//! ranges for rocprof), so no vendor library is linked into athena.  When not enabled
+//! the class is empty and every region compiles away.
+
+#include <string>
+
+#include "athena.hpp"
+
+class ProfilingRegion {
+ public:
+#if PROFILING_REGIONS_ENABLED
+  explicit ProfilingRegion(const char *name) {Kokkos::Profiling::pushRegion(name);}
+  explicit ProfilingRegion(const std::string &name) {Kokkos::Profiling::pushRegion(name);}
+  ~ProfilingRegion() {Kokkos::Profiling::popRegion();}
+#else
+  explicit ProfilingRegion(const char *name) {}
+  explicit ProfilingRegion(const std::string &name) {}
+#endif
+  ProfilingRegion(const ProfilingRegion&) = delete;
+  ProfilingRegion &operator=(const ProfilingRegion&) = delete;
+};
+
+#endif // UTILS_PROFILING_REGION_HPP_
@@ -8,6 +8,9 @@
 //! \file random.cpp
 //  \brief Random number generators (that can be included in Kokkos parallel for regions)
 
+#include <cmath>
+#include <cstdint>
+
 #include "athena.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -189,4 +192,61 @@ static Real RanGaussian(int64_t *idum) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Philox4x32
+//! \brief Counter-based generator Philox4x32-10 of Salmon et al. (2011, "Parallel random
+//! numbers: as easy as 1, 2, 3").  Replaces the 128-bit counter ctr by four random 32-bit
+//! words, which depend only on ctr and the 64-bit key.  There is no state, so it can be
+//! called from any thread in a Kokkos kernel, and the same (key, counter) always gives
+//! the same numbers, independent of the order of calls or the number of ranks.
+
+KOKKOS_INLINE_FUNCTION
+void Philox4x32(std::uint32_t ctr[4], const std::uint64_t key) {
+  std::uint32_t k0 = static_cast<std::uint32_t>(key);
+  std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+  for (int r=0; r<10; ++r) {
+    std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53u)*ctr[0];
+    std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57u)*ctr[2];
+    std::uint32_t c0 = static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ k0;
+    std::uint32_t c2 = static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ k1;
+    ctr[1] = static_cast<std::uint32_t>(p1);
+    ctr[3] = static_cast<std::uint32_t>(p0);
+    ctr[0] = c0;
+    ctr[2] = c2;
+    k0 += 0x9E3779B9u;
+    k1 += 0xBB67AE85u;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn RanCounter
+//! \brief Uniform random deviate in (0,1) (exclusive of the endpoints) with 53 random
+//! bits, for draw n of object id (e.g. particle tag, or cell index within MeshBlock gid)
+//! in stream (e.g. cycle number) of a generator with given seed.
+
+KOKKOS_INLINE_FUNCTION
+double RanCounter(const std::uint64_t seed, const std::uint32_t stream,
+                  const std::uint64_t id, const std::uint32_t n) {
+  std::uint32_t ctr[4] = {n, stream, static_cast<std::uint32_t>(id),
+                          static_cast<std::uint32_t>(id >> 32)};
+  Philox4x32(ctr, seed);
+  return ((ctr[0] >> 5)*67108864.0 + (ctr[1] >> 6) + 0.5)/9007199254740992.0;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn RanGaussianCounter
+//! \brief Gaussian random deviate with zero mean and unit variance, from the Box-Muller
+//! transform of the two uniform deviates in the four words of one counter.
+
+KOKKOS_INLINE_FUNCTION
+double RanGaussianCounter(const std::uint64_t seed, const std::uint32_t stream,
+                          const std::uint64_t id, const std::uint32_t n) {
+  std::uint32_t ctr[4] = {n, stream, static_cast<std::uint32_t>(id),
+                          static_cast<std::uint32_t>(id >> 32)};
+  Philox4x32(ctr, seed);
+  double u1 = ((ctr[0] >> 5)*67108864.0 + (ctr[1] >> 6) + 0.5)/9007199254740992.0;
+  double u2 = ((ctr[2] >> 5)*67108864.0 + (ctr[3] >> 6) + 0.5)/9007199254740992.0;
+  return sqrt(-2.0*log(u1))*cos(2.0*M_PI*u2);
+}
+
 #endif // UTILS_RANDOM_HPP_
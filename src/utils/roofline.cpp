@@ -0,0 +1,257 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file roofline.cpp
+//! \brief Implements the theoretical costs per cell of the hot kernels.  Flops of the
+//! reconstruction are per variable and direction, those of the Riemann solvers per face.
+
+#include <algorithm>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "radiation/radiation.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "z4c/z4c.hpp"
+#include "utils/roofline.hpp"
+
+namespace roofline {
+
+namespace {
+constexpr double kReal = sizeof(Real);
+constexpr double kFlux = sizeof(FluxReal);
+
+// left and right states at both faces of a cell, for one variable in one direction
+double ReconFlops(ReconstructionMethod recon) {
+  switch (recon) {
+    case ReconstructionMethod::dc:    return 0.0;
+    case ReconstructionMethod::plm:   return 12.0;
+    case ReconstructionMethod::ppm4:  return 36.0;
+    case ReconstructionMethod::ppmx:  return 60.0;
+    case ReconstructionMethod::wenoz: return 84.0;
+  }
+  return 0.0;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost HydroFluxes()
+//! \brief reads primitives, writes three faces of fluxes
+
+KernelCost HydroFluxes(ReconstructionMethod recon, Hydro_RSolver rsolver, int nvar) {
+  double rs = 0.0;
+  switch (rsolver) {
+    case Hydro_RSolver::advect:  rs = 10.0;  break;
+    case Hydro_RSolver::llf:     rs = 50.0;  break;
+    case Hydro_RSolver::hlle:    rs = 70.0;  break;
+    case Hydro_RSolver::hllc:    rs = 110.0; break;
+    case Hydro_RSolver::roe:     rs = 180.0; break;
+    case Hydro_RSolver::llf_sr:  rs = 150.0; break;
+    case Hydro_RSolver::hlle_sr: rs = 180.0; break;
+    case Hydro_RSolver::hllc_sr: rs = 260.0; break;
+    case Hydro_RSolver::llf_gr:  rs = 300.0; break;
+    case Hydro_RSolver::hlle_gr: rs = 350.0; break;
+  }
+  KernelCost c;
+  c.bytes = nvar*kReal + 3.0*nvar*kFlux;
+  c.flops = 3.0*(nvar*ReconFlops(recon) + rs);
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost MHDFluxes()
+//! \brief reads primitives and cell- and face-centered fields, writes three faces of
+//! fluxes and of the two electric fields on each face.  Two transverse components of B
+//! are reconstructed with the primitives.
+
+KernelCost MHDFluxes(ReconstructionMethod recon, MHD_RSolver rsolver, int nvar) {
+  double rs = 0.0;
+  switch (rsolver) {
+    case MHD_RSolver::advect:  rs = 15.0;  break;
+    case MHD_RSolver::llf:     rs = 100.0; break;
+    case MHD_RSolver::hlle:    rs = 130.0; break;
+    case MHD_RSolver::hlld:    rs = 300.0; break;
+    case MHD_RSolver::roe:     rs = 400.0; break;
+    case MHD_RSolver::llf_sr:  rs = 300.0; break;
+    case MHD_RSolver::hlle_sr: rs = 350.0; break;
+    case MHD_RSolver::hlld_sr: rs = 700.0; break;
+    case MHD_RSolver::llf_gr:  rs = 500.0; break;
+    case MHD_RSolver::hlle_gr: rs = 600.0; break;
+  }
+  KernelCost c;
+  c.bytes = (nvar + 6)*kReal + 3.0*nvar*kFlux + 6.0*kReal;
+  c.flops = 3.0*((nvar + 2)*ReconFlops(recon) + rs);
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost RKUpdate()
+//! \brief reads conserved variables of two registers and three faces of fluxes, writes
+//! conserved variables
+
+KernelCost RKUpdate(int nvar) {
+  KernelCost c;
+  c.bytes = nvar*(3.0*kReal + 3.0*kFlux);
+  c.flops = nvar*10.0;
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost CornerE()
+//! \brief reads face electric fields, velocities and cell-centered B, writes three edges
+
+KernelCost CornerE() {
+  KernelCost c;
+  c.bytes = 15.0*kReal;
+  c.flops = 60.0;
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost CTUpdate()
+//! \brief reads face fields of two registers and three edges, writes face fields
+
+KernelCost CTUpdate() {
+  KernelCost c;
+  c.bytes = 12.0*kReal;
+  c.flops = 24.0;
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost HydroConsToPrim()
+//! \brief reads conserved and writes primitive variables.  Relativistic solvers assume
+//! about 10 iterations of the root finder.
+
+KernelCost HydroConsToPrim(Hydro_RSolver rsolver, int nvar) {
+  KernelCost c;
+  c.bytes = 2.0*nvar*kReal;
+  switch (rsolver) {
+    case Hydro_RSolver::llf_sr:
+    case Hydro_RSolver::hlle_sr:
+    case Hydro_RSolver::hllc_sr:
+      c.flops = 300.0;
+      break;
+    case Hydro_RSolver::llf_gr:
+    case Hydro_RSolver::hlle_gr:
+      c.flops = 500.0;
+      break;
+    default:
+      c.flops = 20.0;
+  }
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost MHDConsToPrim()
+//! \brief as above, also reads face fields and writes cell-centered fields
+
+KernelCost MHDConsToPrim(MHD_RSolver rsolver, int nvar) {
+  KernelCost c;
+  c.bytes = 2.0*nvar*kReal + 6.0*kReal;
+  switch (rsolver) {
+    case MHD_RSolver::llf_sr:
+    case MHD_RSolver::hlle_sr:
+    case MHD_RSolver::hlld_sr:
+      c.flops = 600.0;
+      break;
+    case MHD_RSolver::llf_gr:
+    case MHD_RSolver::hlle_gr:
+      c.flops = 900.0;
+      break;
+    default:
+      c.flops = 35.0;
+  }
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost Z4cRHS()
+//! \brief reads all Z4c variables and writes their RHS.  Flops are dominated by the 4th
+//! order first and second derivatives (about 130 of them) and the algebra of the RHS.
+
+KernelCost Z4cRHS() {
+  KernelCost c;
+  c.bytes = 2.0*z4c::Z4c::nz4c*kReal;
+  c.flops = 7000.0;
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost RadFluxes()
+//! \brief reads intensities, writes three faces of fluxes, for each angle
+
+KernelCost RadFluxes(int nang) {
+  KernelCost c;
+  c.bytes = nang*(kReal + 3.0*kFlux);
+  c.flops = nang*3.0*(ReconFlops(ReconstructionMethod::plm) + 6.0);
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost RadSource()
+//! \brief reads and writes intensities and fluid primitives
+
+KernelCost RadSource(int nang) {
+  KernelCost c;
+  c.bytes = 2.0*nang*kReal + 10.0*kReal;
+  c.flops = nang*40.0 + 200.0;
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn KernelCost StageCost()
+
+KernelCost StageCost(MeshBlockPack *pmbp) {
+  KernelCost c;
+  if (pmbp->phydro != nullptr) {
+    auto *ph = pmbp->phydro;
+    int nvar = ph->nhydro + ph->nscalars;
+    c += HydroFluxes(ph->recon_method, ph->rsolver_method, nvar);
+    c += RKUpdate(nvar);
+    c += HydroConsToPrim(ph->rsolver_method, nvar);
+  }
+  if (pmbp->pmhd != nullptr) {
+    auto *pm = pmbp->pmhd;
+    int nvar = pm->nmhd + pm->nscalars;
+    c += MHDFluxes(pm->recon_method, pm->rsolver_method, nvar);
+    c += RKUpdate(nvar);
+    c += CornerE();
+    c += CTUpdate();
+    c += MHDConsToPrim(pm->rsolver_method, nvar);
+  }
+  if (pmbp->prad != nullptr) {
+    auto *pr = pmbp->prad;
+    int nang = pr->nintens;
+    c += RadFluxes(nang);
+    c += RKUpdate(nang);
+    if (pr->rad_source) {c += RadSource(nang);}
+  }
+  if (pmbp->pz4c != nullptr) {
+    // update of evolved variables reads two registers and the RHS, writes one
+    KernelCost upd;
+    upd.bytes = 4.0*z4c::Z4c::nz4c*kReal;
+    upd.flops = 4.0*z4c::Z4c::nz4c;
+    c += Z4cRHS();
+    c += upd;
+  }
+  return c;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn double RooflineFraction()
+
+double RooflineFraction(const KernelCost &c, double cells_per_s,
+                        const MachinePeak &peak) {
+  if (peak.bytes_per_s <= 0.0 || c.bytes <= 0.0) return 0.0;
+  if (peak.flops_per_s <= 0.0 || c.flops <= 0.0) {
+    return c.bytes*cells_per_s/peak.bytes_per_s;
+  }
+  double attainable = std::min(peak.flops_per_s, c.Intensity()*peak.bytes_per_s);
+  return c.flops*cells_per_s/attainable;
+}
+
+} // namespace roofline
@@ -0,0 +1,74 @@
+#ifndef UTILS_ROOFLINE_HPP_
+#define UTILS_ROOFLINE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file roofline.hpp
+//! \brief Theoretical cost per cell (bytes moved to/from device memory, and flops) of the
+//! hot kernels, used by athena_bench and the "perf" output to report the achieved
+//! fraction of the roofline min(peak flops, intensity x peak bandwidth).
+//!
+//! Bytes count only compulsory traffic: each array read once and written once per cell,
+//! assuming stencil neighbours are reused from cache, so they are a lower bound.  Flops
+//! are counted from the arithmetic in the kernels (divisions and square roots as one
+//! flop each), for the EOS and Riemann solver selected.  Iterative primitive solvers
+//! assume a typical number of iterations.  The values are estimates to compare kernels
+//! with each other and with the roofline, not exact operation counts.
+
+#include "athena.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+
+class MeshBlockPack;
+
+namespace roofline {
+
+struct KernelCost {
+  double bytes = 0.0;  // per cell
+  double flops = 0.0;  // per cell
+  KernelCost &operator+=(const KernelCost &c) {
+    bytes += c.bytes;
+    flops += c.flops;
+    return *this;
+  }
+  // arithmetic intensity (flop/byte)
+  double Intensity() const {return (bytes > 0.0) ? flops/bytes : 0.0;}
+};
+
+// peak memory bandwidth (bytes/s) and floating-point rate (flop/s) of the device, e.g.
+// measured with STREAM and a dense kernel, or from the data sheet.  Zero if unknown.
+struct MachinePeak {
+  double bytes_per_s = 0.0;
+  double flops_per_s = 0.0;
+};
+
+// reconstruction and Riemann solver of each face in three dimensions, and update
+KernelCost HydroFluxes(ReconstructionMethod recon, Hydro_RSolver rsolver, int nvar);
+KernelCost MHDFluxes(ReconstructionMethod recon, MHD_RSolver rsolver, int nvar);
+KernelCost RKUpdate(int nvar);
+// MHD edge electric fields and constrained-transport update of face fields
+KernelCost CornerE();
+KernelCost CTUpdate();
+// conserved-to-primitive conversion (relativity given by the Riemann solver)
+KernelCost HydroConsToPrim(Hydro_RSolver rsolver, int nvar);
+KernelCost MHDConsToPrim(MHD_RSolver rsolver, int nvar);
+// right-hand side of the Z4c equations (derivatives, algebra, dissipation)
+KernelCost Z4cRHS();
+// radiation spatial fluxes and source term, with nang angles
+KernelCost RadFluxes(int nang);
+KernelCost RadSource(int nang);
+
+// cost per cell of one stage of the integrator, summed over the hot kernels of all
+// physics modules in the MeshBlockPack
+KernelCost StageCost(MeshBlockPack *pmbp);
+
+// fraction of the roofline achieved by a kernel of given cost updating cells_per_s
+// cells/s.  Uses only the bandwidth when the flops (or peak flop rate) are unknown.
+// Returns zero when the peak bandwidth is unknown.
+double RooflineFraction(const KernelCost &c, double cells_per_s,
+                        const MachinePeak &peak);
+} // namespace roofline
+
+#endif // UTILS_ROOFLINE_HPP_
@@ -22,6 +22,9 @@ void ShowConfig() {
   } else {
     std::cout<<"  Floating-point precision:   double" << std::endl;
   }
+  if (MIXED_PRECISION_ENABLED) {
+    std::cout<<"  Flux/output storage:        single" << std::endl;
+  }
 #if MPI_PARALLEL_ENABLED
   std::cout<<"  MPI parallelism:            ON" << std::endl;
 #else
@@ -0,0 +1,246 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file team_tuner.cpp
+//! \brief Implements runtime tuning of the TeamPolicy of par_for_outer kernels.  The
+//! cache file has one line per kernel: team size, vector length, time per launch (s),
+//! and label.  A team size of 0 denotes Kokkos::AUTO.
+
+#include <unistd.h>   // getcwd()
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "utils/team_tuner.hpp"
+
+namespace team_tuner {
+
+namespace {
+// state of tuning of one kernel
+struct Kernel {
+  TeamConfig best;           // used once tuned (Kokkos::AUTO by default)
+  double best_time = -1.0;   // time per launch with best
+  std::vector<double> time;  // minimum time of each candidate (<0 if invalid)
+  int nlaunch = 0;           // number of timed launches so far
+  bool tuned = false;        // read from cache file, or chosen after tuning
+  bool store = false;        // write to cache file (all candidates have been timed)
+};
+
+struct TunerState {
+  bool tuning = false;
+  int nsample = 3, ncycle = 20, cycle = 0;
+  std::string file;
+  std::vector<TeamConfig> candidates;
+  // std::map is ordered by label, so cache files are easy to compare between machines
+  std::map<std::string, Kernel> kernels;
+} state;
+
+// candidates always include Kokkos::AUTO.  On GPUs, teams of 128 to 1024 threads split
+// between team and vector lanes.  On CPUs, team sizes up to the number of threads.
+void SetCandidates() {
+  state.candidates.clear();
+  state.candidates.push_back(TeamConfig());
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP)
+#if defined(KOKKOS_ENABLE_HIP)
+  const int vlens[] = {1, 8, 32, 64};
+#else
+  const int vlens[] = {1, 8, 32};
+#endif
+  for (int nthread : {128, 256, 512, 1024}) {
+    for (int vlen : vlens) {
+      TeamConfig c;
+      c.team_size = nthread/vlen;
+      c.vector_length = vlen;
+      state.candidates.push_back(c);
+    }
+  }
+#else
+  for (int ts=1; ts<=DevExeSpace().concurrency(); ts*=2) {
+    TeamConfig c;
+    c.team_size = ts;
+    state.candidates.push_back(c);
+  }
+#endif
+}
+
+// choose fastest candidate timed so far (Kokkos::AUTO if none)
+void Choose(Kernel &k) {
+  k.tuned = true;
+  for (std::size_t n=0; n<k.time.size(); ++n) {
+    if ((k.time[n] >= 0.0) && (k.time[n] < std::numeric_limits<double>::max()) &&
+        ((k.best_time < 0.0) || (k.time[n] < k.best_time))) {
+      k.best_time = k.time[n];
+      k.best = state.candidates[n];
+    }
+  }
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn std::string DefaultFile()
+
+std::string DefaultFile() {
+#if defined(KOKKOS_ARCH_VOLTA70)
+  std::string arch = "volta70";
+#elif defined(KOKKOS_ARCH_AMPERE80)
+  std::string arch = "ampere80";
+#elif defined(KOKKOS_ARCH_HOPPER90)
+  std::string arch = "hopper90";
+#elif defined(KOKKOS_ARCH_AMD_GFX90A) || defined(KOKKOS_ARCH_VEGA90A)
+  std::string arch = "gfx90a";
+#elif defined(KOKKOS_ARCH_AMD_GFX942)
+  std::string arch = "gfx942";
+#else
+  std::string arch = DevExeSpace().name();
+  std::transform(arch.begin(), arch.end(), arch.begin(),
+                 [](unsigned char c) {return std::tolower(c);});
+#endif
+  return "athena_autotune." + arch + ".txt";
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Enable()
+//! \brief Relative paths of the cache file are taken from the directory in which athena
+//! is started (not the run directory), so that runs in different directories share it.
+
+void Enable(const std::string &file, const int nsample, const int ncycle) {
+  Enabled() = true;
+  state.tuning = true;
+  state.nsample = std::max(nsample, 1);
+  state.ncycle = ncycle;
+  state.cycle = 0;
+  state.file = file;
+  if (!(state.file.empty()) && (state.file[0] != '/')) {
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd)) != nullptr) {
+      state.file = std::string(cwd) + "/" + state.file;
+    }
+  }
+  SetCandidates();
+
+  std::ifstream in(state.file);
+  std::string line;
+  int nread = 0;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream ss(line);
+    Kernel k;
+    std::string name;
+    if (!(ss >> k.best.team_size >> k.best.vector_length >> k.best_time)) continue;
+    std::getline(ss >> std::ws, name);
+    if (name.empty()) continue;
+    k.tuned = true;
+    k.store = true;
+    state.kernels[name] = k;
+    nread++;
+  }
+  if (global_variable::my_rank == 0) {
+    std::cout << "Tuning team sizes of par_for_outer kernels ("
+              << state.candidates.size() << " candidates), " << nread
+              << " kernels read from " << state.file << std::endl;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TeamConfig Select()
+
+TeamConfig Select(const std::string &name, bool &timed) {
+  Kernel &k = state.kernels[name];
+  timed = false;
+  if (k.tuned) return k.best;
+  // kernels first launched after tuning ended use Kokkos::AUTO
+  if (!(state.tuning)) {
+    k.tuned = true;
+    return k.best;
+  }
+  if (Paused()) return k.best;
+  if (k.time.empty()) {
+    k.time.assign(state.candidates.size(), std::numeric_limits<double>::max());
+  }
+  timed = true;
+  return state.candidates[k.nlaunch/state.nsample];
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Record()
+
+void Record(const std::string &name, const double time) {
+  Kernel &k = state.kernels[name];
+  int n = k.nlaunch/state.nsample;
+  if (time < 0.0) {
+    k.time[n] = -1.0;
+    k.nlaunch = (n + 1)*state.nsample;
+  } else {
+    k.time[n] = std::min(k.time[n], time);
+    k.nlaunch++;
+  }
+  if (k.nlaunch >= state.nsample*static_cast<int>(state.candidates.size())) {
+    Choose(k);
+    k.store = true;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void EndCycle()
+
+void EndCycle() {
+  if (!(state.tuning)) return;
+  if (++state.cycle >= state.ncycle) {Finish();}
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Finish()
+//! \brief Kernels that have not timed every candidate use the fastest timed so far, but
+//! are not written to the cache file, so they are tuned again by the next run.
+
+void Finish() {
+  if (!(state.tuning)) return;
+  state.tuning = false;
+  int ntuned = 0, npartial = 0;
+  for (auto &it : state.kernels) {
+    if (it.second.tuned) {
+      ntuned++;
+    } else {
+      Choose(it.second);
+      npartial++;
+    }
+  }
+  if (global_variable::my_rank != 0) return;
+
+  std::FILE *pfile = std::fopen(state.file.c_str(), "w");
+  if (pfile == nullptr) {
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Could not write autotune cache file " << state.file << std::endl;
+    return;
+  }
+  std::fprintf(pfile, "# team sizes of par_for_outer kernels, device %s\n",
+               DevExeSpace().name());
+  std::fprintf(pfile, "# team_size vector_length time_per_launch(s) label\n");
+  for (auto &it : state.kernels) {
+    if (!(it.second.store)) continue;
+    std::fprintf(pfile, "%d %d %.6e %s\n", it.second.best.team_size,
+                 it.second.best.vector_length, it.second.best_time, it.first.c_str());
+  }
+  std::fclose(pfile);
+  std::cout << "Team sizes of " << ntuned << " kernels written to " << state.file;
+  if (npartial > 0) {
+    std::cout << " (" << npartial << " more not fully tuned in " << state.ncycle
+              << " cycles)";
+  }
+  std::cout << std::endl;
+}
+
+} // namespace team_tuner
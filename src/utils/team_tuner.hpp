@@ -0,0 +1,32 @@
+#ifndef UTILS_TEAM_TUNER_HPP_
+#define UTILS_TEAM_TUNER_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file team_tuner.hpp
+//! \brief Runtime tuning of the team size and vector length of par_for_outer kernels.
+//!
+//! Enabled with <job>/autotune = true.  Each kernel launched by par_for_outer (or
+//! LaunchTeams) is run with every candidate configuration in turn, autotune_samples
+//! times each, and the fastest is kept.  Tuning is stopped after autotune_cycles cycles
+//! even if some kernels have not tried every candidate.  Configurations are stored in a
+//! cache file (one per device architecture by default) reused by later runs, so that
+//! kernels already in the file are not tuned again.  Select() and Record(), used inside
+//! LaunchTeams(), are declared in athena.hpp.
+
+#include <string>
+
+namespace team_tuner {
+// default name of cache file, containing the device architecture athena is built for
+std::string DefaultFile();
+// enables tuning, and reads configurations in the cache file (if it exists)
+void Enable(const std::string &file, const int nsample, const int ncycle);
+// called at the end of every cycle; calls Finish() after ncycle cycles
+void EndCycle();
+// ends tuning, and writes the cache file on rank 0
+void Finish();
+} // namespace team_tuner
+
+#endif // UTILS_TEAM_TUNER_HPP_
@@ -13,13 +13,10 @@
 #include <iomanip>
 #include <memory>
 #include <utility>
+#include <vector>
 #include <string>
 #include <cstdio>
 
-#ifdef MPI_PARALLEL
-#include <mpi.h>
-#endif
-
 #include "cce.hpp"
 #include "z4c/z4c.hpp"
 #include "coordinates/adm.hpp"
@@ -31,6 +28,10 @@
 #include "utils/spherical_harm.hpp"
 #include "utils/chebyshev.hpp"
 
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
 #define BUFFSIZE  (1024)
 #define MAX_RADII (100)
 #define ABS(x_) ((x_)>0 ? (x_) : (-(x_)))
@@ -73,35 +74,133 @@ CCE::CCE(Mesh *const pm, ParameterInput *const pin, int index):
   variable_to_dump.push_back(std::make_pair(pmbp->padm->I_ADM_GYY, false));
   variable_to_dump.push_back(std::make_pair(pmbp->padm->I_ADM_GYZ, false));
   variable_to_dump.push_back(std::make_pair(pmbp->padm->I_ADM_GZZ, false));
+
+  streaming = pin->GetOrAddBoolean("cce", "streaming", false);
+  if (streaming && 0 == global_variable::my_rank) {
+    writer = std::thread(&CCE::WriterLoop, this);
+  }
+}
+
+CCE::~CCE() {
+  if (streaming) {
+    FinishStreamDump();
+    if (writer.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        writer_stop = true;
+      }
+      writer_cv.notify_one();
+      writer.join();
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CCE::FinishStreamDump
+//! \brief Waits for the reduction of the last dump started in streaming mode (if any),
+//! and on rank 0 hands the reduced coefficients to the writer thread.
+
+void CCE::FinishStreamDump() {
+  if (!stream_pending) return;
+#if MPI_PARALLEL_ENABLED
+  MPI_Wait(&stream_req, MPI_STATUS_IGNORE);
+#endif
+  stream_pending = false;
+  if (0 == global_variable::my_rank) {
+    {
+      std::lock_guard<std::mutex> lock(writer_mutex);
+      writer_queue.emplace_back(stream_time, std::move(stream_buf));
+    }
+    writer_cv.notify_one();
+  }
+  stream_buf = std::vector<Real>();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CCE::WriterLoop
+//! \brief Writer thread used in streaming mode.  Appends each dump to the file
+//! cce/cce_stream_<index>.bin, which starts with the number of radii, the number of l
+//! modes, and the inner and outer radii, followed by one chunk per dump containing the
+//! time and the real and imaginary coefficients (in the same layout as the files
+//! written without streaming).  The file is flushed after each chunk.
+
+void CCE::WriterLoop() {
+  std::string filename = "cce/cce_stream_" + std::to_string(index) + ".bin";
+  FILE* cce_file = fopen(filename.c_str(), "wb");
+  if (cce_file == nullptr) {
+    perror("Error opening file");
+  } else {
+    fwrite(&nr, sizeof(int), 1, cce_file);
+    fwrite(&num_l_modes, sizeof(int), 1, cce_file);
+    fwrite(&rin, sizeof(Real), 1, cce_file);
+    fwrite(&rout, sizeof(Real), 1, cce_file);
+  }
+  while (true) {
+    std::pair<Real, std::vector<Real>> dump;
+    {
+      std::unique_lock<std::mutex> lock(writer_mutex);
+      writer_cv.wait(lock, [this]() {return writer_stop || !writer_queue.empty();});
+      if (writer_queue.empty()) break;  // only reached once writer_stop is set
+      dump = std::move(writer_queue.front());
+      writer_queue.pop_front();
+    }
+    if (cce_file != nullptr) {
+      WriteDump(cce_file, dump.first, dump.second);
+      fflush(cce_file);
+    }
+  }
+  if (cce_file != nullptr) {
+    fclose(cce_file);
+  }
 }
 
-CCE::~CCE() {}
+//----------------------------------------------------------------------------------------
+//! \fn void CCE::WriteDump
+//! \brief Writes time and coefficients (real parts, then imaginary parts) of one dump
+
+void CCE::WriteDump(FILE *pfile, Real time, const std::vector<Real> &data) {
+  fwrite(&time, sizeof(Real), 1, pfile);
+  size_t elementsWritten = fwrite(data.data(), sizeof(Real), data.size(), pfile);
+  if (elementsWritten != data.size()) {
+    perror("Error writing to file");
+  }
+}
 
 // Interpolate all fields to Gauss-Legendre Sphere
 void CCE::InterpolateAndDecompose(MeshBlockPack *pmbp) {
   Real ylmR,ylmI;
 
-  // reinitialize interpolation indices and weights if AMR
-  if(pmbp->pmesh->adaptive) {
-    for (int k = 0; k < nr; ++k) {
-      grids[k]->SetInterpolationIndices();
-      grids[k]->SetInterpolationWeights();
-    }
+  // reinitialize interpolation indices and weights if MeshBlocks changed
+  for (int k = 0; k < nr; ++k) {
+    grids[k]->UpdateInterpolation();
+  }
+
+  // variables in u0 and u_adm, and their column in the interpolated data
+  std::vector<int> z4c_vars, adm_vars;
+  std::vector<int> column(variable_to_dump.size());
+  for (std::size_t nvar=0; nvar<variable_to_dump.size(); nvar++) {
+    auto &vars = (variable_to_dump[nvar].second)? z4c_vars : adm_vars;
+    column[nvar] = vars.size();
+    vars.push_back(variable_to_dump[nvar].first);
   }
+  HostArray2D<Real> z4c_vals("z4c_vals", 1, 1), adm_vals("adm_vals", 1, 1);
 
   // raveled shape of array & counts for mpi
   int count = 10*nr*num_angular_modes;
-  // Dynamically allocate memory for the 4D array flattened into 1D
-  Real* data_real = new Real[count];
-  Real* data_imag = new Real[count];
-  for(int nvar=0; nvar<10; nvar++) {
-    for (int k = 0; k < nr; ++k) {
-      // Interpolate here
-      if (variable_to_dump[nvar].second) {
-        grids[k]->InterpolateToSphere(variable_to_dump[nvar].first,pmbp->pz4c->u0);
-      } else {
-        grids[k]->InterpolateToSphere(variable_to_dump[nvar].first,pmbp->padm->u_adm);
-      }
+  // 4D array flattened into 1D, with real parts followed by imaginary parts
+  std::vector<Real> data(2*count);
+  Real* data_real = data.data();
+  Real* data_imag = data.data() + count;
+  for (int k = 0; k < nr; ++k) {
+    // Interpolate all variables in each array with one kernel
+    grids[k]->InterpolateToSphere(z4c_vars, pmbp->pz4c->u0);
+    Kokkos::realloc(z4c_vals, grids[k]->nangles, z4c_vars.size());
+    Kokkos::deep_copy(z4c_vals, grids[k]->interp_vals_multi.h_view);
+    grids[k]->InterpolateToSphere(adm_vars, pmbp->padm->u_adm);
+    Kokkos::realloc(adm_vals, grids[k]->nangles, adm_vars.size());
+    Kokkos::deep_copy(adm_vals, grids[k]->interp_vals_multi.h_view);
+    for(int nvar=0; nvar<10; nvar++) {
+      auto &vals = (variable_to_dump[nvar].second)? z4c_vals : adm_vals;
       for (int l = 0; l < num_l_modes+1; ++l) {
         for (int m = -l; m < l+1 ; ++m) {
           Real psilmR = 0.0;
@@ -109,7 +208,7 @@ void CCE::InterpolateAndDecompose(MeshBlockPack *pmbp) {
           for (int ip = 0; ip < grids[k]->nangles; ++ip) {
             Real theta = grids[k]->polar_pos.h_view(ip,0);
             Real phi = grids[k]->polar_pos.h_view(ip,1);
-            Real data = grids[k]->interp_vals.h_view(ip);
+            Real data = vals(ip,column[nvar]);
             Real weight = grids[k]->int_weights.h_view(ip);
             // calculate spherical harmonics
             SWSphericalHarm(&ylmR,&ylmI, l, m, 0, theta, phi);
@@ -129,16 +228,33 @@ void CCE::InterpolateAndDecompose(MeshBlockPack *pmbp) {
     }
   }
 
+  // In streaming mode, finish previous dump (long since complete) and start
+  // non-blocking reduction of this dump, which is written by the writer thread
+  if (streaming) {
+    FinishStreamDump();
+    stream_time = pmbp->pmesh->time;
+    stream_buf = std::move(data);
+#if MPI_PARALLEL_ENABLED
+    if (0 == global_variable::my_rank) {
+      MPI_Ireduce(MPI_IN_PLACE, stream_buf.data(), 2*count, MPI_ATHENA_REAL, MPI_SUM, 0,
+                  MPI_COMM_WORLD, &stream_req);
+    } else {
+      MPI_Ireduce(stream_buf.data(), nullptr, 2*count, MPI_ATHENA_REAL, MPI_SUM, 0,
+                  MPI_COMM_WORLD, &stream_req);
+    }
+#endif
+    stream_pending = true;
+    return;
+  }
+
   // Reduction to the master rank for cnlm_real and cnlm_imag
   #if MPI_PARALLEL_ENABLED
   if (0 == global_variable::my_rank) {
-    MPI_Reduce(MPI_IN_PLACE, data_real, count, MPI_ATHENA_REAL,
-              MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(MPI_IN_PLACE, data_imag, count, MPI_ATHENA_REAL,
+    MPI_Reduce(MPI_IN_PLACE, data.data(), 2*count, MPI_ATHENA_REAL,
               MPI_SUM, 0, MPI_COMM_WORLD);
   } else {
-    MPI_Reduce(data_real, data_real, count, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(data_imag, data_imag, count, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(data.data(), data.data(), 2*count, MPI_ATHENA_REAL, MPI_SUM, 0,
+               MPI_COMM_WORLD);
   }
   #endif
 
@@ -166,18 +282,12 @@ void CCE::InterpolateAndDecompose(MeshBlockPack *pmbp) {
     fwrite(&rin, sizeof(Real), 1, cce_file);
     fwrite(&rout, sizeof(Real), 1, cce_file);
     // Write the 4D array to the binary file
-    size_t elementsWritten = fwrite(data_real, sizeof(Real), count, cce_file);
-    if (elementsWritten != count) {
-      perror("Error writing to file");
-    }
-    elementsWritten = fwrite(data_imag, sizeof(Real), count, cce_file);
-    if (elementsWritten != count) {
+    size_t elementsWritten = fwrite(data.data(), sizeof(Real), 2*count, cce_file);
+    if (elementsWritten != 2*count) {
       perror("Error writing to file");
     }
     // Close the file
     fclose(cce_file);
   }
-  delete[] data_real;
-  delete[] data_imag;
 }
 } // end namespace z4c
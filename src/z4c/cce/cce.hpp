@@ -7,14 +7,23 @@
 #ifndef Z4C_CCE_CCE_HPP_
 #define Z4C_CCE_CCE_HPP_
 
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdio>
+#include <deque>
 #include <string>
 #include <vector>
 #include <utility>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
 
 #include "athena.hpp"
 #include "globals.hpp"
 
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
 // max absolute value of spin in spin weighted Ylm
 #define MAX_SPIN (2)
 
@@ -54,6 +63,24 @@ class CCE {
   // sphere for storing the indices, etc.
   std::vector<std::unique_ptr<GaussLegendreGrid>> grids;
 
+  // streaming output (<cce>/streaming): coefficients are reduced with a non-blocking
+  // MPI call, and appended to one file per shell by a background writer thread
+  bool streaming;
+  bool stream_pending = false;     // true while reduction of a dump is in flight
+  Real stream_time;                // time of dump being reduced
+  std::vector<Real> stream_buf;    // coefficients of dump being reduced
+#if MPI_PARALLEL_ENABLED
+  MPI_Request stream_req;
+#endif
+  std::thread writer;              // writer thread (rank 0 only)
+  std::mutex writer_mutex;
+  std::condition_variable writer_cv;
+  std::deque<std::pair<Real, std::vector<Real>>> writer_queue;  // dumps to be written
+  bool writer_stop = false;
+  void FinishStreamDump();
+  void WriterLoop();
+  void WriteDump(FILE *pfile, Real time, const std::vector<Real> &data);
+
  public:
   CCE(Mesh *const pm, ParameterInput *const pin, int index);
   ~CCE();
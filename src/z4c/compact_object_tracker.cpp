@@ -12,7 +12,9 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <memory>
 #include <string>
+#include <vector>
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
@@ -24,15 +26,16 @@
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
-#include "utils/lagrange_interpolator.hpp"
+#include "coordinates/cell_locations.hpp"
 #include "coordinates/adm.hpp"
+#include "utils/host_tasks.hpp"
 #include "mhd/mhd.hpp"
 #include "z4c/z4c.hpp"
 
 //----------------------------------------------------------------------------------------
 CompactObjectTracker::CompactObjectTracker(Mesh *pmesh, ParameterInput *pin, int n):
               owns_compact_object{false}, pos{NAN, NAN, NAN}, vel{NAN, NAN, NAN},
-              pmesh{pmesh}, out_every{1} {
+              pmesh{pmesh}, out_every{1}, mb_last{-1} {
   std::string nstr = std::to_string(n);
   std::string ofname = pin->GetString("job", "basename") + ".";
   ofname += pin->GetOrAddString("z4c", "filename", "co_");
@@ -76,109 +79,177 @@ CompactObjectTracker::CompactObjectTracker(Mesh *pmesh, ParameterInput *pin, int
 }
 
 //----------------------------------------------------------------------------------------
-CompactObjectTracker::~CompactObjectTracker() { }
+CompactObjectTracker::~CompactObjectTracker() {
+  host_tasks::Wait(write_done);
+}
 
 //----------------------------------------------------------------------------------------
-void CompactObjectTracker::InterpolateVelocity(MeshBlockPack *pmbp) {
-  auto &padm = pmbp->padm;
-  auto &pmhd = pmbp->pmhd;
-  auto &pz4c = pmbp->pz4c;
-  auto *S    = new LagrangeInterpolator(pmbp, pos);
-
-  if (S->point_exist) {
-    owns_compact_object = true;
-
-    Real betax = S->Interpolate(pz4c->u0, pz4c->I_Z4C_BETAX);
-    Real betay = S->Interpolate(pz4c->u0, pz4c->I_Z4C_BETAY);
-    Real betaz = S->Interpolate(pz4c->u0, pz4c->I_Z4C_BETAZ);
-    vel[0] = - betax;
-    vel[1] = - betay;
-    vel[2] = - betaz;
-    if (type == NeutronStar) {
-      Real alp = S->Interpolate(pz4c->u0, pz4c->I_Z4C_ALPHA);
-
-      Real zx = S->Interpolate(pmhd->w0, IVX);
-      Real zy = S->Interpolate(pmhd->w0, IVY);
-      Real zz = S->Interpolate(pmhd->w0, IVZ);
-
-      Real gxx = S->Interpolate(padm->u_adm, padm->I_ADM_GXX);
-      Real gxy = S->Interpolate(padm->u_adm, padm->I_ADM_GXY);
-      Real gxz = S->Interpolate(padm->u_adm, padm->I_ADM_GXZ);
-      Real gyy = S->Interpolate(padm->u_adm, padm->I_ADM_GYY);
-      Real gyz = S->Interpolate(padm->u_adm, padm->I_ADM_GYZ);
-      Real gzz = S->Interpolate(padm->u_adm, padm->I_ADM_GZZ);
-
-      Real z_x = gxx*zx + gxy*zy + gxz*zz;
-      Real z_y = gxy*zx + gyy*zy + gyz*zz;
-      Real z_z = gxz*zx + gyz*zy + gzz*zz;
-      Real W = std::sqrt(z_x*zx + z_y*zy + z_z*zz + 1);
-
-      vel[0] += alp*zx/W;
-      vel[1] += alp*zy/W;
-      vel[2] += alp*zz/W;
+//! \fn void CompactObjectTracker::SetStencil
+//! \brief Sets the MeshBlock and cell indices, and the Lagrange weights (stored as
+//! wghts[3*i + direction] for i < 2*ng), of the stencil used to interpolate to the
+//! position of the CO.  Since the CO moves much less than a MeshBlock per cycle, the
+//! MeshBlock found last time is tried first.  indcs[0] is -1 if the CO is not on this
+//! rank.
+
+void CompactObjectTracker::SetStencil(MeshBlockPack *pmbp, int indcs[4], Real *wghts) {
+  auto &mb_indcs = pmbp->pmesh->mb_indcs;
+  auto &size = pmbp->pmb->mb_size;
+  int nmb = pmbp->nmb_thispack;
+  int &ng = mb_indcs.ng;
+
+  auto contains = [&](int m) {
+    return ((pos[0] >= size.h_view(m).x1min && pos[0] < size.h_view(m).x1max) &&
+            (pos[1] >= size.h_view(m).x2min && pos[1] < size.h_view(m).x2max) &&
+            (pos[2] >= size.h_view(m).x3min && pos[2] < size.h_view(m).x3max));
+  };
+  if (mb_last < 0 || mb_last >= nmb || !contains(mb_last)) {
+    mb_last = -1;
+    for (int m = 0; m < nmb; ++m) {
+      if (contains(m)) {
+        mb_last = m;
+        break;
+      }
     }
-  } else {
-    owns_compact_object = false;
   }
 
-  delete S;
+  indcs[0] = mb_last;
+  if (mb_last < 0) {  // CO not on this rank
+    for (int n = 0; n < 3; ++n) {
+      indcs[n+1] = -1;
+    }
+    for (int i = 0; i < 3*2*ng; ++i) {
+      wghts[i] = 0.;
+    }
+    return;
+  }
+
+  const RegionSize &s = size.h_view(mb_last);
+  Real xmin[3] = {s.x1min, s.x2min, s.x3min};
+  Real xmax[3] = {s.x1max, s.x2max, s.x3max};
+  Real dx[3] = {s.dx1, s.dx2, s.dx3};
+  int nx[3] = {mb_indcs.nx1, mb_indcs.nx2, mb_indcs.nx3};
+  for (int n = 0; n < 3; ++n) {
+    indcs[n+1] = static_cast<int>(std::floor((pos[n] - (xmin[n] + dx[n]/2.0))/dx[n]));
+    for (int i = 0; i < 2*ng; ++i) {
+      Real xi = CellCenterX(indcs[n+1] - ng + i + 1, nx[n], xmin[n], xmax[n]);
+      Real w = 1.;
+      for (int j = 0; j < 2*ng; ++j) {
+        if (j != i) {
+          Real xj = CellCenterX(indcs[n+1] - ng + j + 1, nx[n], xmin[n], xmax[n]);
+          w *= (pos[n] - xj)/(xi - xj);
+        }
+      }
+      wghts[3*i + n] = w;
+    }
+  }
 }
 
 //----------------------------------------------------------------------------------------
-void CompactObjectTracker::EvolveTracker() {
-  if (owns_compact_object) {
-    for (int a = 0; a < NDIM; ++a) {
-      pos[a] += pmesh->dt * vel[a];
-    }
-#if !(MPI_PARALLEL_ENABLED)
-  } else {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl;
-    std::cout << "couldn't find the compact object!" << std::endl;
-    std::exit(EXIT_FAILURE);
+//! \fn void CompactObjectTracker::SetVelocity
+//! \brief Sets the velocity of the CO from the interpolated variables vals: the shift
+//! (x,y,z), and for a neutron star also the lapse, fluid velocity (IVX,IVY,IVZ), and
+//! spatial metric (xx,xy,xz,yy,yz,zz).  Only used if the CO is on this rank.
+
+void CompactObjectTracker::SetVelocity(const Real *vals) {
+  owns_compact_object = true;
+  vel[0] = - vals[0];
+  vel[1] = - vals[1];
+  vel[2] = - vals[2];
+  if (type == NeutronStar) {
+    Real alp = vals[3];
+    Real zx = vals[4], zy = vals[5], zz = vals[6];
+    Real gxx = vals[7], gxy = vals[8], gxz = vals[9];
+    Real gyy = vals[10], gyz = vals[11], gzz = vals[12];
+
+    Real z_x = gxx*zx + gxy*zy + gxz*zz;
+    Real z_y = gxy*zx + gyy*zy + gyz*zz;
+    Real z_z = gxz*zx + gyz*zy + gzz*zz;
+    Real W = std::sqrt(z_x*zx + z_y*zy + z_z*zz + 1);
+
+    vel[0] += alp*zx/W;
+    vel[1] += alp*zy/W;
+    vel[2] += alp*zz/W;
   }
-#else
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CompactObjectTracker::EvolveTrackers
+//! \brief Updates the positions of all COs on the ranks that own them, and broadcasts
+//! the positions and velocities of all COs with a single reduction.
+
+void CompactObjectTracker::EvolveTrackers(
+    std::vector<std::unique_ptr<CompactObjectTracker>> &trackers) {
+  for (auto &pt : trackers) {
+    if (pt->owns_compact_object) {
+      for (int a = 0; a < NDIM; ++a) {
+        pt->pos[a] += pt->pmesh->dt * pt->vel[a];
+      }
+#if !(MPI_PARALLEL_ENABLED)
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl;
+      std::cout << "couldn't find the compact object!" << std::endl;
+      std::exit(EXIT_FAILURE);
+#endif
+    }
   }
-  Real buf[2 * NDIM + 1] = {0., 0., 0., 0., 0., 0., 0.};
-  if (owns_compact_object) {
-    buf[0] = pos[0];
-    buf[1] = pos[1];
-    buf[2] = pos[2];
-    buf[3] = vel[0];
-    buf[4] = vel[1];
-    buf[5] = vel[2];
-    buf[6] = 1.0;
+
+#if MPI_PARALLEL_ENABLED
+  const int nbuf = 2 * NDIM + 1;
+  std::vector<Real> buf(nbuf*trackers.size(), 0.);
+  for (std::size_t n = 0; n < trackers.size(); ++n) {
+    auto &pt = trackers[n];
+    if (pt->owns_compact_object) {
+      for (int a = 0; a < NDIM; ++a) {
+        buf[nbuf*n + a] = pt->pos[a];
+        buf[nbuf*n + NDIM + a] = pt->vel[a];
+      }
+      buf[nbuf*n + 2*NDIM] = 1.0;
+    }
   }
-  MPI_Allreduce(
-    MPI_IN_PLACE, buf, 2 * NDIM + 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
-  if (buf[6] < 0.5) {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl;
-    std::cout << "The compact object has left the grid" << std::endl;
-    std::exit(EXIT_FAILURE);
+  MPI_Allreduce(MPI_IN_PLACE, buf.data(), buf.size(), MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
+  for (std::size_t n = 0; n < trackers.size(); ++n) {
+    auto &pt = trackers[n];
+    Real nown = buf[nbuf*n + 2*NDIM];
+    if (nown < 0.5) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl;
+      std::cout << "The compact object has left the grid" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    for (int a = 0; a < NDIM; ++a) {
+      pt->pos[a] = buf[nbuf*n + a] / nown;
+      pt->vel[a] = buf[nbuf*n + NDIM + a] / nown;
+    }
   }
-  pos[0] = buf[0] / buf[6];
-  pos[1] = buf[1] / buf[6];
-  pos[2] = buf[2] / buf[6];
-  vel[0] = buf[3] / buf[6];
-  vel[1] = buf[4] / buf[6];
-  vel[2] = buf[5] / buf[6];
 #endif // MPI_PARALLEL_ENABLED
 
   // After the compact object has moved it might have changed ownership
-  owns_compact_object = false;
+  for (auto &pt : trackers) {
+    pt->owns_compact_object = false;
+  }
 }
 
 //----------------------------------------------------------------------------------------
+//! \fn void CompactObjectTracker::WriteTracker
+//! \brief Appends the current position and velocity to the output file.  With
+//! <job>/host_threads the row is written by a host thread, after the previous row.
+
 void CompactObjectTracker::WriteTracker() {
   if (0 == global_variable::my_rank && 0 == pmesh->ncycle % out_every) {
-    ofile << pmesh->ncycle << " "
-          << pmesh->time << " "
-          << pos[0] << " "
-          << pos[1] << " "
-          << pos[2] << " "
-          << vel[0] << " "
-          << vel[1] << " "
-          << vel[2] << std::endl << std::flush;
+    int ncycle = pmesh->ncycle;
+    Real time = pmesh->time;
+    std::array<Real, 2*NDIM> pv = {pos[0], pos[1], pos[2], vel[0], vel[1], vel[2]};
+    write_done = host_tasks::Submit([this, ncycle, time, pv]() {
+      ofile << ncycle << " "
+            << time << " "
+            << pv[0] << " "
+            << pv[1] << " "
+            << pv[2] << " "
+            << pv[3] << " "
+            << pv[4] << " "
+            << pv[5] << std::endl << std::flush;
+    }, write_done);
   }
 }
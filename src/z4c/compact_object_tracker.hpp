@@ -7,9 +7,13 @@
 #ifndef Z4C_COMPACT_OBJECT_TRACKER_HPP_
 #define Z4C_COMPACT_OBJECT_TRACKER_HPP_
 
+#include <array>
 #include <cstdio>
 #include <fstream>
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
@@ -29,10 +33,15 @@ class CompactObjectTracker {
   CompactObjectTracker(Mesh *pmesh, ParameterInput *pin, int n);
   //! Destructor (will close output file)
   ~CompactObjectTracker();
-  //! Interpolate the shift vector to the puncture position
-  void InterpolateVelocity(MeshBlockPack *pmbp);
-  //! Update and broadcast the puncture position
-  void EvolveTracker();
+  //! Number of variables interpolated for each type of compact object
+  static constexpr int nvars_bh = 3, nvars_ns = 13;
+  //! Set indices (-1 if not on this rank) and weights of the interpolation stencil
+  void SetStencil(MeshBlockPack *pmbp, int indcs[4], Real *wghts);
+  //! Set velocity from the variables interpolated to the position of the CO
+  void SetVelocity(const Real *vals);
+  //! Update and broadcast the positions of all COs with a single reduction
+  static void EvolveTrackers(
+      std::vector<std::unique_ptr<CompactObjectTracker>> &trackers);
   //! Write data to file
   void WriteTracker();
   //! Get position array
@@ -47,6 +56,10 @@ class CompactObjectTracker {
   inline void SetPos(Real npos[NDIM]) {
     std::memcpy(pos, npos, NDIM*sizeof(Real));
   }
+  //! Get velocity
+  inline Real GetVel(int a) const {
+    return vel[a];
+  }
   //! Get wanted refinement level
   inline int GetReflevel() const {
     return reflevel;
@@ -55,6 +68,10 @@ class CompactObjectTracker {
   inline Real GetRadius() const {
     return radius;
   }
+  //! True for neutron stars, whose velocity also depends on the fluid
+  inline bool IsNeutronStar() const {
+    return type == NeutronStar;
+  }
 
  private:
   bool owns_compact_object;
@@ -65,7 +82,9 @@ class CompactObjectTracker {
   Mesh const *pmesh;
   int out_every;
   std::ofstream ofile;
+  std::shared_future<void> write_done;  // host task writing last row to ofile
   Real pos[NDIM];
+  int mb_last;          // MeshBlock that contained the CO when stencil was last set
 };
 
 #endif // Z4C_COMPACT_OBJECT_TRACKER_HPP_
@@ -16,6 +16,7 @@
 #include <string>
 #include <cstdio>
 #include <utility>
+#include <vector>
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
@@ -72,13 +73,76 @@ HorizonDump::HorizonDump(MeshBlockPack *pmbp, ParameterInput *pin, int n, int is
   variable_to_dump.push_back(std::make_pair(pmbp->padm->I_ADM_KYY, false));
   variable_to_dump.push_back(std::make_pair(pmbp->padm->I_ADM_KYZ, false));
   variable_to_dump.push_back(std::make_pair(pmbp->padm->I_ADM_KZZ, false));
+
+  if (0 == global_variable::my_rank) {
+    writer = std::thread(&HorizonDump::WriterLoop, this);
+  }
 }
 
 //----------------------------------------------------------------------------------------
 HorizonDump::~HorizonDump() {
+  // write any remaining dumps before returning
+  if (writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(writer_mutex);
+      writer_stop = true;
+    }
+    writer_cv.notify_one();
+    writer.join();
+  }
   delete pcat_grid;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonDump::WriterLoop
+//! \brief Background thread that writes queued dumps (and the Einstein Toolkit parameter
+//! files) in order, until the HorizonDump is destroyed.
+
+void HorizonDump::WriterLoop() {
+  while (true) {
+    DumpData dump;
+    {
+      std::unique_lock<std::mutex> lock(writer_mutex);
+      writer_cv.wait(lock, [this]() {return writer_stop || !writer_queue.empty();});
+      if (writer_queue.empty()) break;  // only reached once writer_stop is set
+      dump = std::move(writer_queue.front());
+      writer_queue.pop_front();
+    }
+    WriteDump(dump);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonDump::WriteDump
+//! \brief Writes the interpolated data of one dump, and the Einstein Toolkit parameter
+//! file used to find the horizon from it
+
+void HorizonDump::WriteDump(const DumpData &dump) {
+  std::string foldername = "horizon_"+std::to_string(horizon_ind)
+                        +"/output_"+std::to_string(dump.count);
+  mkdir(foldername.c_str(),0775);
+
+  std::string fname = foldername + "/etk_output_file.dat";
+  FILE* etk_output_file = fopen(fname.c_str(), "wb");
+  if (etk_output_file == nullptr) {
+    perror("Error opening file");
+    return;
+  }
+  fwrite(&common_horizon, sizeof(int), 1, etk_output_file);
+  fwrite(&dump.time, sizeof(Real), 1, etk_output_file);
+  // Write the 4D array to the binary file
+  size_t elementsWritten = fwrite(dump.data.data(), sizeof(Real), dump.data.size(),
+                                  etk_output_file);
+  if (elementsWritten != dump.data.size()) {
+    perror("Error writing to file");
+  }
+  // Close the file
+  fclose(etk_output_file);
+
+  // Write input script for Einstein Toolkit
+  ETK_setup_parfile(dump.count);
+}
+
 void HorizonDump::SetGridAndInterpolate(Real center[NDIM]) {
   // update center location
   pos[0] = center[0];
@@ -93,8 +157,9 @@ void HorizonDump::SetGridAndInterpolate(Real center[NDIM]) {
   // Define the size of each dimension
   int count = horizon_nx * horizon_nx * horizon_nx * 16;
 
-  // Dynamically allocate memory for the 4D array flattened into 1D
-  Real* data_out = new Real[count];
+  // 4D array flattened into 1D, handed to the writer thread once reduced
+  std::vector<Real> data(count);
+  Real* data_out = data.data();
 
   for(int nvar=0; nvar<16; nvar++) {
     // Interpolate here
@@ -124,44 +189,25 @@ void HorizonDump::SetGridAndInterpolate(Real center[NDIM]) {
     MPI_Reduce(data_out, data_out, count, MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
   }
   #endif
-  // Then write output file
-  // Open the file in binary write mode
-  std::string foldername = "horizon_"+std::to_string(horizon_ind)
-                        +"/output_"+std::to_string(output_count);
-  mkdir(foldername.c_str(),0775);
 
+  // Queue data for output by the writer thread
   if (0 == global_variable::my_rank) {
-    std::string fname = foldername + "/etk_output_file.dat";
-    FILE* etk_output_file = fopen(fname.c_str(), "wb");
-    if (etk_output_file == nullptr) {
-      perror("Error opening file");
-      return;
-    }
-    fwrite(&common_horizon, sizeof(int), 1, etk_output_file);
-    fwrite(&pmbp->pmesh->time, sizeof(Real), 1, etk_output_file);
-    // Write the 4D array to the binary file
-    size_t elementsWritten = fwrite(data_out, sizeof(Real), count, etk_output_file);
-    if (elementsWritten != count) {
-      perror("Error writing to file");
+    {
+      std::lock_guard<std::mutex> lock(writer_mutex);
+      writer_queue.push_back({output_count, pmbp->pmesh->time, std::move(data)});
     }
-    // Close the file
-    fclose(etk_output_file);
-
-    // Write input script for Einstein Toolkit
-    ETK_setup_parfile();
-    output_count++;
-    // delete dataout
-    delete[] data_out;
+    writer_cv.notify_one();
   }
+  output_count++;
 }
 
-void HorizonDump::ETK_setup_parfile() {
+void HorizonDump::ETK_setup_parfile(int count) {
   std::string foldername;
   if (common_horizon == 0) {
     foldername = "horizon_"+std::to_string(horizon_ind)+
-                "/output_"+std::to_string(output_count);
+                "/output_"+std::to_string(count);
   } else {
-    foldername = "horizon_common/output_"+std::to_string(output_count);
+    foldername = "horizon_common/output_"+std::to_string(count);
   }
   std::string fname = foldername + "/ET_analyze_BHaH_data_horizon.par";
 
@@ -7,9 +7,13 @@
 #ifndef Z4C_HORIZON_DUMP_HPP_
 #define Z4C_HORIZON_DUMP_HPP_
 
+#include <condition_variable>  // NOLINT(build/c++11)
 #include <cstdio>
+#include <deque>
 #include <fstream>
+#include <mutex>  // NOLINT(build/c++11)
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 #include <utility>
 
@@ -35,8 +39,8 @@ class HorizonDump {
   // Interpolate field to Cartesian Grid centered at the puncture locations
   void SetGridAndInterpolate(Real center[NDIM]);
 
-  //! Write parameter file for Einstein Toolkit
-  void ETK_setup_parfile();
+  //! Write parameter file for Einstein Toolkit for output number count
+  void ETK_setup_parfile(int count);
 
   int horizon_nx;  // number of points in each direction
   int common_horizon; // common horizon or not, triggering when to start dumping data
@@ -56,6 +60,21 @@ class HorizonDump {
   // first element store variable index second
   // store whether from z4c (true) or adm (false) array
   std::vector<std::pair<int, bool>> variable_to_dump;
+
+  // dumps are written by a background thread (rank 0 only), so that evolution does
+  // not wait on the file system
+  struct DumpData {
+    int count;               // output number
+    Real time;
+    std::vector<Real> data;  // reduced interpolated data
+  };
+  std::thread writer;
+  std::mutex writer_mutex;
+  std::condition_variable writer_cv;
+  std::deque<DumpData> writer_queue;
+  bool writer_stop = false;
+  void WriterLoop();
+  void WriteDump(const DumpData &dump);
 };
 
 #endif // Z4C_HORIZON_DUMP_HPP_
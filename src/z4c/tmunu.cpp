@@ -33,6 +33,46 @@ Tmunu::Tmunu(MeshBlockPack *ppack, ParameterInput *pin):
   tmunu.S_dd.InitWithShallowSlice(u_tmunu, I_Tmunu_Sxx, I_Tmunu_Szz);
   tmunu.E.InitWithShallowSlice(u_tmunu, I_Tmunu_E);
   tmunu.S_d.InitWithShallowSlice(u_tmunu, I_Tmunu_Sx, I_Tmunu_Sz);
+
+  vacuum_threshold = pin->GetOrAddReal("z4c", "tmunu_vacuum_threshold", 0.0);
+  Kokkos::realloc(tmunu.matter, nmb);
+  Kokkos::deep_copy(tmunu.matter, 1);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Tmunu::SetMatterBlocks
+//! \brief Flags MBs which contain matter, i.e. in which the energy density E exceeds
+//! vacuum_threshold in at least one active cell.  Called after Tmunu is set.
+
+void Tmunu::SetMatterBlocks() {
+  if (vacuum_threshold <= 0.0) return;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  int nmb = pmy_pack->nmb_thispack;
+  Real thresh = vacuum_threshold;
+  auto &E = tmunu.E;
+  auto &matter = tmunu.matter;
+
+  par_for_outer("tmunu_matter",DevExeSpace(), 0, 0, 0, (nmb-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+    int nabove = 0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+    [=](const int idx, int &sum) {
+      int k = (idx)/nji;
+      int j = (idx - k*nji)/nx1;
+      int i = (idx - k*nji - j*nx1) + is;
+      j += js;
+      k += ks;
+      if (E(m,k,j,i) > thresh) {sum++;}
+    },Kokkos::Sum<int>(nabove));
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+      matter(m) = (nabove > 0)? 1 : 0;
+    });
+  });
 }
 
 Tmunu::~Tmunu() {}
@@ -40,12 +40,18 @@ class Tmunu {
     AthenaTensor<Real, TensorSymm::NONE, 3, 0> E;      // energy density
     AthenaTensor<Real, TensorSymm::NONE, 3, 1> S_d;    // momentum density
     AthenaTensor<Real, TensorSymm::SYM2, 3, 2> S_dd;   // stress tensor
+    DvceArray1D<int> matter;                           // 0 in MBs treated as vacuum
   };
 
   Tmunu_vars tmunu;
 
   DvceArray5D<Real> u_tmunu;                          // Tmunu
 
+  // MBs in which E is below vacuum_threshold in every active cell are treated as vacuum
+  // by the Z4c RHS, which then skips the matter source terms.  Disabled if zero.
+  Real vacuum_threshold;
+  void SetMatterBlocks();
+
  private:
   MeshBlockPack* pmy_pack;
 };
@@ -24,8 +24,10 @@
 #include "z4c/horizon_dump.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
+#include "z4c/z4c_update.hpp"
 #include "coordinates/adm.hpp"
 #include "utils/cart_grid.hpp"
+#include "utils/host_tasks.hpp"
 
 namespace z4c {
 
@@ -75,6 +77,7 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   int nmb = std::max((ppack->nmb_thispack), (ppack->pmesh->nmb_maxperrank));
   // int nmb = ppack->nmb_thispack;
   auto &indcs = pmy_pack->pmesh->mb_indcs;
+  low_storage = Driver::LowStorage2N(pin->GetOrAddString("time", "integrator", "rk2"));
   {
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
   int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
@@ -84,8 +87,13 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   // Matter commented out
   // kokkos::realloc(u_mat, nmb, (N_MAT), ncells3, ncells2, ncells1);
   Kokkos::realloc(u0,    nmb, (nz4c), ncells3, ncells2, ncells1);
-  Kokkos::realloc(u1,    nmb, (nz4c), ncells3, ncells2, ncells1);
+  if (!(low_storage)) {
+    Kokkos::realloc(u1,    nmb, (nz4c), ncells3, ncells2, ncells1);
+  }
   Kokkos::realloc(u_rhs, nmb, (nz4c), ncells3, ncells2, ncells1);
+  if (Driver::EmbeddedPair(pin->GetOrAddString("time", "integrator", "rk2"))) {
+    Kokkos::realloc(u_start, nmb, (nz4c), ncells3, ncells2, ncells1);
+  }
   Kokkos::realloc(u_weyl,    nmb, (2), ncells3, ncells2, ncells1);
 
   con.C.InitWithShallowSlice(u_con, I_CON_C);
@@ -99,23 +107,7 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   //mat.S_d.InitWithShallowSlice(u_mat, I_MAT_Sx, I_MAT_Sz);
   //mat.S_dd.InitWithShallowSlice(u_mat, I_MAT_Sxx, I_MAT_Szz);
 
-  z4c.alpha.InitWithShallowSlice (u0, I_Z4C_ALPHA);
-  z4c.beta_u.InitWithShallowSlice(u0, I_Z4C_BETAX, I_Z4C_BETAZ);
-  z4c.chi.InitWithShallowSlice   (u0, I_Z4C_CHI);
-  z4c.vKhat.InitWithShallowSlice  (u0, I_Z4C_KHAT);
-  z4c.vTheta.InitWithShallowSlice (u0, I_Z4C_THETA);
-  z4c.vGam_u.InitWithShallowSlice (u0, I_Z4C_GAMX, I_Z4C_GAMZ);
-  z4c.g_dd.InitWithShallowSlice  (u0, I_Z4C_GXX, I_Z4C_GZZ);
-  z4c.vA_dd.InitWithShallowSlice  (u0, I_Z4C_AXX, I_Z4C_AZZ);
-
-  rhs.alpha.InitWithShallowSlice (u_rhs, I_Z4C_ALPHA);
-  rhs.beta_u.InitWithShallowSlice(u_rhs, I_Z4C_BETAX, I_Z4C_BETAZ);
-  rhs.chi.InitWithShallowSlice   (u_rhs, I_Z4C_CHI);
-  rhs.vKhat.InitWithShallowSlice  (u_rhs, I_Z4C_KHAT);
-  rhs.vTheta.InitWithShallowSlice (u_rhs, I_Z4C_THETA);
-  rhs.vGam_u.InitWithShallowSlice (u_rhs, I_Z4C_GAMX, I_Z4C_GAMZ);
-  rhs.g_dd.InitWithShallowSlice  (u_rhs, I_Z4C_GXX, I_Z4C_GZZ);
-  rhs.vA_dd.InitWithShallowSlice  (u_rhs, I_Z4C_AXX, I_Z4C_AZZ);
+  SetZ4cAliases();
 
   weyl.rpsi4.InitWithShallowSlice (u_weyl, 0);
   weyl.ipsi4.InitWithShallowSlice (u_weyl, 1);
@@ -154,6 +146,64 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
       pin->GetOrAddInteger("z4c", "extrap_order", 2))));
 
   diss = opt.diss*pow(2., -2.*indcs.ng)*(indcs.ng % 2 == 0 ? -1. : 1.);
+
+  // kernels used to compute RHS.  With tiled_rhs, tiles of Z4c variables are stored in
+  // team scratch memory; tile dimensions (in active cells) should be tuned to the
+  // available scratch memory.  With phased_rhs, derivatives of chunks of rhs_chunk_nmb
+  // MBs are stored in a temporary array.  With autotune_rhs, the fastest kernels,
+  // tiles, and team sizes are measured the first time the RHS is computed.
+  bool tiled_rhs = pin->GetOrAddBoolean("z4c", "tiled_rhs", false);
+  bool phased_rhs = pin->GetOrAddBoolean("z4c", "phased_rhs", false);
+  autotune_rhs = pin->GetOrAddBoolean("z4c", "autotune_rhs", false);
+  if (tiled_rhs && phased_rhs) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<z4c>/tiled_rhs and <z4c>/phased_rhs cannot both be true"
+      << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (tiled_rhs) rhs_pipeline = RHSPipeline::tiled;
+  if (phased_rhs) rhs_pipeline = RHSPipeline::phased;
+  tile_nx1 = std::min(pin->GetOrAddInteger("z4c", "tile_nx1", 4), indcs.nx1);
+  tile_nx2 = std::min(pin->GetOrAddInteger("z4c", "tile_nx2", 4), indcs.nx2);
+  tile_nx3 = std::min(pin->GetOrAddInteger("z4c", "tile_nx3", 4), indcs.nx3);
+  rhs_chunk_nmb = pin->GetOrAddInteger("z4c", "rhs_chunk_nmb", 4);
+  tsize_drv = pin->GetOrAddInteger("z4c", "deriv_team_size", 0);
+  tsize_alg = pin->GetOrAddInteger("z4c", "algebra_team_size", 0);
+  tsize_diss = pin->GetOrAddInteger("z4c", "diss_team_size", 0);
+  if (tile_nx1 < 1 || tile_nx2 < 1 || tile_nx3 < 1 || rhs_chunk_nmb < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<z4c>/tile_nx1,tile_nx2,tile_nx3,rhs_chunk_nmb must be positive"
+      << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // With fused_update, the RK update (and algebraic constraints) are applied in the
+  // tiled RHS kernel, except in cells modified by the Sommerfeld BCs
+  fused_update = pin->GetOrAddBoolean("z4c", "fused_update", false);
+  if (fused_update && low_storage) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<z4c>/fused_update cannot be used with 2N-storage integrators"
+      << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // ratio of spacetime to matter timestep with multirate coupling to GRMHD.  The
+  // spacetime macro step is limited by its own CFL number.
+  multirate = pin->GetOrAddInteger("z4c", "multirate", 1);
+  multirate_cfl = pin->GetOrAddReal("z4c", "multirate_cfl", ppack->pmesh->cfl_no);
+  if (multirate < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<z4c>/multirate must be >= 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (tiled_rhs || fused_update) {
+    size_t scr_max = Kokkos::TeamPolicy<>::scratch_size_max(1);
+    if (TiledRHSScratchSize() > scr_max) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Tiles for <z4c>/tiled_rhs need " << TiledRHSScratchSize()
+        << " bytes of scratch memory, but only " << scr_max << " are available. "
+        << "Reduce tile_nx1, tile_nx2, or tile_nx3" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
   }
 
   // allocate memory for conserved variables on coarse mesh
@@ -185,10 +235,17 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
     Real rad = pin->GetOrAddReal("z4c", "extraction_radius_"+std::to_string(i), 10);
     grids.push_back(std::make_unique<SphericalGrid>(ppack, nlev, rad));
   }
-  // TODO(@dur566): Why is the size of psi_out hardcoded?
-  psi_out = new Real[nrad*77*2];
+  wave_lmax = pin->GetOrAddInteger("z4c", "extraction_lmax", 8);
+  if (wave_lmax < 2) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<z4c>/extraction_lmax must be at least 2" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // real and imaginary parts of modes with 2<=l<=wave_lmax on each sphere
+  psi_out = new Real[nrad*((wave_lmax + 1)*(wave_lmax + 1) - 4)*2];
   if (nrad > 0) {
     mkdir("waveforms",0775);
+    SetWaveExtrHarmonics();
   }
   waveform_dt = pin->GetOrAddReal("z4c", "waveform_dt", 1);
   last_output_time = 0;
@@ -242,12 +299,44 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   */
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::SetZ4cAliases()
+//! \brief Sets the AthenaTensor aliases of u0 and u_rhs (and the lapse and shift in the
+//! ADM class).  Called again whenever u0 and u_rhs are swapped.
+
+void Z4c::SetZ4cAliases() {
+  z4c.alpha.InitWithShallowSlice (u0, I_Z4C_ALPHA);
+  z4c.beta_u.InitWithShallowSlice(u0, I_Z4C_BETAX, I_Z4C_BETAZ);
+  z4c.chi.InitWithShallowSlice   (u0, I_Z4C_CHI);
+  z4c.vKhat.InitWithShallowSlice  (u0, I_Z4C_KHAT);
+  z4c.vTheta.InitWithShallowSlice (u0, I_Z4C_THETA);
+  z4c.vGam_u.InitWithShallowSlice (u0, I_Z4C_GAMX, I_Z4C_GAMZ);
+  z4c.g_dd.InitWithShallowSlice  (u0, I_Z4C_GXX, I_Z4C_GZZ);
+  z4c.vA_dd.InitWithShallowSlice  (u0, I_Z4C_AXX, I_Z4C_AZZ);
+
+  rhs.alpha.InitWithShallowSlice (u_rhs, I_Z4C_ALPHA);
+  rhs.beta_u.InitWithShallowSlice(u_rhs, I_Z4C_BETAX, I_Z4C_BETAZ);
+  rhs.chi.InitWithShallowSlice   (u_rhs, I_Z4C_CHI);
+  rhs.vKhat.InitWithShallowSlice  (u_rhs, I_Z4C_KHAT);
+  rhs.vTheta.InitWithShallowSlice (u_rhs, I_Z4C_THETA);
+  rhs.vGam_u.InitWithShallowSlice (u_rhs, I_Z4C_GAMX, I_Z4C_GAMZ);
+  rhs.g_dd.InitWithShallowSlice  (u_rhs, I_Z4C_GXX, I_Z4C_GZZ);
+  rhs.vA_dd.InitWithShallowSlice  (u_rhs, I_Z4C_AXX, I_Z4C_AZZ);
+
+  if (pmy_pack->padm != nullptr) {
+    pmy_pack->padm->adm.alpha.InitWithShallowSlice(u0, I_Z4C_ALPHA);
+    pmy_pack->padm->adm.beta_u.InitWithShallowSlice(u0, I_Z4C_BETAX, I_Z4C_BETAZ);
+  }
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Z4c::AlgConstr(AthenaArray<Real> & u)
 //! \brief algebraic constraints projection
 //
-// This function operates on all grid points of the MeshBlock
-void Z4c::AlgConstr(MeshBlockPack *pmbp) {
+// This function operates on all grid points of the MeshBlock, or only on the ghost
+// zones if ghosts_only is true (when the constraints were already applied to the active
+// cells by the fused RHS/update kernel).
+void Z4c::AlgConstr(MeshBlockPack *pmbp, const bool ghosts_only) {
   // capture variables for the kernel
   auto &indcs = pmbp->pmesh->mb_indcs;
   int &is = indcs.is; int &ie = indcs.ie;
@@ -260,42 +349,29 @@ void Z4c::AlgConstr(MeshBlockPack *pmbp) {
 
   int nmb = pmbp->nmb_thispack;
 
-  auto &z4c = pmbp->pz4c->z4c;
+  auto &u0 = pmbp->pz4c->u0;
   par_for("Alg constr loop",DevExeSpace(),
   0,nmb-1,ksg,keg,jsg,jeg,isg,ieg,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    Real detg = adm::SpatialDet(z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i),
-                              z4c.g_dd(m,0,2,k,j,i),z4c.g_dd(m,1,1,k,j,i),
-                              z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i));
-    detg = detg > 0. ? detg : 1.;
-    // Real eps = detg - 1.;
-    // Real oopsi4 = (eps < opt.eps_floor) ? (1. - opt.eps_floor/3.) :
-    //             (std::pow(1./detg, 1./3.));
-    Real oopsi4 = std::cbrt(1./detg);
-
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      z4c.g_dd(m,a,b,k,j,i) *= oopsi4;
+    if (ghosts_only && i >= is && i <= ie && j >= js && j <= je && k >= ks && k <= ke) {
+      return;
     }
-
-    // compute trace of A
-    // note: here we are assuming that det g = 1, which we enforced above
-    Real A = adm::Trace(1.0,
-              z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i), z4c.g_dd(m,0,2,k,j,i),
-              z4c.g_dd(m,1,1,k,j,i), z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i),
-              z4c.vA_dd(m,0,0,k,j,i), z4c.vA_dd(m,0,1,k,j,i), z4c.vA_dd(m,0,2,k,j,i),
-              z4c.vA_dd(m,1,1,k,j,i), z4c.vA_dd(m,1,2,k,j,i), z4c.vA_dd(m,2,2,k,j,i));
-
-    // enforce trace of A to be zero
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      z4c.vA_dd(m,a,b,k,j,i) -= (1.0/3.0) * A * z4c.g_dd(m,a,b,k,j,i);
+    Real g[6], A[6];
+    for (int n = 0; n < 6; ++n) {
+      g[n] = u0(m,I_Z4C_GXX+n,k,j,i);
+      A[n] = u0(m,I_Z4C_AXX+n,k,j,i);
+    }
+    AlgConstrPoint(g, A);
+    for (int n = 0; n < 6; ++n) {
+      u0(m,I_Z4C_GXX+n,k,j,i) = g[n];
+      u0(m,I_Z4C_AXX+n,k,j,i) = A[n];
     }
   });
 }
 //----------------------------------------------------------------------------------------
 // destructor
 Z4c::~Z4c() {
+  host_tasks::Wait(wave_write_done);
   delete[] psi_out;
   delete pbval_u;
   delete pbval_weyl;
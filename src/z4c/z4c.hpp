@@ -8,6 +8,7 @@
 //! \file z4c.hpp
 //! \brief definitions for Z4c class
 
+#include <future>    // NOLINT(build/c++11)
 #include <map>
 #include <memory>    // make_unique, unique_ptr
 #include <list>
@@ -15,6 +16,7 @@
 #include <vector>
 #include "athena.hpp"
 #include "utils/finite_diff.hpp"
+#include "utils/fd_stencil.hpp"
 #include "utils/cart_grid.hpp"
 #include "parameter_input.hpp"
 #include "tasklist/task_list.hpp"
@@ -32,6 +34,10 @@ class HorizonDump;
 namespace z4c {
 class Z4c_AMR;
 
+// kernels used to compute the RHS: one fused kernel, one kernel over tiles stored in
+// scratch memory, or separate kernels for derivatives/algebra/dissipation
+enum class RHSPipeline {fused, tiled, phased};
+
 // Shift needed for derivatives
 //----------------------------------------------------------------------------------------
 //! \class Z4c
@@ -81,7 +87,7 @@ class Z4c {
   DvceArray5D<Real> u_con;     // constraints fields
   DvceArray5D<Real> u_mat;
   DvceArray5D<Real> u0;        // z4c solution
-  DvceArray5D<Real> u1;        // z4c solution at intermediate timestep
+  DvceArray5D<Real> u1;        // z4c solution at intermediate timestep (not with 2N)
   DvceArray5D<Real> u_rhs;     // z4c rhs storage
   DvceArray5D<Real> coarse_u0; // coarse representation of z4c solution
   DvceArray5D<Real> u_weyl; // weyl scalars
@@ -180,6 +186,29 @@ class Z4c {
   Options opt;
   Real diss;              // Dissipation parameter
 
+  // kernels and launch configuration used to compute RHS
+  RHSPipeline rhs_pipeline = RHSPipeline::fused;
+  bool autotune_rhs = false;         // choose pipeline/launch configuration at startup
+  int tile_nx1, tile_nx2, tile_nx3;  // dimensions of tiles in active cells (tiled)
+  int rhs_chunk_nmb;                 // number of MBs in each chunk (phased)
+  int tsize_drv = 0, tsize_alg = 0, tsize_diss = 0;  // team sizes (0 = default)
+  DvceArray5D<Real> u_drv;           // derivatives of z4c variables (phased)
+  static constexpr int nz4c_drv = 136;  // number of derivatives stored in u_drv
+  bool fused_update = false;         // RK update computed with RHS (u_rhs holds new u0)
+  // With 2N-storage integrators u1 is not allocated, and the RHS kernels accumulate
+  // u_rhs = rhs_a*u_rhs + rhs, where rhs_a is set for each stage by CalcRHS()
+  bool low_storage = false;
+  Real rhs_a = 0.0;
+  // Multirate coupling to GRMHD (z4c_multirate.cpp): spacetime is advanced over
+  // multirate*dt once every multirate cycles, ahead of the matter.  ADM variables used by
+  // the matter are interpolated in time between the start and end of the macro step, and
+  // Tmunu used by the spacetime is extrapolated from the previous two macro steps.
+  int multirate = 1;
+  Real multirate_cfl;                // CFL number of spacetime macro step
+  DvceArray5D<Real> adm_mr0, adm_mr1;      // ADM variables at start/end of macro step
+  DvceArray5D<Real> tmunu_mr0, tmunu_mr1;  // Tmunu at start of previous/current step
+  bool tmunu_mr_valid = false;             // tmunu_mr0 is set
+
   // Boundary communication buffers and functions for u
   MeshBoundaryValuesCC *pbval_u;
 
@@ -188,6 +217,8 @@ class Z4c {
 
   // following only used for time-evolving flow
   Real dtnew;
+  Real errnew = 0.0;           // error norm of step with embedded RK pairs
+  DvceArray5D<Real> u_start;   // z4c solution at start of step (embedded RK pairs)
 
   // geodesic grid for wave extr
   std::vector<std::unique_ptr<SphericalGrid>> spherical_grids;
@@ -196,6 +227,14 @@ class Z4c {
   Real waveform_dt;
   Real last_output_time;
   int nrad; // number of radii to perform wave extraction
+  int wave_lmax;  // maximum l of modes of psi4 computed by wave extraction
+  DvceArray3D<Real> wave_ylm;   // Y^{-2}_{lm} times solid angle at each angle
+  DvceArray3D<Real> wave_vals;  // psi4 interpolated to each sphere
+  DvceArray3D<Real> wave_psi;   // modes of psi4 on each sphere
+  std::shared_future<void> wave_write_done;  // host task writing last waveform rows
+  // MBs (and their neighbors) used to interpolate Weyl scalars to the extraction spheres
+  DualArray1D<int> weyl_mbs;   // indices of these MBs are the first nmb_weyl elements
+  int nmb_weyl = 0;
 
   // CCE
   Real cce_dump_dt;
@@ -218,6 +257,8 @@ class Z4c {
   TaskStatus Prolongate(Driver *pdrive, int stage);
   TaskStatus ProlongateWeyl(Driver *pdrive, int stage);
   TaskStatus ExpRKUpdate(Driver *d, int stage);
+  TaskStatus FusedRKUpdate(Driver *d, int stage);
+  TaskStatus LowStorageRKUpdate(Driver *d, int stage);
   TaskStatus NewTimeStep(Driver *d, int stage);
   TaskStatus ApplyPhysicalBCs(Driver *d, int stage);
   TaskStatus EnforceAlgConstr(Driver *d, int stage);
@@ -237,6 +278,22 @@ class Z4c {
   template <int NGHOST>
   TaskStatus CalcRHS(Driver *d, int stage);
   template <int NGHOST>
+  void CalcRHSFused();
+  template <int NGHOST>
+  void CalcRHSTiled();
+  template <int NGHOST>
+  void CalcRHSPhased();
+  template <int NGHOST>
+  void CalcRHSUpdate(Driver *d, int stage);
+  template <int NGHOST>
+  void RHSDerivatives(const int m0, const int nm);
+  void RHSAlgebra(const int m0, const int nm);
+  template <int NGHOST>
+  void RHSDissipation();
+  template <int NGHOST>
+  void AutotuneRHS();
+  size_t TiledRHSScratchSize();
+  template <int NGHOST>
   void ADMToZ4c(MeshBlockPack *pmbp, ParameterInput *pin);
   void GaugePreCollapsedLapse(MeshBlockPack *pmbp, ParameterInput *pin);
   void Z4cToADM(MeshBlockPack *pmbp);
@@ -245,10 +302,22 @@ class Z4c {
   template <int NGHOST>
   void Z4cWeyl(MeshBlockPack *pmbp);
   void WaveExtr(MeshBlockPack *pmbp);
-  void AlgConstr(MeshBlockPack *pmbp);
+  void SetWaveExtrHarmonics();
+  int WeylMeshBlocks();
+  void AlgConstr(MeshBlockPack *pmbp, const bool ghosts_only = false);
+  void MultirateStartMacroStep(Driver *pdrive);
+  void MultirateExtrapolateTmunu(const Real frac);
+  void MultirateEndMacroStep();
+  void MultirateInterpolateADM(const Real frac);
+  void SetZ4cAliases();
 
   Z4c_AMR *pamr;
   std::vector<std::unique_ptr<CompactObjectTracker>> ptracker;
+  // interpolation to all compact object trackers in one kernel (z4c_trackers.cpp)
+  DualArray2D<int> tracker_indcs;   // (tracker, MB/i/j/k) of interpolation stencil
+  DualArray3D<Real> tracker_wghts;  // (tracker, point, direction) Lagrange weights
+  DualArray2D<Real> tracker_vals;   // (tracker, variable) interpolated values
+  void InterpolateTrackers();
   std::vector<std::unique_ptr<HorizonDump>> phorizon_dump;
 
   /*
@@ -263,6 +332,8 @@ class Z4c {
   // same for the waveform.
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Z4c
+  int weyl_version_ = -1;   // value of Mesh::mesh_version when weyl_mbs was set
+  int weyl_nmb_ = -1;       // number of MBs in pack when weyl_mbs was set
 };
 
 } // namespace z4c
@@ -0,0 +1,184 @@
+#ifndef Z4C_Z4C_SBC_HPP_
+#define Z4C_Z4C_SBC_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file z4c_Sbc.hpp
+//! \brief Sommerfeld boundary condition on the rhs of the Z4c variables in one cell,
+//! shared by Z4c::Z4cBoundaryRHS() and the tiled RHS kernels, which apply it in the same
+//! pass as the rhs in MeshBlocks at faces of the mesh.
+
+#include <math.h>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "z4c/z4c.hpp"
+#include "z4c/z4c_update.hpp"
+#include "coordinates/cell_locations.hpp"
+
+namespace z4c {
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::Z4cSommerfeld
+//! \brief apply Sommerfeld BCs to the given set of points.  With 2N-storage integrators
+//! (rhs_a != 0), rhs_a times the rhs at the previous stage is added, which was saved in
+//! the adjacent ghost cell (k+dk,j+dj,i+di) by Z4c::LowStorageRKUpdate().  The evolved
+//! variables are read through z4c, which is either the Z4c_vars aliases of u0, or a
+//! tile of u0 in team scratch memory (in the tiled RHS kernels).
+
+template <typename Z4cVars>
+KOKKOS_INLINE_FUNCTION
+void Z4cSommerfeld(const Z4cVars& z4c, const Z4c::Z4c_vars& rhs,
+    const RegionIndcs &indcs, const DualArray1D<RegionSize> &size, const Real rhs_a,
+    const int dk, const int dj, const int di,
+    const int m, const int k, const int j, const int i) {
+  // -------------------------------------------------------------------------------------
+  // Scratch data
+  //
+
+  // First derivatives
+  // Scalars
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dKhat_d;
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dTheta_d;
+
+  // Vectors
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 2> dGam_du;
+
+  // Tensors
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 3> dA_ddd;
+
+
+  // Psuedoradial vector
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> s_u;
+
+  Real idx[] = {1./size.d_view(m).dx1, 1./size.d_view(m).dx2, 1./size.d_view(m).dx3};
+
+  // -------------------------------------------------------------------------------------
+  // First derivatives
+  // We force all derivatives to be calculated at second-order, as this was found to
+  // be necessary for stability in Athena++.
+  //
+  for (int a = 0; a < 3; a++) {
+    dKhat_d(a) = Dx<2>(a, idx, z4c.vKhat, m, k, j, i);
+    dTheta_d(a) = Dx<2>(a, idx, z4c.vTheta, m, k, j, i);
+  }
+  for (int a = 0; a < 3; a++) {
+    for (int b = 0; b < 3; b++) {
+      dGam_du(b,a) = Dx<2>(b, idx, z4c.vGam_u, m, a, k, j, i);
+    }
+  }
+  for (int a = 0; a < 3; a++) {
+    for (int b = a; b < 3; b++) {
+      for (int c = 0; c < 3; c++) {
+        dA_ddd(c, a, b) = Dx<2>(c, idx, z4c.vA_dd, m, a, b, k, j, i);
+      }
+    }
+  }
+
+  // -------------------------------------------------------------------------------------
+  // Compute psuedo-radial vector
+  //
+  Real &x1min = size.d_view(m).x1min;
+  Real &x1max = size.d_view(m).x1max;
+  Real &x2min = size.d_view(m).x2min;
+  Real &x2max = size.d_view(m).x2max;
+  Real &x3min = size.d_view(m).x3min;
+  Real &x3max = size.d_view(m).x3max;
+
+  Real x1v = CellCenterX(i-indcs.is, indcs.nx1, x1min, x1max);
+  Real x2v = CellCenterX(j-indcs.js, indcs.nx2, x2min, x2max);
+  Real x3v = CellCenterX(k-indcs.ks, indcs.nx3, x3min, x3max);
+
+  Real r = sqrt(SQR(x1v) + SQR(x2v) + SQR(x3v));
+  s_u(0) = x1v/r;
+  s_u(1) = x2v/r;
+  s_u(2) = x3v/r;
+
+  // -------------------------------------------------------------------------------------
+  // Boundary RHS for scalars
+  //
+  rhs.vTheta(m,k,j,i) = - z4c.vTheta(m,k,j,i)/r;
+  rhs.vKhat(m,k,j,i) = - sqrt(2.) * z4c.vKhat(m,k,j,i)/r;
+  for (int a = 0; a < 3; a++) {
+    rhs.vTheta(m,k,j,i) -= s_u(a) * dTheta_d(a);
+    rhs.vKhat(m,k,j,i) -= sqrt(2.) * s_u(a) * dKhat_d(a);
+  }
+
+  // -------------------------------------------------------------------------------------
+  // Boundary RHS for Gamma
+  //
+  for (int a = 0; a < 3; a++) {
+    rhs.vGam_u(m,a,k,j,i) = - z4c.vGam_u(m, a, k, j, i)/r;
+    for (int b = 0; b < 3; b++) {
+      rhs.vGam_u(m,a,k,j,i) -= s_u(b) * dGam_du(b,a);
+    }
+  }
+
+  // -------------------------------------------------------------------------------------
+  // Boundary RHS for A_ab
+  //
+  for (int a = 0; a < 3; a++) {
+    for (int b = a; b < 3; b++) {
+      rhs.vA_dd(m,a,b,k,j,i) = - z4c.vA_dd(m,a,b,k,j,i)/r;
+      for (int c = 0; c < 3; c++) {
+        rhs.vA_dd(m,a,b,k,j,i) -= s_u(c) * dA_ddd(c,a,b);
+      }
+    }
+  }
+
+  // -------------------------------------------------------------------------------------
+  // Accumulate rhs from previous stage with 2N-storage integrators
+  //
+  if (rhs_a != 0.0) {
+    const int ko = k + dk, jo = j + dj, io = i + di;
+    rhs.vTheta(m,k,j,i) += rhs_a * rhs.vTheta(m,ko,jo,io);
+    rhs.vKhat(m,k,j,i) += rhs_a * rhs.vKhat(m,ko,jo,io);
+    for (int a = 0; a < 3; a++) {
+      rhs.vGam_u(m,a,k,j,i) += rhs_a * rhs.vGam_u(m,a,ko,jo,io);
+      for (int b = a; b < 3; b++) {
+        rhs.vA_dd(m,a,b,k,j,i) += rhs_a * rhs.vA_dd(m,a,b,ko,jo,io);
+      }
+    }
+  }
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn bool SommerfeldOffset
+//! \brief Returns true if the Sommerfeld condition is applied in active cell (m,k,j,i),
+//! and the offset (dk,dj,di) of the ghost cell across the face it is applied at.  In
+//! edge and corner cells this is the face processed last by Z4c::Z4cBoundaryRHS() (in
+//! the order inner/outer x1, x2, x3), which overwrites the others.
+
+KOKKOS_INLINE_FUNCTION
+bool SommerfeldOffset(const DualArray2D<BoundaryFlag> &mb_bcs, const bool user_Sbc,
+                      const RegionIndcs &indcs, const int m, const int k, const int j,
+                      const int i, int &dk, int &dj, int &di) {
+  dk = 0; dj = 0; di = 0;
+  if (k == indcs.ke &&
+      SommerfeldFace(mb_bcs.d_view(m,BoundaryFace::outer_x3), user_Sbc)) {
+    dk = 1;
+  } else if (k == indcs.ks &&
+             SommerfeldFace(mb_bcs.d_view(m,BoundaryFace::inner_x3), user_Sbc)) {
+    dk = -1;
+  } else if (j == indcs.je &&
+             SommerfeldFace(mb_bcs.d_view(m,BoundaryFace::outer_x2), user_Sbc)) {
+    dj = 1;
+  } else if (j == indcs.js &&
+             SommerfeldFace(mb_bcs.d_view(m,BoundaryFace::inner_x2), user_Sbc)) {
+    dj = -1;
+  } else if (i == indcs.ie &&
+             SommerfeldFace(mb_bcs.d_view(m,BoundaryFace::outer_x1), user_Sbc)) {
+    di = 1;
+  } else if (i == indcs.is &&
+             SommerfeldFace(mb_bcs.d_view(m,BoundaryFace::inner_x1), user_Sbc)) {
+    di = -1;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+} // namespace z4c
+#endif // Z4C_Z4C_SBC_HPP_
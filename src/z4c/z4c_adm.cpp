@@ -98,7 +98,7 @@ void Z4c::ADMToZ4c(MeshBlockPack *pmbp, ParameterInput *pin) {
                                 z4c.vKhat(m,k,j,i) * z4c.g_dd(m,a,b,k,j,i);
     }
   });
-  Kokkos::fence();
+  TaskExecSpace().fence();
 
   DvceArray5D<Real> g_uu("g_uu", nmb, 6, ncells3, ncells2, ncells1);
   AthenaTensor<Real, TensorSymm::SYM2, 3, 2> g3u;
@@ -116,7 +116,7 @@ void Z4c::ADMToZ4c(MeshBlockPack *pmbp, ParameterInput *pin) {
               &g3u(m,0,0,k,j,i), &g3u(m,0,1,k,j,i), &g3u(m,0,2,k,j,i),
               &g3u(m,1,1,k,j,i), &g3u(m,1,2,k,j,i), &g3u(m,2,2,k,j,i));
   });
-  Kokkos::fence();
+  TaskExecSpace().fence();
 
   // Compute Gammas
   // Compute only for internal points
@@ -193,6 +193,7 @@ void Z4c::ADMToZ4c(MeshBlockPack *pmbp, ParameterInput *pin) {
 template void Z4c::ADMToZ4c<2>(MeshBlockPack *pmbp, ParameterInput *pin);
 template void Z4c::ADMToZ4c<3>(MeshBlockPack *pmbp, ParameterInput *pin);
 template void Z4c::ADMToZ4c<4>(MeshBlockPack *pmbp, ParameterInput *pin);
+template void Z4c::ADMToZ4c<5>(MeshBlockPack *pmbp, ParameterInput *pin);
 //----------------------------------------------------------------------------------------
 //! \fn void Z4c::Z4cToADM(MeshBlockPack *pmbp)
 //! \brief Compute ADM Psi4, g_ij, and K_ij from Z4c variables
@@ -268,7 +269,7 @@ void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
   Tmunu::Tmunu_vars tmunu;
   if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
 
-  Kokkos::deep_copy(u_con, 0.);
+  Kokkos::deep_copy(TaskExecSpace(), u_con, 0.);
   auto &con = pmbp->pz4c->con;
   par_for("ADM constraints loop",DevExeSpace(),
   0,nmb-1,ks,ke,js,je,is,ie,
@@ -300,30 +301,35 @@ void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
     // -----------------------------------------------------------------------------------
     // derivatives
     //
-    // first derivatives of g and K
+    // first and second derivatives of g, and first derivatives of K
+    Real d1[3], d2[6];
     for(int c = 0; c < 3; ++c)
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      dg_ddd(c,a,b) = Dx<NGHOST>(c, idx, adm.g_dd, m,a,b,k,j,i);
-      dg_ddd_z4c(c,a,b) = Dx<NGHOST>(c, idx, z4c.g_dd, m,a,b,k,j,i);
-      dK_ddd(c,a,b) = Dx<NGHOST>(c, idx, adm.vK_dd, m,a,b,k,j,i);
+    for(int d = c; d < 3; ++d) {
+      FDGradientHessian<NGHOST>([&](int dk, int dj, int di) {
+        return adm.g_dd(m,c,d,k+dk,j+dj,i+di);}, idx, d1, d2);
+      for(int a = 0, n = 0; a < 3; ++a) {
+        dg_ddd(a,c,d) = d1[a];
+        for(int b = a; b < 3; ++b) {
+          ddg_dddd(a,b,c,d) = d2[n++];
+        }
+      }
+      FDGradient<NGHOST>([&](int dk, int dj, int di) {
+        return z4c.g_dd(m,c,d,k+dk,j+dj,i+di);}, idx, d1);
+      for(int a = 0; a < 3; ++a) {
+        dg_ddd_z4c(a,c,d) = d1[a];
+      }
+      FDGradient<NGHOST>([&](int dk, int dj, int di) {
+        return adm.vK_dd(m,c,d,k+dk,j+dj,i+di);}, idx, d1);
+      for(int a = 0; a < 3; ++a) {
+        dK_ddd(a,c,d) = d1[a];
+      }
     }
 
     // first derivative of psi4
+    FDGradient<NGHOST>([&](int dk, int dj, int di) {
+      return adm.psi4(m,k+dk,j+dj,i+di);}, idx, d1);
     for (int a =0; a < 3; ++a) {
-      dpsi4_d(a) = Dx<NGHOST>(a, idx, adm.psi4, m, k, j, i);
-    }
-
-    // second derivatives of g
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
-    for(int c = 0; c < 3; ++c)
-    for(int d = c; d < 3; ++d) {
-      if(a == b) {
-        ddg_dddd(a,a,c,d) = Dxx<NGHOST>(a, idx, adm.g_dd, m,c,d,k,j,i);
-      } else {
-        ddg_dddd(a,b,c,d) = Dxy<NGHOST>(a, b, idx, adm.g_dd, m,c,d,k,j,i);
-      }
+      dpsi4_d(a) = d1[a];
     }
 
     // -----------------------------------------------------------------------------------
@@ -523,4 +529,5 @@ void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
 template void Z4c::ADMConstraints<2>(MeshBlockPack *pmbp);
 template void Z4c::ADMConstraints<3>(MeshBlockPack *pmbp);
 template void Z4c::ADMConstraints<4>(MeshBlockPack *pmbp);
+template void Z4c::ADMConstraints<5>(MeshBlockPack *pmbp);
 } // namespace z4c
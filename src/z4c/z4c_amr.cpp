@@ -5,6 +5,7 @@
 //========================================================================================
 
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <iostream>
 #include <limits>
@@ -15,16 +16,18 @@
 #include "athena.hpp"
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
+#include "mesh/refinement_criteria.hpp"
 #include "parameter_input.hpp"
 #include "z4c/compact_object_tracker.hpp"
 #include "z4c/z4c.hpp"
 
-#define SQ(X) ((X)*(X))
-
 namespace z4c {
 
 // set some parameters
-Z4c_AMR::Z4c_AMR(ParameterInput *pin) {
+Z4c_AMR::Z4c_AMR(ParameterInput *pin) :
+  chi_thresh(0.2),
+  dchi_thresh(0.01),
+  tracker_data("trk_data",1,8) {
   std::string ref_method = pin->GetOrAddString("z4c_amr", "method", "trivial");
   if (ref_method == "trivial") {
     method = Trivial;
@@ -55,220 +58,160 @@ Z4c_AMR::Z4c_AMR(ParameterInput *pin) {
   }
 }
 
-// 1: refines, -1: de-refines, 0: does nothing
-void Z4c_AMR::Refine(MeshBlockPack *pmy_pack) {
-  if (method == Tracker) {
-    RefineTracker(pmy_pack);
-  } else if (method == Chi) {
-    RefineChiMin(pmy_pack);
-  } else if (method == dChi) {
-    RefineDchiMax(pmy_pack);
+//----------------------------------------------------------------------------------------
+//! \struct Z4cRefinementVote
+//! \brief per-cell refinement criteria for Z4c based on min{chi} or max{dchi}, evaluated
+//! with MeshRefinement::FlagRefinement()
+struct Z4cRefinementVote {
+  DvceArray5D<Real> u0;
+  int ichi;            // index of chi in u0
+  bool use_dchi;       // use max{dchi} rather than min{chi}
+  Real chi_thresh, dchi_thresh;
+
+  KOKKOS_INLINE_FUNCTION
+  int operator()(const int m, const int k, const int j, const int i) const {
+    if (use_dchi) {
+      Real d2 = SQR(u0(m,ichi,k,j,i+1) - u0(m,ichi,k,j,i-1));
+      d2 += SQR(u0(m,ichi,k,j+1,i) - u0(m,ichi,k,j-1,i));
+      d2 += SQR(u0(m,ichi,k+1,j,i) - u0(m,ichi,k-1,j,i));
+      Real dchi = sqrt(d2);
+      if (dchi > dchi_thresh) return 1;
+      if (dchi < 0.5*dchi_thresh) return -1;
+      return 0;
+    }
+    Real chi = u0(m,ichi,k,j,i);
+    if (chi < chi_thresh) return 1;
+    if (chi > 1.25*chi_thresh) return -1;
+    return 0;
   }
-  RefineRadii(pmy_pack);
-}
-
-// refine region within a certain distance from each compact object
-void Z4c_AMR::RefineTracker(MeshBlockPack *pmbp) {
-  Mesh *pmesh       = pmbp->pmesh;
-  auto &refine_flag = pmesh->pmr->refine_flag;
-  auto &size        = pmbp->pmb->mb_size;
-  int nmb           = pmbp->nmb_thispack;
-  int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
-
-  std::vector<int> flag;
-  flag.reserve(pmbp->pz4c->ptracker.size());
-
-  for (int m = 0; m < nmb; ++m) {
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct Z4cRefinementAdjust
+//! \brief per-MeshBlock refinement criteria for Z4c based on distance from each compact
+//! object tracker, and the minimum refinement level inside radial shells.
+struct Z4cRefinementAdjust {
+  DualArray1D<RegionSize> size;
+  DualArray1D<int> mblev;
+  int root_level;
+  bool use_tracker;
+  int ntracker;
+  DualArray2D<Real> tracker;   // (x, radius, reflevel, v) of each tracker
+  Real lookahead;              // time over which positions of trackers are predicted
+  int nradius;
+  Real radius[16];
+  int reflevel[16];
+
+  KOKKOS_INLINE_FUNCTION
+  int operator()(const int m, int flag, const int vote) const {
     // current refinement level
-    int level = pmesh->lloc_eachmb[m + mbs].level - pmesh->root_level;
-
-    // extract MeshBlock bounds
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
-
-    flag.clear();
-    for (auto & pt : pmbp->pz4c->ptracker) {
-      Real d2[8] = {
-        SQ(x1min - pt->GetPos(0)) + SQ(x2min - pt->GetPos(1)) + SQ(x3min - pt->GetPos(2)),
-        SQ(x1max - pt->GetPos(0)) + SQ(x2min - pt->GetPos(1)) + SQ(x3min - pt->GetPos(2)),
-        SQ(x1min - pt->GetPos(0)) + SQ(x2max - pt->GetPos(1)) + SQ(x3min - pt->GetPos(2)),
-        SQ(x1max - pt->GetPos(0)) + SQ(x2max - pt->GetPos(1)) + SQ(x3min - pt->GetPos(2)),
-        SQ(x1min - pt->GetPos(0)) + SQ(x2min - pt->GetPos(1)) + SQ(x3max - pt->GetPos(2)),
-        SQ(x1max - pt->GetPos(0)) + SQ(x2min - pt->GetPos(1)) + SQ(x3max - pt->GetPos(2)),
-        SQ(x1min - pt->GetPos(0)) + SQ(x2max - pt->GetPos(1)) + SQ(x3max - pt->GetPos(2)),
-        SQ(x1max - pt->GetPos(0)) + SQ(x2max - pt->GetPos(1)) + SQ(x3max - pt->GetPos(2)),
-      };
-      Real dmin2 = *std::min_element(&d2[0], &d2[8]);
-      bool iscontained =
-        (pt->GetPos(0) >= x1min && pt->GetPos(0) <= x1max) &&
-        (pt->GetPos(1) >= x2min && pt->GetPos(1) <= x2max) &&
-        (pt->GetPos(2) >= x3min && pt->GetPos(2) <= x3max);
-
-      if (dmin2 < SQ(pt->GetRadius()) || iscontained) {
-        if (pt->GetReflevel() < 0 || level < pt->GetReflevel()) {
-          flag.push_back(1);
-        } else if (level == pt->GetReflevel()) {
-          flag.push_back(0);
-        } else {
-          flag.push_back(-1);
+    int level = mblev.d_view(m) - root_level;
+    const RegionSize &s = size.d_view(m);
+    if (vote != 0) {flag = vote;}
+
+    // refine region within a certain distance from each compact object
+    // With lookahead>0, the region around predicted positions is also refined
+    if (use_tracker && ntracker > 0) {
+      flag = -1;
+      int npos = (lookahead > 0.0)? 3 : 1;
+      for (int nn=0; nn<npos*ntracker; ++nn) {
+        int n = nn/npos;
+        Real t = (npos > 1)? lookahead*static_cast<Real>(nn - n*npos)/(npos-1) : 0.0;
+        Real x1 = tracker.d_view(n,0) + t*tracker.d_view(n,5);
+        Real x2 = tracker.d_view(n,1) + t*tracker.d_view(n,6);
+        Real x3 = tracker.d_view(n,2) + t*tracker.d_view(n,7);
+        Real dmin2 = SQR(s.x1min - x1) + SQR(s.x2min - x2) + SQR(s.x3min - x3);
+        for (int c=1; c<8; ++c) {
+          Real d2 = SQR(((c & 1)? s.x1max : s.x1min) - x1) +
+                    SQR(((c & 2)? s.x2max : s.x2min) - x2) +
+                    SQR(((c & 4)? s.x3max : s.x3min) - x3);
+          dmin2 = fmin(dmin2, d2);
+        }
+        bool iscontained = (x1 >= s.x1min && x1 <= s.x1max) &&
+                           (x2 >= s.x2min && x2 <= s.x2max) &&
+                           (x3 >= s.x3min && x3 <= s.x3max);
+        int trk_level = static_cast<int>(tracker.d_view(n,4));
+        if (dmin2 < SQR(tracker.d_view(n,3)) || iscontained) {
+          if (trk_level < 0 || level < trk_level) {
+            flag = 1;
+          } else if (level == trk_level && flag < 0) {
+            flag = 0;
+          }
         }
-      } else {
-        flag.push_back(-1);
       }
     }
-    refine_flag.h_view(m + mbs) = *std::max_element(flag.begin(), flag.end());
-  }
-
-  // sync host and device
-  refine_flag.template modify<HostMemSpace>();
-  refine_flag.template sync<DevExeSpace>();
-}
-
-// refine based on min{chi}
-void Z4c_AMR::RefineChiMin(MeshBlockPack *pmbp) {
-  Mesh *pmesh       = pmbp->pmesh;
-  int nmb           = pmbp->nmb_thispack;
-  int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
-  auto &refine_flag = pmesh->pmr->refine_flag;
-  auto &indcs       = pmesh->mb_indcs;
-  int &is = indcs.is, nx1 = indcs.nx1;
-  int &js = indcs.js, nx2 = indcs.nx2;
-  int &ks = indcs.ks, nx3 = indcs.nx3;
-  const int nkji = nx3 * nx2 * nx1;
-  const int nji  = nx2 * nx1;
-  auto &u0       = pmbp->pz4c->u0;
-  int I_Z4C_CHI  = pmbp->pz4c->I_Z4C_CHI;
-  // note: we need this to prevent capture by this in the lambda expr.
-  auto chi_thresh = this->chi_thresh;
 
-  par_for_outer(
-    "Z4c_AMR::ChiMin", DevExeSpace(), 0, 0, 0, (nmb - 1),
-    KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
-      Real team_dmin;
-      Kokkos::parallel_reduce(
-        Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real &dmin) {
-          int k = (idx) / nji;
-          int j = (idx - k * nji) / nx1;
-          int i = (idx - k * nji - j * nx1) + is;
-          j += js;
-          k += ks;
-          dmin = fmin(u0(m, I_Z4C_CHI, k, j, i), dmin);
-        },
-        Kokkos::Min<Real>(team_dmin));
-
-      if (team_dmin < chi_thresh) {
-        refine_flag.d_view(m + mbs) = 1;
-      }
-      if (team_dmin > 1.25 * chi_thresh) {
-        refine_flag.d_view(m + mbs) = -1;
+    // enforce some minimum resolution within a certain spherical region
+    Real rmin2 = SQR(s.x1min) + SQR(s.x2min) + SQR(s.x3min);
+    for (int c=1; c<8; ++c) {
+      Real r2 = SQR((c & 1)? s.x1max : s.x1min) + SQR((c & 2)? s.x2max : s.x2min) +
+                SQR((c & 4)? s.x3max : s.x3min);
+      rmin2 = fmin(rmin2, r2);
+    }
+    for (int ir=0; ir<nradius; ++ir) {
+      if (rmin2 < SQR(radius[ir])) {
+        if (level < reflevel[ir]) {
+          flag = 1;
+        } else if (level == reflevel[ir] && flag == -1) {
+          flag = 0;
+        }
       }
-    });
-
-  // sync host and device
-  refine_flag.template modify<DevExeSpace>();
-  refine_flag.template sync<HostMemSpace>();
-}
-
-// refine based on max{dchi}
-void Z4c_AMR::RefineDchiMax(MeshBlockPack *pmbp) {
-  Mesh *pmesh       = pmbp->pmesh;
-  int nmb           = pmbp->nmb_thispack;
-  int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
-  auto &refine_flag = pmesh->pmr->refine_flag;
-  auto &indcs       = pmesh->mb_indcs;
-  int &is = indcs.is, nx1 = indcs.nx1;
-  int &js = indcs.js, nx2 = indcs.nx2;
-  int &ks = indcs.ks, nx3 = indcs.nx3;
-  const int nkji = nx3 * nx2 * nx1;
-  const int nji  = nx2 * nx1;
-  auto &u0       = pmbp->pz4c->u0;
-  int I_Z4C_CHI  = pmbp->pz4c->I_Z4C_CHI;
-  // note: we need this to prevent capture by this in the lambda expr.
-  auto dchi_thresh = this->dchi_thresh;
-
-  par_for_outer(
-    "Z4c_AMR::ChiMin", DevExeSpace(), 0, 0, 0, (nmb - 1),
-    KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
-      Real team_dmax;
-      Kokkos::parallel_reduce(
-        Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real &dmax) {
-          int k = (idx) / nji;
-          int j = (idx - k * nji) / nx1;
-          int i = (idx - k * nji - j * nx1) + is;
-          j += js;
-          k += ks;
-          Real d2 = SQR(u0(m,I_Z4C_CHI,k,j,i+1) - u0(m,I_Z4C_CHI,k,j,i-1));
-          d2 += SQR(u0(m,I_Z4C_CHI,k,j+1,i) - u0(m,I_Z4C_CHI,k,j-1,i));
-          d2 += SQR(u0(m,I_Z4C_CHI,k+1,j,i) - u0(m,I_Z4C_CHI,k-1,j,i));
-          dmax = fmax((sqrt(d2)), dmax);
-        },
-        Kokkos::Max<Real>(team_dmax));
+    }
+    return flag;
+  }
+};
 
-      if (team_dmax > dchi_thresh) {
-        refine_flag.d_view(m + mbs) = 1;
-      }
-      if (team_dmax < 0.5 * dchi_thresh) {
-        refine_flag.d_view(m + mbs) = -1;
+// 1: refines, -1: de-refines, 0: does nothing
+// Per-cell (chi/dchi) and per-MeshBlock (tracker/radii) criteria are evaluated together
+// in a single kernel, and flags are only modified on the device.
+void Z4c_AMR::Refine(MeshBlockPack *pmy_pack) {
+  Mesh *pmesh = pmy_pack->pmesh;
+
+  Z4cRefinementVote vote;
+  vote.u0 = pmy_pack->pz4c->u0;
+  vote.ichi = pmy_pack->pz4c->I_Z4C_CHI;
+  vote.use_dchi = (method == dChi);
+  vote.chi_thresh = chi_thresh;
+  vote.dchi_thresh = dchi_thresh;
+
+  Z4cRefinementAdjust adjust;
+  adjust.size = pmy_pack->pmb->mb_size;
+  adjust.mblev = pmy_pack->pmb->mb_lev;
+  adjust.root_level = pmesh->root_level;
+  adjust.use_tracker = (method == Tracker);
+  adjust.ntracker = 0;
+  if (method == Tracker) {
+    // copy current positions of trackers to device
+    auto &ptracker = pmy_pack->pz4c->ptracker;
+    adjust.ntracker = static_cast<int>(ptracker.size());
+    if (tracker_data.extent_int(0) != adjust.ntracker) {
+      Kokkos::realloc(tracker_data, adjust.ntracker, 8);
+    }
+    for (int n=0; n<adjust.ntracker; ++n) {
+      for (int a=0; a<3; ++a) {
+        tracker_data.h_view(n,a) = ptracker[n]->GetPos(a);
       }
-    });
-
-  // sync host and device
-  refine_flag.template modify<DevExeSpace>();
-  refine_flag.template sync<HostMemSpace>();
-}
-
-// Enforce some minimum resolution within a certain spherical region
-void Z4c_AMR::RefineRadii(MeshBlockPack *pmbp) {
-  Mesh *pmesh       = pmbp->pmesh;
-  auto &refine_flag = pmesh->pmr->refine_flag;
-  auto &size        = pmbp->pmb->mb_size;
-  int nmb           = pmbp->nmb_thispack;
-  int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
-
-  for (int m = 0; m < nmb; ++m) {
-    // current refinement level
-    int level = pmesh->lloc_eachmb[m + mbs].level - pmesh->root_level;
-
-    // extract MeshBlock bounds
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
-
-    Real r2[8] = {
-      SQ(x1min) + SQ(x2min) + SQ(x3min),
-      SQ(x1max) + SQ(x2min) + SQ(x3min),
-      SQ(x1min) + SQ(x2max) + SQ(x3min),
-      SQ(x1max) + SQ(x2max) + SQ(x3min),
-      SQ(x1min) + SQ(x2min) + SQ(x3max),
-      SQ(x1max) + SQ(x2min) + SQ(x3max),
-      SQ(x1min) + SQ(x2max) + SQ(x3max),
-      SQ(x1max) + SQ(x2max) + SQ(x3max),
-    };
-    Real rmin2 = *std::min_element(&r2[0], &r2[8]);
-
-    for (int ir = 0; ir < radius.size(); ++ir) {
-      if (rmin2 < SQ(radius[ir])) {
-        if (level < reflevel[ir]) {
-          refine_flag.h_view(m + mbs) = 1;
-        } else if (level == reflevel[ir] && refine_flag.h_view(m + mbs) == -1) {
-          refine_flag.h_view(m + mbs) = 0;
-        }
+      tracker_data.h_view(n,3) = ptracker[n]->GetRadius();
+      tracker_data.h_view(n,4) = static_cast<Real>(ptracker[n]->GetReflevel());
+      // velocity is not set until the tracker has been evolved
+      for (int a=0; a<3; ++a) {
+        Real vel = ptracker[n]->GetVel(a);
+        tracker_data.h_view(n,5+a) = (std::isfinite(vel))? vel : 0.0;
       }
     }
+    tracker_data.template modify<HostMemSpace>();
+    tracker_data.template sync<DevExeSpace>();
+  }
+  adjust.tracker = tracker_data;
+  adjust.lookahead = (pmesh->pmr->lookahead_cycles)*(pmesh->dt);
+  adjust.nradius = static_cast<int>(radius.size());
+  for (int ir=0; ir<adjust.nradius; ++ir) {
+    adjust.radius[ir] = radius[ir];
+    adjust.reflevel[ir] = reflevel[ir];
   }
 
-  // sync host and device
-  refine_flag.template modify<HostMemSpace>();
-  refine_flag.template sync<DevExeSpace>();
+  bool use_cells = (method == Chi || method == dChi);
+  pmesh->pmr->FlagRefinement(pmy_pack, use_cells, vote, adjust);
 }
 
 } // namespace z4c
@@ -27,11 +27,8 @@ class Z4c_AMR {
   explicit Z4c_AMR(ParameterInput *pin);
   ~Z4c_AMR() noexcept = default;
 
-  void Refine(MeshBlockPack *pmbp);             // call the AMR method
-  void RefineTracker(MeshBlockPack *pmbp);      // Refine based on the trackers
-  void RefineChiMin(MeshBlockPack *pmbp);       // Refine based on min{chi}
-  void RefineDchiMax(MeshBlockPack *pmbp);      // Refine based on max{dchi}
-  void RefineRadii(MeshBlockPack *pmbp);        // Refine based on the radii
+  // evaluate all criteria of the AMR method in a single kernel
+  void Refine(MeshBlockPack *pmbp);
 
   RefinementMethod method;
 
@@ -41,6 +38,8 @@ class Z4c_AMR {
 
   Real chi_thresh;     // chi threshold for chi refinement method
   Real dchi_thresh;    // dchi threshold for dchi refinement method
+
+  DualArray2D<Real> tracker_data;  // positions, radii, and levels of trackers
 };
 
 } // namespace z4c
@@ -4,229 +4,234 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \fn TaskStatus Z4c::CalcRHS
-//! \brief Computes the wave equation RHS
+//! \brief Computes the wave equation RHS.  With <z4c>/tiled_rhs=true, each team loads
+//! a tile of all Z4c variables (plus ghost cells) into scratch memory once, and computes
+//! all first, second, mixed, and advective derivatives (and the K-O dissipation) from
+//! it, rather than re-reading the neighbours of each cell from global memory for every
+//! derivative of every field.  With <z4c>/phased_rhs=true, derivatives, algebraic RHS,
+//! and dissipation are computed by separate kernels, to reduce register pressure.  With
+//! <z4c>/fused_update=true, the RK update (and algebraic constraints) are also applied
+//! in the tiled kernel.
 
 #include <math.h>
 
-//#include <algorithm>
+#include <algorithm>
 //#include <cinttypes>
 #include <iostream>
+#include <string>
 //#include <limits>
 
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
 #include "coordinates/adm.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/tmunu.hpp"
+#include "z4c/z4c_update.hpp"
+#include "z4c/z4c_Sbc.hpp"
 #include "coordinates/cell_locations.hpp"
+#include "reconstruct/scratch_tile.hpp"
 
 namespace z4c {
+//----------------------------------------------------------------------------------------
+//! \struct Z4cTileVar
+//! \brief Accessor for one scalar, vector, or symmetric tensor Z4c variable in a tile of
+//! u0 stored in team scratch memory, with the same indices as the AthenaTensor alias.
+//! Components start at index n0 of the tile; symmetric tensors are ordered xx,xy,xz,yy,
+//! yz,zz as in u0.
 
-template <int NGHOST>
-//! \fn void Z4c::CalcRHS(Driver *pdriver, int stage)
-//! \brief compute rhs of the z4c equations
-TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
-  auto &indcs = pmy_pack->pmesh->mb_indcs;
-  auto &size = pmy_pack->pmb->mb_size;
-  int &is = indcs.is; int &ie = indcs.ie;
-  int &js = indcs.js; int &je = indcs.je;
-  int &ks = indcs.ks; int &ke = indcs.ke;
+struct Z4cTileVar {
+  ScrTile t;
+  int n0;
 
-  int nmb = pmy_pack->nmb_thispack;
+  KOKKOS_INLINE_FUNCTION
+  Real operator()(const int m, const int k, const int j, const int i) const {
+    return t(m,n0,k,j,i);
+  }
+  KOKKOS_INLINE_FUNCTION
+  Real operator()(const int m, const int a, const int k, const int j, const int i) const {
+    return t(m,n0+a,k,j,i);
+  }
+  KOKKOS_INLINE_FUNCTION
+  Real operator()(const int m, const int a, const int b, const int k, const int j,
+                  const int i) const {
+    const int l = (a < b)? a : b, u = (a < b)? b : a;
+    return t(m,n0+(l*(7-l))/2+(u-l),k,j,i);
+  }
+};
 
-  auto &z4c = pmy_pack->pz4c->z4c;
-  auto &rhs = pmy_pack->pz4c->rhs;
-  auto &opt = pmy_pack->pz4c->opt;
+//----------------------------------------------------------------------------------------
+//! \struct Z4cTileVars
+//! \brief Same members as Z4c::Z4c_vars, but reading from a tile in scratch memory
 
-  bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
-  Tmunu::Tmunu_vars tmunu;
-  if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
+struct Z4cTileVars {
+  Z4cTileVar chi, vKhat, vTheta, alpha, vGam_u, beta_u, g_dd, vA_dd;
 
-  // ===================================================================================
-  // Main RHS calculation
-  //
-  par_for("z4c rhs loop",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    // Define scratch arrays to be used in the following calculations
-
-    // Gamma computed from the metric
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Gamma_u;
-    // Covariant derivative of A
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> DA_u;
-
-    // inverse of conf. metric
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> g_uu;
-    // inverse of A
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> A_uu;
-    // g^cd A_ac A_db
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> AA_dd;
-    // Ricci tensor
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> R_dd;
-    // Ricci tensor, conformal contribution
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Rphi_dd;
-    // 2nd differential of the lapse
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Ddalpha_dd;
-    // 2nd differential of phi
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Ddphi_dd;
-
-    // Christoffel symbols of 1st kind
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_ddd;
-    // Christoffel symbols of 2nd kind
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_udd;
-
-    // auxiliary derivatives
-
-    // lapse 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dalpha_d;
-    // 2nd "divergence" of beta
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> ddbeta_d;
-    // chi 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dchi_d;
-    // phi 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dphi_d;
-    // Khat 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dKhat_d;
-    // Theta 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dTheta_d;
-
-    // lapse 2nd drvts
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> ddalpha_dd;
-    // shift 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 2> dbeta_du;
-    // chi 2nd drvts
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> ddchi_dd;
-    // Gamma 1st drvts
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 2> dGam_du;
-
-    // metric 1st drvts
-    AthenaPointTensor<Real, TensorSymm::SYM2,  3, 3> dg_ddd;
-    // shift 2nd drvts
-    AthenaPointTensor<Real, TensorSymm::ISYM2, 3, 3> ddbeta_ddu;
-
-    // metric 2nd drvts
-    AthenaPointTensor<Real, TensorSymm::SYM22, 3, 4> ddg_dddd;
-
-    // Lie derivative of Gamma
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> LGam_u;
-    // Lie derivative of the shift
-    AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Lbeta_u;
-
-    // Lie derivative of conf. 3-metric
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Lg_dd;
-    // Lie derivative of A
-    AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> LA_dd;
+  KOKKOS_INLINE_FUNCTION
+  explicit Z4cTileVars(const ScrTile &t) :
+    chi{t, Z4c::I_Z4C_CHI}, vKhat{t, Z4c::I_Z4C_KHAT}, vTheta{t, Z4c::I_Z4C_THETA},
+    alpha{t, Z4c::I_Z4C_ALPHA}, vGam_u{t, Z4c::I_Z4C_GAMX}, beta_u{t, Z4c::I_Z4C_BETAX},
+    g_dd{t, Z4c::I_Z4C_GXX}, vA_dd{t, Z4c::I_Z4C_AXX} {}
+};
 
-    Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+//----------------------------------------------------------------------------------------
+//! \fn void ParForTuned
+//! \brief Launches function(idx) for idx in [0,n-1], one index per thread.  With
+//! team_size > 0 a TeamPolicy with that team size (limited to the largest allowed for
+//! the kernel) is used, so that the launch configuration of each phase of the RHS can be
+//! tuned.  Otherwise a RangePolicy with the default configuration is used, as in par_for.
 
-    // -----------------------------------------------------------------------------------
-    // Initialize everything to zero
-    //
-    // Scalars
+template <typename Function>
+inline void ParForTuned(const std::string &name, const int n, const int team_size,
+                        const Function &function) {
+  const DevExeSpace exec_inst = TaskExecSpace();
+  if (team_size <= 0) {
+    Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_inst, 0, n), function);
+    return;
+  }
+  auto kernel = KOKKOS_LAMBDA(TeamMember_t member) {
+    const int idx = member.league_rank()*member.team_size() + member.team_rank();
+    if (idx < n) {function(idx);}
+  };
+  int nt = Kokkos::TeamPolicy<>(exec_inst, 1, 1).team_size_max(kernel,
+                                                               Kokkos::ParallelForTag());
+  nt = (team_size < nt)? team_size : nt;
+  Kokkos::parallel_for(name, Kokkos::TeamPolicy<>(exec_inst, (n + nt - 1)/nt, nt),
+                       kernel);
+}
 
-    // auxiliary Lie derivatives along the shift vector
-    // Lie derivative of the lapse
-    Real Lalpha = 0.0;
-    // Lie derivative of chi
-    Real Lchi = 0.0;
-    // Lie derivative of Khat
-    Real LKhat = 0.0;
-    // Lie derivative of Theta
-    Real LTheta = 0.0;
-
-    // determinant of three metric
-    Real detg = 0.0;
-    // bounded version of chi
-    Real chi_guarded = 0.0;
-    // 1/psi4
-    Real oopsi4 = 0.0;
-    // trace of A
-    Real AA = 0.0;
-    // Ricci scalar
-    Real R = 0.0;
-    // tilde H
-    Real Ht = 0.0;
-    // trace of extrinsic curvature
-    Real K = 0.0;
-    // Trace of S_ik
-    Real S = 0.0;
-    // Trace of Ddalpha_dd
-    Real Ddalpha = 0.0;
-
-    // d_a beta^a
-    Real dbeta = 0.0;
+//----------------------------------------------------------------------------------------
+//! \struct Z4cDerivs
+//! \brief All (first, second, mixed, and advective) derivatives of the Z4c variables
+//! needed for the RHS in one cell.  Computed in the first phase of the phased RHS, and
+//! stored in a compact temporary array (nderiv independent components per cell) that is
+//! read by the algebraic phase.
 
-    //
-    // Vectors
+struct Z4cDerivs {
+  static constexpr int nderiv = Z4c::nz4c_drv;  // number of independent components
+
+  // lapse 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dalpha_d;
+  // chi 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dchi_d;
+  // Khat 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dKhat_d;
+  // Theta 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dTheta_d;
+
+  // lapse 2nd drvts
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> ddalpha_dd;
+  // shift 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 2> dbeta_du;
+  // chi 2nd drvts
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> ddchi_dd;
+  // Gamma 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 2> dGam_du;
+
+  // metric 1st drvts
+  AthenaPointTensor<Real, TensorSymm::SYM2,  3, 3> dg_ddd;
+  // shift 2nd drvts
+  AthenaPointTensor<Real, TensorSymm::ISYM2, 3, 3> ddbeta_ddu;
+
+  // metric 2nd drvts
+  AthenaPointTensor<Real, TensorSymm::SYM22, 3, 4> ddg_dddd;
+
+  // auxiliary Lie derivatives along the shift vector
+  // Lie derivative of the lapse
+  Real Lalpha;
+  // Lie derivative of chi
+  Real Lchi;
+  // Lie derivative of Khat
+  Real LKhat;
+  // Lie derivative of Theta
+  Real LTheta;
+
+  // Lie derivative of Gamma
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> LGam_u;
+  // Lie derivative of the shift
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Lbeta_u;
+
+  // Lie derivative of conf. 3-metric
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Lg_dd;
+  // Lie derivative of A
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> LA_dd;
+
+  template <int NGHOST, typename Z4cVars>
+  KOKKOS_INLINE_FUNCTION
+  void Compute(const Z4cVars &z4c, const Real idx[],
+               const int m, const int k, const int j, const int i) {
+    Lalpha = 0.0;
+    Lchi = 0.0;
+    LKhat = 0.0;
+    LTheta = 0.0;
     Lbeta_u.ZeroClear();
     LGam_u.ZeroClear();
-    Gamma_u.ZeroClear();
-    DA_u.ZeroClear();
-    ddbeta_d.ZeroClear();
-
-    //
-    // Symmetric tensors
     Lg_dd.ZeroClear();
     LA_dd.ZeroClear();
-    AA_dd.ZeroClear();
-    R_dd.ZeroClear();
-    A_uu.ZeroClear();
-    Gamma_udd.ZeroClear();
 
     // -----------------------------------------------------------------------------------
-    // 1st derivatives
+    // 1st and 2nd derivatives
+    // All derivatives of each variable are evaluated together by the fused operators in
+    // utils/fd_stencil.hpp, which read each point of the stencil only once.
     //
+    Real d1[3], d2[6];
     // Scalars
-    for(int a = 0; a < 3; ++a) {
-      dalpha_d(a) = Dx<NGHOST>(a, idx, z4c.alpha, m,k,j,i);
-      dchi_d  (a) = Dx<NGHOST>(a, idx, z4c.chi,   m,k,j,i);
-      dKhat_d (a) = Dx<NGHOST>(a, idx, z4c.vKhat,  m,k,j,i);
-      dTheta_d(a) = Dx<NGHOST>(a, idx, z4c.vTheta, m,k,j,i);
+    FDGradientHessian<NGHOST>([&](int dk, int dj, int di) {
+      return z4c.alpha(m,k+dk,j+dj,i+di);}, idx, d1, d2);
+    for(int a = 0, n = 0; a < 3; ++a) {
+      dalpha_d(a) = d1[a];
+      for(int b = a; b < 3; ++b) {
+        ddalpha_dd(a,b) = d2[n++];
+      }
     }
-
-    // Vectors
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      dbeta_du(b,a) = Dx<NGHOST>(b, idx, z4c.beta_u, m,a,k,j,i);
-      dGam_du(b,a) = Dx<NGHOST>(b, idx, z4c.vGam_u,  m,a,k,j,i);
+    FDGradientHessian<NGHOST>([&](int dk, int dj, int di) {
+      return z4c.chi(m,k+dk,j+dj,i+di);}, idx, d1, d2);
+    for(int a = 0, n = 0; a < 3; ++a) {
+      dchi_d(a) = d1[a];
+      for(int b = a; b < 3; ++b) {
+        ddchi_dd(a,b) = d2[n++];
+      }
     }
-
-    // Tensors
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
-    for(int c = 0; c < 3; ++c) {
-      dg_ddd(c,a,b) = Dx<NGHOST>(c, idx, z4c.g_dd, m,a,b,k,j,i);
+    FDGradient<NGHOST>([&](int dk, int dj, int di) {
+      return z4c.vKhat(m,k+dk,j+dj,i+di);}, idx, d1);
+    for(int a = 0; a < 3; ++a) {
+      dKhat_d(a) = d1[a];
     }
-
-    // -----------------------------------------------------------------------------------
-    // 2nd derivatives
-    //
-    // Scalars
+    FDGradient<NGHOST>([&](int dk, int dj, int di) {
+      return z4c.vTheta(m,k+dk,j+dj,i+di);}, idx, d1);
     for(int a = 0; a < 3; ++a) {
-      ddalpha_dd(a,a) = Dxx<NGHOST>(a, idx, z4c.alpha, m,k,j,i);
-      ddchi_dd(a,a) = Dxx<NGHOST>(a, idx, z4c.chi,   m,k,j,i);
-
-      for(int b = a + 1; b < 3; ++b) {
-        ddalpha_dd(a,b) = Dxy<NGHOST>(a, b, idx, z4c.alpha, m,k,j,i);
-        ddchi_dd(a,b) = Dxy<NGHOST>(a, b, idx, z4c.chi,   m,k,j,i);
-      }
+      dTheta_d(a) = d1[a];
     }
 
     // Vectors
-    for(int c = 0; c < 3; ++c)
-    for(int a = 0; a < 3; ++a) {
-      ddbeta_ddu(a,a,c) = Dxx<NGHOST>(a, idx, z4c.beta_u, m,c,k,j,i);
-      for(int b = a + 1; b < 3; ++b) {
-        ddbeta_ddu(a,b,c) = Dxy<NGHOST>(a, b, idx, z4c.beta_u, m,c,k,j,i);
+    for(int c = 0; c < 3; ++c) {
+      FDGradientHessian<NGHOST>([&](int dk, int dj, int di) {
+        return z4c.beta_u(m,c,k+dk,j+dj,i+di);}, idx, d1, d2);
+      int n = 0;
+      for(int a = 0; a < 3; ++a) {
+        dbeta_du(a,c) = d1[a];
+        for(int b = a; b < 3; ++b) {
+          ddbeta_ddu(a,b,c) = d2[n++];
+        }
+      }
+      FDGradient<NGHOST>([&](int dk, int dj, int di) {
+        return z4c.vGam_u(m,c,k+dk,j+dj,i+di);}, idx, d1);
+      for(int a = 0; a < 3; ++a) {
+        dGam_du(a,c) = d1[a];
       }
     }
 
     // Tensors
     for(int c = 0; c < 3; ++c)
-    for(int d = c; d < 3; ++d)
-    for(int a = 0; a < 3; ++a) {
-      ddg_dddd(a,a,c,d) = Dxx<NGHOST>(a, idx, z4c.g_dd, m,c,d,k,j,i);
-      for(int b = a + 1; b < 3; ++b) {
-        ddg_dddd(a,b,c,d) = Dxy<NGHOST>(a, b, idx, z4c.g_dd, m,c,d,k,j,i);
+    for(int d = c; d < 3; ++d) {
+      FDGradientHessian<NGHOST>([&](int dk, int dj, int di) {
+        return z4c.g_dd(m,c,d,k+dk,j+dj,i+di);}, idx, d1, d2);
+      int n = 0;
+      for(int a = 0; a < 3; ++a) {
+        dg_ddd(a,c,d) = d1[a];
+        for(int b = a; b < 3; ++b) {
+          ddg_dddd(a,b,c,d) = d2[n++];
+        }
       }
     }
 
@@ -259,330 +264,937 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       Lg_dd(a,b) += Lx<NGHOST>(c, idx, z4c.beta_u, z4c.g_dd, m,c,a,b,k,j,i);
       LA_dd(a,b) += Lx<NGHOST>(c, idx, z4c.beta_u, z4c.vA_dd, m,c,a,b,k,j,i);
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Get K from Khat
-    //
-    K = z4c.vKhat(m,k,j,i) + 2.*z4c.vTheta(m,k,j,i);
+  // calls f(x) for each independent component x, always in the same order
+  template <typename F>
+  KOKKOS_INLINE_FUNCTION
+  void ForEach(const F &f) {
+    f(Lalpha); f(Lchi); f(LKhat); f(LTheta);
+    for(int a = 0; a < 3; ++a) {
+      f(dalpha_d(a)); f(dchi_d(a)); f(dKhat_d(a)); f(dTheta_d(a));
+      f(Lbeta_u(a)); f(LGam_u(a));
+    }
+    for(int a = 0; a < 3; ++a)
+    for(int b = 0; b < 3; ++b) {
+      f(dbeta_du(a,b)); f(dGam_du(a,b));
+    }
+    for(int a = 0; a < 3; ++a)
+    for(int b = a; b < 3; ++b) {
+      f(ddalpha_dd(a,b)); f(ddchi_dd(a,b)); f(Lg_dd(a,b)); f(LA_dd(a,b));
+      for(int c = 0; c < 3; ++c) {
+        f(dg_ddd(c,a,b)); f(ddbeta_ddu(a,b,c));
+      }
+      for(int c = 0; c < 3; ++c)
+      for(int d = c; d < 3; ++d) {
+        f(ddg_dddd(a,b,c,d));
+      }
+    }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Inverse metric
+  // store/load derivatives in cell (m,k,j,i) of array of size (*,nderiv,*,*,*)
+  KOKKOS_INLINE_FUNCTION
+  void Store(const DvceArray5D<Real> &d, const int m, const int k, const int j,
+             const int i) {
+    int n = 0;
+    ForEach([&](Real &x) {d(m,n++,k,j,i) = x;});
+  }
+  KOKKOS_INLINE_FUNCTION
+  void Load(const DvceArray5D<Real> &d, const int m, const int k, const int j,
+            const int i) {
+    int n = 0;
+    ForEach([&](Real &x) {x = d(m,n++,k,j,i);});
+  }
+};
 
-    detg = adm::SpatialDet(z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i),
-                              z4c.g_dd(m,0,2,k,j,i), z4c.g_dd(m,1,1,k,j,i),
-                              z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i));
-    adm::SpatialInv(1.0/detg,
-               z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i), z4c.g_dd(m,0,2,k,j,i),
-               z4c.g_dd(m,1,1,k,j,i), z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i),
-               &g_uu(0,0), &g_uu(0,1), &g_uu(0,2),
-               &g_uu(1,1), &g_uu(1,2), &g_uu(2,2));
+//----------------------------------------------------------------------------------------
+//! \fn void Z4cPointAlgebra
+//! \brief Computes rhs of the z4c equations in cell (m,k,j,i) given the derivatives of
+//! the evolved variables in drv.  Only the values of the evolved variables in the cell
+//! itself are read through z4c.
 
-    // -----------------------------------------------------------------------------------
-    // Christoffel symbols
+template <typename Z4cVars>
+KOKKOS_INLINE_FUNCTION
+void Z4cPointAlgebra(const Z4cVars &z4c, Z4cDerivs &drv, const Z4c::Z4c_vars &rhs,
+                     const Z4c::Options &opt, const bool is_vacuum,
+                     const Tmunu::Tmunu_vars &tmunu,
+                     const int m, const int k, const int j, const int i) {
+  // matter source terms are skipped in MBs flagged as vacuum by Tmunu::SetMatterBlocks()
+  const bool vacuum = is_vacuum || (tmunu.matter(m) == 0);
 
-    for(int c = 0; c < 3; ++c)
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
+  // derivatives computed by Z4cDerivs::Compute()
+  auto &dalpha_d = drv.dalpha_d;
+  auto &dchi_d = drv.dchi_d;
+  auto &dKhat_d = drv.dKhat_d;
+  auto &dTheta_d = drv.dTheta_d;
+  auto &ddalpha_dd = drv.ddalpha_dd;
+  auto &dbeta_du = drv.dbeta_du;
+  auto &ddchi_dd = drv.ddchi_dd;
+  auto &dGam_du = drv.dGam_du;
+  auto &dg_ddd = drv.dg_ddd;
+  auto &ddbeta_ddu = drv.ddbeta_ddu;
+  auto &ddg_dddd = drv.ddg_dddd;
+  Real &Lchi = drv.Lchi;
+  auto &LGam_u = drv.LGam_u;
+  auto &Lbeta_u = drv.Lbeta_u;
+  auto &Lg_dd = drv.Lg_dd;
+  auto &LA_dd = drv.LA_dd;
+  const Real Lalpha = drv.Lalpha;
+  const Real LKhat = drv.LKhat;
+  const Real LTheta = drv.LTheta;
+
+  // Define scratch arrays to be used in the following calculations
+
+  // Gamma computed from the metric
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> Gamma_u;
+  // Covariant derivative of A
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> DA_u;
+
+  // inverse of conf. metric
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> g_uu;
+  // inverse of A
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> A_uu;
+  // g^cd A_ac A_db
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> AA_dd;
+  // Ricci tensor
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> R_dd;
+  // Ricci tensor, conformal contribution
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Rphi_dd;
+  // 2nd differential of the lapse
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Ddalpha_dd;
+  // 2nd differential of phi
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 2> Ddphi_dd;
+
+  // Christoffel symbols of 1st kind
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_ddd;
+  // Christoffel symbols of 2nd kind
+  AthenaPointTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_udd;
+
+  // 2nd "divergence" of beta
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> ddbeta_d;
+  // phi 1st drvts
+  AthenaPointTensor<Real, TensorSymm::NONE, 3, 1> dphi_d;
+
+  // -----------------------------------------------------------------------------------
+  // Initialize everything to zero
+  //
+  // Scalars
+
+  // determinant of three metric
+  Real detg = 0.0;
+  // bounded version of chi
+  Real chi_guarded = 0.0;
+  // 1/psi4
+  Real oopsi4 = 0.0;
+  // trace of A
+  Real AA = 0.0;
+  // Ricci scalar
+  Real R = 0.0;
+  // tilde H
+  Real Ht = 0.0;
+  // trace of extrinsic curvature
+  Real K = 0.0;
+  // Trace of S_ik
+  Real S = 0.0;
+  // Trace of Ddalpha_dd
+  Real Ddalpha = 0.0;
+
+  // d_a beta^a
+  Real dbeta = 0.0;
+
+  //
+  // Vectors
+  Gamma_u.ZeroClear();
+  DA_u.ZeroClear();
+  ddbeta_d.ZeroClear();
+
+  //
+  // Symmetric tensors
+  AA_dd.ZeroClear();
+  R_dd.ZeroClear();
+  A_uu.ZeroClear();
+  Gamma_udd.ZeroClear();
+
+  // -----------------------------------------------------------------------------------
+  // Get K from Khat
+  //
+  K = z4c.vKhat(m,k,j,i) + 2.*z4c.vTheta(m,k,j,i);
+
+  // -----------------------------------------------------------------------------------
+  // Inverse metric
+
+  detg = adm::SpatialDet(z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i),
+                            z4c.g_dd(m,0,2,k,j,i), z4c.g_dd(m,1,1,k,j,i),
+                            z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i));
+  adm::SpatialInv(1.0/detg,
+             z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i), z4c.g_dd(m,0,2,k,j,i),
+             z4c.g_dd(m,1,1,k,j,i), z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i),
+             &g_uu(0,0), &g_uu(0,1), &g_uu(0,2),
+             &g_uu(1,1), &g_uu(1,2), &g_uu(2,2));
+
+  // -----------------------------------------------------------------------------------
+  // Christoffel symbols
+  // These contractions (and those of the Ricci tensor below) are unrolled at compile
+  // time with TensorFor, so all point tensors are indexed with constants and stay in
+  // registers.  Terms are summed in the same order as with runtime loops.
+
+  TensorFor<3>([&](auto c) { TensorFor<3>([&](auto a) { TensorFor<3>([&](auto b) {
+    if constexpr (b >= a) {
       Gamma_ddd(c,a,b) = 0.5*(dg_ddd(a,b,c) + dg_ddd(b,a,c) - dg_ddd(c,a,b));
     }
-    for(int c = 0; c < 3; ++c)
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
-    for(int d = 0; d < 3; ++d) {
-      Gamma_udd(c,a,b) += g_uu(c,d)*Gamma_ddd(d,a,b);
-    }
-    // Gamma's computed from the conformal metric (not evolved)
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b)
-    for(int c = 0; c < 3; ++c) {
-      Gamma_u(a) += g_uu(b,c)*Gamma_udd(a,b,c);
+  });});});
+  TensorFor<3>([&](auto c) { TensorFor<3>([&](auto a) { TensorFor<3>([&](auto b) {
+    if constexpr (b >= a) {
+      TensorFor<3>([&](auto d) {
+        Gamma_udd(c,a,b) += g_uu(c,d)*Gamma_ddd(d,a,b);
+      });
     }
+  });});});
+  // Gamma's computed from the conformal metric (not evolved)
+  TensorFor<3>([&](auto a) { TensorFor<3>([&](auto b) { TensorFor<3>([&](auto c) {
+    Gamma_u(a) += g_uu(b,c)*Gamma_udd(a,b,c);
+  });});});
 
-    // -----------------------------------------------------------------------------------
-    // Curvature of conformal metric
-    //
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      for(int c = 0; c < 3; ++c) {
+  // -----------------------------------------------------------------------------------
+  // Curvature of conformal metric
+  //
+  TensorFor<3>([&](auto a) { TensorFor<3>([&](auto b) {
+    if constexpr (b >= a) {
+      TensorFor<3>([&](auto c) {
         R_dd(a,b) += 0.5*(z4c.g_dd(m,c,a,k,j,i)*dGam_du(b,c) +
                           z4c.g_dd(m,c,b,k,j,i)*dGam_du(a,c) +
                           Gamma_u(c)*(Gamma_ddd(a,b,c) + Gamma_ddd(b,a,c)));
-      }
-      for(int c = 0; c < 3; ++c)
-      for(int d = 0; d < 3; ++d) {
+      });
+      TensorFor<3>([&](auto c) { TensorFor<3>([&](auto d) {
         R_dd(a,b) -= 0.5*g_uu(c,d)*ddg_dddd(c,d,a,b);
-      }
-      for(int c = 0; c < 3; ++c)
-      for(int d = 0; d < 3; ++d)
-      for(int e = 0; e < 3; ++e) {
+      });});
+      TensorFor<3>([&](auto c) { TensorFor<3>([&](auto d) { TensorFor<3>([&](auto e) {
         R_dd(a,b) += g_uu(c,d)*(
             Gamma_udd(e,c,a)*Gamma_ddd(b,e,d) +
             Gamma_udd(e,c,b)*Gamma_ddd(a,e,d) +
             Gamma_udd(e,a,d)*Gamma_ddd(e,c,b));
-      }
+      });});});
     }
+  });});
 
-    // -----------------------------------------------------------------------------------
-    // Derivatives of conformal factor phi
-    //
-    chi_guarded = (z4c.chi(m,k,j,i)>opt.chi_div_floor)
-                    ? z4c.chi(m,k,j,i) : opt.chi_div_floor;
-    oopsi4 = pow(chi_guarded, -4./opt.chi_psi_power);
-    for(int a = 0; a < 3; ++a) {
-      dphi_d(a) = dchi_d(a)/(chi_guarded * opt.chi_psi_power);
+  // -----------------------------------------------------------------------------------
+  // Derivatives of conformal factor phi
+  //
+  chi_guarded = (z4c.chi(m,k,j,i)>opt.chi_div_floor)
+                  ? z4c.chi(m,k,j,i) : opt.chi_div_floor;
+  oopsi4 = pow(chi_guarded, -4./opt.chi_psi_power);
+  for(int a = 0; a < 3; ++a) {
+    dphi_d(a) = dchi_d(a)/(chi_guarded * opt.chi_psi_power);
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    Ddphi_dd(a,b) = ddchi_dd(a,b)/(chi_guarded * opt.chi_psi_power) -
+      opt.chi_psi_power * dphi_d(a) * dphi_d(b);
+    for(int c = 0; c < 3; ++c) {
+      Ddphi_dd(a,b) -= Gamma_udd(c,a,b)*dphi_d(c);
     }
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      Ddphi_dd(a,b) = ddchi_dd(a,b)/(chi_guarded * opt.chi_psi_power) -
-        opt.chi_psi_power * dphi_d(a) * dphi_d(b);
-      for(int c = 0; c < 3; ++c) {
-        Ddphi_dd(a,b) -= Gamma_udd(c,a,b)*dphi_d(c);
-      }
+  }
+
+  // -----------------------------------------------------------------------------------
+  // Curvature contribution from conformal factor
+  //
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    Rphi_dd(a,b) = 4.*dphi_d(a)*dphi_d(b) - 2.*Ddphi_dd(a,b);
+    for(int c = 0; c < 3; ++c)
+    for(int d = 0; d < 3; ++d) {
+      Rphi_dd(a,b) -= 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)*(Ddphi_dd(c,d) +
+          2.*dphi_d(c)*dphi_d(d));
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Curvature contribution from conformal factor
-    //
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      Rphi_dd(a,b) = 4.*dphi_d(a)*dphi_d(b) - 2.*Ddphi_dd(a,b);
-      for(int c = 0; c < 3; ++c)
+  // TODO(JMF): Update with Tmunu terms.
+  // -----------------------------------------------------------------------------------
+  // Trace of the matter stress tensor
+  //
+  // Matter commented out
+  //S.ZeroClear();
+  //member.team_barrier();
+  //for(int a = 0; a < 3; ++a)
+  //for(int b = 0; b < 3; ++b) {
+  //  ILOOP1(1) {
+  //    S(1) += oopsi4(1) * g_uu(a,b,i) * mat.S_dd(m,a,b,k,j,i);
+  //  }
+  //}
+  if(!vacuum) {
+    for (int a = 0; a < 3; ++a)
+    for (int b = 0; b < 3; ++b) {
+      S += oopsi4 * g_uu(a,b) * tmunu.S_dd(m,a,b,k,j,i);
+    }
+  }
+
+  // -----------------------------------------------------------------------------------
+  // 2nd covariant derivative of the lapse
+  // TODO(JMF): This could potentially be sped up by calculating d_i phi d^i alpha
+  // beforehand.
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    Ddalpha_dd(a,b) = ddalpha_dd(a,b)
+                     - 2.*(dphi_d(a)*dalpha_d(b) + dphi_d(b)*dalpha_d(a));
+    for(int c = 0; c < 3; ++c) {
+      Ddalpha_dd(a,b) -= Gamma_udd(c,a,b)*dalpha_d(c);
       for(int d = 0; d < 3; ++d) {
-        Rphi_dd(a,b) -= 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)*(Ddphi_dd(c,d) +
-            2.*dphi_d(c)*dphi_d(d));
+          Ddalpha_dd(a,b) += 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)
+          * dphi_d(c) * dalpha_d(d);
       }
     }
+  }
 
-    // TODO(JMF): Update with Tmunu terms.
-    // -----------------------------------------------------------------------------------
-    // Trace of the matter stress tensor
-    //
-    // Matter commented out
-    //S.ZeroClear();
-    //member.team_barrier();
-    //for(int a = 0; a < 3; ++a)
-    //for(int b = 0; b < 3; ++b) {
-    //  ILOOP1(1) {
-    //    S(1) += oopsi4(1) * g_uu(a,b,i) * mat.S_dd(m,a,b,k,j,i);
-    //  }
-    //}
-    if(!is_vacuum) {
-      for (int a = 0; a < 3; ++a)
-      for (int b = 0; b < 3; ++b) {
-        S += oopsi4 * g_uu(a,b) * tmunu.S_dd(m,a,b,k,j,i);
-      }
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    Ddalpha += oopsi4 * g_uu(a,b) * Ddalpha_dd(a,b);
+  }
+
+  // -----------------------------------------------------------------------------------
+  // Contractions of A_ab, inverse, and derivatives
+  //
+  TensorFor<3>([&](auto a) { TensorFor<3>([&](auto b) {
+    if constexpr (b >= a) {
+      TensorFor<3>([&](auto c) { TensorFor<3>([&](auto d) {
+        AA_dd(a,b) += g_uu(c,d) * z4c.vA_dd(m,a,c,k,j,i) * z4c.vA_dd(m,d,b,k,j,i);
+      });});
+    }
+  });});
+  TensorFor<3>([&](auto a) { TensorFor<3>([&](auto b) {
+    AA += g_uu(a,b) * AA_dd(a,b);
+  });});
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b)
+  for(int c = 0; c < 3; ++c)
+  for(int d = 0; d < 3; ++d) {
+    A_uu(a,b) += g_uu(a,c) * g_uu(b,d) * z4c.vA_dd(m,c,d,k,j,i);
+  }
+  // TODO(JMF): dchi_d/chi_guarded is opt.chi_psi_power * dphi_d.
+  for(int a = 0; a < 3; ++a) {
+    for(int b = 0; b < 3; ++b) {
+        DA_u(a) -= (3./2.) * A_uu(a,b) * dchi_d(b) / chi_guarded;
+        DA_u(a) -= (1./3.) * g_uu(a,b) * (2.*dKhat_d(b) + dTheta_d(b));
+    }
+    for(int b = 0; b < 3; ++b)
+    for(int c = 0; c < 3; ++c) {
+      DA_u(a) += Gamma_udd(a,b,c) * A_uu(b,c);
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // 2nd covariant derivative of the lapse
-    // TODO(JMF): This could potentially be sped up by calculating d_i phi d^i alpha
-    // beforehand.
-    for(int a = 0; a < 3; ++a)
+  // -----------------------------------------------------------------------------------
+  // Ricci scalar
+  //
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    R += oopsi4 * g_uu(a,b) * (R_dd(a,b) + Rphi_dd(a,b));
+  }
+
+  // -----------------------------------------------------------------------------------
+  // Hamiltonian constraint
+  //
+  Ht = R + (2./3.)*SQR(K) - AA;// - 16.*M_PI*tmunu.E(m,k,j,i);
+
+  // -----------------------------------------------------------------------------------
+  // Finalize advective (Lie) derivatives
+  //
+  // Shift vector contractions
+  for(int a = 0; a < 3; ++a) {
+    dbeta += dbeta_du(a,a);
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = 0; b < 3; ++b) {
+    ddbeta_d(a) += (1./3.) * ddbeta_ddu(a,b,b);
+  }
+
+  // Finalize Lchi
+  Lchi += (1./6.) * opt.chi_psi_power * chi_guarded * dbeta;
+
+  // Finalize LGam_u (note that this is not a real Lie derivative)
+  for(int a = 0; a < 3; ++a) {
+    LGam_u(a) += (2./3.) * Gamma_u(a) * dbeta;
     for(int b = 0; b < 3; ++b) {
-      Ddalpha_dd(a,b) = ddalpha_dd(a,b)
-                       - 2.*(dphi_d(a)*dalpha_d(b) + dphi_d(b)*dalpha_d(a));
+      LGam_u(a) += g_uu(a,b) * ddbeta_d(b) - Gamma_u(b) * dbeta_du(b,a);
       for(int c = 0; c < 3; ++c) {
-        Ddalpha_dd(a,b) -= Gamma_udd(c,a,b)*dalpha_d(c);
-        for(int d = 0; d < 3; ++d) {
-            Ddalpha_dd(a,b) += 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)
-            * dphi_d(c) * dalpha_d(d);
-        }
+        LGam_u(a) += g_uu(b,c) * ddbeta_ddu(b,c,a);
       }
     }
+  }
 
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      Ddalpha += oopsi4 * g_uu(a,b) * Ddalpha_dd(a,b);
+  // Finalize Lg_dd and LA_dd
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    Lg_dd(a,b) -= (2./3.) * z4c.g_dd(m,a,b,k,j,i) * dbeta;
+    for(int c = 0; c < 3; ++c) {
+      Lg_dd(a,b) += dbeta_du(a,c) * z4c.g_dd(m,b,c,k,j,i);
+      Lg_dd(a,b) += dbeta_du(b,c) * z4c.g_dd(m,a,c,k,j,i);
     }
-
-    // -----------------------------------------------------------------------------------
-    // Contractions of A_ab, inverse, and derivatives
-    //
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
-    for(int c = 0; c < 3; ++c)
-    for(int d = 0; d < 3; ++d) {
-      AA_dd(a,b) += g_uu(c,d) * z4c.vA_dd(m,a,c,k,j,i) * z4c.vA_dd(m,d,b,k,j,i);
+  }
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    LA_dd(a,b) -= (2./3.) * z4c.vA_dd(m,a,b,k,j,i) * dbeta;
+    for(int c = 0; c < 3; ++c) {
+      LA_dd(a,b) += dbeta_du(b,c) * z4c.vA_dd(m,a,c,k,j,i);
+      LA_dd(a,b) += dbeta_du(a,c) * z4c.vA_dd(m,b,c,k,j,i);
     }
-    for(int a = 0; a < 3; ++a)
+  }
+
+  // -----------------------------------------------------------------------------------
+  // Assemble RHS
+  //
+  // Khat, chi, and Theta
+  rhs.vKhat(m,k,j,i) = - Ddalpha + z4c.alpha(m,k,j,i)
+    * (AA + (1./3.)*SQR(K)) +
+    LKhat + opt.damp_kappa1*(1 - opt.damp_kappa2)
+    * z4c.alpha(m,k,j,i) * z4c.vTheta(m,k,j,i);
+  // Matter term
+  if(!vacuum) {
+    rhs.vKhat(m,k,j,i) += 4.*M_PI * z4c.alpha(m,k,j,i) * (S + tmunu.E(m,k,j,i));
+  }
+  rhs.chi(m,k,j,i) = Lchi - (1./6.) * opt.chi_psi_power *
+    chi_guarded * z4c.alpha(m,k,j,i) * K;
+  rhs.vTheta(m,k,j,i) = LTheta + z4c.alpha(m,k,j,i) * (
+      0.5*Ht - (2. + opt.damp_kappa2) * opt.damp_kappa1 * z4c.vTheta(m,k,j,i));
+  // Matter term
+  if(!vacuum) {
+    rhs.vTheta(m,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) * tmunu.E(m,k,j,i);
+  }
+  // If BSSN is enabled, theta is disabled.
+  rhs.vTheta(m,k,j,i) *= opt.use_z4c;
+  // Gamma's
+  for(int a = 0; a < 3; ++a) {
+    rhs.vGam_u(m,a,k,j,i) = 2.*z4c.alpha(m,k,j,i)*DA_u(a) + LGam_u(a);
+    rhs.vGam_u(m,a,k,j,i) -= 2.*z4c.alpha(m,k,j,i) * opt.damp_kappa1 *
+        (z4c.vGam_u(m,a,k,j,i) - Gamma_u(a));
     for(int b = 0; b < 3; ++b) {
-      AA += g_uu(a,b) * AA_dd(a,b);
-    }
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
-    for(int c = 0; c < 3; ++c)
-    for(int d = 0; d < 3; ++d) {
-      A_uu(a,b) += g_uu(a,c) * g_uu(b,d) * z4c.vA_dd(m,c,d,k,j,i);
-    }
-    // TODO(JMF): dchi_d/chi_guarded is opt.chi_psi_power * dphi_d.
-    for(int a = 0; a < 3; ++a) {
-      for(int b = 0; b < 3; ++b) {
-          DA_u(a) -= (3./2.) * A_uu(a,b) * dchi_d(b) / chi_guarded;
-          DA_u(a) -= (1./3.) * g_uu(a,b) * (2.*dKhat_d(b) + dTheta_d(b));
-      }
-      for(int b = 0; b < 3; ++b)
-      for(int c = 0; c < 3; ++c) {
-        DA_u(a) += Gamma_udd(a,b,c) * A_uu(b,c);
+      rhs.vGam_u(m,a,k,j,i) -= 2. * A_uu(a,b) * dalpha_d(b);
+      // Matter term
+      if(!vacuum) {
+        rhs.vGam_u(m,a,k,j,i) -= 16.*M_PI * z4c.alpha(m,k,j,i)
+                            * g_uu(a,b) * tmunu.S_d(m,b,k,j,i);
       }
     }
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Ricci scalar
-    //
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      R += oopsi4 * g_uu(a,b) * (R_dd(a,b) + Rphi_dd(a,b));
+  // g and A
+  for(int a = 0; a < 3; ++a)
+  for(int b = a; b < 3; ++b) {
+    rhs.g_dd(m,a,b,k,j,i) = - 2. * z4c.alpha(m,k,j,i) * z4c.vA_dd(m,a,b,k,j,i)
+                    + Lg_dd(a,b);
+    rhs.vA_dd(m,a,b,k,j,i) = oopsi4 *
+        (-Ddalpha_dd(a,b) + z4c.alpha(m,k,j,i) * (R_dd(a,b) + Rphi_dd(a,b)));
+    rhs.vA_dd(m,a,b,k,j,i) -= (1./3.) * z4c.g_dd(m,a,b,k,j,i)
+                           * (-Ddalpha + z4c.alpha(m,k,j,i)*R);
+    rhs.vA_dd(m,a,b,k,j,i) += z4c.alpha(m,k,j,i) * (K*z4c.vA_dd(m,a,b,k,j,i)
+                           - 2.*AA_dd(a,b));
+    rhs.vA_dd(m,a,b,k,j,i) += LA_dd(a,b);
+    // Matter term
+    if(!vacuum) {
+      rhs.vA_dd(m,a,b,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) *
+              (oopsi4*tmunu.S_dd(m,a,b,k,j,i) - (1./3.)*S*z4c.g_dd(m,a,b,k,j,i));
     }
+  }
+  // lapse function
+  Real const f = opt.lapse_oplog * opt.lapse_harmonicf
+               + opt.lapse_harmonic * z4c.alpha(m,k,j,i);
+  rhs.alpha(m,k,j,i) = opt.lapse_advect * Lalpha
+                     - f * z4c.alpha(m,k,j,i) * z4c.vKhat(m,k,j,i);
 
-    // -----------------------------------------------------------------------------------
-    // Hamiltonian constraint
-    //
-    Ht = R + (2./3.)*SQR(K) - AA;// - 16.*M_PI*tmunu.E(m,k,j,i);
+  // shift vector
+  for(int a = 0; a < 3; ++a) {
+    rhs.beta_u(m,a,k,j,i) = opt.shift_ggamma * z4c.vGam_u(m,a,k,j,i)
+                          + opt.shift_advect * Lbeta_u(a);
+    rhs.beta_u(m,a,k,j,i) -= opt.shift_eta * z4c.beta_u(m,a,k,j,i);
+    // FORCE beta = 0
+    //rhs.beta_u(m,a,k,j,i) = 0;
+  }
 
-    // -----------------------------------------------------------------------------------
-    // Finalize advective (Lie) derivatives
-    //
-    // Shift vector contractions
-    for(int a = 0; a < 3; ++a) {
-      dbeta += dbeta_du(a,a);
-    }
-    for(int a = 0; a < 3; ++a)
+  // harmonic gauge terms
+  for(int a = 0; a < 3; ++a) {
+    rhs.beta_u(m,a,k,j,i) += opt.shift_alpha2ggamma *
+                        SQR(z4c.alpha(m,k,j,i)) * z4c.vGam_u(m,a,k,j,i);
     for(int b = 0; b < 3; ++b) {
-      ddbeta_d(a) += (1./3.) * ddbeta_ddu(a,b,b);
+      rhs.beta_u(m,a,k,j,i) += opt.shift_hh * z4c.alpha(m,k,j,i) *
+        chi_guarded * (0.5 * z4c.alpha(m,k,j,i) * dchi_d(b) - dalpha_d(b)) * g_uu(a,b);
     }
+  }
+}
 
-    // Finalize Lchi
-    Lchi += (1./6.) * opt.chi_psi_power * chi_guarded * dbeta;
+//----------------------------------------------------------------------------------------
+//! \fn void Z4cPointRHS
+//! \brief Computes rhs of the z4c equations in cell (m,k,j,i).  The evolved variables
+//! (and their derivatives) are read through z4c, which is either the Z4c_vars aliases of
+//! u0 in global memory, or a Z4cTileVars holding a tile of u0 in team scratch memory.
+//! With 2N-storage integrators (rhs_a != 0), the rhs is added to rhs_a times the value
+//! stored in u_rhs (which rhs aliases) at the previous stage.
 
-    // Finalize LGam_u (note that this is not a real Lie derivative)
+template <int NGHOST, typename Z4cVars>
+KOKKOS_INLINE_FUNCTION
+void Z4cPointRHS(const Z4cVars &z4c, const Z4c::Z4c_vars &rhs, const Z4c::Options &opt,
+                 const bool is_vacuum, const Tmunu::Tmunu_vars &tmunu, const Real idx[],
+                 const Real rhs_a, const DvceArray5D<Real> &u_rhs,
+                 const int m, const int k, const int j, const int i) {
+  Z4cDerivs drv;
+  drv.Compute<NGHOST>(z4c, idx, m, k, j, i);
+  if (rhs_a != 0.0) {
+    Real rold[Z4c::nz4c];
+    for (int v=0; v<Z4c::nz4c; ++v) {rold[v] = u_rhs(m,v,k,j,i);}
+    Z4cPointAlgebra(z4c, drv, rhs, opt, is_vacuum, tmunu, m, k, j, i);
+    for (int v=0; v<Z4c::nz4c; ++v) {u_rhs(m,v,k,j,i) += rhs_a*rold[v];}
+  } else {
+    Z4cPointAlgebra(z4c, drv, rhs, opt, is_vacuum, tmunu, m, k, j, i);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::CalcRHS(Driver *pdriver, int stage)
+//! \brief compute rhs of the z4c equations (including K-O dissipation), using the fused,
+//! tiled, or phased kernels.  With <z4c>/autotune_rhs=true the fastest kernels and
+//! launch configuration are chosen the first time this function is called.
+
+template <int NGHOST>
+TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
+  // coefficient of u_rhs from previous stage with 2N-storage integrators (always zero in
+  // the first stage, so autotuning in the first call may overwrite u_rhs)
+  rhs_a = (low_storage)? pdriver->a_2n[stage-1] : 0.0;
+  if (autotune_rhs) {
+    AutotuneRHS<NGHOST>();
+  }
+  if (fused_update) {
+    CalcRHSUpdate<NGHOST>(pdriver, stage);
+    return TaskStatus::complete;
+  }
+  switch (rhs_pipeline) {
+    case RHSPipeline::tiled:
+      CalcRHSTiled<NGHOST>();
+      break;
+    case RHSPipeline::phased:
+      CalcRHSPhased<NGHOST>();
+      break;
+    default:
+      CalcRHSFused<NGHOST>();
+      RHSDissipation<NGHOST>();
+      break;
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::CalcRHSFused
+//! \brief compute rhs of the z4c equations (without dissipation) with one kernel
+
+template <int NGHOST>
+void Z4c::CalcRHSFused() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &size = pmy_pack->pmb->mb_size;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+
+  int nmb = pmy_pack->nmb_thispack;
+
+  auto &z4c = pmy_pack->pz4c->z4c;
+  auto &rhs = pmy_pack->pz4c->rhs;
+  auto &opt = pmy_pack->pz4c->opt;
+
+  bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
+  Tmunu::Tmunu_vars tmunu;
+  if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
+  Real rhs_a_ = rhs_a;
+  auto &u_rhs_ = u_rhs;
+
+  // ===================================================================================
+  // Main RHS calculation
+  //
+  par_for("z4c rhs loop",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+    Z4cPointRHS<NGHOST>(z4c, rhs, opt, is_vacuum, tmunu, idx, rhs_a_, u_rhs_,
+                        m, k, j, i);
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::RHSDissipation
+//! \brief Add K-O dissipation for stability to rhs of all MBs
+
+template <int NGHOST>
+void Z4c::RHSDissipation() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &size = pmy_pack->pmb->mb_size;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int nmb = pmy_pack->nmb_thispack;
+  const int nji = nx2*nx1;
+  const int nkji = nx3*nji;
+  const int nnkji = nz4c*nkji;
+
+  Real &diss_ = diss;
+  auto &u0_ = u0;
+  auto &u_rhs_ = u_rhs;
+  ParForTuned("K-O Dissipation", nmb*nnkji, tsize_diss,
+  KOKKOS_LAMBDA(const int idx) {
+    int m = idx/nnkji;
+    int n = (idx - m*nnkji)/nkji;
+    int k = (idx - m*nnkji - n*nkji)/nji;
+    int j = (idx - m*nnkji - n*nkji - k*nji)/nx1;
+    int i = (idx - m*nnkji - n*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real idx_[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
     for(int a = 0; a < 3; ++a) {
-      LGam_u(a) += (2./3.) * Gamma_u(a) * dbeta;
-      for(int b = 0; b < 3; ++b) {
-        LGam_u(a) += g_uu(a,b) * ddbeta_d(b) - Gamma_u(b) * dbeta_du(b,a);
-        for(int c = 0; c < 3; ++c) {
-          LGam_u(a) += g_uu(b,c) * ddbeta_ddu(b,c,a);
-        }
-      }
+      u_rhs_(m,n,k,j,i) += Diss<NGHOST>(a, idx_, u0_, m, n, k, j, i)*diss_;
     }
+  });
+  return;
+}
 
-    // Finalize Lg_dd and LA_dd
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      Lg_dd(a,b) -= (2./3.) * z4c.g_dd(m,a,b,k,j,i) * dbeta;
-      for(int c = 0; c < 3; ++c) {
-        Lg_dd(a,b) += dbeta_du(a,c) * z4c.g_dd(m,b,c,k,j,i);
-        Lg_dd(a,b) += dbeta_du(b,c) * z4c.g_dd(m,a,c,k,j,i);
-      }
-    }
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      LA_dd(a,b) -= (2./3.) * z4c.vA_dd(m,a,b,k,j,i) * dbeta;
-      for(int c = 0; c < 3; ++c) {
-        LA_dd(a,b) += dbeta_du(b,c) * z4c.vA_dd(m,a,c,k,j,i);
-        LA_dd(a,b) += dbeta_du(a,c) * z4c.vA_dd(m,b,c,k,j,i);
-      }
-    }
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::CalcRHSPhased
+//! \brief compute rhs of the z4c equations in three phases, each with its own launch
+//! configuration: (1) all derivatives are stored in the temporary array u_drv, (2) the
+//! algebraic RHS is computed from them, and (3) K-O dissipation is added.  Splitting the
+//! RHS reduces the register footprint of each kernel.  To limit the size of u_drv,
+//! phases (1) and (2) are applied to chunks of rhs_chunk_nmb MBs.
 
-    // -----------------------------------------------------------------------------------
-    // Assemble RHS
-    //
-    // Khat, chi, and Theta
-    rhs.vKhat(m,k,j,i) = - Ddalpha + z4c.alpha(m,k,j,i)
-      * (AA + (1./3.)*SQR(K)) +
-      LKhat + opt.damp_kappa1*(1 - opt.damp_kappa2)
-      * z4c.alpha(m,k,j,i) * z4c.vTheta(m,k,j,i);
-    // Matter term
-    if(!is_vacuum) {
-      rhs.vKhat(m,k,j,i) += 4.*M_PI * z4c.alpha(m,k,j,i) * (S + tmunu.E(m,k,j,i));
-    }
-    rhs.chi(m,k,j,i) = Lchi - (1./6.) * opt.chi_psi_power *
-      chi_guarded * z4c.alpha(m,k,j,i) * K;
-    rhs.vTheta(m,k,j,i) = LTheta + z4c.alpha(m,k,j,i) * (
-        0.5*Ht - (2. + opt.damp_kappa2) * opt.damp_kappa1 * z4c.vTheta(m,k,j,i));
-    // Matter term
-    if(!is_vacuum) {
-      rhs.vTheta(m,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) * tmunu.E(m,k,j,i);
+template <int NGHOST>
+void Z4c::CalcRHSPhased() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int nmb = pmy_pack->nmb_thispack;
+  int nchunk = std::min(rhs_chunk_nmb, nmb);
+  if (u_drv.extent_int(0) != nchunk) {
+    Kokkos::realloc(u_drv, nchunk, Z4cDerivs::nderiv, indcs.nx3, indcs.nx2, indcs.nx1);
+  }
+  for (int m0=0; m0<nmb; m0+=nchunk) {
+    int nm = std::min(nchunk, nmb - m0);
+    RHSDerivatives<NGHOST>(m0, nm);
+    RHSAlgebra(m0, nm);
+  }
+  RHSDissipation<NGHOST>();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::RHSDerivatives
+//! \brief First phase of CalcRHSPhased: computes all derivatives needed by the RHS in
+//! the active cells of MBs [m0,m0+nm-1], and stores them in u_drv
+
+template <int NGHOST>
+void Z4c::RHSDerivatives(const int m0, const int nm) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &size = pmy_pack->pmb->mb_size;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  const int nji = nx2*nx1;
+  const int nkji = nx3*nji;
+
+  auto &z4c_ = z4c;
+  auto &u_drv_ = u_drv;
+  ParForTuned("z4c rhs derivatives", nm*nkji, tsize_drv,
+  KOKKOS_LAMBDA(const int idx) {
+    int mm = idx/nkji;
+    int k = (idx - mm*nkji)/nji;
+    int j = (idx - mm*nkji - k*nji)/nx1;
+    int i = (idx - mm*nkji - k*nji - j*nx1);
+    int m = mm + m0;
+    Real idx_[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+    Z4cDerivs drv;
+    drv.Compute<NGHOST>(z4c_, idx_, m, k+ks, j+js, i+is);
+    drv.Store(u_drv_, mm, k, j, i);
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::RHSAlgebra
+//! \brief Second phase of CalcRHSPhased: computes rhs in the active cells of MBs
+//! [m0,m0+nm-1] from the derivatives stored in u_drv
+
+void Z4c::RHSAlgebra(const int m0, const int nm) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  const int nji = nx2*nx1;
+  const int nkji = nx3*nji;
+
+  auto &z4c_ = z4c;
+  auto &rhs_ = rhs;
+  auto &opt_ = opt;
+  auto &u_drv_ = u_drv;
+  bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
+  Tmunu::Tmunu_vars tmunu;
+  if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
+  Real rhs_a_ = rhs_a;
+  auto &u_rhs_ = u_rhs;
+
+  ParForTuned("z4c rhs algebra", nm*nkji, tsize_alg,
+  KOKKOS_LAMBDA(const int idx) {
+    int mm = idx/nkji;
+    int k = (idx - mm*nkji)/nji;
+    int j = (idx - mm*nkji - k*nji)/nx1;
+    int i = (idx - mm*nkji - k*nji - j*nx1);
+    Z4cDerivs drv;
+    drv.Load(u_drv_, mm, k, j, i);
+    // with 2N-storage integrators, add rhs_a times u_rhs from previous stage
+    Real rold[Z4c::nz4c];
+    if (rhs_a_ != 0.0) {
+      for (int v=0; v<Z4c::nz4c; ++v) {rold[v] = u_rhs_(mm+m0,v,k+ks,j+js,i+is);}
     }
-    // If BSSN is enabled, theta is disabled.
-    rhs.vTheta(m,k,j,i) *= opt.use_z4c;
-    // Gamma's
-    for(int a = 0; a < 3; ++a) {
-      rhs.vGam_u(m,a,k,j,i) = 2.*z4c.alpha(m,k,j,i)*DA_u(a) + LGam_u(a);
-      rhs.vGam_u(m,a,k,j,i) -= 2.*z4c.alpha(m,k,j,i) * opt.damp_kappa1 *
-          (z4c.vGam_u(m,a,k,j,i) - Gamma_u(a));
-      for(int b = 0; b < 3; ++b) {
-        rhs.vGam_u(m,a,k,j,i) -= 2. * A_uu(a,b) * dalpha_d(b);
-        // Matter term
-        if(!is_vacuum) {
-          rhs.vGam_u(m,a,k,j,i) -= 16.*M_PI * z4c.alpha(m,k,j,i)
-                              * g_uu(a,b) * tmunu.S_d(m,b,k,j,i);
-        }
+    Z4cPointAlgebra(z4c_, drv, rhs_, opt_, is_vacuum, tmunu, mm+m0, k+ks, j+js, i+is);
+    if (rhs_a_ != 0.0) {
+      for (int v=0; v<Z4c::nz4c; ++v) {
+        u_rhs_(mm+m0,v,k+ks,j+js,i+is) += rhs_a_*rold[v];
       }
     }
+  });
+  return;
+}
 
-    // g and A
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b) {
-      rhs.g_dd(m,a,b,k,j,i) = - 2. * z4c.alpha(m,k,j,i) * z4c.vA_dd(m,a,b,k,j,i)
-                      + Lg_dd(a,b);
-      rhs.vA_dd(m,a,b,k,j,i) = oopsi4 *
-          (-Ddalpha_dd(a,b) + z4c.alpha(m,k,j,i) * (R_dd(a,b) + Rphi_dd(a,b)));
-      rhs.vA_dd(m,a,b,k,j,i) -= (1./3.) * z4c.g_dd(m,a,b,k,j,i)
-                             * (-Ddalpha + z4c.alpha(m,k,j,i)*R);
-      rhs.vA_dd(m,a,b,k,j,i) += z4c.alpha(m,k,j,i) * (K*z4c.vA_dd(m,a,b,k,j,i)
-                             - 2.*AA_dd(a,b));
-      rhs.vA_dd(m,a,b,k,j,i) += LA_dd(a,b);
-      // Matter term
-      if(!is_vacuum) {
-        rhs.vA_dd(m,a,b,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) *
-                (oopsi4*tmunu.S_dd(m,a,b,k,j,i) - (1./3.)*S*z4c.g_dd(m,a,b,k,j,i));
-      }
-    }
-    // lapse function
-    Real const f = opt.lapse_oplog * opt.lapse_harmonicf
-                 + opt.lapse_harmonic * z4c.alpha(m,k,j,i);
-    rhs.alpha(m,k,j,i) = opt.lapse_advect * Lalpha
-                       - f * z4c.alpha(m,k,j,i) * z4c.vKhat(m,k,j,i);
+//----------------------------------------------------------------------------------------
+//! \fn size_t Z4c::TiledRHSScratchSize
+//! \brief Returns size of team scratch memory (in bytes) needed by CalcRHSTiled
 
-    // shift vector
-    for(int a = 0; a < 3; ++a) {
-      rhs.beta_u(m,a,k,j,i) = opt.shift_ggamma * z4c.vGam_u(m,a,k,j,i)
-                            + opt.shift_advect * Lbeta_u(a);
-      rhs.beta_u(m,a,k,j,i) -= opt.shift_eta * z4c.beta_u(m,a,k,j,i);
-      // FORCE beta = 0
-      //rhs.beta_u(m,a,k,j,i) = 0;
-    }
+size_t Z4c::TiledRHSScratchSize() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &ng = indcs.ng;
+  return ScrTile::shmem_size(nz4c, tile_nx3 + 2*ng, tile_nx2 + 2*ng, tile_nx1 + 2*ng);
+}
 
-    // harmonic gauge terms
-    for(int a = 0; a < 3; ++a) {
-      rhs.beta_u(m,a,k,j,i) += opt.shift_alpha2ggamma *
-                          SQR(z4c.alpha(m,k,j,i)) * z4c.vGam_u(m,a,k,j,i);
-      for(int b = 0; b < 3; ++b) {
-        rhs.beta_u(m,a,k,j,i) += opt.shift_hh * z4c.alpha(m,k,j,i) *
-          chi_guarded * (0.5 * z4c.alpha(m,k,j,i) * dchi_d(b) - dalpha_d(b)) * g_uu(a,b);
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::CalcRHSTiled
+//! \brief Computes rhs of the z4c equations and adds K-O dissipation with one team per
+//! tile of tile_nx1*tile_nx2*tile_nx3 active cells.  The tile of u0 is stored in level 0
+//! scratch if it fits, otherwise in level 1 scratch.  In cells at faces of the mesh with
+//! Sommerfeld BCs, the rhs is then replaced by the Sommerfeld condition computed from
+//! the same tile, so that Z4cBoundaryRHS() does not need to re-read u0.  Results are
+//! identical to the untiled kernels in CalcRHS() followed by Z4cBoundaryRHS().
+
+template <int NGHOST>
+void Z4c::CalcRHSTiled() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &mb_bcs = pmy_pack->pmb->mb_bcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ng = indcs.ng;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nvar = nz4c;
+
+  auto &u0_ = u0;
+  auto &u_rhs_ = u_rhs;
+  auto &rhs_ = rhs;
+  auto &opt_ = opt;
+  Real diss_ = diss;
+  Real rhs_a_ = rhs_a;
+  bool user_Sbc = opt.user_Sbc;
+  bool sommerfeld = false;
+  for (int f=0; f<6; ++f) {
+    sommerfeld = sommerfeld || SommerfeldFace(pmy_pack->pmesh->mesh_bcs[f], user_Sbc);
+  }
+
+  bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
+  Tmunu::Tmunu_vars tmunu;
+  if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
+
+  // dimensions of tiles (in active cells) and number of tiles in each direction
+  int tni = tile_nx1, tnj = tile_nx2, tnk = tile_nx3;
+  int nti = (indcs.nx1 + tni - 1)/tni;
+  int ntj = (indcs.nx2 + tnj - 1)/tnj;
+  int ntk = (indcs.nx3 + tnk - 1)/tnk;
+  int tile_size = nvar*(tnk + 2*ng)*(tnj + 2*ng)*(tni + 2*ng);
+
+  size_t scr_size = TiledRHSScratchSize();
+  int scr_level = (scr_size <= Kokkos::TeamPolicy<>::scratch_size_max(0))? 0 : 1;
+  par_for_outer("z4c rhs tiled",DevExeSpace(), scr_size, scr_level, 0, nmb1, 0, ntk-1,
+                0, ntj-1, 0, nti-1,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int tk, const int tj,
+                const int ti) {
+    // active cells in this tile
+    int kl = ks + tk*tnk, ku = (kl + tnk - 1 < ke)? (kl + tnk - 1) : ke;
+    int jl = js + tj*tnj, ju = (jl + tnj - 1 < je)? (jl + tnj - 1) : je;
+    int il = is + ti*tni, iu = (il + tni - 1 < ie)? (il + tni - 1) : ie;
+
+    // load all Z4c variables in tile (plus ghost cells) into scratch
+    ScrTile u;
+    u.q = ScrArray1D<Real>(member.team_scratch(scr_level), tile_size);
+    u.nvar = nvar;
+    u.nk = (ku - kl + 1) + 2*ng;
+    u.nj = (ju - jl + 1) + 2*ng;
+    u.ni = (iu - il + 1) + 2*ng;
+    u.k0 = kl - ng;
+    u.j0 = jl - ng;
+    u.i0 = il - ng;
+    u.Load(member, u0_, m);
+    Z4cTileVars vars(u);
+
+    Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+    const int ni = iu - il + 1;
+    const int nji = (ju - jl + 1)*ni;
+    par_for_inner(member, 0, (ku - kl + 1)*nji - 1, [&](const int n) {
+      int k = n/nji;
+      int j = (n - k*nji)/ni;
+      int i = (n - k*nji - j*ni) + il;
+      j += jl;
+      k += kl;
+      Z4cPointRHS<NGHOST>(vars, rhs_, opt_, is_vacuum, tmunu, idx, rhs_a_, u_rhs_,
+                          m, k, j, i);
+      // Add dissipation for stability
+      for (int v=0; v<nvar; ++v) {
+        for (int a=0; a<3; ++a) {
+          u_rhs_(m,v,k,j,i) += Diss<NGHOST>(a, idx, u, m, v, k, j, i)*diss_;
+        }
       }
-    }
+      // Sommerfeld BCs replace the rhs in cells at faces of the mesh
+      int dk, dj, di;
+      if (sommerfeld &&
+          SommerfeldOffset(mb_bcs, user_Sbc, indcs, m, k, j, i, dk, dj, di)) {
+        Z4cSommerfeld(vars, rhs_, indcs, size, rhs_a_, dk, dj, di, m, k, j, i);
+      }
+    });
   });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::CalcRHSUpdate
+//! \brief Same as CalcRHSTiled, but also applies the RK update for this stage (and the
+//! algebraic constraints, when EnforceAlgConstr() would apply them) in each cell once its
+//! rhs is known, so that rhs never has to be re-read from memory.  Since neighbouring
+//! teams still read u0, the updated state is stored in u_rhs, and the two arrays are
+//! swapped by ExpRKUpdate().  As in CalcRHSTiled(), the Sommerfeld BCs are applied to
+//! the rhs before the update in cells at faces of the mesh.
+
+template <int NGHOST>
+void Z4c::CalcRHSUpdate(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &mb_bcs = pmy_pack->pmb->mb_bcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ng = indcs.ng;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nvar = nz4c;
+
+  auto &u0_ = u0;
+  auto &u1_ = u1;
+  auto &u_rhs_ = u_rhs;
+  auto &rhs_ = rhs;
+  auto &opt_ = opt;
+  Real diss_ = diss;
+  bool user_Sbc = opt.user_Sbc;
+  bool sommerfeld = false;
+  for (int f=0; f<6; ++f) {
+    sommerfeld = sommerfeld || SommerfeldFace(pmy_pack->pmesh->mesh_bcs[f], user_Sbc);
+  }
+
+  Real gam0 = pdriver->gam0[stage-1];
+  Real gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  bool alg_constr = (pmy_pack->pdyngr != nullptr || stage == pdriver->nexp_stages);
+
+  bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
+  Tmunu::Tmunu_vars tmunu;
+  if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
+
+  // dimensions of tiles (in active cells) and number of tiles in each direction
+  int tni = tile_nx1, tnj = tile_nx2, tnk = tile_nx3;
+  int nti = (indcs.nx1 + tni - 1)/tni;
+  int ntj = (indcs.nx2 + tnj - 1)/tnj;
+  int ntk = (indcs.nx3 + tnk - 1)/tnk;
+  int tile_size = nvar*(tnk + 2*ng)*(tnj + 2*ng)*(tni + 2*ng);
+
+  size_t scr_size = TiledRHSScratchSize();
+  int scr_level = (scr_size <= Kokkos::TeamPolicy<>::scratch_size_max(0))? 0 : 1;
+  par_for_outer("z4c rhs update",DevExeSpace(), scr_size, scr_level, 0, nmb1, 0, ntk-1,
+                0, ntj-1, 0, nti-1,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int tk, const int tj,
+                const int ti) {
+    // active cells in this tile
+    int kl = ks + tk*tnk, ku = (kl + tnk - 1 < ke)? (kl + tnk - 1) : ke;
+    int jl = js + tj*tnj, ju = (jl + tnj - 1 < je)? (jl + tnj - 1) : je;
+    int il = is + ti*tni, iu = (il + tni - 1 < ie)? (il + tni - 1) : ie;
+
+    // load all Z4c variables in tile (plus ghost cells) into scratch
+    ScrTile u;
+    u.q = ScrArray1D<Real>(member.team_scratch(scr_level), tile_size);
+    u.nvar = nvar;
+    u.nk = (ku - kl + 1) + 2*ng;
+    u.nj = (ju - jl + 1) + 2*ng;
+    u.ni = (iu - il + 1) + 2*ng;
+    u.k0 = kl - ng;
+    u.j0 = jl - ng;
+    u.i0 = il - ng;
+    u.Load(member, u0_, m);
+    Z4cTileVars vars(u);
 
-  // ===================================================================================
-  // Add dissipation for stability
-  //
-  Real &diss = pmy_pack->pz4c->diss;
-  auto &u0 = pmy_pack->pz4c->u0;
-  auto &u_rhs = pmy_pack->pz4c->u_rhs;
-  par_for("K-O Dissipation",
-  DevExeSpace(),0,nmb-1,0,nz4c-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
     Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
-    for(int a = 0; a < 3; ++a) {
-      u_rhs(m,n,k,j,i) += Diss<NGHOST>(a, idx, u0, m, n, k, j, i)*diss;
-    }
-  });
+    const int ni = iu - il + 1;
+    const int nji = (ju - jl + 1)*ni;
+    par_for_inner(member, 0, (ku - kl + 1)*nji - 1, [&](const int n) {
+      int k = n/nji;
+      int j = (n - k*nji)/ni;
+      int i = (n - k*nji - j*ni) + il;
+      j += jl;
+      k += kl;
+      Z4cPointRHS<NGHOST>(vars, rhs_, opt_, is_vacuum, tmunu, idx, 0.0, u_rhs_,
+                          m, k, j, i);
+      // Add dissipation for stability
+      for (int v=0; v<nvar; ++v) {
+        for (int a=0; a<3; ++a) {
+          u_rhs_(m,v,k,j,i) += Diss<NGHOST>(a, idx, u, m, v, k, j, i)*diss_;
+        }
+      }
+      // Sommerfeld BCs replace the rhs in cells at faces of the mesh
+      int dk, dj, di;
+      if (sommerfeld &&
+          SommerfeldOffset(mb_bcs, user_Sbc, indcs, m, k, j, i, dk, dj, di)) {
+        Z4cSommerfeld(vars, rhs_, indcs, size, 0.0, dk, dj, di, m, k, j, i);
+      }
 
-  return TaskStatus::complete;
+      // RK update, with new state stored in u_rhs
+      Real unew[Z4c::nz4c];
+      for (int v=0; v<nvar; ++v) {
+        unew[v] = gam0*u(m,v,k,j,i) + gam1*u1_(m,v,k,j,i) + beta_dt*u_rhs_(m,v,k,j,i);
+      }
+      if (alg_constr) {
+        AlgConstrPoint(&unew[I_Z4C_GXX], &unew[I_Z4C_AXX]);
+      }
+      for (int v=0; v<nvar; ++v) {
+        u_rhs_(m,v,k,j,i) = unew[v];
+      }
+    });
+  });
+  return;
 }
 
 template TaskStatus Z4c::CalcRHS<2>(Driver *pdriver, int stage);
 template TaskStatus Z4c::CalcRHS<3>(Driver *pdriver, int stage);
 template TaskStatus Z4c::CalcRHS<4>(Driver *pdriver, int stage);
+template TaskStatus Z4c::CalcRHS<5>(Driver *pdriver, int stage);
+template void Z4c::CalcRHSFused<2>();
+template void Z4c::CalcRHSFused<3>();
+template void Z4c::CalcRHSFused<4>();
+template void Z4c::CalcRHSFused<5>();
+template void Z4c::CalcRHSTiled<2>();
+template void Z4c::CalcRHSTiled<3>();
+template void Z4c::CalcRHSTiled<4>();
+template void Z4c::CalcRHSTiled<5>();
+template void Z4c::CalcRHSPhased<2>();
+template void Z4c::CalcRHSPhased<3>();
+template void Z4c::CalcRHSPhased<4>();
+template void Z4c::CalcRHSPhased<5>();
+template void Z4c::CalcRHSUpdate<2>(Driver *pdriver, int stage);
+template void Z4c::CalcRHSUpdate<3>(Driver *pdriver, int stage);
+template void Z4c::CalcRHSUpdate<4>(Driver *pdriver, int stage);
+template void Z4c::CalcRHSUpdate<5>(Driver *pdriver, int stage);
+template void Z4c::RHSDerivatives<2>(const int m0, const int nm);
+template void Z4c::RHSDerivatives<3>(const int m0, const int nm);
+template void Z4c::RHSDerivatives<4>(const int m0, const int nm);
+template void Z4c::RHSDerivatives<5>(const int m0, const int nm);
+template void Z4c::RHSDissipation<2>();
+template void Z4c::RHSDissipation<3>();
+template void Z4c::RHSDissipation<4>();
+template void Z4c::RHSDissipation<5>();
 } // namespace z4c
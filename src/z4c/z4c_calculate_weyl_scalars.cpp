@@ -22,11 +22,56 @@
 #include "coordinates/cell_locations.hpp"
 
 namespace z4c {
+//----------------------------------------------------------------------------------------
+//! \fn int Z4c::WeylMeshBlocks
+//! \brief Returns number of MBs in which the Weyl scalars are needed for wave extraction,
+//! whose indices are the first nmb_weyl elements of weyl_mbs.  These are the MBs within
+//! 2*ng cells of some point of the extraction spheres, which includes all MBs containing
+//! these points, and all neighbors that send ghost zones used by the interpolation
+//! (neighbors differ by at most one level).  Since the test only depends on the size of
+//! each MB, all ranks agree on it.  The list is recomputed when the MBs change.
+
+int Z4c::WeylMeshBlocks() {
+  int nmb = pmy_pack->nmb_thispack;
+  if ((weyl_version_ == pmy_pack->pmesh->mesh_version) && (weyl_nmb_ == nmb)) {
+    return nmb_weyl;
+  }
+
+  auto &size = pmy_pack->pmb->mb_size;
+  int ng = pmy_pack->pmesh->mb_indcs.ng;
+  Kokkos::realloc(weyl_mbs, nmb);
+  nmb_weyl = 0;
+  for (int m=0; m<nmb; ++m) {
+    auto &s = size.h_view(m);
+    Real pad = 2.0*ng*std::max(s.dx1, std::max(s.dx2, s.dx3));
+    bool needed = false;
+    for (auto &grid : spherical_grids) {
+      for (int n=0; n<grid->nangles && !needed; ++n) {
+        Real x = grid->interp_coord.h_view(n,0);
+        Real y = grid->interp_coord.h_view(n,1);
+        Real z = grid->interp_coord.h_view(n,2);
+        needed = (x >= s.x1min - pad && x <= s.x1max + pad &&
+                  y >= s.x2min - pad && y <= s.x2max + pad &&
+                  z >= s.x3min - pad && z <= s.x3max + pad);
+      }
+    }
+    if (needed) {
+      weyl_mbs.h_view(nmb_weyl++) = m;
+    }
+  }
+  weyl_mbs.template modify<HostMemSpace>();
+  weyl_mbs.template sync<DevExeSpace>();
+  weyl_version_ = pmy_pack->pmesh->mesh_version;
+  weyl_nmb_ = nmb;
+  return nmb_weyl;
+}
+
 //----------------------------------------------------------------------------------------
 // \!fn void Z4c::Z4cWeyl(MeshBlockPack *pmbp)
 // \brief compute the weyl scalars given the adm variables and matter state
 //
-// This function operates only on the interior points of the MeshBlock
+// This function operates only on the interior points of the MeshBlocks needed for wave
+// extraction (see WeylMeshBlocks()), u_weyl is zero in all other MeshBlocks.
 template <int NGHOST>
 void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
   // capture variables for the kernel
@@ -35,15 +80,18 @@ void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
   int &is = indcs.is; int &ie = indcs.ie;
   int &js = indcs.js; int &je = indcs.je;
   int &ks = indcs.ks; int &ke = indcs.ke;
-  int nmb = pmbp->nmb_thispack;
+  int nmb = pmbp->pz4c->WeylMeshBlocks();
 
   auto &adm = pmbp->padm->adm;
   auto &weyl = pmbp->pz4c->weyl;
   auto &u_weyl = pmbp->pz4c->u_weyl;
-  Kokkos::deep_copy(u_weyl, 0.);
+  auto &weyl_mbs = pmbp->pz4c->weyl_mbs;
+  Kokkos::deep_copy(TaskExecSpace(), u_weyl, 0.);
+  if (nmb == 0) return;
 
   par_for("z4c_weyl_scalar",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+    const int m = weyl_mbs.d_view(n);
     // Simplify constants (2 & sqrt 2 factors) featured in re/im[psi4]
     const Real FR4 = 0.25;
     Real &x1min = size.d_view(m).x1min;
@@ -138,22 +186,22 @@ void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
     // -----------------------------------------------------------------------------------
     // derivatives
     //
-    // first derivatives of g and K
-    for(int c = 0; c < 3; ++c)
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      dg_ddd(c,a,b) = Dx<NGHOST>(c, idx, adm.g_dd, m,a,b,k,j,i);
-      dK_ddd(c,a,b) = Dx<NGHOST>(c, idx, adm.vK_dd, m,a,b,k,j,i);
-    }
-    // second derivatives of g
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
+    // first and second derivatives of g, and first derivatives of K
+    Real d1[3], d2[6];
     for(int c = 0; c < 3; ++c)
     for(int d = c; d < 3; ++d) {
-      if(a == b) {
-        ddg_dddd(a,b,c,d) = Dxx<NGHOST>(a, idx, adm.g_dd, m,c,d,k,j,i);
-      } else {
-        ddg_dddd(a,b,c,d) = Dxy<NGHOST>(a, b, idx, adm.g_dd, m,c,d,k,j,i);
+      FDGradientHessian<NGHOST>([&](int dk, int dj, int di) {
+        return adm.g_dd(m,c,d,k+dk,j+dj,i+di);}, idx, d1, d2);
+      for(int a = 0, n = 0; a < 3; ++a) {
+        dg_ddd(a,c,d) = d1[a];
+        for(int b = a; b < 3; ++b) {
+          ddg_dddd(a,b,c,d) = d2[n++];
+        }
+      }
+      FDGradient<NGHOST>([&](int dk, int dj, int di) {
+        return adm.vK_dd(m,c,d,k+dk,j+dj,i+di);}, idx, d1);
+      for(int a = 0; a < 3; ++a) {
+        dK_ddd(a,c,d) = d1[a];
       }
     }
 
@@ -414,4 +462,5 @@ void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
 template void Z4c::Z4cWeyl<2>(MeshBlockPack *pmbp);
 template void Z4c::Z4cWeyl<3>(MeshBlockPack *pmbp);
 template void Z4c::Z4cWeyl<4>(MeshBlockPack *pmbp);
+template void Z4c::Z4cWeyl<5>(MeshBlockPack *pmbp);
 } // namespace z4c
@@ -0,0 +1,110 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file z4c_multirate.cpp
+//! \brief Multirate coupling of the z4c spacetime to dynamical GRMHD.  With
+//! <z4c>/multirate = m > 1, the Driver advances the spacetime over the macro step
+//! m*dt once every m cycles (using the "z4c_*" TaskLists), and then the matter over
+//! each of the m cycles (using the "mhd_*" TaskLists).  The spacetime is therefore ahead
+//! of the matter during a macro step, and:
+//!  - the ADM variables used by the matter are linearly interpolated in time between
+//!    their values at the start and end of the macro step,
+//!  - Tmunu used by the spacetime is linearly extrapolated in time from its values at the
+//!    start of the previous and current macro steps (it is constant in the first step).
+//! Only the z4c RHS evaluations of one in every m cycles are needed.
+
+#include <utility>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "coordinates/adm.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
+#include "z4c/tmunu.hpp"
+#include "z4c/z4c.hpp"
+
+namespace z4c {
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::MultirateStartMacroStep
+//! \brief Saves the ADM variables and Tmunu of the matter at the start of a macro step
+
+void Z4c::MultirateStartMacroStep(Driver *pdrive) {
+  auto &u_adm = pmy_pack->padm->u_adm;
+  auto &u_tmunu = pmy_pack->ptmunu->u_tmunu;
+  if (!(adm_mr0.is_allocated())) {
+    Kokkos::realloc(adm_mr0, u_adm.extent(0), u_adm.extent(1), u_adm.extent(2),
+                    u_adm.extent(3), u_adm.extent(4));
+    Kokkos::realloc(adm_mr1, u_adm.extent(0), u_adm.extent(1), u_adm.extent(2),
+                    u_adm.extent(3), u_adm.extent(4));
+    Kokkos::realloc(tmunu_mr0, u_tmunu.extent(0), u_tmunu.extent(1), u_tmunu.extent(2),
+                    u_tmunu.extent(3), u_tmunu.extent(4));
+    Kokkos::realloc(tmunu_mr1, u_tmunu.extent(0), u_tmunu.extent(1), u_tmunu.extent(2),
+                    u_tmunu.extent(3), u_tmunu.extent(4));
+  }
+  Kokkos::deep_copy(TaskExecSpace(), adm_mr0, u_adm);
+
+  // Tmunu of the matter at the start of the macro step (the previous value is only used
+  // once tmunu_mr_valid is set at the end of the first macro step)
+  std::swap(tmunu_mr0, tmunu_mr1);
+  (void) pmy_pack->pdyngr->SetTmunu(pdrive, 0);
+  Kokkos::deep_copy(TaskExecSpace(), tmunu_mr1, u_tmunu);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::MultirateExtrapolateTmunu
+//! \brief Sets Tmunu at fraction frac of the macro step, by linear extrapolation from
+//! the start of the previous and current macro steps
+
+void Z4c::MultirateExtrapolateTmunu(const Real frac) {
+  auto &u_tmunu = pmy_pack->ptmunu->u_tmunu;
+  if (!(tmunu_mr_valid)) {
+    Kokkos::deep_copy(TaskExecSpace(), u_tmunu, tmunu_mr1);
+    return;
+  }
+  int nmb1 = u_tmunu.extent_int(0) - 1;
+  int nvar1 = u_tmunu.extent_int(1) - 1;
+  int n3 = u_tmunu.extent_int(2) - 1;
+  int n2 = u_tmunu.extent_int(3) - 1;
+  int n1 = u_tmunu.extent_int(4) - 1;
+  auto &t0 = tmunu_mr0;
+  auto &t1 = tmunu_mr1;
+  par_for("mr_tmunu", DevExeSpace(), 0, nmb1, 0, nvar1, 0, n3, 0, n2, 0, n1,
+  KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
+    u_tmunu(m,n,k,j,i) = t1(m,n,k,j,i) + frac*(t1(m,n,k,j,i) - t0(m,n,k,j,i));
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::MultirateEndMacroStep
+//! \brief Saves the ADM variables at the end of a macro step
+
+void Z4c::MultirateEndMacroStep() {
+  Kokkos::deep_copy(TaskExecSpace(), adm_mr1, pmy_pack->padm->u_adm);
+  tmunu_mr_valid = true;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::MultirateInterpolateADM
+//! \brief Sets the ADM variables (in all cells) at fraction frac of the macro step
+
+void Z4c::MultirateInterpolateADM(const Real frac) {
+  auto &u_adm = pmy_pack->padm->u_adm;
+  int nmb1 = u_adm.extent_int(0) - 1;
+  int nvar1 = u_adm.extent_int(1) - 1;
+  int n3 = u_adm.extent_int(2) - 1;
+  int n2 = u_adm.extent_int(3) - 1;
+  int n1 = u_adm.extent_int(4) - 1;
+  auto &a0 = adm_mr0;
+  auto &a1 = adm_mr1;
+  par_for("mr_adm", DevExeSpace(), 0, nmb1, 0, nvar1, 0, n3, 0, n2, 0, n1,
+  KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
+    u_adm(m,n,k,j,i) = (1.0 - frac)*a0(m,n,k,j,i) + frac*a1(m,n,k,j,i);
+  });
+  return;
+}
+} // namespace z4c
@@ -42,7 +42,7 @@ TaskStatus Z4c::NewTimeStep(Driver *pdriver, int stage) {
   const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
   const int nkji = nx3*nx2*nx1;
 
-  Kokkos::parallel_reduce("Z4c dt",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  Kokkos::parallel_reduce("Z4c dt",Kokkos::RangePolicy<>(TaskExecSpace(), 0, nmkji),
   KOKKOS_LAMBDA(const int &idx, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
     // compute m,k,j,i indices of thread and call function
     int m = (idx)/nkji;
@@ -57,6 +57,11 @@ TaskStatus Z4c::NewTimeStep(Driver *pdriver, int stage) {
   if (pmy_pack->pmesh->multi_d) { dtnew = std::min(dtnew, dt2); }
   if (pmy_pack->pmesh->three_d) { dtnew = std::min(dtnew, dt3); }
 
+  // error norm of step with embedded RK pairs
+  if (pdriver->adaptive_dt) {
+    errnew = pdriver->EmbeddedErrorNorm(pmy_pack, u0, u1, nz4c);
+  }
+
   return TaskStatus::complete;
 }
 } // namespace z4c
@@ -0,0 +1,133 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file z4c_rhs_autotune.cpp
+//! \brief Chooses the kernels (fused, tiled, or phased), the tile dimensions, and the
+//! team size of each phase used to compute the Z4c RHS on the device in use.  Each
+//! candidate is timed on the actual data the first time the RHS is computed, so the
+//! choice is made separately for each GPU model (and MeshBlock size) without the need to
+//! tune input parameters by hand.
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "z4c/z4c.hpp"
+
+namespace z4c {
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::AutotuneRHS
+//! \brief Times all candidate kernels/launch configurations for the RHS and keeps the
+//! fastest.  Each candidate overwrites u_rhs, which is recomputed by CalcRHS() later.
+
+template <int NGHOST>
+void Z4c::AutotuneRHS() {
+  autotune_rhs = false;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int nmb = pmy_pack->nmb_thispack;
+
+  // returns minimum wall time of function over a few calls
+  Kokkos::Timer timer;
+  auto time_kernel = [&](auto &&function) {
+    double tmin = std::numeric_limits<double>::max();
+    for (int n=0; n<3; ++n) {
+      Kokkos::fence();
+      timer.reset();
+      function();
+      Kokkos::fence();
+      tmin = std::min(tmin, timer.seconds());
+    }
+    return tmin;
+  };
+  // candidate team sizes, where 0 denotes the default RangePolicy
+  const int team_sizes[] = {0, 32, 64, 128, 256, 512};
+  // returns fastest team size for function
+  auto tune_team_size = [&](int &tsize, auto &&function) {
+    double tmin = std::numeric_limits<double>::max();
+    int best = 0;
+    for (int ts : team_sizes) {
+      tsize = ts;
+      double t = time_kernel(function);
+      if (t < tmin) {
+        tmin = t;
+        best = ts;
+      }
+    }
+    tsize = best;
+    return tmin;
+  };
+
+  // dissipation, used by both the fused and phased kernels
+  double t_diss = tune_team_size(tsize_diss, [&]() {RHSDissipation<NGHOST>();});
+
+  // fused kernel
+  double t_fused = time_kernel([&]() {CalcRHSFused<NGHOST>();}) + t_diss;
+
+  // phased kernels, with team size of each phase tuned on first chunk of MBs
+  int nchunk = std::min(rhs_chunk_nmb, nmb);
+  Kokkos::realloc(u_drv, nchunk, nz4c_drv, indcs.nx3, indcs.nx2, indcs.nx1);
+  tune_team_size(tsize_drv, [&]() {RHSDerivatives<NGHOST>(0, nchunk);});
+  tune_team_size(tsize_alg, [&]() {RHSAlgebra(0, nchunk);});
+  double t_phased = time_kernel([&]() {CalcRHSPhased<NGHOST>();});
+
+  // tiled kernel, with tile dimensions chosen from a few candidates
+  const int tiles[][3] = {
+    {tile_nx1, tile_nx2, tile_nx3}, {4,4,4}, {8,4,4}, {8,8,4}, {16,4,4}, {16,8,4}, {8,8,8}
+  };
+  size_t scr_max = Kokkos::TeamPolicy<>::scratch_size_max(1);
+  double t_tiled = std::numeric_limits<double>::max();
+  int best_tile[3] = {tile_nx1, tile_nx2, tile_nx3};
+  for (auto &tile : tiles) {
+    tile_nx1 = std::min(tile[0], indcs.nx1);
+    tile_nx2 = std::min(tile[1], indcs.nx2);
+    tile_nx3 = std::min(tile[2], indcs.nx3);
+    if (TiledRHSScratchSize() > scr_max) continue;
+    double t = time_kernel([&]() {CalcRHSTiled<NGHOST>();});
+    if (t < t_tiled) {
+      t_tiled = t;
+      best_tile[0] = tile_nx1;
+      best_tile[1] = tile_nx2;
+      best_tile[2] = tile_nx3;
+    }
+  }
+  tile_nx1 = best_tile[0];
+  tile_nx2 = best_tile[1];
+  tile_nx3 = best_tile[2];
+
+  // keep fastest kernels
+  rhs_pipeline = RHSPipeline::fused;
+  double tbest = t_fused;
+  if (t_tiled < tbest) {
+    rhs_pipeline = RHSPipeline::tiled;
+    tbest = t_tiled;
+  }
+  if (t_phased < tbest) {
+    rhs_pipeline = RHSPipeline::phased;
+    tbest = t_phased;
+  }
+  if (rhs_pipeline != RHSPipeline::phased) {
+    u_drv = DvceArray5D<Real>();
+  }
+
+  if (global_variable::my_rank == 0) {
+    std::cout << "Z4c RHS autotuning (rank 0): fused = " << t_fused << " s, tiled = "
+              << t_tiled << " s (tile " << tile_nx1 << "x" << tile_nx2 << "x" << tile_nx3
+              << "), phased = " << t_phased << " s (team sizes " << tsize_drv << "/"
+              << tsize_alg << "/" << tsize_diss << ")" << std::endl << "Using "
+              << ((rhs_pipeline == RHSPipeline::fused)? "fused" :
+                  ((rhs_pipeline == RHSPipeline::tiled)? "tiled" : "phased"))
+              << " kernels for Z4c RHS" << std::endl;
+  }
+  return;
+}
+
+template void Z4c::AutotuneRHS<2>();
+template void Z4c::AutotuneRHS<3>();
+template void Z4c::AutotuneRHS<4>();
+template void Z4c::AutotuneRHS<5>();
+} // namespace z4c
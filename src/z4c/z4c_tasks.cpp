@@ -55,6 +55,10 @@ void Z4c::QueueZ4cTasks() {
       pnr->QueueTask(&Z4c::CalcRHS<4>, this, Z4c_CalcRHS, "Z4c_CalcRHS",
                      Task_Run, {Z4c_CopyU}, {MHD_SetTmunu});
       break;
+    case 5:
+      pnr->QueueTask(&Z4c::CalcRHS<5>, this, Z4c_CalcRHS, "Z4c_CalcRHS",
+                     Task_Run, {Z4c_CopyU}, {MHD_SetTmunu});
+      break;
   }
   pnr->QueueTask(&Z4c::Z4cBoundaryRHS, this, Z4c_SomBC, "Z4c_SomBC", Task_Run,
                  {Z4c_CalcRHS});
@@ -134,10 +138,10 @@ TaskStatus Z4c::ClearSend(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn  void Z4c::CopyU
-//! \brief  copy u0 --> u1 in first stage
+//! \brief  copy u0 --> u1 in first stage.  Nothing to do with 2N-storage integrators.
 
 TaskStatus Z4c::CopyU(Driver *pdrive, int stage) {
-  auto integrator = pdrive->integrator;
+  if (low_storage) return TaskStatus::complete;
 
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
@@ -151,10 +155,14 @@ TaskStatus Z4c::CopyU(Driver *pdrive, int stage) {
   // hierarchical parallel loop that updates conserved variables to intermediate step
   // using weights and fractional time step appropriate to stages of time-integrator.
   // Important to use vector inner loop for good performance on cpus
-  if (integrator == "rk4") {
+  // save state at start of step in case step is rejected (embedded RK pairs)
+  if (stage == 1 && pdrive->adaptive_dt) {
+    Kokkos::deep_copy(TaskExecSpace(), u_start, u0);
+  }
+  if (pdrive->use_delta) {
     Real &delta = pdrive->delta[stage-1];
     if (stage == 1) {
-      Kokkos::deep_copy(DevExeSpace(), u1, u0);
+      Kokkos::deep_copy(TaskExecSpace(), u1, u0);
     } else {
       par_for("CopyCons", DevExeSpace(),0, nmb1, 0, nvar-1, ks, ke, js, je, is, ie,
       KOKKOS_LAMBDA(int m, int n, int k, int j, int i){
@@ -163,7 +171,7 @@ TaskStatus Z4c::CopyU(Driver *pdrive, int stage) {
     }
   } else {
     if (stage == 1) {
-      Kokkos::deep_copy(DevExeSpace(), u1, u0);
+      Kokkos::deep_copy(TaskExecSpace(), u1, u0);
     }
   }
   return TaskStatus::complete;
@@ -193,7 +201,8 @@ TaskStatus Z4c::RecvU(Driver *pdrive, int stage) {
 
 TaskStatus Z4c::EnforceAlgConstr(Driver *pdrive, int stage) {
   if (pmy_pack->pdyngr != nullptr || stage == pdrive->nexp_stages) {
-    AlgConstr(pmy_pack);
+    // active cells were already constrained by CalcRHSUpdate() with fused_update
+    AlgConstr(pmy_pack, fused_update);
   }
   return TaskStatus::complete;
 }
@@ -222,11 +231,12 @@ TaskStatus Z4c::UpdateExcisionMasks(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn  void Z4c::ADM_Constraints_
-//! \brief
+//! \brief Computes the constraints, which are only used by outputs, in cycles at the
+//! end of which outputs are made
 
 TaskStatus Z4c::ADMConstraints_(Driver *pdrive, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  if (stage == pdrive->nexp_stages) {
+  if (stage == pdrive->nexp_stages && pdrive->output_due) {
     switch (indcs.ng) {
       case 2: ADMConstraints<2>(pmy_pack);
               break;
@@ -234,6 +244,8 @@ TaskStatus Z4c::ADMConstraints_(Driver *pdrive, int stage) {
               break;
       case 4: ADMConstraints<4>(pmy_pack);
               break;
+      case 5: ADMConstraints<5>(pmy_pack);
+              break;
     }
   }
   return TaskStatus::complete;
@@ -241,7 +253,8 @@ TaskStatus Z4c::ADMConstraints_(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn  void Z4c::RestrictU
-//! \brief
+//! \brief restricts u0 to coarse_u0.  With <mesh_refinement>/restrict_boundary_only,
+//! only MBs with a coarser neighbor are restricted
 
 TaskStatus Z4c::RestrictU(Driver *pdrive, int stage) {
   // Only execute Mesh function with SMR/SMR
@@ -283,10 +296,13 @@ TaskStatus Z4c::ApplyPhysicalBCs(Driver *pdrive, int stage) {
 }
 
 TaskStatus Z4c::TrackCompactObjects(Driver *pdrive, int stage) {
-  if (stage == pdrive->nexp_stages) {
+  // trackers are not evolved in steps rejected by error control (embedded RK pairs)
+  if (stage == pdrive->nexp_stages && !(pdrive->step_rejected)) {
+    if (ptracker.size() > 0) {
+      InterpolateTrackers();
+      CompactObjectTracker::EvolveTrackers(ptracker);
+    }
     for (auto & pt : ptracker) {
-      pt->InterpolateVelocity(pmy_pack);
-      pt->EvolveTracker();
       pt->WriteTracker();
     }
   }
@@ -301,7 +317,7 @@ TaskStatus Z4c::CCEDump(Driver *pdrive, int stage) {
   float time_32 = static_cast<float>(pmy_pack->pmesh->time);
   float next_32 = static_cast<float>(cce_dump_last_output_time+cce_dump_dt);
   if ((time_32 >= next_32)) {
-    if (stage == pdrive->nexp_stages) {
+    if (stage == pdrive->nexp_stages && !(pdrive->step_rejected)) {
       //printf("%s:(ctime,dt)=(%f,%f)",__func__,pmy_pack->pmesh->time,cce_dump_dt);
       for (auto cce : pmy_pack->pz4c_cce) {
         cce->InterpolateAndDecompose(pmy_pack);
@@ -331,6 +347,8 @@ TaskStatus Z4c::CalcWeylScalar(Driver *pdrive, int stage) {
                 break;
         case 4: Z4cWeyl<4>(pmy_pack);
                 break;
+        case 5: Z4cWeyl<5>(pmy_pack);
+                break;
       }
     }
     return TaskStatus::complete;
@@ -342,7 +360,8 @@ TaskStatus Z4c::CalcWaveForm(Driver *pdrive, int stage) {
     return TaskStatus::complete;
   } else {
     float time_32 = static_cast<float>(pmy_pack->pmesh->time);
-    if ((last_output_time==time_32) && (stage == pdrive->nexp_stages)) {
+    if ((last_output_time==time_32) && (stage == pdrive->nexp_stages) &&
+        !(pdrive->step_rejected)) {
       WaveExtr(pmy_pack);
     }
     return TaskStatus::complete;
@@ -433,7 +452,9 @@ TaskStatus Z4c::InitRecvWeyl(Driver *pdrive, int stage) {
   } else {
     float time_32 = static_cast<float>(pmy_pack->pmesh->time);
     float next_32 = static_cast<float>(last_output_time+waveform_dt);
-    if (((time_32 >= next_32) || (time_32 == 0)) && stage == pdrive->nexp_stages) {
+    // last_output_time==time_32 only when a step rejected by error control is repeated
+    if (((time_32 >= next_32) || (time_32 == 0) || (last_output_time == time_32)) &&
+        stage == pdrive->nexp_stages) {
       last_output_time = time_32;
       TaskStatus tstat = pbval_weyl->InitRecv(2);
       return tstat;
@@ -480,7 +501,8 @@ TaskStatus Z4c::ClearSendWeyl(Driver *pdrive, int stage) {
 }
 
 TaskStatus Z4c::DumpHorizons(Driver *pdrive, int stage) {
-  if (pmy_pack->pz4c->phorizon_dump.size() == 0 || stage != pdrive->nexp_stages) {
+  if (pmy_pack->pz4c->phorizon_dump.size() == 0 || stage != pdrive->nexp_stages ||
+      pdrive->step_rejected) {
     return TaskStatus::complete;
   } else {
     float time_32 = static_cast<float>(pmy_pack->pmesh->time);
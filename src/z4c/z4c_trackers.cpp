@@ -0,0 +1,135 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file z4c_trackers.cpp
+//! \brief Interpolates the variables needed to move all compact object trackers with a
+//! single kernel.  The stencils are set on the host (from the MeshBlock that contained
+//! each CO at the previous cycle), the interpolation is done on the device, and only the
+//! interpolated values are copied back to the host.
+
+#include <iostream>
+#include <vector>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/adm.hpp"
+#include "mhd/mhd.hpp"
+#include "z4c/z4c.hpp"
+#include "z4c/compact_object_tracker.hpp"
+
+namespace z4c {
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::InterpolateTrackers
+//! \brief Interpolates the shift (and for neutron stars the lapse, fluid velocity, and
+//! spatial metric) to the positions of all COs, and sets the velocity of each CO owned
+//! by this rank.
+
+void Z4c::InterpolateTrackers() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &js = indcs.js, &ks = indcs.ks;
+  int ng = indcs.ng;
+  int ntrk = ptracker.size();
+
+  // variables needed by the trackers
+  int nvars = CompactObjectTracker::nvars_bh;
+  for (auto &pt : ptracker) {
+    if (pt->IsNeutronStar()) {
+      nvars = CompactObjectTracker::nvars_ns;
+    }
+  }
+  if (nvars == CompactObjectTracker::nvars_ns && pmy_pack->pmhd == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Tracking a neutron star requires <mhd> block" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  if (tracker_vals.extent_int(0) != ntrk || tracker_vals.extent_int(1) != nvars ||
+      tracker_wghts.extent_int(1) != 2*ng) {
+    Kokkos::realloc(tracker_indcs, ntrk, 4);
+    Kokkos::realloc(tracker_wghts, ntrk, 2*ng, 3);
+    Kokkos::realloc(tracker_vals, ntrk, nvars);
+  }
+
+  // set stencils on host
+  for (int n = 0; n < ntrk; ++n) {
+    int ii[4];
+    std::vector<Real> ww(3*2*ng);
+    ptracker[n]->SetStencil(pmy_pack, ii, ww.data());
+    for (int a = 0; a < 4; ++a) {
+      tracker_indcs.h_view(n,a) = ii[a];
+    }
+    for (int i = 0; i < 2*ng; ++i) {
+      for (int a = 0; a < 3; ++a) {
+        tracker_wghts.h_view(n,i,a) = ww[3*i + a];
+      }
+    }
+  }
+  tracker_indcs.template modify<HostMemSpace>();
+  tracker_indcs.template sync<DevExeSpace>();
+  tracker_wghts.template modify<HostMemSpace>();
+  tracker_wghts.template sync<DevExeSpace>();
+
+  // interpolate all variables to all trackers with one kernel, with one team per
+  // (tracker, variable) reducing over the (2*ng)^3 points of the stencil
+  auto &u0_ = u0;
+  auto &u_adm = pmy_pack->padm->u_adm;
+  auto w0_ = (pmy_pack->pmhd != nullptr)? pmy_pack->pmhd->w0 : DvceArray5D<Real>();
+  const int ibetax = I_Z4C_BETAX, ibetay = I_Z4C_BETAY, ibetaz = I_Z4C_BETAZ;
+  const int ialpha = I_Z4C_ALPHA, igxx = pmy_pack->padm->I_ADM_GXX;
+  auto &iindcs = tracker_indcs;
+  auto &iwghts = tracker_wghts;
+  auto &ivals = tracker_vals;
+  const int nsten = 2*ng;
+  const int npts = nsten*nsten*nsten;
+  par_for_outer("trackers_interp",DevExeSpace(), 0, 0, 0, (ntrk-1), 0, (nvars-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int n, const int v) {
+    int m = iindcs.d_view(n,0);
+    if (m < 0) {  // CO not on this rank
+      Kokkos::single(Kokkos::PerTeam(tmember), [&]() {ivals.d_view(n,v) = 0.0;});
+      return;
+    }
+    int ii1 = iindcs.d_view(n,1);
+    int ii2 = iindcs.d_view(n,2);
+    int ii3 = iindcs.d_view(n,3);
+    Real val = 0.0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, npts),
+    [=](const int idx, Real &sum) {
+      int k = idx/(nsten*nsten);
+      int j = (idx - k*nsten*nsten)/nsten;
+      int i = idx - k*nsten*nsten - j*nsten;
+      int kk = ii3 - (ng - k - ks) + 1;
+      int jj = ii2 - (ng - j - js) + 1;
+      int ii = ii1 - (ng - i - is) + 1;
+      Real f;
+      if (v < 3) {
+        f = u0_(m, ((v == 0)? ibetax : ((v == 1)? ibetay : ibetaz)), kk, jj, ii);
+      } else if (v == 3) {
+        f = u0_(m, ialpha, kk, jj, ii);
+      } else if (v < 7) {
+        f = w0_(m, IVX + (v - 4), kk, jj, ii);
+      } else {
+        f = u_adm(m, igxx + (v - 7), kk, jj, ii);
+      }
+      sum += iwghts.d_view(n,i,0)*iwghts.d_view(n,j,1)*iwghts.d_view(n,k,2)*f;
+    }, Kokkos::Sum<Real>(val));
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {ivals.d_view(n,v) = val;});
+  });
+
+  // copy interpolated values to host and set velocities
+  tracker_vals.template modify<DevExeSpace>();
+  tracker_vals.template sync<HostMemSpace>();
+  for (int n = 0; n < ntrk; ++n) {
+    if (tracker_indcs.h_view(n,0) >= 0) {
+      Real vals[CompactObjectTracker::nvars_ns];
+      for (int v = 0; v < nvars; ++v) {
+        vals[v] = tracker_vals.h_view(n,v);
+      }
+      ptracker[n]->SetVelocity(vals);
+    }
+  }
+  return;
+}
+
+} // namespace z4c
@@ -8,17 +8,28 @@
 //  SSP RK integrators (e.g. RK1, RK2, RK3, RK4). Update uses weighted average
 //  and partial time step appropriate to stage.
 
+#include <utility>
+
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
 #include "coordinates/coordinates.hpp"
 #include "z4c/z4c.hpp"
+#include "z4c/z4c_update.hpp"
 
 namespace z4c {
 //----------------------------------------------------------------------------------------
 //! \fn  void Z4c::Update
-//! \brief Explicit RK update
+//! \brief Explicit RK update.  With fused_update, the new state in all active cells was
+//! already stored in u_rhs by CalcRHSUpdate().  In that case u0 and u_rhs are only
+//! swapped here.  With 2N-storage integrators, see LowStorageRKUpdate().
 TaskStatus Z4c::ExpRKUpdate(Driver *pdriver, int stage) {
+  if (fused_update) {
+    return FusedRKUpdate(pdriver, stage);
+  }
+  if (low_storage) {
+    return LowStorageRKUpdate(pdriver, stage);
+  }
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
@@ -41,4 +52,53 @@ TaskStatus Z4c::ExpRKUpdate(Driver *pdriver, int stage) {
   });
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Z4c::FusedRKUpdate
+//! \brief Completes the RK update computed by CalcRHSUpdate() (including cells with
+//! Sommerfeld BCs) by swapping u0 and u_rhs.  Ghost zones of the new u0 are filled by
+//! the boundary communication and physical BCs.
+TaskStatus Z4c::FusedRKUpdate(Driver *pdriver, int stage) {
+  std::swap(u0, u_rhs);
+  SetZ4cAliases();
+  return TaskStatus::complete;
+}
+//----------------------------------------------------------------------------------------
+//! \fn  void Z4c::LowStorageRKUpdate
+//! \brief RK update with 2N-storage integrators, u0 += b*dt*u_rhs, where u_rhs holds the
+//! rhs accumulated over stages by CalcRHS().  The Sommerfeld BCs overwrite the rhs in
+//! active cells at faces of the Mesh, so u_rhs in each face cell is also copied into the
+//! (otherwise unused) adjacent ghost cell of u_rhs, from which Z4cBoundaryRHS() reads it
+//! in the next stage.
+TaskStatus Z4c::LowStorageRKUpdate(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+
+  Real b_dt = (pdriver->b_2n[stage-1])*(pmy_pack->pmesh->dt);
+  auto &u0_ = u0;
+  auto &u_rhs_ = u_rhs;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nvar = nz4c;
+
+  par_for("z4c 2N RK update",DevExeSpace(),0,nmb1,0,nvar-1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
+    Real r = u_rhs_(m,n,k,j,i);
+    u0_(m,n,k,j,i) += b_dt*r;
+    if (i == is) {u_rhs_(m,n,k,j,i-1) = r;}
+    if (i == ie) {u_rhs_(m,n,k,j,i+1) = r;}
+    if (multi_d) {
+      if (j == js) {u_rhs_(m,n,k,j-1,i) = r;}
+      if (j == je) {u_rhs_(m,n,k,j+1,i) = r;}
+    }
+    if (three_d) {
+      if (k == ks) {u_rhs_(m,n,k-1,j,i) = r;}
+      if (k == ke) {u_rhs_(m,n,k+1,j,i) = r;}
+    }
+  });
+  return TaskStatus::complete;
+}
 } // namespace z4c
@@ -0,0 +1,57 @@
+#ifndef Z4C_Z4C_UPDATE_HPP_
+#define Z4C_Z4C_UPDATE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file z4c_update.hpp
+//! \brief Inline functions shared by the RK update of the Z4c variables, the update
+//! fused with the RHS kernel (<z4c>/fused_update), and the enforcement of algebraic
+//! constraints.
+
+#include <cmath>
+
+#include "athena.hpp"
+#include "bvals/bvals.hpp"
+#include "coordinates/adm.hpp"
+
+namespace z4c {
+//----------------------------------------------------------------------------------------
+//! \fn void AlgConstrPoint
+//! \brief Rescales the conformal metric g to unit determinant, and removes the trace of
+//! A, in one cell.  Components of both are ordered xx,xy,xz,yy,yz,zz.
+
+KOKKOS_INLINE_FUNCTION
+void AlgConstrPoint(Real g[6], Real A[6]) {
+  Real detg = adm::SpatialDet(g[0], g[1], g[2], g[3], g[4], g[5]);
+  detg = detg > 0. ? detg : 1.;
+  Real oopsi4 = std::cbrt(1./detg);
+  for (int n = 0; n < 6; ++n) {
+    g[n] *= oopsi4;
+  }
+
+  // compute trace of A
+  // note: here we are assuming that det g = 1, which we enforced above
+  Real trA = adm::Trace(1.0, g[0], g[1], g[2], g[3], g[4], g[5],
+                        A[0], A[1], A[2], A[3], A[4], A[5]);
+
+  // enforce trace of A to be zero
+  for (int n = 0; n < 6; ++n) {
+    A[n] -= (1.0/3.0) * trA * g[n];
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool SommerfeldFace
+//! \brief Returns true if the Sommerfeld condition is applied to the RHS at a MeshBlock
+//! face with boundary flag bc, as in Z4c::Z4cBoundaryRHS()
+
+KOKKOS_INLINE_FUNCTION
+bool SommerfeldFace(const BoundaryFlag bc, const bool user_Sbc) {
+  return (bc == BoundaryFlag::outflow || bc == BoundaryFlag::diode ||
+          (bc == BoundaryFlag::user && user_Sbc));
+}
+
+} // namespace z4c
+#endif // Z4C_Z4C_UPDATE_HPP_
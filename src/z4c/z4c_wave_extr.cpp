@@ -17,6 +17,7 @@
 #include <fstream>
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #ifdef MPI_PARALLEL
 #include <mpi.h>
@@ -29,6 +30,7 @@
 #include "coordinates/cell_locations.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "geodesic-grid/spherical_grid.hpp"
+#include "utils/host_tasks.hpp"
 
 namespace z4c {
 
@@ -61,10 +63,44 @@ int LmIndex(int l,int m) {
     return l*l+m+l-4;
 }
 //----------------------------------------------------------------------------------------
-// \!fn void Z4c::Z4cWeyl(MeshBlockPack *pmbp)
-// \brief compute the weyl scalars given the adm variables and matter state
+//! \fn void Z4c::SetWaveExtrHarmonics
+//! \brief Tabulates the spin-weighted spherical harmonics Y^{-2}_{lm} (multiplied by the
+//! solid angle of each point) for all modes 2<=l<=wave_lmax at every angle of the
+//! extraction spheres.  All spheres use the same geodesic grid, so one table is computed
+//! once and stored on the device.
+
+void Z4c::SetWaveExtrHarmonics() {
+  if (spherical_grids.empty()) return;
+  auto &grid = spherical_grids[0];
+  int nmodes = (wave_lmax + 1)*(wave_lmax + 1) - 4;
+  Kokkos::realloc(wave_ylm, nmodes, grid->nangles, 2);
+  auto ylm_h = Kokkos::create_mirror_view(wave_ylm);
+  for (int l = 2; l < wave_lmax+1; ++l) {
+    for (int m = -l; m < l+1 ; ++m) {
+      for (int ip = 0; ip < grid->nangles; ++ip) {
+        Real theta = grid->polar_pos.h_view(ip,0);
+        Real phi = grid->polar_pos.h_view(ip,1);
+        Real weight = grid->solid_angles.h_view(ip);
+        Real ylmR, ylmI;
+        swsh(&ylmR,&ylmI,l,m,theta,phi);
+        ylm_h(LmIndex(l,m),ip,0) = weight*ylmR;
+        ylm_h(LmIndex(l,m),ip,1) = weight*ylmI;
+      }
+    }
+  }
+  Kokkos::deep_copy(wave_ylm, ylm_h);
+  Kokkos::realloc(wave_vals, spherical_grids.size(), grid->nangles, 2);
+  Kokkos::realloc(wave_psi, spherical_grids.size(), nmodes, 2);
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn void Z4c::WaveExtr(MeshBlockPack *pmbp)
+// \brief Projects psi4 interpolated to each extraction sphere onto spin-weighted
+// spherical harmonics, and writes the modes to files.
 //
-// This function operates only on the interior points of the MeshBlock
+// The Weyl scalars on all spheres are gathered into one array, and the projection onto
+// all modes of all spheres is computed with a single kernel using the tabulated
+// harmonics, with one team per sphere, mode, and real/imaginary part.
 void Z4c::WaveExtr(MeshBlockPack *pmbp) {
   // Spherical Grid for user-defined history
   auto &grids = pmbp->pz4c->spherical_grids;
@@ -73,41 +109,52 @@ void Z4c::WaveExtr(MeshBlockPack *pmbp) {
 
   // number of radii
   int nradii = grids.size();
-
-  // maximum l; TODO(@hzhu): read in from input file
-  int lmax = 8;
+  int lmax = wave_lmax;
+  int nmodes = (lmax + 1)*(lmax + 1) - 4;
+  int nang = grids[0]->nangles;
   // bool bitant = false;
 
-  Real ylmR,ylmI;
-  int count = 0;
   for (int g=0; g<nradii; ++g) {
     // Interpolate Weyl scalars to the surface
     grids[g]->InterpolateToSphere(2, u_weyl);
-    for (int l = 2; l < lmax+1; ++l) {
-      for (int m = -l; m < l+1 ; ++m) {
-        Real psilmR = 0.0;
-        Real psilmI = 0.0;
-          for (int ip = 0; ip < grids[g]->nangles; ++ip) {
-            Real theta = grids[g]->polar_pos.h_view(ip,0);
-            Real phi = grids[g]->polar_pos.h_view(ip,1);
-            Real datareal = grids[g]->interp_vals.h_view(ip,0);
-            Real dataim = grids[g]->interp_vals.h_view(ip,1);
-            Real weight = grids[g]->solid_angles.h_view(ip);
-            swsh(&ylmR,&ylmI,l,m,theta,phi);
-            // The spherical harmonics transform as
-            // Y^s_{l m}( Pi-th, ph ) = (-1)^{l+s} Y^s_{l -m}(th, ph)
-            // but the PoisitionPolar function returns theta \in [0,\pi],
-            // so these are correct for bitant.
-            // With bitant, under reflection the imaginary part of
-            // the weyl scalar should pick a - sign,
-            // which is accounted for here.
-            // Real bitant_z_fac = (bitant && theta > M_PI/2) ? -1 : 1;
-            psilmR += weight*(datareal*ylmR + dataim*ylmI);
-            psilmI += weight*(dataim*ylmR - datareal*ylmI);
-          }
-        psi_out[count++] = psilmR;
-        psi_out[count++] = psilmI;
+    Kokkos::deep_copy(TaskExecSpace(), Kokkos::subview(wave_vals, g, Kokkos::ALL,
+                      Kokkos::ALL), grids[g]->interp_vals.d_view);
+  }
+
+  // The spherical harmonics transform as
+  // Y^s_{l m}( Pi-th, ph ) = (-1)^{l+s} Y^s_{l -m}(th, ph)
+  // but the PoisitionPolar function returns theta \in [0,\pi],
+  // so these are correct for bitant.
+  // With bitant, under reflection the imaginary part of
+  // the weyl scalar should pick a - sign,
+  // which is accounted for here.
+  // Real bitant_z_fac = (bitant && theta > M_PI/2) ? -1 : 1;
+  auto &ylm = wave_ylm;
+  auto &vals = wave_vals;
+  auto &psi = wave_psi;
+  par_for_outer("wave_extr",DevExeSpace(),0,0,0,(nradii-1),0,(nmodes-1),0,1,
+  KOKKOS_LAMBDA(TeamMember_t member, const int g, const int lm, const int c) {
+    Real sum = 0.0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, nang),
+    [=](const int ip, Real &psum) {
+      Real datareal = vals(g,ip,0);
+      Real dataim = vals(g,ip,1);
+      if (c == 0) {
+        psum += datareal*ylm(lm,ip,0) + dataim*ylm(lm,ip,1);
+      } else {
+        psum += dataim*ylm(lm,ip,0) - datareal*ylm(lm,ip,1);
       }
+    }, sum);
+    Kokkos::single(Kokkos::PerTeam(member), [&]() {
+      psi(g,lm,c) = sum;
+    });
+  });
+  auto psi_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), wave_psi);
+  int count = 0;
+  for (int g=0; g<nradii; ++g) {
+    for (int lm=0; lm<nmodes; ++lm) {
+      psi_out[count++] = psi_h(g,lm,0);
+      psi_out[count++] = psi_h(g,lm,1);
     }
   }
 
@@ -120,101 +167,113 @@ void Z4c::WaveExtr(MeshBlockPack *pmbp) {
   }
   #endif
 
+  // files are written by a host task from copies of the modes, after those of the
+  // previous extraction
   if (0 == global_variable::my_rank) {
-    int idx = 0;
+    std::vector<Real> psi(psi_out, psi_out + count);
+    std::vector<Real> radii(nradii);
     for (int g=0; g<nradii; ++g) {
-      // Output file names
-      std::string filename = "waveforms/rpsi4_real_";
-      std::string filename2 = "waveforms/rpsi4_imag_";
-      std::stringstream strObj;
-      strObj << std::setfill('0') << std::setw(4) << grids[g]->radius;
-      filename += strObj.str();
-      filename += ".txt";
-      filename2 += strObj.str();
-      filename2 += ".txt";
-
-      // Check if the file already exists
-      std::ifstream fileCheck(filename);
-      bool fileExists = fileCheck.good();
-      fileCheck.close();
-      std::ifstream fileCheck2(filename2);
-      bool fileExists2 = fileCheck2.good();
-      fileCheck2.close();
-
-
-      // If the file doesn't exist, create it
-      if (!fileExists) {
-        std::ofstream createFile(filename);
-        createFile.close();
+      radii[g] = grids[g]->radius;
+    }
+    Real time = pmbp->pmesh->time;
+    wave_write_done = host_tasks::Submit([psi, radii, time, nradii, lmax]() {
+      int idx = 0;
+      for (int g=0; g<nradii; ++g) {
+        // Output file names
+        std::string filename = "waveforms/rpsi4_real_";
+        std::string filename2 = "waveforms/rpsi4_imag_";
+        std::stringstream strObj;
+        strObj << std::setfill('0') << std::setw(4) << radii[g];
+        filename += strObj.str();
+        filename += ".txt";
+        filename2 += strObj.str();
+        filename2 += ".txt";
 
-        // Open a file stream for writing header
-        std::ofstream outFile;
-        // append mode
-        outFile.open(filename, std::ios::out | std::ios::app);
-        // first append time
-        outFile << "# 1:time" << "\t";
-        // append waveform
-        int a = 2;
-        for (int l = 2; l < lmax+1; ++l) {
-          for (int m = -l; m < l+1 ; ++m) {
-            outFile << std::to_string(a)+":"+std::to_string(l)+std::to_string(m) << '\t';
-            a++;
+        // Check if the file already exists
+        std::ifstream fileCheck(filename);
+        bool fileExists = fileCheck.good();
+        fileCheck.close();
+        std::ifstream fileCheck2(filename2);
+        bool fileExists2 = fileCheck2.good();
+        fileCheck2.close();
+
+
+        // If the file doesn't exist, create it
+        if (!fileExists) {
+          std::ofstream createFile(filename);
+          createFile.close();
+
+          // Open a file stream for writing header
+          std::ofstream outFile;
+          // append mode
+          outFile.open(filename, std::ios::out | std::ios::app);
+          // first append time
+          outFile << "# 1:time" << "\t";
+          // append waveform
+          int a = 2;
+          for (int l = 2; l < lmax+1; ++l) {
+            for (int m = -l; m < l+1 ; ++m) {
+              outFile << std::to_string(a)+":"+std::to_string(l)+std::to_string(m)
+                      << '\t';
+              a++;
+            }
           }
+          outFile << '\n';
+
+          // Close the file stream
+          outFile.close();
         }
-        outFile << '\n';
+        if (!fileExists2) {
+          std::ofstream createFile(filename2);
+          createFile.close();
 
-        // Close the file stream
-        outFile.close();
-      }
-      if (!fileExists2) {
-        std::ofstream createFile(filename2);
-        createFile.close();
+          // Open a file stream for writing header
+          std::ofstream outFile;
+          // append mode
+          outFile.open(filename2, std::ios::out | std::ios::app);
+          // first append time
+          outFile << "# 1:time" << "\t";
+          // append waveform
+          int a = 2;
+          for (int l = 2; l < lmax+1; ++l) {
+            for (int m = -l; m < l+1 ; ++m) {
+              outFile << std::to_string(a)+":"+std::to_string(l)+std::to_string(m)
+                      << '\t';
+              a++;
+            }
+          }
+          outFile << '\n';
 
+          // Close the file stream
+          outFile.close();
+        }
         // Open a file stream for writing header
         std::ofstream outFile;
+        std::ofstream outFile2;
+
         // append mode
-        outFile.open(filename2, std::ios::out | std::ios::app);
+        outFile.open(filename, std::ios::out | std::ios::app);
+        outFile2.open(filename2, std::ios::out | std::ios::app);
+
         // first append time
-        outFile << "# 1:time" << "\t";
+        outFile << time << "\t";
+        outFile2 << time << "\t";
+
         // append waveform
-        int a = 2;
         for (int l = 2; l < lmax+1; ++l) {
           for (int m = -l; m < l+1 ; ++m) {
-            outFile << std::to_string(a)+":"+std::to_string(l)+std::to_string(m) << '\t';
-            a++;
+            outFile << std::setprecision(15) << psi[idx++] << '\t';
+            outFile2 << std::setprecision(15) << psi[idx++] << '\t';
           }
         }
         outFile << '\n';
+        outFile2 << '\n';
 
         // Close the file stream
         outFile.close();
+        outFile2.close();
       }
-      // Open a file stream for writing header
-      std::ofstream outFile;
-      std::ofstream outFile2;
-
-      // append mode
-      outFile.open(filename, std::ios::out | std::ios::app);
-      outFile2.open(filename2, std::ios::out | std::ios::app);
-
-      // first append time
-      outFile << pmbp->pmesh->time << "\t";
-      outFile2 << pmbp->pmesh->time << "\t";
-
-      // append waveform
-      for (int l = 2; l < lmax+1; ++l) {
-        for (int m = -l; m < l+1 ; ++m) {
-          outFile << std::setprecision(15) << psi_out[idx++] << '\t';
-          outFile2 << std::setprecision(15) << psi_out[idx++] << '\t';
-        }
-      }
-      outFile << '\n';
-      outFile2 << '\n';
-
-      // Close the file stream
-      outFile.close();
-      outFile2.close();
-    }
+    }, wave_write_done);
   }
 }
 
@@ -15,9 +15,15 @@ Notes:
   - Scripts that run tests on CPU must have '_cpu' in name
   - Scripts that run tests on CPU with MPI must have '_mpicpu' in name
   - Scripts that run tests on GPU must have '_gpu' in name
+  - With --perf, the zone-cycles/s of every run are recorded in perf_results.json and
+    compared with perf_baselines/<hostname>.json (if it exists), and runs slower than
+    the baseline by more than --perf-tolerance make the suite fail.  Use --perf-update
+    to store the results as the new baseline of this machine instead.
   - For more information, check online automatic testing wiki page.
 """
 import os
+import platform
+import shutil
 import sys
 import pytest
 import argparse
@@ -65,12 +71,32 @@ parser.add_argument(
     "--gpu", nargs="*", help="Run test on GPU. Can add optional cmake arguments."
 )
 parser.add_argument("--test", type=str, help="Run a specific test by name.")
+parser.add_argument(
+    "--perf", action="store_true", help="record and check zone-cycles/s of each run."
+)
+parser.add_argument(
+    "--perf-baseline",
+    type=str,
+    default=os.path.join("perf_baselines", platform.node() + ".json"),
+    help="baseline to compare with [perf_baselines/<hostname>.json].",
+)
+parser.add_argument(
+    "--perf-tolerance",
+    type=float,
+    default=0.25,
+    help="fractional slowdown allowed before a run is flagged [0.25].",
+)
+parser.add_argument(
+    "--perf-update",
+    action="store_true",
+    help="store the recorded results as the baseline instead of checking them.",
+)
 
 
 args = parser.parse_args()
 status = True
-for arg in vars(args):
-    status *= getattr(args, arg) is None
+for arg in ["style", "cpu", "mpicpu", "gpu", "test"]:
+    status *= getattr(args, arg) in (None, False)
 if status:
     print("No target device (CPU/GPU) specified.")
     print(parser.format_help())
@@ -100,6 +126,13 @@ if args.test is not None:
 
 tests = os.path.abspath(tests)
 
+if args.perf or args.perf_update:
+    PERF_RESULTS = os.path.abspath("perf_results.json")
+    PERF_BASELINE = os.path.abspath(args.perf_baseline)
+    if os.path.exists(PERF_RESULTS):
+        os.remove(PERF_RESULTS)
+    testutils.PERF_RESULTS = PERF_RESULTS
+
 if args.cpu is not None:
     testutils.clean_make(flags=cmake_flags(args.cpu, []))
     test([tests, "-k", "_cpu"])  # run all scripts with _cpu in name
@@ -114,3 +147,20 @@ if args.gpu is not None:
 
 os.chdir(original_dir)
 testutils.clean()
+
+if testutils.PERF_RESULTS is not None and os.path.exists(PERF_RESULTS):
+    if args.perf_update:
+        os.makedirs(os.path.dirname(PERF_BASELINE), exist_ok=True)
+        shutil.copyfile(PERF_RESULTS, PERF_BASELINE)
+        print(f"Performance baseline written to {PERF_BASELINE}")
+    elif os.path.exists(PERF_BASELINE):
+        slower = testutils.compare_perf(
+            PERF_RESULTS, PERF_BASELINE, tolerance=args.perf_tolerance
+        )
+        if slower:
+            print("Performance regressions:")
+            for message in slower:
+                print("  " + message)
+            sys.exit(1)
+    else:
+        print(f"No performance baseline {PERF_BASELINE}, use --perf-update to create it")
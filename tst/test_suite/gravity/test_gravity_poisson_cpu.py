@@ -0,0 +1,56 @@
+"""
+Test of the multigrid Poisson solver of self-gravity with V- and F-cycles.  The potential
+of a sinusoidal density on a periodic 3D mesh with several MeshBlocks is compared to the
+analytic solution.  The solver must converge within max_cycles, and the error must
+converge at second order with resolution.
+"""
+
+# Modules
+import pytest
+import athena_read
+import test_suite.testutils as testutils
+
+input_file = "inputs/poisson.athinput"
+# Threshold error and error ratio
+maxerror = (1.0e-6, 0.3)
+max_cycles = 50
+_res = [32, 64]  # resolutions to test
+L1_INDEX = 4  # Index for L1 error in data
+NCYCLES_INDEX = 6  # Index for number of multigrid cycles in data
+
+
+@pytest.mark.parametrize("cycle", ["V", "F"])
+def test_poisson(cycle):
+    """Sinusoidal density with given multigrid cycle."""
+    try:
+        for res in _res:
+            arguments = [
+                f"gravity/cycle={cycle}",
+                f"gravity/max_cycles={max_cycles}",
+                f"mesh/nx1={res}",
+                f"mesh/nx2={res}",
+                f"mesh/nx3={res}",
+            ]
+            results = testutils.run(input_file, arguments)
+            assert results, f"Poisson test failed for {cycle}-cycles and {res}."
+        data = athena_read.error_dat("poisson-errs.dat")
+        for row in data:
+            if row[NCYCLES_INDEX] >= max_cycles:
+                pytest.fail(
+                    f"Multigrid with {cycle}-cycles did not converge in {max_cycles} "
+                    f"cycles for {int(row[0])}^3 cells"
+                )
+        l1_lr = data[0][L1_INDEX]
+        l1_hr = data[1][L1_INDEX]
+        if l1_hr > maxerror[0]:
+            pytest.fail(
+                f"Potential error too large for {cycle}-cycles, "
+                f"error: {l1_hr:g} threshold: {maxerror[0]:g}"
+            )
+        if l1_hr / l1_lr > maxerror[1]:
+            pytest.fail(
+                f"Potential not converging for {cycle}-cycles, "
+                f"error ratio: {l1_hr / l1_lr:g} threshold: {maxerror[1]:g}"
+            )
+    finally:
+        testutils.cleanup()
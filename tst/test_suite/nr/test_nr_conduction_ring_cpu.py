@@ -0,0 +1,40 @@
+"""
+Ring test of anisotropic conduction in MHD (Parrish & Stone 2005, Sharma & Hammett 2007)
+with explicit heat fluxes and with RKL2 super time-stepping.  Heat in a patch of an
+annulus diffuses along circular field lines.  The slope-limited transverse gradients
+must not create new temperature extrema, and most of the heat must stay in the annulus.
+"""
+
+# Modules
+import pytest
+import athena_read
+import test_suite.testutils as testutils
+
+t0, dt0 = 10.0, 2.0  # background temperature and its increase in patch
+tol_extrema = 0.01  # allowed over/undershoot as fraction of dt0
+max_heat_outside = 0.1  # maximum fraction of excess heat outside annulus
+TMIN_INDEX, TMAX_INDEX, HEAT_INDEX = 4, 5, 6  # Index of diagnostics in data
+
+
+@pytest.mark.parametrize("sts", ["none", "rkl2"])
+def test_run(sts):
+    """Ring test with given super time-stepping integrator."""
+    try:
+        arguments = [f"time/sts_integrator={sts}"]
+        results = testutils.run("inputs/conduction_ring.athinput", arguments)
+        assert results, f"Conduction ring run failed for {sts}."
+        data = athena_read.error_dat("conduction_ring-errs.dat")
+        tmin, tmax = data[0][TMIN_INDEX], data[0][TMAX_INDEX]
+        heat_outside = data[0][HEAT_INDEX]
+        if tmin < t0 - tol_extrema * dt0 or tmax > t0 + (1.0 + tol_extrema) * dt0:
+            pytest.fail(
+                f"New temperature extrema for sts_integrator={sts}, "
+                f"T_min: {tmin:g} T_max: {tmax:g}"
+            )
+        if heat_outside > max_heat_outside:
+            pytest.fail(
+                f"Too much heat diffused across field for sts_integrator={sts}, "
+                f"fraction outside: {heat_outside:g} threshold: {max_heat_outside:g}"
+            )
+    finally:
+        testutils.cleanup()
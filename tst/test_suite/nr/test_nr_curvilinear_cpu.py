@@ -0,0 +1,92 @@
+"""
+Tests of hydrodynamics in cylindrical and spherical-polar coordinates.
+  - a uniform pressure at rest must remain in equilibrium to round-off in 2D
+  - a rotating ring in cylindrical coordinates, with the pressure gradient balancing the
+    centrifugal force, must remain steady to second order in the cell size
+"""
+
+# Modules
+import numpy as np
+import pytest
+import athena_read
+import test_suite.testutils as testutils
+
+input_file = "inputs/curvilinear.athinput"
+
+# 2D meshes for the uniform equilibrium, including the axis and poles
+_mesh = {}
+_mesh["cylindrical"] = [
+    "mesh/x1min=0.0",
+    "mesh/x1max=1.0",
+    "mesh/ix1_bc=reflect",
+    "mesh/x2min=0.0",
+    f"mesh/x2max={2.0 * np.pi!r}",
+]
+_mesh["spherical_polar"] = [
+    "mesh/x1min=0.5",
+    "mesh/x1max=1.5",
+    "mesh/x2min=0.0",
+    f"mesh/x2max={np.pi!r}",
+    "mesh/ix2_bc=reflect",
+    "mesh/ox2_bc=reflect",
+    "mesh/x3min=0.0",
+    f"mesh/x3max={2.0 * np.pi!r}",
+]
+
+maxerror_uniform = 1.0e-12
+# Threshold error and error ratio for the rotating ring
+maxerror_rotating = (1.0e-3, 0.4)
+_res = [128, 256]  # resolutions to test
+L1_RMS_INDEX = 4  # Index for L1 RMS error in data
+
+
+@pytest.mark.parametrize("system", ["cylindrical", "spherical_polar"])
+def test_uniform(system):
+    """Uniform pressure at rest in 2D."""
+    arguments = _mesh[system] + [
+        f"coord/system={system}",
+        "problem/type=uniform",
+        "mesh/nx1=32",
+        "mesh/nx2=32",
+        "meshblock/nx1=16",
+        "meshblock/nx2=16",
+        "time/nlim=50",
+    ]
+    try:
+        results = testutils.run(input_file, arguments)
+        assert results, f"Uniform equilibrium run failed for {system}."
+        data = athena_read.error_dat("curvilinear-errs.dat")
+        l1_rms = data[0][L1_RMS_INDEX]
+        if l1_rms > maxerror_uniform:
+            pytest.fail(
+                f"Uniform state not in equilibrium for {system}, "
+                f"error: {l1_rms:g} threshold: {maxerror_uniform:g}"
+            )
+    finally:
+        testutils.cleanup()
+
+
+def test_rotating():
+    """Convergence of the steady rotating ring in cylindrical coordinates."""
+    try:
+        for res in _res:
+            results = testutils.run(
+                input_file, [f"mesh/nx1={res}", "problem/type=rotating"]
+            )
+            assert results, f"Rotating ring run failed for {res}."
+        maxerror, maxratio = maxerror_rotating
+        data = athena_read.error_dat("curvilinear-errs.dat")
+        l1_rms_lr = data[0][L1_RMS_INDEX]
+        l1_rms_hr = data[1][L1_RMS_INDEX]
+        if l1_rms_hr > maxerror:
+            pytest.fail(
+                f"Rotating ring error too large, "
+                f"error: {l1_rms_hr:g} threshold: {maxerror:g}"
+            )
+        if l1_rms_hr / l1_rms_lr > maxratio:
+            pytest.fail(
+                f"Rotating ring not converging, "
+                f"error ratio: {l1_rms_hr / l1_rms_lr:g} threshold: {maxratio:g}"
+            )
+    finally:
+        testutils.cleanup()
@@ -0,0 +1,50 @@
+"""
+Convergence test of viscous diffusion of a Gaussian velocity profile for
+non-relativistic hydro, with explicit viscous fluxes and with RKL1/RKL2 super
+time-stepping.  With STS the timestep is set by the hyperbolic CFL condition, so the
+solution converges at first order in time with RKL1 and second order with RKL2.
+"""
+
+# Modules
+import pytest
+import athena_read
+import test_suite.testutils as testutils
+
+# Threshold errors and error ratios for each super time-stepping integrator
+errors = {
+    "none": (1.0e-7, 0.3),
+    "rkl1": (1.0e-7, 0.6),
+    "rkl2": (1.0e-7, 0.3),
+}
+_res = [64, 128]  # resolutions to test
+L1_RMS_INDEX = 4  # Index for L1 RMS error in data
+
+
+@pytest.mark.parametrize("sts", ["none", "rkl1", "rkl2"])
+def test_run(sts):
+    """Diffusion of Gaussian with given super time-stepping integrator."""
+    try:
+        for res in _res:
+            arguments = [
+                f"time/sts_integrator={sts}",
+                f"mesh/nx1={res}",
+                f"meshblock/nx1={res // 2}",
+            ]
+            results = testutils.run("inputs/viscosity.athinput", arguments)
+            assert results, f"Viscous diffusion run failed for {sts} and {res}."
+        maxerror, maxratio = errors[sts]
+        data = athena_read.error_dat("viscosity-errs.dat")
+        l1_rms_lr = data[0][L1_RMS_INDEX]
+        l1_rms_hr = data[1][L1_RMS_INDEX]
+        if l1_rms_hr > maxerror:
+            pytest.fail(
+                f"Viscous diffusion error too large for sts_integrator={sts}, "
+                f"error: {l1_rms_hr:g} threshold: {maxerror:g}"
+            )
+        if l1_rms_hr / l1_rms_lr > maxratio:
+            pytest.fail(
+                f"Viscous diffusion not converging for sts_integrator={sts}, "
+                f"error ratio: {l1_rms_hr / l1_rms_lr:g} threshold: {maxratio:g}"
+            )
+    finally:
+        testutils.cleanup()
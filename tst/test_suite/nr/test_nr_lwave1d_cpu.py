@@ -7,7 +7,9 @@ Runs tests in both hydro and MHD for different
 """
 
 # Modules
+import subprocess
 import pytest
+import athena_read
 import test_suite.testutils as testutils
 
 # Threshold errors and error ratios for different integrators, reconstruction,
@@ -93,9 +95,30 @@ errors = {
     ("mhd", "rk3", "ppm4", "3"): (6e-09, 0.26),
     ("mhd", "rk3", "ppmx", "3"): (1.9e-11, 0.066),
     ("mhd", "rk3", "wenoz", "3"): (3.4e-12, 0.045),
+    # integrators with more stages are tested for hydro only, with thresholds of rk3
+    ("hydro", "ssprk43", "plm", "0"): (1.8e-08, 0.28),
+    ("hydro", "ssprk43", "wenoz", "0"): (2.3e-11, 0.11),
+    ("hydro", "ssprk43", "plm", "4"): (1.8e-08, 0.28),
+    ("hydro", "ssprk43", "wenoz", "4"): (2.3e-11, 0.11),
+    ("hydro", "ssprk43", "plm", "3"): (1.2e-08, 0.29),
+    ("hydro", "ssprk43", "wenoz", "3"): (2.5e-12, 0.064),
+    ("hydro", "ssprk104", "plm", "0"): (1.8e-08, 0.28),
+    ("hydro", "ssprk104", "wenoz", "0"): (2.3e-11, 0.11),
+    ("hydro", "ssprk104", "plm", "4"): (1.8e-08, 0.28),
+    ("hydro", "ssprk104", "wenoz", "4"): (2.3e-11, 0.11),
+    ("hydro", "ssprk104", "plm", "3"): (1.2e-08, 0.29),
+    ("hydro", "ssprk104", "wenoz", "3"): (2.5e-12, 0.064),
+    ("hydro", "rk32", "plm", "0"): (1.8e-08, 0.28),
+    ("hydro", "rk32", "wenoz", "0"): (2.3e-11, 0.11),
+    ("hydro", "rk32", "plm", "4"): (1.8e-08, 0.28),
+    ("hydro", "rk32", "wenoz", "4"): (2.3e-11, 0.11),
+    ("hydro", "rk32", "plm", "3"): (1.2e-08, 0.29),
+    ("hydro", "rk32", "wenoz", "3"): (2.5e-12, 0.064),
 }
 
 _int = ["rk2", "rk3"]
+_int_hydro = ["ssprk43", "ssprk104", "rk32"]
+_recon_hydro = ["plm", "wenoz"]
 _recon = ["plm", "ppm4", "ppmx", "wenoz"]
 _wave = {}
 _wave["mhd"] = ["0", "6", "5", "1", "4", "2", "3"]
@@ -158,3 +181,53 @@ def test_run(iv, rv, soe):
                 f"Errors in L/R-going waves not equal for {soe}+{iv}+{rv}+{fv}, "
                 f"L: {l1_rms_l:g} R: {l1_rms_r:g}"
             )
+
+
+@pytest.mark.parametrize("iv", _int_hydro)
+@pytest.mark.parametrize("rv", _recon_hydro)
+def test_run_integrators(iv, rv):
+    """Run hydro test with HLLC and given integrator/reconstruction."""
+    testutils.test_error_convergence(
+        "inputs/lwave_hydro.athinput",
+        "lwave1d_hydro",
+        arguments,
+        errors,
+        _wave["hydro"],
+        _res,
+        iv,
+        rv,
+        "hllc",
+        "hydro",
+        left_wave="0",
+        right_wave="4",
+    )
+
+
+def test_rk32_reject():
+    """Run rk32 with tolerances small enough that steps are rejected, and check
+    both that at least one step is rejected and that the solution is still accurate."""
+    flags = arguments("rk32", "plm", "hllc", "0", 64, "hydro", "lwave1d_hydro") + [
+        "time/err_rtol=0.0",
+        "time/err_atol=1.0e-13",
+    ]
+    command = ["./athena", "-i", "inputs/lwave_hydro.athinput"] + flags
+    try:
+        process = subprocess.run(command, capture_output=True, text=True)
+        assert process.returncode == 0, "rk32 run with error control failed."
+        nreject = 0
+        for line in process.stdout.splitlines():
+            if line.startswith("steps rejected by error control ="):
+                nreject = int(line.split("=")[1])
+        if nreject == 0:
+            pytest.fail("No steps rejected by rk32 with err_atol=1e-13")
+        maxerror = errors[("hydro", "rk32", "plm", "0")][0]
+        data = athena_read.error_dat("lwave1d_hydro-errs.dat")
+        L1_RMS_INDEX = 4  # Index for L1 RMS error in data
+        l1_rms = data[0][L1_RMS_INDEX]
+        if l1_rms > maxerror:
+            pytest.fail(
+                f"error too large for rk32 with rejected steps, "
+                f"error: {l1_rms:g} threshold: {maxerror:g}"
+            )
+    finally:
+        testutils.cleanup()
@@ -72,3 +72,29 @@ def test_run(rv, soe):
             soe,
             mpi=True,
         )
+
+
+def arguments_reduced(iv, rv, fv, wv, res, soe, name):
+    """Arguments with reduced-precision messages between levels"""
+    return arguments(iv, rv, fv, wv, res, soe, name) + [
+        f"{soe}/reduced_precision_bvals=true"
+    ]
+
+
+@pytest.mark.parametrize("soe", ["hydro", "mhd"])
+def test_run_reduced_bvals(soe):
+    """Single-precision messages between levels must not change convergence."""
+    for fv in _flux[soe]:
+        _, _ = testutils.test_error_convergence(
+            f"inputs/lwave_{soe}.athinput",
+            f"lwave2d_amr_{soe}",
+            arguments_reduced,
+            errors,
+            _wave,
+            _res,
+            "rk2",
+            "plm",
+            fv,
+            soe,
+            mpi=True,
+        )
@@ -0,0 +1,65 @@
+"""
+Tests of the implicit coupling of radiation to (magnetized) GR fluids, using a uniform
+fluid in a periodic box.
+  - A magnetized fluid moving through black-body radiation that is isotropic in the
+    fluid frame is an exact equilibrium, which must be held to round-off.
+  - A magnetized fluid moving through radiation at rest exchanges momentum with it.
+    With large opacity, the radiation after one implicit step must be (nearly) isotropic
+    in the frame of the updated fluid, which requires the inertia of the fluid to
+    include the magnetic contribution b^2.  Total momentum must be conserved.
+"""
+
+# Modules
+import numpy as np
+import athena_read
+import test_suite.testutils as testutils
+
+input_file = "inputs/rad_equilibrium.athinput"
+
+
+def read(var, n):
+    return athena_read.tab(f"tab/rad_eq.{var}.{n:05d}.tab")
+
+
+def fluid_frame_flux(data):
+    """Fluid-frame radiation flux relative to fluid-frame energy density."""
+    flux = np.sqrt(data["r01_ff"] ** 2 + data["r02_ff"] ** 2 + data["r03_ff"] ** 2)
+    return np.max(flux / data["r00_ff"])
+
+
+def test_equilibrium():
+    """Uniform magnetized fluid with radiation isotropic in its frame."""
+    try:
+        testutils.run(
+            input_file,
+            ["time/nlim=10", "problem/v1=0.1", "problem/v1_rad=0.1", "problem/b2=3.0"],
+        )
+        w0, w1 = read("rad_mhd_w", 0), read("rad_mhd_w", 1)
+        for var in ["dens", "velx", "eint", "r00", "r01"]:
+            err = np.max(np.abs(w1[var] - w0[var])) / np.max(np.abs(w0[var]))
+            assert err < 1.0e-10, f"{var} changed by {err:g} in equilibrium"
+    finally:
+        testutils.cleanup()
+
+
+def test_momentum_exchange():
+    """Magnetized fluid moving through radiation at rest, one optically thick step."""
+    try:
+        testutils.run(
+            input_file,
+            ["time/nlim=1", "problem/v1=0.1", "problem/v1_rad=0.0", "problem/b2=3.0"],
+        )
+        u0, u1 = read("rad_mhd_u", 0), read("rad_mhd_u", 1)
+        mom0 = u0["mom1"] + u0["r01"]
+        mom1 = u1["mom1"] + u1["r01"]
+        err = np.max(np.abs(mom1 - mom0)) / np.max(np.abs(mom0))
+        assert err < 1.0e-10, f"total momentum not conserved, error {err:g}"
+
+        flux0 = fluid_frame_flux(read("rad_mhd_w", 0))
+        flux1 = fluid_frame_flux(read("rad_mhd_w", 1))
+        assert flux1 < 1.0e-2 * flux0, (
+            f"radiation not isotropic in fluid frame after coupling: "
+            f"F/E = {flux1:g}, initially {flux0:g}"
+        )
+    finally:
+        testutils.cleanup()
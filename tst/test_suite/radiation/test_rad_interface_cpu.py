@@ -0,0 +1,31 @@
+"""
+Test of the moment fallback for optically thick MeshBlocks in a periodic box, in which
+a pulse of radiation crosses the boundaries between thin MeshBlocks (evolved with
+intensities) and thick MeshBlocks (evolved with moments).  Fluxes on MeshBlock faces
+must be the same on both sides, so that the total radiation energy is conserved.
+"""
+
+# Modules
+import numpy as np
+import pytest
+import athena_read
+import test_suite.testutils as testutils
+
+input_file = "inputs/rad_interface.athinput"
+
+
+def total_energy(n):
+    data = athena_read.tab(f"tab/rad_int.rad_coord.{n:05d}.tab")
+    return np.sum(data["r00"])
+
+
+@pytest.mark.parametrize("integrator", ["rk2", "rk3"])
+def test_interface_conservation(integrator):
+    """Total radiation energy across thin/thick MeshBlock boundaries."""
+    try:
+        testutils.run(input_file, [f"time/integrator={integrator}"])
+        e0, e1 = total_energy(0), total_energy(1)
+        err = abs(e1 - e0) / e0
+        assert err < 1.0e-12, f"radiation energy not conserved, error {err:g}"
+    finally:
+        testutils.cleanup()
@@ -59,7 +59,7 @@ _wave = {}
 _wave["mhd"] = ["0", "6", "5", "1", "4", "2", "3"]
 _wave["hydro"] = ["0", "4", "3"]
 _flux = {}
-_flux["mhd"] = ["llf", "hlle"]
+_flux["mhd"] = ["llf", "hlle", "hlld"]
 _flux["hydro"] = ["llf", "hlle", "hllc"]
 _res = [32, 64]  # resolutions to test
 
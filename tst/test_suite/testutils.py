@@ -9,6 +9,7 @@ Various utility functions used for automatic testing, including
 import os
 from subprocess import Popen, PIPE
 from typing import List
+import json
 import time
 import pytest
 import logging
@@ -23,6 +24,12 @@ athena_read.check_nan_flag = True  # Enable NaN checking in athena_read
 ATHENAK_PATH = ".."
 ATHENAK_BUILD = "build/src"
 
+# Performance results are recorded when PERF_RESULTS is set to the path of a JSON file
+# (see run_test_suite.py --perf).  Each run of the binary appends its ATHENA_PERF line,
+# keyed by the test and the command line, so that repeated suites give the same keys.
+PERF_RESULTS = None
+PERF_PREFIX = "ATHENA_PERF"
+
 # Configure logging
 LOG_FILE_PATH = os.path.abspath(os.path.join(ATHENAK_PATH, "tst", "test_log.txt"))
 logging.basicConfig(
@@ -56,9 +63,107 @@ def run_command(command: List[str], text: bool = False) -> bool:
 
     if process.returncode != 0:
         logging.error(f"Command failed with return code {process.returncode}")
+    elif PERF_RESULTS is not None:
+        record_perf(command, output)
     return process.returncode == 0
 
 
+def parse_perf(output: str) -> dict:
+    """
+    Extracts the performance summary printed by Driver::Finalize.
+
+    Args:
+        output (str): The standard output of the AthenaK binary.
+
+    Returns:
+        dict: The key=value pairs of the last ATHENA_PERF line as floats, or an empty
+        dictionary if there is none (e.g. problems without time evolution).
+    """
+    perf = {}
+    for line in output.splitlines():
+        words = line.split()
+        if not words or words[0] != PERF_PREFIX:
+            continue
+        perf = {}
+        for word in words[1:]:
+            key, _, value = word.partition("=")
+            try:
+                perf[key] = float(value)
+            except ValueError:
+                pass
+    return perf
+
+
+def record_perf(command: List[str], output: str) -> None:
+    """
+    Appends the performance summary of one run to the PERF_RESULTS file.
+
+    Args:
+        command (list): The command that was executed.
+        output (str): Its standard output.
+    """
+    perf = parse_perf(output)
+    if not perf:
+        return
+    # PYTEST_CURRENT_TEST is "path::test_name[params] (call)"
+    test = os.environ.get("PYTEST_CURRENT_TEST", "").split(" ")[0]
+    if "./athena" in command:
+        command = command[command.index("./athena"):]
+    key = test + " " + " ".join(command)
+    results = {}
+    if os.path.exists(PERF_RESULTS):
+        with open(PERF_RESULTS, "r") as f:
+            results = json.load(f)
+    results[key] = perf
+    with open(PERF_RESULTS, "w") as f:
+        json.dump(results, f, indent=1, sort_keys=True)
+
+
+def compare_perf(
+    results_file: str,
+    baseline_file: str,
+    tolerance: float = 0.25,
+    min_seconds: float = 1.0,
+) -> List[str]:
+    """
+    Compares recorded zone-cycles/s against a stored baseline of the same machine.
+
+    Args:
+        results_file (str): JSON file written by record_perf().
+        baseline_file (str): JSON file of an earlier suite on this machine.
+        tolerance (float): Fractional slowdown allowed before a run is flagged.
+        min_seconds (float): Runs shorter than this (in the baseline) are too noisy to
+            compare, and are skipped.
+
+    Returns:
+        list: One message per run slower than the baseline by more than tolerance.
+    """
+    with open(results_file, "r") as f:
+        results = json.load(f)
+    with open(baseline_file, "r") as f:
+        baseline = json.load(f)
+    slower = []
+    ncompared = 0
+    for key, perf in sorted(results.items()):
+        if key not in baseline:
+            continue
+        base = baseline[key]
+        if base.get("cpu_seconds", 0.0) < min_seconds:
+            continue
+        ncompared += 1
+        rate, base_rate = perf["zone_cycles_per_s"], base["zone_cycles_per_s"]
+        if rate < (1.0 - tolerance) * base_rate:
+            slower.append(
+                f"{key}: {rate:.4g} zone-cycles/s, baseline {base_rate:.4g} "
+                f"({100.0 * (rate / base_rate - 1.0):+.1f}%)"
+            )
+    logging.info(
+        f"Compared {ncompared} of {len(results)} runs with baseline {baseline_file}, "
+        f"{len(slower)} slower by more than {100.0 * tolerance:g}%"
+    )
+    return slower
+
+
 def cmake(flags: List[str] = [], **kwargs) -> bool:
     """
     Runs the CMake command to configure the build system.
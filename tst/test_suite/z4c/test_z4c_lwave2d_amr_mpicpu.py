@@ -60,3 +60,32 @@ def test_run_2nd():
             )
     finally:
         testutils.cleanup()
+
+
+# run test of 2nd order FD with low-storage RK4 integrator
+def test_run_lsrk54():
+    """Run a single test with integrator=lsrk54."""
+    try:
+        for res in _res:
+            results = testutils.mpi_run(
+                input_file, arguments(res) + ["time/integrator=lsrk54"]
+            )
+            assert results, f"Z4c linear wave run with lsrk54 failed for {res}."
+        maxerror, errorratio = errors[("2nd-order")]
+        data = athena_read.error_dat("z4c_lin_wave-errs.dat")
+        L1_RMS_INDEX = 4  # Index for L1 RMS error in data
+        l1_rms_err0 = data[0][L1_RMS_INDEX]
+        l1_rms_err1 = data[1][L1_RMS_INDEX]
+        if l1_rms_err1 > maxerror:
+            pytest.fail(
+                f"Z4c wave error too large with lsrk54,"
+                f"error: {l1_rms_err1:g} threshold: {maxerror:g}"
+            )
+        if (l1_rms_err1 / l1_rms_err0) > errorratio:
+            pytest.fail(
+                f"Z4c wave converging too slow with lsrk54,"
+                f"error ratio: {(l1_rms_err1/l1_rms_err0):g}"
+                f"  expected ratio: {errorratio:g}"
+            )
+    finally:
+        testutils.cleanup()
@@ -1,6 +1,8 @@
 """
 Linear wave convergence test for Z4c with AMR in full 3D.
 Does a convergence test for 2nd-order, but only tests amplitude error for 6th-order.
+The 8th-order test (nghost=5) only runs on uniform meshes, and uses rk4 with a small
+CFL number so that the convergence of the spatial error can be tested.
 """
 
 # Modules
@@ -10,21 +12,26 @@ import athena_read
 
 
 # Threshold errors and error ratios for different finite-difference orders
-errors = {("2nd-order"): (3.5e-11, 0.25), ("6th-order"): (6.0e-12, 0.0)}
+errors = {
+    ("2nd-order"): (3.5e-11, 0.25),
+    ("6th-order"): (6.0e-12, 0.0),
+    ("8th-order"): (6.0e-12, 1.0 / 64.0),
+}
 
 _res = [32, 64]  # resolutions to test
+_res_8th = [16, 32]  # resolutions to test at 8th-order
 
 
-def arguments(res, ng):
+def arguments(res, ng, nmb=8):
     """Assemble arguments for run command"""
     return [
         "mesh/nghost=" + repr(ng),
         "mesh/nx1=" + repr(res),
         "mesh/nx2=" + repr(res),
         "mesh/nx3=" + repr(res),
-        "meshblock/nx1=" + repr(res // 8),
-        "meshblock/nx2=" + repr(res // 8),
-        "meshblock/nx3=" + repr(res // 8),
+        "meshblock/nx1=" + repr(res // nmb),
+        "meshblock/nx2=" + repr(res // nmb),
+        "meshblock/nx3=" + repr(res // nmb),
         "mesh_refinement/max_nmb_per_rank=4096",
         "problem/kx1=1",
         "problem/kx2=1",
@@ -82,3 +89,36 @@ def test_run_6th():
             )
     finally:
         testutils.cleanup()
+
+
+# tests maxerror and convergence faster than 6th-order at 8th-order, on uniform mesh
+def test_run_8th():
+    """Run a single test."""
+    ng = 5
+    try:
+        for res in _res_8th:
+            flags = arguments(res, ng, nmb=2) + [
+                "mesh_refinement/refinement=none",
+                "time/integrator=rk4",
+                "time/cfl_number=0.05",
+            ]
+            results = testutils.run(input_file, flags)
+            assert results, f"8th-order Z4c linear wave run failed for {res}."
+        maxerror, errorratio = errors[("8th-order")]
+        data = athena_read.error_dat("z4c_lin_wave-errs.dat")
+        L1_RMS_INDEX = 4  # Index for L1 RMS error in data
+        l1_rms_err0 = data[0][L1_RMS_INDEX]
+        l1_rms_err1 = data[1][L1_RMS_INDEX]
+        if l1_rms_err1 > maxerror:
+            pytest.fail(
+                f"8th-order Z4c wave error too large,"
+                f"error: {l1_rms_err1:g} threshold: {maxerror:g}"
+            )
+        if (l1_rms_err1 / l1_rms_err0) > errorratio:
+            pytest.fail(
+                f"8th-order Z4c wave converging too slow,"
+                f"error ratio: {(l1_rms_err1/l1_rms_err0):g}"
+                f"  expected ratio: {errorratio:g}"
+            )
+    finally:
+        testutils.cleanup()
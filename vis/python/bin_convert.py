@@ -27,6 +27,15 @@ the athdf file from the xdmf, so please be aware of this requirement.
 
 ----
 
+For large files, LazyBinary memory-maps the file and reads only the
+requested variables, MeshBlocks or region (in parallel), using the block
+index written at the end of bin files with <output>/block_index=true:
+
+  lb = bin_convert.LazyBinary("path/to/file.bin")
+  filedata = lb.read(variables=["dens"], region=(0.0, 0.5, 0.0, 0.5, -1.0, 1.0))
+
+----
+
 The read_*(...) functions return a filedata dictionary-like object with
 
     filedata['header'] = array of strings
@@ -88,32 +97,39 @@ import os
 import h5py
 import glob
 
+_BLOCK_INDEX_MAGIC = b"ATHBIDX1"
 
-def read_binary(filename):
-    """
-    Reads a bin file from filename to dictionary.
 
-    Originally written by Lev Arzamasskiy (leva@ias.edu) on 11/15/2021
-    Updated to support mesh refinement by George Wong (gnwong@ias.edu) on 01/27/2022
-    Made faster by Drummond Fielding on 09/09/2024
-
-    args:
-      filename - string
-          filename of bin file to read
-
-    returns:
-      filedata - dict
-          dictionary of fluid file data
+def _read_meshblock_data(fp, compression, varfmt, n_vars, ncells):
     """
+    Reads data of all variables on one MeshBlock from fp. In compressed files
+    (compression=zstd), each variable is stored as the size of the compressed data
+    (uint64) followed by the zstd-compressed, byte-shuffled floats.
+    """
+    if compression == "none":
+        return np.fromfile(
+            fp, dtype=np.float64 if varfmt == "d" else np.float32, count=ncells * n_vars
+        )
+    if compression != "zstd":
+        raise ValueError(f"unsupported compression {compression}")
+    import zstandard
+
+    decompressor = zstandard.ZstdDecompressor()
+    data = np.empty((n_vars, ncells), dtype=np.float32)
+    for vari in range(n_vars):
+        csize = int(np.frombuffer(fp.read(8), dtype=np.uint64)[0])
+        raw = decompressor.decompress(fp.read(csize), max_output_size=4 * ncells)
+        shuffled = np.frombuffer(raw, dtype=np.uint8).reshape(4, ncells)
+        data[vari] = shuffled.T.copy().view(np.float32)[:, 0]
+    return data
 
-    filedata = {}
-
-    # load file and get size
-    fp = open(filename, "rb")
-    fp.seek(0, 2)
-    filesize = fp.tell()
-    fp.seek(0, 0)
 
+def _read_binary_header(fp):
+    """
+    Reads the preheader and header of a bin file from fp (positioned at the start of the
+    file), and leaves fp positioned at the first MeshBlock record. Returns a dictionary
+    of the header information.
+    """
     # load header information and validate file format
     code_header = fp.readline().split()
     if len(code_header) < 1:
@@ -124,7 +140,7 @@ def read_binary(filename):
             + '(should be "Athena")'
         )
     version = code_header[-1].split(b"=")[-1]
-    if version != b"1.1":
+    if version not in [b"1.1", b"1.2"]:
         raise TypeError(f"unsupported file format version {version.decode('utf-8')}")
 
     pheader_count = int(fp.readline().split(b"=")[-1])
@@ -136,6 +152,7 @@ def read_binary(filename):
     cycle = int(pheader["cycle"])
     locsizebytes = int(pheader["size of location"])
     varsizebytes = int(pheader["size of variable"])
+    compression = pheader.get("compression", "none")
 
     nvars = int(fp.readline().split(b"=")[-1])
     var_list = [v.decode("utf-8") for v in fp.readline().split()[1:]]
@@ -188,6 +205,100 @@ def read_binary(filename):
     x3min = float(get_from_header(header, "<mesh>", "x3min"))
     x3max = float(get_from_header(header, "<mesh>", "x3max"))
 
+    return {
+        "header": header,
+        "time": time,
+        "cycle": cycle,
+        "var_names": var_list,
+        "nvars": nvars,
+        "compression": compression,
+        "locsizebytes": locsizebytes,
+        "locfmt": locfmt,
+        "varfmt": varfmt,
+        "nghost": nghost,
+        "Nx1": Nx1,
+        "Nx2": Nx2,
+        "Nx3": Nx3,
+        "nx1_mb": nx1,
+        "nx2_mb": nx2,
+        "nx3_mb": nx3,
+        "x1min": x1min,
+        "x1max": x1max,
+        "x2min": x2min,
+        "x2max": x2max,
+        "x3min": x3min,
+        "x3max": x3max,
+    }
+
+
+def _read_block_index(fp, filesize):
+    """
+    Reads the index of MeshBlock records written at the end of bin files with
+    <output>/block_index=true: for each MeshBlock its gid, the offset of its record in the
+    file, and the size of its record (all uint64), followed by the number of MeshBlocks
+    (uint64) and the 8 characters "ATHBIDX1". Returns the index as an array with shape
+    [n_mbs, 3] (or None if the file has no index) and the end of the MeshBlock records.
+    The position of fp is unchanged.
+    """
+    pos = fp.tell()
+    index = None
+    data_end = filesize
+    if filesize >= 16:
+        fp.seek(filesize - 16)
+        trailer = fp.read(16)
+        if trailer[8:] == _BLOCK_INDEX_MAGIC:
+            n_mbs = int(np.frombuffer(trailer[:8], dtype=np.uint64)[0])
+            data_end = filesize - 16 - 24 * n_mbs
+            fp.seek(data_end)
+            index = np.frombuffer(fp.read(24 * n_mbs), dtype=np.uint64)
+            index = index.reshape(n_mbs, 3).astype(np.int64)
+    fp.seek(pos)
+    return index, data_end
+
+
+def read_binary(filename):
+    """
+    Reads a bin file from filename to dictionary.
+
+    Originally written by Lev Arzamasskiy (leva@ias.edu) on 11/15/2021
+    Updated to support mesh refinement by George Wong (gnwong@ias.edu) on 01/27/2022
+    Made faster by Drummond Fielding on 09/09/2024
+
+    args:
+      filename - string
+          filename of bin file to read
+
+    returns:
+      filedata - dict
+          dictionary of fluid file data
+    """
+
+    filedata = {}
+
+    # load file and get size
+    fp = open(filename, "rb")
+    fp.seek(0, 2)
+    filesize = fp.tell()
+    fp.seek(0, 0)
+
+    info = _read_binary_header(fp)
+    header = info["header"]
+    time = info["time"]
+    cycle = info["cycle"]
+    var_list = info["var_names"]
+    nvars = info["nvars"]
+    compression = info["compression"]
+    locsizebytes = info["locsizebytes"]
+    locfmt = info["locfmt"]
+    varfmt = info["varfmt"]
+    nghost = info["nghost"]
+    Nx1, Nx2, Nx3 = info["Nx1"], info["Nx2"], info["Nx3"]
+    nx1, nx2, nx3 = info["nx1_mb"], info["nx2_mb"], info["nx3_mb"]
+    x1min, x1max = info["x1min"], info["x1max"]
+    x2min, x2max = info["x2min"], info["x2max"]
+    x3min, x3max = info["x3min"], info["x3max"]
+    _, data_end = _read_block_index(fp, filesize)
+
     # load data from each meshblock
     n_vars = len(var_list)
     mb_count = 0
@@ -199,7 +310,7 @@ def read_binary(filename):
     mb_data = {}
     for var in var_list:
         mb_data[var] = []
-    while fp.tell() < filesize:
+    while fp.tell() < data_end:
         mb_index.append(
             np.frombuffer(fp.read(24), dtype=np.int32).astype(np.int64) - nghost
         )
@@ -214,10 +325,8 @@ def read_binary(filename):
             )
         )
 
-        data = np.fromfile(
-            fp,
-            dtype=np.float64 if varfmt == "d" else np.float32,
-            count=nx1_out * nx2_out * nx3_out * n_vars,
+        data = _read_meshblock_data(
+            fp, compression, varfmt, n_vars, nx1_out * nx2_out * nx3_out
         )
         data = data.reshape(nvars, nx3_out, nx2_out, nx1_out)
         for vari, var in enumerate(var_list):
@@ -259,6 +368,206 @@ def read_binary(filename):
     return filedata
 
 
+class LazyBinary:
+    """
+    Memory-mapped reader of a bin file, which reads only the requested variables on the
+    requested MeshBlocks (or region), using several threads.
+
+    The position of each MeshBlock record is taken from the block index at the end of
+    the file (written with <output>/block_index=true). For files without an index, the
+    records are located by reading just their headers (and, in compressed files, the
+    sizes of the compressed variables). On opening, only the header and the locations
+    of the MeshBlocks are read, e.g.
+
+      lb = bin_convert.LazyBinary("path/to/file.bin")
+      filedata = lb.read(variables=["dens"], region=(0.0, 0.5, -1.0, 1.0, -1.0, 1.0))
+
+    Attributes are the header information of read_binary(...) (except mb_data), along
+    with the gid (-1 if unknown), offset and size of the record of each MeshBlock.
+    """
+
+    def __init__(self, filename):
+        fp = open(filename, "rb")
+        fp.seek(0, 2)
+        filesize = fp.tell()
+        fp.seek(0, 0)
+        info = _read_binary_header(fp)
+        index, data_end = _read_block_index(fp, filesize)
+        self.prefix_size = 40 + 6 * info["locsizebytes"]
+        self.compression = info["compression"]
+        self.vardtype = np.float64 if info["varfmt"] == "d" else np.float32
+        if index is None:
+            index = self._scan(fp, info["nvars"], data_end)
+        fp.close()
+
+        self.filename = filename
+        self.info = info
+        self.var_names = info["var_names"]
+        self.n_mbs = len(index)
+        self.gids = index[:, 0]
+        self.offsets = index[:, 1]
+        self.sizes = index[:, 2]
+        self._mm = np.memmap(filename, dtype=np.uint8, mode="r")
+
+        # indices, logical locations and coordinates of all MeshBlocks
+        locdtype = np.float64 if info["locfmt"] == "d" else np.float32
+        prefix = self._mm[self.offsets[:, None] + np.arange(self.prefix_size)]
+        self.mb_index = (
+            prefix[:, :24].copy().view(np.int32).astype(np.int64) - info["nghost"]
+        )
+        self.mb_logical = prefix[:, 24:40].copy().view(np.int32)
+        self.mb_geometry = prefix[:, 40:].copy().view(locdtype)
+
+    def _scan(self, fp, nvars, data_end):
+        """
+        Returns index of MeshBlock records in file without block index.
+        """
+        index = []
+        pos = fp.tell()
+        while pos < data_end:
+            fp.seek(pos)
+            ind = np.frombuffer(fp.read(24), dtype=np.int32).astype(np.int64)
+            ncells = (ind[1] - ind[0] + 1) * (ind[3] - ind[2] + 1) * (ind[5] - ind[4] + 1)
+            size = self.prefix_size
+            if self.compression == "none":
+                size += nvars * ncells * np.dtype(self.vardtype).itemsize
+            else:
+                for _ in range(nvars):
+                    fp.seek(pos + size)
+                    size += 8 + int(np.frombuffer(fp.read(8), dtype=np.uint64)[0])
+            index.append([-1, pos, size])
+            pos += size
+        return np.array(index, dtype=np.int64).reshape(-1, 3)
+
+    def _cells(self, b, region):
+        """
+        Returns ranges of cells (along x1, x2, x3) of MeshBlock b overlapping region,
+        or None if there are none.
+        """
+        ranges = []
+        for d in range(3):
+            n = int(self.mb_index[b, 2 * d + 1] - self.mb_index[b, 2 * d]) + 1
+            if region is None:
+                ranges.append((0, n))
+                continue
+            xmin, xmax = self.mb_geometry[b, 2 * d], self.mb_geometry[b, 2 * d + 1]
+            rmin, rmax = region[2 * d], region[2 * d + 1]
+            if xmax < rmin or xmin > rmax:
+                return None
+            dx = (xmax - xmin) / n
+            lo = 0 if dx == 0 else max(int(np.floor((rmin - xmin) / dx)), 0)
+            hi = n if dx == 0 else min(int(np.ceil((rmax - xmin) / dx)), n)
+            if hi <= lo:
+                return None
+            ranges.append((lo, hi))
+        return ranges
+
+    def _read_block(self, b, var_ids, ranges):
+        """
+        Returns list of arrays of variables var_ids in cells ranges of MeshBlock b.
+        """
+        ind = self.mb_index[b]
+        nx1, nx2, nx3 = [int(ind[2 * d + 1] - ind[2 * d]) + 1 for d in range(3)]
+        ncells = nx1 * nx2 * nx3
+        crop = (slice(*ranges[2]), slice(*ranges[1]), slice(*ranges[0]))
+        pos = int(self.offsets[b]) + self.prefix_size
+        if self.compression == "none":
+            nbytes = len(self.var_names) * ncells * np.dtype(self.vardtype).itemsize
+            data = self._mm[pos : pos + nbytes].view(self.vardtype)
+            data = data.reshape(len(self.var_names), nx3, nx2, nx1)
+            return [np.array(data[v][crop]) for v in var_ids]
+        import zstandard
+
+        decompressor = zstandard.ZstdDecompressor()
+        out = {}
+        for v in range(max(var_ids) + 1):
+            csize = int(self._mm[pos : pos + 8].view(np.uint64)[0])
+            pos += 8
+            if v in var_ids:
+                raw = decompressor.decompress(
+                    self._mm[pos : pos + csize], max_output_size=4 * ncells
+                )
+                shuffled = np.frombuffer(raw, dtype=np.uint8).reshape(4, ncells)
+                data = shuffled.T.copy().view(np.float32)[:, 0]
+                out[v] = data.reshape(nx3, nx2, nx1)[crop].copy()
+            pos += csize
+        return [out[v] for v in var_ids]
+
+    def read(self, variables=None, blocks=None, region=None, nthreads=None):
+        """
+        Reads variables on MeshBlocks into a filedata dictionary like that returned by
+        read_binary(...), containing only the selected MeshBlocks, with mb_index and
+        mb_geometry of the cells that were read.
+
+        args:
+          variables - list of strings
+              variables to read (default all)
+          blocks - list of ints
+              positions in file of MeshBlocks to read (default all)
+          region - tuple (x1min, x1max, x2min, x2max, x3min, x3max)
+              only read cells overlapping region (default all)
+          nthreads - int
+              number of threads reading MeshBlocks (default chosen by
+              concurrent.futures)
+        """
+        from concurrent.futures import ThreadPoolExecutor
+
+        if variables is None:
+            variables = self.var_names
+        var_ids = [self.var_names.index(var) for var in variables]
+        if blocks is None:
+            blocks = range(self.n_mbs)
+
+        selected = []
+        for b in blocks:
+            ranges = self._cells(b, region)
+            if ranges is not None:
+                selected.append((b, ranges))
+
+        with ThreadPoolExecutor(max_workers=nthreads) as executor:
+            results = list(
+                executor.map(lambda s: self._read_block(s[0], var_ids, s[1]), selected)
+            )
+
+        filedata = {
+            key: self.info[key]
+            for key in [
+                "header", "time", "cycle", "Nx1", "Nx2", "Nx3", "nx1_mb", "nx2_mb",
+                "nx3_mb", "x1min", "x1max", "x2min", "x2max", "x3min", "x3max",
+            ]
+        }
+        filedata["var_names"] = list(variables)
+        filedata["nvars"] = len(variables)
+        filedata["n_mbs"] = len(selected)
+
+        mb_index, mb_logical, mb_geometry = [], [], []
+        for b, ranges in selected:
+            index = self.mb_index[b].copy()
+            geometry = self.mb_geometry[b].copy()
+            for d, (lo, hi) in enumerate(ranges):
+                n = index[2 * d + 1] - index[2 * d] + 1
+                dx = (self.mb_geometry[b, 2 * d + 1] - self.mb_geometry[b, 2 * d]) / n
+                geometry[2 * d] = self.mb_geometry[b, 2 * d] + lo * dx
+                geometry[2 * d + 1] = self.mb_geometry[b, 2 * d] + hi * dx
+                index[2 * d + 1] = index[2 * d] + hi - 1
+                index[2 * d] = index[2 * d] + lo
+            mb_index.append(index)
+            mb_logical.append(self.mb_logical[b])
+            mb_geometry.append(geometry)
+        for d in range(3):
+            key = "nx" + str(d + 1) + "_out_mb"
+            filedata[key] = (
+                (mb_index[0][2 * d + 1] - mb_index[0][2 * d]) + 1 if selected else 0
+            )
+        filedata["mb_index"] = np.array(mb_index)
+        filedata["mb_logical"] = np.array(mb_logical)
+        filedata["mb_geometry"] = np.array(mb_geometry)
+        filedata["mb_data"] = {
+            var: [result[n] for result in results] for n, var in enumerate(variables)
+        }
+        return filedata
+
+
 def read_coarsened_binary(filename):
     """
     Reads a coarsened bin file from filename to dictionary.
@@ -293,7 +602,7 @@ def read_coarsened_binary(filename):
             + '(should be "Athena")'
         )
     version = code_header[-1].split(b"=")[-1]
-    if version != b"1.1":
+    if version not in [b"1.1", b"1.2"]:
         raise TypeError(f"unsupported file format version {version.decode('utf-8')}")
 
     pheader_count = int(fp.readline().split(b"=")[-1])
@@ -305,6 +614,7 @@ def read_coarsened_binary(filename):
     cycle = int(pheader["cycle"])
     locsizebytes = int(pheader["size of location"])
     varsizebytes = int(pheader["size of variable"])
+    compression = pheader.get("compression", "none")
     coarsen_factor = int(pheader["coarsening factor"])
 
     nvars = int(fp.readline().split(b"=")[-1])
@@ -369,7 +679,8 @@ def read_coarsened_binary(filename):
     mb_data = {}
     for var in var_list:
         mb_data[var] = []
-    while fp.tell() < filesize:
+    _, data_end = _read_block_index(fp, filesize)
+    while fp.tell() < data_end:
         mb_index_i = (
             np.frombuffer(fp.read(24), dtype=np.int32).astype(np.int64) - nghost
         )
@@ -386,10 +697,8 @@ def read_coarsened_binary(filename):
             )
         )
 
-        data = np.fromfile(
-            fp,
-            dtype=np.float64 if varfmt == "d" else np.float32,
-            count=nx1_out * nx2_out * nx3_out * n_vars,
+        data = _read_meshblock_data(
+            fp, compression, varfmt, n_vars, nx1_out * nx2_out * nx3_out
         )
         data = data.reshape(nvars, nx3_out, nx2_out, nx1_out)
         for vari, var in enumerate(var_list):